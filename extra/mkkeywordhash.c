@@ -202,7 +202,7 @@ static Keyword aKeywordTable[] = {
   { "DEC",                    "TK_DECIMAL",     true  },
   { "DECIMAL",                "TK_DECIMAL",     true  },
   { "DECLARE",                "TK_STANDARD",    true  },
-  { "DENSE_RANK",             "TK_STANDARD",    true  },
+  { "DENSE_RANK",             "TK_ID",          true  },
   { "DESCRIBE",               "TK_STANDARD",    true  },
   { "DETERMINISTIC",          "TK_STANDARD",    true  },
   { "DOUBLE",                 "TK_DOUBLE",      true  },
@@ -225,12 +225,12 @@ static Keyword aKeywordTable[] = {
   { "NUM",                    "TK_STANDARD",    true  },
   { "NUMERIC",                "TK_STANDARD",    true  },
   { "OUT",                    "TK_STANDARD",    true  },
-  { "OVER",                   "TK_STANDARD",    true  },
-  { "PARTITION",              "TK_STANDARD",    true  },
+  { "OVER",                   "TK_OVER",        true  },
+  { "PARTITION",              "TK_PARTITION",   true  },
   { "PRECISION",              "TK_STANDARD",    true  },
   { "PROCEDURE",              "TK_STANDARD",    true  },
   { "RANGE",                  "TK_STANDARD",    true  },
-  { "RANK",                   "TK_STANDARD",    true  },
+  { "RANK",                   "TK_ID",          true  },
   { "READS",                  "TK_STANDARD",    true  },
   { "REAL",                   "TK_STANDARD",    true  },
   { "REPEAT",                 "TK_STANDARD",    true  },
@@ -238,7 +238,7 @@ static Keyword aKeywordTable[] = {
   { "RETURN",                 "TK_STANDARD",    true  },
   { "REVOKE",                 "TK_STANDARD",    true  },
   { "ROWS",                   "TK_STANDARD",    true  },
-  { "ROW_NUMBER",             "TK_STANDARD",    true  },
+  { "ROW_NUMBER",             "TK_ID",          true  },
   { "SENSITIVE",              "TK_STANDARD",    true  },
   { "SIGNAL",                 "TK_STANDARD",    true  },
   { "SMALLINT",               "TK_ID",          true  },
@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <inttypes.h>
 #include <time.h>
 #include <random>
@@ -111,6 +112,90 @@
 #undef BPS_INNER_CARD
 #undef BPS_INNER_CHILD_CARDS
 
+/*
+ * Trees with a comparator that isn't inlined and loads a cache line per
+ * compared element, like tuple_compare() used by memtx does, with and
+ * without comparison hints. The hint of an element is the element with
+ * the sign bit flipped so the hints have the same order.
+ */
+
+static int64_t i64_tuples[1 << 22];
+
+/* Write the tuples so that they aren't mapped to the zero page. */
+static const bool i64_tuples_init = [] {
+	memset(i64_tuples, 0, sizeof(i64_tuples));
+	return true;
+}();
+
+static inline int64_t
+i64_tuple_load(int64_t a)
+{
+	return a + i64_tuples[(a * 8) & (lengthof(i64_tuples) - 1)];
+}
+
+static NOINLINE int
+i64_compare(int64_t a, int64_t b)
+{
+	a = i64_tuple_load(a);
+	b = i64_tuple_load(b);
+	return a < b ? -1 : a > b;
+}
+
+static NOINLINE int
+i64_compare_key(int64_t a, int64_t b)
+{
+	a = i64_tuple_load(a);
+	return a < b ? -1 : a > b;
+}
+
+#define treecmp_i64_EXTENT_SIZE 8192
+#define treecmp_i64_elem_t int64_t
+#define treecmp_i64_key_t int64_t
+#define BPS_TREE_NAME treecmp_i64_t
+#define BPS_TREE_BLOCK_SIZE 512
+#define BPS_TREE_EXTENT_SIZE treecmp_i64_EXTENT_SIZE
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a) == (b))
+#define BPS_TREE_COMPARE(a, b, arg) i64_compare(a, b)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) i64_compare_key(a, b)
+#define bps_tree_elem_t treecmp_i64_elem_t
+#define bps_tree_key_t treecmp_i64_key_t
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
+#define treehint_i64_EXTENT_SIZE 8192
+#define treehint_i64_elem_t int64_t
+#define treehint_i64_key_t int64_t
+#define BPS_TREE_NAME treehint_i64_t
+#define BPS_TREE_BLOCK_SIZE 512
+#define BPS_TREE_EXTENT_SIZE treehint_i64_EXTENT_SIZE
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a) == (b))
+#define BPS_TREE_COMPARE(a, b, arg) i64_compare(a, b)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) i64_compare_key(a, b)
+#define BPS_TREE_ELEM_HINT(a) ((uint64_t)(a) ^ (1ULL << 63))
+#define BPS_TREE_KEY_HINT(b) ((uint64_t)(b) ^ (1ULL << 63))
+#define BPS_TREE_USE_HINT(arg) true
+#define bps_tree_elem_t treehint_i64_elem_t
+#define bps_tree_key_t treehint_i64_key_t
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_ELEM_HINT
+#undef BPS_TREE_KEY_HINT
+#undef BPS_TREE_USE_HINT
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
 /**
  * Generate the benchmark variations required.
  */
@@ -142,7 +227,9 @@
 	generator(tree_i64, func, arg); \
 	generator(treecc_i64, func, arg); \
 	generator(treeic_i64, func, arg); \
-	generator(treebo_i64, func, arg)
+	generator(treebo_i64, func, arg); \
+	generator(treecmp_i64, func, arg); \
+	generator(treehint_i64, func, arg)
 
 /* Create size-based benchmarks for all trees. */
 #define generate_benchmarks_size(func, size) \
@@ -251,6 +338,8 @@ CREATE_TREE_CLASS(tree_i64);
 CREATE_TREE_CLASS(treecc_i64);
 CREATE_TREE_CLASS(treeic_i64);
 CREATE_TREE_CLASS(treebo_i64);
+CREATE_TREE_CLASS(treecmp_i64);
+CREATE_TREE_CLASS(treehint_i64);
 
 /**
  * Value generators to make key-independent benchmarks.
@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "trivia/config.h"
+#include "crc32.h"
+#include "crc32_impl.h"
+#include "cpu_feature.h"
+
+// This test contains benchmarks for CRC32 implementations used to
+// checksum xlog transactions and vinyl pages:
+//  - Software (table-driven) implementation;
+//  - Hardware implementations available on the CPU;
+//  - The implementation chosen by crc32_init().
+
+constexpr static std::size_t BUF_SIZE_MIN = 64;
+constexpr static std::size_t BUF_SIZE_MAX = 128 * 1024;
+
+static std::vector<char>
+make_buffer(std::size_t size)
+{
+	std::vector<char> buf(size);
+	std::mt19937 gen(42);
+	for (auto &c : buf)
+		c = static_cast<char>(gen());
+	return buf;
+}
+
+static void
+bench_crc32(benchmark::State &state, crc32_func func)
+{
+	std::size_t size = state.range(0);
+	std::vector<char> buf = make_buffer(size);
+	uint32_t crc = 0;
+	for (auto _ : state) {
+		crc = func(crc, buf.data(), size);
+		benchmark::DoNotOptimize(crc);
+	}
+	state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void
+crc32_software(benchmark::State &state)
+{
+	bench_crc32(state, &crc32c);
+}
+BENCHMARK(crc32_software)->Range(BUF_SIZE_MIN, BUF_SIZE_MAX);
+
+#if defined(HAVE_CPUID) && (defined (__x86_64__) || defined (__i386__))
+static void
+crc32_sse42(benchmark::State &state)
+{
+	if (!sse42_enabled_cpu()) {
+		state.SkipWithError("SSE 4.2 is not supported");
+		return;
+	}
+	bench_crc32(state, &crc32c_hw);
+}
+BENCHMARK(crc32_sse42)->Range(BUF_SIZE_MIN, BUF_SIZE_MAX);
+#endif
+
+#if defined(HAVE_CPUID) && defined (__x86_64__)
+static void
+crc32_sse42_pclmul(benchmark::State &state)
+{
+	if (!sse42_enabled_cpu() || !pclmul_enabled_cpu()) {
+		state.SkipWithError("SSE 4.2 or PCLMULQDQ is not supported");
+		return;
+	}
+	bench_crc32(state, &crc32c_hw_multi);
+}
+BENCHMARK(crc32_sse42_pclmul)->Range(BUF_SIZE_MIN, BUF_SIZE_MAX);
+#endif
+
+#if defined (__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static void
+crc32_armv8(benchmark::State &state)
+{
+	if (!armv8_crc32_enabled_cpu()) {
+		state.SkipWithError("ARMv8 CRC32 is not supported");
+		return;
+	}
+	bench_crc32(state, &crc32c_armv8);
+}
+BENCHMARK(crc32_armv8)->Range(BUF_SIZE_MIN, BUF_SIZE_MAX);
+#endif
+
+static void
+crc32_calc_default(benchmark::State &state)
+{
+	crc32_init();
+	bench_crc32(state, crc32_calc);
+}
+BENCHMARK(crc32_calc_default)->Range(BUF_SIZE_MIN, BUF_SIZE_MAX);
+
+BENCHMARK_MAIN();
+
+#include "debug_warning.h"
@@ -16,6 +16,7 @@
 //  - Search only (by value), no misses;
 //  - Search only (by value) with misses;
 //  - Search by key;
+//  - Batched search by key;
 //  - Sequence iteration;
 //  - Inserts after erase;
 //  - Inserts alongside with lookups;
@@ -357,6 +358,41 @@ class HTBench : public ::benchmark::Fixture {
 		state.SetItemsProcessed(lookup_count);
 	}
 
+	// Lookup random values by key in batches of state.range(1) keys.
+	void
+	FindRandByKeyBatch(benchmark::State& state)
+	{
+		std::size_t lookup_count = 0;
+		std::size_t batch_size = state.range(1);
+		std::vector<uint32_t> slots(batch_size);
+		for (auto s : state) {
+			state.PauseTiming();
+			Reset();
+			TupleHolder data(state.range(0));
+			Fill(data.tuples.begin(), data.tuples.end());
+			data.shuffle();
+			std::vector<Hash_t> hashes;
+			std::vector<Key_t> keys;
+			hashes.reserve(data.tuples.size());
+			keys.reserve(data.tuples.size());
+			for (const auto &v : data.tuples) {
+				hashes.push_back(v.hash);
+				keys.push_back(v.key);
+			}
+			state.ResumeTiming();
+
+			for (std::size_t i = 0; i < keys.size(); i += batch_size) {
+				std::size_t count = std::min(batch_size,
+							     keys.size() - i);
+				hash_table.find_key_batch(&hashes[i], &keys[i],
+							  count, slots.data());
+				benchmark::DoNotOptimize(slots.data());
+				lookup_count += count;
+			}
+		}
+		state.SetItemsProcessed(lookup_count);
+	}
+
 	// Sequence iteration over the hash table - starting from the first value.
 	// Measurements include iterator dereference.
 	void
@@ -515,6 +551,13 @@ class Light {
 		return light_find_key(&ht, tuple.hash, tuple.key);
 	}
 
+	void
+	find_key_batch(const Hash_t *hashes, Key_t *keys, std::size_t count,
+		       uint32_t *slots)
+	{
+		light_find_key_batch(&ht, hashes, keys, count, slots);
+	}
+
 	void
 	clear()
 	{
@@ -591,6 +634,11 @@ BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(InsertRandValueReserve);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindRandValue);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindRandValueWithMisses);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindRandByKey);
+BENCHMARK_TEMPLATE_DEFINE_F(HTBench, LightFindRandByKeyBatch, Light)(benchmark::State& state)
+{ HTBench::FindRandByKeyBatch(state); }
+BENCHMARK_REGISTER_F(HTBench, LightFindRandByKeyBatch)->
+	ArgsProduct({{(int64_t)TUPLE_COUNT_MIN, (int64_t)TUPLE_COUNT_MAX},
+		     {1, 8, 32}});
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(SequenceIteration);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(InsertAfterErase);
 BENCHMARK_TEMPLATE_REGISTER_FOR_ALL_IMPLS(FindAfterErase);
@@ -27,6 +27,8 @@
 --     items = ITERATIONS,
 --     real_time = clock.time() - start_time.time,
 --     cpu_time = clock.proc() - start_time.proc,
+--     -- Optional user counters, dumped along with the result in JSON.
+--     counters = {latency_p99 = 100},
 -- })
 --
 -- bench:dump_results()
@@ -76,6 +78,10 @@ local function add_result(bench, name, data)
         iterations = data.items,
         items_per_second = items_per_second,
     }
+    -- Google Benchmark dumps user counters as the result fields.
+    for name, value in pairs(data.counters or {}) do
+        result[name] = value
+    end
     table.insert(bench.results, result)
     return result
 end
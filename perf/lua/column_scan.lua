@@ -22,6 +22,7 @@ local USAGE = [[
    row_count <number, 1000000>      - number of rows in the test space
    use_read_view <boolean, false>   - use a read view
    use_scanner_api <boolean, false> - use the column scanner API
+   use_aggregate <boolean, false>   - use index:aggregate()
 
  Being run without options, this benchmark measures the run time of a full scan
  from the space.
@@ -33,6 +34,7 @@ local params = benchmark.argparse(arg, {
     {'row_count', 'number'},
     {'use_read_view', 'boolean'},
     {'use_scanner_api', 'boolean'},
+    {'use_aggregate', 'boolean'},
 }, USAGE)
 
 local DEFAULT_ENGINE = 'memtx'
@@ -44,6 +46,7 @@ params.column_count = params.column_count or DEFAULT_COLUMN_COUNT
 params.row_count = params.row_count or DEFAULT_ROW_COUNT
 params.use_read_view = params.use_read_view or false
 params.use_scanner_api = params.use_scanner_api or false
+params.use_aggregate = params.use_aggregate or false
 
 local bench = benchmark.new(params)
 
@@ -73,6 +76,16 @@ for _, func_name in ipairs({'sum'}) do
     test_funcs[func_name] = f
 end
 
+if params.use_aggregate then
+    if params.use_scanner_api or params.use_read_view then
+        error('The specified test mode is not supported by index:aggregate()')
+    end
+    test_funcs.sum = function(space_id, index_id, fieldno)
+        local index = box.space[space_id].index[index_id]
+        return index:aggregate(nil, {{'sum', fieldno + 1}})[1][1]
+    end
+end
+
 local WORK_DIR = string.format(
     'column_scan,engine=%s,column_count=%d,row_count=%d',
     params.engine, params.column_count, params.row_count)
@@ -0,0 +1,155 @@
+--
+-- The test measures throughput and latency of requests sent over
+-- the network. The instance running the script serves requests sent
+-- by the iproto_loadgen load generator run as a separate process.
+--
+-- Output format (console):
+-- <test-case> <requests-per-second>
+--
+-- The JSON output includes latency percentiles in microseconds: p50, p90,
+-- p99, p999 and max.
+--
+-- NOTE: The test requires the load generator binary. Set the BUILDDIR
+-- environment variable to the tarantool build directory if using
+-- out-of-source build.
+--
+
+local clock = require('clock')
+local fio = require('fio')
+local json = require('json')
+local popen = require('popen')
+local benchmark = require('benchmark')
+
+local USAGE = [[
+   connections <number, 10>   - number of connections
+   duration <number, 10>      - test duration in seconds
+   engine <string, 'memtx'>   - space engine to use for the test
+   keys <number, 100000>      - number of tuples in the test space
+   mix <string, 'select:80,replace:20'>
+                              - request mix, request types: select, replace,
+                                ping
+   payload <number, 100>      - size of a tuple payload in bytes
+   pipeline <number, 10>      - requests in flight per connection
+   threads <number, 2>        - number of load generator threads
+   wal_mode <string, 'write'> - WAL synchronization mode
+
+ Being run without options, this benchmark measures throughput and latency
+ of a mix of 80% selects and 20% replaces sent over 10 connections by two
+ load generator threads with 10 requests in flight per connection.
+]]
+
+local params = benchmark.argparse(arg, {
+    {'connections', 'number'},
+    {'duration', 'number'},
+    {'engine', 'string'},
+    {'keys', 'number'},
+    {'mix', 'string'},
+    {'payload', 'number'},
+    {'pipeline', 'number'},
+    {'threads', 'number'},
+    {'wal_mode', 'string'},
+}, USAGE)
+
+params.connections = params.connections or 10
+params.duration = params.duration or 10
+params.engine = params.engine or 'memtx'
+params.keys = params.keys or 100000
+params.mix = params.mix or 'select:80,replace:20'
+params.payload = params.payload or 100
+params.pipeline = params.pipeline or 10
+params.threads = params.threads or 2
+params.wal_mode = params.wal_mode or 'write'
+
+local bench = benchmark.new(params)
+
+local BUILDDIR = fio.abspath(fio.pathjoin(os.getenv('BUILDDIR') or '.'))
+local LOADGEN = fio.pathjoin(BUILDDIR, 'perf', 'lua', 'iproto_loadgen')
+if not fio.path.exists(LOADGEN) then
+    error('Load generator is not found at ' .. LOADGEN)
+end
+
+local test_dir = fio.tempdir()
+
+box.cfg({
+    listen = '127.0.0.1:0',
+    work_dir = test_dir,
+    wal_mode = params.wal_mode,
+    memtx_memory = 2 * 1024 * 1024 * 1024,
+    net_msg_max = math.max(768, params.connections * params.pipeline * 2),
+})
+
+local space = box.schema.space.create('test', {engine = params.engine})
+space:create_index('pk')
+local payload = string.rep('x', params.payload)
+box.begin()
+for i = 0, params.keys - 1 do
+    space:replace({i, payload})
+    if i % 1000 == 999 then
+        box.commit()
+        box.begin()
+    end
+end
+box.commit()
+box.schema.user.grant('guest', 'read,write', 'space', 'test')
+
+local port = box.info.listen:match(':(%d+)$')
+local argv = {
+    LOADGEN,
+    '--host', '127.0.0.1',
+    '--port', port,
+    '--space_id', tostring(space.id),
+    '--connections', tostring(params.connections),
+    '--threads', tostring(params.threads),
+    '--pipeline', tostring(params.pipeline),
+    '--duration', tostring(params.duration),
+    '--keys', tostring(params.keys),
+    '--payload', tostring(params.payload),
+    '--mix', params.mix,
+}
+
+local start_cpu_time = clock.proc()
+local ph = assert(popen.new(argv, {stdout = popen.opts.PIPE}))
+-- Reading from the pipe yields, so requests are served meanwhile.
+local output = {}
+while true do
+    local chunk, err = ph:read()
+    if chunk == nil then
+        error('Failed to read the load generator output: ' .. tostring(err))
+    end
+    if chunk == '' then
+        break
+    end
+    table.insert(output, chunk)
+end
+local status = ph:wait()
+ph:close()
+local cpu_time = clock.proc() - start_cpu_time
+if status.exit_code ~= 0 then
+    error('Load generator failed with exit code ' ..
+          tostring(status.exit_code))
+end
+
+for _, res in ipairs(json.decode(table.concat(output))) do
+    if res.errors > 0 then
+        error(('%d %s requests failed'):format(res.errors, res.name))
+    end
+    bench:add_result(res.name, {
+        items = res.requests,
+        real_time = res.real_time,
+        cpu_time = cpu_time,
+        counters = {
+            p50 = res.p50,
+            p90 = res.p90,
+            p99 = res.p99,
+            p999 = res.p999,
+            max = res.max,
+        },
+    })
+end
+
+bench:dump_results()
+
+box.schema.user.revoke('guest', 'read,write', 'space', 'test')
+space:drop()
+fio.rmtree(test_dir)
+os.exit(0)
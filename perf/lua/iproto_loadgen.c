@@ -0,0 +1,727 @@
+/*
+ * IPROTO load generator used by the iproto_load.lua benchmark.
+ *
+ * The generator opens the given number of connections to a Tarantool
+ * instance, spreads them over worker threads, and keeps up to
+ * `pipeline` requests in flight in each connection until the given
+ * duration elapses. Requests are chosen randomly according to the
+ * request mix. Keys are chosen uniformly from [0, keys).
+ *
+ * The results are printed to stdout in JSON, one object per request
+ * type and one for all requests ("total"):
+ *
+ * {"name": "select", "requests": 123, "errors": 0, "real_time": 10.0,
+ *  "p50": 31.5, "p90": 40.1, "p99": 70.2, "p999": 120.3, "max": 900.0}
+ *
+ * Latencies are in microseconds.
+ */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <msgpuck.h>
+
+enum {
+	/** IPROTO constants, see src/box/iproto_constants.h. */
+	IPROTO_GREETING_SIZE = 128,
+	IPROTO_REQUEST_TYPE = 0x00,
+	IPROTO_SYNC = 0x01,
+	IPROTO_SPACE_ID = 0x10,
+	IPROTO_INDEX_ID = 0x11,
+	IPROTO_LIMIT = 0x12,
+	IPROTO_OFFSET = 0x13,
+	IPROTO_ITERATOR = 0x14,
+	IPROTO_KEY = 0x20,
+	IPROTO_TUPLE = 0x21,
+	IPROTO_SELECT = 1,
+	IPROTO_REPLACE = 3,
+	IPROTO_PING = 64,
+	/** Size of the fixed-width packet length prefix (0xce + uint32). */
+	PACKET_LEN_SIZE = 5,
+	/** Max size of a request without the payload. */
+	REQUEST_SIZE_MAX = 128,
+};
+
+enum request_type {
+	REQUEST_SELECT,
+	REQUEST_REPLACE,
+	REQUEST_PING,
+	request_type_MAX,
+};
+
+static const char *const request_type_strs[] = {
+	"select",
+	"replace",
+	"ping",
+};
+
+/**
+ * Latency histogram with buckets growing exponentially: every power
+ * of two range of nanoseconds is split into HIST_SUB_BUCKETS equal
+ * buckets, which gives a relative error below 1 / HIST_SUB_BUCKETS.
+ */
+enum {
+	HIST_SUB_BUCKET_BITS = 5,
+	HIST_SUB_BUCKETS = 1 << HIST_SUB_BUCKET_BITS,
+	HIST_BUCKETS = 64 * HIST_SUB_BUCKETS,
+};
+
+struct histogram {
+	uint64_t buckets[HIST_BUCKETS];
+	uint64_t count;
+	uint64_t max;
+};
+
+static int
+histogram_bucket(uint64_t value)
+{
+	if (value < HIST_SUB_BUCKETS)
+		return value;
+	int log2 = 63 - __builtin_clzll(value);
+	int shift = log2 - HIST_SUB_BUCKET_BITS;
+	int sub = (value >> shift) & (HIST_SUB_BUCKETS - 1);
+	return (shift + 1) * HIST_SUB_BUCKETS + sub;
+}
+
+/** Returns the upper bound of the values stored in a bucket. */
+static uint64_t
+histogram_bucket_value(int bucket)
+{
+	if (bucket < HIST_SUB_BUCKETS)
+		return bucket;
+	int shift = bucket / HIST_SUB_BUCKETS - 1;
+	uint64_t sub = bucket % HIST_SUB_BUCKETS;
+	return ((HIST_SUB_BUCKETS | sub) << shift) + (1ULL << shift) - 1;
+}
+
+static void
+histogram_add(struct histogram *hist, uint64_t value)
+{
+	hist->buckets[histogram_bucket(value)]++;
+	hist->count++;
+	if (value > hist->max)
+		hist->max = value;
+}
+
+static void
+histogram_merge(struct histogram *dst, const struct histogram *src)
+{
+	for (int i = 0; i < HIST_BUCKETS; i++)
+		dst->buckets[i] += src->buckets[i];
+	dst->count += src->count;
+	if (src->max > dst->max)
+		dst->max = src->max;
+}
+
+static uint64_t
+histogram_percentile(const struct histogram *hist, double percentile)
+{
+	uint64_t rank = hist->count * percentile / 100;
+	uint64_t seen = 0;
+	for (int i = 0; i < HIST_BUCKETS; i++) {
+		seen += hist->buckets[i];
+		if (seen > rank) {
+			uint64_t value = histogram_bucket_value(i);
+			return value < hist->max ? value : hist->max;
+		}
+	}
+	return hist->max;
+}
+
+/** Per request type statistics. */
+struct request_stat {
+	struct histogram latency;
+	uint64_t errors;
+};
+
+/** Load generator options. */
+static struct {
+	const char *host;
+	const char *port;
+	int connections;
+	int threads;
+	int pipeline;
+	double duration;
+	uint32_t space_id;
+	uint64_t keys;
+	uint32_t payload;
+	/** Request mix: cumulative weights of request types. */
+	unsigned mix[request_type_MAX];
+	unsigned mix_total;
+} opts = {
+	.host = "127.0.0.1",
+	.port = "3301",
+	.connections = 10,
+	.threads = 2,
+	.pipeline = 10,
+	.duration = 10,
+	.space_id = 512,
+	.keys = 100000,
+	.payload = 100,
+};
+
+/** An in-flight request. */
+struct slot {
+	enum request_type type;
+	uint64_t start_ns;
+};
+
+struct connection {
+	int fd;
+	/** Buffered output. */
+	char *wbuf;
+	size_t wbuf_used;
+	size_t wbuf_size;
+	/** Buffered input. */
+	char *rbuf;
+	size_t rbuf_used;
+	size_t rbuf_size;
+	/** In-flight requests indexed by IPROTO_SYNC. */
+	struct slot *slots;
+	/** Indexes of free slots. */
+	uint32_t *free_slots;
+	int free_count;
+};
+
+struct worker {
+	pthread_t thread;
+	struct connection *conns;
+	int conn_count;
+	/** State of the random number generator. */
+	uint64_t rand_state;
+	struct request_stat stat[request_type_MAX];
+	/** Set if the worker failed, see the message in the log. */
+	bool failed;
+};
+
+static uint64_t
+clock_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/** xorshift64* generator, rand() is too slow when called from threads. */
+static uint64_t
+worker_rand(struct worker *worker)
+{
+	uint64_t x = worker->rand_state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	worker->rand_state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+static int
+connection_connect(struct connection *conn)
+{
+	struct addrinfo hints, *res;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	int rc = getaddrinfo(opts.host, opts.port, &hints, &res);
+	if (rc != 0) {
+		fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(rc));
+		return -1;
+	}
+	conn->fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+	if (conn->fd < 0) {
+		perror("socket");
+		freeaddrinfo(res);
+		return -1;
+	}
+	if (connect(conn->fd, res->ai_addr, res->ai_addrlen) != 0) {
+		perror("connect");
+		freeaddrinfo(res);
+		return -1;
+	}
+	freeaddrinfo(res);
+	int one = 1;
+	setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	/* Skip the greeting, we connect as guest. */
+	char greeting[IPROTO_GREETING_SIZE];
+	size_t size = 0;
+	while (size < sizeof(greeting)) {
+		ssize_t n = read(conn->fd, greeting + size,
+				 sizeof(greeting) - size);
+		if (n <= 0) {
+			perror("read greeting");
+			return -1;
+		}
+		size += n;
+	}
+	int flags = fcntl(conn->fd, F_GETFL, 0);
+	if (flags < 0 || fcntl(conn->fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+		perror("fcntl");
+		return -1;
+	}
+	conn->wbuf_size = opts.pipeline * (REQUEST_SIZE_MAX + opts.payload);
+	conn->wbuf = malloc(conn->wbuf_size);
+	conn->rbuf_size = 64 * 1024 + 2 * (size_t)opts.payload;
+	conn->rbuf = malloc(conn->rbuf_size);
+	conn->slots = calloc(opts.pipeline, sizeof(*conn->slots));
+	conn->free_slots = calloc(opts.pipeline, sizeof(*conn->free_slots));
+	if (conn->wbuf == NULL || conn->rbuf == NULL ||
+	    conn->slots == NULL || conn->free_slots == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return -1;
+	}
+	for (int i = 0; i < opts.pipeline; i++)
+		conn->free_slots[i] = i;
+	conn->free_count = opts.pipeline;
+	return 0;
+}
+
+static void
+connection_close(struct connection *conn)
+{
+	if (conn->fd >= 0)
+		close(conn->fd);
+	free(conn->wbuf);
+	free(conn->rbuf);
+	free(conn->slots);
+	free(conn->free_slots);
+}
+
+static enum request_type
+worker_choose_request(struct worker *worker)
+{
+	unsigned r = worker_rand(worker) % opts.mix_total;
+	for (int i = 0; i < request_type_MAX; i++) {
+		if (r < opts.mix[i])
+			return i;
+	}
+	return REQUEST_PING;
+}
+
+/** Encodes a request to the connection output buffer. */
+static void
+worker_encode_request(struct worker *worker, struct connection *conn,
+		      enum request_type type, uint32_t sync)
+{
+	char *begin = conn->wbuf + conn->wbuf_used;
+	char *data = begin + PACKET_LEN_SIZE;
+	uint64_t key = worker_rand(worker) % opts.keys;
+	data = mp_encode_map(data, 2);
+	data = mp_encode_uint(data, IPROTO_REQUEST_TYPE);
+	switch (type) {
+	case REQUEST_SELECT:
+		data = mp_encode_uint(data, IPROTO_SELECT);
+		break;
+	case REQUEST_REPLACE:
+		data = mp_encode_uint(data, IPROTO_REPLACE);
+		break;
+	case REQUEST_PING:
+		data = mp_encode_uint(data, IPROTO_PING);
+		break;
+	default:
+		abort();
+	}
+	data = mp_encode_uint(data, IPROTO_SYNC);
+	data = mp_encode_uint(data, sync);
+	switch (type) {
+	case REQUEST_SELECT:
+		data = mp_encode_map(data, 6);
+		data = mp_encode_uint(data, IPROTO_SPACE_ID);
+		data = mp_encode_uint(data, opts.space_id);
+		data = mp_encode_uint(data, IPROTO_INDEX_ID);
+		data = mp_encode_uint(data, 0);
+		data = mp_encode_uint(data, IPROTO_LIMIT);
+		data = mp_encode_uint(data, 1);
+		data = mp_encode_uint(data, IPROTO_OFFSET);
+		data = mp_encode_uint(data, 0);
+		data = mp_encode_uint(data, IPROTO_ITERATOR);
+		data = mp_encode_uint(data, 0);
+		data = mp_encode_uint(data, IPROTO_KEY);
+		data = mp_encode_array(data, 1);
+		data = mp_encode_uint(data, key);
+		break;
+	case REQUEST_REPLACE:
+		data = mp_encode_map(data, 2);
+		data = mp_encode_uint(data, IPROTO_SPACE_ID);
+		data = mp_encode_uint(data, opts.space_id);
+		data = mp_encode_uint(data, IPROTO_TUPLE);
+		data = mp_encode_array(data, 2);
+		data = mp_encode_uint(data, key);
+		data = mp_encode_strl(data, opts.payload);
+		memset(data, 'x', opts.payload);
+		data += opts.payload;
+		break;
+	default:
+		data = mp_encode_map(data, 0);
+		break;
+	}
+	/* Fixed-width length so that it can be written after the body. */
+	char *len = begin;
+	*len++ = 0xce;
+	mp_store_u32(len, data - begin - PACKET_LEN_SIZE);
+	conn->wbuf_used = data - conn->wbuf;
+}
+
+/** Fills the pipeline of a connection with new requests. */
+static void
+worker_fill_pipeline(struct worker *worker, struct connection *conn)
+{
+	uint64_t now = clock_ns();
+	while (conn->free_count > 0) {
+		uint32_t sync = conn->free_slots[--conn->free_count];
+		struct slot *slot = &conn->slots[sync];
+		slot->type = worker_choose_request(worker);
+		slot->start_ns = now;
+		worker_encode_request(worker, conn, slot->type, sync);
+	}
+}
+
+static int
+worker_flush(struct connection *conn)
+{
+	size_t written = 0;
+	while (written < conn->wbuf_used) {
+		ssize_t n = write(conn->fd, conn->wbuf + written,
+				  conn->wbuf_used - written);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			perror("write");
+			return -1;
+		}
+		written += n;
+	}
+	memmove(conn->wbuf, conn->wbuf + written, conn->wbuf_used - written);
+	conn->wbuf_used -= written;
+	return 0;
+}
+
+/**
+ * Parses a response header and completes the in-flight request.
+ * Returns -1 if the response is malformed.
+ */
+static int
+worker_handle_response(struct worker *worker, struct connection *conn,
+		       const char *data, uint64_t now)
+{
+	if (mp_typeof(*data) != MP_MAP)
+		return -1;
+	uint64_t code = 0;
+	uint64_t sync = UINT64_MAX;
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		if (mp_typeof(*data) != MP_UINT)
+			return -1;
+		uint64_t key = mp_decode_uint(&data);
+		if (key == IPROTO_REQUEST_TYPE && mp_typeof(*data) == MP_UINT)
+			code = mp_decode_uint(&data);
+		else if (key == IPROTO_SYNC && mp_typeof(*data) == MP_UINT)
+			sync = mp_decode_uint(&data);
+		else
+			mp_next(&data);
+	}
+	if (sync >= (uint64_t)opts.pipeline)
+		return -1;
+	struct slot *slot = &conn->slots[sync];
+	struct request_stat *stat = &worker->stat[slot->type];
+	if (code != 0)
+		stat->errors++;
+	else
+		histogram_add(&stat->latency, now - slot->start_ns);
+	conn->free_slots[conn->free_count++] = sync;
+	return 0;
+}
+
+static int
+worker_read(struct worker *worker, struct connection *conn)
+{
+	ssize_t n = read(conn->fd, conn->rbuf + conn->rbuf_used,
+			 conn->rbuf_size - conn->rbuf_used);
+	if (n < 0) {
+		if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
+		perror("read");
+		return -1;
+	}
+	if (n == 0) {
+		fprintf(stderr, "connection closed by server\n");
+		return -1;
+	}
+	conn->rbuf_used += n;
+	uint64_t now = clock_ns();
+	const char *pos = conn->rbuf;
+	const char *end = conn->rbuf + conn->rbuf_used;
+	while (true) {
+		const char *data = pos;
+		if (data == end || mp_typeof(*data) != MP_UINT) {
+			if (data == end)
+				break;
+			fprintf(stderr, "malformed response\n");
+			return -1;
+		}
+		if (mp_check_uint(data, end) > 0)
+			break;
+		uint64_t len = mp_decode_uint(&data);
+		if (len > conn->rbuf_size / 2) {
+			fprintf(stderr, "response is too big\n");
+			return -1;
+		}
+		if ((uint64_t)(end - data) < len)
+			break;
+		if (worker_handle_response(worker, conn, data, now) != 0) {
+			fprintf(stderr, "malformed response\n");
+			return -1;
+		}
+		pos = data + len;
+	}
+	memmove(conn->rbuf, pos, end - pos);
+	conn->rbuf_used = end - pos;
+	return 0;
+}
+
+static void *
+worker_f(void *arg)
+{
+	struct worker *worker = arg;
+	struct pollfd *fds = calloc(worker->conn_count, sizeof(*fds));
+	if (fds == NULL) {
+		worker->failed = true;
+		return NULL;
+	}
+	uint64_t deadline = clock_ns() + opts.duration * 1e9;
+	while (clock_ns() < deadline) {
+		for (int i = 0; i < worker->conn_count; i++) {
+			struct connection *conn = &worker->conns[i];
+			worker_fill_pipeline(worker, conn);
+			if (worker_flush(conn) != 0)
+				goto fail;
+			fds[i].fd = conn->fd;
+			fds[i].events = POLLIN;
+			if (conn->wbuf_used > 0)
+				fds[i].events |= POLLOUT;
+			fds[i].revents = 0;
+		}
+		int rc = poll(fds, worker->conn_count, 100);
+		if (rc < 0 && errno != EINTR) {
+			perror("poll");
+			goto fail;
+		}
+		for (int i = 0; i < worker->conn_count && rc > 0; i++) {
+			if ((fds[i].revents & (POLLIN | POLLERR | POLLHUP)) &&
+			    worker_read(worker, &worker->conns[i]) != 0)
+				goto fail;
+		}
+	}
+	free(fds);
+	return NULL;
+fail:
+	worker->failed = true;
+	free(fds);
+	return NULL;
+}
+
+static void
+print_stat(const char *name, const struct request_stat *stat,
+	   double real_time, bool last)
+{
+	const struct histogram *hist = &stat->latency;
+	printf("{\"name\": \"%s\", \"requests\": %llu, \"errors\": %llu, "
+	       "\"real_time\": %.6f, \"p50\": %.3f, \"p90\": %.3f, "
+	       "\"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f}%s\n", name,
+	       (unsigned long long)hist->count,
+	       (unsigned long long)stat->errors, real_time,
+	       histogram_percentile(hist, 50) / 1e3,
+	       histogram_percentile(hist, 90) / 1e3,
+	       histogram_percentile(hist, 99) / 1e3,
+	       histogram_percentile(hist, 99.9) / 1e3,
+	       hist->max / 1e3, last ? "" : ",");
+}
+
+/** Parses the request mix option, e.g. "select:80,replace:20". */
+static int
+parse_mix(const char *str)
+{
+	unsigned weights[request_type_MAX] = {0};
+	char *copy = strdup(str);
+	char *saveptr;
+	for (char *tok = strtok_r(copy, ",", &saveptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &saveptr)) {
+		char *colon = strchr(tok, ':');
+		unsigned weight = 1;
+		if (colon != NULL) {
+			*colon = '\0';
+			weight = atoi(colon + 1);
+		}
+		int i;
+		for (i = 0; i < request_type_MAX; i++) {
+			if (strcmp(tok, request_type_strs[i]) == 0)
+				break;
+		}
+		if (i == request_type_MAX) {
+			fprintf(stderr, "unknown request type: %s\n", tok);
+			free(copy);
+			return -1;
+		}
+		weights[i] = weight;
+	}
+	free(copy);
+	opts.mix_total = 0;
+	for (int i = 0; i < request_type_MAX; i++) {
+		opts.mix_total += weights[i];
+		opts.mix[i] = opts.mix_total;
+	}
+	if (opts.mix_total == 0) {
+		fprintf(stderr, "empty request mix\n");
+		return -1;
+	}
+	return 0;
+}
+
+static void
+usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  --host <string, 127.0.0.1>  - server host\n"
+		"  --port <string, 3301>       - server port\n"
+		"  --connections <number, 10>  - number of connections\n"
+		"  --threads <number, 2>       - number of worker threads\n"
+		"  --pipeline <number, 10>     - requests in flight per "
+		"connection\n"
+		"  --duration <number, 10>     - test duration in seconds\n"
+		"  --space_id <number, 512>    - space to send requests to\n"
+		"  --keys <number, 100000>     - number of distinct keys\n"
+		"  --payload <number, 100>     - size of replaced tuples "
+		"payload\n"
+		"  --mix <string, select:80,replace:20>\n"
+		"                              - request mix, types: select, "
+		"replace, ping\n", prog);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const struct option longopts[] = {
+		{"host", required_argument, NULL, 'H'},
+		{"port", required_argument, NULL, 'P'},
+		{"connections", required_argument, NULL, 'c'},
+		{"threads", required_argument, NULL, 't'},
+		{"pipeline", required_argument, NULL, 'p'},
+		{"duration", required_argument, NULL, 'd'},
+		{"space_id", required_argument, NULL, 's'},
+		{"keys", required_argument, NULL, 'k'},
+		{"payload", required_argument, NULL, 'l'},
+		{"mix", required_argument, NULL, 'm'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0},
+	};
+	const char *mix = "select:80,replace:20";
+	int opt;
+	while ((opt = getopt_long(argc, argv, "h", longopts, NULL)) != -1) {
+		switch (opt) {
+		case 'H': opts.host = optarg; break;
+		case 'P': opts.port = optarg; break;
+		case 'c': opts.connections = atoi(optarg); break;
+		case 't': opts.threads = atoi(optarg); break;
+		case 'p': opts.pipeline = atoi(optarg); break;
+		case 'd': opts.duration = atof(optarg); break;
+		case 's': opts.space_id = strtoul(optarg, NULL, 10); break;
+		case 'k': opts.keys = strtoull(optarg, NULL, 10); break;
+		case 'l': opts.payload = strtoul(optarg, NULL, 10); break;
+		case 'm': mix = optarg; break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (opts.connections <= 0 || opts.threads <= 0 ||
+	    opts.pipeline <= 0 || opts.duration <= 0 || opts.keys == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+	if (parse_mix(mix) != 0)
+		return 1;
+	if (opts.threads > opts.connections)
+		opts.threads = opts.connections;
+
+	struct connection *conns = calloc(opts.connections, sizeof(*conns));
+	struct worker *workers = calloc(opts.threads, sizeof(*workers));
+	if (conns == NULL || workers == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	int rc = 1;
+	for (int i = 0; i < opts.connections; i++)
+		conns[i].fd = -1;
+	for (int i = 0; i < opts.connections; i++) {
+		if (connection_connect(&conns[i]) != 0)
+			goto out;
+	}
+	int conns_per_worker = opts.connections / opts.threads;
+	for (int i = 0; i < opts.threads; i++) {
+		struct worker *worker = &workers[i];
+		worker->conns = &conns[i * conns_per_worker];
+		worker->conn_count = i < opts.threads - 1 ? conns_per_worker :
+				     opts.connections - i * conns_per_worker;
+		worker->rand_state = 0x9E3779B97F4A7C15ULL * (i + 1);
+	}
+	uint64_t start = clock_ns();
+	for (int i = 0; i < opts.threads; i++) {
+		if (pthread_create(&workers[i].thread, NULL, worker_f,
+				   &workers[i]) != 0) {
+			perror("pthread_create");
+			/* Wait for the threads that have been started. */
+			opts.threads = i;
+			break;
+		}
+	}
+	bool failed = false;
+	for (int i = 0; i < opts.threads; i++) {
+		pthread_join(workers[i].thread, NULL);
+		failed = failed || workers[i].failed;
+	}
+	double real_time = (clock_ns() - start) / 1e9;
+	if (failed)
+		goto out;
+
+	struct request_stat total;
+	memset(&total, 0, sizeof(total));
+	printf("[\n");
+	for (int type = 0; type < request_type_MAX; type++) {
+		struct request_stat stat;
+		memset(&stat, 0, sizeof(stat));
+		for (int i = 0; i < opts.threads; i++) {
+			histogram_merge(&stat.latency,
+					&workers[i].stat[type].latency);
+			stat.errors += workers[i].stat[type].errors;
+		}
+		histogram_merge(&total.latency, &stat.latency);
+		total.errors += stat.errors;
+		if (stat.latency.count + stat.errors > 0)
+			print_stat(request_type_strs[type], &stat,
+				   real_time, false);
+	}
+	print_stat("total", &total, real_time, true);
+	printf("]\n");
+	rc = 0;
+out:
+	for (int i = 0; i < opts.connections; i++)
+		connection_close(&conns[i]);
+	free(conns);
+	free(workers);
+	return rc;
+}
@@ -0,0 +1,93 @@
+--
+-- The test measures merger throughput for various source counts.
+--
+-- Output format (console):
+-- <test-case> <items-per-second>
+
+local buffer = require('buffer')
+local clock = require('clock')
+local key_def = require('key_def')
+local merger = require('merger')
+local msgpack = require('msgpack')
+local benchmark = require('benchmark')
+
+local USAGE = [[
+   sources <number, 200>    - maximal number of merge sources
+   tuples <number, 200000>  - total number of tuples to merge
+
+ Being run without options, this benchmark measures the throughput of
+ merging table and buffer sources for 2, 16 and 200 sources.
+]]
+
+local params = benchmark.argparse(arg, {
+    {'sources', 'number'},
+    {'tuples', 'number'},
+}, USAGE)
+
+local bench = benchmark.new(params)
+
+local MAX_SOURCES = params.sources or 200
+local TUPLE_COUNT = params.tuples or 2e5
+
+local kd = key_def.new({{fieldno = 1, type = 'unsigned'}})
+
+-- Tuples are distributed over sources round-robin so that every
+-- source is chosen in turn, which is the worst case for a merger.
+local function gen_tuples(source_count)
+    local tuples = {}
+    for i = 1, source_count do
+        tuples[i] = {}
+    end
+    for i = 1, TUPLE_COUNT do
+        local source = tuples[i % source_count + 1]
+        table.insert(source, box.tuple.new({i, 'data' .. i}))
+    end
+    return tuples
+end
+
+local function new_table_sources(tuples)
+    local sources = {}
+    for i, source_tuples in ipairs(tuples) do
+        sources[i] = merger.new_source_fromtable(source_tuples)
+    end
+    return sources
+end
+
+local function new_buffer_sources(tuples)
+    local sources = {}
+    for i, source_tuples in ipairs(tuples) do
+        local buf = buffer.ibuf()
+        msgpack.encode(source_tuples, buf)
+        sources[i] = merger.new_source_frombuffer(buf)
+    end
+    return sources
+end
+
+local function run_test(name, tuples, new_sources)
+    local sources = new_sources(tuples)
+    local m = merger.new(kd, sources)
+    local count = 0
+    local real_time = clock.time()
+    local cpu_time = clock.proc()
+    for _, _ in m:pairs() do
+        count = count + 1
+    end
+    local real_delta = clock.time() - real_time
+    local cpu_delta = clock.proc() - cpu_time
+    assert(count == TUPLE_COUNT)
+    bench:add_result(name, {
+        real_time = real_delta,
+        cpu_time = cpu_delta,
+        items = count,
+    })
+end
+
+for _, source_count in ipairs({2, 16, MAX_SOURCES}) do
+    local tuples = gen_tuples(source_count)
+    run_test(('table_%d'):format(source_count), tuples, new_table_sources)
+    run_test(('buffer_%d'):format(source_count), tuples, new_buffer_sources)
+end
+
+bench:dump_results()
+
+os.exit(0)
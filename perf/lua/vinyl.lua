@@ -0,0 +1,253 @@
+--
+-- The test measures vinyl throughput under YCSB-like workloads and reports
+-- write, read and space amplification. The memory limit is small so that
+-- the workloads trigger dumps and compaction.
+--
+-- Test cases:
+-- * load: insert all keys in random order.
+-- * a: 50% point lookups, 50% replaces.
+-- * b: 95% point lookups, 5% replaces.
+-- * e: 95% short range scans, 5% replaces.
+--
+-- The keys are chosen with the zipfian distribution.
+--
+-- Output format (console):
+-- <test-case> <operations-per-second>
+--
+-- The JSON output includes the following counters:
+-- * write_amp: bytes written to disk by dump and compaction divided by
+--   bytes dumped from memory.
+-- * read_amp: statements read from disk divided by statements returned
+--   to the user.
+-- * space_amp: size of the data on disk divided by size of live data.
+-- * dump_count, compaction_count: number of dumps and compactions.
+--
+
+local clock = require('clock')
+local fiber = require('fiber')
+local fio = require('fio')
+local msgpack = require('msgpack')
+local benchmark = require('benchmark')
+
+local USAGE = [[
+   cache <number, 0>          - vinyl tuple cache size in bytes
+   fibers <number, 10>        - number of fibers issuing requests
+   keys <number, 1000000>     - number of keys in the test space
+   memory <number, 67108864>  - vinyl memory limit in bytes
+   ops <number, 1000000>      - number of operations in a workload
+   payload <number, 100>      - size of a tuple payload in bytes
+   pattern <string>           - run only workloads matching the pattern;
+                                it's possible to specify more than one
+                                pattern separated by '|', for example, 'a|b'
+   scan_limit <number, 20>    - number of tuples read by a range scan
+   zipf_theta <number, 0.99>  - skew of the zipfian key distribution
+
+ Being run without options, this benchmark loads one million keys and runs
+ YCSB workloads A, B and E over the loaded data with the cache disabled.
+]]
+
+local params = benchmark.argparse(arg, {
+    {'cache', 'number'},
+    {'fibers', 'number'},
+    {'keys', 'number'},
+    {'memory', 'number'},
+    {'ops', 'number'},
+    {'payload', 'number'},
+    {'pattern', 'string'},
+    {'scan_limit', 'number'},
+    {'zipf_theta', 'number'},
+}, USAGE)
+
+params.cache = params.cache or 0
+params.fibers = params.fibers or 10
+params.keys = params.keys or 1000000
+params.memory = params.memory or 64 * 1024 * 1024
+params.ops = params.ops or 1000000
+params.payload = params.payload or 100
+params.scan_limit = params.scan_limit or 20
+params.zipf_theta = params.zipf_theta or 0.99
+if params.pattern then
+    params.pattern = string.split(params.pattern, '|')
+end
+
+local bench = benchmark.new(params)
+
+local test_dir = fio.tempdir()
+
+box.cfg({
+    log_level = 'error',
+    work_dir = test_dir,
+    vinyl_memory = params.memory,
+    vinyl_cache = params.cache,
+})
+
+local space = box.schema.space.create('test', {engine = 'vinyl'})
+space:create_index('pk')
+local payload = string.rep('x', params.payload)
+local tuple_size = #msgpack.encode({params.keys, payload})
+
+--
+-- Zipfian generator of keys in range [1, n] as described in "Quickly
+-- Generating Billion-Record Synthetic Databases" by Jim Gray et al.
+-- The generated values are scrambled so that the hot keys are spread
+-- over the key space rather than clustered at its beginning.
+--
+local function zipfian_generator(n, theta)
+    local zetan = 0
+    for i = 1, n do
+        zetan = zetan + 1 / i ^ theta
+    end
+    local zeta2 = 1 + 1 / 2 ^ theta
+    local alpha = 1 / (1 - theta)
+    local eta = (1 - (2 / n) ^ (1 - theta)) / (1 - zeta2 / zetan)
+    return function()
+        local u = math.random()
+        local uz = u * zetan
+        local rank
+        if uz < 1 then
+            rank = 0
+        elseif uz < zeta2 then
+            rank = 1
+        else
+            rank = math.floor(n * (eta * u - eta + 1) ^ alpha)
+        end
+        -- 2654435761 is the golden ratio multiplier of Knuth's
+        -- multiplicative hash.
+        return (rank * 2654435761) % n + 1
+    end
+end
+
+local next_key = zipfian_generator(params.keys, params.zipf_theta)
+
+local function get()
+    space:get(next_key())
+end
+
+local function replace()
+    space:replace({next_key(), payload})
+end
+
+local function scan()
+    space:select(next_key(), {iterator = 'ge', limit = params.scan_limit})
+end
+
+--
+-- Array of workloads. A workload is represented by a table with the
+-- following fields:
+--
+-- * name: workload name
+-- * mix: array of {operation, percentage}
+--
+local WORKLOADS = {
+    {name = 'a', mix = {{get, 50}, {replace, 50}}},
+    {name = 'b', mix = {{get, 95}, {replace, 5}}},
+    {name = 'e', mix = {{scan, 95}, {replace, 5}}},
+}
+
+-- Waits for all dumps and compactions in progress to complete.
+local function wait_scheduler()
+    box.snapshot()
+    while true do
+        local stat = box.stat.vinyl().scheduler
+        if stat.tasks_inprogress == 0 and stat.compaction_queue == 0 then
+            break
+        end
+        fiber.sleep(0.01)
+    end
+end
+
+-- Runs the given function in params.fibers fibers and returns the
+-- real and CPU time it took to run it.
+local function run_fibers(count, func)
+    local fibers = {}
+    local start_time = clock.monotonic()
+    local start_cpu_time = clock.proc()
+    for i = 1, params.fibers do
+        local f = fiber.new(function()
+            for j = i, count, params.fibers do
+                func(j)
+            end
+        end)
+        f:set_joinable(true)
+        table.insert(fibers, f)
+    end
+    for _, f in ipairs(fibers) do
+        assert(f:join())
+    end
+    return clock.monotonic() - start_time, clock.proc() - start_cpu_time
+end
+
+-- Computes the result counters from the index statistics collected
+-- before and after running a workload.
+local function amplification(before, after)
+    local function delta(path)
+        local a, b = after, before
+        for _, k in ipairs(path) do
+            a, b = a[k], b[k]
+        end
+        return a - b
+    end
+    local dump_input = delta({'disk', 'dump', 'input', 'bytes'})
+    local written = delta({'disk', 'dump', 'output', 'bytes'}) +
+                    delta({'disk', 'compaction', 'output', 'bytes'})
+    local returned = delta({'get', 'rows'})
+    local read = delta({'disk', 'iterator', 'read', 'rows'})
+    return {
+        write_amp = dump_input > 0 and written / dump_input or 0,
+        read_amp = returned > 0 and read / returned or 0,
+        space_amp = after.disk.bytes / (params.keys * tuple_size),
+        dump_count = delta({'disk', 'dump', 'count'}),
+        compaction_count = delta({'disk', 'compaction', 'count'}),
+    }
+end
+
+local function run_workload(name, count, func)
+    local before = space.index.pk:stat()
+    local real_time, cpu_time = run_fibers(count, func)
+    wait_scheduler()
+    bench:add_result(name, {
+        items = count,
+        real_time = real_time,
+        cpu_time = cpu_time,
+        counters = amplification(before, space.index.pk:stat()),
+    })
+end
+
+local function matches_pattern(name)
+    if params.pattern == nil then
+        return true
+    end
+    for _, pattern in ipairs(params.pattern) do
+        if name:match(pattern) then
+            return true
+        end
+    end
+    return false
+end
+
+-- The load phase inserts the keys in a pseudo-random order so that
+-- dumped runs overlap and have to be compacted.
+run_workload('load', params.keys, function(i)
+    space:replace({(i * 2654435761) % params.keys + 1, payload})
+end)
+
+for _, workload in ipairs(WORKLOADS) do
+    if matches_pattern(workload.name) then
+        -- Build a table of operations for a random operation choice.
+        local ops = {}
+        for _, op in ipairs(workload.mix) do
+            for _ = 1, op[2] do
+                table.insert(ops, op[1])
+            end
+        end
+        run_workload(workload.name, params.ops, function()
+            ops[math.random(#ops)]()
+        end)
+    end
+end
+
+bench:dump_results()
+
+space:drop()
+fio.rmtree(test_dir)
+os.exit(0)
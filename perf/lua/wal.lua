@@ -0,0 +1,180 @@
+--
+-- The test measures throughput of transactions written to the WAL and
+-- speed of recovery from the written WAL files.
+--
+-- Test cases:
+-- * write: fibers commit transactions of replaces to a memtx space.
+-- * recovery: a new instance recovers from a copy of the WAL files written
+--   by the write test case. It's measured in rows per second, the JSON
+--   output also includes the throughput of WAL reading in bytes per second.
+--
+-- Output format (console):
+-- <test-case> <rows-per-second>
+--
+
+local clock = require('clock')
+local fiber = require('fiber')
+local fio = require('fio')
+local json = require('json')
+local popen = require('popen')
+local benchmark = require('benchmark')
+
+local USAGE = [[
+   fibers <number, 50>                   - number of fibers committing
+                                           transactions
+   ops <number, 1000000>                 - total number of replaces
+   payload <number, 100>                 - size of a tuple payload in bytes
+   recovery <boolean, false>             - also measure recovery from the
+                                           written WAL files
+   transaction <number, 10>              - number of replaces in one
+                                           transaction
+   wal_mode <string, 'write'>            - WAL synchronization mode
+   wal_queue_max_size <number, 16777216> - WAL queue size limit in bytes
+
+ Being run without options, this benchmark measures throughput of 50 fibers
+ committing transactions of 10 replaces each to the WAL in the write mode.
+]]
+
+local params = benchmark.argparse(arg, {
+    {'fibers', 'number'},
+    {'ops', 'number'},
+    {'payload', 'number'},
+    {'recovery', 'boolean'},
+    {'transaction', 'number'},
+    {'wal_mode', 'string'},
+    {'wal_queue_max_size', 'number'},
+}, USAGE)
+
+params.fibers = params.fibers or 50
+params.ops = params.ops or 1000000
+params.payload = params.payload or 100
+params.transaction = params.transaction or 10
+params.wal_mode = params.wal_mode or 'write'
+params.wal_queue_max_size = params.wal_queue_max_size or 16 * 1024 * 1024
+
+local bench = benchmark.new(params)
+
+local test_dir = fio.tempdir()
+
+box.cfg({
+    log_level = 'error',
+    work_dir = test_dir,
+    wal_mode = params.wal_mode,
+    wal_queue_max_size = params.wal_queue_max_size,
+    memtx_memory = 2 * 1024 * 1024 * 1024,
+    -- Keep all the rows in the WAL for the recovery test case.
+    checkpoint_interval = 0,
+})
+
+local space = box.schema.space.create('test')
+space:create_index('pk')
+local payload = string.rep('x', params.payload)
+
+local function fiber_load(first, count)
+    local i = first
+    local last = first + count - 1
+    while i <= last do
+        box.begin()
+        for _ = 1, params.transaction do
+            if i > last then
+                break
+            end
+            space:replace({i, payload})
+            i = i + 1
+        end
+        box.commit()
+    end
+end
+
+local ops_per_fiber = math.ceil(params.ops / params.fibers)
+local fibers = {}
+local start_time = clock.monotonic()
+local start_cpu_time = clock.proc()
+for i = 1, params.fibers do
+    local f = fiber.new(fiber_load, (i - 1) * ops_per_fiber + 1,
+                        ops_per_fiber)
+    f:set_joinable(true)
+    table.insert(fibers, f)
+end
+for _, f in ipairs(fibers) do
+    assert(f:join())
+end
+local ops = ops_per_fiber * params.fibers
+bench:add_result('write_' .. params.wal_mode, {
+    items = ops,
+    real_time = clock.monotonic() - start_time,
+    cpu_time = clock.proc() - start_cpu_time,
+})
+
+-- Runs a new instance recovering from a copy of the WAL files and returns
+-- the time it took to recover.
+local function recover()
+    local recovery_dir = fio.tempdir()
+    local wal_size = 0
+    for _, path in ipairs(fio.glob(fio.pathjoin(test_dir, '*.xlog'))) do
+        assert(fio.copyfile(path, recovery_dir))
+        wal_size = wal_size + fio.stat(path).size
+    end
+    for _, path in ipairs(fio.glob(fio.pathjoin(test_dir, '*.snap'))) do
+        assert(fio.copyfile(path, recovery_dir))
+    end
+    local script = [[
+        local clock = require('clock')
+        local json = require('json')
+        local start_time = clock.monotonic()
+        local start_cpu_time = clock.proc()
+        box.cfg({
+            log_level = 'error',
+            work_dir = arg[1],
+            memtx_memory = 2 * 1024 * 1024 * 1024,
+        })
+        io.stdout:write(json.encode({
+            real_time = clock.monotonic() - start_time,
+            cpu_time = clock.proc() - start_cpu_time,
+            rows = box.space.test:len(),
+        }))
+        os.exit(0)
+    ]]
+    local script_path = fio.pathjoin(recovery_dir, 'recover.lua')
+    local fh = assert(fio.open(script_path, {'O_WRONLY', 'O_CREAT'}, 420))
+    fh:write(script)
+    fh:close()
+    local ph = assert(popen.new({arg[-1], script_path, recovery_dir},
+                                {stdin = popen.opts.DEVNULL,
+                                 stdout = popen.opts.PIPE}))
+    local output = {}
+    while true do
+        local chunk = assert(ph:read())
+        if chunk == '' then
+            break
+        end
+        table.insert(output, chunk)
+    end
+    local status = ph:wait()
+    ph:close()
+    fio.rmtree(recovery_dir)
+    if status.exit_code ~= 0 then
+        error('Recovery failed with exit code ' .. tostring(status.exit_code))
+    end
+    local res = json.decode(table.concat(output))
+    assert(res.rows == ops)
+    return res, wal_size
+end
+
+if params.recovery then
+    local res, wal_size = recover()
+    bench:add_result('recovery', {
+        items = ops,
+        real_time = res.real_time,
+        cpu_time = res.cpu_time,
+        counters = {
+            bytes_per_second = math.floor(wal_size / res.real_time),
+        },
+    })
+end
+
+bench:dump_results()
+
+space:drop()
+fio.rmtree(test_dir)
+os.exit(0)
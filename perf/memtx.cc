@@ -352,7 +352,8 @@ BENCHMARK_F(MemtxFixture, TreeSelectAll)
 		benchmark::DoNotOptimize(::box_select(
 			sid, tree_index_id, ITER_ALL, 0, select_lim,
 			empty_key.first, empty_key.second, &packed_pos,
-			&packed_pos_end, /*update_pos=*/false, &port));
+			&packed_pos_end, /*update_pos=*/false,
+			/*covering=*/false, &port));
 		counter += key_set_size;
 		state.PauseTiming();
 		::port_destroy(&port);
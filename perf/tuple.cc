@@ -2,6 +2,7 @@
 #include "fiber.h"
 #include "tuple.h"
 #include "memtx_engine.h"
+#include "tuple_hash.h"
 #include <allocator.h>
 
 #include <benchmark/benchmark.h>
@@ -574,6 +575,84 @@ tuple_tuple_compare_hint(benchmark::State& state)
 
 BENCHMARK_TEMPLATE(tuple_tuple_compare_hint, FORMAT_BASIC);
 
+// benchmark of tuple compare by a two-part (TYPE, STRING) key.
+template<data_format F, field_type TYPE>
+static void
+tuple_tuple_compare_multipart(benchmark::State& state)
+{
+	TestTuples<F> tuples;
+	size_t i = 0;
+	size_t j = 0;
+	struct key_part_def kdp[2] = {key_part_def_default,
+				      key_part_def_default};
+	kdp[0].fieldno = 0;
+	kdp[0].type = TYPE;
+	kdp[1].fieldno = 1;
+	kdp[1].type = FIELD_TYPE_STRING;
+	struct key_def *kd = key_def_new(kdp, 2, 0);
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		if (j >= NUM_TEST_TUPLES)
+			j -= NUM_TEST_TUPLES;
+		struct tuple *t1 = tuples[i];
+		struct tuple *t2 = tuples[j];
+		benchmark::DoNotOptimize(tuple_compare(t1, HINT_NONE,
+						       t2, HINT_NONE, kd));
+		++i;
+		j += 3;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	key_def_delete(kd);
+}
+
+BENCHMARK_TEMPLATE(tuple_tuple_compare_multipart, FORMAT_BASIC,
+		   FIELD_TYPE_UNSIGNED);
+BENCHMARK_TEMPLATE(tuple_tuple_compare_multipart, FORMAT_BASIC,
+		   FIELD_TYPE_INTEGER);
+
+// benchmark of tuple hash by a STRING or a (UNSIGNED, STRING) key.
+template<data_format F, uint32_t PART_COUNT, bool XXH3>
+static void
+tuple_tuple_hash(benchmark::State& state)
+{
+	TestTuples<F> tuples;
+	size_t i = 0;
+	struct key_part_def kdp[2] = {key_part_def_default,
+				      key_part_def_default};
+	kdp[0].fieldno = 0;
+	kdp[0].type = FIELD_TYPE_UNSIGNED;
+	kdp[1].fieldno = 1;
+	kdp[1].type = FIELD_TYPE_STRING;
+	struct key_def *kd = key_def_new(kdp + 2 - PART_COUNT, PART_COUNT, 0);
+	tuple_hash_t hash = kd->tuple_hash;
+	if (XXH3) {
+		key_hash_t unused;
+		key_def_get_xxh3_hash_func(kd, &hash, &unused);
+	}
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		benchmark::DoNotOptimize(hash(tuples[i], kd));
+		++i;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+	key_def_delete(kd);
+}
+
+BENCHMARK_TEMPLATE(tuple_tuple_hash, FORMAT_BASIC, 1, false);
+BENCHMARK_TEMPLATE(tuple_tuple_hash, FORMAT_BASIC, 1, true);
+BENCHMARK_TEMPLATE(tuple_tuple_hash, FORMAT_BASIC, 2, false);
+BENCHMARK_TEMPLATE(tuple_tuple_hash, FORMAT_BASIC, 2, true);
+
 BENCHMARK_MAIN();
 
 #include "debug_warning.h"
@@ -0,0 +1,306 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "box/key_def.h"
+#include "box/tuple.h"
+#include "box/vy_history.h"
+#include "box/vy_mem.h"
+#include "box/vy_read_view.h"
+#include "box/vy_stmt.h"
+
+extern "C" {
+#include "box/vy_write_iterator.h"
+}
+
+#include "core/fiber.h"
+#include "core/memory.h"
+#include "core/say.h"
+
+#include "small/lsregion.h"
+#include "small/mempool.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * This suite contains benchmarks for the in-memory building blocks of
+ * vinyl - Tarantool's on-disk storage engine: in-memory trees (vy_mem)
+ * searched by point lookups and range scans and the write iterator that
+ * merges in-memory trees on dump.
+ *
+ * The dataset consists of {uint, uint} tuples with the primary key on the
+ * first field. Benchmarks of the whole engine, including disk lookups,
+ * dump and compaction, live in perf/lua/vinyl.lua.
+ */
+
+/** Memory limit of the vinyl memory environment. */
+static constexpr std::size_t vy_memory = 1ull << 30;
+/** Number of keys in the in-memory tree used for lookups. */
+static constexpr std::size_t lookup_key_count = 1 << 20;
+/** Number of tuples returned by one range scan. */
+static constexpr std::size_t range_scan_limit = 100;
+
+/**
+ * The vinyl singleton initializes the subsystems required by vinyl
+ * statements, in-memory trees and iterators.
+ */
+class Vinyl final {
+public:
+	Vinyl(Vinyl &other) = delete;
+	Vinyl &operator=(Vinyl &other) = delete;
+
+	static Vinyl &
+	instance()
+	{
+		static Vinyl instance;
+		return instance;
+	}
+
+	struct key_def *
+	key_def()
+	{
+		return cmp_def;
+	}
+
+	struct mempool *
+	history_pool()
+	{
+		return &history_node_pool;
+	}
+
+	/** Create an in-memory tree filled with @a count random tuples. */
+	struct vy_mem *
+	new_mem(std::size_t count, std::size_t key_count)
+	{
+		struct vy_mem *mem = vy_mem_new(&mem_env, cmp_def, format,
+						++generation, 0);
+		if (mem == NULL)
+			abort();
+		std::uniform_int_distribution<std::uint64_t>
+			key_dist(0, key_count - 1);
+		for (std::size_t i = 0; i < count; i++)
+			insert(mem, key_dist(rng), i);
+		return mem;
+	}
+
+	/** Create an in-memory tree with keys [0, count). */
+	struct vy_mem *
+	new_sequential_mem(std::size_t count)
+	{
+		struct vy_mem *mem = vy_mem_new(&mem_env, cmp_def, format,
+						++generation, 0);
+		if (mem == NULL)
+			abort();
+		for (std::size_t i = 0; i < count; i++)
+			insert(mem, i, i);
+		return mem;
+	}
+
+	/** Delete in-memory trees and free the memory used by them. */
+	void
+	delete_mems(std::vector<struct vy_mem *> &mems)
+	{
+		for (struct vy_mem *mem : mems)
+			vy_mem_delete(mem);
+		mems.clear();
+		lsregion_gc(&mem_env.allocator, generation);
+	}
+
+	/** Create a key statement for the given key. */
+	struct vy_entry
+	new_key(std::uint64_t key)
+	{
+		char buf[16];
+		mp_encode_uint(buf, key);
+		struct vy_entry entry = vy_entry_key_new(stmt_env.key_format,
+							 cmp_def, buf, 1);
+		if (entry.stmt == NULL)
+			abort();
+		return entry;
+	}
+
+	std::mt19937_64 rng;
+
+private:
+	Vinyl()
+	{
+		say_set_log_level(S_WARN);
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		tuple_init(NULL);
+		vy_stmt_env_create(&stmt_env);
+		vy_mem_env_create(&mem_env, vy_memory);
+		mempool_create(&history_node_pool, cord_slab_cache(),
+			       sizeof(struct vy_history_node));
+
+		std::uint32_t fields[] = {0};
+		std::uint32_t types[] = {FIELD_TYPE_UNSIGNED};
+		cmp_def = box_key_def_new(fields, types, 1);
+		if (cmp_def == NULL)
+			abort();
+		format = vy_simple_stmt_format_new(&stmt_env, &cmp_def, 1);
+		if (format == NULL)
+			abort();
+		tuple_format_ref(format);
+	}
+
+	~Vinyl()
+	{
+		tuple_format_unref(format);
+		key_def_delete(cmp_def);
+		mempool_destroy(&history_node_pool);
+		vy_mem_env_destroy(&mem_env);
+		vy_stmt_env_destroy(&stmt_env);
+		tuple_free();
+		fiber_free();
+		memory_free();
+	}
+
+	void
+	insert(struct vy_mem *mem, std::uint64_t key, std::uint64_t value)
+	{
+		char buf[32];
+		char *end = mp_encode_array(buf, 2);
+		end = mp_encode_uint(end, key);
+		end = mp_encode_uint(end, value);
+		struct tuple *stmt = vy_stmt_new_replace(format, buf, end);
+		if (stmt == NULL)
+			abort();
+		vy_stmt_set_lsn(stmt, ++lsn);
+		struct vy_entry entry;
+		entry.stmt = vy_stmt_dup_lsregion(stmt, &mem_env.allocator,
+						  mem->generation);
+		tuple_unref(stmt);
+		if (entry.stmt == NULL)
+			abort();
+		entry.hint = vy_stmt_hint(entry.stmt, cmp_def);
+		if (vy_mem_insert(mem, entry) != 0)
+			abort();
+	}
+
+	struct vy_stmt_env stmt_env;
+	struct vy_mem_env mem_env;
+	struct mempool history_node_pool;
+	struct key_def *cmp_def;
+	struct tuple_format *format;
+	std::int64_t generation = 0;
+	std::int64_t lsn = 0;
+};
+
+/**
+ * Merge in-memory trees with the write iterator like a dump does. The
+ * trees contain overwrites of the same keys so the iterator has to squash
+ * the history of each key. range(0) is the number of trees, range(1) is
+ * the number of statements in each tree.
+ */
+static void
+bench_write_iterator_merge(benchmark::State &state)
+{
+	Vinyl &vinyl = Vinyl::instance();
+	std::size_t mem_count = state.range(0);
+	std::size_t mem_size = state.range(1);
+	std::vector<struct vy_mem *> mems;
+	for (std::size_t i = 0; i < mem_count; i++)
+		mems.push_back(vinyl.new_mem(mem_size, mem_size));
+	struct rlist read_views;
+	rlist_create(&read_views);
+	std::size_t output = 0;
+	for (auto _ : state) {
+		struct vy_stmt_stream *wi = vy_write_iterator_new(
+			vinyl.key_def(), /*is_primary=*/true,
+			/*is_last_level=*/true, &read_views, NULL);
+		if (wi == NULL)
+			abort();
+		for (struct vy_mem *mem : mems) {
+			if (vy_write_iterator_new_mem(wi, mem) != 0)
+				abort();
+		}
+		if (wi->iface->start(wi) != 0)
+			abort();
+		struct vy_entry entry;
+		while (true) {
+			if (wi->iface->next(wi, &entry) != 0)
+				abort();
+			if (entry.stmt == NULL)
+				break;
+			output++;
+		}
+		wi->iface->stop(wi);
+		wi->iface->close(wi);
+	}
+	state.SetItemsProcessed(state.iterations() * mem_count * mem_size);
+	state.counters["output_ratio"] = (double)output /
+		(state.iterations() * mem_count * mem_size);
+	vinyl.delete_mems(mems);
+}
+
+BENCHMARK(bench_write_iterator_merge)
+	->ArgsProduct({{1, 2, 4, 8}, {1 << 16, 1 << 18}})
+	->Unit(benchmark::kMillisecond);
+
+/**
+ * Iterate over an in-memory tree with keys [0, lookup_key_count) starting
+ * from a random key and read up to @a limit keys.
+ */
+static void
+mem_iterate(benchmark::State &state, enum iterator_type type,
+	    std::size_t limit)
+{
+	Vinyl &vinyl = Vinyl::instance();
+	std::vector<struct vy_mem *> mems;
+	mems.push_back(vinyl.new_sequential_mem(lookup_key_count));
+	std::vector<struct vy_entry> keys;
+	std::uniform_int_distribution<std::uint64_t>
+		key_dist(0, lookup_key_count - 1);
+	for (std::size_t i = 0; i < lookup_key_count; i++)
+		keys.push_back(vinyl.new_key(key_dist(vinyl.rng)));
+	struct vy_read_view rv;
+	rv.vlsn = INT64_MAX;
+	const struct vy_read_view *prv = &rv;
+	struct vy_mem_iterator_stat stat;
+	memset(&stat, 0, sizeof(stat));
+	struct vy_history history;
+	vy_history_create(&history, vinyl.history_pool());
+	std::size_t i = 0;
+	std::size_t found = 0;
+	for (auto _ : state) {
+		struct vy_mem_iterator it;
+		vy_mem_iterator_open(&it, &stat, mems[0], type,
+				     keys[i++ % keys.size()], &prv,
+				     /*is_prepared_ok=*/false);
+		for (std::size_t j = 0; j < limit; j++) {
+			if (vy_mem_iterator_next(&it, &history) != 0)
+				abort();
+			if (rlist_empty(&history.stmts))
+				break;
+			found++;
+			vy_history_cleanup(&history);
+		}
+		vy_history_cleanup(&history);
+		vy_mem_iterator_close(&it);
+	}
+	state.SetItemsProcessed(found);
+	for (struct vy_entry &key : keys)
+		tuple_unref(key.stmt);
+	vinyl.delete_mems(mems);
+}
+
+static void
+bench_mem_point_lookup(benchmark::State &state)
+{
+	mem_iterate(state, ITER_EQ, 1);
+}
+
+BENCHMARK(bench_mem_point_lookup);
+
+static void
+bench_mem_range_scan(benchmark::State &state)
+{
+	mem_iterate(state, ITER_GE, range_scan_limit);
+}
+
+BENCHMARK(bench_mem_range_scan);
+
+BENCHMARK_MAIN();
+
+#include "debug_warning.h"
@@ -0,0 +1,264 @@
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "box/iproto_constants.h"
+#include "box/xlog.h"
+#include "box/xrow.h"
+
+#include "core/memory.h"
+#include "core/random.h"
+
+#include "crc32.h"
+#include "trivia/util.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * This suite contains benchmarks for xlog files - the format of Tarantool's
+ * write ahead log, snapshots and vinyl runs: writing transactions with and
+ * without compression and syncing, and reading them back with a cursor the
+ * way recovery does.
+ *
+ * The rows written are INSERT requests of {uint, bin} tuples. A quarter of
+ * the binary payload is random, the rest is a repeated pattern, so zstd
+ * squeezes the compressed transactions somewhat like real tuples.
+ */
+
+/** Size of an xlog file read by the cursor benchmarks. */
+static constexpr std::size_t read_file_size = 64 * 1024 * 1024;
+
+/**
+ * The xlog singleton initializes the subsystems required by xlog files and
+ * owns the temporary directory the benchmark files are created in.
+ */
+class Xlog final {
+public:
+	Xlog(Xlog &other) = delete;
+	Xlog &operator=(Xlog &other) = delete;
+
+	static Xlog &
+	instance()
+	{
+		static Xlog instance;
+		return instance;
+	}
+
+	/** Create a new xlog file in the temporary directory. */
+	void
+	create(struct xlog *xlog, bool compressed)
+	{
+		struct xlog_opts opts = xlog_opts_default;
+		opts.no_compression = !compressed;
+		struct xdir xdir;
+		xdir_create(&xdir, dirname, XLOG, &instance_uuid, &opts);
+		if (xdir_create_xlog(&xdir, xlog, &vclock) != 0)
+			abort();
+		xdir_destroy(&xdir);
+		vclock_inc(&vclock, 0);
+	}
+
+	/** Close an xlog file and remove it. */
+	void
+	remove(struct xlog *xlog)
+	{
+		std::string filename = xlog->filename;
+		if (xlog_close(xlog) != 0)
+			abort();
+		unlink(filename.c_str());
+	}
+
+	/** Encode a tuple with a payload of the given size. */
+	std::vector<char>
+	tuple(std::size_t payload_size)
+	{
+		std::vector<char> data(payload_size + 16);
+		char *pos = mp_encode_array(data.data(), 2);
+		pos = mp_encode_uint(pos, payload_size);
+		pos = mp_encode_binl(pos, payload_size);
+		std::size_t random_size = payload_size / 4;
+		random_bytes(pos, random_size);
+		for (std::size_t i = random_size; i < payload_size; i++)
+			pos[i] = 'a' + i % 16;
+		pos += payload_size;
+		data.resize(pos - data.data());
+		return data;
+	}
+
+	/** Write an INSERT row with the given tuple to an xlog. */
+	void
+	write_row(struct xlog *xlog, const std::vector<char> &tuple)
+	{
+		struct request_replace_body body;
+		request_replace_body_create(&body, 512);
+		struct xrow_header row;
+		memset(&row, 0, sizeof(row));
+		row.type = IPROTO_INSERT;
+		row.lsn = ++lsn;
+		row.bodycnt = 2;
+		row.body[0].iov_base = &body;
+		row.body[0].iov_len = sizeof(body);
+		row.body[1].iov_base = (void *)tuple.data();
+		row.body[1].iov_len = tuple.size();
+		if (xlog_write_row(xlog, &row) < 0)
+			abort();
+	}
+
+private:
+	Xlog()
+	{
+		crc32_init();
+		memory_init();
+		random_init();
+		strlcpy(dirname, "./xlog.XXXXXX", sizeof(dirname));
+		if (mkdtemp(dirname) == NULL)
+			abort();
+		memset(&instance_uuid, 1, sizeof(instance_uuid));
+		vclock_create(&vclock);
+	}
+
+	~Xlog()
+	{
+		rmdir(dirname);
+		random_free();
+		memory_free();
+	}
+
+	char dirname[PATH_MAX];
+	struct tt_uuid instance_uuid;
+	struct vclock vclock;
+	std::int64_t lsn = 0;
+};
+
+/**
+ * Write transactions to an xlog file. range(0) is the tuple payload size,
+ * range(1) is the number of rows in a transaction. If @a sync is set, the
+ * file is synced after each transaction like the WAL does in the fsync
+ * mode.
+ */
+static void
+bench_xlog_write(benchmark::State &state, bool compressed, bool sync)
+{
+	Xlog &x = Xlog::instance();
+	std::size_t payload_size = state.range(0);
+	std::size_t tx_size = state.range(1);
+	std::vector<char> tuple = x.tuple(payload_size);
+	struct xlog xlog;
+	x.create(&xlog, compressed);
+	for (auto _ : state) {
+		xlog_tx_begin(&xlog);
+		for (std::size_t i = 0; i < tx_size; i++)
+			x.write_row(&xlog, tuple);
+		if (xlog_tx_commit(&xlog) < 0)
+			abort();
+		if (sync && xlog_datasync(&xlog) != 0)
+			abort();
+	}
+	state.SetItemsProcessed(state.iterations() * tx_size);
+	state.SetBytesProcessed(state.iterations() * tx_size * tuple.size());
+	state.counters["file_size"] = xlog.offset;
+	x.remove(&xlog);
+}
+
+static void
+bench_xlog_write_plain(benchmark::State &state)
+{
+	bench_xlog_write(state, /*compressed=*/false, /*sync=*/false);
+}
+
+BENCHMARK(bench_xlog_write_plain)
+	->ArgsProduct({{64, 512, 4096}, {1, 16, 256}});
+
+static void
+bench_xlog_write_zstd(benchmark::State &state)
+{
+	bench_xlog_write(state, /*compressed=*/true, /*sync=*/false);
+}
+
+BENCHMARK(bench_xlog_write_zstd)
+	->ArgsProduct({{64, 512, 4096}, {1, 16, 256}});
+
+static void
+bench_xlog_write_fsync(benchmark::State &state)
+{
+	bench_xlog_write(state, /*compressed=*/true, /*sync=*/true);
+}
+
+BENCHMARK(bench_xlog_write_fsync)
+	->ArgsProduct({{512}, {1, 16, 256}})
+	->Unit(benchmark::kMicrosecond);
+
+/**
+ * Read an xlog file with a cursor and decode the DML requests stored in it
+ * like recovery does. range(0) is the tuple payload size.
+ */
+static void
+bench_xlog_cursor_read(benchmark::State &state, bool compressed)
+{
+	Xlog &x = Xlog::instance();
+	std::size_t payload_size = state.range(0);
+	std::vector<char> tuple = x.tuple(payload_size);
+	struct xlog xlog;
+	x.create(&xlog, compressed);
+	/* Transactions of 16 rows are big enough to be compressed. */
+	std::size_t row_count = 0;
+	while (row_count * tuple.size() < read_file_size) {
+		xlog_tx_begin(&xlog);
+		for (int i = 0; i < 16; i++, row_count++)
+			x.write_row(&xlog, tuple);
+		if (xlog_tx_commit(&xlog) < 0)
+			abort();
+	}
+	if (xlog_flush(&xlog) < 0)
+		abort();
+	std::int64_t file_size = xlog.offset;
+	for (auto _ : state) {
+		struct xlog_cursor cursor;
+		if (xlog_cursor_open(&cursor, xlog.filename) != 0)
+			abort();
+		struct xrow_header row;
+		std::size_t count = 0;
+		int rc;
+		while ((rc = xlog_cursor_next(&cursor, &row,
+					      /*force_recovery=*/false)) == 0) {
+			struct request request;
+			if (xrow_decode_dml(&row, &request,
+					    dml_request_key_map(row.type)) != 0)
+				abort();
+			benchmark::DoNotOptimize(request.tuple);
+			count++;
+		}
+		if (rc < 0 || count != row_count)
+			abort();
+		xlog_cursor_close(&cursor, false);
+	}
+	state.SetItemsProcessed(state.iterations() * row_count);
+	state.SetBytesProcessed(state.iterations() * file_size);
+	x.remove(&xlog);
+}
+
+static void
+bench_xlog_cursor_read_plain(benchmark::State &state)
+{
+	bench_xlog_cursor_read(state, /*compressed=*/false);
+}
+
+BENCHMARK(bench_xlog_cursor_read_plain)
+	->Arg(64)->Arg(512)->Arg(4096)
+	->Unit(benchmark::kMillisecond);
+
+static void
+bench_xlog_cursor_read_zstd(benchmark::State &state)
+{
+	bench_xlog_cursor_read(state, /*compressed=*/true);
+}
+
+BENCHMARK(bench_xlog_cursor_read_zstd)
+	->Arg(64)->Arg(512)->Arg(4096)
+	->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
+
+#include "debug_warning.h"
@@ -68,7 +68,19 @@ static void
 box_schema_version_bump(void)
 {
 	++schema_version;
-	box_broadcast_schema();
+	box_broadcast_schema(BOX_ID_NIL);
+}
+
+/**
+ * Bump the schema version on a change that concerns only the given
+ * space and remember the new version in the space object.
+ */
+static void
+space_schema_version_bump(struct space *space)
+{
+	++schema_version;
+	space->schema_version = schema_version;
+	box_broadcast_schema(space_id(space));
 }
 
 /**
@@ -251,6 +263,22 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->bloom_type == index_bloom_type_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "bloom_type must be either 'bloom' or 'xor'");
+		return -1;
+	}
+	if (opts->compaction_strategy == index_compaction_strategy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "compaction_strategy must be either 'leveled' or "
+			 "'tiered'");
+		return -1;
+	}
+	if (opts->hash_func == index_hash_func_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 "hash_func must be either 'murmur' or 'xxh3'");
+		return -1;
+	}
 	return 0;
 }
 
@@ -1024,6 +1052,7 @@ alter_space_do(struct txn_stmt *stmt, struct alter_space *alter)
 	alter->new_space->sequence_path = alter->old_space->sequence_path;
 	memcpy(alter->new_space->access, alter->old_space->access,
 	       sizeof(alter->old_space->access));
+	alter->new_space->stat = alter->old_space->stat;
 
 	space_prepare_upgrade_xc(alter->old_space, alter->new_space);
 
@@ -1657,8 +1686,7 @@ class UpdateSchemaVersion: public AlterSpaceOp
 void
 UpdateSchemaVersion::alter(struct alter_space *alter)
 {
-    (void)alter;
-    box_schema_version_bump();
+	space_schema_version_bump(alter->new_space);
 }
 
 /* }}} */
@@ -2138,7 +2166,7 @@ on_replace_dd_space(struct trigger * /* trigger */, void *event)
 		 * AlterSpaceOps are registered in case of space
 		 * create.
 		 */
-		box_schema_version_bump();
+		space_schema_version_bump(space);
 		/*
 		 * So may happen that until the DDL change record
 		 * is written to the WAL, the space is used for
@@ -2240,7 +2268,7 @@ on_replace_dd_space(struct trigger * /* trigger */, void *event)
 		 * deleting the space from the space_cache, since no
 		 * AlterSpaceOps are registered in case of space drop.
 		 */
-		box_schema_version_bump();
+		space_schema_version_bump(old_space);
 		struct trigger *on_commit =
 			txn_alter_trigger_new(on_drop_space_commit, old_space);
 		if (on_commit == NULL)
@@ -5017,6 +5045,7 @@ on_replace_dd_sequence_data(struct trigger * /* trigger */, void *event)
 		diag_set(ClientError, ER_NO_SUCH_SEQUENCE, int2str(id));
 		return -1;
 	}
+	sequence_prealloc_reset(seq);
 	if (new_tuple != NULL) {			/* INSERT, UPDATE */
 		int64_t value;
 		if (tuple_field_i64(new_tuple, BOX_SEQUENCE_DATA_FIELD_VALUE,
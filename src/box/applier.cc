@@ -915,6 +915,21 @@ struct applier_tx {
 	struct stailq_entry next;
 	/** The transaction rows. */
 	struct stailq rows;
+	/** Time when the transaction was received by the applier thread. */
+	double recv_time;
+	/**
+	 * The following members don't depend on the schema and are
+	 * computed by the applier thread, see applier_tx_prepare().
+	 */
+	/** Number of rows received for the transaction. */
+	uint64_t row_count;
+	/** Set if the transaction may be applied concurrently with others. */
+	bool is_parallel;
+	/**
+	 * Set if all the rows of the transaction are identified by their
+	 * primary keys, see applier_tx_write_set().
+	 */
+	bool is_keyed;
 };
 
 /** A callback for row allocation used by tx thread. */
@@ -1081,6 +1096,83 @@ applier_join(struct applier *applier)
 	applier_set_state(applier, APPLIER_READY);
 }
 
+/**
+ * Decompresses the body of a row if the master compressed it, see
+ * IPROTO_COMPRESSION_LEVEL. All compressed bodies received after
+ * subscribe are decoded with the same streaming context. The
+ * decompressed body is stored in the applier buffer until the next
+ * row is read.
+ */
+static void
+applier_decompress_row(struct applier *applier, struct xrow_header *row)
+{
+	uint64_t compression = IPROTO_COMPRESSION_NONE;
+	const char *pos = row->header;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		/* Keys and their types are checked by xrow_header_decode(). */
+		uint64_t key = mp_decode_uint(&pos);
+		if (key == IPROTO_COMPRESSION) {
+			compression = mp_decode_uint(&pos);
+			break;
+		}
+		mp_next(&pos);
+	}
+	if (compression == IPROTO_COMPRESSION_NONE)
+		return;
+	const char *data = (const char *)row->body[0].iov_base;
+	if (compression != IPROTO_COMPRESSION_ZSTD || row->bodycnt == 0 ||
+	    mp_typeof(*data) != MP_BIN)
+		goto error;
+	{
+		uint32_t len = mp_decode_binl(&data);
+		if (applier->zstd_ctx == NULL) {
+			applier->zstd_ctx = ZSTD_createDCtx();
+			if (applier->zstd_ctx == NULL) {
+				tnt_raise(OutOfMemory, 0, "ZSTD_createDCtx",
+					  "zstd context");
+			}
+		}
+		ZSTD_inBuffer in = {data, len, 0};
+		ZSTD_outBuffer out = {applier->zstd_buf,
+				      applier->zstd_buf_size, 0};
+		/*
+		 * The master flushes the stream after each row, so the
+		 * whole body is decoded once the input is consumed and
+		 * there's space left in the output buffer.
+		 */
+		while (in.pos < in.size || out.pos == out.size) {
+			if (out.pos == out.size) {
+				size_t size = MAX(out.size * 2, (size_t)4096);
+				applier->zstd_buf =
+					(char *)xrealloc(applier->zstd_buf,
+							 size);
+				applier->zstd_buf_size = size;
+				out.dst = applier->zstd_buf;
+				out.size = size;
+			}
+			size_t rc = ZSTD_decompressStream(applier->zstd_ctx,
+							  &out, &in);
+			if (ZSTD_isError(rc)) {
+				tnt_raise(ClientError, ER_DECOMPRESSION,
+					  ZSTD_getErrorName(rc));
+			}
+		}
+		const char *body = applier->zstd_buf;
+		pos = body;
+		if (out.pos == 0 || mp_check(&pos, body + out.pos) != 0 ||
+		    pos != body + out.pos)
+			goto error;
+		row->body[0].iov_base = (void *)body;
+		row->body[0].iov_len = out.pos;
+		applier->compression_in_bytes += len;
+		applier->compression_out_bytes += out.pos;
+		return;
+	}
+error:
+	tnt_raise(ClientError, ER_INVALID_MSGPACK, "compressed row body");
+}
+
 static struct applier_tx_row *
 applier_read_tx_row(struct applier *applier, const struct applier_read_ctx *ctx,
 		    double timeout)
@@ -1092,6 +1184,7 @@ applier_read_tx_row(struct applier *applier, const struct applier_read_ctx *ctx,
 	ERROR_INJECT_YIELD(ERRINJ_APPLIER_READ_TX_ROW_DELAY);
 
 	coio_read_xrow_timeout_xc(io, ctx->ibuf, row, timeout);
+	applier_decompress_row(applier, row);
 
 	if (row->tm > 0)
 		applier->lag = ev_now(loop()) - row->tm;
@@ -1248,6 +1341,8 @@ struct replica_cb_data {
 	 * a transaction.
 	 */
 	double txn_last_tm;
+	/** Time when the transaction started to be applied. */
+	double apply_time;
 };
 
 /** Update replica associated data once write is complete. */
@@ -1255,8 +1350,11 @@ static void
 replica_txn_wal_write_cb(struct replica_cb_data *rcb)
 {
 	struct replica *r = replica_by_id(rcb->replica_id);
-	if (likely(r != NULL && r->applier != NULL))
+	if (likely(r != NULL && r->applier != NULL)) {
 		r->applier->txn_last_tm = rcb->txn_last_tm;
+		latency_collect(&r->applier->wal_latency,
+				ev_now(loop()) - rcb->apply_time);
+	}
 }
 
 static int
@@ -1330,6 +1428,7 @@ apply_synchro_req(uint32_t replica_id, struct xrow_header *row, struct synchro_r
 
 	rcb_data.replica_id = replica_id;
 	rcb_data.txn_last_tm = row->tm;
+	rcb_data.apply_time = ev_now(loop());
 	entry.rcb = &rcb_data;
 
 	/*
@@ -1383,9 +1482,13 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows,
-	       bool skip_conflict, bool use_triggers)
+/**
+ * Apply the rows of a replicated transaction without committing it.
+ * Returns the transaction ready to be submitted to WAL or NULL on error.
+ */
+static struct txn *
+apply_plain_tx_prepare(uint32_t replica_id, struct stailq *rows,
+		       bool skip_conflict, bool use_triggers)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1396,7 +1499,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 	txn->isolation = TXN_ISOLATION_READ_COMMITTED;
 
 	stailq_foreach_entry(item, rows, next) {
@@ -1486,15 +1589,26 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		 */
 		rcb->replica_id = replica_id;
 		rcb->txn_last_tm = item->row.tm;
+		rcb->apply_time = ev_now(loop());
 
 		trigger_create(on_wal_write, applier_txn_wal_write_cb, rcb, NULL);
 		txn_on_wal_write(txn, on_wal_write);
 	}
-
-	return txn_commit_try_async(txn);
+	return txn;
 fail:
 	txn_abort(txn);
-	return -1;
+	return NULL;
+}
+
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows,
+	       bool skip_conflict, bool use_triggers)
+{
+	struct txn *txn = apply_plain_tx_prepare(replica_id, rows,
+						 skip_conflict, use_triggers);
+	if (txn == NULL)
+		return -1;
+	return txn_commit_try_async(txn);
 }
 
 /** A simpler version of applier_apply_tx() for final join stage. */
@@ -1635,6 +1749,44 @@ applier_process_heartbeat(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+/**
+ * Remove the rows that have already been applied from a transaction.
+ * Returns true if the whole transaction has been applied.
+ * Must be called under the order latch of the transaction origin.
+ */
+static bool
+applier_skip_applied_rows(struct stailq *rows)
+{
+	struct xrow_header *first_row =
+		&stailq_first_entry(rows, struct applier_tx_row, next)->row;
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	if (vclock_get(&replicaset.applier.vclock,
+		       last_row->replica_id) >= last_row->lsn) {
+		return true;
+	} else if (vclock_get(&replicaset.applier.vclock,
+			      first_row->replica_id) >= first_row->lsn) {
+		/*
+		 * We've received part of the tx from an old
+		 * instance not knowing of tx boundaries.
+		 * Skip the already applied part.
+		 */
+		struct xrow_header *tmp;
+		while (true) {
+			tmp = &stailq_first_entry(rows,
+						  struct applier_tx_row,
+						  next)->row;
+			if (tmp->lsn <= vclock_get(&replicaset.applier.vclock,
+						   tmp->replica_id)) {
+				stailq_shift(rows);
+			} else {
+				break;
+			}
+		}
+	}
+	return false;
+}
+
 /**
  * Apply all rows in the rows queue as a single transaction.
  *
@@ -1676,29 +1828,8 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	struct latch *latch = (replica ? &replica->order_latch :
 			       &replicaset.applier.order_latch);
 	latch_lock(latch);
-	if (vclock_get(&replicaset.applier.vclock,
-		       last_row->replica_id) >= last_row->lsn) {
+	if (applier_skip_applied_rows(rows))
 		goto finish;
-	} else if (vclock_get(&replicaset.applier.vclock,
-			      first_row->replica_id) >= first_row->lsn) {
-		/*
-		 * We've received part of the tx from an old
-		 * instance not knowing of tx boundaries.
-		 * Skip the already applied part.
-		 */
-		struct xrow_header *tmp;
-		while (true) {
-			tmp = &stailq_first_entry(rows,
-						  struct applier_tx_row,
-						  next)->row;
-			if (tmp->lsn <= vclock_get(&replicaset.applier.vclock,
-						   tmp->replica_id)) {
-				stailq_shift(rows);
-			} else {
-				break;
-			}
-		}
-	}
 	applier_synchro_filter_tx(rows);
 	if (unlikely(iproto_type_is_synchro_request(first_row->type))) {
 		/*
@@ -1723,6 +1854,353 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	return rc;
 }
 
+/** A transaction applied concurrently with others, see applier_apply_txs(). */
+struct applier_parallel_tx {
+	/** The transaction rows. */
+	struct stailq *rows;
+	/**
+	 * Index of the last preceding transaction that modifies
+	 * the same keys or -1.
+	 */
+	int dep;
+	/**
+	 * Set if the transaction may be applied before the preceding
+	 * independent transactions are submitted to WAL. Only true for
+	 * vinyl transactions: memtx transactions don't yield so there's
+	 * nothing to gain applying them concurrently.
+	 */
+	bool can_yield;
+};
+
+/** A batch of transactions applied concurrently. */
+struct applier_parallel {
+	/** The applier which received the transactions. */
+	struct applier *applier;
+	/** The transactions, in the order they must be committed. */
+	struct applier_parallel_tx *txs;
+	int tx_count;
+	/** Index of the next transaction to be taken by a worker. */
+	int next;
+	/**
+	 * Number of transactions submitted to WAL. Transactions are
+	 * always submitted in order.
+	 */
+	int submitted;
+	/** Set if a transaction failed to apply. */
+	bool is_failed;
+	/** The error the failed transaction was aborted with. */
+	struct diag diag;
+	/** Number of running worker fibers. */
+	int worker_count;
+	/** Signaled when a transaction is submitted or fails. */
+	struct fiber_cond cond;
+};
+
+/**
+ * Compute the keys modified by a transaction: hashes of the primary
+ * keys mixed with the space id. Returns false if this can't be done,
+ * e.g. if the transaction modifies a space with secondary unique keys
+ * or a system space, in which case the transaction must be applied
+ * in isolation. Sets @a can_yield if the transaction is vinyl-only.
+ */
+static bool
+applier_tx_write_set(struct stailq *rows, uint64_t *keys, int *key_count,
+		     bool *can_yield)
+{
+	*key_count = 0;
+	*can_yield = true;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		struct request *request = &item->req.dml;
+		if (item->row.type == IPROTO_NOP)
+			continue;
+		assert(item->row.type == request->type);
+		struct space *space = space_by_id(request->space_id);
+		if (space == NULL || space_is_system(space) ||
+		    space_has_before_replace_triggers(space) ||
+		    space_has_on_replace_triggers(space))
+			return false;
+		struct index *pk = space_index(space, 0);
+		if (pk == NULL)
+			return false;
+		for (uint32_t i = 1; i < space->index_count; i++) {
+			if (space->index[i]->def->opts.is_unique)
+				return false;
+		}
+		if (!space_is_vinyl(space))
+			*can_yield = false;
+		struct key_def *key_def = pk->def->key_def;
+		const char *key;
+		switch (request->type) {
+		case IPROTO_INSERT:
+		case IPROTO_REPLACE:
+		case IPROTO_UPSERT:
+			key = tuple_extract_key_raw(request->tuple,
+						    request->tuple_end,
+						    key_def, MULTIKEY_NONE,
+						    NULL);
+			if (key == NULL) {
+				diag_clear(diag_get());
+				return false;
+			}
+			break;
+		case IPROTO_DELETE:
+		case IPROTO_UPDATE:
+			if (request->index_id != 0)
+				return false;
+			key = request->key;
+			break;
+		default:
+			return false;
+		}
+		keys[(*key_count)++] = (uint64_t)request->space_id << 32 |
+				       key_hash(key, key_def);
+	}
+	return true;
+}
+
+/**
+ * Apply a transaction of a concurrently applied batch. Called by
+ * the batch workers in the order of transactions.
+ */
+static void
+applier_parallel_apply_tx(struct applier_parallel *p, int i)
+{
+	struct applier_parallel_tx *tx = &p->txs[i];
+	struct xrow_header *last_row =
+		&stailq_last_entry(tx->rows, struct applier_tx_row, next)->row;
+	/*
+	 * Wait for the transactions modifying the same keys to be
+	 * submitted. A transaction that can't yield is applied only
+	 * when all the preceding transactions are submitted,
+	 * otherwise it'd be aborted while waiting for its turn.
+	 */
+	int wait_for = tx->can_yield ? tx->dep + 1 : i;
+	while (p->submitted < wait_for && !p->is_failed)
+		fiber_cond_wait(&p->cond);
+	if (p->is_failed)
+		return;
+	applier_synchro_filter_tx(tx->rows);
+	struct txn *txn = apply_plain_tx_prepare(p->applier->instance_id,
+						 tx->rows,
+						 replication_skip_conflict,
+						 true);
+	/* Transactions are submitted to WAL strictly in order. */
+	while (p->submitted < i && !p->is_failed)
+		fiber_cond_wait(&p->cond);
+	if (p->is_failed) {
+		/* A preceding transaction failed, so this one is void. */
+		if (txn != NULL)
+			txn_abort(txn);
+		else
+			diag_clear(diag_get());
+		return;
+	}
+	if (txn == NULL || txn_commit_try_async(txn) != 0) {
+		p->is_failed = true;
+		diag_move(diag_get(), &p->diag);
+	} else {
+		vclock_follow(&replicaset.applier.vclock,
+			      last_row->replica_id, last_row->lsn);
+		p->submitted++;
+	}
+	fiber_cond_broadcast(&p->cond);
+}
+
+/** Worker fiber applying transactions of a concurrently applied batch. */
+static int
+applier_parallel_worker_f(va_list ap)
+{
+	struct applier_parallel *p = va_arg(ap, struct applier_parallel *);
+	while (p->next < p->tx_count)
+		applier_parallel_apply_tx(p, p->next++);
+	if (--p->worker_count == 0)
+		fiber_cond_broadcast(&p->cond);
+	return 0;
+}
+
+/**
+ * Check if a transaction may be applied concurrently with others.
+ */
+static bool
+applier_tx_is_parallel(struct applier_tx *tx)
+{
+	struct xrow_header *first_row =
+		&stailq_first_entry(&tx->rows, struct applier_tx_row,
+				    next)->row;
+	struct xrow_header *last_row =
+		&stailq_last_entry(&tx->rows, struct applier_tx_row,
+				   next)->row;
+	return last_row->lsn != 0 &&
+	       !iproto_type_is_synchro_request(first_row->type);
+}
+
+/**
+ * Check if all the rows of a transaction are identified by their
+ * primary keys so that its write set may be computed.
+ */
+static bool
+applier_tx_is_keyed(struct applier_tx *tx)
+{
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, &tx->rows, next) {
+		switch (item->row.type) {
+		case IPROTO_NOP:
+		case IPROTO_INSERT:
+		case IPROTO_REPLACE:
+		case IPROTO_UPSERT:
+			break;
+		case IPROTO_DELETE:
+		case IPROTO_UPDATE:
+			if (item->req.dml.index_id != 0)
+				return false;
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Compute the transaction properties which don't depend on the schema.
+ * Called by the applier thread so that the tx thread doesn't have to
+ * walk the transaction rows once again.
+ */
+static void
+applier_tx_prepare(struct applier_tx *tx, uint64_t row_count)
+{
+	tx->row_count = row_count;
+	tx->is_parallel = applier_tx_is_parallel(tx);
+	tx->is_keyed = tx->is_parallel && applier_tx_is_keyed(tx);
+}
+
+/**
+ * Count the transactions starting from @a tx that may be applied
+ * concurrently with applier_apply_txs().
+ */
+static int
+applier_parallel_tx_count(struct applier *applier, struct applier_tx *tx)
+{
+	if (replication_apply_workers <= 1 ||
+	    applier->state == APPLIER_FINAL_JOIN ||
+	    applier->version_id < version_id(2, 11, 0))
+		return 0;
+	uint32_t replica_id = stailq_first_entry(&tx->rows,
+						 struct applier_tx_row,
+						 next)->row.replica_id;
+	int count = 0;
+	for (; tx != NULL; tx = stailq_next_entry(tx, next)) {
+		struct xrow_header *first_row =
+			&stailq_first_entry(&tx->rows, struct applier_tx_row,
+					    next)->row;
+		if (!tx->is_parallel || first_row->replica_id != replica_id)
+			break;
+		count++;
+	}
+	return count;
+}
+
+/**
+ * Apply @a count transactions starting from @a tx that originate from
+ * the same instance. Transactions that don't modify the same keys are
+ * applied concurrently by up to replication_apply_workers fibers while
+ * transactions modifying the same keys are applied in order. All the
+ * transactions are submitted to WAL in order.
+ *
+ * Return 0 for success or -1 in case of an error.
+ */
+static int
+applier_apply_txs(struct applier *applier, struct applier_tx *tx, int count)
+{
+	struct region *gc = &fiber()->gc;
+	RegionGuard region_guard(gc);
+	uint32_t replica_id = stailq_first_entry(&tx->rows,
+						 struct applier_tx_row,
+						 next)->row.replica_id;
+	struct replica *replica = replica_by_id(replica_id);
+	struct latch *latch = (replica ? &replica->order_latch :
+			       &replicaset.applier.order_latch);
+	latch_lock(latch);
+	auto latch_guard = make_scoped_guard([=] {
+		latch_unlock(latch);
+	});
+
+	struct applier_parallel p;
+	p.applier = applier;
+	p.txs = xregion_alloc_array(gc, typeof(*p.txs), count);
+	p.tx_count = 0;
+	p.next = 0;
+	p.submitted = 0;
+	p.is_failed = false;
+	diag_create(&p.diag);
+	p.worker_count = 0;
+	fiber_cond_create(&p.cond);
+	auto p_guard = make_scoped_guard([&] {
+		fiber_cond_destroy(&p.cond);
+		diag_destroy(&p.diag);
+	});
+
+	/* Map: key -> index of the last transaction modifying it. */
+	struct mh_i64ptr_t *last_tx = mh_i64ptr_new();
+	int barrier = -1;
+	for (int i = 0; i < count; i++, tx = stailq_next_entry(tx, next)) {
+		if (applier_skip_applied_rows(&tx->rows))
+			continue;
+		struct applier_parallel_tx *ptx = &p.txs[p.tx_count];
+		ptx->rows = &tx->rows;
+		int idx = p.tx_count++;
+		uint64_t *keys = xregion_alloc_array(gc, uint64_t,
+						     tx->row_count);
+		int key_count;
+		if (!tx->is_keyed ||
+		    !applier_tx_write_set(&tx->rows, keys, &key_count,
+					  &ptx->can_yield)) {
+			ptx->dep = idx - 1;
+			ptx->can_yield = false;
+			barrier = idx;
+			continue;
+		}
+		ptx->dep = barrier;
+		for (int k = 0; k < key_count; k++) {
+			struct mh_i64ptr_node_t node = {
+				keys[k], (void *)(intptr_t)idx
+			};
+			struct mh_i64ptr_node_t old_node;
+			struct mh_i64ptr_node_t *old_node_ptr = &old_node;
+			mh_i64ptr_put(last_tx, &node, &old_node_ptr, NULL);
+			if (old_node_ptr != NULL)
+				ptx->dep = MAX(ptx->dep,
+					       (int)(intptr_t)old_node.val);
+		}
+	}
+	mh_i64ptr_delete(last_tx);
+
+	/* The applier fiber is a worker, too. */
+	int worker_count = MIN(replication_apply_workers, p.tx_count);
+	for (int i = 1; i < worker_count; i++) {
+		struct fiber *f = fiber_new_system("applier_worker",
+						   applier_parallel_worker_f);
+		if (f == NULL) {
+			diag_log();
+			break;
+		}
+		fiber_set_session(f, current_session());
+		fiber_set_user(f, effective_user());
+		p.worker_count++;
+		fiber_start(f, &p);
+	}
+	while (p.next < p.tx_count)
+		applier_parallel_apply_tx(&p, p.next++);
+	while (p.worker_count > 0)
+		fiber_cond_wait(&p.cond);
+	if (p.is_failed) {
+		diag_move(&p.diag, diag_get());
+		return -1;
+	}
+	return 0;
+}
+
 /**
  * Notify the applier's write fiber that there are more ACKs to
  * send to master.
@@ -1889,6 +2367,28 @@ applier_handle_raft(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+/**
+ * Account the time a transaction spent on the way from the master's WAL
+ * to the applier thread and from the applier thread to the tx thread.
+ */
+static void
+applier_collect_latency(struct applier *applier, struct applier_tx *tx)
+{
+	struct xrow_header *last_row =
+		&stailq_last_entry(&tx->rows, struct applier_tx_row,
+				   next)->row;
+	/* Heartbeats aren't accounted. */
+	if (last_row->lsn == 0)
+		return;
+	/* Local rows and rows of old versions may have no timestamp. */
+	if (last_row->tm > 0) {
+		latency_collect(&applier->network_latency,
+				tx->recv_time - last_row->tm);
+	}
+	latency_collect(&applier->decode_latency,
+			ev_now(loop()) - tx->recv_time);
+}
+
 /**
  * The tx part of applier-in-thread machinery. Apply all the parsed
  * transactions.
@@ -1899,7 +2399,18 @@ applier_process_batch(struct cmsg *base)
 	struct applier_data_msg *msg = (struct applier_data_msg *)base;
 	struct applier *applier = msg->base.applier;
 	struct applier_tx *tx;
-	stailq_foreach_entry(tx, &msg->txs, next) {
+	stailq_foreach_entry(tx, &msg->txs, next)
+		applier_collect_latency(applier, tx);
+	tx = stailq_first_entry(&msg->txs, struct applier_tx, next);
+	for (; tx != NULL; tx = stailq_next_entry(tx, next)) {
+		int count = applier_parallel_tx_count(applier, tx);
+		if (count > 1) {
+			if (applier_apply_txs(applier, tx, count) != 0)
+				diag_raise();
+			for (int i = 1; i < count; i++)
+				tx = stailq_next_entry(tx, next);
+			continue;
+		}
 		struct applier_tx_row *last_txr =
 			stailq_last_entry(&tx->rows, struct applier_tx_row,
 					  next);
@@ -2088,7 +2599,10 @@ applier_thread_reader_f(va_list ap)
 			goto exit_notify;
 		}
 		try {
-			applier_read_tx(applier, &tx->rows, &ctx, timeout);
+			uint64_t row_count = applier_read_tx(applier, &tx->rows,
+							     &ctx, timeout);
+			tx->recv_time = ev_now(loop());
+			applier_tx_prepare(tx, row_count);
 		} catch (FiberIsCancelled *) {
 			return 0;
 		} catch (Exception *e) {
@@ -2391,6 +2905,16 @@ applier_subscribe(struct applier *applier)
 	 * instance as soon as local WAL starts accepting writes.
 	 */
 	req.id_filter = box_is_orphan() ? 0 : 1 << instance_id;
+	req.compression_level = replication_compression;
+	/* The master starts a new zstd stream on each subscribe. */
+	applier->compression_level = replication_compression;
+	applier->compression_in_bytes = 0;
+	applier->compression_out_bytes = 0;
+	latency_reset(&applier->network_latency);
+	latency_reset(&applier->decode_latency);
+	latency_reset(&applier->wal_latency);
+	if (applier->zstd_ctx != NULL)
+		ZSTD_DCtx_reset(applier->zstd_ctx, ZSTD_reset_session_only);
 	RegionGuard region_guard(&fiber()->gc);
 	xrow_encode_subscribe(&row, &req);
 	coio_write_xrow(io, &row);
@@ -2792,6 +3316,10 @@ applier_new(const struct uri *uri)
 	rlist_create(&applier->on_state);
 	fiber_cond_create(&applier->resume_cond);
 	diag_create(&applier->diag);
+	if (latency_create(&applier->network_latency) != 0 ||
+	    latency_create(&applier->decode_latency) != 0 ||
+	    latency_create(&applier->wal_latency) != 0)
+		panic("failed to allocate applier latency histogram");
 
 	return applier;
 }
@@ -2803,6 +3331,11 @@ applier_delete(struct applier *applier)
 	assert(!iostream_is_initialized(&applier->io));
 	iostream_ctx_destroy(&applier->io_ctx);
 	ibuf_destroy(&applier->ibuf);
+	ZSTD_freeDCtx(applier->zstd_ctx);
+	free(applier->zstd_buf);
+	latency_destroy(&applier->network_latency);
+	latency_destroy(&applier->decode_latency);
+	latency_destroy(&applier->wal_latency);
 	uri_destroy(&applier->uri);
 	trigger_destroy(&applier->on_state);
 	diag_destroy(&applier->diag);
@@ -39,6 +39,7 @@
 
 #include "fiber_cond.h"
 #include "iostream.h"
+#include "latency.h"
 #include "trigger.h"
 #include "trivia/util.h"
 #include "tt_uuid.h"
@@ -52,6 +53,8 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+struct ZSTD_DCtx_s;
+
 enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 
 #define applier_STATE(_)                                             \
@@ -179,6 +182,37 @@ struct applier {
 	struct iostream io;
 	/** Input buffer */
 	struct ibuf ibuf;
+	/**
+	 * zstd level the master was asked to compress the replication
+	 * stream with on subscribe, see replication_compression.
+	 */
+	int compression_level;
+	/** Streaming context decompressing the rows sent by the master. */
+	struct ZSTD_DCtx_s *zstd_ctx;
+	/** Buffer for the last decompressed row body. */
+	char *zstd_buf;
+	/** Size of zstd_buf. */
+	size_t zstd_buf_size;
+	/** Total size of the compressed row bodies received. */
+	uint64_t compression_in_bytes;
+	/** Total size of the received row bodies after decompression. */
+	uint64_t compression_out_bytes;
+	/**
+	 * Time between a WAL write of a transaction on the master and
+	 * receiving it on the replica. Includes the clock difference
+	 * between the two instances, see also applier::lag.
+	 */
+	struct latency network_latency;
+	/**
+	 * Time between receiving a transaction in the applier thread
+	 * and starting to apply it in the tx thread.
+	 */
+	struct latency decode_latency;
+	/**
+	 * Time between starting to apply a transaction and finishing
+	 * its WAL write on the replica.
+	 */
+	struct latency wal_latency;
 	/** Triggers invoked on state change or ballot update. */
 	struct rlist on_state;
 	/**
@@ -47,6 +47,13 @@ blackhole_space_destroy(struct space *space)
 	free(space);
 }
 
+/**
+ * The statement is written to WAL from the request, but we still create
+ * a tuple: it's returned to the caller, passed to space triggers and used
+ * to check the space format. Since a blackhole space has no indexes, its
+ * format has no field map to build, so this is just a copy and a format
+ * check of the tuple data.
+ */
 static int
 blackhole_space_execute_replace(struct space *space, struct txn *txn,
 				struct request *request, struct tuple **result)
@@ -138,6 +138,12 @@ static bool backup_is_in_progress;
  */
 static struct gc_checkpoint_ref backup_gc;
 
+/**
+ * Recovery rates observed on local recovery, used for keeping
+ * recovery time below box.cfg.checkpoint_recovery_time.
+ */
+static struct checkpoint_recovery_estimate checkpoint_recovery_estimate;
+
 bool box_read_ffi_is_disabled;
 
 /**
@@ -1183,6 +1189,23 @@ box_check_election_fencing_mode(void)
 	return ELECTION_FENCING_MODE_INVALID;
 }
 
+/**
+ * Raises error if election_lease_max_drift configuration is incorrect. The
+ * leader leases are enabled when the option is set.
+ */
+static int
+box_check_election_lease_max_drift(bool *is_enabled, double *max_drift)
+{
+	*is_enabled = cfg_isnumber("election_lease_max_drift");
+	*max_drift = cfg_getd_default("election_lease_max_drift", 0);
+	if (*max_drift < 0 || *max_drift >= 1) {
+		diag_set(ClientError, ER_CFG, "election_lease_max_drift",
+			 "the value must be a number in the range [0, 1)");
+		return -1;
+	}
+	return 0;
+}
+
 /** A helper to check validity of a single uri. */
 static int
 check_uri(const struct uri *uri, const char *option_name, bool set_diag)
@@ -1272,6 +1295,32 @@ box_check_replication_threads(void)
 	return 0;
 }
 
+static int
+box_check_replication_apply_workers(void)
+{
+	int count = cfg_geti("replication_apply_workers");
+	if (count <= 0) {
+		diag_set(ClientError, ER_CFG, "replication_apply_workers",
+			 "must be greater than 0");
+		return -1;
+	}
+	return count;
+}
+
+static int
+box_check_replication_compression(void)
+{
+	int level = cfg_geti("replication_compression");
+	if (level < 0 || level > ZSTD_maxCLevel()) {
+		diag_set(ClientError, ER_CFG, "replication_compression",
+			 tt_sprintf("must be greater than or equal to 0, "
+				    "less than or equal to %d",
+				    ZSTD_maxCLevel()));
+		return -1;
+	}
+	return level;
+}
+
 /** Check bootstrap_strategy option validity. */
 static enum bootstrap_strategy
 box_check_bootstrap_strategy(void)
@@ -1455,6 +1504,19 @@ box_check_replication_synchro_timeout(void)
 	return timeout;
 }
 
+static double
+box_check_replication_synchro_confirm_delay(void)
+{
+	double delay = cfg_getd("replication_synchro_confirm_delay");
+	if (delay < 0) {
+		diag_set(ClientError, ER_CFG,
+			 "replication_synchro_confirm_delay",
+			 "the value must be greater than or equal to zero");
+		return -1;
+	}
+	return delay;
+}
+
 static double
 box_check_replication_sync_timeout(void)
 {
@@ -1626,6 +1688,17 @@ box_check_wal_queue_max_size(void)
 	return size;
 }
 
+static int64_t
+box_check_wal_ring_size(void)
+{
+	int64_t size = cfg_geti64("wal_ring_size");
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "wal_ring_size",
+			 "wal_ring_size must be >= 0");
+	}
+	return size;
+}
+
 static double
 box_check_wal_cleanup_delay(void)
 {
@@ -1659,6 +1732,56 @@ box_check_checkpoint_count(int checkpoint_count)
 	}
 }
 
+static void
+box_check_checkpoint_recovery_time(double time)
+{
+	if (time < 0) {
+		tnt_raise(ClientError, ER_CFG, "checkpoint_recovery_time",
+			  "the value must not be negative");
+	}
+}
+
+static void
+box_check_memtx_checkpoint_delta_count(int count)
+{
+	if (count < 0) {
+		tnt_raise(ClientError, ER_CFG, "memtx_checkpoint_delta_count",
+			  "the value must not be less than zero");
+	}
+}
+
+static void
+box_check_memtx_snapshot_compress_threads(int count)
+{
+	if (count < 1 || count > XLOG_COMPRESS_THREADS_MAX) {
+		tnt_raise(ClientError, ER_CFG,
+			  "memtx_snapshot_compress_threads",
+			  tt_sprintf("must be greater than 0 and less than or"
+				     " equal to %d",
+				     XLOG_COMPRESS_THREADS_MAX));
+	}
+}
+
+static void
+box_check_memtx_snapshot_compression_level(int level)
+{
+	if (level < 1 || level > ZSTD_maxCLevel()) {
+		tnt_raise(ClientError, ER_CFG,
+			  "memtx_snapshot_compression_level",
+			  tt_sprintf("must be greater than 0 and less than or"
+				     " equal to %d", ZSTD_maxCLevel()));
+	}
+}
+
+static void
+box_check_memtx_ddl_rate_limit(double limit)
+{
+	if (limit < 0) {
+		tnt_raise(ClientError, ER_CFG, "memtx_ddl_rate_limit",
+			  "the value must not be negative");
+	}
+}
+
 static int64_t
 box_check_wal_max_size(int64_t wal_max_size)
 {
@@ -1705,6 +1828,30 @@ box_check_memory_quota(const char *quota_name)
 	return -1;
 }
 
+static int64_t
+box_check_vinyl_read_ahead(void)
+{
+	int64_t size = cfg_geti64("vinyl_read_ahead");
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "vinyl_read_ahead",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return size;
+}
+
+static double
+box_check_vinyl_read_latency_budget(void)
+{
+	double budget = cfg_getd("vinyl_read_latency_budget");
+	if (budget < 0) {
+		diag_set(ClientError, ER_CFG, "vinyl_read_latency_budget",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return budget;
+}
+
 static void
 box_check_vinyl_options(void)
 {
@@ -1718,6 +1865,10 @@ box_check_vinyl_options(void)
 
 	if (box_check_memory_quota("vinyl_memory") < 0)
 		diag_raise();
+	if (box_check_vinyl_read_ahead() < 0)
+		diag_raise();
+	if (box_check_vinyl_read_latency_budget() < 0)
+		diag_raise();
 
 	if (read_threads < 1) {
 		tnt_raise(ClientError, ER_CFG, "vinyl_read_threads",
@@ -1794,6 +1945,66 @@ box_check_small_alloc_options(void)
 			  " to 1024 * 16 and exponent of two");
 }
 
+static int64_t
+box_check_iproto_compression_threshold(void)
+{
+	int64_t threshold = cfg_geti64("iproto_compression_threshold");
+	if (threshold < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_compression_threshold",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return threshold;
+}
+
+static double
+box_check_iproto_busy_poll(void)
+{
+	double budget = cfg_getd("iproto_busy_poll");
+	if (budget < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_busy_poll",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return budget;
+}
+
+static double
+box_check_iproto_slow_request_threshold(void)
+{
+	double threshold = cfg_getd("iproto_slow_request_threshold");
+	if (threshold < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_slow_request_threshold",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return threshold;
+}
+
+static double
+box_check_iproto_wait_vclock_timeout(void)
+{
+	double timeout = cfg_getd("iproto_wait_vclock_timeout");
+	if (timeout < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_wait_vclock_timeout",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return timeout;
+}
+
+static double
+box_check_iproto_read_view_interval(void)
+{
+	double interval = cfg_getd("iproto_read_view_interval");
+	if (interval < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_read_view_interval",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return interval;
+}
+
 static int
 box_check_iproto_options(void)
 {
@@ -1805,6 +2016,16 @@ box_check_iproto_options(void)
 				     IPROTO_THREADS_MAX));
 		return -1;
 	}
+	if (box_check_iproto_read_view_interval() < 0)
+		return -1;
+	if (box_check_iproto_compression_threshold() < 0)
+		return -1;
+	if (box_check_iproto_busy_poll() < 0)
+		return -1;
+	if (box_check_iproto_slow_request_threshold() < 0)
+		return -1;
+	if (box_check_iproto_wait_vclock_timeout() < 0)
+		return -1;
 	return 0;
 }
 
@@ -1898,6 +2119,39 @@ box_check_memtx_sort_threads(void)
 				     " equal to %d", TT_SORT_THREADS_MAX));
 }
 
+/**
+ * Checks whether a CPU affinity configuration parameter is correct.
+ */
+static int
+box_check_cpu_affinity(const char *name)
+{
+	const char *cpu_list = cfg_gets(name);
+	if (cpu_list != NULL && cpu_list_check(cpu_list) != 0) {
+		diag_set(ClientError, ER_CFG, name,
+			 diag_last_error(diag_get())->errmsg);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Checks whether memtx_numa_node configuration parameter is correct.
+ * Returns the node or -1 if it isn't set.
+ */
+static int
+box_check_memtx_numa_node(void)
+{
+	if (!cfg_isnumber("memtx_numa_node"))
+		return -1;
+	int node = cfg_geti("memtx_numa_node");
+	if (node < 0) {
+		diag_set(ClientError, ER_CFG, "memtx_numa_node",
+			 "must be greater than or equal to 0");
+		return -2;
+	}
+	return node;
+}
+
 void
 box_check_config(void)
 {
@@ -1925,6 +2179,11 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_election_fencing_mode() == ELECTION_FENCING_MODE_INVALID)
 		diag_raise();
+	bool is_lease_enabled;
+	double lease_max_drift;
+	if (box_check_election_lease_max_drift(&is_lease_enabled,
+					       &lease_max_drift) != 0)
+		diag_raise();
 	if (box_check_replication(&uri_set) != 0)
 		diag_raise();
 	uri_set_destroy(&uri_set);
@@ -1936,8 +2195,14 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_replication_synchro_timeout() < 0)
 		diag_raise();
+	if (box_check_replication_synchro_confirm_delay() < 0)
+		diag_raise();
 	if (box_check_replication_threads() < 0)
 		diag_raise();
+	if (box_check_replication_apply_workers() < 0)
+		diag_raise();
+	if (box_check_replication_compression() < 0)
+		diag_raise();
 	box_check_replication_sync_timeout();
 	if (box_check_bootstrap_strategy() == BOOTSTRAP_STRATEGY_INVALID)
 		diag_raise();
@@ -1946,10 +2211,21 @@ box_check_config(void)
 	uri_destroy(&uri);
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
+	box_check_checkpoint_recovery_time(
+		cfg_getd("checkpoint_recovery_time"));
+	box_check_memtx_checkpoint_delta_count(
+		cfg_geti("memtx_checkpoint_delta_count"));
+	box_check_memtx_snapshot_compress_threads(
+		cfg_geti("memtx_snapshot_compress_threads"));
+	box_check_memtx_snapshot_compression_level(
+		cfg_geti("memtx_snapshot_compression_level"));
+	box_check_memtx_ddl_rate_limit(cfg_getd("memtx_ddl_rate_limit"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
+	if (box_check_wal_ring_size() < 0)
+		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
 	if (box_check_wal_retention_period() < 0)
@@ -1970,6 +2246,12 @@ box_check_config(void)
 	if (box_check_txn_isolation() == txn_isolation_level_MAX)
 		diag_raise();
 	box_check_memtx_sort_threads();
+	if (box_check_cpu_affinity("tx_cpu_affinity") != 0 ||
+	    box_check_cpu_affinity("wal_cpu_affinity") != 0 ||
+	    box_check_cpu_affinity("iproto_cpu_affinity") != 0)
+		diag_raise();
+	if (box_check_memtx_numa_node() < -1)
+		diag_raise();
 }
 
 int
@@ -2013,6 +2295,17 @@ box_set_election_fencing_mode(void)
 	return 0;
 }
 
+int
+box_set_election_lease_max_drift(void)
+{
+	bool is_enabled;
+	double max_drift;
+	if (box_check_election_lease_max_drift(&is_enabled, &max_drift) != 0)
+		return -1;
+	raft_cfg_lease(box_raft(), is_enabled, max_drift);
+	return 0;
+}
+
 /*
  * Sync box.cfg.replication with the cluster registry, but
  * don't start appliers.
@@ -2241,6 +2534,16 @@ box_set_replication_synchro_timeout(void)
 	return 0;
 }
 
+int
+box_set_replication_synchro_confirm_delay(void)
+{
+	double value = box_check_replication_synchro_confirm_delay();
+	if (value < 0)
+		return -1;
+	replication_synchro_confirm_delay = value;
+	return 0;
+}
+
 void
 box_set_replication_sync_timeout(void)
 {
@@ -2253,6 +2556,26 @@ box_set_replication_skip_conflict(void)
 	replication_skip_conflict = cfg_geti("replication_skip_conflict");
 }
 
+int
+box_set_replication_apply_workers(void)
+{
+	int count = box_check_replication_apply_workers();
+	if (count < 0)
+		return -1;
+	replication_apply_workers = count;
+	return 0;
+}
+
+int
+box_set_replication_compression(void)
+{
+	int level = box_check_replication_compression();
+	if (level < 0)
+		return -1;
+	replication_compression = level;
+	return 0;
+}
+
 /** Register on the master instance. Could be initial join or a name change. */
 static void
 box_register_on_master(void)
@@ -2746,11 +3069,7 @@ box_wait_vclock_f(struct trigger *trigger, void *event)
 	return 0;
 }
 
-/**
- * Wait until this instance's vclock reaches @a vclock or @a deadline is
- * reached.
- */
-static int
+int
 box_wait_vclock(const struct vclock *vclock, double deadline)
 {
 	if (vclock_compare_ignore0(vclock, &replicaset.vclock) <= 0)
@@ -2783,17 +3102,31 @@ int
 box_wait_linearization_point(double timeout)
 {
 	double deadline = ev_monotonic_now(loop()) + timeout;
-	struct vclock confirmed_vclock;
-	vclock_create(&confirmed_vclock);
 	/*
-	 * First find out the vclock which might be confirmed on remote
-	 * instances.
+	 * The leader holding a lease is sure no other leader could confirm
+	 * anything the leader doesn't have, so there is no need to ask the
+	 * quorum about it.
 	 */
-	if (box_collect_confirmed_vclock(&confirmed_vclock, deadline) != 0)
-		return -1;
-	/* Then wait until all the rows up to this vclock are received. */
-	if (box_wait_vclock(&confirmed_vclock, deadline) != 0)
-		return -1;
+	bool has_lease = raft_has_lease(box_raft()) &&
+			 txn_limbo.owner_id == instance_id &&
+			 !txn_limbo_is_ro(&txn_limbo);
+	if (!has_lease) {
+		struct vclock confirmed_vclock;
+		vclock_create(&confirmed_vclock);
+		/*
+		 * First find out the vclock which might be confirmed on remote
+		 * instances.
+		 */
+		if (box_collect_confirmed_vclock(&confirmed_vclock,
+						 deadline) != 0)
+			return -1;
+		/*
+		 * Then wait until all the rows up to this vclock are
+		 * received.
+		 */
+		if (box_wait_vclock(&confirmed_vclock, deadline) != 0)
+			return -1;
+	}
 	/*
 	 * Finally, wait until all the synchronous transactions, which should be
 	 * visible to this tx, become visible.
@@ -3002,7 +3335,17 @@ box_promote_qsync(void)
 		diag_set(ClientError, ER_NOT_LEADER, raft->leader);
 		return -1;
 	}
-	return box_issue_promote(wait_lsn);
+	double promote_start = fiber_clock();
+	if (box_issue_promote(wait_lsn) != 0)
+		return -1;
+	struct box_raft_failover_stat *stat = &box_raft_failover_stat;
+	if (stat->term == raft->term) {
+		double now = fiber_clock();
+		stat->limbo_wait_time = promote_start - stat->leader_start;
+		stat->promote_time = now - promote_start;
+		stat->total_time = now - stat->leader_start;
+	}
+	return 0;
 }
 
 int
@@ -3159,6 +3502,54 @@ box_set_memtx_memory(void)
 	memtx_engine_set_memory_xc(memtx, size);
 }
 
+void
+box_set_memtx_numa_node(void)
+{
+	int node = box_check_memtx_numa_node();
+	if (node < -1)
+		diag_raise();
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	if (memtx_engine_set_numa_node(memtx, node) != 0)
+		diag_raise();
+}
+
+void
+box_set_memtx_use_huge_pages(void)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	if (memtx_engine_set_huge_pages(memtx,
+					cfg_getb("memtx_use_huge_pages")) != 0)
+		diag_raise();
+}
+
+void
+box_set_tx_cpu_affinity(void)
+{
+	if (box_check_cpu_affinity("tx_cpu_affinity") != 0 ||
+	    cord_set_cpu_affinity(cord(), cfg_gets("tx_cpu_affinity")) != 0)
+		diag_raise();
+}
+
+void
+box_set_wal_cpu_affinity(void)
+{
+	if (box_check_cpu_affinity("wal_cpu_affinity") != 0 ||
+	    wal_set_cpu_affinity(cfg_gets("wal_cpu_affinity")) != 0)
+		diag_raise();
+}
+
+void
+box_set_iproto_cpu_affinity(void)
+{
+	if (box_check_cpu_affinity("iproto_cpu_affinity") != 0 ||
+	    iproto_set_cpu_affinity(cfg_gets("iproto_cpu_affinity")) != 0)
+		diag_raise();
+}
+
 void
 box_set_memtx_max_tuple_size(void)
 {
@@ -3187,6 +3578,52 @@ box_set_readahead(void)
 	iproto_readahead = readahead;
 }
 
+void
+box_set_iproto_compression_threshold(void)
+{
+	int64_t threshold = box_check_iproto_compression_threshold();
+	if (threshold < 0)
+		diag_raise();
+	iproto_compression_threshold = threshold;
+}
+
+void
+box_set_iproto_busy_poll(void)
+{
+	double budget = box_check_iproto_busy_poll();
+	if (budget < 0)
+		diag_raise();
+	iproto_busy_poll = budget;
+}
+
+void
+box_set_iproto_slow_request_threshold(void)
+{
+	double threshold = box_check_iproto_slow_request_threshold();
+	if (threshold < 0)
+		diag_raise();
+	iproto_slow_request_threshold = threshold;
+}
+
+void
+box_set_iproto_wait_vclock_timeout(void)
+{
+	double timeout = box_check_iproto_wait_vclock_timeout();
+	if (timeout < 0)
+		diag_raise();
+	iproto_wait_vclock_timeout = timeout;
+}
+
+void
+box_set_iproto_read_view_interval(void)
+{
+	double interval = box_check_iproto_read_view_interval();
+	if (interval < 0)
+		diag_raise();
+	if (iproto_set_read_view_interval(interval) != 0)
+		diag_raise();
+}
+
 void
 box_set_checkpoint_count(void)
 {
@@ -3195,6 +3632,60 @@ box_set_checkpoint_count(void)
 	gc_set_min_checkpoint_count(checkpoint_count);
 }
 
+void
+box_set_memtx_checkpoint_delta_count(void)
+{
+	int count = cfg_geti("memtx_checkpoint_delta_count");
+	box_check_memtx_checkpoint_delta_count(count);
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_checkpoint_delta_count(memtx, count);
+}
+
+void
+box_set_memtx_snapshot_compress_threads(void)
+{
+	int count = cfg_geti("memtx_snapshot_compress_threads");
+	box_check_memtx_snapshot_compress_threads(count);
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_compress_threads(memtx, count);
+}
+
+void
+box_set_memtx_snapshot_compression_level(void)
+{
+	int level = cfg_geti("memtx_snapshot_compression_level");
+	box_check_memtx_snapshot_compression_level(level);
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_compression_level(memtx, level);
+}
+
+void
+box_set_memtx_ddl_rate_limit(void)
+{
+	double limit = cfg_getd("memtx_ddl_rate_limit");
+	box_check_memtx_ddl_rate_limit(limit);
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_ddl_rate_limit(memtx, limit);
+}
+
+void
+box_set_memtx_snapshot_index_order(void)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_index_order(
+		memtx, cfg_getb("memtx_snapshot_index_order"));
+}
+
 void
 box_set_checkpoint_interval(void)
 {
@@ -3202,13 +3693,47 @@ box_set_checkpoint_interval(void)
 	gc_set_checkpoint_interval(interval);
 }
 
-void
-box_set_checkpoint_wal_threshold(void)
+/**
+ * Set the size of WAL triggering a checkpoint. It's configured by
+ * box.cfg.checkpoint_wal_threshold, but is lowered if necessary to
+ * keep the time of recovery from the last checkpoint below
+ * box.cfg.checkpoint_recovery_time.
+ */
+static void
+box_update_checkpoint_wal_threshold(void)
 {
 	int64_t threshold = cfg_geti64("checkpoint_wal_threshold");
+	double recovery_time = cfg_getd("checkpoint_recovery_time");
+	if (recovery_time > 0) {
+		struct memtx_engine *memtx;
+		memtx = (struct memtx_engine *)engine_by_name("memtx");
+		assert(memtx != NULL);
+		int64_t snap_size = memtx_engine_checkpoint_size(memtx);
+		int64_t wal_size = checkpoint_recovery_wal_size(
+			&checkpoint_recovery_estimate, recovery_time,
+			snap_size);
+		say_verbose("checkpoint of %lld bytes, triggering next "
+			    "checkpoint after %lld bytes of WAL",
+			    (long long)snap_size, (long long)wal_size);
+		threshold = MIN(threshold, wal_size);
+	}
 	wal_set_checkpoint_threshold(threshold);
 }
 
+void
+box_set_checkpoint_wal_threshold(void)
+{
+	box_update_checkpoint_wal_threshold();
+}
+
+void
+box_set_checkpoint_recovery_time(void)
+{
+	box_check_checkpoint_recovery_time(
+		cfg_getd("checkpoint_recovery_time"));
+	box_update_checkpoint_wal_threshold();
+}
+
 int
 box_set_wal_queue_max_size(void)
 {
@@ -3219,6 +3744,16 @@ box_set_wal_queue_max_size(void)
 	return 0;
 }
 
+int
+box_set_wal_ring_size(void)
+{
+	int64_t size = box_check_wal_ring_size();
+	if (size < 0)
+		return -1;
+	wal_set_ring_size(size);
+	return 0;
+}
+
 int
 box_set_wal_cleanup_delay(void)
 {
@@ -3274,6 +3809,44 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
+void
+box_set_vinyl_os_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_os_cache(vinyl, cfg_getb("vinyl_os_cache"));
+}
+
+void
+box_set_vinyl_read_ahead(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	int64_t size = box_check_vinyl_read_ahead();
+	if (size < 0)
+		diag_raise();
+	vinyl_engine_set_read_ahead(vinyl, size);
+}
+
+void
+box_set_vinyl_read_latency_budget(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	double budget = box_check_vinyl_read_latency_budget();
+	if (budget < 0)
+		diag_raise();
+	vinyl_engine_set_read_latency_budget(vinyl, budget);
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -3787,7 +4360,7 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
 	   const char *key, const char *key_end,
 	   const char **packed_pos, const char **packed_pos_end,
-	   bool update_pos, struct port *port)
+	   bool update_pos, bool covering, struct port *port)
 {
 	(void)key_end;
 	assert(!update_pos || (packed_pos != NULL && packed_pos_end != NULL));
@@ -3809,6 +4382,22 @@ box_select(uint32_t space_id, uint32_t index_id,
 	struct index *index = index_find(space, index_id);
 	if (index == NULL)
 		return -1;
+	if (index_check_built(index) != 0)
+		return -1;
+	if (covering) {
+		if (index->def->key_def->is_multikey ||
+		    index->def->key_def->for_func_index) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "multikey or functional index",
+				 "covering select");
+			return -1;
+		}
+		if (update_pos || *packed_pos != NULL) {
+			diag_set(IllegalParams, "covering select doesn't "
+				 "support pagination");
+			return -1;
+		}
+	}
 
 	enum iterator_type type = (enum iterator_type) iterator;
 	const char *key_array = key;
@@ -3848,7 +4437,8 @@ box_select(uint32_t space_id, uint32_t index_id,
 		rc = box_check_slice();
 		if (rc != 0)
 			break;
-		rc = iterator_next(it, &tuple);
+		rc = covering ? iterator_next_key(it, &tuple) :
+				iterator_next(it, &tuple);
 		if (rc != 0 || tuple == NULL)
 			break;
 		if (offset > 0) {
@@ -3867,6 +4457,7 @@ box_select(uint32_t space_id, uint32_t index_id,
 	txn_end_ro_stmt(txn, &svp);
 	if (rc != 0)
 		goto fail;
+	space_stat_collect_select(space_id, found);
 
 	if (update_pos) {
 		uint32_t pos_size;
@@ -3895,12 +4486,13 @@ box_select(uint32_t space_id, uint32_t index_id,
 extern "C" int
 box_select_ffi(uint32_t space_id, uint32_t index_id, const char *key,
 	       const char *key_end, const char **packed_pos,
-	       const char **packed_pos_end, bool update_pos, struct port *port,
-	       int64_t iterator, uint64_t offset, uint64_t limit)
+	       const char **packed_pos_end, bool update_pos, bool covering,
+	       struct port *port, int64_t iterator, uint64_t offset,
+	       uint64_t limit)
 {
 	return box_select(space_id, index_id, iterator, offset, limit, key,
 			  key_end, packed_pos, packed_pos_end, update_pos,
-			  port);
+			  covering, port);
 }
 
 API_EXPORT int
@@ -4099,8 +4691,21 @@ box_sequence_next(uint32_t seq_id, int64_t *result)
 	int64_t value;
 	if (sequence_next(seq, &value) != 0)
 		return -1;
-	if (sequence_data_update(seq_id, value) != 0)
-		return -1;
+	if (seq->def->cache <= 1) {
+		if (sequence_data_update(seq_id, value) != 0)
+			return -1;
+	} else if (!sequence_is_preallocated(seq, value)) {
+		int64_t last = sequence_prealloc_last(seq, value);
+		if (sequence_data_update(seq_id, last) != 0)
+			return -1;
+		/*
+		 * The update set the sequence value to the last one
+		 * of the block and dropped the preallocated block.
+		 */
+		if (sequence_set(seq, value) != 0)
+			return -1;
+		sequence_prealloc(seq, value, last);
+	}
 	*result = value;
 	return 0;
 }
@@ -4784,6 +5389,21 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 		coio_write_xrow(io, &row);
 		sent_raft_term = req.term;
 	}
+	/*
+	 * Anonymous replicas aren't persisted, so keep the WAL files they
+	 * need only while they are subscribed. This way an anonymous
+	 * replica relaying rows onward to other anonymous replicas doesn't
+	 * lose the rows its followers haven't fetched yet. The consumer is
+	 * unregistered in replica_on_relay_stop().
+	 */
+	if (replica->anon) {
+		assert(replica->gc == NULL);
+		replica->gc = gc_consumer_register(&start_vclock,
+						   "anonymous replica %s",
+						   tt_uuid_str(&replica->uuid));
+		if (replica->gc == NULL)
+			diag_raise();
+	}
 	/*
 	 * Process SUBSCRIBE request via replication relay
 	 * Send current recovery vector clock as a marker
@@ -4797,7 +5417,8 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &start_vclock,
-			req.version_id, req.id_filter, sent_raft_term);
+			req.version_id, req.id_filter, sent_raft_term,
+			req.compression_level);
 }
 
 void
@@ -4909,6 +5530,8 @@ engine_init()
 				    cfg_getd("slab_alloc_factor"),
 				    cfg_geti("memtx_sort_threads"),
 				    box_on_indexes_built);
+	memtx_engine_set_background_index_build(
+		memtx, cfg_getb("memtx_background_index_build"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
 
@@ -4932,6 +5555,10 @@ engine_init()
 	engine_register((struct engine *)vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
+	box_set_vinyl_os_cache();
+	box_set_vinyl_read_ahead();
+	box_set_vinyl_read_latency_budget();
 	box_set_vinyl_timeout();
 }
 
@@ -5348,12 +5975,15 @@ local_recovery(const struct vclock *checkpoint_vclock)
 	 * recovery of system spaces issue DDL events in
 	 * other engines.
 	 */
+	double recovery_start = ev_monotonic_time();
 	memtx_engine_recover_snapshot_xc(memtx, checkpoint_vclock);
 
 	box_run_on_recovery_state(RECOVERY_STATE_SNAPSHOT_RECOVERED);
 
 	engine_begin_final_recovery_xc();
+	double wal_start = ev_monotonic_time();
 	recover_remaining_wals(recovery, &wal_stream.base, NULL, false);
+	double wal_time = ev_monotonic_time() - wal_start;
 	if (wal_stream_has_unfinished_tx(&wal_stream)) {
 		diag_set(XlogError, "found a not finished transaction "
 			 "in the log");
@@ -5366,7 +5996,8 @@ local_recovery(const struct vclock *checkpoint_vclock)
 	 * Leave hot standby mode, if any, only after
 	 * acquiring the lock.
 	 */
-	if (wal_dir_lock < 0) {
+	bool is_hot_standby = wal_dir_lock < 0;
+	if (is_hot_standby) {
 		title("hot_standby");
 		say_info("Entering hot standby mode");
 		engine_begin_hot_standby_xc();
@@ -5450,6 +6081,19 @@ local_recovery(const struct vclock *checkpoint_vclock)
 	engine_end_recovery_xc();
 	if (check_global_ids_integrity() != 0)
 		diag_raise();
+	/*
+	 * Building secondary keys on end of recovery is accounted as
+	 * loading the checkpoint. In hot standby mode the instance
+	 * spends most of the time waiting so the rates aren't known.
+	 */
+	if (!is_hot_standby) {
+		double snap_time = ev_monotonic_time() - recovery_start -
+				   wal_time;
+		checkpoint_recovery_estimate_update(
+			&checkpoint_recovery_estimate,
+			memtx_engine_checkpoint_size(memtx), snap_time,
+			recovery->read_size, wal_time);
+	}
 	box_run_on_recovery_state(RECOVERY_STATE_WAL_RECOVERED);
 }
 
@@ -5513,6 +6157,20 @@ box_cfg_xc(void)
 		diag_raise();
 	box_set_net_msg_max();
 	box_set_readahead();
+	box_set_iproto_compression_threshold();
+	box_set_iproto_busy_poll();
+	box_set_iproto_slow_request_threshold();
+	box_set_iproto_wait_vclock_timeout();
+	box_set_tx_cpu_affinity();
+	box_set_wal_cpu_affinity();
+	box_set_iproto_cpu_affinity();
+	box_set_memtx_numa_node();
+	box_set_memtx_use_huge_pages();
+	box_set_memtx_checkpoint_delta_count();
+	box_set_memtx_snapshot_compress_threads();
+	box_set_memtx_snapshot_compression_level();
+	box_set_memtx_ddl_rate_limit();
+	box_set_memtx_snapshot_index_order();
 	box_set_too_long_threshold();
 	box_set_replication_timeout();
 	if (box_set_bootstrap_strategy() != 0)
@@ -5527,12 +6185,20 @@ box_cfg_xc(void)
 		diag_raise();
 	if (box_set_replication_synchro_timeout() != 0)
 		diag_raise();
+	if (box_set_replication_synchro_confirm_delay() != 0)
+		diag_raise();
 	box_set_replication_sync_timeout();
 	box_set_replication_skip_conflict();
+	if (box_set_replication_apply_workers() != 0)
+		diag_raise();
+	if (box_set_replication_compression() != 0)
+		diag_raise();
 	if (box_check_instance_name(cfg_instance_name) != 0)
 		diag_raise();
 	if (box_set_wal_queue_max_size() != 0)
 		diag_raise();
+	if (box_set_wal_ring_size() != 0)
+		diag_raise();
 	cfg_replication_anon = box_check_replication_anon();
 	box_broadcast_ballot();
 	/*
@@ -5619,6 +6285,11 @@ box_cfg_xc(void)
 
 	is_box_configured = true;
 	box_broadcast_ballot();
+	/*
+	 * Start serving SELECT requests from a read view only after
+	 * recovery, when all spaces are ready.
+	 */
+	box_set_iproto_read_view_interval();
 	/*
 	 * Fill in leader election parameters after bootstrap. Before it is not
 	 * possible - there may be relevant data to recover from WAL and
@@ -5635,6 +6306,8 @@ box_cfg_xc(void)
 		diag_raise();
 	if (box_set_election_fencing_mode() != 0)
 		diag_raise();
+	if (box_set_election_lease_max_drift() != 0)
+		diag_raise();
 	/*
 	 * Election is enabled last. So as all the parameters are installed by
 	 * that time.
@@ -5771,6 +6444,15 @@ box_reset_space_stat(struct space *space, void *arg)
 	(void)arg;
 	for (uint32_t i = 0; i < space->index_count; i++)
 		index_reset_stat(space->index[i]);
+	space_reset_stat(space);
+	return 0;
+}
+
+static int
+box_reset_func_stat(struct func *func, void *arg)
+{
+	(void)arg;
+	func_reset_stat(func);
 	return 0;
 }
 
@@ -5781,6 +6463,13 @@ box_reset_stat(void)
 	rmean_cleanup(rmean_error);
 	engine_reset_stat();
 	space_foreach(box_reset_space_stat, NULL);
+	func_cache_foreach(box_reset_func_stat, NULL);
+}
+
+const struct fiber_pool *
+box_tx_fiber_pool(void)
+{
+	return &tx_fiber_pool;
 }
 
 static void
@@ -5876,13 +6565,21 @@ box_broadcast_election(void)
 }
 
 void
-box_broadcast_schema(void)
+box_broadcast_schema(uint32_t space_id)
 {
 	char buf[1024];
 	char *w = buf;
-	w = mp_encode_map(w, 1);
+	w = mp_encode_map(w, space_id != BOX_ID_NIL ? 2 : 1);
 	w = mp_encode_str0(w, "version");
 	w = mp_encode_uint(w, box_schema_version());
+	/*
+	 * Let clients that have the previous schema version
+	 * refetch only the changed space.
+	 */
+	if (space_id != BOX_ID_NIL) {
+		w = mp_encode_str0(w, "space_id");
+		w = mp_encode_uint(w, space_id);
+	}
 
 	box_broadcast("box.schema", strlen("box.schema"), buf, w);
 
@@ -5977,6 +6674,13 @@ on_garbage_collection(void)
 	box_broadcast_ballot();
 }
 
+static void
+on_checkpoint(void)
+{
+	/* The checkpoint size has changed. */
+	box_update_checkpoint_wal_threshold();
+}
+
 static void
 box_storage_init(void)
 {
@@ -5992,10 +6696,12 @@ box_storage_init(void)
 	rmean_box = rmean_new(iproto_type_strs, IPROTO_TYPE_STAT_MAX);
 	rmean_error = rmean_new(rmean_error_strings, RMEAN_ERROR_LAST);
 
-	gc_init(on_garbage_collection);
+	checkpoint_recovery_estimate_create(&checkpoint_recovery_estimate);
+	gc_init(on_garbage_collection, on_checkpoint);
 	engine_init();
 	schema_init();
 	replication_init(cfg_geti_default("replication_threads", 1));
+	iproto_reuseport = cfg_getb("iproto_reuseport");
 	iproto_init(cfg_geti("iproto_threads"));
 	sql_init();
 	audit_log_init();
@@ -54,6 +54,7 @@ struct space;
 struct vclock;
 struct key_def;
 struct ballot;
+struct fiber_pool;
 
 /**
  * Pointer to TX thread local vclock.
@@ -267,6 +268,13 @@ const char *box_status(void);
 void
 box_reset_stat(void);
 
+/**
+ * Return the pool of fibers handling messages from other threads,
+ * including iproto requests, in the transaction processor thread.
+ */
+const struct fiber_pool *
+box_tx_fiber_pool(void);
+
 /** Process an authentication request. */
 int
 box_process_auth(struct auth_request *request,
@@ -326,18 +334,35 @@ void box_set_readahead(void);
 void box_set_checkpoint_count(void);
 void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
+void box_set_checkpoint_recovery_time(void);
 int box_set_wal_queue_max_size(void);
+int box_set_wal_ring_size(void);
 int box_set_wal_cleanup_delay(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
+void box_set_memtx_numa_node(void);
+void box_set_memtx_use_huge_pages(void);
+void box_set_memtx_checkpoint_delta_count(void);
+void box_set_memtx_snapshot_compress_threads(void);
+void box_set_memtx_snapshot_compression_level(void);
+void box_set_memtx_ddl_rate_limit(void);
+void box_set_memtx_snapshot_index_order(void);
+void box_set_tx_cpu_affinity(void);
+void box_set_wal_cpu_affinity(void);
+void box_set_iproto_cpu_affinity(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
+void box_set_vinyl_os_cache(void);
+void box_set_vinyl_read_ahead(void);
+void box_set_vinyl_read_latency_budget(void);
 void box_set_vinyl_timeout(void);
 void box_set_force_recovery(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
 int box_set_election_fencing_mode(void);
+int box_set_election_lease_max_drift(void);
 void box_set_replication_timeout(void);
 void box_set_replication_connect_timeout(void);
 void box_set_replication_connect_quorum(void);
@@ -345,13 +370,21 @@ void box_set_replication_sync_lag(void);
 void box_update_replication_synchro_quorum(void);
 int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
+int box_set_replication_synchro_confirm_delay(void);
 void box_set_replication_sync_timeout(void);
 void box_set_replication_skip_conflict(void);
+int box_set_replication_apply_workers(void);
+int box_set_replication_compression(void);
 void box_set_replication_anon(void);
 void box_set_instance_name(void);
 void box_set_replicaset_name(void);
 void box_set_cluster_name(void);
 void box_set_net_msg_max(void);
+void box_set_iproto_read_view_interval(void);
+void box_set_iproto_compression_threshold(void);
+void box_set_iproto_busy_poll(void);
+void box_set_iproto_slow_request_threshold(void);
+void box_set_iproto_wait_vclock_timeout(void);
 int box_set_prepared_stmt_cache_size(void);
 int box_set_feedback(void);
 int box_set_txn_timeout(void);
@@ -392,6 +425,13 @@ box_promote_qsync(void);
 int
 box_wait_linearization_point(double timeout);
 
+/**
+ * Wait until this instance's vclock reaches @a vclock or @a deadline is
+ * reached. Component 0 is ignored.
+ */
+int
+box_wait_vclock(const struct vclock *vclock, double deadline);
+
 /**
  * Allocates memory on region and packs iterator position there.
  * Packed position is returned with packed_pos and packed_pos_end arguments.
@@ -429,6 +469,9 @@ box_make_bootstrap_leader(void);
  * If update_pos is true, packed_pos and packed_pos_end are updated to
  * position of last selected tuple. Returned position is allocated
  * on the fiber region.
+ * If covering is true, index keys (key parts followed by the included
+ * and primary key parts) are returned instead of full tuples. Covering
+ * selection can't be combined with pagination.
  * Pre-requesites: if update_pos is true, packed_pos and packed_pos_end must
  * not be NULL.
  */
@@ -437,7 +480,7 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
 	   const char *key, const char *key_end,
 	   const char **packed_pos, const char **packed_pos_end,
-	   bool update_pos, struct port *port);
+	   bool update_pos, bool covering, struct port *port);
 
 /** \cond public */
 
@@ -797,10 +840,12 @@ void
 box_broadcast_election(void);
 
 /**
- * Broadcast the current schema version
+ * Broadcast the current schema version. If the last schema change
+ * concerns only one space, @a space_id is its id, otherwise it's
+ * BOX_ID_NIL.
  */
 void
-box_broadcast_schema(void);
+box_broadcast_schema(uint32_t space_id);
 
 /** Broadcast this instance's ballot. */
 void
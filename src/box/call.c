@@ -215,8 +215,22 @@ box_process_call(struct call_request *request, struct port *port)
 	 * Find the function definition and check access.
 	 */
 	const char *name = request->name;
-	assert(name != NULL);
-	uint32_t name_len = mp_decode_strl(&name);
+	uint32_t name_len = 0;
+	struct func *func;
+	if (name != NULL) {
+		name_len = mp_decode_strl(&name);
+		func = func_by_name(name, name_len);
+	} else {
+		/* Calls by id are allowed only for persistent functions. */
+		func = func_by_id(request->func_id);
+		if (func == NULL) {
+			diag_set(ClientError, ER_NO_SUCH_FUNCTION,
+				 int2str(request->func_id));
+			return -1;
+		}
+		name = func->def->name;
+		name_len = func->def->name_len;
+	}
 	struct mp_box_ctx ctx;
 	if (mp_box_ctx_create(&ctx, NULL, request->tuple_formats) != 0)
 		return -1;
@@ -224,7 +238,6 @@ box_process_call(struct call_request *request, struct port *port)
 	port_msgpack_create_with_ctx(&args, request->args,
 				     request->args_end - request->args,
 				     (struct mp_ctx *)&ctx);
-	struct func *func = func_by_name(name, name_len);
 	int rc = 0;
 	if (func != NULL) {
 		if (func_access_check(func) != 0) {
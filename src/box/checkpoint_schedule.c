@@ -34,6 +34,36 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <trivia/util.h>
+
+enum {
+	/**
+	 * Min number of bytes read on recovery to measure the rate
+	 * of loading checkpoint or replaying WAL files.
+	 */
+	CHECKPOINT_RECOVERY_SAMPLE_MIN = 16 * 1024 * 1024,
+	/**
+	 * Min size of WAL triggering a checkpoint when the recovery
+	 * time is limited.
+	 */
+	CHECKPOINT_RECOVERY_WAL_SIZE_MIN = 1024 * 1024,
+};
+
+/**
+ * Default recovery rates, in bytes per second. Replaying WAL is
+ * slower than loading a checkpoint because rows are applied one by
+ * one to all indexes.
+ */
+static const double CHECKPOINT_RECOVERY_SNAP_RATE_DEFAULT = 200e6;
+static const double CHECKPOINT_RECOVERY_WAL_RATE_DEFAULT = 50e6;
+
+/**
+ * If the recovery time target can't be met, the next checkpoint is
+ * triggered when replaying WAL takes this share of the checkpoint
+ * load time.
+ */
+static const double CHECKPOINT_RECOVERY_WAL_SHARE_MIN = 0.1;
+
 void
 checkpoint_schedule_cfg(struct checkpoint_schedule *sched,
 			double now, double interval)
@@ -74,3 +104,43 @@ checkpoint_schedule_timeout(struct checkpoint_schedule *sched, double now)
 	assert(timeout > 0);
 	return timeout;
 }
+
+void
+checkpoint_recovery_estimate_create(struct checkpoint_recovery_estimate *est)
+{
+	est->snap_rate = CHECKPOINT_RECOVERY_SNAP_RATE_DEFAULT;
+	est->wal_rate = CHECKPOINT_RECOVERY_WAL_RATE_DEFAULT;
+}
+
+void
+checkpoint_recovery_estimate_update(struct checkpoint_recovery_estimate *est,
+				    int64_t snap_size, double snap_time,
+				    int64_t wal_size, double wal_time)
+{
+	if (snap_size >= CHECKPOINT_RECOVERY_SAMPLE_MIN && snap_time > 0)
+		est->snap_rate = snap_size / snap_time;
+	if (wal_size >= CHECKPOINT_RECOVERY_SAMPLE_MIN && wal_time > 0)
+		est->wal_rate = wal_size / wal_time;
+}
+
+double
+checkpoint_recovery_estimate_time(struct checkpoint_recovery_estimate *est,
+				  int64_t snap_size, int64_t wal_size)
+{
+	return snap_size / est->snap_rate + wal_size / est->wal_rate;
+}
+
+int64_t
+checkpoint_recovery_wal_size(struct checkpoint_recovery_estimate *est,
+			     double target, int64_t snap_size)
+{
+	assert(target > 0);
+	double snap_time = snap_size / est->snap_rate;
+	double wal_time = MAX(target - snap_time,
+			      snap_time * CHECKPOINT_RECOVERY_WAL_SHARE_MIN);
+	double wal_size = wal_time * est->wal_rate;
+	if (wal_size >= (double)INT64_MAX)
+		return INT64_MAX;
+	return MAX((int64_t)wal_size,
+		   (int64_t)CHECKPOINT_RECOVERY_WAL_SIZE_MIN);
+}
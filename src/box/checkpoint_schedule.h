@@ -30,6 +30,7 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stdint.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -78,6 +79,59 @@ checkpoint_schedule_reset(struct checkpoint_schedule *sched, double now);
 double
 checkpoint_schedule_timeout(struct checkpoint_schedule *sched, double now);
 
+/**
+ * Estimate of the time it takes to recover from a checkpoint and
+ * the WAL written after it. Used for triggering checkpoints so that
+ * recovery doesn't take longer than box.cfg.checkpoint_recovery_time.
+ */
+struct checkpoint_recovery_estimate {
+	/** Rate of loading checkpoint files, in bytes per second. */
+	double snap_rate;
+	/** Rate of replaying WAL files, in bytes per second. */
+	double wal_rate;
+};
+
+/**
+ * Initialize a recovery estimate with the default rates, which are
+ * used until the actual ones are observed on recovery.
+ */
+void
+checkpoint_recovery_estimate_create(struct checkpoint_recovery_estimate *est);
+
+/**
+ * Update a recovery estimate with the rates observed on recovery.
+ *
+ * @snap_size bytes of checkpoint files were loaded in @snap_time
+ * seconds, @wal_size bytes of WAL files were replayed in @wal_time
+ * seconds. A rate is left unchanged if too little data was read to
+ * measure it reliably.
+ */
+void
+checkpoint_recovery_estimate_update(struct checkpoint_recovery_estimate *est,
+				    int64_t snap_size, double snap_time,
+				    int64_t wal_size, double wal_time);
+
+/**
+ * Return the estimated time of recovery from a checkpoint of
+ * @snap_size bytes and @wal_size bytes of WAL written after it.
+ */
+double
+checkpoint_recovery_estimate_time(struct checkpoint_recovery_estimate *est,
+				  int64_t snap_size, int64_t wal_size);
+
+/**
+ * Return the size of WAL that may be written after a checkpoint of
+ * @snap_size bytes so that recovery doesn't take longer than @target
+ * seconds, i.e. the WAL size that should trigger the next checkpoint.
+ *
+ * If loading the checkpoint alone takes longer than @target, the
+ * target can't be met, and the returned size is limited from below
+ * so that checkpoints aren't made back to back.
+ */
+int64_t
+checkpoint_recovery_wal_size(struct checkpoint_recovery_estimate *est,
+			     double target, int64_t snap_size);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
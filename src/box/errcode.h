@@ -431,6 +431,9 @@ struct errcode_record {
 	 */ \
 	_(ER_READ_VIEW_BUSY, 285,		"The read view is busy") \
 	_(ER_READ_VIEW_CLOSED, 286,		"The read view is closed") \
+	_(ER_NO_SUCH_CURSOR, 287,		"No such cursor") \
+	_(ER_CURSOR_LIMIT, 288,			"Too many open cursors") \
+	_(ER_TXN_READ_ONLY, 289,		"Can't modify data in a read-only transaction") \
 	TEST_ERROR_CODES(_) /** This one should be last. */
 
 /*
@@ -154,7 +154,16 @@ const char *rmean_error_strings[RMEAN_ERROR_LAST] = {
 	"ERROR"
 };
 
-/** Format client error with arguments in `ap` according to error format. */
+/**
+ * Format client error with arguments in `ap` according to error format.
+ *
+ * Note that the message is formatted eagerly, because error::errmsg is
+ * read directly by all users of struct error, and the error may be moved
+ * to another thread or outlive the objects it refers to, e.g. the tuples
+ * reported by ER_TUPLE_FOUND. For the same reason error objects aren't
+ * preallocated per fiber: an error is reference counted and may stay
+ * alive in Lua or in a diag of a cbus message after the fiber is reused.
+ */
 static void
 client_error_create(struct error *e, va_list ap)
 {
@@ -50,6 +50,7 @@
 #include "rmean.h"
 #include "box/sql/port.h"
 #include "tweaks.h"
+#include "clock.h"
 
 const char *sql_info_key_strs[] = {
 	"row_count",
@@ -116,6 +117,42 @@ sql_stmt_schema_version_is_valid(struct Vdbe *stmt)
 	return sql_stmt_schema_version(stmt) == box_schema_version();
 }
 
+/**
+ * Compile statement and account the compilation time in
+ * the prepared statement cache statistics.
+ */
+static int
+sql_compile(const char *sql, int len, struct Vdbe **stmt)
+{
+	double start = clock_monotonic();
+	int rc = sql_stmt_compile(sql, len, NULL, stmt, NULL);
+	sql_stmt_cache_miss(clock_monotonic() - start);
+	return rc;
+}
+
+/**
+ * Look up a statement with the given SQL text compiled by any
+ * session that can be executed right away: compiled against the
+ * current schema with the same session SQL flags and not being
+ * executed at the moment. Return NULL if there's no such statement.
+ */
+static struct Vdbe *
+sql_stmt_cache_lookup(const char *sql, int len)
+{
+	struct Vdbe *stmt = sql_stmt_cache_find(sql_stmt_calculate_id(sql,
+								      len));
+	if (stmt == NULL)
+		return NULL;
+	/* Statement id is a hash, so it may collide. */
+	const char *sql_str = sql_stmt_query_str(stmt);
+	if (strlen(sql_str) != (size_t)len || memcmp(sql_str, sql, len) != 0)
+		return NULL;
+	if (!sql_stmt_schema_version_is_valid(stmt) || sql_stmt_busy(stmt) ||
+	    sql_stmt_sql_flags(stmt) != current_session()->sql_flags)
+		return NULL;
+	return stmt;
+}
+
 /**
  * Re-compile statement and refresh global prepared statement
  * cache with the newest value.
@@ -125,8 +162,7 @@ sql_reprepare(struct Vdbe **stmt)
 {
 	const char *sql_str = sql_stmt_query_str(*stmt);
 	struct Vdbe *new_stmt;
-	if (sql_stmt_compile(sql_str, strlen(sql_str), NULL,
-			     &new_stmt, NULL) != 0)
+	if (sql_compile(sql_str, strlen(sql_str), &new_stmt) != 0)
 		return -1;
 	if (sql_stmt_cache_update(*stmt, new_stmt) != 0)
 		return -1;
@@ -146,18 +182,18 @@ sql_prepare(const char *sql, int len, struct port *port)
 	struct Vdbe *stmt = sql_stmt_cache_find(stmt_id);
 	rmean_collect(rmean_box, IPROTO_PREPARE, 1);
 	if (stmt == NULL) {
-		if (sql_stmt_compile(sql, len, NULL, &stmt, NULL) != 0)
+		if (sql_compile(sql, len, &stmt) != 0)
 			return -1;
 		if (sql_stmt_cache_insert(stmt) != 0) {
 			sql_stmt_finalize(stmt);
 			return -1;
 		}
+	} else if (!sql_stmt_schema_version_is_valid(stmt) &&
+		   !sql_stmt_busy(stmt)) {
+		if (sql_reprepare(&stmt) != 0)
+			return -1;
 	} else {
-		if (!sql_stmt_schema_version_is_valid(stmt) &&
-		    !sql_stmt_busy(stmt)) {
-			if (sql_reprepare(&stmt) != 0)
-				return -1;
-		}
+		sql_stmt_cache_hit();
 	}
 	assert(stmt != NULL);
 	/* Add id to the list of available statements in session. */
@@ -224,6 +260,38 @@ sql_execute(struct Vdbe *stmt, struct port *port, struct region *region)
 	return 0;
 }
 
+/**
+ * Bind parameters to a statement from the prepared statement
+ * cache and execute it. The statement is reset afterwards, so
+ * it can be reused.
+ */
+static int
+sql_execute_cached(struct Vdbe *stmt, const struct sql_bind *bind,
+		   uint32_t bind_count, struct port *port,
+		   struct region *region)
+{
+	sql_stmt_cache_hit();
+	/*
+	 * Clear all set from previous execution cycle values to be bound and
+	 * remove autoincrement IDs generated in that cycle.
+	 */
+	sql_unbind(stmt);
+	if (sql_bind(stmt, bind, bind_count) != 0)
+		return -1;
+	sql_reset_autoinc_id_list(stmt);
+	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
+					       DQL_EXECUTE : DML_EXECUTE;
+	port_sql_create(port, stmt, format, false);
+	if (sql_execute(stmt, port, region) != 0) {
+		port_destroy(port);
+		sql_stmt_reset(stmt);
+		return -1;
+	}
+	sql_stmt_reset(stmt);
+
+	return 0;
+}
+
 int
 sql_execute_prepared(uint32_t stmt_id, const struct sql_bind *bind,
 		     uint32_t bind_count, struct port *port,
@@ -245,25 +313,7 @@ sql_execute_prepared(uint32_t stmt_id, const struct sql_bind *bind,
 		return sql_prepare_and_execute(sql_str, strlen(sql_str), bind,
 					       bind_count, port, region);
 	}
-	/*
-	 * Clear all set from previous execution cycle values to be bound and
-	 * remove autoincrement IDs generated in that cycle.
-	 */
-	sql_unbind(stmt);
-	if (sql_bind(stmt, bind, bind_count) != 0)
-		return -1;
-	sql_reset_autoinc_id_list(stmt);
-	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
-					       DQL_EXECUTE : DML_EXECUTE;
-	port_sql_create(port, stmt, format, false);
-	if (sql_execute(stmt, port, region) != 0) {
-		port_destroy(port);
-		sql_stmt_reset(stmt);
-		return -1;
-	}
-	sql_stmt_reset(stmt);
-
-	return 0;
+	return sql_execute_cached(stmt, bind, bind_count, port, region);
 }
 
 int
@@ -271,8 +321,14 @@ sql_prepare_and_execute(const char *sql, int len, const struct sql_bind *bind,
 			uint32_t bind_count, struct port *port,
 			struct region *region)
 {
-	struct Vdbe *stmt;
-	if (sql_stmt_compile(sql, len, NULL, &stmt, NULL) != 0)
+	/*
+	 * Reuse the statement if it has already been prepared by
+	 * any session instead of compiling it again.
+	 */
+	struct Vdbe *stmt = sql_stmt_cache_lookup(sql, len);
+	if (stmt != NULL)
+		return sql_execute_cached(stmt, bind, bind_count, port, region);
+	if (sql_compile(sql, len, &stmt) != 0)
 		return -1;
 	assert(stmt != NULL);
 	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
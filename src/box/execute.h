@@ -104,6 +104,10 @@ sql_stmt_query_str(const struct Vdbe *stmt);
 int
 sql_stmt_busy(const struct Vdbe *stmt);
 
+/** Return session SQL flags the statement was compiled with. */
+uint32_t
+sql_stmt_sql_flags(const struct Vdbe *stmt);
+
 /**
  * Prepare (compile into VDBE byte-code) statement.
  *
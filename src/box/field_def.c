@@ -377,6 +377,7 @@ static const struct opt_def field_def_reg[] = {
 	OPT_DEF("collation", OPT_UINT32, struct field_def, coll_id),
 	OPT_DEF_ENUM("compression", compression_type, struct field_def,
 		     compression_type, NULL),
+	OPT_DEF("interned", OPT_BOOL, struct field_def, is_interned),
 	OPT_DEF_CUSTOM("default", field_def_parse_default_value),
 	OPT_DEF("default_func", OPT_UINT32, struct field_def, default_func_id),
 	OPT_DEF_CUSTOM("constraint", field_def_parse_constraint),
@@ -398,6 +399,7 @@ const struct field_def field_def_default = {
 	.default_value = NULL,
 	.default_value_size = 0,
 	.default_func_id = 0,
+	.is_interned = false,
 	.constraint_count = 0,
 	.constraint_def = NULL,
 };
@@ -573,6 +575,16 @@ field_def_decode(struct field_def *field, const char **data,
 		field_def_error(fieldno, "unknown compression type");
 		return -1;
 	}
+	if (field->is_interned && field->type != FIELD_TYPE_STRING) {
+		field_def_error(fieldno, "interning is reasonable only for "
+				"'string' fields");
+		return -1;
+	}
+	if (field->is_interned &&
+	    field->compression_type != COMPRESSION_TYPE_NONE) {
+		field_def_error(fieldno, "interned field can't be compressed");
+		return -1;
+	}
 	return 0;
 }
 
@@ -155,6 +155,11 @@ struct field_def {
 	uint32_t default_func_id;
 	/** Compression type for this field. */
 	enum compression_type compression_type;
+	/**
+	 * True if values of this field are interned, i.e. stored in
+	 * tuples as ids in the dictionary of the space format.
+	 */
+	bool is_interned;
 	/** Array of constraints. Can be NULL if constraints_count == 0. */
 	struct tuple_constraint_def *constraint_def;
 	/** Number of constraints. */
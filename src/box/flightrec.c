@@ -0,0 +1,696 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "flightrec.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "box.h"
+#include "cfg.h"
+#include "clock.h"
+#include "diag.h"
+#include "errcode.h"
+#include "error.h"
+#include "fiber.h"
+#include "iproto.h"
+#include "msgpuck.h"
+#include "prbuf.h"
+#include "rmean.h"
+#include "say.h"
+#include "small/obuf.h"
+#include "small/util.h"
+#include "trivia/config.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "tt_static.h"
+#include "txn.h"
+
+#if defined(ENABLE_FLIGHT_RECORDER)
+# error unimplemented
+#endif
+
+/**
+ * Layout of the flight recorder file:
+ *
+ *   HEADER (page) SECTION (page aligned) SECTION ...
+ *
+ * The header stores the offsets and sizes of the sections. Each section is
+ * a prbuf so it can be read from the file even if the instance crashed.
+ * A disabled section has zero size. Every record is a MsgPack map:
+ *
+ *   logs:     {time, level, file, line, message}
+ *   requests: {time, type = 'request' | 'response', size, data}
+ *   metrics:  {time, box = {NAME = {rps, total}}, net = {NAME = ...}}
+ *
+ * where data is a string with the IPROTO packet truncated to the configured
+ * maximum and size is the original size of the packet.
+ */
+struct PACKED flightrec_file_header {
+	/** Always equals to flightrec_magic. */
+	char magic[4];
+	/** File format version. */
+	uint32_t version;
+	/** Location of the sections in the file. */
+	struct PACKED {
+		uint64_t offset;
+		uint64_t size;
+	} sections[flightrec_section_MAX];
+};
+
+static const char flightrec_magic[4] = {'T', 'T', 'F', 'R'};
+
+enum {
+	/** Version of the file format. Bump on incompatible changes. */
+	FLIGHTREC_VERSION = 1,
+	/** Sections are aligned in the file by this boundary. */
+	FLIGHTREC_ALIGN = 4096,
+	/** Minimal size of a non-empty section. */
+	FLIGHTREC_SECTION_SIZE_MIN = 4096,
+	/** Maximal size of a section, limited by prbuf. */
+	FLIGHTREC_SECTION_SIZE_MAX = 1 << 30,
+	/** Maximal size of a log message stored in the flight recorder. */
+	FLIGHTREC_LOG_MSG_SIZE_MAX = 16384,
+	/** Maximal number of counters in a box.stat() or net snapshot. */
+	FLIGHTREC_STAT_ITEM_MAX = 64,
+	/** Space reserved for a single metrics record. */
+	FLIGHTREC_METRICS_RECORD_SIZE = 2048,
+};
+
+const char *flightrec_section_strs[] = {
+	/* [FLIGHTREC_LOGS]     = */ "logs",
+	/* [FLIGHTREC_REQUESTS] = */ "requests",
+	/* [FLIGHTREC_METRICS]  = */ "metrics",
+};
+
+static_assert(lengthof(flightrec_section_strs) == flightrec_section_MAX,
+	      "flightrec_section_strs must match flightrec_section");
+
+/** Flight recorder configuration, see box.cfg.flightrec_*. */
+struct flightrec_cfg {
+	bool enabled;
+	int64_t logs_size;
+	int64_t logs_max_msg_size;
+	int logs_log_level;
+	double metrics_interval;
+	double metrics_period;
+	int64_t requests_size;
+	int64_t requests_max_req_size;
+	int64_t requests_max_res_size;
+};
+
+static struct flightrec {
+	/** Current configuration. */
+	struct flightrec_cfg cfg;
+	/** Descriptor of the file or -1 if the recorder is disabled. */
+	int fd;
+	/** Memory the file is mapped to. */
+	char *map;
+	/** Size of the mapped memory. */
+	size_t map_size;
+	/** Section buffers. header is NULL if a section is disabled. */
+	struct prbuf sections[flightrec_section_MAX];
+	/**
+	 * Log messages may be written by any thread so writes to the logs
+	 * section and its destruction are serialized with this mutex.
+	 */
+	pthread_mutex_t logs_mutex;
+	/** Fiber writing metrics records or NULL. */
+	struct fiber *metrics_fiber;
+	/**
+	 * Set after the file left by the previous run was renamed so that
+	 * it isn't overwritten by reconfiguration.
+	 */
+	bool is_prev_file_saved;
+} flightrec = {
+	.fd = -1,
+	.logs_mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/** Size of a MsgPack string with the given zero terminated contents. */
+static inline uint32_t
+flightrec_sizeof_str(const char *str)
+{
+	return mp_sizeof_str(strlen(str));
+}
+
+static inline char *
+flightrec_encode_str(char *data, const char *str)
+{
+	return mp_encode_str(data, str, strlen(str));
+}
+
+/**
+ * Writes a log record with the given message to the logs section.
+ * Must be called under the logs mutex.
+ */
+static void
+flightrec_write_log_record(int level, const char *filename, int line,
+			   const char *msg, size_t len)
+{
+	struct prbuf *buf = &flightrec.sections[FLIGHTREC_LOGS];
+	if (buf->header == NULL)
+		return;
+	if (filename == NULL)
+		filename = "";
+	double now = clock_realtime();
+	size_t size = mp_sizeof_map(5) +
+		      flightrec_sizeof_str("time") + mp_sizeof_double(now) +
+		      flightrec_sizeof_str("level") + mp_sizeof_uint(level) +
+		      flightrec_sizeof_str("file") +
+		      flightrec_sizeof_str(filename) +
+		      flightrec_sizeof_str("line") + mp_sizeof_uint(line) +
+		      flightrec_sizeof_str("message");
+	/* Truncate the message if it doesn't fit in the buffer. */
+	size_t max_size = prbuf_max_record_size(buf);
+	if (size + mp_sizeof_str(UINT32_MAX) > max_size)
+		return;
+	len = MIN(len, max_size - size - mp_sizeof_str(UINT32_MAX));
+	size += mp_sizeof_str(len);
+	char *data = prbuf_prepare(buf, size);
+	if (data == NULL)
+		return;
+	data = mp_encode_map(data, 5);
+	data = flightrec_encode_str(data, "time");
+	data = mp_encode_double(data, now);
+	data = flightrec_encode_str(data, "level");
+	data = mp_encode_uint(data, level);
+	data = flightrec_encode_str(data, "file");
+	data = flightrec_encode_str(data, filename);
+	data = flightrec_encode_str(data, "line");
+	data = mp_encode_uint(data, line);
+	data = flightrec_encode_str(data, "message");
+	mp_encode_str(data, msg, len);
+	prbuf_commit(buf);
+}
+
+/**
+ * Writes a log message to the flight recorder. Installed as
+ * log_write_flightrec, may be called by any thread.
+ */
+static void
+flightrec_write_log(int level, const char *filename, int line,
+		    const char *error, const char *format, va_list ap)
+{
+	char msg[FLIGHTREC_LOG_MSG_SIZE_MAX];
+	size_t msg_size = MIN((size_t)flightrec.cfg.logs_max_msg_size,
+			      sizeof(msg));
+	int len = vsnprintf(msg, msg_size, format, ap);
+	if (len < 0)
+		return;
+	len = MIN((size_t)len, msg_size - 1);
+	if (error != NULL && (size_t)len < msg_size - 1) {
+		int rc = snprintf(msg + len, msg_size - len, ": %s", error);
+		if (rc > 0)
+			len = MIN((size_t)(len + rc), msg_size - 1);
+	}
+	tt_pthread_mutex_lock(&flightrec.logs_mutex);
+	flightrec_write_log_record(level, filename, line, msg, len);
+	tt_pthread_mutex_unlock(&flightrec.logs_mutex);
+}
+
+/**
+ * Prepares a requests section record for an IPROTO packet of the given
+ * size and type ('request' or 'response'). Returns a pointer to write
+ * the packet data to and the size of the data to write, which may be less
+ * than the packet size. Returns NULL if the packet shouldn't be written.
+ */
+static char *
+flightrec_prepare_packet(const char *type, size_t packet_size,
+			 int64_t max_size, size_t *data_size)
+{
+	struct prbuf *buf = &flightrec.sections[FLIGHTREC_REQUESTS];
+	if (buf->header == NULL || max_size == 0)
+		return NULL;
+	double now = clock_realtime();
+	size_t size = mp_sizeof_map(4) +
+		      flightrec_sizeof_str("time") + mp_sizeof_double(now) +
+		      flightrec_sizeof_str("type") +
+		      flightrec_sizeof_str(type) +
+		      flightrec_sizeof_str("size") +
+		      mp_sizeof_uint(packet_size) +
+		      flightrec_sizeof_str("data");
+	size_t record_size_max = prbuf_max_record_size(buf);
+	if (size + mp_sizeof_str(UINT32_MAX) > record_size_max)
+		return NULL;
+	size_t len = MIN(packet_size, (size_t)max_size);
+	len = MIN(len, record_size_max - size - mp_sizeof_str(UINT32_MAX));
+	size += mp_sizeof_str(len);
+	char *data = prbuf_prepare(buf, size);
+	if (data == NULL)
+		return NULL;
+	data = mp_encode_map(data, 4);
+	data = flightrec_encode_str(data, "time");
+	data = mp_encode_double(data, now);
+	data = flightrec_encode_str(data, "type");
+	data = flightrec_encode_str(data, type);
+	data = flightrec_encode_str(data, "size");
+	data = mp_encode_uint(data, packet_size);
+	data = flightrec_encode_str(data, "data");
+	data = mp_encode_strl(data, len);
+	*data_size = len;
+	return data;
+}
+
+void
+flightrec_write_request(const char *request_msgpack, size_t len)
+{
+	size_t size;
+	char *data = flightrec_prepare_packet(
+		"request", len, flightrec.cfg.requests_max_req_size, &size);
+	if (data == NULL)
+		return;
+	memcpy(data, request_msgpack, size);
+	prbuf_commit(&flightrec.sections[FLIGHTREC_REQUESTS]);
+}
+
+void
+flightrec_write_response(struct obuf *buf, struct obuf_svp *svp)
+{
+	size_t size;
+	char *data = flightrec_prepare_packet(
+		"response", obuf_size(buf) - svp->used,
+		flightrec.cfg.requests_max_res_size, &size);
+	if (data == NULL)
+		return;
+	int pos = svp->pos;
+	size_t offset = svp->iov_len;
+	while (size > 0) {
+		size_t len = MIN(buf->iov[pos].iov_len - offset, size);
+		memcpy(data, (char *)buf->iov[pos].iov_base + offset, len);
+		data += len;
+		size -= len;
+		offset = 0;
+		pos++;
+	}
+	prbuf_commit(&flightrec.sections[FLIGHTREC_REQUESTS]);
+}
+
+/** Snapshot of statistics counters. */
+struct flightrec_stat {
+	int count;
+	struct {
+		const char *name;
+		uint64_t rps;
+		uint64_t total;
+	} items[FLIGHTREC_STAT_ITEM_MAX];
+};
+
+/** rmean_foreach() callback that appends a counter to a snapshot. */
+static int
+flightrec_stat_collect(const char *name, int rps, int64_t total, void *arg)
+{
+	struct flightrec_stat *stat = arg;
+	if (name == NULL)
+		return 0;
+	if (stat->count == lengthof(stat->items))
+		return 1;
+	stat->items[stat->count].name = name;
+	stat->items[stat->count].rps = MAX(rps, 0);
+	stat->items[stat->count].total = MAX(total, 0);
+	stat->count++;
+	return 0;
+}
+
+/** Size of a snapshot encoded as a map: NAME = {rps, total}. */
+static size_t
+flightrec_stat_sizeof(const struct flightrec_stat *stat)
+{
+	size_t size = mp_sizeof_map(stat->count);
+	for (int i = 0; i < stat->count; i++) {
+		size += flightrec_sizeof_str(stat->items[i].name) +
+			mp_sizeof_map(2) +
+			flightrec_sizeof_str("rps") +
+			mp_sizeof_uint(stat->items[i].rps) +
+			flightrec_sizeof_str("total") +
+			mp_sizeof_uint(stat->items[i].total);
+	}
+	return size;
+}
+
+static char *
+flightrec_stat_encode(char *data, const struct flightrec_stat *stat)
+{
+	data = mp_encode_map(data, stat->count);
+	for (int i = 0; i < stat->count; i++) {
+		data = flightrec_encode_str(data, stat->items[i].name);
+		data = mp_encode_map(data, 2);
+		data = flightrec_encode_str(data, "rps");
+		data = mp_encode_uint(data, stat->items[i].rps);
+		data = flightrec_encode_str(data, "total");
+		data = mp_encode_uint(data, stat->items[i].total);
+	}
+	return data;
+}
+
+/** Writes a snapshot of box.stat() and box.stat.net() counters. */
+static void
+flightrec_write_metrics(void)
+{
+	struct prbuf *buf = &flightrec.sections[FLIGHTREC_METRICS];
+	if (buf->header == NULL || !box_is_configured())
+		return;
+	struct flightrec_stat box_stat, net_stat;
+	box_stat.count = 0;
+	rmean_foreach(rmean_box, flightrec_stat_collect, &box_stat);
+	net_stat.count = 0;
+	iproto_rmean_foreach(flightrec_stat_collect, &net_stat);
+	double now = clock_realtime();
+	size_t size = mp_sizeof_map(3) +
+		      flightrec_sizeof_str("time") + mp_sizeof_double(now) +
+		      flightrec_sizeof_str("box") +
+		      flightrec_stat_sizeof(&box_stat) +
+		      flightrec_sizeof_str("net") +
+		      flightrec_stat_sizeof(&net_stat);
+	if (size > FLIGHTREC_METRICS_RECORD_SIZE)
+		return;
+	char *data = prbuf_prepare(buf, size);
+	if (data == NULL)
+		return;
+	data = mp_encode_map(data, 3);
+	data = flightrec_encode_str(data, "time");
+	data = mp_encode_double(data, now);
+	data = flightrec_encode_str(data, "box");
+	data = flightrec_stat_encode(data, &box_stat);
+	data = flightrec_encode_str(data, "net");
+	flightrec_stat_encode(data, &net_stat);
+	prbuf_commit(buf);
+}
+
+static int
+flightrec_metrics_f(va_list ap)
+{
+	(void)ap;
+	while (!fiber_is_cancelled()) {
+		fiber_sleep(flightrec.cfg.metrics_interval);
+		if (fiber_is_cancelled())
+			break;
+		flightrec_write_metrics();
+	}
+	return 0;
+}
+
+/** Size of the metrics section that fits the configured period. */
+static int64_t
+flightrec_metrics_size(const struct flightrec_cfg *cfg)
+{
+	if (cfg->metrics_period == 0)
+		return 0;
+	/* Reserve space for prbuf metadata and the size of each record. */
+	double count = ceil(cfg->metrics_period / cfg->metrics_interval) + 1;
+	double size = count * (FLIGHTREC_METRICS_RECORD_SIZE + 4) + 16;
+	if (size > FLIGHTREC_SECTION_SIZE_MAX)
+		return -1;
+	return MAX((int64_t)size, (int64_t)FLIGHTREC_SECTION_SIZE_MIN);
+}
+
+static int
+flightrec_check_section_size(const char *name, int64_t size)
+{
+	if (size != 0 && (size < FLIGHTREC_SECTION_SIZE_MIN ||
+			  size > FLIGHTREC_SECTION_SIZE_MAX)) {
+		diag_set(ClientError, ER_CFG, name,
+			 tt_sprintf("must be 0 or between %d and %d",
+				    FLIGHTREC_SECTION_SIZE_MIN,
+				    FLIGHTREC_SECTION_SIZE_MAX));
+		return -1;
+	}
+	return 0;
+}
+
+static int
+flightrec_check_max_size(const char *name, int64_t size)
+{
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, name,
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	return 0;
+}
+
+/** Reads and checks the flight recorder configuration. */
+static int
+flightrec_cfg_get(struct flightrec_cfg *cfg)
+{
+	cfg->enabled = cfg_getb("flightrec_enabled");
+	cfg->logs_size = cfg_geti64("flightrec_logs_size");
+	cfg->logs_max_msg_size = cfg_geti64("flightrec_logs_max_msg_size");
+	cfg->logs_log_level = cfg_geti("flightrec_logs_log_level");
+	cfg->metrics_interval = cfg_getd("flightrec_metrics_interval");
+	cfg->metrics_period = cfg_getd("flightrec_metrics_period");
+	cfg->requests_size = cfg_geti64("flightrec_requests_size");
+	cfg->requests_max_req_size =
+		cfg_geti64("flightrec_requests_max_req_size");
+	cfg->requests_max_res_size =
+		cfg_geti64("flightrec_requests_max_res_size");
+	if (flightrec_check_section_size("flightrec_logs_size",
+					 cfg->logs_size) != 0 ||
+	    flightrec_check_section_size("flightrec_requests_size",
+					 cfg->requests_size) != 0)
+		return -1;
+	if (cfg->logs_max_msg_size <= 0 ||
+	    cfg->logs_max_msg_size > FLIGHTREC_LOG_MSG_SIZE_MAX) {
+		diag_set(ClientError, ER_CFG, "flightrec_logs_max_msg_size",
+			 tt_sprintf("must be greater than 0 and less than or "
+				    "equal to %d", FLIGHTREC_LOG_MSG_SIZE_MAX));
+		return -1;
+	}
+	if (cfg->logs_log_level < S_FATAL || cfg->logs_log_level > S_DEBUG) {
+		diag_set(ClientError, ER_CFG, "flightrec_logs_log_level",
+			 tt_sprintf("must be between %d and %d",
+				    S_FATAL, S_DEBUG));
+		return -1;
+	}
+	if (!(cfg->metrics_interval > 0)) {
+		diag_set(ClientError, ER_CFG, "flightrec_metrics_interval",
+			 "must be greater than 0");
+		return -1;
+	}
+	if (!(cfg->metrics_period >= 0)) {
+		diag_set(ClientError, ER_CFG, "flightrec_metrics_period",
+			 "must be greater than or equal to 0");
+		return -1;
+	}
+	if (flightrec_metrics_size(cfg) < 0) {
+		diag_set(ClientError, ER_CFG, "flightrec_metrics_period",
+			 "is too big for the given flightrec_metrics_interval");
+		return -1;
+	}
+	if (flightrec_check_max_size("flightrec_requests_max_req_size",
+				     cfg->requests_max_req_size) != 0 ||
+	    flightrec_check_max_size("flightrec_requests_max_res_size",
+				     cfg->requests_max_res_size) != 0)
+		return -1;
+	return 0;
+}
+
+int
+box_check_flightrec(void)
+{
+	struct flightrec_cfg cfg;
+	return flightrec_cfg_get(&cfg);
+}
+
+/** Closes the flight recorder file. */
+static void
+flightrec_close(void)
+{
+	say_set_flightrec_log_level(-1);
+	if (flightrec.metrics_fiber != NULL) {
+		fiber_cancel(flightrec.metrics_fiber);
+		flightrec.metrics_fiber = NULL;
+	}
+	if (flightrec.fd < 0)
+		return;
+	tt_pthread_mutex_lock(&flightrec.logs_mutex);
+	for (int i = 0; i < flightrec_section_MAX; i++)
+		flightrec.sections[i].header = NULL;
+	munmap(flightrec.map, flightrec.map_size);
+	flightrec.map = NULL;
+	flightrec.map_size = 0;
+	tt_pthread_mutex_unlock(&flightrec.logs_mutex);
+	close(flightrec.fd);
+	flightrec.fd = -1;
+}
+
+/** Creates the flight recorder file and its sections. */
+static int
+flightrec_open(const struct flightrec_cfg *cfg)
+{
+	assert(flightrec.fd < 0);
+	int64_t sizes[flightrec_section_MAX] = {
+		/* [FLIGHTREC_LOGS]     = */ cfg->logs_size,
+		/* [FLIGHTREC_REQUESTS] = */ cfg->requests_size,
+		/* [FLIGHTREC_METRICS]  = */ flightrec_metrics_size(cfg),
+	};
+	char *map;
+	struct flightrec_file_header header;
+	memcpy(header.magic, flightrec_magic, sizeof(header.magic));
+	header.version = FLIGHTREC_VERSION;
+	size_t map_size = FLIGHTREC_ALIGN;
+	for (int i = 0; i < flightrec_section_MAX; i++) {
+		header.sections[i].offset = map_size;
+		header.sections[i].size = sizes[i];
+		map_size += small_align(sizes[i], FLIGHTREC_ALIGN);
+	}
+	/* Keep the file left by the previous run, it may have crashed. */
+	if (!flightrec.is_prev_file_saved) {
+		if (rename(FLIGHTREC_FILENAME, FLIGHTREC_FILENAME ".prev") != 0 &&
+		    errno != ENOENT) {
+			diag_set(SystemError, "failed to rename '%s'",
+				 FLIGHTREC_FILENAME);
+			return -1;
+		}
+		flightrec.is_prev_file_saved = true;
+	}
+	int fd = open(FLIGHTREC_FILENAME, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to create '%s'",
+			 FLIGHTREC_FILENAME);
+		return -1;
+	}
+	if (ftruncate(fd, map_size) != 0) {
+		diag_set(SystemError, "failed to resize '%s'",
+			 FLIGHTREC_FILENAME);
+		goto fail;
+	}
+	map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		diag_set(SystemError, "failed to map '%s'", FLIGHTREC_FILENAME);
+		goto fail;
+	}
+	for (int i = 0; i < flightrec_section_MAX; i++) {
+		if (sizes[i] == 0)
+			continue;
+		prbuf_create(&flightrec.sections[i],
+			     map + header.sections[i].offset, sizes[i]);
+	}
+	memcpy(map, &header, sizeof(header));
+	flightrec.fd = fd;
+	flightrec.map = map;
+	flightrec.map_size = map_size;
+	return 0;
+fail:
+	close(fd);
+	unlink(FLIGHTREC_FILENAME);
+	return -1;
+}
+
+/**
+ * Returns true if the file has to be recreated to apply the new
+ * configuration, i.e. if the layout of the sections changes.
+ */
+static bool
+flightrec_cfg_needs_reopen(const struct flightrec_cfg *old,
+			   const struct flightrec_cfg *new)
+{
+	return old->enabled != new->enabled ||
+	       old->logs_size != new->logs_size ||
+	       old->requests_size != new->requests_size ||
+	       flightrec_metrics_size(old) != flightrec_metrics_size(new);
+}
+
+int
+box_set_flightrec(void)
+{
+	struct flightrec_cfg cfg;
+	if (flightrec_cfg_get(&cfg) != 0)
+		return -1;
+	if (flightrec.fd < 0 || flightrec_cfg_needs_reopen(&flightrec.cfg,
+							  &cfg)) {
+		flightrec_close();
+		if (cfg.enabled && flightrec_open(&cfg) != 0)
+			return -1;
+	}
+	flightrec.cfg = cfg;
+	if (!cfg.enabled)
+		return 0;
+	if (flightrec.sections[FLIGHTREC_LOGS].header != NULL) {
+		log_write_flightrec = flightrec_write_log;
+		say_set_flightrec_log_level(cfg.logs_log_level);
+	}
+	if (flightrec.sections[FLIGHTREC_METRICS].header != NULL) {
+		if (flightrec.metrics_fiber == NULL) {
+			flightrec.metrics_fiber = fiber_new_system(
+				"flightrec.metrics", flightrec_metrics_f);
+			if (flightrec.metrics_fiber == NULL)
+				return -1;
+			fiber_start(flightrec.metrics_fiber);
+		} else {
+			/* Apply the new interval. */
+			fiber_wakeup(flightrec.metrics_fiber);
+		}
+	}
+	return 0;
+}
+
+void
+flightrec_free(void)
+{
+	flightrec_close();
+}
+
+bool
+flightrec_is_mmapped_address(void *addr)
+{
+	return flightrec.map != NULL && (char *)addr >= flightrec.map &&
+	       (char *)addr < flightrec.map + flightrec.map_size;
+}
+
+int
+flightrec_read(const char *path, flightrec_read_f cb, void *arg)
+{
+	int rc = -1;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to open '%s'", path);
+		return -1;
+	}
+	struct flightrec_file_header header;
+	ssize_t n = pread(fd, &header, sizeof(header), 0);
+	if (n < 0) {
+		diag_set(SystemError, "failed to read '%s'", path);
+		goto out;
+	}
+	if ((size_t)n < sizeof(header) ||
+	    memcmp(header.magic, flightrec_magic, sizeof(header.magic)) != 0) {
+		diag_set(IllegalParams, "'%s' is not a flight recorder file",
+			 path);
+		goto out;
+	}
+	if (header.version != FLIGHTREC_VERSION) {
+		diag_set(IllegalParams, "unsupported flight recorder file "
+			 "version %u", (unsigned)header.version);
+		goto out;
+	}
+	rc = 0;
+	for (int i = 0; i < flightrec_section_MAX && rc == 0; i++) {
+		if (header.sections[i].size == 0)
+			continue;
+		struct prbuf_reader reader;
+		prbuf_reader_create(&reader, fd, header.sections[i].offset);
+		struct prbuf_entry entry;
+		while ((rc = prbuf_reader_next(&reader, &entry)) == 0 &&
+		       entry.ptr != NULL) {
+			rc = cb(i, entry.ptr, entry.size, arg);
+			if (rc != 0)
+				break;
+		}
+		prbuf_reader_destroy(&reader);
+	}
+out:
+	close(fd);
+	return rc;
+}
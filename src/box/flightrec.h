@@ -21,63 +21,84 @@ extern "C" {
 struct obuf;
 struct obuf_svp;
 
+/**
+ * Flight recorder keeps the recent history of the instance in a file
+ * mapped to memory so that it survives a crash: log messages, IPROTO
+ * requests and responses and periodic snapshots of box.stat() and
+ * box.stat.net() counters. Each kind of records is stored in its own
+ * section of the file organized as a ring buffer (see prbuf.h), so the
+ * oldest records are overwritten by new ones.
+ */
+enum flightrec_section {
+	/** Log messages. */
+	FLIGHTREC_LOGS,
+	/** IPROTO requests and responses. */
+	FLIGHTREC_REQUESTS,
+	/** Statistics counters. */
+	FLIGHTREC_METRICS,
+	flightrec_section_MAX,
+};
+
+/** Name of a flight recorder section. */
+extern const char *flightrec_section_strs[];
+
+/** Name of the flight recorder file created in the working directory. */
+#define FLIGHTREC_FILENAME "tarantool.ttfr"
+
 /**
  * Release resources and clean-up flight recorder.
  */
-static inline void
-flightrec_free(void)
-{
-}
+void
+flightrec_free(void);
 
 /** Dump request (which is already packed into msgapck) to flight recorder. */
-static inline void
-flightrec_write_request(const char *request_msgpack, size_t len)
-{
-	(void)request_msgpack;
-	(void)len;
-}
+void
+flightrec_write_request(const char *request_msgpack, size_t len);
 
 /**
  * Dump response to flight recorder. Given savepoint points to the start of
  * response stored into buffer.
  */
-static inline void
-flightrec_write_response(struct obuf *buf, struct obuf_svp *svp)
-{
-	(void)buf;
-	(void)svp;
-}
+void
+flightrec_write_response(struct obuf *buf, struct obuf_svp *svp);
 
 /**
  * Checks box.cfg flight recorder parameters.
  * On success, returns 0. On error, sets diag and returns -1.
  */
-static inline int
-box_check_flightrec(void)
-{
-	return 0;
-}
+int
+box_check_flightrec(void);
 
 /**
  * Applies box.cfg flight recorder parameters.
  * On success, returns 0. On error, sets diag and returns -1.
  */
-static inline int
-box_set_flightrec(void)
-{
-	return 0;
-}
+int
+box_set_flightrec(void);
 
 /**
  * This function is called in SIGBUS handler to check whether accessed address
  * belongs to flightrec file.
  */
-static inline bool
-flightrec_is_mmapped_address(void *addr)
-{
-	(void)addr;
-	return false;
-}
+bool
+flightrec_is_mmapped_address(void *addr);
+
+/**
+ * Callback invoked by flightrec_read() for each record. The record is
+ * a MsgPack map.
+ */
+typedef int
+(*flightrec_read_f)(enum flightrec_section section, const char *data,
+		    size_t size, void *arg);
+
+/**
+ * Reads all records stored in a flight recorder file, from the oldest to
+ * the newest one in each section, and passes them to the callback. Stops
+ * if the callback returns a non-zero value, which is then returned.
+ * On error, sets diag and returns -1.
+ */
+int
+flightrec_read(const char *path, flightrec_read_f cb, void *arg);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -31,6 +31,7 @@
 #include "func.h"
 #include "func_adapter.h"
 #include "fiber.h"
+#include "clock.h"
 #include "assoc.h"
 #include "call.h"
 #include "lua/call.h"
@@ -444,6 +445,7 @@ func_new(const struct func_def *def)
 	rlist_create(&func->func_cache_pin_list);
 	/** Nobody has access to the function but the owner. */
 	memset(func->access, 0, sizeof(func->access));
+	func_reset_stat(func);
 	/*
 	 * Do not initialize the privilege cache right away since
 	 * when loading up a function definition during recovery,
@@ -612,7 +614,32 @@ func_call_no_access_check(struct func *base, struct port *args,
 		}
 		fiber_set_user(fiber(), &base->owner_credentials);
 	}
+	/*
+	 * The statistics are always on so they must be cheap to collect:
+	 * a couple of clock reads and counter snapshots per call.
+	 */
+	uint32_t fid = base->def->fid;
+	struct fiber *fiber = fiber();
+	int csw = fiber->csw;
+	uint64_t lua_alloc = box_lua_gc_allocated();
+	uint64_t start = clock_monotonic64();
+	uint32_t prev_func_id = fiber->storage.func_id;
+	fiber->storage.func_id = fid;
 	int rc = base->vtab->call(base, args, ret);
+	fiber->storage.func_id = prev_func_id;
+	/*
+	 * The function may have been dropped while it was running so look
+	 * it up again rather than dereference a possibly freed object.
+	 */
+	if (func_by_id(fid) == base) {
+		struct func_stat *stat = &base->stat;
+		stat->call_count++;
+		if (rc != 0)
+			stat->error_count++;
+		stat->time += clock_monotonic64() - start;
+		stat->yield_count += fiber->csw - csw;
+		stat->lua_alloc += box_lua_gc_allocated() - lua_alloc;
+	}
 	/* Restore the original user */
 	if (orig_credentials)
 		fiber_set_user(fiber(), orig_credentials);
@@ -34,6 +34,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "small/rlist.h"
 #include "func_def.h"
 #include "func_cache.h"
@@ -55,6 +56,27 @@ struct func_vtab {
 	void (*destroy)(struct func *func);
 };
 
+/**
+ * Runtime statistics of a function collected by func_call.
+ * Reported by box.stat.func(), reset by box.stat.reset().
+ */
+struct func_stat {
+	/** Number of calls. */
+	uint64_t call_count;
+	/** Number of calls that failed. */
+	uint64_t error_count;
+	/** Total time spent in the function, including yields, in ns. */
+	uint64_t time;
+	/** Number of times the function yielded. */
+	uint64_t yield_count;
+	/**
+	 * Number of bytes allocated by the Lua garbage collector while the
+	 * function was running. If the function yields, allocations made
+	 * by other fibers are counted, too.
+	 */
+	uint64_t lua_alloc;
+};
+
 /**
  * Stored function.
  */
@@ -73,6 +95,8 @@ struct func {
 	 * Cached runtime access information.
 	 */
 	struct access access[BOX_USER_MAX];
+	/** Runtime statistics. */
+	struct func_stat stat;
 };
 
 /**
@@ -100,6 +124,13 @@ func_new(const struct func_def *def);
 void
 func_delete(struct func *func);
 
+/** Reset runtime statistics of a function. */
+static inline void
+func_reset_stat(struct func *func)
+{
+	memset(&func->stat, 0, sizeof(func->stat));
+}
+
 /** Check "EXECUTE" permissions for a given function. */
 int
 func_access_check(struct func *func);
@@ -93,6 +93,14 @@ func_by_id(uint32_t fid);
 struct func *
 func_by_name(const char *name, uint32_t name_len);
 
+/**
+ * Call a visitor function on every function in the cache. The visitor
+ * must not modify the cache. If the visitor returns a non-zero value,
+ * the iteration is stopped and the value is returned.
+ */
+int
+func_cache_foreach(int (*cb)(struct func *func, void *arg), void *arg);
+
 /**
  * Register that there is a @a holder of type @a type that is dependent
  * on function @a func.
@@ -102,7 +102,8 @@ gc_checkpoint_delete(struct gc_checkpoint *checkpoint)
 }
 
 void
-gc_init(on_garbage_collection_f on_garbage_collection)
+gc_init(on_garbage_collection_f on_garbage_collection,
+	on_checkpoint_f on_checkpoint)
 {
 	/* Don't delete any files until recovery is complete. */
 	gc.min_checkpoint_count = INT_MAX;
@@ -130,6 +131,7 @@ gc_init(on_garbage_collection_f on_garbage_collection)
 	fiber_set_joinable(gc.checkpoint_fiber, true);
 
 	gc.on_garbage_collection = on_garbage_collection;
+	gc.on_checkpoint = on_checkpoint;
 
 	fiber_start(gc.cleanup_fiber);
 	fiber_start(gc.checkpoint_fiber);
@@ -536,6 +538,7 @@ gc_do_checkpoint(bool is_scheduled)
 	 * collector state.
 	 */
 	gc_add_checkpoint(&checkpoint.vclock);
+	gc.on_checkpoint();
 out:
 	if (rc != 0)
 		engine_abort_checkpoint();
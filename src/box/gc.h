@@ -104,12 +104,17 @@ typedef rb_tree(struct gc_consumer) gc_tree_t;
 typedef void
 (*on_garbage_collection_f)(void);
 
+typedef void
+(*on_checkpoint_f)(void);
+
 /** Garbage collection state. */
 struct gc_state {
 	/** VClock of the oldest WAL row available on the instance. */
 	struct vclock vclock;
 	/** A callback invoked whenever gc.vclock is updated. */
 	on_garbage_collection_f on_garbage_collection;
+	/** A callback invoked whenever a checkpoint is created. */
+	on_checkpoint_f on_checkpoint;
 	/**
 	 * Minimal number of checkpoints to preserve.
 	 * Configured by box.cfg.checkpoint_count.
@@ -221,7 +226,8 @@ gc_last_checkpoint(void)
  * Initialize the garbage collection state.
  */
 void
-gc_init(on_garbage_collection_f on_garbage_collection);
+gc_init(on_garbage_collection_f on_garbage_collection,
+	on_checkpoint_f on_checkpoint);
 
 /**
  * Prepare for freeing resources in gc_free while TX event loop is
@@ -100,6 +100,16 @@ error_set_index(struct error *error, const struct index_def *index_def)
 	error_set_uint(error, "space_id", index_def->space_id);
 }
 
+void
+diag_set_index_not_built(struct index *index)
+{
+	struct error *e = diag_set(ClientError, ER_LOADING);
+	error_set_index(e, index->def);
+	error_append_msg(e, " - index '%s' of space '%s' is not built yet",
+			 index->def->name,
+			 space_by_id(index->def->space_id)->def->name);
+}
+
 int
 key_validate(const struct index_def *index_def, enum iterator_type type,
 	     const char *key, uint32_t part_count)
@@ -268,6 +278,8 @@ check_index(uint32_t space_id, uint32_t index_id,
 	*index = index_find(*space, index_id);
 	if (*index == NULL)
 		return -1;
+	if (index_check_built(*index) != 0)
+		return -1;
 	return 0;
 }
 
@@ -393,11 +405,52 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 		return -1;
 	/* Count statistics. */
 	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+	space_stat_collect_select(space_id, *result != NULL);
 	if (*result != NULL)
 		tuple_bless(*result);
 	return 0;
 }
 
+int
+box_index_get_batch(uint32_t space_id, uint32_t index_id, const char *keys,
+		    const char *keys_end, struct tuple **results)
+{
+	assert(keys != NULL && keys_end != NULL && results != NULL);
+	mp_tuple_assert(keys, keys_end);
+	if (box_check_slice() != 0)
+		return -1;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	uint32_t key_count = mp_decode_array(&keys);
+	const char *key_array = keys;
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (mp_typeof(*key_array) != MP_ARRAY) {
+			diag_set(IllegalParams, "key must be an array");
+			return -1;
+		}
+		const char *key = key_array;
+		uint32_t part_count = mp_decode_array(&key);
+		if (exact_key_validate(index->def, key, part_count) != 0)
+			return -1;
+		box_run_on_select(space, index, ITER_EQ, key_array);
+		mp_next(&key_array);
+	}
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	int rc = index_get_batch(index, keys, key_count, results);
+	txn_end_ro_stmt(txn, &svp);
+	if (rc != 0)
+		return -1;
+	/* Count statistics. */
+	rmean_collect(rmean_box, IPROTO_SELECT, key_count);
+	return 0;
+}
+
 int
 box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result)
@@ -466,9 +519,9 @@ box_index_max(uint32_t space_id, uint32_t index_id, const char *key,
 	return 0;
 }
 
-ssize_t
-box_index_count(uint32_t space_id, uint32_t index_id, int type,
-		const char *key, const char *key_end)
+static ssize_t
+box_index_count_impl(uint32_t space_id, uint32_t index_id, int type,
+		     const char *key, const char *key_end, bool approximate)
 {
 	assert(key != NULL && key_end != NULL);
 	mp_tuple_assert(key, key_end);
@@ -489,13 +542,31 @@ box_index_count(uint32_t space_id, uint32_t index_id, int type,
 	struct txn_ro_savepoint svp;
 	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
 		return -1;
-	ssize_t count = index_count(index, itype, key, part_count);
+	ssize_t count = approximate ?
+			index_approximate_count(index, itype, key, part_count) :
+			index_count(index, itype, key, part_count);
 	txn_end_ro_stmt(txn, &svp);
 	if (count < 0)
 		return -1;
 	return count;
 }
 
+ssize_t
+box_index_count(uint32_t space_id, uint32_t index_id, int type,
+		const char *key, const char *key_end)
+{
+	return box_index_count_impl(space_id, index_id, type, key, key_end,
+				    false);
+}
+
+ssize_t
+box_index_approximate_count(uint32_t space_id, uint32_t index_id, int type,
+			    const char *key, const char *key_end)
+{
+	return box_index_count_impl(space_id, index_id, type, key, key_end,
+				    true);
+}
+
 /* }}} */
 
 /* {{{ Iterators ************************************************/
@@ -629,6 +700,7 @@ iterator_create(struct iterator *it, struct index *index)
 	index_weak_ref_create(&it->index_ref, index);
 	it->next_internal = NULL;
 	it->next = NULL;
+	it->next_key = NULL;
 	it->free = NULL;
 	it->pos_buf = NULL;
 	it->pos_buf_size = 0;
@@ -656,6 +728,47 @@ iterator_next_internal(struct iterator *it, struct tuple **ret)
 	return it->next_internal(it, ret);
 }
 
+struct tuple *
+iterator_key_tuple_new(struct tuple *tuple, struct key_def *cmp_def)
+{
+	assert(!cmp_def->is_multikey && !cmp_def->for_func_index);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t key_size;
+	const char *key = tuple_extract_key(tuple, cmp_def, MULTIKEY_NONE,
+					    &key_size);
+	if (key == NULL)
+		return NULL;
+	struct tuple *key_tuple = tuple_new(tuple_format_runtime, key,
+					    key + key_size);
+	region_truncate(region, region_svp);
+	if (key_tuple == NULL)
+		return NULL;
+	return tuple_bless(key_tuple);
+}
+
+int
+iterator_next_key(struct iterator *it, struct tuple **ret)
+{
+	if (!index_weak_ref_check(&it->index_ref)) {
+		*ret = NULL;
+		return 0;
+	}
+	if (it->next_key != NULL)
+		return it->next_key(it, ret);
+	struct tuple *tuple;
+	if (it->next(it, &tuple) != 0)
+		return -1;
+	/* The index could have been dropped if the iterator yielded. */
+	if (tuple == NULL || !index_weak_ref_check(&it->index_ref)) {
+		*ret = NULL;
+		return 0;
+	}
+	struct index *index = index_weak_ref_get_index_checked(&it->index_ref);
+	*ret = iterator_key_tuple_new(tuple, index->def->cmp_def);
+	return *ret != NULL ? 0 : -1;
+}
+
 int
 iterator_position(struct iterator *it, const char **pos, uint32_t *size)
 {
@@ -794,6 +907,9 @@ index_create(struct index *index, struct engine *engine,
 	/* Unusable until set to proper value during space creation. */
 	index->dense_id = UINT32_MAX;
 	rlist_create(&index->read_gaps);
+	index->sql_tuple_est = NULL;
+	index->sql_tuple_est_size = 0;
+	index->needs_build = false;
 }
 
 void
@@ -806,6 +922,7 @@ index_delete(struct index *index)
 	 * the index is primary or secondary.
 	 */
 	struct index_def *def = index->def;
+	free(index->sql_tuple_est);
 	memtx_tx_on_index_delete(index);
 	index->vtab->destroy(index);
 	index_def_delete(def);
@@ -937,6 +1054,13 @@ generic_index_count(struct index *index, enum iterator_type type,
 	return count;
 }
 
+ssize_t
+generic_index_approximate_count(struct index *index, enum iterator_type type,
+				const char *key, uint32_t part_count)
+{
+	return index_count(index, type, key, part_count);
+}
+
 int
 generic_index_get_internal(struct index *index, const char *key,
 			   uint32_t part_count, struct tuple **result)
@@ -959,6 +1083,34 @@ generic_index_get(struct index *index, const char *key,
 	return -1;
 }
 
+void
+index_get_batch_unref(struct tuple **results, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		if (results[i] != NULL)
+			tuple_unref(results[i]);
+	}
+}
+
+int
+generic_index_get_batch(struct index *index, const char *keys,
+			uint32_t key_count, struct tuple **results)
+{
+	for (uint32_t i = 0; i < key_count; i++) {
+		uint32_t part_count = mp_decode_array(&keys);
+		const char *key = keys;
+		for (uint32_t j = 0; j < part_count; j++)
+			mp_next(&keys);
+		if (index_get(index, key, part_count, &results[i]) != 0) {
+			index_get_batch_unref(results, i);
+			return -1;
+		}
+		if (results[i] != NULL)
+			tuple_ref(results[i]);
+	}
+	return 0;
+}
+
 int
 generic_index_replace(struct index *index, struct tuple *old_tuple,
 		      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -255,6 +255,20 @@ box_tuple_extract_key(box_tuple_t *tuple, uint32_t space_id,
 
 /** \endcond public */
 
+/**
+ * Same as box_index_count(), but the result may be an estimate.
+ * Engines that can count tuples quickly return the exact number,
+ * vinyl estimates it from the in-memory trees and run page indexes
+ * without reading any data. The estimate includes overwritten and
+ * deleted statements that haven't been compacted yet.
+ *
+ * \sa \code box.space[space_id].index[index_id]:count(key,
+ *     { iterator = type, approximate = true }) \endcode
+ */
+ssize_t
+box_index_approximate_count(uint32_t space_id, uint32_t index_id, int type,
+			    const char *key, const char *key_end);
+
 /**
  * Allocate and initialize iterator for space_id, index_id. If packed_pos is
  * not NULL, iterator will start right after tuple with position, described by
@@ -285,6 +299,25 @@ box_index_tuple_position(uint32_t space_id, uint32_t index_id,
 			 const char *tuple, const char *tuple_end,
 			 const char **packed_pos, const char **packed_pos_end);
 
+/**
+ * Get tuples from a unique index by several full keys at once.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys MsgPack array of keys, each in MsgPack Array format.
+ * \param keys_end the end of encoded \a keys
+ * \param[out] results array that receives the tuple found by each key
+ *             or NULL, must fit as many entries as there are keys.
+ *             Every returned tuple is referenced and must be released
+ *             with tuple_unref() by the caller.
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \sa \code box.space[space_id].index[index_id]:get_many(keys) \endcode
+ */
+int
+box_index_get_batch(uint32_t space_id, uint32_t index_id, const char *keys,
+		    const char *keys_end, struct tuple **results);
+
 /**
  * Index statistics (index:stat())
  *
@@ -324,6 +357,12 @@ struct iterator {
 	 * Returns 0 on success, -1 on error.
 	 */
 	int (*next)(struct iterator *it, struct tuple **ret);
+	/**
+	 * Iterate to the next tuple and return its key as stored in
+	 * the index, see iterator_next_key(). Set by engines that can
+	 * read the key without fetching the full tuple, NULL otherwise.
+	 */
+	int (*next_key)(struct iterator *it, struct tuple **ret);
 	/**
 	 * Get position of iterator - extracted cmp_def of last fetched
 	 * tuple with MP_ARRAY header. If iterator is exhausted,
@@ -375,6 +414,27 @@ iterator_next(struct iterator *it, struct tuple **ret);
 int
 iterator_next_internal(struct iterator *it, struct tuple **ret);
 
+/**
+ * Iterate to the next tuple and return its key extracted by the
+ * index cmp_def, i.e. the indexed fields, the fields included in
+ * a covering index and the primary key fields, as a runtime tuple.
+ * Must not be used with multikey and functional indexes.
+ *
+ * The key is returned in @ret (NULL if EOF).
+ * Returns 0 on success, -1 on error.
+ */
+int
+iterator_next_key(struct iterator *it, struct tuple **ret);
+
+/**
+ * Create a runtime tuple out of the key of @a tuple extracted by
+ * @a cmp_def and pin it with tuple_bless(). Helper for
+ * iterator::next_key() implementations.
+ * Returns NULL on error, diag is set.
+ */
+struct tuple *
+iterator_key_tuple_new(struct tuple *tuple, struct key_def *cmp_def);
+
 /** Buffer size required for successful packing. */
 size_t
 iterator_position_pack_bufsize(const char *pos, const char *pos_end);
@@ -543,6 +603,13 @@ struct index_vtab {
 	int (*random)(struct index *index, uint32_t rnd, struct tuple **result);
 	ssize_t (*count)(struct index *index, enum iterator_type type,
 			 const char *key, uint32_t part_count);
+	/**
+	 * Same as count(), but the result may be an estimate. Used by
+	 * engines that can't count tuples without reading them.
+	 */
+	ssize_t (*approximate_count)(struct index *index,
+				     enum iterator_type type,
+				     const char *key, uint32_t part_count);
 	/*
 	 * Same as get(), but returns a tuple as it is stored in the index,
 	 * without any transformations. Used internally by engines. For
@@ -552,6 +619,15 @@ struct index_vtab {
 			    uint32_t part_count, struct tuple **result);
 	int (*get)(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result);
+	/**
+	 * Same as get() called for each of @a key_count full keys,
+	 * which are encoded one after another as MsgPack arrays.
+	 * The tuple found by the i-th key (or NULL) is stored in
+	 * results[i] and referenced. Nothing is referenced on failure.
+	 * Allows an engine to overlap independent lookups.
+	 */
+	int (*get_batch)(struct index *index, const char *keys,
+			 uint32_t key_count, struct tuple **results);
 	/**
 	 * Main entrance point for changing data in index. Once built and
 	 * before deletion this is the only way to insert, replace and delete
@@ -625,6 +701,21 @@ struct index {
 	 * @sa struct gap_item_base.
 	 */
 	struct rlist read_gaps;
+	/**
+	 * Logarithmic estimates of the number of tuples matching a key
+	 * prefix of each length, used by the SQL planner. Collected
+	 * lazily by sampling the index, NULL if not collected yet.
+	 * See index_field_tuple_est().
+	 */
+	int16_t *sql_tuple_est;
+	/** Index size at the time sql_tuple_est was collected. */
+	ssize_t sql_tuple_est_size;
+	/**
+	 * Set if the index is empty, because it's waiting to be built in
+	 * background after recovery (box.cfg.memtx_background_index_build).
+	 * Such an index can't be read, see index_check_built().
+	 */
+	bool needs_build;
 };
 
 /**
@@ -777,6 +868,23 @@ index_check_dup(struct index *index, struct tuple *old_tuple,
 void
 error_set_index(struct error *error, const struct index_def *index_def);
 
+/** Set diag for a read from an index that isn't built yet. */
+void
+diag_set_index_not_built(struct index *index);
+
+/**
+ * Check if the index can be read, i.e. it isn't waiting to be built.
+ * Return 0 on success, -1 on error (diag is set).
+ */
+static inline int
+index_check_built(struct index *index)
+{
+	if (likely(!index->needs_build))
+		return 0;
+	diag_set_index_not_built(index);
+	return -1;
+}
+
 /**
  * Initialize an index instance.
  * Note, this function copies the given index definition.
@@ -895,6 +1003,13 @@ index_count(struct index *index, enum iterator_type type,
 	return index->vtab->count(index, type, key, part_count);
 }
 
+static inline ssize_t
+index_approximate_count(struct index *index, enum iterator_type type,
+			const char *key, uint32_t part_count)
+{
+	return index->vtab->approximate_count(index, type, key, part_count);
+}
+
 static inline int
 index_get_internal(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result)
@@ -909,6 +1024,17 @@ index_get(struct index *index, const char *key,
 	return index->vtab->get(index, key, part_count, result);
 }
 
+/** Unreference the first @a count tuples returned by index_get_batch(). */
+void
+index_get_batch_unref(struct tuple **results, uint32_t count);
+
+static inline int
+index_get_batch(struct index *index, const char *keys,
+		uint32_t key_count, struct tuple **results)
+{
+	return index->vtab->get_batch(index, keys, key_count, results);
+}
+
 static inline int
 index_replace(struct index *index, struct tuple *old_tuple,
 	      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -1061,10 +1187,15 @@ int generic_index_max(struct index *, const char *, uint32_t, struct tuple **);
 int generic_index_random(struct index *, uint32_t, struct tuple **);
 ssize_t generic_index_count(struct index *, enum iterator_type,
 			    const char *, uint32_t);
+ssize_t generic_index_approximate_count(struct index *, enum iterator_type,
+					const char *, uint32_t);
 int
 generic_index_get_internal(struct index *index, const char *key,
 			   uint32_t part_count, struct tuple **result);
 int generic_index_get(struct index *, const char *, uint32_t, struct tuple **);
+int
+generic_index_get_batch(struct index *index, const char *keys,
+			uint32_t key_count, struct tuple **results);
 int generic_index_replace(struct index *, struct tuple *, struct tuple *,
 			  enum dup_replace_mode,
 			  struct tuple **, struct tuple **);
@@ -0,0 +1,345 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "index_aggregate.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "box.h"
+#include "diag.h"
+#include "errcode.h"
+#include "field_def.h"
+#include "fiber.h"
+#include "index.h"
+#include "key_def.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tuple.h"
+#include "tuple_compare.h"
+
+const char *aggregate_func_strs[] = {
+	/* [AGGREGATE_COUNT] = */ "count",
+	/* [AGGREGATE_SUM]   = */ "sum",
+	/* [AGGREGATE_MIN]   = */ "min",
+	/* [AGGREGATE_MAX]   = */ "max",
+};
+
+static_assert(lengthof(aggregate_func_strs) == aggregate_func_MAX,
+	      "Each aggregate function must have a name");
+
+static int
+cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return x < y ? -1 : x > y;
+}
+
+void
+index_aggregate_create(struct index_aggregate *agg,
+		       const struct aggregate_def *defs, uint32_t def_count,
+		       const struct key_def *key_def, uint32_t group_part_count,
+		       index_aggregate_emit_f emit, void *emit_arg)
+{
+	memset(agg, 0, sizeof(*agg));
+	agg->defs = defs;
+	agg->def_count = def_count;
+	agg->values = xcalloc(def_count, sizeof(*agg->values));
+	agg->def_fields = xcalloc(def_count, sizeof(*agg->def_fields));
+	agg->fieldnos = xcalloc(def_count, sizeof(*agg->fieldnos));
+	agg->fields = xcalloc(def_count, sizeof(*agg->fields));
+	for (uint32_t i = 0; i < def_count; i++) {
+		if (defs[i].func != AGGREGATE_COUNT)
+			agg->fieldnos[agg->field_count++] = defs[i].fieldno;
+	}
+	qsort(agg->fieldnos, agg->field_count, sizeof(*agg->fieldnos),
+	      cmp_u32);
+	uint32_t field_count = 0;
+	for (uint32_t i = 0; i < agg->field_count; i++) {
+		if (field_count == 0 ||
+		    agg->fieldnos[i] != agg->fieldnos[field_count - 1])
+			agg->fieldnos[field_count++] = agg->fieldnos[i];
+	}
+	agg->field_count = field_count;
+	for (uint32_t i = 0; i < def_count; i++) {
+		if (defs[i].func == AGGREGATE_COUNT)
+			continue;
+		uint32_t *fieldno = bsearch(&defs[i].fieldno, agg->fieldnos,
+					    field_count, sizeof(*agg->fieldnos),
+					    cmp_u32);
+		assert(fieldno != NULL);
+		agg->def_fields[i] = fieldno - agg->fieldnos;
+	}
+	if (group_part_count > 0) {
+		assert(group_part_count <= key_def->part_count);
+		assert(!key_def->is_multikey && !key_def->for_func_index);
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		struct key_part_def *parts = xregion_alloc_array(
+			region, struct key_part_def, key_def->part_count);
+		if (key_def_dump_parts(key_def, parts, region) != 0)
+			panic("failed to dump key parts");
+		agg->group_def = key_def_new(parts, group_part_count, 0);
+		region_truncate(region, region_svp);
+	}
+	agg->emit = emit;
+	agg->emit_arg = emit_arg;
+}
+
+void
+index_aggregate_destroy(struct index_aggregate *agg)
+{
+	for (uint32_t i = 0; i < agg->def_count; i++)
+		free(agg->values[i].data);
+	free(agg->values);
+	free(agg->def_fields);
+	free(agg->fieldnos);
+	free(agg->fields);
+	free(agg->group_key);
+	if (agg->group_def != NULL)
+		key_def_delete(agg->group_def);
+}
+
+/** Set an error about an aggregated field of an unsupported type. */
+static void
+aggregate_field_type_error(uint32_t fieldno, const char *expected,
+			   const char *field)
+{
+	diag_set(ClientError, ER_FIELD_TYPE,
+		 int2str(fieldno + TUPLE_INDEX_BASE), expected,
+		 mp_type_strs[mp_typeof(*field)]);
+}
+
+/** Add a field value to a SUM aggregate. */
+static int
+aggregate_value_add_sum(struct aggregate_value *value, uint32_t fieldno,
+			const char *field)
+{
+	const char *pos = field;
+	int64_t sum;
+	double d;
+	switch (mp_typeof(*field)) {
+	case MP_UINT: {
+		uint64_t u = mp_decode_uint(&pos);
+		if (!value->is_double && u <= INT64_MAX &&
+		    !__builtin_add_overflow(value->ival, (int64_t)u, &sum)) {
+			value->ival = sum;
+			value->count++;
+			return 0;
+		}
+		d = u;
+		break;
+	}
+	case MP_INT: {
+		int64_t i = mp_decode_int(&pos);
+		if (!value->is_double &&
+		    !__builtin_add_overflow(value->ival, i, &sum)) {
+			value->ival = sum;
+			value->count++;
+			return 0;
+		}
+		d = i;
+		break;
+	}
+	case MP_FLOAT:
+		d = mp_decode_float(&pos);
+		break;
+	case MP_DOUBLE:
+		d = mp_decode_double(&pos);
+		break;
+	default:
+		aggregate_field_type_error(fieldno, "number", field);
+		return -1;
+	}
+	/* Switch to floating point arithmetic for good. */
+	if (!value->is_double) {
+		value->dval = value->ival;
+		value->is_double = true;
+	}
+	value->dval += d;
+	value->count++;
+	return 0;
+}
+
+/** Add a field value to a MIN or MAX aggregate. */
+static int
+aggregate_value_add_min_max(struct aggregate_value *value,
+			    enum aggregate_func func, uint32_t fieldno,
+			    const char *field)
+{
+	if (!field_mp_type_is_compatible(FIELD_TYPE_SCALAR, field, false)) {
+		aggregate_field_type_error(fieldno, "scalar", field);
+		return -1;
+	}
+	if (value->count++ > 0) {
+		int rc = tuple_compare_field(field, value->data,
+					     FIELD_TYPE_SCALAR, NULL);
+		if (func == AGGREGATE_MIN ? rc >= 0 : rc <= 0)
+			return 0;
+	}
+	const char *field_end = field;
+	mp_next(&field_end);
+	uint32_t size = field_end - field;
+	if (size > value->capacity) {
+		value->capacity = MAX(size, 2 * value->capacity);
+		value->data = xrealloc(value->data, value->capacity);
+	}
+	memcpy(value->data, field, size);
+	value->size = size;
+	return 0;
+}
+
+/** Emit the values of the current group and reset them. */
+static int
+index_aggregate_emit(struct index_aggregate *agg)
+{
+	const char *group_key = agg->group_def != NULL ? agg->group_key : NULL;
+	if (agg->emit(agg, group_key, agg->emit_arg) != 0)
+		return -1;
+	for (uint32_t i = 0; i < agg->def_count; i++) {
+		struct aggregate_value *value = &agg->values[i];
+		value->count = 0;
+		value->is_double = false;
+		value->ival = 0;
+		value->dval = 0;
+		value->size = 0;
+	}
+	return 0;
+}
+
+/**
+ * Check if a tuple starts a new group and if it does, emit the values of
+ * the previous group and remember the new group key.
+ */
+static int
+index_aggregate_check_group(struct index_aggregate *agg, const char *data,
+			    const char *data_end)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t key_size;
+	const char *key = tuple_extract_key_raw(data, data_end, agg->group_def,
+						MULTIKEY_NONE, &key_size);
+	if (key == NULL)
+		return -1;
+	int rc = 0;
+	if (agg->group_key_size > 0) {
+		uint32_t part_count = agg->group_def->part_count;
+		const char *a = agg->group_key;
+		const char *b = key;
+		mp_decode_array(&a);
+		mp_decode_array(&b);
+		if (key_compare(a, part_count, HINT_NONE, b, part_count,
+				HINT_NONE, agg->group_def) == 0)
+			goto out;
+		rc = index_aggregate_emit(agg);
+		if (rc != 0)
+			goto out;
+	}
+	if (key_size > agg->group_key_capacity) {
+		agg->group_key_capacity = MAX(key_size,
+					      2 * agg->group_key_capacity);
+		agg->group_key = xrealloc(agg->group_key,
+					  agg->group_key_capacity);
+	}
+	memcpy(agg->group_key, key, key_size);
+	agg->group_key_size = key_size;
+out:
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+int
+index_aggregate_add(struct index_aggregate *agg, const char *data,
+		    const char *data_end)
+{
+	if (agg->group_def != NULL &&
+	    index_aggregate_check_group(agg, data, data_end) != 0)
+		return -1;
+	/* Look up all aggregated fields in one pass over the tuple. */
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	uint32_t i = 0;
+	for (uint32_t fieldno = 0;
+	     fieldno < field_count && i < agg->field_count; fieldno++) {
+		if (fieldno == agg->fieldnos[i])
+			agg->fields[i++] = pos;
+		mp_next(&pos);
+	}
+	for (; i < agg->field_count; i++)
+		agg->fields[i] = NULL;
+	for (i = 0; i < agg->def_count; i++) {
+		const struct aggregate_def *def = &agg->defs[i];
+		struct aggregate_value *value = &agg->values[i];
+		if (def->func == AGGREGATE_COUNT) {
+			value->count++;
+			continue;
+		}
+		const char *field = agg->fields[agg->def_fields[i]];
+		if (field == NULL || mp_typeof(*field) == MP_NIL)
+			continue;
+		int rc;
+		if (def->func == AGGREGATE_SUM) {
+			rc = aggregate_value_add_sum(value, def->fieldno,
+						     field);
+		} else {
+			rc = aggregate_value_add_min_max(value, def->func,
+							 def->fieldno, field);
+		}
+		if (rc != 0)
+			return -1;
+	}
+	return 0;
+}
+
+int
+index_aggregate_finish(struct index_aggregate *agg)
+{
+	if (agg->group_def != NULL && agg->group_key_size == 0)
+		return 0;
+	return index_aggregate_emit(agg);
+}
+
+int
+index_aggregate_iterator(struct index_aggregate *agg, struct iterator *it)
+{
+	while (true) {
+		struct tuple *tuple;
+		if (box_iterator_next(it, &tuple) != 0)
+			return -1;
+		if (tuple == NULL)
+			break;
+		uint32_t bsize;
+		const char *data = tuple_data_range(tuple, &bsize);
+		if (index_aggregate_add(agg, data, data + bsize) != 0)
+			return -1;
+	}
+	return index_aggregate_finish(agg);
+}
+
+int
+index_aggregate_read_view(struct index_aggregate *agg,
+			  struct index_read_view_iterator *it)
+{
+	struct region *region = &fiber()->gc;
+	while (true) {
+		size_t region_svp = region_used(region);
+		struct read_view_tuple result;
+		int rc = index_read_view_iterator_next_raw(it, &result);
+		if (rc == 0 && result.data != NULL) {
+			rc = index_aggregate_add(agg, result.data,
+						 result.data + result.size);
+		}
+		/* The tuple data may be decompressed on the region. */
+		region_truncate(region, region_svp);
+		if (rc != 0)
+			return -1;
+		if (result.data == NULL)
+			break;
+	}
+	return index_aggregate_finish(agg);
+}
@@ -0,0 +1,171 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct index_aggregate;
+struct index_read_view_iterator;
+struct iterator;
+struct key_def;
+
+/** Aggregate function computed by index_aggregate. */
+enum aggregate_func {
+	/** Number of tuples. */
+	AGGREGATE_COUNT,
+	/** Sum of non-null numeric values of a field. */
+	AGGREGATE_SUM,
+	/** Min non-null scalar value of a field. */
+	AGGREGATE_MIN,
+	/** Max non-null scalar value of a field. */
+	AGGREGATE_MAX,
+	aggregate_func_MAX,
+};
+
+/** Lower-case names of aggregate functions. */
+extern const char *aggregate_func_strs[];
+
+/** Definition of an aggregate: a function and the field it's applied to. */
+struct aggregate_def {
+	/** Aggregate function. */
+	enum aggregate_func func;
+	/** Zero-based number of the aggregated field. Unused by COUNT. */
+	uint32_t fieldno;
+};
+
+/** Value of an aggregate computed over a group of tuples. */
+struct aggregate_value {
+	/**
+	 * COUNT: number of tuples in the group.
+	 * Other functions: number of aggregated non-null values.
+	 */
+	uint64_t count;
+	/**
+	 * SUM: set if the sum is stored in dval, because either a value
+	 * isn't an integer or the integer sum doesn't fit in int64.
+	 */
+	bool is_double;
+	/** SUM: integer sum, valid if is_double isn't set. */
+	int64_t ival;
+	/** SUM: floating point sum, valid if is_double is set. */
+	double dval;
+	/** MIN, MAX: MsgPack of the current value, valid if count > 0. */
+	char *data;
+	/** Size of the current value. */
+	uint32_t size;
+	/** Size of the memory allocated for data. */
+	uint32_t capacity;
+};
+
+/**
+ * Callback invoked by index_aggregate for each group of tuples once all
+ * the group tuples have been aggregated. The aggregate values are stored
+ * in index_aggregate::values. The group key is a MsgPack array of group
+ * key parts of the first tuple of the group or NULL if tuples aren't
+ * grouped. Returns 0 on success. On error returns -1 and sets diag,
+ * in which case the aggregation is aborted.
+ */
+typedef int
+(*index_aggregate_emit_f)(struct index_aggregate *agg, const char *group_key,
+			  void *arg);
+
+/**
+ * Aggregation over a stream of tuples fetched from an index.
+ *
+ * If tuples are grouped by a prefix of the index key, the index must
+ * return tuples in the key order so that tuples of the same group go
+ * one after another. The aggregate values are emitted once per group.
+ * If tuples aren't grouped, the values are emitted exactly once, even
+ * if there were no tuples at all.
+ *
+ * Tuples are processed as raw MsgPack so the same code works both for
+ * index iterators and index read view iterators. Only aggregate values
+ * are kept between tuples, tuples are never referenced.
+ */
+struct index_aggregate {
+	/** Aggregate definitions. */
+	const struct aggregate_def *defs;
+	/** Aggregate values, one per definition. */
+	struct aggregate_value *values;
+	/** Number of aggregates. */
+	uint32_t def_count;
+	/** Number of distinct aggregated fields. */
+	uint32_t field_count;
+	/** Sorted numbers of aggregated fields. */
+	uint32_t *fieldnos;
+	/** Index in fieldnos of the field of each aggregate. */
+	uint32_t *def_fields;
+	/** Aggregated fields of the current tuple, NULL if absent. */
+	const char **fields;
+	/** Definition of the group key or NULL if tuples aren't grouped. */
+	struct key_def *group_def;
+	/** Key of the current group, valid if group_key_size > 0. */
+	char *group_key;
+	/** Size of the current group key. */
+	uint32_t group_key_size;
+	/** Size of the memory allocated for group_key. */
+	uint32_t group_key_capacity;
+	/** Callback invoked for each group. */
+	index_aggregate_emit_f emit;
+	/** Argument passed to the callback. */
+	void *emit_arg;
+};
+
+/**
+ * Initialize an aggregation. If @a group_part_count is not 0, tuples are
+ * grouped by the first @a group_part_count parts of @a key_def, which
+ * must not be multikey. The aggregate definitions must stay valid until
+ * the aggregation is destroyed.
+ */
+void
+index_aggregate_create(struct index_aggregate *agg,
+		       const struct aggregate_def *defs, uint32_t def_count,
+		       const struct key_def *key_def, uint32_t group_part_count,
+		       index_aggregate_emit_f emit, void *emit_arg);
+
+/** Free memory allocated by an aggregation. */
+void
+index_aggregate_destroy(struct index_aggregate *agg);
+
+/**
+ * Add a tuple to the aggregation. Returns 0 on success. On error, e.g. if
+ * an aggregated field has an unsupported type, returns -1 and sets diag.
+ */
+int
+index_aggregate_add(struct index_aggregate *agg, const char *data,
+		    const char *data_end);
+
+/**
+ * Emit the values of the last group. Must be called after all tuples have
+ * been added. Returns 0 on success, -1 on error.
+ */
+int
+index_aggregate_finish(struct index_aggregate *agg);
+
+/**
+ * Aggregate all tuples returned by an index iterator and finish the
+ * aggregation. Returns 0 on success, -1 on error.
+ */
+int
+index_aggregate_iterator(struct index_aggregate *agg, struct iterator *it);
+
+/**
+ * Aggregate all tuples returned by an index read view iterator and finish
+ * the aggregation. Returns 0 on success, -1 on error.
+ */
+int
+index_aggregate_read_view(struct index_aggregate *agg,
+			  struct index_read_view_iterator *it);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -36,10 +36,16 @@
 #include "fiber.h"
 #include "tt_static.h"
 
-const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
+const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE", "ART" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *index_bloom_type_strs[] = { "BLOOM", "XOR" };
+
+const char *index_compaction_strategy_strs[] = { "LEVELED", "TIERED" };
+
+const char *index_hash_func_strs[] = { "MURMUR", "XXH3" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -49,9 +55,18 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .bloom_partitioned   = */ false,
+	/* .bloom_type          = */ INDEX_BLOOM_TYPE_BLOOM,
+	/* .compaction_strategy = */ INDEX_COMPACTION_STRATEGY_LEVELED,
+	/* .ttl_field           = */ 0,
+	/* .parallel_compaction = */ false,
 	/* .lsn                 = */ 0,
 	/* .func                = */ 0,
 	/* .hint                = */ INDEX_HINT_DEFAULT,
+	/* .hash_func           = */ INDEX_HASH_FUNC_MURMUR,
+	/* .bucket_count        = */ 0,
+	/* .filter              = */ { 0, 0, { 0 } },
+	/* .include_part_count  = */ 0,
 };
 
 /**
@@ -75,6 +90,90 @@ index_opts_parse_hint(const char **data, void *opts, struct region *region)
 	return 0;
 }
 
+/**
+ * Parse partial index filter option from msgpack.
+ * The filter is a map {field = <1-based field number>,
+ * value = <scalar>}.
+ * Move @a data msgpack pointer to the end of msgpack value.
+ * By convention @a opts must point to corresponding struct index_opts.
+ * Return 0 on success or -1 on error (diag is set to IllegalParams).
+ */
+static int
+index_opts_parse_filter(const char **data, void *opts, struct region *region)
+{
+	(void)region;
+	struct index_opts *index_opts = (struct index_opts *)opts;
+	struct key_filter *filter = &index_opts->filter;
+	if (mp_typeof(**data) != MP_MAP) {
+		diag_set(IllegalParams, "'filter' must be a map");
+		return -1;
+	}
+	bool has_field = false;
+	const char *value = NULL;
+	const char *value_end = NULL;
+	uint32_t map_size = mp_decode_map(data);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(**data) != MP_STR) {
+			diag_set(IllegalParams, "'filter' keys must be strings");
+			return -1;
+		}
+		uint32_t key_len;
+		const char *key = mp_decode_str(data, &key_len);
+		if (key_len == strlen("field") &&
+		    memcmp(key, "field", key_len) == 0) {
+			if (mp_typeof(**data) != MP_UINT) {
+				diag_set(IllegalParams,
+					 "'filter.field' must be unsigned");
+				return -1;
+			}
+			uint64_t val = mp_decode_uint(data);
+			if (val < TUPLE_INDEX_BASE ||
+			    val - TUPLE_INDEX_BASE > BOX_INDEX_FIELD_MAX) {
+				diag_set(IllegalParams,
+					 "'filter.field' is out of range");
+				return -1;
+			}
+			filter->fieldno = val - TUPLE_INDEX_BASE;
+			has_field = true;
+		} else if (key_len == strlen("value") &&
+			   memcmp(key, "value", key_len) == 0) {
+			value = *data;
+			switch (mp_typeof(**data)) {
+			case MP_UINT:
+			case MP_INT:
+			case MP_FLOAT:
+			case MP_DOUBLE:
+			case MP_STR:
+			case MP_BIN:
+			case MP_BOOL:
+				break;
+			default:
+				diag_set(IllegalParams, "'filter.value' must be "
+					 "a number, string, varbinary or "
+					 "boolean");
+				return -1;
+			}
+			mp_next(data);
+			value_end = *data;
+		} else {
+			diag_set(IllegalParams, "unexpected key in 'filter'");
+			return -1;
+		}
+	}
+	if (!has_field || value == NULL) {
+		diag_set(IllegalParams,
+			 "'filter' must have 'field' and 'value' keys");
+		return -1;
+	}
+	if (value_end - value > KEY_FILTER_VALUE_MAX) {
+		diag_set(IllegalParams, "'filter.value' is too long");
+		return -1;
+	}
+	filter->value_len = value_end - value;
+	memcpy(filter->value, value, filter->value_len);
+	return 0;
+}
+
 const struct opt_def index_opts_reg[] = {
 	OPT_DEF("unique", OPT_BOOL, struct index_opts, is_unique),
 	OPT_DEF("dimension", OPT_INT64, struct index_opts, dimension),
@@ -85,10 +184,25 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF("bloom_partitioned", OPT_BOOL, struct index_opts,
+		bloom_partitioned),
+	OPT_DEF_ENUM("bloom_type", index_bloom_type, struct index_opts,
+		     bloom_type, NULL),
+	OPT_DEF_ENUM("compaction_strategy", index_compaction_strategy,
+		     struct index_opts, compaction_strategy, NULL),
+	OPT_DEF("ttl_field", OPT_UINT32, struct index_opts, ttl_field),
+	OPT_DEF("parallel_compaction", OPT_BOOL, struct index_opts,
+		parallel_compaction),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
 	OPT_DEF_CUSTOM("hint", index_opts_parse_hint),
+	OPT_DEF_ENUM("hash_func", index_hash_func, struct index_opts,
+		     hash_func, NULL),
+	OPT_DEF("bucket_count", OPT_UINT32, struct index_opts, bucket_count),
+	OPT_DEF_CUSTOM("filter", index_opts_parse_filter),
+	OPT_DEF("include_part_count", OPT_UINT32, struct index_opts,
+		include_part_count),
 	OPT_END,
 };
 
@@ -131,6 +245,12 @@ index_def_new(uint32_t space_id, uint32_t iid, const char *name,
 		def->cmp_def = key_def_dup(key_def);
 		def->pk_def = key_def_dup(key_def);
 	}
+	if (opts->filter.value_len != 0) {
+		def->key_def->has_filter = true;
+		def->key_def->filter = opts->filter;
+		def->cmp_def->has_filter = true;
+		def->cmp_def->filter = opts->filter;
+	}
 	def->type = type;
 	def->space_id = space_id;
 	def->iid = iid;
@@ -229,6 +349,34 @@ index_def_check(struct index_def *index_def, const char *space_name)
 			space_name, "primary key can not use a function");
 		return -1;
 	}
+	if (index_def->iid == 0 && index_def->key_def->has_filter) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name, "primary key can not be partial");
+		return -1;
+	}
+	if (index_def->key_def->for_func_index &&
+	    index_def->key_def->has_filter) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name, "functional index can not be partial");
+		return -1;
+	}
+	if (index_def->opts.include_part_count > 0) {
+		const char *err = NULL;
+		if (index_def->iid == 0)
+			err = "primary key can not include fields";
+		else if (index_def->opts.is_unique)
+			err = "unique index can not include fields";
+		else if (index_def->key_def->for_func_index)
+			err = "functional index can not include fields";
+		else if (index_def->opts.include_part_count >=
+			 index_def->key_def->part_count)
+			err = "index must have key parts besides included ones";
+		if (err != NULL) {
+			diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+				 space_name, err);
+			return -1;
+		}
+	}
 	for (uint32_t i = 0; i < index_def->key_def->part_count; i++) {
 		assert(index_def->key_def->parts[i].type < field_type_MAX);
 		if (index_def->key_def->parts[i].fieldno > BOX_INDEX_FIELD_MAX) {
@@ -44,6 +44,7 @@ enum index_type {
 	TREE,     /* TREE Index */
 	BITSET,   /* BITSET Index */
 	RTREE,    /* R-Tree Index */
+	ART,      /* Adaptive Radix Tree Index */
 	index_type_MAX,
 };
 
@@ -65,6 +66,36 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Type of filters used by vinyl runs. */
+enum index_bloom_type {
+	/* Classic bloom filter */
+	INDEX_BLOOM_TYPE_BLOOM,
+	/* Static xor filter, denser than bloom */
+	INDEX_BLOOM_TYPE_XOR,
+	index_bloom_type_MAX
+};
+extern const char *index_bloom_type_strs[];
+
+/** Policy used by vinyl to pick runs for compaction. */
+enum index_compaction_strategy {
+	/* Levels of exponentially growing size, one run at the last */
+	INDEX_COMPACTION_STRATEGY_LEVELED,
+	/* Tiers of similarly sized runs, lower write amplification */
+	INDEX_COMPACTION_STRATEGY_TIERED,
+	index_compaction_strategy_MAX
+};
+extern const char *index_compaction_strategy_strs[];
+
+/** Hash function used by memtx HASH indexes. */
+enum index_hash_func {
+	/* Incremental MurmurHash3, the same as used by vinyl blooms */
+	INDEX_HASH_FUNC_MURMUR,
+	/* XXH3, faster for string and multipart keys */
+	INDEX_HASH_FUNC_XXH3,
+	index_hash_func_MAX
+};
+extern const char *index_hash_func_strs[];
+
 /** Index options */
 struct index_opts {
 	/**
@@ -98,6 +129,28 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Split bloom filters of runs into partitions covering
+	 * adjacent pages and load them on demand.
+	 */
+	bool bloom_partitioned;
+	/** Type of filters used for new runs. */
+	enum index_bloom_type bloom_type;
+	/** Policy used to pick runs for compaction. */
+	enum index_compaction_strategy compaction_strategy;
+	/**
+	 * Number of the field (1-based) storing the expiration
+	 * time of a tuple in seconds since the Epoch. Vinyl hides
+	 * expired tuples and discards them on compaction.
+	 * Zero means tuples never expire.
+	 */
+	uint32_t ttl_field;
+	/**
+	 * Split a range that stores too much data to be compacted
+	 * in one go before compacting it so that its parts can be
+	 * compacted in parallel.
+	 */
+	bool parallel_compaction;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -108,6 +161,23 @@ struct index_opts {
 	 * Use hint optimization for tree index.
 	 */
 	enum index_hint_cfg hint;
+	/** Hash function of a memtx hash index. */
+	enum index_hash_func hash_func;
+	/**
+	 * Number of records a memtx hash index allocates room for
+	 * on creation. Zero means the table grows on demand.
+	 */
+	uint32_t bucket_count;
+	/**
+	 * Filter of a partial index: tuples that don't match it
+	 * aren't stored in the index. Unset if value_len is 0.
+	 */
+	struct key_filter filter;
+	/**
+	 * Number of trailing key parts that store fields included
+	 * in a covering index rather than the index key proper.
+	 */
+	uint32_t include_part_count;
 };
 
 extern const struct index_opts index_opts_default;
@@ -151,11 +221,29 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->bloom_partitioned != o2->bloom_partitioned)
+		return o1->bloom_partitioned < o2->bloom_partitioned ? -1 : 1;
+	if (o1->bloom_type != o2->bloom_type)
+		return o1->bloom_type - o2->bloom_type;
+	if (o1->compaction_strategy != o2->compaction_strategy)
+		return o1->compaction_strategy - o2->compaction_strategy;
+	if (o1->ttl_field != o2->ttl_field)
+		return o1->ttl_field < o2->ttl_field ? -1 : 1;
+	if (o1->parallel_compaction != o2->parallel_compaction)
+		return o1->parallel_compaction < o2->parallel_compaction ?
+		       -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
 		return o1->hint - o2->hint;
-	return 0;
+	if (o1->hash_func != o2->hash_func)
+		return o1->hash_func - o2->hash_func;
+	if (o1->bucket_count != o2->bucket_count)
+		return o1->bucket_count < o2->bucket_count ? -1 : 1;
+	if (o1->include_part_count != o2->include_part_count)
+		return o1->include_part_count < o2->include_part_count ?
+		       -1 : 1;
+	return key_filter_cmp(&o1->filter, &o2->filter);
 }
 
 /* Definition of an index. */
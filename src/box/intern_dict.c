@@ -0,0 +1,60 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "intern_dict.h"
+
+#include <string.h>
+
+#include "assoc.h"
+#include "trivia/util.h"
+
+struct intern_dict *
+intern_dict_new(void)
+{
+	struct intern_dict *dict = xcalloc(1, sizeof(*dict));
+	dict->hash = mh_strnu32_new();
+	return dict;
+}
+
+void
+intern_dict_delete(struct intern_dict *dict)
+{
+	for (uint32_t id = 0; id < dict->size; id++) {
+		struct intern_dict_value *chunk =
+			dict->chunks[id / INTERN_DICT_CHUNK_SIZE];
+		free((char *)chunk[id % INTERN_DICT_CHUNK_SIZE].data);
+	}
+	for (int i = 0; i < INTERN_DICT_CHUNK_COUNT; i++)
+		free(dict->chunks[i]);
+	mh_strnu32_delete(dict->hash);
+	free(dict);
+}
+
+int64_t
+intern_dict_put(struct intern_dict *dict, const char *data, uint32_t size)
+{
+	uint32_t hash = mh_strn_hash(data, size);
+	struct mh_strnu32_key_t key = {data, size, hash};
+	mh_int_t k = mh_strnu32_find(dict->hash, &key, NULL);
+	if (k != mh_end(dict->hash))
+		return mh_strnu32_node(dict->hash, k)->val;
+	if (dict->size >= INTERN_DICT_SIZE_MAX)
+		return -1;
+	uint32_t id = dict->size;
+	struct intern_dict_value **chunk =
+		&dict->chunks[id / INTERN_DICT_CHUNK_SIZE];
+	if (*chunk == NULL)
+		*chunk = xcalloc(INTERN_DICT_CHUNK_SIZE, sizeof(**chunk));
+	char *copy = xmalloc(size);
+	memcpy(copy, data, size);
+	struct intern_dict_value *value =
+		&(*chunk)[id % INTERN_DICT_CHUNK_SIZE];
+	value->size = size;
+	value->data = copy;
+	struct mh_strnu32_node_t node = {copy, size, hash, id};
+	mh_strnu32_put(dict->hash, &node, NULL, NULL);
+	dict->size++;
+	return id;
+}
@@ -0,0 +1,88 @@
+#pragma once
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct mh_strnu32_t;
+
+enum {
+	/** Number of values in a chunk of an interned value dictionary. */
+	INTERN_DICT_CHUNK_SIZE = 1024,
+	/** Max number of chunks in an interned value dictionary. */
+	INTERN_DICT_CHUNK_COUNT = 64,
+	/** Max number of values in an interned value dictionary. */
+	INTERN_DICT_SIZE_MAX = INTERN_DICT_CHUNK_SIZE *
+			       INTERN_DICT_CHUNK_COUNT,
+};
+
+/** A value stored in an interned value dictionary. */
+struct intern_dict_value {
+	/** MsgPack of the value. */
+	const char *data;
+	/** Size of the value MsgPack. */
+	uint32_t size;
+};
+
+/**
+ * Dictionary of interned field values of a tuple format. A value
+ * is added to the dictionary on first use and is never removed, so
+ * interning is meant for fields with a small set of distinct values.
+ *
+ * Values are looked up by MsgPack only in the tx thread, while ids
+ * may be resolved to values in any thread (e.g. by a read view
+ * iterator), so values are never moved once added.
+ */
+struct intern_dict {
+	/** Map: value MsgPack => value id. */
+	struct mh_strnu32_t *hash;
+	/** Values indexed by id, allocated in chunks on demand. */
+	struct intern_dict_value *chunks[INTERN_DICT_CHUNK_COUNT];
+	/** Number of values in the dictionary. */
+	uint32_t size;
+};
+
+/** Create a new empty dictionary. */
+struct intern_dict *
+intern_dict_new(void);
+
+/** Delete a dictionary. */
+void
+intern_dict_delete(struct intern_dict *dict);
+
+/**
+ * Return the id of the value MsgPack @a data of @a size bytes,
+ * adding it to the dictionary if necessary. Returns -1 if the
+ * dictionary is full.
+ */
+int64_t
+intern_dict_put(struct intern_dict *dict, const char *data, uint32_t size);
+
+/**
+ * Return the value with the given id or NULL if there's no such
+ * value in the dictionary.
+ */
+static inline const struct intern_dict_value *
+intern_dict_get(const struct intern_dict *dict, uint64_t id)
+{
+	if (id >= INTERN_DICT_SIZE_MAX)
+		return NULL;
+	struct intern_dict_value *chunk =
+		dict->chunks[id / INTERN_DICT_CHUNK_SIZE];
+	if (chunk == NULL)
+		return NULL;
+	const struct intern_dict_value *value =
+		&chunk[id % INTERN_DICT_CHUNK_SIZE];
+	return value->data != NULL ? value : NULL;
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -34,15 +34,18 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <ctype.h>
+#include <limits.h>
 
 #include <msgpuck.h>
 #include <small/ibuf.h>
 #include <small/obuf.h>
 #include <base64.h>
+#include <zstd.h>
 
 #include "version.h"
 #include "event.h"
 #include "func_adapter.h"
+#include "clock.h"
 #include "fiber.h"
 #include "fiber_cond.h"
 #include "cbus.h"
@@ -56,6 +59,7 @@
 
 #include "bind.h"
 #include "port.h"
+#include "sql/port.h"
 #include "box.h"
 #include "call.h"
 #include "tuple_convert.h"
@@ -79,11 +83,45 @@
 #include "box/mp_box_ctx.h"
 #include "box/tuple.h"
 #include "mpstream/mpstream.h"
+#include "read_view.h"
+#include "space.h"
+#include "space_cache.h"
+#include "user.h"
+#include "trivia/usdt.h"
 
 enum {
 	IPROTO_PACKET_SIZE_MAX = 2UL * 1024 * 1024 * 1024,
 };
 
+enum {
+	/**
+	 * Max number of SELECT requests sent to the tx thread in one
+	 * message, see iproto_enqueue_batch().
+	 */
+	IPROTO_SELECT_BATCH_MAX = 32,
+	/**
+	 * Max number of pending stream requests sent to the tx thread
+	 * in one message, see iproto_msg_finish_processing_in_stream().
+	 */
+	IPROTO_STREAM_BATCH_MAX = 32,
+	/**
+	 * Min total size of tuples returned by a SELECT request to send
+	 * them directly from the tuple memory, see iproto_zc_reply.
+	 */
+	IPROTO_ZERO_COPY_SIZE_MIN = 64 * 1024,
+	/**
+	 * Min average size of tuples returned by a SELECT request to send
+	 * them directly from the tuple memory. Writing a lot of small
+	 * chunks is slower than copying them.
+	 */
+	IPROTO_ZERO_COPY_TUPLE_SIZE_MIN = 512,
+	/**
+	 * Max number of SELECT cursors a connection may keep open,
+	 * see IPROTO_CURSOR_ID.
+	 */
+	IPROTO_CURSOR_MAX = 64,
+};
+
 enum {
 	 ENDPOINT_NAME_MAX = 10
 };
@@ -114,6 +152,15 @@ struct iproto_stream {
 	 * This field is accesable only from iproto thread.
 	 */
 	struct iproto_msg *current;
+	/**
+	 * Pending requests sent to the tx thread in one message and
+	 * processed by a single tx fiber, see tx_process_stream_batch().
+	 * The first message is the current one. Linked by
+	 * iproto_msg::in_batch.
+	 */
+	struct stailq batch;
+	/** Message used to send the batch to the tx thread. */
+	struct cmsg batch_msg;
 };
 
 /**
@@ -134,6 +181,34 @@ iproto_wpos_create(struct iproto_wpos *wpos, struct obuf *out)
 	wpos->svp = obuf_create_svp(out);
 }
 
+/**
+ * Tuples returned by a SELECT request that are written to the socket
+ * directly from the tuple memory rather than copied to the connection
+ * output buffer. Created by the tx thread. The reply header is written
+ * to the output buffer as usual, and the iproto thread writes the tuples
+ * right after it (see iproto_flush()). The tuples are referenced until
+ * the tx thread receives the reply back (see tx_zc_reply_delete()).
+ */
+struct iproto_zc_reply {
+	/** Message used to return the reply to the tx thread. */
+	struct cmsg base;
+	/** Link in iproto_connection::zc_replies. */
+	struct stailq_entry in_connection;
+	/**
+	 * Position in the connection output buffer right after
+	 * the reply header.
+	 */
+	struct iproto_wpos wpos;
+	/** Tuple data to write. */
+	struct iovec *iov;
+	/** Number of tuples. */
+	int iov_count;
+	/** Index of the first iovec that hasn't been written yet. */
+	int iov_pos;
+	/** Referenced tuples. */
+	struct tuple **tuples;
+};
+
 /**
  * Message sent when iproto thread dropped all connections that requested
  * to be dropped.
@@ -188,6 +263,8 @@ struct iproto_thread {
 	struct cmsg_hop misc_route[2];
 	struct cmsg_hop call_route[2];
 	struct cmsg_hop select_route[2];
+	struct cmsg_hop select_batch_route[2];
+	struct cmsg_hop stream_batch_route[2];
 	struct cmsg_hop process1_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
@@ -222,6 +299,13 @@ struct iproto_thread {
 	uint32_t id;
 	/** Array of iproto binary listeners */
 	struct evio_service binary;
+	/**
+	 * Listening sockets bound for this thread with SO_REUSEPORT by
+	 * the tx thread if iproto_reuseport is set. The thread listens
+	 * on them instead of the tx_binary sockets, see
+	 * iproto_thread_listener(). Not used by the first thread.
+	 */
+	struct evio_service reuseport_binary;
 	/** Requests count currently pending in stream queue. */
 	size_t requests_in_stream_queue;
 	/** List of all connections. */
@@ -238,6 +322,19 @@ struct iproto_thread {
 	 * accept new connections.
 	 */
 	bool is_shutting_down;
+	/**
+	 * Read view used for serving SELECT requests right in the iproto
+	 * thread or NULL, see iproto_read_view_f(). Set by the tx thread
+	 * with IPROTO_CFG_READ_VIEW.
+	 */
+	struct iproto_read_view *read_view;
+	/**
+	 * Idle watcher that keeps the event loop polling without sleeping
+	 * while it's active, see iproto_thread_busy_poll().
+	 */
+	struct ev_idle busy_poll;
+	/** Time when busy-polling should stop, monotonic. */
+	double busy_poll_deadline;
 	/**
 	 * The following fields are used exclusively by the tx thread.
 	 * Align them to prevent false-sharing.
@@ -262,6 +359,19 @@ static size_t drop_pending_thread_count;
  */
 static unsigned drop_generation;
 
+/**
+ * Interval between read view refreshes, in seconds. If zero, SELECT
+ * requests aren't served from a read view. Set by
+ * box.cfg.iproto_read_view_interval.
+ */
+static double iproto_read_view_interval;
+/** Fiber that refreshes the read view, see iproto_read_view_f(). */
+static struct fiber *iproto_read_view_fiber;
+/** Signaled to wake up iproto_read_view_fiber. */
+static struct fiber_cond iproto_read_view_cond;
+/** Read view currently used by iproto threads or NULL. */
+static struct iproto_read_view *iproto_read_view;
+
 /**
  * IPROTO listen URIs. Set by box.cfg.listen.
  */
@@ -317,6 +427,18 @@ struct iproto_kharon {
  */
 unsigned iproto_readahead = 16320;
 
+size_t iproto_compression_threshold = 16384;
+
+bool iproto_reuseport = false;
+
+double iproto_busy_poll = 0;
+
+double iproto_slow_request_threshold = 0;
+double iproto_wait_vclock_timeout = 1;
+
+/** Context used for compressing responses in the tx thread. */
+static ZSTD_CCtx *tx_zstd_ctx;
+
 /* The maximal number of iproto messages in fly. */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
@@ -401,6 +523,11 @@ enum iproto_cfg_op {
 	 */
 	IPROTO_CFG_DROP_CONNECTIONS,
 	IPROTO_CFG_SHUTDOWN,
+	/**
+	 * Command code to replace the read view used for serving SELECT
+	 * requests in IPROTO thread.
+	 */
+	IPROTO_CFG_READ_VIEW,
 };
 
 /**
@@ -444,6 +571,11 @@ struct iproto_cfg_msg: public cbus_call_msg
 			 */
 			unsigned generation;
 		} drop_connections;
+		/**
+		 * New read view to use in IPROTO thread. Replaced with
+		 * the old one by the IPROTO thread.
+		 */
+		struct iproto_read_view *read_view;
 	};
 	struct iproto_thread *iproto_thread;
 };
@@ -507,6 +639,26 @@ iproto_reset_input(struct ibuf *ibuf)
 
 /* {{{ iproto_msg - declaration */
 
+/**
+ * Session state that the iproto thread needs to serve SELECT requests
+ * from a read view without going to the tx thread. It is reported by
+ * the tx thread with each processed message.
+ */
+struct iproto_session_state {
+	/**
+	 * Authentication token of the session user or BOX_USER_MAX if
+	 * the state isn't known yet.
+	 */
+	uint8_t auth_token;
+	/**
+	 * Id of the session user. Checked along with the token, because
+	 * the token may be reused after the user is dropped.
+	 */
+	uint32_t uid;
+	/** Set if IPROTO_FEATURE_DML_TUPLE_EXTENSION is enabled. */
+	bool box_tuple_as_ext;
+};
+
 /**
  * A single msg from io thread. All requests
  * from all connections are queued into a single queue
@@ -610,8 +762,36 @@ struct iproto_msg
 	struct iproto_stream *stream;
 	/** Link in connection->tx.inprogress. */
 	struct rlist in_inprogress;
+	/**
+	 * SELECT requests that follow this one in the input buffer and
+	 * are sent to the tx thread along with it, see
+	 * iproto_enqueue_batch(). Linked by in_batch.
+	 */
+	struct stailq batch;
+	/** Link in iproto_msg::batch. */
+	struct stailq_entry in_batch;
 	/** TX thread fiber that processing this message. */
 	struct fiber *fiber;
+	/** Time when the first byte of the request was read. */
+	double read_started_at;
+	/** Time when the request was read by the iproto thread. */
+	double received_at;
+	/** Time when the TX thread started processing the request. */
+	double tx_started_at;
+	/** Time when the TX thread finished processing the request. */
+	double tx_finished_at;
+	/** Time spent by the request waiting for WAL writes. */
+	double wal_wait;
+	/**
+	 * Tuples that must be written after the response to this request
+	 * or NULL, see iproto_zc_reply.
+	 */
+	struct iproto_zc_reply *zc_reply;
+	/**
+	 * Session state reported by the tx thread to the iproto thread
+	 * upon completion of the message.
+	 */
+	struct iproto_session_state session_state;
 };
 
 /**
@@ -800,6 +980,11 @@ struct iproto_connection
 	 * meaningless.
 	 */
 	size_t parse_size;
+	/**
+	 * Time when the first byte of the unparsed request was read,
+	 * approximated by the loop time of the read.
+	 */
+	double read_started_at;
 	/**
 	 * Nubmer of active long polling requests that have already
 	 * discarded their arguments in order not to stall other
@@ -893,6 +1078,12 @@ struct iproto_connection
 		bool is_push_pending;
 		/** List of inprogress messages. */
 		struct rlist inprogress;
+		/** Open SELECT cursors, linked by iproto_cursor::link. */
+		struct rlist cursors;
+		/** Number of entries in the cursors list. */
+		int cursor_count;
+		/** Id of the last opened cursor. */
+		uint64_t last_cursor_id;
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
@@ -920,6 +1111,25 @@ struct iproto_connection
 	struct cmsg cancel_msg;
 	/** Set if connection is accepted in TX. */
 	bool is_established;
+	/**
+	 * Session state, as reported by the tx thread with the last
+	 * processed message.
+	 */
+	struct iproto_session_state session_state;
+	/**
+	 * Output buffer for responses written by the iproto thread itself,
+	 * see net_process_select(). Unlike obuf[], it is never accessed by
+	 * the tx thread. To avoid mixing responses, it is flushed only when
+	 * all output written by the tx thread so far has been flushed.
+	 */
+	struct obuf local_obuf;
+	/** Position in local_obuf up to which the data has been flushed. */
+	struct obuf_svp local_wpos;
+	/**
+	 * Tuples to write after the data stored in the output buffers,
+	 * ordered by position, see iproto_zc_reply.
+	 */
+	struct stailq zc_replies;
 };
 
 /** Returns a string suitable for logging. */
@@ -954,6 +1164,7 @@ iproto_stream_new(struct iproto_connection *connection, uint64_t stream_id)
 	stream->txn = NULL;
 	stream->current = NULL;
 	stailq_create(&stream->pending_requests);
+	stailq_create(&stream->batch);
 	stream->id = stream_id;
 	stream->connection = connection;
 	return stream;
@@ -994,6 +1205,7 @@ iproto_stream_delete(struct iproto_stream *stream)
 {
 	assert(stream->current == NULL);
 	assert(stailq_empty(&stream->pending_requests));
+	assert(stailq_empty(&stream->batch));
 	assert(stream->txn == NULL);
 	mempool_free(&stream->connection->iproto_thread->iproto_stream_pool, stream);
 }
@@ -1008,6 +1220,16 @@ iproto_msg_new(struct iproto_connection *con)
 	msg->connection = con;
 	msg->stream = NULL;
 	msg->fiber = NULL;
+	msg->zc_reply = NULL;
+	msg->received_at = ev_monotonic_now(con->loop);
+	msg->read_started_at = con->read_started_at;
+	/* The next request in the buffer was read by now. */
+	con->read_started_at = msg->received_at;
+	msg->tx_started_at = 0;
+	msg->tx_finished_at = 0;
+	msg->wal_wait = 0;
+	msg->session_state = con->session_state;
+	stailq_create(&msg->batch);
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	return msg;
 }
@@ -1323,11 +1545,224 @@ iproto_msg_start_processing_in_stream(struct iproto_msg *msg)
 	return false;
 }
 
+/**
+ * Sends the pending requests of a stream to the tx thread. If there is
+ * more than one pending request, up to IPROTO_STREAM_BATCH_MAX requests
+ * are sent in one message, see tx_process_stream_batch().
+ */
+static void
+iproto_stream_push_pending(struct iproto_stream *stream)
+{
+	struct iproto_connection *con = stream->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	assert(stream->current == NULL);
+	assert(stailq_empty(&stream->batch));
+	assert(!stailq_empty(&stream->pending_requests));
+	stream->current = stailq_shift_entry(&stream->pending_requests,
+					     struct iproto_msg, in_stream);
+	stream->current->wpos = con->wpos;
+	iproto_thread->requests_in_stream_queue--;
+	if (stailq_empty(&stream->pending_requests)) {
+		cpipe_push_input(&iproto_thread->tx_pipe,
+				 &stream->current->base);
+		cpipe_flush_input(&iproto_thread->tx_pipe);
+		return;
+	}
+	stailq_add_tail_entry(&stream->batch, stream->current, in_batch);
+	int batch_size = 1;
+	while (!stailq_empty(&stream->pending_requests) &&
+	       batch_size < IPROTO_STREAM_BATCH_MAX) {
+		struct iproto_msg *msg =
+			stailq_shift_entry(&stream->pending_requests,
+					   struct iproto_msg, in_stream);
+		msg->wpos = con->wpos;
+		iproto_thread->requests_in_stream_queue--;
+		stailq_add_tail_entry(&stream->batch, msg, in_batch);
+		batch_size++;
+	}
+	cmsg_init(&stream->batch_msg, iproto_thread->stream_batch_route);
+	cpipe_push_input(&iproto_thread->tx_pipe, &stream->batch_msg);
+	cpipe_flush_input(&iproto_thread->tx_pipe);
+}
+
+/* {{{ iproto_read_view */
+
+static_assert(BOX_USER_MAX <= 32,
+	      "iproto_read_view_space::read_access must fit all auth tokens");
+
+/**
+ * A read view of memtx spaces that have the iproto_read_view option set,
+ * used by iproto threads to serve SELECT requests without going to the tx
+ * thread. Created and destroyed by the tx thread (see iproto_read_view_f())
+ * and never modified while in use by iproto threads.
+ */
+struct iproto_read_view {
+	/** Database read view. */
+	struct read_view rv;
+	/** Schema version at the time the read view was created. */
+	uint64_t schema_version;
+	/** Map: space id -> struct iproto_read_view_space. */
+	struct mh_i32ptr_t *spaces;
+	/**
+	 * Map: auth token -> user id at the time the read view was
+	 * created. BOX_USER_MAX if the token wasn't in use.
+	 */
+	uint32_t uid[BOX_USER_MAX];
+};
+
+/** A space included in an iproto read view. */
+struct iproto_read_view_space {
+	/** Space read view. */
+	struct space_read_view *rv;
+	/**
+	 * Bit i is set if the user with auth token i was allowed to read
+	 * the space at the time the read view was created.
+	 */
+	uint32_t read_access;
+};
+
+/**
+ * Try to serve a SELECT request from the read view right in the iproto
+ * thread. On success, the response is written to the connection's local
+ * output buffer and 0 is returned. If the request can't be served from
+ * the read view or fails, -1 is returned and the request should be
+ * forwarded to the tx thread, as usual. The diagnostics area is left
+ * intact in this case: the tx thread will report the error, if any.
+ */
+static int
+net_process_select(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct iproto_read_view *rv = iproto_thread->read_view;
+	if (rv == NULL || msg->base.route != iproto_thread->select_route ||
+	    msg->header.stream_id != 0)
+		return -1;
+	/*
+	 * After a DDL the read view is stale until it's refreshed.
+	 * Let the tx thread handle the request in the meantime so
+	 * that the client doesn't see schema versions going back.
+	 */
+	if (rv->schema_version != ::schema_version ||
+	    (msg->header.schema_version != 0 &&
+	     msg->header.schema_version != rv->schema_version))
+		return -1;
+	const struct iproto_session_state *state = &con->session_state;
+	if (state->auth_token >= BOX_USER_MAX ||
+	    rv->uid[state->auth_token] != state->uid ||
+	    state->box_tuple_as_ext)
+		return -1;
+	const struct request *req = &msg->dml;
+	if (req->space_name != NULL || req->index_name != NULL ||
+	    req->after_position != NULL || req->after_tuple != NULL ||
+	    req->fetch_position || req->has_cursor_id ||
+	    req->wait_vclock != NULL || req->iterator >= iterator_type_MAX)
+		return -1;
+	mh_int_t pos = mh_i32ptr_find(rv->spaces, req->space_id, NULL);
+	if (pos == mh_end(rv->spaces))
+		return -1;
+	struct iproto_read_view_space *space =
+		(struct iproto_read_view_space *)
+		mh_i32ptr_node(rv->spaces, pos)->val;
+	if ((space->read_access & (1U << state->auth_token)) == 0)
+		return -1;
+	struct index_read_view *index =
+		space_read_view_index(space->rv, req->index_id);
+	if (index == NULL)
+		return -1;
+
+	enum iterator_type type = (enum iterator_type)req->iterator;
+	const char *key = req->key;
+	uint32_t part_count = key != NULL ? mp_decode_array(&key) : 0;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct diag *diag = diag_get();
+	struct index_read_view_iterator it;
+	if (key_validate(index->def, type, key, part_count) != 0 ||
+	    index_read_view_create_iterator(index, type, key, part_count,
+					    &it) != 0) {
+		diag_clear(diag);
+		return -1;
+	}
+	struct obuf *out = &con->local_obuf;
+	struct obuf_svp svp;
+	iproto_prepare_select(out, &svp);
+	uint32_t offset = req->offset;
+	uint32_t count = 0;
+	int rc = 0;
+	while (count < req->limit) {
+		struct read_view_tuple tuple;
+		rc = index_read_view_iterator_next_raw(&it, &tuple);
+		if (rc != 0 || tuple.data == NULL)
+			break;
+		if (offset > 0) {
+			offset--;
+			continue;
+		}
+		xobuf_dup(out, tuple.data, tuple.size);
+		count++;
+		/* Decompressed tuples are allocated on the region. */
+		region_truncate(region, region_svp);
+	}
+	index_read_view_iterator_destroy(&it);
+	region_truncate(region, region_svp);
+	if (rc != 0) {
+		obuf_rollback_to_svp(out, &svp);
+		diag_clear(diag);
+		return -1;
+	}
+	iproto_reply_select(out, &svp, msg->header.sync, rv->schema_version,
+			    count, false);
+	return 0;
+}
+
+/* }}} iproto_read_view */
+
+/**
+ * Adds a message to a batch of SELECT requests that will be sent to
+ * the tx thread in one cbus message. Returns true if the batch is full
+ * and should be pushed with iproto_push_select_batch().
+ */
+static inline bool
+iproto_add_to_select_batch(struct iproto_msg **batch, int *batch_size,
+			   struct iproto_msg *msg)
+{
+	if (*batch == NULL) {
+		*batch = msg;
+	} else {
+		if (stailq_empty(&(*batch)->batch)) {
+			cmsg_init(&(*batch)->base, msg->connection->
+				  iproto_thread->select_batch_route);
+		}
+		stailq_add_tail_entry(&(*batch)->batch, msg, in_batch);
+	}
+	return ++*batch_size >= IPROTO_SELECT_BATCH_MAX;
+}
+
+/** Pushes a batch of SELECT requests to the tx thread, if any. */
+static inline void
+iproto_push_select_batch(struct iproto_connection *con,
+			 struct iproto_msg **batch, int *batch_size)
+{
+	if (*batch == NULL)
+		return;
+	cpipe_push_input(&con->iproto_thread->tx_pipe, &(*batch)->base);
+	*batch = NULL;
+	*batch_size = 0;
+}
+
 /**
  * Enqueue all requests which were read up. If a request limit is
  * reached - stop the connection input even if not the whole batch
  * is enqueued. Else try to read more feeding read event to the
  * event loop.
+ *
+ * Consecutive SELECT requests that can be processed by the tx thread
+ * in any order are sent to it in one cbus message, which is then
+ * processed by a single tx fiber (see tx_process_select_batch()).
+ * This reduces the cross-thread traffic for clients that pipeline
+ * a lot of small requests.
+ *
  * @param con Connection to enqueue in.
  * @param in Buffer to parse.
  *
@@ -1339,11 +1774,17 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 {
 	assert(rlist_empty(&con->in_stop_list));
 	int n_requests = 0;
+	bool has_local_output = false;
+	struct iproto_msg *batch = NULL;
+	int batch_size = 0;
 	const char *errmsg;
 	while (con->parse_size != 0 && !con->is_in_replication) {
 		if (iproto_check_msg_max(con->iproto_thread)) {
 			iproto_connection_stop_msg_max_limit(con);
+			iproto_push_select_batch(con, &batch, &batch_size);
 			cpipe_flush_input(&con->iproto_thread->tx_pipe);
+			if (has_local_output)
+				iproto_connection_feed_output(con);
 			return 0;
 		}
 		const char *reqstart = in->wpos - con->parse_size;
@@ -1352,6 +1793,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		if (mp_typeof(*pos) != MP_UINT) {
 			errmsg = "packet length";
 err_msgpack:
+			iproto_push_select_batch(con, &batch, &batch_size);
 			cpipe_flush_input(&con->iproto_thread->tx_pipe);
 			diag_set(ClientError, ER_INVALID_MSGPACK,
 				 errmsg);
@@ -1377,7 +1819,20 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		con->input_msg_count[msg->p_ibuf == &con->ibuf[1]]++;
 
 		iproto_msg_prepare(msg, &pos, reqend);
-		if (iproto_msg_start_processing_in_stream(msg)) {
+		bool is_done = net_process_select(msg) == 0;
+		if (is_done) {
+			has_local_output = true;
+			n_requests++;
+		} else if (msg->header.stream_id == 0 &&
+			   msg->base.route ==
+			   con->iproto_thread->select_route) {
+			if (iproto_add_to_select_batch(&batch, &batch_size,
+						       msg))
+				iproto_push_select_batch(con, &batch,
+							 &batch_size);
+			n_requests++;
+		} else if (iproto_msg_start_processing_in_stream(msg)) {
+			iproto_push_select_batch(con, &batch, &batch_size);
 			cpipe_push_input(&con->iproto_thread->tx_pipe, &msg->base);
 			n_requests++;
 		}
@@ -1386,7 +1841,18 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		assert(reqend > reqstart);
 		assert(con->parse_size >= (size_t) (reqend - reqstart));
 		con->parse_size -= reqend - reqstart;
+		if (is_done) {
+			/*
+			 * Discard the request only after it's accounted
+			 * as parsed, see iproto_msg_finish_input().
+			 */
+			iproto_msg_finish_input(msg);
+			iproto_msg_delete(msg);
+		}
 	}
+	iproto_push_select_batch(con, &batch, &batch_size);
+	if (has_local_output && !con->is_in_replication)
+		iproto_connection_feed_output(con);
 	if (con->is_in_replication) {
 		/**
 		 * Don't mess with the file descriptor
@@ -1470,6 +1936,37 @@ iproto_resume(struct iproto_thread *iproto_thread)
 	}
 }
 
+/**
+ * Stop busy-polling once the budget has been spent without any network
+ * activity so that the thread may sleep in the event loop again.
+ */
+static void
+iproto_thread_on_busy_poll(ev_loop *loop, struct ev_idle *watcher,
+			   int /* revents */)
+{
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *)watcher->data;
+	if (iproto_busy_poll <= 0 ||
+	    ev_monotonic_now(loop) >= iproto_thread->busy_poll_deadline)
+		ev_idle_stop(loop, watcher);
+}
+
+/**
+ * Called on network activity. If busy-polling is enabled, prolongs it
+ * so that the thread doesn't go to sleep in epoll_wait() while there
+ * may be more requests or responses coming shortly.
+ */
+static inline void
+iproto_thread_busy_poll(struct iproto_thread *iproto_thread, ev_loop *loop)
+{
+	if (iproto_busy_poll <= 0)
+		return;
+	iproto_thread->busy_poll_deadline =
+		ev_monotonic_now(loop) + iproto_busy_poll;
+	if (!ev_is_active(&iproto_thread->busy_poll))
+		ev_idle_start(loop, &iproto_thread->busy_poll);
+}
+
 static void
 iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			   int /* revents */)
@@ -1480,6 +1977,7 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	assert(con->state == IPROTO_CONNECTION_ALIVE);
 	assert(rlist_empty(&con->in_stop_list));
 	assert(loop == con->loop);
+	iproto_thread_busy_poll(con->iproto_thread, loop);
 	/*
 	 * Throttle if there are too many pending requests,
 	 * otherwise we might deplete the fiber pool in tx
@@ -1519,6 +2017,8 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 
 	/* Update the read position and connection state. */
 	ibuf_alloc(in, nrd);
+	if (con->parse_size == 0)
+		con->read_started_at = ev_monotonic_now(loop);
 	con->parse_size += nrd;
 	/* Enqueue all requests which are fully read up. */
 	if (iproto_enqueue_batch(con, in) != 0)
@@ -1533,30 +2033,15 @@ error:;
 	iproto_connection_close(con);
 }
 
-/** writev() to the socket and handle the result. */
+/**
+ * writev() the data stored in @a obuf between @a begin and @a end to the
+ * socket and advance @a begin. Returns 0 if all the data has been written
+ * (or discarded), IOSTREAM_WANT_* if the socket isn't ready for writing.
+ */
 static int
-iproto_flush(struct iproto_connection *con)
+iproto_flush_obuf(struct iproto_connection *con, struct obuf *obuf,
+		  struct obuf_svp *begin, struct obuf_svp *end)
 {
-	struct obuf *obuf = con->wpos.obuf;
-	struct obuf_svp obuf_end = obuf_create_svp(obuf);
-	struct obuf_svp *begin = &con->wpos.svp;
-	struct obuf_svp *end = &con->wend.svp;
-	if (con->wend.obuf != obuf) {
-		/*
-		 * Flush the current buffer before
-		 * advancing to the next one.
-		 */
-		if (begin->used == obuf_end.used) {
-			obuf = con->wpos.obuf = con->wend.obuf;
-			obuf_svp_reset(begin);
-		} else {
-			end = &obuf_end;
-		}
-	}
-	if (begin->used == end->used) {
-		/* Nothing to do. */
-		return 1;
-	}
 	if (!con->can_write) {
 		/* Receiving end was closed. Discard the output. */
 		*begin = *end;
@@ -1606,12 +2091,138 @@ iproto_flush(struct iproto_connection *con)
 	return nwr;
 }
 
+/**
+ * Flush the output written by the iproto thread to the connection's
+ * local buffer. Returns the same values as iproto_flush().
+ */
+static int
+iproto_flush_local(struct iproto_connection *con)
+{
+	struct obuf_svp end = obuf_create_svp(&con->local_obuf);
+	if (con->local_wpos.used == end.used)
+		return 1;
+	int rc = iproto_flush_obuf(con, &con->local_obuf,
+				   &con->local_wpos, &end);
+	if (rc == 0) {
+		/* All data is written, recycle the buffer. */
+		obuf_reset(&con->local_obuf);
+		obuf_svp_reset(&con->local_wpos);
+	}
+	return rc;
+}
+
+/**
+ * Returns a reply written with iproto_flush_zc_reply() to the tx thread
+ * so that it can release the tuples.
+ */
+static void
+iproto_zc_reply_release(struct iproto_connection *con,
+			struct iproto_zc_reply *reply)
+{
+	cpipe_push(&con->iproto_thread->tx_pipe, &reply->base);
+}
+
+/** Writes the first reply from iproto_connection::zc_replies. */
+static int
+iproto_flush_zc_reply(struct iproto_connection *con)
+{
+	struct iproto_zc_reply *reply =
+		stailq_first_entry(&con->zc_replies, struct iproto_zc_reply,
+				   in_connection);
+	if (con->can_write) {
+		struct iovec *iov = reply->iov + reply->iov_pos;
+		int iovcnt = MIN(reply->iov_count - reply->iov_pos, IOV_MAX);
+		ssize_t nwr = iostream_writev(&con->io, iov, iovcnt);
+		if (nwr == IOSTREAM_ERROR) {
+			diag_log();
+			con->can_write = false;
+		} else if (nwr < 0) {
+			return nwr;
+		} else {
+			rmean_collect(con->iproto_thread->rmean,
+				      IPROTO_SENT, nwr);
+			size_t offset = 0;
+			reply->iov_pos += sio_move_iov(iov, nwr, &offset);
+			if (reply->iov_pos < reply->iov_count) {
+				sio_add_to_iov(&reply->iov[reply->iov_pos],
+					       -offset);
+				return IOSTREAM_WANT_WRITE;
+			}
+		}
+	}
+	stailq_shift(&con->zc_replies);
+	iproto_zc_reply_release(con, reply);
+	return 0;
+}
+
+/**
+ * Returns the position of the first reply from
+ * iproto_connection::zc_replies if it's in the given buffer,
+ * otherwise NULL.
+ */
+static inline struct obuf_svp *
+iproto_zc_reply_pos(struct iproto_connection *con, struct obuf *obuf)
+{
+	if (stailq_empty(&con->zc_replies))
+		return NULL;
+	struct iproto_zc_reply *reply =
+		stailq_first_entry(&con->zc_replies, struct iproto_zc_reply,
+				   in_connection);
+	return reply->wpos.obuf == obuf ? &reply->wpos.svp : NULL;
+}
+
+/** writev() to the socket and handle the result. */
+static int
+iproto_flush(struct iproto_connection *con)
+{
+	/*
+	 * Once we started writing a response from the local buffer,
+	 * we must finish it before switching to the tx output.
+	 */
+	if (con->local_wpos.used != 0)
+		return iproto_flush_local(con);
+	struct obuf *obuf = con->wpos.obuf;
+	struct obuf_svp obuf_end = obuf_create_svp(obuf);
+	struct obuf_svp *begin = &con->wpos.svp;
+	struct obuf_svp *end = &con->wend.svp;
+	struct obuf_svp *zc_pos = iproto_zc_reply_pos(con, obuf);
+	if (con->wend.obuf != obuf) {
+		/*
+		 * Flush the current buffer before
+		 * advancing to the next one.
+		 */
+		if (begin->used == obuf_end.used && zc_pos == NULL) {
+			obuf = con->wpos.obuf = con->wend.obuf;
+			obuf_svp_reset(begin);
+			zc_pos = iproto_zc_reply_pos(con, obuf);
+		} else {
+			end = &obuf_end;
+		}
+	}
+	if (zc_pos != NULL) {
+		/*
+		 * The tuples go right after the reply header so don't
+		 * flush the output past the header until they're written.
+		 */
+		if (zc_pos->used == begin->used)
+			return iproto_flush_zc_reply(con);
+		if (zc_pos->used < end->used)
+			end = zc_pos;
+	}
+	if (begin->used == end->used) {
+		/* Nothing to do, except for the local output. */
+		return iproto_flush_local(con);
+	}
+	return iproto_flush_obuf(con, obuf, begin, end);
+}
+
 static void
 iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 			    int /* revents */)
 {
 	struct iproto_connection *con = (struct iproto_connection *) watcher->data;
 	assert(con->state == IPROTO_CONNECTION_ALIVE);
+	iproto_thread_busy_poll(con->iproto_thread, loop);
 	int rc;
 	while ((rc = iproto_flush(con)) <= 0) {
 		if (rc != 0) {
@@ -1655,19 +2266,29 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 		    iproto_readahead);
 	obuf_create(&con->obuf[1], &con->iproto_thread->net_slabc,
 		    iproto_readahead);
+	obuf_create(&con->local_obuf, cord_slab_cache(), iproto_readahead);
+	obuf_svp_reset(&con->local_wpos);
+	stailq_create(&con->zc_replies);
 	con->p_ibuf = &con->ibuf[0];
 	con->tx.p_obuf = &con->obuf[0];
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
 	con->parse_size = 0;
+	con->read_started_at = ev_monotonic_now(con->loop);
 	con->can_write = true;
 	con->long_poll_count = 0;
 	con->session = NULL;
 	con->is_in_replication = false;
 	con->is_drop_pending = false;
 	con->is_established = false;
+	con->session_state.auth_token = BOX_USER_MAX;
+	con->session_state.uid = BOX_USER_MAX;
+	con->session_state.box_tuple_as_ext = false;
 	rlist_create(&con->in_stop_list);
 	rlist_create(&con->tx.inprogress);
+	rlist_create(&con->tx.cursors);
+	con->tx.cursor_count = 0;
+	con->tx.last_cursor_id = 0;
 	rlist_add_entry(&iproto_thread->connections, con, in_connections);
 	/* It may be very awkward to allocate at close. */
 	cmsg_init(&con->destroy_msg, con->iproto_thread->destroy_route);
@@ -1720,6 +2341,10 @@ iproto_connection_delete(struct iproto_connection *con)
 	ibuf_destroy(&con->ibuf[1]);
 	assert(!obuf_is_initialized(&con->obuf[0]));
 	assert(!obuf_is_initialized(&con->obuf[1]));
+	obuf_destroy(&con->local_obuf);
+	struct iproto_zc_reply *reply, *next;
+	stailq_foreach_entry_safe(reply, next, &con->zc_replies, in_connection)
+		iproto_zc_reply_release(con, reply);
 
 	assert(mh_size(con->streams) == 0);
 	mh_i64ptr_delete(con->streams);
@@ -1751,6 +2376,12 @@ tx_process1(struct cmsg *msg);
 static void
 tx_process_select(struct cmsg *msg);
 
+static void
+tx_process_select_batch(struct cmsg *msg);
+
+static void
+tx_process_stream_batch(struct cmsg *msg);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
@@ -1763,6 +2394,12 @@ tx_reply_iproto_error(struct cmsg *m);
 static void
 net_send_msg(struct cmsg *msg);
 
+static void
+net_send_select_batch(struct cmsg *msg);
+
+static void
+net_send_stream_batch(struct cmsg *msg);
+
 static void
 net_send_error(struct cmsg *msg);
 
@@ -1952,7 +2589,7 @@ iproto_msg_decode(struct iproto_msg *msg, struct cmsg_hop **route)
 }
 
 static void
-tx_fiber_init(struct session *session, uint64_t sync)
+tx_fiber_init(struct session *session, uint64_t sync, uint32_t type)
 {
 	struct fiber *f = fiber();
 	/*
@@ -1961,6 +2598,8 @@ tx_fiber_init(struct session *session, uint64_t sync)
 	 */
 	assert(rlist_empty(&f->on_stop));
 	f->storage.net.sync = sync;
+	f->storage.net.type = type;
+	f->storage.net.wal_wait = 0;
 	/*
 	 * We do not cleanup fiber keys at the end of each request.
 	 * This does not lead to privilege escalation as long as
@@ -1983,7 +2622,7 @@ tx_process_rollback_on_disconnect(struct cmsg *m)
 			     on_disconnect);
 
 	if (stream->txn != NULL) {
-		tx_fiber_init(stream->connection->session, 0);
+		tx_fiber_init(stream->connection->session, 0, 0);
 		txn_attach(stream->txn);
 		if (box_txn_rollback() != 0)
 			panic("failed to rollback transaction on disconnect");
@@ -2007,6 +2646,146 @@ net_finish_rollback_on_disconnect(struct cmsg *m)
 		iproto_connection_try_to_start_destroy(con);
 }
 
+/**
+ * Server-side SELECT cursor, see IPROTO_CURSOR_ID. Keeps the index
+ * iterator between requests so that fetching the next page doesn't
+ * need to position the iterator again. Used only in the tx thread.
+ */
+struct iproto_cursor {
+	/** Cursor id, unique within the connection. */
+	uint64_t id;
+	/** Space and index the cursor iterates over. */
+	uint32_t space_id;
+	uint32_t index_id;
+	/** Index iterator. */
+	struct iterator *it;
+	/** Link in iproto_connection::tx::cursors. */
+	struct rlist link;
+};
+
+/** Close a cursor and free its iterator. */
+static void
+tx_close_cursor(struct iproto_connection *con, struct iproto_cursor *cursor)
+{
+	assert(con->tx.cursor_count > 0);
+	rlist_del_entry(cursor, link);
+	con->tx.cursor_count--;
+	box_iterator_free(cursor->it);
+	free(cursor);
+}
+
+/** Close all cursors of a connection. */
+static void
+tx_close_cursors(struct iproto_connection *con)
+{
+	struct iproto_cursor *cursor, *tmp;
+	rlist_foreach_entry_safe(cursor, &con->tx.cursors, link, tmp)
+		tx_close_cursor(con, cursor);
+	assert(con->tx.cursor_count == 0);
+}
+
+/**
+ * Open a new cursor for a SELECT request. The iterator is positioned
+ * according to the request key, iterator type, offset and pagination
+ * options.
+ */
+static struct iproto_cursor *
+tx_open_cursor(struct iproto_connection *con, const struct request *req)
+{
+	if (con->tx.cursor_count >= IPROTO_CURSOR_MAX) {
+		diag_set(ClientError, ER_CURSOR_LIMIT);
+		return NULL;
+	}
+	const char *packed_pos = req->after_position;
+	const char *packed_pos_end = req->after_position_end;
+	if (packed_pos != NULL) {
+		mp_decode_strl(&packed_pos);
+	} else if (req->after_tuple != NULL) {
+		if (box_index_tuple_position(req->space_id, req->index_id,
+					     req->after_tuple,
+					     req->after_tuple_end,
+					     &packed_pos, &packed_pos_end) != 0)
+			return NULL;
+	}
+	struct iterator *it = box_index_iterator_after(
+		req->space_id, req->index_id, req->iterator,
+		req->key, req->key_end, packed_pos, packed_pos_end);
+	if (it == NULL)
+		return NULL;
+	struct tuple *tuple;
+	for (uint32_t i = 0; i < req->offset; i++) {
+		if (box_iterator_next(it, &tuple) != 0) {
+			box_iterator_free(it);
+			return NULL;
+		}
+		if (tuple == NULL)
+			break;
+	}
+	struct iproto_cursor *cursor =
+		(struct iproto_cursor *)xmalloc(sizeof(*cursor));
+	cursor->id = ++con->tx.last_cursor_id;
+	cursor->space_id = req->space_id;
+	cursor->index_id = req->index_id;
+	cursor->it = it;
+	rlist_add_entry(&con->tx.cursors, cursor, link);
+	con->tx.cursor_count++;
+	return cursor;
+}
+
+/**
+ * Process a SELECT request with IPROTO_CURSOR_ID: open a new cursor
+ * or look up an existing one and fetch up to limit tuples from it to
+ * the port. If the cursor may yield more tuples, its id is returned
+ * in @a cursor_id, otherwise the cursor is closed and @a cursor_id
+ * is set to 0.
+ */
+static int
+tx_process_cursor(struct iproto_connection *con, const struct request *req,
+		  struct port *port, uint64_t *cursor_id)
+{
+	struct iproto_cursor *cursor = NULL;
+	if (req->cursor_id == 0) {
+		cursor = tx_open_cursor(con, req);
+		if (cursor == NULL)
+			return -1;
+	} else {
+		struct iproto_cursor *c;
+		rlist_foreach_entry(c, &con->tx.cursors, link) {
+			if (c->id == req->cursor_id) {
+				cursor = c;
+				break;
+			}
+		}
+		if (cursor == NULL || cursor->space_id != req->space_id ||
+		    cursor->index_id != req->index_id) {
+			diag_set(ClientError, ER_NO_SUCH_CURSOR);
+			return -1;
+		}
+	}
+	port_c_create(port);
+	uint32_t count = 0;
+	struct tuple *tuple = NULL;
+	while (count < req->limit) {
+		if (box_iterator_next(cursor->it, &tuple) != 0) {
+			port_destroy(port);
+			tx_close_cursor(con, cursor);
+			return -1;
+		}
+		if (tuple == NULL)
+			break;
+		port_c_add_tuple(port, tuple);
+		count++;
+	}
+	if (tuple == NULL) {
+		/* The cursor is exhausted or closed by the client. */
+		tx_close_cursor(con, cursor);
+		*cursor_id = 0;
+	} else {
+		*cursor_id = cursor->id;
+	}
+	return 0;
+}
+
 /** Cancel all inprogress requests of the connection. */
 static void
 tx_process_cancel_inprogress(struct cmsg *m)
@@ -2032,7 +2811,7 @@ tx_process_disconnect(struct cmsg *m)
 		 * closed, its push() method is replaced with a stub.
 		 */
 		con->tx.is_push_pending = false;
-		tx_fiber_init(con->session, 0);
+		tx_fiber_init(con->session, 0, 0);
 		session_run_on_disconnect_triggers(con->session);
 	}
 }
@@ -2059,6 +2838,7 @@ tx_process_destroy(struct cmsg *m)
 		session_delete(con->session);
 		con->session = NULL; /* safety */
 	}
+	tx_close_cursors(con);
 	/*
 	 * obuf is being destroyed in tx thread cause it is where
 	 * it was allocated.
@@ -2191,12 +2971,15 @@ tx_accept_msg(struct cmsg *m)
 	if (msg->fiber != NULL)
 		return msg;
 	tx_accept_wpos(msg->connection, &msg->wpos);
-	tx_fiber_init(msg->connection->session, msg->header.sync);
+	tx_fiber_init(msg->connection->session, msg->header.sync,
+		      msg->header.type);
 	tx_prepare_transaction_for_request(msg);
 	msg->connection->iproto_thread->tx.requests_in_progress++;
 	rlist_add_entry(&msg->connection->tx.inprogress, msg,
 			in_inprogress);
 	msg->fiber = fiber();
+	msg->tx_started_at = clock_monotonic();
+	USDT(iproto_request_start, msg->header.sync, msg->header.type);
 	rmean_collect(msg->connection->iproto_thread->tx.rmean,
 		      REQUESTS_IN_PROGRESS, 1);
 	flightrec_write_request(msg->reqstart, msg->len);
@@ -2204,45 +2987,254 @@ tx_accept_msg(struct cmsg *m)
 }
 
 /**
- * Check if the watch request key is in the white list which doesn't need
- * additional checks.
- * The only allowed subscription is to "internal.ballot" event - the one used by
- * replication instead of IPROTO_VOTE on Tarantool 2.11+.
+ * Check if the watch request key is in the white list which doesn't need
+ * additional checks.
+ * The only allowed subscription is to "internal.ballot" event - the one used by
+ * replication instead of IPROTO_VOTE on Tarantool 2.11+.
+ */
+static bool
+check_watch_key(const char *key, uint32_t len)
+{
+	if (len != strlen(box_ballot_event_key))
+		return false;
+	return strncmp(key, box_ballot_event_key, len) == 0;
+}
+
+/**
+ * Check if the tx thread may continue with processing an accepted message.
+ * If something's wrong, returns -1 and sets diag, otherwise returns 0.
+ */
+static int
+tx_check_msg(struct iproto_msg *msg)
+{
+	uint64_t new_schema_version = msg->header.schema_version;
+	if (new_schema_version != 0 && new_schema_version != schema_version) {
+		diag_set(ClientError, ER_WRONG_SCHEMA_VERSION,
+			 new_schema_version, schema_version);
+		return -1;
+	}
+	enum iproto_type type = (enum iproto_type)msg->header.type;
+	if (type != IPROTO_AUTH && type != IPROTO_PING && type != IPROTO_ID &&
+	    type != IPROTO_VOTE && type != IPROTO_VOTE_DEPRECATED &&
+	    (type != IPROTO_WATCH ||
+	     !check_watch_key(msg->watch.key, msg->watch.key_len)) &&
+	    security_check_session() != 0)
+		return -1;
+	return 0;
+}
+
+/**
+ * Save the session state needed by the iproto thread in the message,
+ * see iproto_session_state.
+ */
+static inline void
+tx_save_session_state(struct iproto_msg *msg)
+{
+	struct session *session = msg->connection->session;
+	msg->session_state.auth_token = session->credentials.auth_token;
+	msg->session_state.uid = session->credentials.uid;
+	msg->session_state.box_tuple_as_ext =
+		iproto_features_test(&session->meta.features,
+				     IPROTO_FEATURE_DML_TUPLE_EXTENSION);
+}
+
+/**
+ * Copies @a size bytes starting at @a svp from an output buffer to
+ * a contiguous chunk of memory allocated on the fiber region.
+ */
+static char *
+tx_obuf_copy(struct obuf *out, const struct obuf_svp *svp, size_t size)
+{
+	char *buf = (char *)xregion_alloc(&fiber()->gc, size);
+	char *p = buf;
+	int pos = svp->pos;
+	size_t offset = svp->iov_len;
+	while (size > 0) {
+		size_t len = MIN(out->iov[pos].iov_len - offset, size);
+		memcpy(p, (char *)out->iov[pos].iov_base + offset, len);
+		p += len;
+		size -= len;
+		offset = 0;
+		pos++;
+	}
+	return buf;
+}
+
+/**
+ * Compresses the body of the response starting at @a svp if the client
+ * supports it and the body is big enough, see IPROTO_COMPRESSION.
+ */
+static void
+tx_compress_response(struct iproto_msg *msg, struct obuf_svp *svp)
+{
+	struct obuf *out = msg->connection->tx.p_obuf;
+	size_t size = obuf_size(out) - svp->used;
+	if (iproto_compression_threshold == 0 ||
+	    size <= iproto_compression_threshold ||
+	    !iproto_features_test(&msg->connection->session->meta.features,
+				  IPROTO_FEATURE_COMPRESSION))
+		return;
+	/*
+	 * The tuples of a zero-copy reply aren't stored in the output
+	 * buffer. Also, make sure the response is the last one written
+	 * to the buffer, because we're going to rewrite it.
+	 */
+	if (msg->zc_reply != NULL || msg->wpos.obuf != out ||
+	    msg->wpos.svp.used != obuf_size(out))
+		return;
+	if (tx_zstd_ctx == NULL) {
+		tx_zstd_ctx = ZSTD_createCCtx();
+		if (tx_zstd_ctx == NULL)
+			return;
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	const char *data = tx_obuf_copy(out, svp, size);
+	const char *data_end = data + size;
+	/* Check that the response consists of exactly one packet. */
+	const char *header = data;
+	if (mp_typeof(*header) != MP_UINT)
+		goto out;
+	{
+		uint64_t packet_size = mp_decode_uint(&header);
+		if (packet_size != (uint64_t)(data_end - header) ||
+		    mp_typeof(*header) != MP_MAP)
+			goto out;
+		const char *header_end = header;
+		mp_next(&header_end);
+		const char *body = header_end;
+		size_t body_size = data_end - body;
+		size_t bound = ZSTD_compressBound(body_size);
+		char *zbody = (char *)xregion_alloc(region, bound);
+		size_t zsize = ZSTD_compressCCtx(tx_zstd_ctx, zbody, bound,
+						 body, body_size, 1);
+		if (ZSTD_isError(zsize) ||
+		    mp_sizeof_binl(zsize) + zsize >= body_size)
+			goto out;
+		uint32_t header_map_size = mp_decode_map(&header);
+		size_t header_size = mp_sizeof_map(header_map_size + 1) +
+				     (header_end - header) +
+				     mp_sizeof_uint(IPROTO_COMPRESSION) +
+				     mp_sizeof_uint(IPROTO_COMPRESSION_ZSTD);
+		size_t len = header_size + mp_sizeof_binl(zsize) + zsize;
+		obuf_rollback_to_svp(out, svp);
+		char *p = (char *)xobuf_alloc(out, 5 + header_size +
+					      mp_sizeof_binl(zsize));
+		/* Fix header. */
+		*(p++) = 0xce;
+		mp_store_u32(p, len);
+		p += 4;
+		p = mp_encode_map(p, header_map_size + 1);
+		memcpy(p, header, header_end - header);
+		p += header_end - header;
+		p = mp_encode_uint(p, IPROTO_COMPRESSION);
+		p = mp_encode_uint(p, IPROTO_COMPRESSION_ZSTD);
+		mp_encode_binl(p, zsize);
+		xobuf_dup(out, zbody, zsize);
+		iproto_wpos_create(&msg->wpos, out);
+	}
+out:
+	region_truncate(region, region_svp);
+}
+
+/** Fiber region usage by request type, see iproto_region_stat(). */
+static struct iproto_region_stat tx_region_stat[IPROTO_TYPE_STAT_MAX];
+
+/**
+ * Account the region memory held by the current fiber at the end of
+ * a request of the given type.
+ */
+static inline void
+tx_region_stat_collect(uint32_t type)
+{
+	if (type >= IPROTO_TYPE_STAT_MAX)
+		return;
+	size_t size = region_total(&fiber()->gc);
+	struct iproto_region_stat *stat = &tx_region_stat[type];
+	stat->count++;
+	stat->total += size;
+	stat->max = MAX(stat->max, size);
+}
+
+const struct iproto_region_stat *
+iproto_region_stat(uint32_t type)
+{
+	assert(type < IPROTO_TYPE_STAT_MAX);
+	return &tx_region_stat[type];
+}
+
+/** Request latency by request type, see iproto_latency_stat(). */
+static struct iproto_latency_stat tx_latency_stat[IPROTO_TYPE_STAT_MAX];
+
+static void
+tx_latency_stat_create(void)
+{
+	for (uint32_t type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		struct iproto_latency_stat *stat = &tx_latency_stat[type];
+		stat->count = 0;
+		if (latency_create(&stat->queue) != 0 ||
+		    latency_create(&stat->tx) != 0 ||
+		    latency_create(&stat->wal) != 0)
+			panic("failed to allocate iproto latency histograms");
+	}
+}
+
+static void
+tx_latency_stat_destroy(void)
+{
+	for (uint32_t type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		struct iproto_latency_stat *stat = &tx_latency_stat[type];
+		latency_destroy(&stat->queue);
+		latency_destroy(&stat->tx);
+		latency_destroy(&stat->wal);
+	}
+}
+
+static void
+tx_latency_stat_reset(void)
+{
+	for (uint32_t type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		struct iproto_latency_stat *stat = &tx_latency_stat[type];
+		stat->count = 0;
+		latency_reset(&stat->queue);
+		latency_reset(&stat->tx);
+		latency_reset(&stat->wal);
+	}
+}
+
+/**
+ * Account the latency of a request processed by the current fiber at
+ * the end of the request.
  */
-static bool
-check_watch_key(const char *key, uint32_t len)
+static inline void
+tx_latency_stat_collect(struct iproto_msg *msg)
 {
-	if (len != strlen(box_ballot_event_key))
-		return false;
-	return strncmp(key, box_ballot_event_key, len) == 0;
+	msg->tx_finished_at = clock_monotonic();
+	msg->wal_wait = fiber()->storage.net.wal_wait;
+	uint32_t type = msg->header.type;
+	if (type >= IPROTO_TYPE_STAT_MAX)
+		return;
+	struct iproto_latency_stat *stat = &tx_latency_stat[type];
+	stat->count++;
+	latency_collect(&stat->queue,
+			MAX(msg->tx_started_at - msg->received_at, 0));
+	latency_collect(&stat->tx, msg->tx_finished_at - msg->tx_started_at);
+	latency_collect(&stat->wal, msg->wal_wait);
 }
 
-/**
- * Check if the tx thread may continue with processing an accepted message.
- * If something's wrong, returns -1 and sets diag, otherwise returns 0.
- */
-static int
-tx_check_msg(struct iproto_msg *msg)
+struct iproto_latency_stat *
+iproto_latency_stat(uint32_t type)
 {
-	uint64_t new_schema_version = msg->header.schema_version;
-	if (new_schema_version != 0 && new_schema_version != schema_version) {
-		diag_set(ClientError, ER_WRONG_SCHEMA_VERSION,
-			 new_schema_version, schema_version);
-		return -1;
-	}
-	enum iproto_type type = (enum iproto_type)msg->header.type;
-	if (type != IPROTO_AUTH && type != IPROTO_PING && type != IPROTO_ID &&
-	    type != IPROTO_VOTE && type != IPROTO_VOTE_DEPRECATED &&
-	    (type != IPROTO_WATCH ||
-	     !check_watch_key(msg->watch.key, msg->watch.key_len)) &&
-	    security_check_session() != 0)
-		return -1;
-	return 0;
+	assert(type < IPROTO_TYPE_STAT_MAX);
+	return &tx_latency_stat[type];
 }
 
 static inline void
 tx_end_msg(struct iproto_msg *msg, struct obuf_svp *svp)
 {
+	USDT(iproto_request_finish, msg->header.sync, msg->header.type);
+	tx_region_stat_collect(msg->header.type);
+	tx_latency_stat_collect(msg);
 	if (msg->stream != NULL) {
 		assert(msg->stream->txn == NULL);
 		msg->stream->txn = txn_detach();
@@ -2250,6 +3242,8 @@ tx_end_msg(struct iproto_msg *msg, struct obuf_svp *svp)
 	msg->connection->iproto_thread->tx.requests_in_progress--;
 	rlist_del(&msg->in_inprogress);
 	msg->fiber = NULL;
+	tx_save_session_state(msg);
+	tx_compress_response(msg, svp);
 	struct obuf *out = msg->connection->tx.p_obuf;
 	if (msg->connection->tx.p_obuf->used != svp->used)
 		/* Log response to the flight recorder. */
@@ -2294,6 +3288,35 @@ tx_inject_delay(void)
 	});
 }
 
+/**
+ * Waits until the instance vclock reaches IPROTO_WAIT_VCLOCK sent in the
+ * request, if any, so that a read from a replica sees the writes the client
+ * made on the master. The wait is bounded by iproto_wait_vclock_timeout.
+ */
+static int
+tx_wait_vclock(const char *wait_vclock)
+{
+	if (wait_vclock == NULL)
+		return 0;
+	struct vclock vclock;
+	if (xrow_decode_wait_vclock(wait_vclock, &vclock) != 0)
+		return -1;
+	double deadline = ev_monotonic_now(loop()) + iproto_wait_vclock_timeout;
+	return box_wait_vclock(&vclock, deadline);
+}
+
+/**
+ * Returns true if the reply to a write request should carry the vclock
+ * token, see IPROTO_FEATURE_WAIT_VCLOCK.
+ */
+static inline bool
+tx_reply_vclock_token(struct iproto_msg *msg)
+{
+	return instance_id != REPLICA_ID_NIL &&
+	       iproto_features_test(&msg->connection->session->meta.features,
+				    IPROTO_FEATURE_WAIT_VCLOCK);
+}
+
 static void
 tx_process_begin(struct cmsg *m)
 {
@@ -2357,7 +3380,17 @@ tx_process_commit(struct cmsg *m)
 
 	out = msg->connection->tx.p_obuf;
 	header = obuf_create_svp(out);
-	iproto_reply_ok(out, msg->header.sync, ::schema_version);
+	if (tx_reply_vclock_token(msg)) {
+		struct vclock token;
+		vclock_create(&token);
+		int64_t lsn = vclock_get(box_vclock, instance_id);
+		if (lsn > 0)
+			vclock_follow(&token, instance_id, lsn);
+		iproto_reply_vclock(out, &token, msg->header.sync,
+				    ::schema_version);
+	} else {
+		iproto_reply_ok(out, msg->header.sync, ::schema_version);
+	}
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg, &header);
 	return;
@@ -2472,8 +3505,16 @@ tx_process1(struct cmsg *m)
 	if (box_tuple_as_ext &&
 	    tuple_format_map_to_iproto_obuf(&format_map, out) != 0)
 		goto error;
-	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
-			    tuple != 0, box_tuple_as_ext);
+	if (tx_reply_vclock_token(msg)) {
+		iproto_reply_select_with_vclock(
+			out, &svp, msg->header.sync, ::schema_version,
+			tuple != 0, instance_id,
+			vclock_get(box_vclock, instance_id), box_tuple_as_ext);
+	} else {
+		iproto_reply_select(out, &svp, msg->header.sync,
+				    ::schema_version, tuple != 0,
+				    box_tuple_as_ext);
+	}
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg, &svp);
 	return;
@@ -2484,10 +3525,74 @@ tx_process1(struct cmsg *m)
 	tx_end_msg(msg, &svp);
 }
 
+/** Releases the tuples of a reply sent by iproto_zc_reply_release(). */
 static void
-tx_process_select(struct cmsg *m)
+tx_zc_reply_delete(struct cmsg *m)
 {
-	struct iproto_msg *msg = tx_accept_msg(m);
+	struct iproto_zc_reply *reply = (struct iproto_zc_reply *)m;
+	for (int i = 0; i < reply->iov_count; i++)
+		tuple_unref(reply->tuples[i]);
+	free(reply);
+}
+
+static const struct cmsg_hop tx_zc_reply_route[] = {
+	{ tx_zc_reply_delete, NULL },
+};
+
+/**
+ * Creates a reply that sends the tuples stored in a port directly from
+ * the tuple memory, see iproto_zc_reply. Returns NULL if the tuples are
+ * too small for it to pay off. On success, returns the total size of
+ * the tuples in @a data_size.
+ */
+static struct iproto_zc_reply *
+tx_zc_reply_new(struct port *base, size_t *data_size)
+{
+	struct port_c *port = (struct port_c *)base;
+	size_t size = 0;
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		if (pe->type != PORT_C_ENTRY_TUPLE)
+			return NULL;
+		size += tuple_bsize(pe->tuple);
+	}
+	if (size < IPROTO_ZERO_COPY_SIZE_MIN ||
+	    size < (size_t)port->size * IPROTO_ZERO_COPY_TUPLE_SIZE_MIN)
+		return NULL;
+	int count = port->size;
+	struct iproto_zc_reply *reply = (struct iproto_zc_reply *)
+		xmalloc(sizeof(*reply) + count * (sizeof(*reply->iov) +
+						  sizeof(*reply->tuples)));
+	cmsg_init(&reply->base, tx_zc_reply_route);
+	reply->iov = (struct iovec *)(reply + 1);
+	reply->tuples = (struct tuple **)(reply->iov + count);
+	reply->iov_count = count;
+	reply->iov_pos = 0;
+	int i = 0;
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next, i++) {
+		struct tuple *tuple = pe->tuple;
+		uint32_t bsize;
+		const char *data = tuple_data_range(tuple, &bsize);
+		reply->iov[i].iov_base = (void *)data;
+		reply->iov[i].iov_len = bsize;
+		reply->tuples[i] = tuple;
+		tuple_ref(tuple);
+	}
+	assert(i == count);
+	*data_size = size;
+	return reply;
+}
+
+/**
+ * Processes a SELECT request. If @a zero_copy is set and the request
+ * returns big enough tuples, they are sent without copying them to
+ * the output buffer, see iproto_zc_reply.
+ */
+static void
+tx_process_select_msg(struct iproto_msg *msg, bool zero_copy)
+{
+	tx_accept_msg(&msg->base);
 	bool box_tuple_as_ext =
 		iproto_features_test(&msg->connection->session->meta.features,
 				     IPROTO_FEATURE_DML_TUPLE_EXTENSION);
@@ -2508,16 +3613,27 @@ tx_process_select(struct cmsg *m)
 
 	int count;
 	int rc;
+	size_t data_size;
 	const char *packed_pos, *packed_pos_end;
 	bool reply_position;
+	uint64_t cursor_id = 0;
 	struct request *req = &msg->dml;
 	uint32_t region_svp = region_used(&fiber()->gc);
 	if (tx_check_msg(msg) != 0)
 		goto error;
+	if (tx_wait_vclock(req->wait_vclock) != 0)
+		goto error;
 
 	tx_inject_delay();
 	if (tx_resolve_space_and_index_name(&msg->dml) != 0)
 		goto error;
+	if (req->has_cursor_id) {
+		if (tx_process_cursor(msg->connection, req, &port,
+				      &cursor_id) != 0)
+			goto error;
+		packed_pos = NULL;
+		goto dump;
+	}
 	packed_pos = req->after_position;
 	packed_pos_end = req->after_position_end;
 	if (packed_pos != NULL) {
@@ -2533,12 +3649,27 @@ tx_process_select(struct cmsg *m)
 	rc = box_select(req->space_id, req->index_id,
 			req->iterator, req->offset, req->limit,
 			req->key, req->key_end, &packed_pos, &packed_pos_end,
-			req->fetch_position, &port);
+			req->fetch_position, false, &port);
 	if (rc < 0)
 		goto error;
-
+dump:
 	out = msg->connection->tx.p_obuf;
 	reply_position = req->fetch_position && packed_pos != NULL;
+	if (zero_copy && !reply_position && !box_tuple_as_ext &&
+	    cursor_id == 0 &&
+	    (msg->zc_reply = tx_zc_reply_new(&port, &data_size)) != NULL) {
+		count = msg->zc_reply->iov_count;
+		port_destroy(&port);
+		iproto_prepare_select(out, &svp);
+		iproto_reply_select_detached(out, &svp, msg->header.sync,
+					     ::schema_version, count,
+					     data_size);
+		region_truncate(&fiber()->gc, region_svp);
+		iproto_wpos_create(&msg->wpos, out);
+		msg->zc_reply->wpos = msg->wpos;
+		tx_end_msg(msg, &svp);
+		return;
+	}
 	if (reply_position)
 		iproto_prepare_select_with_position(out, &svp);
 	else
@@ -2559,6 +3690,10 @@ tx_process_select(struct cmsg *m)
 						  ::schema_version, count,
 						  packed_pos, packed_pos_end,
 						  box_tuple_as_ext);
+	} else if (cursor_id != 0) {
+		iproto_reply_select_with_cursor(out, &svp, msg->header.sync,
+						::schema_version, count,
+						cursor_id, box_tuple_as_ext);
 	} else {
 		iproto_reply_select(out, &svp, msg->header.sync,
 				    ::schema_version, count, box_tuple_as_ext);
@@ -2578,6 +3713,105 @@ tx_process_select(struct cmsg *m)
 	tx_end_msg(msg, &svp);
 }
 
+static void
+tx_process_select(struct cmsg *m)
+{
+	tx_process_select_msg((struct iproto_msg *)m, true);
+}
+
+static int
+tx_process_select_f(va_list ap)
+{
+	struct iproto_msg *msg = va_arg(ap, struct iproto_msg *);
+	tx_process_select_msg(msg, false);
+	return 0;
+}
+
+/**
+ * Processes a batch of SELECT requests, see iproto_enqueue_batch().
+ *
+ * The requests are executed one by one in the current fiber. If a request
+ * yields, which may happen if it has to read from disk, the remaining
+ * requests are executed in new fibers so as not to serialize them.
+ */
+static void
+tx_process_select_batch(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *)m;
+	struct iproto_connection *con = msg->connection;
+	struct fiber *f = fiber();
+	int csw = f->csw;
+	/*
+	 * Zero-copy replies rely on messages being returned to the iproto
+	 * thread in the order their replies were written, but a batch is
+	 * returned only after all its requests are complete.
+	 */
+	tx_process_select_msg(msg, false);
+	struct fiber *workers[IPROTO_SELECT_BATCH_MAX];
+	int worker_count = 0;
+	struct iproto_msg *next;
+	stailq_foreach_entry(next, &msg->batch, in_batch) {
+		if (f->csw == csw) {
+			/* Run triggers set by the previous request. */
+			fiber_on_stop(f);
+			tx_process_select_msg(next, false);
+			continue;
+		}
+		assert(worker_count < IPROTO_SELECT_BATCH_MAX);
+		struct fiber *worker = fiber_new(cord_name(cord()),
+						 tx_process_select_f);
+		if (worker == NULL) {
+			diag_log();
+			fiber_on_stop(f);
+			tx_process_select_msg(next, false);
+			continue;
+		}
+		fiber_set_joinable(worker, true);
+		fiber_start(worker, next);
+		workers[worker_count++] = worker;
+	}
+	for (int i = 0; i < worker_count; i++) {
+		if (fiber_join(workers[i]) != 0)
+			diag_log();
+	}
+	/*
+	 * The requests may have been completed in any order and other
+	 * messages may have been sent to the iproto thread while we were
+	 * waiting, so make all of them point to the end of the output
+	 * so that the flush position never goes backwards.
+	 */
+	iproto_wpos_create(&msg->wpos, con->tx.p_obuf);
+	stailq_foreach_entry(next, &msg->batch, in_batch)
+		next->wpos = msg->wpos;
+}
+
+/**
+ * Processes a batch of pending stream requests, see
+ * iproto_stream_push_pending().
+ *
+ * Requests of a stream must be executed sequentially so all of them are
+ * executed one by one in the current fiber. This saves a cbus round trip
+ * and a fiber switch per request of an interactive transaction sent by
+ * a client that pipelines requests. The stream transaction is attached
+ * to the fiber when a request starts and detached when it ends, as usual.
+ */
+static void
+tx_process_stream_batch(struct cmsg *m)
+{
+	struct iproto_stream *stream =
+		container_of(m, struct iproto_stream, batch_msg);
+	struct fiber *f = fiber();
+	bool is_first = true;
+	struct iproto_msg *msg;
+	stailq_foreach_entry(msg, &stream->batch, in_batch) {
+		/* Run triggers set by the previous request. */
+		if (!is_first)
+			fiber_on_stop(f);
+		is_first = false;
+		msg->base.route[0].f(&msg->base);
+	}
+}
+
 static int
 tx_process_call_on_yield(struct trigger *trigger, void *event)
 {
@@ -2623,6 +3857,11 @@ tx_process_call(struct cmsg *m)
 	int rc;
 	struct port port;
 
+	if (tx_wait_vclock(msg->call.wait_vclock) != 0) {
+		trigger_clear(&fiber_on_yield);
+		goto error;
+	}
+
 	switch (msg->header.type) {
 	case IPROTO_CALL:
 	case IPROTO_CALL_16:
@@ -2801,6 +4040,25 @@ tx_process_sql(struct cmsg *m)
 	out = msg->connection->tx.p_obuf;
 	struct obuf_svp header_svp;
 	iproto_prepare_header(out, &header_svp, IPROTO_HEADER_LEN);
+	size_t data_size;
+	if (port.vtab == &port_sql_vtab &&
+	    ((struct port_sql *)&port)->serialization_format == DQL_EXECUTE &&
+	    (msg->zc_reply = tx_zc_reply_new(&port, &data_size)) != NULL) {
+		if (port_sql_dump_msgpack_detached(&port, out) != 0) {
+			tx_zc_reply_delete(&msg->zc_reply->base);
+			msg->zc_reply = NULL;
+			port_destroy(&port);
+			obuf_rollback_to_svp(out, &header_svp);
+			goto error;
+		}
+		port_destroy(&port);
+		iproto_reply_sql_detached(out, &header_svp, msg->header.sync,
+					  schema_version, data_size);
+		iproto_wpos_create(&msg->wpos, out);
+		msg->zc_reply->wpos = msg->wpos;
+		tx_end_msg(msg, &header_svp);
+		return;
+	}
 	if (port_dump_msgpack(&port, out) != 0) {
 		port_destroy(&port);
 		obuf_rollback_to_svp(out, &header_svp);
@@ -3167,6 +4425,23 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 	assert(stream->current == msg);
 	stream->current = NULL;
 
+	if (!stailq_empty(&stream->batch)) {
+		/*
+		 * Replies to a batch of requests are delivered in order,
+		 * see net_send_stream_batch(). Make the next request of
+		 * the batch current until the last one is delivered.
+		 */
+		assert(stailq_first_entry(&stream->batch, struct iproto_msg,
+					  in_batch) == msg);
+		stailq_shift(&stream->batch);
+		if (!stailq_empty(&stream->batch)) {
+			stream->current = stailq_first_entry(&stream->batch,
+							     struct iproto_msg,
+							     in_batch);
+			return;
+		}
+	}
+
 	if (stailq_empty(&stream->pending_requests)) {
 		/*
 		 * If no more messages for the current stream
@@ -3191,25 +4466,45 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 		 * If there are new messages for this stream
 		 * then schedule their processing.
 		 */
-		stream->current =
-			stailq_shift_entry(&stream->pending_requests,
-					   struct iproto_msg,
-					   in_stream);
-		assert(stream->current != NULL);
-		stream->current->wpos = con->wpos;
-		con->iproto_thread->requests_in_stream_queue--;
-		cpipe_push_input(&con->iproto_thread->tx_pipe,
-				 &stream->current->base);
-		cpipe_flush_input(&con->iproto_thread->tx_pipe);
+		iproto_stream_push_pending(stream);
 	}
 }
 
+/**
+ * Log the request if it took longer than iproto_slow_request_threshold,
+ * with a breakdown by stages of processing. Called when the reply to
+ * the request returns to the iproto thread.
+ */
+static void
+net_log_slow_request(struct iproto_msg *msg)
+{
+	double threshold = iproto_slow_request_threshold;
+	if (threshold <= 0 || msg->tx_finished_at == 0)
+		return;
+	double now = clock_monotonic();
+	double total = now - msg->read_started_at;
+	if (total < threshold)
+		return;
+	const char *name = iproto_type_name(msg->header.type);
+	say_warn_ratelimited("slow request %s, sync %llu: %.3f sec "
+			     "(read %.3f, queue %.3f, execution %.3f, "
+			     "wal %.3f, reply %.3f)",
+			     name != NULL ? name : "UNKNOWN",
+			     (unsigned long long)msg->header.sync, total,
+			     msg->received_at - msg->read_started_at,
+			     MAX(msg->tx_started_at - msg->received_at, 0),
+			     msg->tx_finished_at - msg->tx_started_at -
+			     msg->wal_wait, msg->wal_wait,
+			     MAX(now - msg->tx_finished_at, 0));
+}
+
 static void
 net_send_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
 
+	net_log_slow_request(msg);
 	iproto_msg_finish_processing_in_stream(msg);
 	if (msg->len != 0) {
 		/* Discard request (see iproto_enqueue_batch()). */
@@ -3220,6 +4515,11 @@ net_send_msg(struct cmsg *m)
 		con->long_poll_count--;
 	}
 	con->wend = msg->wpos;
+	con->session_state = msg->session_state;
+	if (msg->zc_reply != NULL) {
+		stailq_add_tail_entry(&con->zc_replies, msg->zc_reply,
+				      in_connection);
+	}
 
 	if (con->state == IPROTO_CONNECTION_ALIVE) {
 		iproto_connection_feed_output(con);
@@ -3229,6 +4529,46 @@ net_send_msg(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
+/**
+ * Complete sending a batch of SELECT requests processed by
+ * tx_process_select_batch().
+ */
+static void
+net_send_select_batch(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *)m;
+	struct stailq batch;
+	stailq_create(&batch);
+	stailq_concat(&batch, &msg->batch);
+	net_send_msg(&msg->base);
+	struct iproto_msg *next, *tmp;
+	stailq_foreach_entry_safe(next, tmp, &batch, in_batch)
+		net_send_msg(&next->base);
+}
+
+/**
+ * Complete sending a batch of stream requests processed by
+ * tx_process_stream_batch().
+ */
+static void
+net_send_stream_batch(struct cmsg *m)
+{
+	struct iproto_stream *stream =
+		container_of(m, struct iproto_stream, batch_msg);
+	bool is_last;
+	do {
+		/*
+		 * Delivering the last reply may delete the stream,
+		 * see iproto_msg_finish_processing_in_stream().
+		 */
+		struct iproto_msg *msg = stream->current;
+		is_last = msg == stailq_last_entry(&stream->batch,
+						   struct iproto_msg,
+						   in_batch);
+		msg->base.route[1].f(&msg->base);
+	} while (!is_last);
+}
+
 /**
  * Complete sending an iproto error:
  * recycle the error object and flush output.
@@ -3302,7 +4642,7 @@ tx_process_connect(struct cmsg *m)
 	session_set_peer_addr(con->session, &msg->connect.addr,
 			      msg->connect.addrlen);
 	iproto_features_create(&con->session->meta.features);
-	tx_fiber_init(con->session, 0);
+	tx_fiber_init(con->session, 0, 0);
 	char *greeting = (char *)static_alloc(IPROTO_GREETING_SIZE);
 	/* TODO: dirty read from tx thread */
 	struct tt_uuid uuid = INSTANCE_UUID;
@@ -3313,6 +4653,7 @@ tx_process_connect(struct cmsg *m)
 	if (session_run_on_connect_triggers(con->session) != 0)
 		goto error;
 	iproto_wpos_create(&msg->wpos, out);
+	tx_save_session_state(msg);
 	return;
 error:
 	tx_reply_error(msg);
@@ -3351,6 +4692,7 @@ net_send_greeting(struct cmsg *m)
 	}
 	con->is_established = true;
 	con->wend = msg->wpos;
+	con->session_state = msg->session_state;
 	/*
 	 * Connect is synchronous, so no one could have been
 	 * messing up with the connection while it was in
@@ -3384,6 +4726,15 @@ iproto_thread_accept(struct iproto_thread *iproto_thread, struct iostream *io,
 	msg->connect.addrlen = addrlen;
 	msg->connect.session = session;
 	iostream_move(&con->io, io);
+	if (iproto_busy_poll > 0 &&
+	    evio_setsockopt_busy_poll(con->io.fd,
+				      MIN(iproto_busy_poll * 1e6,
+					  (double)INT_MAX)) != 0) {
+		/* Not critical, e.g. may require CAP_NET_ADMIN. */
+		struct error *e = diag_last_error(diag_get());
+		say_warn_ratelimited("failed to enable busy-polling: %s",
+				     e->errmsg);
+	}
 	cmsg_init(&msg->base, iproto_thread->connect_route);
 	msg->p_ibuf = con->p_ibuf;
 	msg->wpos = con->wpos;
@@ -3419,6 +4770,8 @@ net_cord_f(va_list  ap)
 
 	evio_service_create(loop(), &iproto_thread->binary, "binary",
 			    iproto_on_accept_cb, iproto_thread);
+	ev_idle_init(&iproto_thread->busy_poll, iproto_thread_on_busy_poll);
+	iproto_thread->busy_poll.data = iproto_thread;
 
 	char endpoint_name[ENDPOINT_NAME_MAX];
 	snprintf(endpoint_name, ENDPOINT_NAME_MAX, "net%u",
@@ -3437,6 +4790,7 @@ net_cord_f(va_list  ap)
 
 	cbus_endpoint_destroy(&endpoint, cbus_process);
 	cpipe_destroy(&iproto_thread->tx_pipe);
+	ev_idle_stop(loop(), &iproto_thread->busy_poll);
 	evio_service_detach(&iproto_thread->binary);
 
 	mempool_destroy(&iproto_thread->iproto_stream_pool);
@@ -3566,6 +4920,14 @@ iproto_session_notify(struct session *session, uint64_t sync,
 /**
  * Stops accepting new connections on shutdown.
  */
+/** Stops listeners bound by iproto_start_reuseport(). */
+static void
+iproto_stop_reuseport(void)
+{
+	for (int i = 0; i < iproto_threads_count; i++)
+		evio_service_stop(&iproto_threads[i].reuseport_binary);
+}
+
 static int
 iproto_on_shutdown_f(void *arg)
 {
@@ -3576,7 +4938,10 @@ iproto_on_shutdown_f(void *arg)
 	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_SHUTDOWN);
 	for (int i = 0; i < iproto_threads_count; i++)
 		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
+	iproto_stop_reuseport();
 	evio_service_stop(&tx_binary);
+	/* Let the read view fiber release the read view and exit. */
+	fiber_cond_signal(&iproto_read_view_cond);
 	return 0;
 }
 
@@ -3617,6 +4982,12 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->select_route[0] =
 		{ tx_process_select, &iproto_thread->net_pipe };
 	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_batch_route[0] =
+		{ tx_process_select_batch, &iproto_thread->net_pipe };
+	iproto_thread->select_batch_route[1] = { net_send_select_batch, NULL };
+	iproto_thread->stream_batch_route[0] =
+		{ tx_process_stream_batch, &iproto_thread->net_pipe };
+	iproto_thread->stream_batch_route[1] = { net_send_stream_batch, NULL };
 	iproto_thread->process1_route[0] =
 		{ tx_process1, &iproto_thread->net_pipe };
 	iproto_thread->process1_route[1] = { net_send_msg, NULL };
@@ -3684,6 +5055,10 @@ iproto_thread_init(struct iproto_thread *iproto_thread)
 	iproto_thread->tx.requests_in_progress = 0;
 	iproto_thread->requests_in_stream_queue = 0;
 	rlist_create(&iproto_thread->connections);
+	/* Used only for bind, not for listen, like tx_binary. */
+	evio_service_create(loop(), &iproto_thread->reuseport_binary,
+			    "tx_binary_reuseport", NULL, NULL);
+	iproto_thread->reuseport_binary.reuseport = true;
 }
 
 /**
@@ -3864,6 +5239,7 @@ iproto_init(int threads_count)
 	 * we don't need any accept functions.
 	 */
 	evio_service_create(loop(), &tx_binary, "tx_binary", NULL, NULL);
+	tx_latency_stat_create();
 	iproto_threads = (struct iproto_thread *)
 		xcalloc(threads_count, sizeof(struct iproto_thread));
 	fiber_cond_create(&drop_finished_cond);
@@ -3880,6 +5256,7 @@ iproto_init(int threads_count)
 	 */
 	tx_req_handlers = mh_i32ptr_new();
 	event_foreach(iproto_override_event_init, NULL);
+	fiber_cond_create(&iproto_read_view_cond);
 
 	for (int i = 0; i < threads_count; i++) {
 		struct iproto_thread *iproto_thread = &iproto_threads[i];
@@ -3920,6 +5297,17 @@ iproto_fill_stat(struct iproto_thread *iproto_thread,
 		iproto_thread->requests_in_stream_queue;
 }
 
+/**
+ * Returns the service an IPROTO thread attaches its listener to.
+ */
+static const struct evio_service *
+iproto_thread_listener(struct iproto_thread *iproto_thread)
+{
+	if (iproto_thread->reuseport_binary.entry_count > 0)
+		return &iproto_thread->reuseport_binary;
+	return &tx_binary;
+}
+
 static int
 iproto_do_cfg_f(struct cbus_call_msg *m)
 {
@@ -3940,7 +5328,8 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 	case IPROTO_CFG_START:
 		if (iproto_thread->is_shutting_down)
 			break;
-		evio_service_attach(binary, &tx_binary);
+		evio_service_attach(binary,
+				    iproto_thread_listener(iproto_thread));
 		break;
 	case IPROTO_CFG_SHUTDOWN:
 		iproto_thread->is_shutting_down = true;
@@ -3950,11 +5339,15 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 		break;
 	case IPROTO_CFG_RESTART:
 		evio_service_detach(binary);
-		evio_service_attach(binary, &tx_binary);
+		evio_service_attach(binary,
+				    iproto_thread_listener(iproto_thread));
 		break;
 	case IPROTO_CFG_STAT:
 		iproto_fill_stat(iproto_thread, cfg_msg);
 		break;
+	case IPROTO_CFG_READ_VIEW:
+		SWAP(iproto_thread->read_view, cfg_msg->read_view);
+		break;
 	case IPROTO_CFG_OVERRIDE:
 		if (cfg_msg->override.is_set) {
 			uint32_t old;
@@ -4124,6 +5517,35 @@ iproto_send_restart_msg(void)
 		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
 }
 
+/**
+ * Binds listening sockets with SO_REUSEPORT for all IPROTO threads
+ * except the first one, which listens on the tx_binary sockets, so that
+ * the kernel balances new connections between the threads instead of
+ * waking up all of them on each connection.
+ */
+static int
+iproto_start_reuseport(void)
+{
+	for (int i = 1; i < iproto_threads_count; i++) {
+		if (evio_service_start_reuseport(
+				&iproto_threads[i].reuseport_binary,
+				&tx_binary) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+int
+iproto_set_cpu_affinity(const char *cpu_list)
+{
+	for (int i = 0; i < iproto_threads_count; i++) {
+		if (cord_set_cpu_affinity(&iproto_threads[i].net_cord,
+					  cpu_list) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 int
 iproto_listen(const struct uri_set *uri_set)
 {
@@ -4136,6 +5558,11 @@ iproto_listen(const struct uri_set *uri_set)
 	if (uri_set_is_equal(uri_set, &iproto_uris)) {
 		if (evio_service_reload_uris(&tx_binary) != 0)
 			return -1;
+		for (int i = 0; i < iproto_threads_count; i++) {
+			if (evio_service_reload_uris(
+				&iproto_threads[i].reuseport_binary) != 0)
+				return -1;
+		}
 		iproto_send_restart_msg();
 		return 0;
 	}
@@ -4148,6 +5575,7 @@ iproto_listen(const struct uri_set *uri_set)
 	uri_set_destroy(&iproto_uris);
 	uri_set_copy(&iproto_uris, uri_set);
 	iproto_send_stop_msg();
+	iproto_stop_reuseport();
 	evio_service_stop(&tx_binary);
 	struct errinj *inj = errinj(ERRINJ_IPROTO_CFG_LISTEN, ERRINJ_INT);
 	if (inj != NULL && inj->iparam > 0) {
@@ -4161,8 +5589,11 @@ iproto_listen(const struct uri_set *uri_set)
 	 * implementation, we rely on the Linux kernel to distribute
 	 * incoming connections across iproto threads.
 	 */
+	tx_binary.reuseport = iproto_reuseport;
 	if (evio_service_start(&tx_binary, uri_set) != 0)
 		return -1;
+	if (iproto_reuseport && iproto_start_reuseport() != 0)
+		return -1;
 	iproto_send_start_msg();
 	return 0;
 }
@@ -4212,6 +5643,8 @@ iproto_reset_stat(void)
 		rmean_cleanup(iproto_threads[i].rmean);
 		rmean_cleanup(iproto_threads[i].tx.rmean);
 	}
+	memset(tx_region_stat, 0, sizeof(tx_region_stat));
+	tx_latency_stat_reset();
 }
 
 int
@@ -4233,6 +5666,177 @@ iproto_set_msg_max(int new_iproto_msg_max)
 	return 0;
 }
 
+static bool
+iproto_read_view_filter_space(struct space *space, void *arg)
+{
+	(void)arg;
+	return space->def->opts.iproto_read_view;
+}
+
+static bool
+iproto_read_view_filter_index(struct space *space, struct index *index,
+			      void *arg)
+{
+	(void)space;
+	(void)arg;
+	/*
+	 * Requests to indexes waiting to be built are passed to the tx
+	 * thread, which reports an error.
+	 */
+	if (index->needs_build)
+		return false;
+	/* Other index types don't support read views. */
+	return index->def->type == TREE || index->def->type == HASH;
+}
+
+/**
+ * Returns a bit map of auth tokens of users that are allowed to read
+ * the given space, see iproto_read_view_space::read_access.
+ */
+static uint32_t
+tx_space_read_access(struct space *space)
+{
+	uint32_t read_access = 0;
+	struct fiber *f = fiber();
+	struct credentials *orig_cr = fiber_get_user(f);
+	for (int token = 0; token < BOX_USER_MAX; token++) {
+		struct user *user = user_find_by_token(token);
+		if (user->def == NULL || user->def->type != SC_USER)
+			continue;
+		struct credentials cr;
+		credentials_create(&cr, user);
+		fiber_set_user(f, &cr);
+		if (access_check_space(space, PRIV_R) == 0)
+			read_access |= 1U << token;
+		else
+			diag_clear(diag_get());
+		fiber_set_user(f, orig_cr);
+		credentials_destroy(&cr);
+	}
+	return read_access;
+}
+
+/** Deletes a read view created with iproto_read_view_new(). */
+static void
+iproto_read_view_delete(struct iproto_read_view *rv)
+{
+	mh_int_t i;
+	mh_foreach(rv->spaces, i)
+		free(mh_i32ptr_node(rv->spaces, i)->val);
+	mh_i32ptr_delete(rv->spaces);
+	read_view_close(&rv->rv);
+	TRASH(rv);
+	free(rv);
+}
+
+/**
+ * Opens a read view of all spaces that have the iproto_read_view option
+ * set. Access rights are checked at this point and cached in the read view.
+ * Returns NULL and sets diag on error.
+ */
+static struct iproto_read_view *
+iproto_read_view_new(void)
+{
+	struct iproto_read_view *rv =
+		(struct iproto_read_view *)xmalloc(sizeof(*rv));
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = "iproto";
+	opts.filter_space = iproto_read_view_filter_space;
+	opts.filter_index = iproto_read_view_filter_index;
+	opts.enable_data_temporary_spaces = true;
+	if (read_view_open(&rv->rv, &opts) != 0) {
+		free(rv);
+		return NULL;
+	}
+	rv->schema_version = ::schema_version;
+	for (int token = 0; token < BOX_USER_MAX; token++) {
+		struct user *user = user_find_by_token(token);
+		rv->uid[token] = user->def != NULL ? user->def->uid :
+				 BOX_USER_MAX;
+	}
+	rv->spaces = mh_i32ptr_new();
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, &rv->rv) {
+		struct space *space = space_by_id(space_rv->id);
+		assert(space != NULL);
+		struct iproto_read_view_space *rv_space =
+			(struct iproto_read_view_space *)
+			xmalloc(sizeof(*rv_space));
+		rv_space->rv = space_rv;
+		rv_space->read_access = tx_space_read_access(space);
+		struct mh_i32ptr_node_t node = { space_rv->id, rv_space };
+		mh_i32ptr_put(rv->spaces, &node, NULL, NULL);
+	}
+	return rv;
+}
+
+/**
+ * Makes all iproto threads use the given read view (may be NULL) and
+ * deletes the read view used before.
+ */
+static void
+iproto_read_view_set(struct iproto_read_view *rv)
+{
+	if (rv == NULL && iproto_read_view == NULL)
+		return;
+	struct iproto_cfg_msg cfg_msg;
+	for (int i = 0; i < iproto_threads_count; i++) {
+		iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_READ_VIEW);
+		cfg_msg.read_view = rv;
+		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
+		assert(cfg_msg.read_view == iproto_read_view);
+	}
+	if (iproto_read_view != NULL)
+		iproto_read_view_delete(iproto_read_view);
+	iproto_read_view = rv;
+}
+
+/**
+ * Fiber that periodically replaces the read view used by iproto threads
+ * for serving SELECT requests with a fresh one, so that the data returned
+ * by such requests is at most iproto_read_view_interval seconds stale.
+ */
+static int
+iproto_read_view_f(va_list ap)
+{
+	(void)ap;
+	while (!iproto_is_shutting_down) {
+		if (iproto_read_view_interval == 0) {
+			iproto_read_view_set(NULL);
+			fiber_cond_wait(&iproto_read_view_cond);
+			continue;
+		}
+		struct iproto_read_view *rv = iproto_read_view_new();
+		if (rv == NULL)
+			diag_log();
+		iproto_read_view_set(rv);
+		fiber_cond_wait_timeout(&iproto_read_view_cond,
+					iproto_read_view_interval);
+	}
+	iproto_read_view_set(NULL);
+	iproto_read_view_fiber = NULL;
+	return 0;
+}
+
+int
+iproto_set_read_view_interval(double interval)
+{
+	iproto_read_view_interval = interval;
+	if (iproto_read_view_fiber != NULL) {
+		fiber_cond_signal(&iproto_read_view_cond);
+		return 0;
+	}
+	if (interval == 0 || iproto_is_shutting_down)
+		return 0;
+	iproto_read_view_fiber = fiber_new_system("iproto_read_view",
+						  iproto_read_view_f);
+	if (iproto_read_view_fiber == NULL)
+		return -1;
+	fiber_wakeup(iproto_read_view_fiber);
+	return 0;
+}
+
 int
 iproto_session_new(struct iostream *io, struct user *user, uint64_t *sid)
 {
@@ -4322,6 +5926,7 @@ iproto_free(void)
 		 * is closed by OS.
 		 */
 		evio_service_detach(&iproto_threads[i].binary);
+		evio_service_stop(&iproto_threads[i].reuseport_binary);
 		rmean_delete(iproto_threads[i].rmean);
 		rmean_delete(iproto_threads[i].tx.rmean);
 		slab_cache_destroy(&iproto_threads[i].net_slabc);
@@ -4338,6 +5943,9 @@ iproto_free(void)
 	}
 	mh_i32ptr_delete(tx_req_handlers);
 	fiber_cond_destroy(&drop_finished_cond);
+	tx_latency_stat_destroy();
+	ZSTD_freeCCtx(tx_zstd_ctx);
+	tx_zstd_ctx = NULL;
 
 	/*
 	 * Here we close sockets and unlink all unix socket paths.
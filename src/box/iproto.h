@@ -35,6 +35,7 @@
 #include <stdint.h>
 
 #include "box/box.h"
+#include "latency.h"
 
 struct uri_set;
 struct session;
@@ -80,6 +81,42 @@ struct iproto_stats {
 };
 
 extern unsigned iproto_readahead;
+/**
+ * Min size of a response body to compress it if the client supports
+ * IPROTO_FEATURE_COMPRESSION. Zero disables compression.
+ */
+extern size_t iproto_compression_threshold;
+/**
+ * If set, each IPROTO thread listens on its own sockets bound with
+ * SO_REUSEPORT so that the kernel balances new connections between
+ * the threads.
+ */
+extern bool iproto_reuseport;
+/**
+ * Time, in seconds, an IPROTO thread keeps polling for events without
+ * sleeping after the last network activity. Zero disables busy-polling.
+ */
+extern double iproto_busy_poll;
+/**
+ * Requests that take longer than this time, in seconds, from reading to
+ * returning the reply to the IPROTO thread are logged with a breakdown by
+ * stages of processing. Zero disables the slow request log.
+ */
+extern double iproto_slow_request_threshold;
+
+/**
+ * How long a SELECT, CALL or EVAL request carrying IPROTO_WAIT_VCLOCK
+ * may wait for the instance vclock to reach the given one before it
+ * fails with a timeout error.
+ */
+extern double iproto_wait_vclock_timeout;
+
+/**
+ * Pins all IPROTO threads to the given CPUs, see
+ * cord_set_cpu_affinity(). Returns -1 and sets diag on error.
+ */
+int
+iproto_set_cpu_affinity(const char *cpu_list);
 extern int iproto_threads_count;
 
 /**
@@ -103,6 +140,48 @@ iproto_stats_get(struct iproto_stats *stats);
 void
 iproto_thread_stats_get(struct iproto_stats *stats, int thread_id);
 
+/** Fiber region usage by requests of one type. */
+struct iproto_region_stat {
+	/** Number of requests. */
+	uint64_t count;
+	/** Sum of region memory held at the end of the requests. */
+	uint64_t total;
+	/** Max region memory held at the end of a request. */
+	size_t max;
+};
+
+/**
+ * Return fiber region usage by requests of the given type handled
+ * in the TX thread. The type must be less than IPROTO_TYPE_STAT_MAX.
+ */
+const struct iproto_region_stat *
+iproto_region_stat(uint32_t type);
+
+/**
+ * Latency of requests of one type handled in the TX thread, in seconds.
+ * Collected at the end of each request.
+ */
+struct iproto_latency_stat {
+	/** Number of requests. */
+	uint64_t count;
+	/**
+	 * Time from reading the request in the IPROTO thread to the start
+	 * of its processing in the TX thread.
+	 */
+	struct latency queue;
+	/** Time of processing in the TX thread, including the WAL wait. */
+	struct latency tx;
+	/** Time spent by the request waiting for WAL writes. */
+	struct latency wal;
+};
+
+/**
+ * Return latency of requests of the given type. The type must be less
+ * than IPROTO_TYPE_STAT_MAX.
+ */
+struct iproto_latency_stat *
+iproto_latency_stat(uint32_t type);
+
 /**
  * Reset network statistics.
  */
@@ -152,6 +231,15 @@ iproto_listen(const struct uri_set *uri_set);
 int
 iproto_set_msg_max(int iproto_msg_max);
 
+/**
+ * Sets the interval between refreshes of the read view used by IPROTO
+ * threads to serve SELECT requests for spaces with the iproto_read_view
+ * option without going to the tx thread. Zero disables the feature.
+ * Returns 0 on success, -1 on error (diagnostic is set).
+ */
+int
+iproto_set_read_view_interval(double interval);
+
 /**
  * Creates a new IPROTO session over the given IO stream. Doesn't yield.
  * Set the output parameter sid to the sid of newly created session.
@@ -218,7 +218,38 @@ extern const char *iproto_flag_bit_strs[];
 	/**
 	 * Flag indicating whether the transaction is synchronous.
 	 */								\
-	 _(IS_SYNC, 0x61, MP_BOOL)
+	 _(IS_SYNC, 0x61, MP_BOOL)					\
+	/**
+	 * Packet header key set if the packet body is compressed, see
+	 * enum iproto_compression_type. The compressed body is encoded
+	 * as MP_BIN.
+	 */								\
+	_(COMPRESSION, 0x62, MP_UINT)					\
+	/**
+	 * Id of the function to call. May be used in IPROTO_CALL
+	 * instead of IPROTO_FUNCTION_NAME to skip the name lookup.
+	 */								\
+	_(FUNCTION_ID, 0x63, MP_UINT)					\
+	/**
+	 * Id of a server-side SELECT cursor. Zero in a request opens
+	 * a new cursor, a non-zero value fetches the next page from
+	 * the cursor opened before. Set in a response if the cursor
+	 * may yield more tuples.
+	 */								\
+	_(CURSOR_ID, 0x64, MP_UINT)					\
+	/**
+	 * zstd compression level requested by a replica in SUBSCRIBE.
+	 * If set, the master compresses the bodies of the rows it sends
+	 * with a streaming zstd context, see IPROTO_COMPRESSION.
+	 */								\
+	_(COMPRESSION_LEVEL, 0x65, MP_UINT)				\
+	/**
+	 * Vclock a SELECT, CALL or EVAL request waits for before it's
+	 * executed. Usually it's the IPROTO_VCLOCK returned in the
+	 * response to a write made on the master, which lets a client
+	 * read its own writes from a replica.
+	 */								\
+	_(WAIT_VCLOCK, 0x66, MP_MAP)
 
 #define IPROTO_KEY_MEMBER(s, v, ...) IPROTO_ ## s = v,
 
@@ -238,6 +269,12 @@ static_assert(iproto_key_MAX <= 0x80, "iproto_key_MAX must be <= 0x80");
 /** IPROTO key name by code. */
 extern const char *iproto_key_strs[];
 
+/** Packet body compression types, see IPROTO_COMPRESSION. */
+enum iproto_compression_type {
+	IPROTO_COMPRESSION_NONE = 0,
+	IPROTO_COMPRESSION_ZSTD = 1,
+};
+
 /** MsgPack value type by IPROTO key. */
 extern const unsigned char iproto_key_type[];
 
@@ -391,11 +428,16 @@ iproto_key_bit(unsigned char key)
 	_(WATCH_ONCE, 77)						\
 									\
 	/**
-	 * The following three requests are reserved for vinyl types.
+	 * The following four requests are reserved for vinyl types.
 	 *
 	 * VY_INDEX_RUN_INFO = 100
 	 * VY_INDEX_PAGE_INFO = 101
 	 * VY_RUN_ROW_INDEX = 102
+	 * VY_RUN_BLOOM = 103
+	 *
+	 * The following request is reserved for memtx snapshots.
+	 *
+	 * MEMTX_INDEX_ORDER = 104
 	 */								\
 									\
 	/** Non-final response type. */					\
@@ -422,6 +464,10 @@ enum iproto_type {
 	VY_INDEX_PAGE_INFO = 101,
 	/** Vinyl row index stored in .run file */
 	VY_RUN_ROW_INDEX = 102,
+	/** Vinyl bloom filter partition stored in .run file */
+	VY_RUN_BLOOM = 103,
+	/** Order of a memtx tree index stored in .snap file */
+	MEMTX_INDEX_ORDER = 104,
 };
 
 /** IPROTO type name by code */
@@ -465,6 +511,10 @@ iproto_type_name(uint16_t type)
 		return "PAGEINFO";
 	case VY_RUN_ROW_INDEX:
 		return "ROWINDEX";
+	case VY_RUN_BLOOM:
+		return "BLOOM";
+	case MEMTX_INDEX_ORDER:
+		return "INDEXORDER";
 	default:
 		return NULL;
 	}
@@ -595,6 +645,8 @@ request_replace_body_create(struct request_replace_body *body,
 	_(BLOOM_FILTER, 7)						\
 	/** Number of statements of each type (map). */			\
 	_(STMT_STAT, 8)							\
+	/** Bloom filter partitions stored in the run file (array). */	\
+	_(BLOOM_PARTITIONS, 9)						\
 
 #define VY_RUN_INFO_KEY_MEMBER(s, v) VY_RUN_INFO_ ## s = v,
 
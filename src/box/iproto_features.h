@@ -77,6 +77,28 @@ extern "C" {
 	 * tuple formats are received in IPROTO_TUPLE_FORMATS field.
 	 */								\
 	_(CALL_ARG_TUPLE_EXTENSION, 9)					\
+	/**
+	 * Response body compression support: big response bodies may be
+	 * compressed, see IPROTO_COMPRESSION.
+	 */								\
+	_(COMPRESSION, 10)						\
+	/**
+	 * IPROTO_CALL by function id support: a function registered in
+	 * the _func space may be called by IPROTO_FUNCTION_ID.
+	 */								\
+	_(CALL_BY_FUNCTION_ID, 11)					\
+	/**
+	 * Server-side SELECT cursor support, see IPROTO_CURSOR_ID.
+	 */								\
+	_(CURSOR, 12)							\
+	/**
+	 * Vclock tokens for reading your own writes from replicas:
+	 * the server returns IPROTO_VCLOCK in the response to a DML
+	 * request and accepts IPROTO_WAIT_VCLOCK in SELECT, CALL and
+	 * EVAL requests. The token is only returned to clients that
+	 * set this feature in IPROTO_ID.
+	 */								\
+	_(WAIT_VCLOCK, 13)						\
 
 #define IPROTO_FEATURE_MEMBER(s, v) IPROTO_FEATURE_ ## s = v,
 
@@ -101,7 +123,7 @@ struct iproto_features {
  * `box.iproto.protocol_version` needs to be updated correspondingly.
  */
 enum {
-	IPROTO_CURRENT_VERSION = 7,
+	IPROTO_CURRENT_VERSION = 11,
 };
 
 /**
@@ -1124,6 +1124,8 @@ key_def_merge(const struct key_def *first, const struct key_def *second)
 	new_def->for_func_index = first->for_func_index;
 	new_def->is_unordered = first->is_unordered;
 	new_def->func_index_func = first->func_index_func;
+	new_def->has_filter = first->has_filter;
+	new_def->filter = first->filter;
 
 	/* JSON paths data in the new key_def. */
 	char *path_pool = (char *)new_def + key_def_sizeof(new_part_count, 0);
@@ -178,6 +178,37 @@ typedef hint_t (*tuple_hint_t)(struct tuple *tuple,
 typedef hint_t (*key_hint_t)(const char *key, uint32_t part_count,
 			     struct key_def *key_def);
 
+enum {
+	/** Max size of the MsgPack value a partial index is filtered by. */
+	KEY_FILTER_VALUE_MAX = 64,
+};
+
+/**
+ * Filter of a partial index: only tuples in which the top-level
+ * field @fieldno is equal to @value are stored in the index.
+ */
+struct key_filter {
+	/** Zero-based number of the filtered field. */
+	uint32_t fieldno;
+	/** Size of @value, 0 if the index isn't partial. */
+	uint32_t value_len;
+	/** MsgPack encoded scalar the field must be equal to. */
+	char value[KEY_FILTER_VALUE_MAX];
+};
+
+/** Compare two partial index filters. */
+static inline int
+key_filter_cmp(const struct key_filter *f1, const struct key_filter *f2)
+{
+	if (f1->value_len != f2->value_len)
+		return f1->value_len < f2->value_len ? -1 : 1;
+	if (f1->value_len == 0)
+		return 0;
+	if (f1->fieldno != f2->fieldno)
+		return f1->fieldno < f2->fieldno ? -1 : 1;
+	return memcmp(f1->value, f2->value, f1->value_len);
+}
+
 /* Definition of a multipart key. */
 struct key_def {
 	/** @see tuple_compare() */
@@ -208,6 +239,8 @@ struct key_def {
 	bool is_nullable;
 	/** True if some key part has exclude_null option */
 	bool has_exclude_null;
+	/** True if this is a partial index key definition. */
+	bool has_filter;
 	/** True if some key part has JSON path. */
 	bool has_json_paths;
 	/** True if it is a multikey index definition.
@@ -273,6 +306,11 @@ struct key_def {
 	 * undefined otherwise.
 	*/
 	uint32_t multikey_fieldno;
+	/**
+	 * Filter of a partial index. Valid when key_def->has_filter
+	 * is true, undefined otherwise.
+	 */
+	struct key_filter filter;
 	/** The size of the 'parts' array. */
 	uint32_t part_count;
 	/** Description of parts of a multipart index. */
@@ -927,13 +965,14 @@ tuple_key_is_excluded_slow(struct tuple *tuple, struct key_def *def,
  * @retval true if the tuple key should be excluded from the index.
  *
  * We exclude a tuple if any of its key fields contains null and
- * the index has the 'exclude_null' flag set.
+ * the index has the 'exclude_null' flag set or if the index is
+ * partial and the tuple doesn't match its filter.
  */
 static inline bool
 tuple_key_is_excluded(struct tuple *tuple, struct key_def *def,
 		      int multikey_idx)
 {
-	if (likely(!def->has_exclude_null))
+	if (likely(!def->has_exclude_null && !def->has_filter))
 		return false;
 	return tuple_key_is_excluded_slow(tuple, def, multikey_idx);
 }
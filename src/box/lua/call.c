@@ -38,6 +38,8 @@
 #include "fiber.h"
 #include "tt_static.h"
 
+#include <lmisclib.h>
+
 #include "lua/utils.h"
 #include "lua/serializer.h"
 #include "lua/msgpack.h"
@@ -985,6 +987,14 @@ func_persistent_lua_load(const struct func_def *def)
 	return func_ref;
 }
 
+uint64_t
+box_lua_gc_allocated(void)
+{
+	struct luam_Metrics metrics;
+	luaM_metrics(tarantool_L, &metrics);
+	return metrics.gc_allocated;
+}
+
 struct func *
 func_lua_new(const struct func_def *def)
 {
@@ -58,6 +58,13 @@ int
 box_lua_eval(const char *expr, uint32_t expr_len,
 	     struct port *args, struct port *ret);
 
+/**
+ * Return the total number of bytes allocated by the Lua garbage collector
+ * since the start. Used for collecting function statistics.
+ */
+uint64_t
+box_lua_gc_allocated(void);
+
 /** Construct a Lua function object. */
 struct func *
 func_lua_new(const struct func_def *def);
@@ -37,7 +37,7 @@
 #include "lua/utils.h"
 
 #include "box/box.h"
-#include "libeio/eio.h"
+#include "coio_task.h"
 
 extern "C" {
 	#include <lua.h>
@@ -169,6 +169,17 @@ lbox_cfg_set_checkpoint_wal_threshold(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_checkpoint_recovery_time(struct lua_State *L)
+{
+	try {
+		box_set_checkpoint_recovery_time();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_wal_queue_max_size(struct lua_State *L)
 {
@@ -177,6 +188,14 @@ lbox_cfg_set_wal_queue_max_size(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_wal_ring_size(struct lua_State *L)
+{
+	if (box_set_wal_ring_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_wal_cleanup_delay(struct lua_State *L)
 {
@@ -251,6 +270,50 @@ lbox_cfg_set_vinyl_cache(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_page_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_page_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_os_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_os_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_read_ahead(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_read_ahead();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_read_latency_budget(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_read_latency_budget();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 {
@@ -281,6 +344,168 @@ lbox_cfg_set_net_msg_max(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_iproto_read_view_interval(struct lua_State *L)
+{
+	try {
+		box_set_iproto_read_view_interval();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_iproto_compression_threshold(struct lua_State *L)
+{
+	try {
+		box_set_iproto_compression_threshold();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_tx_cpu_affinity(struct lua_State *L)
+{
+	try {
+		box_set_tx_cpu_affinity();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_wal_cpu_affinity(struct lua_State *L)
+{
+	try {
+		box_set_wal_cpu_affinity();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_iproto_cpu_affinity(struct lua_State *L)
+{
+	try {
+		box_set_iproto_cpu_affinity();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_use_huge_pages(struct lua_State *L)
+{
+	try {
+		box_set_memtx_use_huge_pages();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_checkpoint_delta_count(struct lua_State *L)
+{
+	try {
+		box_set_memtx_checkpoint_delta_count();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_snapshot_compress_threads(struct lua_State *L)
+{
+	try {
+		box_set_memtx_snapshot_compress_threads();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_snapshot_index_order(struct lua_State *L)
+{
+	(void)L;
+	box_set_memtx_snapshot_index_order();
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_snapshot_compression_level(struct lua_State *L)
+{
+	try {
+		box_set_memtx_snapshot_compression_level();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_ddl_rate_limit(struct lua_State *L)
+{
+	try {
+		box_set_memtx_ddl_rate_limit();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_numa_node(struct lua_State *L)
+{
+	try {
+		box_set_memtx_numa_node();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_iproto_busy_poll(struct lua_State *L)
+{
+	try {
+		box_set_iproto_busy_poll();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_iproto_slow_request_threshold(struct lua_State *L)
+{
+	try {
+		box_set_iproto_slow_request_threshold();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_iproto_wait_vclock_timeout(struct lua_State *L)
+{
+	try {
+		box_set_iproto_wait_vclock_timeout();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_set_prepared_stmt_cache_size(struct lua_State *L)
 {
@@ -293,8 +518,7 @@ static int
 lbox_cfg_set_worker_pool_threads(struct lua_State *L)
 {
 	(void) L;
-	eio_set_min_parallel(cfg_geti("worker_pool_threads"));
-	eio_set_max_parallel(cfg_geti("worker_pool_threads"));
+	coio_set_worker_threads(cfg_geti("worker_pool_threads"));
 	return 0;
 }
 
@@ -322,6 +546,14 @@ lbox_cfg_set_election_fencing_mode(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_election_lease_max_drift(struct lua_State *L)
+{
+	if (box_set_election_lease_max_drift() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_timeout(struct lua_State *L)
 {
@@ -382,6 +614,14 @@ lbox_cfg_set_replication_synchro_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_synchro_confirm_delay(struct lua_State *L)
+{
+	if (box_set_replication_synchro_confirm_delay() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_sync_timeout(struct lua_State *L)
 {
@@ -448,6 +688,22 @@ lbox_cfg_set_replication_skip_conflict(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_apply_workers(struct lua_State *L)
+{
+	if (box_set_replication_apply_workers() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_compression(struct lua_State *L)
+{
+	if (box_set_replication_compression() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_feedback(struct lua_State *L)
 {
@@ -504,7 +760,10 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_checkpoint_count", lbox_cfg_set_checkpoint_count},
 		{"cfg_set_checkpoint_interval", lbox_cfg_set_checkpoint_interval},
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
+		{"cfg_set_checkpoint_recovery_time",
+		 lbox_cfg_set_checkpoint_recovery_time},
 		{"cfg_set_wal_queue_max_size", lbox_cfg_set_wal_queue_max_size},
+		{"cfg_set_wal_ring_size", lbox_cfg_set_wal_ring_size},
 		{"cfg_set_wal_cleanup_delay", lbox_cfg_set_wal_cleanup_delay},
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
 		{"cfg_set_memtx_memory", lbox_cfg_set_memtx_memory},
@@ -512,24 +771,63 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_vinyl_memory", lbox_cfg_set_vinyl_memory},
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
+		{"cfg_set_vinyl_page_cache", lbox_cfg_set_vinyl_page_cache},
+		{"cfg_set_vinyl_os_cache", lbox_cfg_set_vinyl_os_cache},
+		{"cfg_set_vinyl_read_ahead", lbox_cfg_set_vinyl_read_ahead},
+		{"cfg_set_vinyl_read_latency_budget",
+		 lbox_cfg_set_vinyl_read_latency_budget},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
 		{"cfg_set_force_recovery", lbox_cfg_set_force_recovery},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
 		{"cfg_set_election_timeout", lbox_cfg_set_election_timeout},
 		{"cfg_set_election_fencing_mode", lbox_cfg_set_election_fencing_mode},
+		{"cfg_set_election_lease_max_drift",
+		 lbox_cfg_set_election_lease_max_drift},
 		{"cfg_set_replication_timeout", lbox_cfg_set_replication_timeout},
 		{"cfg_set_replication_connect_quorum", lbox_cfg_set_replication_connect_quorum},
 		{"cfg_set_replication_connect_timeout", lbox_cfg_set_replication_connect_timeout},
 		{"cfg_set_replication_sync_lag", lbox_cfg_set_replication_sync_lag},
 		{"cfg_set_replication_synchro_quorum", lbox_cfg_set_replication_synchro_quorum},
 		{"cfg_set_replication_synchro_timeout", lbox_cfg_set_replication_synchro_timeout},
+		{"cfg_set_replication_synchro_confirm_delay",
+		 lbox_cfg_set_replication_synchro_confirm_delay},
 		{"cfg_set_replication_sync_timeout", lbox_cfg_set_replication_sync_timeout},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
+		{"cfg_set_replication_apply_workers",
+		 lbox_cfg_set_replication_apply_workers},
+		{"cfg_set_replication_compression",
+		 lbox_cfg_set_replication_compression},
 		{"cfg_set_replication_anon", lbox_cfg_set_replication_anon},
 		{"cfg_set_replicaset_name", lbox_cfg_set_replicaset_name},
 		{"cfg_set_instance_name", lbox_cfg_set_instance_name},
 		{"cfg_set_cluster_name", lbox_cfg_set_cluster_name},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
+		{"cfg_set_iproto_read_view_interval",
+		 lbox_cfg_set_iproto_read_view_interval},
+		{"cfg_set_iproto_compression_threshold",
+		 lbox_cfg_set_iproto_compression_threshold},
+		{"cfg_set_iproto_busy_poll", lbox_cfg_set_iproto_busy_poll},
+		{"cfg_set_iproto_slow_request_threshold",
+		 lbox_cfg_set_iproto_slow_request_threshold},
+		{"cfg_set_iproto_wait_vclock_timeout",
+		 lbox_cfg_set_iproto_wait_vclock_timeout},
+		{"cfg_set_tx_cpu_affinity", lbox_cfg_set_tx_cpu_affinity},
+		{"cfg_set_wal_cpu_affinity", lbox_cfg_set_wal_cpu_affinity},
+		{"cfg_set_iproto_cpu_affinity",
+		 lbox_cfg_set_iproto_cpu_affinity},
+		{"cfg_set_memtx_numa_node", lbox_cfg_set_memtx_numa_node},
+		{"cfg_set_memtx_use_huge_pages",
+		 lbox_cfg_set_memtx_use_huge_pages},
+		{"cfg_set_memtx_checkpoint_delta_count",
+		 lbox_cfg_set_memtx_checkpoint_delta_count},
+		{"cfg_set_memtx_snapshot_compress_threads",
+		 lbox_cfg_set_memtx_snapshot_compress_threads},
+		{"cfg_set_memtx_snapshot_compression_level",
+		 lbox_cfg_set_memtx_snapshot_compression_level},
+		{"cfg_set_memtx_ddl_rate_limit",
+		 lbox_cfg_set_memtx_ddl_rate_limit},
+		{"cfg_set_memtx_snapshot_index_order",
+		 lbox_cfg_set_memtx_snapshot_index_order},
 		{"cfg_set_sql_cache_size", lbox_set_prepared_stmt_cache_size},
 		{"cfg_set_feedback", lbox_cfg_set_feedback},
 		{"cfg_set_txn_timeout", lbox_cfg_set_txn_timeout},
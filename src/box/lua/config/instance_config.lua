@@ -711,6 +711,11 @@ return schema.new('instance_config', schema.record({
             mk_parent_dir = true,
             default = 'var/run/{{ instance_name }}/tarantool.pid',
         }),
+        cpu_affinity = schema.scalar({
+            type = 'string',
+            box_cfg = 'tx_cpu_affinity',
+            default = box.NULL,
+        }),
     }),
     console = schema.record({
         enabled = schema.scalar({
@@ -831,6 +836,19 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'log_format',
             default = 'plain',
         }),
+        async = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'log_async',
+            box_cfg_nondynamic = true,
+            default = false,
+        }),
+        async_overflow = schema.enum({
+            'block',
+            'drop',
+        }, {
+            box_cfg = 'log_async_overflow',
+            default = 'block',
+        }),
         -- box.cfg({log_modules = <...>}) replaces the previous
         -- value without any merging.
         --
@@ -1075,11 +1093,47 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 1,
         }),
+        reuseport = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'iproto_reuseport',
+            box_cfg_nondynamic = true,
+            default = false,
+        }),
+        cpu_affinity = schema.scalar({
+            type = 'string',
+            box_cfg = 'iproto_cpu_affinity',
+            default = box.NULL,
+        }),
         net_msg_max = schema.scalar({
             type = 'integer',
             box_cfg = 'net_msg_max',
             default = 768,
         }),
+        read_view_interval = schema.scalar({
+            type = 'number',
+            box_cfg = 'iproto_read_view_interval',
+            default = 0,
+        }),
+        compression_threshold = schema.scalar({
+            type = 'integer',
+            box_cfg = 'iproto_compression_threshold',
+            default = 16384,
+        }),
+        busy_poll = schema.scalar({
+            type = 'number',
+            box_cfg = 'iproto_busy_poll',
+            default = 0,
+        }),
+        slow_request_threshold = schema.scalar({
+            type = 'number',
+            box_cfg = 'iproto_slow_request_threshold',
+            default = 0,
+        }),
+        wait_vclock_timeout = schema.scalar({
+            type = 'number',
+            box_cfg = 'iproto_wait_vclock_timeout',
+            default = 1,
+        }),
         readahead = schema.scalar({
             type = 'integer',
             box_cfg = 'readahead',
@@ -1191,6 +1245,47 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = box.NULL,
         }),
+        numa_node = schema.scalar({
+            type = 'integer',
+            box_cfg = 'memtx_numa_node',
+            default = box.NULL,
+        }),
+        use_huge_pages = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'memtx_use_huge_pages',
+            default = false,
+        }),
+        checkpoint_delta_count = schema.scalar({
+            type = 'integer',
+            box_cfg = 'memtx_checkpoint_delta_count',
+            default = 0,
+        }),
+        snapshot_compress_threads = schema.scalar({
+            type = 'integer',
+            box_cfg = 'memtx_snapshot_compress_threads',
+            default = 1,
+        }),
+        snapshot_compression_level = schema.scalar({
+            type = 'integer',
+            box_cfg = 'memtx_snapshot_compression_level',
+            default = 3,
+        }),
+        ddl_rate_limit = schema.scalar({
+            type = 'number',
+            box_cfg = 'memtx_ddl_rate_limit',
+            default = 0,
+        }),
+        snapshot_index_order = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'memtx_snapshot_index_order',
+            default = false,
+        }),
+        background_index_build = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'memtx_background_index_build',
+            box_cfg_nondynamic = true,
+            default = false,
+        }),
     }),
     vinyl = schema.record({
         bloom_fpr = schema.scalar({
@@ -1226,6 +1321,16 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'vinyl_memory',
             default = 128 * 1024 * 1024,
         }),
+        os_cache = schema.scalar({
+            type = 'boolean',
+            box_cfg = 'vinyl_os_cache',
+            default = true,
+        }),
+        page_cache = schema.scalar({
+            type = 'integer',
+            box_cfg = 'vinyl_page_cache',
+            default = 0,
+        }),
         page_size = schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_page_size',
@@ -1238,6 +1343,16 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = box.NULL,
         }),
+        read_ahead = schema.scalar({
+            type = 'integer',
+            box_cfg = 'vinyl_read_ahead',
+            default = 0,
+        }),
+        read_latency_budget = schema.scalar({
+            type = 'number',
+            box_cfg = 'vinyl_read_latency_budget',
+            default = 0,
+        }),
         read_threads = schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_read_threads',
@@ -1301,11 +1416,21 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'wal_queue_max_size',
             default = 16 * 1024 * 1024,
         }),
+        ring_size = schema.scalar({
+            type = 'integer',
+            box_cfg = 'wal_ring_size',
+            default = 0,
+        }),
         cleanup_delay = schema.scalar({
             type = 'number',
             box_cfg = 'wal_cleanup_delay',
             default = 4 * 3600,
         }),
+        cpu_affinity = schema.scalar({
+            type = 'string',
+            box_cfg = 'wal_cpu_affinity',
+            default = box.NULL,
+        }),
         retention_period = enterprise_edition(schema.scalar({
             type = 'number',
             box_cfg = 'wal_retention_period',
@@ -1314,7 +1439,7 @@ return schema.new('instance_config', schema.record({
         -- box.cfg({wal_ext = <...>}) replaces the previous
         -- value without any merging. See explanation why it is
         -- important in the log.modules description.
-        ext = enterprise_edition(schema.record({
+        ext = schema.record({
             old = schema.scalar({
                 type = 'boolean',
                 -- TODO: This default is applied despite the outer
@@ -1352,7 +1477,7 @@ return schema.new('instance_config', schema.record({
             -- support of non-scalar schema nodes in
             -- <schema object>:map().
             default = box.NULL,
-        })),
+        }),
     }),
     snapshot = schema.record({
         dir = schema.scalar({
@@ -1373,6 +1498,11 @@ return schema.new('instance_config', schema.record({
                 box_cfg = 'checkpoint_wal_threshold',
                 default = 1e18,
             }),
+            recovery_time = schema.scalar({
+                type = 'number',
+                box_cfg = 'checkpoint_recovery_time',
+                default = 0,
+            }),
         }),
         count = schema.scalar({
             type = 'integer',
@@ -1465,6 +1595,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'replication_synchro_timeout',
             default = 5,
         }),
+        synchro_confirm_delay = schema.scalar({
+            type = 'number',
+            box_cfg = 'replication_synchro_confirm_delay',
+            default = 0,
+        }),
         connect_timeout = schema.scalar({
             type = 'number',
             box_cfg = 'replication_connect_timeout',
@@ -1491,6 +1626,16 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'replication_skip_conflict',
             default = false,
         }),
+        apply_workers = schema.scalar({
+            type = 'integer',
+            box_cfg = 'replication_apply_workers',
+            default = 1,
+        }),
+        compression = schema.scalar({
+            type = 'integer',
+            box_cfg = 'replication_compression',
+            default = 0,
+        }),
         election_mode = schema.enum({
             'off',
             'voter',
@@ -1515,6 +1660,12 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'election_fencing_mode',
             default = 'soft',
         }),
+        election_lease_max_drift = schema.scalar({
+            type = 'number',
+            box_cfg = 'election_lease_max_drift',
+            -- Leader leases are disabled by default.
+            default = box.NULL,
+        }),
         bootstrap_strategy = schema.enum({
             'auto',
             'config',
@@ -1733,52 +1884,52 @@ return schema.new('instance_config', schema.record({
         }),
     }),
     flightrec = schema.record({
-        enabled = enterprise_edition(schema.scalar({
+        enabled = schema.scalar({
             type = 'boolean',
             box_cfg = 'flightrec_enabled',
             default = false,
-        })),
-        logs_size = enterprise_edition(schema.scalar({
+        }),
+        logs_size = schema.scalar({
             type = 'integer',
             box_cfg = 'flightrec_logs_size',
             default = 10485760,
-        })),
-        logs_max_msg_size = enterprise_edition(schema.scalar({
+        }),
+        logs_max_msg_size = schema.scalar({
             type = 'integer',
             box_cfg = 'flightrec_logs_max_msg_size',
             default = 4096,
-        })),
-        logs_log_level = enterprise_edition(schema.scalar({
+        }),
+        logs_log_level = schema.scalar({
             type = 'integer',
             box_cfg = 'flightrec_logs_log_level',
             default = 6,
             allowed_values = {0, 1, 2, 3, 4, 5, 6, 7},
-        })),
-        metrics_interval = enterprise_edition(schema.scalar({
+        }),
+        metrics_interval = schema.scalar({
             type = 'number',
             box_cfg = 'flightrec_metrics_interval',
             default = 1.0,
-        })),
-        metrics_period = enterprise_edition(schema.scalar({
+        }),
+        metrics_period = schema.scalar({
             type = 'number',
             box_cfg = 'flightrec_metrics_period',
             default = 60 * 3,
-        })),
-        requests_size = enterprise_edition(schema.scalar({
+        }),
+        requests_size = schema.scalar({
             type = 'integer',
             box_cfg = 'flightrec_requests_size',
             default = 10485760,
-        })),
-        requests_max_req_size = enterprise_edition(schema.scalar({
+        }),
+        requests_max_req_size = schema.scalar({
             type = 'integer',
             box_cfg = 'flightrec_requests_max_req_size',
             default = 16384,
-        })),
-        requests_max_res_size = enterprise_edition(schema.scalar({
+        }),
+        requests_max_res_size = schema.scalar({
             type = 'integer',
             box_cfg = 'flightrec_requests_max_res_size',
             default = 16384,
-        })),
+        }),
     }),
     security = schema.record({
         auth_type = schema.enum({
@@ -6,6 +6,8 @@ local netbox = require('net.box')
 
 local WATCHER_DELAY = 0.1
 local WATCHER_TIMEOUT = 10
+-- Weight of the last sample in the moving average of call latency.
+local LATENCY_EWMA_ALPHA = 0.2
 
 local connections = {}
 
@@ -49,6 +51,9 @@ local function connect(instance_name, opts)
         end
         conn = res
         connections[instance_name] = conn
+        -- Load statistics used by the 'least_loaded' balancing.
+        conn._in_flight = 0
+        conn._latency = nil
         local function mode(conn)
             if conn.state == 'active' then
                 return conn._mode
@@ -237,6 +242,41 @@ local function filter(opts)
     return dynamic_candidates
 end
 
+-- Returns true if the instance seems to be less loaded than another one
+-- judging by calls made through the pool: the expected time to serve
+-- a call is the number of calls in progress multiplied by the moving
+-- average of call latency. Instances without statistics are preferred
+-- so that they get one.
+local function is_less_loaded(instance_name, other_instance_name)
+    local conn = connections[instance_name]
+    local other_conn = connections[other_instance_name]
+    local latency = conn._latency or 0
+    local other_latency = other_conn._latency or 0
+    local load = (conn._in_flight + 1) * latency
+    local other_load = (other_conn._in_flight + 1) * other_latency
+    if load ~= other_load then
+        return load < other_load
+    end
+    return conn._in_flight < other_conn._in_flight
+end
+
+-- Picks a candidate using the power of two choices: selects two random
+-- candidates and returns the index of the less loaded one.
+local function pick_least_loaded(candidates)
+    local n = math.random(#candidates)
+    if #candidates == 1 then
+        return n
+    end
+    local m = math.random(#candidates - 1)
+    if m >= n then
+        m = m + 1
+    end
+    for _, i in ipairs({n, m}) do
+        connect(candidates[i], {wait_connected = false})
+    end
+    return is_less_loaded(candidates[m], candidates[n]) and m or n
+end
+
 local function get_connection(opts)
     local mode = nil
     if opts.mode == 'ro' or opts.mode == 'rw' then
@@ -300,7 +340,12 @@ local function get_connection(opts)
             end
         end
         while #preferred_candidates > 0 do
-            local n = math.random(#preferred_candidates)
+            local n
+            if opts.balance == 'least_loaded' then
+                n = pick_least_loaded(preferred_candidates)
+            else
+                n = math.random(#preferred_candidates)
+            end
             local instance_name = table.remove(preferred_candidates, n)
             local conn = connect(instance_name, {wait_connected = false})
             if conn:wait_connected() then
@@ -314,6 +359,21 @@ local function get_connection(opts)
     return nil, "connection to candidates failed"
 end
 
+local function call_end(conn, start, ok, ...)
+    conn._in_flight = conn._in_flight - 1
+    local latency = clock.monotonic() - start
+    if conn._latency == nil then
+        conn._latency = latency
+    else
+        conn._latency = conn._latency +
+                        LATENCY_EWMA_ALPHA * (latency - conn._latency)
+    end
+    if not ok then
+        error((...), 0)
+    end
+    return ...
+end
+
 local function call(func_name, args, opts)
     checks('string', '?table', {
         groups = '?table',
@@ -323,6 +383,7 @@ local function call(func_name, args, opts)
         roles = '?table',
         prefer_local = '?boolean',
         mode = '?string',
+        balance = '?string',
         -- The following options passed directly to net.box.call().
         timeout = '?',
         buffer = '?',
@@ -337,6 +398,11 @@ local function call(func_name, args, opts)
                     'got "%s"'
         error(msg:format(opts.mode), 0)
     end
+    if opts.balance ~= nil and opts.balance ~= 'random' and
+       opts.balance ~= 'least_loaded' then
+        local msg = 'Expected nil, "random" or "least_loaded", got "%s"'
+        error(msg:format(opts.balance), 0)
+    end
 
     local conn_opts = {
         groups = opts.groups,
@@ -346,6 +412,7 @@ local function call(func_name, args, opts)
         roles = opts.roles,
         prefer_local = opts.prefer_local,
         mode = opts.mode,
+        balance = opts.balance,
     }
     local conn, err = get_connection(conn_opts)
     if conn == nil then
@@ -360,11 +427,101 @@ local function call(func_name, args, opts)
         on_push_ctx = opts.on_push_ctx,
         is_async = opts.is_async,
     }
-    return conn:call(func_name, args, net_box_call_opts)
+    -- The completion of an asynchronous call isn't tracked, so it isn't
+    -- accounted in the load statistics.
+    if opts.is_async then
+        return conn:call(func_name, args, net_box_call_opts)
+    end
+    conn._in_flight = conn._in_flight + 1
+    return call_end(conn, clock.monotonic(),
+                    pcall(conn.call, conn, func_name, args, net_box_call_opts))
+end
+
+-- Calls the function on the instance and puts the outcome to the channel.
+local function map_call_f(ch, instance_name, func_name, args, deadline)
+    local function timeout()
+        if deadline == nil then
+            return nil
+        end
+        return math.max(deadline - clock.monotonic(), 0)
+    end
+    local ok, res = pcall(function()
+        local conn = connect(instance_name, {wait_connected = false})
+        if not conn:wait_connected(timeout()) then
+            error(conn.error or 'Connection timed out', 0)
+        end
+        return conn:call(func_name, args, {timeout = timeout()})
+    end)
+    ch:put({instance_name, ok, res})
+end
+
+local function map_call(func_name, args, opts)
+    checks('string', '?table', {
+        groups = '?table',
+        replicasets = '?table',
+        instances = '?table',
+        labels = '?table',
+        roles = '?table',
+        mode = '?string',
+        timeout = '?number',
+        reduce = '?function',
+        initial = '?',
+        partial = '?boolean',
+    })
+    opts = opts or {}
+    local candidates = filter({
+        groups = opts.groups,
+        replicasets = opts.replicasets,
+        instances = opts.instances,
+        labels = opts.labels,
+        roles = opts.roles,
+        mode = opts.mode,
+    })
+    if next(candidates) == nil then
+        local msg = "Couldn't execute function %s: no candidates are " ..
+                    "available with these conditions"
+        error(msg:format(func_name), 0)
+    end
+
+    -- Issue all the calls at once and process the results in the order
+    -- of arrival. The channel is big enough to never block senders, so
+    -- the calls left unprocessed on error are simply dropped.
+    local deadline = opts.timeout and clock.monotonic() + opts.timeout
+    local ch = fiber.channel(#candidates)
+    for _, instance_name in ipairs(candidates) do
+        local f = fiber.new(map_call_f, ch, instance_name, func_name, args,
+                            deadline)
+        f:name('connpool.map_call', {truncate = true})
+    end
+
+    local acc = opts.initial
+    if opts.reduce == nil then
+        acc = {}
+    end
+    local errors = nil
+    for _ = 1, #candidates do
+        local instance_name, ok, res = unpack(ch:get())
+        if ok then
+            if opts.reduce ~= nil then
+                acc = opts.reduce(acc, res, instance_name)
+            else
+                acc[instance_name] = res
+            end
+        elseif opts.partial then
+            errors = errors or {}
+            errors[instance_name] = res
+        else
+            local msg = "Couldn't execute function %s on instance %q: %s"
+            error(msg:format(func_name, instance_name,
+                             type(res) == 'cdata' and res.message or res), 0)
+        end
+    end
+    return acc, errors
 end
 
 return {
     connect = connect,
     filter = filter,
     call = call,
+    map_call = map_call,
 }
@@ -0,0 +1,259 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/cpu_profiler.h"
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <stdlib.h>
+
+#include "box/func.h"
+#include "box/func_cache.h"
+#include "box/iproto_constants.h"
+#include "cpu_profiler.h"
+#include "diag.h"
+#include "lua/utils.h"
+#include "tt_static.h"
+#include "trivia/util.h"
+
+/** Default sampling interval, in seconds. */
+static const double CPU_PROFILER_INTERVAL_DEFAULT = 0.01;
+
+/**
+ * cpu_profiler.start([{interval = <seconds>}]) starts sampling the TX
+ * thread every interval seconds of its CPU time.
+ */
+static int
+lbox_cpu_profiler_start(struct lua_State *L)
+{
+	double interval = CPU_PROFILER_INTERVAL_DEFAULT;
+	if (!lua_isnoneornil(L, 1)) {
+		luaL_checktype(L, 1, LUA_TTABLE);
+		lua_getfield(L, 1, "interval");
+		if (!lua_isnil(L, -1)) {
+			if (lua_type(L, -1) != LUA_TNUMBER ||
+			    lua_tonumber(L, -1) <= 0) {
+				diag_set(IllegalParams, "interval must be "
+					 "a positive number");
+				return luaT_error(L);
+			}
+			interval = lua_tonumber(L, -1);
+		}
+		lua_pop(L, 1);
+	}
+	if (cpu_profiler_start(interval) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cpu_profiler_stop(struct lua_State *L)
+{
+	(void)L;
+	cpu_profiler_stop();
+	return 0;
+}
+
+static int
+lbox_cpu_profiler_reset(struct lua_State *L)
+{
+	(void)L;
+	cpu_profiler_reset();
+	return 0;
+}
+
+/** cpu_profiler.info() returns the profiler state and counters. */
+static int
+lbox_cpu_profiler_info(struct lua_State *L)
+{
+	struct cpu_profiler_stat stat;
+	cpu_profiler_stat(&stat);
+	lua_createtable(L, 0, 5);
+	lua_pushboolean(L, stat.is_running);
+	lua_setfield(L, -2, "running");
+	lua_pushnumber(L, stat.interval);
+	lua_setfield(L, -2, "interval");
+	lua_pushnumber(L, stat.sample_count);
+	lua_setfield(L, -2, "samples");
+	lua_pushnumber(L, stat.drop_count);
+	lua_setfield(L, -2, "dropped");
+	lua_pushnumber(L, stat.stack_count);
+	lua_setfield(L, -2, "stacks");
+	return 1;
+}
+
+/** Sort stacks by the number of samples, the most frequent first. */
+static int
+cpu_profiler_stack_cmp(const void *a, const void *b)
+{
+	const struct cpu_profiler_stack *sa = a;
+	const struct cpu_profiler_stack *sb = b;
+	return sa->count < sb->count ? 1 : sa->count > sb->count ? -1 : 0;
+}
+
+/**
+ * Take a snapshot of the sampled stacks sorted by the number of samples.
+ * The caller is supposed to free the returned array.
+ */
+static struct cpu_profiler_stack *
+lbox_cpu_profiler_snapshot(size_t *count)
+{
+	struct cpu_profiler_stack *stacks = cpu_profiler_snapshot(count);
+	if (stacks != NULL)
+		qsort(stacks, *count, sizeof(*stacks), cpu_profiler_stack_cmp);
+	return stacks;
+}
+
+/**
+ * Returns the name of the stored function with the given id or NULL if
+ * the function doesn't exist anymore.
+ */
+static const char *
+cpu_profiler_func_name(uint32_t func_id)
+{
+	if (func_id == 0)
+		return NULL;
+	struct func *func = func_by_id(func_id);
+	return func != NULL ? func->def->name : "<dropped>";
+}
+
+/**
+ * Returns the name of the iproto request type or NULL if the fiber
+ * wasn't handling a request.
+ */
+static const char *
+cpu_profiler_request_name(uint32_t type)
+{
+	return type != 0 ? iproto_type_name(type) : NULL;
+}
+
+#if defined(ENABLE_BACKTRACE)
+/**
+ * Resolve a frame to a "function+offset" string. Returns a pointer to
+ * a static buffer.
+ */
+static const char *
+cpu_profiler_frame_name(const struct backtrace_frame *frame)
+{
+	uintptr_t offset = 0;
+	const char *name = backtrace_frame_resolve(frame, &offset);
+	if (name == NULL)
+		return tt_sprintf("%p", frame->ip);
+	return tt_sprintf("%s+%" PRIuPTR, name, offset);
+}
+#endif /* defined(ENABLE_BACKTRACE) */
+
+/**
+ * cpu_profiler.report() returns an array of sampled stacks sorted by the
+ * number of samples: {count = <number>, fiber = <fiber name>,
+ * request = <iproto request type or nil>, func = <function name or nil>,
+ * frames = {<innermost frame>, ..., <outermost frame>}}.
+ */
+static int
+lbox_cpu_profiler_report(struct lua_State *L)
+{
+	size_t count;
+	struct cpu_profiler_stack *stacks = lbox_cpu_profiler_snapshot(&count);
+	lua_createtable(L, count, 0);
+	for (size_t i = 0; i < count; i++) {
+		struct cpu_profiler_stack *stack = &stacks[i];
+		lua_createtable(L, 0, 5);
+		lua_pushnumber(L, stack->count);
+		lua_setfield(L, -2, "count");
+		lua_pushstring(L, stack->fiber_name);
+		lua_setfield(L, -2, "fiber");
+		const char *name = cpu_profiler_request_name(
+			stack->request_type);
+		if (name != NULL) {
+			lua_pushstring(L, name);
+			lua_setfield(L, -2, "request");
+		}
+		name = cpu_profiler_func_name(stack->func_id);
+		if (name != NULL) {
+			lua_pushstring(L, name);
+			lua_setfield(L, -2, "func");
+		}
+		lua_newtable(L);
+#if defined(ENABLE_BACKTRACE)
+		for (int j = 0; j < stack->bt.frame_count; j++) {
+			lua_pushstring(L, cpu_profiler_frame_name(
+				&stack->bt.frames[j]));
+			lua_rawseti(L, -2, j + 1);
+		}
+#endif /* defined(ENABLE_BACKTRACE) */
+		lua_setfield(L, -2, "frames");
+		lua_rawseti(L, -2, i + 1);
+	}
+	free(stacks);
+	return 1;
+}
+
+/**
+ * Append a frame to a stack in the collapsed format. Semicolons separate
+ * frames so they are replaced in names.
+ */
+static void
+cpu_profiler_add_frame(struct luaL_Buffer *b, const char *name, bool first)
+{
+	if (!first)
+		luaL_addchar(b, ';');
+	for (const char *c = name; *c != '\0'; c++)
+		luaL_addchar(b, *c == ';' || *c == '\n' ? '_' : *c);
+}
+
+/**
+ * cpu_profiler.collapsed() returns the sampled stacks in the collapsed
+ * stack format, understood by flamegraph.pl, speedscope and other tools:
+ * one line per stack with frames from the outermost to the innermost
+ * separated by semicolons followed by the number of samples. The first
+ * frames are the fiber name, the iproto request type and the stored
+ * function, if any.
+ */
+static int
+lbox_cpu_profiler_collapsed(struct lua_State *L)
+{
+	size_t count;
+	struct cpu_profiler_stack *stacks = lbox_cpu_profiler_snapshot(&count);
+	struct luaL_Buffer b;
+	luaL_buffinit(L, &b);
+	for (size_t i = 0; i < count; i++) {
+		struct cpu_profiler_stack *stack = &stacks[i];
+		cpu_profiler_add_frame(&b, stack->fiber_name, true);
+		const char *name = cpu_profiler_request_name(
+			stack->request_type);
+		if (name != NULL)
+			cpu_profiler_add_frame(&b, name, false);
+		name = cpu_profiler_func_name(stack->func_id);
+		if (name != NULL)
+			cpu_profiler_add_frame(&b, name, false);
+#if defined(ENABLE_BACKTRACE)
+		for (int j = stack->bt.frame_count - 1; j >= 0; j--) {
+			cpu_profiler_add_frame(&b, cpu_profiler_frame_name(
+				&stack->bt.frames[j]), false);
+		}
+#endif /* defined(ENABLE_BACKTRACE) */
+		luaL_addstring(&b, tt_sprintf(" %llu\n",
+					      (unsigned long long)stack->count));
+	}
+	free(stacks);
+	luaL_pushresult(&b);
+	return 1;
+}
+
+void
+box_lua_cpu_profiler_init(struct lua_State *L)
+{
+	static const struct luaL_Reg cpu_profiler_lib[] = {
+		{"start", lbox_cpu_profiler_start},
+		{"stop", lbox_cpu_profiler_stop},
+		{"reset", lbox_cpu_profiler_reset},
+		{"info", lbox_cpu_profiler_info},
+		{"report", lbox_cpu_profiler_report},
+		{"collapsed", lbox_cpu_profiler_collapsed},
+		{NULL, NULL}
+	};
+	luaT_newmodule(L, "cpu_profiler", cpu_profiler_lib);
+	lua_pop(L, 1);
+}
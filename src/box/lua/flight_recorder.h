@@ -11,14 +11,23 @@
 #include "lua/flightrec_impl.h"
 #else /* !defined(ENABLE_FLIGHT_RECORDER) */
 
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
 #define FLIGHT_RECORDER_BOX_LUA_MODULES
 
 struct lua_State;
 
-static inline void
-box_lua_flightrec_init(struct lua_State *L)
-{
-	(void)L;
-}
+/**
+ * Registers box.internal.cfg_set_flightrec and the flightrec module used
+ * for reading flight recorder files.
+ */
+void
+box_lua_flightrec_init(struct lua_State *L);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
 
 #endif /* !defined(ENABLE_FLIGHT_RECORDER) */
@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/flight_recorder.h"
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <stddef.h>
+
+#include "box/flightrec.h"
+#include "diag.h"
+#include "lua/msgpack.h"
+#include "lua/utils.h"
+#include "msgpuck.h"
+#include "trivia/config.h"
+
+#if defined(ENABLE_FLIGHT_RECORDER)
+# error unimplemented
+#endif
+
+static int
+lbox_cfg_set_flightrec(struct lua_State *L)
+{
+	if (box_set_flightrec() != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+/**
+ * flightrec_read() callback that appends a decoded record to the table of
+ * its section. The section tables are on the top of the Lua stack.
+ */
+static int
+lbox_flightrec_read_record(enum flightrec_section section, const char *data,
+			   size_t size, void *arg)
+{
+	struct lua_State *L = arg;
+	const char *p = data;
+	if (mp_typeof(*data) != MP_MAP || mp_check(&p, data + size) != 0) {
+		diag_set(IllegalParams, "corrupted flight recorder record");
+		return -1;
+	}
+	int idx = lua_gettop(L) - flightrec_section_MAX + 1 + section;
+	luamp_decode(L, luaL_msgpack_default, &data);
+	lua_rawseti(L, idx, lua_objlen(L, idx) + 1);
+	return 0;
+}
+
+/**
+ * flightrec.read(path) reads a flight recorder file and returns its
+ * records as a table: {logs = {...}, requests = {...}, metrics = {...}}.
+ */
+static int
+lbox_flightrec_read(struct lua_State *L)
+{
+	const char *path = luaL_checkstring(L, 1);
+	lua_newtable(L);
+	for (int i = 0; i < flightrec_section_MAX; i++) {
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, -3 - i, flightrec_section_strs[i]);
+	}
+	if (flightrec_read(path, lbox_flightrec_read_record, L) != 0)
+		return luaT_error(L);
+	lua_pop(L, flightrec_section_MAX);
+	return 1;
+}
+
+void
+box_lua_flightrec_init(struct lua_State *L)
+{
+	luaL_findtable(L, LUA_GLOBALSINDEX, "box.internal", 0);
+	lua_pushcfunction(L, lbox_cfg_set_flightrec);
+	lua_setfield(L, -2, "cfg_set_flightrec");
+	lua_pop(L, 1);
+
+	static const struct luaL_Reg flightrec_lib[] = {
+		{"read", lbox_flightrec_read},
+		{NULL, NULL}
+	};
+	luaT_newmodule(L, "flightrec", flightrec_lib);
+	lua_pop(L, 1);
+}
@@ -34,10 +34,21 @@
 #include "info/info.h"
 #include "box/box.h"
 #include "box/index.h"
+#include "box/index_aggregate.h"
+#include "box/iproto_constants.h"
+#include "box/schema_def.h"
+#include "box/space.h"
+#include "box/space_cache.h"
+#include "box/tuple.h"
+#include "box/txn.h"
 #include "box/lua/tuple.h"
 #include "box/lua/misc.h"
+#include "lua/msgpack.h"
+#include "small/ibuf.h"
 #include "small/region.h"
+#include "msgpuck.h"
 #include "fiber.h"
+#include "cord_buf.h"
 
 /** {{{ box.index Lua library: access to spaces and indexes
  */
@@ -86,6 +97,226 @@ lbox_replace(lua_State *L)
 	return rc == 0 ? luaT_pushtupleornil(L, result) : luaT_error(L);
 }
 
+/**
+ * Get MsgPack data passed to space:insert_batch() and similar methods
+ * at the given stack index: a msgpack object, a Lua string or a 'char *'
+ * followed by the data size. Returns NULL on error.
+ */
+static const char *
+lbox_batch_data(struct lua_State *L, int idx, const char *name,
+		const char **data_end)
+{
+	size_t size;
+	const char *data = luamp_get(L, idx, &size);
+	if (data != NULL) {
+		*data_end = data + size;
+		return data;
+	}
+	uint32_t cdata_type;
+	if (lua_type(L, idx) == LUA_TSTRING) {
+		data = lua_tolstring(L, idx, &size);
+	} else if (lua_type(L, idx) == LUA_TCDATA &&
+		   luaL_checkconstchar(L, idx, &data, &cdata_type) == 0 &&
+		   data != NULL && lua_type(L, idx + 1) == LUA_TNUMBER &&
+		   lua_tonumber(L, idx + 1) >= 0) {
+		size = lua_tonumber(L, idx + 1);
+	} else {
+		diag_set(IllegalParams, "Usage: space:%s(msgpack) or "
+			 "space:%s(ptr, size)", name, name);
+		return NULL;
+	}
+	const char *p = data;
+	if (mp_check_exact(&p, data + size) != 0)
+		return NULL;
+	*data_end = data + size;
+	return data;
+}
+
+/**
+ * Roll back a failed batch: the whole transaction if it was started by
+ * the batch, otherwise only the batch statements. Keeps the diag intact.
+ */
+static void
+lbox_process_batch_rollback(bool is_autocommit, box_txn_savepoint_t *svp)
+{
+	struct diag diag;
+	diag_create(&diag);
+	diag_move(diag_get(), &diag);
+	if (is_autocommit)
+		box_txn_rollback();
+	else if (svp != NULL)
+		box_txn_rollback_to_savepoint(svp);
+	diag_move(&diag, diag_get());
+	diag_destroy(&diag);
+}
+
+/**
+ * Execute one statement of a batch given by the MsgPack at @a data:
+ * a tuple for insert and replace, an array of a tuple and update
+ * operations for upsert. Advances @a data past the statement.
+ */
+static int
+lbox_process_batch_stmt(uint32_t space_id, enum iproto_type type,
+			const char **data)
+{
+	const char *stmt = *data;
+	mp_next(data);
+	if (mp_typeof(*stmt) != MP_ARRAY) {
+		diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+		return -1;
+	}
+	switch (type) {
+	case IPROTO_INSERT:
+		return box_insert(space_id, stmt, *data, NULL);
+	case IPROTO_REPLACE:
+		return box_replace(space_id, stmt, *data, NULL);
+	case IPROTO_UPSERT: {
+		if (mp_decode_array(&stmt) != 2 ||
+		    mp_typeof(*stmt) != MP_ARRAY) {
+			diag_set(IllegalParams, "upsert_batch expects "
+				 "{tuple, operations} pairs");
+			return -1;
+		}
+		const char *tuple = stmt;
+		mp_next(&stmt);
+		if (mp_typeof(*stmt) != MP_ARRAY) {
+			diag_set(IllegalParams, "upsert_batch expects "
+				 "{tuple, operations} pairs");
+			return -1;
+		}
+		return box_upsert(space_id, 0, tuple, stmt, stmt, *data, 1,
+				  NULL);
+	}
+	default:
+		unreachable();
+		return -1;
+	}
+}
+
+/**
+ * Insert, replace or upsert all tuples of a MsgPack array. The tuples are
+ * written in one transaction or, if called in a transaction, rolled back to
+ * the statement start on error. Returns the number of written tuples.
+ */
+static int
+lbox_process_batch(struct lua_State *L, enum iproto_type type)
+{
+	const char *name = type == IPROTO_INSERT ? "insert_batch" :
+			   type == IPROTO_REPLACE ? "replace_batch" :
+			   "upsert_batch";
+	if (lua_gettop(L) < 2 || !lua_isnumber(L, 1)) {
+		diag_set(IllegalParams, "Usage: space:%s(msgpack) or "
+			 "space:%s(ptr, size)", name, name);
+		return luaT_error(L);
+	}
+	uint32_t space_id = lua_tonumber(L, 1);
+	const char *data_end;
+	const char *data = lbox_batch_data(L, 2, name, &data_end);
+	if (data == NULL)
+		return luaT_error(L);
+	if (mp_typeof(*data) != MP_ARRAY) {
+		diag_set(IllegalParams, "%s expects a MsgPack array of tuples",
+			 name);
+		return luaT_error(L);
+	}
+	bool is_autocommit = !box_txn();
+	if (is_autocommit && box_txn_begin() != 0)
+		return luaT_error(L);
+	box_txn_savepoint_t *svp = box_txn_savepoint();
+	if (svp == NULL)
+		goto rollback;
+	uint32_t count = mp_decode_array(&data);
+	for (uint32_t i = 0; i < count; i++) {
+		if (lbox_process_batch_stmt(space_id, type, &data) != 0)
+			goto rollback;
+	}
+	assert(data == data_end);
+	if (is_autocommit && box_txn_commit() != 0)
+		return luaT_error(L);
+	luaL_pushuint64(L, count);
+	return 1;
+rollback:
+	lbox_process_batch_rollback(is_autocommit, svp);
+	return luaT_error(L);
+}
+
+static int
+lbox_insert_batch(struct lua_State *L)
+{
+	return lbox_process_batch(L, IPROTO_INSERT);
+}
+
+static int
+lbox_replace_batch(struct lua_State *L)
+{
+	return lbox_process_batch(L, IPROTO_REPLACE);
+}
+
+static int
+lbox_upsert_batch(struct lua_State *L)
+{
+	return lbox_process_batch(L, IPROTO_UPSERT);
+}
+
+/**
+ * Encode the tuples matching the key in an index into a MsgPack array and
+ * return it as a Lua string. No Lua objects are created for the tuples.
+ * The result can be passed as is to space:insert_batch() or
+ * space:replace_batch(), e.g. on another instance.
+ */
+static int
+lbox_index_export(struct lua_State *L)
+{
+	if (lua_gettop(L) != 5 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_isnumber(L, 3) || !lua_isnumber(L, 5)) {
+		diag_set(IllegalParams,
+			 "Usage: index.export(space_id, index_id, "
+			 "iterator, key, limit)");
+		return luaT_error(L);
+	}
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	uint32_t iterator = lua_tonumber(L, 3);
+	uint32_t limit = lua_tonumber(L, 5);
+	size_t key_len;
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *key = lbox_encode_tuple_on_gc(L, 4, &key_len);
+	if (key == NULL)
+		return luaT_error(L);
+	struct iterator *it = box_index_iterator(space_id, index_id, iterator,
+						 key, key + key_len);
+	region_truncate(&fiber()->gc, region_svp);
+	if (it == NULL)
+		return luaT_error(L);
+	/*
+	 * The tuple count isn't known beforehand, so reserve the largest
+	 * array header and fill it in the end.
+	 */
+	struct ibuf *ibuf = cord_ibuf_take();
+	xibuf_alloc(ibuf, mp_sizeof_array(UINT32_MAX));
+	uint32_t count = 0;
+	int rc = 0;
+	while (count < limit) {
+		struct tuple *tuple;
+		rc = box_iterator_next(it, &tuple);
+		if (rc != 0 || tuple == NULL)
+			break;
+		uint32_t bsize;
+		const char *data = tuple_data_range(tuple, &bsize);
+		memcpy(xibuf_alloc(ibuf, bsize), data, bsize);
+		count++;
+	}
+	box_iterator_free(it);
+	if (rc == 0) {
+		char *header = ibuf->rpos;
+		*header = 0xdd;
+		mp_store_u32(header + 1, count);
+		lua_pushlstring(L, ibuf->rpos, ibuf_used(ibuf));
+	}
+	cord_ibuf_put(ibuf);
+	return rc == 0 ? 1 : luaT_error(L);
+}
+
 static int
 lbox_index_update(lua_State *L)
 {
@@ -213,6 +444,45 @@ lbox_index_get(lua_State *L)
 	return rc == 0 ? luaT_pushtupleornil(L, tuple) : luaT_error(L);
 }
 
+static int
+lbox_index_get_many(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2)) {
+		diag_set(IllegalParams,
+			 "Usage: index.get_many(space_id, index_id, keys)");
+		return luaT_error(L);
+	}
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	size_t keys_len;
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *keys = lbox_encode_tuple_on_gc(L, 3, &keys_len);
+	if (keys == NULL)
+		return luaT_error(L);
+
+	const char *data = keys;
+	uint32_t key_count = mp_decode_array(&data);
+	struct tuple **results = xregion_alloc_array(&fiber()->gc,
+						     struct tuple *,
+						     key_count);
+	if (box_index_get_batch(space_id, index_id, keys, keys + keys_len,
+				results) != 0) {
+		region_truncate(&fiber()->gc, region_svp);
+		return luaT_error(L);
+	}
+	lua_createtable(L, key_count, 0);
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (results[i] == NULL)
+			continue;
+		luaT_pushtuple(L, results[i]);
+		lua_rawseti(L, -2, i + 1);
+		tuple_unref(results[i]);
+	}
+	region_truncate(&fiber()->gc, region_svp);
+	return 1;
+}
+
 static int
 lbox_index_min(lua_State *L)
 {
@@ -262,13 +532,15 @@ lbox_index_max(lua_State *L)
 static int
 lbox_index_count(lua_State *L)
 {
-	if (lua_gettop(L) != 4 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
-	    !lua_isnumber(L, 3)) {
+	int argc = lua_gettop(L);
+	if ((argc != 4 && argc != 5) || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) || !lua_isnumber(L, 3)) {
 		diag_set(IllegalParams,
 			 "Usage: index.count(space_id, index_id, "
-			 "iterator, key)");
+			 "iterator, key[, approximate])");
 		return luaT_error(L);
 	}
+	bool approximate = argc == 5 && lua_toboolean(L, 5);
 
 	uint32_t space_id = lua_tonumber(L, 1);
 	uint32_t index_id = lua_tonumber(L, 2);
@@ -279,8 +551,11 @@ lbox_index_count(lua_State *L)
 	if (key == NULL)
 		return luaT_error(L);
 
-	ssize_t count = box_index_count(space_id, index_id, iterator, key,
-					key + key_len);
+	ssize_t count = approximate ?
+		box_index_approximate_count(space_id, index_id, iterator,
+					    key, key + key_len) :
+		box_index_count(space_id, index_id, iterator, key,
+				key + key_len);
 	region_truncate(&fiber()->gc, region_svp);
 	if (count == -1)
 		return luaT_error(L);
@@ -368,6 +643,289 @@ lbox_iterator_next(lua_State *L)
 	return luaT_pushtupleornil(L, tuple);
 }
 
+/**
+ * Advance an iterator by up to the given number of tuples and return
+ * them in a table. The table is shorter if the iterator is exhausted.
+ */
+static int
+lbox_iterator_next_batch(lua_State *L)
+{
+	if (lua_gettop(L) < 3 || lua_type(L, 1) != LUA_TCDATA ||
+	    !lua_isnumber(L, 2)) {
+		diag_set(IllegalParams, "Usage: next_batch(state, count)");
+		return luaT_error(L);
+	}
+
+	assert(CTID_STRUCT_ITERATOR_PTR != 0);
+	uint32_t ctypeid;
+	void *data = luaL_checkcdata(L, 1, &ctypeid);
+	if (ctypeid != CTID_STRUCT_ITERATOR_PTR) {
+		diag_set(IllegalParams, "Usage: next_batch(state, count)");
+		return luaT_error(L);
+	}
+	uint32_t count = lua_tonumber(L, 2);
+	int level = lua_tonumber(L, 3);
+	assert(level > 0);
+
+	struct iterator *itr = *(struct iterator **) data;
+	/* Don't preallocate too much in case the iterator ends soon. */
+	lua_createtable(L, MIN(count, 4096U), 0);
+	for (uint32_t i = 1; i <= count; i++) {
+		struct tuple *tuple;
+		if (box_iterator_next(itr, &tuple) != 0)
+			return luaT_error_at(L, level);
+		if (tuple == NULL)
+			break;
+		luaT_pushtuple(L, tuple);
+		lua_rawseti(L, -2, i);
+	}
+	return 1;
+}
+
+/** Context of lbox_index_aggregate. */
+struct lbox_index_aggregate_ctx {
+	/** Lua state with the result table on top of the stack. */
+	struct lua_State *L;
+	/** Number of rows in the result table. */
+	int row_count;
+};
+
+/**
+ * Push a row of group key parts followed by aggregate values to the
+ * result table.
+ */
+static int
+lbox_index_aggregate_emit(struct index_aggregate *agg, const char *group_key,
+			  void *arg)
+{
+	struct lbox_index_aggregate_ctx *ctx = arg;
+	struct lua_State *L = ctx->L;
+	uint32_t part_count = 0;
+	if (group_key != NULL)
+		part_count = mp_decode_array(&group_key);
+	lua_createtable(L, part_count + agg->def_count, 0);
+	int n = 0;
+	for (uint32_t i = 0; i < part_count; i++) {
+		luamp_decode(L, luaL_msgpack_default, &group_key);
+		lua_rawseti(L, -2, ++n);
+	}
+	for (uint32_t i = 0; i < agg->def_count; i++) {
+		struct aggregate_value *value = &agg->values[i];
+		if (agg->defs[i].func == AGGREGATE_COUNT) {
+			luaL_pushuint64(L, value->count);
+		} else if (value->count == 0) {
+			luaL_pushnull(L);
+		} else if (agg->defs[i].func == AGGREGATE_SUM) {
+			if (value->is_double)
+				lua_pushnumber(L, value->dval);
+			else
+				luaL_pushint64(L, value->ival);
+		} else {
+			const char *data = value->data;
+			luamp_decode(L, luaL_msgpack_default, &data);
+		}
+		lua_rawseti(L, -2, ++n);
+	}
+	lua_rawseti(L, -2, ++ctx->row_count);
+	return 0;
+}
+
+/**
+ * Parse the field of the aggregate at the given stack index: either
+ * a field number or a field name.
+ */
+static int
+lbox_index_aggregate_parse_field(struct lua_State *L, int idx,
+				 struct space *space, uint32_t i,
+				 uint32_t *fieldno)
+{
+	if (lua_type(L, idx) == LUA_TSTRING) {
+		size_t len;
+		const char *name = lua_tolstring(L, idx, &len);
+		if (tuple_fieldno_by_name(space->def->dict, name, len,
+					  field_name_hash(name, len),
+					  fieldno) != 0) {
+			diag_set(ClientError, ER_NO_SUCH_FIELD_NAME, name);
+			return -1;
+		}
+		return 0;
+	}
+	if (lua_type(L, idx) == LUA_TNUMBER) {
+		double n = lua_tonumber(L, idx);
+		if (n >= TUPLE_INDEX_BASE && n < BOX_FIELD_MAX &&
+		    n == (uint32_t)n) {
+			*fieldno = (uint32_t)n - TUPLE_INDEX_BASE;
+			return 0;
+		}
+	}
+	diag_set(IllegalParams, "aggregate %u field must be a positive "
+		 "integer or a field name", i);
+	return -1;
+}
+
+/**
+ * Parse aggregate definitions given in the array part of the table at
+ * the given stack index. Each aggregate is either a function name or
+ * a table {function, field}. The definitions are allocated on the fiber
+ * region.
+ */
+static int
+lbox_index_aggregate_parse(struct lua_State *L, int idx, struct space *space,
+			   struct aggregate_def **defs, uint32_t *def_count)
+{
+	uint32_t count = lua_objlen(L, idx);
+	if (count == 0) {
+		diag_set(IllegalParams, "at least one aggregate expected");
+		return -1;
+	}
+	*defs = xregion_alloc_array(&fiber()->gc, struct aggregate_def, count);
+	*def_count = count;
+	for (uint32_t i = 1; i <= count; i++) {
+		struct aggregate_def *def = &(*defs)[i - 1];
+		def->fieldno = 0;
+		lua_rawgeti(L, idx, i);
+		bool is_table = lua_type(L, -1) == LUA_TTABLE;
+		if (is_table)
+			lua_rawgeti(L, -1, 1);
+		else
+			lua_pushvalue(L, -1);
+		if (lua_type(L, -1) != LUA_TSTRING) {
+			lua_pop(L, 2);
+			diag_set(IllegalParams, "aggregate %u must be a function "
+				 "name or {function, field}", i);
+			return -1;
+		}
+		const char *name = lua_tostring(L, -1);
+		def->func = strindex(aggregate_func_strs, name,
+				     aggregate_func_MAX);
+		if (def->func == aggregate_func_MAX) {
+			diag_set(IllegalParams,
+				 "unknown aggregate function '%s'", name);
+			lua_pop(L, 2);
+			return -1;
+		}
+		lua_pop(L, 1);
+		if (def->func != AGGREGATE_COUNT) {
+			int rc = -1;
+			if (is_table) {
+				lua_rawgeti(L, -1, 2);
+				rc = lbox_index_aggregate_parse_field(
+					L, -1, space, i, &def->fieldno);
+				lua_pop(L, 1);
+			} else {
+				diag_set(IllegalParams, "aggregate function "
+					 "'%s' needs a field", name);
+			}
+			if (rc != 0) {
+				lua_pop(L, 1);
+				return -1;
+			}
+		}
+		lua_pop(L, 1);
+	}
+	return 0;
+}
+
+/**
+ * Parse the group_by option, which is the number of index key parts
+ * to group tuples by.
+ */
+static int
+lbox_index_aggregate_parse_group_by(struct lua_State *L, int idx,
+				    struct index_def *index_def,
+				    uint32_t *group_part_count)
+{
+	*group_part_count = 0;
+	lua_getfield(L, idx, "group_by");
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		return 0;
+	}
+	struct key_def *key_def = index_def->key_def;
+	double n = lua_tonumber(L, -1);
+	bool is_valid = lua_type(L, -1) == LUA_TNUMBER && n >= 0 &&
+			n <= key_def->part_count && n == (uint32_t)n;
+	lua_pop(L, 1);
+	if (!is_valid) {
+		diag_set(IllegalParams, "group_by must be an integer "
+			 "from 0 to %u", key_def->part_count);
+		return -1;
+	}
+	*group_part_count = n;
+	if (*group_part_count == 0)
+		return 0;
+	if (index_def->type != TREE) {
+		diag_set(ClientError, ER_UNSUPPORTED, index_type_strs[
+			 index_def->type], "aggregate with group_by");
+		return -1;
+	}
+	if (key_def->is_multikey || key_def->for_func_index) {
+		diag_set(ClientError, ER_UNSUPPORTED, key_def->is_multikey ?
+			 "Multikey index" : "Functional index",
+			 "aggregate with group_by");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Compute aggregates over tuples matching the key in an index without
+ * creating Lua objects for the tuples. Returns a table of rows: one row
+ * per group if tuples are grouped, otherwise exactly one row. A row
+ * contains the group key parts followed by the aggregate values.
+ */
+static int
+lbox_index_aggregate(struct lua_State *L)
+{
+	if (lua_gettop(L) != 5 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_isnumber(L, 3) || lua_type(L, 5) != LUA_TTABLE) {
+		diag_set(IllegalParams,
+			 "Usage: index.aggregate(space_id, index_id, "
+			 "iterator, key, aggregates)");
+		return luaT_error(L);
+	}
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	uint32_t iterator = lua_tonumber(L, 3);
+	size_t key_len;
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *key = lbox_encode_tuple_on_gc(L, 4, &key_len);
+	if (key == NULL)
+		return luaT_error(L);
+	struct aggregate_def *defs;
+	uint32_t def_count;
+	uint32_t group_part_count;
+	struct iterator *it = box_index_iterator(space_id, index_id, iterator,
+						 key, key + key_len);
+	if (it == NULL)
+		goto error;
+	/* Checked by box_index_iterator(). */
+	struct space *space = space_by_id(space_id);
+	assert(space != NULL);
+	struct index *index = space_index(space, index_id);
+	assert(index != NULL);
+	if (lbox_index_aggregate_parse(L, 5, space, &defs, &def_count) != 0 ||
+	    lbox_index_aggregate_parse_group_by(L, 5, index->def,
+						&group_part_count) != 0)
+		goto error;
+	struct lbox_index_aggregate_ctx ctx = {.L = L, .row_count = 0};
+	lua_newtable(L);
+	struct index_aggregate agg;
+	index_aggregate_create(&agg, defs, def_count, index->def->key_def,
+			       group_part_count, lbox_index_aggregate_emit,
+			       &ctx);
+	int rc = index_aggregate_iterator(&agg, it);
+	index_aggregate_destroy(&agg);
+	box_iterator_free(it);
+	region_truncate(&fiber()->gc, region_svp);
+	return rc == 0 ? 1 : luaT_error(L);
+error:
+	if (it != NULL)
+		box_iterator_free(it);
+	region_truncate(&fiber()->gc, region_svp);
+	return luaT_error(L);
+}
+
 /** Truncate a given space */
 static int
 lbox_truncate(struct lua_State *L)
@@ -438,16 +996,23 @@ box_lua_index_init(struct lua_State *L)
 	static const struct luaL_Reg boxlib_internal[] = {
 		{"insert", lbox_insert},
 		{"replace",  lbox_replace},
+		{"insert_batch", lbox_insert_batch},
+		{"replace_batch", lbox_replace_batch},
+		{"upsert_batch", lbox_upsert_batch},
 		{"update", lbox_index_update},
 		{"upsert",  lbox_upsert},
 		{"delete",  lbox_index_delete},
 		{"random", lbox_index_random},
 		{"get",  lbox_index_get},
+		{"get_many",  lbox_index_get_many},
 		{"min", lbox_index_min},
 		{"max", lbox_index_max},
 		{"count", lbox_index_count},
 		{"iterator", lbox_index_iterator},
 		{"iterator_next", lbox_iterator_next},
+		{"iterator_next_batch", lbox_iterator_next_batch},
+		{"aggregate", lbox_index_aggregate},
+		{"export", lbox_index_export},
 		{"truncate", lbox_truncate},
 		{"stat", lbox_index_stat},
 		{"compact", lbox_index_compact},
@@ -45,6 +45,7 @@
 #include "info/info.h"
 #include "box/gc.h"
 #include "box/engine.h"
+#include "box/memtx_engine.h"
 #include "box/vinyl.h"
 #include "box/sql_stmt_cache.h"
 #include "main.h"
@@ -96,6 +97,43 @@ lbox_push_replication_error_message(struct lua_State *L, struct error *e,
 	lua_settable(L, idx - 2);
 }
 
+/**
+ * Pushes replication stream compression statistics to the table on
+ * top of the stack: the zstd level and the total size of row bodies
+ * before and after compression.
+ */
+static void
+lbox_push_replication_compression(struct lua_State *L, int level,
+				  uint64_t bytes, uint64_t compressed_bytes)
+{
+	lua_pushstring(L, "compression");
+	lua_createtable(L, 0, 3);
+	lua_pushinteger(L, level);
+	lua_setfield(L, -2, "level");
+	luaL_pushuint64(L, bytes);
+	lua_setfield(L, -2, "bytes");
+	luaL_pushuint64(L, compressed_bytes);
+	lua_setfield(L, -2, "compressed_bytes");
+	lua_settable(L, -3);
+}
+
+/**
+ * Push 50th and 99th percentiles of a replication stage latency
+ * to the table on top of the stack.
+ */
+static void
+lbox_push_replication_latency(struct lua_State *L, const char *stage,
+			      double p50, double p99)
+{
+	lua_pushstring(L, stage);
+	lua_createtable(L, 0, 2);
+	lua_pushnumber(L, p50);
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, p99);
+	lua_setfield(L, -2, "p99");
+	lua_settable(L, -3);
+}
+
 static void
 lbox_pushapplier(lua_State *L, struct applier *applier)
 {
@@ -133,6 +171,29 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 		lua_pushlstring(L, name, total);
 		lua_settable(L, -3);
 
+		if (applier->compression_level > 0) {
+			lbox_push_replication_compression(
+				L, applier->compression_level,
+				applier->compression_out_bytes,
+				applier->compression_in_bytes);
+		}
+
+		lua_pushstring(L, "latency");
+		lua_createtable(L, 0, 3);
+		lbox_push_replication_latency(
+			L, "network",
+			latency_get(&applier->network_latency, 50),
+			latency_get(&applier->network_latency, 99));
+		lbox_push_replication_latency(
+			L, "decode",
+			latency_get(&applier->decode_latency, 50),
+			latency_get(&applier->decode_latency, 99));
+		lbox_push_replication_latency(
+			L, "wal",
+			latency_get(&applier->wal_latency, 50),
+			latency_get(&applier->wal_latency, 99));
+		lua_settable(L, -3);
+
 		struct error *e = diag_last_error(&applier->diag);
 		if (e != NULL)
 			lbox_push_replication_error_message(L, e, -1);
@@ -147,6 +208,7 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 
 	switch(relay_get_state(relay)) {
 	case RELAY_FOLLOW:
+	{
 		lua_pushstring(L, "follow");
 		lua_settable(L, -3);
 		lua_pushstring(L, "vclock");
@@ -159,7 +221,23 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 		lua_pushstring(L, "lag");
 		lua_pushnumber(L, relay_txn_lag(relay));
 		lua_settable(L, -3);
+		uint64_t bytes, compressed_bytes;
+		int level = relay_compression(relay, &bytes,
+					      &compressed_bytes);
+		if (level > 0) {
+			lbox_push_replication_compression(L, level, bytes,
+							  compressed_bytes);
+		}
+		const struct relay_latency *latency = relay_get_latency(relay);
+		lua_pushstring(L, "latency");
+		lua_createtable(L, 0, 2);
+		lbox_push_replication_latency(L, "send", latency->send_p50,
+					      latency->send_p99);
+		lbox_push_replication_latency(L, "ack", latency->ack_p50,
+					      latency->ack_p99);
+		lua_settable(L, -3);
 		break;
+	}
 	case RELAY_STOPPED:
 	{
 		lua_pushstring(L, "stopped");
@@ -496,6 +574,59 @@ lbox_info_memory(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_info_memory_detail_call(struct lua_State *L)
+{
+	if (box_check_configured() != 0)
+		return luaT_error(L);
+
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	struct engine *memtx = engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_memory_detail((struct memtx_engine *)memtx, &info);
+	return 1;
+}
+
+/**
+ * box.info.memory_detail() reports memory used by memtx spaces broken
+ * down by space: tuples, indexes and MVCC stories. Like box.info.memory,
+ * it is evaluated only when called, because it traverses all spaces.
+ */
+static int
+lbox_info_memory_detail(struct lua_State *L)
+{
+	lua_newtable(L);
+
+	lua_newtable(L); /* metatable */
+
+	lua_pushstring(L, "__call");
+	lua_pushcfunction(L, lbox_info_memory_detail_call);
+	lua_settable(L, -3);
+
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+/**
+ * box.info.recovery reports memtx spaces with secondary indexes that are
+ * still being built in background after recovery, see
+ * box.cfg.memtx_background_index_build.
+ */
+static int
+lbox_info_recovery(struct lua_State *L)
+{
+	struct engine *memtx = engine_by_name("memtx");
+	if (memtx == NULL) {
+		lua_newtable(L);
+		return 1;
+	}
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	memtx_engine_index_build_info((struct memtx_engine *)memtx, &info);
+	return 1;
+}
+
 static int
 lbox_info_gc_call(struct lua_State *L)
 {
@@ -708,6 +839,21 @@ lbox_info_election(struct lua_State *L)
 		lua_pushnumber(L, raft_leader_idle(raft));
 		lua_setfield(L, -2, "leader_idle");
 	}
+	struct box_raft_failover_stat *stat = &box_raft_failover_stat;
+	if (stat->term != 0) {
+		lua_createtable(L, 0, 5);
+		luaL_pushuint64(L, stat->term);
+		lua_setfield(L, -2, "term");
+		lua_pushnumber(L, stat->election_time);
+		lua_setfield(L, -2, "election_time");
+		lua_pushnumber(L, stat->limbo_wait_time);
+		lua_setfield(L, -2, "limbo_wait_time");
+		lua_pushnumber(L, stat->promote_time);
+		lua_setfield(L, -2, "promote_time");
+		lua_pushnumber(L, stat->total_time);
+		lua_setfield(L, -2, "total_time");
+		lua_setfield(L, -2, "failover");
+	}
 	return 1;
 }
 
@@ -823,6 +969,8 @@ static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"pid", lbox_info_pid},
 	{"cluster", lbox_info_cluster},
 	{"memory", lbox_info_memory},
+	{"memory_detail", lbox_info_memory_detail},
+	{"recovery", lbox_info_recovery},
 	{"gc", lbox_info_gc},
 	{"vinyl", lbox_info_vinyl},
 	{"sql", lbox_info_sql},
@@ -37,6 +37,7 @@
 #include "lib/core/mp_extension_types.h"
 
 #include "lua/utils.h" /* luaT_error() */
+#include "lua/error.h"
 #include "lua/trigger.h"
 #include "lua/msgpack.h"
 #include "lua/builtin_modcache.h"
@@ -75,6 +76,7 @@
 #include "box/lua/iproto.h"
 #include "box/lua/audit.h"
 #include "box/lua/flight_recorder.h"
+#include "box/lua/cpu_profiler.h"
 #include "box/lua/read_view.h"
 #include "box/lua/security.h"
 #include "box/lua/space_upgrade.h"
@@ -86,9 +88,12 @@
 #include "box/lua/integrity.h"
 
 #include "mpstream/mpstream.h"
+#include "fiber_cond.h"
 
 static uint32_t CTID_STRUCT_TXN_SAVEPOINT_PTR = 0;
 
+static const char *commit_future_typename = "box.commit_future";
+
 extern char session_lua[],
 	tuple_lua[],
 	tuple_format_lua[],
@@ -464,40 +469,274 @@ static const char *lua_sources[] = {
 	NULL
 };
 
+/**
+ * Completion status of a transaction committed with
+ * box.commit({wait = 'none'}).
+ */
+struct commit_future {
+	/** Set when the transaction is committed or rolled back. */
+	bool is_ready;
+	/** Rollback reason or NULL if the transaction was committed. */
+	struct error *error;
+	/** Signalled when the future becomes ready. */
+	struct fiber_cond cond;
+	/** Transaction on_commit trigger. */
+	struct trigger on_commit;
+	/** Transaction on_rollback trigger. */
+	struct trigger on_rollback;
+	/**
+	 * Number of references: one is held by the Lua object and one
+	 * by the transaction until it is complete.
+	 */
+	int refs;
+};
+
+static void
+commit_future_unref(struct commit_future *future)
+{
+	assert(future->refs > 0);
+	if (--future->refs > 0)
+		return;
+	if (future->error != NULL)
+		error_unref(future->error);
+	fiber_cond_destroy(&future->cond);
+	free(future);
+}
+
+static void
+commit_future_complete(struct commit_future *future, struct error *error)
+{
+	assert(!future->is_ready);
+	future->is_ready = true;
+	future->error = error;
+	if (error != NULL)
+		error_ref(error);
+	fiber_cond_broadcast(&future->cond);
+	commit_future_unref(future);
+}
+
 static int
-lbox_commit(lua_State *L)
+commit_future_on_commit(struct trigger *trigger, void *event)
+{
+	(void)event;
+	commit_future_complete(trigger->data, NULL);
+	return 0;
+}
+
+static int
+commit_future_on_rollback(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct txn *txn = in_txn();
+	assert(txn != NULL);
+	struct diag *diag = diag_get();
+	if (txn->signature == TXN_SIGNATURE_ABORT) {
+		/* The rollback reason is already set. */
+		commit_future_complete(trigger->data, diag_last_error(diag));
+		return 0;
+	}
+	/*
+	 * The trigger may run in a fiber completing the journal write,
+	 * don't spoil its diagnostics area.
+	 */
+	struct error *saved = diag_last_error(diag);
+	if (saved != NULL)
+		error_ref(saved);
+	diag_set_txn_sign(txn->signature);
+	commit_future_complete(trigger->data, diag_last_error(diag));
+	if (saved != NULL) {
+		diag_set_error(diag, saved);
+		error_unref(saved);
+	} else {
+		diag_clear(diag);
+	}
+	return 0;
+}
+
+/** Create a new commit future and push it onto the Lua stack. */
+static struct commit_future *
+luaT_push_commit_future(struct lua_State *L)
+{
+	struct commit_future *future = xmalloc(sizeof(*future));
+	future->is_ready = false;
+	future->error = NULL;
+	fiber_cond_create(&future->cond);
+	trigger_create(&future->on_commit, commit_future_on_commit,
+		       future, NULL);
+	trigger_create(&future->on_rollback, commit_future_on_rollback,
+		       future, NULL);
+	future->refs = 1;
+	struct commit_future **ptr = lua_newuserdata(L, sizeof(future));
+	*ptr = future;
+	luaL_getmetatable(L, commit_future_typename);
+	lua_setmetatable(L, -2);
+	return future;
+}
+
+static struct commit_future *
+luaT_check_commit_future(struct lua_State *L, int idx)
+{
+	return *(struct commit_future **)luaL_checkudata(
+		L, idx, commit_future_typename);
+}
+
+static int
+lbox_commit_future_gc(struct lua_State *L)
+{
+	commit_future_unref(luaT_check_commit_future(L, 1));
+	return 0;
+}
+
+static int
+lbox_commit_future_tostring(struct lua_State *L)
+{
+	lua_pushstring(L, commit_future_typename);
+	return 1;
+}
+
+/**
+ * Returns true if the transaction is complete (either committed or
+ * rolled back), false otherwise.
+ */
+static int
+lbox_commit_future_is_ready(struct lua_State *L)
+{
+	struct commit_future *future = luaT_check_commit_future(L, 1);
+	lua_pushboolean(L, future->is_ready);
+	return 1;
+}
+
+/** Push the result of a complete future: true or nil, error. */
+static int
+lbox_commit_future_push_result(struct lua_State *L,
+			       struct commit_future *future)
+{
+	assert(future->is_ready);
+	if (future->error != NULL) {
+		diag_set_error(diag_get(), future->error);
+		return luaT_push_nil_and_error(L);
+	}
+	lua_pushboolean(L, true);
+	return 1;
+}
+
+/**
+ * Obtains the result of the commit.
+ *
+ * Returns:
+ *  - true        if the transaction was committed
+ *  - nil, error  if the transaction was rolled back or is not complete
+ */
+static int
+lbox_commit_future_result(struct lua_State *L)
+{
+	struct commit_future *future = luaT_check_commit_future(L, 1);
+	if (!future->is_ready) {
+		diag_set(ClientError, ER_PROC_LUA, "Transaction is not complete");
+		return luaT_push_nil_and_error(L);
+	}
+	return lbox_commit_future_push_result(L, future);
+}
+
+/**
+ * Waits until the transaction is complete and obtains the result.
+ * Takes an optional timeout argument.
+ *
+ * See the comment to future.result() for the return value format.
+ */
+static int
+lbox_commit_future_wait_result(struct lua_State *L)
+{
+	struct commit_future *future = luaT_check_commit_future(L, 1);
+	double timeout = TIMEOUT_INFINITY;
+	if (!lua_isnoneornil(L, 2)) {
+		if (lua_type(L, 2) != LUA_TNUMBER ||
+		    (timeout = lua_tonumber(L, 2)) < 0)
+			luaL_error(L, "Usage: future:wait_result(timeout)");
+	}
+	double deadline = fiber_clock() + timeout;
+	while (!future->is_ready) {
+		double delay = deadline - fiber_clock();
+		if (delay <= 0 ||
+		    fiber_cond_wait_timeout(&future->cond, delay) != 0) {
+			luaL_testcancel(L);
+			if (future->is_ready)
+				break;
+			diag_set(TimedOut);
+			return luaT_push_nil_and_error(L);
+		}
+	}
+	return lbox_commit_future_push_result(L, future);
+}
+
+/**
+ * Commit the current transaction without waiting for the journal
+ * write and push a future tracking its completion.
+ */
+static int
+lbox_commit_submit(struct lua_State *L)
 {
-	int top = lua_gettop(L);
-	if (top >= 1) {
-		/* box.commit(nil) */
-		if (lua_isnil(L, 1))
-			goto box_commit;
+	struct txn *txn = in_txn();
+	struct commit_future *future = luaT_push_commit_future(L);
+	if (txn == NULL) {
+		/* The same as BEGIN + COMMIT. */
+		future->is_ready = true;
+		return 1;
+	}
+	future->refs++;
+	if (txn_commit_submit(txn, &future->on_commit,
+			      &future->on_rollback) != 0) {
+		/* The triggers are not run if the txn is left intact. */
+		if (!future->is_ready)
+			commit_future_unref(future);
+		return luaT_error(L);
+	}
+	return 1;
+}
 
+static int
+lbox_commit(lua_State *L)
+{
+	bool is_sync = false;
+	bool is_async = false;
+	if (!lua_isnoneornil(L, 1)) {
 		if (lua_type(L, 1) != LUA_TTABLE) {
 			diag_set(IllegalParams, "options should be a table");
 			return luaT_error(L);
 		}
-		/* Get is_sync */
 		lua_getfield(L, 1, "is_sync");
-		/* box.commit({is_sync = nil}) */
-		if (lua_isnil(L, -1))
-			goto box_commit;
-
-		if (!lua_isboolean(L, -1)) {
-			diag_set(IllegalParams, "is_sync must be a boolean");
-			return luaT_error(L);
+		if (!lua_isnil(L, -1)) {
+			if (!lua_isboolean(L, -1)) {
+				diag_set(IllegalParams,
+					 "is_sync must be a boolean");
+				return luaT_error(L);
+			}
+			if (!lua_toboolean(L, -1)) {
+				diag_set(IllegalParams,
+					 "is_sync can only be true");
+				return luaT_error(L);
+			}
+			is_sync = true;
 		}
-		bool is_sync = lua_toboolean(L, lua_gettop(L));
 		lua_pop(L, 1);
-
-		if (!is_sync) {
-			diag_set(IllegalParams, "is_sync can only be true");
-			return luaT_error(L);
+		lua_getfield(L, 1, "wait");
+		if (!lua_isnil(L, -1)) {
+			const char *wait = lua_type(L, -1) == LUA_TSTRING ?
+					   lua_tostring(L, -1) : "";
+			if (strcmp(wait, "none") == 0) {
+				is_async = true;
+			} else if (strcmp(wait, "complete") != 0) {
+				diag_set(IllegalParams, "wait must be "
+					 "'complete' or 'none'");
+				return luaT_error(L);
+			}
 		}
-		box_txn_make_sync();
+		lua_pop(L, 1);
 	}
-
-box_commit:
+	if (is_sync)
+		box_txn_make_sync();
+	if (is_async)
+		return lbox_commit_submit(L);
 	if (box_txn_commit() != 0)
 		return luaT_error(L);
 	return 0;
@@ -891,6 +1130,16 @@ box_lua_init(struct lua_State *L)
 	luaT_newmodule(L, "box", boxlib);
 	lua_setfield(L, LUA_GLOBALSINDEX, "box");
 
+	static const struct luaL_Reg commit_future_meta[] = {
+		{"__gc", lbox_commit_future_gc},
+		{"__tostring", lbox_commit_future_tostring},
+		{"is_ready", lbox_commit_future_is_ready},
+		{"result", lbox_commit_future_result},
+		{"wait_result", lbox_commit_future_wait_result},
+		{NULL, NULL}
+	};
+	luaL_register_type(L, commit_future_typename, commit_future_meta);
+
 	/* box.backup = {<...>} */
 	luaL_findtable(L, LUA_GLOBALSINDEX, "box.backup", 0);
 	luaL_setfuncs(L, boxlib_backup, 0);
@@ -922,6 +1171,7 @@ box_lua_init(struct lua_State *L)
 	box_lua_read_view_init(L);
 	box_lua_security_init(L);
 	box_lua_flightrec_init(L);
+	box_lua_cpu_profiler_init(L);
 	box_lua_trigger_init(L);
 	box_lua_integrity_init(L);
 	box_lua_expression_lexer_init(L);
@@ -93,6 +93,7 @@ local default_cfg = {
     slab_alloc_granularity = 8,
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
+    iproto_reuseport    = false,
     memtx_allocator     = "small",
     work_dir            = nil,
     memtx_dir           = ".",
@@ -101,8 +102,12 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
+    vinyl_os_cache      = true,
+    vinyl_read_ahead    = 0,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
+    vinyl_read_latency_budget = 0,
     vinyl_write_threads = 4,
     vinyl_timeout       = 60,
     vinyl_defer_deletes = false,
@@ -117,6 +122,8 @@ local default_cfg = {
     log_level           = log.cfg.level,
     log_modules         = log.cfg.modules,
     log_format          = log.cfg.format,
+    log_async           = log.cfg.async,
+    log_async_overflow  = log.cfg.async_overflow,
 
     audit_log           = ifdef_audit(nil),
     audit_nonblock      = ifdef_audit(true),
@@ -156,6 +163,7 @@ local default_cfg = {
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
+    wal_ring_size       = 0,
     wal_cleanup_delay   = 4 * 3600,
     wal_retention_period = ifdef_wal_retention_period(0),
     wal_ext             = ifdef_wal_ext(nil),
@@ -176,19 +184,24 @@ local default_cfg = {
     memtx_use_mvcc_engine = false,
     checkpoint_interval = 3600,
     checkpoint_wal_threshold = 1e18,
+    checkpoint_recovery_time = 0,
     checkpoint_count    = 2,
     worker_pool_threads = 4,
     election_mode       = 'off',
     election_timeout    = 5,
     election_fencing_mode = 'soft',
+    election_lease_max_drift = nil, -- leases are disabled
     replication_timeout = 1,
     replication_sync_lag = 10,
     replication_sync_timeout = 0,
     replication_synchro_quorum = "N / 2 + 1",
     replication_synchro_timeout = 5,
+    replication_synchro_confirm_delay = 0,
     replication_connect_timeout = 30,
     replication_connect_quorum = nil, -- connect all
     replication_skip_conflict = false,
+    replication_apply_workers = 1,
+    replication_compression = 0,
     replication_anon      = false,
     replication_threads   = 1,
     bootstrap_strategy    = "auto",
@@ -201,6 +214,22 @@ local default_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback(60),
     feedback_metrics_limit = ifdef_feedback(1024 * 1024),
     net_msg_max           = 768,
+    iproto_read_view_interval = 0,
+    iproto_compression_threshold = 16384,
+    iproto_busy_poll      = 0,
+    iproto_slow_request_threshold = 0,
+    iproto_wait_vclock_timeout = 1,
+    tx_cpu_affinity       = nil,
+    wal_cpu_affinity      = nil,
+    iproto_cpu_affinity   = nil,
+    memtx_numa_node       = nil,
+    memtx_use_huge_pages  = false,
+    memtx_checkpoint_delta_count = 0,
+    memtx_snapshot_compress_threads = 1,
+    memtx_snapshot_compression_level = 3,
+    memtx_ddl_rate_limit = 0,
+    memtx_snapshot_index_order = false,
+    memtx_background_index_build = false,
     sql_cache_size        = 5 * 1024 * 1024,
     txn_timeout           = 365 * 100 * 86400,
     txn_isolation         = "best-effort",
@@ -294,6 +323,7 @@ local template_cfg = {
     slab_alloc_granularity = 'number',
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
+    iproto_reuseport    = 'boolean',
     memtx_allocator     = 'string',
     work_dir            = 'string',
     memtx_dir            = 'string',
@@ -301,8 +331,12 @@ local template_cfg = {
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_os_cache            = 'boolean',
+    vinyl_read_ahead          = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
+    vinyl_read_latency_budget = 'number',
     vinyl_write_threads       = 'number',
     vinyl_timeout             = 'number',
     vinyl_defer_deletes       = 'boolean',
@@ -317,6 +351,8 @@ local template_cfg = {
     log_level           = 'number, string',
     log_modules         = 'table',
     log_format          = 'string',
+    log_async           = 'boolean',
+    log_async_overflow  = 'string',
 
     audit_log           = ifdef_audit('string'),
     audit_nonblock      = ifdef_audit('boolean'),
@@ -372,7 +408,9 @@ local template_cfg = {
     coredump            = 'boolean',
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
+    checkpoint_recovery_time = 'number',
     wal_queue_max_size  = 'number',
+    wal_ring_size       = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
@@ -382,14 +420,18 @@ local template_cfg = {
     election_mode       = 'string',
     election_timeout    = 'number',
     election_fencing_mode = 'string',
+    election_lease_max_drift = 'number',
     replication_timeout = 'number',
     replication_sync_lag = 'number',
     replication_sync_timeout = 'number',
     replication_synchro_quorum = 'string, number',
     replication_synchro_timeout = 'number',
+    replication_synchro_confirm_delay = 'number',
     replication_connect_timeout = 'number',
     replication_connect_quorum = 'number',
     replication_skip_conflict = 'boolean',
+    replication_apply_workers = 'number',
+    replication_compression = 'number',
     replication_anon      = 'boolean',
     replication_threads   = 'number',
     bootstrap_strategy    = 'string',
@@ -402,6 +444,22 @@ local template_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback('number'),
     feedback_metrics_limit = ifdef_feedback('number'),
     net_msg_max           = 'number',
+    iproto_read_view_interval = 'number',
+    iproto_compression_threshold = 'number',
+    iproto_busy_poll      = 'number',
+    iproto_slow_request_threshold = 'number',
+    iproto_wait_vclock_timeout = 'number',
+    tx_cpu_affinity       = 'string',
+    wal_cpu_affinity      = 'string',
+    iproto_cpu_affinity   = 'string',
+    memtx_numa_node       = 'number',
+    memtx_use_huge_pages  = 'boolean',
+    memtx_checkpoint_delta_count = 'number',
+    memtx_snapshot_compress_threads = 'number',
+    memtx_snapshot_compression_level = 'number',
+    memtx_ddl_rate_limit = 'number',
+    memtx_snapshot_index_order = 'boolean',
+    memtx_background_index_build = 'boolean',
     sql_cache_size        = 'number',
     txn_timeout           = 'number',
     memtx_sort_threads    = 'number',
@@ -495,12 +553,18 @@ local dynamic_cfg = {
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
+    vinyl_os_cache          = private.cfg_set_vinyl_os_cache,
+    vinyl_read_ahead        = private.cfg_set_vinyl_read_ahead,
+    vinyl_read_latency_budget = private.cfg_set_vinyl_read_latency_budget,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     vinyl_defer_deletes     = nop,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
+    checkpoint_recovery_time = private.cfg_set_checkpoint_recovery_time,
     wal_queue_max_size      = private.cfg_set_wal_queue_max_size,
+    wal_ring_size           = private.cfg_set_wal_ring_size,
     worker_pool_threads     = private.cfg_set_worker_pool_threads,
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = nop,
@@ -513,6 +577,7 @@ local dynamic_cfg = {
     election_mode           = private.cfg_set_election_mode,
     election_timeout        = private.cfg_set_election_timeout,
     election_fencing_mode = private.cfg_set_election_fencing_mode,
+    election_lease_max_drift = private.cfg_set_election_lease_max_drift,
     replication_timeout     = private.cfg_set_replication_timeout,
     replication_connect_timeout = private.cfg_set_replication_connect_timeout,
     replication_connect_quorum = private.cfg_set_replication_connect_quorum,
@@ -520,7 +585,11 @@ local dynamic_cfg = {
     replication_sync_timeout = private.cfg_set_replication_sync_timeout,
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
+    replication_synchro_confirm_delay =
+        private.cfg_set_replication_synchro_confirm_delay,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
+    replication_apply_workers = private.cfg_set_replication_apply_workers,
+    replication_compression = private.cfg_set_replication_compression,
     replication_anon        = private.cfg_set_replication_anon,
     bootstrap_strategy      = private.cfg_set_bootstrap_strategy,
     instance_uuid           = check_instance_uuid,
@@ -529,6 +598,28 @@ local dynamic_cfg = {
     replicaset_name         = private.cfg_set_replicaset_name,
     cluster_name            = private.cfg_set_cluster_name,
     net_msg_max             = private.cfg_set_net_msg_max,
+    iproto_read_view_interval = private.cfg_set_iproto_read_view_interval,
+    iproto_compression_threshold =
+        private.cfg_set_iproto_compression_threshold,
+    iproto_busy_poll        = private.cfg_set_iproto_busy_poll,
+    iproto_slow_request_threshold =
+        private.cfg_set_iproto_slow_request_threshold,
+    iproto_wait_vclock_timeout =
+        private.cfg_set_iproto_wait_vclock_timeout,
+    tx_cpu_affinity         = private.cfg_set_tx_cpu_affinity,
+    wal_cpu_affinity        = private.cfg_set_wal_cpu_affinity,
+    iproto_cpu_affinity     = private.cfg_set_iproto_cpu_affinity,
+    memtx_numa_node         = private.cfg_set_memtx_numa_node,
+    memtx_use_huge_pages    = private.cfg_set_memtx_use_huge_pages,
+    memtx_checkpoint_delta_count =
+        private.cfg_set_memtx_checkpoint_delta_count,
+    memtx_snapshot_compress_threads =
+        private.cfg_set_memtx_snapshot_compress_threads,
+    memtx_snapshot_compression_level =
+        private.cfg_set_memtx_snapshot_compression_level,
+    memtx_ddl_rate_limit    = private.cfg_set_memtx_ddl_rate_limit,
+    memtx_snapshot_index_order =
+        private.cfg_set_memtx_snapshot_index_order,
     sql_cache_size          = private.cfg_set_sql_cache_size,
     txn_timeout             = private.cfg_set_txn_timeout,
     txn_isolation           = private.cfg_set_txn_isolation,
@@ -606,6 +697,8 @@ local dynamic_cfg_modules = {
             log_modules = true,
             log_format = true,
             log_nonblock = true,
+            log_async = true,
+            log_async_overflow = true,
         },
         skip_at_load = true,
     }
@@ -656,6 +749,7 @@ local dynamic_cfg_order = {
     election_mode           = 300,
     election_timeout        = 320,
     election_fencing_mode   = 320,
+    election_lease_max_drift = 320,
 }
 
 local function sort_cfg_cb(l, r)
@@ -670,11 +764,16 @@ local dynamic_cfg_skip_at_load = {
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
+    vinyl_os_cache          = true,
+    vinyl_read_ahead        = true,
+    vinyl_read_latency_budget = true,
     vinyl_timeout           = true,
     too_long_threshold      = true,
     election_mode           = true,
     election_timeout        = true,
     election_fencing_mode   = true,
+    election_lease_max_drift = true,
     replication             = true,
     replication_timeout     = true,
     replication_connect_timeout = true,
@@ -683,11 +782,15 @@ local dynamic_cfg_skip_at_load = {
     replication_sync_timeout = true,
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
+    replication_synchro_confirm_delay = true,
     replication_skip_conflict = true,
+    replication_apply_workers = true,
+    replication_compression = true,
     replication_anon        = true,
     bootstrap_strategy      = true,
     wal_dir_rescan_delay    = true,
     wal_queue_max_size      = true,
+    wal_ring_size           = true,
     custom_proc_title       = true,
     force_recovery          = true,
     instance_uuid           = true,
@@ -696,6 +799,21 @@ local dynamic_cfg_skip_at_load = {
     replicaset_name         = true,
     cluster_name            = true,
     net_msg_max             = true,
+    iproto_read_view_interval = true,
+    iproto_compression_threshold = true,
+    iproto_busy_poll        = true,
+    iproto_slow_request_threshold = true,
+    iproto_wait_vclock_timeout = true,
+    tx_cpu_affinity         = true,
+    wal_cpu_affinity        = true,
+    iproto_cpu_affinity     = true,
+    memtx_numa_node         = true,
+    memtx_use_huge_pages    = true,
+    memtx_checkpoint_delta_count = true,
+    memtx_snapshot_compress_threads = true,
+    memtx_snapshot_compression_level = true,
+    memtx_ddl_rate_limit    = true,
+    memtx_snapshot_index_order = true,
     readahead               = true,
     auth_type               = true,
     auth_delay              = ifdef_security(true),
@@ -415,11 +415,11 @@ lbox_prepare_auth(lua_State *L)
 static int
 lbox_select(lua_State *L)
 {
-	if (lua_gettop(L) != 8 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	if (lua_gettop(L) != 9 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
 	    !lua_isnumber(L, 3) || !lua_isnumber(L, 4) || !lua_isnumber(L, 5) ||
-	    !lua_isboolean(L, 8)) {
+	    !lua_isboolean(L, 8) || !lua_isboolean(L, 9)) {
 		return luaL_error(L, "Usage index:select(iterator, offset, "
-				  "limit, key, after, fetch_pos)");
+				  "limit, key, after, fetch_pos, covering)");
 	}
 
 	uint32_t svp = region_used(&fiber()->gc);
@@ -432,6 +432,7 @@ lbox_select(lua_State *L)
 	uint32_t offset = lua_tonumber(L, 4);
 	uint32_t limit = lua_tonumber(L, 5);
 	bool fetch_pos = lua_toboolean(L, 8);
+	bool covering = lua_toboolean(L, 9);
 
 	size_t key_len;
 	const char *key = lbox_encode_tuple_on_gc(L, 6, &key_len);
@@ -444,7 +445,7 @@ lbox_select(lua_State *L)
 
 	if (box_select(space_id, index_id, iterator, offset, limit, key,
 		       key + key_len, &packed_pos, &packed_pos_end, fetch_pos,
-		       &port) != 0)
+		       covering, &port) != 0)
 		goto fail;
 	/*
 	 * Lua may raise an exception during allocating table or pushing
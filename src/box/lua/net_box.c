@@ -37,6 +37,7 @@
 #include <stdint.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <zstd.h>
 
 #include "box/authentication.h"
 #include "box/errcode.h"
@@ -101,6 +102,7 @@ static struct iproto_features NETBOX_IPROTO_FEATURES;
 	_(UPSERT)							\
 	_(SELECT)							\
 	_(SELECT_WITH_POS)						\
+	_(SELECT_WITH_CURSOR)						\
 	_(EXECUTE)							\
 	_(PREPARE)							\
 	_(UNPREPARE)							\
@@ -178,6 +180,21 @@ struct netbox_options {
 	 * Flag that determines is it required to fetch server schema or not.
 	 */
 	 bool fetch_schema;
+	/**
+	 * If set, the server is allowed to compress responses,
+	 * see IPROTO_FEATURE_COMPRESSION.
+	 */
+	bool compression;
+	/**
+	 * Max time to delay sending requests in order to send them all
+	 * in one write, in seconds. Delaying is disabled if it's 0.
+	 */
+	double coalesce_timeout;
+	/**
+	 * Requests are sent without delay once this many bytes have been
+	 * accumulated in the send buffer. The limit is disabled if it's 0.
+	 */
+	size_t coalesce_size;
 };
 
 /**
@@ -275,6 +292,13 @@ struct netbox_transport {
 	struct ibuf recv_buf;
 	/** Size of the last received message. */
 	size_t last_msg_size;
+	/**
+	 * Body of the last received message if it was compressed,
+	 * see netbox_transport_decompress().
+	 */
+	struct ibuf decompress_buf;
+	/** Context used for decompressing responses or NULL. */
+	ZSTD_DCtx *zstd_ctx;
 	/** Signalled when send_buf becomes empty. */
 	struct fiber_cond on_send_buf_empty;
 	/** Next request id. */
@@ -288,6 +312,24 @@ struct netbox_transport {
 	 * by the user.
 	 */
 	int64_t inprogress_request_count;
+	/**
+	 * Number of batches that are currently open, see conn:batch().
+	 * Requests are not sent while a batch is open unless someone
+	 * waits for a response.
+	 */
+	int batch_depth;
+	/** Set if the send buffer must be sent without any delay. */
+	bool need_flush;
+	/**
+	 * Time until which sending of the send buffer may be delayed,
+	 * see netbox_options::coalesce_timeout.
+	 */
+	double send_deadline;
+	/**
+	 * Vclock tokens returned by the server in responses to write
+	 * requests merged together, see IPROTO_FEATURE_WAIT_VCLOCK.
+	 */
+	struct vclock vclock_token;
 };
 
 struct netbox_request {
@@ -471,6 +513,13 @@ netbox_request_wait(struct netbox_request *request, double *timeout)
 	       request->transport->worker != fiber());
 	if (*timeout == 0)
 		return false;
+	/* Waiting inside an open batch would never end. */
+	struct netbox_transport *transport = request->transport;
+	if (transport->batch_depth > 0 && !transport->need_flush &&
+	    ibuf_used(&transport->send_buf) > 0 && transport->worker != NULL) {
+		transport->need_flush = true;
+		fiber_wakeup(transport->worker);
+	}
 	double ts = ev_monotonic_now(loop());
 	int rc = fiber_cond_wait_timeout(&request->cond, *timeout);
 	*timeout -= ev_monotonic_now(loop()) - ts;
@@ -554,10 +603,17 @@ netbox_transport_create(struct netbox_transport *transport)
 	ibuf_create(&transport->send_buf, &cord()->slabc, NETBOX_READAHEAD);
 	ibuf_create(&transport->recv_buf, &cord()->slabc, NETBOX_READAHEAD);
 	transport->last_msg_size = 0;
+	ibuf_create(&transport->decompress_buf, &cord()->slabc,
+		    NETBOX_READAHEAD);
+	transport->zstd_ctx = NULL;
 	fiber_cond_create(&transport->on_send_buf_empty);
 	transport->next_sync = 1;
 	transport->requests = mh_i64ptr_new();
 	transport->inprogress_request_count = 0;
+	transport->batch_depth = 0;
+	transport->need_flush = false;
+	transport->send_deadline = 0;
+	vclock_create(&transport->vclock_token);
 }
 
 static void
@@ -574,6 +630,8 @@ netbox_transport_destroy(struct netbox_transport *transport)
 	assert(!iostream_is_initialized(&transport->io));
 	assert(ibuf_used(&transport->send_buf) == 0);
 	assert(ibuf_used(&transport->recv_buf) == 0);
+	ibuf_destroy(&transport->decompress_buf);
+	ZSTD_freeDCtx(transport->zstd_ctx);
 	fiber_cond_destroy(&transport->on_send_buf_empty);
 	struct mh_i64ptr_t *h = transport->requests;
 	assert(mh_size(h) == 0);
@@ -611,6 +669,7 @@ netbox_transport_set_error(struct netbox_transport *transport)
 	error_ref(error);
 	/* Reset buffers. */
 	ibuf_reinit(&transport->send_buf);
+	transport->need_flush = false;
 	ibuf_reinit(&transport->recv_buf);
 	transport->last_msg_size = 0;
 	fiber_cond_broadcast(&transport->on_send_buf_empty);
@@ -705,13 +764,15 @@ netbox_encode_ping(lua_State *L, int idx, struct netbox_method_encode_ctx *ctx)
  */
 static void
 netbox_encode_id(struct lua_State *L, struct ibuf *ibuf, uint64_t sync,
-		 bool fetch_schema)
+		 bool fetch_schema, bool compression)
 {
 	struct iproto_features features = NETBOX_IPROTO_FEATURES;
 	if (fetch_schema) {
 		iproto_features_clear(&features,
 				      IPROTO_FEATURE_DML_TUPLE_EXTENSION);
 	}
+	if (!compression)
+		iproto_features_clear(&features, IPROTO_FEATURE_COMPRESSION);
 #ifndef NDEBUG
 	struct errinj *errinj = errinj(ERRINJ_NETBOX_FLIP_FEATURE, ERRINJ_INT);
 	if (errinj->iparam >= 0 && errinj->iparam < iproto_feature_id_MAX) {
@@ -816,28 +877,59 @@ netbox_encode_call_or_eval_args(lua_State *L, int idx, struct mpstream *stream,
 	return 0;
 }
 
+/*
+ * Encode IPROTO_WAIT_VCLOCK from a Lua table that maps replica ids to LSNs.
+ */
+static void
+netbox_encode_wait_vclock(lua_State *L, int idx, struct mpstream *stream)
+{
+	uint32_t size = 0;
+	lua_pushnil(L);
+	while (lua_next(L, idx) != 0) {
+		size++;
+		lua_pop(L, 1);
+	}
+	mpstream_encode_uint(stream, IPROTO_WAIT_VCLOCK);
+	mpstream_encode_map(stream, size);
+	lua_pushnil(L);
+	while (lua_next(L, idx) != 0) {
+		mpstream_encode_uint(stream, lua_tointeger(L, -2));
+		mpstream_encode_uint(stream, lua_tointeger(L, -1));
+		lua_pop(L, 1);
+	}
+}
+
 /**
  * Encode an `IPROTO_CALL` request and write it to the provided MsgPack stream.
  */
 static int
 netbox_encode_call(lua_State *L, int idx, struct netbox_method_encode_ctx *ctx)
 {
-	/* Lua stack at idx: function_name, args */
+	/* Lua stack at idx: function_name or function_id, args, wait_vclock */
 	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync, IPROTO_CALL,
 					 ctx->stream_id);
 
-	mpstream_encode_map(ctx->stream, 3);
+	bool have_wait_vclock = !lua_isnoneornil(L, idx + 2);
+	mpstream_encode_map(ctx->stream, 3 + have_wait_vclock);
 
-	/* encode proc name */
-	size_t name_len;
-	const char *name = lua_tolstring(L, idx, &name_len);
-	mpstream_encode_uint(ctx->stream, IPROTO_FUNCTION_NAME);
-	mpstream_encode_strn(ctx->stream, name, name_len);
+	/* encode proc name or id */
+	if (lua_type(L, idx) == LUA_TNUMBER) {
+		mpstream_encode_uint(ctx->stream, IPROTO_FUNCTION_ID);
+		mpstream_encode_uint(ctx->stream, lua_tointeger(L, idx));
+	} else {
+		size_t name_len;
+		const char *name = lua_tolstring(L, idx, &name_len);
+		mpstream_encode_uint(ctx->stream, IPROTO_FUNCTION_NAME);
+		mpstream_encode_strn(ctx->stream, name, name_len);
+	}
 
 	if (netbox_encode_call_or_eval_args(L, idx + 1, ctx->stream,
 					    ctx->box_tuple_arg_as_ext) != 0)
 		return -1;
 
+	if (have_wait_vclock)
+		netbox_encode_wait_vclock(L, idx + 2, ctx->stream);
+
 	netbox_end_encode(ctx->stream, svp);
 	return 0;
 }
@@ -848,11 +940,12 @@ netbox_encode_call(lua_State *L, int idx, struct netbox_method_encode_ctx *ctx)
 static int
 netbox_encode_eval(lua_State *L, int idx, struct netbox_method_encode_ctx *ctx)
 {
-	/* Lua stack at idx: expr, args */
+	/* Lua stack at idx: expr, args, wait_vclock */
 	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync, IPROTO_EVAL,
 					 ctx->stream_id);
 
-	mpstream_encode_map(ctx->stream, 3);
+	bool have_wait_vclock = !lua_isnoneornil(L, idx + 2);
+	mpstream_encode_map(ctx->stream, 3 + have_wait_vclock);
 
 	/* encode expr */
 	size_t expr_len;
@@ -864,6 +957,9 @@ netbox_encode_eval(lua_State *L, int idx, struct netbox_method_encode_ctx *ctx)
 					    ctx->box_tuple_arg_as_ext) != 0)
 		return -1;
 
+	if (have_wait_vclock)
+		netbox_encode_wait_vclock(L, idx + 2, ctx->stream);
+
 	netbox_end_encode(ctx->stream, svp);
 	return 0;
 }
@@ -913,7 +1009,7 @@ netbox_encode_select(lua_State *L, int idx,
 {
 	/*
 	 * Lua stack at idx: space_id, index_id, iterator, offset, limit, key,
-	 * after, fetch_pos.
+	 * after, fetch_pos, cursor, wait_vclock.
 	 */
 	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync, IPROTO_SELECT,
 					 ctx->stream_id);
@@ -925,6 +1021,12 @@ netbox_encode_select(lua_State *L, int idx,
 	bool fetch_pos = lua_toboolean(L, idx + 7);
 	if (fetch_pos)
 		map_size++;
+	bool have_cursor = !lua_isnoneornil(L, idx + 8);
+	if (have_cursor)
+		map_size++;
+	bool have_wait_vclock = !lua_isnoneornil(L, idx + 9);
+	if (have_wait_vclock)
+		map_size++;
 	mpstream_encode_map(ctx->stream, map_size);
 	int iterator = lua_tointeger(L, idx + 2);
 	uint32_t offset = lua_tonumber(L, idx + 3);
@@ -974,6 +1076,15 @@ netbox_encode_select(lua_State *L, int idx,
 		mpstream_encode_bool(ctx->stream, fetch_pos);
 	}
 
+	/* encode cursor */
+	if (have_cursor) {
+		mpstream_encode_uint(ctx->stream, IPROTO_CURSOR_ID);
+		mpstream_encode_uint(ctx->stream, luaL_checkuint64(L, idx + 8));
+	}
+
+	if (have_wait_vclock)
+		netbox_encode_wait_vclock(L, idx + 9, ctx->stream);
+
 	netbox_end_encode(ctx->stream, svp);
 	return 0;
 }
@@ -1162,6 +1273,32 @@ netbox_transport_connect(struct netbox_transport *transport)
 	return -1;
 }
 
+/**
+ * Returns true if the send buffer should be written to the socket now.
+ * Otherwise sets @a delay to the time sending may be delayed for.
+ */
+static bool
+netbox_transport_should_send(struct netbox_transport *transport,
+			     double *delay)
+{
+	*delay = TIMEOUT_INFINITY;
+	size_t used = ibuf_used(&transport->send_buf);
+	if (used == 0)
+		return false;
+	if (transport->is_closing || transport->need_flush)
+		return true;
+	if (transport->opts.coalesce_size > 0 &&
+	    used >= transport->opts.coalesce_size)
+		return true;
+	if (transport->batch_depth > 0)
+		return false;
+	double now = ev_monotonic_now(loop());
+	if (now >= transport->send_deadline)
+		return true;
+	*delay = transport->send_deadline - now;
+	return false;
+}
+
 /**
  * Reads data from the given socket until the limit is reached.
  * Returns 0 on success. On error returns -1 and sets diag.
@@ -1225,13 +1362,16 @@ netbox_transport_communicate(struct netbox_transport *transport, size_t limit)
 		}
 		if (ibuf_used(recv_buf) >= limit)
 			return 0;
-		while (ibuf_used(send_buf) > 0) {
+		double delay;
+		while (netbox_transport_should_send(transport, &delay)) {
 			ssize_t rc = iostream_write(io, send_buf->rpos,
 						    ibuf_used(send_buf));
 			if (rc >= 0) {
 				ibuf_consume(send_buf, rc);
-				if (ibuf_used(send_buf) == 0)
+				if (ibuf_used(send_buf) == 0) {
+					transport->need_flush = false;
 					fiber_cond_broadcast(on_send_buf_empty);
+				}
 			} else if (rc == IOSTREAM_ERROR) {
 				goto io_error;
 			} else {
@@ -1239,7 +1379,7 @@ netbox_transport_communicate(struct netbox_transport *transport, size_t limit)
 				break;
 			}
 		}
-		coio_wait(io->fd, events, TIMEOUT_INFINITY);
+		coio_wait(io->fd, events, delay);
 		ERROR_INJECT_YIELD(ERRINJ_NETBOX_IO_DELAY);
 		ERROR_INJECT(ERRINJ_NETBOX_IO_ERROR, {
 			box_error_raise(ER_NO_CONNECTION, "Error injection");
@@ -1257,6 +1397,65 @@ netbox_transport_communicate(struct netbox_transport *transport, size_t limit)
 	return -1;
 }
 
+/**
+ * Decompresses the body of a received response if it's compressed,
+ * see IPROTO_COMPRESSION. The decompressed body is stored in the
+ * transport buffer until the next response is received.
+ * On error returns -1 and sets diag.
+ */
+static int
+netbox_transport_decompress(struct netbox_transport *transport,
+			    struct xrow_header *hdr)
+{
+	uint64_t compression = IPROTO_COMPRESSION_NONE;
+	const char *pos = hdr->header;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		/* Keys and their types are checked by xrow_header_decode(). */
+		uint64_t key = mp_decode_uint(&pos);
+		if (key == IPROTO_COMPRESSION) {
+			compression = mp_decode_uint(&pos);
+			break;
+		}
+		mp_next(&pos);
+	}
+	if (compression == IPROTO_COMPRESSION_NONE)
+		return 0;
+	if (compression != IPROTO_COMPRESSION_ZSTD || hdr->bodycnt == 0)
+		goto error;
+	const char *data = hdr->body[0].iov_base;
+	if (mp_typeof(*data) != MP_BIN)
+		goto error;
+	uint32_t len = mp_decode_binl(&data);
+	unsigned long long size = ZSTD_getFrameContentSize(data, len);
+	if (size == ZSTD_CONTENTSIZE_UNKNOWN ||
+	    size == ZSTD_CONTENTSIZE_ERROR || size > UINT32_MAX)
+		goto error;
+	if (transport->zstd_ctx == NULL) {
+		transport->zstd_ctx = ZSTD_createDCtx();
+		if (transport->zstd_ctx == NULL) {
+			diag_set(OutOfMemory, 0, "ZSTD_createDCtx",
+				 "zstd context");
+			return -1;
+		}
+	}
+	ibuf_reset(&transport->decompress_buf);
+	char *body = xibuf_alloc(&transport->decompress_buf, size);
+	size_t rc = ZSTD_decompressDCtx(transport->zstd_ctx, body, size,
+					data, len);
+	if (ZSTD_isError(rc) || rc != size)
+		goto error;
+	pos = body;
+	if (mp_check(&pos, body + size) != 0 || pos != body + size)
+		goto error;
+	hdr->body[0].iov_base = body;
+	hdr->body[0].iov_len = size;
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_MSGPACK, "compressed packet body");
+	return -1;
+}
+
 /**
  * Sends and receives data over an iproto connection.
  * Returns 0 and a decoded response header on success.
@@ -1290,6 +1489,9 @@ netbox_transport_send_and_recv(struct netbox_transport *transport,
 						hdr, &rpos, body_end,
 						/*end_is_exact=*/true);
 				transport->last_msg_size = body_end - bufpos;
+				if (rc == 0)
+					rc = netbox_transport_decompress(
+							transport, hdr);
 				return rc;
 			}
 		}
@@ -1506,6 +1708,7 @@ netbox_encode_method(struct lua_State *L, int idx, enum netbox_method method,
 		[NETBOX_UPSERT]		= netbox_encode_upsert,
 		[NETBOX_SELECT]		= netbox_encode_select,
 		[NETBOX_SELECT_WITH_POS] = netbox_encode_select,
+		[NETBOX_SELECT_WITH_CURSOR] = netbox_encode_select,
 		[NETBOX_EXECUTE]	= netbox_encode_execute,
 		[NETBOX_PREPARE]	= netbox_encode_prepare,
 		[NETBOX_UNPREPARE]	= netbox_encode_unprepare,
@@ -1543,6 +1746,8 @@ struct response_body {
 	const char *pos;
 	/* IPROTO_POSITION length */
 	uint32_t pos_len;
+	/* IPROTO_CURSOR_ID or 0 */
+	uint64_t cursor_id;
 	/* IPROTO_TUPLE_FORMATS */
 	const char *tuple_formats;
 	/* IPROTO_TUPLE_FORMATS end. */
@@ -1577,6 +1782,10 @@ response_body_decode(struct response_body *response_body, const char **data,
 				mp_decode_str(&value, &response_body->pos_len);
 			assert(response_body->pos_len != 0);
 			break;
+		case IPROTO_CURSOR_ID:
+			assert(mp_typeof(*value) == MP_UINT);
+			response_body->cursor_id = mp_decode_uint(&value);
+			break;
 		case IPROTO_TUPLE_FORMATS:
 			assert(mp_typeof(*value) == MP_MAP);
 			response_body->tuple_formats = value;
@@ -1759,6 +1968,37 @@ netbox_decode_select_with_pos(struct lua_State *L, const char **data,
 	}
 }
 
+/**
+ * Decodes Tarantool response body consisting of IPROTO_DATA and probably
+ * IPROTO_CURSOR_ID keys into array with array of tuple on the first place
+ * and cursor id on the second place, pushes it to Lua stack.
+ */
+static void
+netbox_decode_select_with_cursor(struct lua_State *L, const char **data,
+				 const char *data_end, bool return_raw,
+				 struct tuple_format *format)
+{
+	struct response_body response_body;
+	response_body_decode(&response_body, data, data_end);
+	lua_createtable(L, response_body.cursor_id != 0 ? 2 : 1, 0);
+	int table_idx = lua_gettop(L);
+	struct mp_box_ctx ctx;
+	mp_box_ctx_create(&ctx, NULL, response_body.tuple_formats);
+	if (return_raw) {
+		luamp_push_with_ctx(L, response_body.data,
+				    response_body.data_end,
+				    (struct mp_ctx *)&ctx);
+	} else {
+		netbox_decode_data(L, &response_body.data, format, &ctx);
+	}
+	mp_ctx_destroy((struct mp_ctx *)&ctx);
+	lua_rawseti(L, table_idx, 1);
+	if (response_body.cursor_id != 0) {
+		luaL_pushuint64(L, response_body.cursor_id);
+		lua_rawseti(L, table_idx, 2);
+	}
+}
+
 /**
  * Same as netbox_decode_select, but only decodes the first tuple of the array,
  * skipping the rest.
@@ -2051,6 +2291,7 @@ netbox_decode_method(struct lua_State *L, enum netbox_method method,
 		[NETBOX_UPSERT]		= netbox_decode_nil,
 		[NETBOX_SELECT]		= netbox_decode_select,
 		[NETBOX_SELECT_WITH_POS] = netbox_decode_select_with_pos,
+		[NETBOX_SELECT_WITH_CURSOR] = netbox_decode_select_with_cursor,
 		[NETBOX_EXECUTE]	= netbox_decode_execute,
 		[NETBOX_PREPARE]	= netbox_decode_prepare,
 		[NETBOX_UNPREPARE]	= netbox_decode_nil,
@@ -2382,12 +2623,14 @@ luaT_netbox_request_pairs(struct lua_State *L)
  * Takes the following arguments: uri (string or table) or fd (number),
  * user (string or nil), password (string or nil), callback (function),
  * connect_timeout (number or nil), reconnect_after (number or nil),
- * fetch_schema (boolean or nil), auth_type (string or nil).
+ * fetch_schema (boolean or nil), auth_type (string or nil),
+ * compression (boolean or nil), coalesce_timeout (number or nil),
+ * coalesce_size (number or nil).
  */
 static int
 luaT_netbox_new_transport(struct lua_State *L)
 {
-	assert(lua_gettop(L) == 8);
+	assert(lua_gettop(L) == 11);
 	/* Create a transport object. */
 	struct netbox_transport *transport;
 	transport = lua_newuserdata(L, sizeof(*transport));
@@ -2433,6 +2676,12 @@ luaT_netbox_new_transport(struct lua_State *L)
 			return luaT_error(L);
 		}
 	}
+	if (!lua_isnil(L, 9))
+		opts->compression = lua_toboolean(L, 9);
+	if (!lua_isnil(L, 10))
+		opts->coalesce_timeout = luaL_checknumber(L, 10);
+	if (!lua_isnil(L, 11))
+		opts->coalesce_size = luaL_checkinteger(L, 11);
 	if (opts->user == NULL && opts->password != NULL) {
 		diag_set(ClientError, ER_PROC_LUA,
 			 "net.box: user is not defined");
@@ -2498,8 +2747,16 @@ luaT_netbox_transport_make_request(struct lua_State *L, int idx,
 		return -1;
 	}
 	/* Alert worker to notify it of the queued outgoing data. */
-	if (svp == 0)
+	if (svp == 0) {
+		transport->send_deadline = ev_monotonic_now(loop()) +
+					   transport->opts.coalesce_timeout;
+		fiber_wakeup(transport->worker);
+	} else if (transport->opts.coalesce_size > 0 &&
+		   svp < transport->opts.coalesce_size &&
+		   ibuf_used(&transport->send_buf) >=
+		   transport->opts.coalesce_size) {
 		fiber_wakeup(transport->worker);
+	}
 	transport->inprogress_request_count++;
 
 	/* Initialize and register the request object. */
@@ -2733,6 +2990,34 @@ netbox_write_response_to_buffer(const char *data, const char *data_end,
 		lua_rawseti(L, -2, 1);
 }
 
+/**
+ * Merges the vclock token returned in the response to a write request into
+ * netbox_transport::vclock_token, see IPROTO_FEATURE_WAIT_VCLOCK.
+ */
+static void
+netbox_transport_update_vclock_token(struct netbox_transport *transport,
+				     const char *data)
+{
+	assert(mp_typeof(*data) == MP_MAP);
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		assert(mp_typeof(*data) == MP_UINT);
+		uint64_t key = mp_decode_uint(&data);
+		if (key != IPROTO_VCLOCK || mp_typeof(*data) != MP_MAP) {
+			mp_next(&data);
+			continue;
+		}
+		uint32_t vclock_size = mp_decode_map(&data);
+		for (uint32_t j = 0; j < vclock_size; j++) {
+			uint64_t id = mp_decode_uint(&data);
+			int64_t lsn = mp_decode_uint(&data);
+			if (id < VCLOCK_MAX &&
+			    lsn > vclock_get(&transport->vclock_token, id))
+				vclock_follow(&transport->vclock_token, id, lsn);
+		}
+	}
+}
+
 /**
  * Given a netbox transport and a response header, decodes the response and
  * either completes the request or invokes the on-push trigger, depending on
@@ -2777,6 +3062,20 @@ netbox_transport_dispatch_response(struct netbox_transport *transport,
 	}
 	const char *data = hdr->body[0].iov_base;
 	const char *data_end = data + hdr->body[0].iov_len;
+	if (status == IPROTO_OK) {
+		switch (request->method) {
+		case NETBOX_INSERT:
+		case NETBOX_REPLACE:
+		case NETBOX_DELETE:
+		case NETBOX_UPDATE:
+		case NETBOX_UPSERT:
+		case NETBOX_COMMIT:
+			netbox_transport_update_vclock_token(transport, data);
+			break;
+		default:
+			break;
+		}
+	}
 	if (request->buffer != NULL) {
 		netbox_write_response_to_buffer(data, data_end, L,
 						request->buffer,
@@ -2834,7 +3133,8 @@ netbox_transport_do_id(struct netbox_transport *transport, struct lua_State *L)
 	if (peer_version_id < version_id(2, 10, 0))
 		goto unsupported;
 	netbox_encode_id(L, &transport->send_buf, transport->next_sync++,
-			 transport->opts.fetch_schema);
+			 transport->opts.fetch_schema,
+			 transport->opts.compression);
 	struct xrow_header hdr;
 	if (netbox_transport_send_and_recv(transport, &hdr) != 0)
 		luaT_error(L);
@@ -3213,6 +3513,58 @@ luaT_netbox_transport_stop(struct lua_State *L)
 	return 0;
 }
 
+/**
+ * Returns the vclock tokens received in responses to write requests merged
+ * together in a table that maps replica ids to LSNs or nil if there were no
+ * such responses. The table may be passed in the wait_vclock request option
+ * to a replica.
+ */
+static int
+luaT_netbox_transport_vclock_token(struct lua_State *L)
+{
+	struct netbox_transport *transport = luaT_check_netbox_transport(L, 1);
+	if (vclock_sum(&transport->vclock_token) == 0) {
+		lua_pushnil(L);
+		return 1;
+	}
+	lua_newtable(L);
+	struct vclock_iterator it;
+	vclock_iterator_init(&it, &transport->vclock_token);
+	vclock_foreach(&it, replica) {
+		luaL_pushint64(L, replica.lsn);
+		lua_rawseti(L, -2, replica.id);
+	}
+	return 1;
+}
+
+/**
+ * Opens a batch: requests aren't sent until the batch is closed with
+ * batch_end(), the coalesce size is reached or someone waits for
+ * a response. Batches may be nested.
+ */
+static int
+luaT_netbox_transport_batch_begin(struct lua_State *L)
+{
+	struct netbox_transport *transport = luaT_check_netbox_transport(L, 1);
+	transport->batch_depth++;
+	return 0;
+}
+
+/** Closes a batch opened with batch_begin(). */
+static int
+luaT_netbox_transport_batch_end(struct lua_State *L)
+{
+	struct netbox_transport *transport = luaT_check_netbox_transport(L, 1);
+	assert(transport->batch_depth > 0);
+	if (--transport->batch_depth == 0 &&
+	    ibuf_used(&transport->send_buf) > 0) {
+		transport->need_flush = true;
+		if (transport->worker != NULL)
+			fiber_wakeup(transport->worker);
+	}
+	return 0;
+}
+
 static int
 luaT_netbox_transport_next_sync(struct lua_State *L)
 {
@@ -3269,6 +3621,10 @@ luaopen_net_box(struct lua_State *L)
 			    IPROTO_FEATURE_CALL_RET_TUPLE_EXTENSION);
 	iproto_features_set(&NETBOX_IPROTO_FEATURES,
 			    IPROTO_FEATURE_CALL_ARG_TUPLE_EXTENSION);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_WAIT_VCLOCK);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_COMPRESSION);
 
 	lua_pushcfunction(L, luaT_netbox_request_iterator_next);
 	luaT_netbox_request_iterator_next_ref = luaL_ref(L, LUA_REGISTRYINDEX);
@@ -3278,6 +3634,9 @@ luaopen_net_box(struct lua_State *L)
 		{ "start",          luaT_netbox_transport_start },
 		{ "stop",           luaT_netbox_transport_stop },
 		{ "next_sync",	    luaT_netbox_transport_next_sync },
+		{ "batch_begin",    luaT_netbox_transport_batch_begin },
+		{ "vclock_token",   luaT_netbox_transport_vclock_token },
+		{ "batch_end",      luaT_netbox_transport_batch_end },
 		{ "graceful_shutdown",
 			luaT_netbox_transport_graceful_shutdown },
 		{ "perform_request",
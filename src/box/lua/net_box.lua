@@ -40,6 +40,8 @@ local REQUEST_OPTION_TYPES = {
     skip_header = "boolean",
     timeout     = "number",
     fetch_pos   = "boolean",
+    cursor      = "number",
+    wait_vclock = "table",
     after = function(after)
         if after ~= nil and type(after) ~= "string" and type(after) ~= "table"
                 and not is_tuple(after) then
@@ -64,6 +66,9 @@ local CONNECT_OPTION_TYPES = {
     connect_timeout             = "number",
     fetch_schema                = "boolean",
     auth_type                   = "string",
+    compression                 = "boolean",
+    coalesce_timeout            = "number",
+    coalesce_size               = "number",
     required_protocol_version   = "number",
     required_protocol_features  = "table",
     _disable_graceful_shutdown  = "boolean",
@@ -445,7 +450,8 @@ local function new_sm(uri_or_fd, opts)
     local transport = internal.new_transport(
             uri_or_fd, user, password, weak_callback,
             opts.connect_timeout, opts.reconnect_after,
-            opts.fetch_schema, opts.auth_type)
+            opts.fetch_schema, opts.auth_type, opts.compression,
+            opts.coalesce_timeout, opts.coalesce_size)
     weak_refs.transport = transport
     remote._transport = transport
     remote._gc_hook = ffi.gc(ffi.new('char[1]'), function()
@@ -517,6 +523,25 @@ local function check_eval_args(args)
     end
 end
 
+-- Returns the wait_vclock request option after checking that the server
+-- supports it.
+local function check_wait_vclock(remote, opts)
+    local wait_vclock = opts and opts.wait_vclock
+    if wait_vclock == nil then
+        return nil
+    end
+    if not remote.peer_protocol_features.wait_vclock then
+        box.error(box.error.UNSUPPORTED, "Remote server", "wait_vclock")
+    end
+    for id, lsn in pairs(wait_vclock) do
+        if type(id) ~= 'number' or type(lsn) ~= 'number' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "wait_vclock must map replica ids to LSNs")
+        end
+    end
+    return wait_vclock
+end
+
 local function stream_new_stream(stream)
     check_remote_arg(stream, 'new_stream')
     return stream._conn:new_stream()
@@ -844,6 +869,36 @@ function remote_methods:close()
     self._transport:stop(true)
 end
 
+local function batch_end(transport, ok, ...)
+    transport:batch_end()
+    if not ok then
+        error((...), 0)
+    end
+    return ...
+end
+
+-- Calls the function with the given arguments. Requests issued while
+-- the function is running are queued and sent in one write when
+-- it returns, unless the coalesce size is reached or a response to
+-- a request is awaited earlier.
+function remote_methods:batch(func, ...)
+    check_remote_arg(self, 'batch')
+    if type(func) ~= 'function' then
+        box.error(E_PROC_LUA, 'func must be a function')
+    end
+    self._transport:batch_begin()
+    return batch_end(self._transport, pcall(func, ...))
+end
+
+-- Returns the vclock token of the writes made over this connection: a table
+-- that maps replica ids to LSNs or nil if nothing was written. Pass it in
+-- the wait_vclock option of a read request sent to a replica to make sure
+-- the read sees the writes.
+function remote_methods:vclock_token()
+    check_remote_arg(self, 'vclock_token')
+    return self._transport:vclock_token()
+end
+
 function remote_methods:on_schema_reload(...)
     check_remote_arg(self, 'on_schema_reload')
     return self._on_schema_reload(...)
@@ -966,8 +1021,13 @@ function remote_methods:call(func_name, args, opts)
     check_call_args(args)
     check_param_table(opts, REQUEST_OPTION_TYPES)
     args = args or {}
+    -- A function registered in _func may be called by id.
+    if type(func_name) ~= 'number' then
+        func_name = tostring(func_name)
+    end
+    local wait_vclock = check_wait_vclock(self, opts)
     local res = self:_request('CALL', opts, nil, self._stream_id,
-                              tostring(func_name), args)
+                              func_name, args, wait_vclock)
     if type(res) ~= 'table' or opts and opts.is_async then
         return res
     end
@@ -979,7 +1039,9 @@ function remote_methods:eval(code, args, opts)
     check_eval_args(args)
     check_param_table(opts, REQUEST_OPTION_TYPES)
     args = args or {}
-    local res = self:_request('EVAL', opts, nil, self._stream_id, code, args)
+    local wait_vclock = check_wait_vclock(self, opts)
+    local res = self:_request('EVAL', opts, nil, self._stream_id, code, args,
+                              wait_vclock)
     if type(res) ~= 'table' or opts and opts.is_async then
         return res
     end
@@ -1250,14 +1312,35 @@ index_metatable = function(remote)
             return box.error(box.error.UNSUPPORTED, "Remote server",
                 "pagination")
         end
+        local cursor = opts and opts.cursor
+        if cursor ~= nil then
+            if not remote.peer_protocol_features.cursor then
+                return box.error(box.error.UNSUPPORTED, "Remote server",
+                    "cursors")
+            end
+            if fetch_pos then
+                return box.error(box.error.ILLEGAL_PARAMS,
+                    "options cursor and fetch_pos are mutually exclusive")
+            end
+            if opts.buffer then
+                error("index:select() doesn't support `buffer` argument " ..
+                      "with `cursor`")
+            end
+        end
+
+        local wait_vclock = check_wait_vclock(remote, opts)
 
         local res
         local method = fetch_pos and 'SELECT_WITH_POS' or 'SELECT'
+        if cursor ~= nil then
+            method = 'SELECT_WITH_CURSOR'
+        end
         res = (remote:_request(method, opts, self.space._format_cdata,
                                self._stream_id, self.space._id_or_name,
                                self._id_or_name, iterator, offset, limit, key,
-                               after, fetch_pos))
-        if type(res) ~= 'table' or not fetch_pos or opts and opts.is_async then
+                               after, fetch_pos, cursor, wait_vclock))
+        if type(res) ~= 'table' or not (fetch_pos or cursor ~= nil) or
+                opts and opts.is_async then
             return res
         end
         return unpack(res)
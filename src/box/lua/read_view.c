@@ -0,0 +1,467 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/read_view.h"
+
+#include <lua.h>
+#include <lauxlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "box/error.h"
+#include "box/index.h"
+#include "box/lua/misc.h"
+#include "box/lua/tuple.h"
+#include "box/read_view.h"
+#include "box/space.h"
+#include "box/space_cache.h"
+#include "box/tuple.h"
+#include "box/user_def.h"
+#include "diag.h"
+#include "fiber.h"
+#include "lua/utils.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "small/rlist.h"
+#include "trivia/util.h"
+
+/** Database read view pushed to Lua as userdata. */
+struct lbox_read_view {
+	/** Underlying read view. */
+	struct read_view base;
+	/** Set when the read view is closed. */
+	bool is_closed;
+	/**
+	 * List of open iterators, linked by
+	 * lbox_read_view_iterator::in_read_view. The iterators are
+	 * destroyed when the read view is closed.
+	 */
+	struct rlist iterators;
+};
+
+/** Read view iterator pushed to Lua as userdata. */
+struct lbox_read_view_iterator {
+	/** Underlying index read view iterator. */
+	struct index_read_view_iterator base;
+	/** Space read view the iterator was created for. */
+	struct space_read_view *space_rv;
+	/** Set when the iterator is destroyed along with the read view. */
+	bool is_closed;
+	/** Set when the iterator has returned all tuples. */
+	bool is_exhausted;
+	/** Link in lbox_read_view::iterators. */
+	struct rlist in_read_view;
+};
+
+static const char lbox_read_view_typename[] = "box.read_view";
+static const char lbox_read_view_iterator_typename[] =
+	"box.read_view.iterator";
+
+/** Argument passed to the read view space and index filters. */
+struct lbox_read_view_filter_arg {
+	/** Ids of spaces to include or NULL to include all user spaces. */
+	const uint32_t *space_ids;
+	/** Number of entries in space_ids. */
+	uint32_t space_count;
+};
+
+static bool
+lbox_read_view_filter_space(struct space *space, void *arg_raw)
+{
+	struct lbox_read_view_filter_arg *arg = arg_raw;
+	if (arg->space_ids == NULL) {
+		if (space_is_system(space))
+			return false;
+		if (access_check_space(space, PRIV_R) != 0) {
+			/* Silently skip spaces the user can't read. */
+			diag_clear(diag_get());
+			return false;
+		}
+		return true;
+	}
+	for (uint32_t i = 0; i < arg->space_count; i++) {
+		if (arg->space_ids[i] == space_id(space))
+			return true;
+	}
+	return false;
+}
+
+static bool
+lbox_read_view_filter_index(struct space *space, struct index *index,
+			    void *arg)
+{
+	(void)space;
+	(void)arg;
+	/* Skip indexes that don't support read views, e.g. RTREE. */
+	return index->vtab->create_read_view != generic_index_create_read_view;
+}
+
+static void
+lbox_read_view_iterator_close(struct lbox_read_view_iterator *it)
+{
+	if (it->is_closed)
+		return;
+	it->is_closed = true;
+	rlist_del_entry(it, in_read_view);
+	index_read_view_iterator_destroy(&it->base);
+}
+
+static void
+lbox_read_view_close(struct lbox_read_view *rv)
+{
+	if (rv->is_closed)
+		return;
+	rv->is_closed = true;
+	struct lbox_read_view_iterator *it, *tmp;
+	rlist_foreach_entry_safe(it, &rv->iterators, in_read_view, tmp)
+		lbox_read_view_iterator_close(it);
+	read_view_close(&rv->base);
+}
+
+/**
+ * Returns the read view stored in the Lua stack at the given index.
+ * Raises a Lua error if the read view is closed.
+ */
+static struct lbox_read_view *
+lbox_check_read_view(struct lua_State *L, int idx)
+{
+	struct lbox_read_view *rv =
+		luaL_checkudata(L, idx, lbox_read_view_typename);
+	if (rv->is_closed) {
+		diag_set(ClientError, ER_READ_VIEW_CLOSED);
+		luaT_error(L);
+	}
+	return rv;
+}
+
+/**
+ * Returns the index read view pointer passed as light userdata at the given
+ * index. The pointer is obtained with info() and remains valid until the read
+ * view is closed so the caller must check the read view first.
+ */
+static struct index_read_view *
+lbox_check_index_read_view(struct lua_State *L, int idx)
+{
+	if (lua_type(L, idx) != LUA_TLIGHTUSERDATA)
+		luaL_error(L, "Usage: read_view index expected");
+	return lua_touserdata(L, idx);
+}
+
+/**
+ * Checks the iterator type and the key passed at the given Lua stack indexes.
+ * Only full scans are supported by memtx read views so the iterator type must
+ * be ALL and the key must be empty. On error raises a Lua error.
+ */
+static void
+lbox_read_view_check_iterator(struct lua_State *L, int type_idx, int key_idx)
+{
+	int type = luaL_checkinteger(L, type_idx);
+	bool key_is_empty = true;
+	if (!lua_isnil(L, key_idx)) {
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		size_t key_len;
+		const char *key = lbox_encode_tuple_on_gc(L, key_idx, &key_len);
+		key_is_empty = mp_decode_array(&key) == 0;
+		region_truncate(region, region_svp);
+	}
+	if (type != ITER_ALL || !key_is_empty) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Read view",
+			 "iterator types other than ALL");
+		luaT_error(L);
+	}
+}
+
+/**
+ * Creates a tuple from the data fetched from a read view and pushes it to
+ * the Lua stack.
+ */
+static void
+lbox_read_view_push_tuple(struct lua_State *L,
+			  struct space_read_view *space_rv,
+			  struct read_view_tuple *tuple)
+{
+	struct tuple *result = tuple_new(space_rv->format, tuple->data,
+					 tuple->data + tuple->size);
+	if (result == NULL)
+		luaT_error(L);
+	luaT_pushtuple(L, result);
+}
+
+/**
+ * Opens a read view.
+ *
+ * Takes the read view name and an optional array of space ids to include
+ * into the read view. If the array is omitted, all user spaces the current
+ * user has read access to are included. Returns the read view userdata.
+ */
+static int
+lbox_read_view_open(struct lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct lbox_read_view_filter_arg filter_arg = {
+		.space_ids = NULL,
+		.space_count = 0,
+	};
+	if (!lua_isnoneornil(L, 2)) {
+		luaL_checktype(L, 2, LUA_TTABLE);
+		uint32_t count = lua_objlen(L, 2);
+		size_t size;
+		uint32_t *space_ids = xregion_alloc_array(region, uint32_t,
+							  count, &size);
+		for (uint32_t i = 0; i < count; i++) {
+			lua_rawgeti(L, 2, i + 1);
+			space_ids[i] = luaL_checkinteger(L, -1);
+			lua_pop(L, 1);
+			struct space *space = space_cache_find(space_ids[i]);
+			if (space == NULL ||
+			    access_check_space(space, PRIV_R) != 0) {
+				region_truncate(region, region_svp);
+				return luaT_error(L);
+			}
+		}
+		filter_arg.space_ids = space_ids;
+		filter_arg.space_count = count;
+	}
+	struct lbox_read_view *rv = lua_newuserdata(L, sizeof(*rv));
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = name;
+	opts.filter_space = lbox_read_view_filter_space;
+	opts.filter_index = lbox_read_view_filter_index;
+	opts.filter_arg = &filter_arg;
+	opts.enable_field_names = true;
+	int rc = read_view_open(&rv->base, &opts);
+	region_truncate(region, region_svp);
+	if (rc != 0)
+		return luaT_error(L);
+	rv->is_closed = false;
+	rlist_create(&rv->iterators);
+	luaL_getmetatable(L, lbox_read_view_typename);
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+/**
+ * Closes a read view. All iterators created for the read view are closed,
+ * too. Closing an already closed read view is a no-op. Also used as the
+ * garbage collection callback.
+ */
+static int
+lbox_read_view_close_lua(struct lua_State *L)
+{
+	struct lbox_read_view *rv =
+		luaL_checkudata(L, 1, lbox_read_view_typename);
+	lbox_read_view_close(rv);
+	return 0;
+}
+
+static int
+lbox_read_view_tostring(struct lua_State *L)
+{
+	lua_pushstring(L, lbox_read_view_typename);
+	return 1;
+}
+
+/**
+ * Pushes a table describing the read view to the Lua stack. In addition to
+ * the fields set by lbox_push_read_view(), the table contains an array of
+ * spaces included into the read view:
+ *
+ *   spaces = {
+ *     {id = <number>, name = <string>, indexes = {
+ *       {id = <number>, name = <string>, ptr = <light userdata>}, ...
+ *     }}, ...
+ *   }
+ *
+ * The index pointer is passed to select() and iterator().
+ */
+static int
+lbox_read_view_info(struct lua_State *L)
+{
+	struct lbox_read_view *rv = lbox_check_read_view(L, 1);
+	lbox_push_read_view(L, &rv->base);
+	lua_newtable(L);
+	int space_count = 0;
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, &rv->base) {
+		lua_newtable(L);
+		lua_pushinteger(L, space_rv->id);
+		lua_setfield(L, -2, "id");
+		lua_pushstring(L, space_rv->name);
+		lua_setfield(L, -2, "name");
+		lua_newtable(L);
+		int index_count = 0;
+		for (uint32_t i = 0; i <= space_rv->index_id_max; i++) {
+			struct index_read_view *index_rv =
+				space_read_view_index(space_rv, i);
+			if (index_rv == NULL)
+				continue;
+			lua_newtable(L);
+			lua_pushinteger(L, index_rv->def->iid);
+			lua_setfield(L, -2, "id");
+			lua_pushstring(L, index_rv->def->name);
+			lua_setfield(L, -2, "name");
+			lua_pushlightuserdata(L, index_rv);
+			lua_setfield(L, -2, "ptr");
+			lua_rawseti(L, -2, ++index_count);
+		}
+		lua_setfield(L, -2, "indexes");
+		lua_rawseti(L, -2, ++space_count);
+	}
+	lua_setfield(L, -2, "spaces");
+	return 1;
+}
+
+/**
+ * Selects tuples from an index of a read view.
+ * Takes the read view, the index pointer, the iterator type, the key,
+ * the limit, and the offset. Returns an array of tuples.
+ */
+static int
+lbox_read_view_select(struct lua_State *L)
+{
+	lbox_check_read_view(L, 1);
+	struct index_read_view *index_rv = lbox_check_index_read_view(L, 2);
+	lbox_read_view_check_iterator(L, 3, 4);
+	uint32_t limit = luaL_checkinteger(L, 5);
+	uint32_t offset = luaL_checkinteger(L, 6);
+	struct index_read_view_iterator it;
+	if (index_read_view_create_iterator(index_rv, ITER_ALL, NULL, 0,
+					    &it) != 0)
+		return luaT_error(L);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	lua_newtable(L);
+	uint32_t count = 0;
+	while (count < limit) {
+		struct read_view_tuple tuple;
+		if (index_read_view_iterator_next_raw(&it, &tuple) != 0) {
+			index_read_view_iterator_destroy(&it);
+			region_truncate(region, region_svp);
+			return luaT_error(L);
+		}
+		if (tuple.data == NULL)
+			break;
+		if (offset > 0) {
+			offset--;
+		} else {
+			lbox_read_view_push_tuple(L, index_rv->space, &tuple);
+			lua_rawseti(L, -2, ++count);
+		}
+		region_truncate(region, region_svp);
+	}
+	index_read_view_iterator_destroy(&it);
+	return 1;
+}
+
+/**
+ * Creates an iterator over an index of a read view.
+ * Takes the read view, the index pointer, the iterator type, and the key.
+ * Returns the iterator userdata that should be passed to iterator_next().
+ */
+static int
+lbox_read_view_iterator(struct lua_State *L)
+{
+	struct lbox_read_view *rv = lbox_check_read_view(L, 1);
+	struct index_read_view *index_rv = lbox_check_index_read_view(L, 2);
+	lbox_read_view_check_iterator(L, 3, 4);
+	struct lbox_read_view_iterator *it = lua_newuserdata(L, sizeof(*it));
+	if (index_read_view_create_iterator(index_rv, ITER_ALL, NULL, 0,
+					    &it->base) != 0)
+		return luaT_error(L);
+	it->space_rv = index_rv->space;
+	it->is_closed = false;
+	it->is_exhausted = false;
+	rlist_add_entry(&rv->iterators, it, in_read_view);
+	luaL_getmetatable(L, lbox_read_view_iterator_typename);
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+/**
+ * Returns the next tuple from a read view iterator or nil if the iterator
+ * is exhausted. Raises an error if the read view was closed.
+ */
+static int
+lbox_read_view_iterator_next(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *it =
+		luaL_checkudata(L, 1, lbox_read_view_iterator_typename);
+	if (it->is_closed) {
+		diag_set(ClientError, ER_READ_VIEW_CLOSED);
+		return luaT_error(L);
+	}
+	if (it->is_exhausted) {
+		lua_pushnil(L);
+		return 1;
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct read_view_tuple tuple;
+	if (index_read_view_iterator_next_raw(&it->base, &tuple) != 0) {
+		region_truncate(region, region_svp);
+		return luaT_error(L);
+	}
+	if (tuple.data == NULL) {
+		it->is_exhausted = true;
+		lua_pushnil(L);
+	} else {
+		lbox_read_view_push_tuple(L, it->space_rv, &tuple);
+	}
+	region_truncate(region, region_svp);
+	return 1;
+}
+
+static int
+lbox_read_view_iterator_gc(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *it =
+		luaL_checkudata(L, 1, lbox_read_view_iterator_typename);
+	lbox_read_view_iterator_close(it);
+	return 0;
+}
+
+static int
+lbox_read_view_iterator_tostring(struct lua_State *L)
+{
+	lua_pushstring(L, lbox_read_view_iterator_typename);
+	return 1;
+}
+
+void
+box_lua_read_view_init(struct lua_State *L)
+{
+	static const struct luaL_Reg lbox_read_view_meta[] = {
+		{"__gc", lbox_read_view_close_lua},
+		{"__tostring", lbox_read_view_tostring},
+		{NULL, NULL},
+	};
+	luaL_register_type(L, lbox_read_view_typename, lbox_read_view_meta);
+
+	static const struct luaL_Reg lbox_read_view_iterator_meta[] = {
+		{"__gc", lbox_read_view_iterator_gc},
+		{"__tostring", lbox_read_view_iterator_tostring},
+		{NULL, NULL},
+	};
+	luaL_register_type(L, lbox_read_view_iterator_typename,
+			   lbox_read_view_iterator_meta);
+
+	static const struct luaL_Reg read_view_internal_lib[] = {
+		{"open", lbox_read_view_open},
+		{"close", lbox_read_view_close_lua},
+		{"info", lbox_read_view_info},
+		{"select", lbox_read_view_select},
+		{"iterator", lbox_read_view_iterator},
+		{"iterator_next", lbox_read_view_iterator_next},
+		{NULL, NULL},
+	};
+	luaL_findtable(L, LUA_GLOBALSINDEX, "box.internal.read_view", 0);
+	luaL_setfuncs(L, read_view_internal_lib, 0);
+	lua_pop(L, 1);
+}
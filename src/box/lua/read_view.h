@@ -11,14 +11,25 @@
 #include "lua/read_view_impl.h"
 #else /* !defined(ENABLE_READ_VIEW) */
 
-#define READ_VIEW_BOX_LUA_MODULES
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+extern char read_view_lua[];
+
+#define READ_VIEW_BOX_LUA_MODULES "box/read_view", NULL, read_view_lua,
 
 struct lua_State;
 
-static inline void
-box_lua_read_view_init(struct lua_State *L)
-{
-	(void)L;
-}
+/**
+ * Initializes box.internal.read_view. Only full scans of memtx indexes are
+ * supported by the community read view implementation.
+ */
+void
+box_lua_read_view_init(struct lua_State *L);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
 
 #endif /* !defined(ENABLE_READ_VIEW) */
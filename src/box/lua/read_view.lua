@@ -0,0 +1,166 @@
+-- read_view.lua (internal file)
+--
+-- Community implementation of box.read_view.open(). Only full scans of memtx
+-- indexes are supported.
+
+local utils = require('internal.utils')
+
+local internal = box.internal.read_view
+local check_pairs_opts = box.internal.check_pairs_opts
+local check_select_opts = box.internal.check_select_opts
+
+--
+-- Read view object -> read view handle (userdata returned by internal.open).
+--
+-- We use weak keys, because we don't want to pin a read view after the user
+-- drops the last reference to the read view object. The read view is closed
+-- when the handle is garbage collected.
+--
+local read_view_handles = setmetatable({}, {__mode = 'k'})
+
+local index_methods = {}
+local index_mt = {
+    __index = index_methods,
+    __serialize = function(self)
+        return {id = self.id, name = self.name}
+    end,
+}
+
+local space_methods = {}
+local space_mt = {
+    __index = space_methods,
+    __serialize = function(self)
+        return {id = self.id, name = self.name}
+    end,
+}
+
+local function check_index_arg(index, method, level)
+    if type(index) ~= 'table' or getmetatable(index) ~= index_mt then
+        local fmt = 'Use index:%s(...) instead of index.%s(...)'
+        box.error(box.error.ILLEGAL_PARAMS, string.format(fmt, method, method),
+                  level + 1)
+    end
+end
+
+local function check_space_arg(space, method, level)
+    if type(space) ~= 'table' or getmetatable(space) ~= space_mt then
+        local fmt = 'Use space:%s(...) instead of space.%s(...)'
+        box.error(box.error.ILLEGAL_PARAMS, string.format(fmt, method, method),
+                  level + 1)
+    end
+end
+
+local function check_primary_index(space, level)
+    local pk = space.index[0]
+    if pk == nil then
+        box.error(box.error.NO_SUCH_INDEX_ID, 0, space.name, level + 1)
+    end
+    return pk
+end
+
+local function key_is_nil(key)
+    return key == nil or (type(key) == 'table' and #key == 0)
+end
+
+local function iterator_gen(param, state) -- luacheck: no unused args
+    local tuple = internal.iterator_next(state)
+    if tuple ~= nil then
+        return state, tuple
+    end
+    return nil
+end
+
+local function index_select(index, key, opts, level)
+    local iterator, offset, limit = check_select_opts(opts, key_is_nil(key),
+                                                      level + 1)
+    return internal.select(read_view_handles[index.read_view], index.ptr,
+                           iterator, key, limit, offset)
+end
+
+local function index_pairs(index, key, opts, level)
+    local iterator = check_pairs_opts(opts, key_is_nil(key), level + 1)
+    local handle = read_view_handles[index.read_view]
+    local it = internal.iterator(handle, index.ptr, iterator, key)
+    -- Pass the read view handle as the iterator parameter so that it isn't
+    -- garbage collected while the iterator is in use.
+    return iterator_gen, handle, it
+end
+
+function index_methods:select(key, opts)
+    check_index_arg(self, 'select', 2)
+    return index_select(self, key, opts, 2)
+end
+
+function index_methods:pairs(key, opts)
+    check_index_arg(self, 'pairs', 2)
+    return index_pairs(self, key, opts, 2)
+end
+
+function space_methods:select(key, opts)
+    check_space_arg(self, 'select', 2)
+    return index_select(check_primary_index(self, 2), key, opts, 2)
+end
+
+function space_methods:pairs(key, opts)
+    check_space_arg(self, 'pairs', 2)
+    return index_pairs(check_primary_index(self, 2), key, opts, 2)
+end
+
+--
+-- Read views opened with box.read_view.open() are closed by closing their
+-- handles. System read views can't be closed by the user.
+--
+local read_view_close = box.internal.read_view_close
+function box.internal.read_view_close(rv, level)
+    local handle = read_view_handles[rv]
+    if handle == nil then
+        return read_view_close(rv, level + 1)
+    end
+    internal.close(handle)
+end
+
+--
+-- Opens a read view of the given spaces (all user spaces by default).
+--
+function box.read_view.open(opts)
+    utils.check_param_table(opts, {name = 'string', spaces = 'table'}, 2)
+    opts = opts or {}
+    local space_ids
+    if opts.spaces ~= nil then
+        space_ids = {}
+        for _, space in ipairs(opts.spaces) do
+            local s = box.space[space]
+            if s == nil then
+                box.error(box.error.NO_SUCH_SPACE, tostring(space), 2)
+            end
+            table.insert(space_ids, s.id)
+        end
+    end
+    local handle = internal.open(opts.name or 'unknown', space_ids)
+    local info = internal.info(handle)
+    local spaces = info.spaces
+    info.spaces = nil
+    local rv = info
+    rv.space = {}
+    for _, space_info in ipairs(spaces) do
+        local space = setmetatable({
+            id = space_info.id,
+            name = space_info.name,
+            index = {},
+        }, space_mt)
+        for _, index_info in ipairs(space_info.indexes) do
+            local index = setmetatable({
+                id = index_info.id,
+                name = index_info.name,
+                read_view = rv,
+                ptr = index_info.ptr,
+            }, index_mt)
+            space.index[index.id] = index
+            space.index[index.name] = index
+        end
+        rv.space[space.id] = space
+        rv.space[space.name] = space
+    end
+    read_view_handles[rv] = handle
+    return box.internal.read_view_register(rv)
+end
@@ -2,6 +2,7 @@
 --
 local ffi = require('ffi')
 local msgpack = require('msgpack')
+local msgpackffi = require('msgpackffi')
 local fun = require('fun')
 local log = require('log')
 local buffer = require('buffer')
@@ -30,6 +31,7 @@ local builtin = ffi.C
 
 -- performance fixup for hot functions
 local tuple_encode = box.internal.tuple.encode
+local encode_array = msgpackffi.internal.encode_array
 local tuple_bless = box.internal.tuple.bless
 local is_tuple = box.tuple.is
 assert(tuple_encode ~= nil and tuple_bless ~= nil and is_tuple ~= nil)
@@ -68,6 +70,10 @@ ffi.cdef[[
     box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
                   const char *key_end, box_tuple_t **result);
     int
+    box_index_get_batch(uint32_t space_id, uint32_t index_id,
+                        const char *keys, const char *keys_end,
+                        box_tuple_t **results);
+    int
     box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
                   const char *key_end, box_tuple_t **result);
     int
@@ -76,6 +82,10 @@ ffi.cdef[[
     ssize_t
     box_index_count(uint32_t space_id, uint32_t index_id, int type,
                     const char *key, const char *key_end);
+    ssize_t
+    box_index_approximate_count(uint32_t space_id, uint32_t index_id,
+                                int type, const char *key,
+                                const char *key_end);
     size_t
     box_region_used(void);
     void
@@ -92,6 +102,8 @@ ffi.cdef[[
     box_txn_set_timeout(double timeout);
     void
     box_txn_make_sync();
+    int
+    box_txn_make_read_only();
     void
     memtx_tx_story_gc_step();
     int
@@ -171,8 +183,8 @@ ffi.cdef[[
     box_select_ffi(uint32_t space_id, uint32_t index_id, const char *key,
                    const char *key_end, const char **packed_pos,
                    const char **packed_pos_end, bool update_pos,
-                   struct port *port, int64_t iterator, uint64_t offset,
-                   uint64_t limit);
+                   bool covering, struct port *port, int64_t iterator,
+                   uint64_t offset, uint64_t limit);
 
     enum priv_type {
         PRIV_R = 1,
@@ -352,18 +364,27 @@ local begin_options = {
         end
         return true
     end,
+    read_only = function(read_only, level)
+        if type(read_only) ~= "boolean" then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "read_only must be a boolean", level + 1)
+        end
+        return true
+    end,
 }
 
 box.begin = function(options)
     local timeout
     local txn_isolation
     local is_sync
+    local read_only
     check_param_table(options, begin_options, 2)
     if options then
         timeout = options.timeout
         txn_isolation = options.txn_isolation and
                         normalize_txn_isolation_level(options.txn_isolation)
         is_sync = options.is_sync
+        read_only = options.read_only
     end
     if builtin.box_txn_begin() == -1 then
         box.error(box.error.last(), 2)
@@ -379,6 +400,10 @@ box.begin = function(options)
     if is_sync then
         builtin.box_txn_make_sync()
     end
+    if read_only and builtin.box_txn_make_read_only() ~= 0 then
+        box.rollback()
+        box.error(box.error.last(), 2)
+    end
 end
 
 box.is_in_txn = builtin.box_txn
@@ -835,6 +860,8 @@ box.schema.space.create = function(name, options)
         temporary = 'boolean',
         is_sync = 'boolean',
         defer_deletes = 'boolean',
+        iproto_read_view = 'boolean',
+        wal_coalesce = 'boolean',
         constraint = 'string, table',
         foreign_key = 'table',
     }
@@ -887,6 +914,8 @@ box.schema.space.create = function(name, options)
         type = options.type,
         is_sync = options.is_sync,
         defer_deletes = options.defer_deletes and true or nil,
+        iproto_read_view = options.iproto_read_view and true or nil,
+        wal_coalesce = options.wal_coalesce and true or nil,
         constraint = constraint,
         foreign_key = foreign_key,
     })
@@ -997,6 +1026,8 @@ local alter_space_template = {
     temporary = 'boolean',
     is_sync = 'boolean',
     defer_deletes = 'boolean',
+    iproto_read_view = 'boolean',
+    wal_coalesce = 'boolean',
     name = 'string',
     constraint = 'string, table',
     foreign_key = 'table',
@@ -1045,6 +1076,14 @@ box.schema.space.alter = function(space_id, options)
         flags.defer_deletes = options.defer_deletes
     end
 
+    if options.iproto_read_view ~= nil then
+        flags.iproto_read_view = options.iproto_read_view
+    end
+
+    if options.wal_coalesce ~= nil then
+        flags.wal_coalesce = options.wal_coalesce
+    end
+
     local format
     if options.format ~= nil then
         format = normalize_format(space_id, tuple.name, options.format, 2)
@@ -1540,8 +1579,16 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    bloom_partitioned = 'boolean',
+    bloom_type = 'string',
+    compaction_strategy = 'string',
+    ttl_field = 'number',
+    parallel_compaction = 'boolean',
+    hash_func = 'string',
+    bucket_count = 'number',
     func = 'number, string',
     hint = 'boolean',
+    filter = 'table',
 }
 
 local function jsonpaths_from_idx_parts(parts)
@@ -1575,6 +1622,7 @@ local alter_index_template = {
     name = 'string',
     type = 'string',
     parts = 'table',
+    include = 'table',
     sequence = 'boolean, number, string, table',
 }
 for k, v in pairs(index_options) do
@@ -1598,6 +1646,25 @@ local function func_id_by_name(func_name, level)
 end
 box.internal.func_id_by_name = func_id_by_name -- for space.upgrade
 
+--
+-- Convert a partial index filter to the form stored in _index:
+-- {field = <1-based field number>, value = <scalar>}.
+--
+local function update_index_filter(format, filter, level)
+    if type(filter.field) ~= 'number' and type(filter.field) ~= 'string' then
+        box.error(box.error.ILLEGAL_PARAMS, "options.filter.field: " ..
+                  "expected field name or number", level + 1)
+    end
+    local fieldno, path = format_field_resolve(format, filter.field,
+                                               'options.filter.field',
+                                               level + 1)
+    if path ~= nil then
+        box.error(box.error.ILLEGAL_PARAMS, "options.filter.field: " ..
+                  "JSON paths are not supported", level + 1)
+    end
+    return {field = fieldno + 1, value = filter.value}
+end
+
 box.schema.index.create = atomic_wrapper(function(space_id, name, options)
     check_param(space_id, 'space_id', 'number', 2)
     check_param(name, 'name', 'string', 2)
@@ -1682,9 +1749,25 @@ box.schema.index.create = atomic_wrapper(function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            bloom_partitioned = options.bloom_partitioned,
+            bloom_type = options.bloom_type,
+            compaction_strategy = options.compaction_strategy,
+            ttl_field = options.ttl_field,
+            parallel_compaction = options.parallel_compaction,
             func = options.func,
             hint = options.hint,
+            hash_func = options.hash_func,
+            bucket_count = options.bucket_count,
+            filter = options.filter,
     }
+    -- Included fields are stored as trailing key parts.
+    if options.include ~= nil and #options.include > 0 then
+        local include_parts = update_index_parts(format, options.include, 2)
+        for _, part in ipairs(include_parts) do
+            table.insert(parts, part)
+        end
+        index_opts.include_part_count = #include_parts
+    end
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
         uint = 'unsigned';
@@ -1709,6 +1792,9 @@ box.schema.index.create = atomic_wrapper(function(space_id, name, options)
     if index_opts.func ~= nil and type(index_opts.func) == 'string' then
         index_opts.func = func_id_by_name(index_opts.func, 2)
     end
+    if index_opts.filter ~= nil then
+        index_opts.filter = update_index_filter(format, index_opts.filter, 2)
+    end
     local sequence_proxy = space_sequence_alter_prepare(format, parts, options,
                                                         space_id, iid,
                                                         space.name, name, 2)
@@ -1838,10 +1924,44 @@ box.schema.index.alter = atomic_wrapper(function(space_id, index_id, options)
         box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
                   space.name, "functional index can't use hints", 2)
     end
-    if options.parts then
-        parts = update_index_parts(format, options.parts, 2)
+    if options.parts or options.include then
+        -- Included fields are stored as trailing key parts,
+        -- keep them unless they are redefined and vice versa.
+        local include_count = index_opts.include_part_count or 0
+        local old_parts = {}
+        for _, part in ipairs(parts) do
+            if part[1] ~= nil then
+                -- old format
+                part = {field = part[1], type = part[2]}
+            end
+            table.insert(old_parts, part)
+        end
+        local key_count = #old_parts - include_count
+        local new_parts = {}
+        if options.parts then
+            new_parts = update_index_parts(format, options.parts, 2)
+        else
+            for i = 1, key_count do
+                table.insert(new_parts, old_parts[i])
+            end
+        end
+        local include_parts = {}
+        if options.include then
+            if #options.include > 0 then
+                include_parts = update_index_parts(format, options.include, 2)
+            end
+        else
+            for i = key_count + 1, #old_parts do
+                table.insert(include_parts, old_parts[i])
+            end
+        end
+        for _, part in ipairs(include_parts) do
+            table.insert(new_parts, part)
+        end
+        index_opts.include_part_count = #include_parts > 0 and
+                                        #include_parts or nil
         -- save parts in old format if possible
-        parts = try_simplify_index_parts(parts)
+        parts = try_simplify_index_parts(new_parts)
     end
     if options.hint and is_multikey_index(parts) then
         box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
@@ -1850,6 +1970,9 @@ box.schema.index.alter = atomic_wrapper(function(space_id, index_id, options)
     if index_opts.func ~= nil and type(index_opts.func) == 'string' then
         index_opts.func = func_id_by_name(index_opts.func, 2)
     end
+    if options.filter ~= nil then
+        index_opts.filter = update_index_filter(format, options.filter, 2)
+    end
     local sequence_proxy = space_sequence_alter_prepare(format, parts, options,
                                                         space_id, index_id,
                                                         space.name,
@@ -1866,6 +1989,10 @@ end)
 -- a static box_tuple_t ** instance for calling box_index_* API
 local ptuple = ffi.new('box_tuple_t *[1]')
 
+-- Preallocated result array of get_many(), grown on demand.
+local get_many_results_size = 64
+local get_many_results = ffi.new('box_tuple_t *[?]', get_many_results_size)
+
 local function keify(key)
     if key == nil then
         return {}
@@ -1928,6 +2055,29 @@ local iterator_gen = function(param, state) -- luacheck: no unused args
     end
 end
 
+-- Max number of tuples returned by iterator:next_batch() in one call.
+local ITERATOR_BATCH_MAX = 1024 * 1024
+
+--[[
+    Fetch up to *count* next tuples of an index:pairs() iterator in one
+    call. Returns an array of tuples, which is shorter than *count* or
+    empty if the iterator is exhausted. Crossing the Lua/C boundary once
+    per batch is cheaper than once per tuple for long scans.
+--]]
+local function iterator_next_batch(it, count)
+    if type(it) ~= 'table' or not ffi.istype(iterator_t, it.state) then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  'Usage: iterator:next_batch(count)', 2)
+    end
+    if type(count) ~= 'number' or count <= 0 or count > ITERATOR_BATCH_MAX or
+       math.floor(count) ~= count then
+        box.error(box.error.ILLEGAL_PARAMS, string.format(
+                  'count must be an integer from 1 to %d', ITERATOR_BATCH_MAX),
+                  2)
+    end
+    return internal.iterator_next_batch(it.state, count, 2)
+end
+
 -- global struct port instance to use by select()/get()
 local port = ffi.new('struct port')
 local port_c = ffi.cast('struct port_c *', port)
@@ -2454,8 +2604,10 @@ base_index_mt.pairs_ffi = function(index, key, opts)
     if cdata == nil then
         box.error(box.error.last(), 2)
     end
-    return fun.wrap(iterator_gen, keybuf,
+    local it = fun.wrap(iterator_gen, keybuf,
         ffi.gc(cdata, builtin.box_iterator_free))
+    it.next_batch = iterator_next_batch
+    return it
 end
 base_index_mt.pairs_luac = function(index, key, opts)
     check_index_arg(index, 'pairs', 2)
@@ -2465,8 +2617,10 @@ base_index_mt.pairs_luac = function(index, key, opts)
     local keybuf = ffi.string(keymp, #keymp)
     local cdata = internal.iterator(index.space_id, index.id, itype, keymp,
         after, 2);
-    return fun.wrap(iterator_gen_luac, keybuf,
+    local it = fun.wrap(iterator_gen_luac, keybuf,
         ffi.gc(cdata, builtin.box_iterator_free))
+    it.next_batch = iterator_next_batch
+    return it
 end
 
 -- index subtree size
@@ -2475,8 +2629,11 @@ base_index_mt.count_ffi = function(index, key, opts)
     local ibuf = cord_ibuf_take()
     local pkey, pkey_end = tuple_encode(ibuf, key, 2)
     local itype = check_iterator_type(opts, pkey + 1 >= pkey_end, 2);
-    local count = builtin.box_index_count(index.space_id, index.id,
-        itype, pkey, pkey_end);
+    local count_func = builtin.box_index_count
+    if type(opts) == 'table' and opts.approximate then
+        count_func = builtin.box_index_approximate_count
+    end
+    local count = count_func(index.space_id, index.id, itype, pkey, pkey_end)
     cord_ibuf_put(ibuf)
     if count == -1 then
         box.error(box.error.last(), 2)
@@ -2487,7 +2644,53 @@ base_index_mt.count_luac = function(index, key, opts)
     check_index_arg(index, 'count', 2)
     key = keify(key)
     local itype = check_iterator_type(opts, #key == 0, 2);
-    return internal.count(index.space_id, index.id, itype, key);
+    local approximate = type(opts) == 'table' and opts.approximate == true
+    return internal.count(index.space_id, index.id, itype, key, approximate)
+end
+
+--[[
+    Compute aggregates over tuples matching *key* without creating a Lua
+    object per tuple. The array part of *opts* lists aggregates each of
+    which is either 'count' or {function, field}, where the function is
+    one of 'count', 'sum', 'min', 'max' and the field is a field number
+    or name. The group_by option groups tuples by the given number of
+    the index key parts. Returns an array of rows, one per group or just
+    one if group_by isn't set. A row holds group key parts followed by
+    aggregate values.
+--]]
+base_index_mt.aggregate = function(index, key, opts)
+    check_index_arg(index, 'aggregate', 2)
+    if type(opts) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: index:aggregate(key, {aggregate, ...})", 2)
+    end
+    key = keify(key)
+    local itype = check_iterator_type(opts, #key == 0, 2)
+    return internal.aggregate(index.space_id, index.id, itype, key, opts)
+end
+
+--[[
+    Export tuples matching *key* as a single MsgPack array encoded in a
+    Lua string, without creating Lua objects for them. The *opts* may
+    contain the iterator type and the maximal tuple count (limit). The
+    result may be passed to space:insert_batch() or space:replace_batch(),
+    locally or on another instance, to move data in bulk, e.g. all tuples
+    of a bucket found by a bucket_id index.
+--]]
+base_index_mt.export = function(index, key, opts)
+    check_index_arg(index, 'export', 2)
+    key = keify(key)
+    local itype = check_iterator_type(opts, #key == 0, 2)
+    local limit = 0xffffffff
+    if type(opts) == 'table' and opts.limit ~= nil then
+        limit = opts.limit
+        if type(limit) ~= 'number' or limit < 0 or limit > 0xffffffff or
+           math.floor(limit) ~= limit then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      'limit must be a non-negative integer', 2)
+        end
+    end
+    return internal.export(index.space_id, index.id, itype, key, limit)
 end
 
 base_index_mt.get_ffi = function(index, key)
@@ -2513,6 +2716,60 @@ base_index_mt.get_luac = function(index, key)
     key = keify(key)
     return internal.get(index.space_id, index.id, key)
 end
+base_index_mt.get_many_ffi = function(index, keys)
+    if builtin.box_read_ffi_is_disabled then
+        return base_index_mt.get_many_luac(index, keys)
+    end
+    check_index_arg(index, 'get_many', 2)
+    if type(keys) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  'Usage: index:get_many({key1, key2, ...})', 2)
+    end
+    local key_count = 0
+    for i in ipairs(keys) do
+        key_count = i
+    end
+    if key_count > get_many_results_size then
+        get_many_results_size = key_count
+        get_many_results = ffi.new('box_tuple_t *[?]', key_count)
+    end
+    local results = get_many_results
+    local ibuf = cord_ibuf_take()
+    encode_array(ibuf, key_count)
+    for i = 1, key_count do
+        -- Appends the key to the buffer.
+        tuple_encode(ibuf, keys[i], 2)
+    end
+    local nok = builtin.box_index_get_batch(index.space_id, index.id,
+                                            ibuf.rpos, ibuf.wpos,
+                                            results) ~= 0
+    cord_ibuf_put(ibuf)
+    if nok then
+        box.error(box.error.last(), 2)
+    end
+    local ret = {}
+    for i = 1, key_count do
+        local tuple = results[i - 1]
+        if tuple ~= nil then
+            ret[i] = tuple_bless(tuple)
+            -- Drop the reference taken by box_index_get_batch().
+            builtin.box_tuple_unref(tuple)
+        end
+    end
+    return ret
+end
+base_index_mt.get_many_luac = function(index, keys)
+    check_index_arg(index, 'get_many', 2)
+    if type(keys) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  'Usage: index:get_many({key1, key2, ...})', 2)
+    end
+    local k = {}
+    for i, key in ipairs(keys) do
+        k[i] = keify(key)
+    end
+    return internal.get_many(index.space_id, index.id, k)
+end
 
 local function check_select_opts(opts, key_is_nil, level)
     local offset = 0
@@ -2522,6 +2779,7 @@ local function check_select_opts(opts, key_is_nil, level)
     local fullscan = false
     local after = nil
     local fetch_pos = false
+    local covering = false
     if opts ~= nil and type(opts) == "table" then
         if opts.offset ~= nil then
             offset = opts.offset
@@ -2542,8 +2800,11 @@ local function check_select_opts(opts, key_is_nil, level)
         if opts.fetch_pos ~= nil then
             fetch_pos = opts.fetch_pos
         end
+        if opts.covering ~= nil then
+            covering = opts.covering
+        end
     end
-    return iterator, offset, limit, fullscan, after, fetch_pos
+    return iterator, offset, limit, fullscan, after, fetch_pos, covering
 end
 
 box.internal.check_select_opts = check_select_opts -- for net.box
@@ -2575,7 +2836,7 @@ base_index_mt.select_ffi = function(index, key, opts)
     local key, key_end = tuple_encode(ibuf, key, 2)
     local key_is_nil = key + 1 >= key_end
     local new_position = nil
-    local iterator, offset, limit, fullscan, after, fetch_pos =
+    local iterator, offset, limit, fullscan, after, fetch_pos, covering =
         check_select_opts(opts, key_is_nil, 2)
     local sid = index.space_id
     if is_select_long(sid, key_is_nil, iterator, limit, offset,
@@ -2587,7 +2848,8 @@ base_index_mt.select_ffi = function(index, key, opts)
     if not nok then
         nok = builtin.box_select_ffi(sid, index.id, key, key_end,
                                      iterator_pos, iterator_pos_end, fetch_pos,
-                                     port, iterator, offset, limit) ~= 0
+                                     covering, port, iterator, offset,
+                                     limit) ~= 0
     end
     if not nok and fetch_pos and iterator_pos[0] ~= nil then
         new_position = ffi.string(iterator_pos[0],
@@ -2616,7 +2878,7 @@ base_index_mt.select_luac = function(index, key, opts)
     check_index_arg(index, 'select', 2)
     local key = keify(key)
     local key_is_nil = #key == 0
-    local iterator, offset, limit, fullscan, after, fetch_pos =
+    local iterator, offset, limit, fullscan, after, fetch_pos, covering =
         check_select_opts(opts, key_is_nil, 2)
     local sid = index.space_id
     if is_select_long(sid, key_is_nil, iterator, limit, offset,
@@ -2624,7 +2886,7 @@ base_index_mt.select_luac = function(index, key, opts)
         log_long_select(box.space[sid])
     end
     return internal.select(sid, index.id, iterator,
-        offset, limit, key, after, fetch_pos)
+        offset, limit, key, after, fetch_pos, covering == true)
 end
 
 base_index_mt.update = function(index, key, ops)
@@ -2677,7 +2939,8 @@ base_index_mt.tuple_pos = function(index, tuple)
     return ret
 end
 
-local read_ops = {'select', 'get', 'min', 'max', 'count', 'random', 'pairs'}
+local read_ops = {'select', 'get', 'get_many', 'min', 'max', 'count', 'random',
+                  'pairs'}
 for _, op in ipairs(read_ops) do
     vinyl_index_mt[op] = base_index_mt[op..'_luac']
     memtx_index_mt[op] = base_index_mt[op..'_ffi']
@@ -2705,6 +2968,14 @@ space_mt.count = function(space, key, opts)
     end
     return pk:count(key, opts)
 end
+space_mt.aggregate = function(space, key, opts)
+    check_space_arg(space, 'aggregate', 2)
+    return check_primary_index(space, 2):aggregate(key, opts)
+end
+space_mt.export = function(space, key, opts)
+    check_space_arg(space, 'export', 2)
+    return check_primary_index(space, 2):export(key, opts)
+end
 space_mt.bsize = function(space)
     check_space_arg(space, 'bsize', 2)
     local s = builtin.space_by_id(space.id)
@@ -2718,6 +2989,10 @@ space_mt.get = function(space, key)
     check_space_arg(space, 'get', 2)
     return check_primary_index(space, 2):get(key)
 end
+space_mt.get_many = function(space, keys)
+    check_space_arg(space, 'get_many', 2)
+    return check_primary_index(space, 2):get_many(keys)
+end
 space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select', 2)
     return check_primary_index(space, 2):select(key, opts)
@@ -2743,6 +3018,123 @@ space_mt.replace = function(space, tuple)
     return internal.replace(space.id, tuple);
 end
 space_mt.put = space_mt.replace; -- put is an alias for replace
+--[[
+    Insert or replace tuples given in a MsgPack array: a msgpack object,
+    a Lua string or a 'char *' pointer with the data size (e.g. the read
+    position and the size of a buffer.ibuf). The tuples are written in
+    one transaction without creating Lua objects for them. Returns the
+    number of written tuples.
+--]]
+space_mt.insert_batch = function(space, data, size)
+    check_space_arg(space, 'insert_batch', 2)
+    return internal.insert_batch(space.id, data, size)
+end
+space_mt.replace_batch = function(space, data, size)
+    check_space_arg(space, 'replace_batch', 2)
+    return internal.replace_batch(space.id, data, size)
+end
+-- Same as insert_batch(), but the array holds {tuple, operations} pairs,
+-- which are applied as space:upsert(tuple, operations).
+space_mt.upsert_batch = function(space, data, size)
+    check_space_arg(space, 'upsert_batch', 2)
+    return internal.upsert_batch(space.id, data, size)
+end
+-- Functions converting a CSV field to a value of a field type.
+local load_csv_converters = {
+    unsigned = tonumber64,
+    integer = tonumber64,
+    number = tonumber,
+    double = tonumber,
+    boolean = function(str)
+        if str == 'true' then
+            return true
+        elseif str == 'false' then
+            return false
+        end
+    end,
+}
+
+--[[
+    Load a CSV file into the space. Fields are converted according to
+    the space format, empty fields become nulls if the field is nullable.
+    Rows are written in batches of opts.batch_size (default 1000) with
+    space:insert_batch() or, if opts.mode is 'replace', with
+    space:replace_batch(), each batch is a separate transaction.
+    opts.delimiter, opts.quote_char and opts.skip_head_lines are passed
+    to csv.iterate(). Returns the number of loaded rows.
+--]]
+space_mt.load_csv = function(space, path, opts)
+    check_space_arg(space, 'load_csv', 2)
+    if type(path) ~= 'string' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  'Usage: space:load_csv(path[, opts])', 2)
+    end
+    opts = opts or {}
+    local batch_size = opts.batch_size or 1000
+    if type(batch_size) ~= 'number' or batch_size < 1 or
+       math.floor(batch_size) ~= batch_size then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  'batch_size must be a positive integer', 2)
+    end
+    local write_batch
+    if opts.mode == nil or opts.mode == 'insert' then
+        write_batch = internal.insert_batch
+    elseif opts.mode == 'replace' then
+        write_batch = internal.replace_batch
+    else
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "mode must be 'insert' or 'replace'", 2)
+    end
+    local convert = {}
+    for fieldno, field in ipairs(space:format()) do
+        convert[fieldno] = {
+            func = load_csv_converters[field.type],
+            type = field.type,
+            is_nullable = field.is_nullable,
+        }
+    end
+    local file, err = require('fio').open(path, {'O_RDONLY'})
+    if file == nil then
+        box.error(box.error.SYSTEM,
+                  string.format("Failed to open '%s': %s", path, err), 2)
+    end
+    local count = 0
+    local batch = {}
+    local ok, res = pcall(function()
+        for lineno, row in require('csv').iterate(file, {
+                chunk_size = 1024 * 1024, delimiter = opts.delimiter,
+                quote_char = opts.quote_char,
+                skip_head_lines = opts.skip_head_lines}) do
+            for fieldno, str in ipairs(row) do
+                local c = convert[fieldno]
+                if c ~= nil and c.is_nullable and str == '' then
+                    row[fieldno] = box.NULL
+                elseif c ~= nil and c.func ~= nil then
+                    local value = c.func(str)
+                    if value == nil then
+                        box.error(box.error.ILLEGAL_PARAMS, string.format(
+                            "Failed to convert field %d of line %d to %s",
+                            fieldno, lineno, c.type))
+                    end
+                    row[fieldno] = value
+                end
+            end
+            table.insert(batch, row)
+            if #batch == batch_size then
+                count = count + write_batch(space.id, msgpack.encode(batch))
+                batch = {}
+            end
+        end
+        if #batch > 0 then
+            count = count + write_batch(space.id, msgpack.encode(batch))
+        end
+    end)
+    file:close()
+    if not ok then
+        error(res, 2)
+    end
+    return count
+end
 space_mt.update = function(space, key, ops)
     check_space_arg(space, 'update', 2)
     return check_primary_index(space, 2):update(key, ops)
@@ -4081,15 +4473,9 @@ local read_view_mt = {
     __serialize = read_view_methods.info,
 }
 
+-- box.read_view.open() is defined in box/read_view.lua.
 box.read_view = {}
 
---
--- Function stub. Implemented in Tarantool EE.
---
-function box.read_view.open()
-    box.error(box.error.UNSUPPORTED, "Community edition", "read view", 2)
-end
-
 --
 -- Table of open read views: id -> read view object.
 --
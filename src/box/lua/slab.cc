@@ -239,6 +239,16 @@ lbox_slab_info(struct lua_State *L)
 	lua_pushstring(L, ratio_buf);
 	lua_settable(L, -3);
 
+	/*
+	 * How much of the arena is backed by huge pages, reported
+	 * only if the arena is advised to use them.
+	 */
+	if (memtx->use_huge_pages) {
+		lua_pushstring(L, "huge_pages_size");
+		luaL_pushuint64(L, memtx_engine_huge_pages_size(memtx));
+		lua_settable(L, -3);
+	}
+
 	return 1;
 }
 
@@ -275,6 +285,19 @@ lbox_slab_check(MAYBE_UNUSED struct lua_State *L)
 	return 0;
 }
 
+/*
+ * Starts a tuple defragmentation pass in background. Progress is reported
+ * by box.stat.memtx().defrag.
+ */
+static int
+lbox_slab_defragment(MAYBE_UNUSED struct lua_State *L)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	memtx_engine_defragment(memtx);
+	return 0;
+}
+
 /*
  * Decodes and returns the XML document returned by malloc_info() as is.
  *
@@ -433,6 +456,10 @@ box_lua_slab_init(struct lua_State *L)
 	lua_pushcfunction(L, lbox_slab_check);
 	lua_settable(L, -3);
 
+	lua_pushstring(L, "defragment");
+	lua_pushcfunction(L, lbox_slab_defragment);
+	lua_settable(L, -3);
+
 	lua_settable(L, -3); /* box.slab */
 
 	lua_pushstring(L, "runtime");
@@ -35,6 +35,7 @@
 #include "box/lua/key_def.h"
 #include "box/sql/sqlLimit.h"
 #include "lua/utils.h"
+#include "lua/msgpack.h"
 #include "lua/trigger.h"
 #include "box/box.h"
 
@@ -467,6 +468,11 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 	lua_pushboolean(L, space_is_sync(space));
 	lua_settable(L, i);
 
+	/* space.schema_version */
+	lua_pushstring(L, "schema_version");
+	luaL_pushuint64(L, space->schema_version);
+	lua_settable(L, i);
+
 	lua_pushstring(L, "enabled");
 	lua_pushboolean(L, space_index(space, 0) != 0);
 	lua_settable(L, i);
@@ -487,6 +493,22 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 		lua_settable(L, i);
 	}
 
+	/* space.iproto_read_view, set only if enabled. */
+	lua_pushstring(L, "iproto_read_view");
+	if (space->def->opts.iproto_read_view)
+		lua_pushboolean(L, true);
+	else
+		lua_pushnil(L);
+	lua_settable(L, i);
+
+	/* space.wal_coalesce, set only if enabled. */
+	lua_pushstring(L, "wal_coalesce");
+	if (space->def->opts.wal_coalesce)
+		lua_pushboolean(L, true);
+	else
+		lua_pushnil(L);
+	lua_settable(L, i);
+
 	lua_getfield(L, i, "index");
 	if (lua_isnil(L, -1)) {
 		lua_pop(L, 1);
@@ -551,7 +573,8 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			assert(! lua_isnil(L, -1));
 		}
 
-		if (index_def->type == HASH || index_def->type == TREE) {
+		if (index_def->type == HASH || index_def->type == TREE ||
+		    index_def->type == ART) {
 			lua_pushboolean(L, index_opts->is_unique);
 			lua_setfield(L, -2, "unique");
 		} else if (index_def->type == RTREE) {
@@ -565,6 +588,48 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnil(L);
 			lua_setfield(L, -2, "hint");
 		}
+		if (index_opts->hash_func == INDEX_HASH_FUNC_XXH3) {
+			lua_pushstring(L, "xxh3");
+			lua_setfield(L, -2, "hash_func");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "hash_func");
+		}
+		if (index_opts->bucket_count != 0) {
+			lua_pushnumber(L, index_opts->bucket_count);
+			lua_setfield(L, -2, "bucket_count");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "bucket_count");
+		}
+		if (index_opts->filter.value_len != 0) {
+			const char *value = index_opts->filter.value;
+			lua_newtable(L);
+			lua_pushnumber(L, index_opts->filter.fieldno +
+					  TUPLE_INDEX_BASE);
+			lua_setfield(L, -2, "field");
+			luamp_decode(L, luaL_msgpack_default, &value);
+			lua_setfield(L, -2, "value");
+			lua_setfield(L, -2, "filter");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "filter");
+		}
+		if (index_opts->include_part_count > 0) {
+			struct key_def *key_def = index_def->key_def;
+			uint32_t first = key_def->part_count -
+					 index_opts->include_part_count;
+			lua_createtable(L, index_opts->include_part_count, 0);
+			for (uint32_t i = first; i < key_def->part_count; i++) {
+				lua_pushnumber(L, key_def->parts[i].fieldno +
+						  TUPLE_INDEX_BASE);
+				lua_rawseti(L, -2, i - first + 1);
+			}
+			lua_setfield(L, -2, "include");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "include");
+		}
 
 		if (index_opts->func_id > 0) {
 			lua_pushstring(L, "func");
@@ -653,6 +718,32 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->bloom_partitioned) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "bloom_partitioned");
+			}
+
+			if (index_opts->bloom_type == INDEX_BLOOM_TYPE_XOR) {
+				lua_pushstring(L, "xor");
+				lua_setfield(L, -2, "bloom_type");
+			}
+
+			if (index_opts->compaction_strategy ==
+			    INDEX_COMPACTION_STRATEGY_TIERED) {
+				lua_pushstring(L, "tiered");
+				lua_setfield(L, -2, "compaction_strategy");
+			}
+
+			if (index_opts->ttl_field != 0) {
+				lua_pushnumber(L, index_opts->ttl_field);
+				lua_setfield(L, -2, "ttl_field");
+			}
+
+			if (index_opts->parallel_compaction) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "parallel_compaction");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -853,9 +944,31 @@ lbox_space_frommap(struct lua_State *L)
 	return luaL_error(L, "Usage: space:frommap(map, opts)");
 }
 
+void
+luaT_push_space_stat(struct lua_State *L, const struct space_stat *stat)
+{
+	lua_createtable(L, 0, 9);
+	lua_pushnumber(L, stat->select_count);
+	lua_setfield(L, -2, "select");
+	lua_pushnumber(L, stat->insert_count);
+	lua_setfield(L, -2, "insert");
+	lua_pushnumber(L, stat->replace_count);
+	lua_setfield(L, -2, "replace");
+	lua_pushnumber(L, stat->update_count);
+	lua_setfield(L, -2, "update");
+	lua_pushnumber(L, stat->upsert_count);
+	lua_setfield(L, -2, "upsert");
+	lua_pushnumber(L, stat->delete_count);
+	lua_setfield(L, -2, "delete");
+	lua_pushnumber(L, stat->tuples_read);
+	lua_setfield(L, -2, "tuples_read");
+	lua_pushnumber(L, stat->bytes_written);
+	lua_setfield(L, -2, "bytes_written");
+}
+
 /**
- * Push to Lua stack a table with the statistics on the memory usage by tuples
- * of the space.
+ * Push to Lua stack a table with the request statistics of the space and,
+ * for memtx spaces, the statistics on the memory usage by its tuples.
  */
 static int
 lbox_space_stat(struct lua_State *L)
@@ -873,13 +986,11 @@ lbox_space_stat(struct lua_State *L)
 		return 2;
 	}
 
-	if (!space_is_memtx(space)) {
-		lua_newtable(L);
+	luaT_push_space_stat(L, &space->stat); /* Result table. */
+	if (!space_is_memtx(space))
 		return 1;
-	}
 	struct memtx_space *memtx_space = (struct memtx_space *)space;
 
-	lua_newtable(L); /* Result table. */
 	lua_newtable(L); /* result.tuple */
 
 	for (int i = TUPLE_ARENA_MEMTX; i <= TUPLE_ARENA_MALLOC; i++) {
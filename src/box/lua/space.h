@@ -37,10 +37,18 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct lua_State;
+struct space_stat;
 
 void
 box_lua_space_init(struct lua_State *L);
 
+/**
+ * Push a table with request statistics of a space to the Lua stack.
+ * See struct space_stat for the meaning of fields.
+ */
+void
+luaT_push_space_stat(struct lua_State *L, const struct space_stat *stat);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -40,10 +40,17 @@
 
 #include "box/box.h"
 #include "box/iproto.h"
+#include "box/iproto_constants.h"
 #include "box/engine.h"
+#include "box/func.h"
+#include "box/space.h"
+#include "box/lua/space.h"
 #include "box/vinyl.h"
 #include "box/sql.h"
 #include "box/memtx_engine.h"
+#include "fiber_pool.h"
+#include "coio_task.h"
+#include "cord_buf.h"
 #include "info/info.h"
 #include "lua/info.h"
 #include "lua/utils.h"
@@ -80,6 +87,98 @@ inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 			    stats->requests_in_stream_queue);
 }
 
+/** Push a table with percentiles of fiber pool latencies, in seconds. */
+static void
+push_fiber_pool_latency(struct lua_State *L,
+			const struct fiber_pool_latency *latency)
+{
+	lua_newtable(L);
+	lua_pushnumber(L, fiber_pool_latency_get(latency, 50));
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, fiber_pool_latency_get(latency, 90));
+	lua_setfield(L, -2, "p90");
+	lua_pushnumber(L, fiber_pool_latency_get(latency, 99));
+	lua_setfield(L, -2, "p99");
+}
+
+/**
+ * Push a table with the given TX fiber pool metric to a Lua stack.
+ * Returns false if there's no such metric.
+ */
+static bool
+push_fiber_pool_stat(struct lua_State *L, const char *name)
+{
+	const struct fiber_pool *pool = box_tx_fiber_pool();
+	if (strcmp(name, "FIBER_POOL") == 0) {
+		lua_newtable(L);
+		lua_pushnumber(L, pool->size);
+		lua_setfield(L, -2, "current");
+		lua_pushnumber(L, pool->max_size);
+		lua_setfield(L, -2, "max");
+	} else if (strcmp(name, "QUEUE_TIME") == 0) {
+		push_fiber_pool_latency(L, &pool->last_queue_time);
+	} else if (strcmp(name, "SERVICE_TIME") == 0) {
+		push_fiber_pool_latency(L, &pool->last_service_time);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/** Push a table with percentiles of a request latency, in seconds. */
+static void
+push_latency(struct lua_State *L, struct latency *latency)
+{
+	lua_createtable(L, 0, 4);
+	lua_pushnumber(L, latency_get(latency, 50));
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, latency_get(latency, 90));
+	lua_setfield(L, -2, "p90");
+	lua_pushnumber(L, latency_get(latency, 99));
+	lua_setfield(L, -2, "p99");
+	lua_pushnumber(L, latency_get(latency, 100));
+	lua_setfield(L, -2, "max");
+}
+
+/**
+ * Push a table with latencies of requests handled in the TX thread by
+ * request type. Only types of requests handled since the last reset are
+ * included. See struct iproto_latency_stat for the meaning of fields.
+ */
+static void
+push_iproto_latency_stat(struct lua_State *L)
+{
+	lua_newtable(L);
+	for (uint32_t type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		struct iproto_latency_stat *stat = iproto_latency_stat(type);
+		const char *name = iproto_type_name(type);
+		if (stat->count == 0 || name == NULL)
+			continue;
+		lua_createtable(L, 0, 4);
+		lua_pushnumber(L, stat->count);
+		lua_setfield(L, -2, "count");
+		push_latency(L, &stat->queue);
+		lua_setfield(L, -2, "queue");
+		push_latency(L, &stat->tx);
+		lua_setfield(L, -2, "tx");
+		push_latency(L, &stat->wal);
+		lua_setfield(L, -2, "wal");
+		lua_setfield(L, -2, name);
+	}
+}
+
+static void
+inject_fiber_pool_stats(struct lua_State *L)
+{
+	static const char *const names[] = {
+		"FIBER_POOL", "QUEUE_TIME", "SERVICE_TIME",
+	};
+	for (size_t i = 0; i < lengthof(names); i++) {
+		push_fiber_pool_stat(L, names[i]);
+		lua_setfield(L, -2, names[i]);
+	}
+}
+
 static void
 fill_stat_item(struct lua_State *L, int rps, int64_t total)
 {
@@ -206,6 +305,7 @@ lbox_stat_reset(struct lua_State *L)
 	(void)L;
 	box_reset_stat();
 	iproto_reset_stat();
+	cord_ibuf_reset_stat();
 	return 0;
 }
 
@@ -221,6 +321,12 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	const char *key = luaL_checkstring(L, -1);
+	if (push_fiber_pool_stat(L, key))
+		return 1;
+	if (strcmp(key, "LATENCY") == 0) {
+		push_iproto_latency_stat(L);
+		return 1;
+	}
 	if (iproto_rmean_foreach(seek_stat_item, L) == 0)
 		return 0;
 
@@ -261,14 +367,23 @@ lbox_stat_net_index(struct lua_State *L)
  * - STREAMS: total, rps, current;
  * - REQUESTS: total, rps, current;
  * - REQUESTS_IN_PROGRESS: total, rps, current;
- * - REQUESTS_IN_STREAM_QUEUE: total, rps, current.
+ * - REQUESTS_IN_STREAM_QUEUE: total, rps, current;
+ * - FIBER_POOL (fibers in the TX thread pool): current, max;
+ * - QUEUE_TIME (time messages wait for a pool fiber): p50, p90, p99;
+ * - SERVICE_TIME (time pool fibers handle messages): p50, p90, p99;
+ * - LATENCY (latency of requests by request type): count and queue, tx,
+ *   wal (see struct iproto_latency_stat), each with p50, p90, p99, max.
  *
  * These fields have the following meaning:
  *
  * - total -- amount of events since start;
  * - rps -- amount of events per second, mean over last 5 seconds;
  * - current -- amount of resources currently hold (say, number of
- *   open connections).
+ *   open connections);
+ * - max -- the current limit on the amount of resources;
+ * - p50, p90, p99 -- percentiles of the time, in seconds, over the
+ *   last complete fiber pool stat period (the idle fiber timeout), or
+ *   since the last reset for LATENCY.
  */
 static int
 lbox_stat_net_call(struct lua_State *L)
@@ -278,6 +393,9 @@ lbox_stat_net_call(struct lua_State *L)
 	struct iproto_stats stats;
 	iproto_stats_get(&stats);
 	inject_iproto_stats(L, &stats);
+	inject_fiber_pool_stats(L);
+	push_iproto_latency_stat(L);
+	lua_setfield(L, -2, "LATENCY");
 	return 1;
 }
 
@@ -317,6 +435,146 @@ lbox_stat_net_thread_call(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Push a table of coio pool statistics to a Lua stack, indexed by
+ * pool names. See struct coio_pool_stat for the meaning of fields.
+ */
+static int
+lbox_stat_coio(struct lua_State *L)
+{
+	lua_createtable(L, 0, coio_pool_MAX);
+	for (int i = 0; i < coio_pool_MAX; i++) {
+		struct coio_pool_stat stat;
+		coio_pool_stat(i, &stat);
+		lua_createtable(L, 0, 9);
+		lua_pushinteger(L, stat.priority);
+		lua_setfield(L, -2, "priority");
+		lua_pushinteger(L, stat.limit);
+		lua_setfield(L, -2, "limit");
+		lua_pushinteger(L, stat.active);
+		lua_setfield(L, -2, "active");
+		lua_pushinteger(L, stat.waiting);
+		lua_setfield(L, -2, "waiting");
+		lua_pushnumber(L, stat.count);
+		lua_setfield(L, -2, "count");
+		lua_pushnumber(L, stat.wait_time);
+		lua_setfield(L, -2, "wait_time");
+		lua_pushnumber(L, stat.wait_time_max);
+		lua_setfield(L, -2, "wait_time_max");
+		lua_pushnumber(L, stat.exec_time);
+		lua_setfield(L, -2, "exec_time");
+		lua_pushnumber(L, stat.exec_time_max);
+		lua_setfield(L, -2, "exec_time_max");
+		lua_setfield(L, -2, coio_pool_id_strs[i]);
+	}
+	return 1;
+}
+
+/**
+ * Push a table with transient memory usage in the TX thread: region
+ * memory held at the end of requests by request type and usage of
+ * the global cord ibuf.
+ */
+static int
+lbox_stat_region(struct lua_State *L)
+{
+	lua_createtable(L, 0, 2);
+	lua_newtable(L);
+	for (uint32_t type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		const struct iproto_region_stat *stat =
+			iproto_region_stat(type);
+		const char *name = iproto_type_name(type);
+		if (stat->count == 0 || name == NULL)
+			continue;
+		lua_createtable(L, 0, 3);
+		lua_pushnumber(L, stat->count);
+		lua_setfield(L, -2, "count");
+		lua_pushnumber(L, stat->total / stat->count);
+		lua_setfield(L, -2, "avg");
+		lua_pushnumber(L, stat->max);
+		lua_setfield(L, -2, "max");
+		lua_setfield(L, -2, name);
+	}
+	lua_setfield(L, -2, "requests");
+	struct cord_ibuf_stat ibuf_stat;
+	cord_ibuf_stat(&ibuf_stat);
+	lua_createtable(L, 0, 4);
+	lua_pushnumber(L, ibuf_stat.capacity);
+	lua_setfield(L, -2, "capacity");
+	lua_pushnumber(L, ibuf_stat.capacity_max);
+	lua_setfield(L, -2, "capacity_max");
+	lua_pushnumber(L, ibuf_stat.used_max);
+	lua_setfield(L, -2, "used_max");
+	lua_pushnumber(L, ibuf_stat.shrink_count);
+	lua_setfield(L, -2, "shrink_count");
+	lua_setfield(L, -2, "ibuf");
+	return 1;
+}
+
+/** Push statistics of a function to a Lua table if it has been called. */
+static int
+lbox_stat_func_push(struct func *func, void *arg)
+{
+	struct lua_State *L = arg;
+	const struct func_stat *stat = &func->stat;
+	if (stat->call_count == 0)
+		return 0;
+	lua_createtable(L, 0, 5);
+	lua_pushnumber(L, stat->call_count);
+	lua_setfield(L, -2, "calls");
+	lua_pushnumber(L, stat->error_count);
+	lua_setfield(L, -2, "errors");
+	lua_pushnumber(L, (double)stat->time / 1e9);
+	lua_setfield(L, -2, "time");
+	lua_pushnumber(L, stat->yield_count);
+	lua_setfield(L, -2, "yields");
+	lua_pushnumber(L, stat->lua_alloc);
+	lua_setfield(L, -2, "lua_alloc");
+	lua_setfield(L, -2, func->def->name);
+	return 0;
+}
+
+/**
+ * Push a table of statistics of stored functions indexed by function
+ * names. Only functions called since the last reset are included.
+ * See struct func_stat for the meaning of fields.
+ */
+static int
+lbox_stat_func(struct lua_State *L)
+{
+	lua_newtable(L);
+	func_cache_foreach(lbox_stat_func_push, L);
+	return 1;
+}
+
+/** Push statistics of a space to a Lua table if it has been accessed. */
+static int
+lbox_stat_spaces_push(struct space *space, void *arg)
+{
+	struct lua_State *L = arg;
+	const struct space_stat *stat = &space->stat;
+	if (stat->select_count == 0 && stat->insert_count == 0 &&
+	    stat->replace_count == 0 && stat->update_count == 0 &&
+	    stat->upsert_count == 0 && stat->delete_count == 0)
+		return 0;
+	luaT_push_space_stat(L, stat);
+	lua_setfield(L, -2, space_name(space));
+	return 0;
+}
+
+/**
+ * Push a table of request statistics of spaces indexed by space names.
+ * Only spaces accessed since the last reset are included.
+ * See struct space_stat for the meaning of fields.
+ */
+static int
+lbox_stat_spaces(struct lua_State *L)
+{
+	lua_newtable(L);
+	space_foreach(lbox_stat_spaces_push, L);
+	return 1;
+}
+
 static int
 lbox_stat_sql(struct lua_State *L)
 {
@@ -367,6 +625,10 @@ box_lua_stat_init(struct lua_State *L)
 		{"vinyl", lbox_stat_vinyl},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
+		{"coio", lbox_stat_coio},
+		{"region", lbox_stat_region},
+		{"func", lbox_stat_func},
+		{"spaces", lbox_stat_spaces},
 		{NULL, NULL}
 	};
 
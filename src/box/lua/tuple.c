@@ -693,6 +693,222 @@ lbox_tuple_field_by_path(struct lua_State *L)
 	return 1;
 }
 
+/* {{{ Tuple projection */
+
+/** A field of a tuple projection. */
+struct tuple_projection_field {
+	/** Field name or JSON path as given by the user. */
+	char *path;
+	/** Length of the path. */
+	uint32_t path_len;
+	/** Hash of the path, see field_name_hash(). */
+	uint32_t path_hash;
+	/**
+	 * Field number resolved for the cached format or UINT32_MAX
+	 * if the path doesn't match any field of the format.
+	 */
+	uint32_t fieldno;
+	/** Part of the path following the field name or number. */
+	const char *subpath;
+	/** Length of the subpath. */
+	uint32_t subpath_len;
+	/** Offset slot cache, see key_part::offset_slot_cache. */
+	int32_t offset_slot_cache;
+};
+
+/**
+ * A compiled list of tuple fields that can be fetched in one call.
+ * Field names are resolved to field numbers and offset slots once
+ * per tuple format and reused while tuples of the same format are
+ * passed to the projection.
+ */
+struct tuple_projection {
+	/** Epoch of the format the fields are resolved for. */
+	uint64_t format_epoch;
+	/**
+	 * Version of the format dictionary the fields are resolved
+	 * for. A dictionary is updated in place on space format
+	 * change, without creating a new format.
+	 */
+	uint64_t dict_version;
+	/** Number of fields. */
+	uint32_t field_count;
+	/** Fields to fetch. */
+	struct tuple_projection_field fields[0];
+};
+
+static const char *tuple_projectionlib_name = "box.tuple.projection";
+
+/** Resolve a projection field for the given format. */
+static void
+tuple_projection_field_resolve(struct tuple_projection_field *field,
+			       struct tuple_format *format)
+{
+	field->fieldno = UINT32_MAX;
+	field->subpath = NULL;
+	field->subpath_len = 0;
+	field->offset_slot_cache = TUPLE_OFFSET_SLOT_NIL;
+	/* A field name has priority over a JSON path, as in tuple[path]. */
+	if (tuple_fieldno_by_name(format->dict, field->path, field->path_len,
+				  field->path_hash, &field->fieldno) == 0)
+		return;
+	struct json_lexer lexer;
+	struct json_token token;
+	json_lexer_create(&lexer, field->path, field->path_len,
+			  TUPLE_INDEX_BASE);
+	if (json_lexer_next_token(&lexer, &token) != 0)
+		return;
+	switch (token.type) {
+	case JSON_TOKEN_NUM:
+		field->fieldno = token.num;
+		break;
+	case JSON_TOKEN_STR:
+		if (tuple_fieldno_by_name(format->dict, token.str, token.len,
+					  field_name_hash(token.str, token.len),
+					  &field->fieldno) != 0)
+			return;
+		break;
+	default:
+		assert(token.type == JSON_TOKEN_END ||
+		       token.type == JSON_TOKEN_ANY);
+		return;
+	}
+	field->subpath = field->path + lexer.offset;
+	field->subpath_len = field->path_len - lexer.offset;
+}
+
+static struct tuple_projection *
+luaT_checkprojection(struct lua_State *L, int idx)
+{
+	return *(struct tuple_projection **)
+		luaL_checkudata(L, idx, tuple_projectionlib_name);
+}
+
+/**
+ * Create a tuple projection.
+ * @param L Lua state.
+ * @param paths 1-th argument on a lua stack, array of field names
+ *        or JSON paths.
+ *
+ * @retval Tuple projection object.
+ */
+static int
+lbox_tuple_projection_new(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || lua_type(L, 1) != LUA_TTABLE)
+		return luaL_error(L, "Usage: box.tuple.projection({path, ...})");
+	uint32_t field_count = lua_objlen(L, 1);
+	if (field_count == 0 || field_count > LUAI_MAXCSTACK)
+		return luaL_error(L, "projection must contain from 1 to %d "
+				  "fields", LUAI_MAXCSTACK);
+	for (uint32_t i = 1; i <= field_count; i++) {
+		lua_rawgeti(L, 1, i);
+		if (lua_type(L, -1) != LUA_TSTRING || lua_objlen(L, -1) == 0)
+			return luaL_error(L, "projection field %d must be a "
+					  "non-empty string", (int)i);
+		lua_pop(L, 1);
+	}
+	struct tuple_projection *proj = xmalloc(sizeof(*proj) + field_count *
+						sizeof(proj->fields[0]));
+	proj->format_epoch = 0;
+	proj->dict_version = 0;
+	proj->field_count = field_count;
+	for (uint32_t i = 0; i < field_count; i++) {
+		struct tuple_projection_field *field = &proj->fields[i];
+		size_t len;
+		lua_rawgeti(L, 1, i + 1);
+		const char *path = lua_tolstring(L, -1, &len);
+		field->path = xmalloc(len);
+		memcpy(field->path, path, len);
+		field->path_len = len;
+		field->path_hash = lua_hashstring(L, -1);
+		field->fieldno = UINT32_MAX;
+		field->offset_slot_cache = TUPLE_OFFSET_SLOT_NIL;
+		lua_pop(L, 1);
+	}
+	struct tuple_projection **ptr = lua_newuserdata(L, sizeof(proj));
+	*ptr = proj;
+	luaL_getmetatable(L, tuple_projectionlib_name);
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+static int
+lbox_tuple_projection_gc(struct lua_State *L)
+{
+	struct tuple_projection *proj = luaT_checkprojection(L, 1);
+	for (uint32_t i = 0; i < proj->field_count; i++)
+		free(proj->fields[i].path);
+	free(proj);
+	return 0;
+}
+
+/**
+ * Fetch the projection fields from a tuple.
+ * @param L Lua state.
+ * @param proj 1-th argument on a lua stack, tuple projection.
+ * @param tuple 2-th argument on a lua stack, tuple to get fields
+ *        from.
+ *
+ * @retval Values of the projection fields in the projection order,
+ *         nil for a field that is NULL or does not exist.
+ */
+static int
+lbox_tuple_projection_call(struct lua_State *L)
+{
+	struct tuple_projection *proj = luaT_checkprojection(L, 1);
+	struct tuple *tuple = luaT_istuple(L, 2);
+	if (tuple == NULL)
+		return luaL_error(L, "Usage: projection(tuple)");
+	struct tuple_format *format = tuple_format(tuple);
+	const char *data = tuple_data(tuple);
+	const uint32_t *field_map = tuple_field_map(tuple);
+	if (unlikely(proj->format_epoch != format->epoch ||
+		     proj->dict_version != format->dict->version)) {
+		for (uint32_t i = 0; i < proj->field_count; i++)
+			tuple_projection_field_resolve(&proj->fields[i],
+						       format);
+		proj->format_epoch = format->epoch;
+		proj->dict_version = format->dict->version;
+	}
+	if (!lua_checkstack(L, proj->field_count))
+		return luaL_error(L, "projection is too big");
+	for (uint32_t i = 0; i < proj->field_count; i++) {
+		struct tuple_projection_field *field = &proj->fields[i];
+		const char *value = NULL;
+		if (field->fieldno != UINT32_MAX) {
+			value = tuple_field_raw_by_path(
+				format, data, field_map, field->fieldno,
+				field->subpath, field->subpath_len,
+				TUPLE_INDEX_BASE, &field->offset_slot_cache,
+				MULTIKEY_NONE);
+		}
+		if (value == NULL)
+			lua_pushnil(L);
+		else
+			luamp_decode(L, luaL_msgpack_default, &value);
+	}
+	return proj->field_count;
+}
+
+static int
+lbox_tuple_projection_to_string(struct lua_State *L)
+{
+	struct tuple_projection *proj = luaT_checkprojection(L, 1);
+	lua_pushfstring(L, "<tuple projection of %d fields>",
+			(int)proj->field_count);
+	return 1;
+}
+
+static const struct luaL_Reg lbox_tuple_projection_meta[] = {
+	{"__gc", lbox_tuple_projection_gc},
+	{"__call", lbox_tuple_projection_call},
+	{"__tostring", lbox_tuple_projection_to_string},
+	{NULL, NULL}
+};
+
+/* }}} Tuple projection */
+
 static int
 lbox_tuple_to_string(struct lua_State *L)
 {
@@ -784,6 +1000,7 @@ static const struct luaL_Reg lbox_tuple_meta[] = {
 	{"new", lbox_tuple_new},
 	{"info", lbox_tuple_info},
 	{"tuple_get_format", lbox_tuple_get_format},
+	{"projection", lbox_tuple_projection_new},
 	{NULL, NULL}
 };
 
@@ -820,6 +1037,8 @@ box_lua_tuple_init(struct lua_State *L)
 	lua_pop(L, 1); /* box.internal */
 	luaL_register_type(L, tuple_iteratorlib_name,
 			   lbox_tuple_iterator_meta);
+	luaL_register_type(L, tuple_projectionlib_name,
+			   lbox_tuple_projection_meta);
 
 	tuple_serializer_update_options();
 	trigger_create(&tuple_serializer.update_trigger,
@@ -409,3 +409,7 @@ box.tuple.new = new_tuple
 -- is() is implemented in Lua, because then it is
 -- easy to be JITed.
 box.tuple.is = is_tuple
+
+-- projection() compiles a list of field paths to an object that
+-- fetches all of them from a tuple in one call.
+box.tuple.projection = internal.tuple.projection
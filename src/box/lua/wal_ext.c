@@ -0,0 +1,164 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/wal_ext.h"
+
+#include <assert.h>
+#include <lua.h>
+#include <lauxlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "box/error.h"
+#include "box/wal_ext.h"
+#include "diag.h"
+#include "lua/utils.h"
+#include "trivia/config.h"
+#include "tt_static.h"
+
+#if defined(ENABLE_WAL_EXT)
+# error unimplemented
+#endif
+
+/**
+ * Parses a table with the 'old' and 'new' boolean fields located at
+ * the given Lua stack index. The 'spaces' field is skipped if allow_spaces
+ * is set. The table is referred to as what in error messages. Returns 0 on
+ * success. On error sets diag and returns -1.
+ */
+static int
+lbox_wal_ext_parse(struct lua_State *L, int idx, const char *what,
+		   bool allow_spaces, struct space_wal_ext *ext)
+{
+	ext->old_tuple = false;
+	ext->new_tuple = false;
+	if (lua_type(L, idx) != LUA_TTABLE) {
+		diag_set(ClientError, ER_CFG, "wal_ext",
+			 tt_sprintf("%s should be a table", what));
+		return -1;
+	}
+	lua_pushnil(L);
+	while (lua_next(L, idx) != 0) {
+		const char *key = lua_type(L, -2) == LUA_TSTRING ?
+				  lua_tostring(L, -2) : NULL;
+		bool *value;
+		if (key != NULL && strcmp(key, "old") == 0) {
+			value = &ext->old_tuple;
+		} else if (key != NULL && strcmp(key, "new") == 0) {
+			value = &ext->new_tuple;
+		} else if (key != NULL && strcmp(key, "spaces") == 0 &&
+			   allow_spaces) {
+			lua_pop(L, 1);
+			continue;
+		} else {
+			diag_set(ClientError, ER_CFG, "wal_ext",
+				 tt_sprintf("unexpected option '%s' in %s",
+					    key != NULL ? key : "?", what));
+			lua_pop(L, 2);
+			return -1;
+		}
+		if (lua_type(L, -1) != LUA_TBOOLEAN) {
+			diag_set(ClientError, ER_CFG, "wal_ext",
+				 tt_sprintf("%s.%s should be a boolean",
+					    what, key));
+			lua_pop(L, 2);
+			return -1;
+		}
+		*value = lua_toboolean(L, -1);
+		lua_pop(L, 1);
+	}
+	return 0;
+}
+
+/**
+ * Parses the 'spaces' field of box.cfg.wal_ext located at the given Lua
+ * stack index. If apply is set, adds the parsed space settings to
+ * the pending configuration started with wal_ext_cfg_begin(). Returns 0
+ * on success. On error sets diag and returns -1.
+ */
+static int
+lbox_wal_ext_parse_spaces(struct lua_State *L, int idx, bool apply)
+{
+	lua_getfield(L, idx, "spaces");
+	int spaces_idx = lua_gettop(L);
+	int rc = 0;
+	if (lua_isnil(L, spaces_idx) || luaL_isnull(L, spaces_idx))
+		goto out;
+	if (lua_type(L, spaces_idx) != LUA_TTABLE) {
+		diag_set(ClientError, ER_CFG, "wal_ext",
+			 "wal_ext.spaces should be a table");
+		rc = -1;
+		goto out;
+	}
+	lua_pushnil(L);
+	while (lua_next(L, spaces_idx) != 0) {
+		if (lua_type(L, -2) != LUA_TSTRING) {
+			diag_set(ClientError, ER_CFG, "wal_ext",
+				 "wal_ext.spaces keys should be space names");
+			lua_pop(L, 2);
+			rc = -1;
+			goto out;
+		}
+		const char *name = lua_tostring(L, -2);
+		struct space_wal_ext ext;
+		if (lbox_wal_ext_parse(L, lua_gettop(L),
+				       tt_sprintf("wal_ext.spaces.%s", name),
+				       false, &ext) != 0) {
+			lua_pop(L, 2);
+			rc = -1;
+			goto out;
+		}
+		if (apply)
+			wal_ext_cfg_add_space(name, &ext);
+		lua_pop(L, 1);
+	}
+out:
+	lua_pop(L, 1);
+	return rc;
+}
+
+/**
+ * Applies box.cfg.wal_ext: {old = <boolean>, new = <boolean>,
+ * spaces = {<space name> = {old = <boolean>, new = <boolean>}, ...}}.
+ * The top-level settings are used for spaces not listed in 'spaces'.
+ */
+static int
+lbox_cfg_set_wal_ext(struct lua_State *L)
+{
+	lua_getfield(L, LUA_GLOBALSINDEX, "box");
+	lua_getfield(L, -1, "cfg");
+	lua_getfield(L, -1, "wal_ext");
+	int idx = lua_gettop(L);
+	bool is_set = !lua_isnil(L, idx) && !luaL_isnull(L, idx);
+	struct space_wal_ext default_ext = {
+		.old_tuple = false,
+		.new_tuple = false,
+	};
+	if (is_set) {
+		/* Validate everything before changing the configuration. */
+		if (lbox_wal_ext_parse(L, idx, "wal_ext", true,
+				       &default_ext) != 0 ||
+		    lbox_wal_ext_parse_spaces(L, idx, false) != 0)
+			return luaT_error(L);
+	}
+	wal_ext_cfg_begin(&default_ext);
+	if (is_set) {
+		int rc = lbox_wal_ext_parse_spaces(L, idx, true);
+		assert(rc == 0);
+		(void)rc;
+	}
+	wal_ext_cfg_commit();
+	lua_pop(L, 3);
+	return 0;
+}
+
+void
+box_lua_wal_ext_init(struct lua_State *L)
+{
+	luaL_findtable(L, LUA_GLOBALSINDEX, "box.internal", 0);
+	lua_pushcfunction(L, lbox_cfg_set_wal_ext);
+	lua_setfield(L, -2, "cfg_set_wal_ext");
+	lua_pop(L, 1);
+}
@@ -11,12 +11,18 @@
 #include "lua/wal_ext_impl.h"
 #else /* !defined(ENABLE_WAL_EXT) */
 
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
 struct lua_State;
 
-static inline void
-box_lua_wal_ext_init(struct lua_State *L)
-{
-	(void)L;
-}
+/** Registers box.internal.cfg_set_wal_ext. */
+void
+box_lua_wal_ext_init(struct lua_State *L);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
 
 #endif /* !defined(ENABLE_WAL_EXT) */
@@ -103,14 +103,16 @@ lbox_xlog_parse_body_kv(struct lua_State *L, int type, const char **beg)
 		return;
 	}
 	uint32_t v = mp_decode_uint(beg);
-	if (iproto_type_is_dml(type) && iproto_key_name(v)) {
+	if ((iproto_type_is_dml(type) || type == MEMTX_INDEX_ORDER) &&
+	    iproto_key_name(v)) {
 		/*
 		 * Historically, the xlog reader outputs IPROTO_OPS as
 		 * "operations", not "ops".
 		 */
 		lbox_xlog_pushkey(L, (v == IPROTO_OPS ? "operations" :
 				      iproto_key_name(v)));
-	} else if (type == VY_INDEX_RUN_INFO && vy_run_info_key_name(v)) {
+	} else if ((type == VY_INDEX_RUN_INFO || type == VY_RUN_BLOOM) &&
+		   vy_run_info_key_name(v)) {
 		lbox_xlog_pushkey(L, vy_run_info_key_name(v));
 	} else if (type == VY_INDEX_PAGE_INFO && vy_page_info_key_name(v)) {
 		lbox_xlog_pushkey(L, vy_page_info_key_name(v));
@@ -340,6 +342,7 @@ lbox_xlog_parser_open_pairs(struct lua_State *L)
 		return luaT_error(L);
 	}
 	if (strncmp(cur->meta.filetype, "SNAP", 4) != 0 &&
+	    strncmp(cur->meta.filetype, "DSNAP", 5) != 0 &&
 	    strncmp(cur->meta.filetype, "XLOG", 4) != 0 &&
 	    strncmp(cur->meta.filetype, "RUN", 3) != 0 &&
 	    strncmp(cur->meta.filetype, "INDEX", 5) != 0 &&
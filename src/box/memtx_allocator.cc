@@ -31,6 +31,8 @@
 #include "memtx_allocator.h"
 #include "trivia/tuple.h"
 
+#include <stdlib.h>
+
 struct memtx_tuple_rv *
 memtx_tuple_rv_new(uint32_t version, struct rlist *list)
 {
@@ -175,6 +177,10 @@ memtx_allocators_destroy()
 {
 	foreach_memtx_allocator<allocator_destroy>();
 	foreach_allocator<allocator_destroy>();
+	::free(defrag_classes);
+	defrag_classes = nullptr;
+	defrag_class_count = 0;
+	defrag_class_capacity = 0;
 }
 
 struct memtx_allocator_open_read_view {
@@ -232,3 +238,58 @@ memtx_allocators_stats(struct memtx_allocator_stats *stats)
 	memtx_allocator_stats_create(stats);
 	foreach_memtx_allocator<memtx_allocator_add_stats>(*stats);
 }
+
+/** Object sizes of size classes selected for defragmentation, sorted. */
+static size_t *defrag_classes;
+/** Number of entries in defrag_classes. */
+static int defrag_class_count;
+/** Capacity of defrag_classes. */
+static int defrag_class_capacity;
+
+static int
+memtx_defrag_select_class_cb(const void *stats, void *cb_ctx)
+{
+	const struct mempool_stats *pool =
+		(const struct mempool_stats *)stats;
+	double fill_factor = *(double *)cb_ctx;
+	size_t mem_free = pool->totals.total - pool->totals.used;
+	if (pool->slabcount < 2 || mem_free < pool->slabsize ||
+	    pool->totals.used >= pool->totals.total * fill_factor)
+		return 0;
+	if (defrag_class_count == defrag_class_capacity) {
+		defrag_class_capacity = MAX(defrag_class_capacity * 2, 16);
+		defrag_classes = (size_t *)xrealloc(defrag_classes,
+				defrag_class_capacity * sizeof(*defrag_classes));
+	}
+	defrag_classes[defrag_class_count++] = pool->objsize;
+	return 0;
+}
+
+static int
+memtx_defrag_class_cmp(const void *a, const void *b)
+{
+	size_t lhs = *(const size_t *)a;
+	size_t rhs = *(const size_t *)b;
+	return lhs < rhs ? -1 : lhs > rhs;
+}
+
+int
+memtx_defrag_select_classes(double fill_factor)
+{
+	struct allocator_stats stats;
+	defrag_class_count = 0;
+	SmallAlloc::stats(&stats, memtx_defrag_select_class_cb, &fill_factor);
+	if (defrag_class_count > 1)
+		qsort(defrag_classes, defrag_class_count, sizeof(*defrag_classes),
+		      memtx_defrag_class_cmp);
+	return defrag_class_count;
+}
+
+bool
+memtx_defrag_class_is_selected(size_t objsize)
+{
+	if (defrag_class_count == 0)
+		return false;
+	return bsearch(&objsize, defrag_classes, defrag_class_count,
+		       sizeof(*defrag_classes), memtx_defrag_class_cmp) != NULL;
+}
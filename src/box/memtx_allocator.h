@@ -204,6 +204,22 @@ memtx_allocator_stats_add(struct memtx_allocator_stats *dst,
 	dst->used_gc += src->used_gc;
 }
 
+/**
+ * Selects sparse size classes of the small allocator for defragmentation,
+ * see MemtxAllocator::relocate_tuple(). A size class is selected if it has
+ * at least one slab worth of free memory and less than @a fill_factor of
+ * its memory is used. Returns the number of selected size classes.
+ */
+int
+memtx_defrag_select_classes(double fill_factor);
+
+/**
+ * Returns true if the small allocator size class with the given object
+ * size was selected by the last call to memtx_defrag_select_classes().
+ */
+bool
+memtx_defrag_class_is_selected(size_t objsize);
+
 template<class Allocator>
 class MemtxAllocator {
 public:
@@ -331,6 +347,37 @@ class MemtxAllocator {
 		}
 	}
 
+	/**
+	 * Allocates a copy of a tuple in order to reduce memory fragmentation.
+	 *
+	 * The small allocator serves allocations from the non-full slab with
+	 * the lowest address so copying tuples stored in a sparse size class
+	 * to a lower address gradually drains the highest slabs of the class
+	 * until they are empty and released. Returns null if the tuple isn't
+	 * worth moving: it isn't stored in a size class selected with
+	 * memtx_defrag_select_classes() or the copy wouldn't be placed lower.
+	 *
+	 * The copy has zero references. Freeing the original tuple is up to
+	 * the caller.
+	 */
+	static struct tuple *relocate_tuple(struct tuple *tuple)
+	{
+		if (!may_relocate(tuple))
+			return nullptr;
+		size_t size = tuple_size(tuple);
+		struct tuple *copy = alloc_tuple(size);
+		if (copy == nullptr)
+			return nullptr;
+		if (copy > tuple) {
+			free(container_of(copy, struct memtx_tuple, base),
+			     size + offsetof(struct memtx_tuple, base));
+			return nullptr;
+		}
+		memcpy(copy, tuple, size);
+		tuple_ref_init(copy, 0);
+		return copy;
+	}
+
 	/**
 	 * Does a garbage collection step. Returns false if there's no more
 	 * tuples to collect.
@@ -368,6 +415,12 @@ class MemtxAllocator {
 		return ptr;
 	}
 
+	/**
+	 * Returns true if the tuple is stored in a size class selected for
+	 * defragmentation, see relocate_tuple().
+	 */
+	static bool may_relocate(struct tuple *tuple);
+
 	/**
 	 * Returns the most recent open read view that needs this tuple or null
 	 * if the tuple may be freed immediately.
@@ -434,6 +487,26 @@ class MemtxAllocator {
 	static bool may_reuse_read_view;
 };
 
+template<>
+inline bool
+MemtxAllocator<SmallAlloc>::may_relocate(struct tuple *tuple)
+{
+	struct small_alloc_info info;
+	SmallAlloc::get_alloc_info(container_of(tuple, struct memtx_tuple, base),
+				   tuple_size(tuple) +
+				   offsetof(struct memtx_tuple, base), &info);
+	return !info.is_large && memtx_defrag_class_is_selected(info.real_size);
+}
+
+template<>
+inline bool
+MemtxAllocator<SysAlloc>::may_relocate(struct tuple *tuple)
+{
+	/* Fragmentation of the system allocator is out of our control. */
+	(void)tuple;
+	return false;
+}
+
 template<class Allocator>
 struct stailq MemtxAllocator<Allocator>::gc;
 
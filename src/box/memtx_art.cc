@@ -0,0 +1,862 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_art.h"
+
+#include <small/mempool.h>
+#include <small/region.h>
+
+#include "fiber.h"
+#include "index.h"
+#include "memtx_engine.h"
+#include "memtx_tx.h"
+#include "msgpuck.h"
+#include "salad/art.h"
+#include "schema.h" /* space_by_id() */
+#include "space.h"
+#include "trivia/util.h"
+#include "tuple.h"
+#include "txn.h"
+
+/**
+ * Memtx index based on an adaptive radix tree. Tuples are indexed by
+ * their keys converted to byte strings that compare with memcmp() the
+ * same way as the keys compare with tuple_compare(), so that the index
+ * supports both point lookups and ordered iteration. The index must be
+ * unique and only unsigned, integer and string parts without collation
+ * are supported, see memtx_art_encode_part().
+ */
+struct memtx_art_index {
+	struct index base;
+	struct art tree;
+	/** Tree node pools, one per node size, created on demand. */
+	struct mempool node_pools[ART_NODE_SIZE_COUNT];
+	/** Buffer for the key returned by the tree key callback. */
+	unsigned char *key_buf;
+	/** Size of the key buffer. */
+	uint32_t key_buf_size;
+	/** Tuples to be unreferenced by the primary index destruction. */
+	struct tuple **gc_tuples;
+	/** Number of tuples in gc_tuples. */
+	size_t gc_tuple_count;
+	/** Number of tuples in gc_tuples unreferenced so far. */
+	size_t gc_tuple_pos;
+	struct memtx_gc_task gc_task;
+};
+
+/* {{{ Key encoding *********************************************/
+
+/** Max size of an encoded key part. */
+static uint32_t
+memtx_art_part_size_max(enum field_type type, const char *field)
+{
+	switch (type) {
+	case FIELD_TYPE_UNSIGNED:
+		return 8;
+	case FIELD_TYPE_INTEGER:
+		return 9;
+	case FIELD_TYPE_STRING:
+		return 2 * mp_decode_strl(&field) + 2;
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+/** Store a 64-bit value in the big-endian order. */
+static inline unsigned char *
+memtx_art_encode_u64(unsigned char *buf, uint64_t value)
+{
+	for (int i = 7; i >= 0; i--) {
+		buf[i] = value & 0xff;
+		value >>= 8;
+	}
+	return buf + 8;
+}
+
+/**
+ * Encode a key part so that encoded keys compare with memcmp():
+ *  - unsigned: 8 bytes, big-endian;
+ *  - integer: 0 for negative and 1 for non-negative values followed
+ *    by 8 bytes of the two's complement value, big-endian;
+ *  - string: the string bytes with 0 escaped as {0, 0xff},
+ *    terminated with {0, 0}.
+ * Encoded parts are self-delimiting, so encoded full keys are
+ * prefix-free and a partial key is a prefix of all keys matching it.
+ */
+static unsigned char *
+memtx_art_encode_part(unsigned char *buf, enum field_type type,
+		      const char *field)
+{
+	switch (mp_typeof(*field)) {
+	case MP_UINT: {
+		if (type == FIELD_TYPE_INTEGER)
+			*buf++ = 1;
+		return memtx_art_encode_u64(buf, mp_decode_uint(&field));
+	}
+	case MP_INT: {
+		int64_t value = mp_decode_int(&field);
+		if (type == FIELD_TYPE_INTEGER)
+			*buf++ = value >= 0;
+		return memtx_art_encode_u64(buf, (uint64_t)value);
+	}
+	case MP_STR: {
+		assert(type == FIELD_TYPE_STRING);
+		uint32_t len;
+		const char *str = mp_decode_str(&field, &len);
+		for (uint32_t i = 0; i < len; i++) {
+			*buf++ = str[i];
+			if (str[i] == 0)
+				*buf++ = 0xff;
+		}
+		*buf++ = 0;
+		*buf++ = 0;
+		return buf;
+	}
+	default:
+		unreachable();
+	}
+	return buf;
+}
+
+/**
+ * Encode the first @a part_count parts of a key. The key is allocated
+ * on the fiber region. Its size is returned in @a len.
+ */
+static unsigned char *
+memtx_art_encode_key(struct key_def *key_def, const char *key,
+		     uint32_t part_count, uint32_t *len)
+{
+	uint32_t size = 0;
+	const char *field = key;
+	for (uint32_t i = 0; i < part_count; i++) {
+		size += memtx_art_part_size_max(key_def->parts[i].type, field);
+		mp_next(&field);
+	}
+	unsigned char *buf = (unsigned char *)
+		xregion_alloc(&fiber()->gc, MAX(size, 1));
+	unsigned char *pos = buf;
+	field = key;
+	for (uint32_t i = 0; i < part_count; i++) {
+		pos = memtx_art_encode_part(pos, key_def->parts[i].type,
+					    field);
+		mp_next(&field);
+	}
+	*len = pos - buf;
+	return buf;
+}
+
+/** Max size of the encoded key of a tuple. */
+static uint32_t
+memtx_art_tuple_key_size_max(struct key_def *key_def, struct tuple *tuple)
+{
+	uint32_t size = 0;
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		struct key_part *part = &key_def->parts[i];
+		const char *field = tuple_field_by_part(tuple, part,
+							MULTIKEY_NONE);
+		assert(field != NULL);
+		size += memtx_art_part_size_max(part->type, field);
+	}
+	return size;
+}
+
+/** Encode the key of a tuple. Returns the end of the encoded key. */
+static unsigned char *
+memtx_art_encode_tuple(struct key_def *key_def, struct tuple *tuple,
+		       unsigned char *buf)
+{
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		struct key_part *part = &key_def->parts[i];
+		const char *field = tuple_field_by_part(tuple, part,
+							MULTIKEY_NONE);
+		buf = memtx_art_encode_part(buf, part->type, field);
+	}
+	return buf;
+}
+
+/**
+ * Encode the key of a tuple on the fiber region. The key size is
+ * returned in @a len.
+ */
+static unsigned char *
+memtx_art_encode_tuple_on_region(struct key_def *key_def,
+				 struct tuple *tuple, uint32_t *len)
+{
+	uint32_t size = memtx_art_tuple_key_size_max(key_def, tuple);
+	unsigned char *buf = (unsigned char *)
+		xregion_alloc(&fiber()->gc, size);
+	*len = memtx_art_encode_tuple(key_def, tuple, buf) - buf;
+	return buf;
+}
+
+/**
+ * Key callback of the tree. The key is encoded to a buffer owned by
+ * the index, because the callback is invoked while the tree is being
+ * searched for another key allocated on the fiber region.
+ */
+static const unsigned char *
+memtx_art_index_key_of(void *record, uint32_t *len, void *ctx)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)ctx;
+	struct key_def *key_def = index->base.def->key_def;
+	struct tuple *tuple = (struct tuple *)record;
+	uint32_t size = memtx_art_tuple_key_size_max(key_def, tuple);
+	if (size > index->key_buf_size) {
+		index->key_buf_size = MAX(size, 2 * index->key_buf_size);
+		index->key_buf = (unsigned char *)
+			xrealloc(index->key_buf, index->key_buf_size);
+	}
+	*len = memtx_art_encode_tuple(key_def, tuple, index->key_buf) -
+	       index->key_buf;
+	return index->key_buf;
+}
+
+/* }}} */
+
+/* {{{ Node allocation ******************************************/
+
+static struct mempool *
+memtx_art_index_node_pool(struct memtx_art_index *index, size_t size)
+{
+	for (int i = 0; i < ART_NODE_SIZE_COUNT; i++) {
+		struct mempool *pool = &index->node_pools[i];
+		if (!mempool_is_initialized(pool)) {
+			struct memtx_engine *memtx =
+				(struct memtx_engine *)index->base.engine;
+			mempool_create(pool, &memtx->index_slab_cache, size);
+			return pool;
+		}
+		if (pool->objsize == size)
+			return pool;
+	}
+	unreachable();
+	return NULL;
+}
+
+static void *
+memtx_art_index_node_alloc(void *ctx, size_t size)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)ctx;
+	void *node = mempool_alloc(memtx_art_index_node_pool(index, size));
+	if (node == NULL)
+		diag_set(OutOfMemory, size, "mempool", "memtx_art_index node");
+	return node;
+}
+
+static void
+memtx_art_index_node_free(void *ctx, void *ptr, size_t size)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)ctx;
+	mempool_free(memtx_art_index_node_pool(index, size), ptr);
+}
+
+/* }}} */
+
+/* {{{ Iterators ************************************************/
+
+struct art_iterator {
+	struct iterator base;
+	/** Iterator type. */
+	enum iterator_type type;
+	/** Number of parts in the search key. */
+	uint32_t part_count;
+	/** Search key. */
+	const char *key;
+	/**
+	 * Tuple returned last, referenced, or NULL if the iterator
+	 * hasn't been positioned yet. Next tuples are looked up by
+	 * the key of this tuple so the iterator stays valid no matter
+	 * how the index is modified.
+	 */
+	struct tuple *last;
+	/** Memory pool the iterator was allocated from. */
+	struct mempool *pool;
+};
+
+static_assert(sizeof(struct art_iterator) <= MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct art_iterator) must be less than or equal "
+	      "to MEMTX_ITERATOR_SIZE");
+
+static void
+art_iterator_free(struct iterator *iterator)
+{
+	struct art_iterator *it = (struct art_iterator *)iterator;
+	if (it->last != NULL)
+		tuple_unref(it->last);
+	mempool_free(it->pool, it);
+}
+
+/** Look up the next tuple in the tree, ignoring transactions. */
+static struct tuple *
+art_iterator_next_base(struct art_iterator *it,
+		       struct memtx_art_index *index)
+{
+	struct key_def *key_def = index->base.def->key_def;
+	struct art *tree = &index->tree;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	bool is_forward = iterator_direction(it->type) > 0;
+	struct tuple *tuple = NULL;
+	uint32_t len;
+	if (it->last != NULL) {
+		unsigned char *key = memtx_art_encode_tuple_on_region(
+			key_def, it->last, &len);
+		tuple = (struct tuple *)(is_forward ?
+			art_seek_ge(tree, key, len, true) :
+			art_seek_le(tree, key, len, false));
+	} else {
+		unsigned char *key = memtx_art_encode_key(
+			key_def, it->key, it->part_count, &len);
+		switch (it->type) {
+		case ITER_ALL:
+		case ITER_EQ:
+		case ITER_GE:
+			tuple = (struct tuple *)
+				art_seek_ge(tree, key, len, false);
+			break;
+		case ITER_GT:
+			tuple = (struct tuple *)
+				art_seek_ge(tree, key, len, true);
+			break;
+		case ITER_REQ:
+		case ITER_LE:
+			tuple = (struct tuple *)
+				art_seek_le(tree, key, len, true);
+			break;
+		case ITER_LT:
+			tuple = (struct tuple *)
+				art_seek_le(tree, key, len, false);
+			break;
+		default:
+			unreachable();
+		}
+	}
+	region_truncate(region, region_svp);
+	if (tuple != NULL && (it->type == ITER_EQ || it->type == ITER_REQ) &&
+	    tuple_compare_with_key(tuple, HINT_NONE, it->key, it->part_count,
+				   HINT_NONE, key_def) != 0)
+		tuple = NULL;
+	if (it->last != NULL)
+		tuple_unref(it->last);
+	it->last = tuple;
+	if (tuple != NULL)
+		tuple_ref(tuple);
+	else
+		it->base.next_internal = exhausted_iterator_next;
+	return tuple;
+}
+
+static int
+art_iterator_next(struct iterator *iterator, struct tuple **ret)
+{
+	struct art_iterator *it = (struct art_iterator *)iterator;
+	struct txn *txn = in_txn();
+	struct space *space;
+	struct index *index;
+	index_weak_ref_get_checked(&iterator->index_ref, &space, &index);
+	do {
+		*ret = art_iterator_next_base(
+			it, (struct memtx_art_index *)index);
+		if (*ret == NULL)
+			return 0;
+		*ret = memtx_tx_tuple_clarify(txn, space, *ret, index, 0);
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		memtx_tx_story_gc();
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	} while (*ret == NULL);
+	return 0;
+}
+
+/** Look up a tuple by a full key, tracking the key if it's not found. */
+static struct tuple *
+memtx_art_index_find(struct memtx_art_index *index, const char *key)
+{
+	struct index *base = &index->base;
+	struct key_def *key_def = base->def->key_def;
+	struct space *space = space_by_id(base->def->space_id);
+	struct txn *txn = in_txn();
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t len;
+	unsigned char *art_key = memtx_art_encode_key(key_def, key,
+						      key_def->part_count,
+						      &len);
+	struct tuple *tuple = (struct tuple *)
+		art_find(&index->tree, art_key, len);
+	region_truncate(region, region_svp);
+	if (tuple != NULL) {
+		tuple = memtx_tx_tuple_clarify(txn, space, tuple, base, 0);
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		memtx_tx_story_gc();
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	} else {
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		memtx_tx_track_point(txn, space, base, key);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	}
+	return tuple;
+}
+
+/** Iterator over the tuple matching a full key. */
+static int
+art_iterator_point(struct iterator *iterator, struct tuple **ret)
+{
+	struct art_iterator *it = (struct art_iterator *)iterator;
+	iterator->next_internal = exhausted_iterator_next;
+	struct memtx_art_index *index = (struct memtx_art_index *)
+		index_weak_ref_get_index_checked(&iterator->index_ref);
+	*ret = memtx_art_index_find(index, it->key);
+	return 0;
+}
+
+/* }}} */
+
+/* {{{ Index ****************************************************/
+
+static void
+memtx_art_index_free(struct memtx_art_index *index)
+{
+	/* The tree nodes are freed along with the pools. */
+	for (int i = 0; i < ART_NODE_SIZE_COUNT; i++) {
+		if (mempool_is_initialized(&index->node_pools[i]))
+			mempool_destroy(&index->node_pools[i]);
+	}
+	free(index->gc_tuples);
+	free(index->key_buf);
+	free(index);
+}
+
+static void
+memtx_art_index_gc_run(struct memtx_gc_task *task, bool *done)
+{
+	/*
+	 * Yield every 1K tuples to keep latency < 0.1 ms.
+	 * Yield more often in debug mode.
+	 */
+#ifdef NDEBUG
+	enum { YIELD_LOOPS = 1000 };
+#else
+	enum { YIELD_LOOPS = 10 };
+#endif
+
+	struct memtx_art_index *index = container_of(task,
+			struct memtx_art_index, gc_task);
+	unsigned int loops = 0;
+	while (index->gc_tuple_pos < index->gc_tuple_count) {
+		tuple_unref(index->gc_tuples[index->gc_tuple_pos++]);
+		if (++loops >= YIELD_LOOPS) {
+			*done = false;
+			return;
+		}
+	}
+	*done = true;
+}
+
+static void
+memtx_art_index_gc_free(struct memtx_gc_task *task)
+{
+	struct memtx_art_index *index = container_of(task,
+			struct memtx_art_index, gc_task);
+	memtx_art_index_free(index);
+}
+
+static const struct memtx_gc_task_vtab memtx_art_index_gc_vtab = {
+	.run = memtx_art_index_gc_run,
+	.free = memtx_art_index_gc_free,
+};
+
+/** art_foreach() callback collecting tuples to an array. */
+static int
+memtx_art_index_collect(void *record, void *arg)
+{
+	struct tuple ***pos = (struct tuple ***)arg;
+	*(*pos)++ = (struct tuple *)record;
+	return 0;
+}
+
+/** Return all tuples stored in the index in the key order. */
+static struct tuple **
+memtx_art_index_tuples(struct memtx_art_index *index)
+{
+	size_t count = art_size(&index->tree);
+	struct tuple **tuples = (struct tuple **)
+		xmalloc(MAX(count, (size_t)1) * sizeof(*tuples));
+	struct tuple **pos = tuples;
+	art_foreach(&index->tree, memtx_art_index_collect, &pos);
+	assert((size_t)(pos - tuples) == count);
+	return tuples;
+}
+
+static void
+memtx_art_index_destroy(struct index *base)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	if (base->def->iid == 0) {
+		/*
+		 * Primary index. We need to free all tuples stored
+		 * in the index, which may take a while. Schedule a
+		 * background task in order not to block tx thread.
+		 */
+		index->gc_tuples = memtx_art_index_tuples(index);
+		index->gc_tuple_count = art_size(&index->tree);
+		index->gc_tuple_pos = 0;
+		index->gc_task.vtab = &memtx_art_index_gc_vtab;
+		memtx_engine_schedule_gc(memtx, &index->gc_task);
+	} else {
+		/*
+		 * Secondary index. Destruction is fast, no need to
+		 * hand over to background fiber.
+		 */
+		memtx_art_index_free(index);
+	}
+}
+
+static ssize_t
+memtx_art_index_size(struct index *base)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct space *space = space_by_id(base->def->space_id);
+	/* Substract invisible count. */
+	return art_size(&index->tree) -
+	       memtx_tx_index_invisible_count(in_txn(), space, base);
+}
+
+static ssize_t
+memtx_art_index_bsize(struct index *base)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	return index->tree.mem_used;
+}
+
+static ssize_t
+memtx_art_index_count(struct index *base, enum iterator_type type,
+		      const char *key, uint32_t part_count)
+{
+	if (type == ITER_ALL)
+		return memtx_art_index_size(base); /* optimization */
+	return generic_index_count(base, type, key, part_count);
+}
+
+static int
+memtx_art_index_get_internal(struct index *base, const char *key,
+			     uint32_t part_count, struct tuple **result)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
+	(void)part_count;
+	*result = memtx_art_index_find(index, key);
+	return 0;
+}
+
+static int
+memtx_art_index_replace(struct index *base, struct tuple *old_tuple,
+			struct tuple *new_tuple, enum dup_replace_mode mode,
+			struct tuple **result, struct tuple **successor)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct key_def *key_def = base->def->key_def;
+	struct art *tree = &index->tree;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t len;
+
+	/*
+	 * Range reads from the index are tracked as full scans by
+	 * the transaction manager so successors aren't needed.
+	 */
+	*successor = NULL;
+
+	if (new_tuple != NULL) {
+		unsigned char *key = memtx_art_encode_tuple_on_region(
+			key_def, new_tuple, &len);
+		void *dup = NULL;
+		if (art_insert(tree, key, len, new_tuple, &dup) != 0) {
+			region_truncate(region, region_svp);
+			return -1;
+		}
+		struct tuple *dup_tuple = (struct tuple *)dup;
+		if (index_check_dup(base, old_tuple, new_tuple,
+				    dup_tuple, mode) != 0) {
+			/* Restoring a replaced tuple never fails. */
+			if (dup_tuple != NULL)
+				VERIFY(art_insert(tree, key, len, dup_tuple,
+						  &dup) == 0);
+			else
+				art_delete(tree, key, len);
+			region_truncate(region, region_svp);
+			return -1;
+		}
+		if (dup_tuple != NULL) {
+			region_truncate(region, region_svp);
+			*result = dup_tuple;
+			return 0;
+		}
+	}
+	if (old_tuple != NULL) {
+		unsigned char *key = memtx_art_encode_tuple_on_region(
+			key_def, old_tuple, &len);
+		void *deleted = art_delete(tree, key, len);
+		assert(deleted == old_tuple);
+		(void)deleted;
+	}
+	region_truncate(region, region_svp);
+	*result = old_tuple;
+	return 0;
+}
+
+static struct iterator *
+memtx_art_index_create_iterator(struct index *base, enum iterator_type type,
+				const char *key, uint32_t part_count,
+				const char *pos)
+{
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+
+	assert(part_count == 0 || key != NULL);
+	if (pos != NULL) {
+		diag_set(UnsupportedIndexFeature, base->def, "pagination");
+		return NULL;
+	}
+	switch (type) {
+	case ITER_ALL:
+	case ITER_EQ:
+	case ITER_REQ:
+	case ITER_GE:
+	case ITER_GT:
+	case ITER_LE:
+	case ITER_LT:
+		break;
+	default:
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		return NULL;
+	}
+	if (part_count == 0) {
+		/* An empty key matches all tuples. */
+		type = iterator_direction(type) > 0 ? ITER_GE : ITER_LE;
+	}
+
+	struct art_iterator *it = (struct art_iterator *)
+		mempool_alloc(&memtx->iterator_pool);
+	if (it == NULL) {
+		diag_set(OutOfMemory, sizeof(struct art_iterator),
+			 "memtx_art_index", "iterator");
+		return NULL;
+	}
+	iterator_create(&it->base, base);
+	it->pool = &memtx->iterator_pool;
+	it->base.free = art_iterator_free;
+	it->base.next = memtx_iterator_next;
+	it->base.position = generic_iterator_position;
+	it->type = type;
+	it->key = key;
+	it->part_count = part_count;
+	it->last = NULL;
+	if ((type == ITER_EQ || type == ITER_REQ) &&
+	    part_count == base->def->key_def->part_count) {
+		/* The index is unique, at most one tuple matches. */
+		it->base.next_internal = art_iterator_point;
+	} else {
+		it->base.next_internal = art_iterator_next;
+		struct space *space = space_by_id(base->def->space_id);
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		memtx_tx_track_full_scan(in_txn(), space, &index->base);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+	}
+	return (struct iterator *)it;
+}
+
+/* }}} */
+
+/* {{{ Read view ************************************************/
+
+/**
+ * Read view implementation. The tree nodes are updated in place so
+ * the read view stores a sorted array of the index tuples.
+ */
+struct art_read_view {
+	/** Base class. */
+	struct index_read_view base;
+	/** Index tuples in the key order. */
+	struct tuple **tuples;
+	/** Number of tuples. */
+	size_t tuple_count;
+	/** Used for clarifying read view tuples. */
+	struct memtx_tx_snapshot_cleaner cleaner;
+};
+
+/** Read view iterator implementation. */
+struct art_read_view_iterator {
+	/** Base class. */
+	struct index_read_view_iterator_base base;
+	/** Position of the next tuple in the read view. */
+	size_t pos;
+};
+
+static_assert(sizeof(struct art_read_view_iterator) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct art_read_view_iterator) must be less than or "
+	      "equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+
+static void
+art_read_view_free(struct index_read_view *base)
+{
+	struct art_read_view *rv = (struct art_read_view *)base;
+	free(rv->tuples);
+	memtx_tx_snapshot_cleaner_destroy(&rv->cleaner);
+	TRASH(rv);
+	free(rv);
+}
+
+static int
+art_read_view_get_raw(struct index_read_view *base,
+		      const char *key, uint32_t part_count,
+		      struct read_view_tuple *result)
+{
+	struct art_read_view *rv = (struct art_read_view *)base;
+	struct key_def *key_def = base->def->key_def;
+	assert(part_count == key_def->part_count);
+	size_t begin = 0;
+	size_t end = rv->tuple_count;
+	while (begin < end) {
+		size_t mid = begin + (end - begin) / 2;
+		int cmp = tuple_compare_with_key(rv->tuples[mid], HINT_NONE,
+						 key, part_count, HINT_NONE,
+						 key_def);
+		if (cmp == 0) {
+			return memtx_prepare_read_view_tuple(
+				rv->tuples[mid], base, &rv->cleaner, result);
+		}
+		if (cmp < 0)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+	*result = read_view_tuple_none();
+	return 0;
+}
+
+/** Implementation of next_raw index_read_view_iterator callback. */
+static int
+art_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
+				struct read_view_tuple *result)
+{
+	struct art_read_view_iterator *it =
+		(struct art_read_view_iterator *)iterator;
+	struct art_read_view *rv = (struct art_read_view *)it->base.index;
+	while (it->pos < rv->tuple_count) {
+		struct tuple *tuple = rv->tuples[it->pos++];
+		if (memtx_prepare_read_view_tuple(tuple, &rv->base,
+						  &rv->cleaner, result) != 0)
+			return -1;
+		if (result->data != NULL)
+			return 0;
+	}
+	*result = read_view_tuple_none();
+	return 0;
+}
+
+/** Implementation of create_iterator index_read_view callback. */
+static int
+art_read_view_create_iterator(struct index_read_view *base,
+			      enum iterator_type type,
+			      const char *key, uint32_t part_count,
+			      const char *pos,
+			      struct index_read_view_iterator *iterator)
+{
+	if (pos != NULL) {
+		diag_set(UnsupportedIndexFeature, base->def, "pagination");
+		return -1;
+	}
+	if (type != ITER_ALL || part_count > 0) {
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested read view iterator type");
+		return -1;
+	}
+	(void)key;
+	struct art_read_view_iterator *it =
+		(struct art_read_view_iterator *)iterator;
+	it->base.index = base;
+	it->base.destroy = generic_index_read_view_iterator_destroy;
+	it->base.next_raw = art_read_view_iterator_next_raw;
+	it->base.position = generic_index_read_view_iterator_position;
+	it->pos = 0;
+	return 0;
+}
+
+/** Implementation of create_read_view index callback. */
+static struct index_read_view *
+memtx_art_index_create_read_view(struct index *base)
+{
+	static const struct index_read_view_vtab vtab = {
+		.free = art_read_view_free,
+		.get_raw = art_read_view_get_raw,
+		.create_iterator = art_read_view_create_iterator,
+	};
+	struct memtx_art_index *index = (struct memtx_art_index *)base;
+	struct art_read_view *rv =
+		(struct art_read_view *)xmalloc(sizeof(*rv));
+	index_read_view_create(&rv->base, &vtab, base->def);
+	struct space *space = space_by_id(base->def->space_id);
+	assert(space != NULL);
+	memtx_tx_snapshot_cleaner_create(&rv->cleaner, space);
+	/*
+	 * Tuples aren't freed while there are read views that may
+	 * access them, so it's enough to remember tuple pointers.
+	 */
+	rv->tuples = memtx_art_index_tuples(index);
+	rv->tuple_count = art_size(&index->tree);
+	return (struct index_read_view *)rv;
+}
+
+/* }}} */
+
+static const struct index_vtab memtx_art_index_vtab = {
+	/* .destroy = */ memtx_art_index_destroy,
+	/* .commit_create = */ generic_index_commit_create,
+	/* .abort_create = */ generic_index_abort_create,
+	/* .commit_modify = */ generic_index_commit_modify,
+	/* .commit_drop = */ generic_index_commit_drop,
+	/* .update_def = */ generic_index_update_def,
+	/* .depends_on_pk = */ generic_index_depends_on_pk,
+	/* .def_change_requires_rebuild = */
+		memtx_index_def_change_requires_rebuild,
+	/* .size = */ memtx_art_index_size,
+	/* .bsize = */ memtx_art_index_bsize,
+	/* .min = */ generic_index_min,
+	/* .max = */ generic_index_max,
+	/* .random = */ generic_index_random,
+	/* .count = */ memtx_art_index_count,
+	/* .approximate_count = */ generic_index_approximate_count,
+	/* .get_internal = */ memtx_art_index_get_internal,
+	/* .get = */ memtx_index_get,
+	/* .get_batch = */ generic_index_get_batch,
+	/* .replace = */ memtx_art_index_replace,
+	/* .create_iterator = */ memtx_art_index_create_iterator,
+	/* .create_read_view = */ memtx_art_index_create_read_view,
+	/* .stat = */ generic_index_stat,
+	/* .compact = */ generic_index_compact,
+	/* .reset_stat = */ generic_index_reset_stat,
+	/* .begin_build = */ generic_index_begin_build,
+	/* .reserve = */ generic_index_reserve,
+	/* .build_next = */ generic_index_build_next,
+	/* .end_build = */ generic_index_end_build,
+};
+
+struct index *
+memtx_art_index_new(struct memtx_engine *memtx, struct index_def *def)
+{
+	struct memtx_art_index *index =
+		(struct memtx_art_index *)xcalloc(1, sizeof(*index));
+	index_create(&index->base, (struct engine *)memtx,
+		     &memtx_art_index_vtab, def);
+	art_create(&index->tree, memtx_art_index_key_of,
+		   memtx_art_index_node_alloc, memtx_art_index_node_free,
+		   index);
+	return &index->base;
+}
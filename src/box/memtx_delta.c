@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_delta.h"
+
+#include <PMurHash.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assoc.h"
+#include "trivia/util.h"
+
+static inline uint32_t
+memtx_delta_key_hash(uint32_t space_id, const char *data, uint32_t size)
+{
+	uint32_t h = 13;
+	uint32_t carry = 0;
+	PMurHash32_Process(&h, &carry, &space_id, sizeof(space_id));
+	PMurHash32_Process(&h, &carry, data, size);
+	return PMurHash32_Result(h, carry, sizeof(space_id) + size);
+}
+
+/** Lookup key: the key data is compared with memcmp(). */
+struct memtx_delta_lookup {
+	uint32_t hash;
+	uint32_t space_id;
+	const char *data;
+	uint32_t size;
+};
+
+static inline bool
+memtx_delta_key_equal(const struct memtx_delta_key *a,
+		      const struct memtx_delta_key *b)
+{
+	return a->space_id == b->space_id && a->size == b->size &&
+	       memcmp(a->data, b->data, a->size) == 0;
+}
+
+static inline bool
+memtx_delta_lookup_equal(const struct memtx_delta_lookup *a,
+			 const struct memtx_delta_key *b)
+{
+	return a->space_id == b->space_id && a->size == b->size &&
+	       memcmp(a->data, b->data, a->size) == 0;
+}
+
+#define MH_SOURCE 1
+#define mh_name _memtx_delta
+#define mh_key_t const struct memtx_delta_lookup *
+#define mh_node_t struct memtx_delta_key *
+#define mh_arg_t void *
+#define mh_hash(a, arg) ((*(a))->hash)
+#define mh_hash_key(a, arg) ((a)->hash)
+#define mh_cmp(a, b, arg) (!memtx_delta_key_equal(*(a), *(b)))
+#define mh_cmp_key(a, b, arg) (!memtx_delta_lookup_equal((a), *(b)))
+#include "salad/mhash.h"
+
+struct memtx_delta_set {
+	/** Changed keys. */
+	struct mh_memtx_delta_t *keys;
+	/** Ids of spaces that have changed keys. */
+	struct mh_i32_t *spaces;
+};
+
+struct memtx_delta_set *
+memtx_delta_set_new(void)
+{
+	struct memtx_delta_set *set = xmalloc(sizeof(*set));
+	set->keys = mh_memtx_delta_new();
+	set->spaces = mh_i32_new();
+	return set;
+}
+
+void
+memtx_delta_set_delete(struct memtx_delta_set *set)
+{
+	mh_int_t i;
+	mh_foreach(set->keys, i)
+		free(*mh_memtx_delta_node(set->keys, i));
+	mh_memtx_delta_delete(set->keys);
+	mh_i32_delete(set->spaces);
+	free(set);
+}
+
+size_t
+memtx_delta_set_size(struct memtx_delta_set *set)
+{
+	return mh_size(set->keys);
+}
+
+bool
+memtx_delta_set_has_space(struct memtx_delta_set *set, uint32_t space_id)
+{
+	return mh_i32_find(set->spaces, space_id, NULL) != mh_end(set->spaces);
+}
+
+/** Insert a key unless it's already in the set. Frees a duplicate. */
+static void
+memtx_delta_set_put(struct memtx_delta_set *set, struct memtx_delta_key *key)
+{
+	struct memtx_delta_lookup lookup = {
+		.hash = key->hash,
+		.space_id = key->space_id,
+		.data = key->data,
+		.size = key->size,
+	};
+	if (mh_memtx_delta_find(set->keys, &lookup, NULL) !=
+	    mh_end(set->keys)) {
+		free(key);
+		return;
+	}
+	key->is_written = false;
+	const struct memtx_delta_key *node = key;
+	mh_memtx_delta_put(set->keys, &node, NULL, NULL);
+	mh_i32_put(set->spaces, &key->space_id, NULL, NULL);
+}
+
+void
+memtx_delta_set_add(struct memtx_delta_set *set, uint32_t space_id,
+		    const char *data, uint32_t size)
+{
+	struct memtx_delta_lookup lookup = {
+		.hash = memtx_delta_key_hash(space_id, data, size),
+		.space_id = space_id,
+		.data = data,
+		.size = size,
+	};
+	if (mh_memtx_delta_find(set->keys, &lookup, NULL) != mh_end(set->keys))
+		return;
+	struct memtx_delta_key *key = xmalloc(sizeof(*key) + size);
+	key->hash = lookup.hash;
+	key->space_id = space_id;
+	key->is_written = false;
+	key->size = size;
+	memcpy(key->data, data, size);
+	const struct memtx_delta_key *node = key;
+	mh_memtx_delta_put(set->keys, &node, NULL, NULL);
+	mh_i32_put(set->spaces, &space_id, NULL, NULL);
+}
+
+struct memtx_delta_key *
+memtx_delta_set_find(struct memtx_delta_set *set, uint32_t space_id,
+		     const char *data, uint32_t size)
+{
+	struct memtx_delta_lookup lookup = {
+		.hash = memtx_delta_key_hash(space_id, data, size),
+		.space_id = space_id,
+		.data = data,
+		.size = size,
+	};
+	mh_int_t i = mh_memtx_delta_find(set->keys, &lookup, NULL);
+	if (i == mh_end(set->keys))
+		return NULL;
+	return *mh_memtx_delta_node(set->keys, i);
+}
+
+void
+memtx_delta_set_merge(struct memtx_delta_set *dst,
+		      struct memtx_delta_set *src)
+{
+	mh_int_t i;
+	mh_foreach(src->keys, i)
+		memtx_delta_set_put(dst, *mh_memtx_delta_node(src->keys, i));
+	mh_memtx_delta_clear(src->keys);
+	memtx_delta_set_delete(src);
+}
+
+int
+memtx_delta_set_foreach(struct memtx_delta_set *set, memtx_delta_key_cb cb,
+			void *arg)
+{
+	mh_int_t i;
+	mh_foreach(set->keys, i) {
+		if (cb(*mh_memtx_delta_node(set->keys, i), arg) != 0)
+			return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Primary key of a tuple changed since the last checkpoint.
+ */
+struct memtx_delta_key {
+	/** Hash of the space id and the key. */
+	uint32_t hash;
+	/** Id of the space the key belongs to. */
+	uint32_t space_id;
+	/** Set once a tuple with this key was written to a delta snapshot. */
+	bool is_written;
+	/** Size of the key. */
+	uint32_t size;
+	/** MsgPack array of the primary key parts. */
+	char data[0];
+};
+
+/**
+ * Set of primary keys of tuples changed since the last checkpoint,
+ * used for writing a delta snapshot.
+ */
+struct memtx_delta_set;
+
+/** Allocate an empty set of changed keys. */
+struct memtx_delta_set *
+memtx_delta_set_new(void);
+
+/** Free a set of changed keys. */
+void
+memtx_delta_set_delete(struct memtx_delta_set *set);
+
+/** Return the number of keys in the set. */
+size_t
+memtx_delta_set_size(struct memtx_delta_set *set);
+
+/** Return true if the set contains any key of the given space. */
+bool
+memtx_delta_set_has_space(struct memtx_delta_set *set, uint32_t space_id);
+
+/** Add a key to the set unless it's already there. */
+void
+memtx_delta_set_add(struct memtx_delta_set *set, uint32_t space_id,
+		    const char *data, uint32_t size);
+
+/** Look up a key in the set. Returns NULL if not found. */
+struct memtx_delta_key *
+memtx_delta_set_find(struct memtx_delta_set *set, uint32_t space_id,
+		     const char *data, uint32_t size);
+
+/** Move all keys from @a src to @a dst and delete @a src. */
+void
+memtx_delta_set_merge(struct memtx_delta_set *dst,
+		      struct memtx_delta_set *src);
+
+typedef int
+(*memtx_delta_key_cb)(struct memtx_delta_key *key, void *arg);
+
+/**
+ * Call @a cb for each key of the set. Stops and returns -1 if
+ * the callback returns a non-zero value.
+ */
+int
+memtx_delta_set_foreach(struct memtx_delta_set *set, memtx_delta_key_cb cb,
+			void *arg);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -30,6 +30,11 @@
  */
 #include "memtx_engine.h"
 
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <small/quota.h>
 #include <small/small.h>
 #include <small/mempool.h>
@@ -58,6 +63,7 @@
 #include "index.h"
 #include "read_view.h"
 #include "memtx_tuple_compression.h"
+#include "memtx_delta.h"
 #include "memtx_space.h"
 #include "memtx_space_upgrade.h"
 #include "tt_sort.h"
@@ -88,11 +94,16 @@ static inline struct tuple *
 memtx_tuple_new_raw_impl(struct tuple_format *format, const char *data,
 			 const char *end, bool validate);
 
+/** MemtxAllocator::relocate_tuple() of the tuple allocator in use. */
+static struct tuple *
+(*memtx_tuple_relocate)(struct tuple *tuple);
+
 template <class ALLOC>
 static void
 memtx_alloc_init(void)
 {
 	memtx_tuple_new_raw = memtx_tuple_new_raw_impl<ALLOC>;
+	memtx_tuple_relocate = MemtxAllocator<ALLOC>::relocate_tuple;
 }
 
 static int
@@ -100,7 +111,7 @@ memtx_end_build_primary_key(struct space *space, void *param)
 {
 	struct memtx_space *memtx_space = (struct memtx_space *)space;
 	if (space->engine != param || space_index(space, 0) == NULL ||
-	    memtx_space->replace == memtx_space_replace_all_keys)
+	    memtx_space->replace != memtx_space_replace_build_next)
 		return 0;
 
 	index_end_build(space->index[0]);
@@ -191,6 +202,176 @@ memtx_build_secondary_keys(struct space *space, void *param)
 	return 0;
 }
 
+/**
+ * Defers building of secondary keys of a space till the background
+ * build started after recovery, see memtx_engine_deferred_build_f().
+ * Until then, the space can't be modified and its secondary indexes
+ * can't be read.
+ */
+static int
+memtx_defer_secondary_keys(struct space *space, void *param)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)param;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (space->engine != &memtx->base || space_index(space, 0) == NULL ||
+	    memtx_space->replace == memtx_space_replace_all_keys)
+		return 0;
+	/* Nothing to build, enable the space right away. */
+	if (space->index_count == 1 || index_size(space->index[0]) == 0)
+		return memtx_build_secondary_keys(space, memtx);
+
+	for (uint32_t j = 1; j < space->index_count; j++)
+		space->index[j]->needs_build = true;
+	memtx_space->replace = memtx_space_replace_deferred_keys;
+	memtx->deferred_space_ids = (uint32_t *)xrealloc(
+		memtx->deferred_space_ids,
+		(memtx->deferred_space_count + 1) *
+		sizeof(*memtx->deferred_space_ids));
+	memtx->deferred_space_ids[memtx->deferred_space_count++] =
+		space_id(space);
+	return 0;
+}
+
+/**
+ * Builds secondary keys of a space deferred by
+ * memtx_defer_secondary_keys(). Indexes become readable one by one,
+ * the space becomes writable once all of them are built. Building
+ * an index may yield, but the space can't be altered or changed
+ * meanwhile, so it's safe.
+ */
+static int
+memtx_build_deferred_keys(struct space *space)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	assert(memtx_space->replace == memtx_space_replace_deferred_keys);
+	struct index *pk = space->index[0];
+	say_info("Building secondary indexes in space '%s'...",
+		 space_name(space));
+	for (uint32_t j = 1; j < space->index_count; j++) {
+		struct index *index = space->index[j];
+		if (!index->needs_build)
+			continue;
+		if (memtx_build_secondary_index(index, pk) != 0)
+			return -1;
+		index->needs_build = false;
+	}
+	say_info("Space '%s': done", space_name(space));
+	memtx_space->replace = memtx_space_replace_all_keys;
+	return 0;
+}
+
+/**
+ * Fiber building secondary keys of spaces deferred after recovery
+ * one by one, yielding between spaces to serve requests.
+ */
+static int
+memtx_engine_deferred_build_f(va_list ap)
+{
+	struct memtx_engine *memtx = va_arg(ap, struct memtx_engine *);
+	while (memtx->deferred_space_pos < memtx->deferred_space_count) {
+		ERROR_INJECT_YIELD(ERRINJ_MEMTX_INDEX_BUILD_DELAY);
+		uint32_t id =
+			memtx->deferred_space_ids[memtx->deferred_space_pos];
+		struct space *space = space_by_id(id);
+		/*
+		 * On failure the space is left unavailable: it's as good
+		 * as a failure to start.
+		 */
+		if (space != NULL && memtx_build_deferred_keys(space) != 0) {
+			say_error("failed to build secondary indexes of "
+				  "space '%s'", space_name(space));
+			diag_log();
+			diag_clear(diag_get());
+		}
+		memtx->deferred_space_pos++;
+		fiber_sleep(0);
+	}
+	free(memtx->deferred_space_ids);
+	memtx->deferred_space_ids = NULL;
+	memtx->deferred_space_count = 0;
+	memtx->deferred_space_pos = 0;
+	say_info("background build of secondary indexes completed");
+	memtx->on_indexes_built_cb();
+	return 0;
+}
+
+/**
+ * Defers building of secondary keys of all spaces recovered without
+ * them and starts a fiber building them in background.
+ */
+static int
+memtx_engine_defer_secondary_keys(struct memtx_engine *memtx)
+{
+	assert(memtx->deferred_space_ids == NULL);
+	if (space_foreach(memtx_defer_secondary_keys, memtx) != 0)
+		return -1;
+	if (memtx->deferred_space_count == 0) {
+		memtx->on_indexes_built_cb();
+		return 0;
+	}
+	say_info("building secondary indexes of %d spaces in background",
+		 memtx->deferred_space_count);
+	struct fiber *fiber = fiber_new_system("memtx.index_build",
+					       memtx_engine_deferred_build_f);
+	if (fiber == NULL)
+		return -1;
+	fiber_start(fiber, memtx);
+	return 0;
+}
+
+/** Order of a secondary index loaded from the snapshot. */
+struct memtx_index_order {
+	/** Positions of the index tuples in the primary index. */
+	uint32_t *positions;
+	/** Number of loaded positions. */
+	size_t size;
+};
+
+/** Returns the key of an index in memtx_engine::index_orders. */
+static inline uint64_t
+memtx_index_order_key(uint32_t space_id, uint32_t index_id)
+{
+	return (uint64_t)space_id << 32 | index_id;
+}
+
+/** Frees the index orders loaded from the snapshot. */
+static void
+memtx_engine_free_index_orders(struct memtx_engine *memtx)
+{
+	struct mh_i64ptr_t *h = memtx->index_orders;
+	if (h == NULL)
+		return;
+	mh_int_t k;
+	mh_foreach(h, k) {
+		struct memtx_index_order *order =
+			(struct memtx_index_order *)mh_i64ptr_node(h, k)->val;
+		free(order->positions);
+		free(order);
+	}
+	mh_i64ptr_delete(h);
+	memtx->index_orders = NULL;
+}
+
+uint32_t *
+memtx_engine_take_index_order(struct memtx_engine *memtx, uint32_t space_id,
+			      uint32_t index_id, size_t *size)
+{
+	struct mh_i64ptr_t *h = memtx->index_orders;
+	if (h == NULL)
+		return NULL;
+	mh_int_t k = mh_i64ptr_find(h, memtx_index_order_key(space_id,
+							     index_id), NULL);
+	if (k == mh_end(h))
+		return NULL;
+	struct memtx_index_order *order =
+		(struct memtx_index_order *)mh_i64ptr_node(h, k)->val;
+	mh_i64ptr_del(h, k, NULL);
+	uint32_t *positions = order->positions;
+	*size = order->size;
+	free(order);
+	return positions;
+}
+
 static void
 memtx_engine_free(struct engine *engine)
 {
@@ -218,6 +399,11 @@ memtx_engine_free(struct engine *engine)
 	tuple_arena_destroy(&memtx->arena);
 
 	xdir_destroy(&memtx->snap_dir);
+	xdir_destroy(&memtx->delta_dir);
+	if (memtx->delta_set != NULL)
+		memtx_delta_set_delete(memtx->delta_set);
+	memtx_engine_free_index_orders(memtx);
+	free(memtx->deferred_space_ids);
 	tuple_format_unref(memtx->func_key_format);
 	free(memtx);
 }
@@ -247,31 +433,62 @@ static int
 memtx_engine_recover_snapshot_row(struct xrow_header *row,
 				  enum snapshot_recovery_state *state);
 
-int
-memtx_engine_recover_snapshot(struct memtx_engine *memtx,
-			      const struct vclock *vclock)
+/**
+ * Recovers one xrow from a delta snapshot.
+ *
+ * @retval -1 error, diagnostic set
+ * @retval 0 success
+ */
+static int
+memtx_engine_recover_delta_row(struct xrow_header *row);
+
+/**
+ * Recovers the engine from a snapshot file. If @a dir is the delta
+ * snapshot directory, the file is applied on top of the checkpoint
+ * with @a prev_vclock, which must have been recovered before. Raft
+ * and synchro state is recovered only if @a recover_state is set.
+ */
+static int
+memtx_engine_recover_snapshot_file(struct memtx_engine *memtx,
+				   struct xdir *dir,
+				   const struct vclock *vclock,
+				   const struct vclock *prev_vclock,
+				   bool recover_state)
 {
-	/* Process existing snapshot */
-	say_info("recovery start");
+	bool is_delta = dir == &memtx->delta_dir;
 	int64_t signature = vclock_sum(vclock);
-	const char *filename = xdir_format_filename(&memtx->snap_dir,
-						    signature, NONE);
+	const char *filename = xdir_format_filename(dir, signature, NONE);
 
 	say_info("recovering from `%s'", filename);
 	struct xlog_cursor cursor;
 	if (xlog_cursor_open(&cursor, filename) < 0)
 		return -1;
+	if (is_delta && vclock_compare(&cursor.meta.prev_vclock,
+				       prev_vclock) != 0) {
+		diag_set(XlogError, "delta snapshot `%s' is not based on "
+			 "checkpoint %s", cursor.name,
+			 vclock_to_string(prev_vclock));
+		xlog_cursor_close(&cursor, false);
+		return -1;
+	}
 
 	int rc;
 	struct xrow_header row;
 	uint64_t row_count = 0;
-	bool force_recovery = false;
+	bool force_recovery = is_delta && memtx->force_recovery;
 	enum snapshot_recovery_state state = SNAPSHOT_RECOVERY_NOT_STARTED;
 	while ((rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
+		if (!recover_state && (row.type == IPROTO_RAFT ||
+				       row.type == IPROTO_RAFT_PROMOTE))
+			continue;
 		row.lsn = signature;
-		rc = memtx_engine_recover_snapshot_row(&row, &state);
-		if (state == DONE_RECOVERING_SYSTEM_SPACES)
-			force_recovery = memtx->force_recovery;
+		if (is_delta) {
+			rc = memtx_engine_recover_delta_row(&row);
+		} else {
+			rc = memtx_engine_recover_snapshot_row(&row, &state);
+			if (state == DONE_RECOVERING_SYSTEM_SPACES)
+				force_recovery = memtx->force_recovery;
+		}
 		if (rc < 0) {
 			if (!force_recovery)
 				break;
@@ -305,7 +522,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	 * Snapshot entries are ordered by the space id, it means that if there
 	 * are no spaces, then all system spaces are definitely missing.
 	 */
-	if (state == SNAPSHOT_RECOVERY_NOT_STARTED) {
+	if (!is_delta && state == SNAPSHOT_RECOVERY_NOT_STARTED) {
 		diag_set(ClientError, ER_MISSING_SYSTEM_SPACES);
 		return -1;
 	}
@@ -313,6 +530,79 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	return 0;
 }
 
+/**
+ * Returns the full snapshot the checkpoint with the given vclock
+ * is based on, i.e. the newest snapshot not newer than the checkpoint,
+ * or NULL if there's no such snapshot.
+ */
+static struct vclock *
+memtx_engine_checkpoint_base(struct memtx_engine *memtx,
+			     const struct vclock *vclock)
+{
+	int64_t signature = vclock_sum(vclock);
+	vclockset_t *index = &memtx->snap_dir.index;
+	struct vclock *base;
+	for (base = vclockset_last(index); base != NULL;
+	     base = vclockset_prev(index, base)) {
+		if (vclock_sum(base) <= signature)
+			break;
+	}
+	return base;
+}
+
+int
+memtx_engine_recover_snapshot(struct memtx_engine *memtx,
+			      const struct vclock *vclock)
+{
+	/* Process existing snapshot */
+	say_info("recovery start");
+	int64_t signature = vclock_sum(vclock);
+	struct vclock *base = memtx_engine_checkpoint_base(memtx, vclock);
+	if (base == NULL) {
+		diag_set(ClientError, ER_MISSING_SNAPSHOT);
+		return -1;
+	}
+	bool is_delta = vclock_sum(base) != signature;
+	if (memtx_engine_recover_snapshot_file(memtx, &memtx->snap_dir, base,
+					       NULL, !is_delta) != 0)
+		return -1;
+	memtx->checkpoint_delta_chain = 0;
+	if (is_delta) {
+		/*
+		 * Delta snapshots replace and delete tuples so they
+		 * can't be loaded with the bulk build of primary keys.
+		 */
+		if (memtx->state == MEMTX_INITIAL_RECOVERY)
+			space_foreach(memtx_end_build_primary_key, memtx);
+		/* Index orders don't account applied changes. */
+		memtx_engine_free_index_orders(memtx);
+		vclockset_t *index = &memtx->delta_dir.index;
+		const struct vclock *prev = base;
+		for (struct vclock *delta = vclockset_first(index);
+		     delta != NULL; delta = vclockset_next(index, delta)) {
+			int64_t delta_signature = vclock_sum(delta);
+			if (delta_signature <= vclock_sum(base))
+				continue;
+			if (delta_signature > signature)
+				break;
+			if (memtx_engine_recover_snapshot_file(
+					memtx, &memtx->delta_dir, delta, prev,
+					delta_signature == signature) != 0)
+				return -1;
+			prev = delta;
+			memtx->checkpoint_delta_chain++;
+		}
+		if (vclock_sum(prev) != signature) {
+			diag_set(ClientError, ER_MISSING_SNAPSHOT);
+			return -1;
+		}
+	}
+	/* Changes are tracked from the recovered checkpoint on. */
+	if (memtx->checkpoint_delta_count > 0)
+		memtx->delta_set = memtx_delta_set_new();
+	return 0;
+}
+
 static int
 memtx_engine_recover_raft(const struct xrow_header *row)
 {
@@ -364,30 +654,11 @@ snapshot_recovery_state_update(enum snapshot_recovery_state *state,
 	return 0;
 }
 
+/** Applies a DML request read from a snapshot file. */
 static int
-memtx_engine_recover_snapshot_row(struct xrow_header *row,
-				  enum snapshot_recovery_state *state)
+memtx_engine_recover_request(struct request *request)
 {
-	assert(row->bodycnt == 1); /* always 1 for read */
-	if (row->type != IPROTO_INSERT) {
-		if (snapshot_recovery_state_update(state, false) != 0)
-			return -1;
-		if (row->type == IPROTO_RAFT)
-			return memtx_engine_recover_raft(row);
-		if (row->type == IPROTO_RAFT_PROMOTE)
-			return memtx_engine_recover_synchro(row);
-		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
-			 (uint32_t) row->type);
-		return -1;
-	}
-	struct request request;
-	RegionGuard region_guard(&fiber()->gc);
-	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
-		return -1;
-	bool is_system_space_request = space_id_is_system(request.space_id);
-	if (snapshot_recovery_state_update(state, is_system_space_request) != 0)
-		return -1;
-	struct space *space = space_cache_find(request.space_id);
+	struct space *space = space_cache_find(request->space_id);
 	if (space == NULL)
 		goto log_request;
 	/* memtx snapshot must contain only memtx spaces */
@@ -399,13 +670,13 @@ memtx_engine_recover_snapshot_row(struct xrow_header *row,
 	txn = txn_begin();
 	if (txn == NULL)
 		goto log_request;
-	if (txn_begin_stmt(txn, space, request.type) != 0)
+	if (txn_begin_stmt(txn, space, request->type) != 0)
 		goto rollback;
 	/* no access checks here - applier always works with admin privs */
 	struct tuple *unused;
-	if (space_execute_dml(space, txn, &request, &unused) != 0)
+	if (space_execute_dml(space, txn, request, &unused) != 0)
 		goto rollback_stmt;
-	if (txn_commit_stmt(txn, &request) != 0)
+	if (txn_commit_stmt(txn, request) != 0)
 		goto rollback;
 	/*
 	 * Snapshot rows are confirmed by definition. They don't need to go to
@@ -418,10 +689,185 @@ memtx_engine_recover_snapshot_row(struct xrow_header *row,
 rollback:
 	txn_abort(txn);
 log_request:
-	say_error("error at request: %s", request_str(&request));
+	say_error("error at request: %s", request_str(request));
+	return -1;
+}
+
+/** A part of the order of a secondary index written to the snapshot. */
+struct memtx_index_order_row {
+	/** Space id. */
+	uint32_t space_id;
+	/** Index id. */
+	uint32_t index_id;
+	/** Offset of the part in the index order. */
+	uint64_t offset;
+	/** MsgPack array of positions of the index tuples in the pk. */
+	const char *positions;
+};
+
+/** Decodes a MEMTX_INDEX_ORDER row. Returns -1 and sets diag on error. */
+static int
+memtx_index_order_row_decode(const struct xrow_header *row,
+			     struct memtx_index_order_row *order_row)
+{
+	assert(row->type == MEMTX_INDEX_ORDER);
+	const char *data = (const char *)row->body[0].iov_base;
+	const char *data_end = data + row->body[0].iov_len;
+	const char *tmp = data;
+	if (mp_check_exact(&tmp, data_end) != 0 || mp_typeof(*data) != MP_MAP)
+		goto error;
+	order_row->space_id = UINT32_MAX;
+	order_row->index_id = UINT32_MAX;
+	order_row->offset = UINT64_MAX;
+	order_row->positions = NULL;
+	for (uint32_t size = mp_decode_map(&data); size > 0; size--) {
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t key = mp_decode_uint(&data);
+		if (key == IPROTO_DATA) {
+			if (mp_typeof(*data) != MP_ARRAY)
+				goto error;
+			order_row->positions = data;
+			mp_next(&data);
+			continue;
+		}
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t value = mp_decode_uint(&data);
+		if (key == IPROTO_SPACE_ID && value < UINT32_MAX)
+			order_row->space_id = value;
+		else if (key == IPROTO_INDEX_ID && value < UINT32_MAX)
+			order_row->index_id = value;
+		else if (key == IPROTO_OFFSET)
+			order_row->offset = value;
+	}
+	if (order_row->space_id == UINT32_MAX ||
+	    order_row->index_id == UINT32_MAX ||
+	    order_row->offset == UINT64_MAX || order_row->positions == NULL)
+		goto error;
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_MSGPACK, "index order");
 	return -1;
 }
 
+/**
+ * Loads a part of the order of a secondary index written to the
+ * snapshot. The order is applied when the index is built, see
+ * memtx_engine_take_index_order(). It's ignored unless the primary
+ * keys are loaded with the bulk build, since otherwise the primary
+ * index may contain tuples in a different order.
+ */
+static int
+memtx_engine_recover_index_order(const struct xrow_header *row)
+{
+	struct memtx_index_order_row order_row;
+	if (memtx_index_order_row_decode(row, &order_row) != 0)
+		return -1;
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	if (memtx->state != MEMTX_INITIAL_RECOVERY)
+		return 0;
+	if (memtx->index_orders == NULL)
+		memtx->index_orders = mh_i64ptr_new();
+	struct mh_i64ptr_t *h = memtx->index_orders;
+	uint64_t key = memtx_index_order_key(order_row.space_id,
+					     order_row.index_id);
+	mh_int_t k = mh_i64ptr_find(h, key, NULL);
+	struct memtx_index_order *order;
+	if (k != mh_end(h)) {
+		order = (struct memtx_index_order *)mh_i64ptr_node(h, k)->val;
+	} else if (order_row.offset == 0) {
+		order = (struct memtx_index_order *)xcalloc(1, sizeof(*order));
+		struct mh_i64ptr_node_t node = {key, order};
+		k = mh_i64ptr_put(h, &node, NULL, NULL);
+	} else {
+		/* The beginning of the order was discarded. */
+		return 0;
+	}
+	const char *data = order_row.positions;
+	uint32_t count = mp_decode_array(&data);
+	bool is_valid = order_row.offset == order->size;
+	if (is_valid) {
+		order->positions = (uint32_t *)xrealloc(
+			order->positions,
+			(order->size + count) * sizeof(*order->positions));
+	}
+	for (uint32_t i = 0; i < count && is_valid; i++) {
+		if (mp_typeof(*data) != MP_UINT) {
+			is_valid = false;
+			break;
+		}
+		uint64_t position = mp_decode_uint(&data);
+		if (position >= UINT32_MAX)
+			is_valid = false;
+		order->positions[order->size++] = position;
+	}
+	if (!is_valid) {
+		/* The order is useless without any of its parts. */
+		say_warn("discarding order of index %u of space %u loaded "
+			 "from the snapshot", order_row.index_id,
+			 order_row.space_id);
+		mh_i64ptr_del(h, k, NULL);
+		free(order->positions);
+		free(order);
+	}
+	return 0;
+}
+
+static int
+memtx_engine_recover_snapshot_row(struct xrow_header *row,
+				  enum snapshot_recovery_state *state)
+{
+	assert(row->bodycnt == 1); /* always 1 for read */
+	if (row->type != IPROTO_INSERT) {
+		if (snapshot_recovery_state_update(state, false) != 0)
+			return -1;
+		if (row->type == IPROTO_RAFT)
+			return memtx_engine_recover_raft(row);
+		if (row->type == IPROTO_RAFT_PROMOTE)
+			return memtx_engine_recover_synchro(row);
+		if (row->type == MEMTX_INDEX_ORDER)
+			return memtx_engine_recover_index_order(row);
+		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+			 (uint32_t) row->type);
+		return -1;
+	}
+	struct request request;
+	RegionGuard region_guard(&fiber()->gc);
+	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
+		return -1;
+	bool is_system_space_request = space_id_is_system(request.space_id);
+	if (snapshot_recovery_state_update(state, is_system_space_request) != 0)
+		return -1;
+	return memtx_engine_recover_request(&request);
+}
+
+static int
+memtx_engine_recover_delta_row(struct xrow_header *row)
+{
+	assert(row->bodycnt == 1); /* always 1 for read */
+	switch (row->type) {
+	case IPROTO_REPLACE:
+	case IPROTO_DELETE:
+		break;
+	case IPROTO_RAFT:
+		return memtx_engine_recover_raft(row);
+	case IPROTO_RAFT_PROMOTE:
+		return memtx_engine_recover_synchro(row);
+	default:
+		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+			 (uint32_t) row->type);
+		return -1;
+	}
+	struct request request;
+	RegionGuard region_guard(&fiber()->gc);
+	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
+		return -1;
+	return memtx_engine_recover_request(&request);
+}
+
 /** Called at start to tell memtx to recover to a given LSN. */
 static int
 memtx_engine_begin_initial_recovery(struct engine *engine,
@@ -463,13 +909,17 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 		panic("Failed to complete recovery from snapshot!");
 	}
 
-	if (!memtx->force_recovery && !memtx_tx_manager_use_mvcc_engine) {
+	bool has_index_orders = memtx->index_orders != NULL &&
+				mh_size(memtx->index_orders) > 0;
+	if (!memtx->force_recovery && !memtx_tx_manager_use_mvcc_engine &&
+	    !has_index_orders) {
 		/*
 		 * Fast start path: "play out" WAL
 		 * records using the primary key only,
 		 * then bulk-build all secondary keys.
 		 */
 		memtx->state = MEMTX_FINAL_RECOVERY;
+		memtx_engine_free_index_orders(memtx);
 	} else {
 		/*
 		 * If force_recovery = true, it's
@@ -477,9 +927,16 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 		 * secondary keys before reading the WAL,
 		 * to detect and discard duplicates in
 		 * unique keys.
+		 *
+		 * Index orders loaded from the snapshot
+		 * refer to the primary key positions of
+		 * snapshot tuples, so they can only be
+		 * applied before the WAL is read.
 		 */
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
+		int rc = space_foreach(memtx_build_secondary_keys, memtx);
+		memtx_engine_free_index_orders(memtx);
+		if (rc != 0)
 			return -1;
 		memtx->on_indexes_built_cb();
 	}
@@ -518,11 +975,18 @@ memtx_engine_end_recovery(struct engine *engine)
 	if (memtx->state != MEMTX_OK) {
 		assert(memtx->state == MEMTX_FINAL_RECOVERY);
 		memtx->state = MEMTX_OK;
-		if (space_foreach(memtx_build_secondary_keys, memtx) != 0)
-			return -1;
-		memtx->on_indexes_built_cb();
+		if (memtx->background_index_build) {
+			if (memtx_engine_defer_secondary_keys(memtx) != 0)
+				return -1;
+		} else {
+			if (space_foreach(memtx_build_secondary_keys,
+					  memtx) != 0)
+				return -1;
+			memtx->on_indexes_built_cb();
+		}
 	}
 	xdir_remove_temporary_files(&memtx->snap_dir);
+	xdir_remove_temporary_files(&memtx->delta_dir);
 
 	/* Complete space initialization. */
 	int rc = space_foreach(space_on_final_recovery_complete, NULL);
@@ -625,7 +1089,6 @@ static void
 memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 				struct txn_stmt *stmt)
 {
-	(void)engine;
 	(void)txn;
 	struct tuple *old_tuple = stmt->rollback_info.old_tuple;
 	struct tuple *new_tuple = stmt->rollback_info.new_tuple;
@@ -646,6 +1109,14 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 	if (space->upgrade != NULL && new_tuple != NULL)
 		memtx_space_upgrade_untrack_tuple(space->upgrade, new_tuple);
 
+	/*
+	 * The change could have been written to a delta snapshot
+	 * before it was rolled back.
+	 */
+	memtx_engine_track_change((struct memtx_engine *)engine, space,
+				  stmt->new_tuple != NULL ? stmt->new_tuple :
+				  stmt->old_tuple);
+
 	if (memtx_tx_manager_use_mvcc_engine)
 		return memtx_tx_history_rollback_stmt(stmt);
 
@@ -744,16 +1215,22 @@ checkpoint_write_row(struct xlog *l, struct xrow_header *row)
 
 }
 
+/**
+ * Writes a snapshot row of the given type. For a DELETE row, @a data
+ * is the key of the deleted tuple, otherwise it's the tuple data.
+ */
 static int
-checkpoint_write_tuple(struct xlog *l, uint32_t space_id, uint32_t group_id,
-		       const char *data, uint32_t size)
+checkpoint_write_tuple(struct xlog *l, uint16_t type, uint32_t space_id,
+		       uint32_t group_id, const char *data, uint32_t size)
 {
 	struct request_replace_body body;
 	request_replace_body_create(&body, space_id);
+	if (type == IPROTO_DELETE)
+		body.k_tuple = IPROTO_KEY;
 
 	struct xrow_header row;
 	memset(&row, 0, sizeof(struct xrow_header));
-	row.type = IPROTO_INSERT;
+	row.type = type;
 	row.group_id = group_id;
 
 	row.bodycnt = 2;
@@ -788,6 +1265,24 @@ struct checkpoint {
 	 * checkpoint already exists.
 	 */
 	bool touch;
+	/**
+	 * Set if only tuples with keys from @a delta_set are written,
+	 * i.e. the checkpoint is a delta snapshot.
+	 */
+	bool is_delta;
+	/** The vclock of the checkpoint the delta snapshot is based on. */
+	struct vclock prev_vclock;
+	/**
+	 * Keys of tuples changed since the previous checkpoint or NULL
+	 * if changes weren't tracked. Returned to the engine if no new
+	 * checkpoint is created.
+	 */
+	struct memtx_delta_set *delta_set;
+	/**
+	 * Set if the order of secondary tree indexes is written to the
+	 * snapshot, see box.cfg.memtx_snapshot_index_order.
+	 */
+	bool index_order;
 };
 
 /** Space filter for checkpoint. */
@@ -812,6 +1307,38 @@ primary_index_filter(struct space *space, struct index *index, void *arg)
 	return index->def->iid == 0;
 }
 
+/**
+ * Returns true if the order of the index can be written to a snapshot
+ * and used to build the index on recovery without sorting. Tuples of
+ * a primary index of type TREE are recovered in the order they were
+ * written so the order of a secondary index is written as positions of
+ * its tuples in the primary index. Multikey and functional indexes are
+ * excluded, because they may contain a tuple more than once or not at
+ * all. System spaces are small and omitted. Indexes waiting to be built
+ * in background are empty.
+ */
+static bool
+index_order_is_supported(struct space *space, struct index *index)
+{
+	struct index *pk = space_index(space, 0);
+	return index->def->iid != 0 && !space_is_system(space) &&
+	       pk != NULL && pk->def->type == TREE &&
+	       index->def->type == TREE &&
+	       !index->def->key_def->is_multikey &&
+	       !index->def->key_def->for_func_index && !index->needs_build;
+}
+
+/**
+ * Index filter for a checkpoint writing the order of secondary indexes:
+ * the primary index and the indexes the order is written for.
+ */
+static bool
+index_order_filter(struct space *space, struct index *index, void *arg)
+{
+	(void)arg;
+	return index->def->iid == 0 || index_order_is_supported(space, index);
+}
+
 /*
  * Return true if tuple @a data represents temporary space's metadata.
  * @a space_id is used to determine the tuple's format.
@@ -853,7 +1380,8 @@ is_tuple_temporary(const char *data, uint32_t space_id,
 }
 
 static struct checkpoint *
-checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
+checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit,
+	       int compress_threads, int compression_level, bool index_order)
 {
 	struct checkpoint *ckpt = (struct checkpoint *)malloc(sizeof(*ckpt));
 	if (ckpt == NULL) {
@@ -866,13 +1394,16 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 	rv_opts.name = "checkpoint";
 	rv_opts.is_system = true;
 	rv_opts.filter_space = checkpoint_space_filter;
-	rv_opts.filter_index = primary_index_filter;
+	rv_opts.filter_index = index_order ? index_order_filter :
+				primary_index_filter;
 	if (read_view_open(&ckpt->rv, &rv_opts) != 0) {
 		free(ckpt);
 		return NULL;
 	}
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = snap_io_rate_limit;
+	opts.compress_threads = compress_threads;
+	opts.compression_level = compression_level;
 	opts.sync_interval = SNAP_SYNC_INTERVAL;
 	opts.free_cache = true;
 	xdir_create(&ckpt->dir, snap_dirname, SNAP, &INSTANCE_UUID, &opts);
@@ -882,6 +1413,10 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 	txn_limbo_checkpoint(&txn_limbo, &ckpt->synchro_state,
 			     &ckpt->synchro_vclock);
 	ckpt->touch = false;
+	ckpt->is_delta = false;
+	vclock_clear(&ckpt->prev_vclock);
+	ckpt->delta_set = NULL;
+	ckpt->index_order = index_order;
 	return ckpt;
 }
 
@@ -890,9 +1425,24 @@ checkpoint_delete(struct checkpoint *ckpt)
 {
 	read_view_close(&ckpt->rv);
 	xdir_destroy(&ckpt->dir);
+	if (ckpt->delta_set != NULL)
+		memtx_delta_set_delete(ckpt->delta_set);
 	free(ckpt);
 }
 
+/** Sets the type of the snapshot file written by a checkpoint. */
+static void
+checkpoint_set_type(struct checkpoint *ckpt, enum xdir_type type)
+{
+	if (ckpt->dir.type == type)
+		return;
+	char dirname[PATH_MAX];
+	strlcpy(dirname, ckpt->dir.dirname, sizeof(dirname));
+	struct xlog_opts opts = ckpt->dir.opts;
+	xdir_destroy(&ckpt->dir);
+	xdir_create(&ckpt->dir, dirname, type, &INSTANCE_UUID, &opts);
+}
+
 static int
 checkpoint_write_raft(struct xlog *l, const struct raft_request *req)
 {
@@ -929,8 +1479,8 @@ checkpoint_write_corrupted_insert_row(struct xlog *l)
 	char *p = mp_encode_array(buf, 10);
 	p = mp_encode_uint(p, 0);
 	assert((size_t)(p - buf) <= sizeof(buf));
-	return checkpoint_write_tuple(l, /*space_id=*/512, GROUP_DEFAULT,
-				      buf, p - buf);
+	return checkpoint_write_tuple(l, IPROTO_INSERT, /*space_id=*/512,
+				      GROUP_DEFAULT, buf, p - buf);
 }
 
 /** Writes an INSERT row for a missing space to the snapshot. */
@@ -941,8 +1491,8 @@ checkpoint_write_missing_space_row(struct xlog *l)
 	char *p = mp_encode_array(buf, 1);
 	p = mp_encode_uint(p, 0);
 	assert((size_t)(p - buf) <= sizeof(buf));
-	return checkpoint_write_tuple(l, /*space_id=*/777, GROUP_DEFAULT,
-				      buf, p - buf);
+	return checkpoint_write_tuple(l, IPROTO_INSERT, /*space_id=*/777,
+				      GROUP_DEFAULT, buf, p - buf);
 }
 
 /** Writes a row with an unknown type to the snapshot. */
@@ -981,21 +1531,216 @@ checkpoint_write_invalid_system_row(struct xlog *l)
 }
 #endif /* NDEBUG */
 
+/**
+ * Writes a tuple read from a checkpoint read view to a delta snapshot
+ * if its key was changed since the previous checkpoint.
+ */
 static int
-checkpoint_f(va_list ap)
-{
-#ifdef NDEBUG
-	enum { YIELD_LOOPS = 1000 };
-#else
-	enum { YIELD_LOOPS = 10 };
-#endif
-
+checkpoint_write_delta_tuple(struct checkpoint *ckpt,
+			     struct index_read_view *index_rv,
+			     const struct read_view_tuple *tuple)
+{
+	uint32_t size;
+	const char *data = tuple_extract_key_raw(tuple->data,
+						 tuple->data + tuple->size,
+						 index_rv->def->key_def,
+						 MULTIKEY_NONE, &size);
+	if (data == NULL)
+		return -1;
+	struct space_read_view *space_rv = index_rv->space;
+	struct memtx_delta_key *key = memtx_delta_set_find(ckpt->delta_set,
+							   space_rv->id,
+							   data, size);
+	if (key == NULL)
+		return 0;
+	key->is_written = true;
+	return checkpoint_write_tuple(&ckpt->snap, IPROTO_REPLACE,
+				      space_rv->id, space_rv->group_id,
+				      tuple->data, tuple->size);
+}
+
+/** Argument of checkpoint_write_delete_cb(). */
+struct checkpoint_write_delete_arg {
+	/** Snapshot file. */
+	struct xlog *snap;
+	/** Space read view with the tuples written to the snapshot. */
+	struct space_read_view *space_rv;
+};
+
+static int
+checkpoint_write_delete_cb(struct memtx_delta_key *key, void *arg_raw)
+{
+	struct checkpoint_write_delete_arg *arg =
+		(struct checkpoint_write_delete_arg *)arg_raw;
+	if (key->space_id != arg->space_rv->id || key->is_written)
+		return 0;
+	return checkpoint_write_tuple(arg->snap, IPROTO_DELETE, key->space_id,
+				      arg->space_rv->group_id, key->data,
+				      key->size);
+}
+
+/**
+ * Writes DELETE rows for the changed keys of a space that are
+ * missing in the checkpoint read view to a delta snapshot.
+ */
+static int
+checkpoint_write_delta_deletes(struct checkpoint *ckpt,
+			       struct space_read_view *space_rv)
+{
+	struct checkpoint_write_delete_arg arg;
+	arg.snap = &ckpt->snap;
+	arg.space_rv = space_rv;
+	return memtx_delta_set_foreach(ckpt->delta_set,
+				       checkpoint_write_delete_cb, &arg);
+}
+
+enum {
+	/** Max number of positions in a MEMTX_INDEX_ORDER row. */
+	INDEX_ORDER_ROW_POSITIONS_MAX = 16 * 1024,
+};
+
+/**
+ * Writes positions [offset, offset + count) of the index order to
+ * a MEMTX_INDEX_ORDER snapshot row.
+ */
+static int
+checkpoint_write_index_order_row(struct xlog *l, uint32_t space_id,
+				 uint32_t index_id, uint64_t offset,
+				 const uint32_t *positions, uint32_t count)
+{
+	struct region *region = &fiber()->gc;
+	RegionGuard region_guard(region);
+	size_t size = mp_sizeof_map(4) +
+		      mp_sizeof_uint(IPROTO_SPACE_ID) +
+		      mp_sizeof_uint(space_id) +
+		      mp_sizeof_uint(IPROTO_INDEX_ID) +
+		      mp_sizeof_uint(index_id) +
+		      mp_sizeof_uint(IPROTO_OFFSET) +
+		      mp_sizeof_uint(offset) +
+		      mp_sizeof_uint(IPROTO_DATA) +
+		      mp_sizeof_array(count) +
+		      count * mp_sizeof_uint(UINT32_MAX);
+	char *buf = (char *)xregion_alloc(region, size);
+	char *data = buf;
+	data = mp_encode_map(data, 4);
+	data = mp_encode_uint(data, IPROTO_SPACE_ID);
+	data = mp_encode_uint(data, space_id);
+	data = mp_encode_uint(data, IPROTO_INDEX_ID);
+	data = mp_encode_uint(data, index_id);
+	data = mp_encode_uint(data, IPROTO_OFFSET);
+	data = mp_encode_uint(data, offset);
+	data = mp_encode_uint(data, IPROTO_DATA);
+	data = mp_encode_array(data, count);
+	for (uint32_t i = 0; i < count; i++)
+		data = mp_encode_uint(data, positions[i]);
+	assert(data <= buf + size);
+
+	struct xrow_header row;
+	memset(&row, 0, sizeof(row));
+	row.type = MEMTX_INDEX_ORDER;
+	row.bodycnt = 1;
+	row.body[0].iov_base = buf;
+	row.body[0].iov_len = data - buf;
+	return checkpoint_write_row(l, &row);
+}
+
+/**
+ * Writes the order of a secondary index to a snapshot: positions of
+ * the index tuples in the primary index. @a pk_positions maps tuple
+ * data of each tuple written to the snapshot to its position. Nothing
+ * is written if the index doesn't contain exactly the same tuples.
+ */
+static int
+checkpoint_write_index_order(struct xlog *l, struct index_read_view *index_rv,
+			     struct mh_i64ptr_t *pk_positions,
+			     uint64_t pk_count)
+{
+	if (pk_count == 0 || pk_count > UINT32_MAX)
+		return 0;
+	uint32_t *positions = (uint32_t *)xmalloc(pk_count *
+						  sizeof(*positions));
+	uint64_t count = 0;
+	struct index_read_view_iterator it;
+	int rc = index_read_view_create_iterator(index_rv, ITER_ALL,
+						 NULL, 0, &it);
+	if (rc != 0)
+		goto out;
+	while (true) {
+		struct read_view_tuple result;
+		rc = index_read_view_iterator_next_raw(&it, &result);
+		if (rc != 0 || result.data == NULL)
+			break;
+		mh_int_t k = mh_i64ptr_find(pk_positions,
+					    (uintptr_t)result.data, NULL);
+		if (k == mh_end(pk_positions) || count == pk_count) {
+			count = 0;
+			break;
+		}
+		positions[count++] = (uintptr_t)mh_i64ptr_node(pk_positions,
+								k)->val;
+	}
+	index_read_view_iterator_destroy(&it);
+	if (rc != 0 || count != pk_count)
+		goto out;
+	for (uint64_t offset = 0; offset < count;
+	     offset += INDEX_ORDER_ROW_POSITIONS_MAX) {
+		uint32_t n = MIN(count - offset,
+				 (uint64_t)INDEX_ORDER_ROW_POSITIONS_MAX);
+		rc = checkpoint_write_index_order_row(l, index_rv->space->id,
+						      index_rv->def->iid,
+						      offset,
+						      positions + offset, n);
+		if (rc != 0)
+			break;
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			rc = -1;
+			break;
+		}
+	}
+out:
+	free(positions);
+	return rc;
+}
+
+/**
+ * Returns true if the order of secondary indexes of the space is
+ * written to the snapshot, see checkpoint_write_index_order().
+ */
+static bool
+checkpoint_has_index_order(struct checkpoint *ckpt,
+			   struct space_read_view *space_rv)
+{
+	if (!ckpt->index_order || ckpt->is_delta)
+		return false;
+	for (uint32_t i = 1; i <= space_rv->index_id_max; i++) {
+		if (space_read_view_index(space_rv, i) != NULL)
+			return true;
+	}
+	return false;
+}
+
+static int
+checkpoint_f(va_list ap)
+{
+#ifdef NDEBUG
+	enum { YIELD_LOOPS = 1000 };
+#else
+	enum { YIELD_LOOPS = 10 };
+#endif
+
 	int rc = 0;
 	struct checkpoint *ckpt = va_arg(ap, struct checkpoint *);
 
 	if (ckpt->touch) {
 		if (xdir_touch_xlog(&ckpt->dir, &ckpt->vclock) == 0)
 			return 0;
+		/*
+		 * A delta snapshot can't be recreated, because the
+		 * checkpoint it's based on is the same as the new one.
+		 */
+		if (ckpt->dir.type == DSNAP)
+			return -1;
 		/*
 		 * Failed to touch an existing snapshot, create
 		 * a new one.
@@ -1005,7 +1750,10 @@ checkpoint_f(va_list ap)
 
 	struct xlog *snap = &ckpt->snap;
 	assert(!xlog_is_open(snap));
-	if (xdir_create_xlog(&ckpt->dir, snap, &ckpt->vclock) != 0) {
+	if ((ckpt->is_delta ?
+	     xdir_create_xlog_with_prev(&ckpt->dir, snap, &ckpt->vclock,
+					&ckpt->prev_vclock) :
+	     xdir_create_xlog(&ckpt->dir, snap, &ckpt->vclock)) != 0) {
 		/*
 		 * We call memtx_engine_abort_checkpoint on failure to discard
 		 * an incomplete xlog file. Clear the xlog object so that it's
@@ -1034,6 +1782,16 @@ checkpoint_f(va_list ap)
 		ERROR_INJECT(ERRINJ_SNAP_SKIP_DDL_ROWS, {
 			skip = space_id_is_system(space_rv->id);
 		});
+		/*
+		 * A delta snapshot contains only spaces with changed
+		 * tuples and _sequence_data, which isn't updated when
+		 * a sequence is used, so it's always written in full.
+		 */
+		bool is_delta = ckpt->is_delta &&
+				space_rv->id != BOX_SEQUENCE_DATA_ID;
+		if (is_delta && !memtx_delta_set_has_space(ckpt->delta_set,
+							   space_rv->id))
+			skip = true;
 		if (skip)
 			continue;
 		struct index_read_view *index_rv =
@@ -1045,6 +1803,14 @@ checkpoint_f(va_list ap)
 			rc = -1;
 			break;
 		}
+		/*
+		 * Positions of the written tuples, needed to write
+		 * the order of secondary indexes.
+		 */
+		struct mh_i64ptr_t *pk_positions = NULL;
+		uint64_t pk_count = 0;
+		if (checkpoint_has_index_order(ckpt, space_rv))
+			pk_positions = mh_i64ptr_new();
 		unsigned int loops = 0;
 		while (true) {
 			RegionGuard region_guard(&fiber()->gc);
@@ -1056,9 +1822,22 @@ checkpoint_f(va_list ap)
 					       space_rv->id,
 					       temp_space_ids))
 				continue;
-			rc = checkpoint_write_tuple(snap, space_rv->id,
-						    space_rv->group_id,
-						    result.data, result.size);
+			if (pk_positions != NULL) {
+				struct mh_i64ptr_node_t node = {
+					(uintptr_t)result.data,
+					(void *)(uintptr_t)pk_count++,
+				};
+				mh_i64ptr_put(pk_positions, &node, NULL, NULL);
+			}
+			if (is_delta) {
+				rc = checkpoint_write_delta_tuple(
+					ckpt, index_rv, &result);
+			} else {
+				rc = checkpoint_write_tuple(
+					snap, IPROTO_INSERT, space_rv->id,
+					space_rv->group_id, result.data,
+					result.size);
+			}
 			if (rc != 0)
 				break;
 			/* Yield to make thread cancellable. */
@@ -1071,8 +1850,24 @@ checkpoint_f(va_list ap)
 			}
 		}
 		index_read_view_iterator_destroy(&it);
+		for (uint32_t i = 1; pk_positions != NULL && rc == 0 &&
+				     i <= space_rv->index_id_max; i++) {
+			struct index_read_view *sk_rv =
+				space_read_view_index(space_rv, i);
+			if (sk_rv != NULL) {
+				rc = checkpoint_write_index_order(
+					snap, sk_rv, pk_positions, pk_count);
+			}
+		}
+		if (pk_positions != NULL)
+			mh_i64ptr_delete(pk_positions);
 		if (rc != 0)
 			break;
+		if (is_delta) {
+			rc = checkpoint_write_delta_deletes(ckpt, space_rv);
+			if (rc != 0)
+				break;
+		}
 	}
 	mh_i32_delete(temp_space_ids);
 	if (rc != 0)
@@ -1108,6 +1903,135 @@ checkpoint_f(va_list ap)
 	return -1;
 }
 
+/**
+ * Gets the vclock of the last checkpoint, full or delta, and returns
+ * its signature or -1 if there are no checkpoints.
+ */
+static int64_t
+memtx_engine_last_checkpoint(struct memtx_engine *memtx,
+			     struct vclock *vclock, bool *is_delta)
+{
+	struct vclock snap_vclock, delta_vclock;
+	int64_t snap_signature = xdir_last_vclock(&memtx->snap_dir,
+						  &snap_vclock);
+	int64_t delta_signature = xdir_last_vclock(&memtx->delta_dir,
+						   &delta_vclock);
+	*is_delta = delta_signature > snap_signature;
+	if (*is_delta) {
+		vclock_copy(vclock, &delta_vclock);
+		return delta_signature;
+	}
+	if (snap_signature >= 0)
+		vclock_copy(vclock, &snap_vclock);
+	return snap_signature;
+}
+
+/** Returns the size of a checkpoint file or 0 if it can't be stat'ed. */
+static int64_t
+memtx_checkpoint_file_size(struct xdir *dir, int64_t signature)
+{
+	const char *filename = xdir_format_filename(dir, signature, NONE);
+	struct stat st;
+	if (stat(filename, &st) != 0) {
+		say_syserror("failed to stat checkpoint file '%s'", filename);
+		return 0;
+	}
+	return st.st_size;
+}
+
+int64_t
+memtx_engine_checkpoint_size(struct memtx_engine *memtx)
+{
+	struct vclock vclock;
+	bool is_delta;
+	int64_t signature = memtx_engine_last_checkpoint(memtx, &vclock,
+							 &is_delta);
+	if (signature < 0)
+		return 0;
+	struct vclock *base = memtx_engine_checkpoint_base(memtx, &vclock);
+	if (base == NULL)
+		return 0;
+	int64_t size = memtx_checkpoint_file_size(&memtx->snap_dir,
+						  vclock_sum(base));
+	if (!is_delta)
+		return size;
+	vclockset_t *index = &memtx->delta_dir.index;
+	for (struct vclock *delta = vclockset_first(index); delta != NULL;
+	     delta = vclockset_next(index, delta)) {
+		int64_t delta_signature = vclock_sum(delta);
+		if (delta_signature <= vclock_sum(base))
+			continue;
+		if (delta_signature > signature)
+			break;
+		size += memtx_checkpoint_file_size(&memtx->delta_dir,
+						   delta_signature);
+	}
+	return size;
+}
+
+/** Stops tracking changes so that the next checkpoint is a full one. */
+static void
+memtx_engine_reset_delta(struct memtx_engine *memtx)
+{
+	if (memtx->delta_set != NULL) {
+		memtx_delta_set_delete(memtx->delta_set);
+		memtx->delta_set = NULL;
+	}
+}
+
+/**
+ * Returns the keys changed before a checkpoint that didn't create
+ * a new checkpoint file to the engine.
+ */
+static void
+memtx_engine_restore_delta(struct memtx_engine *memtx,
+			   struct checkpoint *ckpt)
+{
+	if (ckpt->delta_set != NULL && memtx->delta_set != NULL)
+		memtx_delta_set_merge(memtx->delta_set, ckpt->delta_set);
+	else if (ckpt->delta_set != NULL)
+		memtx_delta_set_delete(ckpt->delta_set);
+	else
+		memtx_engine_reset_delta(memtx);
+	ckpt->delta_set = NULL;
+}
+
+void
+memtx_engine_track_change(struct memtx_engine *memtx, struct space *space,
+			  struct tuple *tuple)
+{
+	if (memtx->delta_set == NULL || space->def->opts.is_ephemeral ||
+	    space_is_data_temporary(space))
+		return;
+	uint32_t id = space_id(space);
+	/* Sequence data is written to each delta snapshot in full. */
+	if (id == BOX_SEQUENCE_DATA_ID)
+		return;
+	/*
+	 * Delta snapshots don't contain schema changes, because system
+	 * spaces are recovered before user data and can't be updated
+	 * on top of it.
+	 */
+	if (space_id_is_system(id)) {
+		memtx_engine_reset_delta(memtx);
+		return;
+	}
+	struct index *pk = space_index(space, 0);
+	assert(pk != NULL);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t size;
+	const char *key = tuple_extract_key(tuple, pk->def->key_def,
+					    MULTIKEY_NONE, &size);
+	if (key == NULL) {
+		diag_log();
+		memtx_engine_reset_delta(memtx);
+		return;
+	}
+	memtx_delta_set_add(memtx->delta_set, id, key, size);
+	region_truncate(region, region_svp);
+}
+
 static int
 memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 {
@@ -1116,9 +2040,31 @@ memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 
 	assert(memtx->checkpoint == NULL);
 	memtx->checkpoint = checkpoint_new(memtx->snap_dir.dirname,
-					   memtx->snap_io_rate_limit);
+					   memtx->snap_io_rate_limit,
+					   memtx->snap_compress_threads,
+					   memtx->snap_compression_level,
+					   memtx->snap_index_order);
 	if (memtx->checkpoint == NULL)
 		return -1;
+	/*
+	 * Write a delta snapshot if all changes since the last
+	 * checkpoint are known and the delta chain isn't too long.
+	 * Changes made after this point go to a new set, because
+	 * the read view is already open.
+	 */
+	struct checkpoint *ckpt = memtx->checkpoint;
+	bool unused;
+	if (memtx->delta_set != NULL &&
+	    memtx->checkpoint_delta_chain < memtx->checkpoint_delta_count &&
+	    memtx_engine_last_checkpoint(memtx, &ckpt->prev_vclock,
+					 &unused) >= 0) {
+		ckpt->is_delta = true;
+		checkpoint_set_type(ckpt, DSNAP);
+	}
+	ckpt->delta_set = memtx->delta_set;
+	memtx->delta_set = NULL;
+	if (memtx->checkpoint_delta_count > 0)
+		memtx->delta_set = memtx_delta_set_new();
 	return 0;
 }
 
@@ -1133,9 +2079,13 @@ memtx_engine_wait_checkpoint(struct engine *engine,
 	 * If a snapshot already exists, do not create a new one.
 	 */
 	struct vclock last;
-	if (xdir_last_vclock(&memtx->snap_dir, &last) >= 0 &&
+	bool last_is_delta;
+	if (memtx_engine_last_checkpoint(memtx, &last, &last_is_delta) >= 0 &&
 	    vclock_compare(&last, vclock) == 0) {
 		memtx->checkpoint->touch = true;
+		memtx->checkpoint->is_delta = false;
+		checkpoint_set_type(memtx->checkpoint,
+				    last_is_delta ? DSNAP : SNAP);
 	}
 	vclock_copy(&memtx->checkpoint->vclock, vclock);
 
@@ -1178,12 +2128,26 @@ memtx_engine_commit_checkpoint(struct engine *engine,
 			  &memtx->checkpoint->snap);
 	}
 
+	struct checkpoint *ckpt = memtx->checkpoint;
 	struct vclock last;
-	if (xdir_last_vclock(&memtx->snap_dir, &last) < 0 ||
+	bool unused;
+	if (memtx_engine_last_checkpoint(memtx, &last, &unused) < 0 ||
 	    vclock_compare(&last, vclock) != 0) {
 		/* Add the new checkpoint to the set. */
-		xdir_add_vclock(&memtx->snap_dir, &memtx->checkpoint->vclock);
+		if (ckpt->is_delta) {
+			xdir_add_vclock(&memtx->delta_dir, &ckpt->vclock);
+			memtx->checkpoint_delta_chain++;
+		} else {
+			xdir_add_vclock(&memtx->snap_dir, &ckpt->vclock);
+			memtx->checkpoint_delta_chain = 0;
+		}
 	}
+	/*
+	 * If the existing checkpoint was reused, the changes made
+	 * before it are still to be written.
+	 */
+	if (ckpt->touch)
+		memtx_engine_restore_delta(memtx, ckpt);
 
 	checkpoint_delete(memtx->checkpoint);
 	memtx->checkpoint = NULL;
@@ -1206,6 +2170,7 @@ memtx_engine_abort_checkpoint(struct engine *engine)
 	assert(!xlog_is_open(&memtx->checkpoint->snap));
 
 	coio_call(memtx_engine_abort_checkpoint_f, &memtx->checkpoint->snap);
+	memtx_engine_restore_delta(memtx, memtx->checkpoint);
 	checkpoint_delete(memtx->checkpoint);
 	memtx->checkpoint = NULL;
 }
@@ -1214,8 +2179,15 @@ static void
 memtx_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
-	xdir_collect_garbage(&memtx->snap_dir, vclock_sum(vclock),
-			     XDIR_GC_ASYNC);
+	/*
+	 * Delta snapshots are recovered on top of the previous
+	 * checkpoints so keep the full snapshot the oldest
+	 * checkpoint is based on and all deltas after it.
+	 */
+	const struct vclock *base = memtx_engine_checkpoint_base(memtx, vclock);
+	int64_t signature = vclock_sum(base != NULL ? base : vclock);
+	xdir_collect_garbage(&memtx->snap_dir, signature, XDIR_GC_ASYNC);
+	xdir_collect_garbage(&memtx->delta_dir, signature, XDIR_GC_ASYNC);
 }
 
 static int
@@ -1223,9 +2195,28 @@ memtx_engine_backup(struct engine *engine, const struct vclock *vclock,
 		    engine_backup_cb cb, void *cb_arg)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
+	int64_t signature = vclock_sum(vclock);
+	const struct vclock *base = memtx_engine_checkpoint_base(memtx, vclock);
+	int64_t base_signature = base != NULL ? vclock_sum(base) : signature;
 	const char *filename = xdir_format_filename(&memtx->snap_dir,
-						    vclock_sum(vclock), NONE);
-	return cb(filename, cb_arg);
+						    base_signature, NONE);
+	if (cb(filename, cb_arg) != 0)
+		return -1;
+	/* Delta snapshots the checkpoint consists of. */
+	vclockset_t *index = &memtx->delta_dir.index;
+	for (struct vclock *delta = vclockset_first(index); delta != NULL;
+	     delta = vclockset_next(index, delta)) {
+		int64_t delta_signature = vclock_sum(delta);
+		if (delta_signature <= base_signature)
+			continue;
+		if (delta_signature > signature)
+			break;
+		filename = xdir_format_filename(&memtx->delta_dir,
+						delta_signature, NONE);
+		if (cb(filename, cb_arg) != 0)
+			return -1;
+	}
+	return 0;
 }
 
 struct memtx_join_ctx {
@@ -1443,6 +2434,291 @@ memtx_engine_gc_f(va_list va)
 	return 0;
 }
 
+enum {
+	/**
+	 * Number of tuples looked up in a space by one tuple
+	 * defragmentation batch.
+	 */
+	MEMTX_DEFRAG_BATCH_SIZE = 100,
+};
+
+/**
+ * Size class of the tuple allocator is defragmented if less than this
+ * fraction of its memory is used.
+ */
+static const double MEMTX_DEFRAG_FILL_FACTOR = 0.75;
+
+/**
+ * Max time the defragmentation fiber is allowed to run per event loop
+ * iteration, in seconds.
+ */
+static const double MEMTX_DEFRAG_FIBER_BUDGET = 1e-3;
+
+/**
+ * How long the defragmentation fiber sleeps while a checkpoint is in
+ * progress, in seconds.
+ */
+static const double MEMTX_DEFRAG_CHECKPOINT_DELAY = 0.1;
+
+/** Position of a tuple defragmentation pass in a space. */
+struct memtx_defrag_cursor {
+	/** Primary key parts of the last visited tuple. */
+	char *key;
+	/** Size of the key buffer. */
+	size_t key_capacity;
+	/** Number of primary key parts or 0 if the scan hasn't started. */
+	uint32_t part_count;
+};
+
+/**
+ * Returns true if tuples of a space may be moved by defragmentation.
+ *
+ * We skip spaces that are being built or altered, because moving tuples
+ * there would bypass on_replace triggers of a background DDL operation,
+ * and spaces with functional indexes, because keys of such indexes are
+ * computed by user functions. The space is scanned in batches so it must
+ * have a TREE primary index to resume the scan after a yield.
+ */
+static bool
+memtx_space_may_defrag(struct memtx_engine *memtx, struct space *space)
+{
+	if (space->engine != &memtx->base || space->index_count == 0)
+		return false;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (memtx_space->replace != memtx_space_replace_all_keys ||
+	    space->upgrade != NULL || !rlist_empty(&space->on_replace) ||
+	    space->index[0]->def->type != TREE)
+		return false;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (space->index[i]->def->key_def->for_func_index)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Moves a tuple of a space to a new place in memory, see
+ * MemtxAllocator::relocate_tuple(). Returns true if the tuple
+ * was moved.
+ */
+static bool
+memtx_space_relocate_tuple(struct memtx_engine *memtx, struct space *space,
+			   struct tuple *tuple)
+{
+	/*
+	 * A tuple can't be freed while it's referenced by anyone but
+	 * the space. Dirty tuples are also referenced by MVCC stories.
+	 */
+	if (!tuple_has_single_ref(tuple) ||
+	    tuple_has_flag(tuple, TUPLE_IS_DIRTY))
+		return false;
+	if (memtx_index_extent_reserve(memtx,
+				       RESERVE_EXTENTS_BEFORE_REPLACE) != 0) {
+		diag_clear(diag_get());
+		return false;
+	}
+	struct tuple *copy = memtx_tuple_relocate(tuple);
+	if (copy == NULL)
+		return false;
+	tuple_format_ref(tuple_format(copy));
+	uint32_t i;
+	for (i = 0; i < space->index_count; i++) {
+		struct tuple *unused;
+		if (index_replace(space->index[i], tuple, copy,
+				  DUP_INSERT, &unused, &unused) != 0)
+			goto rollback;
+	}
+	memtx_space_update_tuple_stat(space, tuple, copy);
+	tuple_ref(copy);
+	tuple_unref(tuple);
+	return true;
+rollback:
+	diag_log();
+	diag_clear(diag_get());
+	for (; i > 0; i--) {
+		struct tuple *unused;
+		struct index *index = space->index[i - 1];
+		/* Rollback must not fail. */
+		if (index_replace(index, copy, tuple,
+				  DUP_INSERT, &unused, &unused) != 0) {
+			diag_log();
+			unreachable();
+			panic("failed to rollback change");
+		}
+	}
+	tuple_delete(copy);
+	return false;
+}
+
+/**
+ * Moves a batch of tuples of a space starting from the cursor position,
+ * and advances the cursor. Sets @a done if the end of the space was
+ * reached. Returns 0 on success, -1 on error (diag is set).
+ */
+static int
+memtx_space_defrag_batch(struct memtx_engine *memtx, struct space *space,
+			 struct memtx_defrag_cursor *cursor, bool *done)
+{
+	struct index *pk = space->index[0];
+	struct iterator *it = index_create_iterator(
+		pk, cursor->part_count == 0 ? ITER_ALL : ITER_GT,
+		cursor->key, cursor->part_count);
+	if (it == NULL)
+		return -1;
+	/*
+	 * Collect the batch first, because the iterator references
+	 * the last returned tuple. We don't yield until the batch is
+	 * processed so the tuples can't go anywhere.
+	 */
+	struct tuple *batch[MEMTX_DEFRAG_BATCH_SIZE];
+	int count = 0;
+	int rc = 0;
+	while (count < MEMTX_DEFRAG_BATCH_SIZE) {
+		struct tuple *tuple;
+		if (iterator_next(it, &tuple) != 0) {
+			rc = -1;
+			break;
+		}
+		if (tuple == NULL)
+			break;
+		batch[count++] = tuple;
+	}
+	iterator_delete(it);
+	if (rc != 0)
+		return -1;
+	*done = count < MEMTX_DEFRAG_BATCH_SIZE;
+	if (!*done) {
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		uint32_t key_size;
+		const char *key = tuple_extract_key(batch[count - 1],
+						    pk->def->key_def,
+						    MULTIKEY_NONE, &key_size);
+		if (key == NULL)
+			return -1;
+		const char *key_end = key + key_size;
+		cursor->part_count = mp_decode_array(&key);
+		key_size = key_end - key;
+		if (key_size > cursor->key_capacity) {
+			cursor->key = (char *)xrealloc(cursor->key, key_size);
+			cursor->key_capacity = key_size;
+		}
+		memcpy(cursor->key, key, key_size);
+		region_truncate(region, region_svp);
+	}
+	for (int i = 0; i < count; i++) {
+		if (memtx_space_relocate_tuple(memtx, space, batch[i]))
+			memtx->defrag_relocated++;
+	}
+	return 0;
+}
+
+/** Ids of memtx spaces handled by a tuple defragmentation pass. */
+struct memtx_defrag_spaces {
+	/** Memtx engine. */
+	struct memtx_engine *memtx;
+	/** Array of space ids. */
+	uint32_t *ids;
+	/** Number of entries in the array. */
+	int count;
+	/** Capacity of the array. */
+	int capacity;
+};
+
+static int
+memtx_defrag_spaces_add(struct space *space, void *arg)
+{
+	struct memtx_defrag_spaces *spaces = (struct memtx_defrag_spaces *)arg;
+	if (space->engine != &spaces->memtx->base)
+		return 0;
+	if (spaces->count == spaces->capacity) {
+		spaces->capacity = MAX(spaces->capacity * 2, 16);
+		spaces->ids = (uint32_t *)xrealloc(spaces->ids,
+				spaces->capacity * sizeof(*spaces->ids));
+	}
+	spaces->ids[spaces->count++] = space_id(space);
+	return 0;
+}
+
+/**
+ * Runs a tuple defragmentation pass over all memtx spaces. The spaces
+ * are looked up by id after each yield, because they may be dropped or
+ * altered meanwhile.
+ */
+static void
+memtx_engine_run_defrag(struct memtx_engine *memtx)
+{
+	struct memtx_defrag_spaces spaces;
+	memset(&spaces, 0, sizeof(spaces));
+	spaces.memtx = memtx;
+	space_foreach(memtx_defrag_spaces_add, &spaces);
+	struct memtx_defrag_cursor cursor;
+	memset(&cursor, 0, sizeof(cursor));
+	double deadline = clock_monotonic() + MEMTX_DEFRAG_FIBER_BUDGET;
+	int i = 0;
+	while (i < spaces.count && !fiber_is_cancelled()) {
+		if (memtx->checkpoint != NULL) {
+			/*
+			 * Tuples moved while a checkpoint is in progress
+			 * can't be freed until it completes.
+			 */
+			fiber_sleep(MEMTX_DEFRAG_CHECKPOINT_DELAY);
+			deadline = clock_monotonic() +
+				   MEMTX_DEFRAG_FIBER_BUDGET;
+			continue;
+		}
+		if (memtx_defrag_select_classes(MEMTX_DEFRAG_FILL_FACTOR) == 0)
+			break;
+		struct space *space = space_by_id(spaces.ids[i]);
+		bool done = true;
+		if (space != NULL && memtx_space_may_defrag(memtx, space) &&
+		    memtx_space_defrag_batch(memtx, space, &cursor,
+					     &done) != 0) {
+			diag_log();
+			diag_clear(diag_get());
+			done = true;
+		}
+		if (done) {
+			cursor.part_count = 0;
+			i++;
+		}
+		if (clock_monotonic() > deadline) {
+			/*
+			 * Yield after running for a while so as not to
+			 * block tx thread for too long.
+			 */
+			fiber_sleep(0);
+			deadline = clock_monotonic() +
+				   MEMTX_DEFRAG_FIBER_BUDGET;
+		}
+	}
+	free(cursor.key);
+	free(spaces.ids);
+}
+
+static int
+memtx_engine_defrag_f(va_list va)
+{
+	struct memtx_engine *memtx = va_arg(va, struct memtx_engine *);
+	while (!fiber_is_cancelled()) {
+		if (!memtx->defrag_requested) {
+			fiber_yield();
+			continue;
+		}
+		memtx->defrag_requested = false;
+		memtx_engine_run_defrag(memtx);
+		memtx->defrag_passes++;
+	}
+	return 0;
+}
+
+void
+memtx_engine_defragment(struct memtx_engine *memtx)
+{
+	memtx->defrag_requested = true;
+	fiber_wakeup(memtx->defrag_fiber);
+}
+
 void
 memtx_set_tuple_format_vtab(const char *allocator_name)
 {
@@ -1490,8 +2766,12 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	xdir_create(&memtx->snap_dir, snap_dirname, SNAP, &INSTANCE_UUID,
 		    &xlog_opts_default);
 	memtx->snap_dir.force_recovery = force_recovery;
+	xdir_create(&memtx->delta_dir, snap_dirname, DSNAP, &INSTANCE_UUID,
+		    &xlog_opts_default);
+	memtx->delta_dir.force_recovery = force_recovery;
 
-	if (xdir_scan(&memtx->snap_dir, true) != 0)
+	if (xdir_scan(&memtx->snap_dir, true) != 0 ||
+	    xdir_scan(&memtx->delta_dir, true) != 0)
 		goto fail;
 
 	/*
@@ -1514,17 +2794,38 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		xlog_cursor_close(&cursor, false);
 	}
 
-	/* Apprise the garbage collector of available checkpoints. */
-	for (struct vclock *vclock = vclockset_first(&memtx->snap_dir.index);
-	     vclock != NULL;
-	     vclock = vclockset_next(&memtx->snap_dir.index, vclock)) {
-		gc_add_checkpoint(vclock);
+	/*
+	 * Apprise the garbage collector of available checkpoints,
+	 * full and delta, in the order they were created.
+	 */
+	struct vclock *snap_vclock;
+	struct vclock *delta_vclock;
+	snap_vclock = vclockset_first(&memtx->snap_dir.index);
+	delta_vclock = vclockset_first(&memtx->delta_dir.index);
+	while (snap_vclock != NULL || delta_vclock != NULL) {
+		if (delta_vclock == NULL ||
+		    (snap_vclock != NULL &&
+		     vclock_sum(snap_vclock) < vclock_sum(delta_vclock))) {
+			gc_add_checkpoint(snap_vclock);
+			snap_vclock = vclockset_next(&memtx->snap_dir.index,
+						     snap_vclock);
+		} else {
+			gc_add_checkpoint(delta_vclock);
+			delta_vclock = vclockset_next(&memtx->delta_dir.index,
+						      delta_vclock);
+		}
 	}
 
 	stailq_create(&memtx->gc_queue);
+	rlist_create(&memtx->ddl_progress);
+	memtx->ddl_rate_limit = 0;
 	memtx->gc_fiber = fiber_new_system("memtx.gc", memtx_engine_gc_f);
 	if (memtx->gc_fiber == NULL)
 		goto fail;
+	memtx->defrag_fiber = fiber_new_system("memtx.defrag",
+					       memtx_engine_defrag_f);
+	if (memtx->defrag_fiber == NULL)
+		goto fail;
 
 	/*
 	 * Currently we have two quota consumers: tuple and index allocators.
@@ -1593,7 +2894,17 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 
 	memtx->state = MEMTX_INITIALIZED;
 	memtx->max_tuple_size = MAX_TUPLE_SIZE;
+	memtx->numa_node = -1;
+	memtx->use_huge_pages = false;
 	memtx->force_recovery = force_recovery;
+	memtx->snap_compress_threads = 1;
+	memtx->snap_compression_level = XLOG_COMPRESSION_LEVEL_DEFAULT;
+	memtx->snap_index_order = false;
+	memtx->index_orders = NULL;
+	memtx->background_index_build = false;
+	memtx->deferred_space_ids = NULL;
+	memtx->deferred_space_count = 0;
+	memtx->deferred_space_pos = 0;
 	if (sort_threads == 0) {
 		char *ompnum_str = getenv_safe("OMP_NUM_THREADS", NULL, 0);
 		if (ompnum_str != NULL) {
@@ -1636,9 +2947,11 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->on_indexes_built_cb = on_indexes_built;
 
 	fiber_start(memtx->gc_fiber, memtx);
+	fiber_start(memtx->defrag_fiber, memtx);
 	return memtx;
 fail:
 	xdir_destroy(&memtx->snap_dir);
+	xdir_destroy(&memtx->delta_dir);
 	free(memtx);
 	return NULL;
 }
@@ -1705,6 +3018,10 @@ memtx_engine_stat_tx(struct memtx_engine *memtx, struct info_handler *h)
 		info_table_end(h);
 	}
 	info_table_end(h); /* tuples */
+	info_table_begin(h, "gc");
+	info_append_int(h, "pending_steps", stats.gc_pending_steps);
+	info_append_int(h, "background_steps", stats.gc_fiber_steps);
+	info_table_end(h); /* gc */
 	info_table_end(h); /* mvcc */
 	info_table_end(h); /* tx */
 }
@@ -1736,6 +3053,36 @@ memtx_engine_stat_index(struct memtx_engine *memtx, struct info_handler *h)
 	info_table_end(h); /* index */
 }
 
+/** Appends memtx tuple defragmentation stats to info. */
+static void
+memtx_engine_stat_defrag(struct memtx_engine *memtx, struct info_handler *h)
+{
+	info_table_begin(h, "defrag");
+	info_append_int(h, "passes", memtx->defrag_passes);
+	info_append_int(h, "relocated", memtx->defrag_relocated);
+	info_table_end(h); /* defrag */
+}
+
+/** Appends the progress of background DDL operations to info. */
+static void
+memtx_engine_stat_ddl(struct memtx_engine *memtx, struct info_handler *h)
+{
+	info_table_begin(h, "ddl");
+	struct memtx_ddl_progress *progress;
+	rlist_foreach_entry(progress, &memtx->ddl_progress, in_ddl_progress) {
+		info_table_begin(h, space_name(progress->space));
+		info_append_str(h, "op", progress->op);
+		if (progress->index != NULL)
+			info_append_str(h, "index", progress->index->def->name);
+		info_append_int(h, "processed", progress->processed);
+		info_append_int(h, "total", progress->total);
+		info_append_double(h, "time", ev_monotonic_now(loop()) -
+				   progress->start_time);
+		info_table_end(h);
+	}
+	info_table_end(h); /* ddl */
+}
+
 void
 memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h)
 {
@@ -1743,6 +3090,102 @@ memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h)
 	memtx_engine_stat_data(memtx, h);
 	memtx_engine_stat_index(memtx, h);
 	memtx_engine_stat_tx(memtx, h);
+	memtx_engine_stat_defrag(memtx, h);
+	memtx_engine_stat_ddl(memtx, h);
+	info_end(h);
+}
+
+/** Appends memory usage stats of a memtx space to info. */
+static int
+memtx_engine_memory_detail_space(struct space *space, void *arg)
+{
+	struct info_handler *h = (struct info_handler *)arg;
+	if (!space_is_memtx(space))
+		return 0;
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	struct tuple_info tuple_stat;
+	memset(&tuple_stat, 0, sizeof(tuple_stat));
+	for (int i = 0; i < tuple_arena_type_MAX; i++) {
+		struct tuple_info *stat = &memtx_space->tuple_stat[i];
+		tuple_stat.data_size += stat->data_size;
+		tuple_stat.header_size += stat->header_size;
+		tuple_stat.field_map_size += stat->field_map_size;
+		tuple_stat.waste_size += stat->waste_size;
+	}
+	size_t total = tuple_stat.data_size + tuple_stat.header_size +
+		       tuple_stat.field_map_size + tuple_stat.waste_size;
+	info_table_begin(h, space_name(space));
+	info_table_begin(h, "tuple");
+	info_append_int(h, "data_size", tuple_stat.data_size);
+	info_append_int(h, "header_size", tuple_stat.header_size);
+	info_append_int(h, "field_map_size", tuple_stat.field_map_size);
+	info_append_int(h, "waste_size", tuple_stat.waste_size);
+	info_table_end(h); /* tuple */
+	info_table_begin(h, "index");
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct index *index = space->index[i];
+		size_t size = index_bsize(index);
+		info_append_int(h, index->def->name, size);
+		total += size;
+	}
+	info_table_end(h); /* index */
+	struct memtx_tx_space_statistics mvcc;
+	memtx_tx_space_statistics_collect(space, &mvcc);
+	info_table_begin(h, "mvcc");
+	append_total_count_stats(h, "stories", mvcc.stories.total,
+				 mvcc.stories.count);
+	append_total_count_stats(h, "retained", mvcc.retained_tuples.total,
+				 mvcc.retained_tuples.count);
+	info_table_end(h); /* mvcc */
+	total += mvcc.stories.total + mvcc.retained_tuples.total;
+	info_append_int(h, "total", total);
+	info_table_end(h); /* space */
+	return 0;
+}
+
+void
+memtx_engine_index_build_info(struct memtx_engine *memtx,
+			      struct info_handler *h)
+{
+	info_begin(h);
+	info_append_str(h, "status",
+			memtx->deferred_space_ids != NULL ?
+			"building_indexes" : "done");
+	info_table_begin(h, "spaces");
+	for (int i = memtx->deferred_space_pos;
+	     i < memtx->deferred_space_count; i++) {
+		struct space *space = space_by_id(memtx->deferred_space_ids[i]);
+		if (space == NULL)
+			continue;
+		info_append_str(h, space_name(space),
+				i == memtx->deferred_space_pos ?
+				"building" : "pending");
+	}
+	info_table_end(h); /* spaces */
+	info_end(h);
+}
+
+void
+memtx_engine_memory_detail(struct memtx_engine *memtx,
+			   struct info_handler *h)
+{
+	info_begin(h);
+	info_table_begin(h, "spaces");
+	space_foreach(memtx_engine_memory_detail_space, h);
+	info_table_end(h); /* spaces */
+	/*
+	 * Freed tuples and index extents retained by read views aren't
+	 * linked to the spaces they belonged to, so they are reported for
+	 * all spaces at once.
+	 */
+	struct memtx_allocator_stats data_stats;
+	memtx_allocators_stats(&data_stats);
+	info_table_begin(h, "read_view");
+	info_append_int(h, "data", data_stats.used_rv);
+	info_append_int(h, "index",
+			(size_t)memtx->index_extent_stats.read_view_extent_count *
+			MEMTX_EXTENT_SIZE);
+	info_table_end(h); /* read_view */
 	info_end(h);
 }
 
@@ -1776,12 +3219,186 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size)
 	return 0;
 }
 
+void
+memtx_engine_set_checkpoint_delta_count(struct memtx_engine *memtx,
+					int count)
+{
+	memtx->checkpoint_delta_count = count;
+	if (count == 0)
+		memtx_engine_reset_delta(memtx);
+}
+
+void
+memtx_engine_set_snap_compress_threads(struct memtx_engine *memtx,
+				       int count)
+{
+	memtx->snap_compress_threads = count;
+}
+
+void
+memtx_engine_set_snap_compression_level(struct memtx_engine *memtx,
+					int level)
+{
+	memtx->snap_compression_level = level;
+}
+
+void
+memtx_engine_set_ddl_rate_limit(struct memtx_engine *memtx, double limit)
+{
+	memtx->ddl_rate_limit = limit;
+}
+
+void
+memtx_engine_set_snap_index_order(struct memtx_engine *memtx, bool value)
+{
+	memtx->snap_index_order = value;
+}
+
+void
+memtx_engine_set_background_index_build(struct memtx_engine *memtx,
+					bool value)
+{
+	memtx->background_index_build = value;
+}
+
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 {
 	memtx->max_tuple_size = max_size;
 }
 
+#if defined(__linux__) && defined(SYS_mbind)
+
+/* Memory policy modes, see <numaif.h> from libnuma. */
+enum {
+	MEMTX_MPOL_DEFAULT = 0,
+	MEMTX_MPOL_PREFERRED = 1,
+};
+
+int
+memtx_engine_set_numa_node(struct memtx_engine *memtx, int node)
+{
+	if (node < 0)
+		node = -1;
+	if (node == memtx->numa_node)
+		return 0;
+	unsigned long nodemask = 0;
+	unsigned long maxnode = 0;
+	int mode = MEMTX_MPOL_DEFAULT;
+	if (node >= 0) {
+		if (node >= (int)(sizeof(nodemask) * CHAR_BIT)) {
+			diag_set(ClientError, ER_CFG, "memtx_numa_node",
+				 "no such NUMA node");
+			return -1;
+		}
+		nodemask = 1UL << node;
+		/* The kernel ignores the last bit of the mask. */
+		maxnode = sizeof(nodemask) * CHAR_BIT + 1;
+		mode = MEMTX_MPOL_PREFERRED;
+	}
+	/*
+	 * Only the preallocated part of the arena is covered. Slabs that
+	 * are mapped after memtx_memory is increased use the default
+	 * policy, i.e. are allocated on the node of the tx thread.
+	 */
+	if (syscall(SYS_mbind, memtx->arena.arena, memtx->arena.prealloc,
+		    mode, node >= 0 ? &nodemask : NULL, maxnode, 0) != 0) {
+		diag_set(SystemError, "failed to set NUMA node %d for "
+			 "memtx arena", node);
+		return -1;
+	}
+	memtx->numa_node = node;
+	return 0;
+}
+
+#else /* !defined(__linux__) || !defined(SYS_mbind) */
+
+int
+memtx_engine_set_numa_node(struct memtx_engine *memtx, int node)
+{
+	(void)memtx;
+	if (node < 0)
+		return 0;
+	diag_set(ClientError, ER_CFG, "memtx_numa_node",
+		 "NUMA is not supported");
+	return -1;
+}
+
+#endif /* !defined(__linux__) || !defined(SYS_mbind) */
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+
+int
+memtx_engine_set_huge_pages(struct memtx_engine *memtx, bool use_huge_pages)
+{
+	if (use_huge_pages == memtx->use_huge_pages)
+		return 0;
+	/*
+	 * Like the NUMA policy, the advice covers only the preallocated
+	 * part of the arena, which includes index extents as well.
+	 */
+	int advice = use_huge_pages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE;
+	if (madvise(memtx->arena.arena, memtx->arena.prealloc, advice) != 0) {
+		if (errno != EINVAL) {
+			diag_set(SystemError, "failed to set huge pages "
+				 "advice for memtx arena");
+			return -1;
+		}
+		/* The kernel is built without transparent huge pages. */
+		say_warn("transparent huge pages are not supported, "
+			 "memtx arena uses regular pages");
+	}
+	memtx->use_huge_pages = use_huge_pages;
+	return 0;
+}
+
+size_t
+memtx_engine_huge_pages_size(struct memtx_engine *memtx)
+{
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if (f == NULL)
+		return 0;
+	uintptr_t arena_begin = (uintptr_t)memtx->arena.arena;
+	uintptr_t arena_end = arena_begin + memtx->arena.prealloc;
+	bool in_arena = false;
+	size_t size = 0;
+	char line[256];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		unsigned long begin, end;
+		unsigned long kb;
+		if (sscanf(line, "%lx-%lx ", &begin, &end) == 2) {
+			in_arena = begin < arena_end && end > arena_begin;
+		} else if (in_arena &&
+			   sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+			size += (size_t)kb * 1024;
+		}
+	}
+	fclose(f);
+	return size;
+}
+
+#else /* !defined(__linux__) || !defined(MADV_HUGEPAGE) */
+
+int
+memtx_engine_set_huge_pages(struct memtx_engine *memtx, bool use_huge_pages)
+{
+	(void)memtx;
+	if (!use_huge_pages)
+		return 0;
+	diag_set(ClientError, ER_CFG, "memtx_use_huge_pages",
+		 "huge pages are not supported");
+	return -1;
+}
+
+size_t
+memtx_engine_huge_pages_size(struct memtx_engine *memtx)
+{
+	(void)memtx;
+	return 0;
+}
+
+#endif /* !defined(__linux__) || !defined(MADV_HUGEPAGE) */
+
 template<class ALLOC>
 static struct tuple *
 memtx_tuple_new_raw_impl(struct tuple_format *format, const char *data,
@@ -2014,6 +3631,10 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (old_def->opts.hash_func != new_def->opts.hash_func)
+		return true;
+	if (key_filter_cmp(&old_def->opts.filter, &new_def->opts.filter) != 0)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -2086,8 +3707,8 @@ memtx_prepare_read_view_tuple(struct tuple *tuple,
 	result->data = tuple_data_range(tuple, &result->size);
 	if (!index->space->rv->disable_decompression) {
 		result->data = memtx_tuple_decompress_raw(
-				result->data, result->data + result->size,
-				&result->size);
+				tuple_format(tuple), result->data,
+				result->data + result->size, &result->size);
 		if (result->data == NULL)
 			return -1;
 	}
@@ -52,6 +52,8 @@ struct index_read_view;
 struct info_handler;
 struct iterator;
 struct fiber;
+struct memtx_delta_set;
+struct mh_i64ptr_t;
 struct read_view_tuple;
 struct tuple;
 struct tuple_format;
@@ -114,6 +116,27 @@ enum memtx_reserve_extents_num {
 typedef void
 (*memtx_on_indexes_built_cb)(void);
 
+/**
+ * Progress of a DDL operation scanning a space in background: building
+ * an index or checking a new space format. Shown in box.stat.memtx().
+ */
+struct memtx_ddl_progress {
+	/** Link in memtx_engine::ddl_progress. */
+	struct rlist in_ddl_progress;
+	/** Operation name. */
+	const char *op;
+	/** The space being scanned. */
+	struct space *space;
+	/** The index being built or NULL if it's a format check. */
+	struct index *index;
+	/** Number of tuples processed so far. */
+	size_t processed;
+	/** Number of tuples in the space when the operation started. */
+	size_t total;
+	/** Monotonic time when the operation started. */
+	double start_time;
+};
+
 struct memtx_engine {
 	struct engine base;
 	/** Engine recovery state, see enum memtx_recovery_state description. */
@@ -122,8 +145,64 @@ struct memtx_engine {
 	struct checkpoint *checkpoint;
 	/** The directory where to store snapshots. */
 	struct xdir snap_dir;
+	/**
+	 * Delta snapshots, stored in the snapshot directory. A delta
+	 * snapshot contains only tuples changed since the previous
+	 * checkpoint and is recovered on top of it.
+	 */
+	struct xdir delta_dir;
+	/**
+	 * Max number of delta snapshots written after a full one,
+	 * box.cfg.memtx_checkpoint_delta_count. Zero disables delta
+	 * snapshots.
+	 */
+	int checkpoint_delta_count;
+	/** Number of delta snapshots written after the last full one. */
+	int checkpoint_delta_chain;
+	/**
+	 * Primary keys of tuples changed since the last checkpoint or
+	 * NULL if changes aren't tracked, in which case the next
+	 * checkpoint is written in full.
+	 */
+	struct memtx_delta_set *delta_set;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t snap_io_rate_limit;
+	/**
+	 * Number of threads compressing a snapshot file,
+	 * box.cfg.memtx_snapshot_compress_threads.
+	 */
+	int snap_compress_threads;
+	/**
+	 * Zstd compression level of a snapshot file,
+	 * box.cfg.memtx_snapshot_compression_level.
+	 */
+	int snap_compression_level;
+	/**
+	 * Write the order of secondary tree indexes to snapshots,
+	 * box.cfg.memtx_snapshot_index_order.
+	 */
+	bool snap_index_order;
+	/**
+	 * Orders of secondary indexes loaded from the snapshot, see
+	 * memtx_engine_take_index_order(), or NULL. Freed once
+	 * secondary indexes are built.
+	 */
+	struct mh_i64ptr_t *index_orders;
+	/**
+	 * Build secondary keys in background after recovery instead of
+	 * building them before box.cfg() returns,
+	 * box.cfg.memtx_background_index_build.
+	 */
+	bool background_index_build;
+	/**
+	 * Ids of spaces with secondary keys to be built in background,
+	 * in the build order, see memtx_engine_deferred_build_f().
+	 */
+	uint32_t *deferred_space_ids;
+	/** Number of entries in deferred_space_ids. */
+	int deferred_space_count;
+	/** Position in deferred_space_ids of the space being built. */
+	int deferred_space_pos;
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/**
@@ -159,6 +238,16 @@ struct memtx_engine {
 	void *reserved_extents;
 	/** Maximal allowed tuple size, box.cfg.memtx_max_tuple_size. */
 	size_t max_tuple_size;
+	/**
+	 * Preferred NUMA node of the tuple arena, box.cfg.memtx_numa_node,
+	 * or -1 if the default memory policy is used.
+	 */
+	int numa_node;
+	/**
+	 * Set if the tuple arena is advised to be backed by transparent
+	 * huge pages, box.cfg.memtx_use_huge_pages.
+	 */
+	bool use_huge_pages;
 	/** Memory pool for rtree index iterator. */
 	struct mempool rtree_iterator_pool;
 	/**
@@ -177,6 +266,27 @@ struct memtx_engine {
 	 * memtx_gc_task::link.
 	 */
 	struct stailq gc_queue;
+	/**
+	 * Tuple defragmentation fiber. Runs a defragmentation pass
+	 * over all memtx spaces on demand, see memtx_engine_defragment().
+	 */
+	struct fiber *defrag_fiber;
+	/** Set if a new tuple defragmentation pass was requested. */
+	bool defrag_requested;
+	/** Number of tuples moved by defragmentation. */
+	int64_t defrag_relocated;
+	/** Number of completed tuple defragmentation passes. */
+	int64_t defrag_passes;
+	/**
+	 * DDL operations scanning spaces in progress, linked by
+	 * memtx_ddl_progress::in_ddl_progress.
+	 */
+	struct rlist ddl_progress;
+	/**
+	 * Max number of tuples processed per second by DDL operations
+	 * scanning spaces, box.cfg.memtx_ddl_rate_limit. 0 if unlimited.
+	 */
+	double ddl_rate_limit;
 	/**
 	 * Format used for allocating functional index keys.
 	 */
@@ -217,6 +327,18 @@ void
 memtx_engine_schedule_gc(struct memtx_engine *memtx,
 			 struct memtx_gc_task *task);
 
+/**
+ * Request a tuple defragmentation pass over all memtx spaces.
+ *
+ * The pass runs in background. It moves tuples stored in sparse
+ * size classes of the tuple allocator to a lower address so that
+ * the highest slabs of the classes are emptied and released to
+ * the arena. If a pass is already in progress, another one will
+ * be started after it completes.
+ */
+void
+memtx_engine_defragment(struct memtx_engine *memtx);
+
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
@@ -230,6 +352,14 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 void
 memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h);
 
+/**
+ * Memory usage of memtx spaces broken down by space and by index
+ * (box.info.memory_detail()).
+ */
+void
+memtx_engine_memory_detail(struct memtx_engine *memtx,
+			   struct info_handler *h);
+
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock);
@@ -243,6 +373,113 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+/**
+ * Set the max number of delta snapshots written after a full one.
+ * Zero disables delta snapshots.
+ */
+void
+memtx_engine_set_checkpoint_delta_count(struct memtx_engine *memtx,
+					int count);
+
+/**
+ * Set the number of threads compressing a snapshot file. Takes effect
+ * starting from the next checkpoint.
+ */
+void
+memtx_engine_set_snap_compress_threads(struct memtx_engine *memtx,
+				       int count);
+
+/**
+ * Set the zstd compression level of a snapshot file. Takes effect
+ * starting from the next checkpoint.
+ */
+void
+memtx_engine_set_snap_compression_level(struct memtx_engine *memtx,
+					int level);
+
+/**
+ * Set the max number of tuples processed per second by a DDL operation
+ * scanning a space. 0 means no limit. Takes effect immediately.
+ */
+void
+memtx_engine_set_ddl_rate_limit(struct memtx_engine *memtx, double limit);
+
+/**
+ * Return the total size of the files of the last checkpoint, that is
+ * the snapshot and the delta snapshots written after it, in bytes.
+ */
+int64_t
+memtx_engine_checkpoint_size(struct memtx_engine *memtx);
+
+/**
+ * Set whether the order of secondary tree indexes is written to
+ * snapshots. Takes effect starting from the next checkpoint.
+ */
+void
+memtx_engine_set_snap_index_order(struct memtx_engine *memtx, bool value);
+
+/**
+ * Set whether secondary keys are built in background after recovery.
+ * Must be called before recovery.
+ */
+void
+memtx_engine_set_background_index_build(struct memtx_engine *memtx,
+					bool value);
+
+/**
+ * Report the state of the background build of secondary keys started
+ * after recovery (box.info.recovery).
+ */
+void
+memtx_engine_index_build_info(struct memtx_engine *memtx,
+			      struct info_handler *h);
+
+/**
+ * Take the order of a secondary index loaded from the snapshot: the
+ * positions of the index tuples in the primary index, the number of
+ * positions is returned in @a size. Returns NULL if there's no order
+ * for the index. The caller is supposed to free the returned array.
+ */
+uint32_t *
+memtx_engine_take_index_order(struct memtx_engine *memtx, uint32_t space_id,
+			      uint32_t index_id, size_t *size);
+
+/**
+ * Remember that the tuple with the primary key of @a tuple was changed
+ * in @a space so that it's written to the next delta snapshot. A change
+ * of a system space makes the next checkpoint a full one.
+ */
+void
+memtx_engine_track_change(struct memtx_engine *memtx, struct space *space,
+			  struct tuple *tuple);
+
+/**
+ * Sets the preferred NUMA node for the memtx tuple arena pages that
+ * haven't been touched yet. If @a node is negative, the default memory
+ * policy is used. Supported only on Linux.
+ *
+ * Returns -1 and sets diag on error.
+ */
+int
+memtx_engine_set_numa_node(struct memtx_engine *memtx, int node);
+
+/**
+ * Advise the kernel to back the memtx arena with transparent huge pages
+ * or stop doing it. If huge pages are not available, regular pages are
+ * used and a warning is logged.
+ *
+ * Returns -1 and sets diag on error.
+ */
+int
+memtx_engine_set_huge_pages(struct memtx_engine *memtx, bool use_huge_pages);
+
+/**
+ * Return the size of the memtx arena backed by huge pages, in bytes,
+ * or 0 if it's unknown.
+ */
+size_t
+memtx_engine_huge_pages_size(struct memtx_engine *memtx);
+
 /** Tuple format vtab for memtx engine. */
 extern struct tuple_format_vtab memtx_tuple_format_vtab;
 
@@ -37,10 +37,13 @@
 #include "memtx_tx.h"
 #include "memtx_engine.h"
 #include "memtx_tuple_compression.h"
+#include "tuple_hash.h"
 #include "space.h"
 #include "schema.h" /* space_by_id(), space_cache_find() */
 #include "errinj.h"
 #include "trivia/config.h"
+#include "trivia/util.h"
+#include "tt_sort.h"
 
 #include <small/mempool.h>
 
@@ -76,11 +79,26 @@ memtx_hash_equal_key(struct tuple *tuple, const char *key,
 #undef LIGHT_EQUAL
 #undef LIGHT_EQUAL_KEY
 
+/** A tuple collected for index build along with its hash. */
+struct memtx_hash_build_entry {
+	uint32_t hash;
+	struct tuple *tuple;
+};
+
 struct memtx_hash_index {
 	struct index base;
+	/**
+	 * Hash functions of the index, either the default ones of
+	 * the key_def or the ones selected by the hash_func option.
+	 */
+	tuple_hash_t tuple_hash;
+	key_hash_t key_hash;
 	struct light_index_core hash_table;
 	struct memtx_gc_task gc_task;
 	struct light_index_iterator gc_iterator;
+	/** Tuples collected by build_next() to be inserted on end_build(). */
+	struct memtx_hash_build_entry *build_array;
+	size_t build_array_size, build_array_alloc_size;
 };
 
 /* {{{ MemtxHash Iterators ****************************************/
@@ -194,6 +212,7 @@ static void
 memtx_hash_index_free(struct memtx_hash_index *index)
 {
 	light_index_destroy(&index->hash_table);
+	free(index->build_array);
 	free(index);
 }
 
@@ -264,11 +283,26 @@ memtx_hash_index_destroy(struct index *base)
 	}
 }
 
+/** Set the index hash functions according to its definition. */
+static void
+memtx_hash_index_set_hash_func(struct memtx_hash_index *index)
+{
+	struct index_def *def = index->base.def;
+	if (def->opts.hash_func == INDEX_HASH_FUNC_XXH3) {
+		key_def_get_xxh3_hash_func(def->key_def, &index->tuple_hash,
+					   &index->key_hash);
+	} else {
+		index->tuple_hash = def->key_def->tuple_hash;
+		index->key_hash = def->key_def->key_hash;
+	}
+}
+
 static void
 memtx_hash_index_update_def(struct index *base)
 {
 	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
 	index->hash_table.common.arg = index->base.def->key_def;
+	memtx_hash_index_set_hash_func(index);
 }
 
 static ssize_t
@@ -341,7 +375,7 @@ memtx_hash_index_get_internal(struct index *base, const char *key,
 	struct space *space = space_by_id(base->def->space_id);
 	struct txn *txn = in_txn();
 	*result = NULL;
-	uint32_t h = key_hash(key, base->def->key_def);
+	uint32_t h = index->key_hash(key, base->def->key_def);
 	uint32_t k = light_index_find_key(&index->hash_table, h, key);
 	if (k != light_index_end) {
 		struct tuple *tuple = light_index_get(&index->hash_table, k);
@@ -357,6 +391,76 @@ memtx_hash_index_get_internal(struct index *base, const char *key,
 	return 0;
 }
 
+/** Number of keys hashed in advance by memtx_hash_index_get_batch(). */
+enum { MEMTX_HASH_GET_BATCH_SIZE = 16 };
+
+static int
+memtx_hash_index_get_batch(struct index *base, const char *keys,
+			   uint32_t key_count, struct tuple **results)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct key_def *key_def = base->def->key_def;
+	assert(base->def->opts.is_unique);
+
+	struct space *space = space_by_id(base->def->space_id);
+	struct txn *txn = in_txn();
+	struct tuple **results_begin = results;
+	const char *key[MEMTX_HASH_GET_BATCH_SIZE];
+	uint32_t hash[MEMTX_HASH_GET_BATCH_SIZE];
+	uint32_t slot[MEMTX_HASH_GET_BATCH_SIZE];
+	while (key_count > 0) {
+		uint32_t count = MIN(key_count,
+				     (uint32_t)MEMTX_HASH_GET_BATCH_SIZE);
+		/*
+		 * Hash all keys of the batch first so that the hash
+		 * table lookups, which are dominated by cache misses,
+		 * can be pipelined.
+		 */
+		for (uint32_t i = 0; i < count; i++) {
+			key[i] = keys;
+			mp_next(&keys);
+			uint32_t part_count = mp_decode_array(&key[i]);
+			assert(part_count == key_def->part_count);
+			(void)part_count;
+			hash[i] = index->key_hash(key[i], key_def);
+		}
+		light_index_find_key_batch(&index->hash_table, hash, key,
+					   count, slot);
+		for (uint32_t i = 0; i < count; i++) {
+			struct tuple *tuple = NULL;
+			if (slot[i] != light_index_end) {
+				tuple = light_index_get(&index->hash_table,
+							slot[i]);
+				tuple = memtx_tx_tuple_clarify(txn, space,
+							       tuple, base, 0);
+			} else {
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+				memtx_tx_track_point(txn, space, base, key[i]);
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+			}
+			if (memtx_prepare_result_tuple(space, &tuple) != 0) {
+				index_get_batch_unref(results_begin,
+						      results - results_begin + i);
+				return -1;
+			}
+			if (tuple != NULL)
+				tuple_ref(tuple);
+			results[i] = tuple;
+		}
+		/*
+		 * Story garbage collection may delete tuples from the
+		 * index, which would invalidate the found slots, so run
+		 * it only when the whole chunk has been processed.
+		 */
+/********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
+		memtx_tx_story_gc();
+/*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
+		results += count;
+		key_count -= count;
+	}
+	return 0;
+}
+
 static int
 memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 			 struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -369,7 +473,7 @@ memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 	*successor = NULL;
 
 	if (new_tuple) {
-		uint32_t h = tuple_hash(new_tuple, base->def->key_def);
+		uint32_t h = index->tuple_hash(new_tuple, base->def->key_def);
 		struct tuple *dup_tuple = NULL;
 		uint32_t pos = light_index_replace(hash_table, h, new_tuple,
 						   &dup_tuple);
@@ -406,7 +510,7 @@ memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 	}
 
 	if (old_tuple) {
-		uint32_t h = tuple_hash(old_tuple, base->def->key_def);
+		uint32_t h = index->tuple_hash(old_tuple, base->def->key_def);
 		int res = light_index_delete_value(hash_table, h, old_tuple);
 		assert(res == 0); (void) res;
 	}
@@ -455,7 +559,8 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 
 		if (part_count != 0) {
 			light_index_iterator_key(&index->hash_table, &it->iterator,
-					key_hash(key, base->def->key_def), key);
+					index->key_hash(key, base->def->key_def),
+					key);
 			it->base.next_internal = hash_iterator_gt;
 		} else {
 			light_index_iterator_begin(&index->hash_table, &it->iterator);
@@ -477,7 +582,7 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 	case ITER_EQ:
 		assert(part_count > 0);
 		light_index_iterator_key(&index->hash_table, &it->iterator,
-				key_hash(key, base->def->key_def), key);
+				index->key_hash(key, base->def->key_def), key);
 		it->base.next_internal = hash_iterator_eq;
 		if (it->iterator.slotpos == light_index_end)
 /********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
@@ -496,6 +601,111 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 	return (struct iterator *)it;
 }
 
+/** Make sure that the build array has room for the given number of tuples. */
+static int
+memtx_hash_index_build_array_reserve(struct memtx_hash_index *index,
+				     size_t size)
+{
+	if (size <= index->build_array_alloc_size)
+		return 0;
+	struct memtx_hash_build_entry *tmp =
+		(struct memtx_hash_build_entry *)realloc(index->build_array,
+							 size * sizeof(*tmp));
+	if (tmp == NULL) {
+		diag_set(OutOfMemory, size * sizeof(*tmp),
+			 "memtx_hash_index", "build_next");
+		return -1;
+	}
+	index->build_array = tmp;
+	index->build_array_alloc_size = size;
+	return 0;
+}
+
+static void
+memtx_hash_index_begin_build(struct index *base)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	assert(light_index_count(&index->hash_table) == 0);
+	(void)index;
+}
+
+static int
+memtx_hash_index_reserve(struct index *base, uint32_t size_hint)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	return memtx_hash_index_build_array_reserve(index, size_hint);
+}
+
+static int
+memtx_hash_index_build_next(struct index *base, struct tuple *tuple)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	if (index->build_array_size == index->build_array_alloc_size) {
+		size_t size = MAX(index->build_array_alloc_size +
+				  DIV_ROUND_UP(index->build_array_alloc_size, 2),
+				  MEMTX_EXTENT_SIZE / sizeof(*index->build_array));
+		if (memtx_hash_index_build_array_reserve(index, size) != 0)
+			return -1;
+	}
+	struct memtx_hash_build_entry *entry =
+		&index->build_array[index->build_array_size++];
+	entry->hash = index->tuple_hash(tuple, base->def->key_def);
+	entry->tuple = tuple;
+	return 0;
+}
+
+/** Compare build entries by the hash table slots they go to. */
+static int
+memtx_hash_build_entry_cmp(const void *a, const void *b, void *arg)
+{
+	const struct memtx_hash_build_entry *entry_a =
+		(const struct memtx_hash_build_entry *)a;
+	const struct memtx_hash_build_entry *entry_b =
+		(const struct memtx_hash_build_entry *)b;
+	const struct light_index_common *ht =
+		(const struct light_index_common *)arg;
+	uint32_t slot_a = light_index_slot(ht, entry_a->hash);
+	uint32_t slot_b = light_index_slot(ht, entry_b->hash);
+	if (slot_a != slot_b)
+		return slot_a < slot_b ? -1 : 1;
+	return entry_a->hash < entry_b->hash ? -1 :
+	       entry_a->hash > entry_b->hash;
+}
+
+static void
+memtx_hash_index_end_build(struct index *base)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	struct light_index_core *hash_table = &index->hash_table;
+	/*
+	 * Allocate the whole table at once instead of growing it and
+	 * splitting chains on the way. Then insert the tuples in the
+	 * order of their slots: this way the table is filled almost
+	 * sequentially rather than touched at random. If the memory
+	 * can't be allocated in one go, the insertions below will try
+	 * to grow the table as usual.
+	 */
+	if (index->build_array_size <= UINT32_MAX)
+		light_index_reserve(hash_table, index->build_array_size);
+	tt_sort(index->build_array, index->build_array_size,
+		sizeof(index->build_array[0]), memtx_hash_build_entry_cmp,
+		&hash_table->common, memtx->sort_threads);
+	for (size_t i = 0; i < index->build_array_size; i++) {
+		struct memtx_hash_build_entry *entry = &index->build_array[i];
+		uint32_t pos = light_index_insert(hash_table, entry->hash,
+						  entry->tuple);
+		if (pos == light_index_end) {
+			panic("Failed to allocate memory in "
+			      "build of hash_table");
+		}
+	}
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
+}
+
 /** Read view implementation. */
 struct hash_read_view {
 	/** Base class. */
@@ -662,18 +872,20 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .max = */ generic_index_max,
 	/* .random = */ memtx_hash_index_random,
 	/* .count = */ memtx_hash_index_count,
+	/* .approximate_count = */ generic_index_approximate_count,
 	/* .get_internal = */ memtx_hash_index_get_internal,
 	/* .get = */ memtx_index_get,
+	/* .get_batch = */ memtx_hash_index_get_batch,
 	/* .replace = */ memtx_hash_index_replace,
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
 	/* .create_read_view = */ memtx_hash_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
-	/* .begin_build = */ generic_index_begin_build,
-	/* .reserve = */ generic_index_reserve,
-	/* .build_next = */ generic_index_build_next,
-	/* .end_build = */ generic_index_end_build,
+	/* .begin_build = */ memtx_hash_index_begin_build,
+	/* .reserve = */ memtx_hash_index_reserve,
+	/* .build_next = */ memtx_hash_index_build_next,
+	/* .end_build = */ memtx_hash_index_end_build,
 };
 
 struct index *
@@ -683,11 +895,21 @@ memtx_hash_index_new(struct memtx_engine *memtx, struct index_def *def)
 		(struct memtx_hash_index *)xcalloc(1, sizeof(*index));
 	index_create(&index->base, (struct engine *)memtx,
 		     &memtx_hash_index_vtab, def);
+	memtx_hash_index_set_hash_func(index);
 
 	light_index_create(&index->hash_table, index->base.def->key_def,
 			   MEMTX_EXTENT_SIZE, memtx_index_extent_alloc,
 			   memtx_index_extent_free, memtx,
 			   &memtx->index_extent_stats);
+	uint32_t bucket_count = def->opts.bucket_count;
+	if (light_index_reserve(&index->hash_table, bucket_count) != 0) {
+		diag_set(OutOfMemory, (size_t)bucket_count *
+			 sizeof(struct light_index_record),
+			 "hash_table", "bucket_count");
+		index_def_delete(index->base.def);
+		memtx_hash_index_free(index);
+		return NULL;
+	}
 	return &index->base;
 }
 
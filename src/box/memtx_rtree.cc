@@ -50,6 +50,12 @@ struct memtx_rtree_index {
 	struct index base;
 	unsigned dimension;
 	struct rtree tree;
+	/** Records collected by build_next, see rtree_bulk_load(). */
+	char *build_array;
+	/** Number of records in build_array. */
+	size_t build_array_size;
+	/** Number of records that fit in build_array. */
+	size_t build_array_alloc_size;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -177,6 +183,7 @@ memtx_rtree_index_destroy(struct index *base)
 {
 	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
 	rtree_destroy(&index->tree);
+	free(index->build_array);
 	free(index);
 }
 
@@ -299,6 +306,70 @@ memtx_rtree_index_reserve(struct index *base, uint32_t size_hint)
 }
 
 /** Implementation of create_iterator for memtx rtree index. */
+/**
+ * Reserve index extents for a tree bulk loaded from the given number of
+ * records: there is no error handling in the rtree lib and end_build
+ * can't fail.
+ */
+static int
+memtx_rtree_index_reserve_build(struct memtx_rtree_index *index,
+				size_t count)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)index->base.engine;
+	size_t page_count = rtree_bulk_load_page_count(&index->tree, count);
+	size_t pages_in_extent = MEMTX_EXTENT_SIZE / index->tree.page_size;
+	size_t extents = DIV_ROUND_UP(page_count, pages_in_extent);
+	/* Matras needs extents for its block tables, too. */
+	extents += DIV_ROUND_UP(extents, MEMTX_EXTENT_SIZE / sizeof(void *));
+	return memtx_index_extent_reserve(memtx, extents + 1 +
+					  RESERVE_EXTENTS_BEFORE_REPLACE);
+}
+
+static int
+memtx_rtree_index_build_next(struct index *base, struct tuple *tuple)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	assert(rtree_number_of_records(&index->tree) == 0);
+	struct rtree_rect rect;
+	if (extract_rectangle(&rect, tuple, base->def) != 0)
+		return -1;
+	size_t entry_size = rtree_bulk_entry_size(&index->tree);
+	if (index->build_array_size == index->build_array_alloc_size) {
+		size_t alloc_size = index->build_array_alloc_size +
+			DIV_ROUND_UP(index->build_array_alloc_size, 2);
+		alloc_size = MAX(alloc_size, MEMTX_EXTENT_SIZE / entry_size);
+		char *tmp = (char *)realloc(index->build_array,
+					    alloc_size * entry_size);
+		if (tmp == NULL) {
+			diag_set(OutOfMemory, alloc_size * entry_size,
+				 "memtx_rtree_index", "build_next");
+			return -1;
+		}
+		index->build_array = tmp;
+		index->build_array_alloc_size = alloc_size;
+	}
+	if (memtx_rtree_index_reserve_build(index,
+					    index->build_array_size + 1) != 0)
+		return -1;
+	rtree_bulk_entry_set(&index->tree, index->build_array,
+			     index->build_array_size++, &rect, tuple);
+	return 0;
+}
+
+static void
+memtx_rtree_index_end_build(struct index *base)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	/* Memory for the tree pages was reserved by build_next. */
+	if (rtree_bulk_load(&index->tree, index->build_array,
+			    index->build_array_size) != 0)
+		panic("failed to bulk load RTREE index");
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
+}
+
 static struct iterator *
 memtx_rtree_index_create_iterator(struct index *base, enum iterator_type type,
 				  const char *key, uint32_t part_count,
@@ -397,8 +468,10 @@ static const struct index_vtab memtx_rtree_index_vtab = {
 	/* .max = */ generic_index_max,
 	/* .random = */ generic_index_random,
 	/* .count = */ memtx_rtree_index_count,
+	/* .approximate_count = */ generic_index_approximate_count,
 	/* .get_internal = */ memtx_rtree_index_get_internal,
 	/* .get = */ memtx_index_get,
+	/* .get_batch = */ generic_index_get_batch,
 	/* .replace = */ memtx_rtree_index_replace,
 	/* .create_iterator = */ memtx_rtree_index_create_iterator,
 	/* .create_read_view = */ generic_index_create_read_view,
@@ -407,8 +480,8 @@ static const struct index_vtab memtx_rtree_index_vtab = {
 	/* .reset_stat = */ generic_index_reset_stat,
 	/* .begin_build = */ generic_index_begin_build,
 	/* .reserve = */ memtx_rtree_index_reserve,
-	/* .build_next = */ generic_index_build_next,
-	/* .end_build = */ generic_index_end_build,
+	/* .build_next = */ memtx_rtree_index_build_next,
+	/* .end_build = */ memtx_rtree_index_end_build,
 };
 
 struct index *
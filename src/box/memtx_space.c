@@ -41,6 +41,7 @@
 #include "memtx_tree.h"
 #include "memtx_rtree.h"
 #include "memtx_bitset.h"
+#include "memtx_art.h"
 #include "memtx_engine.h"
 #include "column_mask.h"
 #include "sequence.h"
@@ -127,6 +128,37 @@ memtx_space_update_tuple_stat(struct space *space, struct tuple *old_tuple,
 	}
 }
 
+/** Set diag for a change of a space with indexes waiting to be built. */
+static void
+diag_set_space_not_built(struct space *space)
+{
+	struct error *e = diag_set(ClientError, ER_LOADING);
+	error_set_str(e, "space", space_name(space));
+	error_set_uint(e, "space_id", space_id(space));
+	error_append_msg(e, " - indexes of space '%s' are not built yet",
+			 space_name(space));
+}
+
+/**
+ * A version of space_replace for a space the secondary keys of
+ * which are being built in background after recovery. The space
+ * can't be modified until they are built.
+ */
+int
+memtx_space_replace_deferred_keys(struct space *space,
+				  struct tuple *old_tuple,
+				  struct tuple *new_tuple,
+				  enum dup_replace_mode mode,
+				  struct tuple **result)
+{
+	(void)old_tuple;
+	(void)new_tuple;
+	(void)mode;
+	(void)result;
+	diag_set_space_not_built(space);
+	return -1;
+}
+
 /**
  * A version of space_replace for a space which has
  * no indexes (is not yet fully built).
@@ -178,6 +210,7 @@ memtx_space_replace_build_next(struct space *space, struct tuple *old_tuple,
 	if (index_build_next(space->index[0], new_tuple) != 0)
 		return -1;
 	memtx_space_update_tuple_stat(space, NULL, new_tuple);
+	memtx_space_update_max_field_count(space, new_tuple);
 	tuple_ref(new_tuple);
 	return 0;
 }
@@ -197,6 +230,7 @@ memtx_space_replace_primary_key(struct space *space, struct tuple *old_tuple,
 			  new_tuple, mode, &old_tuple, &successor) != 0)
 		return -1;
 	memtx_space_update_tuple_stat(space, old_tuple, new_tuple);
+	memtx_space_update_max_field_count(space, new_tuple);
 	if (new_tuple != NULL)
 		tuple_ref(new_tuple);
 	*result = old_tuple;
@@ -314,6 +348,12 @@ memtx_space_replace_all_keys(struct space *space, struct tuple *old_tuple,
 	/* Replace must be done in transaction, except ephemeral spaces. */
 	assert(space->def->opts.is_ephemeral ||
 	       (in_txn() != NULL && txn_current_stmt(in_txn()) != NULL));
+	/*
+	 * Account the new tuple before the statement is applied so
+	 * that uncommitted (including MVCC) tuples are counted, too.
+	 * Overestimating is harmless.
+	 */
+	memtx_space_update_max_field_count(space, new_tuple);
 	/*
 	 * Don't use MVCC engine for ephemeral in any case.
 	 * MVCC engine requires txn to be present as a storage for
@@ -414,6 +454,9 @@ memtx_space_replace_tuple(struct space *space, struct txn_stmt *stmt,
 	}
 	if (space->upgrade != NULL && new_tuple != NULL)
 		memtx_space_upgrade_track_tuple(space->upgrade, new_tuple);
+	memtx_engine_track_change((struct memtx_engine *)space->engine, space,
+				  orig_new_tuple != NULL ? orig_new_tuple :
+				  stmt->old_tuple);
 finish:
 	/*
 	 * Regardless of whether the function ended with success or
@@ -761,6 +804,26 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 {
 	struct key_def *key_def = index_def->key_def;
 
+	if (index_def->type != HASH &&
+	    index_def->opts.hash_func != INDEX_HASH_FUNC_MURMUR) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "hash_func is only reasonable with memtx hash index");
+		return -1;
+	}
+	if (index_def->type != HASH && index_def->opts.bucket_count != 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "bucket_count is only reasonable with memtx hash index");
+		return -1;
+	}
+	if (index_def->type != TREE && key_def->has_filter) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "filter is only reasonable with memtx tree index");
+		return -1;
+	}
+
 	if (key_def->is_nullable) {
 		if (index_def->iid == 0) {
 			diag_set(ClientError, ER_NULLABLE_PRIMARY,
@@ -798,6 +861,51 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 	case TREE:
 		/* TREE index has no limitations. */
 		break;
+	case ART:
+		if (!index_def->opts.is_unique) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "ART index must be unique");
+			return -1;
+		}
+		if (key_def->is_multikey) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "ART index cannot be multikey");
+			return -1;
+		}
+		if (key_def->for_func_index) {
+			diag_set(ClientError, ER_MODIFY_INDEX,
+				 index_def->name, space_name(space),
+				 "ART index can not use a function");
+			return -1;
+		}
+		for (uint32_t i = 0; i < key_def->part_count; i++) {
+			struct key_part *part = &key_def->parts[i];
+			if (part->type != FIELD_TYPE_UNSIGNED &&
+			    part->type != FIELD_TYPE_INTEGER &&
+			    part->type != FIELD_TYPE_STRING) {
+				diag_set(ClientError, ER_MODIFY_INDEX,
+					 index_def->name, space_name(space),
+					 "ART index field type must be "
+					 "UNSIGNED, INTEGER or STRING");
+				return -1;
+			}
+			if (part->coll != NULL) {
+				diag_set(ClientError, ER_MODIFY_INDEX,
+					 index_def->name, space_name(space),
+					 "ART index can not use collations");
+				return -1;
+			}
+			if (part->sort_order == SORT_ORDER_DESC) {
+				diag_set(ClientError, ER_MODIFY_INDEX,
+					 index_def->name, space_name(space),
+					 "ART index can not use descending "
+					 "sort order");
+				return -1;
+			}
+		}
+		break;
 	case RTREE:
 		if (key_def->part_count != 1) {
 			diag_set(ClientError, ER_MODIFY_INDEX,
@@ -935,6 +1043,8 @@ memtx_space_create_index(struct space *space, struct index_def *index_def)
 		return memtx_rtree_index_new(memtx, index_def);
 	case BITSET:
 		return memtx_bitset_index_new(memtx, index_def);
+	case ART:
+		return memtx_art_index_new(memtx, index_def);
 	default:
 		unreachable();
 		return NULL;
@@ -990,6 +1100,52 @@ struct memtx_ddl_state {
 	int rc;
 };
 
+/**
+ * Starts tracking the progress of a DDL operation scanning a space
+ * in background. The index is NULL if it's a format check.
+ */
+static void
+memtx_ddl_progress_begin(struct memtx_ddl_progress *progress,
+			 const char *op, struct space *space,
+			 struct index *index, size_t total)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	progress->op = op;
+	progress->space = space;
+	progress->index = index;
+	progress->processed = 0;
+	progress->total = total;
+	progress->start_time = ev_monotonic_now(loop());
+	rlist_add_tail_entry(&memtx->ddl_progress, progress, in_ddl_progress);
+}
+
+/** Stops tracking the progress of a DDL operation. */
+static void
+memtx_ddl_progress_end(struct memtx_ddl_progress *progress)
+{
+	rlist_del_entry(progress, in_ddl_progress);
+}
+
+/**
+ * Yields in the middle of a DDL operation scanning a space. If
+ * box.cfg.memtx_ddl_rate_limit is set, sleeps long enough for the
+ * operation not to process tuples faster than the limit.
+ */
+static void
+memtx_ddl_yield(struct memtx_ddl_progress *progress)
+{
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)progress->space->engine;
+	double timeout = 0;
+	if (memtx->ddl_rate_limit > 0) {
+		double elapsed = ev_monotonic_now(loop()) -
+				 progress->start_time;
+		timeout = progress->processed / memtx->ddl_rate_limit -
+			  elapsed;
+	}
+	fiber_sleep(MAX(timeout, 0));
+}
+
 static int
 memtx_check_on_replace(struct trigger *trigger, void *event)
 {
@@ -1025,7 +1181,9 @@ memtx_space_check_format(struct space *space, struct tuple_format *format)
 {
 	struct txn *txn = in_txn();
 
-	if (tuple_format1_can_store_format2_tuples(format, space->format))
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (tuple_format1_can_store_format2_tuples_with_field_count(
+			format, space->format, memtx_space->max_field_count))
 		return 0;
 	if (space->index_count == 0)
 		return 0;
@@ -1051,9 +1209,12 @@ memtx_space_check_format(struct space *space, struct tuple_format *format)
 	trigger_create(&on_replace, memtx_check_on_replace, &state, NULL);
 	trigger_add(&space->on_replace, &on_replace);
 
+	struct memtx_ddl_progress progress;
+	memtx_ddl_progress_begin(&progress, "check_format", space, NULL,
+				 index_size(pk));
+
 	int rc;
 	struct tuple *tuple;
-	size_t count = 0;
 	while ((rc = iterator_next_internal(it, &tuple)) == 0 &&
 	       tuple != NULL) {
 		/*
@@ -1067,9 +1228,9 @@ memtx_space_check_format(struct space *space, struct tuple_format *format)
 		state.cursor = tuple;
 		tuple_ref(state.cursor);
 
-		if (++count % MEMTX_DDL_YIELD_LOOPS == 0 &&
+		if (++progress.processed % MEMTX_DDL_YIELD_LOOPS == 0 &&
 		    memtx->state == MEMTX_OK)
-			fiber_sleep(0);
+			memtx_ddl_yield(&progress);
 
 		ERROR_INJECT_YIELD(ERRINJ_CHECK_FORMAT_DELAY);
 
@@ -1080,6 +1241,7 @@ memtx_space_check_format(struct space *space, struct tuple_format *format)
 			break;
 		}
 	}
+	memtx_ddl_progress_end(&progress);
 	iterator_delete(it);
 	diag_destroy(&state.diag);
 	trigger_clear(&on_replace);
@@ -1325,24 +1487,47 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 	 * etc., the build is aborted.
 	 */
 	/* Build the new index. */
+	struct memtx_ddl_progress progress;
+	memtx_ddl_progress_begin(&progress, "build_index", src_space,
+				 new_index, index_size(pk));
 	int rc;
 	struct tuple *tuple;
-	size_t count = 0;
+	/*
+	 * All tuples of a space usually share the same format, so
+	 * format checks are done only when the format of the next
+	 * tuple differs from the previous one. The last checked
+	 * format is referenced so that it can't be freed and its
+	 * memory reused by another format while we yield.
+	 */
+	struct tuple_format *checked_format = NULL;
+	bool need_validate = true;
 	while ((rc = iterator_next_internal(it, &tuple)) == 0 &&
 	       tuple != NULL) {
-		struct key_def *key_def = new_index->def->key_def;
-		if (!tuple_format_is_compatible_with_key_def(tuple_format(tuple),
-							     key_def)) {
-			rc = -1;
-			break;
+		struct tuple_format *format = tuple_format(tuple);
+		if (format != checked_format) {
+			struct key_def *key_def = new_index->def->key_def;
+			if (!tuple_format_is_compatible_with_key_def(format,
+								     key_def)) {
+				rc = -1;
+				break;
+			}
+			if (checked_format != NULL)
+				tuple_format_unref(checked_format);
+			checked_format = format;
+			tuple_format_ref(checked_format);
+			need_validate = !tuple_format1_can_store_format2_tuples(
+						new_format, format);
 		}
 		/*
 		 * Check that the tuple is OK according to the
-		 * new format.
+		 * new format unless the new format can store any
+		 * tuple of the tuple format.
 		 */
-		rc = memtx_tuple_validate(new_format, tuple);
-		if (rc != 0)
-			break;
+		if (need_validate) {
+			rc = memtx_tuple_validate(new_format, tuple);
+			if (rc != 0)
+				break;
+		}
 		/*
 		 * @todo: better message if there is a duplicate.
 		 */
@@ -1362,6 +1547,7 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		 */
 		if (new_index->def->iid == 0)
 			tuple_ref(tuple);
+		progress.processed++;
 		/*
 		 * Do not build index in background
 		 * if the feature is disabled.
@@ -1375,9 +1561,9 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		 */
 		state.cursor = tuple;
 		tuple_ref(state.cursor);
-		if (++count % MEMTX_DDL_YIELD_LOOPS == 0 &&
+		if (progress.processed % MEMTX_DDL_YIELD_LOOPS == 0 &&
 		    memtx->state == MEMTX_OK)
-			fiber_sleep(0);
+			memtx_ddl_yield(&progress);
 		/*
 		 * Sleep after at least one tuple is inserted to test
 		 * on_replace triggers for index build.
@@ -1399,7 +1585,10 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 			break;
 		}
 	}
+	memtx_ddl_progress_end(&progress);
 	iterator_delete(it);
+	if (checked_format != NULL)
+		tuple_format_unref(checked_format);
 	if (can_yield) {
 		diag_destroy(&state.diag);
 		trigger_clear(&on_replace);
@@ -1413,6 +1602,15 @@ memtx_space_prepare_alter(struct space *old_space, struct space *new_space)
 	struct memtx_space *old_memtx_space = (struct memtx_space *)old_space;
 	struct memtx_space *new_memtx_space = (struct memtx_space *)new_space;
 
+	/*
+	 * Indexes waiting to be built are empty so they can't be
+	 * altered or used to build new indexes.
+	 */
+	if (old_memtx_space->replace == memtx_space_replace_deferred_keys) {
+		diag_set_space_not_built(old_space);
+		return -1;
+	}
+
 	if (memtx_space_bsize(old_space) != 0 &&
 	    space_is_data_temporary(old_space) !=
 	    space_is_data_temporary(new_space)) {
@@ -1444,6 +1642,9 @@ memtx_space_finish_alter(struct space *old_space, struct space *new_space)
 			old_memtx_space->tuple_stat[TUPLE_ARENA_MEMTX];
 		new_memtx_space->tuple_stat[TUPLE_ARENA_MALLOC] =
 			old_memtx_space->tuple_stat[TUPLE_ARENA_MALLOC];
+		new_memtx_space->max_field_count =
+			MAX(new_memtx_space->max_field_count,
+			    old_memtx_space->max_field_count);
 	}
 }
 
@@ -1511,6 +1712,7 @@ memtx_space_new(struct memtx_engine *memtx,
 
 	memset(&memtx_space->tuple_stat, 0, sizeof(memtx_space->tuple_stat));
 	memtx_space->rowid = 0;
+	memtx_space->max_field_count = 0;
 	memtx_space->replace = memtx_space_replace_no_keys;
 	return (struct space *)memtx_space;
 }
@@ -56,6 +56,13 @@ struct memtx_space {
 	 * tuples within one unique primary key.
 	 */
 	uint64_t rowid;
+	/**
+	 * Upper bound of the number of fields in the tuples stored
+	 * in the space. It's updated on each insertion and never
+	 * decreases. Used to append nullable fields to the space
+	 * format without checking the space data.
+	 */
+	uint32_t max_field_count;
 	/**
 	 * A pointer to replace function, set to different values
 	 * at different stages of recovery.
@@ -77,6 +84,22 @@ void
 memtx_space_update_tuple_stat(struct space *space, struct tuple *old_tuple,
 			      struct tuple *new_tuple);
 
+/**
+ * Account the number of fields of a tuple inserted into a space
+ * in memtx_space::max_field_count.
+ */
+static inline void
+memtx_space_update_max_field_count(struct space *space,
+				   struct tuple *new_tuple)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (new_tuple == NULL)
+		return;
+	uint32_t field_count = tuple_field_count(new_tuple);
+	if (field_count > memtx_space->max_field_count)
+		memtx_space->max_field_count = field_count;
+}
+
 int
 memtx_space_replace_no_keys(struct space *, struct tuple *, struct tuple *,
 			    enum dup_replace_mode, struct tuple **);
@@ -89,6 +112,10 @@ memtx_space_replace_primary_key(struct space *, struct tuple *, struct tuple *,
 int
 memtx_space_replace_all_keys(struct space *, struct tuple *, struct tuple *,
 			     enum dup_replace_mode, struct tuple **);
+int
+memtx_space_replace_deferred_keys(struct space *, struct tuple *,
+				  struct tuple *, enum dup_replace_mode,
+				  struct tuple **);
 
 struct space *
 memtx_space_new(struct memtx_engine *memtx,
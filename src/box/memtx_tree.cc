@@ -43,6 +43,7 @@
 #include "trivia/config.h"
 #include "trivia/util.h"
 #include "tt_sort.h"
+#include "bit/bit.h"
 #include <small/mempool.h>
 
 /**
@@ -120,6 +121,8 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 			       (b)->part_count, (b)->hint, arg)
 #define BPS_TREE_IS_IDENTICAL(a, b) memtx_tree_data_is_equal(&a, &b)
 #define BPS_TREE_NO_DEBUG 1
+/* Inner block cardinalities are used for counting tuples in a range. */
+#define BPS_INNER_CARD
 #define bps_tree_arg_t struct key_def *
 
 #define BPS_TREE_NAMESPACE NS_NO_HINT
@@ -135,12 +138,21 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #define BPS_TREE_NAMESPACE NS_USE_HINT
 #define bps_tree_elem_t struct memtx_tree_data<true>
 #define bps_tree_key_t struct memtx_tree_key_data<true> *
+#define BPS_TREE_ELEM_HINT(a) ((a).hint)
+#define BPS_TREE_KEY_HINT(b) ((b)->hint)
+/* Multikey and functional index hints aren't comparison hints. */
+#define BPS_TREE_USE_HINT(arg) \
+	(!(arg)->is_multikey && !(arg)->for_func_index)
+static_assert(HINT_NONE == UINT64_MAX, "BPS tree unknown hint is UINT64_MAX");
 
 #include "salad/bps_tree.h"
 
 #undef BPS_TREE_NAMESPACE
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
+#undef BPS_TREE_ELEM_HINT
+#undef BPS_TREE_KEY_HINT
+#undef BPS_TREE_USE_HINT
 
 #undef BPS_TREE_NAME
 #undef BPS_TREE_BLOCK_SIZE
@@ -149,6 +161,7 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef BPS_TREE_COMPARE_KEY
 #undef BPS_TREE_IS_IDENTICAL
 #undef BPS_TREE_NO_DEBUG
+#undef BPS_INNER_CARD
 #undef bps_tree_arg_t
 
 using namespace NS_NO_HINT;
@@ -206,6 +219,44 @@ invalidate_tree_iterator(NS_USE_HINT::memtx_tree_iterator *itr)
 	*itr = NS_USE_HINT::memtx_tree_invalid_iterator();
 }
 
+/**
+ * Keys of a tuple stored in a functional index. They are kept in order
+ * to delete the tuple from the index without calling the function.
+ * The keys are referenced by the index tree, not by the entry.
+ */
+struct func_key_cache_entry {
+	/** Indexed tuple. */
+	struct tuple *tuple;
+	/** Number of the tuple keys. */
+	uint32_t key_count;
+	/** The key if there is only one, otherwise an array of keys. */
+	union {
+		struct tuple *key;
+		struct tuple **keys;
+	};
+};
+
+static inline uint32_t
+func_key_cache_hash(const struct tuple *tuple)
+{
+	uintptr_t u = (uintptr_t)tuple;
+	if (sizeof(uintptr_t) <= sizeof(uint32_t))
+		return u;
+	else
+		return u ^ (u >> 32);
+}
+
+#define mh_name _func_key_cache
+#define mh_key_t struct tuple *
+#define mh_node_t struct func_key_cache_entry
+#define mh_arg_t int
+#define mh_hash(a, arg) (func_key_cache_hash((a)->tuple))
+#define mh_hash_key(a, arg) (func_key_cache_hash(a))
+#define mh_cmp(a, b, arg) (((a)->tuple) != ((b)->tuple))
+#define mh_cmp_key(a, b, arg) ((a) != ((b)->tuple))
+#define MH_SOURCE
+#include "salad/mhash.h"
+
 template <bool USE_HINT>
 struct memtx_tree_index {
 	struct index base;
@@ -216,6 +267,8 @@ struct memtx_tree_index {
 	memtx_tree_iterator_t<USE_HINT> gc_iterator;
 	/** Whether index is functional. */
 	bool is_func;
+	/** Functional index only: keys of the indexed tuples. */
+	struct mh_func_key_cache_t *func_key_cache;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -395,6 +448,20 @@ tree_iterator_prev_reposition(struct tree_iterator<USE_HINT> *iterator,
 	assert(exact || in_txn() == NULL || !memtx_tx_manager_use_mvcc_engine);
 }
 
+/**
+ * Prefetch the tuple the given tree element points to. Used by forward
+ * scans to load the next tuple while the current one is processed:
+ * tuples referenced by neighbouring tree elements are usually scattered
+ * over memory so each of them is a cache miss otherwise.
+ */
+template <bool USE_HINT>
+static inline void
+memtx_tree_data_prefetch(struct memtx_tree_data<USE_HINT> *data)
+{
+	if (data != NULL)
+		prefetch(data->tuple, 0);
+}
+
 template <bool USE_HINT>
 static int
 tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
@@ -420,6 +487,10 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	if (*ret == NULL) {
 		iterator->next_internal = exhausted_iterator_next;
 	} else {
+		memtx_tree_iterator_t<USE_HINT> next = it->tree_iterator;
+		memtx_tree_iterator_next(&index->tree, &next);
+		memtx_tree_data_prefetch<USE_HINT>(
+			memtx_tree_iterator_get_elem(&index->tree, &next));
 		tree_iterator_set_last<USE_HINT>(it, res);
 		struct txn *txn = in_txn();
 		bool is_multikey = index_base->def->key_def->is_multikey;
@@ -890,6 +961,17 @@ memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
 {
 	memtx_tree_destroy(&index->tree);
 	free(index->build_array);
+	struct mh_func_key_cache_t *cache = index->func_key_cache;
+	if (cache != NULL) {
+		mh_int_t k;
+		mh_foreach(cache, k) {
+			struct func_key_cache_entry *entry =
+				mh_func_key_cache_node(cache, k);
+			if (entry->key_count > 1)
+				free(entry->keys);
+		}
+		mh_func_key_cache_delete(cache);
+	}
 	free(index);
 }
 
@@ -1023,7 +1105,10 @@ memtx_tree_index_bsize(struct index *base)
 {
 	struct memtx_tree_index<USE_HINT> *index =
 		(struct memtx_tree_index<USE_HINT> *)base;
-	return memtx_tree_mem_used(&index->tree);
+	size_t bsize = memtx_tree_mem_used(&index->tree);
+	if (index->func_key_cache != NULL)
+		bsize += mh_func_key_cache_memsize(index->func_key_cache);
+	return bsize;
 }
 
 template <bool USE_HINT>
@@ -1060,9 +1145,58 @@ static ssize_t
 memtx_tree_index_count(struct index *base, enum iterator_type type,
 		       const char *key, uint32_t part_count)
 {
-	if (type == ITER_ALL)
+	if (type == ITER_ALL || part_count == 0)
 		return memtx_tree_index_size<USE_HINT>(base); /* optimization */
-	return generic_index_count(base, type, key, part_count);
+	/*
+	 * With MVCC enabled some tuples may be invisible and the read
+	 * must be tracked, so fall back on the iterator.
+	 */
+	if (memtx_tx_manager_use_mvcc_engine)
+		return generic_index_count(base, type, key, part_count);
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	memtx_tree_t<USE_HINT> *tree = &index->tree;
+	struct key_def *cmp_def = memtx_tree_cmp_def(tree);
+	struct memtx_tree_key_data<USE_HINT> key_data;
+	key_data.key = key;
+	key_data.part_count = part_count;
+	if (USE_HINT)
+		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	/*
+	 * The tree stores cardinalities of the inner blocks so the
+	 * number of elements less than the key (lower bound offset)
+	 * or less or equal to the key (upper bound offset) is found
+	 * in O(log n).
+	 */
+	size_t size = memtx_tree_size(tree);
+	size_t lower = size, upper = size;
+	switch (type) {
+	case ITER_EQ:
+	case ITER_REQ:
+		memtx_tree_lower_bound_get_offset(tree, &key_data, NULL,
+						  &lower);
+		memtx_tree_upper_bound_get_offset(tree, &key_data, NULL,
+						  &upper);
+		return upper - lower;
+	case ITER_GE:
+		memtx_tree_lower_bound_get_offset(tree, &key_data, NULL,
+						  &lower);
+		return size - lower;
+	case ITER_GT:
+		memtx_tree_upper_bound_get_offset(tree, &key_data, NULL,
+						  &upper);
+		return size - upper;
+	case ITER_LE:
+		memtx_tree_upper_bound_get_offset(tree, &key_data, NULL,
+						  &upper);
+		return upper;
+	case ITER_LT:
+		memtx_tree_lower_bound_get_offset(tree, &key_data, NULL,
+						  &lower);
+		return lower;
+	default:
+		return generic_index_count(base, type, key, part_count);
+	}
 }
 
 template <bool USE_HINT>
@@ -1481,6 +1615,64 @@ func_key_undo_new(struct region *region)
 	return undo;
 }
 
+/** Add a key of a tuple to the functional key cache of an index. */
+static void
+memtx_tree_func_key_cache_add(struct memtx_tree_index<true> *index,
+			      struct tuple *tuple, struct tuple *key)
+{
+	struct mh_func_key_cache_t *cache = index->func_key_cache;
+	mh_int_t k = mh_func_key_cache_find(cache, tuple, 0);
+	if (k == mh_end(cache)) {
+		struct func_key_cache_entry entry;
+		entry.tuple = tuple;
+		entry.key_count = 1;
+		entry.key = key;
+		mh_func_key_cache_put(cache, &entry, NULL, 0);
+		return;
+	}
+	struct func_key_cache_entry *entry = mh_func_key_cache_node(cache, k);
+	if (entry->key_count == 1) {
+		struct tuple **keys = (struct tuple **)xmalloc(2 * sizeof(*keys));
+		keys[0] = entry->key;
+		entry->keys = keys;
+	} else if ((entry->key_count & (entry->key_count - 1)) == 0) {
+		/* The array capacity is the next power of two. */
+		entry->keys = (struct tuple **)xrealloc(entry->keys,
+				2 * entry->key_count * sizeof(*entry->keys));
+	}
+	entry->keys[entry->key_count++] = key;
+}
+
+/**
+ * Delete a tuple from a functional index by the keys cached on its
+ * insertion. Returns false if the tuple keys are not cached, then
+ * they have to be computed with the function.
+ */
+static bool
+memtx_tree_func_index_delete_cached(struct memtx_tree_index<true> *index,
+				    struct tuple *tuple)
+{
+	struct mh_func_key_cache_t *cache = index->func_key_cache;
+	mh_int_t k = mh_func_key_cache_find(cache, tuple, 0);
+	if (k == mh_end(cache))
+		return false;
+	struct func_key_cache_entry entry = *mh_func_key_cache_node(cache, k);
+	mh_func_key_cache_del(cache, k, 0);
+	struct tuple **keys = entry.key_count > 1 ? entry.keys : &entry.key;
+	struct memtx_tree_data<true> data, deleted_data;
+	data.tuple = tuple;
+	for (uint32_t i = 0; i < entry.key_count; i++) {
+		data.hint = (hint_t)keys[i];
+		deleted_data.tuple = NULL;
+		memtx_tree_delete_value(&index->tree, data, &deleted_data);
+		if (deleted_data.tuple != NULL)
+			tuple_unref((struct tuple *)deleted_data.hint);
+	}
+	if (entry.key_count > 1)
+		free(entry.keys);
+	return true;
+}
+
 /**
  * Rollback a sequence of memtx_tree_index_replace_multikey_one
  * insertions for functional index. Routine uses given list to
@@ -1511,6 +1703,8 @@ memtx_tree_func_index_replace_rollback(struct memtx_tree_index<true> *index,
  * It is used to restore the original b+* entries with their
  * original key_hint(s) pointers in case of failure and release
  * the now useless hints of old items in case of success.
+ * The keys of inserted tuples are cached so that deleting a tuple
+ * doesn't need to call the function again.
  */
 static int
 memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
@@ -1609,6 +1803,14 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 			assert(old_tuple == NULL || old_tuple == *result);
 			old_tuple = *result;
 		}
+		/*
+		 * The cached keys of the old tuple may be hints of
+		 * the replaced entries, so use them before the hints
+		 * are released.
+		 */
+		if (old_tuple != NULL &&
+		    memtx_tree_func_index_delete_cached(index, old_tuple))
+			old_tuple = NULL;
 		/*
 		 * Commit changes: release hints for
 		 * replaced entries.
@@ -1616,8 +1818,13 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 		rlist_foreach_entry(undo, &old_keys, link) {
 			tuple_unref((struct tuple *)undo->key.hint);
 		}
+		rlist_foreach_entry(undo, &new_keys, link) {
+			memtx_tree_func_key_cache_add(index, new_tuple,
+					(struct tuple *)undo->key.hint);
+		}
 	}
-	if (old_tuple != NULL) {
+	if (old_tuple != NULL &&
+	    !memtx_tree_func_index_delete_cached(index, old_tuple)) {
 		/*
 		 * Use the runtime format to avoid OOM while deleting a tuple
 		 * from a space. It's okay, because we are not going to store
@@ -1920,6 +2127,66 @@ memtx_tree_index_build_array_deduplicate(
 	index->build_array_size = w_idx + 1;
 }
 
+/**
+ * Reorders the build_array of the index according to the order loaded
+ * from the snapshot, see memtx_engine_take_index_order(). The build_array
+ * is filled in the primary index order, so the order consists of indexes
+ * in the build_array. Returns true if the build_array is sorted now.
+ *
+ * The order is checked to be a permutation and the result is checked to
+ * be sorted, because the snapshot might be written by a version with
+ * a different collation, for instance. It takes a linear number of
+ * comparisons instead of sorting. If the check fails, the build_array
+ * may be left reordered arbitrarily but not corrupted.
+ */
+template <bool USE_HINT>
+static bool
+memtx_tree_index_apply_build_order(struct memtx_tree_index<USE_HINT> *index)
+{
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	struct memtx_engine *memtx = (struct memtx_engine *)index->base.engine;
+	size_t size;
+	uint32_t *order = memtx_engine_take_index_order(
+		memtx, index->base.def->space_id, index->base.def->iid, &size);
+	if (order == NULL)
+		return false;
+	bool is_sorted = false;
+	struct memtx_tree_data<USE_HINT> *array = NULL;
+	uint8_t *is_used = NULL;
+	if (size != index->build_array_size || index->is_func ||
+	    cmp_def->is_multikey)
+		goto out;
+	array = (struct memtx_tree_data<USE_HINT> *)xmalloc(
+		size * sizeof(*array));
+	is_used = (uint8_t *)xcalloc(DIV_ROUND_UP(size, 8), 1);
+	for (size_t i = 0; i < size; i++) {
+		uint32_t pos = order[i];
+		if (pos >= size || bit_test(is_used, pos))
+			goto out;
+		bit_set(is_used, pos);
+		array[i] = index->build_array[pos];
+	}
+	SWAP(array, index->build_array);
+	index->build_array_alloc_size = size;
+	is_sorted = true;
+	for (size_t i = 1; i < size && is_sorted; i++) {
+		if (memtx_tree_qcompare<USE_HINT>(&index->build_array[i - 1],
+						  &index->build_array[i],
+						  cmp_def) >= 0)
+			is_sorted = false;
+	}
+	if (!is_sorted) {
+		say_warn("order of index '%s' loaded from the snapshot "
+			 "is invalid, sorting the index",
+			 index->base.def->name);
+	}
+out:
+	free(is_used);
+	free(array);
+	free(order);
+	return is_sorted;
+}
+
 template <bool USE_HINT>
 static void
 memtx_tree_index_end_build(struct index *base)
@@ -1928,9 +2195,12 @@ memtx_tree_index_end_build(struct index *base)
 		(struct memtx_tree_index<USE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
-	tt_sort(index->build_array, index->build_array_size,
-		sizeof(index->build_array[0]), memtx_tree_qcompare<USE_HINT>,
-		cmp_def, memtx->sort_threads);
+	if (!memtx_tree_index_apply_build_order<USE_HINT>(index)) {
+		tt_sort(index->build_array, index->build_array_size,
+			sizeof(index->build_array[0]),
+			memtx_tree_qcompare<USE_HINT>, cmp_def,
+			memtx->sort_threads);
+	}
 	if (cmp_def->is_multikey || cmp_def->for_func_index) {
 		/*
 		 * Multikey index may have equal(in terms of
@@ -1943,6 +2213,15 @@ memtx_tree_index_end_build(struct index *base)
 	}
 	memtx_tree_build(&index->tree, index->build_array,
 			 index->build_array_size);
+	if (index->func_key_cache != NULL) {
+		for (size_t i = 0; i < index->build_array_size; i++) {
+			struct memtx_tree_data<USE_HINT> *elem =
+				&index->build_array[i];
+			memtx_tree_func_key_cache_add(
+				(struct memtx_tree_index<true> *)index,
+				elem->tuple, (struct tuple *)elem->hint);
+		}
+	}
 
 	free(index->build_array);
 	index->build_array = NULL;
@@ -2043,6 +2322,9 @@ tree_read_view_iterator_next_raw(struct index_read_view_iterator *iterator,
 
 		memtx_tree_view_iterator_next(&rv->tree_view,
 					      &it->tree_iterator);
+		memtx_tree_data_prefetch<USE_HINT>(
+			memtx_tree_view_iterator_get_elem(&rv->tree_view,
+							  &it->tree_iterator));
 		if (memtx_prepare_read_view_tuple(res->tuple, &rv->base,
 						  &rv->cleaner, result) != 0)
 			return -1;
@@ -2190,8 +2472,10 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .max = */ generic_index_max,
 	/* .random = */ generic_index_random,
 	/* .count = */ generic_index_count,
+	/* .approximate_count = */ generic_index_approximate_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ generic_index_get,
+	/* .get_batch = */ generic_index_get_batch,
 	/* .replace = */ disabled_index_replace,
 	/* .create_iterator = */ generic_index_create_iterator,
 	/* .create_read_view = */ generic_index_create_read_view,
@@ -2250,8 +2534,10 @@ get_memtx_tree_index_vtab(void)
 		/* .max = */ generic_index_max,
 		/* .random = */ memtx_tree_index_random<USE_HINT>,
 		/* .count = */ memtx_tree_index_count<USE_HINT>,
+		/* .approximate_count = */ generic_index_approximate_count,
 		/* .get_internal */ memtx_tree_index_get_internal<USE_HINT>,
 		/* .get = */ memtx_index_get,
+		/* .get_batch = */ generic_index_get_batch,
 		/* .replace = */ is_mk ? memtx_tree_index_replace_multikey :
 				 is_func ? memtx_tree_func_index_replace :
 				 memtx_tree_index_replace<USE_HINT>,
@@ -2291,6 +2577,8 @@ memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 			  memtx_index_extent_free, memtx,
 			  &memtx->index_extent_stats);
 	index->is_func = def->key_def->func_index_func != NULL;
+	if (index->is_func)
+		index->func_key_cache = mh_func_key_cache_new();
 	return &index->base;
 }
 
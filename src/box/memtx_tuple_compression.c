@@ -0,0 +1,266 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_tuple_compression.h"
+
+#include <string.h>
+
+#include "diag.h"
+#include "errcode.h"
+#include "fiber.h"
+#include "intern_dict.h"
+#include "memtx_engine.h"
+#include "msgpuck.h"
+#include "mp_compression.h"
+#include "mp_extension_types.h"
+#include "small/region.h"
+#include "tuple.h"
+#include "tuple_format.h"
+
+#if defined(ENABLE_TUPLE_COMPRESSION)
+# error unimplemented
+#endif
+
+enum {
+	/**
+	 * Fields shorter than this are stored as is: the gain, if
+	 * any, isn't worth the time spent on decompression.
+	 */
+	MEMTX_TUPLE_COMPRESSION_MIN_SIZE = 64,
+	/**
+	 * Interned values shorter than this are stored as is: an id
+	 * of an interned value takes up to 3 bytes.
+	 */
+	MEMTX_TUPLE_INTERNING_MIN_SIZE = 4,
+};
+
+/** Check if @a field is an MP_COMPRESSION value. */
+static bool
+memtx_tuple_field_is_compressed(const char *field)
+{
+	if (mp_typeof(*field) != MP_EXT)
+		return false;
+	int8_t type;
+	mp_decode_extl(&field, &type);
+	return type == MP_COMPRESSION;
+}
+
+/**
+ * Encode the value of @a field of @a format at @a data of @a size
+ * bytes to @a dst. On success sets @a dst_end to the end of the
+ * encoded value or to NULL if the value should be stored as is.
+ */
+static int
+memtx_tuple_field_encode(struct tuple_format *format,
+			 struct tuple_field *field, const char *data,
+			 size_t size, char *dst, char **dst_end)
+{
+	*dst_end = NULL;
+	if (field->is_interned) {
+		if (mp_typeof(*data) != MP_STR ||
+		    size < MEMTX_TUPLE_INTERNING_MIN_SIZE)
+			return 0;
+		int64_t id = intern_dict_put(format->intern_dict, data, size);
+		if (id >= 0)
+			*dst_end = mp_encode_uint(dst, id);
+		return 0;
+	}
+	enum compression_type type = field->compression_type;
+	if (type == COMPRESSION_TYPE_NONE ||
+	    size < MEMTX_TUPLE_COMPRESSION_MIN_SIZE)
+		return 0;
+	char *end = mp_compress(dst, data, size, type);
+	if (end == NULL) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 compression_type_strs[type]);
+		return -1;
+	}
+	/* Store the value as is if compression is useless. */
+	if ((size_t)(end - dst) < size)
+		*dst_end = end;
+	return 0;
+}
+
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	assert(format->is_compressed);
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	const char *data_end = data + bsize;
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	uint32_t count = MIN(field_count, tuple_format_field_count(format));
+	/* Estimate the size of the compressed tuple. */
+	size_t size = bsize;
+	const char *field = pos;
+	for (uint32_t i = 0; i < count; i++) {
+		const char *field_end = field;
+		mp_next(&field_end);
+		if (tuple_format_field(format, i)->compression_type !=
+		    COMPRESSION_TYPE_NONE)
+			size += mp_compress_bound(field_end - field);
+		field = field_end;
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *buf = xregion_alloc(region, size);
+	char *buf_end = mp_encode_array(buf, field_count);
+	bool is_compressed = false;
+	field = pos;
+	for (uint32_t i = 0; i < count; i++) {
+		const char *field_end = field;
+		mp_next(&field_end);
+		size_t field_size = field_end - field;
+		char *next;
+		if (memtx_tuple_field_encode(format,
+					     tuple_format_field(format, i),
+					     field, field_size, buf_end,
+					     &next) != 0) {
+			region_truncate(region, region_svp);
+			return NULL;
+		}
+		if (next != NULL) {
+			is_compressed = true;
+		} else {
+			memcpy(buf_end, field, field_size);
+			next = buf_end + field_size;
+		}
+		buf_end = next;
+		field = field_end;
+	}
+	if (!is_compressed) {
+		region_truncate(region, region_svp);
+		return tuple;
+	}
+	memcpy(buf_end, field, data_end - field);
+	buf_end += data_end - field;
+	assert((size_t)(buf_end - buf) <= size);
+	struct tuple *result = memtx_tuple_new_raw(format, buf, buf_end, false);
+	region_truncate(region, region_svp);
+	return result;
+}
+
+/**
+ * Check if field @a fieldno of @a format stored at @a field is an id
+ * of an interned value.
+ */
+static bool
+memtx_tuple_field_is_interned(struct tuple_format *format, uint32_t fieldno,
+			      const char *field)
+{
+	return format->intern_dict != NULL &&
+	       fieldno < tuple_format_field_count(format) &&
+	       tuple_format_field(format, fieldno)->is_interned &&
+	       mp_typeof(*field) == MP_UINT;
+}
+
+/**
+ * Decode the fields of the tuple data of @a format at @a data to
+ * the fiber region. Returns @a data itself if there are no encoded
+ * fields or NULL on error.
+ */
+static const char *
+memtx_tuple_data_decompress(struct tuple_format *format, const char *data,
+			    const char *data_end, uint32_t *p_size)
+{
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	const char *fields = pos;
+	size_t size = data_end - data;
+	bool is_compressed = false;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		size_t raw_size;
+		if (memtx_tuple_field_is_compressed(field)) {
+			raw_size = mp_decompressed_size(field);
+		} else if (memtx_tuple_field_is_interned(format, i, field)) {
+			const char *id = field;
+			const struct intern_dict_value *value =
+				intern_dict_get(format->intern_dict,
+						mp_decode_uint(&id));
+			raw_size = value != NULL ? value->size : 0;
+		} else {
+			continue;
+		}
+		if (raw_size == 0) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "malformed encoded field");
+			return NULL;
+		}
+		size = size - (pos - field) + raw_size;
+		is_compressed = true;
+	}
+	*p_size = size;
+	if (!is_compressed)
+		return data;
+	char *buf = xregion_alloc(&fiber()->gc, size);
+	char *buf_end = buf + size;
+	char *out = mp_encode_array(buf, field_count);
+	pos = fields;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		if (memtx_tuple_field_is_compressed(field)) {
+			size_t raw_size = mp_decompress(&pos, out,
+							buf_end - out);
+			if (raw_size == 0) {
+				diag_set(ClientError, ER_DECOMPRESSION,
+					 "malformed compressed field");
+				return NULL;
+			}
+			out += raw_size;
+			continue;
+		}
+		if (memtx_tuple_field_is_interned(format, i, field)) {
+			const struct intern_dict_value *value =
+				intern_dict_get(format->intern_dict,
+						mp_decode_uint(&pos));
+			memcpy(out, value->data, value->size);
+			out += value->size;
+			continue;
+		}
+		mp_next(&pos);
+		memcpy(out, field, pos - field);
+		out += pos - field;
+	}
+	memcpy(out, pos, data_end - pos);
+	assert(out + (data_end - pos) == buf_end);
+	return buf;
+}
+
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	if (!format->is_compressed)
+		return tuple;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	uint32_t size;
+	const char *raw = memtx_tuple_data_decompress(format, data,
+						      data + bsize, &size);
+	struct tuple *result = tuple;
+	if (raw == NULL)
+		result = NULL;
+	else if (raw != data)
+		result = memtx_tuple_new_raw(format, raw, raw + size, false);
+	region_truncate(region, region_svp);
+	return result;
+}
+
+const char *
+memtx_tuple_decompress_raw(struct tuple_format *format, const char *tuple,
+			   const char *tuple_end, uint32_t *p_size)
+{
+	if (!format->is_compressed) {
+		*p_size = tuple_end - tuple;
+		return tuple;
+	}
+	return memtx_tuple_data_decompress(format, tuple, tuple_end, p_size);
+}
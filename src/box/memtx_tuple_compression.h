@@ -17,28 +17,32 @@
 extern "C" {
 #endif
 
-static inline struct tuple *
-memtx_tuple_compress(struct tuple *tuple)
-{
-        (void)tuple;
-        unreachable();
-        return NULL;
-}
-
-static inline struct tuple *
-memtx_tuple_decompress(struct tuple *tuple)
-{
-	assert(!tuple_is_compressed(tuple));
-	return tuple;
-}
-
-static inline const char *
-memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
-			   uint32_t *p_size)
-{
-	*p_size = tuple_end - tuple;
-	return tuple;
-}
+/**
+ * Compress and intern the fields of @a tuple according to its
+ * format.
+ * Returns @a tuple itself if no field was worth compressing,
+ * a new tuple otherwise or NULL on error (diag is set).
+ */
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple);
+
+/**
+ * Decompress the fields of @a tuple, including interned ones.
+ * Returns @a tuple itself if it has no compressed fields, a new tuple of the same format
+ * otherwise or NULL on error (diag is set).
+ */
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple);
+
+/**
+ * Decompress the fields of the tuple data of @a format at @a tuple.
+ * Returns the data itself if there are no compressed fields, a copy
+ * allocated on the fiber region otherwise or NULL on error (diag is
+ * set). The size of the result is returned in @a p_size.
+ */
+const char *
+memtx_tuple_decompress_raw(struct tuple_format *format, const char *tuple,
+			   const char *tuple_end, uint32_t *p_size);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -36,6 +36,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "clock.h"
+#include "fiber.h"
 #include "schema_def.h"
 #include "small/mempool.h"
 
@@ -572,6 +574,13 @@ struct tx_manager
 	struct rlist all_txs;
 	/** Accumulated number of GC steps that should be done. */
 	size_t must_do_gc_steps;
+	/**
+	 * Fiber doing the GC steps that were not done in transaction
+	 * paths, see memtx_tx_story_gc().
+	 */
+	struct fiber *gc_fiber;
+	/** Number of GC steps done by the GC fiber. */
+	size_t gc_fiber_steps;
 };
 
 enum {
@@ -581,14 +590,29 @@ enum {
 	 * a new story.
 	 */
 		TX_MANAGER_GC_STEPS_SIZE = 2,
+	/**
+	 * Max number of GC steps done in a transaction path. The rest
+	 * are left to the GC fiber, so that a transaction that created
+	 * a lot of stories doesn't stall the next one.
+	 */
+	TX_MANAGER_GC_STEPS_MAX = 64,
 };
 
+/**
+ * Max time the GC fiber is allowed to run per event loop iteration,
+ * in seconds.
+ */
+static const double TX_MANAGER_GC_FIBER_BUDGET = 1e-3;
+
 /** That's a definition, see declaration for description. */
 bool memtx_tx_manager_use_mvcc_engine = false;
 
 /** The one and only instance of tx_manager. */
 static struct tx_manager txm;
 
+static int
+memtx_tx_gc_f(va_list va);
+
 void
 memtx_tx_manager_init()
 {
@@ -618,6 +642,11 @@ memtx_tx_manager_init()
 	txm.traverse_all_stories = &txm.all_stories;
 	txm.must_do_gc_steps = 0;
 	memset(&txm.story_stats, 0, sizeof(txm.story_stats));
+	txm.gc_fiber_steps = 0;
+	txm.gc_fiber = fiber_new_system("memtx.tx_gc", memtx_tx_gc_f);
+	if (txm.gc_fiber == NULL)
+		panic("failed to start MVCC garbage collection fiber");
+	fiber_start(txm.gc_fiber);
 }
 
 void
@@ -662,6 +691,8 @@ memtx_tx_statistics_collect(struct memtx_tx_statistics *stats)
 		}
 	}
 	stats->txn_count = txn_count;
+	stats->gc_pending_steps = txm.must_do_gc_steps;
+	stats->gc_fiber_steps = txm.gc_fiber_steps;
 }
 
 void
@@ -732,6 +763,31 @@ memtx_tx_adjust_position_in_read_view_list(struct txn *txn)
 	rlist_add_tail(&prev_txn->in_read_view_txs, &txn->in_read_view_txs);
 }
 
+void
+memtx_tx_make_read_only(struct txn *txn)
+{
+	assert(txn_has_flag(txn, TXN_IS_READ_ONLY));
+	assert(stailq_empty(&txn->stmts));
+	if (!memtx_tx_manager_use_mvcc_engine)
+		return;
+	assert(txn->status == TXN_INPROGRESS);
+	/*
+	 * Changes of prepared transactions are not visible for the read
+	 * view, but they would become visible on commit if the read view
+	 * started after them, so start it before the oldest of them.
+	 */
+	int64_t rv_psn = txn_next_psn;
+	struct txn *other;
+	rlist_foreach_entry(other, &txm.all_txs, in_all_txs) {
+		if (other->status == TXN_PREPARED && other->psn < rv_psn)
+			rv_psn = other->psn;
+	}
+	txn->status = TXN_IN_READ_VIEW;
+	txn->rv_psn = rv_psn;
+	rlist_add_tail(&txm.read_view_txs, &txn->in_read_view_txs);
+	memtx_tx_adjust_position_in_read_view_list(txn);
+}
+
 /**
  * Mark @a victim as conflicted and abort it.
  * Does nothing if the transaction is already aborted.
@@ -760,6 +816,14 @@ memtx_tx_abort_with_conflict(struct txn *victim)
  * changes is chosen.
  * Otherwise @a victim must be marked as conflicted and aborted on occasion.
  *
+ * Since read sets include gaps and full scans, they work as predicate locks,
+ * and the rule above makes the history of committed read-write transactions
+ * serializable regardless of the isolation level, which only determines what
+ * changes a transaction may see. It's stricter than SSI, which aborts a
+ * transaction only if it has both an incoming and an outgoing read-write
+ * dependency, so some transactions are aborted needlessly, but no dependency
+ * graph has to be maintained.
+ *
  * NB: can trigger story garbage collection.
  */
 static void
@@ -1512,11 +1576,13 @@ memtx_tx_story_full_unlink_story_gc_step(struct memtx_story *story)
 
 /**
  * Run one step of a crawler that traverses all stories and removes no more
- * used stories.
+ * used stories. The step is accounted as one of the accumulated GC steps.
  */
 void
 memtx_tx_story_gc_step()
 {
+	if (txm.must_do_gc_steps > 0)
+		txm.must_do_gc_steps--;
 	if (txm.traverse_all_stories == &txm.all_stories) {
 		/* We came to the head of the list. */
 		txm.traverse_all_stories = txm.traverse_all_stories->next;
@@ -1602,9 +1668,41 @@ memtx_tx_story_gc_step()
 void
 memtx_tx_story_gc()
 {
-	for (size_t i = 0; i < txm.must_do_gc_steps; i++)
+	size_t steps = MIN(txm.must_do_gc_steps,
+			   (size_t)TX_MANAGER_GC_STEPS_MAX);
+	for (size_t i = 0; i < steps; i++)
 		memtx_tx_story_gc_step();
-	txm.must_do_gc_steps = 0;
+	if (txm.must_do_gc_steps > 0)
+		fiber_wakeup(txm.gc_fiber);
+}
+
+/**
+ * Fiber that does the GC steps accumulated but not done in
+ * transaction paths. It yields to the event loop if it runs out
+ * of the time budget.
+ */
+static int
+memtx_tx_gc_f(va_list va)
+{
+	(void)va;
+	while (!fiber_is_cancelled()) {
+		if (txm.must_do_gc_steps == 0) {
+			fiber_yield();
+			continue;
+		}
+		double deadline = clock_monotonic() +
+				  TX_MANAGER_GC_FIBER_BUDGET;
+		do {
+			size_t steps = MIN(txm.must_do_gc_steps,
+					   (size_t)TX_MANAGER_GC_STEPS_MAX);
+			for (size_t i = 0; i < steps; i++)
+				memtx_tx_story_gc_step();
+			txm.gc_fiber_steps += steps;
+		} while (txm.must_do_gc_steps > 0 &&
+			 clock_monotonic() < deadline);
+		fiber_sleep(0);
+	}
+	return 0;
 }
 
 /**
@@ -2819,6 +2917,9 @@ detect_whether_prepared_ok(struct txn *txn)
 {
 	if (txn == NULL)
 		return false;
+	else if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		/* Read-only transactions see only committed changes. */
+		return false;
 	else if (txn->isolation == TXN_ISOLATION_READ_COMMITTED)
 		return true;
 	else if (txn->isolation == TXN_ISOLATION_READ_CONFIRMED ||
@@ -2887,6 +2988,22 @@ memtx_tx_index_invisible_count_slow(struct txn *txn,
 	return res;
 }
 
+void
+memtx_tx_space_statistics_collect(struct space *space,
+				  struct memtx_tx_space_statistics *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	struct memtx_story *story;
+	rlist_foreach_entry(story, &space->memtx_stories, in_space_stories) {
+		memtx_tx_stats_collect(&stats->stories,
+				       memtx_story_size(story));
+		if (story->tuple_is_retained) {
+			memtx_tx_stats_collect(&stats->retained_tuples,
+					       tuple_size(story->tuple));
+		}
+	}
+}
+
 /**
  * Destroy and free any kind of gap item.
  */
@@ -2984,6 +3101,8 @@ memtx_tx_track_read_story(struct txn *txn, struct space *space,
 {
 	if (txn == NULL || space == NULL || space->def->opts.is_ephemeral)
 		return;
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		return;
 	(void)space;
 	assert(story != NULL);
 	struct tx_read_tracker *tracker = NULL;
@@ -3028,6 +3147,8 @@ memtx_tx_track_read(struct txn *txn, struct space *space, struct tuple *tuple)
 		return;
 	if (txn == NULL || space == NULL || space->def->opts.is_ephemeral)
 		return;
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		return;
 
 	if (tuple_has_flag(tuple, TUPLE_IS_DIRTY)) {
 		struct memtx_story *story = memtx_tx_story_get(tuple);
@@ -132,6 +132,10 @@ struct memtx_tx_statistics {
 	size_t tx_max[TX_ALLOC_TYPE_MAX];
 	/* Number of txns registered in memtx transaction manager. */
 	size_t txn_count;
+	/* Number of story GC steps that are yet to be done. */
+	size_t gc_pending_steps;
+	/* Number of story GC steps done by the background GC fiber. */
+	size_t gc_fiber_steps;
 };
 
 /**
@@ -140,6 +144,24 @@ struct memtx_tx_statistics {
 void
 memtx_tx_statistics_collect(struct memtx_tx_statistics *stats);
 
+/**
+ * Memory statistics of memtx mvcc engine related to one space.
+ */
+struct memtx_tx_space_statistics {
+	/** Stories of the space tuples. */
+	struct memtx_tx_stats stories;
+	/** Tuples of the space that are retained only by stories. */
+	struct memtx_tx_stats retained_tuples;
+};
+
+/**
+ * Collect MVCC memory usage statistics of a space. Traverses all stories
+ * of the space, so it's meant for diagnostics only.
+ */
+void
+memtx_tx_space_statistics_collect(struct space *space,
+				  struct memtx_tx_space_statistics *stats);
+
 /**
  * Initialize MVCC part of a transaction.
  * Must be called even if MVCC engine is not enabled in config.
@@ -147,6 +169,15 @@ memtx_tx_statistics_collect(struct memtx_tx_statistics *stats);
 void
 memtx_tx_register_txn(struct txn *txn);
 
+/**
+ * Send a read-only transaction @a txn to a read view of the current
+ * state of the database. The transaction will not see any changes
+ * prepared after this point and will not track its reads, since it
+ * can never conflict. Does nothing if MVCC engine is not enabled.
+ */
+void
+memtx_tx_make_read_only(struct txn *txn);
+
 /**
  * Initialize memtx transaction manager.
  */
@@ -284,6 +315,9 @@ memtx_tx_track_point(struct txn *txn, struct space *space,
 		return;
 	if (txn == NULL || space == NULL || space->def->opts.is_ephemeral)
 		return;
+	/* Read-only transactions read from a snapshot, no need to track. */
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		return;
 	memtx_tx_track_point_slow(txn, index, key);
 }
 
@@ -314,6 +348,9 @@ memtx_tx_track_gap(struct txn *txn, struct space *space, struct index *index,
 		return;
 	if (txn == NULL || space == NULL || space->def->opts.is_ephemeral)
 		return;
+	/* Read-only transactions read from a snapshot, no need to track. */
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		return;
 	memtx_tx_track_gap_slow(txn, space, index, successor,
 				type, key, part_count);
 }
@@ -342,11 +379,15 @@ memtx_tx_track_full_scan(struct txn *txn, struct space *space,
 		return;
 	if (txn == NULL || space == NULL || space->def->opts.is_ephemeral)
 		return;
+	/* Read-only transactions read from a snapshot, no need to track. */
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		return;
 	memtx_tx_track_full_scan_slow(txn, index);
 }
 
 /**
- * Run several rounds of memtx_tx_story_gc_step()
+ * Run several rounds of memtx_tx_story_gc_step(). The number of rounds
+ * is limited, the remaining ones are done by a background fiber.
  */
 void
 memtx_tx_story_gc();
@@ -36,9 +36,6 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#define HEAP_FORWARD_DECLARATION
-#include "salad/heap.h"
-
 #include "diag.h"             /* diag_set() */
 #include "box/tuple.h"        /* tuple_ref(), tuple_unref(),
 				 tuple_validate() */
@@ -52,42 +49,30 @@
 /**
  * Holds a source to fetch next tuples and a last fetched tuple to
  * compare the node against other nodes.
- *
- * The main reason why this structure is separated from a merge
- * source is that a heap node can not be a member of several
- * heaps.
- *
- * The second reason is that it allows to encapsulate all heap
- * related logic inside this compilation unit, without any traces
- * in externally visible structures.
  */
-struct merger_heap_node {
+struct merger_node {
 	/* A source of tuples. */
 	struct merge_source *source;
 	/*
 	 * A last fetched (refcounted) tuple to compare against
-	 * other nodes.
+	 * other nodes or NULL if the source is exhausted.
 	 */
 	struct tuple *tuple;
-	/* An anchor to make the structure a merger heap node. */
-	struct heap_node in_merger;
 };
 
-static bool
-merge_source_less(const heap_t *heap, const struct merger_heap_node *left,
-		  const struct merger_heap_node *right);
-#define HEAP_NAME merger_heap
-#define HEAP_LESS merge_source_less
-#define heap_value_t struct merger_heap_node
-#define heap_value_attr in_merger
-#include "salad/heap.h"
-#undef HEAP_NAME
-#undef HEAP_LESS
-#undef heap_value_t
-#undef heap_value_attr
-
 /**
- * Holds a heap, parameters of a merge process and utility fields.
+ * Holds a loser tree, parameters of a merge process and utility
+ * fields.
+ *
+ * The loser tree is a complete binary tree stored in an array
+ * the same way as a binary heap: internal nodes have indexes
+ * [1, node_count), leaves have indexes [node_count, 2 * node_count)
+ * and correspond to merger nodes. An internal node stores the
+ * merger node that lost the match between the winners of its
+ * subtrees, the overall winner is stored at index 0. When the
+ * winner is advanced, it only has to replay the matches on the
+ * path from its leaf to the root, which takes one comparison
+ * per tree level, while a binary heap sift-down takes two.
  */
 struct merger {
 	/* A merger is a source. */
@@ -95,22 +80,23 @@ struct merger {
 	/*
 	 * Whether a merge process started.
 	 *
-	 * The merger postpones charging of heap nodes until a
-	 * first output tuple is acquired.
+	 * The merger postpones fetching of first tuples from
+	 * sources until a first output tuple is acquired.
 	 */
 	bool started;
 	/* A key_def to compare tuples. */
 	struct key_def *key_def;
 	/* A format to acquire compatible tuples from sources. */
 	struct tuple_format *format;
+	/* An array of merger nodes. */
+	uint32_t node_count;
+	struct merger_node *nodes;
 	/*
-	 * A heap of sources (of nodes that contains a source to
-	 * be exact).
+	 * The loser tree: indexes of merger nodes. It has room
+	 * for 2 * node_count entries; entries past node_count are
+	 * used to store winners while the tree is built.
 	 */
-	heap_t heap;
-	/* An array of heap nodes. */
-	uint32_t node_count;
-	struct merger_heap_node *nodes;
+	uint32_t *tree;
 	/* Ascending (false) / descending (true) order. */
 	bool reverse;
 };
@@ -118,75 +104,91 @@ struct merger {
 /* Helpers */
 
 /**
- * Data comparing function to construct a heap of sources.
+ * Return true if the a-th merger node must be output before the
+ * b-th one. Exhausted nodes go after all others. Nodes with equal
+ * tuples are ordered by their indexes so that the order is total.
  */
-static bool
-merge_source_less(const heap_t *heap, const struct merger_heap_node *left,
-		  const struct merger_heap_node *right)
+static inline bool
+merger_node_less(struct merger *merger, uint32_t a, uint32_t b)
 {
-	assert(left->tuple != NULL);
-	assert(right->tuple != NULL);
-	struct merger *merger = container_of(heap, struct merger, heap);
-	int cmp = tuple_compare(left->tuple, HINT_NONE, right->tuple, HINT_NONE,
+	struct tuple *left = merger->nodes[a].tuple;
+	struct tuple *right = merger->nodes[b].tuple;
+	if (left == NULL || right == NULL)
+		return right == NULL && (left != NULL || a < b);
+	int cmp = tuple_compare(left, HINT_NONE, right, HINT_NONE,
 				merger->key_def);
-	return merger->reverse ? cmp >= 0 : cmp < 0;
+	if (cmp == 0)
+		return a < b;
+	return merger->reverse ? cmp > 0 : cmp < 0;
 }
 
 /**
- * Initialize a new merger heap node.
+ * Return the index of the merger node that won in the subtree
+ * rooted at the given loser tree index. Valid only while the
+ * tree is being built.
  */
-static void
-merger_heap_node_create(struct merger_heap_node *node,
-			struct merge_source *source)
+static inline uint32_t
+merger_tree_winner(struct merger *merger, uint32_t pos)
 {
-	node->source = source;
-	merge_source_ref(node->source);
-	node->tuple = NULL;
-	heap_node_create(&node->in_merger);
+	uint32_t count = merger->node_count;
+	return pos >= count ? pos - count : merger->tree[count + pos];
 }
 
 /**
- * Free a merger heap node.
+ * Build the loser tree from the current tuples of merger nodes.
  */
 static void
-merger_heap_node_delete(struct merger_heap_node *node)
+merger_tree_build(struct merger *merger)
 {
-	merge_source_unref(node->source);
-	if (node->tuple != NULL)
-		tuple_unref(node->tuple);
+	uint32_t count = merger->node_count;
+	assert(count > 0);
+	for (uint32_t pos = count - 1; pos > 0; pos--) {
+		uint32_t winner = merger_tree_winner(merger, 2 * pos);
+		uint32_t loser = merger_tree_winner(merger, 2 * pos + 1);
+		if (merger_node_less(merger, loser, winner))
+			SWAP(winner, loser);
+		merger->tree[pos] = loser;
+		merger->tree[count + pos] = winner;
+	}
+	merger->tree[0] = merger_tree_winner(merger, count > 1 ? 1 : count);
 }
 
 /**
- * The helper to add a new heap node to a merger heap.
- *
- * Return -1 at an error and set a diag.
- *
- * Otherwise store a next tuple in node->tuple, add the node to
- * merger->heap and return 0.
+ * Restore the loser tree after the tuple of the winner node was
+ * replaced.
  */
-static int
-merger_add_heap_node(struct merger *merger, struct merger_heap_node *node)
+static void
+merger_tree_replay(struct merger *merger)
 {
-	struct tuple *tuple = NULL;
-
-	/* Acquire a next tuple. */
-	struct merge_source *source = node->source;
-	if (merge_source_next(source, merger->format, &tuple) != 0)
-		return -1;
-
-	/* Don't add an empty source to a heap. */
-	if (tuple == NULL)
-		return 0;
-
-	node->tuple = tuple;
-
-	/* Add a node to a heap. */
-	if (merger_heap_insert(&merger->heap, node) != 0) {
-		diag_set(OutOfMemory, 0, "malloc", "merger->heap");
-		return -1;
+	uint32_t count = merger->node_count;
+	uint32_t winner = merger->tree[0];
+	for (uint32_t pos = (count + winner) / 2; pos > 0; pos /= 2) {
+		if (merger_node_less(merger, merger->tree[pos], winner))
+			SWAP(merger->tree[pos], winner);
 	}
+	merger->tree[0] = winner;
+}
 
-	return 0;
+/**
+ * Initialize a new merger node.
+ */
+static void
+merger_node_create(struct merger_node *node, struct merge_source *source)
+{
+	node->source = source;
+	merge_source_ref(node->source);
+	node->tuple = NULL;
+}
+
+/**
+ * Free a merger node.
+ */
+static void
+merger_node_delete(struct merger_node *node)
+{
+	merge_source_unref(node->source);
+	if (node->tuple != NULL)
+		tuple_unref(node->tuple);
 }
 
 /* Virtual methods declarations */
@@ -210,20 +212,30 @@ static int
 merger_set_sources(struct merger *merger, struct merge_source **sources,
 		   uint32_t source_count)
 {
-	const size_t nodes_size = sizeof(struct merger_heap_node) *
-		source_count;
-	struct merger_heap_node *nodes = malloc(nodes_size);
+	if (source_count == 0)
+		return 0;
+
+	const size_t nodes_size = sizeof(struct merger_node) * source_count;
+	struct merger_node *nodes = malloc(nodes_size);
 	if (nodes == NULL) {
 		diag_set(OutOfMemory, nodes_size, "malloc",
-			 "merger heap nodes");
+			 "merger nodes");
+		return -1;
+	}
+	const size_t tree_size = sizeof(uint32_t) * 2 * source_count;
+	uint32_t *tree = malloc(tree_size);
+	if (tree == NULL) {
+		diag_set(OutOfMemory, tree_size, "malloc", "merger tree");
+		free(nodes);
 		return -1;
 	}
 
 	for (uint32_t i = 0; i < source_count; ++i)
-		merger_heap_node_create(&nodes[i], sources[i]);
+		merger_node_create(&nodes[i], sources[i]);
 
 	merger->node_count = source_count;
 	merger->nodes = nodes;
+	merger->tree = tree;
 	return 0;
 }
 
@@ -262,15 +274,14 @@ merger_new(struct key_def *key_def, struct merge_source **sources,
 	merger->started = false;
 	merger->key_def = key_def;
 	merger->format = format;
-	merger_heap_create(&merger->heap);
 	merger->node_count = 0;
 	merger->nodes = NULL;
+	merger->tree = NULL;
 	merger->reverse = reverse;
 
 	if (merger_set_sources(merger, sources, source_count) != 0) {
 		key_def_delete(merger->key_def);
 		tuple_format_unref(merger->format);
-		merger_heap_destroy(&merger->heap);
 		free(merger);
 		return NULL;
 	}
@@ -287,14 +298,12 @@ merger_delete(struct merge_source *base)
 
 	key_def_delete(merger->key_def);
 	tuple_format_unref(merger->format);
-	merger_heap_destroy(&merger->heap);
 
 	for (uint32_t i = 0; i < merger->node_count; ++i)
-		merger_heap_node_delete(&merger->nodes[i]);
-
-	if (merger->nodes != NULL)
-		free(merger->nodes);
+		merger_node_delete(&merger->nodes[i]);
 
+	free(merger->nodes);
+	free(merger->tree);
 	free(merger);
 }
 
@@ -304,27 +313,35 @@ merger_next(struct merge_source *base, struct tuple_format *format,
 {
 	struct merger *merger = container_of(base, struct merger, base);
 
+	if (merger->node_count == 0) {
+		*out = NULL;
+		return 0;
+	}
+
 	/*
-	 * Fetch a first tuple for each source and add all heap
-	 * nodes to a merger heap.
+	 * Fetch a first tuple for each source and build a loser
+	 * tree.
 	 */
 	if (!merger->started) {
 		for (uint32_t i = 0; i < merger->node_count; ++i) {
-			struct merger_heap_node *node = &merger->nodes[i];
-			if (merger_add_heap_node(merger, node) != 0)
+			struct merger_node *node = &merger->nodes[i];
+			if (node->tuple != NULL)
+				continue;
+			if (merge_source_next(node->source, merger->format,
+					      &node->tuple) != 0)
 				return -1;
 		}
+		merger_tree_build(merger);
 		merger->started = true;
 	}
 
 	/* Get a next tuple. */
-	struct merger_heap_node *node = merger_heap_top(&merger->heap);
-	if (node == NULL) {
+	struct merger_node *node = &merger->nodes[merger->tree[0]];
+	struct tuple *tuple = node->tuple;
+	if (tuple == NULL) {
 		*out = NULL;
 		return 0;
 	}
-	struct tuple *tuple = node->tuple;
-	assert(tuple != NULL);
 
 	/* Validate the tuple. */
 	if (format != NULL && tuple_validate(format, tuple) != 0)
@@ -335,15 +352,15 @@ merger_next(struct merge_source *base, struct tuple_format *format,
 	 * *out as refcounted tuple, so we don't unreference it
 	 * here.
 	 */
-	struct merge_source *source = node->source;
-	if (merge_source_next(source, merger->format, &node->tuple) != 0)
+	node->tuple = NULL;
+	if (merge_source_next(node->source, merger->format,
+			      &node->tuple) != 0) {
+		node->tuple = tuple;
 		return -1;
+	}
 
-	/* Update a heap. */
-	if (node->tuple == NULL)
-		merger_heap_delete(&merger->heap, node);
-	else
-		merger_heap_update(&merger->heap, node);
+	/* Update the tree. */
+	merger_tree_replay(merger);
 
 	*out = tuple;
 	return 0;
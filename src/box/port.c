@@ -190,6 +190,14 @@ port_c_add_tuple(struct port *base, struct tuple *tuple)
 /**
  * Appends raw MsgPack to the port, it is copied.
  * Returns the new entry containing MsgPack, never fails.
+ *
+ * Note that the data can't be written right to the output buffer of
+ * the connection even if the port is going to be dumped to IPROTO:
+ * the function may yield between two box_return_mp() calls and other
+ * requests of the same connection would append their replies to the
+ * same buffer meanwhile. Besides, the reply header must precede the
+ * body. Small data don't take a heap allocation, see
+ * port_c_data_xalloc().
  */
 static struct port_c_entry *
 port_c_add_mp_impl(struct port *base, const char *mp, const char *mp_end)
@@ -54,6 +54,8 @@ enum election_mode box_election_mode = ELECTION_MODE_INVALID;
 enum election_fencing_mode box_election_fencing_mode =
 	ELECTION_FENCING_MODE_SOFT;
 
+struct box_raft_failover_stat box_raft_failover_stat;
+
 /**
  * A trigger executed each time the Raft state machine updates any
  * of its visible attributes.
@@ -190,12 +192,35 @@ box_raft_schedule_async(struct raft *raft)
 	box_raft_has_work = true;
 }
 
+/** Remember when the node starts and wins the elections. */
+static void
+box_raft_update_failover_stat(struct raft *raft)
+{
+	struct box_raft_failover_stat *stat = &box_raft_failover_stat;
+	if (raft->state == RAFT_STATE_CANDIDATE &&
+	    stat->candidate_term != raft->volatile_term) {
+		stat->candidate_term = raft->volatile_term;
+		stat->candidate_start = fiber_clock();
+	} else if (raft->state == RAFT_STATE_LEADER &&
+		   stat->term != raft->term) {
+		double now = fiber_clock();
+		stat->term = raft->term;
+		stat->leader_start = now;
+		stat->election_time = stat->candidate_term == raft->term ?
+				      now - stat->candidate_start : 0;
+		stat->limbo_wait_time = 0;
+		stat->promote_time = 0;
+		stat->total_time = 0;
+	}
+}
+
 static int
 box_raft_on_update_f(struct trigger *trigger, void *event)
 {
 	(void)trigger;
 	struct raft *raft = (struct raft *)event;
 	assert(raft == box_raft());
+	box_raft_update_failover_stat(raft);
 	/*
 	 * When the instance becomes a follower, it's good to make it read-only
 	 * ASAP. This way we make sure followers don't write anything.
@@ -72,6 +72,38 @@ enum election_fencing_mode {
 
 struct raft_request;
 
+/**
+ * Timings of the last failover, i.e. of the last time this instance won the
+ * elections and took over the synchronous queue. All the durations are in
+ * seconds.
+ */
+struct box_raft_failover_stat {
+	/** Term in which the instance became the leader. 0 if it never did. */
+	uint64_t term;
+	/** Time spent as a candidate in this term before winning. */
+	double election_time;
+	/**
+	 * Time spent after winning the elections in waiting for the
+	 * synchronous transactions of the previous leader to gather a quorum.
+	 */
+	double limbo_wait_time;
+	/** Time spent on writing PROMOTE. */
+	double promote_time;
+	/**
+	 * Time since winning the elections till the instance became the
+	 * synchronous queue owner. 0 while the promotion is in progress.
+	 */
+	double total_time;
+	/** Term in which the instance became a candidate last time. */
+	uint64_t candidate_term;
+	/** Time when the instance became a candidate last time. */
+	double candidate_start;
+	/** Time when the instance became the leader in the term. */
+	double leader_start;
+};
+
+extern struct box_raft_failover_stat box_raft_failover_stat;
+
 /**
  * box_election_mode - current mode of operation for raft. Some modes correspond
  * to RAFT operation modes directly, like CANDIDATE, VOTER and OFF.
@@ -161,6 +161,7 @@ recovery_close_log(struct recovery *r)
 		say_warn("file `%s` wasn't correctly closed",
 			 r->cursor.name);
 	}
+	r->read_size += r->cursor.read_offset;
 	xlog_cursor_close(&r->cursor, false);
 	trigger_run_xc(&r->on_close_log, NULL);
 }
@@ -236,6 +237,57 @@ recovery_delete(struct recovery *r)
 	free(r);
 }
 
+/**
+ * Feed a row read from a WAL to the stream unless it precedes the
+ * recovery vclock. @a is_sending_tx is set if the row doesn't end
+ * the transaction being recovered.
+ */
+static void
+recover_row(struct recovery *r, struct xstream *stream,
+	    struct xrow_header *row, bool *is_sending_tx)
+{
+	/*
+	 * All rows in xlog files have an assigned replica
+	 * id. The only exception are local rows, which
+	 * are signed with a zero replica id.
+	 */
+	assert(row->replica_id != 0 || row->group_id == GROUP_LOCAL);
+	int64_t current_lsn = vclock_get(&r->vclock, row->replica_id);
+	if (row->lsn <= current_lsn) {
+		/*
+		 * Skip the already applied row, if it is not needed to
+		 * preserve transaction boundaries (is not the last row
+		 * of a currently recovered transaction). Otherwise,
+		 * replace it with a NOP, so that the transaction end
+		 * flag reaches the receiver, but the data isn't
+		 * recovered twice.
+		 */
+		if (!*is_sending_tx || !row->is_commit)
+			return; /* already applied, skip */
+		row->type = IPROTO_NOP;
+		row->bodycnt = 0;
+		row->body[0].iov_base = NULL;
+		row->body[0].iov_len = 0;
+	} else {
+		/*
+		 * We can promote the vclock either before or
+		 * after xstream_write(): it only makes any impact
+		 * in case of forced recovery, when we skip the
+		 * failed row anyway.
+		 */
+		vclock_follow_xrow(&r->vclock, row);
+	}
+	*is_sending_tx = !row->is_commit;
+	if (xstream_write(stream, row) != 0) {
+		if (!r->wal_dir.force_recovery)
+			diag_raise();
+
+		say_error("skipping row {%u: %lld}",
+			  (unsigned)row->replica_id, (long long)row->lsn);
+		diag_log();
+	}
+}
+
 /**
  * Read all rows in a file starting from the last position.
  * Advance the position. If end of file is reached,
@@ -270,49 +322,39 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 		    r->vclock.signature >= stop_vclock->signature)
 			return;
 
-		/*
-		 * All rows in xlog files have an assigned replica
-		 * id. The only exception are local rows, which
-		 * are signed with a zero replica id.
-		 */
-		assert(row.replica_id != 0 || row.group_id == GROUP_LOCAL);
-		int64_t current_lsn = vclock_get(&r->vclock, row.replica_id);
-		if (row.lsn <= current_lsn) {
-			/*
-			 * Skip the already applied row, if it is not needed to
-			 * preserve transaction boundaries (is not the last row
-			 * of a currently recovered transaction). Otherwise,
-			 * replace it with a NOP, so that the transaction end
-			 * flag reaches the receiver, but the data isn't
-			 * recovered twice.
-			 */
-			if (!is_sending_tx || !row.is_commit)
-				continue; /* already applied, skip */
-			row.type = IPROTO_NOP;
-			row.bodycnt = 0;
-			row.body[0].iov_base = NULL;
-			row.body[0].iov_len = 0;
-		} else {
-			/*
-			 * We can promote the vclock either before or
-			 * after xstream_write(): it only makes any impact
-			 * in case of forced recovery, when we skip the
-			 * failed row anyway.
-			 */
-			vclock_follow_xrow(&r->vclock, &row);
-		}
-		is_sending_tx = !row.is_commit;
-		if (xstream_write(stream, &row) != 0) {
-			if (!r->wal_dir.force_recovery)
-				diag_raise();
-
-			say_error("skipping row {%u: %lld}",
-				  (unsigned)row.replica_id, (long long)row.lsn);
-			diag_log();
-		}
+		recover_row(r, stream, &row, &is_sending_tx);
+	}
+}
+
+void
+recover_rows(struct recovery *r, struct xstream *stream,
+	     const char *data, const char *data_end)
+{
+	struct xrow_header row;
+	bool is_sending_tx = false;
+	while (data < data_end) {
+		xrow_header_decode_xc(&row, &data, data_end, false);
+		if (++stream->row_count % WAL_ROWS_PER_YIELD == 0)
+			xstream_yield(stream);
+		recover_row(r, stream, &row, &is_sending_tx);
 	}
 }
 
+void
+recovery_release_log(struct recovery *r)
+{
+	if (xlog_cursor_is_open(&r->cursor)) {
+		r->read_size += r->cursor.read_offset;
+		xlog_cursor_close(&r->cursor, false);
+	}
+	/*
+	 * Make the next recover_remaining_wals() call look up the WAL
+	 * to read by the recovery vclock, as if it were the first one.
+	 */
+	r->cursor.state = XLOG_CURSOR_NEW;
+	trigger_run_xc(&r->on_close_log, NULL);
+}
+
 /**
  * Find out if there are new .xlog files since the current
  * LSN, and read them all up.
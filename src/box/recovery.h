@@ -56,6 +56,8 @@ struct recovery {
 	struct fiber *watcher;
 	/** List of triggers invoked when the current WAL is closed. */
 	struct rlist on_close_log;
+	/** Number of bytes read from closed WAL files. */
+	int64_t read_size;
 };
 
 struct recovery *
@@ -104,4 +106,23 @@ void
 recover_remaining_wals(struct recovery *r, struct xstream *stream,
 		       const struct vclock *stop_vclock, bool scan_dir);
 
+/**
+ * Feed rows encoded the same way as in an xlog file to the stream,
+ * skipping the rows that precede the recovery vclock the same way
+ * recover_remaining_wals() does. The data must end on a transaction
+ * boundary.
+ */
+void
+recover_rows(struct recovery *r, struct xstream *stream,
+	     const char *data, const char *data_end);
+
+/**
+ * Close the current WAL, even if it isn't read up to the end, and run
+ * the on_close_log triggers. Used when the rows are fed to the stream
+ * with recover_rows() instead. The next recover_remaining_wals() call
+ * looks up the WAL to read by the recovery vclock.
+ */
+void
+recovery_release_log(struct recovery *r);
+
 #endif /* TARANTOOL_RECOVERY_H_INCLUDED */
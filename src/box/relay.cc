@@ -37,6 +37,7 @@
 #include "cbus.h"
 #include "errinj.h"
 #include "fiber.h"
+#include "latency.h"
 #include "memory.h"
 #include "say.h"
 
@@ -57,8 +58,10 @@
 #include "wal.h"
 #include "txn_limbo.h"
 #include "raft.h"
+#include "trivia/usdt.h"
 
 #include <stdlib.h>
+#include <zstd.h>
 
 /**
  * Cbus message to send status updates from relay to tx thread.
@@ -74,8 +77,12 @@ struct relay_status_msg {
 	struct vclock vclock;
 	/** Last replicated transaction timestamp. */
 	double txn_lag;
+	/** Latency percentiles computed in the relay thread. */
+	struct relay_latency latency;
 	/** Last vclock sync received in replica's response. */
 	uint64_t vclock_sync;
+	/** Send time of the heartbeat with vclock_sync, 0 if unknown. */
+	double vclock_sync_time;
 };
 
 /**
@@ -107,6 +114,29 @@ struct relay_raft_msg {
 };
 
 
+enum {
+	/**
+	 * Max number of iovecs written to the replica socket with
+	 * a single writev() call when sending a transaction.
+	 */
+	RELAY_TX_IOVMAX = 256,
+	/**
+	 * Number of the last heartbeats whose send time is remembered. Acks
+	 * usually come back before a few more heartbeats are sent.
+	 */
+	RELAY_HEARTBEAT_HISTORY_SIZE = 8,
+	/**
+	 * Size of the buffer accumulating rows sent on initial join
+	 * so that they are written to the socket in big chunks.
+	 */
+	RELAY_JOIN_BUF_SIZE = 128 * 1024,
+	/**
+	 * Row bodies smaller than this are sent uncompressed even if
+	 * the replica asked for compression, see relay_compress_row().
+	 */
+	RELAY_COMPRESSION_MIN_SIZE = 64,
+};
+
 /** State of a replication relay. */
 struct relay {
 	/** Replica connection */
@@ -129,6 +159,31 @@ struct relay {
 	int64_t read_tsn;
 	/** A list of rows making up the currently read transaction. */
 	struct rlist current_tx;
+	/**
+	 * Position in the WAL ring, see wal_ring_read(). Zero if
+	 * the relay reads rows from WAL files.
+	 */
+	int64_t wal_ring_seqno;
+	/** Buffer for rows copied from the WAL ring. */
+	struct ibuf wal_ring_buf;
+	/** Buffer for rows sent on initial join, see relay_send_buffered(). */
+	char *join_buf;
+	/** Size of the data accumulated in join_buf. */
+	size_t join_buf_used;
+	/**
+	 * zstd level requested by the replica on subscribe, 0 if the
+	 * replication stream isn't compressed.
+	 */
+	int compression_level;
+	/**
+	 * Streaming context compressing the bodies of the rows sent to
+	 * the replica. NULL if the replication stream isn't compressed.
+	 */
+	ZSTD_CCtx *zstd_ctx;
+	/** Total size of the row bodies passed to zstd_ctx. */
+	uint64_t compression_in_bytes;
+	/** Total size of the row bodies produced by zstd_ctx. */
+	uint64_t compression_out_bytes;
 	/** Vclock to stop playing xlogs */
 	struct vclock stop_vclock;
 	/** Remote replica */
@@ -182,6 +237,15 @@ struct relay {
 	double last_row_time;
 	/** Time when last heartbeat was sent to the peer. */
 	double last_heartbeat_time;
+	/**
+	 * Send times of the last heartbeats by their vclock sync modulo the
+	 * history size. Allow to tell when the acknowledged heartbeat was
+	 * sent, which is needed for the leader leases.
+	 */
+	struct {
+		uint64_t vclock_sync;
+		double time;
+	} heartbeat_history[RELAY_HEARTBEAT_HISTORY_SIZE];
 	/** Time of last communication with the tx thread. */
 	double tx_seen_time;
 	/**
@@ -192,6 +256,16 @@ struct relay {
 	 * received.
 	 */
 	double txn_lag;
+	/**
+	 * Time between a WAL write of a transaction and sending it
+	 * to the replica. Accessed from the relay thread only.
+	 */
+	struct latency send_latency;
+	/**
+	 * Time between a WAL write of a transaction and receiving
+	 * an ACK for it. Accessed from the relay thread only.
+	 */
+	struct latency ack_latency;
 	/** Relay sync state. */
 	enum relay_state state;
 	/** Whether relay should speed up the next heartbeat dispatch. */
@@ -206,6 +280,8 @@ struct relay {
 		 * from TX thread only.
 		 */
 		double txn_lag;
+		/** Latency percentiles to be accessed from TX thread only. */
+		struct relay_latency latency;
 		/** Known vclock sync received in response from replica. */
 		uint64_t vclock_sync;
 		/**
@@ -263,6 +339,21 @@ relay_txn_lag(const struct relay *relay)
 	return relay->tx.txn_lag;
 }
 
+int
+relay_compression(const struct relay *relay, uint64_t *in_bytes,
+		  uint64_t *out_bytes)
+{
+	*in_bytes = relay->compression_in_bytes;
+	*out_bytes = relay->compression_out_bytes;
+	return relay->compression_level;
+}
+
+const struct relay_latency *
+relay_get_latency(const struct relay *relay)
+{
+	return &relay->tx.latency;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
@@ -303,6 +394,19 @@ relay_new(struct replica *replica)
 	assert(relay != NULL);
 
 	memset(relay, 0, sizeof(struct relay));
+	if (latency_create(&relay->send_latency) != 0) {
+		diag_set(OutOfMemory, sizeof(struct latency), "malloc",
+			 "relay->send_latency");
+		free(relay);
+		return NULL;
+	}
+	if (latency_create(&relay->ack_latency) != 0) {
+		diag_set(OutOfMemory, sizeof(struct latency), "malloc",
+			 "relay->ack_latency");
+		latency_destroy(&relay->send_latency);
+		free(relay);
+		return NULL;
+	}
 	relay->replica = replica;
 	relay->last_row_time = ev_monotonic_now(loop());
 	fiber_cond_create(&relay->reader_cond);
@@ -352,8 +456,14 @@ relay_start(struct relay *relay, struct iostream *io, uint64_t sync,
 	relay->last_row_time = ev_monotonic_now(loop());
 	relay->tx_seen_time = relay->last_row_time;
 	relay->last_heartbeat_time = relay->last_row_time;
+	memset(relay->heartbeat_history, 0, sizeof(relay->heartbeat_history));
 	/* Never send rows for REPLICA_ID_NIL to anyone */
 	relay->id_filter = 1 << REPLICA_ID_NIL;
+	relay->compression_level = 0;
+	relay->compression_in_bytes = 0;
+	relay->compression_out_bytes = 0;
+	latency_reset(&relay->send_latency);
+	latency_reset(&relay->ack_latency);
 	memset(&relay->status_msg, 0, sizeof(relay->status_msg));
 }
 
@@ -376,6 +486,9 @@ relay_exit(struct relay *relay)
 	recovery_delete(relay->r);
 	relay->r = NULL;
 	lsregion_destroy(&relay->lsregion);
+	ibuf_destroy(&relay->wal_ring_buf);
+	ZSTD_freeCCtx(relay->zstd_ctx);
+	relay->zstd_ctx = NULL;
 }
 
 static void
@@ -398,6 +511,7 @@ relay_stop(struct relay *relay)
 	 */
 	relay->txn_lag = 0;
 	relay->tx.txn_lag = 0;
+	memset(&relay->tx.latency, 0, sizeof(relay->tx.latency));
 	relay->tx.vclock_sync = 0;
 }
 
@@ -408,6 +522,8 @@ relay_delete(struct relay *relay)
 		relay_stop(relay);
 	fiber_cond_destroy(&relay->reader_cond);
 	diag_destroy(&relay->diag);
+	latency_destroy(&relay->send_latency);
+	latency_destroy(&relay->ack_latency);
 	TRASH(relay);
 	free(relay);
 }
@@ -436,6 +552,8 @@ relay_cord_init(struct relay *relay)
 	relay->lsr_id = 0;
 	relay->read_tsn = 0;
 	rlist_create(&relay->current_tx);
+	relay->wal_ring_seqno = 0;
+	ibuf_create(&relay->wal_ring_buf, &cord()->slabc, 16 * 1024);
 }
 
 void
@@ -448,7 +566,9 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 
 	relay_start(relay, io, sync, relay_send_initial_join_row, relay_yield,
 		    UINT64_MAX);
+	relay->join_buf = (char *)xmalloc(RELAY_JOIN_BUF_SIZE);
 	auto relay_guard = make_scoped_guard([=] {
+		free(relay->join_buf);
 		relay_stop(relay);
 		relay_delete(relay);
 	});
@@ -512,6 +632,7 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 
 	/* Send read view to the replica. */
 	engine_join_xc(&ctx, &relay->stream);
+	relay_join_buf_flush(relay);
 }
 
 int
@@ -600,6 +721,7 @@ tx_status_update(struct cmsg *msg)
 	struct relay *relay = status->relay;
 	vclock_copy(&relay->tx.vclock, &status->vclock);
 	relay->tx.txn_lag = status->txn_lag;
+	relay->tx.latency = status->latency;
 	relay->tx.vclock_sync = status->vclock_sync;
 
 	struct replication_ack ack;
@@ -616,6 +738,8 @@ tx_status_update(struct cmsg *msg)
 	 * has no result yet, need a PROMOTE.
 	 */
 	raft_process_term(box_raft(), status->term, ack.source);
+	raft_process_lease_ack(box_raft(), ack.source, status->term,
+			       status->vclock_sync_time);
 	/*
 	 * Let pending synchronous transactions know, which of
 	 * them were successfully sent to the replica. Acks are
@@ -712,6 +836,42 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Send new rows from the WAL ring instead of reading them from WAL
+ * files. Returns false if the rows aren't in the ring anymore, e.g.
+ * if the relay has fallen behind, in which case they must be read
+ * from WAL files.
+ */
+static bool
+relay_send_wal_ring(struct relay *relay, bool release_log)
+{
+	/* Switch to the ring only on a transaction boundary. */
+	if (relay->wal_ring_seqno == 0 && relay->read_tsn != 0)
+		return false;
+	struct recovery *r = relay->r;
+	struct ibuf *buf = &relay->wal_ring_buf;
+	do {
+		ibuf_reset(buf);
+		if (wal_ring_read(&relay->wal_ring_seqno, &r->vclock,
+				  buf) != 0) {
+			relay->wal_ring_seqno = 0;
+			return false;
+		}
+		if (release_log) {
+			/*
+			 * Release the WAL file left open by the file
+			 * reader on switching to the ring and after WAL
+			 * rotation so that the garbage collector can
+			 * remove the WAL files sent to the replica.
+			 */
+			recovery_release_log(r);
+			release_log = false;
+		}
+		recover_rows(r, &relay->stream, buf->rpos, buf->wpos);
+	} while (ibuf_used(buf) > 0);
+	return true;
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -729,8 +889,17 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
+		bool was_reading_ring = relay->wal_ring_seqno != 0;
+		if (relay_send_wal_ring(relay, !was_reading_ring ||
+					(events & WAL_EVENT_ROTATE) != 0))
+			return;
+		/*
+		 * The WAL directory may have changed while the relay was
+		 * reading the ring so rescan it on falling back on files.
+		 */
 		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+				       (events & WAL_EVENT_ROTATE) != 0 ||
+				       was_reading_ring);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -759,8 +928,10 @@ relay_process_ack(struct relay *relay, double tm)
 	 * can't go down.
 	 */
 	assert(vclock_compare(prev_vclock, next_vclock) <= 0);
-	if (vclock_compare_ignore0(prev_vclock, next_vclock) < 0)
+	if (vclock_compare_ignore0(prev_vclock, next_vclock) < 0) {
 		relay->txn_lag = ev_now(loop()) - tm;
+		latency_collect(&relay->ack_latency, relay->txn_lag);
+	}
 }
 
 /*
@@ -816,6 +987,10 @@ relay_send_heartbeat(struct relay *relay)
 			row.tm = ev_now(loop());
 		row.replica_id = instance_id;
 		relay->last_heartbeat_time = ev_monotonic_now(loop());
+		uint64_t sync = relay->last_sent_ack.vclock_sync;
+		int i = sync % RELAY_HEARTBEAT_HISTORY_SIZE;
+		relay->heartbeat_history[i].vclock_sync = sync;
+		relay->heartbeat_history[i].time = relay->last_heartbeat_time;
 		relay_send(relay, &row);
 		relay->need_new_vclock_sync = false;
 	} catch (Exception *e) {
@@ -965,9 +1140,18 @@ relay_check_status_needs_update(struct relay *relay)
 	cmsg_init(&status_msg->msg, route);
 	vclock_copy(&status_msg->vclock, send_vclock);
 	status_msg->txn_lag = relay->txn_lag;
+	status_msg->latency.send_p50 = latency_get(&relay->send_latency, 50);
+	status_msg->latency.send_p99 = latency_get(&relay->send_latency, 99);
+	status_msg->latency.ack_p50 = latency_get(&relay->ack_latency, 50);
+	status_msg->latency.ack_p99 = latency_get(&relay->ack_latency, 99);
 	status_msg->relay = relay;
 	status_msg->term = last_recv_ack->term;
 	status_msg->vclock_sync = last_recv_ack->vclock_sync;
+	int i = status_msg->vclock_sync % RELAY_HEARTBEAT_HISTORY_SIZE;
+	if (relay->heartbeat_history[i].vclock_sync == status_msg->vclock_sync)
+		status_msg->vclock_sync_time = relay->heartbeat_history[i].time;
+	else
+		status_msg->vclock_sync_time = 0;
 	cpipe_push(&relay->tx_pipe, &status_msg->msg);
 }
 
@@ -996,6 +1180,18 @@ relay_subscribe_f(va_list ap)
 	struct relay *relay = va_arg(ap, struct relay *);
 
 	relay_cord_init(relay);
+	if (relay->compression_level > 0) {
+		relay->zstd_ctx = ZSTD_createCCtx();
+		if (relay->zstd_ctx == NULL) {
+			say_warn("failed to create zstd context, "
+				 "replication stream won't be compressed");
+			relay->compression_level = 0;
+		} else {
+			ZSTD_CCtx_setParameter(relay->zstd_ctx,
+					       ZSTD_c_compressionLevel,
+					       relay->compression_level);
+		}
+	}
 
 	cbus_endpoint_create(&relay->tx_endpoint,
 			     tt_sprintf("relay_tx_%p", relay),
@@ -1008,15 +1204,10 @@ relay_subscribe_f(va_list ap)
 			     tt_sprintf("relay_wal_%p", relay),
 			     fiber_schedule_cb, fiber());
 
-	/*
-	 * Setup garbage collection trigger.
-	 * Not needed for anonymous replicas, since they
-	 * aren't registered with gc at all.
-	 */
+	/* Setup garbage collection trigger. */
 	struct trigger on_close_log;
 	trigger_create(&on_close_log, relay_on_close_log_f, relay, NULL);
-	if (!relay->replica->anon)
-		trigger_add(&relay->r->on_close_log, &on_close_log);
+	trigger_add(&relay->r->on_close_log, &on_close_log);
 
 	/* Setup WAL watcher for sending new rows to the replica. */
 	struct errinj *inj = errinj(ERRINJ_RELAY_WAL_START_DELAY, ERRINJ_BOOL);
@@ -1095,7 +1286,8 @@ relay_subscribe_f(va_list ap)
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		const struct vclock *start_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter, uint64_t sent_raft_term)
+		uint32_t replica_id_filter, uint64_t sent_raft_term,
+		uint32_t compression_level)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -1119,6 +1311,8 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	vclock_copy_ignore0(&relay->tx.vclock, start_vclock);
 	relay->version_id = replica_version_id;
 	relay->id_filter |= replica_id_filter;
+	relay->compression_level = MIN(compression_level,
+				       (uint32_t)ZSTD_maxCLevel());
 
 	struct cord cord;
 	int rc = cord_costart(&cord, "subscribe", relay_subscribe_f, relay);
@@ -1128,6 +1322,80 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		diag_raise();
 }
 
+/**
+ * Compresses the body of a row encoded with xrow_to_iovec() if the
+ * replica asked for it on subscribe. The compressed body is encoded
+ * as MP_BIN and IPROTO_COMPRESSION is added to the row header. All
+ * bodies are fed to the same streaming context and flushed at the
+ * end of each row, so the replica must decompress them in the order
+ * they were sent. The result is allocated on the fiber region.
+ */
+static void
+relay_compress_row(struct relay *relay, struct iovec *iov, int *iovcnt)
+{
+	if (relay->zstd_ctx == NULL)
+		return;
+	size_t size = 0;
+	for (int i = 1; i < *iovcnt; i++)
+		size += iov[i].iov_len;
+	if (size < RELAY_COMPRESSION_MIN_SIZE)
+		return;
+	struct region *region = &fiber()->gc;
+	ZSTD_outBuffer out;
+	out.size = ZSTD_compressBound(size);
+	out.dst = xregion_alloc(region, out.size);
+	out.pos = 0;
+	for (int i = 1; i < *iovcnt; i++) {
+		ZSTD_inBuffer in = {iov[i].iov_base, iov[i].iov_len, 0};
+		ZSTD_EndDirective mode = i < *iovcnt - 1 ?
+					 ZSTD_e_continue : ZSTD_e_flush;
+		while (true) {
+			size_t rc = ZSTD_compressStream2(relay->zstd_ctx,
+							 &out, &in, mode);
+			if (ZSTD_isError(rc)) {
+				tnt_raise(ClientError, ER_COMPRESSION,
+					  ZSTD_getErrorName(rc));
+			}
+			if (mode == ZSTD_e_flush ? rc == 0 : in.pos == in.size)
+				break;
+			if (out.pos < out.size)
+				continue;
+			/* Out of space in the output buffer, grow it. */
+			void *dst = xregion_alloc(region, out.size * 2);
+			memcpy(dst, out.dst, out.pos);
+			out.dst = dst;
+			out.size *= 2;
+		}
+	}
+	/*
+	 * The header map is encoded in one byte by xrow_header_encode(),
+	 * so we can add a key to it without moving the other keys.
+	 */
+	const char *header = (const char *)iov[0].iov_base + 5;
+	uint32_t map_size = mp_decode_map(&header);
+	assert(map_size < 15);
+	char *buf = (char *)xregion_alloc(region, iov[0].iov_len +
+					  mp_sizeof_uint(IPROTO_COMPRESSION) +
+					  mp_sizeof_uint(IPROTO_COMPRESSION_ZSTD) +
+					  mp_sizeof_binl(out.pos));
+	memcpy(buf, iov[0].iov_base, iov[0].iov_len);
+	mp_encode_map(buf + 5, map_size + 1);
+	char *p = buf + iov[0].iov_len;
+	p = mp_encode_uint(p, IPROTO_COMPRESSION);
+	p = mp_encode_uint(p, IPROTO_COMPRESSION_ZSTD);
+	p = mp_encode_binl(p, out.pos);
+	/* Fix the packet length. */
+	buf[0] = 0xce;
+	store_u32(buf + 1, mp_bswap_u32(p - buf - 5 + out.pos));
+	iov[0].iov_base = buf;
+	iov[0].iov_len = p - buf;
+	iov[1].iov_base = out.dst;
+	iov[1].iov_len = out.pos;
+	*iovcnt = 2;
+	relay->compression_in_bytes += size;
+	relay->compression_out_bytes += out.pos;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet)
 {
@@ -1135,13 +1403,90 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 
 	packet->sync = relay->sync;
 	relay->last_row_time = ev_monotonic_now(loop());
-	coio_write_xrow(relay->io, packet);
+	USDT(relay_send, packet->replica_id, packet->lsn);
+	if (relay->zstd_ctx == NULL) {
+		coio_write_xrow(relay->io, packet);
+	} else {
+		RegionGuard region_guard(&fiber()->gc);
+		int iovcnt;
+		struct iovec iov[XROW_IOVMAX];
+		xrow_to_iovec(packet, iov, &iovcnt);
+		relay_compress_row(relay, iov, &iovcnt);
+		if (coio_writev(relay->io, iov, iovcnt, 0) < 0)
+			diag_raise();
+	}
 
 	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
 	if (inj != NULL && inj->dparam > 0)
 		fiber_sleep(inj->dparam);
 }
 
+/** Check if error injections require sending rows one by one. */
+static bool
+relay_send_is_delayed(void)
+{
+	struct errinj *inj = errinj(ERRINJ_RELAY_SEND_DELAY, ERRINJ_BOOL);
+	if (inj != NULL && inj->bparam)
+		return true;
+	inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
+	return inj != NULL && inj->dparam > 0;
+}
+
+/** Write the given iovecs to the replica. */
+static void
+relay_writev(struct relay *relay, struct iovec *iov, int iovcnt)
+{
+	relay->last_row_time = ev_monotonic_now(loop());
+	if (coio_writev(relay->io, iov, iovcnt, 0) < 0)
+		diag_raise();
+}
+
+/** Write the rows accumulated in the join buffer to the replica. */
+static void
+relay_join_buf_flush(struct relay *relay)
+{
+	if (relay->join_buf_used == 0)
+		return;
+	struct iovec iov;
+	iov.iov_base = relay->join_buf;
+	iov.iov_len = relay->join_buf_used;
+	relay->join_buf_used = 0;
+	relay_writev(relay, &iov, 1);
+}
+
+/**
+ * Append a row to the join buffer, flushing it if it's full. Rows
+ * that don't fit in the buffer are written directly.
+ */
+static void
+relay_send_buffered(struct relay *relay, struct xrow_header *packet)
+{
+	if (relay_send_is_delayed()) {
+		relay_join_buf_flush(relay);
+		relay_send(relay, packet);
+		return;
+	}
+	RegionGuard region_guard(&fiber()->gc);
+	packet->sync = relay->sync;
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt;
+	xrow_to_iovec(packet, iov, &iovcnt);
+	size_t len = 0;
+	for (int i = 0; i < iovcnt; i++)
+		len += iov[i].iov_len;
+	if (relay->join_buf_used + len > RELAY_JOIN_BUF_SIZE)
+		relay_join_buf_flush(relay);
+	if (len > RELAY_JOIN_BUF_SIZE) {
+		relay_writev(relay, iov, iovcnt);
+		return;
+	}
+	for (int i = 0; i < iovcnt; i++) {
+		memcpy(relay->join_buf + relay->join_buf_used,
+		       iov[i].iov_base, iov[i].iov_len);
+		relay->join_buf_used += iov[i].iov_len;
+	}
+}
+
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 {
@@ -1151,7 +1496,7 @@ relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 	 * vclock while sending a snapshot.
 	 */
 	if (row->group_id != GROUP_LOCAL)
-		relay_send(relay, row);
+		relay_send_buffered(relay, row);
 }
 
 /**
@@ -1307,14 +1652,23 @@ relay_save_row(struct relay *relay, struct xrow_header *packet)
 	rlist_add_tail_entry(&relay->current_tx, tx_row, in_tx);
 }
 
-/** Send a full transaction to the replica. */
+/**
+ * Send a full transaction to the replica. The rows are written
+ * with as few writev() calls as possible rather than one by one.
+ */
 static void
 relay_send_tx(struct relay *relay)
 {
 	struct relay_row *item;
+	bool is_delayed = relay_send_is_delayed();
+	RegionGuard region_guard(&fiber()->gc);
+	struct iovec iov[RELAY_TX_IOVMAX];
+	int iovcnt = 0;
+	double tm = 0;
 
 	rlist_foreach_entry(item, &relay->current_tx, in_tx) {
 		struct xrow_header *packet = &item->row;
+		tm = packet->tm;
 
 		struct errinj *inj = errinj(ERRINJ_RELAY_BREAK_LSN,
 					    ERRINJ_INT);
@@ -1324,8 +1678,25 @@ relay_send_tx(struct relay *relay)
 			say_warn("injected broken lsn: %lld",
 				 (long long) packet->lsn);
 		}
-		relay_send(relay, packet);
+		if (is_delayed) {
+			relay_send(relay, packet);
+			continue;
+		}
+		if (iovcnt + XROW_IOVMAX > RELAY_TX_IOVMAX) {
+			relay_writev(relay, iov, iovcnt);
+			iovcnt = 0;
+		}
+		packet->sync = relay->sync;
+		int cnt;
+		xrow_to_iovec(packet, iov + iovcnt, &cnt);
+		relay_compress_row(relay, iov + iovcnt, &cnt);
+		iovcnt += cnt;
 	}
+	if (iovcnt > 0)
+		relay_writev(relay, iov, iovcnt);
+	/* Local rows and rows of old versions may have no timestamp. */
+	if (tm > 0)
+		latency_collect(&relay->send_latency, ev_now(loop()) - tm);
 
 	rlist_create(&relay->current_tx);
 	lsregion_gc(&relay->lsregion, relay->lsr_id);
@@ -43,6 +43,19 @@ struct replica;
 struct tt_uuid;
 struct vclock;
 
+/**
+ * Percentiles of the downstream replication latency, in seconds,
+ * observed since the relay was started.
+ */
+struct relay_latency {
+	/** Time between a WAL write and sending the transaction. */
+	double send_p50;
+	double send_p99;
+	/** Time between a WAL write and receiving an ACK for it. */
+	double ack_p50;
+	double ack_p99;
+};
+
 enum relay_state {
 	/**
 	 * Applier has not connected to the master or not expected.
@@ -96,6 +109,20 @@ relay_last_row_time(const struct relay *relay);
 double
 relay_txn_lag(const struct relay *relay);
 
+/**
+ * Returns the zstd level the rows sent to the replica are compressed
+ * with or 0 if the replication stream isn't compressed. The total size
+ * of the row bodies before and after compression is returned in
+ * @a in_bytes and @a out_bytes.
+ */
+int
+relay_compression(const struct relay *relay, uint64_t *in_bytes,
+		  uint64_t *out_bytes);
+
+/** Returns the relay's latency percentiles. */
+const struct relay_latency *
+relay_get_latency(const struct relay *relay);
+
 /**
  * Makes the relay issue a new vclock sync request and returns the sync to wait
  * for.
@@ -146,6 +173,7 @@ relay_final_join(struct replica *replica, struct iostream *io, uint64_t sync,
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		const struct vclock *start_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter, uint64_t sent_raft_term);
+		uint32_t replica_id_filter, uint64_t sent_raft_term,
+		uint32_t compression_level);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -58,9 +58,12 @@ int replication_connect_quorum = REPLICATION_CONNECT_QUORUM_ALL;
 double replication_sync_lag = 10.0; /* seconds */
 int replication_synchro_quorum = 1;
 double replication_synchro_timeout = 5.0; /* seconds */
+double replication_synchro_confirm_delay = 0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 int replication_threads = 1;
+int replication_apply_workers = 1;
+int replication_compression = 0;
 
 bool cfg_replication_anon = true;
 struct tt_uuid cfg_bootstrap_leader_uuid;
@@ -363,12 +366,17 @@ replica_set_id(struct replica *replica, uint32_t replica_id)
 	} else if (replica->anon) {
 		/*
 		 * Set replica gc on its transition from
-		 * anonymous to a normal one.
+		 * anonymous to a normal one. If the replica is
+		 * still subscribed, keep the WALs it hasn't
+		 * fetched yet.
 		 */
-		assert(replica->gc == NULL);
-		replica->gc = gc_consumer_register(&replicaset.vclock,
+		struct gc_consumer *gc = replica->gc;
+		replica->gc = gc_consumer_register(gc != NULL ? &gc->vclock :
+						   &replicaset.vclock,
 						   "replica %s",
 						   tt_uuid_str(&replica->uuid));
+		if (gc != NULL)
+			gc_consumer_unregister(gc);
 	}
 	replicaset.replica_by_id[replica_id] = replica;
 	gc_delay_ref();
@@ -1360,13 +1368,9 @@ replica_on_relay_stop(struct replica *replica)
 	 * WALs for it anymore. Unregister it with the garbage
 	 * collector then. See also replica_clear_id.
 	 */
-	if (replica->id == REPLICA_ID_NIL) {
-		if (!replica->anon) {
-			gc_consumer_unregister(replica->gc);
-			replica->gc = NULL;
-		} else {
-			assert(replica->gc == NULL);
-		}
+	if (replica->id == REPLICA_ID_NIL && replica->gc != NULL) {
+		gc_consumer_unregister(replica->gc);
+		replica->gc = NULL;
 	}
 
 	replica_update_relay_health(replica);
@@ -196,6 +196,12 @@ extern int replication_synchro_quorum;
  */
 extern double replication_synchro_timeout;
 
+/**
+ * Time in seconds the master waits for more ACKs before writing
+ * a CONFIRM so that a single CONFIRM covers more transactions.
+ */
+extern double replication_synchro_confirm_delay;
+
 /**
  * Max time to wait for appliers to synchronize before entering
  * the orphan mode.
@@ -211,6 +217,18 @@ extern bool replication_skip_conflict;
 /** How many threads to use for decoding incoming replication stream. */
 extern int replication_threads;
 
+/**
+ * Max number of fibers applying independent transactions received
+ * from the same master concurrently.
+ */
+extern int replication_apply_workers;
+
+/**
+ * zstd level the masters are asked to compress the replication stream
+ * with on subscribe. Zero disables compression.
+ */
+extern int replication_compression;
+
 /**
  * A list of triggers fired once quorum of "healthy" connections is acquired.
  */
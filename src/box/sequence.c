@@ -257,6 +257,46 @@ sequence_next(struct sequence *seq, int64_t *result)
 	goto done;
 }
 
+bool
+sequence_is_preallocated(const struct sequence *seq, int64_t value)
+{
+	if (!seq->has_prealloc)
+		return false;
+	/*
+	 * Check the first value as well so that a cyclic sequence
+	 * that wrapped around writes the new value.
+	 */
+	if (seq->def->step > 0)
+		return value > seq->prealloc_first &&
+		       value <= seq->prealloc_last;
+	else
+		return value < seq->prealloc_first &&
+		       value >= seq->prealloc_last;
+}
+
+int64_t
+sequence_prealloc_last(const struct sequence *seq, int64_t value)
+{
+	struct sequence_def *def = seq->def;
+	if (def->cache <= 1)
+		return value;
+	/* Use unsigned arithmetic to avoid overflows. */
+	uint64_t span = def->cache - 1;
+	if (def->step > 0) {
+		uint64_t step = def->step;
+		uint64_t room = (uint64_t)def->max - (uint64_t)value;
+		if (span > room / step)
+			return def->max;
+		return (int64_t)((uint64_t)value + span * step);
+	} else {
+		uint64_t step = -(uint64_t)def->step;
+		uint64_t room = (uint64_t)value - (uint64_t)def->min;
+		if (span > room / step)
+			return def->min;
+		return (int64_t)((uint64_t)value - span * step);
+	}
+}
+
 int
 access_check_sequence(struct sequence *seq)
 {
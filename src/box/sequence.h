@@ -64,7 +64,11 @@ struct sequence_def {
 	int64_t max;
 	/** Initial sequence value. */
 	int64_t start;
-	/** Number of values to preallocate. Not implemented yet. */
+	/**
+	 * Number of values to preallocate. If greater than 1,
+	 * box_sequence_next() writes to _sequence_data only once
+	 * per this many values, see sequence_prealloc().
+	 */
 	int64_t cache;
 	/**
 	 * If this flag is set, the sequence will wrap
@@ -82,6 +86,12 @@ struct sequence {
 	struct sequence_def *def;
 	/** Set if the sequence is automatically generated. */
 	bool is_generated;
+	/** Set if prealloc_first and prealloc_last are valid. */
+	bool has_prealloc;
+	/** Value the preallocated block was written for. */
+	int64_t prealloc_first;
+	/** Last preallocated value, written to _sequence_data. */
+	int64_t prealloc_last;
 	/** Cached runtime access information. */
 	struct access access[BOX_USER_MAX];
 };
@@ -152,6 +162,46 @@ sequence_update(struct sequence *seq, int64_t value);
 int
 sequence_next(struct sequence *seq, int64_t *result);
 
+/**
+ * Check if a value returned by sequence_next() lies within
+ * the block preallocated by sequence_prealloc() so that it
+ * doesn't need to be written to _sequence_data.
+ */
+bool
+sequence_is_preallocated(const struct sequence *seq, int64_t value);
+
+/**
+ * Return the last value of a block of def->cache values starting
+ * at the given value returned by sequence_next(). The last value
+ * is written to _sequence_data instead of the given one so that
+ * on recovery the sequence resumes after it, skipping the values
+ * of the block that weren't given out.
+ */
+int64_t
+sequence_prealloc_last(const struct sequence *seq, int64_t value);
+
+/**
+ * Remember the block of values written to _sequence_data; see
+ * sequence_prealloc_last().
+ */
+static inline void
+sequence_prealloc(struct sequence *seq, int64_t first, int64_t last)
+{
+	seq->has_prealloc = true;
+	seq->prealloc_first = first;
+	seq->prealloc_last = last;
+}
+
+/**
+ * Drop the preallocated block. Called whenever _sequence_data
+ * is modified.
+ */
+static inline void
+sequence_prealloc_reset(struct sequence *seq)
+{
+	seq->has_prealloc = false;
+}
+
 /**
  * Check whether or not the current user can be granted
  * access to the sequence.
@@ -1301,6 +1301,49 @@ after_old_tuple_lookup:;
 	return rc;
 }
 
+void
+space_stat_collect_select(uint32_t space_id, uint32_t count)
+{
+	struct space *space = space_by_id(space_id);
+	if (space == NULL)
+		return;
+	space->stat.select_count++;
+	space->stat.tuples_read += count;
+}
+
+/**
+ * Account a successfully executed DML request. @a result is the new tuple
+ * for INSERT, REPLACE and UPDATE.
+ */
+static void
+space_stat_collect_dml(struct space *space, struct request *request,
+		       struct tuple *result)
+{
+	struct space_stat *stat = &space->stat;
+	switch (request->type) {
+	case IPROTO_INSERT:
+		stat->insert_count++;
+		break;
+	case IPROTO_REPLACE:
+		stat->replace_count++;
+		break;
+	case IPROTO_UPDATE:
+		stat->update_count++;
+		break;
+	case IPROTO_DELETE:
+		stat->delete_count++;
+		return;
+	case IPROTO_UPSERT:
+		stat->upsert_count++;
+		stat->bytes_written += request->tuple_end - request->tuple;
+		return;
+	default:
+		return;
+	}
+	if (result != NULL)
+		stat->bytes_written += tuple_bsize(result);
+}
+
 int
 space_execute_dml(struct space *space, struct txn *txn,
 		  struct request *request, struct tuple **result)
@@ -1395,6 +1438,7 @@ space_execute_dml(struct space *space, struct txn *txn,
 	default:
 		*result = NULL;
 	}
+	space_stat_collect_dml(space, request, *result);
 	return 0;
 }
 
@@ -30,6 +30,8 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <string.h>
+
 #include "user_def.h"
 #include "space_def.h"
 #include "small/rlist.h"
@@ -175,6 +177,32 @@ struct space_event {
 	struct event *by_name;
 };
 
+/**
+ * Statistics of requests executed on a space. Reported by space:stat()
+ * and box.stat.spaces(), reset by box.stat.reset().
+ */
+struct space_stat {
+	/** Number of SELECT requests, including index:get(). */
+	uint64_t select_count;
+	/** Number of INSERT requests. */
+	uint64_t insert_count;
+	/** Number of REPLACE requests. */
+	uint64_t replace_count;
+	/** Number of UPDATE requests. */
+	uint64_t update_count;
+	/** Number of UPSERT requests. */
+	uint64_t upsert_count;
+	/** Number of DELETE requests. */
+	uint64_t delete_count;
+	/** Number of tuples returned by SELECT requests. */
+	uint64_t tuples_read;
+	/**
+	 * Total size of new tuples written by INSERT, REPLACE and UPDATE
+	 * requests and of tuples passed to UPSERT requests, in bytes.
+	 */
+	uint64_t bytes_written;
+};
+
 struct space {
 	/** Virtual function table. */
 	const struct space_vtab *vtab;
@@ -225,6 +253,11 @@ struct space {
 	bool run_recovery_triggers;
 	/** This space has foreign key constraints in its format. */
 	bool has_foreign_keys;
+	/**
+	 * Schema version at which the space definition was changed
+	 * last time, i.e. the space was created or altered.
+	 */
+	uint64_t schema_version;
 	/**
 	 * Space format or NULL if space does not have format
 	 * (sysview engine, for example).
@@ -284,6 +317,8 @@ struct space {
 	 * this object in sync. For more information see #9120.
 	 */
 	int lua_ref;
+	/** Request statistics. */
+	struct space_stat stat;
 };
 
 /** Space alter statement. */
@@ -559,6 +594,21 @@ space_has_before_replace_triggers(struct space *space)
 int
 space_on_replace(struct space *space, struct txn *txn);
 
+/** Reset request statistics of a space. */
+static inline void
+space_reset_stat(struct space *space)
+{
+	memset(&space->stat, 0, sizeof(space->stat));
+}
+
+/**
+ * Account a SELECT request that returned @a count tuples from the space
+ * with the given id. The space is looked up by id, because it may have
+ * been altered or dropped while the request yielded.
+ */
+void
+space_stat_collect_select(uint32_t space_id, uint32_t count);
+
 /**
  * Execute a DML request on the given space.
  */
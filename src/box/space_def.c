@@ -45,6 +45,8 @@ const struct space_opts space_opts_default = {
 	/* .view = */ false,
 	/* .is_sync = */ false,
 	/* .defer_deletes = */ false,
+	/* .iproto_read_view = */ false,
+	/* .wal_coalesce = */ false,
 	/* .sql        = */ NULL,
 	/* .constraint_def = */ NULL,
 	/* .constraint_count = */ 0,
@@ -97,6 +99,9 @@ const struct opt_def space_opts_reg[] = {
 	OPT_DEF("view", OPT_BOOL, struct space_opts, is_view),
 	OPT_DEF("is_sync", OPT_BOOL, struct space_opts, is_sync),
 	OPT_DEF("defer_deletes", OPT_BOOL, struct space_opts, defer_deletes),
+	OPT_DEF("iproto_read_view", OPT_BOOL, struct space_opts,
+		iproto_read_view),
+	OPT_DEF("wal_coalesce", OPT_BOOL, struct space_opts, wal_coalesce),
 	OPT_DEF("sql", OPT_STRPTR, struct space_opts, sql),
 	OPT_DEF_CUSTOM("constraint", space_opts_parse_constraint),
 	OPT_DEF_CUSTOM("foreign_key", space_opts_parse_foreign_key),
@@ -112,6 +112,18 @@ struct space_opts {
 	 * which should speed up writes, but may also slow down reads.
 	 */
 	bool defer_deletes;
+	/**
+	 * Setting this flag for a memtx space allows IPROTO threads to
+	 * serve SELECT requests for it from a read view without going to
+	 * the tx thread, see box.cfg.iproto_read_view_interval.
+	 */
+	bool iproto_read_view;
+	/**
+	 * Setting this flag for a memtx space makes a transaction write
+	 * only one WAL row per primary key it modifies in the space: the
+	 * resulting tuple or its deletion.
+	 */
+	bool wal_coalesce;
 	/** SQL statement that produced this space. */
 	char *sql;
 	/** Array of constraints. Can be NULL if constraints_count == 0. */
@@ -58,6 +58,7 @@
 #include "mp_util.h"
 #include "tweaks.h"
 #include "coll_id_cache.h"
+#include "qsort_arg.h"
 
 static sql *db = NULL;
 
@@ -66,6 +67,13 @@ static const char nil_key[] = { 0x90 }; /* Empty MsgPack array. */
 static bool sql_seq_scan_default = false;
 TWEAK_BOOL(sql_seq_scan_default);
 
+/**
+ * If set, the planner estimates the number of tuples matching a key prefix
+ * from statistics sampled from the index instead of the default numbers.
+ */
+static bool sql_index_stat = false;
+TWEAK_BOOL(sql_index_stat);
+
 uint32_t
 sql_default_session_flags(void)
 {
@@ -148,6 +156,28 @@ cursor_seek(BtCursor *pCur, int *pRes);
 static int
 cursor_advance(BtCursor *pCur, int *pRes);
 
+static void
+cursor_set_tuple(BtCursor *pCur, struct tuple *tuple, int *pRes);
+
+static int
+cursor_skip_filtered(BtCursor *pCur, int *pRes);
+
+/*
+ * Check if a seek of the cursor can be done with a single index lookup
+ * instead of an iterator: the search is for equality on all parts of a
+ * unique index, so at most one tuple matches the key.
+ */
+static inline bool
+cursor_is_point_lookup(const BtCursor *pCur, uint32_t part_count)
+{
+	if (pCur->iter_type != ITER_EQ && pCur->iter_type != ITER_REQ)
+		return false;
+	const struct index_def *def = pCur->index->def;
+	return def->opts.is_unique && !def->key_def->is_nullable &&
+	       !def->key_def->is_multikey && !def->key_def->for_func_index &&
+	       part_count == def->key_def->part_count;
+}
+
 const void *tarantoolsqlPayloadFetch(BtCursor *pCur, u32 *pAmt)
 {
 	assert(pCur->curFlags & BTCF_TaCursor ||
@@ -168,7 +198,9 @@ int tarantoolsqlFirst(BtCursor *pCur, int *pRes)
 		return -1;
 	memcpy(pCur->key, nil_key, sizeof(nil_key));
 	pCur->iter_type = ITER_GE;
-	return cursor_seek(pCur, pRes);
+	if (cursor_seek(pCur, pRes) != 0)
+		return -1;
+	return cursor_skip_filtered(pCur, pRes);
 }
 
 /* Set cursor to the last tuple in given space. */
@@ -178,7 +210,9 @@ int tarantoolsqlLast(BtCursor *pCur, int *pRes)
 		return -1;
 	memcpy(pCur->key, nil_key, sizeof(nil_key));
 	pCur->iter_type = ITER_LE;
-	return cursor_seek(pCur, pRes);
+	if (cursor_seek(pCur, pRes) != 0)
+		return -1;
+	return cursor_skip_filtered(pCur, pRes);
 }
 
 /*
@@ -195,7 +229,9 @@ int tarantoolsqlNext(BtCursor *pCur, int *pRes)
 		return 0;
 	}
 	assert(iterator_direction(pCur->iter_type) > 0);
-	return cursor_advance(pCur, pRes);
+	if (cursor_advance(pCur, pRes) != 0)
+		return -1;
+	return cursor_skip_filtered(pCur, pRes);
 }
 
 /*
@@ -210,7 +246,9 @@ int tarantoolsqlPrevious(BtCursor *pCur, int *pRes)
 		return 0;
 	}
 	assert(iterator_direction(pCur->iter_type) < 0);
-	return cursor_advance(pCur, pRes);
+	if (cursor_advance(pCur, pRes) != 0)
+		return -1;
+	return cursor_skip_filtered(pCur, pRes);
 }
 
 int
@@ -315,6 +353,15 @@ sql_space_info_new_from_index_def(const struct index_def *def, bool has_rowid)
 	return info;
 }
 
+/*
+ * Note that ephemeral spaces share tuple formats: a format created for
+ * an ephemeral space is reusable (see tuple_format_reuse()), so spaces
+ * of the same shape created by different statements get the same
+ * format. The space and its tree are still created from scratch. We
+ * don't cache emptied spaces, because emptying a tree costs as much as
+ * destroying it, and ephemeral tuples can't be allocated on the region,
+ * because they may outlive a region truncation during the statement.
+ */
 struct space *
 sql_ephemeral_space_new(const struct sql_space_info *info)
 {
@@ -465,7 +512,6 @@ int tarantoolsqlReplace(struct space *space, const char *tuple,
 int tarantoolsqlEphemeralDelete(BtCursor *pCur)
 {
 	assert(pCur->curFlags & BTCF_TEphemCursor);
-	assert(pCur->iter != NULL);
 	assert(pCur->last_tuple != NULL);
 
 	char *key;
@@ -489,7 +535,6 @@ int
 tarantoolsqlDelete(struct BtCursor *pCur)
 {
 	assert(pCur->curFlags & BTCF_TaCursor);
-	assert(pCur->iter != NULL);
 	assert(pCur->last_tuple != NULL);
 
 	char *key;
@@ -700,7 +745,6 @@ tarantoolsqlIdxKeyCompare(struct BtCursor *cursor,
 			      struct UnpackedRecord *unpacked)
 {
 	assert(cursor->curFlags & (BTCF_TaCursor | BTCF_TEphemCursor));
-	assert(cursor->iter != NULL);
 	assert(cursor->last_tuple != NULL);
 
 	struct key_def *key_def;
@@ -882,6 +926,19 @@ cursor_seek(BtCursor *pCur, int *pRes)
 	struct txn_ro_savepoint svp;
 	if (space->def->id != 0 && txn_begin_ro_stmt(space, &txn, &svp) != 0)
 		return -1;
+	if (cursor_is_point_lookup(pCur, part_count)) {
+		struct tuple *tuple;
+		int rc = index_get(pCur->index, key, part_count, &tuple);
+		if (txn != NULL)
+			txn_end_ro_stmt(txn, &svp);
+		if (rc != 0) {
+			pCur->eState = CURSOR_INVALID;
+			return -1;
+		}
+		pCur->eState = CURSOR_VALID;
+		cursor_set_tuple(pCur, tuple, pRes);
+		return 0;
+	}
 	struct iterator *it =
 		index_create_iterator(pCur->index, pCur->iter_type, key,
 				      part_count);
@@ -910,11 +967,24 @@ cursor_seek(BtCursor *pCur, int *pRes)
 static int
 cursor_advance(BtCursor *pCur, int *pRes)
 {
-	assert(pCur->iter != NULL);
-
-	struct tuple *tuple;
-	if (iterator_next(pCur->iter, &tuple) != 0)
+	/*
+	 * A point lookup has no iterator: the only matching tuple
+	 * was returned by the seek.
+	 */
+	struct tuple *tuple = NULL;
+	if (pCur->iter != NULL && iterator_next(pCur->iter, &tuple) != 0)
 		return -1;
+	cursor_set_tuple(pCur, tuple, pRes);
+	return 0;
+}
+
+/*
+ * Save the tuple in the cursor instead of the current one. If the tuple
+ * is NULL, the cursor is invalidated and pRes is set to 1.
+ */
+static void
+cursor_set_tuple(BtCursor *pCur, struct tuple *tuple, int *pRes)
+{
 	if (pCur->last_tuple)
 		box_tuple_unref(pCur->last_tuple);
 	if (tuple) {
@@ -925,6 +995,67 @@ cursor_advance(BtCursor *pCur, int *pRes)
 		*pRes = 1;
 	}
 	pCur->last_tuple = tuple;
+}
+
+/*
+ * Check if the tuple may satisfy all filters of the cursor. A comparison
+ * with NULL is never true. Comparisons that would require an implicit
+ * cast or raise an error are left to VDBE.
+ */
+static bool
+cursor_filter_is_passed(const BtCursor *pCur, struct tuple *tuple)
+{
+	for (uint32_t i = 0; i < pCur->filter_count; i++) {
+		const struct cursor_filter *filter = &pCur->filter[i];
+		if (mem_is_null(filter->value))
+			return false;
+		/* A missing field may be replaced with its default value. */
+		const char *field = tuple_field(tuple, filter->fieldno);
+		if (field == NULL)
+			continue;
+		if (mp_typeof(*field) == MP_NIL)
+			return false;
+		int cmp;
+		if (!mem_cmp_msgpack_same_class(filter->value, field, &cmp))
+			continue;
+		/* The field is the right operand of the comparison. */
+		bool is_passed;
+		switch (filter->op) {
+		case OP_Eq:
+			is_passed = cmp == 0;
+			break;
+		case OP_Lt:
+			is_passed = cmp > 0;
+			break;
+		case OP_Le:
+			is_passed = cmp >= 0;
+			break;
+		case OP_Gt:
+			is_passed = cmp < 0;
+			break;
+		default:
+			assert(filter->op == OP_Ge);
+			is_passed = cmp <= 0;
+			break;
+		}
+		if (!is_passed)
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Move the cursor forward until it points to a tuple that may satisfy
+ * all its filters.
+ */
+static int
+cursor_skip_filtered(BtCursor *pCur, int *pRes)
+{
+	while (*pRes == 0 &&
+	       !cursor_filter_is_passed(pCur, pCur->last_tuple)) {
+		if (cursor_advance(pCur, pRes) != 0)
+			return -1;
+	}
 	return 0;
 }
 
@@ -1262,7 +1393,8 @@ vdbe_field_ref_fill(struct vdbe_field_ref *field_ref, struct tuple *tuple,
 	field_ref->field_count = MIN(field_ref->field_capacity, mp_count);
 	field_ref->slots[0] = 0;
 	memset(&field_ref->slots[1], 0,
-	       field_ref->field_count * sizeof(field_ref->slots[0]));
+	       field_ref->rightmost_slot * sizeof(field_ref->slots[0]));
+	field_ref->rightmost_slot = 0;
 	field_ref->slot_bitmask = 0;
 	bitmask64_set_bit(&field_ref->slot_bitmask, 0);
 }
@@ -1354,6 +1486,159 @@ sql_space_tuple_log_count(struct space *space)
 	return sqlLogEst(pk->vtab->size(pk));
 }
 
+/** Number of tuples sampled to collect index statistics. */
+enum { INDEX_STAT_SAMPLE_SIZE = 256 };
+
+/** Compare sampled tuples by the index key. */
+static int
+index_stat_sample_cmp(const void *a, const void *b, void *arg)
+{
+	struct tuple *tuple_a = *(struct tuple **)a;
+	struct tuple *tuple_b = *(struct tuple **)b;
+	return tuple_compare(tuple_a, HINT_NONE, tuple_b, HINT_NONE,
+			     (struct key_def *)arg);
+}
+
+/**
+ * Return the number of leading key parts equal in two tuples.
+ */
+static uint32_t
+index_stat_common_parts(struct tuple *tuple_a, struct tuple *tuple_b,
+			struct key_def *key_def)
+{
+	uint32_t i;
+	for (i = 0; i < key_def->part_count; i++) {
+		struct key_part *part = &key_def->parts[i];
+		const char *field_a = tuple_field_by_part(tuple_a, part,
+							  MULTIKEY_NONE);
+		const char *field_b = tuple_field_by_part(tuple_b, part,
+							  MULTIKEY_NONE);
+		bool is_null_a = field_a == NULL || mp_typeof(*field_a) == MP_NIL;
+		bool is_null_b = field_b == NULL || mp_typeof(*field_b) == MP_NIL;
+		if (is_null_a || is_null_b) {
+			if (is_null_a != is_null_b)
+				break;
+			continue;
+		}
+		if (tuple_compare_field(field_a, field_b, part->type,
+					part->coll) != 0)
+			break;
+	}
+	return i;
+}
+
+/**
+ * Estimate the number of tuples matching a key prefix of each length by
+ * sampling random tuples of the index. The number of tuples matching the
+ * prefix of a random tuple is estimated as the index size multiplied by the
+ * fraction of pairs of sampled tuples that have equal prefixes. The sample
+ * is sorted by the index key, so such pairs form runs of adjacent tuples.
+ *
+ * @param index Index to sample, must support index_random().
+ * @param size Index size.
+ * @param[out] est Logarithmic estimates, see index_field_tuple_est().
+ *
+ * @retval 0 on success, -1 on error.
+ */
+static int
+index_stat_sample(struct index *index, ssize_t size, int16_t *est)
+{
+	struct key_def *key_def = index->def->key_def;
+	uint32_t part_count = key_def->part_count;
+	struct tuple *sample[INDEX_STAT_SAMPLE_SIZE];
+	uint32_t sample_size = 0;
+	int rc = 0;
+	/*
+	 * Do not sample in the current transaction so as not to make
+	 * it track reads of random tuples. Sampling never yields.
+	 */
+	struct txn *txn = in_txn();
+	fiber_set_txn(fiber(), NULL);
+	for (uint32_t i = 0; i < INDEX_STAT_SAMPLE_SIZE; i++) {
+		struct tuple *tuple;
+		if (index_random(index, rand(), &tuple) != 0) {
+			rc = -1;
+			break;
+		}
+		if (tuple == NULL)
+			break;
+		tuple_ref(tuple);
+		sample[sample_size++] = tuple;
+	}
+	fiber_set_txn(fiber(), txn);
+	if (rc != 0 || sample_size < 2)
+		goto out;
+	qsort_arg(sample, sample_size, sizeof(sample[0]),
+		  index_stat_sample_cmp, key_def);
+	uint64_t *pairs = xregion_alloc_array(&fiber()->gc, uint64_t,
+					      part_count + 1);
+	memset(pairs, 0, sizeof(pairs[0]) * (part_count + 1));
+	/* run[k] is the length of the current run of equal k-prefixes. */
+	uint64_t *run = xregion_alloc_array(&fiber()->gc, uint64_t,
+					    part_count + 1);
+	for (uint32_t k = 0; k <= part_count; k++)
+		run[k] = 1;
+	for (uint32_t i = 1; i < sample_size; i++) {
+		uint32_t common = index_stat_common_parts(sample[i - 1],
+							  sample[i], key_def);
+		for (uint32_t k = 1; k <= part_count; k++) {
+			if (k <= common) {
+				pairs[k] += run[k];
+				run[k]++;
+			} else {
+				run[k] = 1;
+			}
+		}
+	}
+	uint64_t total = (uint64_t)sample_size * (sample_size - 1) / 2;
+	for (uint32_t k = 1; k <= part_count; k++) {
+		uint64_t count = (uint64_t)size * pairs[k] / total;
+		est[k] = MIN(sqlLogEst(MAX(count, 1)), est[k - 1]);
+	}
+out:
+	for (uint32_t i = 0; i < sample_size; i++)
+		tuple_unref(sample[i]);
+	return rc;
+}
+
+/**
+ * Return statistics of the index collected by sampling, see
+ * index_field_tuple_est(), or NULL if they are not available. The
+ * statistics are collected again if the index size has changed more
+ * than twice since they were collected.
+ */
+static const int16_t *
+index_stat_get(struct index *index)
+{
+	ssize_t size = index_size(index);
+	if (size < 0)
+		return NULL;
+	if (index->sql_tuple_est != NULL &&
+	    size <= 2 * index->sql_tuple_est_size &&
+	    2 * size >= index->sql_tuple_est_size)
+		return index->sql_tuple_est;
+	struct index_def *def = index->def;
+	uint32_t part_count = def->key_def->part_count;
+	int16_t *est = xrealloc(index->sql_tuple_est,
+				sizeof(est[0]) * (part_count + 1));
+	index->sql_tuple_est = est;
+	index->sql_tuple_est_size = size;
+	est[0] = sqlLogEst(MAX(size, 1));
+	for (uint32_t k = 1; k <= part_count; k++) {
+		est[k] = MIN(default_tuple_est[k + 1 >= 6 ? 6 : k],
+			     est[k - 1]);
+	}
+	struct space *space = space_by_id(def->space_id);
+	if (space_is_memtx(space) && (def->type == TREE || def->type == HASH) &&
+	    !def->key_def->is_multikey && !def->key_def->for_func_index) {
+		size_t region_svp = region_used(&fiber()->gc);
+		if (index_stat_sample(index, size, est) != 0)
+			diag_log();
+		region_truncate(&fiber()->gc, region_svp);
+	}
+	return est;
+}
+
 int16_t
 index_field_tuple_est(const struct index_def *idx_def, uint32_t field)
 {
@@ -1371,6 +1656,16 @@ index_field_tuple_est(const struct index_def *idx_def, uint32_t field)
 	if (field == idx_def->key_def->part_count &&
 	    idx_def->opts.is_unique)
 		return 0;
+	if (sql_index_stat) {
+		struct index *index = space_index(space, idx_def->iid);
+		const int16_t *est = NULL;
+		if (index != NULL &&
+		    index->def->key_def->part_count ==
+		    idx_def->key_def->part_count)
+			est = index_stat_get(index);
+		if (est != NULL)
+			return est[field];
+	}
 	return default_tuple_est[field + 1 >= 6 ? 6 : field];
 }
 
@@ -351,6 +351,12 @@ struct vdbe_field_ref {
 	 * extra tuple decoding as possible.
 	 */
 	uint64_t slot_bitmask;
+	/**
+	 * The biggest fieldno whose slot is initialized. All the
+	 * slots after it are zero so only slots up to this one
+	 * need to be cleared when the next tuple is prepared.
+	 */
+	uint32_t rightmost_slot;
 	/**
 	 * Array of offsets of tuple fields.
 	 * Only values <= rightmost_slot are valid.
@@ -56,6 +56,20 @@ sqlCursorZero(BtCursor * p)
 	memset(p, 0, sizeof(*p));
 }
 
+void
+sql_cursor_set_filter(struct BtCursor *cursor, uint32_t slot,
+		      uint32_t fieldno, int op, const struct Mem *value)
+{
+	assert(slot < CURSOR_FILTER_MAX);
+	assert(op == OP_Eq || op == OP_Lt || op == OP_Le ||
+	       op == OP_Gt || op == OP_Ge);
+	struct cursor_filter *filter = &cursor->filter[slot];
+	filter->fieldno = fieldno;
+	filter->op = op;
+	filter->value = value;
+	cursor->filter_count = MAX(cursor->filter_count, slot + 1);
+}
+
 void
 sql_cursor_close(struct BtCursor *cursor)
 {
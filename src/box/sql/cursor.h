@@ -34,6 +34,28 @@
 
 typedef struct BtCursor BtCursor;
 
+struct Mem;
+
+enum {
+	/** Max number of filters pushed down to a cursor. */
+	CURSOR_FILTER_MAX = 4,
+};
+
+/**
+ * Comparison of a tuple field with a value, which is checked by
+ * the cursor on its own while it scans a space. Tuples that
+ * definitely do not satisfy the comparison are skipped without
+ * being passed to VDBE.
+ */
+struct cursor_filter {
+	/** Number of the compared field. */
+	uint32_t fieldno;
+	/** Comparison opcode: OP_Eq, OP_Lt, OP_Le, OP_Gt or OP_Ge. */
+	int op;
+	/** Value to compare the field with. */
+	const struct Mem *value;
+};
+
 /*
  * A cursor contains a particular entry either from Tarantrool or
  * Sorter. Tarantool cursor is able to point to ordinary table or
@@ -50,6 +72,10 @@ struct BtCursor {
 	enum iterator_type iter_type;
 	struct tuple *last_tuple;
 	char *key;		/* Saved key that was cursor last known position */
+	/** Filters checked by the cursor while it scans a space. */
+	struct cursor_filter filter[CURSOR_FILTER_MAX];
+	/** Number of used filters. */
+	uint32_t filter_count;
 };
 
 void sqlCursorZero(BtCursor *);
@@ -61,6 +87,16 @@ void sqlCursorZero(BtCursor *);
 void
 sql_cursor_close(struct BtCursor *cursor);
 
+/**
+ * Set filter number @a slot of the cursor: the cursor skips tuples
+ * for which comparison of field @a fieldno with @a value is
+ * definitely not true while it scans a space. Tuples passed by the
+ * filter still have to be checked by the caller.
+ */
+void
+sql_cursor_set_filter(struct BtCursor *cursor, uint32_t slot,
+		      uint32_t fieldno, int op, const struct Mem *value);
+
 int sqlCursorNext(BtCursor *, int *pRes);
 int sqlCursorPrevious(BtCursor *, int *pRes);
 void
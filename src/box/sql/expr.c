@@ -1178,6 +1178,32 @@ sqlExprFunction(Parse * pParse, ExprList * pList, Token * pToken)
 	return new_expr;
 }
 
+struct Expr *
+sql_window_new(struct Parse *parse, struct ExprList *partition_by,
+	       struct ExprList *order_by)
+{
+	struct Expr *order = NULL;
+	if (order_by != NULL) {
+		order = sql_expr_new_anon(TK_ORDER);
+		order->x.pList = order_by;
+		sqlExprSetHeightAndFlags(parse, order);
+	}
+	struct Expr *window = sqlPExpr(parse, TK_OVER, order, NULL);
+	window->x.pList = partition_by;
+	sqlExprSetHeightAndFlags(parse, window);
+	return window;
+}
+
+void
+sql_expr_attach_window(struct Parse *parse, struct Expr *func,
+		       struct Expr *window)
+{
+	assert(func->op == TK_FUNCTION && func->pRight == NULL);
+	assert(window->op == TK_OVER);
+	sqlExprAttachSubtrees(func, NULL, window);
+	sqlExprSetHeightAndFlags(parse, func);
+}
+
 /*
  * Assign a variable number to an expression that encodes a
  * wildcard in the original SQL statement.
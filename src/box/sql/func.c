@@ -233,6 +233,19 @@ step_group_concat(struct sql_context *ctx, int argc, const struct Mem *argv)
 		ctx->is_aborted = true;
 }
 
+/**
+ * Implementation of the ROW_NUMBER(), RANK() and DENSE_RANK() functions.
+ * These functions have no accumulator, their values are computed by the
+ * window code while the rows of a partition are returned.
+ */
+static void
+step_rank(struct sql_context *ctx, int argc, const struct Mem *argv)
+{
+	(void)ctx;
+	(void)argc;
+	(void)argv;
+}
+
 /** Implementations of the ABS() function. */
 static void
 func_abs_int(struct sql_context *ctx, int argc, const struct Mem *argv)
@@ -1804,6 +1817,8 @@ static struct sql_func_dictionary dictionaries[] = {
 	{"COALESCE", 2, SQL_MAX_FUNCTION_ARG, SQL_FUNC_COALESCE, true, 0, NULL},
 	{"COUNT", 0, 1, SQL_FUNC_AGG, false, 0, NULL},
 	{"DATE_PART", 2, 2, 0, true, 0, NULL},
+	{"DENSE_RANK", 0, 0, SQL_FUNC_AGG | SQL_FUNC_DENSE_RANK, false, 0,
+	 NULL},
 	{"GREATEST", 2, SQL_MAX_FUNCTION_ARG, SQL_FUNC_NEEDCOLL, true, 0, NULL},
 	{"GROUP_CONCAT", 1, 2, SQL_FUNC_AGG, false, 0, NULL},
 	{"HEX", 1, 1, 0, true, 0, NULL},
@@ -1826,9 +1841,12 @@ static struct sql_func_dictionary dictionaries[] = {
 	{"QUOTE", 1, 1, 0, true, 0, NULL},
 	{"RANDOM", 0, 0, 0, false, 0, NULL},
 	{"RANDOMBLOB", 1, 1, 0, false, 0, NULL},
+	{"RANK", 0, 0, SQL_FUNC_AGG | SQL_FUNC_RANK, false, 0, NULL},
 	{"REPLACE", 3, 3, SQL_FUNC_DERIVEDCOLL, true, 0, NULL},
 	{"ROUND", 1, 2, 0, true, 0, NULL},
 	{"ROW_COUNT", 0, 0, 0, true, 0, NULL},
+	{"ROW_NUMBER", 0, 0, SQL_FUNC_AGG | SQL_FUNC_ROW_NUMBER, false, 0,
+	 NULL},
 	{"SOUNDEX", 1, 1, 0, true, 0, NULL},
 	{"SUBSTR", 2, 3, SQL_FUNC_DERIVEDCOLL, true, 0, NULL},
 	{"SUM", 1, 1, SQL_FUNC_AGG, false, 0, NULL},
@@ -1895,6 +1913,7 @@ static struct sql_func_definition definitions[] = {
 	 fin_count},
 	{"DATE_PART", 2, {FIELD_TYPE_STRING, FIELD_TYPE_DATETIME},
 	 FIELD_TYPE_INTEGER, func_date_part, NULL},
+	{"DENSE_RANK", 0, {}, FIELD_TYPE_INTEGER, step_rank, NULL},
 
 	{"GREATEST", -1, {FIELD_TYPE_INTEGER}, FIELD_TYPE_INTEGER,
 	 func_greatest_least, NULL},
@@ -2009,6 +2028,7 @@ static struct sql_func_definition definitions[] = {
 	{"RANDOM", 0, {}, FIELD_TYPE_INTEGER, func_random, NULL},
 	{"RANDOMBLOB", 1, {FIELD_TYPE_INTEGER}, FIELD_TYPE_VARBINARY,
 	 func_randomblob, NULL},
+	{"RANK", 0, {}, FIELD_TYPE_INTEGER, step_rank, NULL},
 	{"REPLACE", 3,
 	 {FIELD_TYPE_STRING, FIELD_TYPE_STRING, FIELD_TYPE_STRING},
 	 FIELD_TYPE_STRING, replaceFunc, NULL},
@@ -2028,6 +2048,7 @@ static struct sql_func_definition definitions[] = {
 	{"ROUND", 2, {FIELD_TYPE_INTEGER, FIELD_TYPE_INTEGER},
 	 FIELD_TYPE_INTEGER, func_round_int, NULL},
 	{"ROW_COUNT", 0, {}, FIELD_TYPE_INTEGER, func_row_count, NULL},
+	{"ROW_NUMBER", 0, {}, FIELD_TYPE_INTEGER, step_rank, NULL},
 	{"SOUNDEX", 1, {FIELD_TYPE_STRING}, FIELD_TYPE_STRING, soundexFunc,
 	 NULL},
 	{"SUBSTR", 2, {FIELD_TYPE_STRING, FIELD_TYPE_INTEGER},
@@ -2758,6 +2758,37 @@ mem_cmp_msgpack(const struct Mem *a, const char **b, int *result,
 	return 0;
 }
 
+bool
+mem_cmp_msgpack_same_class(const struct Mem *a, const char *b, int *result)
+{
+	if (!mem_is_comparable(a) || (a->flags & MEM_Scalar) != 0)
+		return false;
+	enum mem_class class_b;
+	switch (mp_typeof(*b)) {
+	case MP_BOOL:
+		class_b = MEM_CLASS_BOOL;
+		break;
+	case MP_UINT:
+	case MP_INT:
+	case MP_FLOAT:
+	case MP_DOUBLE:
+		class_b = MEM_CLASS_NUMBER;
+		break;
+	case MP_STR:
+		class_b = MEM_CLASS_STR;
+		break;
+	case MP_BIN:
+		class_b = MEM_CLASS_BIN;
+		break;
+	default:
+		return false;
+	}
+	if (mem_type_class(a->type) != class_b)
+		return false;
+	VERIFY(mem_cmp_msgpack(a, &b, result, NULL) == 0);
+	return true;
+}
+
 int
 mem_cmp(const struct Mem *a, const struct Mem *b, int *result,
 	const struct coll *coll)
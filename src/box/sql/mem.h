@@ -649,6 +649,15 @@ int
 mem_cmp_msgpack(const struct Mem *a, const char **b, int *result,
 		const struct coll *coll);
 
+/**
+ * Compare MEM and packed to msgpack value without collation if both values
+ * are booleans, numbers, strings or varbinaries, i.e. if they can be compared
+ * without an implicit cast. Return false if they cannot, otherwise store the
+ * result of comparison in @a result and return true.
+ */
+bool
+mem_cmp_msgpack_same_class(const struct Mem *a, const char *b, int *result);
+
 /**
  * Compare two MEMs using implicit cast rules and return the result of
  * comparison. MEMs should be scalars. Original MEMs are not changed.
@@ -1154,6 +1154,45 @@ expr(A) ::= id(X) LP STAR RP(E). {
   A.pExpr = sqlExprFunction(pParse, 0, &X);
   spanSet(&A,&X,&E);
 }
+
+expr(A) ::= id(X) LP distinct(D) exprlist(Y) RP OVER LP window(W) RP(E). {
+  if (Y != NULL && Y->nExpr > SQL_MAX_FUNCTION_ARG){
+    const char *err =
+      tt_sprintf("Number of arguments to function %.*s", X.n, X.z);
+    diag_set(ClientError, ER_SQL_PARSER_LIMIT, err, Y->nExpr,
+             SQL_MAX_FUNCTION_ARG);
+    pParse->is_aborted = true;
+  }
+  A.pExpr = sqlExprFunction(pParse, Y, &X);
+  sql_expr_attach_window(pParse, A.pExpr, W);
+  spanSet(&A,&X,&E);
+  if( D==SF_Distinct && A.pExpr ){
+    A.pExpr->flags |= EP_Distinct;
+  }
+}
+
+expr(A) ::= id(X) LP STAR RP OVER LP window(W) RP(E). {
+  A.pExpr = sqlExprFunction(pParse, 0, &X);
+  sql_expr_attach_window(pParse, A.pExpr, W);
+  spanSet(&A,&X,&E);
+}
+
+/*
+ * The window of a window function call. Only the default frame is
+ * supported: the whole partition if there is no ORDER BY, otherwise the
+ * rows from the start of the partition up to the last peer of the current
+ * row.
+ */
+%type window {struct Expr *}
+%destructor window {sql_expr_delete($$);}
+window(A) ::= partitionby_opt(P) orderby_opt(O). {
+  A = sql_window_new(pParse, P, O);
+}
+
+%type partitionby_opt {ExprList*}
+%destructor partitionby_opt {sql_expr_list_delete($$);}
+partitionby_opt(A) ::= .                          {A = NULL;}
+partitionby_opt(A) ::= PARTITION BY nexprlist(X). {A = X;}
 /*
  * term(A) ::= CTIME_KW(OP). {
  *   A.pExpr = sqlExprFunction(pParse, 0, &OP);
@@ -206,6 +206,52 @@ sql_get_prepare_common_keys(struct Vdbe *stmt, struct obuf *out, int keys)
 	return 0;
 }
 
+/**
+ * Dump the body of a DQL EXECUTE response up to the IPROTO_DATA key:
+ * the body map header and the metadata.
+ */
+static int
+port_sql_dump_dql_header(struct Vdbe *stmt, struct obuf *out)
+{
+	int keys = 2;
+	int size = mp_sizeof_map(keys);
+	char *pos = obuf_alloc(out, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		return -1;
+	}
+	pos = mp_encode_map(pos, keys);
+	if (sql_get_metadata(stmt, out, sql_column_count(stmt)) != 0)
+		return -1;
+	size = mp_sizeof_uint(IPROTO_DATA);
+	pos = obuf_alloc(out, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		return -1;
+	}
+	pos = mp_encode_uint(pos, IPROTO_DATA);
+	return 0;
+}
+
+int
+port_sql_dump_msgpack_detached(struct port *port, struct obuf *out)
+{
+	assert(port->vtab == &port_sql_vtab);
+	struct port_sql *sql_port = (struct port_sql *)port;
+	assert(sql_port->serialization_format == DQL_EXECUTE);
+	if (port_sql_dump_dql_header(sql_port->stmt, out) != 0)
+		return -1;
+	uint32_t count = ((struct port_c *)port)->size;
+	size_t size = mp_sizeof_array(count);
+	char *pos = obuf_alloc(out, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		return -1;
+	}
+	mp_encode_array(pos, count);
+	return 0;
+}
+
 /**
  * Dump data from port to buffer. Data in port contains tuples,
  * metadata, or information obtained from an executed SQL query.
@@ -253,23 +299,8 @@ port_sql_dump_msgpack(struct port *port, struct obuf *out, struct mp_ctx *ctx)
 	struct Vdbe *stmt = sql_port->stmt;
 	switch (sql_port->serialization_format) {
 	case DQL_EXECUTE: {
-		int keys = 2;
-		int size = mp_sizeof_map(keys);
-		char *pos = obuf_alloc(out, size);
-		if (pos == NULL) {
-			diag_set(OutOfMemory, size, "obuf_alloc", "pos");
-			return -1;
-		}
-		pos = mp_encode_map(pos, keys);
-		if (sql_get_metadata(stmt, out, sql_column_count(stmt)) != 0)
+		if (port_sql_dump_dql_header(stmt, out) != 0)
 			return -1;
-		size = mp_sizeof_uint(IPROTO_DATA);
-		pos = obuf_alloc(out, size);
-		if (pos == NULL) {
-			diag_set(OutOfMemory, size, "obuf_alloc", "pos");
-			return -1;
-		}
-		pos = mp_encode_uint(pos, IPROTO_DATA);
 		port_c_dump_msgpack_wrapped(port, out, ctx);
 		break;
 	}
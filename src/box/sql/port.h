@@ -61,6 +61,17 @@ void
 port_sql_create(struct port *port, struct Vdbe *stmt,
 		enum sql_serialization_format format, bool do_finalize);
 
+/**
+ * Dump the body of a DQL EXECUTE response stored in the port to @a out
+ * except for the rows, which are supposed to be sent separately right
+ * after it: the metadata and the IPROTO_DATA array header.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+port_sql_dump_msgpack_detached(struct port *port, struct obuf *out);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined __cplusplus */
@@ -607,6 +607,28 @@ resolveExprStep(Walker * pWalker, Expr * pExpr)
 			nId = sqlStrlen30(zId);
 			uint32_t flags = sql_func_flags(pExpr);
 			bool is_agg = (flags & SQL_FUNC_AGG) != 0;
+			struct Expr *window = sql_expr_window(pExpr);
+			if (window != NULL && !is_agg) {
+				const char *err =
+					tt_sprintf("%.*s() is not a window "\
+						   "function", nId, zId);
+				diag_set(ClientError, ER_SQL_PARSER_GENERIC,
+					 err);
+				pParse->is_aborted = true;
+				pNC->nErr++;
+				return WRC_Abort;
+			}
+			if (window == NULL && (flags & SQL_FUNC_WINDOW) != 0) {
+				const char *err =
+					tt_sprintf("window function %.*s() "\
+						   "requires an OVER clause",
+						   nId, zId);
+				diag_set(ClientError, ER_SQL_PARSER_GENERIC,
+					 err);
+				pParse->is_aborted = true;
+				pNC->nErr++;
+				return WRC_Abort;
+			}
 			if ((flags & SQL_FUNC_UNLIKELY) != 0 && n == 2) {
 				ExprSetProperty(pExpr, EP_Unlikely | EP_Skip);
 				pExpr->iTable =
@@ -632,8 +654,10 @@ resolveExprStep(Walker * pWalker, Expr * pExpr)
 			}
 			if (is_agg && (pNC->ncFlags & NC_AllowAgg) == 0) {
 				const char *err =
-					tt_sprintf("misuse of aggregate "\
-						   "function %.*s()", nId, zId);
+					tt_sprintf("misuse of %s function "\
+						   "%.*s()", window != NULL ?
+						   "window" : "aggregate",
+						   nId, zId);
 				diag_set(ClientError, ER_SQL_PARSER_GENERIC, err);
 				pParse->is_aborted = true;
 				pNC->nErr++;
@@ -642,9 +666,19 @@ resolveExprStep(Walker * pWalker, Expr * pExpr)
 			if (is_agg)
 				pNC->ncFlags &= ~NC_AllowAgg;
 			sqlWalkExprList(pWalker, pList);
+			sqlWalkExpr(pWalker, window);
 			if (pParse->is_aborted)
 				break;
-			if (is_agg) {
+			if (is_agg && window != NULL) {
+				/*
+				 * A window function is computed by the
+				 * SELECT it is used in and does not make
+				 * the SELECT an aggregate.
+				 */
+				pExpr->op = TK_AGG_FUNCTION;
+				pExpr->op2 = 0;
+				pNC->ncFlags |= NC_HasWindow | NC_AllowAgg;
+			} else if (is_agg) {
 				NameContext *pNC2 = pNC;
 				pExpr->op = TK_AGG_FUNCTION;
 				pExpr->op2 = 0;
@@ -1360,6 +1394,8 @@ resolveSelectStep(Walker * pWalker, Select * p)
 				}
 			}
 		}
+		if ((sNC.ncFlags & NC_HasWindow) != 0)
+			p->selFlags |= SF_Window;
 
 		/* If this is part of a compound SELECT, check that it has the right
 		 * number of expressions in the select list.
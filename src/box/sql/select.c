@@ -1042,8 +1042,12 @@ pushOntoSorter(Parse * pParse,		/* Parser context */
 		sqlVdbeJumpHere(v, addrJmp);
 	}
 	if (pSort->sortFlags & SORTFLAG_UseSorter) {
-		sqlVdbeAddOp2(v, OP_SorterInsert, pSort->iECursor,
-				  regRecord);
+		/*
+		 * Let the sorter keep only LIMIT+OFFSET first rows
+		 * in memory.
+		 */
+		sqlVdbeAddOp3(v, OP_SorterInsert, pSort->iECursor,
+			      regRecord, iLimit);
 		return;
 	}
 	sqlVdbeAddOp2(v, OP_IdxInsert, regRecord, pSort->reg_eph);
@@ -3923,6 +3927,11 @@ substSelect(Parse * pParse,	/* Report errors here */
  *        "SELECT x FROM (SELECT max(y), x FROM t1)" would not necessarily
  *        return the value X for which Y was maximal.)
  *
+ *  (25)  Neither the outer query nor the subquery use window
+ *        functions. The window of the outer query is computed over
+ *        the rows of the subquery, and the window of the subquery
+ *        must not see the outer WHERE terms.
+ *
  *
  * In this routine, the "p" parameter is a pointer to the outer query.
  * The subquery is p->pSrc->a[iFrom].  isAgg is true if the outer query
@@ -4017,6 +4026,8 @@ flattenSubquery(Parse * pParse,		/* Parsing context */
 	if ((p->selFlags & SF_Recursive) && pSub->pPrior) {
 		return 0;	/* Restriction (23) */
 	}
+	if (((p->selFlags | pSub->selFlags) & SF_Window) != 0)
+		return 0;	/* Restriction (25) */
 
 	/* OBSOLETE COMMENT 1:
 	 * Restriction 3:  If the subquery is a join, make sure the subquery is
@@ -4070,8 +4081,9 @@ flattenSubquery(Parse * pParse,		/* Parsing context */
 				return 0;
 			assert(pSub->pSrc != 0);
 			assert(pSub->pEList->nExpr == pSub1->pEList->nExpr);
-			if ((pSub1->selFlags & (SF_Distinct | SF_Aggregate)) !=
-			    0 || (pSub1->pPrior && pSub1->op != TK_ALL)
+			if ((pSub1->selFlags & (SF_Distinct | SF_Aggregate |
+						SF_Window)) != 0 ||
+			    (pSub1->pPrior && pSub1->op != TK_ALL)
 			    || pSub1->pSrc->nSrc < 1) {
 				return 0;
 			}
@@ -4370,6 +4382,9 @@ flattenSubquery(Parse * pParse,		/* Parsing context */
  *   (5) The WHERE clause expression originates in the ON or USING clause
  *       of a LEFT JOIN.
  *
+ *   (6) The inner query uses window functions. (The outer WHERE terms
+ *       would change the rows the windows are computed over.)
+ *
  * Return 0 if no changes are made and non-zero if one or more WHERE clause
  * terms are duplicated into the subquery.
  */
@@ -4385,8 +4400,9 @@ pushDownWhereTerms(Parse * pParse,	/* Parse context (for malloc() and error repo
 	if (pWhere == 0)
 		return 0;
 	for (pX = pSubq; pX; pX = pX->pPrior) {
-		if ((pX->selFlags & (SF_Aggregate | SF_Recursive)) != 0) {
-			return 0;	/* restrictions (1) and (2) */
+		if ((pX->selFlags & (SF_Aggregate | SF_Recursive |
+				     SF_Window)) != 0) {
+			return 0;	/* restrictions (1), (2) and (6) */
 		}
 	}
 	if (pSubq->pLimit != 0) {
@@ -5507,6 +5523,373 @@ vdbe_code_raise_on_multiple_rows(struct Parse *parser, int limit_reg, int end_ma
 	sqlReleaseTempReg(parser, r1);
 }
 
+/**
+ * Reassign the columns of the window ephemeral space. The first
+ * columns of the space are the PARTITION BY and ORDER BY terms of
+ * the window, they are followed by the source columns that are
+ * not window terms themselves and by the sequence number that
+ * makes the rows unique.
+ *
+ * @param agg_info Aggregate info of the SELECT.
+ * @param keys PARTITION BY terms followed by ORDER BY terms.
+ */
+static void
+window_assign_sorter_columns(struct AggInfo *agg_info, struct ExprList *keys)
+{
+	int key_count = keys != NULL ? keys->nExpr : 0;
+	agg_info->nSortingColumn = key_count;
+	for (int i = 0; i < agg_info->nColumn; i++) {
+		struct AggInfo_col *col = &agg_info->aCol[i];
+		col->iSorterColumn = -1;
+		for (int j = 0; j < key_count; j++) {
+			struct Expr *expr = keys->a[j].pExpr;
+			if (expr->op == TK_COLUMN_REF &&
+			    expr->iTable == col->iTable &&
+			    expr->iColumn == col->iColumn) {
+				col->iSorterColumn = j;
+				break;
+			}
+		}
+		if (col->iSorterColumn < 0)
+			col->iSorterColumn = agg_info->nSortingColumn++;
+	}
+}
+
+/**
+ * Create the description of the window ephemeral space. Its
+ * primary key consists of the window terms and the sequence
+ * number, so the cursors over the space visit the rows
+ * partition by partition in the window ORDER BY order.
+ */
+static struct sql_space_info *
+window_space_info_new(struct Parse *parse, struct AggInfo *agg_info,
+		      struct ExprList *keys)
+{
+	int key_count = keys != NULL ? keys->nExpr : 0;
+	uint32_t field_count = agg_info->nSortingColumn + 1;
+	struct sql_space_info *info =
+		sql_space_info_new(field_count, key_count + 1);
+	for (int i = 0; i < key_count; i++) {
+		bool unused;
+		struct coll *coll;
+		struct Expr *expr = keys->a[i].pExpr;
+		enum field_type type = sql_expr_type(expr);
+		if (type == FIELD_TYPE_ANY)
+			type = FIELD_TYPE_SCALAR;
+		uint32_t coll_id;
+		if (sql_expr_coll(parse, expr, &unused, &coll_id,
+				  &coll) != 0) {
+			sql_xfree(info);
+			return NULL;
+		}
+		info->types[i] = type;
+		info->coll_ids[i] = coll_id;
+		info->sort_orders[i] = keys->a[i].sort_order;
+	}
+	for (int i = 0; i < agg_info->nColumn; i++) {
+		struct AggInfo_col *col = &agg_info->aCol[i];
+		if (col->iSorterColumn < key_count)
+			continue;
+		info->types[col->iSorterColumn] =
+			col->space_def->fields[col->iColumn].type;
+	}
+	info->types[field_count - 1] = FIELD_TYPE_INTEGER;
+	info->parts[key_count] = field_count - 1;
+	return info;
+}
+
+/**
+ * Generate code for a SELECT with window functions. All the
+ * window functions of the SELECT share the same window, so the
+ * rows produced by the FROM and WHERE clauses are stored into an
+ * ephemeral space ordered by the PARTITION BY and ORDER BY terms
+ * of the window. Then two cursors walk over the space: the lead
+ * one feeds rows to the aggregate accumulators and the lag one
+ * emits the rows of each group of peers as soon as the lead
+ * cursor leaves the group. So every row is read twice and the
+ * result is computed in a single pass over the sorted rows.
+ *
+ * Only the default frame is supported: the frame of a row is the
+ * whole partition if there is no ORDER BY in the window, and
+ * rows from the partition start up to the last peer of the row
+ * otherwise.
+ *
+ * @param parse Parsing context.
+ * @param select SELECT to code.
+ * @param agg_info Aggregate info of the SELECT.
+ * @param sort ORDER BY context of the SELECT.
+ * @param distinct DISTINCT context of the SELECT.
+ * @param dest Destination of the result.
+ * @retval 0 on success.
+ * @retval -1 on error.
+ */
+static int
+select_window(struct Parse *parse, struct Select *select,
+	      struct AggInfo *agg_info, struct SortCtx *sort,
+	      struct DistinctCtx *distinct, struct SelectDest *dest)
+{
+	struct Vdbe *v = parse->pVdbe;
+	struct NameContext nc;
+	memset(&nc, 0, sizeof(nc));
+	nc.pParse = parse;
+	nc.pSrcList = select->pSrc;
+	nc.pAggInfo = agg_info;
+	agg_info->mnReg = parse->nMem + 1;
+	sqlExprAnalyzeAggList(&nc, select->pEList);
+	sqlExprAnalyzeAggList(&nc, sort->pOrderBy);
+	agg_info->nAccumulator = 0;
+	for (int i = 0; i < agg_info->nFunc; i++) {
+		nc.ncFlags |= NC_InAggFunc;
+		sqlExprAnalyzeAggList(&nc, agg_info->aFunc[i].pExpr->x.pList);
+		nc.ncFlags &= ~NC_InAggFunc;
+	}
+	agg_info->mxReg = parse->nMem;
+	if (parse->is_aborted)
+		return -1;
+	assert(agg_info->nFunc > 0);
+	struct Expr *window = sql_expr_window(agg_info->aFunc[0].pExpr);
+	for (int i = 0; i < agg_info->nFunc; i++) {
+		struct AggInfo_func *func = &agg_info->aFunc[i];
+		const char *err = NULL;
+		if (func->func->def->language != FUNC_LANGUAGE_SQL_BUILTIN) {
+			err = tt_sprintf("user-defined aggregate function "
+					 "%s() can't be used as a window "
+					 "function", func->func->def->name);
+		} else if (sqlExprCompare(sql_expr_window(func->pExpr),
+					  window, -1) != 0) {
+			err = "all window functions of a SELECT must use the "
+			      "same window";
+		}
+		if (err != NULL) {
+			diag_set(ClientError, ER_SQL_PARSER_GENERIC, err);
+			parse->is_aborted = true;
+			return -1;
+		}
+	}
+	/*
+	 * Window terms are kept in the original form: they are
+	 * computed directly from the source tables when rows are
+	 * stored into the ephemeral space.
+	 */
+	struct ExprList *partition_by = window->x.pList;
+	struct ExprList *order_by = window->pLeft != NULL ?
+				    window->pLeft->x.pList : NULL;
+	int part_count = partition_by != NULL ? partition_by->nExpr : 0;
+	int order_count = order_by != NULL ? order_by->nExpr : 0;
+	int key_count = part_count + order_count;
+	struct ExprList *keys = sql_expr_list_dup(partition_by, 0);
+	for (int i = 0; i < order_count; i++) {
+		struct Expr *expr = sqlExprDup(order_by->a[i].pExpr, 0);
+		keys = sql_expr_list_append(keys, expr);
+		keys->a[keys->nExpr - 1].sort_order = order_by->a[i].sort_order;
+	}
+	window_assign_sorter_columns(agg_info, keys);
+	int rc = -1;
+	struct sql_key_info *part_key_info = NULL;
+	struct sql_key_info *order_key_info = NULL;
+	struct sql_space_info *info =
+		window_space_info_new(parse, agg_info, keys);
+	if (info == NULL)
+		goto error;
+	if (part_count > 0) {
+		part_key_info = sql_expr_list_to_key_info(parse, keys, 0);
+		if (part_key_info == NULL)
+			goto error;
+	}
+	if (order_count > 0) {
+		order_key_info = sql_expr_list_to_key_info(parse, keys,
+							   part_count);
+		if (order_key_info == NULL)
+			goto error;
+	}
+
+	int reg_eph = ++parse->nMem;
+	int lead = parse->nTab++;
+	int lag = parse->nTab++;
+	int field_count = agg_info->nSortingColumn + 1;
+	int reg_row_num = ++parse->nMem;
+	int reg_dense_rank = ++parse->nMem;
+	int reg_peer_rows = ++parse->nMem;
+	int reg_abort = ++parse->nMem;
+	int reg_flush = ++parse->nMem;
+	int reg_key = parse->nMem + 1;
+	parse->nMem += key_count;
+	int reg_peer_key = parse->nMem + 1;
+	parse->nMem += key_count;
+	int reg_values = parse->nMem + 1;
+	parse->nMem += agg_info->nFunc;
+	int addr_flush = sqlVdbeMakeLabel(v);
+	int addr_end = sqlVdbeMakeLabel(v);
+
+	sqlVdbeAddOp4(v, OP_OpenTEphemeral, reg_eph, field_count, 0,
+		      (char *)info, P4_DYNAMIC);
+	VdbeComment((v, "Window table"));
+	info = NULL;
+	explainTempTable(parse, "WINDOW");
+	struct WhereInfo *where_info =
+		sqlWhereBegin(parse, select->pSrc, select->pWhere, NULL, NULL,
+			      0, 0);
+	if (where_info == NULL)
+		goto error;
+	int reg_base = sqlGetTempRange(parse, field_count);
+	sqlExprCacheClear(parse);
+	if (key_count > 0)
+		sqlExprCodeExprList(parse, keys, reg_base, 0, 0);
+	for (int i = 0; i < agg_info->nColumn; i++) {
+		struct AggInfo_col *col = &agg_info->aCol[i];
+		if (col->iSorterColumn < key_count)
+			continue;
+		sqlExprCodeGetColumnToReg(parse, col->iColumn, col->iTable,
+					  reg_base + col->iSorterColumn);
+	}
+	sqlVdbeAddOp2(v, OP_NextIdEphemeral, reg_eph,
+		      reg_base + field_count - 1);
+	int reg_record = sqlGetTempReg(parse);
+	sqlVdbeAddOp3(v, OP_MakeRecord, reg_base, field_count, reg_record);
+	sqlVdbeAddOp2(v, OP_IdxInsert, reg_record, reg_eph);
+	sqlReleaseTempReg(parse, reg_record);
+	sqlReleaseTempRange(parse, reg_base, field_count);
+	sqlWhereEnd(where_info);
+
+	/*
+	 * Walk over the stored rows with the lead cursor. The
+	 * accumulators are reset at the start of each partition
+	 * and the rows of the previous group of peers are emitted
+	 * before the first row of the next group is accumulated.
+	 */
+	sqlVdbeAddOp2(v, OP_Integer, 0, reg_abort);
+	sqlVdbeAddOp2(v, OP_Integer, 0, reg_peer_rows);
+	sqlVdbeAddOp2(v, OP_Integer, 0, reg_row_num);
+	sqlVdbeAddOp2(v, OP_Integer, 0, reg_dense_rank);
+	if (key_count > 0) {
+		sqlVdbeAddOp3(v, OP_Null, 0, reg_peer_key,
+			      reg_peer_key + key_count - 1);
+	}
+	resetAccumulator(parse, agg_info);
+	sqlVdbeAddOp3(v, OP_IteratorOpen, lead, 0, reg_eph);
+	sqlVdbeAddOp3(v, OP_IteratorOpen, lag, 0, reg_eph);
+	sqlVdbeAddOp2(v, OP_Rewind, lead, addr_end);
+	sqlVdbeAddOp2(v, OP_Rewind, lag, addr_end);
+	int addr_top = sqlVdbeCurrentAddr(v);
+	sqlExprCacheClear(parse);
+	for (int i = 0; i < key_count; i++)
+		sqlVdbeAddOp3(v, OP_Column, lead, i, reg_key + i);
+	int addr_peer_key = sqlVdbeMakeLabel(v);
+	if (part_count > 0) {
+		int addr_same_part = sqlVdbeMakeLabel(v);
+		sqlVdbeAddOp4(v, OP_Compare, reg_peer_key, reg_key, part_count,
+			      (char *)part_key_info, P4_KEYINFO);
+		part_key_info = NULL;
+		int addr_jump = sqlVdbeCurrentAddr(v);
+		sqlVdbeAddOp3(v, OP_Jump, addr_jump + 1, addr_same_part,
+			      addr_jump + 1);
+		sqlVdbeAddOp2(v, OP_Gosub, reg_flush, addr_flush);
+		VdbeComment((v, "partition end"));
+		sqlVdbeAddOp2(v, OP_IfPos, reg_abort, addr_end);
+		resetAccumulator(parse, agg_info);
+		sqlVdbeAddOp2(v, OP_Integer, 0, reg_row_num);
+		sqlVdbeAddOp2(v, OP_Integer, 0, reg_dense_rank);
+		sqlVdbeGoto(v, addr_peer_key);
+		sqlVdbeResolveLabel(v, addr_same_part);
+	}
+	if (order_count > 0) {
+		int addr_same_peer = sqlVdbeMakeLabel(v);
+		sqlVdbeAddOp4(v, OP_Compare, reg_peer_key + part_count,
+			      reg_key + part_count, order_count,
+			      (char *)order_key_info, P4_KEYINFO);
+		order_key_info = NULL;
+		int addr_jump = sqlVdbeCurrentAddr(v);
+		sqlVdbeAddOp3(v, OP_Jump, addr_jump + 1, addr_same_peer,
+			      addr_jump + 1);
+		sqlVdbeAddOp2(v, OP_Gosub, reg_flush, addr_flush);
+		VdbeComment((v, "peer group end"));
+		sqlVdbeAddOp2(v, OP_IfPos, reg_abort, addr_end);
+		sqlVdbeResolveLabel(v, addr_peer_key);
+		sqlVdbeAddOp3(v, OP_Copy, reg_key, reg_peer_key,
+			      key_count - 1);
+		sqlVdbeResolveLabel(v, addr_same_peer);
+	} else {
+		sqlVdbeResolveLabel(v, addr_peer_key);
+		if (key_count > 0) {
+			sqlVdbeAddOp3(v, OP_Copy, reg_key, reg_peer_key,
+				      key_count - 1);
+		}
+	}
+	agg_info->useSortingIdx = 1;
+	agg_info->sortingIdxPTab = lead;
+	updateAccumulator(parse, agg_info);
+	if (parse->is_aborted)
+		goto error;
+	sqlVdbeAddOp2(v, OP_AddImm, reg_peer_rows, 1);
+	sqlVdbeAddOp2(v, OP_Next, lead, addr_top);
+	sqlVdbeAddOp2(v, OP_Gosub, reg_flush, addr_flush);
+	VdbeComment((v, "last peer group"));
+	sqlVdbeGoto(v, addr_end);
+
+	/*
+	 * The subroutine that computes the values of the window
+	 * functions for the current group of peers and emits its
+	 * rows reading them with the lag cursor.
+	 */
+	int addr_set_abort = sqlVdbeCurrentAddr(v);
+	sqlVdbeAddOp2(v, OP_Integer, 1, reg_abort);
+	sqlVdbeAddOp1(v, OP_Return, reg_flush);
+	sqlVdbeResolveLabel(v, addr_flush);
+	sqlExprCacheClear(parse);
+	int addr_flush_start = sqlVdbeCurrentAddr(v);
+	sqlVdbeAddOp2(v, OP_IfPos, reg_peer_rows, addr_flush_start + 2);
+	sqlVdbeAddOp1(v, OP_Return, reg_flush);
+	sqlVdbeAddOp2(v, OP_AddImm, reg_dense_rank, 1);
+	for (int i = 0; i < agg_info->nFunc; i++) {
+		struct AggInfo_func *func = &agg_info->aFunc[i];
+		int reg_value = reg_values + i;
+		if (sql_func_flag_is_set(func->func, SQL_FUNC_RANK)) {
+			sqlVdbeAddOp2(v, OP_Copy, reg_row_num, reg_value);
+			sqlVdbeAddOp2(v, OP_AddImm, reg_value, 1);
+		} else if (sql_func_flag_is_set(func->func,
+						SQL_FUNC_DENSE_RANK)) {
+			sqlVdbeAddOp2(v, OP_Copy, reg_dense_rank, reg_value);
+		} else if (!sql_func_flag_is_set(func->func,
+						 SQL_FUNC_ROW_NUMBER)) {
+			sqlVdbeAddOp2(v, OP_AggValue, func->iMem, reg_value);
+			sqlVdbeAppendP4(v, func->func, P4_FUNC);
+		}
+	}
+	int addr_next_row = sqlVdbeMakeLabel(v);
+	int addr_row_loop = sqlVdbeCurrentAddr(v);
+	sqlVdbeAddOp3(v, OP_IfPos, reg_peer_rows, addr_row_loop + 2, 1);
+	sqlVdbeAddOp1(v, OP_Return, reg_flush);
+	sqlVdbeAddOp2(v, OP_AddImm, reg_row_num, 1);
+	for (int i = 0; i < agg_info->nFunc; i++) {
+		struct AggInfo_func *func = &agg_info->aFunc[i];
+		if (sql_func_flag_is_set(func->func, SQL_FUNC_ROW_NUMBER))
+			sqlVdbeAddOp2(v, OP_Copy, reg_row_num, reg_values + i);
+		/*
+		 * Make the window functions of the result set
+		 * refer to the computed values instead of the
+		 * accumulators.
+		 */
+		func->iMem = reg_values + i;
+	}
+	agg_info->sortingIdxPTab = lag;
+	agg_info->directMode = 1;
+	sqlExprCacheClear(parse);
+	selectInnerLoop(parse, select, select->pEList, -1, sort, distinct,
+			dest, addr_next_row, addr_set_abort);
+	agg_info->directMode = 0;
+	sqlVdbeResolveLabel(v, addr_next_row);
+	sqlVdbeAddOp2(v, OP_Next, lag, addr_row_loop);
+	sqlVdbeGoto(v, addr_row_loop);
+	sqlVdbeResolveLabel(v, addr_end);
+	rc = parse->is_aborted ? -1 : 0;
+error:
+	sql_xfree(info);
+	sql_key_info_unref(part_key_info);
+	sql_key_info_unref(order_key_info);
+	sql_expr_list_delete(keys);
+	return rc;
+}
+
 /*
  * Generate code for the SELECT statement given in the p argument.
  *
@@ -5812,8 +6195,8 @@ sqlSelect(Parse * pParse,		/* The parser context */
 	 * written the query must use a temp-table for at least one of the ORDER
 	 * BY and DISTINCT, and an index or separate temp-table for the other.
 	 */
-	if ((p->selFlags & (SF_Distinct | SF_Aggregate)) == SF_Distinct
-	    && sqlExprListCompare(sSort.pOrderBy, pEList, -1) == 0) {
+	if ((p->selFlags & (SF_Distinct | SF_Aggregate | SF_Window)) ==
+	    SF_Distinct && sqlExprListCompare(sSort.pOrderBy, pEList, -1) == 0) {
 		p->selFlags &= ~SF_Distinct;
 		pGroupBy = sql_expr_list_dup(pEList, 0);
 		p->pGroupBy = pGroupBy;
@@ -5929,7 +6312,18 @@ sqlSelect(Parse * pParse,		/* The parser context */
 		sDistinct.eTnctType = WHERE_DISTINCT_NOOP;
 	}
 
-	if (!isAgg && pGroupBy == 0) {
+	if ((p->selFlags & SF_Window) != 0) {
+		if (isAgg || pGroupBy != NULL) {
+			diag_set(ClientError, ER_SQL_PARSER_GENERIC,
+				 "window functions can't be used together with "
+				 "GROUP BY or aggregate functions");
+			pParse->is_aborted = true;
+			goto select_end;
+		}
+		if (select_window(pParse, p, &sAggInfo, &sSort, &sDistinct,
+				  pDest) != 0)
+			goto select_end;
+	} else if (!isAgg && pGroupBy == 0) {
 		/* No aggregate functions and no GROUP BY clause */
 		u16 wctrlFlags = (sDistinct.isTnct ? WHERE_WANT_DISTINCT : 0);
 		assert(WHERE_USE_LIMIT == SF_FixedLimit);
@@ -1088,6 +1088,15 @@ struct type_def {
  * argument.
  */
 #define SQL_FUNC_DERIVEDCOLL 0x4000
+/** Built-in row_number() window function. */
+#define SQL_FUNC_ROW_NUMBER 0x0100
+/** Built-in rank() window function. */
+#define SQL_FUNC_RANK 0x0800
+/** Built-in dense_rank() window function. */
+#define SQL_FUNC_DENSE_RANK 0x8000
+/** Function can be called only as a window function. */
+#define SQL_FUNC_WINDOW \
+	(SQL_FUNC_ROW_NUMBER | SQL_FUNC_RANK | SQL_FUNC_DENSE_RANK)
 
 /*
  * Trim side mask components. TRIM_LEADING means to trim left side
@@ -1729,6 +1738,8 @@ struct NameContext {
 #define NC_MinMaxAgg 0x1000	/* min/max aggregates seen.  See note above */
 /** One or more identifiers are out of aggregate function. */
 #define NC_HasUnaggregatedId     0x2000
+/** One or more window functions seen. */
+#define NC_HasWindow 0x4000
 /*
  * An instance of the following structure contains all information
  * needed to generate code for a single SELECT statement.
@@ -1797,6 +1808,8 @@ struct Select {
 #define SF_Converted      0x10000	/* By convertCompoundSelectToSubquery() */
 /** Abort subquery if its output contains more than one row. */
 #define SF_SingleRow      0x20000
+/** Contains window functions. */
+#define SF_Window         0x40000
 
 /*
  * The results of a SELECT can be distributed in several ways, as defined
@@ -2609,6 +2622,39 @@ struct Expr *
 sql_and_expr_new(struct Expr *left_expr, struct Expr *right_expr);
 
 Expr *sqlExprFunction(Parse *, ExprList *, Token *);
+
+/**
+ * Create the window of a window function call. The window is a TK_OVER
+ * expression, which list is the PARTITION BY list and the left operand is
+ * a TK_ORDER expression holding the ORDER BY list. Both lists may be NULL.
+ *
+ * @param parse Parsing context.
+ * @param partition_by PARTITION BY list of the window.
+ * @param order_by ORDER BY list of the window.
+ * @retval New expression.
+ */
+struct Expr *
+sql_window_new(struct Parse *parse, struct ExprList *partition_by,
+	       struct ExprList *order_by);
+
+/**
+ * Attach the window created by sql_window_new() to the function call,
+ * which becomes a window function call. The window is stored as the right
+ * operand of the TK_FUNCTION expression.
+ */
+void
+sql_expr_attach_window(struct Parse *parse, struct Expr *func,
+		       struct Expr *window);
+
+/** Return the window of the function call or NULL if there is none. */
+static inline struct Expr *
+sql_expr_window(const struct Expr *expr)
+{
+	assert(expr->op == TK_FUNCTION || expr->op == TK_AGG_FUNCTION);
+	assert(expr->pRight == NULL || expr->pRight->op == TK_OVER);
+	return expr->pRight;
+}
+
 void sqlExprAssignVarNumber(Parse *, Expr *, u32);
 ExprList *sqlExprListAppendVector(Parse *, ExprList *, IdList *, Expr *);
 
@@ -51,6 +51,7 @@
 
 #include "msgpuck/msgpuck.h"
 #include "mpstream/mpstream.h"
+#include "PMurHash.h"
 
 #include "box/schema.h"
 #include "box/space.h"
@@ -308,7 +309,9 @@ vdbe_field_ref_fetch_data(struct vdbe_field_ref *field_ref, uint32_t fieldno)
 			 * Try to find the biggest initialized
 			 * slot.
 			 */
-			for (uint32_t it = fieldno - 1; it > prev; it--) {
+			uint32_t it = MIN(fieldno - 1,
+					  field_ref->rightmost_slot);
+			for (; it > prev; it--) {
 				if (field_ref->slots[it] == 0)
 					continue;
 				prev = it;
@@ -326,6 +329,8 @@ vdbe_field_ref_fetch_data(struct vdbe_field_ref *field_ref, uint32_t fieldno)
 	}
 	field_ref->slots[fieldno] = (uint32_t)(field_begin - field_ref->data);
 	bitmask64_set_bit(&field_ref->slot_bitmask, fieldno);
+	if (fieldno > field_ref->rightmost_slot)
+		field_ref->rightmost_slot = fieldno;
 	return field_begin;
 }
 
@@ -355,6 +360,73 @@ vdbe_field_ref_fetch(struct vdbe_field_ref *field_ref, uint32_t fieldno,
 	return 0;
 }
 
+/**
+ * Calculate the hash of COUNT values starting from MEMS that is used by
+ * bloom filters. Values that are equal have equal hashes: in particular, an
+ * integral DOUBLE is hashed the same way as the equal integer. Return false
+ * if one of the values has a type that is not supported by bloom filters.
+ */
+static bool
+vdbe_filter_hash(const struct Mem *mems, int count, uint32_t *hash)
+{
+	uint32_t h = 13, carry = 0, size = 0;
+	for (int i = 0; i < count; i++) {
+		const struct Mem *mem = &mems[i];
+		uint16_t type = mem->type;
+		const void *data = NULL;
+		uint32_t len = 0;
+		uint64_t u;
+		switch (mem->type) {
+		case MEM_TYPE_NULL:
+			break;
+		case MEM_TYPE_UINT:
+		case MEM_TYPE_INT:
+			u = mem->u.u;
+			data = &u;
+			len = sizeof(u);
+			break;
+		case MEM_TYPE_DOUBLE: {
+			double r = mem->u.r;
+			if (r >= 0 && r < 18446744073709551616.0 &&
+			    r == (double)(uint64_t)r) {
+				type = MEM_TYPE_UINT;
+				u = (uint64_t)r;
+			} else if (r < 0 && r >= -9223372036854775808.0 &&
+				   r == (double)(int64_t)r) {
+				type = MEM_TYPE_INT;
+				u = (uint64_t)(int64_t)r;
+			} else {
+				memcpy(&u, &r, sizeof(u));
+			}
+			data = &u;
+			len = sizeof(u);
+			break;
+		}
+		case MEM_TYPE_BOOL:
+			u = mem->u.b;
+			data = &u;
+			len = sizeof(u);
+			break;
+		case MEM_TYPE_STR:
+		case MEM_TYPE_BIN:
+			data = mem->z;
+			len = mem->n;
+			break;
+		case MEM_TYPE_UUID:
+			data = &mem->u.uuid;
+			len = sizeof(mem->u.uuid);
+			break;
+		default:
+			return false;
+		}
+		PMurHash32_Process(&h, &carry, &type, sizeof(type));
+		PMurHash32_Process(&h, &carry, data, len);
+		size += sizeof(type) + len;
+	}
+	*hash = PMurHash32_Result(h, carry, size);
+	return true;
+}
+
 /*
  * Execute as much of a VDBE program as we can.
  * This is the core of sql_step().
@@ -1807,6 +1879,57 @@ case OP_Once: {             /* jump */
 	break;
 }
 
+/* Opcode: FilterInit P1 P2 * * *
+ * Synopsis: filter(r[P1])=zeroblob(P2)
+ *
+ * Initialize register P1 as an empty bloom filter of P2 bytes.
+ */
+case OP_FilterInit: {
+	pOut = vdbe_prepare_null_out(p, pOp->p1);
+	assert(pOp->p2 > 0);
+	mem_set_bin_allocated(pOut, sql_xmalloc0(pOp->p2), pOp->p2);
+	break;
+}
+
+/* Opcode: FilterAdd P1 * P3 P4 *
+ * Synopsis: filter(r[P1]) += key(r[P3@P4])
+ *
+ * Compute the hash of P4 registers starting with r[P3] and add it to the
+ * bloom filter stored in register P1. If the hash cannot be computed, fill
+ * the filter so that it never rejects a key.
+ */
+case OP_FilterAdd: {
+	pIn1 = &aMem[pOp->p1];
+	assert(mem_is_bin(pIn1));
+	uint32_t h;
+	if (!vdbe_filter_hash(&aMem[pOp->p3], pOp->p4.i, &h)) {
+		memset(pIn1->z, 0xff, pIn1->n);
+		break;
+	}
+	uint64_t bit = h % ((uint64_t)pIn1->n * 8);
+	pIn1->z[bit / 8] |= 1 << (bit % 8);
+	break;
+}
+
+/* Opcode: Filter P1 P2 P3 P4 *
+ * Synopsis: if key(r[P3@P4]) not in filter(r[P1]) goto P2
+ *
+ * Compute the hash of P4 registers starting with r[P3] and jump to P2 if
+ * the hash is definitely not in the bloom filter stored in register P1.
+ * Fall through if the hash might be in the filter or cannot be computed.
+ */
+case OP_Filter: {          /* jump */
+	pIn1 = &aMem[pOp->p1];
+	assert(mem_is_bin(pIn1));
+	uint32_t h;
+	if (!vdbe_filter_hash(&aMem[pOp->p3], pOp->p4.i, &h))
+		break;
+	uint64_t bit = h % ((uint64_t)pIn1->n * 8);
+	if ((pIn1->z[bit / 8] & (1 << (bit % 8))) == 0)
+		goto jump_to_p2;
+	break;
+}
+
 /* Opcode: If P1 P2 P3 * *
  *
  * Jump to P2 if the value in register P1 is true. If the value
@@ -2449,6 +2572,8 @@ case OP_IteratorOpen: {
 
 	struct index *index = space_index(space, pOp->p2);
 	assert(index != NULL);
+	if (index_check_built(index) != 0)
+		goto abort_due_to_error;
 	assert(pOp->p1 >= 0);
 	cur = allocateCursor(p, pOp->p1,
 			     space->def->exact_field_count == 0 ?
@@ -3260,6 +3385,24 @@ case OP_NullRow: {
 	break;
 }
 
+/* Opcode: CursorFilter P1 P2 P3 P4 P5
+ * Synopsis: filter(P1)[P5]: field P2 op(P4) r[P3]
+ *
+ * Set filter number P5 of Tarantool cursor P1: while the cursor scans
+ * the space after Rewind or Last, it skips tuples for which the
+ * comparison of field P2 with register P3 using comparison opcode P4
+ * (Eq, Lt, Le, Gt or Ge) is definitely not true. Register P3 must not
+ * change until the cursor is closed.
+ */
+case OP_CursorFilter: {
+	assert(pOp->p1 >= 0 && pOp->p1 < p->nCursor);
+	VdbeCursor *pC = p->apCsr[pOp->p1];
+	assert(pC != NULL && pC->eCurType == CURTYPE_TARANTOOL);
+	sql_cursor_set_filter(pC->uc.pCursor, pOp->p5, pOp->p2, pOp->p4.i,
+			      &aMem[pOp->p3]);
+	break;
+}
+
 /* Opcode: Last P1 P2 P3 * *
  *
  * The next use of the Column or Prev instruction for P1
@@ -3502,12 +3645,16 @@ case OP_Next:          /* jump */
 	break;
 }
 
-/* Opcode: SorterInsert P1 P2 * * *
+/* Opcode: SorterInsert P1 P2 P3 * *
  * Synopsis: key=r[P2]
  *
  * Register P2 holds an SQL index key made using the
  * MakeRecord instructions.  This opcode writes that key
  * into the sorter P1.  Data for the entry is nil.
+ *
+ * If P3 is not zero, register P3 holds the number of first
+ * records in sort order that are going to be read from the
+ * sorter, so the sorter may drop the others.
  */
 case OP_SorterInsert: {      /* in2 */
 	assert(pOp->p1 >= 0 && pOp->p1 < p->nCursor);
@@ -3516,7 +3663,12 @@ case OP_SorterInsert: {      /* in2 */
 	assert(isSorter(cursor));
 	pIn2 = &aMem[pOp->p2];
 	assert(mem_is_bin(pIn2));
-	if (sqlVdbeSorterWrite(cursor, pIn2) != 0)
+	uint64_t limit = 0;
+	if (pOp->p3 != 0) {
+		assert(mem_is_uint(&aMem[pOp->p3]));
+		limit = aMem[pOp->p3].u.u;
+	}
+	if (sqlVdbeSorterWrite(cursor, pIn2, limit) != 0)
 		goto abort_due_to_error;
 	break;
 }
@@ -4292,6 +4444,28 @@ case OP_AggFinal: {
 	break;
 }
 
+/* Opcode: AggValue P1 P2 * P4 *
+ * Synopsis: r[P2]=value(accum=r[P1])
+ *
+ * Store the current value of an aggregate to register P2. P1 is the memory
+ * location that is the accumulator for the aggregate. Unlike AggFinal, the
+ * accumulator is not changed, so the aggregate can be stepped further. P4
+ * is a pointer to the function.
+ */
+case OP_AggValue: {
+	assert(pOp->p1 > 0 && pOp->p1 <= (p->nMem + 1 - p->nCursor));
+	struct func_sql_builtin *func = (struct func_sql_builtin *)pOp->p4.func;
+	pOut = vdbe_prepare_null_out(p, pOp->p2);
+	if (mem_copy(pOut, &aMem[pOp->p1]) != 0)
+		goto abort_due_to_error;
+	if (func->finalize != NULL && func->finalize(pOut) != 0)
+		goto abort_due_to_error;
+	UPDATE_MAX_BLOBSIZE(pOut);
+	if (sqlVdbeMemTooBig(pOut) != 0)
+		goto too_big;
+	break;
+}
+
 /* Opcode: Expire P1 * * * *
  *
  * Cause precompiled statements to expire.
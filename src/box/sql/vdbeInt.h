@@ -375,7 +375,15 @@ int
 sqlVdbeSorterNext(const struct VdbeCursor *pCsr, int *pbEof);
 
 int sqlVdbeSorterRewind(const VdbeCursor *, int *);
-int sqlVdbeSorterWrite(const VdbeCursor *, Mem *);
+
+/**
+ * Add a record to the sorter. If limit is not 0, only the first limit
+ * records in sort order are needed, so the sorter may drop the others.
+ */
+int
+sqlVdbeSorterWrite(const struct VdbeCursor *pCsr, struct Mem *pVal,
+		   uint64_t limit);
+
 int sqlVdbeSorterCompare(const VdbeCursor *, Mem *, int, int *);
 
 int sqlVdbeMemTranslate(Mem *, u8);
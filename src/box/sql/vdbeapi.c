@@ -570,6 +570,13 @@ sql_stmt_busy(const struct Vdbe *v)
 	return v->magic == VDBE_MAGIC_RUN && v->pc >= 0;
 }
 
+uint32_t
+sql_stmt_sql_flags(const struct Vdbe *v)
+{
+	assert(v != NULL);
+	return v->sql_flags;
+}
+
 const char *
 sql_sql(struct Vdbe *p)
 {
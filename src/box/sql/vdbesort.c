@@ -315,6 +315,8 @@ struct VdbeSorter {
 	SorterList list;	/* List of in-memory records */
 	int iMemory;		/* Offset of free space in list.aMemory */
 	int nMemory;		/* Size of list.aMemory allocation in bytes */
+	/** Number of records in list. */
+	uint64_t nRecord;
 	u8 bUsePMA;		/* True if one or more PMAs created */
 	SortSubtask aTask;	/* A single subtask */
 };
@@ -916,6 +918,7 @@ sqlVdbeSorterReset(struct VdbeSorter *pSorter)
 	pSorter->list.szPMA = 0;
 	pSorter->bUsePMA = 0;
 	pSorter->iMemory = 0;
+	pSorter->nRecord = 0;
 	pSorter->mxKeysize = 0;
 	sql_xfree(pSorter->pUnpacked);
 	pSorter->pUnpacked = 0;
@@ -1365,16 +1368,77 @@ static int
 vdbeSorterFlushPMA(VdbeSorter * pSorter)
 {
 	pSorter->bUsePMA = 1;
+	pSorter->nRecord = 0;
 	return vdbeSorterListToPMA(&pSorter->aTask, &pSorter->list);
 }
 
 /*
- * Add a record to the sorter.
+ * Minimal number of records the in-memory list of a sorter with a limit
+ * may hold above the limit before it is pruned.
  */
+#define SORTER_PRUNE_MIN 256
+
+/*
+ * Sort the in-memory list of records and drop all of them except the
+ * first nLimit ones. Records kept in list.aMemory are moved to
+ * a new allocation so that the memory of the dropped ones is reused.
+ * This bounds the memory used by ORDER BY ... LIMIT by about twice the
+ * limit instead of the whole input.
+ */
+static int
+vdbeSorterPrune(VdbeSorter * pSorter, uint64_t nLimit)
+{
+	SorterList *pList = &pSorter->list;
+	int rc = vdbeSorterSort(&pSorter->aTask, pList);
+	if (rc != 0)
+		return rc;
+	u8 *aMemory = NULL;
+	int iMemory = 0;
+	if (pList->aMemory != NULL)
+		aMemory = xmalloc(pSorter->nMemory);
+	SorterRecord *pKept = NULL;
+	int szPMA = 0;
+	uint64_t nRecord = 0;
+	SorterRecord *p = pList->pList;
+	while (p != NULL) {
+		/* The sorted list is linked with u.pNext pointers. */
+		SorterRecord *pNext = p->u.pNext;
+		if (nRecord == nLimit) {
+			if (aMemory == NULL)
+				free(p);
+			p = pNext;
+			continue;
+		}
+		nRecord++;
+		szPMA += p->nVal + sqlVarintLen(p->nVal);
+		if (aMemory != NULL) {
+			int nReq = p->nVal + sizeof(SorterRecord);
+			SorterRecord *pNew = (SorterRecord *)&aMemory[iMemory];
+			memcpy(pNew, p, nReq);
+			if (pKept != NULL)
+				pNew->u.iNext = (int)((u8 *)pKept - aMemory);
+			pKept = pNew;
+			iMemory += ROUND8(nReq);
+		} else {
+			p->u.pNext = pKept;
+			pKept = p;
+		}
+		p = pNext;
+	}
+	if (aMemory != NULL) {
+		free(pList->aMemory);
+		pList->aMemory = aMemory;
+		pSorter->iMemory = iMemory;
+	}
+	pList->pList = pKept;
+	pList->szPMA = szPMA;
+	pSorter->nRecord = nRecord;
+	return 0;
+}
+
 int
-sqlVdbeSorterWrite(const VdbeCursor * pCsr,	/* Sorter cursor */
-		       Mem * pVal	/* Memory cell containing record */
-    )
+sqlVdbeSorterWrite(const struct VdbeCursor *pCsr, struct Mem *pVal,
+		   uint64_t limit)
 {
 	VdbeSorter *pSorter;
 	int rc = 0;	/* Return Code */
@@ -1460,7 +1524,11 @@ sqlVdbeSorterWrite(const VdbeCursor * pCsr,	/* Sorter cursor */
 	memcpy(SRVAL(pNew), pVal->z, pVal->n);
 	pNew->nVal = pVal->n;
 	pSorter->list.pList = pNew;
+	pSorter->nRecord++;
 
+	if (rc == 0 && limit != 0 &&
+	    pSorter->nRecord >= limit + MAX(limit, SORTER_PRUNE_MIN))
+		rc = vdbeSorterPrune(pSorter, limit);
 	return rc;
 }
 
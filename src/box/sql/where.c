@@ -712,6 +712,48 @@ termCanDriveIndex(WhereTerm * pTerm,	/* WHERE clause term to check */
 	return 1;
 }
 
+/** Min size of a bloom filter of an automatic index, in bytes. */
+enum { WHERE_FILTER_SIZE_MIN = 10000 };
+/** Max size of a bloom filter of an automatic index, in bytes. */
+enum { WHERE_FILTER_SIZE_MAX = 10000000 };
+
+/**
+ * Check if a bloom filter can be built for the equality key parts of an
+ * automatic index. The filter hashes values byte-wise, so it can only be
+ * used if neither key parts nor comparisons driving the index have a
+ * collation and the key part types are such that equal values have equal
+ * hashes.
+ */
+static bool
+where_filter_is_supported(struct Parse *parse, const struct WhereLoop *loop,
+			  const struct key_def *key_def)
+{
+	for (uint32_t i = 0; i < loop->nEq; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		if (part->coll != NULL)
+			return false;
+		struct Expr *expr = loop->aLTerm[i]->pExpr;
+		uint32_t coll_id;
+		if (sql_binary_compare_coll_seq(parse, expr->pLeft,
+						expr->pRight, &coll_id) != 0 ||
+		    coll_id != COLL_NONE)
+			return false;
+		switch (part->type) {
+		case FIELD_TYPE_UNSIGNED:
+		case FIELD_TYPE_INTEGER:
+		case FIELD_TYPE_DOUBLE:
+		case FIELD_TYPE_STRING:
+		case FIELD_TYPE_VARBINARY:
+		case FIELD_TYPE_BOOLEAN:
+		case FIELD_TYPE_UUID:
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  * Generate a code that will create a tuple, which is supposed to be inserted
  * in the ephemeral index space. The created tuple consists of rowid and
@@ -722,11 +764,14 @@ termCanDriveIndex(WhereTerm * pTerm,	/* WHERE clause term to check */
  * @param cursor Cursor of source space from which values for tuple are fetched.
  * @param reg_out Register to contain the created tuple.
  * @param reg_eph Register holding pointer to ephemeral index.
+ * @param reg_filter Register holding the bloom filter of the index or 0.
+ * @param eq_count Number of key parts added to the bloom filter.
  */
 static void
 vdbe_emit_ephemeral_index_tuple(struct Parse *parse,
 				const struct key_def *key_def, int cursor,
-				int reg_out, int reg_eph)
+				int reg_out, int reg_eph, int reg_filter,
+				int eq_count)
 {
 	assert(reg_out != 0);
 	struct Vdbe *v = parse->pVdbe;
@@ -736,6 +781,10 @@ vdbe_emit_ephemeral_index_tuple(struct Parse *parse,
 		uint32_t tabl_col = key_def->parts[j].fieldno;
 		sqlVdbeAddOp3(v, OP_Column, cursor, tabl_col, reg_base + j);
 	}
+	if (reg_filter != 0) {
+		sqlVdbeAddOp4Int(v, OP_FilterAdd, reg_filter, 0, reg_base,
+				 eq_count);
+	}
 	sqlVdbeAddOp2(v, OP_NextIdEphemeral, reg_eph, reg_base + col_cnt);
 	sqlVdbeAddOp3(v, OP_MakeRecord, reg_base, col_cnt + 1, reg_out);
 	sqlReleaseTempRange(parse, reg_base, col_cnt + 1);
@@ -915,6 +964,19 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	sqlVdbeAddOp3(v, OP_IteratorOpen, pLevel->iIdxCur, 0, reg_eph);
 	VdbeComment((v, "for %s", space->def->name));
 
+	/*
+	 * Create a bloom filter for the equality key parts so that probes
+	 * for keys missing in the automatic index skip the index seek.
+	 * The filter takes about one byte per row of the source space.
+	 */
+	if (where_filter_is_supported(pParse, pLoop, idx_def->key_def)) {
+		uint64_t size = sqlLogEstToInt(sql_space_tuple_log_count(space));
+		size = MAX(size, (uint64_t)WHERE_FILTER_SIZE_MIN);
+		size = MIN(size, (uint64_t)WHERE_FILTER_SIZE_MAX);
+		pLevel->regFilter = ++pParse->nMem;
+		sqlVdbeAddOp2(v, OP_FilterInit, pLevel->regFilter, size);
+	}
+
 	/* Fill the automatic index with content */
 	sqlExprCachePush(pParse);
 	assert(pWC->pWInfo->pTabList->a[pLevel->iFrom].fg.viaCoroutine == 0);
@@ -922,7 +984,8 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	addrTop = sqlVdbeAddOp1(v, OP_Rewind, cursor);
 	regRecord = sqlGetTempReg(pParse);
 	vdbe_emit_ephemeral_index_tuple(pParse, idx_def->key_def, cursor,
-					regRecord, reg_eph);
+					regRecord, reg_eph, pLevel->regFilter,
+					pLoop->nEq);
 	sqlVdbeAddOp2(v, OP_IdxInsert, regRecord, reg_eph);
 	sqlVdbeAddOp2(v, OP_Next, cursor, addrTop + 1);
 	sqlVdbeChangeP5(v, SQL_STMTSTATUS_AUTOINDEX);
@@ -2207,7 +2270,9 @@ whereLoopAddBtree(WhereLoopBuilder * pBuilder,	/* WHERE clause information */
 		if (i > 0)
 			probe = space->index[i]->def;
 		/* Such index may possibly contain not all tuples, so skip it */
-		if (pSrc->pIBIndex == NULL && probe->key_def->has_exclude_null)
+		if (pSrc->pIBIndex == NULL &&
+		    (probe->key_def->has_exclude_null ||
+		     probe->key_def->has_filter))
 			continue;
 		rSize = index_field_tuple_est(probe, 0);
 		pNew->nEq = 0;
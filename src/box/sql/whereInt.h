@@ -80,6 +80,7 @@ struct WhereLevel {
 	int iLeftJoin;		/* Memory cell used to implement LEFT OUTER JOIN */
 	int iTabCur;		/* The VDBE cursor used to access the table */
 	int iIdxCur;		/* The VDBE cursor used to access pIdx */
+	int regFilter;		/* Bloom filter for the automatic index or 0 */
 	int addrBrk;		/* Jump here to break out of the loop */
 	int addrNxt;		/* Jump here to start the next IN combination */
 	int addrSkip;		/* Jump here for next iteration of skip-scan */
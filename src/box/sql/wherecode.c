@@ -38,6 +38,7 @@
  * that actually generate the bulk of the WHERE loop code.  The original where.c
  * file retains the code that does query planning and analysis.
  */
+#include "box/coll_id.h"
 #include "box/schema.h"
 #include "sqlInt.h"
 #include "whereInt.h"
@@ -658,6 +659,68 @@ codeExprOrVector(Parse * pParse, Expr * p, int iReg, int nReg)
 	}
 }
 
+/**
+ * Push comparisons of columns of the table with cursor @a tab_cursor
+ * and constants down to cursor @a cursor, which scans the whole table,
+ * so that it skips tuples that definitely do not satisfy them without
+ * passing them to VDBE. The comparisons are still coded as usual, so
+ * the cursor may pass extra tuples.
+ */
+static void
+where_push_cursor_filters(struct WhereInfo *winfo, struct WhereLevel *level,
+			  int tab_cursor, int cursor)
+{
+	struct Parse *parse = winfo->pParse;
+	if (level->iLeftJoin != 0 || !ConstFactorOk(parse))
+		return;
+	struct Vdbe *v = parse->pVdbe;
+	struct WhereClause *wc = &winfo->sWC;
+	uint32_t slot = 0;
+	for (int i = 0; i < wc->nTerm && slot < CURSOR_FILTER_MAX; i++) {
+		struct WhereTerm *term = &wc->a[i];
+		if ((term->wtFlags & (TERM_VIRTUAL | TERM_CODED)) != 0)
+			continue;
+		struct Expr *expr = term->pExpr;
+		int op;
+		switch (expr->op) {
+		case TK_EQ:
+			op = OP_Eq;
+			break;
+		case TK_LT:
+			op = OP_Lt;
+			break;
+		case TK_LE:
+			op = OP_Le;
+			break;
+		case TK_GT:
+			op = OP_Gt;
+			break;
+		case TK_GE:
+			op = OP_Ge;
+			break;
+		default:
+			continue;
+		}
+		struct Expr *left = expr->pLeft;
+		struct Expr *right = expr->pRight;
+		if (left->op != TK_COLUMN_REF || left->iTable != tab_cursor ||
+		    left->iColumn < 0 || right->op == TK_REGISTER ||
+		    !sqlExprIsConstantNotJoin(right))
+			continue;
+		uint32_t coll_id;
+		if (sql_binary_compare_coll_seq(parse, left, right,
+						&coll_id) != 0 ||
+		    coll_id != COLL_NONE)
+			continue;
+		int reg_free;
+		int reg = sqlExprCodeTemp(parse, right, &reg_free);
+		assert(reg_free == 0);
+		sqlVdbeAddOp4Int(v, OP_CursorFilter, cursor, left->iColumn,
+				 reg, op);
+		sqlVdbeChangeP5(v, slot++);
+	}
+}
+
 /*
  * Generate code for the start of the iLevel-th loop in the WHERE clause
  * implementation described by pWInfo.
@@ -798,6 +861,8 @@ sqlWhereCodeOneLoopStart(WhereInfo * pWInfo,	/* Complete information about the W
 		assert(space->def->field_count != 0);
 		iIdxCur = pLevel->iIdxCur;
 		assert(nEq >= pLoop->nSkip);
+		if ((pLoop->wsFlags & WHERE_CONSTRAINT) == 0)
+			where_push_cursor_filters(pWInfo, pLevel, iCur, iIdxCur);
 
 		/* If this loop satisfies a sort order (pOrderBy) request that
 		 * was passed to this function to implement a "SELECT min(x) ..."
@@ -913,6 +978,15 @@ sqlWhereCodeOneLoopStart(WhereInfo * pWInfo,	/* Complete information about the W
 			op = aStartOp[(start_constraints << 2) +
 				      (startEq << 1) + bRev];
 			assert(op != 0);
+			/*
+			 * Skip the seek if the bloom filter of the
+			 * automatic index says there is no match.
+			 */
+			if (pLevel->regFilter != 0) {
+				sqlVdbeAddOp4Int(v, OP_Filter,
+						 pLevel->regFilter, addrNxt,
+						 regBase, nEq);
+			}
 			sqlVdbeAddOp4Int(v, op, iIdxCur, addrNxt, regBase,
 					     nConstraint);
 		}
@@ -1291,6 +1365,7 @@ sqlWhereCodeOneLoopStart(WhereInfo * pWInfo,	/* Complete information about the W
 			 */
 			pLevel->op = OP_Noop;
 		} else {
+			where_push_cursor_filters(pWInfo, pLevel, iCur, iCur);
 			pLevel->op = aStep[bRev];
 			pLevel->p1 = iCur;
 			pLevel->p2 =
@@ -44,6 +44,9 @@ sql_stmt_cache_init(void)
 	sql_stmt_cache.hash = mh_i32ptr_new();
 	sql_stmt_cache.mem_quota = 0;
 	sql_stmt_cache.mem_used = 0;
+	sql_stmt_cache.hits = 0;
+	sql_stmt_cache.misses = 0;
+	sql_stmt_cache.compile_time = 0;
 	rlist_create(&sql_stmt_cache.gc_queue);
 }
 
@@ -58,10 +61,26 @@ sql_stmt_cache_stat(struct info_handler *h)
 	mh_foreach(sql_stmt_cache.hash, i)
 		entry_count++;
 	info_append_int(h, "stmt_count", entry_count);
+	info_append_int(h, "hits", sql_stmt_cache.hits);
+	info_append_int(h, "misses", sql_stmt_cache.misses);
+	info_append_double(h, "compile_time", sql_stmt_cache.compile_time);
 	info_table_end(h);
 	info_end(h);
 }
 
+void
+sql_stmt_cache_hit(void)
+{
+	sql_stmt_cache.hits++;
+}
+
+void
+sql_stmt_cache_miss(double compile_time)
+{
+	sql_stmt_cache.misses++;
+	sql_stmt_cache.compile_time += compile_time;
+}
+
 static size_t
 sql_cache_entry_sizeof(struct Vdbe *stmt)
 {
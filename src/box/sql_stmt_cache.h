@@ -81,6 +81,12 @@ struct sql_stmt_cache {
 	 * times.
 	 */
 	struct stmt_cache_entry *last_found;
+	/** Number of times a compiled statement was reused. */
+	uint64_t hits;
+	/** Number of times a statement had to be compiled. */
+	uint64_t misses;
+	/** Total time spent compiling statements, in seconds. */
+	double compile_time;
 };
 
 /**
@@ -91,12 +97,24 @@ void
 sql_stmt_cache_init(void);
 
 /**
- * Store statistics concerning cache (current size and number
- * of statements in it) into info handler @h.
+ * Store statistics concerning cache (current size, number
+ * of statements in it, hits, misses and compilation time)
+ * into info handler @h.
  */
 void
 sql_stmt_cache_stat(struct info_handler *h);
 
+/** Account reuse of a compiled statement. */
+void
+sql_stmt_cache_hit(void);
+
+/**
+ * Account compilation of a statement that took @a compile_time
+ * seconds.
+ */
+void
+sql_stmt_cache_miss(double compile_time);
+
 /**
  * Erase session local hash: unref statements belong to this
  * session and deallocate hash itself.
@@ -243,51 +243,41 @@ tuple_next(struct tuple_iterator *it)
  */
 enum { TUPLE_UPLOAD_REFS = TUPLE_LOCAL_REF_MAX / 2 + 1 };
 
-/** Convenient helper for hash table. */
-static uint32_t
-tuple_ref_get_uploaded_refs(struct tuple *tuple)
+/**
+ * Returns the external storage of the reference counter of a tuple
+ * that has uploaded references. The counter is updated in place so
+ * that uploading or acquiring references takes a single hash lookup.
+ */
+static struct tuple_uploaded_refs *
+tuple_ref_find_uploaded_refs(struct tuple *tuple, mh_int_t *pos)
 {
-	if (!tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS))
-		return 0;
-	mh_int_t pos = mh_tuple_uploaded_refs_find(tuple_uploaded_refs, tuple,
-						   0);
-	assert(pos != mh_end(tuple_uploaded_refs));
+	assert(tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS));
+	*pos = mh_tuple_uploaded_refs_find(tuple_uploaded_refs, tuple, 0);
+	assert(*pos != mh_end(tuple_uploaded_refs));
 	struct tuple_uploaded_refs *uploaded =
-		mh_tuple_uploaded_refs_node(tuple_uploaded_refs, pos);
+		mh_tuple_uploaded_refs_node(tuple_uploaded_refs, *pos);
 	assert(uploaded->tuple == tuple);
 	assert(uploaded->refs >= TUPLE_UPLOAD_REFS);
 	assert(uploaded->refs % TUPLE_UPLOAD_REFS == 0);
-	return uploaded->refs;
-}
-
-/** Convenient helper for hash table. */
-static void
-tuple_ref_set_uploaded_refs(struct tuple *tuple, uint32_t refs)
-{
-	struct tuple_uploaded_refs put;
-	put.tuple = tuple;
-	put.refs = refs;
-	mh_tuple_uploaded_refs_put(tuple_uploaded_refs, &put, NULL, 0);
-}
-
-/** Convenient helper for hash table. */
-static void
-tuple_ref_drop_uploaded_refs(struct tuple *tuple)
-{
-	assert(tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS));
-	mh_int_t pos = mh_tuple_uploaded_refs_find(tuple_uploaded_refs, tuple,
-						   0);
-	assert(pos != mh_end(tuple_uploaded_refs));
-	mh_tuple_uploaded_refs_del(tuple_uploaded_refs, pos, 0);
+	return uploaded;
 }
 
 void
 tuple_upload_refs(struct tuple *tuple)
 {
 	assert(tuple->local_refs == TUPLE_LOCAL_REF_MAX);
-	uint32_t refs = tuple_ref_get_uploaded_refs(tuple);
-	tuple_ref_set_uploaded_refs(tuple, refs + TUPLE_UPLOAD_REFS);
-	tuple_set_flag(tuple, TUPLE_HAS_UPLOADED_REFS);
+	if (tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS)) {
+		mh_int_t pos;
+		struct tuple_uploaded_refs *uploaded =
+			tuple_ref_find_uploaded_refs(tuple, &pos);
+		uploaded->refs += TUPLE_UPLOAD_REFS;
+	} else {
+		struct tuple_uploaded_refs put;
+		put.tuple = tuple;
+		put.refs = TUPLE_UPLOAD_REFS;
+		mh_tuple_uploaded_refs_put(tuple_uploaded_refs, &put, NULL, 0);
+		tuple_set_flag(tuple, TUPLE_HAS_UPLOADED_REFS);
+	}
 	tuple->local_refs -= TUPLE_UPLOAD_REFS;
 }
 
@@ -295,13 +285,14 @@ void
 tuple_acquire_refs(struct tuple *tuple)
 {
 	assert(tuple->local_refs == 0);
-	assert(tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS));
-	uint32_t refs = tuple_ref_get_uploaded_refs(tuple);
-	if (refs == TUPLE_UPLOAD_REFS) {
-		tuple_ref_drop_uploaded_refs(tuple);
+	mh_int_t pos;
+	struct tuple_uploaded_refs *uploaded =
+		tuple_ref_find_uploaded_refs(tuple, &pos);
+	if (uploaded->refs == TUPLE_UPLOAD_REFS) {
+		mh_tuple_uploaded_refs_del(tuple_uploaded_refs, pos, 0);
 		tuple_clear_flag(tuple, TUPLE_HAS_UPLOADED_REFS);
 	} else {
-		tuple_ref_set_uploaded_refs(tuple, refs - TUPLE_UPLOAD_REFS);
+		uploaded->refs -= TUPLE_UPLOAD_REFS;
 	}
 	tuple->local_refs += TUPLE_UPLOAD_REFS;
 }
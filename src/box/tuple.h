@@ -639,6 +639,17 @@ tuple_is_unreferenced(struct tuple *tuple)
 	return tuple->local_refs == 0;
 }
 
+/**
+ * Check that the tuple has exactly one reference, i.e. nobody except its
+ * owner (for example, a space) uses it.
+ */
+static inline bool
+tuple_has_single_ref(struct tuple *tuple)
+{
+	return tuple->local_refs == 1 &&
+	       !tuple_has_flag(tuple, TUPLE_HAS_UPLOADED_REFS);
+}
+
 /** Check that the tuple is in compact mode. */
 static inline bool
 tuple_is_compact(struct tuple *tuple)
@@ -42,6 +42,7 @@
 #include "key_def.h"
 #include "tuple.h"
 #include "salad/bloom.h"
+#include "salad/xor_filter.h"
 #include "trivia/util.h"
 #include <PMurHash.h>
 
@@ -150,20 +151,78 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 	return 0;
 }
 
-struct tuple_bloom *
-tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
+/** Return the expected false positive rate of a partial key filter. */
+static double
+tuple_bloom_part_fpr(const struct tuple_bloom *bloom, uint32_t i,
+		     uint32_t count)
+{
+	if (bloom->is_xor)
+		return xor_filter_fpr(&bloom->parts[i].xor_filter);
+	return bloom_fpr(&bloom->parts[i].bloom, count);
+}
+
+/** Check if a hash is stored in a partial key filter. */
+static inline bool
+tuple_bloom_part_maybe_has(const struct tuple_bloom *bloom, uint32_t i,
+			   uint32_t hash)
+{
+	if (bloom->is_xor)
+		return xor_filter_maybe_has(&bloom->parts[i].xor_filter, hash);
+	return bloom_maybe_has(&bloom->parts[i].bloom, hash);
+}
+
+/** Allocate an empty tuple bloom filter. */
+static struct tuple_bloom *
+tuple_bloom_alloc(uint32_t part_count, bool is_xor)
 {
-	uint32_t part_count = builder->part_count;
 	size_t size = sizeof(struct tuple_bloom) +
-			part_count * sizeof(struct bloom);
+			part_count * sizeof(union tuple_bloom_part);
 	struct tuple_bloom *bloom = malloc(size);
 	if (bloom == NULL) {
 		diag_set(OutOfMemory, size, "malloc", "tuple bloom");
 		return NULL;
 	}
-
 	bloom->is_legacy = false;
+	bloom->is_xor = is_xor;
 	bloom->part_count = 0;
+	return bloom;
+}
+
+struct tuple_bloom *
+tuple_bloom_new_xor(struct tuple_bloom_builder *builder, double fpr)
+{
+	uint32_t part_count = builder->part_count;
+	struct tuple_bloom *bloom = tuple_bloom_alloc(part_count, true);
+	if (bloom == NULL)
+		return NULL;
+
+	for (uint32_t i = 0; i < part_count; i++) {
+		struct tuple_hash_array *hash_arr = &builder->parts[i];
+		/* See the comment in tuple_bloom_new(). */
+		double part_fpr = fpr;
+		for (uint32_t j = 0; j < i; j++)
+			part_fpr /= tuple_bloom_part_fpr(bloom, j, 0);
+		part_fpr = MIN(part_fpr, 0.5);
+		if (xor_filter_create(&bloom->parts[i].xor_filter,
+				      hash_arr->values, hash_arr->count,
+				      part_fpr) != 0) {
+			diag_set(OutOfMemory, 0, "xor_filter_create",
+				 "tuple bloom part");
+			tuple_bloom_delete(bloom);
+			return NULL;
+		}
+		bloom->part_count++;
+	}
+	return bloom;
+}
+
+struct tuple_bloom *
+tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
+{
+	uint32_t part_count = builder->part_count;
+	struct tuple_bloom *bloom = tuple_bloom_alloc(part_count, false);
+	if (bloom == NULL)
+		return NULL;
 
 	for (uint32_t i = 0; i < part_count; i++) {
 		struct tuple_hash_array *hash_arr = &builder->parts[i];
@@ -178,9 +237,10 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 		 */
 		double part_fpr = fpr;
 		for (uint32_t j = 0; j < i; j++)
-			part_fpr /= bloom_fpr(&bloom->parts[j], count);
+			part_fpr /= tuple_bloom_part_fpr(bloom, j, count);
 		part_fpr = MIN(part_fpr, 0.5);
-		if (bloom_create(&bloom->parts[i], count, part_fpr) != 0) {
+		if (bloom_create(&bloom->parts[i].bloom, count,
+				 part_fpr) != 0) {
 			diag_set(OutOfMemory, 0, "bloom_create",
 				 "tuple bloom part");
 			tuple_bloom_delete(bloom);
@@ -188,7 +248,7 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 		}
 		bloom->part_count++;
 		for (uint32_t k = 0; k < count; k++)
-			bloom_add(&bloom->parts[i], hash_arr->values[k]);
+			bloom_add(&bloom->parts[i].bloom, hash_arr->values[k]);
 	}
 	return bloom;
 }
@@ -196,8 +256,12 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 void
 tuple_bloom_delete(struct tuple_bloom *bloom)
 {
-	for (uint32_t i = 0; i < bloom->part_count; i++)
-		bloom_destroy(&bloom->parts[i]);
+	for (uint32_t i = 0; i < bloom->part_count; i++) {
+		if (bloom->is_xor)
+			xor_filter_destroy(&bloom->parts[i].xor_filter);
+		else
+			bloom_destroy(&bloom->parts[i].bloom);
+	}
 	free(bloom);
 }
 
@@ -208,7 +272,7 @@ tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 	assert(!key_def->is_multikey || multikey_idx != MULTIKEY_NONE);
 
 	if (bloom->is_legacy) {
-		return bloom_maybe_has(&bloom->parts[0],
+		return bloom_maybe_has(&bloom->parts[0].bloom,
 				       tuple_hash(tuple, key_def));
 	}
 
@@ -223,7 +287,7 @@ tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 						  &key_def->parts[i],
 						  multikey_idx);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		if (!tuple_bloom_part_maybe_has(bloom, i, hash))
 			return false;
 	}
 	return true;
@@ -237,7 +301,7 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 	if (bloom->is_legacy) {
 		if (part_count < key_def->part_count)
 			return true;
-		return bloom_maybe_has(&bloom->parts[0],
+		return bloom_maybe_has(&bloom->parts[0].bloom,
 				       key_hash(key, key_def));
 	}
 
@@ -253,12 +317,54 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 					       key_def->parts[i].type,
 					       key_def->parts[i].coll);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		if (!tuple_bloom_part_maybe_has(bloom, i, hash))
 			return false;
 	}
 	return true;
 }
 
+static size_t
+tuple_bloom_sizeof_xor_part(const struct xor_filter *part)
+{
+	size_t size = 0;
+	size += mp_sizeof_array(4);
+	size += mp_sizeof_uint(part->segment_size);
+	size += mp_sizeof_uint(part->fingerprint_bits);
+	size += mp_sizeof_uint(part->seed);
+	size += mp_sizeof_bin(xor_filter_store_size(part));
+	return size;
+}
+
+static char *
+tuple_bloom_encode_xor_part(const struct xor_filter *part, char *buf)
+{
+	buf = mp_encode_array(buf, 4);
+	buf = mp_encode_uint(buf, part->segment_size);
+	buf = mp_encode_uint(buf, part->fingerprint_bits);
+	buf = mp_encode_uint(buf, part->seed);
+	buf = mp_encode_binl(buf, xor_filter_store_size(part));
+	buf = xor_filter_store(part, buf);
+	return buf;
+}
+
+static int
+tuple_bloom_decode_xor_part(struct xor_filter *part, const char **data)
+{
+	memset(part, 0, sizeof(*part));
+	part->segment_size = mp_decode_uint(data);
+	part->fingerprint_bits = mp_decode_uint(data);
+	part->seed = mp_decode_uint(data);
+	size_t store_size = mp_decode_binl(data);
+	assert(store_size == xor_filter_store_size(part));
+	if (xor_filter_load_table(part, *data) != 0) {
+		diag_set(OutOfMemory, store_size, "xor_filter_load_table",
+			 "tuple bloom part");
+		return -1;
+	}
+	*data += store_size;
+	return 0;
+}
+
 static size_t
 tuple_bloom_sizeof_part(const struct bloom *part)
 {
@@ -285,8 +391,6 @@ static int
 tuple_bloom_decode_part(struct bloom *part, const char **data)
 {
 	memset(part, 0, sizeof(*part));
-	if (mp_decode_array(data) != 3)
-		unreachable();
 	part->table_size = mp_decode_uint(data);
 	part->hash_count = mp_decode_uint(data);
 	size_t store_size = mp_decode_binl(data);
@@ -305,8 +409,14 @@ tuple_bloom_size(const struct tuple_bloom *bloom)
 {
 	size_t size = 0;
 	size += mp_sizeof_array(bloom->part_count);
-	for (uint32_t i = 0; i < bloom->part_count; i++)
-		size += tuple_bloom_sizeof_part(&bloom->parts[i]);
+	for (uint32_t i = 0; i < bloom->part_count; i++) {
+		if (bloom->is_xor) {
+			size += tuple_bloom_sizeof_xor_part(
+					&bloom->parts[i].xor_filter);
+		} else {
+			size += tuple_bloom_sizeof_part(&bloom->parts[i].bloom);
+		}
+	}
 	return size;
 }
 
@@ -314,8 +424,15 @@ char *
 tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf)
 {
 	buf = mp_encode_array(buf, bloom->part_count);
-	for (uint32_t i = 0; i < bloom->part_count; i++)
-		buf = tuple_bloom_encode_part(&bloom->parts[i], buf);
+	for (uint32_t i = 0; i < bloom->part_count; i++) {
+		if (bloom->is_xor) {
+			buf = tuple_bloom_encode_xor_part(
+					&bloom->parts[i].xor_filter, buf);
+		} else {
+			buf = tuple_bloom_encode_part(&bloom->parts[i].bloom,
+						      buf);
+		}
+	}
 	return buf;
 }
 
@@ -323,20 +440,34 @@ struct tuple_bloom *
 tuple_bloom_decode(const char **data)
 {
 	uint32_t part_count = mp_decode_array(data);
-	struct tuple_bloom *bloom = malloc(sizeof(*bloom) +
-			part_count * sizeof(*bloom->parts));
-	if (bloom == NULL) {
-		diag_set(OutOfMemory, sizeof(*bloom) +
-			 part_count * sizeof(*bloom->parts),
-			 "malloc", "tuple bloom");
-		return NULL;
+	/*
+	 * Bloom filter parts are encoded as arrays of 3 elements,
+	 * xor filter parts as arrays of 4 elements.
+	 */
+	bool is_xor = false;
+	if (part_count > 0) {
+		const char *part = *data;
+		is_xor = mp_decode_array(&part) == 4;
 	}
-
-	bloom->is_legacy = false;
-	bloom->part_count = 0;
+	struct tuple_bloom *bloom = tuple_bloom_alloc(part_count, is_xor);
+	if (bloom == NULL)
+		return NULL;
 
 	for (uint32_t i = 0; i < part_count; i++) {
-		if (tuple_bloom_decode_part(&bloom->parts[i], data) != 0) {
+		uint32_t size = mp_decode_array(data);
+		int rc;
+		if (is_xor) {
+			if (size != 4)
+				unreachable();
+			rc = tuple_bloom_decode_xor_part(
+					&bloom->parts[i].xor_filter, data);
+		} else {
+			if (size != 3)
+				unreachable();
+			rc = tuple_bloom_decode_part(&bloom->parts[i].bloom,
+						     data);
+		}
+		if (rc != 0) {
 			tuple_bloom_delete(bloom);
 			return NULL;
 		}
@@ -357,6 +488,7 @@ tuple_bloom_decode_legacy(const char **data)
 	}
 
 	bloom->is_legacy = true;
+	bloom->is_xor = false;
 	bloom->part_count = 1;
 
 	if (mp_decode_array(data) != 4)
@@ -364,12 +496,12 @@ tuple_bloom_decode_legacy(const char **data)
 	if (mp_decode_uint(data) != 0) /* version */
 		unreachable();
 
-	bloom->parts[0].table_size = mp_decode_uint(data);
-	bloom->parts[0].hash_count = mp_decode_uint(data);
+	bloom->parts[0].bloom.table_size = mp_decode_uint(data);
+	bloom->parts[0].bloom.hash_count = mp_decode_uint(data);
 
 	size_t store_size = mp_decode_binl(data);
-	assert(store_size == bloom_store_size(&bloom->parts[0]));
-	if (bloom_load_table(&bloom->parts[0], *data) != 0) {
+	assert(store_size == bloom_store_size(&bloom->parts[0].bloom));
+	if (bloom_load_table(&bloom->parts[0].bloom, *data) != 0) {
 		diag_set(OutOfMemory, store_size, "bloom_load_table",
 			 "tuple bloom part");
 		free(bloom);
@@ -35,6 +35,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "salad/bloom.h"
+#include "salad/xor_filter.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -50,6 +51,10 @@ struct key_def;
  * When a key is checked to be hashed in the bloom, all its
  * partial keys are checked as well, which lowers the probability
  * of false positive results.
+ *
+ * Since the filter is never modified after construction, it may
+ * use static xor filters instead of bloom filters for partial
+ * keys, see tuple_bloom_new_xor().
  */
 struct tuple_bloom {
 	/**
@@ -58,10 +63,15 @@ struct tuple_bloom {
 	 * (see tuple_bloom_decode_legacy).
 	 */
 	bool is_legacy;
+	/** Set if partial keys are stored in xor filters. */
+	bool is_xor;
 	/** Number of key parts. */
 	uint32_t part_count;
-	/** Array of bloom filters, one per each partial key. */
-	struct bloom parts[0];
+	/** Array of filters, one per each partial key. */
+	union tuple_bloom_part {
+		struct bloom bloom;
+		struct xor_filter xor_filter;
+	} parts[0];
 };
 
 /**
@@ -159,6 +169,17 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 struct tuple_bloom *
 tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr);
 
+/**
+ * Create a new tuple bloom filter that uses xor filters instead
+ * of bloom filters. It takes less memory for the same false
+ * positive rate, but takes longer to build.
+ * @param builder - bloom filter builder
+ * @param fpr - desired false positive rate
+ * @return bloom filter on success or NULL on OOM
+ */
+struct tuple_bloom *
+tuple_bloom_new_xor(struct tuple_bloom_builder *builder, double fpr);
+
 /**
  * Delete a tuple bloom filter.
  * @param bloom - bloom filter to delete
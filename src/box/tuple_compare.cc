@@ -242,6 +242,21 @@ mp_compare_double_any_number(double lhs, const char *rhs,
 static int
 mp_compare_decimal(const char *lhs, const char *rhs)
 {
+	/*
+	 * Decimals with the same scale, e.g. money amounts, can be
+	 * compared without unpacking.
+	 */
+	const char *lhs_data = lhs, *rhs_data = rhs;
+	int8_t lhs_ext_type, rhs_ext_type;
+	uint32_t lhs_len = mp_decode_extl(&lhs_data, &lhs_ext_type);
+	uint32_t rhs_len = mp_decode_extl(&rhs_data, &rhs_ext_type);
+	assert(lhs_ext_type == MP_DECIMAL && rhs_ext_type == MP_DECIMAL);
+	(void)lhs_ext_type;
+	(void)rhs_ext_type;
+	int r;
+	if (decimal_compare_packed(lhs_data, lhs_len, rhs_data, rhs_len, &r))
+		return r;
+
 	decimal_t lhs_dec, rhs_dec;
 	decimal_t *ret;
 	ret = mp_decode_decimal(&lhs, &lhs_dec);
@@ -439,14 +454,13 @@ mp_compare_uuid(const char *field_a, const char *field_b)
 static int
 mp_compare_datetime(const char *lhs, const char *rhs)
 {
-	struct datetime lhs_dt, rhs_dt;
-	struct datetime *ret;
-	ret = mp_decode_datetime(&lhs, &lhs_dt);
-	assert(ret != NULL);
-	ret = mp_decode_datetime(&rhs, &rhs_dt);
-	assert(ret != NULL);
-	(void)ret;
-	return datetime_compare(&lhs_dt, &rhs_dt);
+	int8_t lhs_type, rhs_type;
+	uint32_t lhs_len = mp_decode_extl(&lhs, &lhs_type);
+	uint32_t rhs_len = mp_decode_extl(&rhs, &rhs_type);
+	assert(lhs_type == MP_DATETIME && rhs_type == MP_DATETIME);
+	(void)lhs_type;
+	(void)rhs_type;
+	return datetime_compare_packed(lhs, lhs_len, rhs, rhs_len);
 }
 
 typedef int (*mp_compare_f)(const char *, const char *);
@@ -1059,6 +1073,36 @@ tuple_compare_sequential(struct tuple *tuple_a, hint_t tuple_a_hint,
 	return 0;
 }
 
+static inline bool
+hint_is_exact_int(hint_t hint);
+
+/**
+ * Return true if the given hint of a field of type TYPE carries
+ * the whole field value so that equal hints imply equal fields
+ * and there's no need to look at the tuple data.
+ */
+template <int TYPE>
+static inline bool
+hint_is_key(hint_t hint)
+{
+	(void)hint;
+	return false;
+}
+
+template <>
+inline bool
+hint_is_key<FIELD_TYPE_UNSIGNED>(hint_t hint)
+{
+	return hint_is_exact_int(hint);
+}
+
+template <>
+inline bool
+hint_is_key<FIELD_TYPE_INTEGER>(hint_t hint)
+{
+	return hint_is_exact_int(hint);
+}
+
 template <int TYPE>
 static inline int
 field_compare(const char **field_a, const char **field_b);
@@ -1070,6 +1114,14 @@ field_compare<FIELD_TYPE_UNSIGNED>(const char **field_a, const char **field_b)
 	return mp_compare_uint(*field_a, *field_b);
 }
 
+template <>
+inline int
+field_compare<FIELD_TYPE_INTEGER>(const char **field_a, const char **field_b)
+{
+	return mp_compare_integer_with_type(*field_a, mp_typeof(**field_a),
+					    *field_b, mp_typeof(**field_b));
+}
+
 template <>
 inline int
 field_compare<FIELD_TYPE_STRING>(const char **field_a, const char **field_b)
@@ -1098,6 +1150,18 @@ field_compare_and_next<FIELD_TYPE_UNSIGNED>(const char **field_a,
 	return r;
 }
 
+template <>
+inline int
+field_compare_and_next<FIELD_TYPE_INTEGER>(const char **field_a,
+					   const char **field_b)
+{
+	int r = mp_compare_integer_with_type(*field_a, mp_typeof(**field_a),
+					     *field_b, mp_typeof(**field_b));
+	mp_next(field_a);
+	mp_next(field_b);
+	return r;
+}
+
 template <>
 inline int
 field_compare_and_next<FIELD_TYPE_STRING>(const char **field_a,
@@ -1181,6 +1245,10 @@ struct TupleCompare
 		int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
 		if (rc != 0)
 			return rc;
+		if (sizeof...(MORE_TYPES) == 0 &&
+		    tuple_a_hint == tuple_b_hint &&
+		    hint_is_key<TYPE>(tuple_a_hint))
+			return 0;
 		struct tuple_format *format_a = tuple_format(tuple_a);
 		struct tuple_format *format_b = tuple_format(tuple_b);
 		const char *field_a, *field_b;
@@ -1203,6 +1271,10 @@ struct TupleCompare<0, TYPE, MORE_TYPES...> {
 		int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
 		if (rc != 0)
 			return rc;
+		if (sizeof...(MORE_TYPES) == 0 &&
+		    tuple_a_hint == tuple_b_hint &&
+		    hint_is_key<TYPE>(tuple_a_hint))
+			return 0;
 		struct tuple_format *format_a = tuple_format(tuple_a);
 		struct tuple_format *format_b = tuple_format(tuple_b);
 		const char *field_a = tuple_data(tuple_a);
@@ -1240,6 +1312,13 @@ static const comparator_signature cmp_arr[] = {
 	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
 	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
 	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
+	COMPARATOR(0, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_UNSIGNED)
+	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_INTEGER)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_STRING)
+	COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_INTEGER , 2, FIELD_TYPE_INTEGER)
 };
 
 #undef COMPARATOR
@@ -1258,6 +1337,14 @@ field_compare_with_key<FIELD_TYPE_UNSIGNED>(const char **field, const char **key
 	return mp_compare_uint(*field, *key);
 }
 
+template <>
+inline int
+field_compare_with_key<FIELD_TYPE_INTEGER>(const char **field, const char **key)
+{
+	return mp_compare_integer_with_type(*field, mp_typeof(**field),
+					    *key, mp_typeof(**key));
+}
+
 template <>
 inline int
 field_compare_with_key<FIELD_TYPE_STRING>(const char **field, const char **key)
@@ -1286,6 +1373,18 @@ field_compare_with_key_and_next<FIELD_TYPE_UNSIGNED>(const char **field_a,
 	return r;
 }
 
+template <>
+inline int
+field_compare_with_key_and_next<FIELD_TYPE_INTEGER>(const char **field_a,
+						    const char **field_b)
+{
+	int r = mp_compare_integer_with_type(*field_a, mp_typeof(**field_a),
+					     *field_b, mp_typeof(**field_b));
+	mp_next(field_a);
+	mp_next(field_b);
+	return r;
+}
+
 template <>
 inline int
 field_compare_with_key_and_next<FIELD_TYPE_STRING>(const char **field_a,
@@ -1368,6 +1467,9 @@ struct TupleCompareWithKey
 		int rc = hint_cmp(tuple_hint, key_hint);
 		if (rc != 0)
 			return rc;
+		if (part_count == 1 && tuple_hint == key_hint &&
+		    hint_is_key<TYPE>(tuple_hint))
+			return 0;
 		struct tuple_format *format = tuple_format(tuple);
 		const char *field = tuple_field_raw(format, tuple_data(tuple),
 						    tuple_field_map(tuple),
@@ -1391,6 +1493,9 @@ struct TupleCompareWithKey<0, 0, TYPE, MORE_TYPES...>
 		int rc = hint_cmp(tuple_hint, key_hint);
 		if (rc != 0)
 			return rc;
+		if (part_count == 1 && tuple_hint == key_hint &&
+		    hint_is_key<TYPE>(tuple_hint))
+			return 0;
 		struct tuple_format *format = tuple_format(tuple);
 		const char *field = tuple_data(tuple);
 		mp_decode_array(&field);
@@ -1425,6 +1530,13 @@ static const comparator_with_key_signature cmp_wk_arr[] = {
 	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_UNSIGNED)
 	KEY_COMPARATOR(1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
 	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
+
+	KEY_COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_INTEGER , 2, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_UNSIGNED)
+	KEY_COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_INTEGER , 2, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_INTEGER , 2, FIELD_TYPE_INTEGER)
+	KEY_COMPARATOR(0, FIELD_TYPE_INTEGER , 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
+	KEY_COMPARATOR(1, FIELD_TYPE_INTEGER , 2, FIELD_TYPE_INTEGER)
 };
 
 #undef KEY_COMPARATOR
@@ -1704,6 +1816,21 @@ hint_int(int64_t i)
 	return hint_create(MP_CLASS_NUMBER, val);
 }
 
+/**
+ * Return true if the hint was created by hint_uint() or hint_int()
+ * from a number that fits in a hint value, i.e. the number can be
+ * restored from the hint. Values at the bounds are excluded since
+ * out-of-range numbers are clamped to them.
+ */
+static inline bool
+hint_is_exact_int(hint_t hint)
+{
+	if (hint == HINT_NONE || hint >> HINT_VALUE_BITS != MP_CLASS_NUMBER)
+		return false;
+	uint64_t val = hint & HINT_VALUE_MAX;
+	return val != 0 && val != HINT_VALUE_MAX;
+}
+
 static inline hint_t
 hint_double(double d)
 {
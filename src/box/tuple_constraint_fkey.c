@@ -294,6 +294,8 @@ tuple_constraint_fkey_check(const struct tuple_constraint *constr,
 		}
 	}
 	struct index *index = foreign_space->index[constr->fkey->foreign_index];
+	if (index_check_built(index) != 0)
+		return -1;
 	struct key_def *key_def = index->def->key_def;
 	uint32_t part_count = constr->fkey->field_count;
 	assert(constr->fkey->field_count == key_def->part_count);
@@ -450,6 +452,8 @@ tuple_constraint_fkey_check_delete(const struct tuple_constraint *constr,
 	}
 
 	struct index *index = constr->space->index[constr->fkey->local_index];
+	if (index_check_built(index) != 0)
+		return -1;
 	struct key_def *key_def = index->def->key_def;
 	uint32_t part_count = constr->fkey->field_count;
 	assert(constr->fkey->field_count == key_def->part_count);
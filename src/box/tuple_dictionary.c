@@ -37,6 +37,9 @@
 
 field_name_hash_f field_name_hash;
 
+/** Source of tuple_dictionary::version values. */
+static uint64_t tuple_dictionary_version = 0;
+
 /** Free names hash and its content. */
 static inline void
 tuple_dictionary_delete_hash(struct mh_strnu32_t *hash)
@@ -106,6 +109,7 @@ tuple_dictionary_new(const struct field_def *fields, uint32_t field_count)
 		return NULL;
 	}
 	dict->refs = 1;
+	dict->version = ++tuple_dictionary_version;
 	dict->name_count = field_count;
 	if (field_count == 0)
 		return dict;
@@ -177,6 +181,8 @@ tuple_dictionary_swap(struct tuple_dictionary *a, struct tuple_dictionary *b)
 	*b = t;
 	a->refs = a_refs;
 	b->refs = b_refs;
+	a->version = ++tuple_dictionary_version;
+	b->version = ++tuple_dictionary_version;
 }
 
 void
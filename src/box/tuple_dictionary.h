@@ -57,6 +57,11 @@ struct tuple_dictionary {
 	uint32_t name_count;
 	/** Reference counter. */
 	int refs;
+	/**
+	 * Unique value that changes whenever the names are changed,
+	 * used for caching name lookups.
+	 */
+	uint64_t version;
 };
 
 /**
@@ -85,7 +90,7 @@ tuple_dictionary_cmp(const struct tuple_dictionary *a,
 
 /**
  * Swap content of two dictionaries. Reference counters are not
- * swaped.
+ * swaped, versions of both dictionaries are updated.
  */
 void
 tuple_dictionary_swap(struct tuple_dictionary *a, struct tuple_dictionary *b);
@@ -486,14 +486,46 @@ tuple_key_contains_null(struct tuple *tuple, struct key_def *def,
 	return false;
 }
 
+/**
+ * Check if a tuple field matches the filter of a partial index.
+ * Non-scalar and extension values never match, because filter
+ * values can't be of these types.
+ */
+static bool
+tuple_field_matches_filter(const char *field, const struct key_filter *filter)
+{
+	if (field == NULL)
+		return false;
+	switch (mp_typeof(*field)) {
+	case MP_UINT:
+	case MP_INT:
+	case MP_FLOAT:
+	case MP_DOUBLE:
+	case MP_STR:
+	case MP_BIN:
+	case MP_BOOL:
+		return tuple_compare_field(field, filter->value,
+					   FIELD_TYPE_SCALAR, NULL) == 0;
+	default:
+		return false;
+	}
+}
+
 bool
 tuple_key_is_excluded_slow(struct tuple *tuple, struct key_def *def,
 			   int multikey_idx)
 {
-	assert(def->has_exclude_null);
+	assert(def->has_exclude_null || def->has_filter);
 	struct tuple_format *format = tuple_format(tuple);
 	const char *data = tuple_data(tuple);
 	const uint32_t *field_map = tuple_field_map(tuple);
+	if (def->has_filter &&
+	    !tuple_field_matches_filter(tuple_field_raw(format, data, field_map,
+							def->filter.fieldno),
+					&def->filter))
+		return true;
+	if (!def->has_exclude_null)
+		return false;
 	for (struct key_part *part = def->parts, *end = part + def->part_count;
 	     part < end; ++part) {
 		if (!part->exclude_null)
@@ -38,6 +38,7 @@
 #include "tuple_builder.h"
 #include "tuple_constraint.h"
 #include "field_default_func.h"
+#include "intern_dict.h"
 #include "tt_static.h"
 #include "mpstream/mpstream.h"
 
@@ -119,6 +120,9 @@ tuple_format_cmp(const struct tuple_format *format1,
 		if (field_a->compression_type != field_b->compression_type)
 			return (int)field_a->compression_type -
 			       (int)field_b->compression_type;
+		if (field_a->is_interned != field_b->is_interned)
+			return (int)field_a->is_interned -
+			       (int)field_b->is_interned;
 		if (field_a->constraint_count != field_b->constraint_count)
 			return (int)field_a->constraint_count -
 			       (int)field_b->constraint_count;
@@ -168,6 +172,7 @@ tuple_format_hash(struct tuple_format *format)
 		TUPLE_FIELD_MEMBER_HASH(f, nullable_action, h, carry, size)
 		TUPLE_FIELD_MEMBER_HASH(f, is_key_part, h, carry, size)
 		TUPLE_FIELD_MEMBER_HASH(f, compression_type, h, carry, size);
+		TUPLE_FIELD_MEMBER_HASH(f, is_interned, h, carry, size);
 		for (uint32_t i = 0; i < f->constraint_count; ++i)
 			size += tuple_constraint_hash_process(&f->constraint[i],
 							      &h, &carry);
@@ -315,6 +320,48 @@ tuple_field_ensure_child_compatibility(struct tuple_field *parent,
 	return 0;
 }
 
+enum {
+	/**
+	 * Max number of fixed size fields that may precede a field
+	 * accessed without an offset slot.
+	 */
+	TUPLE_FORMAT_FIXED_PREFIX_MAX = 4,
+};
+
+/**
+ * Check if a field always takes the same number of bytes in tuples
+ * of the format.
+ */
+static bool
+tuple_field_is_fixed_size(const struct tuple_field *field)
+{
+	if (tuple_field_is_nullable(field) ||
+	    field->compression_type != COMPRESSION_TYPE_NONE ||
+	    field->is_interned)
+		return false;
+	return field->type == FIELD_TYPE_BOOLEAN ||
+	       field->type == FIELD_TYPE_UUID;
+}
+
+/**
+ * Check if the top-level field @a fieldno is preceded only by a few
+ * fixed size fields, so that it's cheap enough to reach it by
+ * decoding the tuple and there's no need to store its offset in
+ * the field map of each tuple.
+ */
+static bool
+tuple_format_field_has_fixed_prefix(struct tuple_format *format,
+				    uint32_t fieldno)
+{
+	if (fieldno > TUPLE_FORMAT_FIXED_PREFIX_MAX)
+		return false;
+	for (uint32_t i = 0; i < fieldno; i++) {
+		if (!tuple_field_is_fixed_size(tuple_format_field(format, i)))
+			return false;
+	}
+	return true;
+}
+
 /**
  * Given a field number and a path, add the corresponding field
  * to the tuple format, allocating intermediate fields if
@@ -409,9 +456,13 @@ tuple_format_add_field(struct tuple_format *format, uint32_t fieldno,
 	 * In the tuple, store only offsets necessary to access
 	 * fields of non-sequential keys. First field is always
 	 * simply accessible, so we don't store an offset for it.
+	 * Neither we do for a top-level field preceded only by
+	 * a few fixed size fields.
 	 */
 	if (parent->offset_slot == TUPLE_OFFSET_SLOT_NIL &&
-	    is_sequential == false && (fieldno > 0 || path != NULL)) {
+	    is_sequential == false && (fieldno > 0 || path != NULL) &&
+	    (path != NULL ||
+	     !tuple_format_field_has_fixed_prefix(format, fieldno))) {
 		*current_slot = *current_slot - 1;
 		parent->offset_slot = *current_slot;
 	}
@@ -529,6 +580,12 @@ tuple_format_create(struct tuple_format *format, struct key_def *const *keys,
 		field->compression_type = fields[i].compression_type;
 		if (field->compression_type != COMPRESSION_TYPE_NONE)
 			format->is_compressed = true;
+		field->is_interned = fields[i].is_interned;
+		if (field->is_interned) {
+			format->is_compressed = true;
+			if (format->intern_dict == NULL)
+				format->intern_dict = intern_dict_new();
+		}
 
 		field->constraint =
 			tuple_constraint_array_new(fields[i].constraint_def,
@@ -599,6 +656,15 @@ tuple_format_create(struct tuple_format *format, struct key_def *const *keys,
 	}
 	format->field_map_size = field_map_size;
 
+	for (uint32_t i = 0; i < tuple_format_field_count(format); i++) {
+		struct tuple_field *field = tuple_format_field(format, i);
+		if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL)
+			format->field_map_field_count = i + 1;
+		if (field->type != FIELD_TYPE_ANY ||
+		    field->constraint_count > 0)
+			format->validate_field_count = i + 1;
+	}
+
 	size_t required_fields_sz = BITMAP_SIZE(format->total_field_count);
 	format->required_fields = calloc(1, required_fields_sz);
 	if (format->required_fields == NULL) {
@@ -785,6 +851,8 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 	format->index_field_count = index_field_count;
 	format->exact_field_count = 0;
 	format->min_field_count = 0;
+	format->field_map_field_count = 0;
+	format->validate_field_count = 0;
 	format->epoch = 0;
 	format->constraint_count = 0;
 	format->constraint = NULL;
@@ -801,6 +869,8 @@ static inline void
 tuple_format_destroy(struct tuple_format *format)
 {
 	free(format->required_fields);
+	if (format->intern_dict != NULL)
+		intern_dict_delete(format->intern_dict);
 	tuple_format_destroy_fields(format);
 	tuple_dictionary_unref(format->dict);
 	for (uint32_t i = 0; i < format->constraint_count; i++)
@@ -885,6 +955,7 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 	format->is_reusable = is_reusable;
 	/* This flag is set in `tuple_format_create` function. */
 	format->is_compressed = false;
+	format->intern_dict = NULL;
 	format->exact_field_count = exact_field_count;
 	format->epoch = ++formats_epoch;
 	if (format_data != NULL) {
@@ -951,20 +1022,43 @@ tuple_format_is_compatible_with_key_def(struct tuple_format *format,
         for (uint32_t i = 0; i < tuple_format_field_count(format); i++) {
         	struct tuple_field *field =
                         tuple_format_field(format, i);
-        	if (field->compression_type == COMPRESSION_TYPE_NONE)
+        	if (field->compression_type == COMPRESSION_TYPE_NONE &&
+		    !field->is_interned)
 			continue;
 		if (key_def_find_by_fieldno(key_def, i)) {
-			diag_set(ClientError, ER_UNSUPPORTED,
-				 "Indexed field", "compression");
+			diag_set(ClientError, ER_UNSUPPORTED, "Indexed field",
+				 field->is_interned ? "interning" :
+				 "compression");
 			return false;
 		}
         }
         return true;
 }
 
+/** Returns the number of the top-level field containing a field. */
+static uint32_t
+tuple_format_field_root_fieldno(struct tuple_format *format,
+				struct tuple_field *field)
+{
+	struct json_token *token = &field->token;
+	while (token->parent != &format->fields.root)
+		token = token->parent;
+	assert(token->type == JSON_TOKEN_NUM);
+	return token->num;
+}
+
 bool
 tuple_format1_can_store_format2_tuples(struct tuple_format *format1,
 				       struct tuple_format *format2)
+{
+	return tuple_format1_can_store_format2_tuples_with_field_count(
+			format1, format2, UINT32_MAX);
+}
+
+bool
+tuple_format1_can_store_format2_tuples_with_field_count(
+		struct tuple_format *format1, struct tuple_format *format2,
+		uint32_t field_count)
 {
 	if (format1->exact_field_count != format2->exact_field_count)
 		return false;
@@ -998,8 +1092,17 @@ tuple_format1_can_store_format2_tuples(struct tuple_format *format1,
 			if (field1->type == FIELD_TYPE_ANY &&
 			    tuple_field_is_nullable(field1))
 				continue;
-			else
-				return false;
+			/*
+			 * A nullable field beyond the fields of all
+			 * the stored tuples is missing in all of them
+			 * so it doesn't require a data check either.
+			 */
+			if (tuple_field_is_nullable(field1) &&
+			    field1->constraint_count == 0 &&
+			    tuple_format_field_root_fieldno(format1, field1) >=
+			    field_count)
+				continue;
+			return false;
 		}
 		if (! field_type1_contains_type2(field1->type, field2->type))
 			return false;
@@ -1178,6 +1281,12 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 	}
 
 	uint32_t field_count = MIN(defined_field_count, format_field_count);
+	/*
+	 * Without validation only fields with offset slots matter,
+	 * so stop at the last of them.
+	 */
+	if (!validate)
+		field_count = MIN(field_count, format->field_map_field_count);
 	if (unlikely(field_count == 0))
 		return 0;
 
@@ -1193,8 +1302,15 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 			mp_decode_nil(&next_pos);
 		} else {
 			mp_next(&next_pos);
-			if (validate && tuple_field_validate(format, field, pos,
-							     next_pos) != 0)
+			/*
+			 * A field of type 'any' without constraints can
+			 * only fail validation if it's an extension.
+			 */
+			if (validate &&
+			    (i < format->validate_field_count ||
+			     mp_typeof(*pos) == MP_EXT) &&
+			    tuple_field_validate(format, field, pos,
+						 next_pos) != 0)
 				goto error;
 		}
 		if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL)
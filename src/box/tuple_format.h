@@ -70,6 +70,7 @@ struct tuple_info;
 struct tuple_format;
 struct coll;
 struct mpstream;
+struct intern_dict;
 
 /** Engine-specific tuple format methods. */
 struct tuple_format_vtab {
@@ -147,6 +148,8 @@ struct tuple_field {
 	uint32_t coll_id;
 	/** Type of compression for this field. */
 	enum compression_type compression_type;
+	/** True if values of this field are interned. */
+	bool is_interned;
 	/**
 	 * Bitmap of fields that must be present in a tuple
 	 * conforming to the multikey subtree. Not NULL only
@@ -257,8 +260,17 @@ struct tuple_format {
 	 * those are never altered. We can also reuse formats exported to Lua.
 	 */
 	bool is_reusable;
-	/** True if tuples of this format may contain compressed fields. */
+	/**
+	 * True if tuples of this format may contain compressed or
+	 * interned fields, which must be decoded before the tuple
+	 * is returned to the user.
+	 */
 	bool is_compressed;
+	/**
+	 * Dictionary of values of interned fields. NULL if there are
+	 * no interned fields in the format.
+	 */
+	struct intern_dict *intern_dict;
 	/**
 	 * Size of minimal field map of tuple where each indexed
 	 * field has own offset slot (in bytes). The real tuple
@@ -281,6 +293,19 @@ struct tuple_format {
 	 * index_field_count <= min_field_count <= field_count.
 	 */
 	uint32_t min_field_count;
+	/**
+	 * The longest top level field prefix in which the last
+	 * field has an offset slot. Fields past it don't need to
+	 * be walked to build a field map.
+	 */
+	uint32_t field_map_field_count;
+	/**
+	 * The longest top level field prefix in which the last
+	 * field has a type other than 'any' or a constraint. The
+	 * rest of fields only need to be checked for unsupported
+	 * MsgPack extensions on validation.
+	 */
+	uint32_t validate_field_count;
 	/**
 	 * Total number of formatted fields, including JSON
 	 * path fields. See also tuple_format::fields.
@@ -473,6 +498,17 @@ bool
 tuple_format1_can_store_format2_tuples(struct tuple_format *format1,
 				       struct tuple_format *format2);
 
+/**
+ * Same as tuple_format1_can_store_format2_tuples(), but it's known
+ * that the tuples of @a format2 have no more than @a field_count
+ * fields. Nullable fields beyond them don't require a data check,
+ * so they can be appended to a format instantly.
+ */
+bool
+tuple_format1_can_store_format2_tuples_with_field_count(
+		struct tuple_format *format1, struct tuple_format *format2,
+		uint32_t field_count);
+
 /**
  * Calculate minimal field count of tuples with specified keys and
  * space format.
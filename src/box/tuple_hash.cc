@@ -35,6 +35,9 @@
 #include "coll/coll.h"
 #include <math.h>
 
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
 /* Tuple and key hasher */
 namespace {
 
@@ -194,15 +197,92 @@ struct TupleHash<FIELD_TYPE_UNSIGNED> {
 	}
 };
 
+template <int TYPE>
+static inline uint64_t
+field_hash_xxh3(uint64_t h, const char **field)
+{
+	/* See field_hash() for these restrictions. */
+	static_assert(TYPE != FIELD_TYPE_STRING, "See the comment above.");
+	static_assert(TYPE != FIELD_TYPE_DOUBLE, "See the comment above.");
+	const char *f = *field;
+	mp_next(field);
+	return XXH3_64bits_withSeed(f, *field - f, h);
+}
+
+template <>
+inline uint64_t
+field_hash_xxh3<FIELD_TYPE_STRING>(uint64_t h, const char **field)
+{
+	uint32_t size;
+	const char *f = mp_decode_str(field, &size);
+	return XXH3_64bits_withSeed(f, size, h);
+}
+
+/*
+ * XXH3 doesn't have a cheap incremental mode, so key fields are
+ * hashed one by one, each with the hash of the previous fields
+ * used as the seed.
+ */
+template <int TYPE, int ...MORE_TYPES> struct Xxh3FieldHash {};
+
+template <int TYPE, int TYPE2, int ...MORE_TYPES>
+struct Xxh3FieldHash<TYPE, TYPE2, MORE_TYPES...> {
+	static uint64_t hash(uint64_t h, const char **pfield)
+	{
+		h = field_hash_xxh3<TYPE>(h, pfield);
+		return Xxh3FieldHash<TYPE2, MORE_TYPES...>::hash(h, pfield);
+	}
+};
+
+template <int TYPE>
+struct Xxh3FieldHash<TYPE> {
+	static uint64_t hash(uint64_t h, const char **pfield)
+	{
+		return field_hash_xxh3<TYPE>(h, pfield);
+	}
+};
+
+template <int TYPE, int ...MORE_TYPES>
+struct Xxh3KeyHash {
+	static uint32_t hash(const char *key, struct key_def *)
+	{
+		return Xxh3FieldHash<TYPE, MORE_TYPES...>::hash(HASH_SEED,
+								&key);
+	}
+};
+
+/* An unsigned key is the hash by itself, no need to mix it. */
+template <>
+struct Xxh3KeyHash<FIELD_TYPE_UNSIGNED> : KeyHash<FIELD_TYPE_UNSIGNED> {};
+
+template <int TYPE, int ...MORE_TYPES>
+struct Xxh3TupleHash {
+	static uint32_t hash(struct tuple *tuple, struct key_def *key_def)
+	{
+		assert(!key_def->is_multikey);
+		const char *field = tuple_field_by_part(tuple,
+						key_def->parts,
+						MULTIKEY_NONE);
+		return Xxh3FieldHash<TYPE, MORE_TYPES...>::hash(HASH_SEED,
+								&field);
+	}
+};
+
+template <>
+struct Xxh3TupleHash<FIELD_TYPE_UNSIGNED> : TupleHash<FIELD_TYPE_UNSIGNED> {};
+
 }; /* namespace { */
 
 #define HASHER(...) \
 	{ KeyHash<__VA_ARGS__>::hash, TupleHash<__VA_ARGS__>::hash, \
+	  Xxh3KeyHash<__VA_ARGS__>::hash, Xxh3TupleHash<__VA_ARGS__>::hash, \
 		{ __VA_ARGS__, UINT32_MAX } },
 
 struct hasher_signature {
 	key_hash_t kf;
 	tuple_hash_t tf;
+	key_hash_t xxh3_kf;
+	tuple_hash_t xxh3_tf;
 	uint32_t p[64];
 };
 
@@ -235,10 +315,21 @@ tuple_hash_slowpath(struct tuple *tuple, struct key_def *key_def);
 static uint32_t
 key_hash_slowpath(const char *key, struct key_def *key_def);
 
-void
-key_def_set_hash_func(struct key_def *key_def) {
+static uint32_t
+tuple_hash_xxh3_slowpath(struct tuple *tuple, struct key_def *key_def);
+
+static uint32_t
+key_hash_xxh3_slowpath(const char *key, struct key_def *key_def);
+
+/**
+ * Find pre-generated hash functions for the key_def. Returns NULL
+ * if there are none.
+ */
+static const struct hasher_signature *
+key_def_find_hasher(const struct key_def *key_def)
+{
 	if (key_def->is_nullable || key_def->has_json_paths)
-		goto slowpath;
+		return NULL;
 	/*
 	 * Check that key_def defines sequential a key without holes
 	 * starting from **arbitrary** field.
@@ -246,11 +337,11 @@ key_def_set_hash_func(struct key_def *key_def) {
 	for (uint32_t i = 1; i < key_def->part_count; i++) {
 		if (key_def->parts[i - 1].fieldno + 1 !=
 		    key_def->parts[i].fieldno)
-			goto slowpath;
+			return NULL;
 	}
 	if (key_def_has_collation(key_def)) {
 		/* Precalculated comparators don't use collation */
-		goto slowpath;
+		return NULL;
 	}
 	/*
 	 * Try to find pre-generated tuple_hash() and key_hash()
@@ -263,14 +354,20 @@ key_def_set_hash_func(struct key_def *key_def) {
 				break;
 			}
 		}
-		if (i == key_def->part_count && hash_arr[k].p[i] == UINT32_MAX){
-			key_def->tuple_hash = hash_arr[k].tf;
-			key_def->key_hash = hash_arr[k].kf;
-			return;
-		}
+		if (i == key_def->part_count && hash_arr[k].p[i] == UINT32_MAX)
+			return &hash_arr[k];
 	}
+	return NULL;
+}
 
-slowpath:
+void
+key_def_set_hash_func(struct key_def *key_def) {
+	const struct hasher_signature *hasher = key_def_find_hasher(key_def);
+	if (hasher != NULL) {
+		key_def->tuple_hash = hasher->tf;
+		key_def->key_hash = hasher->kf;
+		return;
+	}
 	if (key_def->has_optional_parts) {
 		if (key_def->has_json_paths)
 			key_def->tuple_hash = tuple_hash_slowpath<true, true>;
@@ -285,13 +382,30 @@ key_def_set_hash_func(struct key_def *key_def) {
 	key_def->key_hash = key_hash_slowpath;
 }
 
-uint32_t
-tuple_hash_field(uint32_t *ph1, uint32_t *pcarry, const char **field,
-		 enum field_type type, struct coll *coll)
+void
+key_def_get_xxh3_hash_func(const struct key_def *key_def,
+			   tuple_hash_t *tuple_hash, key_hash_t *key_hash)
+{
+	const struct hasher_signature *hasher = key_def_find_hasher(key_def);
+	if (hasher != NULL) {
+		*tuple_hash = hasher->xxh3_tf;
+		*key_hash = hasher->xxh3_kf;
+		return;
+	}
+	*tuple_hash = tuple_hash_xxh3_slowpath;
+	*key_hash = key_hash_xxh3_slowpath;
+}
+
+/**
+ * Decode a key field of the given type and return the data to hash
+ * it by. The data may be stored in @a buf, which must be at least
+ * 9 bytes long. Collations are handled by callers.
+ */
+static inline const char *
+tuple_hash_field_data(const char **field, enum field_type type, char *buf,
+		      uint32_t *size)
 {
-	char buf[9]; /* enough to store MP_INT/MP_UINT/MP_DOUBLE */
 	const char *f = *field;
-	uint32_t size;
 
 	/*
 	 * MsgPack values of double key field are casted to double, encoded
@@ -316,10 +430,9 @@ tuple_hash_field(uint32_t *ph1, uint32_t *pcarry, const char **field,
 		if (mp_read_double_lossy(field, &value) == -1)
 			unreachable();
 		char *double_msgpack_end = mp_encode_double(buf, value);
-		size = double_msgpack_end - buf;
-		assert(size <= sizeof(buf));
-		PMurHash32_Process(ph1, pcarry, buf, size);
-		return size;
+		*size = double_msgpack_end - buf;
+		assert(*size <= 9);
+		return buf;
 	}
 
 	switch (mp_typeof(**field)) {
@@ -330,9 +443,7 @@ tuple_hash_field(uint32_t *ph1, uint32_t *pcarry, const char **field,
 		 * with old third-party MsgPack (spec-old.md) implementations.
 		 * \sa https://github.com/tarantool/tarantool/issues/522
 		 */
-		f = mp_decode_str(field, &size);
-		if (coll != NULL)
-			return coll->hash(f, size, ph1, pcarry, coll);
+		f = mp_decode_str(field, size);
 		break;
 	case MP_FLOAT:
 	case MP_DOUBLE: {
@@ -348,7 +459,7 @@ tuple_hash_field(uint32_t *ph1, uint32_t *pcarry, const char **field,
 			     mp_decode_double(field);
 		if (!isfinite(val) || modf(val, &iptr) != 0 ||
 		    val < -exp2(63) || val >= exp2(64)) {
-			size = *field - f;
+			*size = *field - f;
 			break;
 		}
 		char *data;
@@ -356,14 +467,14 @@ tuple_hash_field(uint32_t *ph1, uint32_t *pcarry, const char **field,
 			data = mp_encode_uint(buf, (uint64_t)val);
 		else
 			data = mp_encode_int(buf, (int64_t)val);
-		size = data - buf;
-		assert(size <= sizeof(buf));
+		*size = data - buf;
+		assert(*size <= 9);
 		f = buf;
 		break;
 	}
 	default:
 		mp_next(field);
-		size = *field - f;  /* calculate the size of field */
+		*size = *field - f;  /* calculate the size of field */
 		/*
 		 * (!) All other fields hashed **including** MsgPack format
 		 * identifier (e.g. 0xcc). This was done **intentionally**
@@ -374,7 +485,21 @@ tuple_hash_field(uint32_t *ph1, uint32_t *pcarry, const char **field,
 		 */
 		break;
 	}
-	assert(size < INT32_MAX);
+	assert(*size < INT32_MAX);
+	return f;
+}
+
+uint32_t
+tuple_hash_field(uint32_t *ph1, uint32_t *pcarry, const char **field,
+		 enum field_type type, struct coll *coll)
+{
+	uint32_t size;
+	if (coll != NULL && mp_typeof(**field) == MP_STR) {
+		const char *f = mp_decode_str(field, &size);
+		return coll->hash(f, size, ph1, pcarry, coll);
+	}
+	char buf[9]; /* enough to store MP_INT/MP_UINT/MP_DOUBLE */
+	const char *f = tuple_hash_field_data(field, type, buf, &size);
 	PMurHash32_Process(ph1, pcarry, f, size);
 	return size;
 }
@@ -474,3 +599,58 @@ key_hash_slowpath(const char *key, struct key_def *key_def)
 
 	return PMurHash32_Result(h, carry, total_size);
 }
+
+/** Mix a key field into the XXH3 hash @a h. */
+static inline uint64_t
+tuple_hash_field_xxh3(uint64_t h, const char **field, enum field_type type,
+		      struct coll *coll)
+{
+	uint32_t size;
+	if (coll != NULL && mp_typeof(**field) == MP_STR) {
+		/*
+		 * Collations only support incremental MurmurHash3,
+		 * so mix in the finalized collation hash.
+		 */
+		const char *f = mp_decode_str(field, &size);
+		uint32_t coll_h = HASH_SEED;
+		uint32_t carry = 0;
+		uint32_t total_size = coll->hash(f, size, &coll_h, &carry, coll);
+		coll_h = PMurHash32_Result(coll_h, carry, total_size);
+		return XXH3_64bits_withSeed(&coll_h, sizeof(coll_h), h);
+	}
+	char buf[9]; /* enough to store MP_INT/MP_UINT/MP_DOUBLE */
+	const char *f = tuple_hash_field_data(field, type, buf, &size);
+	return XXH3_64bits_withSeed(f, size, h);
+}
+
+static uint32_t
+tuple_hash_xxh3_slowpath(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey);
+	assert(!key_def->for_func_index);
+	uint64_t h = HASH_SEED;
+	for (struct key_part *part = key_def->parts;
+	     part < key_def->parts + key_def->part_count; part++) {
+		const char *field = tuple_field_by_part(tuple, part,
+							MULTIKEY_NONE);
+		if (field == NULL) {
+			/* Hash as MP_NIL to match key_hash(). */
+			const char null = 0xc0;
+			h = XXH3_64bits_withSeed(&null, 1, h);
+		} else {
+			h = tuple_hash_field_xxh3(h, &field, part->type,
+						  part->coll);
+		}
+	}
+	return h;
+}
+
+static uint32_t
+key_hash_xxh3_slowpath(const char *key, struct key_def *key_def)
+{
+	uint64_t h = HASH_SEED;
+	for (struct key_part *part = key_def->parts;
+	     part < key_def->parts + key_def->part_count; part++)
+		h = tuple_hash_field_xxh3(h, &key, part->type, part->coll);
+	return h;
+}
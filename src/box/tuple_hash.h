@@ -30,6 +30,8 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include "key_def.h"
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
@@ -43,6 +45,16 @@ struct key_def;
 void
 key_def_set_hash_func(struct key_def *def);
 
+/**
+ * Get XXH3-based implementations of tuple_hash() and key_hash() for
+ * the key_def. They are faster than the default ones for string and
+ * multipart keys, but give different hash values, so they may only
+ * be used where the values are never persisted.
+ */
+void
+key_def_get_xxh3_hash_func(const struct key_def *key_def,
+			   tuple_hash_t *tuple_hash, key_hash_t *key_hash);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -35,6 +35,7 @@
 #include "tuple.h"
 #include "journal.h"
 #include <fiber.h>
+#include "clock.h"
 #include "xrow.h"
 #include "errinj.h"
 #include "iproto_constants.h"
@@ -42,6 +43,9 @@
 #include "session.h"
 #include "wal_ext.h"
 #include "rmean.h"
+#include "request.h"
+#include "assoc.h"
+#include "trivia/usdt.h"
 
 double too_long_threshold;
 
@@ -545,6 +549,7 @@ txn_begin(void)
 	txn_set_flags(txn, TXN_CAN_YIELD);
 	memtx_tx_register_txn(txn);
 	rmean_collect(rmean_box, IPROTO_BEGIN, 1);
+	USDT(txn_begin, txn->id);
 	return txn;
 }
 
@@ -576,6 +581,10 @@ txn_begin_stmt(struct txn *txn, struct space *space, uint16_t type)
 		diag_set(ClientError, ER_SUB_STMT_MAX);
 		return -1;
 	}
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY)) {
+		diag_set(ClientError, ER_TXN_READ_ONLY);
+		return -1;
+	}
 
 	if (txn->status == TXN_IN_READ_VIEW) {
 		rlist_del(&txn->in_read_view_txs);
@@ -652,6 +661,8 @@ txn_commit_stmt(struct txn *txn, struct request *request)
 			goto fail;
 		assert(stmt->row != NULL);
 		txn_update_row_counts(txn, stmt, 1);
+		if (stmt->space != NULL && stmt->space->def->opts.wal_coalesce)
+			txn_set_flags(txn, TXN_HAS_COALESCIBLE_ROWS);
 	}
 	/*
 	 * If there are transactional event triggers set on `stmt->space', save
@@ -756,6 +767,7 @@ txn_complete_fail(struct txn *txn)
 	}
 	if (txn_event_on_rollback_run_triggers(txn) != 0)
 		diag_log();
+	USDT(txn_rollback, txn->id, txn->signature);
 	txn_free_or_wakeup(txn);
 	rmean_collect(rmean_box, IPROTO_ROLLBACK, 1);
 }
@@ -793,6 +805,7 @@ txn_complete_success(struct txn *txn)
 	}
 	if (txn_event_on_commit_run_triggers(txn) != 0)
 		diag_log();
+	USDT(txn_commit, txn->id, txn->signature);
 	txn_free_or_wakeup(txn);
 	rmean_collect(rmean_box, IPROTO_COMMIT, 1);
 }
@@ -877,6 +890,107 @@ txn_on_journal_write(struct journal_entry *entry)
 	fiber_set_session(fiber(), orig_session);
 }
 
+/**
+ * Return the tuple identifying the primary key modified by @a stmt if
+ * the statement's redo row may be coalesced with rows of other
+ * statements modifying the same key, NULL otherwise.
+ */
+static struct tuple *
+txn_stmt_coalesce_tuple(struct txn_stmt *stmt)
+{
+	struct space *space = stmt->space;
+	if (stmt->row == NULL || stmt->row->replica_id != 0 ||
+	    space == NULL || !space->def->opts.wal_coalesce ||
+	    space->wal_ext != NULL)
+		return NULL;
+	switch (stmt->row->type) {
+	case IPROTO_INSERT:
+	case IPROTO_REPLACE:
+	case IPROTO_UPDATE:
+	case IPROTO_UPSERT:
+	case IPROTO_DELETE:
+		break;
+	default:
+		return NULL;
+	}
+	struct tuple *tuple = stmt->new_tuple != NULL ?
+			      stmt->new_tuple : stmt->old_tuple;
+	/* Stored data of encoded fields can't be written to WAL. */
+	if (tuple == NULL || tuple_format(tuple)->is_compressed)
+		return NULL;
+	/*
+	 * Moving a change of a key past changes of other keys could
+	 * break uniqueness of a secondary key on replay.
+	 */
+	for (uint32_t i = 1; i < space->index_count; i++) {
+		if (space->index[i]->def->opts.is_unique)
+			return NULL;
+	}
+	return tuple;
+}
+
+/**
+ * Drop redo rows of statements overwritten by later statements of the
+ * same transaction in spaces with the wal_coalesce option. The row of
+ * the last statement modifying a key is turned into REPLACE or DELETE
+ * of the resulting tuple so that it doesn't depend on the dropped ones.
+ */
+static int
+txn_coalesce_rows(struct txn *txn)
+{
+	struct mh_i64ptr_t *h = mh_i64ptr_new();
+	struct region *txn_region = tx_region_acquire(txn);
+	int rc = 0;
+	struct txn_stmt *stmt;
+	stailq_foreach_entry(stmt, &txn->stmts, next) {
+		struct tuple *tuple = txn_stmt_coalesce_tuple(stmt);
+		if (tuple == NULL)
+			continue;
+		struct key_def *key_def = stmt->space->index[0]->def->key_def;
+		struct mh_i64ptr_node_t node = {
+			(uint64_t)space_id(stmt->space) << 32 |
+				tuple_hash(tuple, key_def),
+			stmt,
+		};
+		struct mh_i64ptr_node_t old_node;
+		struct mh_i64ptr_node_t *old_node_ptr = &old_node;
+		mh_i64ptr_put(h, &node, &old_node_ptr, NULL);
+		if (old_node_ptr == NULL)
+			continue;
+		struct txn_stmt *prev = old_node_ptr->val;
+		struct tuple *prev_tuple = prev->new_tuple != NULL ?
+					   prev->new_tuple : prev->old_tuple;
+		/* Either a hash collision or another space. */
+		if (prev->space != stmt->space ||
+		    tuple_compare(prev_tuple, HINT_NONE, tuple, HINT_NONE,
+				  key_def) != 0)
+			continue;
+		txn_update_row_counts(txn, prev, -1);
+		prev->row = NULL;
+		struct request request;
+		memset(&request, 0, sizeof(request));
+		request.header = stmt->row;
+		request.type = stmt->row->type;
+		uint32_t size;
+		const char *data = tuple_data_range(tuple, &size);
+		if (stmt->new_tuple != NULL) {
+			rc = request_create_from_tuple(&request, stmt->space,
+						       NULL, 0, data, size,
+						       txn_region, false);
+		} else {
+			rc = request_create_from_tuple(&request, stmt->space,
+						       data, size, NULL, 0,
+						       txn_region, false);
+		}
+		if (rc != 0)
+			break;
+	}
+	tx_region_release(txn, TX_ALLOC_SYSTEM);
+	mh_i64ptr_delete(h);
+	txn_clear_flags(txn, TXN_HAS_COALESCIBLE_ROWS);
+	return rc;
+}
+
 static struct journal_entry *
 txn_journal_entry_new(struct txn *txn)
 {
@@ -885,6 +999,10 @@ txn_journal_entry_new(struct txn *txn)
 
 	assert(txn->n_new_rows + txn->n_applier_rows > 0);
 
+	if (txn_has_flag(txn, TXN_HAS_COALESCIBLE_ROWS) &&
+	    txn_coalesce_rows(txn) != 0)
+		return NULL;
+
 	struct region *txn_region = tx_region_acquire(txn);
 	req = journal_entry_new(txn->n_new_rows + txn->n_applier_rows,
 				txn_region, txn_on_journal_write, txn);
@@ -1114,6 +1232,7 @@ int
 txn_commit(struct txn *txn)
 {
 	struct journal_entry *req;
+	double wal_start;
 
 	txn->fiber = fiber();
 
@@ -1141,8 +1260,10 @@ txn_commit(struct txn *txn)
 	}
 
 	fiber_set_txn(fiber(), NULL);
+	wal_start = clock_monotonic();
 	if (journal_write(req) != 0)
 		goto rollback_io;
+	fiber()->storage.net.wal_wait += clock_monotonic() - wal_start;
 	if (req->res < 0) {
 		diag_set_journal_res(req->res);
 		goto rollback_io;
@@ -1307,6 +1428,22 @@ box_txn_commit(void)
 	return txn_commit(txn);
 }
 
+int
+txn_commit_submit(struct txn *txn, struct trigger *on_commit,
+		  struct trigger *on_rollback)
+{
+	assert(txn == in_txn());
+	if (txn->in_sub_stmt) {
+		diag_set(ClientError, ER_COMMIT_IN_SUB_STMT);
+		return -1;
+	}
+	if (txn_check_can_complete(txn) != 0)
+		return -1;
+	txn_on_commit(txn, on_commit);
+	txn_on_rollback(txn, on_rollback);
+	return txn_commit_try_async(txn);
+}
+
 int
 box_txn_rollback(void)
 {
@@ -1378,6 +1515,27 @@ box_txn_make_sync(void)
 	txn_set_flags(txn, TXN_WAIT_ACK);
 }
 
+int
+box_txn_make_read_only(void)
+{
+	struct txn *txn = in_txn();
+	if (txn == NULL) {
+		diag_set(ClientError, ER_NO_TRANSACTION);
+		return -1;
+	}
+	if (!stailq_empty(&txn->stmts)) {
+		diag_set(ClientError, ER_ACTIVE_TRANSACTION);
+		return -1;
+	}
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		return 0;
+	if (txn_check_can_continue(txn) != 0)
+		return -1;
+	txn_set_flags(txn, TXN_IS_READ_ONLY);
+	memtx_tx_make_read_only(txn);
+	return 0;
+}
+
 /** Wait for a linearization point for a transaction. */
 static int
 txn_make_linearizable(struct txn *txn)
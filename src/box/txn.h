@@ -110,6 +110,17 @@ enum txn_flag {
 	 * Transaction has been rolled back so it cannot be continued.
 	 */
 	TXN_IS_ROLLED_BACK = 0x200,
+	/*
+	 * Transaction was declared read-only, so it can't modify data.
+	 * With memtx MVCC it reads from a snapshot taken at start and
+	 * doesn't track its reads.
+	 */
+	TXN_IS_READ_ONLY = 0x400,
+	/*
+	 * Transaction has redo rows for spaces with the wal_coalesce
+	 * option, which may be merged before the WAL write.
+	 */
+	TXN_HAS_COALESCIBLE_ROWS = 0x800,
 };
 
 enum {
@@ -710,6 +721,23 @@ txn_abort(struct txn *txn);
 int
 txn_commit_try_async(struct txn *txn);
 
+/**
+ * Commit a transaction without waiting for the journal write, like
+ * COMMIT does for a user transaction.
+ * @pre txn == in_txn()
+ *
+ * Either @a on_commit or @a on_rollback trigger is run when the
+ * transaction is complete.
+ *
+ * Return 0 if the transaction was submitted to the journal. On error
+ * -1 is returned: if the transaction can't be completed now (e.g. it
+ * is inside a sub-statement), it is left intact and the triggers are
+ * not installed, otherwise it is rolled back and @a on_rollback is run.
+ */
+int
+txn_commit_submit(struct txn *txn, struct trigger *on_commit,
+		  struct trigger *on_rollback);
+
 /**
  * Most txns don't have triggers, and txn objects
  * are created on every access to data, so txns
@@ -1098,6 +1126,16 @@ box_txn_set_isolation(uint32_t level);
  */
 API_EXPORT void
 box_txn_make_sync(void);
+
+/**
+ * Make the transaction read-only. Must be called before the
+ * transaction makes any changes.
+ *
+ * @retval 0 if success
+ * @retval -1 if failed, diag is set.
+ */
+API_EXPORT int
+box_txn_make_read_only(void);
 /** \endcond public */
 
 typedef struct txn_savepoint box_txn_savepoint_t;
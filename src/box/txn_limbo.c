@@ -53,6 +53,8 @@ txn_limbo_create(struct txn_limbo *limbo)
 	limbo->promote_greatest_term = 0;
 	latch_create(&limbo->promote_latch);
 	limbo->confirmed_lsn = 0;
+	limbo->pending_confirm_lsn = 0;
+	limbo->is_writing_confirm = false;
 	limbo->rollback_count = 0;
 	limbo->is_in_rollback = false;
 	limbo->svp_confirmed_lsn = -1;
@@ -308,10 +310,13 @@ txn_limbo_wait_complete(struct txn_limbo *limbo, struct txn_limbo_entry *entry)
 
 	/* First in the queue is always a synchronous transaction. */
 	assert(entry->lsn > 0);
-	if (entry->lsn <= limbo->confirmed_lsn) {
+	if (entry->lsn <= limbo->confirmed_lsn ||
+	    (limbo->is_writing_confirm &&
+	     entry->lsn <= limbo->pending_confirm_lsn)) {
 		/*
 		 * Yes, the wait timed out, but there is an on-going CONFIRM WAL
-		 * write in another fiber covering this LSN. Can't rollback it
+		 * write in another fiber covering this LSN or the writer is
+		 * going to cover it with the next CONFIRM. Can't rollback it
 		 * already. All what can be done is waiting. The CONFIRM writer
 		 * will wakeup all the confirmed txns when WAL write will be
 		 * finished.
@@ -521,6 +526,42 @@ txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn)
 	}
 }
 
+/**
+ * Confirm all the entries <= @a lsn unless another fiber is writing
+ * a CONFIRM right now. In the latter case the LSN is handed over to
+ * the writer, which confirms it after the current write is done. Thus
+ * the ACKs received during a CONFIRM write are collected into a single
+ * CONFIRM instead of a CONFIRM per ACK.
+ *
+ * Note that a CONFIRM doesn't need a WAL write of its own under load: it is
+ * queued into the same WAL batch as the transactions submitted in the same
+ * event loop iteration, and the batch is synced to disk once.
+ */
+static void
+txn_limbo_confirm(struct txn_limbo *limbo, int64_t lsn)
+{
+	if (lsn > limbo->pending_confirm_lsn)
+		limbo->pending_confirm_lsn = lsn;
+	if (limbo->is_writing_confirm)
+		return;
+	limbo->is_writing_confirm = true;
+	/* Let more ACKs arrive so as to confirm them all at once. */
+	if (replication_synchro_confirm_delay > 0)
+		fiber_sleep(replication_synchro_confirm_delay);
+	/*
+	 * The limbo state may change while a CONFIRM is written, so check
+	 * it before writing the next one.
+	 */
+	while (limbo->pending_confirm_lsn > limbo->confirmed_lsn &&
+	       !limbo->is_in_rollback && !txn_limbo_is_ro(limbo)) {
+		lsn = limbo->pending_confirm_lsn;
+		txn_limbo_write_confirm(limbo, lsn);
+		txn_limbo_read_confirm(limbo, lsn);
+	}
+	limbo->pending_confirm_lsn = limbo->confirmed_lsn;
+	limbo->is_writing_confirm = false;
+}
+
 /**
  * Write a rollback message to WAL. After it's written all the
  * transactions following the current one and waiting for
@@ -704,8 +745,7 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	}
 	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
 		return;
-	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
+	txn_limbo_confirm(limbo, confirm_lsn);
 }
 
 /**
@@ -1258,10 +1298,8 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 			assert(confirm_lsn > 0);
 		}
 	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
-		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
-	}
+	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback)
+		txn_limbo_confirm(limbo, confirm_lsn);
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
 	 * there can be non-transactional waiters, such as CONFIRM
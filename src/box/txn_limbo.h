@@ -168,6 +168,15 @@ struct txn_limbo {
 	 * illegal.
 	 */
 	int64_t confirmed_lsn;
+	/**
+	 * Maximal LSN gathered quorum while a CONFIRM was being written by
+	 * another fiber. The writer confirms it once its write is done, so
+	 * that ACKs received during a CONFIRM write are confirmed with a
+	 * single WAL write. See is_writing_confirm.
+	 */
+	int64_t pending_confirm_lsn;
+	/** Whether a fiber is writing CONFIRM requests to WAL. */
+	bool is_writing_confirm;
 	/**
 	 * Total number of performed rollbacks. It used as a guard
 	 * to do some actions assuming all limbo transactions will
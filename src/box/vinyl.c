@@ -187,6 +187,14 @@ vy_env(struct engine *engine)
 	return (struct vy_env *)engine;
 }
 
+/** Account a read request in the load regulator. */
+static inline void
+vy_env_collect_read_latency(struct vy_lsm_env *lsm_env, double latency)
+{
+	struct vy_env *env = container_of(lsm_env, struct vy_env, lsm_env);
+	vy_regulator_collect_read_latency(&env->regulator, latency);
+}
+
 /** Extract vy_lsm from an index object. */
 struct vy_lsm *
 vy_lsm(struct index *index)
@@ -263,6 +271,7 @@ vy_info_append_regulator(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "rate_limit", vy_quota_get_rate_limit(r->quota,
 							VY_QUOTA_CONSUMER_TX));
 	info_append_int(h, "blocked_writers", r->quota->n_blocked);
+	info_append_double(h, "read_latency", r->read_latency_p99);
 	info_table_end(h); /* regulator */
 }
 
@@ -298,11 +307,23 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "level0", lsregion_used(&env->mem_env.allocator));
 	info_append_int(h, "tuple", env->stmt_env.sum_tuple_size);
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
+	info_append_int(h, "page_cache", env->run_env.page_cache.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
-	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
+	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size +
+			env->run_env.bloom_partition_size);
 	info_table_end(h); /* memory */
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache *cache = &env->run_env.page_cache;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "hit", cache->hit);
+	info_append_int(h, "miss", cache->miss);
+	info_table_end(h); /* page_cache */
+}
+
 static void
 vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 {
@@ -321,6 +342,7 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *h)
 	info_begin(h);
 	vy_info_append_tx(env, h);
 	vy_info_append_memory(env, h);
+	vy_info_append_page_cache(env, h);
 	vy_info_append_disk(env, h);
 	vy_info_append_scheduler(env, h);
 	vy_info_append_regulator(env, h);
@@ -510,6 +532,7 @@ vinyl_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 				env->mem_env.tree_extent_size;
 	stat->index += env->mem_env.tree_extent_size;
 	stat->index += env->lsm_env.bloom_size;
+	stat->index += env->run_env.bloom_partition_size;
 	stat->index += env->lsm_env.page_index_size;
 	stat->cache += env->cache_env.mem_used;
 	stat->tx += vy_tx_manager_mem_used(env->xm);
@@ -586,6 +609,11 @@ vinyl_engine_check_space_def(struct space_def *def)
 				 "Vinyl", "compression");
 			return -1;
 		}
+		if (def->fields[i].is_interned) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "Vinyl", "interned fields");
+			return -1;
+		}
 	}
 	if (space_opts_is_data_temporary(&def->opts)) {
 		diag_set(ClientError, ER_ALTER_SPACE,
@@ -593,6 +621,16 @@ vinyl_engine_check_space_def(struct space_def *def)
 			 "engine does not support data-temporary spaces");
 		return -1;
 	}
+	if (def->opts.iproto_read_view) {
+		diag_set(ClientError, ER_UNSUPPORTED,
+			 "Vinyl", "iproto_read_view");
+		return -1;
+	}
+	if (def->opts.wal_coalesce) {
+		diag_set(ClientError, ER_UNSUPPORTED,
+			 "Vinyl", "wal_coalesce");
+		return -1;
+	}
 	return 0;
 }
 
@@ -678,6 +716,18 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "hint is only reasonable with memtx tree index");
 		return -1;
 	}
+	if (index_def->opts.hash_func != INDEX_HASH_FUNC_MURMUR) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "hash_func is only reasonable with memtx hash index");
+		return -1;
+	}
+	if (index_def->opts.bucket_count != 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "bucket_count is only reasonable with memtx hash index");
+		return -1;
+	}
 
 	struct key_def *key_def = index_def->key_def;
 
@@ -694,6 +744,25 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "functional index");
 		return -1;
 	}
+	if (index_def->opts.ttl_field != 0 && index_def->iid > 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "ttl_field is only supported by primary index");
+		return -1;
+	}
+	/*
+	 * Surrogate DELETEs generated for secondary indexes and
+	 * skipped updates of secondary keys rely on the index key
+	 * covering all fields the index depends on.
+	 */
+	if (key_def->has_filter &&
+	    key_def_find_by_fieldno(index_def->cmp_def,
+				    key_def->filter.fieldno) == NULL) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name(space),
+			 "filter field must be indexed by the partial index");
+		return -1;
+	}
 	return 0;
 }
 
@@ -957,6 +1026,8 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.func_id != new_def->opts.func_id)
 		return true;
+	if (key_filter_cmp(&old_def->opts.filter, &new_def->opts.filter) != 0)
+		return true;
 
 	assert(index_depends_on_pk(index));
 	const struct key_def *old_key_def = old_def->key_def;
@@ -1244,6 +1315,29 @@ vinyl_index_bsize(struct index *index)
 	return bsize;
 }
 
+static ssize_t
+vinyl_index_approximate_count(struct index *base, enum iterator_type type,
+			      const char *key, uint32_t part_count)
+{
+	/*
+	 * Like vinyl_index_size(), count statements rather than
+	 * tuples, but only those that fall in the requested range.
+	 */
+	struct vy_lsm *lsm = vy_lsm(base);
+	if (type > ITER_GT) {
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		return -1;
+	}
+	struct vy_entry entry = vy_entry_key_new(lsm->env->key_format,
+						 lsm->cmp_def, key, part_count);
+	if (entry.stmt == NULL)
+		return -1;
+	uint64_t count = vy_lsm_estimate_count(lsm, type, entry);
+	tuple_unref(entry.stmt);
+	return count;
+}
+
 static void
 vinyl_index_compact(struct index *index)
 {
@@ -1482,6 +1576,7 @@ vy_get(struct vy_lsm *lsm, struct vy_tx *tx,
 
 	double latency = ev_monotonic_now(loop()) - start_time;
 	latency_collect(&lsm->stat.latency, latency);
+	vy_env_collect_read_latency(lsm->env, latency);
 
 	if (latency > lsm->env->too_long_threshold) {
 		say_warn_ratelimited("%s: get(%s) => %s "
@@ -1526,6 +1621,87 @@ vy_get_by_raw_key(struct vy_lsm *lsm, struct vy_tx *tx,
 	return rc;
 }
 
+/**
+ * Get tuples by @a count full keys. Works like vy_get() called
+ * for each key, but looks up all keys with one batched point
+ * lookup so that disk reads for different keys are grouped.
+ * The tuple found by keys[i] (or NULL) is returned in results[i]
+ * and must be unreferenced after usage. Nothing is returned on
+ * failure.
+ *
+ * @param  0 Success.
+ * @param -1 Memory error or read error.
+ */
+static int
+vy_get_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+	     const struct vy_read_view **rv,
+	     const struct vy_entry *keys, int count, struct tuple **results)
+{
+	double start_time = ev_monotonic_now(loop());
+	assert(tx == NULL || tx->state == VINYL_TX_READY);
+	/*
+	 * Make sure the LSM tree isn't deleted while we are
+	 * reading from it.
+	 */
+	vy_lsm_ref(lsm);
+
+	size_t region_svp = region_used(&fiber()->gc);
+	struct vy_entry *entries = xregion_alloc_array(&fiber()->gc,
+						       typeof(entries[0]),
+						       count);
+	int i;
+	lsm->stat.lookup += count;
+	if (tx != NULL) {
+		for (i = 0; i < count; i++) {
+			if (vy_tx_track_point(tx, lsm, keys[i]) != 0)
+				goto fail;
+		}
+	}
+	if (vy_point_lookup_batch(lsm, tx, rv, keys, count, entries) != 0)
+		goto fail;
+	for (i = 0; i < count; i++) {
+		struct vy_entry entry = entries[i];
+		if (lsm->index_id > 0 && entry.stmt != NULL) {
+			int rc = vy_get_by_secondary_tuple(lsm, tx, rv,
+							   entries[i], &entry);
+			tuple_unref(entries[i].stmt);
+			if (rc != 0) {
+				for (int j = i + 1; j < count; j++) {
+					if (entries[j].stmt != NULL)
+						tuple_unref(entries[j].stmt);
+				}
+				for (int j = 0; j < i; j++) {
+					if (results[j] != NULL)
+						tuple_unref(results[j]);
+				}
+				goto fail;
+			}
+		}
+		if ((*rv)->vlsn == INT64_MAX)
+			vy_cache_add_point(&lsm->cache, entry, keys[i]);
+		results[i] = entry.stmt;
+		if (entry.stmt != NULL)
+			vy_stmt_counter_acct_tuple(&lsm->stat.get, entry.stmt);
+	}
+	region_truncate(&fiber()->gc, region_svp);
+
+	double latency = ev_monotonic_now(loop()) - start_time;
+	latency_collect(&lsm->stat.latency, latency);
+	vy_env_collect_read_latency(lsm->env, latency);
+
+	if (latency > lsm->env->too_long_threshold) {
+		say_warn_ratelimited("%s: get_batch(%d keys) "
+				     "took too long: %.3f sec",
+				     vy_lsm_name(lsm), count, latency);
+	}
+	vy_lsm_unref(lsm);
+	return 0;
+fail:
+	region_truncate(&fiber()->gc, region_svp);
+	vy_lsm_unref(lsm);
+	return -1;
+}
+
 /**
  * Check if insertion of a new tuple violates unique constraint
  * of the primary index.
@@ -2565,6 +2741,13 @@ vy_env_trigger_dump_cb(struct vy_regulator *regulator)
 	return 0;
 }
 
+static int64_t
+vy_env_compaction_debt_cb(struct vy_regulator *regulator)
+{
+	struct vy_env *env = container_of(regulator, struct vy_env, regulator);
+	return env->lsm_env.compaction_queue_size;
+}
+
 static void
 vy_env_dump_complete_cb(struct vy_scheduler *scheduler,
 			int64_t dump_generation, double dump_duration)
@@ -2647,7 +2830,8 @@ vy_env_new(const char *path, size_t memory,
 
 	vy_quota_create(&e->quota, memory, vy_env_quota_exceeded_cb);
 	vy_regulator_create(&e->regulator, &e->quota,
-			    vy_env_trigger_dump_cb);
+			    vy_env_trigger_dump_cb,
+			    vy_env_compaction_debt_cb);
 
 	struct slab_cache *slab_cache = cord_slab_cache();
 	mempool_create(&e->iterator_pool, slab_cache,
@@ -2755,6 +2939,13 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_page_cache_quota(&env->run_env, quota);
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -2775,6 +2966,27 @@ vinyl_engine_set_max_tuple_size(struct engine *engine, size_t max_size)
 	env->stmt_env.max_tuple_size = max_size;
 }
 
+void
+vinyl_engine_set_os_cache(struct engine *engine, bool enabled)
+{
+	struct vy_env *env = vy_env(engine);
+	env->run_env.drop_os_cache = !enabled;
+}
+
+void
+vinyl_engine_set_read_ahead(struct engine *engine, size_t size)
+{
+	struct vy_env *env = vy_env(engine);
+	env->run_env.read_ahead = size;
+}
+
+void
+vinyl_engine_set_read_latency_budget(struct engine *engine, double budget)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_regulator_set_read_latency_budget(&env->regulator, budget);
+}
+
 void
 vinyl_engine_set_timeout(struct engine *engine, double timeout)
 {
@@ -3634,6 +3846,7 @@ vinyl_iterator_account_read(struct vinyl_iterator *it, double start_time,
 
 	double latency = ev_monotonic_now(loop()) - start_time;
 	latency_collect(&lsm->stat.latency, latency);
+	vy_env_collect_read_latency(lsm->env, latency);
 
 	if (latency > lsm->env->too_long_threshold) {
 		say_warn_ratelimited("%s: select(%s, %s) => %s "
@@ -3749,6 +3962,79 @@ vinyl_iterator_secondary_next(struct iterator *base, struct tuple **ret)
 	return -1;
 }
 
+/**
+ * Implementation of the iterator::next_key() method for secondary
+ * indexes. Unless the space defers DELETEs, a secondary index never
+ * stores statements overwritten in the primary index, so the key is
+ * read from the secondary index alone, without a primary index
+ * lookup. Otherwise stale statements have to be filtered out by
+ * the lookup, like vinyl_iterator_secondary_next() does.
+ *
+ * Read statements aren't added to the tuple cache, because it is
+ * supposed to store full tuples shared with the primary index.
+ */
+static int
+vinyl_iterator_secondary_next_key(struct iterator *base, struct tuple **ret)
+{
+	double start_time = ev_monotonic_now(loop());
+
+	assert(base->next_key == vinyl_iterator_secondary_next_key);
+	struct vinyl_iterator *it = (struct vinyl_iterator *)base;
+	struct vy_lsm *lsm = it->iterator.lsm;
+	assert(lsm->index_id > 0);
+	/*
+	 * Make sure the LSM tree isn't deleted while we are
+	 * reading from it.
+	 */
+	vy_lsm_ref(lsm);
+
+	struct vy_entry partial, entry;
+next:
+	if (vinyl_iterator_check_tx(it) != 0)
+		goto fail;
+
+	if (vy_read_iterator_next(&it->iterator, &partial) != 0)
+		goto fail;
+
+	if (partial.stmt == NULL) {
+		/* EOF. Close the iterator immediately. */
+		vinyl_iterator_account_read(it, start_time, NULL);
+		vinyl_iterator_close(it);
+		*ret = NULL;
+		goto out;
+	}
+	struct space *space = space_by_id(lsm->space_id);
+	if (space == NULL || space->def->opts.defer_deletes) {
+		if (vy_get_by_secondary_tuple(lsm, it->tx,
+					      vy_tx_read_view(it->tx),
+					      partial, &entry) != 0)
+			goto fail;
+		if (entry.stmt == NULL)
+			goto next;
+		*ret = iterator_key_tuple_new(entry.stmt, lsm->cmp_def);
+		tuple_unref(entry.stmt);
+	} else if (vy_stmt_is_key(partial.stmt)) {
+		/* Statements read from disk store extended keys. */
+		uint32_t size;
+		const char *data = tuple_data_range(partial.stmt, &size);
+		*ret = tuple_new(tuple_format_runtime, data, data + size);
+		if (*ret != NULL)
+			tuple_bless(*ret);
+	} else {
+		*ret = iterator_key_tuple_new(partial.stmt, lsm->cmp_def);
+	}
+	if (*ret == NULL)
+		goto fail;
+	vinyl_iterator_account_read(it, start_time, partial.stmt);
+out:
+	vy_lsm_unref(lsm);
+	return 0;
+fail:
+	vinyl_iterator_close(it);
+	vy_lsm_unref(lsm);
+	return -1;
+}
+
 /** Implementation of the iterator::position() method. */
 static int
 vinyl_iterator_position(struct iterator *base, const char **pos, uint32_t *size)
@@ -3833,8 +4119,10 @@ vinyl_index_create_iterator(struct index *base, enum iterator_type type,
 	iterator_create(&it->base, base);
 	if (lsm->index_id == 0)
 		it->base.next = vinyl_iterator_primary_next;
-	else
+	else {
 		it->base.next = vinyl_iterator_secondary_next;
+		it->base.next_key = vinyl_iterator_secondary_next_key;
+	}
 	it->base.position = vinyl_iterator_position;
 	it->base.free = vinyl_iterator_free;
 	it->pool = &env->iterator_pool;
@@ -3898,6 +4186,55 @@ vinyl_index_get(struct index *index, const char *key,
 	return 0;
 }
 
+static int
+vinyl_index_get_batch(struct index *index, const char *keys,
+		      uint32_t key_count, struct tuple **results)
+{
+	assert(index->def->opts.is_unique);
+
+	struct vy_lsm *lsm = vy_lsm(index);
+	struct vy_env *env = vy_env(index->engine);
+	struct vy_tx *tx = in_txn() ? in_txn()->engine_tx : NULL;
+	if (tx != NULL && tx->state == VINYL_TX_ABORT) {
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		return -1;
+	}
+	if (key_count == 0)
+		return 0;
+
+	size_t region_svp = region_used(&fiber()->gc);
+	struct vy_entry *key_entries = xregion_alloc_array(
+			&fiber()->gc, typeof(key_entries[0]), key_count);
+	uint32_t i;
+	int rc = -1;
+	for (i = 0; i < key_count; i++) {
+		uint32_t part_count = mp_decode_array(&keys);
+		assert(index->def->key_def->part_count == part_count);
+		struct tuple *key = vy_key_new(env->key_format, keys,
+					       part_count);
+		if (key == NULL)
+			goto out;
+		key_entries[i].stmt = key;
+		key_entries[i].hint = vy_stmt_hint(key, lsm->cmp_def);
+		for (uint32_t j = 0; j < part_count; j++)
+			mp_next(&keys);
+	}
+	struct vy_tx tx_autocommit;
+	if (tx == NULL) {
+		tx = &tx_autocommit;
+		vy_tx_create(env->xm, tx);
+	}
+	rc = vy_get_batch(lsm, tx, vy_tx_read_view(tx), key_entries,
+			  key_count, results);
+	if (tx == &tx_autocommit)
+		vy_tx_destroy(tx);
+out:
+	while (i-- > 0)
+		tuple_unref(key_entries[i].stmt);
+	region_truncate(&fiber()->gc, region_svp);
+	return rc;
+}
+
 /*** }}} Cursor */
 
 /* {{{ Index build */
@@ -4672,8 +5009,10 @@ static const struct index_vtab vinyl_index_vtab = {
 	/* .max = */ generic_index_max,
 	/* .random = */ generic_index_random,
 	/* .count = */ generic_index_count,
+	/* .approximate_count = */ vinyl_index_approximate_count,
 	/* .get_internal = */ generic_index_get_internal,
 	/* .get = */ vinyl_index_get,
+	/* .get_batch = */ vinyl_index_get_batch,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ vinyl_index_create_iterator,
 	/* .create_read_view = */ generic_index_create_read_view,
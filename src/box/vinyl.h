@@ -57,6 +57,12 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Update the size of the cache of decompressed run pages.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
 /**
  * Update vinyl memory size.
  */
@@ -69,6 +75,24 @@ vinyl_engine_set_memory(struct engine *engine, size_t size);
 void
 vinyl_engine_set_max_tuple_size(struct engine *engine, size_t max_size);
 
+/**
+ * Enable or disable caching of run files by the OS.
+ */
+void
+vinyl_engine_set_os_cache(struct engine *engine, bool enabled);
+
+/**
+ * Update the amount of data read ahead by range scans.
+ */
+void
+vinyl_engine_set_read_ahead(struct engine *engine, size_t size);
+
+/**
+ * Update the target 99th percentile of read latency.
+ */
+void
+vinyl_engine_set_read_latency_budget(struct engine *engine, double budget);
+
 /**
  * Update query timeout.
  */
@@ -37,6 +37,7 @@
 #include <small/rlist.h>
 
 #include "diag.h"
+#include "fiber.h"
 #include "tuple.h"
 #include "iproto_constants.h"
 #include "vy_stmt.h"
@@ -79,13 +80,15 @@ vy_history_cleanup(struct vy_history *history)
 
 int
 vy_history_apply(struct vy_history *history, struct key_def *cmp_def,
-		 bool keep_delete, int *upserts_applied, struct vy_entry *ret)
+		 uint32_t ttl_field, bool keep_delete, int *upserts_applied,
+		 struct vy_entry *ret)
 {
 	*ret = vy_entry_none();
 	*upserts_applied = 0;
 	if (rlist_empty(&history->stmts))
 		return 0;
 
+	double now = ttl_field != 0 ? fiber_time() : 0;
 	struct vy_entry curr = vy_entry_none();
 	struct vy_history_node *node = rlist_last_entry(&history->stmts,
 					struct vy_history_node, link);
@@ -96,6 +99,14 @@ vy_history_apply(struct vy_history *history, struct key_def *cmp_def,
 			 * Ignore terminal delete unless the caller
 			 * explicitly asked to keep it.
 			 */
+		} else if (vy_stmt_is_expired(node->entry.stmt, ttl_field,
+					      now) &&
+			   (!keep_delete || rlist_first_entry(&history->stmts,
+					struct vy_history_node, link) != node)) {
+			/*
+			 * An expired statement is a DELETE. Keep it
+			 * only if there are no UPSERTs to apply.
+			 */
 		} else {
 			curr = node->entry;
 			tuple_ref(curr.stmt);
@@ -113,6 +124,11 @@ vy_history_apply(struct vy_history *history, struct key_def *cmp_def,
 		curr = entry;
 		node = rlist_prev_entry_safe(node, &history->stmts, link);
 	}
+	if (!keep_delete && curr.stmt != NULL &&
+	    vy_stmt_is_expired(curr.stmt, ttl_field, now)) {
+		tuple_unref(curr.stmt);
+		curr = vy_entry_none();
+	}
 	*ret = curr;
 	return 0;
 }
@@ -135,10 +135,18 @@ vy_history_cleanup(struct vy_history *history);
  * Get a resultant statement from collected history.
  * If the resultant statement is a DELETE, the function
  * will return NULL unless @keep_delete flag is set.
+ *
+ * If @ttl_field is not zero, an expired terminal statement
+ * (see vy_stmt_is_expired()) is treated as a DELETE, i.e.
+ * UPSERTs are applied as if there were no terminal statement.
+ * An expired resultant statement is returned only if
+ * @keep_delete flag is set, in which case it is up to the
+ * caller to skip it.
  */
 int
 vy_history_apply(struct vy_history *history, struct key_def *cmp_def,
-		 bool keep_delete, int *upserts_applied, struct vy_entry *ret);
+		 uint32_t ttl_field, bool keep_delete, int *upserts_applied,
+		 struct vy_entry *ret);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -795,13 +795,51 @@ vy_log_tx_delete(struct vy_log_tx *tx)
 	mempool_free(&vy_log.tx_pool, tx);
 }
 
+/** Return the number of records in a given transaction. */
+static int
+vy_log_tx_record_count(struct vy_log_tx *tx)
+{
+	int count = 0;
+	struct vy_log_record *record;
+	stailq_foreach_entry(record, &tx->records, in_tx)
+		count++;
+	return count;
+}
+
+/**
+ * Encode records of a given transaction to journal entry rows
+ * starting from the row number @a row_count, which is advanced.
+ */
+static int
+vy_log_tx_encode(struct vy_log_tx *tx, struct journal_entry *entry,
+		 struct xrow_header *rows, int *row_count)
+{
+	struct vy_log_record *record;
+	stailq_foreach_entry(record, &tx->records, in_tx) {
+		if (record->gc_lsn == VY_LOG_GC_LSN_CURRENT)
+			record->gc_lsn = vy_log_signature();
+		struct xrow_header *row = &rows[*row_count];
+		if (vy_log_record_encode(record, row) < 0)
+			return -1;
+		entry->rows[(*row_count)++] = row;
+	}
+	return 0;
+}
+
 /**
- * Write a given transaction to disk.
+ * Write given transactions to disk: a list of transactions linked by
+ * vy_log_tx::in_pending followed by @a last, which may be NULL. All of
+ * them are written in one journal entry so that the disk write and sync
+ * are paid once no matter how many transactions are pending.
  */
 static int
-vy_log_tx_flush(struct vy_log_tx *tx)
+vy_log_tx_flush(struct stailq *txs, struct vy_log_tx *last)
 {
-	if (stailq_empty(&tx->records))
+	int tx_size = last != NULL ? vy_log_tx_record_count(last) : 0;
+	struct vy_log_tx *tx;
+	stailq_foreach_entry(tx, txs, in_pending)
+		tx_size += vy_log_tx_record_count(tx);
+	if (tx_size == 0)
 		return 0; /* nothing to do */
 
 	ERROR_INJECT(ERRINJ_VY_LOG_FLUSH, {
@@ -809,11 +847,6 @@ vy_log_tx_flush(struct vy_log_tx *tx)
 		return -1;
 	});
 
-	int tx_size = 0;
-	struct vy_log_record *record;
-	stailq_foreach_entry(record, &tx->records, in_tx)
-		tx_size++;
-
 	size_t used = region_used(&fiber()->gc);
 
 	struct journal_entry *entry;
@@ -832,16 +865,12 @@ vy_log_tx_flush(struct vy_log_tx *tx)
 	 * Encode buffered records.
 	 */
 	int i = 0;
-	stailq_foreach_entry(record, &tx->records, in_tx) {
-		if (record->gc_lsn == VY_LOG_GC_LSN_CURRENT)
-			record->gc_lsn = vy_log_signature();
-		assert(i < tx_size);
-		struct xrow_header *row = &rows[i];
-		if (vy_log_record_encode(record, row) < 0)
+	stailq_foreach_entry(tx, txs, in_pending) {
+		if (vy_log_tx_encode(tx, entry, rows, &i) != 0)
 			goto err;
-		entry->rows[i] = row;
-		i++;
 	}
+	if (last != NULL && vy_log_tx_encode(last, entry, rows, &i) != 0)
+		goto err;
 	assert(i == tx_size);
 
 	/*
@@ -859,15 +888,16 @@ vy_log_tx_flush(struct vy_log_tx *tx)
 }
 
 /**
- * Write all pending transaction to disk.
+ * Write all pending transactions to disk followed by @a tx unless it's
+ * NULL. The caller owns @a tx and must delete it.
  */
 static int
-vy_log_flush(void)
+vy_log_flush(struct vy_log_tx *tx)
 {
 	/*
 	 * vy_log_tx_try_commit() can add a new transaction to
 	 * the list while we are writing to disk. This is okay -
-	 * we'll flush it next time. If we fail, we put remaining
+	 * we'll flush it next time. If we fail, we put the
 	 * transactions back to the head of the list to preserve
 	 * the commit order.
 	 */
@@ -875,15 +905,12 @@ vy_log_flush(void)
 	stailq_create(&pending);
 	stailq_concat(&pending, &vy_log.pending_tx);
 
-	int rc = 0;
-	while (!stailq_empty(&pending)) {
-		struct vy_log_tx *tx = stailq_first_entry(&pending,
-					struct vy_log_tx, in_pending);
-		rc = vy_log_tx_flush(tx);
-		if (rc != 0)
-			break;
-		stailq_shift(&pending);
-		vy_log_tx_delete(tx);
+	int rc = vy_log_tx_flush(&pending, tx);
+	if (rc == 0) {
+		struct vy_log_tx *flushed, *next;
+		stailq_foreach_entry_safe(flushed, next, &pending, in_pending)
+			vy_log_tx_delete(flushed);
+		stailq_create(&pending);
 	}
 	stailq_concat(&pending, &vy_log.pending_tx);
 	stailq_concat(&vy_log.pending_tx, &pending);
@@ -906,7 +933,7 @@ vy_log_flusher_f(va_list va)
 			continue;
 		}
 		latch_lock(&vy_log.latch);
-		int rc = vy_log_flush();
+		int rc = vy_log_flush(NULL);
 		latch_unlock(&vy_log.latch);
 		if (rc != 0) {
 			diag_log();
@@ -1206,7 +1233,7 @@ vy_log_end_recovery(void)
 	}
 
 	/* Flush all pending records. */
-	if (vy_log_flush() < 0) {
+	if (vy_log_flush(NULL) < 0) {
 		diag_log();
 		say_error("failed to flush vylog after recovery");
 		return -1;
@@ -1367,9 +1394,7 @@ vy_log_tx_commit(void)
 	 * if any, because they were committed first.
 	 */
 	latch_lock(&vy_log.latch);
-	int rc = vy_log_flush();
-	if (rc == 0)
-		rc = vy_log_tx_flush(tx);
+	int rc = vy_log_flush(tx);
 	latch_unlock(&vy_log.latch);
 
 	vy_log_tx_delete(tx);
@@ -2467,7 +2492,7 @@ vy_recovery_new_locked(int64_t signature, int flags)
 	 * Before proceeding to log recovery, make sure that all
 	 * pending records have been flushed out.
 	 */
-	rc = vy_log_flush();
+	rc = vy_log_flush(NULL);
 	if (rc != 0) {
 		diag_log();
 		say_error("failed to flush vylog for recovery");
@@ -1040,6 +1040,26 @@ vy_lsm_rollback_stmt(struct vy_lsm *lsm, struct vy_mem *mem,
 	vy_cache_on_write(&lsm->cache, entry, NULL);
 }
 
+uint64_t
+vy_lsm_estimate_count(struct vy_lsm *lsm, enum iterator_type type,
+		      struct vy_entry key)
+{
+	uint64_t count = vy_mem_count(lsm->mem, type, key);
+	struct vy_mem *mem;
+	rlist_foreach_entry(mem, &lsm->sealed, in_sealed)
+		count += vy_mem_count(mem, type, key);
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		struct vy_slice *slice;
+		rlist_foreach_entry(slice, &range->slices, in_range) {
+			count += vy_slice_estimate_count(slice, type, key,
+							 lsm->cmp_def);
+		}
+	}
+	return count;
+}
+
 int
 vy_lsm_find_range_intersection(struct vy_lsm *lsm,
 		const char *min_key, const char *max_key,
@@ -1071,6 +1091,7 @@ vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
 
 	const char *split_key_raw;
 	if (!vy_range_needs_split(range, vy_lsm_range_size(lsm),
+				  lsm->opts.parallel_compaction,
 				  &split_key_raw))
 		return false;
 
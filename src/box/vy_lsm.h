@@ -560,6 +560,17 @@ vy_lsm_rotate_mem_if_required(struct vy_lsm *lsm);
 void
 vy_lsm_delete_mem(struct vy_lsm *lsm, struct vy_mem *mem);
 
+/**
+ * Estimate the number of statements stored in an LSM tree that
+ * match the given key and iterator type without reading any data
+ * from disk. The in-memory trees are counted precisely while for
+ * runs only the page index is used, see vy_slice_estimate_count().
+ * All versions of a key, including DELETEs, are counted.
+ */
+uint64_t
+vy_lsm_estimate_count(struct vy_lsm *lsm, enum iterator_type type,
+		      struct vy_entry key);
+
 /**
  * Lookup ranges intersecting [min_key, max_key] interval in
  * the given LSM tree.
@@ -132,6 +132,46 @@ vy_mem_delete(struct vy_mem *index)
 	free(index);
 }
 
+size_t
+vy_mem_count(struct vy_mem *mem, enum iterator_type type,
+	     struct vy_entry key)
+{
+	size_t size = vy_mem_tree_size(&mem->tree);
+	if (type == ITER_ALL || vy_stmt_is_empty_key(key.stmt))
+		return size;
+	/* Match all versions of the key. */
+	struct vy_mem_tree_key tree_key;
+	tree_key.entry = key;
+	tree_key.lsn = INT64_MAX - 1;
+	size_t lower = size, upper = size;
+	if (type == ITER_EQ || type == ITER_REQ ||
+	    type == ITER_GE || type == ITER_LT) {
+		vy_mem_tree_lower_bound_get_offset(&mem->tree, &tree_key,
+						   NULL, &lower);
+	}
+	if (type == ITER_EQ || type == ITER_REQ ||
+	    type == ITER_GT || type == ITER_LE) {
+		vy_mem_tree_upper_bound_get_offset(&mem->tree, &tree_key,
+						   NULL, &upper);
+	}
+	switch (type) {
+	case ITER_EQ:
+	case ITER_REQ:
+		return upper - lower;
+	case ITER_GE:
+		return size - lower;
+	case ITER_GT:
+		return size - upper;
+	case ITER_LE:
+		return upper;
+	case ITER_LT:
+		return lower;
+	default:
+		unreachable();
+		return 0;
+	}
+}
+
 struct vy_entry
 vy_mem_older_lsn(struct vy_mem *mem, struct vy_entry entry)
 {
@@ -125,6 +125,8 @@ vy_mem_tree_cmp_key(struct vy_entry entry, struct vy_mem_tree_key *key,
 #define bps_tree_elem_t struct vy_entry
 #define bps_tree_key_t struct vy_mem_tree_key *
 #define bps_tree_arg_t struct key_def *
+/* Inner block cardinalities are used for estimating range sizes. */
+#define BPS_INNER_CARD
 
 #include <salad/bps_tree.h>
 
@@ -137,6 +139,7 @@ vy_mem_tree_cmp_key(struct vy_entry entry, struct vy_mem_tree_key *key,
 #undef bps_tree_key_t
 #undef bps_tree_arg_t
 #undef BPS_TREE_IS_IDENTICAL
+#undef BPS_INNER_CARD
 
 /** @endcond false */
 
@@ -278,6 +281,15 @@ vy_mem_delete(struct vy_mem *index);
 struct vy_entry
 vy_mem_older_lsn(struct vy_mem *mem, struct vy_entry entry);
 
+/**
+ * Return the number of statements in an in-memory tree matching
+ * the given key and iterator type. All versions of the same key
+ * are counted. Complexity is O(log N).
+ */
+size_t
+vy_mem_count(struct vy_mem *mem, enum iterator_type type,
+	     struct vy_entry key);
+
 /**
  * Insert a statement into the in-memory level.
  * @param mem        vy_mem.
@@ -305,7 +305,8 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 	if (rc == 0) {
 		int upserts_applied;
 		rc = vy_history_apply(&history, lsm->cmp_def,
-				      false, &upserts_applied, ret);
+				      lsm->opts.ttl_field, false,
+				      &upserts_applied, ret);
 		lsm->stat.upsert.applied += upserts_applied;
 	}
 	vy_history_cleanup(&history);
@@ -316,6 +317,259 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 	return 0;
 }
 
+/** State of a key looked up by vy_point_lookup_batch(). */
+struct vy_point_lookup_batch_key {
+	/** Key to look up. */
+	struct vy_entry key;
+	/** History collected from txw and cache. */
+	struct vy_history history;
+	/** History collected from mems. */
+	struct vy_history mem_history;
+	/** History collected from runs. */
+	struct vy_history disk_history;
+	/** Set if txw or cache returned a terminal statement. */
+	bool is_done;
+	/** Slices of the range containing the key, pinned. */
+	struct vy_slice **slices;
+	/** Number of entries in the slices array. */
+	int slice_count;
+};
+
+/** Return true if a key of a batch needs to be looked up on disk. */
+static inline bool
+vy_point_lookup_batch_key_needs_disk(struct vy_point_lookup_batch_key *k)
+{
+	return !k->is_done && !vy_history_is_terminal(&k->mem_history);
+}
+
+/**
+ * Scan slices for all keys of a batch that need it. Slices are
+ * scanned level by level: on each iteration we open an iterator
+ * over the next slice for each key that doesn't have a terminal
+ * statement yet and prefetch pages for all of them at once. All
+ * slices are pinned before the first scan, see the comment to
+ * vy_point_lookup_scan_slices().
+ */
+static int
+vy_point_lookup_batch_scan_slices(struct vy_lsm *lsm,
+				  const struct vy_read_view **rv,
+				  struct vy_point_lookup_batch_key *batch,
+				  int count)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	for (int i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_key *k = &batch[i];
+		if (!vy_point_lookup_batch_key_needs_disk(k))
+			continue;
+		struct vy_range *range = vy_range_tree_find_by_key(
+				&lsm->range_tree, ITER_EQ, k->key);
+		assert(range != NULL);
+		if (range->slice_count == 0)
+			continue;
+		k->slices = xregion_alloc_array(region, typeof(k->slices[0]),
+						range->slice_count);
+		struct vy_slice *slice;
+		rlist_foreach_entry(slice, &range->slices, in_range) {
+			vy_slice_pin(slice);
+			k->slices[k->slice_count++] = slice;
+		}
+		assert(k->slice_count == range->slice_count);
+	}
+	struct vy_run_iterator *itrs =
+		xregion_alloc_array(region, typeof(itrs[0]), count);
+	struct vy_run_iterator **itr_ptrs =
+		xregion_alloc_array(region, typeof(itr_ptrs[0]), count);
+	struct vy_point_lookup_batch_key **itr_keys =
+		xregion_alloc_array(region, typeof(itr_keys[0]), count);
+	int rc = 0;
+	for (int level = 0; rc == 0; level++) {
+		int itr_count = 0;
+		for (int i = 0; i < count; i++) {
+			struct vy_point_lookup_batch_key *k = &batch[i];
+			if (level >= k->slice_count ||
+			    vy_history_is_terminal(&k->disk_history))
+				continue;
+			struct vy_run_iterator *itr = &itrs[itr_count];
+			vy_run_iterator_open(itr, &lsm->stat.disk.iterator,
+					     k->slices[level], ITER_EQ, k->key,
+					     rv, lsm->cmp_def, lsm->key_def,
+					     lsm->disk_format);
+			itr_ptrs[itr_count] = itr;
+			itr_keys[itr_count] = k;
+			itr_count++;
+		}
+		if (itr_count == 0)
+			break;
+		rc = vy_run_iterator_prefetch(itr_ptrs, itr_count);
+		for (int i = 0; i < itr_count; i++) {
+			if (rc == 0) {
+				struct vy_history slice_history;
+				vy_history_create(&slice_history,
+						  &lsm->env->history_node_pool);
+				rc = vy_run_iterator_next(&itrs[i],
+							  &slice_history);
+				vy_history_splice(&itr_keys[i]->disk_history,
+						  &slice_history);
+			}
+			vy_run_iterator_close(&itrs[i]);
+		}
+	}
+	for (int i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_key *k = &batch[i];
+		for (int j = 0; j < k->slice_count; j++)
+			vy_slice_unpin(k->slices[j]);
+		k->slices = NULL;
+		k->slice_count = 0;
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      const struct vy_entry *keys, int count,
+		      struct vy_entry *ret)
+{
+	assert(tx == NULL || tx->state == VINYL_TX_READY);
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct vy_point_lookup_batch_key *batch =
+		xregion_alloc_array(region, typeof(batch[0]), count);
+	int rc = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		/* All key parts must be set for a point lookup. */
+		assert(vy_stmt_is_full_key(keys[i].stmt, lsm->cmp_def));
+		struct vy_point_lookup_batch_key *k = &batch[i];
+		k->key = keys[i];
+		k->is_done = false;
+		k->slices = NULL;
+		k->slice_count = 0;
+		vy_history_create(&k->history, &lsm->env->history_node_pool);
+		vy_history_create(&k->mem_history,
+				  &lsm->env->history_node_pool);
+		vy_history_create(&k->disk_history,
+				  &lsm->env->history_node_pool);
+		ret[i] = vy_entry_none();
+	}
+
+	bool is_prepared_ok = tx != NULL ? vy_tx_is_prepared_ok(tx) : false;
+	for (i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_key *k = &batch[i];
+		rc = vy_point_lookup_scan_txw(lsm, tx, k->key, &k->history);
+		if (rc != 0)
+			goto done;
+		if (vy_history_is_terminal(&k->history)) {
+			k->is_done = true;
+			continue;
+		}
+		rc = vy_point_lookup_scan_cache(lsm, rv, is_prepared_ok,
+						k->key, &k->history);
+		if (rc != 0)
+			goto done;
+		if (vy_history_is_terminal(&k->history))
+			k->is_done = true;
+	}
+
+restart:
+	for (i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_key *k = &batch[i];
+		if (k->is_done)
+			continue;
+		rc = vy_point_lookup_scan_mems(lsm, tx, rv, is_prepared_ok,
+					       k->key, &k->mem_history);
+		if (rc != 0)
+			goto done;
+	}
+
+	/* Save version before yield */
+	uint32_t mem_version = lsm->mem->version;
+	uint32_t mem_list_version = lsm->mem_list_version;
+
+	rc = vy_point_lookup_batch_scan_slices(lsm, rv, batch, count);
+	if (rc != 0)
+		goto done;
+
+	ERROR_INJECT(ERRINJ_VY_POINT_ITER_WAIT, {
+		while (mem_list_version == lsm->mem_list_version)
+			fiber_sleep(0.01);
+		/* Turn of the injection to avoid infinite loop */
+		errinj(ERRINJ_VY_POINT_ITER_WAIT, ERRINJ_BOOL)->bparam = false;
+	});
+
+	if (tx != NULL && tx->state == VINYL_TX_ABORT) {
+		/* See the comment in vy_point_lookup(). */
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		rc = -1;
+		goto done;
+	}
+
+	if (mem_list_version != lsm->mem_list_version) {
+		/*
+		 * Mem list was changed during yield. Statements
+		 * read from mems of all keys may be gone, even of
+		 * those that didn't need disk, so reread history
+		 * of all keys, see vy_point_lookup().
+		 */
+		for (i = 0; i < count; i++) {
+			vy_history_cleanup(&batch[i].mem_history);
+			vy_history_cleanup(&batch[i].disk_history);
+		}
+		goto restart;
+	}
+
+	if (mem_version != lsm->mem->version) {
+		/*
+		 * Rescan the memory level if its version changed while we
+		 * were reading disk, because there may be new statements
+		 * matching the search keys.
+		 */
+		for (i = 0; i < count; i++) {
+			struct vy_point_lookup_batch_key *k = &batch[i];
+			if (k->is_done)
+				continue;
+			vy_history_cleanup(&k->mem_history);
+			rc = vy_point_lookup_scan_mems(lsm, tx, rv,
+						       is_prepared_ok, k->key,
+						       &k->mem_history);
+			if (rc != 0)
+				goto done;
+			if (vy_history_is_terminal(&k->mem_history))
+				vy_history_cleanup(&k->disk_history);
+		}
+	}
+
+done:
+	for (i = 0; i < count; i++) {
+		struct vy_point_lookup_batch_key *k = &batch[i];
+		vy_history_splice(&k->history, &k->mem_history);
+		vy_history_splice(&k->history, &k->disk_history);
+		if (rc == 0) {
+			int upserts_applied;
+			rc = vy_history_apply(&k->history, lsm->cmp_def,
+					      lsm->opts.ttl_field, false,
+					      &upserts_applied, &ret[i]);
+			lsm->stat.upsert.applied += upserts_applied;
+		}
+		vy_history_cleanup(&k->history);
+	}
+	region_truncate(region, region_svp);
+
+	if (rc != 0) {
+		for (i = 0; i < count; i++) {
+			if (ret[i].stmt != NULL)
+				tuple_unref(ret[i].stmt);
+			ret[i] = vy_entry_none();
+		}
+		return -1;
+	}
+	return 0;
+}
+
 int
 vy_point_lookup_mem(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		    struct vy_entry key, struct vy_entry *ret)
@@ -342,7 +596,8 @@ vy_point_lookup_mem(struct vy_lsm *lsm, const struct vy_read_view **rv,
 	if (rc == 0) {
 		int upserts_applied;
 		rc = vy_history_apply(&history, lsm->cmp_def,
-				      true, &upserts_applied, ret);
+				      /*ttl_field=*/0, true,
+				      &upserts_applied, ret);
 		lsm->stat.upsert.applied += upserts_applied;
 	}
 out:
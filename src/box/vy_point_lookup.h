@@ -70,6 +70,21 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 		const struct vy_read_view **rv,
 		struct vy_entry key, struct vy_entry *ret);
 
+/**
+ * Look up tuples by @a count keys. Works like vy_point_lookup()
+ * called for each key, but reads runs level by level: for each
+ * key still lacking a terminal statement, the next slice of its
+ * range is checked with one batched disk read per level instead
+ * of one disk read per key. The result for keys[i] is returned in
+ * ret[i] with its reference counter elevated. Nothing is returned
+ * on failure.
+ */
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      const struct vy_entry *keys, int count,
+		      struct vy_entry *ret);
+
 /**
  * Look up a tuple by key in memory.
  *
@@ -284,28 +284,10 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * to be compacted and sets @compaction_priority to the number of runs
  * in this level and all preceding levels.
  */
-void
-vy_range_update_compaction_priority(struct vy_range *range,
-				    const struct index_opts *opts)
+static void
+vy_range_update_compaction_priority_leveled(struct vy_range *range,
+					    const struct index_opts *opts)
 {
-	assert(opts->run_count_per_level > 0);
-	assert(opts->run_size_ratio > 1);
-
-	range->compaction_priority = 0;
-	vy_disk_stmt_counter_reset(&range->compaction_queue);
-
-	if (range->slice_count <= 1) {
-		/* Nothing to compact. */
-		range->needs_compaction = false;
-		return;
-	}
-
-	if (range->needs_compaction) {
-		range->compaction_priority = range->slice_count;
-		range->compaction_queue = range->count;
-		return;
-	}
-
 	/* Total number of statements in checked runs. */
 	struct vy_disk_stmt_counter total_stmt_count;
 	vy_disk_stmt_counter_reset(&total_stmt_count);
@@ -425,6 +407,127 @@ vy_range_update_compaction_priority(struct vy_range *range,
 	}
 }
 
+/**
+ * Tiered compaction trades read and space amplification for lower
+ * write amplification. Runs in each range are divided into groups
+ * called tiers, newer runs first, so that runs of the same tier
+ * have similar size: a run starts a new tier if it is more than
+ * run_size_ratio times larger than an average run of the current
+ * tier. When the number of runs in a tier exceeds
+ * run_count_per_level, we compact all its runs along with all runs
+ * from the upper tiers, which are smaller, and in-memory indexes.
+ * The compacted run ends up in the next tier.
+ *
+ * Unlike leveled compaction, the last tier may store more than one
+ * run and isn't compacted until it overflows, too. As a result,
+ * a statement is rewritten once per tier rather than up to
+ * run_count_per_level times per level, at the cost of keeping up
+ * to run_count_per_level runs of a similar size at each tier.
+ *
+ * Given a range, this function computes the maximal tier that needs
+ * to be compacted and sets @compaction_priority to the number of runs
+ * in this tier and all preceding tiers.
+ */
+static void
+vy_range_update_compaction_priority_tiered(struct vy_range *range,
+					   const struct index_opts *opts)
+{
+	/* Total number of statements in checked runs. */
+	struct vy_disk_stmt_counter total_stmt_count;
+	vy_disk_stmt_counter_reset(&total_stmt_count);
+	/* Total number of checked runs. */
+	uint32_t total_run_count = 0;
+	/* Estimated size of a compacted run, if compaction is scheduled. */
+	uint64_t est_new_run_size = 0;
+	/* The number of runs at the current tier. */
+	uint32_t tier_run_count = 0;
+	/* The total size of runs at the current tier. */
+	uint64_t tier_size = 0;
+
+	struct vy_slice *slice;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		uint64_t size = slice->count.bytes;
+		if (tier_run_count > 0 &&
+		    (double)size > (double)tier_size / tier_run_count *
+				   opts->run_size_ratio) {
+			/*
+			 * The run is much larger than runs of the
+			 * current tier. Switch to the next tier.
+			 */
+			tier_run_count = 0;
+			tier_size = 0;
+			/*
+			 * If we have already scheduled a compaction
+			 * of upper tiers, and the estimated compacted
+			 * run will end up at this tier, include it
+			 * into this tier right away to avoid
+			 * a cascading compaction.
+			 */
+			if ((double)est_new_run_size * opts->run_size_ratio >=
+			    (double)size) {
+				tier_run_count++;
+				tier_size += est_new_run_size;
+			}
+		}
+		tier_run_count++;
+		tier_size += size;
+		total_run_count++;
+		vy_disk_stmt_counter_add(&total_stmt_count, &slice->count);
+		/*
+		 * Randomize compaction pace among ranges, see
+		 * vy_range_update_compaction_priority_leveled().
+		 */
+		uint32_t max_run_count = opts->run_count_per_level;
+		if (slice->seed < RAND_MAX / 10)
+			max_run_count++;
+		if (tier_run_count > max_run_count) {
+			/*
+			 * The number of runs at the current tier
+			 * exceeds the configured maximum. Arrange
+			 * for compaction. We compact all runs at
+			 * this tier and upper tiers.
+			 */
+			range->compaction_priority = total_run_count;
+			range->compaction_queue = total_stmt_count;
+			est_new_run_size = total_stmt_count.bytes;
+		}
+	}
+}
+
+void
+vy_range_update_compaction_priority(struct vy_range *range,
+				    const struct index_opts *opts)
+{
+	assert(opts->run_count_per_level > 0);
+	assert(opts->run_size_ratio > 1);
+
+	range->compaction_priority = 0;
+	vy_disk_stmt_counter_reset(&range->compaction_queue);
+
+	if (range->slice_count <= 1) {
+		/* Nothing to compact. */
+		range->needs_compaction = false;
+		return;
+	}
+
+	if (range->needs_compaction) {
+		range->compaction_priority = range->slice_count;
+		range->compaction_queue = range->count;
+		return;
+	}
+
+	switch (opts->compaction_strategy) {
+	case INDEX_COMPACTION_STRATEGY_LEVELED:
+		vy_range_update_compaction_priority_leveled(range, opts);
+		break;
+	case INDEX_COMPACTION_STRATEGY_TIERED:
+		vy_range_update_compaction_priority_tiered(range, opts);
+		break;
+	default:
+		unreachable();
+	}
+}
+
 void
 vy_range_update_dumps_per_compaction(struct vy_range *range)
 {
@@ -449,24 +552,40 @@ vy_range_update_dumps_per_compaction(struct vy_range *range)
  * - We should split around the last run middle key.
  * - We should only split if the last run size is greater than
  *   4/3 * range_size.
+ *
+ * If @split_early is set and the range accumulated so much data that
+ * compacting it in one go would take a lot of time, we split it around
+ * the biggest run middle key no matter if it was merged or not. Parts
+ * of the split range are compacted independently so this lets the
+ * scheduler spread the work among several compaction threads.
  */
 bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
+		     bool split_early,
 		     const char **p_split_key)
 {
-	struct vy_slice *slice;
-
-	/* The range hasn't been merged yet - too early to split it. */
-	if (range->n_compactions < 1)
-		return false;
+	struct vy_slice *slice = NULL;
 
-	/* Find the oldest run. */
 	assert(!rlist_empty(&range->slices));
-	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
-
-	/* The range is too small to be split. */
-	if (slice->count.bytes < range_size * 4 / 3)
-		return false;
+	if (range->n_compactions >= 1) {
+		/* Find the oldest run. */
+		slice = rlist_last_entry(&range->slices,
+					 struct vy_slice, in_range);
+		/* The range is too small to be split. */
+		if (slice->count.bytes < range_size * 4 / 3)
+			slice = NULL;
+	}
+	if (slice == NULL) {
+		/* The range is too small to split it before compaction. */
+		if (!split_early || range->count.bytes < range_size * 4)
+			return false;
+		/* Find the biggest run. */
+		struct vy_slice *s;
+		rlist_foreach_entry(s, &range->slices, in_range) {
+			if (slice == NULL || s->count.bytes > slice->count.bytes)
+				slice = s;
+		}
+	}
 
 	/* Find the median key in the oldest run (approximately). */
 	struct vy_page_info *mid_page;
@@ -258,12 +258,14 @@ vy_range_update_dumps_per_compaction(struct vy_range *range);
  *
  * @param range             The range.
  * @param range_size        Target range size.
+ * @param split_early       Split a big range before compaction.
  * @param[out] p_split_key  Key to split the range by.
  *
  * @retval true             If the range needs to be split.
  */
 bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
+		     bool split_early,
 		     const char **p_split_key);
 
 /**
@@ -883,7 +883,7 @@ vy_read_iterator_apply_history(struct vy_read_iterator *itr,
 	}
 
 	int upserts_applied = 0;
-	int rc = vy_history_apply(&history, lsm->cmp_def,
+	int rc = vy_history_apply(&history, lsm->cmp_def, lsm->opts.ttl_field,
 				  true, &upserts_applied, ret);
 
 	lsm->stat.upsert.applied += upserts_applied;
@@ -936,9 +936,13 @@ vy_read_iterator_next(struct vy_read_iterator *itr, struct vy_entry *result)
 		tuple_unref(itr->last.stmt);
 	itr->last = entry;
 
-	if (entry.stmt != NULL && vy_stmt_type(entry.stmt) == IPROTO_DELETE) {
+	if (entry.stmt != NULL &&
+	    (vy_stmt_type(entry.stmt) == IPROTO_DELETE ||
+	     vy_stmt_is_expired(entry.stmt, itr->lsm->opts.ttl_field,
+				fiber_time()))) {
 		/*
-		 * We don't return DELETEs so skip to the next key.
+		 * We don't return DELETEs and expired tuples so skip
+		 * to the next key.
 		 * If the DELETE was read from TX write set, there
 		 * is a good chance that the space actually has
 		 * the deleted key and hence we must not consider
@@ -83,6 +83,38 @@ static const size_t VY_DUMP_SIZE_ACCT_MIN = 1024 * 1024;
  */
 static const int VY_RECENT_DUMP_COUNT = 100;
 
+/**
+ * Min number of reads needed to estimate read latency percentile.
+ * If there are fewer reads, we accumulate observations for up to
+ * VY_READ_LATENCY_WIN seconds.
+ */
+static const size_t VY_READ_LATENCY_SAMPLES_MIN = 100;
+
+/**
+ * Max time window over which read latency is measured,
+ * in seconds.
+ */
+static const double VY_READ_LATENCY_WIN = 10;
+
+/**
+ * Never throttle writes below this rate to keep read latency
+ * within the budget, because it can be exceeded for reasons
+ * that have nothing to do with compaction.
+ */
+static const size_t VY_READ_RATE_LIMIT_MIN = 100 * 1024;
+
+/**
+ * Set the disk rate limit to the least of the rate limits
+ * required by compaction and read latency.
+ */
+static void
+vy_regulator_update_disk_rate_limit(struct vy_regulator *regulator)
+{
+	vy_quota_set_rate_limit(regulator->quota, VY_QUOTA_RESOURCE_DISK,
+				MIN(regulator->compaction_rate_limit,
+				    regulator->read_rate_limit));
+}
+
 static void
 vy_regulator_trigger_dump(struct vy_regulator *regulator)
 {
@@ -189,6 +221,69 @@ vy_regulator_update_dump_watermark(struct vy_regulator *regulator)
 					quota->limit / 2);
 }
 
+/*
+ * If tuning the LSM tree shape for the write rate isn't enough to
+ * keep reads fast, for example, because compaction has to compete
+ * with reads for the disk bandwidth, we may throttle writes even
+ * more to keep read latency within the configured budget.
+ *
+ * To this end, we periodically check the 99th percentile of read
+ * latency. If it exceeds the budget while there's data waiting for
+ * compaction, we reduce the write rate limit by 25%, which makes
+ * dumps less frequent and so lets compaction catch up. If read
+ * latency drops below 90% of the budget or there's nothing left
+ * to compact, we gradually raise the limit back, by 12.5% on each
+ * check, and lift it completely as soon as it isn't a bottleneck
+ * anymore. This way, the write rate is changed smoothly and we don't
+ * oscillate between throttling and not throttling writes on every
+ * check.
+ */
+static void
+vy_regulator_update_read_rate_limit(struct vy_regulator *regulator)
+{
+	double budget = regulator->read_latency_budget;
+	if (budget == 0)
+		return;
+
+	double now = ev_monotonic_now(loop());
+	/* Don't count the zero observation added on reset. */
+	size_t samples = regulator->read_latency.histogram->total - 1;
+	if (samples < VY_READ_LATENCY_SAMPLES_MIN &&
+	    now - regulator->read_latency_check_time < VY_READ_LATENCY_WIN)
+		return;
+
+	double p99 = samples > 0 ? latency_get(&regulator->read_latency, 99) : 0;
+	latency_reset(&regulator->read_latency);
+	regulator->read_latency_check_time = now;
+	regulator->read_latency_p99 = p99;
+
+	bool has_debt = regulator->compaction_debt_cb(regulator) > 0;
+	size_t rate = regulator->read_rate_limit;
+	if (p99 > budget && has_debt) {
+		if (rate == SIZE_MAX) {
+			rate = MIN(regulator->write_rate,
+				   regulator->compaction_rate_limit);
+		}
+		rate = MAX(rate / 4 * 3, VY_READ_RATE_LIMIT_MIN);
+		if (rate != regulator->read_rate_limit) {
+			say_info("read latency %.3f s exceeds budget %.3f s, "
+				 "limiting write rate to %.1f MB/s", p99,
+				 budget, (double)rate / 1024 / 1024);
+		}
+	} else if (rate != SIZE_MAX &&
+		   (p99 < budget * 9 / 10 || !has_debt)) {
+		rate += rate / 8;
+		if (rate >= regulator->compaction_rate_limit ||
+		    rate > regulator->write_rate * 2) {
+			say_info("lifting write rate limit, "
+				 "read latency %.3f s", p99);
+			rate = SIZE_MAX;
+		}
+	}
+	regulator->read_rate_limit = rate;
+	vy_regulator_update_disk_rate_limit(regulator);
+}
+
 static void
 vy_regulator_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 {
@@ -200,11 +295,13 @@ vy_regulator_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 	vy_regulator_update_write_rate(regulator);
 	vy_regulator_update_dump_watermark(regulator);
 	vy_regulator_check_dump_watermark(regulator);
+	vy_regulator_update_read_rate_limit(regulator);
 }
 
 void
 vy_regulator_create(struct vy_regulator *regulator, struct vy_quota *quota,
-		    vy_trigger_dump_f trigger_dump_cb)
+		    vy_trigger_dump_f trigger_dump_cb,
+		    vy_compaction_debt_f compaction_debt_cb)
 {
 	enum { KB = 1024, MB = KB * KB };
 	static int64_t dump_bandwidth_buckets[] = {
@@ -222,14 +319,19 @@ vy_regulator_create(struct vy_regulator *regulator, struct vy_quota *quota,
 					lengthof(dump_bandwidth_buckets));
 	if (regulator->dump_bandwidth_hist == NULL)
 		panic("failed to allocate dump bandwidth histogram");
+	if (latency_create(&regulator->read_latency) != 0)
+		panic("failed to allocate read latency histogram");
 
 	regulator->quota = quota;
 	regulator->trigger_dump_cb = trigger_dump_cb;
+	regulator->compaction_debt_cb = compaction_debt_cb;
 	ev_timer_init(&regulator->timer, vy_regulator_timer_cb, 0,
 		      VY_REGULATOR_TIMER_PERIOD);
 	regulator->timer.data = regulator;
 	regulator->dump_bandwidth = VY_DUMP_BANDWIDTH_DEFAULT;
 	regulator->dump_watermark = SIZE_MAX;
+	regulator->compaction_rate_limit = SIZE_MAX;
+	regulator->read_rate_limit = SIZE_MAX;
 }
 
 void
@@ -246,6 +348,7 @@ vy_regulator_destroy(struct vy_regulator *regulator)
 {
 	ev_timer_stop(loop(), &regulator->timer);
 	histogram_delete(regulator->dump_bandwidth_hist);
+	latency_destroy(&regulator->read_latency);
 }
 
 void
@@ -316,6 +419,20 @@ vy_regulator_reset_dump_bandwidth(struct vy_regulator *regulator, size_t max)
 				regulator->dump_bandwidth);
 }
 
+void
+vy_regulator_set_read_latency_budget(struct vy_regulator *regulator,
+				     double budget)
+{
+	regulator->read_latency_budget = budget;
+	regulator->read_latency_check_time = ev_monotonic_now(loop());
+	regulator->read_latency_p99 = 0;
+	latency_reset(&regulator->read_latency);
+	if (budget == 0) {
+		regulator->read_rate_limit = SIZE_MAX;
+		vy_regulator_update_disk_rate_limit(regulator);
+	}
+}
+
 void
 vy_regulator_reset_stat(struct vy_regulator *regulator)
 {
@@ -445,8 +562,8 @@ vy_regulator_update_rate_limit(struct vy_regulator *regulator,
 		rate64 = rate;
 	else
 		rate64 = UINT64_MAX;
-	vy_quota_set_rate_limit(regulator->quota, VY_QUOTA_RESOURCE_DISK,
-				(size_t)MIN(rate64, SIZE_MAX));
+	regulator->compaction_rate_limit = (size_t)MIN(rate64, SIZE_MAX);
+	vy_regulator_update_disk_rate_limit(regulator);
 
 	/*
 	 * Periodically rotate statistics for quicker adaptation
@@ -35,6 +35,7 @@
 #include <stddef.h>
 #include <tarantool_ev.h>
 
+#include "latency.h"
 #include "vy_stat.h"
 
 #if defined(__cplusplus)
@@ -48,6 +49,9 @@ struct vy_regulator;
 typedef int
 (*vy_trigger_dump_f)(struct vy_regulator *regulator);
 
+typedef int64_t
+(*vy_compaction_debt_f)(struct vy_regulator *regulator);
+
 /**
  * The regulator is supposed to keep track of vinyl memory usage
  * and dump/compaction progress and adjust transaction write rate
@@ -65,6 +69,12 @@ struct vy_regulator {
 	 * memory dump and return 0 on success, -1 on failure.
 	 */
 	vy_trigger_dump_f trigger_dump_cb;
+	/**
+	 * Returns the amount of data awaiting compaction, in bytes.
+	 * Used for deciding whether throttling writes can help to
+	 * reduce read latency.
+	 */
+	vy_compaction_debt_f compaction_debt_cb;
 	/**
 	 * Periodic timer that updates the memory watermark
 	 * basing on accumulated statistics.
@@ -124,11 +134,33 @@ struct vy_regulator {
 	 * Used for calculating the rate limit.
 	 */
 	struct vy_scheduler_stat sched_stat_recent;
+	/**
+	 * Rate limit set to ensure compaction keeps up with dumps,
+	 * in bytes per second. See vy_regulator_update_rate_limit().
+	 */
+	size_t compaction_rate_limit;
+	/**
+	 * Target 99th percentile of read latency, in seconds.
+	 * Zero if the write rate isn't limited by read latency.
+	 */
+	double read_latency_budget;
+	/** Read latency observed since the last check. */
+	struct latency read_latency;
+	/** Time of the last read latency check. */
+	double read_latency_check_time;
+	/** 99th percentile of read latency observed last time. */
+	double read_latency_p99;
+	/**
+	 * Write rate limit set to keep read latency within the
+	 * budget, in bytes per second. SIZE_MAX if not limited.
+	 */
+	size_t read_rate_limit;
 };
 
 void
 vy_regulator_create(struct vy_regulator *regulator, struct vy_quota *quota,
-		    vy_trigger_dump_f trigger_dump_cb);
+		    vy_trigger_dump_f trigger_dump_cb,
+		    vy_compaction_debt_f compaction_debt_cb);
 
 void
 vy_regulator_start(struct vy_regulator *regulator);
@@ -175,6 +207,25 @@ vy_regulator_reset_dump_bandwidth(struct vy_regulator *regulator, size_t max);
 void
 vy_regulator_reset_stat(struct vy_regulator *regulator);
 
+/**
+ * Set the target 99th percentile of read latency, in seconds.
+ * Zero disables throttling writes basing on read latency.
+ */
+void
+vy_regulator_set_read_latency_budget(struct vy_regulator *regulator,
+				     double budget);
+
+/**
+ * Notify the regulator about a completed read request.
+ */
+static inline void
+vy_regulator_collect_read_latency(struct vy_regulator *regulator,
+				  double latency)
+{
+	if (regulator->read_latency_budget > 0)
+		latency_collect(&regulator->read_latency, latency);
+}
+
 /**
  * Set transaction rate limit so as to ensure that compaction
  * will keep up with dumps.
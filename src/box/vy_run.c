@@ -30,6 +30,7 @@
  */
 #include "vy_run.h"
 
+#include <fcntl.h>
 #include <zstd.h>
 
 #include "fiber.h"
@@ -61,6 +62,9 @@ static const uint64_t vy_run_info_key_map = (1 << VY_RUN_INFO_MIN_KEY) |
 /** xlog meta type for .run files */
 #define XLOG_META_TYPE_RUN "RUN"
 
+/** Number of pages covered by a bloom filter partition. */
+enum { VY_BLOOM_PARTITION_PAGES = 16 };
+
 /** xlog meta type for .index files */
 #define XLOG_META_TYPE_INDEX "INDEX"
 
@@ -109,6 +113,38 @@ struct vy_page_read_task {
 	bool equal_found;
 	/** [out] resulting vinyl page */
 	struct vy_page *page;
+	/** offset of the file chunk to read ahead */
+	uint64_t read_ahead_offset;
+	/** size of the file chunk to read ahead, 0 if none */
+	uint64_t read_ahead_size;
+	/** metadata of the page to prefetch, NULL if none */
+	struct vy_page_info *next_page_info;
+	/** page to prefetch into the page cache, NULL if none */
+	struct vy_page *next_page;
+	/** [out] true if the page to prefetch was read successfully */
+	bool next_page_read;
+};
+
+/** A page read by vy_page_batch_read_task. */
+struct vy_page_batch_read_entry {
+	/** vinyl page metadata */
+	struct vy_page_info *page_info;
+	/** vy_run with fd */
+	struct vy_run *run;
+	/** [out] resulting vinyl page */
+	struct vy_page *page;
+};
+
+/** Task reading a batch of pages, see vy_run_iterator_prefetch(). */
+struct vy_page_batch_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** vinyl run environment */
+	struct vy_run_env *env;
+	/** pages to read */
+	struct vy_page_batch_read_entry *entries;
+	/** number of pages to read */
+	int entry_count;
 };
 
 /** Destructor for env->zdctx_key thread-local variable */
@@ -189,6 +225,7 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
 	env->initial_join = false;
+	rlist_create(&env->page_cache.lru);
 }
 
 /**
@@ -291,9 +328,13 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	return run;
 }
 
+static void
+vy_page_cache_purge_run(struct vy_page_cache *cache, struct vy_run *run);
+
 static void
 vy_run_clear(struct vy_run *run)
 {
+	vy_page_cache_purge_run(&run->env->page_cache, run);
 	if (run->page_info != NULL) {
 		uint32_t page_no;
 		for (page_no = 0; page_no < run->info.page_count; ++page_no)
@@ -307,6 +348,16 @@ vy_run_clear(struct vy_run *run)
 		tuple_bloom_delete(run->info.bloom);
 		run->info.bloom = NULL;
 	}
+	for (uint32_t i = 0; i < run->info.bloom_partition_count; i++) {
+		struct tuple_bloom *bloom = run->info.bloom_partitions[i].bloom;
+		if (bloom == NULL)
+			continue;
+		run->env->bloom_partition_size -= tuple_bloom_size(bloom);
+		tuple_bloom_delete(bloom);
+	}
+	free(run->info.bloom_partitions);
+	run->info.bloom_partitions = NULL;
+	run->info.bloom_partition_count = 0;
 	free(run->info.min_key);
 	run->info.min_key = NULL;
 	free(run->info.max_key);
@@ -478,6 +529,40 @@ vy_slice_new(int64_t id, struct vy_run *run, struct vy_entry begin,
 	return slice;
 }
 
+uint64_t
+vy_slice_estimate_count(struct vy_slice *slice, enum iterator_type type,
+			struct vy_entry key, struct key_def *cmp_def)
+{
+	struct vy_run *run = slice->run;
+	if (slice->count.rows == 0)
+		return 0;
+	uint32_t first = slice->first_page_no;
+	uint32_t last = slice->last_page_no;
+	if (type != ITER_ALL && !vy_stmt_is_empty_key(key.stmt)) {
+		bool unused;
+		if (type != ITER_LE && type != ITER_LT) {
+			/* The first page that may contain the key range. */
+			uint32_t page_no = vy_page_index_find_page(
+				run, key, cmp_def,
+				type == ITER_GT ? ITER_GT : ITER_GE, &unused);
+			first = MAX(first, page_no);
+		}
+		if (type != ITER_GE && type != ITER_GT) {
+			/* The last page that may contain the key range. */
+			uint32_t page_no = vy_page_index_find_page(
+				run, key, cmp_def,
+				type == ITER_LT ? ITER_LT : ITER_LE, &unused);
+			if (page_no == run->info.page_count)
+				return 0;
+			last = MIN(last, page_no);
+		}
+	}
+	uint64_t count = 0;
+	for (uint32_t page_no = first; page_no <= last; page_no++)
+		count += vy_run_page_info(run, page_no)->row_count;
+	return count;
+}
+
 void
 vy_slice_delete(struct vy_slice *slice)
 {
@@ -624,6 +709,70 @@ vy_stmt_stat_decode(struct vy_stmt_stat *stat, const char **data)
 	}
 }
 
+/** Return the size of the encoded bloom filter partition index. */
+static size_t
+vy_bloom_partitions_sizeof(const struct vy_run_info *run_info)
+{
+	size_t size = mp_sizeof_array(run_info->bloom_partition_count);
+	for (uint32_t i = 0; i < run_info->bloom_partition_count; i++) {
+		const struct vy_bloom_partition *p =
+			&run_info->bloom_partitions[i];
+		size += mp_sizeof_array(4);
+		size += mp_sizeof_uint(p->first_page_no);
+		size += mp_sizeof_uint(p->offset);
+		size += mp_sizeof_uint(p->size);
+		size += mp_sizeof_uint(p->unpacked_size);
+	}
+	return size;
+}
+
+/** Encode the bloom filter partition index to @buf. */
+static char *
+vy_bloom_partitions_encode(const struct vy_run_info *run_info, char *buf)
+{
+	buf = mp_encode_array(buf, run_info->bloom_partition_count);
+	for (uint32_t i = 0; i < run_info->bloom_partition_count; i++) {
+		const struct vy_bloom_partition *p =
+			&run_info->bloom_partitions[i];
+		buf = mp_encode_array(buf, 4);
+		buf = mp_encode_uint(buf, p->first_page_no);
+		buf = mp_encode_uint(buf, p->offset);
+		buf = mp_encode_uint(buf, p->size);
+		buf = mp_encode_uint(buf, p->unpacked_size);
+	}
+	return buf;
+}
+
+/**
+ * Decode the bloom filter partition index from @data and advance
+ * @data. Partitions themselves are loaded on demand.
+ */
+static int
+vy_bloom_partitions_decode(struct vy_run_info *run_info, const char **data)
+{
+	uint32_t count = mp_decode_array(data);
+	struct vy_bloom_partition *partitions = calloc(count,
+						       sizeof(*partitions));
+	if (partitions == NULL && count > 0) {
+		diag_set(OutOfMemory, count * sizeof(*partitions),
+			 "malloc", "struct vy_bloom_partition");
+		return -1;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		struct vy_bloom_partition *p = &partitions[i];
+		if (mp_decode_array(data) != 4)
+			unreachable();
+		p->first_page_no = mp_decode_uint(data);
+		p->offset = mp_decode_uint(data);
+		p->size = mp_decode_uint(data);
+		p->unpacked_size = mp_decode_uint(data);
+	}
+	free(run_info->bloom_partitions);
+	run_info->bloom_partitions = partitions;
+	run_info->bloom_partition_count = count;
+	return 0;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -688,6 +837,10 @@ vy_run_info_decode(struct vy_run_info *run_info,
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_BLOOM_PARTITIONS:
+			if (vy_bloom_partitions_decode(run_info, &pos) != 0)
+				return -1;
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -713,6 +866,9 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->refs = 1;
+	page->run = NULL;
+	rlist_create(&page->in_cache);
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
@@ -749,6 +905,123 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** Size of memory occupied by a page. */
+static inline size_t
+vy_page_size(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(*page->row_index);
+}
+
+/** Remove a page from the page cache and drop the cache reference. */
+static void
+vy_page_cache_remove(struct vy_page_cache *cache, struct vy_page *page)
+{
+	struct vy_run *run = page->run;
+	assert(run != NULL && run->cached_pages[page->page_no] == page);
+	run->cached_pages[page->page_no] = NULL;
+	page->run = NULL;
+	rlist_del_entry(page, in_cache);
+	assert(cache->mem_used >= vy_page_size(page));
+	cache->mem_used -= vy_page_size(page);
+	vy_page_unref(page);
+}
+
+/** Evict the least recently used pages until the cache fits its quota. */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page,
+							in_cache);
+		vy_page_cache_remove(cache, page);
+	}
+}
+
+/**
+ * Look up a page of a run in the page cache. Returns NULL if the page
+ * isn't cached. The returned page isn't referenced.
+ */
+static struct vy_page *
+vy_page_cache_lookup(struct vy_page_cache *cache, struct vy_run *run,
+		     uint32_t page_no)
+{
+	if (run->cached_pages == NULL)
+		return NULL;
+	struct vy_page *page = run->cached_pages[page_no];
+	if (page != NULL)
+		rlist_move_entry(&cache->lru, page, in_cache);
+	return page;
+}
+
+/**
+ * Add a page just read from a run to the page cache. Does nothing if
+ * the cache is disabled or the page has been cached by another reader
+ * while this one was loading it.
+ */
+static void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_run *run,
+		  struct vy_page *page)
+{
+	assert(page->run == NULL);
+	size_t size = vy_page_size(page);
+	if (size > cache->mem_quota)
+		return;
+	if (run->cached_pages == NULL) {
+		run->cached_pages = calloc(run->info.page_count,
+					   sizeof(*run->cached_pages));
+		if (run->cached_pages == NULL)
+			return;
+	}
+	if (run->cached_pages[page->page_no] != NULL)
+		return;
+	vy_page_ref(page);
+	page->run = run;
+	run->cached_pages[page->page_no] = page;
+	rlist_add_entry(&cache->lru, page, in_cache);
+	cache->mem_used += size;
+	vy_page_cache_evict(cache);
+}
+
+/** Drop all pages of a run from the page cache. */
+static void
+vy_page_cache_purge_run(struct vy_page_cache *cache, struct vy_run *run)
+{
+	if (run->cached_pages == NULL)
+		return;
+	for (uint32_t page_no = 0; page_no < run->info.page_count; page_no++) {
+		struct vy_page *page = run->cached_pages[page_no];
+		if (page != NULL)
+			vy_page_cache_remove(cache, page);
+	}
+	free(run->cached_pages);
+	run->cached_pages = NULL;
+}
+
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	env->page_cache.mem_quota = quota;
+	vy_page_cache_evict(&env->page_cache);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -835,9 +1108,9 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -883,6 +1156,24 @@ vy_run_filename(struct vy_run *run)
 	return buf;
 }
 
+/**
+ * Drop a chunk of a run file from the OS page cache if configured
+ * so, see vy_run_env::drop_os_cache. This is merely a hint, so
+ * errors are ignored.
+ */
+static inline void
+vy_run_drop_os_cache(struct vy_run *run, uint64_t offset, uint64_t size)
+{
+#ifdef HAVE_POSIX_FADVISE
+	if (run->env->drop_os_cache)
+		(void)posix_fadvise(run->fd, offset, size, POSIX_FADV_DONTNEED);
+#else
+	(void)run;
+	(void)offset;
+	(void)size;
+#endif /* HAVE_POSIX_FADVISE */
+}
+
 /**
  * Read a page requests from vinyl xlog data file.
  *
@@ -914,6 +1205,7 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 			 "Unexpected end of file");
 		goto error;
 	}
+	vy_run_drop_os_cache(run, page_info->offset, page_info->size);
 
 	struct errinj *inj = errinj(ERRINJ_VY_READ_PAGE_TIMEOUT, ERRINJ_DOUBLE);
 	if (inj != NULL && inj->dparam > 0)
@@ -988,15 +1280,134 @@ vy_page_read_cb(struct cbus_call_msg *base)
 		return -1;
 	if (vy_page_read(task->page, task->page_info, task->run, zdctx) != 0)
 		return -1;
+#ifdef HAVE_POSIX_FADVISE
+	if (task->read_ahead_size > 0) {
+		(void)posix_fadvise(task->run->fd, task->read_ahead_offset,
+				    task->read_ahead_size, POSIX_FADV_WILLNEED);
+	}
+#endif /* HAVE_POSIX_FADVISE */
 	if (task->key.stmt != NULL) {
 		task->pos_in_page = vy_page_find_key(task->page, task->key,
 						     task->cmp_def, task->format,
 						     task->iterator_type,
 						     &task->equal_found);
 	}
+	/*
+	 * Prefetch is best-effort: a failure to read the next page
+	 * doesn't fail the task, the page will be read again when
+	 * the iterator gets to it.
+	 */
+	if (task->next_page != NULL) {
+		task->next_page_read = vy_page_read(task->next_page,
+						    task->next_page_info,
+						    task->run, zdctx) == 0;
+		if (!task->next_page_read)
+			diag_clear(diag_get());
+	}
 	return 0;
 }
 
+/**
+ * Find the chunk of the run file to read ahead when the iterator
+ * loads the page with the given number. We read ahead only if the
+ * iterator reads pages sequentially, i.e. the page adjoins the
+ * current page, which is the case for range scans. The next chunk
+ * is requested when the iterator reaches the last page read ahead
+ * so that it is read in the background while the iterator is busy
+ * with the current page.
+ *
+ * Returns the size of the chunk, 0 if nothing should be read ahead.
+ */
+static uint64_t
+vy_run_iterator_read_ahead(struct vy_run_iterator *itr, uint32_t page_no,
+			   uint64_t *offset)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run *run = slice->run;
+	uint64_t window = run->env->read_ahead;
+	if (window == 0 || itr->curr_page == NULL)
+		return 0;
+
+	uint64_t size;
+	uint32_t i;
+	struct vy_page_info *first, *last;
+	if (page_no == itr->curr_page->page_no + 1) {
+		/* Forward scan. */
+		i = page_no + 1;
+		if (i > slice->last_page_no || i <= itr->read_ahead_page_no)
+			return 0;
+		first = last = vy_run_page_info(run, i);
+		size = last->size;
+		while (size < window && i < slice->last_page_no) {
+			last = vy_run_page_info(run, ++i);
+			size += last->size;
+		}
+	} else if (page_no + 1 == itr->curr_page->page_no) {
+		/* Backward scan. */
+		if (page_no <= slice->first_page_no)
+			return 0;
+		i = page_no - 1;
+		if (i >= itr->read_ahead_page_no)
+			return 0;
+		first = last = vy_run_page_info(run, i);
+		size = first->size;
+		while (size < window && i > slice->first_page_no) {
+			first = vy_run_page_info(run, --i);
+			size += first->size;
+		}
+	} else {
+		return 0;
+	}
+	itr->read_ahead_page_no = i;
+	*offset = first->offset;
+	return last->offset + last->size - first->offset;
+}
+
+/**
+ * Allocate the page following the given one in the scan direction
+ * so that it's read by the same reader task and put into the page
+ * cache. This saves a round trip to a reader thread per page in
+ * range scans. Pages are prefetched only if the iterator reads them
+ * sequentially and the page cache is enabled, because otherwise
+ * there's nowhere to keep the prefetched page.
+ *
+ * Returns NULL if nothing should be prefetched.
+ */
+static struct vy_page *
+vy_run_iterator_prefetch_next(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run *run = slice->run;
+	struct vy_page_cache *cache = &run->env->page_cache;
+	if (cache->mem_quota == 0 || itr->curr_page == NULL)
+		return NULL;
+	uint32_t next_page_no;
+	if (page_no == itr->curr_page->page_no + 1) {
+		/* Forward scan. */
+		if (page_no >= slice->last_page_no)
+			return NULL;
+		next_page_no = page_no + 1;
+	} else if (page_no + 1 == itr->curr_page->page_no) {
+		/* Backward scan. */
+		if (page_no <= slice->first_page_no)
+			return NULL;
+		next_page_no = page_no - 1;
+	} else {
+		return NULL;
+	}
+	if (run->cached_pages != NULL &&
+	    run->cached_pages[next_page_no] != NULL)
+		return NULL;
+	struct vy_page *page = vy_page_new(vy_run_page_info(run,
+							    next_page_no));
+	if (page == NULL) {
+		diag_clear(diag_get());
+		return NULL;
+	}
+	page->page_no = next_page_no;
+	return page;
+}
+
 /**
  * Read a page from disk given its number.
  * The function caches two most recently read pages.
@@ -1032,6 +1443,22 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		return 0;
 	}
 
+	/* Check the page cache shared by all iterators */
+	struct vy_page_cache *cache = &env->page_cache;
+	if (cache->mem_quota > 0) {
+		page = vy_page_cache_lookup(cache, slice->run, page_no);
+		if (page != NULL) {
+			cache->hit++;
+			vy_page_ref(page);
+			if (key.stmt != NULL)
+				*pos_in_page = vy_page_find_key(
+					page, key, itr->cmp_def, itr->format,
+					iterator_type, equal_found);
+			goto update_cache;
+		}
+		cache->miss++;
+	}
+
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	page = vy_page_new(page_info);
@@ -1055,23 +1482,28 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	task->format = itr->format;
 	task->pos_in_page = 0;
 	task->equal_found = false;
+	task->read_ahead_size = vy_run_iterator_read_ahead(
+			itr, page_no, &task->read_ahead_offset);
+	task->next_page = vy_run_iterator_prefetch_next(itr, page_no);
+	task->next_page_info = task->next_page == NULL ? NULL :
+		vy_run_page_info(slice->run, task->next_page->page_no);
+	task->next_page_read = false;
 
 	int rc = vy_run_env_coio_call(env, &task->base, vy_page_read_cb);
 
 	*pos_in_page = task->pos_in_page;
 	*equal_found = task->equal_found;
 
+	struct vy_page *next_page = task->next_page;
+	struct vy_page_info *next_page_info = task->next_page_info;
+	bool next_page_read = task->next_page_read;
 	mempool_free(&env->read_task_pool, task);
 	if (rc != 0) {
+		if (next_page != NULL)
+			vy_page_delete(next_page);
 		vy_page_delete(page);
 		return -1;
 	}
-
-	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
 	page->page_no = page_no;
 
 	/* Update read statistics. */
@@ -1080,10 +1512,225 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	itr->stat->read.bytes_compressed += page_info->size;
 	itr->stat->read.pages++;
 
+	vy_page_cache_put(cache, slice->run, page);
+	if (next_page != NULL) {
+		if (next_page_read) {
+			itr->stat->read.rows += next_page_info->row_count;
+			itr->stat->read.bytes += next_page_info->unpacked_size;
+			itr->stat->read.bytes_compressed +=
+				next_page_info->size;
+			itr->stat->read.pages++;
+			vy_page_cache_put(cache, slice->run, next_page);
+		}
+		vy_page_unref(next_page);
+	}
+update_cache:
+	/* Update cache */
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+
 	*result = page;
 	return 0;
 }
 
+/** Bloom filter partition read task. */
+struct vy_bloom_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** vy_run with fd - ref. counted */
+	struct vy_run *run;
+	/** partition to read */
+	const struct vy_bloom_partition *partition;
+	/** [out] loaded bloom filter */
+	struct tuple_bloom *bloom;
+};
+
+/**
+ * Read a bloom filter partition from a run file.
+ * Returns the loaded bloom filter or NULL on error.
+ */
+static struct tuple_bloom *
+vy_bloom_partition_read(const struct vy_bloom_partition *partition,
+			struct vy_run *run, ZSTD_DStream *zdctx)
+{
+	struct tuple_bloom *bloom = NULL;
+	size_t region_svp = region_used(&fiber()->gc);
+	size_t size = partition->size + partition->unpacked_size;
+	char *data = (char *)region_alloc(&fiber()->gc, size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, size, "region gc", "bloom partition");
+		goto out;
+	}
+	ssize_t readen = fio_pread(run->fd, data, partition->size,
+				   partition->offset);
+	if (readen < 0) {
+		diag_set(SystemError, "failed to read from file");
+		goto out;
+	}
+	if (readen != (ssize_t)partition->size) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Unexpected end of file");
+		goto out;
+	}
+	vy_run_drop_os_cache(run, partition->offset, partition->size);
+	char *rows = data + partition->size;
+	char *rows_end = rows + partition->unpacked_size;
+	if (xlog_tx_decode(data, data + readen, rows, rows_end, zdctx) != 0)
+		goto out;
+
+	struct xrow_header xrow;
+	const char *pos = rows;
+	if (xrow_header_decode(&xrow, &pos, rows_end, true) == -1)
+		goto out;
+	if (xrow.type != VY_RUN_BLOOM || xrow.bodycnt == 0) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Wrong bloom filter type "
+				    "(expected %d, got %u)",
+				    VY_RUN_BLOOM, (unsigned)xrow.type));
+		goto out;
+	}
+	pos = xrow.body->iov_base;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		uint32_t key = mp_decode_uint(&pos);
+		if (key != VY_RUN_INFO_BLOOM_FILTER || bloom != NULL) {
+			mp_next(&pos); /* unknown key, ignore */
+			continue;
+		}
+		bloom = tuple_bloom_decode(&pos);
+		if (bloom == NULL)
+			goto out;
+	}
+	if (bloom == NULL) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Can't decode bloom filter partition");
+	}
+out:
+	region_truncate(&fiber()->gc, region_svp);
+	if (bloom == NULL) {
+		diag_log();
+		say_error("error reading %s@%llu:%u", vy_run_filename(run),
+			  (unsigned long long)partition->offset,
+			  (unsigned)partition->size);
+	}
+	return bloom;
+}
+
+/**
+ * Bloom filter partition read callback.
+ */
+static int
+vy_bloom_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_bloom_read_task *task = (struct vy_bloom_read_task *)base;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(task->run->env);
+	if (zdctx == NULL)
+		return -1;
+	task->bloom = vy_bloom_partition_read(task->partition, task->run,
+					      zdctx);
+	return task->bloom != NULL ? 0 : -1;
+}
+
+/**
+ * Load a bloom filter partition from disk unless it's been
+ * loaded already.
+ *
+ * @retval 0 success
+ * @retval -1 read error or out of memory.
+ */
+static NODISCARD int
+vy_run_load_bloom_partition(struct vy_run *run,
+			    struct vy_bloom_partition *partition)
+{
+	if (partition->bloom != NULL)
+		return 0;
+	struct vy_run_env *env = run->env;
+	struct vy_bloom_read_task task;
+	task.run = run;
+	task.partition = partition;
+	task.bloom = NULL;
+	if (vy_run_env_coio_call(env, &task.base, vy_bloom_read_cb) != 0) {
+		if (task.bloom != NULL)
+			tuple_bloom_delete(task.bloom);
+		return -1;
+	}
+	if (partition->bloom != NULL) {
+		/* Loaded by another fiber while we were reading it. */
+		tuple_bloom_delete(task.bloom);
+		return 0;
+	}
+	partition->bloom = task.bloom;
+	env->bloom_partition_size += tuple_bloom_size(task.bloom);
+	return 0;
+}
+
+/**
+ * Return the bloom filter partition covering a page.
+ */
+static struct vy_bloom_partition *
+vy_run_bloom_partition(struct vy_run *run, uint32_t page_no)
+{
+	assert(run->info.bloom_partition_count > 0);
+	uint32_t begin = 0;
+	uint32_t end = run->info.bloom_partition_count;
+	/* Find the last partition with first_page_no <= page_no. */
+	while (end - begin > 1) {
+		uint32_t mid = begin + (end - begin) / 2;
+		if (run->info.bloom_partitions[mid].first_page_no <= page_no)
+			begin = mid;
+		else
+			end = mid;
+	}
+	return &run->info.bloom_partitions[begin];
+}
+
+/**
+ * Check the partitioned bloom filter of a run for the iterator
+ * key, loading partitions from disk if necessary. On success sets
+ * @a maybe_has to false if the run definitely doesn't store any
+ * statements matching the key.
+ *
+ * @retval 0 success
+ * @retval -1 read error or out of memory.
+ */
+static NODISCARD int
+vy_run_iterator_check_bloom_partitions(struct vy_run_iterator *itr,
+				       bool *maybe_has)
+{
+	struct vy_run *run = itr->slice->run;
+	bool unused;
+	*maybe_has = false;
+	/*
+	 * Statements matching the key can only be stored in pages
+	 * [first, last] so we only need to check partitions covering
+	 * them, which is usually just one partition.
+	 */
+	uint32_t first = vy_page_index_find_page(run, itr->key, itr->cmp_def,
+						 ITER_GE, &unused);
+	uint32_t last = vy_page_index_find_page(run, itr->key, itr->cmp_def,
+						ITER_LE, &unused);
+	if (last == run->info.page_count)
+		return 0;
+	assert(first <= last);
+	struct vy_bloom_partition *partition =
+		vy_run_bloom_partition(run, first);
+	struct vy_bloom_partition *end = run->info.bloom_partitions +
+					 run->info.bloom_partition_count;
+	for (; partition < end && partition->first_page_no <= last;
+	     partition++) {
+		if (vy_run_load_bloom_partition(run, partition) != 0)
+			return -1;
+		if (vy_bloom_maybe_has(partition->bloom, itr->key,
+				       itr->key_def)) {
+			*maybe_has = true;
+			return 0;
+		}
+	}
+	return 0;
+}
+
 /**
  * Read key and lsn by a given wide position.
  * For the first record in a page reads the result from the page
@@ -1352,11 +1999,23 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 
 	/* Check the bloom filter on the first iteration. */
 	bool check_bloom = (itr->iterator_type == ITER_EQ &&
-			    itr->curr.stmt == NULL && bloom != NULL);
-	if (check_bloom && !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
-		vy_run_iterator_stop(itr);
-		itr->stat->bloom_hit++;
-		return 0;
+			    itr->curr.stmt == NULL &&
+			    (bloom != NULL ||
+			     slice->run->info.bloom_partition_count > 0));
+	if (check_bloom) {
+		bool maybe_has;
+		if (bloom != NULL) {
+			maybe_has = vy_bloom_maybe_has(bloom, itr->key,
+						       itr->key_def);
+		} else if (vy_run_iterator_check_bloom_partitions(
+					itr, &maybe_has) != 0) {
+			return -1;
+		}
+		if (!maybe_has) {
+			vy_run_iterator_stop(itr);
+			itr->stat->bloom_hit++;
+			return 0;
+		}
 	}
 
 	/*
@@ -1484,6 +2143,8 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_pos.page_no = slice->run->info.page_count;
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
+	itr->read_ahead_page_no = iterator_direction(iterator_type) > 0 ?
+				  0 : UINT32_MAX;
 	itr->search_started = false;
 
 	/*
@@ -1497,6 +2158,160 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	tuple_format_ref(format);
 }
 
+/**
+ * vinyl batch read task callback
+ */
+static int
+vy_page_batch_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_page_batch_read_task *task =
+		(struct vy_page_batch_read_task *)base;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(task->env);
+	if (zdctx == NULL)
+		return -1;
+	for (int i = 0; i < task->entry_count; i++) {
+		struct vy_page_batch_read_entry *entry = &task->entries[i];
+		if (vy_page_read(entry->page, entry->page_info,
+				 entry->run, zdctx) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Make a page the most recently used page of a run iterator.
+ * The iterator takes a reference to the page.
+ */
+static void
+vy_run_iterator_cache_page(struct vy_run_iterator *itr, struct vy_page *page)
+{
+	vy_page_ref(page);
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+}
+
+int
+vy_run_iterator_prefetch(struct vy_run_iterator **itrs, int count)
+{
+	if (count == 0)
+		return 0;
+	struct vy_run_env *env = itrs[0]->slice->run->env;
+	struct vy_page_cache *cache = &env->page_cache;
+	struct vy_run_iterator_stat *stat = itrs[0]->stat;
+
+	size_t region_svp = region_used(&fiber()->gc);
+	struct vy_page_batch_read_entry *entries =
+		xregion_alloc_array(&fiber()->gc, typeof(entries[0]), count);
+	/* Index of the entry storing the page needed by each iterator. */
+	int *entry_idx = xregion_alloc_array(&fiber()->gc, int, count);
+	int entry_count = 0;
+	int rc = -1;
+
+	for (int i = 0; i < count; i++) {
+		struct vy_run_iterator *itr = itrs[i];
+		struct vy_slice *slice = itr->slice;
+		struct vy_run *run = slice->run;
+		assert(itr->iterator_type == ITER_EQ);
+		assert(!itr->search_started && itr->curr_page == NULL);
+		entry_idx[i] = -1;
+		/* Statements matching the key can't be in the slice. */
+		if ((slice->begin.stmt != NULL &&
+		     vy_entry_compare(itr->key, slice->begin,
+				      itr->cmp_def) < 0) ||
+		    (slice->end.stmt != NULL &&
+		     vy_entry_compare(itr->key, slice->end,
+				      itr->cmp_def) >= 0))
+			continue;
+		/* Check the bloom filter, see vy_run_iterator_seek(). */
+		bool maybe_has = true;
+		if (run->info.bloom != NULL) {
+			maybe_has = vy_bloom_maybe_has(run->info.bloom,
+						       itr->key, itr->key_def);
+		} else if (run->info.bloom_partition_count > 0 &&
+			   vy_run_iterator_check_bloom_partitions(
+					itr, &maybe_has) != 0) {
+			goto out;
+		}
+		if (!maybe_has) {
+			itr->search_started = true;
+			itr->stat->bloom_hit++;
+			continue;
+		}
+		/* Find the page vy_run_iterator_search() will load. */
+		bool unused;
+		uint32_t page_no = vy_page_index_find_page(run, itr->key,
+							   itr->cmp_def,
+							   ITER_EQ, &unused);
+		if (page_no == run->info.page_count)
+			continue;
+		if (cache->mem_quota > 0) {
+			struct vy_page *page = vy_page_cache_lookup(cache, run,
+								    page_no);
+			if (page != NULL) {
+				cache->hit++;
+				vy_run_iterator_cache_page(itr, page);
+				continue;
+			}
+		}
+		/* The page may be needed by another key of the batch. */
+		for (int j = 0; j < entry_count; j++) {
+			if (entries[j].run == run &&
+			    entries[j].page->page_no == page_no) {
+				entry_idx[i] = j;
+				break;
+			}
+		}
+		if (entry_idx[i] >= 0)
+			continue;
+		if (cache->mem_quota > 0)
+			cache->miss++;
+		struct vy_page_info *page_info = vy_run_page_info(run, page_no);
+		struct vy_page *page = vy_page_new(page_info);
+		if (page == NULL)
+			goto out;
+		page->page_no = page_no;
+		entries[entry_count].page_info = page_info;
+		entries[entry_count].run = run;
+		entries[entry_count].page = page;
+		entry_idx[i] = entry_count++;
+	}
+	if (entry_count == 0) {
+		rc = 0;
+		goto out;
+	}
+
+	/* Read all missing pages from the disk at once. */
+	struct vy_page_batch_read_task task;
+	task.env = env;
+	task.entries = entries;
+	task.entry_count = entry_count;
+	if (vy_run_env_coio_call(env, &task.base, vy_page_batch_read_cb) != 0)
+		goto out;
+
+	for (int j = 0; j < entry_count; j++) {
+		struct vy_page_info *page_info = entries[j].page_info;
+		/* Update read statistics. */
+		stat->read.rows += page_info->row_count;
+		stat->read.bytes += page_info->unpacked_size;
+		stat->read.bytes_compressed += page_info->size;
+		stat->read.pages++;
+		vy_page_cache_put(cache, entries[j].run, entries[j].page);
+	}
+	for (int i = 0; i < count; i++) {
+		if (entry_idx[i] >= 0)
+			vy_run_iterator_cache_page(itrs[i],
+						   entries[entry_idx[i]].page);
+	}
+	rc = 0;
+out:
+	for (int j = 0; j < entry_count; j++)
+		vy_page_unref(entries[j].page);
+	region_truncate(&fiber()->gc, region_svp);
+	return rc;
+}
+
 /**
  * Advance a run iterator to the newest statement for the next key.
  * The statement is returned in @ret (NULL if EOF).
@@ -1990,6 +2805,8 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 6;
 	if (run_info->bloom != NULL)
 		key_count++;
+	if (run_info->bloom_partition_count > 0)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2003,6 +2820,9 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	if (run_info->bloom != NULL)
 		size += mp_sizeof_uint(VY_RUN_INFO_BLOOM_FILTER) +
 			tuple_bloom_size(run_info->bloom);
+	if (run_info->bloom_partition_count > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_BLOOM_PARTITIONS) +
+			vy_bloom_partitions_sizeof(run_info);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
 
@@ -2031,6 +2851,10 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM_FILTER);
 		pos = tuple_bloom_encode(run_info->bloom, pos);
 	}
+	if (run_info->bloom_partition_count > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM_PARTITIONS);
+		pos = vy_bloom_partitions_encode(run_info, pos);
+	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
@@ -2061,6 +2885,7 @@ vy_run_write_index(struct vy_run *run, const char *dirpath,
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
+	opts.free_cache = run->env->drop_os_cache;
 	if (xlog_create(&index_xlog, path, 0, &meta, &opts) < 0)
 		return -1;
 
@@ -2105,11 +2930,23 @@ vy_run_write_index(struct vy_run *run, const char *dirpath,
 	return -1;
 }
 
+/** Build a run bloom filter of the given type. */
+static struct tuple_bloom *
+vy_run_bloom_new(struct tuple_bloom_builder *builder, double fpr,
+		 enum index_bloom_type type)
+{
+	if (type == INDEX_BLOOM_TYPE_XOR)
+		return tuple_bloom_new_xor(builder, fpr);
+	return tuple_bloom_new(builder, fpr);
+}
+
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     uint64_t page_size, double bloom_fpr,
+		     enum index_bloom_type bloom_type,
+		     bool bloom_partitioned, bool no_compression)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
@@ -2120,8 +2957,11 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	writer->key_def = key_def;
 	writer->page_size = page_size;
 	writer->bloom_fpr = bloom_fpr;
+	writer->bloom_type = bloom_type;
 	writer->no_compression = no_compression;
-	if (bloom_fpr < 1) {
+	if (bloom_fpr < 1 && bloom_partitioned) {
+		writer->bloom_partitioned = true;
+	} else if (bloom_fpr < 1) {
 		writer->bloom = tuple_bloom_builder_new(key_def->part_count);
 		if (writer->bloom == NULL)
 			return -1;
@@ -2156,6 +2996,7 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
+	opts.free_cache = writer->run->env->drop_os_cache;
 	opts.no_compression = writer->no_compression;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
@@ -2196,6 +3037,13 @@ vy_run_writer_start_page(struct vy_run_writer *writer,
 	if (vy_page_info_create(page, writer->data_xlog.offset,
 				key, writer->cmp_def) != 0)
 		return -1;
+	if (writer->bloom_partitioned && writer->bloom_partition == NULL) {
+		writer->bloom_partition = tuple_bloom_builder_new(
+					writer->key_def->part_count);
+		if (writer->bloom_partition == NULL)
+			return -1;
+		writer->bloom_partition_first_page_no = run->info.page_count;
+	}
 	xlog_tx_begin(&writer->data_xlog);
 	return 0;
 }
@@ -2214,6 +3062,10 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	if (writer->bloom != NULL &&
 	    vy_bloom_builder_add(writer->bloom, entry, writer->key_def) != 0)
 		return -1;
+	if (writer->bloom_partition != NULL &&
+	    vy_bloom_builder_add(writer->bloom_partition, entry,
+				 writer->key_def) != 0)
+		return -1;
 	if (writer->last.stmt != NULL)
 		vy_stmt_unref_if_possible(writer->last.stmt);
 	writer->last = entry;
@@ -2237,6 +3089,90 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	return 0;
 }
 
+/**
+ * Write the current bloom filter partition to the run file
+ * as a separate transaction following the pages it covers.
+ * @param writer Run writer.
+ * @retval -1 Memory or IO error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_end_bloom_partition(struct vy_run_writer *writer)
+{
+	struct vy_run *run = writer->run;
+	struct vy_run_info *info = &run->info;
+	assert(writer->bloom_partition != NULL);
+	assert(info->page_count > writer->bloom_partition_first_page_no);
+
+	if (info->bloom_partition_count >= writer->bloom_partition_capacity) {
+		uint32_t capacity = MAX(writer->bloom_partition_capacity * 2,
+					16U);
+		struct vy_bloom_partition *partitions = realloc(
+				info->bloom_partitions,
+				capacity * sizeof(*partitions));
+		if (partitions == NULL) {
+			diag_set(OutOfMemory, capacity * sizeof(*partitions),
+				 "realloc", "struct vy_bloom_partition");
+			return -1;
+		}
+		info->bloom_partitions = partitions;
+		writer->bloom_partition_capacity = capacity;
+	}
+
+	struct tuple_bloom *bloom = vy_run_bloom_new(writer->bloom_partition,
+						     writer->bloom_fpr,
+						     writer->bloom_type);
+	if (bloom == NULL)
+		return -1;
+	size_t size = mp_sizeof_map(1) +
+		      mp_sizeof_uint(VY_RUN_INFO_BLOOM_FILTER) +
+		      tuple_bloom_size(bloom);
+	char *pos = region_alloc(&fiber()->gc, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "region", "bloom partition");
+		tuple_bloom_delete(bloom);
+		return -1;
+	}
+	struct xrow_header xrow;
+	memset(&xrow, 0, sizeof(xrow));
+	xrow.type = VY_RUN_BLOOM;
+	xrow.body->iov_base = pos;
+	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM_FILTER);
+	pos = tuple_bloom_encode(bloom, pos);
+	xrow.body->iov_len = pos - (char *)xrow.body->iov_base;
+	xrow.bodycnt = 1;
+	/*
+	 * The partition is loaded on demand so there's no need
+	 * to keep it in memory.
+	 */
+	tuple_bloom_delete(bloom);
+
+	struct vy_bloom_partition *partition =
+		&info->bloom_partitions[info->bloom_partition_count];
+	memset(partition, 0, sizeof(*partition));
+	partition->first_page_no = writer->bloom_partition_first_page_no;
+	partition->offset = writer->data_xlog.offset;
+	xlog_tx_begin(&writer->data_xlog);
+	ssize_t written = xlog_write_row(&writer->data_xlog, &xrow);
+	if (written < 0) {
+		xlog_tx_rollback(&writer->data_xlog);
+		return -1;
+	}
+	partition->unpacked_size = written;
+	written = xlog_tx_commit(&writer->data_xlog);
+	if (written == 0)
+		written = xlog_flush(&writer->data_xlog);
+	if (written < 0)
+		return -1;
+	partition->size = written;
+	info->bloom_partition_count++;
+
+	tuple_bloom_builder_delete(writer->bloom_partition);
+	writer->bloom_partition = NULL;
+	return 0;
+}
+
 /**
  * Finish a current page.
  * @param writer Run writer.
@@ -2272,6 +3208,10 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	run->info.page_count++;
 	vy_run_acct_page(run, page);
 	ibuf_reset(&writer->row_index_buf);
+	if (writer->bloom_partition != NULL &&
+	    run->info.page_count - writer->bloom_partition_first_page_no >=
+	    VY_BLOOM_PARTITION_PAGES)
+		return vy_run_writer_end_bloom_partition(writer);
 	return 0;
 }
 
@@ -2310,6 +3250,8 @@ vy_run_writer_destroy(struct vy_run_writer *writer)
 		xlog_discard(&writer->data_xlog);
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
+	if (writer->bloom_partition != NULL)
+		tuple_bloom_builder_delete(writer->bloom_partition);
 	ibuf_destroy(&writer->row_index_buf);
 }
 
@@ -2322,6 +3264,9 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	if (ibuf_used(&writer->row_index_buf) != 0 &&
 	    vy_run_writer_end_page(writer) != 0)
 		goto out;
+	if (writer->bloom_partition != NULL &&
+	    vy_run_writer_end_bloom_partition(writer) != 0)
+		goto out;
 
 	struct vy_run *run = writer->run;
 	if (vy_run_is_empty(run)) {
@@ -2358,8 +3303,9 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 	}
 
 	if (writer->bloom != NULL) {
-		run->info.bloom = tuple_bloom_new(writer->bloom,
-						  writer->bloom_fpr);
+		run->info.bloom = vy_run_bloom_new(writer->bloom,
+						   writer->bloom_fpr,
+						   writer->bloom_type);
 		if (run->info.bloom == NULL)
 			goto out;
 	}
@@ -2436,6 +3382,14 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 				row_offset = xlog_cursor_tx_pos(&cursor);
 				continue;
 			}
+			if (xrow.type == VY_RUN_BLOOM) {
+				/*
+				 * Bloom filter partitions aren't
+				 * pages, the filter is rebuilt below.
+				 */
+				row_offset = xlog_cursor_tx_pos(&cursor);
+				continue;
+			}
 			++page_row_count;
 			struct tuple *tuple = vy_stmt_decode(&xrow, format);
 			if (tuple == NULL)
@@ -2472,6 +3426,8 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 				min_lsn = xrow.lsn;
 			row_offset = xlog_cursor_tx_pos(&cursor);
 		}
+		if (page_row_count == 0)
+			continue;
 		struct vy_page_info *info;
 		info = run->page_info + run->info.page_count;
 		if (vy_page_info_create(info, page_offset,
@@ -2505,8 +3461,9 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	xlog_cursor_close(&cursor, true);
 
 	if (bloom_builder != NULL) {
-		run->info.bloom = tuple_bloom_new(bloom_builder,
-						  opts->bloom_fpr);
+		run->info.bloom = vy_run_bloom_new(bloom_builder,
+						   opts->bloom_fpr,
+						   opts->bloom_type);
 		if (run->info.bloom == NULL)
 			goto close_err;
 		tuple_bloom_builder_delete(bloom_builder);
@@ -44,6 +44,7 @@
 #include "xlog.h"
 
 #include "small/mempool.h"
+#include "small/rlist.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -52,10 +53,38 @@ extern "C" {
 struct vy_history;
 struct vy_run_reader;
 
+/**
+ * Cache of decompressed run pages shared by all run iterators.
+ * Pages are evicted in LRU order once the memory limit is hit.
+ */
+struct vy_page_cache {
+	/** Max memory size that can be used by the cache, 0 disables it. */
+	size_t mem_quota;
+	/** Memory used by cached pages. */
+	size_t mem_used;
+	/** List of cached pages, the most recently used pages go first. */
+	struct rlist lru;
+	/** Number of page loads served from the cache. */
+	int64_t hit;
+	/** Number of page loads that had to read the disk. */
+	int64_t miss;
+};
+
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
 	/** Write rate limit, in bytes per second. */
 	uint64_t snap_io_rate_limit;
+	/**
+	 * If set, run file data is dropped from the OS page cache
+	 * once it has been read or written, because it's cached
+	 * by vinyl anyway.
+	 */
+	bool drop_os_cache;
+	/**
+	 * Amount of data read ahead by iterators scanning a run
+	 * sequentially, in bytes. Zero disables read-ahead.
+	 */
+	uint64_t read_ahead;
 	/** Mempool for struct vy_page_read_task */
 	struct mempool read_task_pool;
 	/** Key for thread-local ZSTD context */
@@ -74,6 +103,27 @@ struct vy_run_env {
 	 * unconditionally remove unused runs' files in-place.
 	 */
 	bool initial_join;
+	/** Cache of decompressed pages of all runs. */
+	struct vy_page_cache page_cache;
+	/** Memory used by bloom filter partitions loaded on demand. */
+	size_t bloom_partition_size;
+};
+
+/**
+ * Partition of a run bloom filter stored in the run file.
+ * Covers all statements of a range of adjacent pages.
+ */
+struct vy_bloom_partition {
+	/** Number of the first page covered by the partition. */
+	uint32_t first_page_no;
+	/** Size of the partition in the run file. */
+	uint32_t size;
+	/** Size of the partition in memory, i.e. unpacked. */
+	uint32_t unpacked_size;
+	/** Offset of the partition in the run file. */
+	uint64_t offset;
+	/** Loaded bloom filter or NULL if it hasn't been read yet. */
+	struct tuple_bloom *bloom;
 };
 
 /**
@@ -92,6 +142,14 @@ struct vy_run_info {
 	uint32_t page_count;
 	/** Bloom filter of all tuples in run */
 	struct tuple_bloom *bloom;
+	/**
+	 * Partitioned bloom filter, used instead of @bloom if
+	 * the index has bloom_partitioned option set. Partitions
+	 * are sorted by the first page number and loaded lazily.
+	 */
+	struct vy_bloom_partition *bloom_partitions;
+	/** Number of bloom filter partitions. */
+	uint32_t bloom_partition_count;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
 };
@@ -173,6 +231,11 @@ struct vy_run {
 	struct rlist in_unused;
 	/** Link in vy_lsm::runs list. */
 	struct rlist in_lsm;
+	/**
+	 * Pages of this run stored in the page cache, indexed by
+	 * page number. Allocated on the first insertion.
+	 */
+	struct vy_page **cached_pages;
 };
 
 /**
@@ -284,6 +347,11 @@ struct vy_run_iterator {
 	 */
 	struct vy_page *curr_page;
 	struct vy_page *prev_page;
+	/**
+	 * Number of the farthest page the iterator has read ahead,
+	 * in the iteration direction: 0 or UINT32_MAX if none.
+	 */
+	uint32_t read_ahead_page_no;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
 };
@@ -292,6 +360,15 @@ struct vy_run_iterator {
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/**
+	 * Reference counter. A page is referenced by each run
+	 * iterator that caches it and by the page cache.
+	 */
+	int refs;
+	/** Run this page belongs to, set if the page is cached. */
+	struct vy_run *run;
+	/** Link in vy_page_cache::lru. */
+	struct rlist in_cache;
 	/** Page position in the run file. */
 	uint32_t page_no;
 	/** Size of page data in memory, i.e. unpacked. */
@@ -320,6 +397,12 @@ vy_run_env_create(struct vy_run_env *env, int read_threads);
 void
 vy_run_env_destroy(struct vy_run_env *env);
 
+/**
+ * Set the memory limit of the page cache, evicting pages if needed.
+ */
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota);
+
 /**
  * Enable coio reads for a vinyl run environment.
  *
@@ -473,6 +556,16 @@ struct vy_slice *
 vy_slice_new(int64_t id, struct vy_run *run, struct vy_entry begin,
 	     struct vy_entry end, struct key_def *cmp_def);
 
+/**
+ * Estimate the number of statements in a slice matching the given
+ * key and iterator type. Only the page index is used so the estimate
+ * includes all statements of the pages at the boundaries of the
+ * requested key range.
+ */
+uint64_t
+vy_slice_estimate_count(struct vy_slice *slice, enum iterator_type type,
+			struct vy_entry key, struct key_def *cmp_def);
+
 /**
  * Free a run slice.
  * This function decrements @run->refs and
@@ -539,6 +632,23 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 		     struct key_def *cmp_def, struct key_def *key_def,
 		     struct tuple_format *format);
 
+/**
+ * Load pages needed by a batch of run iterators to look up their
+ * keys. All pages that aren't found in the page cache are read by
+ * a single reader thread call so that looking up many keys in the
+ * same run costs one round trip rather than one per key.
+ *
+ * The iterators must be opened for ITER_EQ with full keys and must
+ * not have been advanced yet. Iterators whose keys are filtered out
+ * by bloom filters are positioned at EOF. The other iterators will
+ * find the loaded pages in their own cache on the first call to
+ * vy_run_iterator_next().
+ *
+ * Returns 0 on success, -1 on memory allocation or IO error.
+ */
+NODISCARD int
+vy_run_iterator_prefetch(struct vy_run_iterator **itrs, int count);
+
 /**
  * Advance a run iterator to the next key.
  * The key history is returned in @history (empty if EOF).
@@ -633,8 +743,18 @@ struct vy_run_writer {
 	struct xlog data_xlog;
 	/** Bloom filter false positive rate. */
 	double bloom_fpr;
+	/** Type of filters to build. */
+	enum index_bloom_type bloom_type;
 	/** Bloom filter. */
 	struct tuple_bloom_builder *bloom;
+	/** Write a partitioned bloom filter instead of @bloom. */
+	bool bloom_partitioned;
+	/** Bloom filter of the current partition. */
+	struct tuple_bloom_builder *bloom_partition;
+	/** Number of the first page of the current partition. */
+	uint32_t bloom_partition_first_page_no;
+	/** Current bloom partition array capacity. */
+	uint32_t bloom_partition_capacity;
 	/** Buffer of a current page row offsets. */
 	struct ibuf row_index_buf;
 	/**
@@ -649,7 +769,9 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     uint64_t page_size, double bloom_fpr,
+		     enum index_bloom_type bloom_type,
+		     bool bloom_partitioned, bool no_compression);
 
 /**
  * Write a specified statement into a run.
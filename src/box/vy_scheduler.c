@@ -59,6 +59,7 @@
 #include "vy_run.h"
 #include "vy_write_iterator.h"
 #include "trivia/util.h"
+#include "trivia/usdt.h"
 
 /* Min and max values for vy_scheduler::timeout. */
 #define VY_SCHEDULER_TIMEOUT_MIN	1
@@ -204,6 +205,8 @@ struct vy_task {
 	 * from another thread.
 	 */
 	double bloom_fpr;
+	bool bloom_partitioned;
+	enum index_bloom_type bloom_type;
 	int64_t page_size;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
@@ -1115,6 +1118,7 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 lsm->space_id, lsm->index_id,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
+				 task->bloom_type, task->bloom_partitioned,
 				 no_compression) != 0)
 		goto fail;
 
@@ -1308,6 +1312,7 @@ vy_task_dump_complete(struct vy_task *task)
 	assert(scheduler->dump_task_count > 0);
 	scheduler->dump_task_count--;
 
+	USDT(vy_dump_finish, lsm->space_id, lsm->index_id, true);
 	say_info("%s: dump completed", vy_lsm_name(lsm));
 
 	vy_scheduler_complete_dump(scheduler);
@@ -1338,6 +1343,7 @@ vy_task_dump_abort(struct vy_task *task)
 	struct error *e = diag_last_error(&task->diag);
 	error_log(e);
 	say_error("%s: dump failed", vy_lsm_name(lsm));
+	USDT(vy_dump_finish, lsm->space_id, lsm->index_id, false);
 
 	vy_run_discard(task->new_run);
 
@@ -1433,6 +1439,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 				   is_last_level, scheduler->read_views, NULL);
 	if (wi == NULL)
 		goto err_wi;
+	if (lsm->index_id == 0)
+		vy_write_iterator_set_ttl(wi, lsm->opts.ttl_field, fiber_time());
 	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
 		if (mem->generation > scheduler->dump_generation)
 			continue;
@@ -1443,6 +1451,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_partitioned = lsm->opts.bloom_partitioned;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->page_size = lsm->opts.page_size;
 
 	lsm->is_dumping = true;
@@ -1462,6 +1472,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 
 	scheduler->dump_task_count++;
 
+	USDT(vy_dump_start, lsm->space_id, lsm->index_id);
 	say_info("%s: dump started", vy_lsm_name(lsm));
 	*p_task = task;
 	return 0;
@@ -1647,6 +1658,7 @@ vy_task_compaction_complete(struct vy_task *task)
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 
+	USDT(vy_compaction_finish, lsm->space_id, lsm->index_id, true);
 	say_info("%s: completed compacting range %s",
 		 vy_lsm_name(lsm), vy_range_str(range));
 	return 0;
@@ -1666,6 +1678,7 @@ vy_task_compaction_abort(struct vy_task *task)
 	error_log(e);
 	say_error("%s: failed to compact range %s",
 		  vy_lsm_name(lsm), vy_range_str(range));
+	USDT(vy_compaction_finish, lsm->space_id, lsm->index_id, false);
 
 	vy_run_discard(task->new_run);
 
@@ -1711,6 +1724,8 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 				   &task->deferred_delete_handler);
 	if (wi == NULL)
 		goto err_wi;
+	if (lsm->index_id == 0)
+		vy_write_iterator_set_ttl(wi, lsm->opts.ttl_field, fiber_time());
 
 	struct vy_slice *slice;
 	int32_t dump_count = 0;
@@ -1750,6 +1765,8 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_partitioned = lsm->opts.bloom_partitioned;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->page_size = lsm->opts.page_size;
 
 	/*
@@ -1759,6 +1776,7 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_range_heap_delete(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 
+	USDT(vy_compaction_start, lsm->space_id, lsm->index_id);
 	say_info("%s: started compacting range %s, runs %d/%d",
 		 vy_lsm_name(lsm), vy_range_str(range),
                  range->compaction_priority, range->slice_count);
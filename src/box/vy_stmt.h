@@ -310,6 +310,42 @@ vy_stmt_is_full_key(struct tuple *stmt, struct key_def *key_def)
 	return vy_stmt_key_part_count(stmt, key_def) == key_def->part_count;
 }
 
+/**
+ * Return true if the given REPLACE or INSERT statement has expired,
+ * i.e. its field @ttl_field (1-based) stores a number of seconds
+ * since the Epoch that is less than or equal to @now. An expired
+ * statement is treated as a DELETE. Zero @ttl_field disables
+ * expiration. Statements of other types and statements that don't
+ * store a number in the field never expire.
+ */
+static inline bool
+vy_stmt_is_expired(struct tuple *stmt, uint32_t ttl_field, double now)
+{
+	if (ttl_field == 0)
+		return false;
+	enum iproto_type type = vy_stmt_type(stmt);
+	if (type != IPROTO_REPLACE && type != IPROTO_INSERT)
+		return false;
+	const char *field = tuple_field(stmt, ttl_field - 1);
+	if (field == NULL)
+		return false;
+	double value;
+	switch (mp_typeof(*field)) {
+	case MP_UINT:
+		value = mp_decode_uint(&field);
+		break;
+	case MP_FLOAT:
+		value = mp_decode_float(&field);
+		break;
+	case MP_DOUBLE:
+		value = mp_decode_double(&field);
+		break;
+	default:
+		return false;
+	}
+	return value <= now;
+}
+
 /**
  * Return true if the given vinyl statement stores an empty
  * (match all) key.
@@ -952,7 +952,19 @@ vy_tx_track(struct vy_tx *tx, struct vy_lsm *lsm,
 	    struct vy_entry right, bool right_belongs)
 {
 	if (vy_tx_is_in_read_view(tx)) {
-		/* No point in tracking reads. */
+		/*
+		 * No point in tracking reads. The intervals tracked
+		 * before the transaction was sent to the read view can't
+		 * cause conflicts anymore, but they are still checked by
+		 * every writer, so drop them. It can't be done right in
+		 * vy_tx_send_to_read_view(), because it may be called
+		 * while iterating over the LSM tree read set.
+		 */
+		if (!vy_tx_read_set_empty(&tx->read_set)) {
+			vy_tx_read_set_iter(&tx->read_set, NULL,
+					    vy_tx_read_set_free_cb, NULL);
+			vy_tx_read_set_new(&tx->read_set);
+		}
 		return 0;
 	}
 
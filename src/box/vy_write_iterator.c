@@ -189,6 +189,13 @@ struct vy_write_iterator {
 	 * of the old tuple from secondary indexes.
 	 */
 	struct vy_entry deferred_delete;
+	/**
+	 * Number of the field storing tuple expiration time,
+	 * starting from 1, or 0 if tuples never expire.
+	 */
+	uint32_t ttl_field;
+	/** Time used to check if a tuple has expired. */
+	double ttl_now;
 	/** Length of the @read_views. */
 	int rv_count;
 	/**
@@ -390,10 +397,23 @@ vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 	stream->is_last_level = is_last_level;
 	stream->deferred_delete_handler = handler;
 	stream->deferred_delete = vy_entry_none();
+	stream->ttl_field = 0;
+	stream->ttl_now = 0;
 	stream->last = vy_entry_none();
 	return &stream->base;
 }
 
+void
+vy_write_iterator_set_ttl(struct vy_stmt_stream *vstream,
+			  uint32_t ttl_field, double now)
+{
+	assert(vstream->iface == &vy_slice_stream_iface);
+	struct vy_write_iterator *stream = (struct vy_write_iterator *)vstream;
+	assert(stream->is_primary || ttl_field == 0);
+	stream->ttl_field = ttl_field;
+	stream->ttl_now = now;
+}
+
 /**
  * Start the search. Must be called after *new* methods and
  * before *next* method.
@@ -763,10 +783,13 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 
 		/*
 		 * Optimization 1: skip last level delete.
+		 * An expired tuple is treated as a DELETE.
 		 * @sa vy_write_iterator for details about this
 		 * and other optimizations.
 		 */
-		if (vy_stmt_type(src->entry.stmt) == IPROTO_DELETE &&
+		if ((vy_stmt_type(src->entry.stmt) == IPROTO_DELETE ||
+		     vy_stmt_is_expired(src->entry.stmt, stream->ttl_field,
+					stream->ttl_now)) &&
 		    stream->is_last_level && merge_until_lsn < 0) {
 			current_rv_lsn = -1; /* Force skip */
 			goto next_lsn;
@@ -875,6 +898,11 @@ vy_read_view_merge(struct vy_write_iterator *stream, struct vy_entry prev,
 	     vy_stmt_type(prev.stmt) != IPROTO_UPSERT))) {
 		assert(!stream->is_last_level || prev.stmt == NULL ||
 		       vy_stmt_type(prev.stmt) != IPROTO_UPSERT);
+		/* UPSERT applied to an expired tuple inserts a new one. */
+		if (prev.stmt != NULL &&
+		    vy_stmt_is_expired(prev.stmt, stream->ttl_field,
+				       stream->ttl_now))
+			prev = vy_entry_none();
 		struct vy_entry applied;
 		applied = vy_entry_apply_upsert(h->entry, prev,
 						stream->cmp_def, false);
@@ -890,8 +918,12 @@ vy_read_view_merge(struct vy_write_iterator *stream, struct vy_entry prev,
 		assert(h->entry.stmt != NULL &&
 		       vy_stmt_type(h->entry.stmt) == IPROTO_UPSERT);
 		assert(result->entry.stmt != NULL);
+		struct vy_entry base = result->entry;
+		if (vy_stmt_is_expired(base.stmt, stream->ttl_field,
+				       stream->ttl_now))
+			base = vy_entry_none();
 		struct vy_entry applied;
-		applied = vy_entry_apply_upsert(h->entry, result->entry,
+		applied = vy_entry_apply_upsert(h->entry, base,
 						stream->cmp_def, false);
 		if (applied.stmt == NULL)
 			return -1;
@@ -252,6 +252,16 @@ vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 		      bool is_last_level, struct rlist *read_views,
 		      struct vy_deferred_delete_handler *handler);
 
+/**
+ * Make the iterator treat tuples that expired by @now as DELETE
+ * statements. @ttl_field is the number of the field storing tuple
+ * expiration time, starting from 1, or 0 if tuples never expire.
+ * Only relevant to primary index.
+ */
+void
+vy_write_iterator_set_ttl(struct vy_stmt_stream *stream,
+			  uint32_t ttl_field, double now);
+
 /**
  * Add a mem as a source to the iterator.
  * @return 0 on success, -1 on error (diag is set).
@@ -32,6 +32,7 @@
 
 #include "fiber.h"
 #include "fio.h"
+#include "tt_pthread.h"
 #include "errinj.h"
 #include "error.h"
 #include "exception.h"
@@ -44,6 +45,8 @@
 #include "replication.h"
 #include "iproto_constants.h"
 #include "watcher.h"
+#include "small/ibuf.h"
+#include "trivia/usdt.h"
 
 enum {
 	/**
@@ -55,6 +58,19 @@ enum {
 	 * latency. 1 MB seems to be a well balanced choice.
 	 */
 	WAL_FALLOCATE_LEN = 1024 * 1024,
+	/**
+	 * Max size of disk space to preallocate with xlog_fallocate().
+	 * Each preallocation is a file system journal commit, so if
+	 * the WAL keeps growing, the preallocation size is doubled
+	 * up to this limit to make such commits rare under a high
+	 * write load.
+	 */
+	WAL_FALLOCATE_LEN_MAX = 32 * 1024 * 1024,
+	/**
+	 * Max amount of data copied from the WAL ring in one go.
+	 * It limits the time the ring is locked by a reader.
+	 */
+	WAL_RING_READ_MAX = 1024 * 1024,
 };
 
 const char *wal_mode_STRS[WAL_MODE_MAX] = {
@@ -79,6 +95,40 @@ wal_write_none_async(struct journal *, struct journal_entry *);
 static int
 wal_write_none(struct journal *, struct journal_entry *);
 
+/** Rows written to WAL by one batch, see struct wal_ring. */
+struct wal_ring_entry {
+	/** WAL vclock before the batch. */
+	struct vclock vclock;
+	/** Size of the encoded rows. */
+	size_t size;
+	/** Rows encoded as in a WAL file. */
+	char data[0];
+};
+
+/**
+ * A ring buffer of recently written rows. It lets relays that keep
+ * up with the master send new rows without re-reading them from
+ * the WAL file. Appended by the WAL thread, read by relay threads.
+ */
+struct wal_ring {
+	/** Protects all the members. */
+	pthread_mutex_t mutex;
+	/**
+	 * Array of capacity entries indexed by seqno modulo
+	 * capacity. Capacity is a power of two.
+	 */
+	struct wal_ring_entry **entries;
+	int64_t capacity;
+	/** Seqno of the oldest entry. */
+	int64_t first_seqno;
+	/** Seqno of the next entry to append. */
+	int64_t next_seqno;
+	/** Total size of the entries' data. */
+	size_t size;
+	/** Max size of the entries' data, 0 if the ring is disabled. */
+	size_t max_size;
+};
+
 /*
  * WAL writer - maintain a Write Ahead Log for every change
  * in the data state.
@@ -116,6 +166,11 @@ struct wal_writer
 	int64_t wal_max_size;
 	/** Another one - wal_mode */
 	enum wal_mode wal_mode;
+	/**
+	 * Size of disk space to preallocate in the current WAL
+	 * next time, see WAL_FALLOCATE_LEN_MAX.
+	 */
+	size_t fallocate_len;
 	/** wal_dir, from the configuration file. */
 	struct xdir wal_dir;
 	/** 'wal' thread doing the writes. */
@@ -174,6 +229,8 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/** Recently written rows, see wal_ring_read(). */
+	struct wal_ring ring;
 };
 
 struct wal_msg {
@@ -241,7 +298,18 @@ wal_msg(struct cmsg *msg)
 	return msg->route == wal_request_route ? (struct wal_msg *) msg : NULL;
 }
 
-/** Write a request to a log in a single transaction. */
+/**
+ * Write a request to a log in a single transaction.
+ *
+ * All rows of a journal entry go to one xlog block so that a torn write
+ * of a huge transaction is discarded as a whole on recovery. Writing
+ * such a transaction in several blocks would bound the memory used by
+ * the WAL thread, but a crash in the middle would leave the transaction
+ * without the row flagged with is_commit at the end of the log. Local
+ * recovery treats it as an error (see wal_stream_has_unfinished_tx()),
+ * and relays would send the partial transaction to replicas again after
+ * a restart, so both would have to learn to skip such a tail first.
+ */
 static ssize_t
 xlog_write_entry(struct xlog *l, struct journal_entry *entry)
 {
@@ -426,6 +494,7 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 {
 	writer->wal_mode = wal_mode;
 	writer->wal_max_size = wal_max_size;
+	writer->fallocate_len = WAL_FALLOCATE_LEN;
 
 	journal_create(&writer->base,
 		       wal_mode == WAL_NONE ?
@@ -442,8 +511,6 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	 */
 	xdir_set_retention_period(&writer->wal_dir, wal_retention_period);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
-		writer->wal_dir.open_wflags |= O_SYNC;
 
 	stailq_create(&writer->rollback);
 	writer->is_in_rollback = false;
@@ -461,6 +528,194 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	mempool_create(&writer->msg_pool, &cord()->slabc,
 		       sizeof(struct wal_msg));
+
+	struct wal_ring *ring = &writer->ring;
+	tt_pthread_mutex_init(&ring->mutex, NULL);
+	ring->entries = NULL;
+	ring->capacity = 0;
+	ring->first_seqno = 1;
+	ring->next_seqno = 1;
+	ring->size = 0;
+	ring->max_size = 0;
+}
+
+/**
+ * Drop all entries from the ring. The next seqno is skipped so that
+ * readers positioned at the end of the ring fall back on WAL files.
+ * Must be called under the ring mutex.
+ */
+static void
+wal_ring_clear(struct wal_ring *ring)
+{
+	for (int64_t seqno = ring->first_seqno; seqno < ring->next_seqno;
+	     seqno++)
+		free(ring->entries[seqno & (ring->capacity - 1)]);
+	ring->next_seqno++;
+	ring->first_seqno = ring->next_seqno;
+	ring->size = 0;
+}
+
+/**
+ * Drop the oldest entries until the ring fits in its max size.
+ * Must be called under the ring mutex.
+ */
+static void
+wal_ring_evict(struct wal_ring *ring)
+{
+	while (ring->size > ring->max_size) {
+		assert(ring->first_seqno < ring->next_seqno);
+		struct wal_ring_entry **entry =
+			&ring->entries[ring->first_seqno & (ring->capacity - 1)];
+		ring->size -= (*entry)->size;
+		free(*entry);
+		*entry = NULL;
+		ring->first_seqno++;
+	}
+}
+
+/**
+ * Make room for a new entry in the ring array.
+ * Must be called under the ring mutex.
+ */
+static int
+wal_ring_reserve(struct wal_ring *ring)
+{
+	if (ring->next_seqno - ring->first_seqno < ring->capacity)
+		return 0;
+	int64_t capacity = ring->capacity > 0 ? ring->capacity * 2 : 1024;
+	struct wal_ring_entry **entries =
+		calloc(capacity, sizeof(*entries));
+	if (entries == NULL)
+		return -1;
+	for (int64_t seqno = ring->first_seqno; seqno < ring->next_seqno;
+	     seqno++) {
+		entries[seqno & (capacity - 1)] =
+			ring->entries[seqno & (ring->capacity - 1)];
+	}
+	free(ring->entries);
+	ring->entries = entries;
+	ring->capacity = capacity;
+	return 0;
+}
+
+/**
+ * Append the rows of the given journal entries to the ring.
+ * @a vclock is the WAL vclock before the entries.
+ */
+static void
+wal_ring_append(struct wal_ring *ring, const struct vclock *vclock,
+		struct stailq_entry *first, struct stailq_entry *last)
+{
+	size_t size = 0;
+	struct journal_entry *entry;
+	struct stailq_entry *item;
+	for (item = first; ; item = stailq_next(item)) {
+		entry = stailq_entry(item, struct journal_entry, fifo);
+		for (int i = 0; i < entry->n_rows; i++) {
+			struct xrow_header *row = entry->rows[i];
+			size += XROW_HEADER_LEN_MAX;
+			for (int j = 0; j < row->bodycnt; j++)
+				size += row->body[j].iov_len;
+		}
+		if (item == last)
+			break;
+	}
+	struct wal_ring_entry *ring_entry = malloc(sizeof(*ring_entry) +
+						   size);
+	if (ring_entry != NULL) {
+		vclock_copy(&ring_entry->vclock, vclock);
+		char *pos = ring_entry->data;
+		for (item = first; ; item = stailq_next(item)) {
+			entry = stailq_entry(item, struct journal_entry, fifo);
+			for (int i = 0; i < entry->n_rows; i++) {
+				struct xrow_header *row = entry->rows[i];
+				pos = xrow_header_encode_buf(row, 0, pos);
+				for (int j = 0; j < row->bodycnt; j++) {
+					memcpy(pos, row->body[j].iov_base,
+					       row->body[j].iov_len);
+					pos += row->body[j].iov_len;
+				}
+			}
+			if (item == last)
+				break;
+		}
+		ring_entry->size = pos - ring_entry->data;
+	}
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->max_size == 0) {
+		free(ring_entry);
+	} else if (ring_entry == NULL || wal_ring_reserve(ring) != 0) {
+		say_warn_ratelimited("failed to allocate WAL ring entry");
+		free(ring_entry);
+		wal_ring_clear(ring);
+	} else {
+		ring->entries[ring->next_seqno & (ring->capacity - 1)] =
+			ring_entry;
+		ring->next_seqno++;
+		ring->size += ring_entry->size;
+		wal_ring_evict(ring);
+	}
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+void
+wal_set_ring_size(int64_t size)
+{
+	struct wal_ring *ring = &wal_writer_singleton.ring;
+	tt_pthread_mutex_lock(&ring->mutex);
+	ring->max_size = size;
+	if (ring->max_size == 0)
+		wal_ring_clear(ring);
+	else
+		wal_ring_evict(ring);
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+int
+wal_ring_read(int64_t *seqno, const struct vclock *vclock, struct ibuf *buf)
+{
+	struct wal_ring *ring = &wal_writer_singleton.ring;
+	int rc = -1;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->max_size == 0)
+		goto out;
+	if (*seqno == 0) {
+		/*
+		 * Look up the newest entry written after the given
+		 * vclock. The entry vclocks grow monotonically.
+		 */
+		int64_t begin = ring->first_seqno;
+		int64_t end = ring->next_seqno;
+		while (begin < end) {
+			int64_t mid = begin + (end - begin) / 2;
+			struct wal_ring_entry *entry =
+				ring->entries[mid & (ring->capacity - 1)];
+			if (vclock_compare_ignore0(&entry->vclock, vclock) <= 0)
+				begin = mid + 1;
+			else
+				end = mid;
+		}
+		if (begin == ring->first_seqno)
+			goto out;
+		*seqno = begin - 1;
+	} else if (*seqno < ring->first_seqno) {
+		goto out;
+	}
+	size_t copied = 0;
+	for (; *seqno < ring->next_seqno && copied < WAL_RING_READ_MAX;
+	     (*seqno)++) {
+		struct wal_ring_entry *entry =
+			ring->entries[*seqno & (ring->capacity - 1)];
+		void *data = ibuf_alloc(buf, entry->size);
+		if (data == NULL)
+			goto out;
+		memcpy(data, entry->data, entry->size);
+		copied += entry->size;
+	}
+	rc = 0;
+out:
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
 }
 
 /** Destroy a WAL writer structure. */
@@ -793,6 +1048,12 @@ wal_set_queue_max_size(int64_t size)
 	journal_queue_set_max_size(size);
 }
 
+int
+wal_set_cpu_affinity(const char *cpu_list)
+{
+	return cord_set_cpu_affinity(&wal_writer_singleton.cord, cpu_list);
+}
+
 /** Retention delay configuration message. */
 struct wal_set_retention_period_msg {
 	/* The state of a synchronous cross-thread call. */
@@ -929,6 +1190,7 @@ wal_opt_rotate(struct wal_writer *writer)
 	if (xdir_create_xlog(&writer->wal_dir, &writer->current_wal,
 			     &writer->vclock) != 0)
 		return -1;
+	writer->fallocate_len = WAL_FALLOCATE_LEN;
 	/*
 	 * Keep track of the new WAL vclock. Required for garbage
 	 * collection, see wal_collect_garbage().
@@ -979,8 +1241,22 @@ wal_fallocate(struct wal_writer *writer, size_t len)
 	if (errinj == NULL || errinj->iparam == 0) {
 		if (l->allocated >= len)
 			goto out;
-		if (xlog_fallocate(l, MAX(len, WAL_FALLOCATE_LEN)) == 0)
+		/*
+		 * Don't preallocate much beyond the max WAL size:
+		 * the excess is freed on rotation anyway.
+		 */
+		size_t fallocate_len = writer->fallocate_len;
+		if (l->offset + fallocate_len > (size_t)writer->wal_max_size) {
+			fallocate_len = writer->wal_max_size > l->offset ?
+					writer->wal_max_size - l->offset : 0;
+			fallocate_len = MAX(fallocate_len,
+					    (size_t)WAL_FALLOCATE_LEN);
+		}
+		if (xlog_fallocate(l, MAX(len, fallocate_len)) == 0) {
+			writer->fallocate_len = MIN(writer->fallocate_len * 2,
+						    WAL_FALLOCATE_LEN_MAX);
 			goto out;
+		}
 	} else {
 		errinj->iparam--;
 		diag_set(ClientError, ER_INJECTION, "xlog fallocate");
@@ -1114,6 +1390,7 @@ wal_write_to_disk(struct cmsg *msg)
 	struct error *error;
 	if (stailq_empty(&wal_msg->commit))
 		panic("Attempted to write an empty batch to WAL");
+	USDT(wal_write_start, wal_msg->approx_len);
 
 	/*
 	 * Track all vclock changes made by this batch into
@@ -1122,6 +1399,9 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 	struct vclock vclock_diff;
 	vclock_create(&vclock_diff);
+	/* WAL vclock before the batch, for the WAL ring. */
+	struct vclock ring_vclock;
+	vclock_copy(&ring_vclock, &writer->vclock);
 
 	ERROR_INJECT_SLEEP(ERRINJ_WAL_DELAY);
 
@@ -1172,6 +1452,17 @@ wal_write_to_disk(struct cmsg *msg)
 
 	struct xlog *l = &writer->current_wal;
 
+	/*
+	 * In the fsync mode, the whole batch is synced to disk with
+	 * a single fdatasync(2) call after it has been written so that
+	 * the cost of syncing is paid once per batch rather than once
+	 * per write(2), as it would be with O_SYNC. Until then, none
+	 * of the batch requests may be considered committed, so on
+	 * failure we discard everything written since the batch start.
+	 */
+	bool is_sync = writer->wal_mode == WAL_FSYNC;
+	off_t batch_offset = l->offset;
+
 	/*
 	 * Iterate over requests (transactions)
 	 */
@@ -1183,22 +1474,33 @@ wal_write_to_disk(struct cmsg *msg)
 		rc = xlog_write_entry(l, entry);
 		if (rc < 0) {
 			err_code = JOURNAL_ENTRY_ERR_IO;
-			goto done;
+			goto discard;
 		}
 		if (rc > 0) {
 			writer->checkpoint_wal_size += rc;
-			last_committed = &entry->fifo;
-			vclock_merge(&writer->vclock, &vclock_diff);
+			if (!is_sync) {
+				last_committed = &entry->fifo;
+				vclock_merge(&writer->vclock, &vclock_diff);
+			}
 		}
 		/* rc == 0: the write is buffered in xlog_tx */
 	}
 	rc = xlog_flush(l);
 	if (rc < 0) {
 		err_code = JOURNAL_ENTRY_ERR_IO;
-		goto done;
+		goto discard;
 	}
-
 	writer->checkpoint_wal_size += rc;
+	if (is_sync) {
+		USDT(wal_fsync_start);
+		rc = xlog_datasync(l);
+		USDT(wal_fsync_finish, rc);
+		if (rc != 0) {
+			err_code = JOURNAL_ENTRY_ERR_IO;
+			goto discard;
+		}
+	}
+
 	last_committed = stailq_last(&wal_msg->commit);
 	vclock_merge(&writer->vclock, &vclock_diff);
 
@@ -1223,7 +1525,13 @@ wal_write_to_disk(struct cmsg *msg)
 				 "notification message");
 		}
 	}
+	goto done;
 
+discard:
+	if (is_sync && l->offset > batch_offset) {
+		writer->checkpoint_wal_size -= l->offset - batch_offset;
+		xlog_truncate(l, batch_offset);
+	}
 done:
 	error = diag_last_error(diag_get());
 	if (error) {
@@ -1246,6 +1554,7 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 	struct stailq rollback;
 	stailq_cut_tail(&wal_msg->commit, last_committed, &rollback);
+	USDT(wal_write_finish, wal_msg->approx_len, stailq_empty(&rollback));
 
 	if (!stailq_empty(&rollback)) {
 		assert(err_code != JOURNAL_ENTRY_ERR_UNKNOWN);
@@ -1258,6 +1567,15 @@ wal_write_to_disk(struct cmsg *msg)
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
+	/*
+	 * The ring size is read without locking here, because it's
+	 * rechecked under the ring mutex on append.
+	 */
+	if (last_committed != NULL && writer->ring.max_size != 0) {
+		wal_ring_append(&writer->ring, &ring_vclock,
+				stailq_first(&wal_msg->commit),
+				last_committed);
+	}
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
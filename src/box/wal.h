@@ -38,6 +38,7 @@
 #include "vclock/vclock.h"
 
 struct fiber;
+struct ibuf;
 struct wal_writer;
 struct tt_uuid;
 
@@ -267,6 +268,32 @@ wal_set_checkpoint_threshold(int64_t threshold);
 void
 wal_set_queue_max_size(int64_t size);
 
+/**
+ * Set the size of the in-memory ring of recently written rows that
+ * relays read instead of WAL files. Zero disables the ring.
+ */
+void
+wal_set_ring_size(int64_t size);
+
+/**
+ * Copy rows written to WAL after @a vclock from the in-memory ring
+ * to @a buf. The rows are encoded as in a WAL file and end on
+ * a transaction boundary. @a seqno is the position in the ring:
+ * it must be 0 on the first call and is advanced on return.
+ *
+ * Returns -1 if the rows aren't (or are no longer) in the ring,
+ * in which case they must be read from WAL files.
+ */
+int
+wal_ring_read(int64_t *seqno, const struct vclock *vclock, struct ibuf *buf);
+
+/**
+ * Pins the WAL thread to the given CPUs, see cord_set_cpu_affinity().
+ * Returns -1 and sets diag on error.
+ */
+int
+wal_set_cpu_affinity(const char *cpu_list);
+
 /**
  * Set new value for wal_retention_period, update expiration time
  * of all xlog files.
@@ -0,0 +1,186 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "wal_ext.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assoc.h"
+#include "iproto_constants.h"
+#include "space.h"
+#include "trivia/util.h"
+#include "tuple.h"
+#include "txn.h"
+#include "xrow.h"
+
+#if defined(ENABLE_WAL_EXT)
+# error unimplemented
+#endif
+
+/** WAL extensions configured for a space with the given name. */
+struct wal_ext_space {
+	/** Extensions of the space. */
+	struct space_wal_ext ext;
+	/** Space name, null-terminated. */
+	char name[0];
+};
+
+/** WAL extensions configuration. */
+struct wal_ext_cfg {
+	/** Extensions of spaces not configured explicitly. */
+	struct space_wal_ext default_ext;
+	/** Space name -> struct wal_ext_space. */
+	struct mh_strnptr_t *spaces;
+};
+
+/** Current configuration. */
+static struct wal_ext_cfg wal_ext_current;
+
+/** Configuration started with wal_ext_cfg_begin(). */
+static struct wal_ext_cfg wal_ext_pending;
+
+static inline bool
+space_wal_ext_is_enabled(const struct space_wal_ext *ext)
+{
+	return ext->old_tuple || ext->new_tuple;
+}
+
+static void
+wal_ext_cfg_create(struct wal_ext_cfg *cfg,
+		   const struct space_wal_ext *default_ext)
+{
+	cfg->default_ext = *default_ext;
+	cfg->spaces = mh_strnptr_new();
+}
+
+static void
+wal_ext_cfg_destroy(struct wal_ext_cfg *cfg)
+{
+	if (cfg->spaces == NULL)
+		return;
+	mh_int_t i;
+	mh_foreach(cfg->spaces, i)
+		free(mh_strnptr_node(cfg->spaces, i)->val);
+	mh_strnptr_delete(cfg->spaces);
+	cfg->spaces = NULL;
+}
+
+void
+wal_ext_init(void)
+{
+	struct space_wal_ext default_ext = {
+		.old_tuple = false,
+		.new_tuple = false,
+	};
+	wal_ext_cfg_create(&wal_ext_current, &default_ext);
+}
+
+void
+wal_ext_free(void)
+{
+	wal_ext_cfg_destroy(&wal_ext_pending);
+	wal_ext_cfg_destroy(&wal_ext_current);
+}
+
+void
+space_wal_ext_process_request(struct space_wal_ext *ext, struct txn_stmt *stmt,
+			      struct request *request)
+{
+	bool has_new_tuple;
+	switch (request->type) {
+	case IPROTO_UPDATE:
+	case IPROTO_UPSERT:
+		has_new_tuple = true;
+		break;
+	case IPROTO_REPLACE:
+	case IPROTO_DELETE:
+		has_new_tuple = false;
+		break;
+	default:
+		return;
+	}
+	uint32_t size;
+	if (ext->old_tuple && stmt->old_tuple != NULL) {
+		request->old_tuple = tuple_data_range(stmt->old_tuple, &size);
+		request->old_tuple_end = request->old_tuple + size;
+	}
+	if (ext->new_tuple && has_new_tuple && stmt->new_tuple != NULL) {
+		request->new_tuple = tuple_data_range(stmt->new_tuple, &size);
+		request->new_tuple_end = request->new_tuple + size;
+	}
+}
+
+struct space_wal_ext *
+space_wal_ext_by_name(const char *space_name)
+{
+	struct wal_ext_cfg *cfg = &wal_ext_current;
+	if (cfg->spaces == NULL)
+		return NULL;
+	mh_int_t i = mh_strnptr_find_str(cfg->spaces, space_name,
+					 strlen(space_name));
+	struct space_wal_ext *ext;
+	if (i != mh_end(cfg->spaces)) {
+		struct wal_ext_space *s = mh_strnptr_node(cfg->spaces, i)->val;
+		ext = &s->ext;
+	} else {
+		ext = &cfg->default_ext;
+	}
+	return space_wal_ext_is_enabled(ext) ? ext : NULL;
+}
+
+void
+wal_ext_cfg_begin(const struct space_wal_ext *default_ext)
+{
+	wal_ext_cfg_destroy(&wal_ext_pending);
+	wal_ext_cfg_create(&wal_ext_pending, default_ext);
+}
+
+void
+wal_ext_cfg_add_space(const char *space_name,
+		      const struct space_wal_ext *ext)
+{
+	struct wal_ext_cfg *cfg = &wal_ext_pending;
+	assert(cfg->spaces != NULL);
+	size_t name_len = strlen(space_name);
+	struct wal_ext_space *s = xmalloc(sizeof(*s) + name_len + 1);
+	s->ext = *ext;
+	memcpy(s->name, space_name, name_len + 1);
+	struct mh_strnptr_node_t node = {
+		s->name, name_len, mh_strn_hash(s->name, name_len), s,
+	};
+	struct mh_strnptr_node_t old_node, *p_old_node = &old_node;
+	mh_strnptr_put(cfg->spaces, &node, &p_old_node, NULL);
+	if (p_old_node != NULL)
+		free(p_old_node->val);
+}
+
+static int
+wal_ext_update_space_cb(struct space *space, void *arg)
+{
+	(void)arg;
+	space->wal_ext = space_wal_ext_by_name(space_name(space));
+	return 0;
+}
+
+void
+wal_ext_cfg_commit(void)
+{
+	assert(wal_ext_pending.spaces != NULL);
+	struct wal_ext_cfg old_cfg = wal_ext_current;
+	wal_ext_current.spaces = wal_ext_pending.spaces;
+	wal_ext_current.default_ext = wal_ext_pending.default_ext;
+	wal_ext_pending.spaces = NULL;
+	/*
+	 * Spaces point to the old configuration so we must update them
+	 * before freeing it.
+	 */
+	space_foreach(wal_ext_update_space_cb, NULL);
+	wal_ext_cfg_destroy(&old_cfg);
+}
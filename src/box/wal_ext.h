@@ -15,48 +15,75 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+#include <stdbool.h>
 #include <stddef.h>
 
+struct txn_stmt;
+struct request;
+
+/**
+ * WAL extensions of a space: additional data written to DML requests stored
+ * in the WAL so that it can be consumed by CDC tools reading xlogs or
+ * the replication stream without looking up tuples in the database.
+ */
+struct space_wal_ext {
+	/**
+	 * Write the old tuple to UPDATE, UPSERT, REPLACE, and DELETE
+	 * requests (IPROTO_OLD_TUPLE).
+	 */
+	bool old_tuple;
+	/**
+	 * Write the new tuple to UPDATE and UPSERT requests
+	 * (IPROTO_NEW_TUPLE). INSERT and REPLACE requests already
+	 * contain the new tuple.
+	 */
+	bool new_tuple;
+};
+
 /** Initialize WAL extensions cache. */
-static inline void
-wal_ext_init(void)
-{
-}
+void
+wal_ext_init(void);
 
 /** Cleanup extensions cache and default value. */
-static inline void
-wal_ext_free(void)
-{
-}
-
-struct space_wal_ext;
-struct txn_stmt;
-struct request;
+void
+wal_ext_free(void);
 
 /**
  * Fills in @a request with data from @a stmt depending on space's WAL
  * extensions.
  */
-static inline void
+void
 space_wal_ext_process_request(struct space_wal_ext *ext, struct txn_stmt *stmt,
-			      struct request *request)
-{
-	(void)ext;
-	(void)stmt;
-	(void)request;
-}
+			      struct request *request);
 
 /**
  * Return reference to corresponding WAL extension by given space name.
  * Returned object MUST NOT be freed or changed in any way; it should be
- * read-only.
+ * read-only. Returns NULL if no extensions are enabled for the space.
+ */
+struct space_wal_ext *
+space_wal_ext_by_name(const char *space_name);
+
+/**
+ * Starts a new WAL extensions configuration with the given default
+ * extensions applied to spaces not configured explicitly. Settings of
+ * spaces are added with wal_ext_cfg_add_space(). The new configuration
+ * replaces the current one on wal_ext_cfg_commit().
+ */
+void
+wal_ext_cfg_begin(const struct space_wal_ext *default_ext);
+
+/** Sets WAL extensions of the space with the given name. */
+void
+wal_ext_cfg_add_space(const char *space_name,
+		      const struct space_wal_ext *ext);
+
+/**
+ * Replaces the current WAL extensions configuration with the one started
+ * with wal_ext_cfg_begin() and updates extensions of all spaces.
  */
-static inline struct space_wal_ext *
-space_wal_ext_by_name(const char *space_name)
-{
-	(void)space_name;
-	return NULL;
-}
+void
+wal_ext_cfg_commit(void);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -20,6 +20,14 @@
 #include "trivia/util.h"
 #include "tt_static.h"
 
+/**
+ * Number of watcher callbacks the worker fiber runs in a row before yielding.
+ * Broadcasting a key watched by lots of sessions, like every connection of a
+ * big cluster, would otherwise block the tx thread until all of them are
+ * notified.
+ */
+enum { WATCHABLE_WORKER_YIELD_LOOPS = 1000 };
+
 /**
  * Global watchable object used by box.
  */
@@ -351,11 +359,16 @@ watchable_worker_f(va_list ap)
 	(void)ap;
 	struct watchable *watchable = fiber()->f_arg;
 	assert(watchable->worker == fiber());
+	int loops = 0;
 	while (!fiber_is_cancelled()) {
 		fiber_check_gc();
 		if (!watchable_run(watchable)) {
 			/* No more watchers to run, wait... */
+			loops = 0;
 			fiber_yield();
+		} else if (++loops % WATCHABLE_WORKER_YIELD_LOOPS == 0) {
+			/* Let other fibers run between the batches. */
+			fiber_sleep(0);
 		}
 	}
 	return 0;
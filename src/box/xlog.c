@@ -34,6 +34,7 @@
 #include <ctype.h>
 
 #include "fiber.h"
+#include "tt_pthread.h"
 #include "exception.h"
 #include "crc32.h"
 #include "fio.h"
@@ -98,6 +99,8 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.compress_threads = 1,
+	.compression_level = XLOG_COMPRESSION_LEVEL_DEFAULT,
 };
 
 /* {{{ struct xlog_meta */
@@ -357,6 +360,11 @@ xdir_create(struct xdir *dir, const char *dirname, enum xdir_type type,
 		dir->filename_ext = ".vylog";
 		dir->suffix = INPROGRESS;
 		break;
+	case DSNAP:
+		dir->filetype = "DSNAP";
+		dir->filename_ext = ".dsnap";
+		dir->suffix = INPROGRESS;
+		break;
 	default:
 		unreachable();
 	}
@@ -807,6 +815,12 @@ xlog_materialize(struct xlog *l)
 	return 0;
 }
 
+static struct xlog_zpool *
+xlog_zpool_new(int worker_count, int compression_level);
+
+static void
+xlog_zpool_delete(struct xlog_zpool *pool);
+
 static int
 xlog_init(struct xlog *xlog, const struct xlog_opts *opts)
 {
@@ -823,6 +837,12 @@ xlog_init(struct xlog *xlog, const struct xlog_opts *opts)
 				 "failed to create context");
 			return -1;
 		}
+		if (opts->compress_threads > 1) {
+			xlog->zpool = xlog_zpool_new(opts->compress_threads,
+						     opts->compression_level);
+			if (xlog->zpool == NULL)
+				return -1;
+		}
 	}
 	return 0;
 }
@@ -848,6 +868,10 @@ xlog_free(struct xlog *xlog)
 	obuf_destroy(&xlog->zbuf);
 	ZSTD_freeCCtx(xlog->zctx);
 	xlog->zctx = NULL;
+	if (xlog->zpool != NULL) {
+		xlog_zpool_delete(xlog->zpool);
+		xlog->zpool = NULL;
+	}
 }
 
 int
@@ -1005,7 +1029,7 @@ xdir_touch_xlog(struct xdir *dir, const struct vclock *vclock)
 	int64_t signature = vclock_sum(vclock);
 	const char *filename = xdir_format_filename(dir, signature, NONE);
 
-	if (dir->type != SNAP) {
+	if (dir->type != SNAP && dir->type != DSNAP) {
 		assert(false);
 		diag_set(SystemError, "Can't touch xlog '%s'", filename);
 		return -1;
@@ -1026,10 +1050,6 @@ int
 xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 		 const struct vclock *vclock)
 {
-	int64_t signature = vclock_sum(vclock);
-	assert(signature >= 0);
-	assert(!tt_uuid_is_nil(dir->instance_uuid));
-
 	/*
 	 * For WAL dir: store vclock of the previous xlog file
 	 * to check for gaps on recovery.
@@ -1037,6 +1057,17 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 	const struct vclock *prev_vclock = NULL;
 	if (dir->type == XLOG && !vclockset_empty(&dir->index))
 		prev_vclock = vclockset_last(&dir->index);
+	return xdir_create_xlog_with_prev(dir, xlog, vclock, prev_vclock);
+}
+
+int
+xdir_create_xlog_with_prev(struct xdir *dir, struct xlog *xlog,
+			   const struct vclock *vclock,
+			   const struct vclock *prev_vclock)
+{
+	int64_t signature = vclock_sum(vclock);
+	assert(signature >= 0);
+	assert(!tt_uuid_is_nil(dir->instance_uuid));
 
 	struct xlog_meta meta;
 	xlog_meta_create(&meta, dir->filetype, dir->instance_uuid,
@@ -1091,6 +1122,36 @@ xlog_fallocate(struct xlog *log, size_t len)
 #endif /* HAVE_FALLOCATE */
 }
 
+/**
+ * Encodes the fixheader of a block of @a len bytes with the given
+ * magic and checksum. The fixheader always takes XLOG_FIXHEADER_SIZE
+ * bytes.
+ */
+static void
+xlog_fixheader_encode(char *fixheader, log_magic_t magic, size_t len,
+		      uint32_t crc32c)
+{
+	memcpy(fixheader, &magic, sizeof(log_magic_t));
+	char *data = fixheader + sizeof(log_magic_t);
+	data = mp_encode_uint(data, len);
+	/* Encode crc32 for previous row */
+	data = mp_encode_uint(data, 0);
+	/* Encode crc32 for current row */
+	data = mp_encode_uint(data, crc32c);
+	/*
+	 * Encode a padding, to ensure the resulting
+	 * fixheader always has the same size.
+	 */
+	ssize_t padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
+	if (padding > 0) {
+		data = mp_encode_strl(data, padding - 1);
+		if (padding > 1) {
+			memset(data, 0, padding - 1);
+			data += padding - 1;
+		}
+	}
+}
+
 /**
  * Write a sequence of uncompressed xrow objects.
  *
@@ -1105,14 +1166,6 @@ xlog_tx_write_plain(struct xlog *log)
 	 * now populate it with data.
 	 */
 	char *fixheader = (char *)log->obuf.iov[0].iov_base;
-	memcpy(fixheader, &row_marker, sizeof(log_magic_t));
-	char *data = fixheader + sizeof(log_magic_t);
-
-	data = mp_encode_uint(data,
-			      obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE);
-	/* Encode crc32 for previous row */
-	data = mp_encode_uint(data, 0);
-	/* Encode crc32 for current row */
 	uint32_t crc32c = 0;
 	struct iovec *iov;
 	size_t offset = XLOG_FIXHEADER_SIZE;
@@ -1122,19 +1175,9 @@ xlog_tx_write_plain(struct xlog *log)
 				    iov->iov_len - offset);
 		offset = 0;
 	}
-	data = mp_encode_uint(data, crc32c);
-	/*
-	 * Encode a padding, to ensure the resulting
-	 * fixheader always has the same size.
-	 */
-	ssize_t padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
-	if (padding > 0) {
-		data = mp_encode_strl(data, padding - 1);
-		if (padding > 1) {
-			memset(data, 0, padding - 1);
-			data += padding - 1;
-		}
-	}
+	xlog_fixheader_encode(fixheader, row_marker,
+			      obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE,
+			      crc32c);
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
@@ -1167,8 +1210,7 @@ xlog_tx_write_zstd(struct xlog *log)
 	}
 	uint32_t crc32c = 0;
 	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	ZSTD_compressBegin(log->zctx, log->opts.compression_level);
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -1208,25 +1250,9 @@ xlog_tx_write_zstd(struct xlog *log)
 		offset = 0;
 	}
 
-	memcpy(fixheader, &zrow_marker, sizeof(log_magic_t));
-	char *data;
-	data = fixheader + sizeof(log_magic_t);
-	data = mp_encode_uint(data,
-			      obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE);
-	/* Encode crc32 for previous row */
-	data = mp_encode_uint(data, 0);
-	/* Encode crc32 for current row */
-	data = mp_encode_uint(data, crc32c);
-	/* Encode padding */
-	ssize_t padding;
-	padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
-	if (padding > 0) {
-		data = mp_encode_strl(data, padding - 1);
-		if (padding > 1) {
-			memset(data, 0, padding - 1);
-			data += padding - 1;
-		}
-	}
+	xlog_fixheader_encode(fixheader, zrow_marker,
+			      obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE,
+			      crc32c);
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
@@ -1255,46 +1281,17 @@ xlog_tx_write_zstd(struct xlog *log)
 #define SYNC_ROUND_UP(size)	(SYNC_ROUND_DOWN(size + SYNC_MASK))
 
 /**
- * Writes xlog batch to file
+ * Advances the write position of the xlog after a block of @a written
+ * bytes is written and syncs or throttles the writer if needed.
  */
-static ssize_t
-xlog_tx_write(struct xlog *log)
+static void
+xlog_tx_advance(struct xlog *log, ssize_t written)
 {
-	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
-		return 0;
-	ssize_t written;
-
-	if (!log->opts.no_compression &&
-	    obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
-		written = xlog_tx_write_zstd(log);
-	} else {
-		written = xlog_tx_write_plain(log);
-	}
-	ERROR_INJECT(ERRINJ_WAL_WRITE, {
-		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		written = -1;
-	});
-
-	obuf_reset(&log->obuf);
-	/*
-	 * Simplify recovery after a temporary write failure:
-	 * truncate the file to the best known good write
-	 * position.
-	 */
-	if (written < 0) {
-		if (lseek(log->fd, log->offset, SEEK_SET) < 0 ||
-		    ftruncate(log->fd, log->offset) != 0)
-			panic_syserror("failed to truncate xlog after write error");
-		log->allocated = 0;
-		return -1;
-	}
 	if (log->allocated > (size_t)written)
 		log->allocated -= written;
 	else
 		log->allocated = 0;
 	log->offset += written;
-	log->rows += log->tx_rows;
-	log->tx_rows = 0;
 	if ((log->opts.sync_interval && log->offset >=
 	    (off_t)(log->synced_size + log->opts.sync_interval)) ||
 	    (log->opts.rate_limit && log->offset >=
@@ -1333,7 +1330,432 @@ xlog_tx_write(struct xlog *log)
 		}
 		log->synced_size = log->offset;
 	}
+}
+
+/* {{{ xlog compression threads */
+
+/** A block of rows compressed by a compression thread. */
+struct xlog_zblock {
+	/** Rows of the block, starting with space for the fixheader. */
+	struct obuf obuf;
+	/** Number of rows in the block. */
+	int64_t rows;
+	/** Compressed block with the fixheader, malloc'ed. */
+	char *buf;
+	/** Size of the allocated buffer. */
+	size_t capacity;
+	/** Size of the compressed block with the fixheader. */
+	size_t size;
+	/** Set by the compression thread when it's done with the block. */
+	bool is_done;
+	/** Compression error message or NULL on success. */
+	const char *error;
+};
+
+/** A compression thread. */
+struct xlog_zworker {
+	/** The pool the worker belongs to. */
+	struct xlog_zpool *pool;
+	/** The context of zstd compression. */
+	ZSTD_CCtx *zctx;
+	/** The thread. */
+	pthread_t thread;
+	/** Set if the thread was started. */
+	bool is_started;
+};
+
+/**
+ * Pool of threads compressing the blocks of an xlog. Blocks are
+ * submitted by the writer to a ring buffer, taken by compression
+ * threads in the submission order and written to the file by the
+ * writer in the same order, so the file doesn't differ from the one
+ * compressed by the writer itself.
+ */
+struct xlog_zpool {
+	pthread_mutex_t mutex;
+	/** Signaled when a block is submitted or the pool is stopped. */
+	pthread_cond_t submit_cond;
+	/** Signaled when a block is compressed. */
+	pthread_cond_t done_cond;
+	/** Set to stop the compression threads. */
+	bool is_stopped;
+	/** Number of blocks submitted by the writer. */
+	uint64_t submitted;
+	/** Number of blocks taken by the compression threads. */
+	uint64_t taken;
+	/** Number of blocks written or discarded by the writer. */
+	uint64_t written;
+	/** Ring buffer of blocks. */
+	struct xlog_zblock *blocks;
+	/** Size of the ring buffer. */
+	int block_count;
+	/** Compression threads. */
+	struct xlog_zworker *workers;
+	/** Number of compression threads. */
+	int worker_count;
+	/** Zstd compression level, see xlog_opts::compression_level. */
+	int compression_level;
+};
+
+/** Calculates the max size of a compressed block with the fixheader. */
+static size_t
+xlog_zblock_bound(struct xlog_zblock *block)
+{
+	size_t size = XLOG_FIXHEADER_SIZE;
+	size_t offset = XLOG_FIXHEADER_SIZE;
+	for (struct iovec *iov = block->obuf.iov; iov->iov_len; ++iov) {
+		size += ZSTD_compressBound(iov->iov_len - offset);
+		offset = 0;
+	}
+	return size;
+}
+
+/**
+ * Compresses a block. Runs in a compression thread so it only uses
+ * the block rows and the malloc'ed output buffer, see
+ * xlog_tx_write_zstd().
+ */
+static void
+xlog_zblock_compress(struct xlog_zblock *block, ZSTD_CCtx *zctx, int level)
+{
+	size_t bound = xlog_zblock_bound(block);
+	if (block->capacity < bound) {
+		free(block->buf);
+		block->capacity = 0;
+		block->buf = malloc(bound);
+		if (block->buf == NULL) {
+			block->error = "failed to allocate compression buffer";
+			return;
+		}
+		block->capacity = bound;
+	}
+	char *data = block->buf + XLOG_FIXHEADER_SIZE;
+	char *data_end = block->buf + block->capacity;
+	uint32_t crc32c = 0;
+	ZSTD_compressBegin(zctx, level);
+	size_t offset = XLOG_FIXHEADER_SIZE;
+	for (struct iovec *iov = block->obuf.iov; iov->iov_len; ++iov) {
+		size_t (*fcompress)(ZSTD_CCtx *, void *, size_t,
+				    const void *, size_t);
+		if (iov == block->obuf.iov + block->obuf.pos ||
+		    !(iov + 1)->iov_len) {
+			fcompress = ZSTD_compressEnd;
+		} else {
+			fcompress = ZSTD_compressContinue;
+		}
+		size_t zsize = fcompress(zctx, data, data_end - data,
+					 (char *)iov->iov_base + offset,
+					 iov->iov_len - offset);
+		if (ZSTD_isError(zsize)) {
+			block->error = ZSTD_getErrorName(zsize);
+			return;
+		}
+		crc32c = crc32_calc(crc32c, data, zsize);
+		data += zsize;
+		offset = 0;
+	}
+	xlog_fixheader_encode(block->buf, zrow_marker,
+			      data - block->buf - XLOG_FIXHEADER_SIZE, crc32c);
+	block->size = data - block->buf;
+}
+
+/** Compression thread function. */
+static void *
+xlog_zworker_f(void *arg)
+{
+	struct xlog_zworker *worker = (struct xlog_zworker *)arg;
+	struct xlog_zpool *pool = worker->pool;
+	tt_pthread_mutex_lock(&pool->mutex);
+	while (true) {
+		while (!pool->is_stopped && pool->taken == pool->submitted)
+			tt_pthread_cond_wait(&pool->submit_cond, &pool->mutex);
+		if (pool->is_stopped)
+			break;
+		struct xlog_zblock *block =
+			&pool->blocks[pool->taken++ % pool->block_count];
+		tt_pthread_mutex_unlock(&pool->mutex);
+		xlog_zblock_compress(block, worker->zctx,
+				     pool->compression_level);
+		tt_pthread_mutex_lock(&pool->mutex);
+		block->is_done = true;
+		tt_pthread_cond_signal(&pool->done_cond);
+	}
+	tt_pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+/** Stops the compression threads and frees the pool. */
+static void
+xlog_zpool_delete(struct xlog_zpool *pool)
+{
+	tt_pthread_mutex_lock(&pool->mutex);
+	pool->is_stopped = true;
+	tt_pthread_cond_broadcast(&pool->submit_cond);
+	tt_pthread_mutex_unlock(&pool->mutex);
+	for (int i = 0; i < pool->worker_count; i++) {
+		struct xlog_zworker *worker = &pool->workers[i];
+		if (worker->is_started)
+			tt_pthread_join(worker->thread, NULL);
+		ZSTD_freeCCtx(worker->zctx);
+	}
+	for (int i = 0; i < pool->block_count; i++) {
+		struct xlog_zblock *block = &pool->blocks[i];
+		obuf_destroy(&block->obuf);
+		free(block->buf);
+	}
+	tt_pthread_cond_destroy(&pool->done_cond);
+	tt_pthread_cond_destroy(&pool->submit_cond);
+	tt_pthread_mutex_destroy(&pool->mutex);
+	free(pool->workers);
+	free(pool->blocks);
+	free(pool);
+}
+
+/**
+ * Creates a pool of @a worker_count compression threads compressing
+ * blocks with the given zstd level. Returns NULL and sets diag on
+ * failure.
+ */
+static struct xlog_zpool *
+xlog_zpool_new(int worker_count, int compression_level)
+{
+	assert(worker_count > 1);
+	struct xlog_zpool *pool = (struct xlog_zpool *)xcalloc(1,
+							       sizeof(*pool));
+	tt_pthread_mutex_init(&pool->mutex, NULL);
+	tt_pthread_cond_init(&pool->submit_cond, NULL);
+	tt_pthread_cond_init(&pool->done_cond, NULL);
+	/*
+	 * Two blocks per thread let the writer fill a block while
+	 * all threads are busy compressing.
+	 */
+	pool->block_count = 2 * worker_count;
+	pool->blocks = (struct xlog_zblock *)xcalloc(pool->block_count,
+						     sizeof(*pool->blocks));
+	for (int i = 0; i < pool->block_count; i++) {
+		obuf_create(&pool->blocks[i].obuf, &cord()->slabc,
+			    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+	}
+	pool->worker_count = worker_count;
+	pool->compression_level = compression_level;
+	pool->workers = (struct xlog_zworker *)xcalloc(worker_count,
+						       sizeof(*pool->workers));
+	for (int i = 0; i < worker_count; i++) {
+		struct xlog_zworker *worker = &pool->workers[i];
+		worker->pool = pool;
+		worker->zctx = ZSTD_createCCtx();
+		if (worker->zctx == NULL) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 "failed to create context");
+			goto fail;
+		}
+		if (tt_pthread_create(&worker->thread, NULL,
+				      xlog_zworker_f, worker) != 0) {
+			diag_set(SystemError, "failed to create thread");
+			goto fail;
+		}
+		worker->is_started = true;
+	}
+	return pool;
+fail:
+	xlog_zpool_delete(pool);
+	return NULL;
+}
+
+/** Returns the oldest block that hasn't been written yet. */
+static struct xlog_zblock *
+xlog_zpool_first(struct xlog_zpool *pool)
+{
+	assert(pool->written < pool->submitted);
+	return &pool->blocks[pool->written % pool->block_count];
+}
+
+/** Checks if the oldest submitted block is compressed. */
+static bool
+xlog_zpool_first_is_done(struct xlog_zpool *pool)
+{
+	if (pool->written == pool->submitted)
+		return false;
+	tt_pthread_mutex_lock(&pool->mutex);
+	bool is_done = xlog_zpool_first(pool)->is_done;
+	tt_pthread_mutex_unlock(&pool->mutex);
+	return is_done;
+}
+
+/** Waits until the oldest submitted block is compressed. */
+static struct xlog_zblock *
+xlog_zpool_wait_first(struct xlog_zpool *pool)
+{
+	struct xlog_zblock *block = xlog_zpool_first(pool);
+	tt_pthread_mutex_lock(&pool->mutex);
+	while (!block->is_done)
+		tt_pthread_cond_wait(&pool->done_cond, &pool->mutex);
+	tt_pthread_mutex_unlock(&pool->mutex);
+	return block;
+}
+
+/** Releases the oldest submitted block after it's compressed. */
+static void
+xlog_zpool_release_first(struct xlog_zpool *pool)
+{
+	struct xlog_zblock *block = xlog_zpool_first(pool);
+	assert(block->is_done);
+	obuf_reset(&block->obuf);
+	block->is_done = false;
+	block->error = NULL;
+	block->size = 0;
+	block->rows = 0;
+	pool->written++;
+}
+
+/**
+ * Discards all submitted blocks after a write error, so that the next
+ * write starts at the last known good position.
+ */
+static void
+xlog_zpool_discard(struct xlog *log)
+{
+	struct xlog_zpool *pool = log->zpool;
+	while (pool->written < pool->submitted) {
+		log->rows -= xlog_zpool_wait_first(pool)->rows;
+		xlog_zpool_release_first(pool);
+	}
+}
+
+/**
+ * Writes the oldest submitted block to the file, waiting for it to be
+ * compressed. On failure, discards all submitted blocks.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_zpool_write_first(struct xlog *log)
+{
+	struct xlog_zpool *pool = log->zpool;
+	struct xlog_zblock *block = xlog_zpool_wait_first(pool);
+	if (block->error != NULL) {
+		diag_set(ClientError, ER_COMPRESSION, block->error);
+		goto error;
+	}
+	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		goto error;
+	});
+	if (fio_writen(log->fd, block->buf, block->size) < 0) {
+		diag_set(SystemError, "failed to write to '%s' file",
+			 log->filename);
+		goto error;
+	}
+	ssize_t written = block->size;
+	xlog_zpool_release_first(pool);
+	xlog_tx_advance(log, written);
 	return written;
+error:
+	xlog_zpool_discard(log);
+	xlog_truncate(log, log->offset);
+	return -1;
+}
+
+/**
+ * Writes all submitted blocks to the file.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_zpool_flush(struct xlog *log)
+{
+	struct xlog_zpool *pool = log->zpool;
+	ssize_t total = 0;
+	while (pool->written < pool->submitted) {
+		ssize_t written = xlog_zpool_write_first(log);
+		if (written < 0)
+			return -1;
+		total += written;
+	}
+	return total;
+}
+
+/**
+ * Submits the buffered rows for compression. Compressed blocks are
+ * written to the file as slots of the ring buffer are needed.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_zpool_submit(struct xlog *log)
+{
+	struct xlog_zpool *pool = log->zpool;
+	ssize_t total = 0;
+	while (pool->submitted - pool->written ==
+	       (uint64_t)pool->block_count ||
+	       xlog_zpool_first_is_done(pool)) {
+		ssize_t written = xlog_zpool_write_first(log);
+		if (written < 0) {
+			obuf_reset(&log->obuf);
+			return -1;
+		}
+		total += written;
+	}
+	struct xlog_zblock *block =
+		&pool->blocks[pool->submitted % pool->block_count];
+	assert(obuf_size(&block->obuf) == 0);
+	SWAP(log->obuf, block->obuf);
+	block->rows = log->tx_rows;
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+	tt_pthread_mutex_lock(&pool->mutex);
+	pool->submitted++;
+	tt_pthread_cond_signal(&pool->submit_cond);
+	tt_pthread_mutex_unlock(&pool->mutex);
+	return total;
+}
+
+/* }}} */
+
+/**
+ * Writes xlog batch to file
+ */
+static ssize_t
+xlog_tx_write(struct xlog *log)
+{
+	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
+		return 0;
+	ssize_t written;
+	ssize_t flushed = 0;
+
+	if (!log->opts.no_compression &&
+	    obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
+		if (log->zpool != NULL)
+			return xlog_zpool_submit(log);
+		written = xlog_tx_write_zstd(log);
+	} else {
+		/* Blocks submitted before must be written first. */
+		if (log->zpool != NULL)
+			flushed = xlog_zpool_flush(log);
+		written = flushed < 0 ? -1 : xlog_tx_write_plain(log);
+	}
+	ERROR_INJECT(ERRINJ_WAL_WRITE, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		written = -1;
+	});
+
+	obuf_reset(&log->obuf);
+	/*
+	 * Simplify recovery after a temporary write failure:
+	 * truncate the file to the best known good write
+	 * position.
+	 */
+	if (written < 0) {
+		xlog_truncate(log, log->offset);
+		return -1;
+	}
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+	xlog_tx_advance(log, written);
+	return flushed + written;
 }
 
 /*
@@ -1360,35 +1782,32 @@ xlog_write_row(struct xlog *log, const struct xrow_header *packet)
 
 	struct obuf_svp svp = obuf_create_svp(&log->obuf);
 	size_t page_offset = obuf_size(&log->obuf);
-	/** encode row into iovec */
-	struct iovec iov[XROW_IOVMAX];
-	/** don't write sync to the disk */
-	size_t region_svp = region_used(&fiber()->gc);
-	int iovcnt;
-	xrow_header_encode(packet, /*sync=*/0, /*fixheader_len=*/0,
-			   iov, &iovcnt);
-	for (int i = 0; i < iovcnt; ++i) {
-		struct errinj *inj = errinj(ERRINJ_WAL_WRITE_PARTIAL,
-					    ERRINJ_INT);
-		if (inj != NULL && inj->iparam >= 0 &&
-		    obuf_size(&log->obuf) > (size_t)inj->iparam) {
-			diag_set(ClientError, ER_INJECTION,
-				 "xlog write injection");
-			obuf_rollback_to_svp(&log->obuf, &svp);
-			region_truncate(&fiber()->gc, region_svp);
-			return -1;
-		};
-		if (obuf_dup(&log->obuf, iov[i].iov_base, iov[i].iov_len) <
-		    iov[i].iov_len) {
-			diag_set(OutOfMemory, XLOG_FIXHEADER_SIZE,
-				  "runtime arena", "xlog tx output buffer");
-			obuf_rollback_to_svp(&log->obuf, &svp);
-			region_truncate(&fiber()->gc, region_svp);
-			return -1;
-		}
-	}
-	region_truncate(&fiber()->gc, region_svp);
-	assert(iovcnt <= XROW_IOVMAX);
+	struct errinj *inj = errinj(ERRINJ_WAL_WRITE_PARTIAL, ERRINJ_INT);
+#define XLOG_INJECT_PARTIAL_WRITE()					\
+	(inj != NULL && inj->iparam >= 0 &&				\
+	 obuf_size(&log->obuf) > (size_t)inj->iparam)
+	if (XLOG_INJECT_PARTIAL_WRITE())
+		goto error_injection;
+	/*
+	 * Encode the row header right into the output buffer to
+	 * avoid an extra copy: this is on the hot path of the WAL
+	 * thread. Don't write sync to the disk.
+	 */
+	char *header = (char *)obuf_reserve(&log->obuf, XROW_HEADER_LEN_MAX);
+	if (header == NULL)
+		goto error_oom;
+	char *header_end = xrow_header_encode_buf(packet, /*sync=*/0, header);
+	obuf_alloc(&log->obuf, header_end - header);
+	for (int i = 0; i < packet->bodycnt; ++i) {
+		const struct iovec *iov = &packet->body[i];
+		if (XLOG_INJECT_PARTIAL_WRITE())
+			goto error_injection;
+		if (obuf_dup(&log->obuf, iov->iov_base, iov->iov_len) <
+		    iov->iov_len)
+			goto error_oom;
+	}
+#undef XLOG_INJECT_PARTIAL_WRITE
+	assert(1 + packet->bodycnt <= XROW_IOVMAX);
 	log->tx_rows++;
 
 	size_t row_size = obuf_size(&log->obuf) - page_offset;
@@ -1398,6 +1817,15 @@ xlog_write_row(struct xlog *log, const struct xrow_header *packet)
 		return -1;
 
 	return row_size;
+error_injection:
+	diag_set(ClientError, ER_INJECTION, "xlog write injection");
+	obuf_rollback_to_svp(&log->obuf, &svp);
+	return -1;
+error_oom:
+	diag_set(OutOfMemory, XROW_HEADER_LEN_MAX,
+		 "runtime arena", "xlog tx output buffer");
+	obuf_rollback_to_svp(&log->obuf, &svp);
+	return -1;
 }
 
 /**
@@ -1448,9 +1876,37 @@ ssize_t
 xlog_flush(struct xlog *log)
 {
 	assert(log->is_autocommit);
-	if (log->obuf.used == 0)
-		return 0;
-	return xlog_tx_write(log);
+	ssize_t written = log->obuf.used == 0 ? 0 : xlog_tx_write(log);
+	if (written < 0 || log->zpool == NULL)
+		return written;
+	ssize_t flushed = xlog_zpool_flush(log);
+	return flushed < 0 ? -1 : written + flushed;
+}
+
+int
+xlog_datasync(struct xlog *log)
+{
+	if (fdatasync(log->fd) < 0) {
+		diag_set(SystemError, "failed to sync file '%s'",
+			 log->filename);
+		return -1;
+	}
+	log->synced_size = log->offset;
+	log->sync_time = ev_monotonic_time();
+	return 0;
+}
+
+void
+xlog_truncate(struct xlog *log, off_t offset)
+{
+	assert(offset <= log->offset);
+	if (lseek(log->fd, offset, SEEK_SET) < 0 ||
+	    ftruncate(log->fd, offset) != 0)
+		panic_syserror("failed to truncate xlog after write error");
+	log->allocated = 0;
+	log->offset = offset;
+	if (log->synced_size > (uint64_t)offset)
+		log->synced_size = offset;
 }
 
 static int
@@ -1632,6 +2088,19 @@ xlog_cursor_ensure(struct xlog_cursor *cursor, size_t count)
 		cursor->read_ahead = XLOG_READ_AHEAD_MIN;
 	}
 	cursor->read_offset += readen;
+#ifdef HAVE_POSIX_FADVISE
+	/*
+	 * If the file is being read sequentially, ask the kernel to
+	 * start reading the next chunk in the background so that
+	 * disk reads overlap with decoding of the data read so far.
+	 * This speeds up recovery from snapshot and xlog files not
+	 * present in the page cache. This is merely a hint, so
+	 * errors are ignored.
+	 */
+	if ((size_t)readen == to_load)
+		(void)posix_fadvise(cursor->fd, cursor->read_offset,
+				    cursor->read_ahead, POSIX_FADV_WILLNEED);
+#endif /* HAVE_POSIX_FADVISE */
 	return ibuf_used(&cursor->rbuf) >= count ? 0: 1;
 }
 
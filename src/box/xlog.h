@@ -44,6 +44,7 @@
 
 struct iovec;
 struct xrow_header;
+struct xlog_zpool;
 
 #if defined(__cplusplus)
 extern "C" {
@@ -82,6 +83,27 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * Number of threads compressing the written blocks. If it's
+	 * greater than 1, blocks are compressed in background threads
+	 * and written to the file in order once compressed, so the
+	 * file offset lags behind the written rows until the xlog is
+	 * flushed.
+	 *
+	 * This option is useful for memtx snapshots, which are written
+	 * by a single thread at once and are too big for compression
+	 * to keep up with reading the database.
+	 */
+	int compress_threads;
+	/** Zstd compression level of the written blocks. */
+	int compression_level;
+};
+
+enum {
+	/** Max value of xlog_opts::compress_threads. */
+	XLOG_COMPRESS_THREADS_MAX = 64,
+	/** Default value of xlog_opts::compression_level. */
+	XLOG_COMPRESSION_LEVEL_DEFAULT = 3,
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -97,6 +119,7 @@ enum xdir_type {
 	SNAP,		/* memtx snapshot */
 	XLOG,		/* write ahead log */
 	VYLOG,		/* vinyl metadata log */
+	DSNAP,		/* memtx delta snapshot */
 };
 
 /**
@@ -449,6 +472,11 @@ struct xlog {
 	uint64_t synced_size;
 	/** Time when xlog wast synced last time */
 	double sync_time;
+	/**
+	 * Pool of compression threads or NULL if blocks are
+	 * compressed by the writer, see xlog_opts::compress_threads.
+	 */
+	struct xlog_zpool *zpool;
 };
 
 /**
@@ -482,6 +510,17 @@ int
 xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 		 const struct vclock *vclock);
 
+/**
+ * Create a new file like xdir_create_xlog(), but store the given
+ * vclock of the previous file in the file header instead of the
+ * vclock of the last file in the directory. Used for memtx delta
+ * snapshots, which are based on the previous checkpoint.
+ */
+int
+xdir_create_xlog_with_prev(struct xdir *dir, struct xlog *xlog,
+			   const struct vclock *vclock,
+			   const struct vclock *prev_vclock);
+
 /**
  * Create new xlog writer based on fd.
  * @param fd            file descriptor
@@ -577,6 +616,24 @@ xlog_tx_rollback(struct xlog *log);
 ssize_t
 xlog_flush(struct xlog *log);
 
+/**
+ * Sync data written to the xlog file to disk with fdatasync().
+ *
+ * Returns 0 on success. On failure, sets diag and returns -1.
+ */
+int
+xlog_datasync(struct xlog *log);
+
+/**
+ * Discard everything written to the xlog file after the given
+ * offset, which must not exceed the current write offset.
+ *
+ * Panics on failure, because we can't proceed writing to a file
+ * with junk at the end.
+ */
+void
+xlog_truncate(struct xlog *log, off_t offset);
+
 /**
  * Closes an xlog object.
  *
@@ -282,15 +282,10 @@ xrow_decode_node_name(const char **pos, char *out)
 	return 0;
 }
 
-void
-xrow_header_encode(const struct xrow_header *header, uint64_t sync,
-		   size_t fixheader_len, struct iovec *out, int *iovcnt)
+char *
+xrow_header_encode_buf(const struct xrow_header *header, uint64_t sync,
+		       char *data)
 {
-	/* allocate memory for sign + header */
-	out->iov_base = xregion_alloc(&fiber()->gc, XROW_HEADER_LEN_MAX +
-				      fixheader_len);
-	char *data = (char *) out->iov_base + fixheader_len;
-
 	/* Header */
 	char *d = data + 1; /* Skip 1 byte for MP_MAP */
 	int map_size = 0;
@@ -400,6 +395,18 @@ xrow_header_encode(const struct xrow_header *header, uint64_t sync,
 	ERROR_INJECT(ERRINJ_XLOG_WRITE_CORRUPTED_HEADER, {
 		*data = 0xc1;
 	});
+	return d;
+}
+
+void
+xrow_header_encode(const struct xrow_header *header, uint64_t sync,
+		   size_t fixheader_len, struct iovec *out, int *iovcnt)
+{
+	/* allocate memory for sign + header */
+	out->iov_base = xregion_alloc(&fiber()->gc, XROW_HEADER_LEN_MAX +
+				      fixheader_len);
+	char *data = (char *) out->iov_base + fixheader_len;
+	char *d = xrow_header_encode_buf(header, sync, data);
 	out->iov_len = d - (char *) out->iov_base;
 	out++;
 
@@ -741,6 +748,23 @@ iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
+void
+iproto_reply_select_detached(struct obuf *buf, struct obuf_svp *svp,
+			     uint64_t sync, uint64_t schema_version,
+			     uint32_t count, size_t data_size)
+{
+	assert(obuf_size(buf) - svp->used == IPROTO_SELECT_HEADER_LEN);
+	char *pos = (char *)obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
+			     IPROTO_SELECT_HEADER_LEN - IPROTO_HEADER_LEN +
+			     data_size);
+
+	struct iproto_body_bin body = iproto_body_bin;
+	body.v_data_len = mp_bswap_u32(count);
+
+	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+}
+
 /** Reply select with IPROTO_DATA and IPROTO_POSITION. */
 void
 iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
@@ -769,6 +793,58 @@ iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
+/** Reply select with IPROTO_DATA and IPROTO_CURSOR_ID. */
+void
+iproto_reply_select_with_cursor(struct obuf *buf, struct obuf_svp *svp,
+				uint64_t sync, uint32_t schema_version,
+				uint32_t count, uint64_t cursor_id,
+				bool box_tuple_as_ext)
+{
+	size_t alloc_size = mp_sizeof_uint(IPROTO_CURSOR_ID) +
+			    mp_sizeof_uint(cursor_id);
+	char *ptr = xobuf_alloc(buf, alloc_size);
+	ptr = mp_encode_uint(ptr, IPROTO_CURSOR_ID);
+	mp_encode_uint(ptr, cursor_id);
+
+	char *pos = (char *)obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
+			     obuf_size(buf) - svp->used -
+			     IPROTO_HEADER_LEN);
+
+	struct iproto_body_bin body = iproto_body_bin_with_position;
+	body.m_body += box_tuple_as_ext;
+	body.v_data_len = mp_bswap_u32(count);
+
+	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+}
+
+/** Reply select with IPROTO_DATA and IPROTO_VCLOCK. */
+void
+iproto_reply_select_with_vclock(struct obuf *buf, struct obuf_svp *svp,
+				uint64_t sync, uint32_t schema_version,
+				uint32_t count, uint32_t replica_id,
+				int64_t lsn, bool box_tuple_as_ext)
+{
+	size_t alloc_size = mp_sizeof_uint(IPROTO_VCLOCK) + mp_sizeof_map(1) +
+			    mp_sizeof_uint(replica_id) + mp_sizeof_uint(lsn);
+	char *ptr = xobuf_alloc(buf, alloc_size);
+	ptr = mp_encode_uint(ptr, IPROTO_VCLOCK);
+	ptr = mp_encode_map(ptr, 1);
+	ptr = mp_encode_uint(ptr, replica_id);
+	mp_encode_uint(ptr, lsn);
+
+	char *pos = (char *)obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
+			     obuf_size(buf) - svp->used -
+			     IPROTO_HEADER_LEN);
+
+	struct iproto_body_bin body = iproto_body_bin_with_position;
+	body.m_body += box_tuple_as_ext;
+	body.v_data_len = mp_bswap_u32(count);
+
+	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+}
+
 int
 xrow_decode_sql(const struct xrow_header *row, struct sql_request *request)
 {
@@ -831,6 +907,17 @@ iproto_reply_sql(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 			     obuf_size(buf) - svp->used - IPROTO_HEADER_LEN);
 }
 
+void
+iproto_reply_sql_detached(struct obuf *buf, struct obuf_svp *svp,
+			  uint64_t sync, uint64_t schema_version,
+			  size_t data_size)
+{
+	char *pos = (char *)obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
+			     obuf_size(buf) - svp->used - IPROTO_HEADER_LEN +
+			     data_size);
+}
+
 void
 iproto_reply_chunk(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		   uint64_t schema_version)
@@ -946,6 +1033,13 @@ xrow_decode_dml_internal(struct xrow_header *row, struct request *request,
 		case IPROTO_FETCH_POSITION:
 			request->fetch_position = mp_decode_bool(&value);
 			break;
+		case IPROTO_CURSOR_ID:
+			request->cursor_id = mp_decode_uint(&value);
+			request->has_cursor_id = true;
+			break;
+		case IPROTO_WAIT_VCLOCK:
+			request->wait_vclock = value;
+			break;
 		case IPROTO_TUPLE:
 			request->tuple = value;
 			request->tuple_end = data;
@@ -1045,6 +1139,10 @@ request_snprint(char *buf, int size, const struct request *request)
 		SNPRINT(total, snprintf, buf, size, ", after_tuple: ");
 		SNPRINT(total, mp_snprint, buf, size, request->after_tuple);
 	}
+	if (request->has_cursor_id) {
+		SNPRINT(total, snprintf, buf, size, ", cursor_id: %llu",
+			(unsigned long long)request->cursor_id);
+	}
 	SNPRINT(total, snprintf, buf, size, "}");
 	return total;
 }
@@ -1069,6 +1167,8 @@ xrow_encode_dml(const struct request *request, struct region *region,
 	assert(request->after_position == NULL);
 	assert(request->after_tuple == NULL);
 	assert(!request->fetch_position);
+	assert(!request->has_cursor_id);
+	assert(request->wait_vclock == NULL);
 	const int MAP_LEN_MAX = 40;
 	uint32_t key_len = request->key_end - request->key;
 	uint32_t ops_len = request->ops_end - request->ops;
@@ -1533,6 +1633,14 @@ xrow_decode_call(const struct xrow_header *row, struct call_request *request)
 				goto error;
 			request->name = value;
 			break;
+		case IPROTO_FUNCTION_ID:
+			if (mp_typeof(*value) != MP_UINT)
+				goto error;
+			uint64_t func_id = mp_decode_uint(&value);
+			if (func_id > UINT32_MAX)
+				goto error;
+			request->func_id = func_id;
+			break;
 		case IPROTO_EXPR:
 			if (mp_typeof(*value) != MP_STR)
 				goto error;
@@ -1549,6 +1657,12 @@ xrow_decode_call(const struct xrow_header *row, struct call_request *request)
 				goto error;
 			request->tuple_formats = value;
 			request->tuple_formats_end = data;
+			break;
+		case IPROTO_WAIT_VCLOCK:
+			if (mp_typeof(*value) != MP_MAP)
+				goto error;
+			request->wait_vclock = value;
+			break;
 		default:
 			continue; /* unknown key */
 		}
@@ -1559,7 +1673,7 @@ xrow_decode_call(const struct xrow_header *row, struct call_request *request)
 					   iproto_key_name(IPROTO_EXPR));
 			return -1;
 		}
-	} else if (request->name == NULL) {
+	} else if (request->name == NULL && request->func_id == 0) {
 		assert(row->type == IPROTO_CALL_16 ||
 		       row->type == IPROTO_CALL);
 		xrow_on_decode_err(row, ER_MISSING_REQUEST_FIELD,
@@ -2065,6 +2179,8 @@ struct replication_request {
 	uint32_t *version_id;
 	/** IPROTO_REPLICA_ANON. */
 	bool *is_anon;
+	/** IPROTO_COMPRESSION_LEVEL. */
+	uint32_t *compression_level;
 };
 
 /** Encode a replication request template. */
@@ -2128,6 +2244,11 @@ xrow_encode_replication_request(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (req->compression_level != NULL && *req->compression_level != 0) {
+		++map_size;
+		data = mp_encode_uint(data, IPROTO_COMPRESSION_LEVEL);
+		data = mp_encode_uint(data, *req->compression_level);
+	}
 	assert(data <= buf + size);
 	assert(map_size <= 15);
 	char *map_header_end = mp_encode_map(buf, map_size);
@@ -2248,6 +2369,16 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 				*req->id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_COMPRESSION_LEVEL:
+			if (req->compression_level == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid COMPRESSION_LEVEL");
+				return -1;
+			}
+			*req->compression_level = mp_decode_uint(&d);
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -2295,6 +2426,7 @@ xrow_encode_subscribe(struct xrow_header *row,
 		.is_anon = &cast->is_anon,
 		.id_filter = &cast->id_filter,
 		.version_id = &cast->version_id,
+		.compression_level = &cast->compression_level,
 	};
 	xrow_encode_replication_request(row, &base_req, IPROTO_SUBSCRIBE);
 }
@@ -2313,6 +2445,7 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		.version_id = &req->version_id,
 		.is_anon = &req->is_anon,
 		.id_filter = &req->id_filter,
+		.compression_level = &req->compression_level,
 	};
 	return xrow_decode_replication_request(row, &base_req);
 }
@@ -2551,6 +2684,31 @@ xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
 	return xrow_decode_replication_request(row, &base_req);
 }
 
+int
+xrow_decode_wait_vclock(const char *data, struct vclock *vclock)
+{
+	vclock_create(vclock);
+	assert(mp_typeof(*data) == MP_MAP);
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t id = mp_decode_uint(&data);
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t lsn = mp_decode_uint(&data);
+		if (id >= VCLOCK_MAX || lsn > INT64_MAX)
+			goto error;
+		if (id != 0 && (int64_t)lsn > vclock_get(vclock, id))
+			vclock_follow(vclock, id, lsn);
+	}
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_MSGPACK,
+		 iproto_key_name(IPROTO_WAIT_VCLOCK));
+	return -1;
+}
+
 void
 xrow_encode_subscribe_response(struct xrow_header *row,
 			       const struct subscribe_response *rsp)
@@ -141,6 +141,20 @@ xrow_approx_len(const struct xrow_header *row)
 	return len;
 }
 
+/**
+ * Encode xrow header (without body) into the given buffer, which
+ * must have at least XROW_HEADER_LEN_MAX bytes available.
+ *
+ * @param header xrow
+ * @param sync request sync number
+ * @param data buffer to encode the header to
+ *
+ * @return a pointer to the end of the encoded header
+ */
+char *
+xrow_header_encode_buf(const struct xrow_header *header, uint64_t sync,
+		       char *data);
+
 /**
  * Encode xrow into a binary packet
  *
@@ -225,6 +239,12 @@ struct request {
 	int index_base;
 	/** Send position of last selected tuple in response if true. */
 	bool fetch_position;
+	/** Id of the server-side cursor, see IPROTO_CURSOR_ID. */
+	uint64_t cursor_id;
+	/** True if the request has IPROTO_CURSOR_ID. */
+	bool has_cursor_id;
+	/** Vclock to wait for, see IPROTO_WAIT_VCLOCK. MessagePack Map. */
+	const char *wait_vclock;
 	/** Name of requested space, points to the request's input buffer. */
 	const char *space_name;
 	/** Length of @space_name. */
@@ -413,6 +433,11 @@ xrow_decode_raft(const struct xrow_header *row, struct raft_request *r,
 struct call_request {
 	/** Function name for CALL request. MessagePack String. */
 	const char *name;
+	/**
+	 * Function id for CALL request. Used if the function name
+	 * isn't set.
+	 */
+	uint32_t func_id;
 	/** Expression for EVAL request. MessagePack String. */
 	const char *expr;
 	/** CALL/EVAL parameters. MessagePack Array. */
@@ -422,6 +447,8 @@ struct call_request {
 	const char *tuple_formats;
 	/** End of tuple formats of CALL/EVAL parameters. */
 	const char *tuple_formats_end;
+	/** Vclock to wait for, see IPROTO_WAIT_VCLOCK. MessagePack Map. */
+	const char *wait_vclock;
 };
 
 /**
@@ -617,6 +644,11 @@ struct subscribe_request {
 	uint32_t version_id;
 	/** Flag whether the replica is anon. */
 	bool is_anon;
+	/**
+	 * zstd level to compress the replication stream with,
+	 * 0 if the stream isn't compressed.
+	 */
+	uint32_t compression_level;
 };
 
 /** Encode SUBSCRIBE request. */
@@ -735,6 +767,16 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 int
 xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock);
 
+/**
+ * Decode IPROTO_WAIT_VCLOCK of a request.
+ * @param data MessagePack map of replica id to LSN.
+ * @param[out] vclock Decoded vclock. Component 0 is ignored.
+ * @retval  0 Success.
+ * @retval -1 Error, diag is set.
+ */
+int
+xrow_decode_wait_vclock(const char *data, struct vclock *vclock);
+
 /**
  * Encode any bodyless message.
  * @param row[out] Row to encode into.
@@ -807,6 +849,17 @@ iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint64_t schema_version, uint32_t count,
 		    bool box_tuple_as_ext);
 
+/**
+ * Write select header to a preallocated buffer for a result set that
+ * isn't stored in the buffer, but is sent separately right after it.
+ * @param count Number of tuples in the result set.
+ * @param data_size Total size of the tuples, in bytes.
+ */
+void
+iproto_reply_select_detached(struct obuf *buf, struct obuf_svp *svp,
+			     uint64_t sync, uint64_t schema_version,
+			     uint32_t count, size_t data_size);
+
 /**
  * Write extended select header to a preallocated buffer.
  */
@@ -817,6 +870,26 @@ iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
 				  const char *packed_pos_end,
 				  bool box_tuple_as_ext);
 
+/**
+ * Write select header with a cursor id to a preallocated buffer.
+ */
+void
+iproto_reply_select_with_cursor(struct obuf *buf, struct obuf_svp *svp,
+				uint64_t sync, uint32_t schema_version,
+				uint32_t count, uint64_t cursor_id,
+				bool box_tuple_as_ext);
+
+/**
+ * Write select header with a vclock token to a preallocated buffer.
+ * The token is IPROTO_VCLOCK that has the only component @a replica_id
+ * equal to @a lsn.
+ */
+void
+iproto_reply_select_with_vclock(struct obuf *buf, struct obuf_svp *svp,
+				uint64_t sync, uint32_t schema_version,
+				uint32_t count, uint32_t replica_id,
+				int64_t lsn, bool box_tuple_as_ext);
+
 /**
  * Encode iproto header with IPROTO_OK response code.
  * @param out Encode to.
@@ -900,6 +973,20 @@ void
 iproto_reply_sql(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		 uint64_t schema_version);
 
+/**
+ * Write the SQL header for a response which rows aren't stored in
+ * the buffer, but are sent separately right after it.
+ * @param buf Out buffer.
+ * @param svp Savepoint of the header beginning.
+ * @param sync Request sync.
+ * @param schema_version Schema version.
+ * @param data_size Total size of the rows, in bytes.
+ */
+void
+iproto_reply_sql_detached(struct obuf *buf, struct obuf_svp *svp,
+			  uint64_t sync, uint64_t schema_version,
+			  size_t data_size);
+
 /**
  * Write an IPROTO_CHUNK header from a specified position in a
  * buffer.
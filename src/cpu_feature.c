@@ -103,6 +103,118 @@ crc32c_hw(uint32_t crc, const char *buf, unsigned int len)
 	return crc32c_hw_byte(crc, (const char *)ptmp, iremainder);
 }
 
+#if defined (__x86_64__)
+
+enum {
+	/**
+	 * Sizes of the blocks checksummed in parallel by the three
+	 * streams of crc32c_hw_multi(). The short block is used for
+	 * the remainder of the buffer not fitting into long blocks.
+	 */
+	CRC32C_LONG_BLOCK = 2048,
+	CRC32C_SHORT_BLOCK = 256,
+};
+
+/*
+ * Constants to shift a CRC by a block of zero bytes with
+ * crc32c_hw_shift(): x^(8 * n - 33) mod P in the bit-reflected
+ * form, where n is the number of bytes and P is the CRC32C
+ * polynomial.
+ */
+#define CRC32C_LONG_SHIFT_1	0xa51b6135 /* n = CRC32C_LONG_BLOCK */
+#define CRC32C_LONG_SHIFT_2	0x82f89c77 /* n = 2 * CRC32C_LONG_BLOCK */
+#define CRC32C_SHORT_SHIFT_1	0xb9e02b86 /* n = CRC32C_SHORT_BLOCK */
+#define CRC32C_SHORT_SHIFT_2	0xdd7e3b0c /* n = 2 * CRC32C_SHORT_BLOCK */
+
+static inline uint64_t
+crc32c_hw_u64(uint64_t crc, uint64_t data)
+{
+	__asm__("crc32q %1, %0" : "+r"(crc) : "rm"(data));
+	return crc;
+}
+
+/** Carry-less multiplication of two 64-bit values, low half. */
+static inline uint64_t
+clmul_u64(uint64_t a, uint64_t b)
+{
+	uint64_t res;
+	__asm__("movq %1, %%xmm0\n\t"
+		"movq %2, %%xmm1\n\t"
+		"pclmulqdq $0x00, %%xmm1, %%xmm0\n\t"
+		"movq %%xmm0, %0"
+		: "=r"(res) : "r"(a), "r"(b) : "xmm0", "xmm1");
+	return res;
+}
+
+/**
+ * Returns the CRC of the data the given CRC was computed for
+ * followed by n zero bytes, where k is the constant for n.
+ * The product of the CRC and k is reduced modulo P with the
+ * crc32 instruction, which multiplies its argument by x^32.
+ */
+static inline uint32_t
+crc32c_hw_shift(uint32_t crc, uint64_t k)
+{
+	return crc32c_hw_u64(0, clmul_u64(crc, k));
+}
+
+/**
+ * Calculates CRC32 of three adjacent blocks of the given size
+ * as independent streams of crc32 instructions and combines the
+ * results. The crc32 instruction has a latency of three cycles
+ * but a throughput of one per cycle, so the streams don't stall
+ * each other. The buffer must be aligned by 8 bytes.
+ */
+static uint32_t
+crc32c_hw_3way(uint32_t crc, const char *buf, unsigned int block,
+	       uint64_t k1, uint64_t k2)
+{
+	const uint64_t *p0 = (const uint64_t *)buf;
+	const uint64_t *p1 = (const uint64_t *)(buf + block);
+	const uint64_t *p2 = (const uint64_t *)(buf + 2 * block);
+	uint64_t crc0 = crc, crc1 = 0, crc2 = 0;
+	for (unsigned int i = 0; i < block / sizeof(uint64_t); i++) {
+		crc0 = crc32c_hw_u64(crc0, p0[i]);
+		crc1 = crc32c_hw_u64(crc1, p1[i]);
+		crc2 = crc32c_hw_u64(crc2, p2[i]);
+	}
+	/*
+	 * CRC without pre- and post-inversion is linear, so the CRC
+	 * of the whole is the XOR of the stream CRCs shifted by the
+	 * length of the data following them.
+	 */
+	return crc32c_hw_shift(crc0, k2) ^ crc32c_hw_shift(crc1, k1) ^ crc2;
+}
+
+uint32_t
+crc32c_hw_multi(uint32_t crc, const char *buf, unsigned int len)
+{
+	if (len < 3 * CRC32C_SHORT_BLOCK)
+		return crc32c_hw(crc, buf, len);
+	const unsigned int align = alignof(uint64_t);
+	unsigned int not_aligned_prefix =
+		(align - (unsigned long)buf % align) % align;
+	crc = crc32c_hw_byte(crc, buf, not_aligned_prefix);
+	buf += not_aligned_prefix;
+	len -= not_aligned_prefix;
+	while (len >= 3 * CRC32C_LONG_BLOCK) {
+		crc = crc32c_hw_3way(crc, buf, CRC32C_LONG_BLOCK,
+				     CRC32C_LONG_SHIFT_1, CRC32C_LONG_SHIFT_2);
+		buf += 3 * CRC32C_LONG_BLOCK;
+		len -= 3 * CRC32C_LONG_BLOCK;
+	}
+	while (len >= 3 * CRC32C_SHORT_BLOCK) {
+		crc = crc32c_hw_3way(crc, buf, CRC32C_SHORT_BLOCK,
+				     CRC32C_SHORT_SHIFT_1,
+				     CRC32C_SHORT_SHIFT_2);
+		buf += 3 * CRC32C_SHORT_BLOCK;
+		len -= 3 * CRC32C_SHORT_BLOCK;
+	}
+	return crc32c_hw(crc, buf, len);
+}
+
+#endif /* defined (__x86_64__) */
+
 bool
 sse42_enabled_cpu()
 {
@@ -114,6 +226,17 @@ sse42_enabled_cpu()
 	return (cx & (1 << 20)) != 0;
 }
 
+bool
+pclmul_enabled_cpu()
+{
+	unsigned int ax, bx, cx, dx;
+
+	if (__get_cpuid(1, &ax, &bx, &cx, &dx) == 0)
+		return 0;
+
+	return (cx & (1 << 1)) != 0;
+}
+
 #else /* !(defined (__x86_64__) || defined (__i386__)) */
 
 bool
@@ -122,4 +245,75 @@ sse42_enabled_cpu()
 	return false;
 }
 
+bool
+pclmul_enabled_cpu()
+{
+	return false;
+}
+
+#endif
+
+#if defined (__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+#include <string.h>
+#if defined (__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+static inline uint32_t
+crc32c_armv8_u64(uint32_t crc, uint64_t data)
+{
+	__asm__(".arch_extension crc\n\t"
+		"crc32cx %w0, %w0, %x1" : "+r"(crc) : "r"(data));
+	return crc;
+}
+
+static inline uint32_t
+crc32c_armv8_u8(uint32_t crc, uint8_t data)
+{
+	__asm__(".arch_extension crc\n\t"
+		"crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)data));
+	return crc;
+}
+
+uint32_t
+crc32c_armv8(uint32_t crc, const char *buf, unsigned int len)
+{
+	/* Unaligned loads are cheap on ARMv8 but must be done safely. */
+	while (len >= sizeof(uint64_t)) {
+		uint64_t data;
+		memcpy(&data, buf, sizeof(data));
+		crc = crc32c_armv8_u64(crc, data);
+		buf += sizeof(data);
+		len -= sizeof(data);
+	}
+	while (len--)
+		crc = crc32c_armv8_u8(crc, *buf++);
+	return crc;
+}
+
+bool
+armv8_crc32_enabled_cpu()
+{
+#if defined (__linux__)
+	return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#elif defined (__APPLE__)
+	/* All Apple ARM CPUs implement the CRC32 extension. */
+	return true;
+#else
+	return false;
+#endif
+}
+
+#else /* !defined (__aarch64__) */
+
+bool
+armv8_crc32_enabled_cpu()
+{
+	return false;
+}
+
 #endif
@@ -42,6 +42,12 @@
  */
 bool sse42_enabled_cpu();
 
+/* Check whether CPU supports PCLMULQDQ (needed to combine CRC32 streams). */
+bool pclmul_enabled_cpu();
+
+/* Check whether CPU supports the ARMv8 CRC32 extension. */
+bool armv8_crc32_enabled_cpu();
+
 #if defined (__x86_64__) || defined (__i386__)
 /* Hardware-calculate CRC32 for the given data buffer.
  *
@@ -55,5 +61,27 @@ bool sse42_enabled_cpu();
 uint32_t crc32c_hw(uint32_t crc, const char *buf, unsigned int len);
 #endif
 
+#if defined (__x86_64__)
+/* Hardware-calculate CRC32 for the given data buffer with three
+ * interleaved streams of crc32 instructions combined with carry-less
+ * multiplication. Faster than crc32c_hw() for buffers of 768 bytes
+ * and larger.
+ *
+ * @pre 	true == sse42_enabled_cpu() && true == pclmul_enabled_cpu()
+ * @return	CRC32 value
+ */
+uint32_t crc32c_hw_multi(uint32_t crc, const char *buf, unsigned int len);
+#endif
+
+#if defined (__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/* Hardware-calculate CRC32 for the given data buffer with the ARMv8
+ * CRC32 instructions.
+ *
+ * @pre 	true == armv8_crc32_enabled_cpu()
+ * @return	CRC32 value
+ */
+uint32_t crc32c_armv8(uint32_t crc, const char *buf, unsigned int len);
+#endif
+
 #endif /* TARANTOOL_CPU_FEATURES_H */
 
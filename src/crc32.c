@@ -42,9 +42,16 @@ crc32_func crc32_calc = NULL;
 void
 crc32_init(void)
 {
-#if defined(HAVE_CPUID) && (defined (__x86_64__) || defined (__i386__))
-	crc32_calc = sse42_enabled_cpu() ? &crc32c_hw : &crc32c;
-#else
 	crc32_calc = &crc32c;
+#if defined(HAVE_CPUID) && (defined (__x86_64__) || defined (__i386__))
+	if (sse42_enabled_cpu())
+		crc32_calc = &crc32c_hw;
+#if defined (__x86_64__)
+	if (sse42_enabled_cpu() && pclmul_enabled_cpu())
+		crc32_calc = &crc32c_hw_multi;
+#endif
+#elif defined (__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if (armv8_crc32_enabled_cpu())
+		crc32_calc = &crc32c_armv8;
 #endif
 }
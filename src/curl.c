@@ -245,6 +245,13 @@ curl_env_create(struct curl_env *env, long max_conns, long max_total_conns)
 	curl_multi_setopt(env->multi, CURLMOPT_SOCKETDATA, (void *) env);
 
 	curl_multi_setopt(env->multi, CURLMOPT_MAXCONNECTS, max_conns);
+	/*
+	 * Multiplexing is the default since libcurl 7.62.0, set it
+	 * explicitly so that HTTP/2 requests share connections with
+	 * older libcurl versions too.
+	 */
+	curl_multi_setopt(env->multi, CURLMOPT_PIPELINING,
+			  (long)CURLPIPE_MULTIPLEX);
 #if LIBCURL_VERSION_NUM >= 0x071e00
 	curl_multi_setopt(env->multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, max_total_conns);
 #else
@@ -484,6 +484,16 @@ httpc_set_http_version(struct httpc_request *req, const char *version)
 			 version);
 		return -1;
 	}
+	if (strcmp(version, "1.1") != 0) {
+		/*
+		 * Prefer waiting for a connection that is being
+		 * established to the same host over opening a new one,
+		 * so that concurrent requests issued by different fibers
+		 * are multiplexed over a single HTTP/2 connection.
+		 */
+		curl_easy_setopt(req->curl_request.easy, CURLOPT_PIPEWAIT,
+				 1L);
+	}
 	return 0;
 }
 
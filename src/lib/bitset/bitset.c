@@ -80,7 +80,123 @@ tt_bitset_test(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	return bit_test(tt_bitset_page_data(page), pos - page->first_pos);
+	size_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_sparse(page)) {
+		size_t i = tt_bitset_page_sparse_lower_bound(page, offset);
+		return i < page->cardinality &&
+		       tt_bitset_page_sparse_data(page)[i] == offset;
+	}
+	return bit_test(tt_bitset_page_data(page), offset);
+}
+
+/** Replace a page in the pages tree with a page at the same position. */
+static void
+tt_bitset_replace_page(struct tt_bitset *bitset, struct tt_bitset_page *old,
+		       struct tt_bitset_page *new)
+{
+	assert(old->first_pos == new->first_pos);
+	tt_bitset_pages_remove(&bitset->pages, old);
+	tt_bitset_page_destroy(old);
+	bitset->realloc(old, 0);
+	tt_bitset_pages_insert(&bitset->pages, new);
+}
+
+/**
+ * Allocate a sparse page of @a capacity with the same bits as @a page.
+ * Returns NULL on memory error.
+ */
+static struct tt_bitset_page *
+tt_bitset_page_to_sparse(struct tt_bitset *bitset,
+			 struct tt_bitset_page *page, size_t capacity)
+{
+	assert(page->cardinality <= capacity);
+	struct tt_bitset_page *sparse =
+		bitset->realloc(NULL, tt_bitset_page_sparse_alloc_size(capacity));
+	if (sparse == NULL)
+		return NULL;
+	tt_bitset_page_create_sparse(sparse, capacity);
+	sparse->first_pos = page->first_pos;
+	sparse->cardinality = page->cardinality;
+	uint16_t *offsets = tt_bitset_page_sparse_data(sparse);
+	if (tt_bitset_page_is_sparse(page)) {
+		memcpy(offsets, tt_bitset_page_sparse_data(page),
+		       page->cardinality * sizeof(*offsets));
+		return sparse;
+	}
+	struct bit_iterator it;
+	bit_iterator_init(&it, tt_bitset_page_data(page),
+			  BITSET_PAGE_DATA_SIZE, true);
+	size_t offset;
+	while ((offset = bit_iterator_next(&it)) != SIZE_MAX)
+		*offsets++ = offset;
+	assert(offsets - tt_bitset_page_sparse_data(sparse) ==
+	       (ptrdiff_t)page->cardinality);
+	return sparse;
+}
+
+/**
+ * Allocate a dense page with the same bits as sparse @a page.
+ * Returns NULL on memory error.
+ */
+static struct tt_bitset_page *
+tt_bitset_page_to_dense(struct tt_bitset *bitset, struct tt_bitset_page *page)
+{
+	struct tt_bitset_page *dense =
+		bitset->realloc(NULL, tt_bitset_page_alloc_size(bitset->realloc));
+	if (dense == NULL)
+		return NULL;
+	tt_bitset_page_create(dense);
+	dense->first_pos = page->first_pos;
+	dense->cardinality = page->cardinality;
+	void *data = tt_bitset_page_data(dense);
+	const uint16_t *offsets = tt_bitset_page_sparse_data(page);
+	for (size_t i = 0; i < page->cardinality; i++)
+		bit_set(data, offsets[i]);
+	return dense;
+}
+
+/**
+ * Set a bit in a sparse page. The page may be reallocated or converted
+ * to a dense one.
+ */
+static int
+tt_bitset_page_sparse_set(struct tt_bitset *bitset,
+			  struct tt_bitset_page *page, size_t offset)
+{
+	size_t i = tt_bitset_page_sparse_lower_bound(page, offset);
+	if (i < page->cardinality &&
+	    tt_bitset_page_sparse_data(page)[i] == offset) {
+		/* Value has not changed */
+		return 1;
+	}
+	if (page->cardinality == BITSET_PAGE_SPARSE_MAX) {
+		/* Too many bits for a sparse page */
+		struct tt_bitset_page *dense =
+			tt_bitset_page_to_dense(bitset, page);
+		if (dense == NULL)
+			return -1;
+		tt_bitset_replace_page(bitset, page, dense);
+		bit_set(tt_bitset_page_data(dense), offset);
+		dense->cardinality++;
+		return 0;
+	}
+	if (page->cardinality == page->sparse_capacity) {
+		size_t capacity = page->sparse_capacity * 2;
+		if (capacity > BITSET_PAGE_SPARSE_MAX)
+			capacity = BITSET_PAGE_SPARSE_MAX;
+		struct tt_bitset_page *grown =
+			tt_bitset_page_to_sparse(bitset, page, capacity);
+		if (grown == NULL)
+			return -1;
+		tt_bitset_replace_page(bitset, page, grown);
+		page = grown;
+	}
+	uint16_t *offsets = tt_bitset_page_sparse_data(page);
+	memmove(offsets + i + 1, offsets + i,
+		(page->cardinality - i) * sizeof(*offsets));
+	offsets[i] = offset;
+	page->cardinality++;
+	return 0;
 }
 
 int
@@ -93,13 +209,14 @@ tt_bitset_set(struct tt_bitset *bitset, size_t pos)
 	struct tt_bitset_page *page =
 		tt_bitset_pages_search(&bitset->pages, &key);
 	if (page == NULL) {
-		/* Allocate a new page */
-		size_t size = tt_bitset_page_alloc_size(bitset->realloc);
+		/* Allocate a new page, all pages start as sparse */
+		size_t size = tt_bitset_page_sparse_alloc_size(
+			BITSET_PAGE_SPARSE_MIN);
 		page = bitset->realloc(NULL, size);
 		if (page == NULL)
 			return -1;
 
-		tt_bitset_page_create(page);
+		tt_bitset_page_create_sparse(page, BITSET_PAGE_SPARSE_MIN);
 		page->first_pos = key.first_pos;
 
 		/* Insert the page into pages tree */
@@ -108,7 +225,14 @@ tt_bitset_set(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	bool prev = bit_set(tt_bitset_page_data(page), pos - page->first_pos);
+	size_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_sparse(page)) {
+		int rc = tt_bitset_page_sparse_set(bitset, page, offset);
+		if (rc == 0)
+			bitset->cardinality++;
+		return rc;
+	}
+	bool prev = bit_set(tt_bitset_page_data(page), offset);
 	if (prev) {
 		/* Value has not changed */
 		return 1;
@@ -134,9 +258,19 @@ tt_bitset_clear(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	bool prev = bit_clear(tt_bitset_page_data(page), pos - page->first_pos);
-	if (!prev) {
-		return 0;
+	size_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_sparse(page)) {
+		size_t i = tt_bitset_page_sparse_lower_bound(page, offset);
+		uint16_t *offsets = tt_bitset_page_sparse_data(page);
+		if (i == page->cardinality || offsets[i] != offset)
+			return 0;
+		memmove(offsets + i, offsets + i + 1,
+			(page->cardinality - i - 1) * sizeof(*offsets));
+	} else {
+		bool prev = bit_clear(tt_bitset_page_data(page), offset);
+		if (!prev) {
+			return 0;
+		}
 	}
 
 	assert(bitset->cardinality > 0);
@@ -150,6 +284,16 @@ tt_bitset_clear(struct tt_bitset *bitset, size_t pos)
 		/* Free the page */
 		tt_bitset_page_destroy(page);
 		bitset->realloc(page, 0);
+	} else if (!tt_bitset_page_is_sparse(page) &&
+		   page->cardinality <= BITSET_PAGE_SPARSE_MAX / 2) {
+		/*
+		 * Convert the page to a sparse one to save memory.
+		 * It's fine to keep it dense if there is no memory.
+		 */
+		struct tt_bitset_page *sparse = tt_bitset_page_to_sparse(
+			bitset, page, BITSET_PAGE_SPARSE_MAX);
+		if (sparse != NULL)
+			tt_bitset_replace_page(bitset, page, sparse);
 	}
 
 	return 1;
@@ -170,6 +314,9 @@ tt_bitset_info(struct tt_bitset *bitset, struct tt_bitset_info *info)
 	struct tt_bitset_page *page = tt_bitset_pages_first(&bitset->pages);
 	while (page != NULL) {
 		info->pages++;
+		if (tt_bitset_page_is_sparse(page))
+			info->sparse_pages++;
+		info->mem_size += tt_bitset_page_size(page, bitset->realloc);
 		cardinality_check += page->cardinality;
 		page = tt_bitset_pages_next(&bitset->pages, page);
 	}
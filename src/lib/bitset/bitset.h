@@ -68,7 +68,13 @@ extern "C" {
 struct tt_bitset_page {
 	size_t first_pos;
 	rb_node(struct tt_bitset_page) node;
-	size_t cardinality;
+	uint32_t cardinality;
+	/**
+	 * Zero for a dense page, which stores a bitmap in data.
+	 * For a sparse page, the number of sorted 16-bit offsets
+	 * of set bits that fit in data.
+	 */
+	uint32_t sparse_capacity;
 	uint8_t data[];
 };
 
@@ -151,9 +157,16 @@ tt_bitset_cardinality(const struct tt_bitset *bitset) {
 struct tt_bitset_info {
 	/** Number of allocated pages */
 	size_t pages;
+	/** Number of allocated pages that store offsets instead of bitmaps */
+	size_t sparse_pages;
+	/** Total size of allocated pages (in bytes) */
+	size_t mem_size;
 	/** Data (payload) size of one page (in bytes) */
 	size_t page_data_size;
-	/** Full size of one page (in bytes, including padding and tree data) */
+	/**
+	 * Full size of one dense page (in bytes, including padding and
+	 * tree data)
+	 */
 	size_t page_total_size;
 	/** A multiplier by which an address of page data is aligned **/
 	size_t page_data_alignment;
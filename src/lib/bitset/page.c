@@ -44,6 +44,26 @@ tt_bitset_page_create(struct tt_bitset_page *page);
 extern inline void
 tt_bitset_page_destroy(struct tt_bitset_page *page);
 
+extern inline bool
+tt_bitset_page_is_sparse(const struct tt_bitset_page *page);
+
+extern inline uint16_t *
+tt_bitset_page_sparse_data(struct tt_bitset_page *page);
+
+extern inline size_t
+tt_bitset_page_sparse_alloc_size(size_t capacity);
+
+extern inline void
+tt_bitset_page_create_sparse(struct tt_bitset_page *page, size_t capacity);
+
+extern inline size_t
+tt_bitset_page_sparse_lower_bound(struct tt_bitset_page *page,
+				  size_t offset);
+
+extern inline size_t
+tt_bitset_page_size(const struct tt_bitset_page *page,
+		    void *(*realloc_arg)(void *ptr, size_t size));
+
 extern inline size_t
 tt_bitset_page_first_pos(size_t pos);
 
@@ -48,6 +48,8 @@
 #include <string.h>
 #include <limits.h>
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -55,9 +57,25 @@ extern "C" {
 
 enum {
 	/** How many bytes to store in one page */
-	BITSET_PAGE_DATA_SIZE = 160
+	BITSET_PAGE_DATA_SIZE = 160,
+	/**
+	 * Max number of set bits in a sparse page. A sparse page stores
+	 * sorted 16-bit offsets of set bits instead of a bitmap so it takes
+	 * less memory than a dense page while it has only a few bits set.
+	 * A dense page is converted back to a sparse one when its
+	 * cardinality drops to a half of this value.
+	 */
+	BITSET_PAGE_SPARSE_MAX = 64,
+	/** Capacity of a newly allocated sparse page */
+	BITSET_PAGE_SPARSE_MIN = 4,
 };
 
+static_assert(BITSET_PAGE_DATA_SIZE * CHAR_BIT <= UINT16_MAX + 1,
+	      "Page offsets must fit in uint16_t");
+static_assert(BITSET_PAGE_SPARSE_MAX * sizeof(uint16_t) <
+	      BITSET_PAGE_DATA_SIZE,
+	      "Sparse page must be smaller than dense page");
+
 #if defined(ENABLE_AVX)
 typedef __m256i tt_bitset_word_t;
 #define BITSET_PAGE_DATA_ALIGNMENT 32
@@ -129,6 +147,64 @@ tt_bitset_page_destroy(struct tt_bitset_page *page)
 	/* nothing */
 }
 
+inline bool
+tt_bitset_page_is_sparse(const struct tt_bitset_page *page)
+{
+	return page->sparse_capacity > 0;
+}
+
+inline uint16_t *
+tt_bitset_page_sparse_data(struct tt_bitset_page *page)
+{
+	assert(tt_bitset_page_is_sparse(page));
+	return (uint16_t *) page->data;
+}
+
+inline size_t
+tt_bitset_page_sparse_alloc_size(size_t capacity)
+{
+	return sizeof(struct tt_bitset_page) + capacity * sizeof(uint16_t);
+}
+
+inline void
+tt_bitset_page_create_sparse(struct tt_bitset_page *page, size_t capacity)
+{
+	assert(capacity > 0 && capacity <= BITSET_PAGE_SPARSE_MAX);
+	memset(page, 0, sizeof(*page));
+	page->sparse_capacity = capacity;
+}
+
+/**
+ * Return the index of the first offset in a sparse page that is
+ * greater than or equal to @a offset.
+ */
+inline size_t
+tt_bitset_page_sparse_lower_bound(struct tt_bitset_page *page,
+				  size_t offset)
+{
+	const uint16_t *offsets = tt_bitset_page_sparse_data(page);
+	size_t begin = 0;
+	size_t end = page->cardinality;
+	while (begin < end) {
+		size_t mid = begin + (end - begin) / 2;
+		if (offsets[mid] < offset)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+	return begin;
+}
+
+/** Return the amount of memory allocated for a page. */
+inline size_t
+tt_bitset_page_size(const struct tt_bitset_page *page,
+		    void *(*realloc_arg)(void *ptr, size_t size))
+{
+	if (tt_bitset_page_is_sparse(page))
+		return tt_bitset_page_sparse_alloc_size(page->sparse_capacity);
+	return tt_bitset_page_alloc_size(realloc_arg);
+}
+
 inline size_t
 tt_bitset_page_first_pos(size_t pos) {
 	return pos - (pos % (BITSET_PAGE_DATA_SIZE * CHAR_BIT));
@@ -148,9 +224,31 @@ tt_bitset_page_set_ones(struct tt_bitset_page *page)
 	memset(data, -1, BITSET_PAGE_DATA_SIZE);
 }
 
+/*
+ * Bitwise operations below take a dense destination page and either
+ * a dense or a sparse source page. Dense pages are processed a machine
+ * word (or a SIMD register) at a time, sparse ones - an offset at a time.
+ */
+
 inline void
 tt_bitset_page_and(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_sparse(dst));
+	if (tt_bitset_page_is_sparse(src)) {
+		void *data = tt_bitset_page_data(dst);
+		const uint16_t *offsets = tt_bitset_page_sparse_data(src);
+		uint16_t kept[BITSET_PAGE_SPARSE_MAX];
+		size_t kept_count = 0;
+		assert(src->cardinality <= BITSET_PAGE_SPARSE_MAX);
+		for (size_t i = 0; i < src->cardinality; i++) {
+			if (bit_test(data, offsets[i]))
+				kept[kept_count++] = offsets[i];
+		}
+		memset(data, 0, BITSET_PAGE_DATA_SIZE);
+		for (size_t i = 0; i < kept_count; i++)
+			bit_set(data, kept[i]);
+		return;
+	}
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -164,6 +262,14 @@ tt_bitset_page_and(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 inline void
 tt_bitset_page_nand(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_sparse(dst));
+	if (tt_bitset_page_is_sparse(src)) {
+		void *data = tt_bitset_page_data(dst);
+		const uint16_t *offsets = tt_bitset_page_sparse_data(src);
+		for (size_t i = 0; i < src->cardinality; i++)
+			bit_clear(data, offsets[i]);
+		return;
+	}
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -177,6 +283,14 @@ tt_bitset_page_nand(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 inline void
 tt_bitset_page_or(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_sparse(dst));
+	if (tt_bitset_page_is_sparse(src)) {
+		void *data = tt_bitset_page_data(dst);
+		const uint16_t *offsets = tt_bitset_page_sparse_data(src);
+		for (size_t i = 0; i < src->cardinality; i++)
+			bit_set(data, offsets[i]);
+		return;
+	}
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -80,6 +80,13 @@ coll_icu_cmp(const char *s, size_t slen, const char *t, size_t tlen,
 	     const struct coll *coll)
 {
 	assert(coll->collator != NULL);
+	/*
+	 * Identical strings are equal under any collation. It's the common
+	 * case of the last comparison of a lookup by an exact key, and it's
+	 * much cheaper to check than to run the collator.
+	 */
+	if (slen == tlen && memcmp(s, t, slen) == 0)
+		return 0;
 
 	UErrorCode status = U_ZERO_ERROR;
 
@@ -87,6 +87,33 @@ static void
 cpipe_flush_cb(ev_loop * /* loop */, struct ev_async *watcher,
 	       int /* events */);
 
+/**
+ * Push a batch of messages to the endpoint without locking and
+ * empty the batch. Returns true if the endpoint had no messages
+ * before, i.e. the consumer needs to be notified.
+ */
+static bool
+cbus_endpoint_push(struct cbus_endpoint *endpoint, struct stailq *input)
+{
+	if (stailq_empty(input))
+		return false;
+	/*
+	 * The consumer takes the stack as a whole and reverses the
+	 * list, so push the batch reversed to keep the messages in
+	 * the order they were pushed to the pipe.
+	 */
+	stailq_reverse(input);
+	struct stailq_entry *first = stailq_first(input);
+	struct stailq_entry_ptr *last_next = input->last;
+	struct stailq_entry *top = pm_atomic_load(&endpoint->output);
+	do {
+		last_next->value = top;
+	} while (!pm_atomic_compare_exchange_weak(&endpoint->output,
+						  &top, first));
+	stailq_create(input);
+	return top == NULL;
+}
+
 void
 cpipe_create(struct cpipe *pipe, const char *consumer)
 {
@@ -149,11 +176,11 @@ cpipe_destroy(struct cpipe *pipe)
 	 * delivered.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
+	/* Add the pipe shutdown message as the last one. */
+	stailq_add_tail_entry(&pipe->input, poison, msg.fifo);
 	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
+	cbus_endpoint_push(endpoint, &pipe->input);
 	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
 	/* Count statistics */
 	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 	/*
@@ -215,7 +242,7 @@ cbus_endpoint_create(struct cbus_endpoint *endpoint, const char *name,
 	endpoint->n_pipes = 0;
 	fiber_cond_create(&endpoint->cond);
 	tt_pthread_mutex_init(&endpoint->mutex, NULL);
-	stailq_create(&endpoint->output);
+	endpoint->output = NULL;
 	ev_async_init(&endpoint->async,
 		      (void (*)(ev_loop *, struct ev_async *, int)) fetch_cb);
 	endpoint->async.data = fetch_data;
@@ -249,14 +276,15 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	while (true) {
 		if (process_cb)
 			process_cb(endpoint);
-		if (endpoint->n_pipes == 0 && stailq_empty(&endpoint->output))
+		if (endpoint->n_pipes == 0 &&
+		    pm_atomic_load(&endpoint->output) == NULL)
 			break;
 		 fiber_cond_wait(&endpoint->cond);
 	}
 
 	/*
-	 * Pipe flush func can still lock mutex, so just lock and unlock
-	 * it.
+	 * Pipe destroy func can still lock mutex, so just lock and
+	 * unlock it.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
 	tt_pthread_mutex_unlock(&endpoint->mutex);
@@ -279,14 +307,7 @@ cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 
 	trigger_run(&pipe->on_flush, pipe);
 	/* Trigger task processing when the queue becomes non-empty. */
-	bool output_was_empty;
-
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	output_was_empty = stailq_empty(&endpoint->output);
-	/** Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-
+	bool output_was_empty = cbus_endpoint_push(endpoint, &pipe->input);
 	pipe->n_input = 0;
 	if (output_was_empty) {
 		/* Count statistics */
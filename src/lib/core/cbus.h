@@ -35,6 +35,7 @@
 #include "rmean.h"
 #include "small/rlist.h"
 #include "salad/stailq.h"
+#include <pmatomic.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -118,7 +119,8 @@ struct cpipe {
 	/**
 	 * When pushing messages, keep the staged input size under
 	 * this limit (speeds up message delivery and reduces
-	 * latency, while still keeping the bus mutex cold enough).
+	 * latency, while still keeping the endpoint cache line
+	 * cold enough).
 	 */
 	int max_input;
 	/**
@@ -166,7 +168,7 @@ cpipe_destroy(struct cpipe *pipe);
  * Otherwise, the messages flushed once per event loop iteration.
  *
  * @todo: collect bus stats per second and adjust max_input once
- * a second to keep the mutex cold regardless of the message load,
+ * a second to keep the endpoint cold regardless of the message load,
  * while still keeping the latency low if there are few
  * long-to-process messages.
  */
@@ -255,10 +257,19 @@ struct cbus_endpoint {
 	char name[FIBER_NAME_MAX];
 	/** Member of cbus->endpoints */
 	struct rlist in_cbus;
-	/** The lock around the pipe. */
+	/**
+	 * The lock taken by a pipe being destroyed for the time it
+	 * signals the consumer, so that the endpoint isn't freed
+	 * under its feet.
+	 */
 	pthread_mutex_t mutex;
-	/** A queue with incoming messages. */
-	struct stailq output;
+	/**
+	 * Lock-free stack of incoming messages. Producers push
+	 * batches of messages in reverse order with a CAS, the
+	 * consumer takes the whole stack with an atomic exchange
+	 * and reverses it, which restores the order of messages.
+	 */
+	struct stailq_entry *output;
 	/** Consumer cord loop */
 	ev_loop *consumer;
 	/** Async to notify the consumer */
@@ -275,9 +286,16 @@ struct cbus_endpoint {
 static inline void
 cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
 {
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	stailq_concat(output, &endpoint->output);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
+	struct stailq_entry *entry = pm_atomic_exchange(
+		&endpoint->output, (struct stailq_entry *)NULL);
+	struct stailq fetched;
+	stailq_create(&fetched);
+	while (entry != NULL) {
+		struct stailq_entry *next = entry->next.value;
+		stailq_add(&fetched, entry);
+		entry = next;
+	}
+	stailq_concat(output, &fetched);
 }
 
 /** Initialize the global singleton bus. */
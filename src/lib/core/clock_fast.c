@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "clock_fast.h"
+
+#include "trivia/config.h"
+
+#if defined(HAVE_CPUID) && defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+enum {
+	/** Time to calibrate the counter rate, in nanoseconds. */
+	CLOCK_FAST_CALIBRATION_NS = 5 * 1000 * 1000,
+};
+
+bool clock_fast_use_counter;
+double clock_fast_ns_per_tick;
+uint64_t clock_fast_counter_base;
+int64_t clock_fast_ns_base;
+
+/**
+ * Check if the CPU counter ticks at a constant rate regardless of
+ * the CPU frequency and power state.
+ */
+static bool
+clock_fast_counter_is_invariant(void)
+{
+#if defined(__x86_64__)
+#if defined(HAVE_CPUID)
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 ||
+	    eax < 0x80000007)
+		return false;
+	__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+	/* Invariant TSC. */
+	return (edx & (1 << 8)) != 0;
+#else
+	return false;
+#endif
+#elif defined(__aarch64__)
+	/* The generic timer always ticks at a constant rate. */
+	return true;
+#else
+	return false;
+#endif
+}
+
+void
+clock_fast_init(void)
+{
+	if (clock_fast_use_counter || !clock_fast_counter_is_invariant())
+		return;
+	int64_t ns_start = clock_monotonic64();
+	uint64_t counter_start = clock_fast_counter();
+	int64_t ns_end;
+	do {
+		ns_end = clock_monotonic64();
+	} while (ns_end - ns_start < CLOCK_FAST_CALIBRATION_NS);
+	uint64_t counter_end = clock_fast_counter();
+	if (counter_end <= counter_start)
+		return;
+	clock_fast_ns_per_tick = (double)(ns_end - ns_start) /
+				 (counter_end - counter_start);
+	clock_fast_counter_base = counter_end;
+	clock_fast_ns_base = ns_end;
+	clock_fast_use_counter = true;
+}
@@ -0,0 +1,87 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+/**
+ * Fast monotonic clock for measuring intervals on hot paths.
+ *
+ * Reads the CPU counter (RDTSC on x86_64, CNTVCT_EL0 on AArch64)
+ * if it ticks at a constant rate and falls back to
+ * clock_monotonic64() otherwise. The counter rate is calibrated
+ * against CLOCK_MONOTONIC by clock_fast_init(). The clock may
+ * slightly drift from CLOCK_MONOTONIC, so it must only be used to
+ * measure intervals, not to get timestamps.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "clock.h"
+#include "trivia/util.h"
+
+#if __cplusplus
+extern "C" {
+#endif
+
+#if defined(__x86_64__) || defined(__aarch64__)
+#define CLOCK_FAST_HAVE_COUNTER 1
+#endif
+
+/** Set if clock_fast_ns() reads the CPU counter. */
+extern bool clock_fast_use_counter;
+/** Nanoseconds per counter tick. */
+extern double clock_fast_ns_per_tick;
+/** Counter value at the calibration time. */
+extern uint64_t clock_fast_counter_base;
+/** clock_monotonic64() value at the calibration time. */
+extern int64_t clock_fast_ns_base;
+
+/** Return the current value of the CPU counter. */
+static inline uint64_t
+clock_fast_counter(void)
+{
+#if defined(__x86_64__)
+	return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+	uint64_t value;
+	__asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+	return value;
+#else
+	return 0;
+#endif
+}
+
+/** Monotonic time in nanoseconds. */
+static inline int64_t
+clock_fast_ns(void)
+{
+#ifdef CLOCK_FAST_HAVE_COUNTER
+	if (likely(clock_fast_use_counter)) {
+		int64_t ticks = clock_fast_counter() - clock_fast_counter_base;
+		return clock_fast_ns_base +
+		       (int64_t)(ticks * clock_fast_ns_per_tick);
+	}
+#endif
+	return clock_monotonic64();
+}
+
+/** Same as clock_fast_ns(), but returns the time in seconds. */
+static inline double
+clock_fast(void)
+{
+	return clock_fast_ns() / 1e9;
+}
+
+/**
+ * Check if the CPU counter ticks at a constant rate and calibrate
+ * it. Must be called once before other threads are started.
+ */
+void
+clock_fast_init(void);
+
+#if __cplusplus
+}
+#endif
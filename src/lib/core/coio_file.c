@@ -47,6 +47,8 @@ struct coio_file_task {
 	int errorno;
 	struct fiber *fiber;
 	bool done;
+	/** Time the task was submitted, see coio_pool_enter(). */
+	double submit_time;
 
 	union {
 		struct {
@@ -106,10 +108,14 @@ struct coio_file_task {
 	};
 };
 
+/** libeio priority of file tasks. */
+#define COIO_FILE_PRI coio_pool_priority(COIO_POOL_FILE)
+
 #define INIT_COEIO_FILE(name)			\
 	struct coio_file_task name;		\
 	memset(&name, 0, sizeof(name));		\
 	name.fiber = fiber();			\
+	name.submit_time = coio_pool_enter(COIO_POOL_FILE);
 
 /** A callback invoked by eio when a task is complete. */
 static int
@@ -120,6 +126,7 @@ coio_complete(eio_req *req)
 	eio->errorno = req->errorno;
 	eio->done = true;
 	eio->result = req->result;
+	coio_pool_leave(COIO_POOL_FILE, eio->submit_time);
 
 	fiber_wakeup(eio->fiber);
 	return 0;
@@ -133,6 +140,7 @@ static ssize_t
 coio_wait_done(eio_req *req, struct coio_file_task *eio)
 {
 	if (!req) {
+		coio_pool_leave(COIO_POOL_FILE, eio->submit_time);
 		errno = ENOMEM;
 		return -1;
 	}
@@ -148,7 +156,7 @@ int
 coio_file_open(const char *path, int flags, mode_t mode)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_open(path, flags, mode, 0,
+	eio_req *req = eio_open(path, flags, mode, COIO_FILE_PRI,
 				coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -157,7 +165,7 @@ int
 coio_file_close(int fd)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_close(fd, 0, coio_complete, &eio);
+	eio_req *req = eio_close(fd, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -176,7 +184,7 @@ coio_pwrite(int fd, const void *buf, size_t count, off_t offset)
 		});
 
 		req = eio_write(fd, (char *)buf + pos, chunk,
-				offset + pos, EIO_PRI_DEFAULT,
+				offset + pos, COIO_FILE_PRI,
 				coio_complete, &eio);
 		res = coio_wait_done(req, &eio);
 		if (res < 0) {
@@ -195,7 +203,7 @@ coio_pread(int fd, void *buf, size_t count, off_t offset)
 {
 	INIT_COEIO_FILE(eio);
 	eio_req *req = eio_read(fd, buf, count,
-				offset, 0, coio_complete, &eio);
+				offset, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -243,7 +251,7 @@ coio_write(int fd, const void *buf, size_t count)
 		eio.write.count	= left;
 		eio.write.fd	= fd;
 
-		req = eio_custom(coio_do_write, EIO_PRI_DEFAULT,
+		req = eio_custom(coio_do_write, COIO_FILE_PRI,
 				 coio_complete, &eio);
 		res = coio_wait_done(req, &eio);
 		if (res < 0) {
@@ -272,7 +280,7 @@ coio_read(int fd, void *buf, size_t count)
 	eio.read.buf = buf;
 	eio.read.count = count;
 	eio.read.fd = fd;
-	eio_req *req = eio_custom(coio_do_read, 0,
+	eio_req *req = eio_custom(coio_do_read, COIO_FILE_PRI,
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -296,7 +304,7 @@ coio_lseek(int fd, off_t offset, int whence)
 	eio.lseek.offset = offset;
 	eio.lseek.fd = fd;
 
-	eio_req *req = eio_custom(coio_do_lseek, 0,
+	eio_req *req = eio_custom(coio_do_lseek, COIO_FILE_PRI,
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -315,7 +323,7 @@ coio_lstat(const char *pathname, struct stat *buf)
 	INIT_COEIO_FILE(eio);
 	eio.lstat.pathname = pathname;
 	eio.lstat.buf = buf;
-	eio_req *req = eio_custom(coio_do_lstat, 0,
+	eio_req *req = eio_custom(coio_do_lstat, COIO_FILE_PRI,
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -334,7 +342,7 @@ coio_stat(const char *pathname, struct stat *buf)
 	INIT_COEIO_FILE(eio);
 	eio.lstat.pathname = pathname;
 	eio.lstat.buf = buf;
-	eio_req *req = eio_custom(coio_do_stat, 0,
+	eio_req *req = eio_custom(coio_do_stat, COIO_FILE_PRI,
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -354,7 +362,7 @@ coio_fstat(int fd, struct stat *stat)
 	eio.fstat.fd = fd;
 	eio.fstat.buf = stat;
 
-	eio_req *req = eio_custom(coio_do_fstat, 0,
+	eio_req *req = eio_custom(coio_do_fstat, COIO_FILE_PRI,
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -363,7 +371,7 @@ int
 coio_rename(const char *oldpath, const char *newpath)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_rename(oldpath, newpath, 0,
+	eio_req *req = eio_rename(oldpath, newpath, COIO_FILE_PRI,
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 
@@ -373,7 +381,7 @@ int
 coio_unlink(const char *pathname)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_unlink(pathname, 0, coio_complete, &eio);
+	eio_req *req = eio_unlink(pathname, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -381,7 +389,8 @@ int
 coio_ftruncate(int fd, off_t length)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_ftruncate(fd, length, 0, coio_complete, &eio);
+	eio_req *req = eio_ftruncate(fd, length, COIO_FILE_PRI,
+				     coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -389,7 +398,8 @@ int
 coio_truncate(const char *path, off_t length)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_truncate(path, length, 0, coio_complete, &eio);
+	eio_req *req = eio_truncate(path, length, COIO_FILE_PRI,
+				    coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -413,7 +423,7 @@ coio_glob(const char *pattern, int flags,
 	eio.glob.errfunc = errfunc;
 	eio.glob.pglob = pglob;
 	eio_req *req =
-		eio_custom(coio_do_glob, 0, coio_complete, &eio);
+		eio_custom(coio_do_glob, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -422,7 +432,8 @@ coio_chown(const char *path, uid_t owner, gid_t group)
 {
 	INIT_COEIO_FILE(eio);
 	eio_req *req =
-		eio_chown(path, owner, group, 0, coio_complete, &eio);
+		eio_chown(path, owner, group, COIO_FILE_PRI,
+			  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -430,7 +441,8 @@ int
 coio_chmod(const char *path, mode_t mode)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_chmod(path, mode, 0, coio_complete, &eio);
+	eio_req *req = eio_chmod(path, mode, COIO_FILE_PRI,
+				 coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -438,7 +450,8 @@ int
 coio_mkdir(const char *pathname, mode_t mode)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_mkdir(pathname, mode, 0, coio_complete, &eio);
+	eio_req *req = eio_mkdir(pathname, mode, COIO_FILE_PRI,
+				 coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -446,7 +459,7 @@ int
 coio_rmdir(const char *pathname)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_rmdir(pathname, 0, coio_complete, &eio);
+	eio_req *req = eio_rmdir(pathname, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -454,7 +467,8 @@ int
 coio_link(const char *oldpath, const char *newpath)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_link(oldpath, newpath, 0, coio_complete, &eio);
+	eio_req *req = eio_link(oldpath, newpath, COIO_FILE_PRI,
+				coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -463,7 +477,8 @@ coio_symlink(const char *target, const char *linkpath)
 {
 	INIT_COEIO_FILE(eio);
 	eio_req *req =
-		eio_symlink(target, linkpath, 0, coio_complete, &eio);
+		eio_symlink(target, linkpath, COIO_FILE_PRI,
+			    coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -483,7 +498,7 @@ coio_readlink(const char *pathname, char *buf, size_t bufsize)
 	eio.readlink.pathname = pathname;
 	eio.readlink.buf = buf;
 	eio.readlink.bufsize = bufsize;
-	eio_req *req = eio_custom(coio_do_readlink, 0,
+	eio_req *req = eio_custom(coio_do_readlink, COIO_FILE_PRI,
 				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -504,8 +519,6 @@ coio_do_tempdir(eio_req *req)
 int
 coio_tempdir(char *path, size_t path_size)
 {
-	INIT_COEIO_FILE(eio);
-
 	char *tmpdir = getenv_safe("TMPDIR", NULL, 0);
 	const char *append_dir = tmpdir;
 	if (append_dir == NULL)
@@ -518,9 +531,10 @@ coio_tempdir(char *path, size_t path_size)
 		errno = ENOMEM;
 		return -1;
 	}
+	INIT_COEIO_FILE(eio);
 	eio.tempdir.tpl = path;
 	eio_req *req =
-		eio_custom(coio_do_tempdir, 0, coio_complete, &eio);
+		eio_custom(coio_do_tempdir, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -528,7 +542,7 @@ int
 coio_sync(void)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_sync(0, coio_complete, &eio);
+	eio_req *req = eio_sync(COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -536,7 +550,7 @@ int
 coio_fsync(int fd)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_fsync(fd, 0, coio_complete, &eio);
+	eio_req *req = eio_fsync(fd, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -544,7 +558,7 @@ int
 coio_fdatasync(int fd)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_fdatasync(fd, 0, coio_complete, &eio);
+	eio_req *req = eio_fdatasync(fd, COIO_FILE_PRI, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -609,7 +623,8 @@ coio_readdir(const char *dir_path, char **buf)
 	INIT_COEIO_FILE(eio)
 	eio.readdir.bufp = buf;
 	eio.readdir.pathname = dir_path;
-	eio_req *req = eio_custom(coio_do_readdir, 0, coio_complete, &eio);
+	eio_req *req = eio_custom(coio_do_readdir, COIO_FILE_PRI,
+				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -673,7 +688,8 @@ coio_copyfile(const char *source, const char *dest)
 	INIT_COEIO_FILE(eio)
 	eio.copyfile.source = source;
 	eio.copyfile.dest = dest;
-	eio_req *req = eio_custom(coio_do_copyfile, 0, coio_complete, &eio);
+	eio_req *req = eio_custom(coio_do_copyfile, COIO_FILE_PRI,
+				  coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
 
@@ -681,6 +697,7 @@ int
 coio_utime(const char *pathname, double atime, double mtime)
 {
 	INIT_COEIO_FILE(eio);
-	eio_req *req = eio_utime(pathname, atime, mtime, 0, coio_complete, &eio);
+	eio_req *req = eio_utime(pathname, atime, mtime, COIO_FILE_PRI,
+				 coio_complete, &eio);
 	return coio_wait_done(req, &eio);
 }
@@ -34,11 +34,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
 #include <unistd.h>
 #include <netdb.h>
 #include <sys/socket.h>
 
 #include "fiber.h"
+#include "fiber_cond.h"
+#include "tweaks.h"
 #include <tarantool_ev.h>
 
 /*
@@ -74,6 +77,145 @@ struct coio_manager {
 
 static __thread struct coio_manager coio_manager;
 
+/** A coio pool, see enum coio_pool_id. */
+struct coio_pool {
+	/** Statistics, also stores the priority and the current limit. */
+	struct coio_pool_stat stat;
+	/** Signaled when a task of the pool completes. */
+	struct fiber_cond cond;
+};
+
+/**
+ * Pools are used only from the thread that polls libeio, where task
+ * completion callbacks are run.
+ */
+static struct coio_pool coio_pools[coio_pool_MAX];
+
+const char *coio_pool_id_strs[] = {
+	[COIO_POOL_DEFAULT] = "default",
+	[COIO_POOL_DNS] = "dns",
+	[COIO_POOL_FILE] = "file",
+	[COIO_POOL_USER] = "user",
+};
+
+static_assert(lengthof(coio_pool_id_strs) == coio_pool_MAX,
+	      "each coio pool must have a name");
+
+/** libeio priorities of pools. Tasks requested from Lua go last. */
+static const int coio_pool_priorities[] = {
+	[COIO_POOL_DEFAULT] = EIO_PRI_DEFAULT,
+	[COIO_POOL_DNS] = EIO_PRI_DEFAULT,
+	[COIO_POOL_FILE] = EIO_PRI_DEFAULT - 1,
+	[COIO_POOL_USER] = EIO_PRI_DEFAULT - 1,
+};
+
+static_assert(lengthof(coio_pool_priorities) == coio_pool_MAX,
+	      "each coio pool must have a priority");
+
+/**
+ * Max number of tasks of the file and user pools executed
+ * concurrently. Zero means the number of worker threads minus one,
+ * so that there's always a thread for internal tasks.
+ */
+static uint64_t coio_pool_file_max;
+TWEAK_UINT(coio_pool_file_max);
+static uint64_t coio_pool_user_max;
+TWEAK_UINT(coio_pool_user_max);
+
+/** Number of threads in the worker pool, the libeio default. */
+static int coio_worker_threads = 4;
+
+void
+coio_set_worker_threads(int count)
+{
+	eio_set_min_parallel(count);
+	eio_set_max_parallel(count);
+	coio_worker_threads = count;
+}
+
+/** Return the max number of concurrent tasks of a pool, 0 if unlimited. */
+static int
+coio_pool_limit(enum coio_pool_id id)
+{
+	uint64_t max;
+	switch (id) {
+	case COIO_POOL_FILE:
+		max = coio_pool_file_max;
+		break;
+	case COIO_POOL_USER:
+		max = coio_pool_user_max;
+		break;
+	default:
+		return 0;
+	}
+	if (max != 0)
+		return MIN(max, (uint64_t)INT_MAX);
+	return MAX(coio_worker_threads - 1, 1);
+}
+
+int
+coio_pool_priority(enum coio_pool_id id)
+{
+	assert(id < coio_pool_MAX);
+	return coio_pool_priorities[id];
+}
+
+void
+coio_pool_stat(enum coio_pool_id id, struct coio_pool_stat *stat)
+{
+	assert(id < coio_pool_MAX);
+	*stat = coio_pools[id].stat;
+	stat->priority = coio_pool_priority(id);
+	stat->limit = coio_pool_limit(id);
+}
+
+/** Account a new task in the pool without waiting for the limit. */
+static double
+coio_pool_take(enum coio_pool_id id)
+{
+	assert(id < coio_pool_MAX);
+	coio_pools[id].stat.active++;
+	return ev_monotonic_now(loop());
+}
+
+double
+coio_pool_enter(enum coio_pool_id id)
+{
+	assert(id < coio_pool_MAX);
+	struct coio_pool *pool = &coio_pools[id];
+	int limit = coio_pool_limit(id);
+	if (limit != 0 && pool->stat.active >= limit) {
+		double start = ev_monotonic_now(loop());
+		pool->stat.waiting++;
+		/*
+		 * The task can't be aborted because it hasn't been
+		 * submitted yet, so ignore cancellation.
+		 */
+		while (pool->stat.active >= coio_pool_limit(id))
+			fiber_cond_wait(&pool->cond);
+		pool->stat.waiting--;
+		double wait_time = ev_monotonic_now(loop()) - start;
+		pool->stat.wait_time += wait_time;
+		pool->stat.wait_time_max = MAX(pool->stat.wait_time_max,
+					       wait_time);
+	}
+	return coio_pool_take(id);
+}
+
+void
+coio_pool_leave(enum coio_pool_id id, double submit_time)
+{
+	assert(id < coio_pool_MAX);
+	struct coio_pool *pool = &coio_pools[id];
+	assert(pool->stat.active > 0);
+	pool->stat.active--;
+	pool->stat.count++;
+	double exec_time = ev_monotonic_now(loop()) - submit_time;
+	pool->stat.exec_time += exec_time;
+	pool->stat.exec_time_max = MAX(pool->stat.exec_time_max, exec_time);
+	fiber_cond_signal(&pool->cond);
+}
+
 static void
 coio_idle_cb(ev_loop *loop, struct ev_idle *w, int events)
 {
@@ -148,6 +290,9 @@ coio_enable(void)
 	ev_async_init(&coio_manager.coio_async, coio_async_cb);
 
 	ev_async_start(loop(), &coio_manager.coio_async);
+
+	for (int i = 0; i < coio_pool_MAX; i++)
+		fiber_cond_create(&coio_pools[i].cond);
 }
 
 void
@@ -174,6 +319,7 @@ static int
 coio_on_finish(eio_req *req)
 {
 	struct coio_task *task = (struct coio_task *) req;
+	coio_pool_leave(task->pool, task->submit_time);
 	if (task->fiber == NULL) {
 		/*
 		 * Timed out. Resources will be freed by coio_on_destroy.
@@ -218,6 +364,8 @@ coio_task_create(struct coio_task *task,
 	task->fiber = fiber();
 	task->task_cb = func;
 	task->timeout_cb = on_timeout;
+	task->pool = COIO_POOL_DEFAULT;
+	task->submit_time = 0;
 	task->complete = 0;
 	diag_create(&task->diag);
 }
@@ -233,6 +381,9 @@ coio_task_post(struct coio_task *task)
 {
 	assert(task->base.type == EIO_CUSTOM);
 	assert(task->fiber == fiber());
+	/* A detached task is never delayed by the pool limit. */
+	task->submit_time = coio_pool_take(task->pool);
+	task->base.pri = coio_pool_priority(task->pool);
 	eio_submit(&task->base);
 	task->fiber = NULL;
 }
@@ -243,8 +394,11 @@ coio_task_execute(struct coio_task *task, double timeout)
 	assert(task->base.type == EIO_CUSTOM);
 	assert(task->fiber == fiber());
 
+	double deadline = ev_monotonic_now(loop()) + timeout;
+	task->submit_time = coio_pool_enter(task->pool);
+	task->base.pri = coio_pool_priority(task->pool);
 	eio_submit(&task->base);
-	fiber_yield_timeout(timeout);
+	fiber_yield_deadline(deadline);
 	if (!task->complete) {
 		/* timed out or cancelled. */
 		task->fiber = NULL;
@@ -266,8 +420,9 @@ coio_on_call(eio_req *req)
 		diag_move(diag_get(), &task->diag);
 }
 
-ssize_t
-coio_call(ssize_t (*func)(va_list ap), ...)
+/** Common part of coio_call() and coio_call_pool(). */
+static ssize_t
+coio_vcall(enum coio_pool_id pool, ssize_t (*func)(va_list ap), va_list ap)
 {
 	struct coio_task *task = (struct coio_task *) calloc(1, sizeof(*task));
 	if (task == NULL)
@@ -277,14 +432,16 @@ coio_call(ssize_t (*func)(va_list ap), ...)
 	task->base.feed = coio_on_call;
 	task->base.finish = coio_on_finish;
 	/* task->base.destroy = NULL; */
-	/* task->base.pri = 0; */
+	task->base.pri = coio_pool_priority(pool);
 
 	task->fiber = fiber();
 	task->call_cb = func;
+	task->pool = pool;
 	task->complete = 0;
 	diag_create(&task->diag);
 
-	va_start(task->ap, func);
+	va_copy(task->ap, ap);
+	task->submit_time = coio_pool_enter(pool);
 	eio_submit(&task->base);
 
 	do {
@@ -301,6 +458,26 @@ coio_call(ssize_t (*func)(va_list ap), ...)
 	return result;
 }
 
+ssize_t
+coio_call(ssize_t (*func)(va_list ap), ...)
+{
+	va_list ap;
+	va_start(ap, func);
+	ssize_t result = coio_vcall(COIO_POOL_DEFAULT, func, ap);
+	va_end(ap);
+	return result;
+}
+
+ssize_t
+coio_call_pool(enum coio_pool_id pool, ssize_t (*func)(va_list ap), ...)
+{
+	va_list ap;
+	va_start(ap, func);
+	ssize_t result = coio_vcall(pool, func, ap);
+	va_end(ap);
+	return result;
+}
+
 struct async_getaddrinfo_task {
 	struct coio_task base;
 	struct addrinfo *result;
@@ -372,6 +549,7 @@ coio_getaddrinfo(const char *host, const char *port,
 	}
 
 	coio_task_create(&task->base, getaddrinfo_cb, getaddrinfo_free_cb);
+	task->base.pool = COIO_POOL_DNS;
 
 	/*
 	 * getaddrinfo() on osx upto osx 10.8 crashes when AI_NUMERICSERV is
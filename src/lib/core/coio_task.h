@@ -53,6 +53,74 @@ void coio_init(void);
 void coio_enable(void);
 void coio_shutdown(void);
 
+/**
+ * Set the number of threads in the worker pool. Limits of coio
+ * pools that are not set explicitly depend on it.
+ */
+void
+coio_set_worker_threads(int count);
+
+/**
+ * Tasks are accounted in pools, which set the libeio priority of
+ * tasks and may limit the number of tasks executed concurrently,
+ * so that a burst of tasks of one kind doesn't occupy all worker
+ * threads.
+ */
+enum coio_pool_id {
+	/** Internal tasks. High priority, not limited. */
+	COIO_POOL_DEFAULT,
+	/** Host name resolution. High priority, not limited. */
+	COIO_POOL_DNS,
+	/** File operations requested from Lua (fio). */
+	COIO_POOL_FILE,
+	/** Other tasks requested from Lua, e.g. digest. */
+	COIO_POOL_USER,
+	coio_pool_MAX,
+};
+
+/** Names of coio pools, for statistics. */
+extern const char *coio_pool_id_strs[];
+
+/** Statistics of a coio pool. */
+struct coio_pool_stat {
+	/** libeio priority of tasks. */
+	int priority;
+	/** Max number of tasks executed concurrently, 0 if unlimited. */
+	int limit;
+	/** Number of tasks being executed. */
+	int active;
+	/** Number of fibers waiting for the limit. */
+	int waiting;
+	/** Number of completed tasks. */
+	int64_t count;
+	/** Total and max time spent waiting for the limit, seconds. */
+	double wait_time;
+	double wait_time_max;
+	/** Total and max time from submission to completion, seconds. */
+	double exec_time;
+	double exec_time_max;
+};
+
+/** Get statistics of a coio pool. */
+void
+coio_pool_stat(enum coio_pool_id id, struct coio_pool_stat *stat);
+
+/** Return the libeio priority of tasks of a coio pool. */
+int
+coio_pool_priority(enum coio_pool_id id);
+
+/**
+ * Wait until the number of tasks executed in the pool is below the
+ * limit and account a new task. Returns the task submission time,
+ * which should be passed to coio_pool_leave() on completion.
+ */
+double
+coio_pool_enter(enum coio_pool_id id);
+
+/** Account completion of a task in the pool. */
+void
+coio_pool_leave(enum coio_pool_id id, double submit_time);
+
 struct coio_task;
 
 typedef ssize_t (*coio_call_cb)(va_list ap);
@@ -80,6 +148,10 @@ struct coio_task {
 			va_list ap;
 		};
 	};
+	/** Pool the task is accounted in, COIO_POOL_DEFAULT by default. */
+	enum coio_pool_id pool;
+	/** Time the task was submitted, see coio_pool_enter(). */
+	double submit_time;
 	/** Callback results. */
 	int complete;
 	/** Task diag **/
@@ -179,6 +251,10 @@ coio_getaddrinfo(const char *host, const char *port,
 		 double timeout);
 /** \endcond public */
 
+/** Same as coio_call(), but accounts the task in the given pool. */
+ssize_t
+coio_call_pool(enum coio_pool_id pool, ssize_t (*func)(va_list), ...);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -6,6 +6,7 @@
 #include "cord_buf.h"
 #include "fiber.h"
 #include "trigger.h"
+#include "tweaks.h"
 
 #include "small/ibuf.h"
 
@@ -33,6 +34,17 @@ struct cord_buf {
 #endif
 };
 
+/**
+ * Max capacity of the buffer saved to the cache. A bigger buffer is
+ * freed before being saved so that a rare request needing a lot of
+ * temporary memory doesn't pin it forever.
+ */
+static uint64_t cord_ibuf_max_cached = 1024 * 1024;
+TWEAK_UINT(cord_ibuf_max_cached);
+
+/** Statistics of the global buffer usage. */
+static struct cord_ibuf_stat cord_buf_stat;
+
 /**
  * The global buffer last saved to the cache. Having it here is supposed to
  * help to reuse the buffer's already allocated data sometimes.
@@ -42,6 +54,17 @@ static struct cord_buf *cord_buf_global = NULL;
 static inline void
 cord_buf_put(struct cord_buf *buf);
 
+/** Account the buffer memory usage before putting it back. */
+static inline void
+cord_buf_collect_stat(struct cord_buf *buf)
+{
+	/* Consumed data counts too, the memory was needed for it. */
+	size_t used = buf->base.wpos - buf->base.buf;
+	size_t capacity = ibuf_capacity(&buf->base);
+	cord_buf_stat.used_max = MAX(cord_buf_stat.used_max, used);
+	cord_buf_stat.capacity_max = MAX(cord_buf_stat.capacity_max, capacity);
+}
+
 static void
 cord_buf_delete(struct cord_buf *buf);
 
@@ -109,6 +132,11 @@ cord_buf_put(struct cord_buf *buf)
 {
 	assert(cord_is_main());
 	cord_buf_clear_owner(buf);
+	cord_buf_collect_stat(buf);
+	if (ibuf_capacity(&buf->base) > cord_ibuf_max_cached) {
+		ibuf_reinit(&buf->base);
+		cord_buf_stat.shrink_count++;
+	}
 	/*
 	 * Delete if the stash is busy. It could happen if there was >= 2
 	 * buffers at some point and one of them is already saved back to the
@@ -162,6 +190,23 @@ cord_ibuf_put(struct ibuf *ibuf)
 void
 cord_ibuf_drop(struct ibuf *ibuf)
 {
+	cord_buf_collect_stat((struct cord_buf *)ibuf);
 	ibuf_reinit(ibuf);
 	cord_ibuf_put(ibuf);
 }
+
+void
+cord_ibuf_stat(struct cord_ibuf_stat *stat)
+{
+	*stat = cord_buf_stat;
+	stat->capacity = cord_buf_global != NULL ?
+			 ibuf_capacity(&cord_buf_global->base) : 0;
+}
+
+void
+cord_ibuf_reset_stat(void)
+{
+	cord_buf_stat.used_max = 0;
+	cord_buf_stat.capacity_max = 0;
+	cord_buf_stat.shrink_count = 0;
+}
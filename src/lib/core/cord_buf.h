@@ -5,6 +5,9 @@
  */
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
@@ -44,6 +47,29 @@ cord_ibuf_put(struct ibuf *ibuf);
 void
 cord_ibuf_drop(struct ibuf *ibuf);
 
+/** Statistics of the global ibuf usage. */
+struct cord_ibuf_stat {
+	/** Capacity of the buffer saved in the stash now. */
+	size_t capacity;
+	/** Max capacity of the buffer when it was put back. */
+	size_t capacity_max;
+	/** Max size of data in the buffer when it was put back. */
+	size_t used_max;
+	/**
+	 * Number of times the buffer memory was freed on put, because
+	 * its capacity exceeded the cache limit.
+	 */
+	uint64_t shrink_count;
+};
+
+/** Get statistics of the global ibuf usage. */
+void
+cord_ibuf_stat(struct cord_ibuf_stat *stat);
+
+/** Reset max values and counters of the global ibuf statistics. */
+void
+cord_ibuf_reset_stat(void);
+
 #if defined(__cplusplus)
 }
 #endif /* defined(__cplusplus) */
@@ -0,0 +1,309 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "cpu_profiler.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif /* defined(__linux__) */
+
+#include <PMurHash.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "trivia/util.h"
+
+#if defined(ENABLE_BACKTRACE) && defined(__linux__)
+# define CPU_PROFILER_SUPPORTED 1
+#endif
+
+#if defined(CPU_PROFILER_SUPPORTED) && !defined(sigev_notify_thread_id)
+# define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+enum {
+	/** Number of slots in the stack table, must be a power of two. */
+	CPU_PROFILER_TABLE_SIZE = 4096,
+	/** Max number of slots probed to find a stack in the table. */
+	CPU_PROFILER_PROBE_MAX = 64,
+};
+
+static struct {
+	/**
+	 * Hash table of sampled stacks with linear probing or NULL if
+	 * the profiler has never been started. It's updated by the signal
+	 * handler, so the signal is blocked while it's read or modified.
+	 */
+	struct cpu_profiler_stack *table;
+	/** Number of used slots in the table. */
+	size_t stack_count;
+	/** Number of samples accounted in the table. */
+	uint64_t sample_count;
+	/** Number of samples that didn't fit in the table. */
+	uint64_t drop_count;
+	/** True if the timer is armed. */
+	bool is_running;
+	/** Sampling interval, in seconds. */
+	double interval;
+#if defined(CPU_PROFILER_SUPPORTED)
+	/** Timer measuring the CPU time of the profiled thread. */
+	timer_t timer;
+	/** SIGPROF action set before the profiler was started. */
+	struct sigaction old_action;
+#endif /* defined(CPU_PROFILER_SUPPORTED) */
+} profiler;
+
+/**
+ * Block SIGPROF in the current thread to access the stack table. The old
+ * signal mask is saved to @a old.
+ */
+static void
+cpu_profiler_lock(sigset_t *old)
+{
+	sigset_t set;
+	sigemptyset(&set);
+	sigaddset(&set, SIGPROF);
+	pthread_sigmask(SIG_BLOCK, &set, old);
+}
+
+/** Restore the signal mask saved by cpu_profiler_lock(). */
+static void
+cpu_profiler_unlock(const sigset_t *old)
+{
+	pthread_sigmask(SIG_SETMASK, old, NULL);
+}
+
+#if defined(CPU_PROFILER_SUPPORTED)
+
+static uint32_t
+cpu_profiler_stack_hash(const struct cpu_profiler_stack *stack)
+{
+	uint32_t h = 13;
+	uint32_t carry = 0;
+	uint32_t total_size = 0;
+	size_t size = stack->bt.frame_count * sizeof(stack->bt.frames[0]);
+	PMurHash32_Process(&h, &carry, stack->bt.frames, size);
+	total_size += size;
+	size = strlen(stack->fiber_name);
+	PMurHash32_Process(&h, &carry, stack->fiber_name, size);
+	total_size += size;
+	size = sizeof(stack->request_type);
+	PMurHash32_Process(&h, &carry, &stack->request_type, size);
+	total_size += size;
+	size = sizeof(stack->func_id);
+	PMurHash32_Process(&h, &carry, &stack->func_id, size);
+	total_size += size;
+	return PMurHash32_Result(h, carry, total_size);
+}
+
+static bool
+cpu_profiler_stack_equal(const struct cpu_profiler_stack *a,
+			 const struct cpu_profiler_stack *b)
+{
+	return a->hash == b->hash && a->request_type == b->request_type &&
+	       a->func_id == b->func_id &&
+	       a->bt.frame_count == b->bt.frame_count &&
+	       strcmp(a->fiber_name, b->fiber_name) == 0 &&
+	       memcmp(a->bt.frames, b->bt.frames,
+		      a->bt.frame_count * sizeof(a->bt.frames[0])) == 0;
+}
+
+/** Account a sample in the stack table. Called from the signal handler. */
+static void
+cpu_profiler_account(const struct cpu_profiler_stack *sample)
+{
+	for (uint32_t i = 0; i < CPU_PROFILER_PROBE_MAX; i++) {
+		struct cpu_profiler_stack *slot = &profiler.table[
+			(sample->hash + i) & (CPU_PROFILER_TABLE_SIZE - 1)];
+		if (slot->count == 0) {
+			*slot = *sample;
+			slot->count = 1;
+			profiler.stack_count++;
+			profiler.sample_count++;
+			return;
+		}
+		if (cpu_profiler_stack_equal(slot, sample)) {
+			slot->count++;
+			profiler.sample_count++;
+			return;
+		}
+	}
+	profiler.drop_count++;
+}
+
+/**
+ * SIGPROF handler. It runs in the profiled thread on the stack of the
+ * interrupted fiber, so it only has to do async-signal-safe work: read
+ * the fiber attributes, unwind the stack and update the table.
+ */
+static void
+cpu_profiler_signal_cb(int signo, siginfo_t *info, void *context)
+{
+	(void)signo;
+	(void)info;
+	(void)context;
+	if (!profiler.is_running)
+		return;
+	int saved_errno = errno;
+	struct cpu_profiler_stack sample;
+	struct fiber *f = fiber();
+	sample.request_type = f->storage.net.type;
+	sample.func_id = f->storage.func_id;
+	strlcpy(sample.fiber_name, fiber_name(f), sizeof(sample.fiber_name));
+	/*
+	 * Skip backtrace_collect(), the signal handler and the signal
+	 * trampoline frames.
+	 */
+	backtrace_collect(&sample.bt, NULL, 3);
+	sample.hash = cpu_profiler_stack_hash(&sample);
+	cpu_profiler_account(&sample);
+	errno = saved_errno;
+}
+
+int
+cpu_profiler_start(double interval)
+{
+	assert(interval > 0);
+	if (profiler.is_running) {
+		diag_set(IllegalParams, "CPU profiler is already running");
+		return -1;
+	}
+	struct sigaction sa;
+	if (sigaction(SIGPROF, NULL, &sa) != 0) {
+		diag_set(SystemError, "sigaction");
+		return -1;
+	}
+	if ((sa.sa_flags & SA_SIGINFO) != 0 ||
+	    (sa.sa_handler != SIG_DFL && sa.sa_handler != SIG_IGN)) {
+		diag_set(IllegalParams, "SIGPROF is used by another profiler");
+		return -1;
+	}
+	if (profiler.table == NULL) {
+		profiler.table = xcalloc(CPU_PROFILER_TABLE_SIZE,
+					 sizeof(*profiler.table));
+	}
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = cpu_profiler_signal_cb;
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	if (sigaction(SIGPROF, &sa, &profiler.old_action) != 0) {
+		diag_set(SystemError, "sigaction");
+		return -1;
+	}
+	struct sigevent sev;
+	memset(&sev, 0, sizeof(sev));
+	sev.sigev_notify = SIGEV_THREAD_ID;
+	sev.sigev_signo = SIGPROF;
+	sev.sigev_notify_thread_id = syscall(SYS_gettid);
+	if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &profiler.timer) != 0) {
+		diag_set(SystemError, "timer_create");
+		sigaction(SIGPROF, &profiler.old_action, NULL);
+		return -1;
+	}
+	struct itimerspec its;
+	its.it_interval.tv_sec = (time_t)interval;
+	its.it_interval.tv_nsec = (long)((interval - (time_t)interval) * 1e9);
+	if (its.it_interval.tv_sec == 0 && its.it_interval.tv_nsec == 0)
+		its.it_interval.tv_nsec = 1;
+	its.it_value = its.it_interval;
+	profiler.is_running = true;
+	profiler.interval = interval;
+	if (timer_settime(profiler.timer, 0, &its, NULL) != 0) {
+		diag_set(SystemError, "timer_settime");
+		cpu_profiler_stop();
+		return -1;
+	}
+	return 0;
+}
+
+void
+cpu_profiler_stop(void)
+{
+	if (!profiler.is_running)
+		return;
+	timer_delete(profiler.timer);
+	/*
+	 * Ignoring the signal discards the one that may still be pending,
+	 * so that it isn't delivered with the default action restored.
+	 */
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = SIG_IGN;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, NULL);
+	sigaction(SIGPROF, &profiler.old_action, NULL);
+	profiler.is_running = false;
+}
+
+#else /* !defined(CPU_PROFILER_SUPPORTED) */
+
+int
+cpu_profiler_start(double interval)
+{
+	(void)interval;
+	diag_set(IllegalParams, "CPU profiler is not supported");
+	return -1;
+}
+
+void
+cpu_profiler_stop(void)
+{
+}
+
+#endif /* !defined(CPU_PROFILER_SUPPORTED) */
+
+void
+cpu_profiler_reset(void)
+{
+	sigset_t old;
+	cpu_profiler_lock(&old);
+	if (profiler.table != NULL) {
+		memset(profiler.table, 0,
+		       CPU_PROFILER_TABLE_SIZE * sizeof(*profiler.table));
+	}
+	profiler.stack_count = 0;
+	profiler.sample_count = 0;
+	profiler.drop_count = 0;
+	cpu_profiler_unlock(&old);
+}
+
+void
+cpu_profiler_stat(struct cpu_profiler_stat *stat)
+{
+	sigset_t old;
+	cpu_profiler_lock(&old);
+	stat->is_running = profiler.is_running;
+	stat->interval = profiler.interval;
+	stat->sample_count = profiler.sample_count;
+	stat->drop_count = profiler.drop_count;
+	stat->stack_count = profiler.stack_count;
+	cpu_profiler_unlock(&old);
+}
+
+struct cpu_profiler_stack *
+cpu_profiler_snapshot(size_t *count)
+{
+	*count = 0;
+	struct cpu_profiler_stack *stacks = NULL;
+	sigset_t old;
+	cpu_profiler_lock(&old);
+	if (profiler.stack_count > 0) {
+		stacks = xmalloc(profiler.stack_count * sizeof(*stacks));
+		for (size_t i = 0; i < CPU_PROFILER_TABLE_SIZE; i++) {
+			if (profiler.table[i].count != 0)
+				stacks[(*count)++] = profiler.table[i];
+		}
+		assert(*count == profiler.stack_count);
+	}
+	cpu_profiler_unlock(&old);
+	return stacks;
+}
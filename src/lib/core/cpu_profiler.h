@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fiber.h"
+#include "trivia/config.h"
+
+#if defined(ENABLE_BACKTRACE)
+#include "backtrace.h"
+#endif /* defined(ENABLE_BACKTRACE) */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Sampling CPU profiler of a thread.
+ *
+ * A POSIX timer measuring the CPU time of the profiled thread sends
+ * SIGPROF to the thread. The signal handler collects the C call stack
+ * of the running fiber and accounts it in a preallocated hash table
+ * under the name of the fiber, the type of the iproto request and the id
+ * of the stored function it is executing, see struct fiber::storage.
+ *
+ * Only one thread can be profiled at a time. Profiling is supported only
+ * on Linux in builds with ENABLE_BACKTRACE.
+ */
+
+/** A call stack sampled by the CPU profiler. */
+struct cpu_profiler_stack {
+	/** Number of samples of the stack, 0 if the slot is free. */
+	uint64_t count;
+	/** Hash of all other members. */
+	uint32_t hash;
+	/** Type of the iproto request handled by the fiber or 0. */
+	uint32_t request_type;
+	/** Id of the stored function executed by the fiber or 0. */
+	uint32_t func_id;
+	/** Name of the fiber, truncated. */
+	char fiber_name[FIBER_NAME_INLINE];
+#if defined(ENABLE_BACKTRACE)
+	/** C call stack of the fiber. */
+	struct backtrace bt;
+#endif /* defined(ENABLE_BACKTRACE) */
+};
+
+/** CPU profiler statistics. */
+struct cpu_profiler_stat {
+	/** True if the profiler is running. */
+	bool is_running;
+	/** Sampling interval, in seconds of CPU time. */
+	double interval;
+	/** Number of samples accounted. */
+	uint64_t sample_count;
+	/** Number of samples dropped because the stack table is full. */
+	uint64_t drop_count;
+	/** Number of distinct stacks sampled. */
+	size_t stack_count;
+};
+
+/**
+ * Start sampling the current thread every @a interval seconds of its CPU
+ * time. Samples collected before are kept. Returns -1 and sets diag on
+ * failure, in particular if the profiler is already running or SIGPROF
+ * is used by somebody else, e.g. by the LuaJIT sampling profiler.
+ */
+int
+cpu_profiler_start(double interval);
+
+/** Stop the profiler. The collected samples are kept. */
+void
+cpu_profiler_stop(void);
+
+/** Discard all collected samples. */
+void
+cpu_profiler_reset(void);
+
+/** Get the profiler statistics. */
+void
+cpu_profiler_stat(struct cpu_profiler_stat *stat);
+
+/**
+ * Copy the sampled stacks to a malloc'ed array. The number of stacks is
+ * returned in @a count. The caller is supposed to free the array. Returns
+ * NULL if no stacks were sampled.
+ */
+struct cpu_profiler_stack *
+cpu_profiler_snapshot(size_t *count);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -531,3 +531,97 @@ decimal_unpack(const char **data, uint32_t len, decimal_t *dec)
 	}
 	return res;
 }
+
+/** A packed decimal split into the scale, the digits and the sign. */
+struct decimal_packed {
+	/** Scale. */
+	int64_t scale;
+	/** BCD digits, the last nibble is the sign. */
+	const uint8_t *bcd;
+	/** Index of the first non-zero digit nibble. */
+	uint32_t first;
+	/** Number of digit nibbles. */
+	uint32_t digit_count;
+	/** -1, 0 or 1 for a negative, zero or positive number. */
+	int sign;
+};
+
+/** Get the digit nibble of a packed decimal with the given index. */
+static inline uint8_t
+decimal_packed_digit(const struct decimal_packed *p, uint32_t i)
+{
+	uint8_t byte = p->bcd[i / 2];
+	return i % 2 == 0 ? byte >> 4 : byte & 0x0f;
+}
+
+/**
+ * Split a packed decimal. Returns false if the encoding is
+ * unexpected, in which case the caller should fall back on
+ * decimal_unpack() to handle it.
+ */
+static bool
+decimal_packed_create(struct decimal_packed *p, const char *data,
+		      uint32_t len)
+{
+	const char *end = data + len;
+	if (len == 0)
+		return false;
+	if (mp_typeof(*data) == MP_UINT) {
+		if (mp_check_uint(data, end) > 0)
+			return false;
+		p->scale = mp_decode_uint(&data);
+	} else if (mp_typeof(*data) == MP_INT) {
+		if (mp_check_int(data, end) > 0)
+			return false;
+		p->scale = mp_decode_int(&data);
+	} else {
+		return false;
+	}
+	len = end - data;
+	if (len == 0)
+		return false;
+	p->bcd = (const uint8_t *)data;
+	p->digit_count = len * 2 - 1;
+	uint8_t sign = p->bcd[len - 1] & 0x0f;
+	if (sign < 0x0a)
+		return false;
+	for (p->first = 0; p->first < p->digit_count; p->first++) {
+		if (decimal_packed_digit(p, p->first) != 0)
+			break;
+	}
+	if (p->first == p->digit_count)
+		p->sign = 0;
+	else
+		p->sign = sign == 0x0b || sign == 0x0d ? -1 : 1;
+	return true;
+}
+
+bool
+decimal_compare_packed(const char *lhs, uint32_t lhs_len,
+		       const char *rhs, uint32_t rhs_len, int *result)
+{
+	struct decimal_packed l, r;
+	if (!decimal_packed_create(&l, lhs, lhs_len) ||
+	    !decimal_packed_create(&r, rhs, rhs_len) ||
+	    l.scale != r.scale)
+		return false;
+	if (l.sign != r.sign || l.sign == 0) {
+		*result = l.sign - r.sign;
+		return true;
+	}
+	/* Same scale and sign: compare the significant digits. */
+	uint32_t l_count = l.digit_count - l.first;
+	uint32_t r_count = r.digit_count - r.first;
+	int cmp = 0;
+	if (l_count != r_count) {
+		cmp = l_count < r_count ? -1 : 1;
+	} else {
+		for (uint32_t i = 0; i < l_count && cmp == 0; i++) {
+			uint8_t l_digit = decimal_packed_digit(&l, l.first + i);
+			uint8_t r_digit = decimal_packed_digit(&r, r.first + i);
+			cmp = l_digit - r_digit;
+		}
+	}
+	*result = l.sign * cmp;
+	return true;
+}
@@ -282,6 +282,19 @@ decimal_pack(char *data, const decimal_t *dec);
 decimal_t *
 decimal_unpack(const char **data, uint32_t len, decimal_t *dec);
 
+/**
+ * Compare two packed decimals of lengths \a lhs_len and \a rhs_len
+ * without unpacking them. Works only if both decimals have the same
+ * scale.
+ *
+ * @return true and set \a result to the comparison result (< 0,
+ *         0 or > 0) on success, false if the decimals have different
+ *         scales or the encoding is unexpected.
+ */
+bool
+decimal_compare_packed(const char *lhs, uint32_t lhs_len,
+		       const char *rhs, uint32_t rhs_len, int *result);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
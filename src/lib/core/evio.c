@@ -57,6 +57,12 @@ struct evio_service_entry {
 	struct ev_io ev;
 	/** Pointer to the root evio_service, which contains this object */
 	struct evio_service *service;
+	/**
+	 * Set if the acceptor socket is borrowed from another service,
+	 * see evio_service_start_reuseport(). Such a socket isn't closed
+	 * on stop.
+	 */
+	bool is_shared;
 };
 
 static int
@@ -121,6 +127,19 @@ evio_setsockopt_client(int fd, int family, int type)
 	return 0;
 }
 
+int
+evio_setsockopt_busy_poll(int fd, int usec)
+{
+#ifdef SO_BUSY_POLL
+	return sio_setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL,
+			      &usec, sizeof(usec));
+#else
+	(void)fd;
+	(void)usec;
+	return 0;
+#endif
+}
+
 int
 evio_setsockopt_server(int fd, int family, int type)
 {
@@ -239,7 +258,7 @@ evio_service_entry_reuse_addr(const struct uri *u)
  * Throws an exception if error.
  */
 static int
-evio_service_entry_bind_addr(struct evio_service_entry *entry)
+evio_service_entry_bind_addr(struct evio_service_entry *entry, bool reuseport)
 {
 	say_debug("%s: binding to %s...",
 		  evio_service_name(entry->service),
@@ -254,6 +273,12 @@ evio_service_entry_bind_addr(struct evio_service_entry *entry)
 				   SOCK_STREAM) != 0)
 		goto error;
 
+	int on = 1;
+	if (reuseport && entry->addr.sa_family != AF_UNIX &&
+	    sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+			   &on, sizeof(on)) != 0)
+		goto error;
+
 	if (sio_bind(fd, &entry->addr, entry->addr_len) != 0)
 		goto error;
 
@@ -312,6 +337,7 @@ evio_service_entry_create(struct evio_service_entry *entry,
 	ev_io_set(&entry->ev, -1, 0);
 	entry->ev.data = entry;
 	entry->service = service;
+	entry->is_shared = false;
 }
 
 /**
@@ -335,7 +361,7 @@ evio_service_entry_bind(struct evio_service_entry *entry, const struct uri *u)
 		entry->addr_len = sizeof(*un);
 		strlcpy(un->sun_path, u->service, sizeof(un->sun_path));
 		un->sun_family = AF_UNIX;
-		return evio_service_entry_bind_addr(entry);
+		return evio_service_entry_bind_addr(entry, false);
 	}
 
 	/* IP socket */
@@ -354,7 +380,8 @@ evio_service_entry_bind(struct evio_service_entry *entry, const struct uri *u)
 	for (struct addrinfo *ai = res; ai != NULL; ai = ai->ai_next) {
 		memcpy(&entry->addr, ai->ai_addr, ai->ai_addrlen);
 		entry->addr_len = ai->ai_addrlen;
-		if (evio_service_entry_bind_addr(entry) == 0) {
+		if (evio_service_entry_bind_addr(entry,
+						 entry->service->reuseport) == 0) {
 			freeaddrinfo(res);
 			return 0;
 		}
@@ -386,8 +413,9 @@ static void
 evio_service_entry_stop(struct evio_service_entry *entry)
 {
 	int service_fd = entry->ev.fd;
+	bool is_shared = entry->is_shared;
 	evio_service_entry_detach(entry);
-	if (service_fd < 0)
+	if (service_fd < 0 || is_shared)
 		return;
 
 	if (close(service_fd) < 0)
@@ -416,6 +444,32 @@ evio_service_entry_attach(struct evio_service_entry *dst,
 	ev_io_start(dst->service->loop, &dst->ev);
 }
 
+/**
+ * Binds a new socket with SO_REUSEPORT to the address of @a src and
+ * starts listening on it. A UNIX socket is shared with @a src instead.
+ */
+static int
+evio_service_entry_start_reuseport(struct evio_service_entry *dst,
+				   const struct evio_service_entry *src)
+{
+	assert(!ev_is_active(&dst->ev));
+	uri_destroy(&dst->uri);
+	uri_copy(&dst->uri, &src->uri);
+	dst->addrstorage = src->addrstorage;
+	dst->addr_len = src->addr_len;
+	iostream_ctx_copy(&dst->io_ctx, &src->io_ctx);
+	if (src->addr.sa_family == AF_UNIX) {
+		dst->is_shared = true;
+		ev_io_set(&dst->ev, src->ev.fd, EV_READ);
+		if (dst->service->on_accept != NULL)
+			ev_io_start(dst->service->loop, &dst->ev);
+		return 0;
+	}
+	if (evio_service_entry_bind_addr(dst, true) != 0)
+		return -1;
+	return evio_service_entry_listen(dst);
+}
+
 /** Recreate the IO stream contexts from the service entry URI. */
 static int
 evio_service_entry_reload_uri(struct evio_service_entry *entry)
@@ -546,6 +600,21 @@ evio_service_start(struct evio_service *service, const struct uri_set *uri_set)
 	return 0;
 }
 
+int
+evio_service_start_reuseport(struct evio_service *dst,
+			     const struct evio_service *src)
+{
+	assert(dst->entry_count == 0);
+	assert(dst->reuseport && src->reuseport);
+	evio_service_create_entries(dst, src->entry_count);
+	for (int i = 0; i < src->entry_count; i++) {
+		if (evio_service_entry_start_reuseport(&dst->entries[i],
+						       &src->entries[i]) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 int
 evio_service_reload_uris(struct evio_service *service)
 {
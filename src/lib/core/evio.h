@@ -88,6 +88,12 @@ struct evio_service {
         evio_accept_f on_accept;
         void *on_accept_param;
         ev_loop *loop;
+        /**
+         * If set, TCP sockets are bound with SO_REUSEPORT so that
+         * other services can bind separate sockets to the same
+         * addresses, see evio_service_start_reuseport().
+         */
+        bool reuseport;
 };
 
 /**
@@ -127,6 +133,17 @@ evio_service_stop(struct evio_service *service);
 void
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
 
+/**
+ * Binds @a dst to the addresses @a src is bound to and starts listening
+ * on them. Both services must have the reuseport flag set. Each TCP
+ * address gets its own socket so that the kernel balances incoming
+ * connections between the services. UNIX sockets can't be bound twice
+ * so they are shared with @a src and aren't closed on stop.
+ */
+int
+evio_service_start_reuseport(struct evio_service *dst,
+			     const struct evio_service *src);
+
 /**
  * Reload service URIs.
  *
@@ -159,6 +176,14 @@ evio_timeout_update(ev_loop *loop, ev_tstamp *start, ev_tstamp *delay)
 int
 evio_setsockopt_client(int fd, int family, int type);
 
+/**
+ * Set SO_BUSY_POLL so that the kernel busy-polls the device queue
+ * for up to @a usec microseconds before sleeping on a blocking read
+ * or poll of the socket. A no-op if the option isn't supported.
+ */
+int
+evio_setsockopt_busy_poll(int fd, int usec);
+
 /** Set options for server sockets. */
 int
 evio_setsockopt_server(int fd, int family, int type);
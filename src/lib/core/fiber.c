@@ -33,6 +33,7 @@
 #include <trivia/config.h>
 #include <trivia/util.h>
 #include <errno.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -44,8 +45,11 @@
 #include "trigger.h"
 #include "errinj.h"
 #include "clock.h"
+#include "clock_fast.h"
 #include "tt_sigaction.h"
 #include "tt_static.h"
+#include "tweaks.h"
+#include "trivia/usdt.h"
 
 extern void cord_on_yield(void);
 
@@ -104,7 +108,7 @@ clock_stat_reset(struct clock_stat *stat)
 static void
 cpu_stat_start(struct cpu_stat *stat)
 {
-	stat->prev_clock = clock_monotonic64();
+	stat->prev_clock = clock_fast_ns();
 	/*
 	 * We want to measure thread cpu time here to calculate
 	 * each fiber's cpu time, so don't use libev's ev_now() or
@@ -123,7 +127,7 @@ cpu_stat_reset(struct cpu_stat *stat)
 static uint64_t
 cpu_stat_on_csw(struct cpu_stat *stat)
 {
-	uint64_t delta, clock = clock_monotonic64();
+	uint64_t delta, clock = clock_fast_ns();
 	/*
 	 * Just in case. On Linux CLOCK_MONOTONIC guarantee that the
 	 * time returned by consecutive calls to clock_gettime will not
@@ -321,7 +325,7 @@ struct cord_on_exit {
 static const struct cord_on_exit cord_on_exit_sentinel = { NULL, NULL };
 #define CORD_ON_EXIT_WONT_RUN (&cord_on_exit_sentinel)
 
-static struct cord main_cord;
+struct cord main_cord;
 __thread struct cord *cord_ptr = NULL;
 pthread_t main_thread_id;
 
@@ -339,6 +343,13 @@ enum {
 	FIBER_STACK_SIZE_WATERMARK = 65536,
 };
 
+/**
+ * Max number of dead fibers with custom stack size cached in each
+ * cord for reuse. Zero disables the cache.
+ */
+static uint64_t fiber_stack_cache_max = 16;
+TWEAK_UINT(fiber_stack_cache_max);
+
 /** Default fiber attributes */
 static const struct fiber_attr fiber_attr_default = {
        .stack_size = FIBER_STACK_SIZE_DEFAULT,
@@ -473,7 +484,10 @@ cord_reset_slice(struct fiber *f)
 static bool
 fiber_is_reusable(uint32_t fiber_flags)
 {
-	/* For now we can not reuse fibers with custom stack size. */
+	/*
+	 * Fibers with custom stack size are reused only if the stack
+	 * size matches, see cord_stack_cache_get().
+	 */
 	return (fiber_flags & FIBER_CUSTOM_STACK) == 0;
 }
 
@@ -508,6 +522,7 @@ fiber_call_impl(struct fiber *callee)
 	if (cord_is_main())
 		cord_reset_slice(callee);
 
+	USDT(fiber_switch, caller->fid, callee->fid);
 	ASAN_START_SWITCH_FIBER(asan_state, 1,
 				callee->stack,
 				callee->stack_size);
@@ -851,6 +866,7 @@ fiber_yield_impl(MAYBE_UNUSED bool will_switch_back)
 	cord->fiber = callee;
 	callee->flags = (callee->flags & ~FIBER_IS_READY) | FIBER_IS_RUNNING;
 
+	USDT(fiber_switch, caller->fid, callee->fid);
 	ASAN_START_SWITCH_FIBER(asan_state, will_switch_back, callee->stack,
 				callee->stack_size);
 	coro_transfer(&caller->ctx, &callee->ctx);
@@ -1028,6 +1044,43 @@ fiber_self(void)
 	return fiber();
 }
 
+/**
+ * Put a dead fiber with custom stack size to the cache for reuse.
+ * Returns false if the cache is full.
+ */
+static bool
+cord_stack_cache_put(struct cord *cord, struct fiber *fiber)
+{
+	struct fiber_stack_cache_stat *stat = &cord->stack_cache_stat;
+	if ((uint64_t)stat->count >= fiber_stack_cache_max)
+		return false;
+	rlist_move_entry(&cord->dead_custom_stack, fiber, link);
+	stat->count++;
+	stat->size += fiber->stack_size;
+	return true;
+}
+
+/**
+ * Take a dead fiber with the given custom stack size from the
+ * cache. Returns NULL if there's no such fiber.
+ */
+static struct fiber *
+cord_stack_cache_get(struct cord *cord, size_t stack_size)
+{
+	struct fiber_stack_cache_stat *stat = &cord->stack_cache_stat;
+	struct fiber *fiber;
+	rlist_foreach_entry(fiber, &cord->dead_custom_stack, link) {
+		if (fiber->stack_attr_size == stack_size) {
+			stat->count--;
+			stat->size -= fiber->stack_size;
+			stat->hits++;
+			return fiber;
+		}
+	}
+	stat->misses++;
+	return NULL;
+}
+
 /** Common part of fiber_new() and fiber_recycle(). */
 static void
 fiber_reset(struct fiber *fiber)
@@ -1065,7 +1118,7 @@ fiber_recycle(struct fiber *fiber)
 	region_free(&fiber->gc);
 	if (fiber_is_reusable(fiber->flags)) {
 		rlist_move_entry(&cord()->dead, fiber, link);
-	} else {
+	} else if (!cord_stack_cache_put(cord(), fiber)) {
 		cord_add_garbage(cord(), fiber);
 	}
 }
@@ -1350,11 +1403,17 @@ fiber_stack_recycle(struct fiber *fiber)
 	}
 
 	/*
-	 * Ignore errors on MADV_DONTNEED because this is
-	 * just a hint for OS and not critical for
-	 * functionality.
+	 * Ignore errors on madvise because this is just a hint
+	 * for OS and not critical for functionality. MADV_FREE
+	 * lets the kernel reclaim the pages only under memory
+	 * pressure, so the next fiber using the stack doesn't
+	 * page-fault unless the memory was actually reclaimed.
+	 * It may be unsupported by the kernel though.
 	 */
-	fiber_madvise_unaligned(start, end, MADV_DONTNEED);
+#ifdef HAVE_MADV_FREE
+	if (fiber_madvise_unaligned(start, end, MADV_FREE) != 0)
+#endif
+		fiber_madvise_unaligned(start, end, MADV_DONTNEED);
 	stack_put_watermark(fiber->stack_watermark);
 }
 
@@ -1367,8 +1426,9 @@ fiber_stack_watermark_create(struct fiber *fiber,
 {
 	assert(fiber->stack_watermark == NULL);
 
-	/* No tracking on custom stacks for simplicity. */
-	if (fiber_attr->flags & FIBER_CUSTOM_STACK)
+	(void)fiber_attr;
+	/* A stack must be larger than the watermark to track it. */
+	if (fiber->stack_size <= FIBER_STACK_SIZE_WATERMARK)
 		return;
 
 	/*
@@ -1550,8 +1610,14 @@ fiber_new_ex(const char *name, const struct fiber_attr *fiber_attr,
 		return NULL;
 	}
 
-	if (fiber_is_reusable(fiber_attr->flags) && !rlist_empty(&cord->dead)) {
-		fiber = rlist_first_entry(&cord->dead, struct fiber, link);
+	if (fiber_is_reusable(fiber_attr->flags)) {
+		if (!rlist_empty(&cord->dead))
+			fiber = rlist_first_entry(&cord->dead, struct fiber,
+						  link);
+	} else {
+		fiber = cord_stack_cache_get(cord, fiber_attr->stack_size);
+	}
+	if (fiber != NULL) {
 		rlist_move_entry(&cord->alive, fiber, link);
 		assert(fiber_is_dead(fiber));
 	} else {
@@ -1570,6 +1636,7 @@ fiber_new_ex(const char *name, const struct fiber_attr *fiber_attr,
 			mempool_free(&cord->fiber_mempool, fiber);
 			return NULL;
 		}
+		fiber->stack_attr_size = fiber_attr->stack_size;
 		coro_create(&fiber->ctx, fiber_loop, NULL,
 			    fiber->stack, fiber->stack_size);
 
@@ -1681,6 +1748,8 @@ fiber_delete_all(struct cord *cord)
 	cord_collect_garbage(cord);
 	cord_delete_fibers_in_list(cord, &cord->alive);
 	cord_delete_fibers_in_list(cord, &cord->dead);
+	cord_delete_fibers_in_list(cord, &cord->dead_custom_stack);
+	memset(&cord->stack_cache_stat, 0, sizeof(cord->stack_cache_stat));
 	cord_delete_fibers_in_list(cord, &cord->ready);
 }
 
@@ -1841,6 +1910,8 @@ cord_create(struct cord *cord, const char *name)
 	rlist_create(&cord->alive);
 	rlist_create(&cord->ready);
 	rlist_create(&cord->dead);
+	rlist_create(&cord->dead_custom_stack);
+	memset(&cord->stack_cache_stat, 0, sizeof(cord->stack_cache_stat));
 	cord->garbage = NULL;
 	cord->fiber_registry = mh_i64ptr_new();
 
@@ -2228,12 +2299,102 @@ cord_set_name(const char *name)
 	tt_pthread_setname(name);
 }
 
-bool
-cord_is_main(void)
+#ifdef __linux__
+
+/** Parses a CPU list, see cord_set_cpu_affinity(). */
+static int
+cpu_list_parse(const char *cpu_list, cpu_set_t *set)
+{
+	CPU_ZERO(set);
+	const char *p = cpu_list;
+	while (true) {
+		char *end;
+		long first = strtol(p, &end, 10);
+		if (end == p || first < 0 || first >= CPU_SETSIZE)
+			goto error;
+		long last = first;
+		p = end;
+		if (*p == '-') {
+			p++;
+			last = strtol(p, &end, 10);
+			if (end == p || last < first || last >= CPU_SETSIZE)
+				goto error;
+			p = end;
+		}
+		for (long cpu = first; cpu <= last; cpu++)
+			CPU_SET(cpu, set);
+		if (*p == '\0')
+			return 0;
+		if (*p != ',')
+			goto error;
+		p++;
+	}
+error:
+	diag_set(IllegalParams, "invalid CPU list '%s'", cpu_list);
+	return -1;
+}
+
+int
+cpu_list_check(const char *cpu_list)
+{
+	cpu_set_t set;
+	return cpu_list_parse(cpu_list, &set);
+}
+
+int
+cord_set_cpu_affinity(struct cord *cord, const char *cpu_list)
+{
+	/*
+	 * The affinity the process was started with, e.g. by taskset.
+	 * All calls are made from the main thread so it's the affinity
+	 * of the main thread before the first call.
+	 */
+	static cpu_set_t initial_set;
+	static bool initial_set_saved;
+	if (!initial_set_saved) {
+		if (sched_getaffinity(0, sizeof(initial_set),
+				      &initial_set) != 0) {
+			diag_set(SystemError, "failed to get CPU affinity");
+			return -1;
+		}
+		initial_set_saved = true;
+	}
+	cpu_set_t set;
+	if (cpu_list == NULL)
+		set = initial_set;
+	else if (cpu_list_parse(cpu_list, &set) != 0)
+		return -1;
+	int rc = pthread_setaffinity_np(cord->id, sizeof(set), &set);
+	if (rc != 0) {
+		errno = rc;
+		diag_set(SystemError, "failed to set CPU affinity of "
+			 "thread '%s'", cord_name(cord));
+		return -1;
+	}
+	return 0;
+}
+
+#else /* !defined(__linux__) */
+
+int
+cpu_list_check(const char *cpu_list)
 {
-	return cord() == &main_cord;
+	(void)cpu_list;
+	diag_set(IllegalParams, "CPU affinity is not supported");
+	return -1;
 }
 
+int
+cord_set_cpu_affinity(struct cord *cord, const char *cpu_list)
+{
+	(void)cord;
+	if (cpu_list == NULL)
+		return 0;
+	return cpu_list_check(cpu_list);
+}
+
+#endif /* !defined(__linux__) */
+
 static NOINLINE int
 check_stack_direction(void *prev_stack_frame)
 {
@@ -2252,6 +2413,7 @@ fiber_init(int (*invoke)(fiber_func f, va_list ap))
 		panic("can't init event loop");
 	cord_create(&main_cord, "main");
 	fiber_signal_init();
+	clock_fast_init();
 }
 
 void
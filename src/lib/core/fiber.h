@@ -635,6 +635,12 @@ struct fiber {
 #endif
 	/** Coro stack size. */
 	size_t stack_size;
+	/**
+	 * Stack size requested with the fiber attributes. A dead
+	 * fiber with a custom stack size is reused only for a new
+	 * fiber requesting the same stack size.
+	 */
+	size_t stack_attr_size;
 	/** Fiber's custom slice if fiber has it, zero otherwise. */
 	struct fiber_slice max_slice;
 	/** Valgrind stack id. */
@@ -739,10 +745,21 @@ struct fiber {
 			int storage_ref;
 		} lua;
 		/**
-		 * Iproto sync.
+		 * Id of the stored function executed by the fiber or 0.
+		 * Used for attribution by the CPU profiler.
 		 */
+		uint32_t func_id;
+		/** State of the iproto request handled by the fiber. */
 		struct {
+			/** Iproto sync. */
 			uint64_t sync;
+			/** Iproto request type or 0. */
+			uint32_t type;
+			/**
+			 * Time spent by the request waiting for WAL
+			 * writes, in seconds.
+			 */
+			double wal_wait;
 		} net;
 	} storage;
 	/** An object to wait for incoming message or a reader. */
@@ -772,6 +789,18 @@ struct cord_on_exit;
  * thread. Each cord consists of fibers to implement cooperative multitasking
  * model.
  */
+/** Statistics of the cache of fibers with custom stack size. */
+struct fiber_stack_cache_stat {
+	/** Number of cached fibers. */
+	int64_t count;
+	/** Total size of cached stacks, in bytes. */
+	int64_t size;
+	/** Number of fibers created by reusing a cached one. */
+	int64_t hits;
+	/** Number of fibers with custom stack size allocated anew. */
+	int64_t misses;
+};
+
 struct cord {
 	/** The fiber that is currently being executed. */
 	struct fiber *fiber;
@@ -793,6 +822,15 @@ struct cord {
 	struct rlist ready;
 	/** A cache of dead fibers for reuse */
 	struct rlist dead;
+	/**
+	 * A cache of dead fibers with custom stack size for reuse,
+	 * most recently used first. Saves the stack allocation and
+	 * guard page setup syscalls when fibers with the same custom
+	 * stack size are created in a loop.
+	 */
+	struct rlist dead_custom_stack;
+	/** Statistics of the dead_custom_stack cache. */
+	struct fiber_stack_cache_stat stack_cache_stat;
 	/**
 	 * Latest dead fiber which couldn't be reused and waits for its
 	 * deletion. A fiber can't be reused if it is somehow non-standard. For
@@ -955,9 +993,36 @@ cord_name(struct cord *cord)
 	return cord->name;
 }
 
-/** True if this cord represents the process main thread. */
-bool
-cord_is_main(void);
+/** The cord of the process main thread. */
+extern struct cord main_cord;
+
+/**
+ * True if this cord represents the process main thread. Inline, because
+ * it is called on each access to an indexed field by a JSON path.
+ */
+static inline bool
+cord_is_main(void)
+{
+	return cord() == &main_cord;
+}
+
+/**
+ * Pins the thread of @a cord to the CPUs from @a cpu_list, which is
+ * a comma-separated list of CPU numbers and ranges, e.g. "0-3,8".
+ * If @a cpu_list is NULL, restores the CPU affinity the process had
+ * before the first call. Supported only on Linux.
+ *
+ * Returns -1 and sets diag on error.
+ */
+int
+cord_set_cpu_affinity(struct cord *cord, const char *cpu_list);
+
+/**
+ * Checks that @a cpu_list is a valid argument for
+ * cord_set_cpu_affinity(). Returns -1 and sets diag if it isn't.
+ */
+int
+cpu_list_check(const char *cpu_list);
 
 /**
  * Delete the latest garbage fiber which couldn't be deleted somewhy before. Can
@@ -29,6 +29,141 @@
  * SUCH DAMAGE.
  */
 #include "fiber_pool.h"
+
+#include <string.h>
+
+#include "bit/bit.h"
+#include "clock_fast.h"
+#include "tweaks.h"
+
+/**
+ * If set, the pool size limit is tuned between
+ * FIBER_POOL_ADAPTIVE_MIN_SIZE and the size limit set with
+ * fiber_pool_set_max_size() to minimize the message latency.
+ */
+static bool fiber_pool_adaptive = false;
+TWEAK_BOOL(fiber_pool_adaptive);
+
+/** Update a latency histogram with a new observation, in seconds. */
+static void
+fiber_pool_latency_collect(struct fiber_pool_latency *latency, double value)
+{
+	uint64_t usec = value > 0 ? (uint64_t)(value * 1e6) : 0;
+	int bucket = usec == 0 ? 0 : 64 - bit_clz_u64(usec);
+	if (bucket >= FIBER_POOL_LATENCY_BUCKETS)
+		bucket = FIBER_POOL_LATENCY_BUCKETS - 1;
+	latency->buckets[bucket]++;
+	latency->count++;
+}
+
+double
+fiber_pool_latency_get(const struct fiber_pool_latency *latency, int pct)
+{
+	if (latency->count == 0)
+		return 0;
+	int64_t rank = (latency->count * pct + 99) / 100;
+	int64_t count = 0;
+	int bucket = 0;
+	for (; bucket < FIBER_POOL_LATENCY_BUCKETS - 1; bucket++) {
+		count += latency->buckets[bucket];
+		if (count >= rank)
+			break;
+	}
+	/* Report the upper bound of the bucket. */
+	return (double)((uint64_t)1 << bucket) / 1e6;
+}
+
+/**
+ * Stage messages fetched from the endpoint for fibers to work on
+ * and remember when they were fetched.
+ */
+static void
+fiber_pool_stage(struct fiber_pool *pool, struct stailq *fetched)
+{
+	int count = 0;
+	struct stailq_entry *entry;
+	stailq_foreach(entry, fetched)
+		count++;
+	if (count == 0)
+		return;
+	stailq_concat(&pool->output, fetched);
+	if (pool->batch_count == FIBER_POOL_BATCH_MAX) {
+		/*
+		 * The ring is full, account the messages to the
+		 * last batch, overestimating their wait time.
+		 */
+		int last = (pool->batch_first + pool->batch_count - 1) %
+			   FIBER_POOL_BATCH_MAX;
+		pool->batches[last].count += count;
+		return;
+	}
+	int i = (pool->batch_first + pool->batch_count) % FIBER_POOL_BATCH_MAX;
+	pool->batches[i].fetched_at = clock_fast();
+	pool->batches[i].count = count;
+	pool->batch_count++;
+}
+
+/**
+ * Account a message taken by a fiber from the staged messages at
+ * the given time and return how long it was staged.
+ */
+static double
+fiber_pool_unstage(struct fiber_pool *pool, double now)
+{
+	assert(pool->batch_count > 0);
+	struct fiber_pool_batch *batch = &pool->batches[pool->batch_first];
+	double queue_time = now - batch->fetched_at;
+	if (--batch->count == 0) {
+		pool->batch_first = (pool->batch_first + 1) %
+				    FIBER_POOL_BATCH_MAX;
+		pool->batch_count--;
+	}
+	return queue_time;
+}
+
+/**
+ * Tune the pool size limit using the message latency in the last
+ * stat period. The limit is changed in steps in one direction
+ * while it doesn't make the 99th percentile of the latency worse,
+ * otherwise the direction is reversed.
+ */
+static void
+fiber_pool_adapt(struct fiber_pool *pool)
+{
+	if (!fiber_pool_adaptive) {
+		pool->max_size = pool->size_limit;
+		return;
+	}
+	/* Nothing to tune on without load. */
+	if (pool->last_service_time.count == 0)
+		return;
+	double p99 = fiber_pool_latency_get(&pool->last_queue_time, 99) +
+		     fiber_pool_latency_get(&pool->last_service_time, 99);
+	/* Tolerate small fluctuations of the latency. */
+	if (pool->adapt_last_p99 > 0 && p99 > pool->adapt_last_p99 * 1.1)
+		pool->adapt_direction = -pool->adapt_direction;
+	pool->adapt_last_p99 = p99;
+	/* More fibers don't help if no message waited for a fiber. */
+	if (pool->adapt_direction > 0 && !pool->is_saturated)
+		return;
+	int min_size = MIN(FIBER_POOL_ADAPTIVE_MIN_SIZE, pool->size_limit);
+	int step = MAX(pool->max_size / 8, 1);
+	int max_size = pool->max_size + pool->adapt_direction * step;
+	pool->max_size = MAX(MIN(max_size, pool->size_limit), min_size);
+}
+
+/** Start a new stat period. */
+static void
+fiber_pool_rotate_stat(struct fiber_pool *pool)
+{
+	pool->last_queue_time = pool->queue_time;
+	pool->last_service_time = pool->service_time;
+	memset(&pool->queue_time, 0, sizeof(pool->queue_time));
+	memset(&pool->service_time, 0, sizeof(pool->service_time));
+	fiber_pool_adapt(pool);
+	pool->is_saturated = false;
+}
+
 /**
  * Main function of the fiber invoked to handle all outstanding
  * tasks in a queue.
@@ -48,6 +183,9 @@ fiber_pool_f(va_list ap)
 	msg = NULL;
 	while (!stailq_empty(output) && !fiber_is_cancelled()) {
 		 msg = stailq_shift_entry(output, struct cmsg, fifo);
+		double start = clock_fast();
+		fiber_pool_latency_collect(&pool->queue_time,
+					   fiber_pool_unstage(pool, start));
 
 		if (f->caller == &cord->sched && ! stailq_empty(output) &&
 		    ! rlist_empty(&pool->idle)) {
@@ -64,6 +202,8 @@ fiber_pool_f(va_list ap)
 		fiber_set_system(fiber(), false);
 		cmsg_deliver(msg);
 		fiber_set_system(fiber(), true);
+		fiber_pool_latency_collect(&pool->service_time,
+					   clock_fast() - start);
 		fiber_check_gc();
 		/*
 		 * Normally fibers die after their function
@@ -76,8 +216,12 @@ fiber_pool_f(va_list ap)
 		 */
 		fiber_on_stop(f);
 	}
-	/** Put the current fiber into a fiber cache. */
-	if (!fiber_is_cancelled() && (msg != NULL ||
+	/*
+	 * Put the current fiber into a fiber cache unless the pool
+	 * size limit was lowered.
+	 */
+	if (!fiber_is_cancelled() && pool->size <= pool->max_size &&
+	    (msg != NULL ||
 	    ev_monotonic_now(loop) - last_active_at < pool->idle_timeout)) {
 		if (msg != NULL)
 			last_active_at = ev_monotonic_now(loop);
@@ -113,6 +257,7 @@ fiber_pool_idle_cb(ev_loop *loop, struct ev_timer *watcher, int events)
 		f = rlist_shift_tail_entry(&pool->idle, struct fiber, state);
 		fiber_call(f);
 	}
+	fiber_pool_rotate_stat(pool);
 	ev_timer_again(loop, watcher);
 }
 
@@ -124,7 +269,10 @@ fiber_pool_cb(ev_loop *loop, struct ev_watcher *watcher, int events)
 	(void) events;
 	struct fiber_pool *pool = (struct fiber_pool *) watcher->data;
 	/** Fetch messages */
-	cbus_endpoint_fetch(&pool->endpoint, &pool->output);
+	struct stailq fetched;
+	stailq_create(&fetched);
+	cbus_endpoint_fetch(&pool->endpoint, &fetched);
+	fiber_pool_stage(pool, &fetched);
 
 	struct stailq *output = &pool->output;
 	while (! stailq_empty(output)) {
@@ -154,9 +302,15 @@ fiber_pool_cb(ev_loop *loop, struct ev_watcher *watcher, int events)
 			 * No worries that this watcher may not
 			 * get scheduled again - there are enough
 			 * worker fibers already, so just leave.
+			 * Don't warn if the limit was lowered
+			 * by the adaptive sizing.
 			 */
-			say_warn("fiber pool size %d reached on endpoint %s",
-				 pool->max_size, pool->endpoint.name);
+			pool->is_saturated = true;
+			if (pool->max_size == pool->size_limit) {
+				say_warn("fiber pool size %d reached on "
+					 "endpoint %s", pool->max_size,
+					 pool->endpoint.name);
+			}
 			break;
 		}
 	}
@@ -165,7 +319,9 @@ fiber_pool_cb(ev_loop *loop, struct ev_watcher *watcher, int events)
 void
 fiber_pool_set_max_size(struct fiber_pool *pool, int new_max_size)
 {
-	pool->max_size = new_max_size;
+	pool->size_limit = new_max_size;
+	if (!fiber_pool_adaptive || pool->max_size > new_max_size)
+		pool->max_size = new_max_size;
 }
 
 void
@@ -181,8 +337,18 @@ fiber_pool_create(struct fiber_pool *pool, const char *name, int max_pool_size,
 	ev_timer_again(loop(), &pool->idle_timer);
 	pool->size = 0;
 	pool->max_size = max_pool_size;
+	pool->size_limit = max_pool_size;
 	stailq_create(&pool->output);
 	fiber_cond_create(&pool->worker_cond);
+	pool->batch_first = 0;
+	pool->batch_count = 0;
+	pool->is_saturated = false;
+	memset(&pool->queue_time, 0, sizeof(pool->queue_time));
+	memset(&pool->service_time, 0, sizeof(pool->service_time));
+	memset(&pool->last_queue_time, 0, sizeof(pool->last_queue_time));
+	memset(&pool->last_service_time, 0, sizeof(pool->last_service_time));
+	pool->adapt_direction = -1;
+	pool->adapt_last_p99 = 0;
 	/* Join fiber pool to cbus */
 	cbus_endpoint_create(&pool->endpoint, name, fiber_pool_cb, pool);
 }
@@ -44,6 +44,38 @@ extern "C" {
 /** Period after which an idle fiber in the pool is shut down. */
 enum { FIBER_POOL_IDLE_TIMEOUT = 1 };
 
+enum {
+	/** Number of buckets in a fiber pool latency histogram. */
+	FIBER_POOL_LATENCY_BUCKETS = 32,
+	/**
+	 * Max number of batches of staged messages the fetch time
+	 * is tracked for.
+	 */
+	FIBER_POOL_BATCH_MAX = 64,
+	/** The lower bound of the pool size when it's adaptive. */
+	FIBER_POOL_ADAPTIVE_MIN_SIZE = 16,
+};
+
+/**
+ * Histogram of latency observations. The bucket i > 0 counts
+ * observations from 2^(i-1) to 2^i microseconds, the bucket 0
+ * counts observations shorter than a microsecond.
+ */
+struct fiber_pool_latency {
+	/** Total number of observations. */
+	int64_t count;
+	/** Number of observations by bucket. */
+	int64_t buckets[FIBER_POOL_LATENCY_BUCKETS];
+};
+
+/** Fetch time of a batch of messages staged for fibers. */
+struct fiber_pool_batch {
+	/** Time when the messages were fetched from the endpoint. */
+	double fetched_at;
+	/** Number of the messages which are still staged. */
+	int count;
+};
+
 /**
  * A pool of worker fibers to handle messages,
  * so that each message is handled in its own fiber.
@@ -56,6 +88,12 @@ struct fiber_pool {
 		int size;
 		/** The limit on the number of fibers working on tasks. */
 		int max_size;
+		/**
+		 * The upper bound of max_size set with
+		 * fiber_pool_set_max_size(). The actual limit
+		 * may be lower if the pool size is adaptive.
+		 */
+		int size_limit;
 		/**
 		 * Fibers in leave the pool if they have nothing to do
 		 * for longer than this.
@@ -67,6 +105,42 @@ struct fiber_pool {
 		struct ev_timer idle_timer;
 		/** Condition for worker exit signaling */
 		struct fiber_cond worker_cond;
+		/**
+		 * Ring of batches of staged messages, in the order
+		 * they were fetched, used to find out how long the
+		 * messages wait for a fiber.
+		 */
+		struct fiber_pool_batch batches[FIBER_POOL_BATCH_MAX];
+		/** Index of the oldest batch in the ring. */
+		int batch_first;
+		/** Number of batches in the ring. */
+		int batch_count;
+		/**
+		 * Set if messages had to wait for a fiber, because
+		 * the pool size limit was reached, in the current
+		 * stat period.
+		 */
+		bool is_saturated;
+		/**
+		 * Time the messages waited for a fiber and time
+		 * of handling them in the current stat period.
+		 * The stat period is the idle timeout.
+		 */
+		struct fiber_pool_latency queue_time;
+		struct fiber_pool_latency service_time;
+		/** Same as above, for the last complete stat period. */
+		struct fiber_pool_latency last_queue_time;
+		struct fiber_pool_latency last_service_time;
+		/**
+		 * Direction (1 or -1) in which the adaptive pool
+		 * size is changed.
+		 */
+		int adapt_direction;
+		/**
+		 * 99th percentile of the message latency in the
+		 * last stat period the pool size was adapted on.
+		 */
+		double adapt_last_p99;
 	};
 	struct {
 		/** The consumer thread loop. */
@@ -92,6 +166,13 @@ fiber_pool_create(struct fiber_pool *pool, const char *name, int max_pool_size,
 void
 fiber_pool_set_max_size(struct fiber_pool *pool, int new_max_size);
 
+/**
+ * Get the pct-th percentile of latency observations, in seconds.
+ * Returns 0 if there are no observations.
+ */
+double
+fiber_pool_latency_get(const struct fiber_pool_latency *latency, int pct);
+
 /**
  * Destroy a fiber pool
  */
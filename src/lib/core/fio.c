@@ -156,25 +156,39 @@ ssize_t
 fio_writevn(int fd, struct iovec *iov, int iovcnt)
 {
 	assert(iov && iovcnt >= 0);
+	/*
+	 * Pass the caller's vector to writev(2) as is: local file
+	 * systems normally write all the data at once so there is
+	 * no need to copy the vector to a retry buffer beforehand.
+	 * The caller's vector isn't modified on partial write, so
+	 * the tail of a partially written buffer is written with
+	 * a separate call.
+	 */
 	ssize_t nwr = 0;
-	int iov_pos = 0;
-	struct fio_batch *batch = fio_batch_new();
-	while (iov_pos < iovcnt) {
-		int iov_to_batch = MIN(batch->max_iov, iovcnt - iov_pos);
-		memmove(batch->iov + batch->iovcnt, iov + iov_pos,
-			sizeof(struct iovec) * iov_to_batch);
-		fio_batch_add(batch, iov_to_batch);
-		iov_pos += iov_to_batch;
-		while (batch->iovcnt) {
-			ssize_t written = fio_batch_write(batch, fd);
-			if (written < 0) {
-				fio_batch_delete(batch);
+	while (iovcnt > 0) {
+		ssize_t written = fio_writev(fd, iov, MIN(iovcnt, IOV_MAX));
+		if (written < 0)
+			return -1;
+		nwr += written;
+		bool progress = false;
+		for (; iovcnt > 0 && (size_t)written >= iov->iov_len;
+		     ++iov, --iovcnt) {
+			written -= iov->iov_len;
+			progress = true;
+		}
+		if (written > 0) {
+			size_t tail = iov->iov_len - written;
+			if (fio_writen(fd, (char *)iov->iov_base + written,
+				       tail) < 0)
 				return -1;
-			}
-			nwr += written;
+			nwr += tail;
+			++iov;
+			--iovcnt;
+		} else if (!progress) {
+			/* Nothing was written, avoid spinning. */
+			return -1;
 		}
 	}
-	fio_batch_delete(batch);
 	return nwr;
 }
 
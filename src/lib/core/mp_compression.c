@@ -0,0 +1,230 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "mp_compression.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <zstd.h>
+
+#include "fiber.h"
+#include "msgpuck.h"
+#include "mp_extension_types.h"
+#include "small/region.h"
+#include "tt_pthread.h"
+
+enum {
+	/** zstd compression level, the same as used for xlog files. */
+	MP_COMPRESSION_ZSTD_LEVEL = 3,
+};
+
+/** zstd contexts of a thread, created on demand. */
+struct mp_compression_ctx {
+	/** Compression context. */
+	ZSTD_CCtx *cctx;
+	/** Decompression context. */
+	ZSTD_DCtx *dctx;
+};
+
+static pthread_once_t mp_compression_once = PTHREAD_ONCE_INIT;
+static pthread_key_t mp_compression_key;
+
+static void
+mp_compression_ctx_delete(void *arg)
+{
+	struct mp_compression_ctx *ctx = arg;
+	ZSTD_freeCCtx(ctx->cctx);
+	ZSTD_freeDCtx(ctx->dctx);
+	free(ctx);
+}
+
+static void
+mp_compression_key_create(void)
+{
+	tt_pthread_key_create(&mp_compression_key, mp_compression_ctx_delete);
+}
+
+/** Return zstd contexts of the current thread. */
+static struct mp_compression_ctx *
+mp_compression_ctx(void)
+{
+	tt_pthread_once(&mp_compression_once, mp_compression_key_create);
+	struct mp_compression_ctx *ctx =
+		tt_pthread_getspecific(mp_compression_key);
+	if (ctx == NULL) {
+		ctx = xcalloc(1, sizeof(*ctx));
+		tt_pthread_setspecific(mp_compression_key, ctx);
+	}
+	return ctx;
+}
+
+size_t
+mp_compress_bound(size_t src_size)
+{
+	uint32_t len = mp_sizeof_uint(compression_type_MAX) +
+		       mp_sizeof_uint(src_size) + ZSTD_compressBound(src_size);
+	return mp_sizeof_ext(len);
+}
+
+char *
+mp_compress(char *dst, const char *src, size_t src_size,
+	    enum compression_type type)
+{
+	assert(type == COMPRESSION_TYPE_ZSTD);
+	struct mp_compression_ctx *ctx = mp_compression_ctx();
+	if (ctx->cctx == NULL) {
+		ctx->cctx = ZSTD_createCCtx();
+		if (ctx->cctx == NULL)
+			return NULL;
+	}
+	size_t bound = ZSTD_compressBound(src_size);
+	uint32_t prefix_size = mp_sizeof_uint(type) + mp_sizeof_uint(src_size);
+	/*
+	 * The size of the extension header depends on the size of
+	 * the compressed data, so compress the data past the longest
+	 * possible header and move it after encoding the header.
+	 */
+	char *body = dst + mp_sizeof_extl(prefix_size + bound) + prefix_size;
+	size_t size = ZSTD_compressCCtx(ctx->cctx, body, bound, src, src_size,
+					MP_COMPRESSION_ZSTD_LEVEL);
+	if (ZSTD_isError(size))
+		return NULL;
+	char *pos = mp_encode_extl(dst, MP_COMPRESSION, prefix_size + size);
+	pos = mp_encode_uint(pos, type);
+	pos = mp_encode_uint(pos, src_size);
+	assert(pos <= body);
+	memmove(pos, body, size);
+	return pos + size;
+}
+
+/**
+ * Decode the prefix of the MP_COMPRESSION extension data of @a len
+ * bytes at @a data. On success advances @a data to the compressed
+ * bytes.
+ */
+static int
+mp_decode_compression_prefix(const char **data, uint32_t len,
+			     enum compression_type *type, size_t *raw_size)
+{
+	const char *end = *data + len;
+	if (mp_typeof(**data) != MP_UINT || mp_check_uint(*data, end) > 0)
+		return -1;
+	uint64_t value = mp_decode_uint(data);
+	if (value == COMPRESSION_TYPE_NONE || value >= compression_type_MAX)
+		return -1;
+	*type = value;
+	if (mp_typeof(**data) != MP_UINT || mp_check_uint(*data, end) > 0)
+		return -1;
+	value = mp_decode_uint(data);
+	if (value == 0 || value > SIZE_MAX)
+		return -1;
+	*raw_size = value;
+	return 0;
+}
+
+/**
+ * Decompress the MP_COMPRESSION extension data of @a len bytes at
+ * @a data to @a dst of @a dst_size bytes. Returns the size of the
+ * original MsgPack or 0 on error.
+ */
+static size_t
+mp_decompress_data(const char *data, uint32_t len, char *dst, size_t dst_size)
+{
+	const char *end = data + len;
+	enum compression_type type;
+	size_t raw_size;
+	if (mp_decode_compression_prefix(&data, len, &type, &raw_size) != 0)
+		return 0;
+	if (raw_size > dst_size)
+		return 0;
+	assert(type == COMPRESSION_TYPE_ZSTD);
+	struct mp_compression_ctx *ctx = mp_compression_ctx();
+	if (ctx->dctx == NULL) {
+		ctx->dctx = ZSTD_createDCtx();
+		if (ctx->dctx == NULL)
+			return 0;
+	}
+	size_t size = ZSTD_decompressDCtx(ctx->dctx, dst, raw_size, data,
+					  end - data);
+	if (ZSTD_isError(size) || size != raw_size)
+		return 0;
+	return size;
+}
+
+size_t
+mp_decompressed_size(const char *data)
+{
+	if (mp_typeof(*data) != MP_EXT)
+		return 0;
+	int8_t ext_type;
+	uint32_t len = mp_decode_extl(&data, &ext_type);
+	if (ext_type != MP_COMPRESSION)
+		return 0;
+	enum compression_type type;
+	size_t raw_size;
+	if (mp_decode_compression_prefix(&data, len, &type, &raw_size) != 0)
+		return 0;
+	return raw_size;
+}
+
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size)
+{
+	const char *data = *src;
+	if (mp_typeof(*data) != MP_EXT)
+		return 0;
+	int8_t ext_type;
+	uint32_t len = mp_decode_extl(&data, &ext_type);
+	if (ext_type != MP_COMPRESSION)
+		return 0;
+	size_t size = mp_decompress_data(data, len, dst, dst_size);
+	if (size == 0)
+		return 0;
+	*src = data + len;
+	return size;
+}
+
+/**
+ * Decompress the MP_COMPRESSION extension data of @a len bytes at
+ * @a data to the fiber region and advance @a data past it. Returns
+ * NULL if the data is malformed.
+ */
+static const char *
+mp_decompress_to_region(const char **data, uint32_t len)
+{
+	const char *ext = *data;
+	*data += len;
+	const char *pos = ext;
+	enum compression_type type;
+	size_t raw_size;
+	if (mp_decode_compression_prefix(&pos, len, &type, &raw_size) != 0)
+		return NULL;
+	char *raw = xregion_alloc(&fiber()->gc, raw_size);
+	if (mp_decompress_data(ext, len, raw, raw_size) == 0)
+		return NULL;
+	return raw;
+}
+
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	const char *raw = mp_decompress_to_region(data, len);
+	int rc = raw != NULL ? mp_snprint(buf, size, raw) : -1;
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	const char *raw = mp_decompress_to_region(data, len);
+	int rc = raw != NULL ? mp_fprint(file, raw) : -1;
+	region_truncate(region, region_svp);
+	return rc;
+}
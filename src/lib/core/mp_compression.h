@@ -20,48 +20,59 @@
 extern "C" {
 #endif
 
-static inline char *
+/*
+ * A compressed value is encoded as MP_EXT of type MP_COMPRESSION.
+ * The extension data is the compression type (MP_UINT), the size
+ * of the original MsgPack (MP_UINT) and the compressed bytes.
+ */
+
+/**
+ * Return the maximal size of an MP_COMPRESSION value encoding
+ * @a src_size bytes of MsgPack.
+ */
+size_t
+mp_compress_bound(size_t src_size);
+
+/**
+ * Compress @a src_size bytes of MsgPack at @a src with the given
+ * method and encode the result to @a dst as MP_COMPRESSION. The
+ * @a dst buffer must be at least mp_compress_bound(src_size)
+ * bytes long. Returns the end of the encoded value or NULL on
+ * compression error.
+ */
+char *
 mp_compress(char *dst, const char *src, size_t src_size,
-	    enum compression_type type)
-{
-        (void)dst;
-        (void)src;
-        (void)src_size;
-        (void)type;
-        unreachable();
-        return NULL;
-}
+	    enum compression_type type);
 
-static inline size_t
-mp_decompress(const char **src, char *dst, size_t dst_size)
-{
-        (void)src;
-        (void)dst;
-        (void)dst_size;
-        unreachable();
-        return 0;
-}
+/**
+ * Return the size of the original MsgPack of the MP_COMPRESSION
+ * value at @a data or 0 if the value is malformed.
+ */
+size_t
+mp_decompressed_size(const char *data);
 
-static inline int
-mp_snprint_compression(char *buf, int size, const char **data, uint32_t len)
-{
-        (void)buf;
-        (void)size;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/**
+ * Decompress the MP_COMPRESSION value at @a src to @a dst, which
+ * must be at least mp_decompressed_size() bytes long. On success
+ * advances @a src past the value and returns the size of the
+ * original MsgPack. Returns 0 if the value is malformed.
+ */
+size_t
+mp_decompress(const char **src, char *dst, size_t dst_size);
 
-static inline int
-mp_fprint_compression(FILE *file, const char **data, uint32_t len)
-{
-        (void)file;
-        (void)data;
-        (void)len;
-        unreachable();
-        return -1;
-}
+/**
+ * Print the original value of the MP_COMPRESSION extension data
+ * of @a len bytes at @a data to memory buffer.
+ */
+int
+mp_snprint_compression(char *buf, int size, const char **data, uint32_t len);
+
+/**
+ * Print the original value of the MP_COMPRESSION extension data
+ * of @a len bytes at @a data to file.
+ */
+int
+mp_fprint_compression(FILE *file, const char **data, uint32_t len);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -6,6 +6,8 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include "bit/bit.h"
 #include "datetime.h"
 
 #if defined(__cplusplus)
@@ -70,6 +72,28 @@ mp_validate_datetime(const char *data, uint32_t len)
 	return datetime_unpack(&data, len, &date) == NULL;
 }
 
+/**
+ * Compare two valid packed datetime values of the given lengths
+ * without unpacking them. The packed epoch is an integer, and the
+ * optional tail starts with nanoseconds.
+ * @sa datetime_compare
+ */
+static inline int
+datetime_compare_packed(const char *lhs, uint32_t lhs_len,
+			const char *rhs, uint32_t rhs_len)
+{
+	int64_t lhs_epoch = load_u64(lhs);
+	int64_t rhs_epoch = load_u64(rhs);
+	if (lhs_epoch != rhs_epoch)
+		return lhs_epoch < rhs_epoch ? -1 : 1;
+	int32_t lhs_nsec = 0, rhs_nsec = 0;
+	if (lhs_len > sizeof(lhs_epoch))
+		memcpy(&lhs_nsec, lhs + sizeof(lhs_epoch), sizeof(lhs_nsec));
+	if (rhs_len > sizeof(rhs_epoch))
+		memcpy(&rhs_nsec, rhs + sizeof(rhs_epoch), sizeof(rhs_nsec));
+	return (lhs_nsec > rhs_nsec) - (lhs_nsec < rhs_nsec);
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
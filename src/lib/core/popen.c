@@ -2,6 +2,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <paths.h>
 #include <signal.h>
 #include <poll.h>
@@ -11,12 +12,15 @@
 #include <sys/wait.h>
 
 #include "popen.h"
+#include "trivia/config.h"
 #include "trivia/util.h"
 #include "small/region.h"
 #include "fiber.h"
 #include "fiber_cond.h"
 #include "assoc.h"
 #include "coio.h"
+#include "coio_task.h"
+#include "clock.h"
 #include "iostream.h"
 #include "say.h"
 #include "tarantool_ev.h"
@@ -25,6 +29,10 @@
 # include <sys/ioctl.h>
 #endif
 
+#if defined(HAVE_SENDFILE_LINUX)
+# include <sys/sendfile.h>
+#endif
+
 #define POPEN_WAIT_LEADERSHIP_DELAY 0.01
 
 /* A mapping to find popens by their pids in a signal handler */
@@ -415,6 +423,140 @@ popen_write_timeout(struct popen_handle *handle, const void *buf,
 	return rc;
 }
 
+/** Size of a chunk copied by popen_write_file_f() at once. */
+#define POPEN_WRITE_FILE_CHUNK (1 << 20)
+
+/**
+ * Copy a file to a non-blocking pipe. Runs in a coio thread,
+ * because reading the file may block.
+ */
+static ssize_t
+popen_write_file_f(va_list ap)
+{
+	int out_fd = va_arg(ap, int);
+	const char *path = va_arg(ap, const char *);
+	off_t offset = va_arg(ap, off_t);
+	size_t count = va_arg(ap, size_t);
+	double deadline = va_arg(ap, double);
+
+	int in_fd = open(path, O_RDONLY);
+	if (in_fd < 0) {
+		diag_set(SystemError, "popen: failed to open '%s'", path);
+		return -1;
+	}
+#if !defined(HAVE_SENDFILE_LINUX)
+	char *buf = malloc(POPEN_WRITE_FILE_CHUNK);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, POPEN_WRITE_FILE_CHUNK, "malloc", "buf");
+		close(in_fd);
+		return -1;
+	}
+	size_t buf_pos = 0, buf_len = 0;
+#endif
+	size_t done = 0;
+	ssize_t rc = -1;
+	while (done < count) {
+		size_t chunk = MIN(count - done, POPEN_WRITE_FILE_CHUNK);
+		ssize_t n;
+#if defined(HAVE_SENDFILE_LINUX)
+		/* Move the data without copying it to user space. */
+		n = sendfile(out_fd, in_fd, &offset, chunk);
+		if (n == 0)
+			break; /* EOF */
+#else
+		if (buf_pos == buf_len) {
+			n = pread(in_fd, buf, chunk, offset);
+			if (n == 0)
+				break; /* EOF */
+			if (n < 0) {
+				diag_set(SystemError, "popen: failed to read "
+					 "'%s'", path);
+				goto out;
+			}
+			offset += n;
+			buf_pos = 0;
+			buf_len = n;
+		}
+		n = write(out_fd, buf + buf_pos, buf_len - buf_pos);
+		if (n > 0)
+			buf_pos += n;
+#endif
+		if (n > 0) {
+			done += n;
+			continue;
+		}
+		if (errno == EINTR)
+			continue;
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			diag_set(SocketError, "popen", "failed to write "
+				 "'%s'", path);
+			goto out;
+		}
+		/* The pipe is full, wait for the child to read. */
+		double timeout = deadline - clock_monotonic();
+		if (timeout <= 0) {
+			diag_set(TimedOut);
+			goto out;
+		}
+		struct pollfd pfd = {.fd = out_fd, .events = POLLOUT};
+		int ms = timeout > INT_MAX / 1000 ? INT_MAX : timeout * 1000 + 1;
+		(void)poll(&pfd, 1, ms);
+	}
+	rc = done;
+out:
+#if !defined(HAVE_SENDFILE_LINUX)
+	free(buf);
+#endif
+	close(in_fd);
+	return rc;
+}
+
+/**
+ * Write a file to the child stdin.
+ *
+ * Copies @a count bytes starting at @a offset of the file at
+ * @a path. Copying stops at the end of the file. On Linux the data
+ * is moved from the page cache to the pipe with sendfile(2),
+ * without copying it through user space, elsewhere it's read and
+ * written in chunks. The copying is done in a coio thread, so the
+ * calling fiber can't be cancelled until it completes or times out.
+ *
+ * Returns the number of written bytes at success, otherwise
+ * returns -1 and set a diag.
+ *
+ * Possible errors are the same as of popen_write_timeout(),
+ * plus SystemError if the file can't be opened or read.
+ */
+ssize_t
+popen_write_file_timeout(struct popen_handle *handle, const char *path,
+			 off_t offset, size_t count, unsigned int flags,
+			 ev_tstamp timeout)
+{
+	assert(handle != NULL);
+
+	if (count > (size_t)SSIZE_MAX)
+		count = SSIZE_MAX;
+
+	if (!(flags & POPEN_FLAG_FD_STDIN)) {
+		diag_set(IllegalParams, "popen: stdin is not set");
+		return -1;
+	}
+
+	int idx = STDIN_FILENO;
+
+	if (popen_may_io(handle, idx, flags) != 0)
+		return -1;
+
+	say_debug("popen: %d: write file idx [%s:%d] path %s offset %lld "
+		  "count %zu fds %d timeout %.9g",
+		  handle->pid, stdX_str(idx), idx, path, (long long)offset,
+		  count, handle->ios[idx].fd, timeout);
+
+	double deadline = clock_monotonic() + timeout;
+	return coio_call(popen_write_file_f, handle->ios[idx].fd, path,
+			 offset, count, deadline);
+}
+
 /**
  * Read data from a child's peer with timeout.
  *
@@ -222,6 +222,11 @@ popen_write_timeout(struct popen_handle *handle, const void *buf,
 		    size_t count, unsigned int flags,
 		    ev_tstamp timeout);
 
+extern ssize_t
+popen_write_file_timeout(struct popen_handle *handle, const char *path,
+			 off_t offset, size_t count, unsigned int flags,
+			 ev_tstamp timeout);
+
 extern ssize_t
 popen_read_timeout(struct popen_handle *handle, void *buf,
 		   size_t count, unsigned int flags,
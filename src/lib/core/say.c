@@ -282,6 +282,18 @@ say_format_by_name(const char *format)
 	return STR2ENUM(say_format, format);
 }
 
+static const char *say_async_overflow_strs[] = {
+	[SAY_ASYNC_OVERFLOW_BLOCK] = "block",
+	[SAY_ASYNC_OVERFLOW_DROP] = "drop",
+	[say_async_overflow_MAX] = "unknown"
+};
+
+enum say_async_overflow
+say_async_overflow_by_name(const char *name)
+{
+	return STR2ENUM(say_async_overflow, name);
+}
+
 /**
  * Sets O_NONBLOCK flag in case if lognonblock is set.
  */
@@ -671,6 +683,7 @@ log_create(struct log *log, const char *init_str, int nonblock)
 	log->path = NULL;
 	log->format_func = say_format_plain;
 	log->level = S_INFO;
+	log->is_async = false;
 	log->rotating_threads = 0;
 	tt_pthread_mutex_init(&log->rotate_mutex, NULL);
 	tt_pthread_cond_init(&log->rotate_cond, NULL);
@@ -799,11 +812,16 @@ say_set_background(void)
 	return 0;
 }
 
+static void
+say_logger_async_stop(void);
+
 void
 say_logger_free(void)
 {
-	if (say_logger_initialized())
+	if (say_logger_initialized()) {
+		say_logger_async_stop();
 		log_destroy(&log_std);
+	}
 }
 
 /** {{{ Formatters */
@@ -1169,6 +1187,354 @@ write_to_syslog(struct log *log, int total)
 
 /** Loggers }}} */
 
+/** {{{ Async logger */
+
+enum {
+	/** Size of a ring of the async logger, per thread. */
+	SAY_RING_SIZE = 256 * 1024,
+	/** Time to sleep waiting for the logger cord, in microseconds. */
+	SAY_ASYNC_WAIT_US = 100,
+	/** Max number of waits for the logger cord to flush a ring. */
+	SAY_ASYNC_FLUSH_WAIT_MAX = 10000,
+};
+
+static_assert(SAY_BUF_LEN_MAX + sizeof(uint32_t) <= SAY_RING_SIZE,
+	      "SAY_RING_SIZE must fit any log message");
+
+/**
+ * A single-producer single-consumer ring of formatted messages.
+ * The producer is the thread owning the ring, the consumer is the
+ * logger cord. A message is stored as its length followed by the
+ * text, both may wrap around the end of the ring.
+ */
+struct say_ring {
+	/** Link in say_async_rings. */
+	struct rlist in_rings;
+	/** Set when the owning thread exits. */
+	bool is_orphan;
+	/** Number of bytes ever written. Updated by the producer. */
+	uint64_t head;
+	/** Number of bytes ever read. Updated by the consumer. */
+	uint64_t tail;
+	/** Messages. */
+	char data[SAY_RING_SIZE];
+};
+
+/** The logger cord and its state. */
+static struct {
+	/** The cord draining the rings. */
+	struct cord cord;
+	/** Event loop of the logger cord, NULL until it is ready. */
+	struct ev_loop *loop;
+	/** Wakes up the logger cord after a message is queued. */
+	struct ev_async wakeup;
+	/** Set if the logger cord is started. */
+	bool is_running;
+	/** Set to stop the logger cord. */
+	bool is_stopping;
+	/** Set if the async mode was requested. Survives fork. */
+	bool is_enabled;
+	/** enum say_async_overflow. */
+	int overflow;
+	/** Number of messages written by the logger cord. */
+	int64_t written;
+	/** Number of messages dropped because a ring was full. */
+	int64_t dropped;
+} say_async;
+
+/** Rings of all threads that have logged in the async mode. */
+static RLIST_HEAD(say_async_rings);
+/** Protects say_async_rings. */
+static pthread_mutex_t say_async_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t say_async_once = PTHREAD_ONCE_INIT;
+/** Used to mark the ring orphan on thread exit. */
+static pthread_key_t say_ring_key;
+/** Ring of the current thread, allocated on demand. */
+static __thread struct say_ring *say_ring;
+/** Set in the logger cord, which always writes messages itself. */
+static __thread bool say_is_logger_cord;
+
+/** Copy @a size bytes to the ring at position @a pos. */
+static void
+say_ring_write(struct say_ring *ring, uint64_t pos, const void *src,
+	       size_t size)
+{
+	size_t offset = pos % SAY_RING_SIZE;
+	size_t n = MIN(size, SAY_RING_SIZE - offset);
+	memcpy(ring->data + offset, src, n);
+	memcpy(ring->data, (const char *)src + n, size - n);
+}
+
+/** Copy @a size bytes from the ring at position @a pos. */
+static void
+say_ring_read(struct say_ring *ring, uint64_t pos, void *dst, size_t size)
+{
+	size_t offset = pos % SAY_RING_SIZE;
+	size_t n = MIN(size, SAY_RING_SIZE - offset);
+	memcpy(dst, ring->data + offset, n);
+	memcpy((char *)dst + n, ring->data, size - n);
+}
+
+/** Thread exit callback. The ring is freed by the logger cord. */
+static void
+say_ring_orphan(void *arg)
+{
+	struct say_ring *ring = arg;
+	pm_atomic_store(&ring->is_orphan, true);
+}
+
+/** Return the ring of the current thread or NULL on OOM. */
+static struct say_ring *
+say_ring_get(void)
+{
+	if (say_ring != NULL)
+		return say_ring;
+	struct say_ring *ring = malloc(sizeof(*ring));
+	if (ring == NULL)
+		return NULL;
+	ring->is_orphan = false;
+	ring->head = 0;
+	ring->tail = 0;
+	tt_pthread_setspecific(say_ring_key, ring);
+	tt_pthread_mutex_lock(&say_async_rings_mutex);
+	rlist_add_tail_entry(&say_async_rings, ring, in_rings);
+	tt_pthread_mutex_unlock(&say_async_rings_mutex);
+	say_ring = ring;
+	return ring;
+}
+
+/** Wake up the logger cord. */
+static void
+say_async_wakeup(void)
+{
+	struct ev_loop *loop = pm_atomic_load(&say_async.loop);
+	if (loop != NULL)
+		ev_async_send(loop, &say_async.wakeup);
+}
+
+/**
+ * Queue the message formatted in say_buf to the ring of the current
+ * thread. Returns false if the message must be written synchronously.
+ */
+static bool
+say_async_push(int level, int total)
+{
+	struct say_ring *ring = say_ring_get();
+	if (ring == NULL)
+		return false;
+	uint32_t len = total;
+	uint64_t size = sizeof(len) + len;
+	/* Only this thread updates the head. */
+	uint64_t head = ring->head;
+	while (head + size - pm_atomic_load(&ring->tail) > SAY_RING_SIZE) {
+		if (pm_atomic_load(&say_async.overflow) ==
+		    SAY_ASYNC_OVERFLOW_DROP && level != S_FATAL) {
+			pm_atomic_fetch_add(&say_async.dropped, 1);
+			return true;
+		}
+		say_async_wakeup();
+		usleep(SAY_ASYNC_WAIT_US);
+	}
+	say_ring_write(ring, head, &len, sizeof(len));
+	say_ring_write(ring, head + sizeof(len), say_buf, len);
+	pm_atomic_store(&ring->head, head + size);
+	/*
+	 * The logger cord updates the tail before checking the head,
+	 * so if it has consumed all messages queued before this one,
+	 * it may be going to sleep and must be woken up.
+	 */
+	if (pm_atomic_load(&ring->tail) == head)
+		say_async_wakeup();
+	if (level == S_FATAL) {
+		/* The process is likely to exit, flush the ring. */
+		for (int i = 0; i < SAY_ASYNC_FLUSH_WAIT_MAX &&
+				pm_atomic_load(&ring->tail) != head + size;
+		     i++) {
+			say_async_wakeup();
+			usleep(SAY_ASYNC_WAIT_US);
+		}
+	}
+	return true;
+}
+
+/** Write the message formatted in say_buf in the logger cord. */
+static void
+say_async_write(struct log *log, int total)
+{
+	if (log->type == SAY_LOGGER_SYSLOG)
+		write_to_syslog(log, total);
+	else
+		write_to_file(log, total);
+}
+
+/** Write all messages queued to the ring. */
+static void
+say_ring_drain(struct say_ring *ring, struct log *log)
+{
+	/* Only this thread updates the tail. */
+	uint64_t tail = ring->tail;
+	while (pm_atomic_load(&ring->head) != tail) {
+		uint32_t len;
+		say_ring_read(ring, tail, &len, sizeof(len));
+		say_ring_read(ring, tail + sizeof(len), say_buf, len);
+		say_async_write(log, len);
+		tail += sizeof(len) + len;
+		pm_atomic_store(&ring->tail, tail);
+		pm_atomic_store(&say_async.written,
+				pm_atomic_load(&say_async.written) + 1);
+	}
+}
+
+/** Write messages queued to all rings, free rings of exited threads. */
+static void
+say_async_drain(struct log *log)
+{
+	tt_pthread_mutex_lock(&say_async_rings_mutex);
+	struct say_ring *ring, *tmp;
+	rlist_foreach_entry_safe(ring, &say_async_rings, in_rings, tmp) {
+		say_ring_drain(ring, log);
+		/* An orphan ring can't receive new messages. */
+		if (pm_atomic_load(&ring->is_orphan) &&
+		    ring->tail == pm_atomic_load(&ring->head)) {
+			rlist_del_entry(ring, in_rings);
+			free(ring);
+		}
+	}
+	tt_pthread_mutex_unlock(&say_async_rings_mutex);
+}
+
+static void
+say_async_wakeup_cb(struct ev_loop *loop, struct ev_async *watcher,
+		    int revents)
+{
+	(void)loop;
+	(void)revents;
+	fiber_wakeup(watcher->data);
+}
+
+/** Main fiber of the logger cord. */
+static int
+say_async_f(va_list ap)
+{
+	(void)ap;
+	say_is_logger_cord = true;
+	say_async.wakeup.data = fiber();
+	ev_async_start(loop(), &say_async.wakeup);
+	pm_atomic_store(&say_async.loop, loop());
+	/* Producers may wake up the cord only after it's ready. */
+	pm_atomic_store(&log_std.is_async, true);
+	while (!pm_atomic_load(&say_async.is_stopping)) {
+		say_async_drain(&log_std);
+		fiber_yield();
+	}
+	pm_atomic_store(&log_std.is_async, false);
+	say_async_drain(&log_std);
+	pm_atomic_store(&say_async.loop, NULL);
+	ev_async_stop(loop(), &say_async.wakeup);
+	return 0;
+}
+
+static void
+say_async_atfork_prepare(void)
+{
+	tt_pthread_mutex_lock(&say_async_rings_mutex);
+}
+
+static void
+say_async_atfork_parent(void)
+{
+	tt_pthread_mutex_unlock(&say_async_rings_mutex);
+}
+
+/**
+ * The logger cord doesn't exist in a forked child, so switch the
+ * child to the synchronous mode and drop messages queued by the
+ * parent: they are written by the parent's logger cord.
+ */
+static void
+say_async_atfork_child(void)
+{
+	log_std.is_async = false;
+	say_async.loop = NULL;
+	say_async.is_running = false;
+	memset(&say_async.cord, 0, sizeof(say_async.cord));
+	struct say_ring *ring;
+	rlist_foreach_entry(ring, &say_async_rings, in_rings) {
+		ring->tail = ring->head;
+		/* Other threads don't exist in the child either. */
+		if (ring != say_ring)
+			ring->is_orphan = true;
+	}
+	tt_pthread_mutex_unlock(&say_async_rings_mutex);
+}
+
+static void
+say_async_init(void)
+{
+	ev_async_init(&say_async.wakeup, say_async_wakeup_cb);
+	tt_pthread_key_create(&say_ring_key, say_ring_orphan);
+	tt_pthread_atfork(say_async_atfork_prepare, say_async_atfork_parent,
+			  say_async_atfork_child);
+}
+
+int
+say_logger_async_start(void)
+{
+	assert(say_logger_initialized());
+	say_async.is_enabled = true;
+	if (say_async.is_running || log_std.type == SAY_LOGGER_STDERR)
+		return 0;
+	tt_pthread_once(&say_async_once, say_async_init);
+	say_async.is_stopping = false;
+	if (cord_costart(&say_async.cord, "log", say_async_f, NULL) != 0)
+		return -1;
+	say_async.is_running = true;
+	return 0;
+}
+
+int
+say_logger_async_restart(void)
+{
+	if (!say_async.is_enabled)
+		return 0;
+	return say_logger_async_start();
+}
+
+/** Stop the logger cord and write all queued messages. */
+static void
+say_logger_async_stop(void)
+{
+	if (!say_async.is_running)
+		return;
+	pm_atomic_store(&say_async.is_stopping, true);
+	say_async_wakeup();
+	if (cord_join(&say_async.cord) != 0)
+		diag_log();
+	say_async.is_running = false;
+	/*
+	 * The cord might have exited before it was ready or before a
+	 * message was queued. Nobody else consumes the rings now.
+	 */
+	pm_atomic_store(&log_std.is_async, false);
+	say_async_drain(&log_std);
+}
+
+void
+say_set_log_async_overflow(enum say_async_overflow overflow)
+{
+	assert(overflow < say_async_overflow_MAX);
+	pm_atomic_store(&say_async.overflow, overflow);
+}
+
+void
+say_logger_async_stat(struct say_async_stat *stat)
+{
+	stat->written = pm_atomic_load(&say_async.written);
+	stat->dropped = pm_atomic_load(&say_async.dropped);
+}
+
+/** Async logger }}} */
+
 /*
  * Init string parser(s)
  */
@@ -1369,6 +1735,10 @@ log_vsay(struct log *log, int level, bool check_level, const char *module,
 	if (total <= 0)
 		goto out;
 
+	if (pm_atomic_load(&log->is_async) && !say_is_logger_cord &&
+	    say_async_push(level, total))
+		goto out;
+
 	switch (log->type) {
 	case SAY_LOGGER_FILE:
 	case SAY_LOGGER_PIPE:
@@ -150,6 +150,23 @@ enum syslog_facility {
 	syslog_facility_MAX,
 };
 
+/** What to do with a message if the async log ring is full. */
+enum say_async_overflow {
+	/** Wait until the logger cord frees space in the ring. */
+	SAY_ASYNC_OVERFLOW_BLOCK,
+	/** Drop the message. */
+	SAY_ASYNC_OVERFLOW_DROP,
+	say_async_overflow_MAX,
+};
+
+/** Statistics of the async logger. */
+struct say_async_stat {
+	/** Number of messages written by the logger cord. */
+	int64_t written;
+	/** Number of messages dropped because a ring was full. */
+	int64_t dropped;
+};
+
 struct log;
 
 typedef int (*log_format_func_t)(struct log *log, char *buf, int len, int level,
@@ -174,6 +191,11 @@ struct log {
 	 */
 	char *path;
 	bool nonblock;
+	/**
+	 * Set if messages are passed to the logger cord instead of
+	 * being written by the thread that logs them.
+	 */
+	bool is_async;
 	log_format_func_t format_func;
 	/** pid of the process if logging to pipe. */
 	pid_t pid;
@@ -338,6 +360,40 @@ say_set_background(void);
 bool
 say_logger_initialized(void);
 
+/**
+ * Start the logger cord and switch the default logger to the async
+ * mode: each thread formats messages into its own ring drained by
+ * the logger cord. Does nothing if the default logger writes to
+ * stderr, because it may be an interactive console.
+ *
+ * @retval 0 on success
+ * @retval -1 on error, the diag is set
+ */
+int
+say_logger_async_start(void);
+
+/**
+ * Restart the logger cord in a forked child if the async mode was
+ * enabled in the parent. Until then the child logs synchronously.
+ */
+int
+say_logger_async_restart(void);
+
+/** Set the policy applied to messages that don't fit the ring. */
+void
+say_set_log_async_overflow(enum say_async_overflow overflow);
+
+/**
+ * Return the async overflow policy by its name.
+ * @retval say_async_overflow_MAX on error
+ */
+enum say_async_overflow
+say_async_overflow_by_name(const char *name);
+
+/** Get statistics of the async logger. */
+void
+say_logger_async_stat(struct say_async_stat *stat);
+
 /** Free default logger */
 void
 say_logger_free(void);
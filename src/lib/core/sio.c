@@ -113,10 +113,14 @@ sio_option_name(int option)
 	CASE_OPTION(SO_LINGER);
 	CASE_OPTION(SO_ERROR);
 	CASE_OPTION(SO_REUSEADDR);
+	CASE_OPTION(SO_REUSEPORT);
 	CASE_OPTION(TCP_NODELAY);
 #ifdef __linux__
 	CASE_OPTION(TCP_KEEPCNT);
 	CASE_OPTION(TCP_KEEPINTVL);
+#endif
+#ifdef SO_BUSY_POLL
+	CASE_OPTION(SO_BUSY_POLL);
 #endif
 	default:
 		return "undefined";
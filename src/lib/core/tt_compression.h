@@ -21,6 +21,8 @@ extern "C" {
 
 enum compression_type {
         COMPRESSION_TYPE_NONE = 0,
+        /** Field is compressed with zstd. */
+        COMPRESSION_TYPE_ZSTD = 1,
         compression_type_MAX
 };
 
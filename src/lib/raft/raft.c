@@ -245,6 +245,18 @@ raft_is_leader_seen(const struct raft *raft)
 	return is_seen;
 }
 
+/**
+ * Check if the instance has promised some other leader not to vote for the
+ * given candidate, see raft_process_heartbeat().
+ */
+static inline bool
+raft_is_lease_promised(const struct raft *raft, uint32_t candidate_id)
+{
+	return raft->is_lease_enabled && raft->lease_holder != candidate_id &&
+	       raft->lease_promise_deadline >
+	       raft_ev_monotonic_now(raft_loop());
+}
+
 /** Schedule broadcast of the complete Raft state to all the followers. */
 static void
 raft_schedule_broadcast(struct raft *raft);
@@ -458,9 +470,20 @@ raft_notify_is_leader_seen(struct raft *raft, bool is_leader_seen,
 			   uint32_t source)
 {
 	assert(source > 0 && source < VCLOCK_MAX && source != raft->self);
-	/* Leader doesn't care whether someone sees it or not. */
-	if (raft->state == RAFT_STATE_LEADER)
+	/*
+	 * Leader doesn't care whether someone sees it or not. Except for the
+	 * leases - they can only be granted by the followers seeing the leader.
+	 */
+	if (raft->state == RAFT_STATE_LEADER) {
+		if (!is_leader_seen) {
+			raft->lease_witness_time[source] = 0;
+			raft->lease_deadline[source] = 0;
+		} else if (raft->lease_witness_time[source] == 0) {
+			raft->lease_witness_time[source] =
+				raft_ev_monotonic_now(raft_loop());
+		}
 		return;
+	}
 
 	if (is_leader_seen)
 		bit_set(&raft->leader_witness_map, source);
@@ -575,6 +598,12 @@ raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 					 "already voted in this term");
 				break;
 			}
+			if (raft_is_lease_promised(raft, req->vote)) {
+				say_info("RAFT: vote request is skipped - the "
+					 "lease of %u hasn't expired yet",
+					 raft->lease_holder);
+				break;
+			}
 			raft_sm_try_new_vote(raft, req->vote, req->vclock);
 			break;
 		case RAFT_STATE_CANDIDATE:
@@ -604,6 +633,9 @@ raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 		}
 	}
 	if (req->state != RAFT_STATE_LEADER) {
+		/* A leader gives up its lease when resigns. */
+		if (source == raft->lease_holder)
+			raft->lease_promise_deadline = 0;
 		if (source == raft->leader) {
 			say_info("RAFT: the node %u has resigned from the "
 				 "leader role", raft->leader);
@@ -663,14 +695,25 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	 */
 	if (source == 0)
 		return;
-	if (!raft->is_enabled)
-		return;
 	/* Don't care about heartbeats when this node is a leader itself. */
 	if (raft->state == RAFT_STATE_LEADER)
 		return;
 	/* Not interested in heartbeats from not a leader. */
 	if (raft->leader != source)
 		return;
+	/*
+	 * The acknowledgement of this heartbeat extends the lease of the
+	 * leader. The promise is kept even if Raft is disabled now, because it
+	 * can be enabled before the promise expires.
+	 */
+	if (raft->is_lease_enabled) {
+		raft->lease_holder = source;
+		raft->lease_promise_deadline =
+			raft_ev_monotonic_now(raft_loop()) +
+			raft->death_timeout;
+	}
+	if (!raft->is_enabled)
+		return;
 	/*
 	 * The instance currently is busy with writing something on disk. Can't
 	 * react to heartbeats. Still, update leader_last_seen field for the
@@ -696,6 +739,48 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	raft_sm_wait_leader_dead(raft);
 }
 
+void
+raft_process_lease_ack(struct raft *raft, uint32_t source, uint64_t term,
+		       double sent_time)
+{
+	assert(source < VCLOCK_MAX);
+	if (source == 0 || source == raft->self)
+		return;
+	if (!raft->is_lease_enabled || raft->state != RAFT_STATE_LEADER)
+		return;
+	/* The follower might not know about this leader yet. */
+	if (term != raft->term)
+		return;
+	double witness_time = raft->lease_witness_time[source];
+	if (witness_time == 0 || sent_time <= witness_time)
+		return;
+	/*
+	 * The follower keeps its promise for the death timeout since it has
+	 * received the heartbeat. Here it is counted since the heartbeat was
+	 * sent, and is shortened to tolerate the clocks running at different
+	 * rates.
+	 */
+	double deadline = sent_time +
+			  raft->death_timeout * (1 - raft->lease_max_drift);
+	if (deadline > raft->lease_deadline[source])
+		raft->lease_deadline[source] = deadline;
+}
+
+bool
+raft_has_lease(const struct raft *raft)
+{
+	if (!raft->is_lease_enabled || raft->state != RAFT_STATE_LEADER)
+		return false;
+	double now = raft_ev_monotonic_now(raft_loop());
+	/* The leader itself is a part of the quorum. */
+	int count = 1;
+	for (int i = 0; i < VCLOCK_MAX; ++i) {
+		if (raft->lease_deadline[i] > now)
+			++count;
+	}
+	return count >= raft->election_quorum;
+}
+
 /* Dump Raft state to WAL in a blocking way. */
 static void
 raft_worker_handle_io(struct raft *raft)
@@ -847,6 +932,8 @@ raft_sm_become_leader(struct raft *raft)
 	assert(!raft->is_write_in_progress);
 	raft->state = RAFT_STATE_LEADER;
 	raft->leader = raft->self;
+	memset(raft->lease_witness_time, 0, sizeof(raft->lease_witness_time));
+	memset(raft->lease_deadline, 0, sizeof(raft->lease_deadline));
 	raft_ev_timer_stop(raft_loop(), &raft->timer);
 	/* State is visible and it is changed - broadcast. */
 	raft_schedule_broadcast(raft);
@@ -1290,6 +1377,18 @@ raft_cfg_max_shift(struct raft *raft, double shift)
 	raft->max_shift = shift;
 }
 
+void
+raft_cfg_lease(struct raft *raft, bool is_enabled, double max_drift)
+{
+	assert(max_drift >= 0 && max_drift < 1);
+	raft->is_lease_enabled = is_enabled;
+	raft->lease_max_drift = max_drift;
+	if (!is_enabled) {
+		raft->lease_promise_deadline = 0;
+		memset(raft->lease_deadline, 0, sizeof(raft->lease_deadline));
+	}
+}
+
 void
 raft_cfg_instance_id(struct raft *raft, uint32_t instance_id)
 {
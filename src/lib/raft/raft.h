@@ -243,6 +243,27 @@ struct raft {
 	double death_timeout;
 	/** Maximal deviation from the election timeout. */
 	double max_shift;
+	/** Whether the leader leases are enabled. */
+	bool is_lease_enabled;
+	/**
+	 * Maximal relative drift between the clocks of the instances which
+	 * the leader leases have to tolerate.
+	 */
+	double lease_max_drift;
+	/**
+	 * Follower: the leader which was promised not to be voted against
+	 * until lease_promise_deadline.
+	 */
+	uint32_t lease_holder;
+	/** Follower: the moment the promise given to lease_holder expires. */
+	double lease_promise_deadline;
+	/**
+	 * Leader: the moment each follower was found seeing this leader.
+	 * Heartbeats sent before that moment don't extend the lease.
+	 */
+	double lease_witness_time[VCLOCK_MAX];
+	/** Leader: the moment the lease granted by each follower expires. */
+	double lease_deadline[VCLOCK_MAX];
 	/** Number of instances registered in the cluster. */
 	int cluster_size;
 	/** Virtual table to perform application-specific actions. */
@@ -311,6 +332,24 @@ raft_process_async(struct raft *raft);
 void
 raft_process_heartbeat(struct raft *raft, uint32_t source);
 
+/**
+ * Process an acknowledgement of a heartbeat sent by this instance to the
+ * given source at the moment @a sent_time. The source has reported the given
+ * term in the acknowledgement. When leases are enabled, it extends the lease
+ * granted by the source to the leader.
+ */
+void
+raft_process_lease_ack(struct raft *raft, uint32_t source, uint64_t term,
+		       double sent_time);
+
+/**
+ * Check if the instance is the leader holding a valid lease, i.e. no other
+ * leader can be elected right now and the local data can be read without
+ * contacting a quorum.
+ */
+bool
+raft_has_lease(const struct raft *raft);
+
 /** Configure whether Raft is enabled. */
 void
 raft_cfg_is_enabled(struct raft *raft, bool is_enabled);
@@ -385,6 +424,15 @@ raft_cfg_death_timeout(struct raft *raft, double timeout);
 void
 raft_cfg_max_shift(struct raft *raft, double shift);
 
+/**
+ * Configure the leader leases. When they are enabled, followers don't vote
+ * against a leader during the death timeout after its last heartbeat, and the
+ * leader can rely on that for the death timeout shortened by the given maximal
+ * relative clock drift.
+ */
+void
+raft_cfg_lease(struct raft *raft, bool is_enabled, double max_drift);
+
 /**
  * Configure ID of the given Raft instance. The ID can't be changed after it is
  * assigned first time.
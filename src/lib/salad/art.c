@@ -0,0 +1,1010 @@
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "art.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trivia/util.h"
+
+enum art_node_type {
+	ART_NODE4,
+	ART_NODE16,
+	ART_NODE48,
+	ART_NODE256,
+};
+
+enum {
+	/** Max number of compressed path bytes stored in a node. */
+	ART_PREFIX_MAX = 8,
+};
+
+/** Common header of all inner nodes. */
+struct art_node {
+	/** Node type, enum art_node_type. */
+	uint8_t type;
+	/** Number of children. */
+	uint16_t count;
+	/**
+	 * Length of the compressed path, i.e. the number of key bytes
+	 * shared by all records of the node skipped before the child
+	 * byte. Only ART_PREFIX_MAX first bytes are stored in the node,
+	 * the rest are fetched from the key of any record of the node.
+	 */
+	uint32_t prefix_len;
+	/** First bytes of the compressed path. */
+	unsigned char prefix[ART_PREFIX_MAX];
+};
+
+/** Node with up to 4 children, keys are sorted. */
+struct art_node4 {
+	struct art_node base;
+	unsigned char keys[4];
+	void *children[4];
+};
+
+/** Node with up to 16 children, keys are sorted. */
+struct art_node16 {
+	struct art_node base;
+	unsigned char keys[16];
+	void *children[16];
+};
+
+/**
+ * Node with up to 48 children, indexed by a key byte map storing
+ * the child slot number plus one or 0 if there's no child.
+ */
+struct art_node48 {
+	struct art_node base;
+	unsigned char index[256];
+	void *children[48];
+};
+
+/** Node with up to 256 children, indexed by key byte. */
+struct art_node256 {
+	struct art_node base;
+	void *children[256];
+};
+
+static const size_t art_node_size[] = {
+	/* [ART_NODE4]   = */ sizeof(struct art_node4),
+	/* [ART_NODE16]  = */ sizeof(struct art_node16),
+	/* [ART_NODE48]  = */ sizeof(struct art_node48),
+	/* [ART_NODE256] = */ sizeof(struct art_node256),
+};
+
+static_assert(lengthof(art_node_size) == ART_NODE_SIZE_COUNT,
+	      "ART_NODE_SIZE_COUNT must match the number of node types");
+
+static inline bool
+art_is_leaf(const void *ptr)
+{
+	return ((uintptr_t)ptr & 1) != 0;
+}
+
+static inline void *
+art_leaf_record(const void *ptr)
+{
+	assert(art_is_leaf(ptr));
+	return (void *)((uintptr_t)ptr & ~(uintptr_t)1);
+}
+
+static inline void *
+art_leaf_new(void *record)
+{
+	assert(((uintptr_t)record & 1) == 0);
+	return (void *)((uintptr_t)record | 1);
+}
+
+/** Compare a record key with the given key. */
+static inline bool
+art_leaf_matches(struct art *tree, const void *leaf,
+		 const unsigned char *key, uint32_t len)
+{
+	uint32_t leaf_len;
+	const unsigned char *leaf_key =
+		tree->key_of(art_leaf_record(leaf), &leaf_len, tree->ctx);
+	return leaf_len == len && memcmp(leaf_key, key, len) == 0;
+}
+
+static struct art_node *
+art_node_new(struct art *tree, enum art_node_type type)
+{
+	size_t size = art_node_size[type];
+	struct art_node *node = tree->alloc(tree->ctx, size);
+	if (node == NULL)
+		return NULL;
+	memset(node, 0, size);
+	node->type = type;
+	tree->mem_used += size;
+	return node;
+}
+
+static void
+art_node_delete(struct art *tree, struct art_node *node)
+{
+	size_t size = art_node_size[node->type];
+	tree->mem_used -= size;
+	tree->free(tree->ctx, node, size);
+}
+
+/** Copy the header of a node to a node of another type. */
+static void
+art_node_copy_header(struct art_node *dst, const struct art_node *src)
+{
+	dst->count = src->count;
+	dst->prefix_len = src->prefix_len;
+	memcpy(dst->prefix, src->prefix, ART_PREFIX_MAX);
+}
+
+/** Return a pointer to the child slot for the given byte or NULL. */
+static void **
+art_node_find_child(struct art_node *node, unsigned char c)
+{
+	switch (node->type) {
+	case ART_NODE4: {
+		struct art_node4 *n = (struct art_node4 *)node;
+		for (int i = 0; i < node->count; i++) {
+			if (n->keys[i] == c)
+				return &n->children[i];
+		}
+		return NULL;
+	}
+	case ART_NODE16: {
+		struct art_node16 *n = (struct art_node16 *)node;
+		for (int i = 0; i < node->count; i++) {
+			if (n->keys[i] == c)
+				return &n->children[i];
+		}
+		return NULL;
+	}
+	case ART_NODE48: {
+		struct art_node48 *n = (struct art_node48 *)node;
+		int slot = n->index[c];
+		return slot != 0 ? &n->children[slot - 1] : NULL;
+	}
+	case ART_NODE256: {
+		struct art_node256 *n = (struct art_node256 *)node;
+		return n->children[c] != NULL ? &n->children[c] : NULL;
+	}
+	default:
+		unreachable();
+	}
+	return NULL;
+}
+
+/**
+ * Return the child with the least key byte greater than or equal to
+ * @a from and store its key byte in @a byte. Returns NULL if there's
+ * no such child. @a from may be 256.
+ */
+static void *
+art_node_next_child(const struct art_node *node, int from, int *byte)
+{
+	switch (node->type) {
+	case ART_NODE4: {
+		const struct art_node4 *n = (const struct art_node4 *)node;
+		for (int i = 0; i < node->count; i++) {
+			if (n->keys[i] >= from) {
+				*byte = n->keys[i];
+				return n->children[i];
+			}
+		}
+		return NULL;
+	}
+	case ART_NODE16: {
+		const struct art_node16 *n = (const struct art_node16 *)node;
+		for (int i = 0; i < node->count; i++) {
+			if (n->keys[i] >= from) {
+				*byte = n->keys[i];
+				return n->children[i];
+			}
+		}
+		return NULL;
+	}
+	case ART_NODE48: {
+		const struct art_node48 *n = (const struct art_node48 *)node;
+		for (int c = from; c < 256; c++) {
+			if (n->index[c] != 0) {
+				*byte = c;
+				return n->children[n->index[c] - 1];
+			}
+		}
+		return NULL;
+	}
+	case ART_NODE256: {
+		const struct art_node256 *n = (const struct art_node256 *)node;
+		for (int c = from; c < 256; c++) {
+			if (n->children[c] != NULL) {
+				*byte = c;
+				return n->children[c];
+			}
+		}
+		return NULL;
+	}
+	default:
+		unreachable();
+	}
+	return NULL;
+}
+
+/**
+ * Return the child with the greatest key byte less than or equal to
+ * @a to or NULL. @a to may be -1.
+ */
+static void *
+art_node_prev_child(const struct art_node *node, int to)
+{
+	switch (node->type) {
+	case ART_NODE4: {
+		const struct art_node4 *n = (const struct art_node4 *)node;
+		for (int i = node->count - 1; i >= 0; i--) {
+			if (n->keys[i] <= to)
+				return n->children[i];
+		}
+		return NULL;
+	}
+	case ART_NODE16: {
+		const struct art_node16 *n = (const struct art_node16 *)node;
+		for (int i = node->count - 1; i >= 0; i--) {
+			if (n->keys[i] <= to)
+				return n->children[i];
+		}
+		return NULL;
+	}
+	case ART_NODE48: {
+		const struct art_node48 *n = (const struct art_node48 *)node;
+		for (int c = to; c >= 0; c--) {
+			if (n->index[c] != 0)
+				return n->children[n->index[c] - 1];
+		}
+		return NULL;
+	}
+	case ART_NODE256: {
+		const struct art_node256 *n = (const struct art_node256 *)node;
+		for (int c = to; c >= 0; c--) {
+			if (n->children[c] != NULL)
+				return n->children[c];
+		}
+		return NULL;
+	}
+	default:
+		unreachable();
+	}
+	return NULL;
+}
+
+/** Return the first record of a subtree or NULL if it's empty. */
+static void *
+art_subtree_first(const void *node)
+{
+	int byte;
+	while (node != NULL && !art_is_leaf(node))
+		node = art_node_next_child(node, 0, &byte);
+	return node != NULL ? art_leaf_record(node) : NULL;
+}
+
+/** Return the last record of a subtree or NULL if it's empty. */
+static void *
+art_subtree_last(const void *node)
+{
+	while (node != NULL && !art_is_leaf(node))
+		node = art_node_prev_child(node, 255);
+	return node != NULL ? art_leaf_record(node) : NULL;
+}
+
+/**
+ * Return the compressed path of a node. @a depth is the number of key
+ * bytes preceding the path. The returned pointer is valid until the
+ * next invocation of the key callback.
+ */
+static const unsigned char *
+art_node_prefix(struct art *tree, const struct art_node *node,
+		uint32_t depth)
+{
+	if (node->prefix_len <= ART_PREFIX_MAX)
+		return node->prefix;
+	uint32_t len;
+	const unsigned char *key = tree->key_of(art_subtree_first(node),
+						&len, tree->ctx);
+	assert(len >= depth + node->prefix_len);
+	return key + depth;
+}
+
+/**
+ * Add a child to a node, growing the node if it's full, in which case
+ * the node is replaced in @a ref. Returns -1 on memory error.
+ */
+static int
+art_node_add_child(struct art *tree, void **ref, struct art_node *node,
+		   unsigned char c, void *child)
+{
+	switch (node->type) {
+	case ART_NODE4: {
+		struct art_node4 *n = (struct art_node4 *)node;
+		if (node->count == 4) {
+			struct art_node16 *new_node = (struct art_node16 *)
+				art_node_new(tree, ART_NODE16);
+			if (new_node == NULL)
+				return -1;
+			art_node_copy_header(&new_node->base, node);
+			memcpy(new_node->keys, n->keys, sizeof(n->keys));
+			memcpy(new_node->children, n->children,
+			       sizeof(n->children));
+			art_node_delete(tree, node);
+			*ref = new_node;
+			return art_node_add_child(tree, ref, &new_node->base,
+						  c, child);
+		}
+		int i = node->count;
+		for (; i > 0 && n->keys[i - 1] > c; i--) {
+			n->keys[i] = n->keys[i - 1];
+			n->children[i] = n->children[i - 1];
+		}
+		n->keys[i] = c;
+		n->children[i] = child;
+		node->count++;
+		return 0;
+	}
+	case ART_NODE16: {
+		struct art_node16 *n = (struct art_node16 *)node;
+		if (node->count == 16) {
+			struct art_node48 *new_node = (struct art_node48 *)
+				art_node_new(tree, ART_NODE48);
+			if (new_node == NULL)
+				return -1;
+			art_node_copy_header(&new_node->base, node);
+			for (int i = 0; i < 16; i++) {
+				new_node->index[n->keys[i]] = i + 1;
+				new_node->children[i] = n->children[i];
+			}
+			art_node_delete(tree, node);
+			*ref = new_node;
+			return art_node_add_child(tree, ref, &new_node->base,
+						  c, child);
+		}
+		int i = node->count;
+		for (; i > 0 && n->keys[i - 1] > c; i--) {
+			n->keys[i] = n->keys[i - 1];
+			n->children[i] = n->children[i - 1];
+		}
+		n->keys[i] = c;
+		n->children[i] = child;
+		node->count++;
+		return 0;
+	}
+	case ART_NODE48: {
+		struct art_node48 *n = (struct art_node48 *)node;
+		if (node->count == 48) {
+			struct art_node256 *new_node = (struct art_node256 *)
+				art_node_new(tree, ART_NODE256);
+			if (new_node == NULL)
+				return -1;
+			art_node_copy_header(&new_node->base, node);
+			for (int b = 0; b < 256; b++) {
+				if (n->index[b] != 0) {
+					new_node->children[b] =
+						n->children[n->index[b] - 1];
+				}
+			}
+			art_node_delete(tree, node);
+			*ref = new_node;
+			return art_node_add_child(tree, ref, &new_node->base,
+						  c, child);
+		}
+		/* Slots are freed on deletion so look for an empty one. */
+		int slot = 0;
+		while (n->children[slot] != NULL)
+			slot++;
+		n->children[slot] = child;
+		n->index[c] = slot + 1;
+		node->count++;
+		return 0;
+	}
+	case ART_NODE256: {
+		struct art_node256 *n = (struct art_node256 *)node;
+		assert(n->children[c] == NULL);
+		n->children[c] = child;
+		node->count++;
+		return 0;
+	}
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+/**
+ * Replace a node having one child with the child, merging compressed
+ * paths if the child is an inner node.
+ */
+static void
+art_node_collapse(struct art *tree, void **ref, struct art_node *node)
+{
+	assert(node->count == 1);
+	int byte;
+	void *child = art_node_next_child(node, 0, &byte);
+	assert(child != NULL);
+	if (!art_is_leaf(child)) {
+		/* Leaves don't store compressed paths. */
+		struct art_node *c = child;
+		uint32_t len = node->prefix_len;
+		if (len < ART_PREFIX_MAX) {
+			node->prefix[len++] = byte;
+			uint32_t tail = MIN(c->prefix_len,
+					    (uint32_t)ART_PREFIX_MAX - len);
+			memcpy(node->prefix + len, c->prefix, tail);
+		}
+		memcpy(c->prefix, node->prefix, ART_PREFIX_MAX);
+		c->prefix_len += node->prefix_len + 1;
+	}
+	*ref = child;
+	art_node_delete(tree, node);
+}
+
+/**
+ * Remove a child from a node, shrinking the node if it becomes sparse,
+ * in which case the node is replaced in @a ref. A node left with one
+ * child is replaced with the child. Switching to a smaller node type is
+ * skipped on memory error so this function never fails.
+ */
+static void
+art_node_remove_child(struct art *tree, void **ref, struct art_node *node,
+		      unsigned char c)
+{
+	switch (node->type) {
+	case ART_NODE4: {
+		struct art_node4 *n = (struct art_node4 *)node;
+		int i = 0;
+		while (n->keys[i] != c)
+			i++;
+		for (node->count--; i < node->count; i++) {
+			n->keys[i] = n->keys[i + 1];
+			n->children[i] = n->children[i + 1];
+		}
+		break;
+	}
+	case ART_NODE16: {
+		struct art_node16 *n = (struct art_node16 *)node;
+		int i = 0;
+		while (n->keys[i] != c)
+			i++;
+		for (node->count--; i < node->count; i++) {
+			n->keys[i] = n->keys[i + 1];
+			n->children[i] = n->children[i + 1];
+		}
+		break;
+	}
+	case ART_NODE48: {
+		struct art_node48 *n = (struct art_node48 *)node;
+		assert(n->index[c] != 0);
+		n->children[n->index[c] - 1] = NULL;
+		n->index[c] = 0;
+		node->count--;
+		break;
+	}
+	case ART_NODE256: {
+		struct art_node256 *n = (struct art_node256 *)node;
+		assert(n->children[c] != NULL);
+		n->children[c] = NULL;
+		node->count--;
+		break;
+	}
+	default:
+		unreachable();
+	}
+	if (node->count == 1) {
+		art_node_collapse(tree, ref, node);
+		return;
+	}
+	/* Leave some slack to avoid flapping between node types. */
+	switch (node->type) {
+	case ART_NODE16: {
+		if (node->count > 3)
+			return;
+		struct art_node16 *n = (struct art_node16 *)node;
+		struct art_node4 *new_node = (struct art_node4 *)
+			art_node_new(tree, ART_NODE4);
+		if (new_node == NULL)
+			return;
+		art_node_copy_header(&new_node->base, node);
+		memcpy(new_node->keys, n->keys, node->count);
+		memcpy(new_node->children, n->children,
+		       node->count * sizeof(n->children[0]));
+		art_node_delete(tree, node);
+		*ref = new_node;
+		return;
+	}
+	case ART_NODE48: {
+		if (node->count > 12)
+			return;
+		struct art_node48 *n = (struct art_node48 *)node;
+		struct art_node16 *new_node = (struct art_node16 *)
+			art_node_new(tree, ART_NODE16);
+		if (new_node == NULL)
+			return;
+		art_node_copy_header(&new_node->base, node);
+		int i = 0;
+		for (int b = 0; b < 256; b++) {
+			if (n->index[b] == 0)
+				continue;
+			new_node->keys[i] = b;
+			new_node->children[i] = n->children[n->index[b] - 1];
+			i++;
+		}
+		assert(i == node->count);
+		art_node_delete(tree, node);
+		*ref = new_node;
+		return;
+	}
+	case ART_NODE256: {
+		if (node->count > 37)
+			return;
+		struct art_node256 *n = (struct art_node256 *)node;
+		struct art_node48 *new_node = (struct art_node48 *)
+			art_node_new(tree, ART_NODE48);
+		if (new_node == NULL)
+			return;
+		art_node_copy_header(&new_node->base, node);
+		int slot = 0;
+		for (int b = 0; b < 256; b++) {
+			if (n->children[b] == NULL)
+				continue;
+			new_node->children[slot] = n->children[b];
+			new_node->index[b] = ++slot;
+		}
+		art_node_delete(tree, node);
+		*ref = new_node;
+		return;
+	}
+	default:
+		return;
+	}
+}
+
+void
+art_create(struct art *tree, art_key_f key_of, art_alloc_f alloc,
+	   art_free_f free, void *ctx)
+{
+	tree->root = NULL;
+	tree->size = 0;
+	tree->mem_used = 0;
+	tree->key_of = key_of;
+	tree->alloc = alloc;
+	tree->free = free;
+	tree->ctx = ctx;
+}
+
+/** Stack entry used for walking over a tree without recursion. */
+struct art_walk_entry {
+	/** Inner node. */
+	struct art_node *node;
+	/** Key byte of the next child to visit. */
+	int byte;
+};
+
+/**
+ * Visit all records of a tree in the key order. If @a cb is NULL,
+ * nodes are freed once all their children have been visited.
+ */
+static int
+art_walk(struct art *tree, art_foreach_f cb, void *arg)
+{
+	if (tree->root == NULL)
+		return 0;
+	if (art_is_leaf(tree->root))
+		return cb != NULL ? cb(art_leaf_record(tree->root), arg) : 0;
+	int capacity = 16;
+	struct art_walk_entry *stack = xmalloc(capacity * sizeof(*stack));
+	int depth = 0;
+	stack[depth++] = (struct art_walk_entry){tree->root, 0};
+	int rc = 0;
+	while (depth > 0) {
+		struct art_walk_entry *top = &stack[depth - 1];
+		int byte;
+		void *child = top->byte < 256 ?
+			art_node_next_child(top->node, top->byte, &byte) :
+			NULL;
+		if (child == NULL) {
+			if (cb == NULL)
+				art_node_delete(tree, top->node);
+			depth--;
+			continue;
+		}
+		top->byte = byte + 1;
+		if (art_is_leaf(child)) {
+			if (cb != NULL && (rc = cb(art_leaf_record(child),
+						   arg)) != 0)
+				break;
+			continue;
+		}
+		if (depth == capacity) {
+			capacity *= 2;
+			stack = xrealloc(stack, capacity * sizeof(*stack));
+		}
+		stack[depth++] = (struct art_walk_entry){child, 0};
+	}
+	free(stack);
+	return rc;
+}
+
+void
+art_destroy(struct art *tree)
+{
+	art_walk(tree, NULL, NULL);
+	assert(tree->mem_used == 0);
+	tree->root = NULL;
+	tree->size = 0;
+}
+
+int
+art_foreach(struct art *tree, art_foreach_f cb, void *arg)
+{
+	assert(cb != NULL);
+	return art_walk(tree, cb, arg);
+}
+
+void *
+art_find(struct art *tree, const unsigned char *key, uint32_t len)
+{
+	const void *node = tree->root;
+	uint32_t depth = 0;
+	while (node != NULL && !art_is_leaf(node)) {
+		const struct art_node *n = node;
+		/*
+		 * Only check the stored part of the compressed path,
+		 * the whole key is compared with the leaf anyway.
+		 */
+		if (n->prefix_len > 0) {
+			if (n->prefix_len >= len - depth)
+				return NULL;
+			if (memcmp(n->prefix, key + depth,
+				   MIN(n->prefix_len,
+				       (uint32_t)ART_PREFIX_MAX)) != 0)
+				return NULL;
+			depth += n->prefix_len;
+		}
+		if (depth >= len)
+			return NULL;
+		void **child = art_node_find_child((struct art_node *)n,
+						   key[depth]);
+		if (child == NULL)
+			return NULL;
+		node = *child;
+		depth++;
+	}
+	if (node == NULL || !art_leaf_matches(tree, node, key, len))
+		return NULL;
+	return art_leaf_record(node);
+}
+
+/**
+ * Replace a leaf with a new node having two children: the leaf and
+ * a leaf for the new record.
+ */
+static int
+art_split_leaf(struct art *tree, void **ref, uint32_t depth,
+	       const unsigned char *key, uint32_t len, void *record)
+{
+	uint32_t leaf_len;
+	const unsigned char *leaf_key =
+		tree->key_of(art_leaf_record(*ref), &leaf_len, tree->ctx);
+	uint32_t i = depth;
+	while (i < len && i < leaf_len && key[i] == leaf_key[i])
+		i++;
+	/* Keys are prefix-free so they must differ before either ends. */
+	assert(i < len && i < leaf_len);
+	struct art_node *node = art_node_new(tree, ART_NODE4);
+	if (node == NULL)
+		return -1;
+	node->prefix_len = i - depth;
+	memcpy(node->prefix, key + depth,
+	       MIN(node->prefix_len, (uint32_t)ART_PREFIX_MAX));
+	struct art_node4 *n = (struct art_node4 *)node;
+	void *leaf = art_leaf_new(record);
+	if (key[i] < leaf_key[i]) {
+		n->keys[0] = key[i];
+		n->children[0] = leaf;
+		n->keys[1] = leaf_key[i];
+		n->children[1] = *ref;
+	} else {
+		n->keys[0] = leaf_key[i];
+		n->children[0] = *ref;
+		n->keys[1] = key[i];
+		n->children[1] = leaf;
+	}
+	node->count = 2;
+	*ref = node;
+	return 0;
+}
+
+/**
+ * Split the compressed path of a node at the first mismatching byte
+ * and insert a leaf for the new record there.
+ */
+static int
+art_split_prefix(struct art *tree, void **ref, uint32_t depth,
+		 uint32_t mismatch, const unsigned char *prefix,
+		 const unsigned char *key, void *record)
+{
+	struct art_node *node = *ref;
+	assert(mismatch < node->prefix_len);
+	struct art_node *parent = art_node_new(tree, ART_NODE4);
+	if (parent == NULL)
+		return -1;
+	parent->prefix_len = mismatch;
+	memcpy(parent->prefix, prefix,
+	       MIN(mismatch, (uint32_t)ART_PREFIX_MAX));
+	unsigned char c = prefix[mismatch];
+	/* The prefix may point to the node, so use memmove. */
+	node->prefix_len -= mismatch + 1;
+	memmove(node->prefix, prefix + mismatch + 1,
+		MIN(node->prefix_len, (uint32_t)ART_PREFIX_MAX));
+	struct art_node4 *n = (struct art_node4 *)parent;
+	void *leaf = art_leaf_new(record);
+	unsigned char leaf_c = key[depth + mismatch];
+	assert(leaf_c != c);
+	if (leaf_c < c) {
+		n->keys[0] = leaf_c;
+		n->children[0] = leaf;
+		n->keys[1] = c;
+		n->children[1] = node;
+	} else {
+		n->keys[0] = c;
+		n->children[0] = node;
+		n->keys[1] = leaf_c;
+		n->children[1] = leaf;
+	}
+	parent->count = 2;
+	*ref = parent;
+	return 0;
+}
+
+int
+art_insert(struct art *tree, const unsigned char *key, uint32_t len,
+	   void *record, void **replaced)
+{
+	*replaced = NULL;
+	void **ref = &tree->root;
+	uint32_t depth = 0;
+	while (true) {
+		void *node = *ref;
+		if (node == NULL) {
+			*ref = art_leaf_new(record);
+			tree->size++;
+			return 0;
+		}
+		if (art_is_leaf(node)) {
+			if (art_leaf_matches(tree, node, key, len)) {
+				*replaced = art_leaf_record(node);
+				*ref = art_leaf_new(record);
+				return 0;
+			}
+			if (art_split_leaf(tree, ref, depth, key, len,
+					   record) != 0)
+				return -1;
+			tree->size++;
+			return 0;
+		}
+		struct art_node *n = node;
+		if (n->prefix_len > 0) {
+			const unsigned char *prefix =
+				art_node_prefix(tree, n, depth);
+			uint32_t max = MIN(n->prefix_len, len - depth);
+			uint32_t i = 0;
+			while (i < max && prefix[i] == key[depth + i])
+				i++;
+			if (i < n->prefix_len) {
+				if (art_split_prefix(tree, ref, depth, i,
+						     prefix, key,
+						     record) != 0)
+					return -1;
+				tree->size++;
+				return 0;
+			}
+			depth += n->prefix_len;
+		}
+		assert(depth < len);
+		void **child = art_node_find_child(n, key[depth]);
+		if (child == NULL) {
+			if (art_node_add_child(tree, ref, n, key[depth],
+					       art_leaf_new(record)) != 0)
+				return -1;
+			tree->size++;
+			return 0;
+		}
+		ref = child;
+		depth++;
+	}
+}
+
+void *
+art_delete(struct art *tree, const unsigned char *key, uint32_t len)
+{
+	void **ref = &tree->root;
+	void **parent_ref = NULL;
+	unsigned char parent_c = 0;
+	uint32_t depth = 0;
+	while (*ref != NULL && !art_is_leaf(*ref)) {
+		struct art_node *n = *ref;
+		if (n->prefix_len > 0) {
+			if (n->prefix_len >= len - depth)
+				return NULL;
+			if (memcmp(n->prefix, key + depth,
+				   MIN(n->prefix_len,
+				       (uint32_t)ART_PREFIX_MAX)) != 0)
+				return NULL;
+			depth += n->prefix_len;
+		}
+		if (depth >= len)
+			return NULL;
+		void **child = art_node_find_child(n, key[depth]);
+		if (child == NULL)
+			return NULL;
+		parent_ref = ref;
+		parent_c = key[depth];
+		ref = child;
+		depth++;
+	}
+	if (*ref == NULL || !art_leaf_matches(tree, *ref, key, len))
+		return NULL;
+	void *record = art_leaf_record(*ref);
+	if (parent_ref == NULL)
+		tree->root = NULL;
+	else
+		art_node_remove_child(tree, parent_ref, *parent_ref, parent_c);
+	tree->size--;
+	return record;
+}
+
+/**
+ * Compare the key of a record with the given key. If the record key
+ * starts with the given key, @a prefix_cmp is returned.
+ */
+static int
+art_leaf_compare(struct art *tree, const void *leaf,
+		 const unsigned char *key, uint32_t len, int prefix_cmp)
+{
+	uint32_t leaf_len;
+	const unsigned char *leaf_key =
+		tree->key_of(art_leaf_record(leaf), &leaf_len, tree->ctx);
+	int cmp = memcmp(leaf_key, key, MIN(leaf_len, len));
+	if (cmp != 0)
+		return cmp;
+	return leaf_len >= len ? prefix_cmp : -1;
+}
+
+void *
+art_seek_ge(struct art *tree, const unsigned char *key, uint32_t len,
+	    bool skip_prefix)
+{
+	const void *node = tree->root;
+	/*
+	 * The subtree with the least keys greater than the key prefix
+	 * matched so far. Its first record is the answer if the search
+	 * fails to go further down.
+	 */
+	const void *next = NULL;
+	uint32_t depth = 0;
+	while (node != NULL) {
+		if (depth >= len) {
+			/* All records of the subtree start with the key. */
+			if (!skip_prefix)
+				return art_subtree_first(node);
+			break;
+		}
+		if (art_is_leaf(node)) {
+			if (art_leaf_compare(tree, node, key, len,
+					     skip_prefix ? -1 : 0) >= 0)
+				return art_leaf_record(node);
+			break;
+		}
+		const struct art_node *n = node;
+		if (n->prefix_len > 0) {
+			const unsigned char *prefix =
+				art_node_prefix(tree, n, depth);
+			int cmp = memcmp(prefix, key + depth,
+					 MIN(n->prefix_len, len - depth));
+			if (cmp > 0)
+				return art_subtree_first(node);
+			if (cmp < 0)
+				break;
+			depth += n->prefix_len;
+			if (depth >= len)
+				continue;
+		}
+		int c = key[depth];
+		int byte;
+		const void *sibling = art_node_next_child(n, c + 1, &byte);
+		if (sibling != NULL)
+			next = sibling;
+		void **child = art_node_find_child((struct art_node *)n, c);
+		if (child == NULL)
+			break;
+		node = *child;
+		depth++;
+	}
+	return art_subtree_first(next);
+}
+
+void *
+art_seek_le(struct art *tree, const unsigned char *key, uint32_t len,
+	    bool include_prefix)
+{
+	const void *node = tree->root;
+	/*
+	 * The subtree with the greatest keys less than the key prefix
+	 * matched so far. Its last record is the answer if the search
+	 * fails to go further down.
+	 */
+	const void *prev = NULL;
+	uint32_t depth = 0;
+	while (node != NULL) {
+		if (depth >= len) {
+			/* All records of the subtree start with the key. */
+			if (include_prefix)
+				return art_subtree_last(node);
+			break;
+		}
+		if (art_is_leaf(node)) {
+			if (art_leaf_compare(tree, node, key, len,
+					     include_prefix ? -1 : 0) < 0)
+				return art_leaf_record(node);
+			break;
+		}
+		const struct art_node *n = node;
+		if (n->prefix_len > 0) {
+			const unsigned char *prefix =
+				art_node_prefix(tree, n, depth);
+			int cmp = memcmp(prefix, key + depth,
+					 MIN(n->prefix_len, len - depth));
+			if (cmp < 0)
+				return art_subtree_last(node);
+			if (cmp > 0)
+				break;
+			depth += n->prefix_len;
+			if (depth >= len)
+				continue;
+		}
+		int c = key[depth];
+		const void *sibling = art_node_prev_child(n, c - 1);
+		if (sibling != NULL)
+			prev = sibling;
+		void **child = art_node_find_child((struct art_node *)n, c);
+		if (child == NULL)
+			break;
+		node = *child;
+		depth++;
+	}
+	return art_subtree_last(prev);
+}
@@ -0,0 +1,177 @@
+#ifndef TARANTOOL_LIB_SALAD_ART_H_INCLUDED
+#define TARANTOOL_LIB_SALAD_ART_H_INCLUDED
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Adaptive radix tree:
+ *  Leis, Viktor; Kemper, Alfons; Neumann, Thomas (2013),
+ *  "The Adaptive Radix Tree: ARTful Indexing for Main-Memory Databases"
+ *
+ * The tree maps binary keys to records. Inner nodes grow from 4 to 16,
+ * 48 and 256 children as needed and store compressed paths, leaves are
+ * records themselves, so a point lookup touches one node per distinct
+ * key byte position and never compares whole keys except at the leaf.
+ * Records are iterated in the memcmp order of their keys.
+ *
+ * The tree doesn't store keys: they are fetched from records with a
+ * callback when needed. Keys must be prefix-free, i.e. no key may be
+ * a prefix of another key, and records must be at least 2-byte aligned,
+ * because the lowest bit of a child pointer is used to tell leaves from
+ * inner nodes.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Return the key of a record and store its length in @a len. The key
+ * must stay valid until the next invocation of the callback.
+ */
+typedef const unsigned char *
+(*art_key_f)(void *record, uint32_t *len, void *ctx);
+
+/** Allocate a tree node of the given size. Returns NULL on error. */
+typedef void *
+(*art_alloc_f)(void *ctx, size_t size);
+
+/** Free a tree node allocated with art_alloc_f. */
+typedef void
+(*art_free_f)(void *ctx, void *ptr, size_t size);
+
+/**
+ * Callback invoked by art_foreach() for each record. Iteration stops
+ * if it returns a non-zero value.
+ */
+typedef int
+(*art_foreach_f)(void *record, void *arg);
+
+/** Adaptive radix tree. */
+struct art {
+	/** Root node, tagged as a leaf if the tree stores one record. */
+	void *root;
+	/** Number of records stored in the tree. */
+	size_t size;
+	/** Total size of allocated nodes. */
+	size_t mem_used;
+	/** Record key getter. */
+	art_key_f key_of;
+	/** Node allocator. */
+	art_alloc_f alloc;
+	/** Node deallocator. */
+	art_free_f free;
+	/** Context passed to the callbacks. */
+	void *ctx;
+};
+
+enum {
+	/**
+	 * Number of distinct node sizes passed to art_alloc_f, useful
+	 * for allocating nodes from fixed size pools.
+	 */
+	ART_NODE_SIZE_COUNT = 4,
+};
+
+/** Initialize an empty tree. */
+void
+art_create(struct art *tree, art_key_f key_of, art_alloc_f alloc,
+	   art_free_f free, void *ctx);
+
+/** Free all tree nodes. Records are left intact. */
+void
+art_destroy(struct art *tree);
+
+/** Return the number of records stored in a tree. */
+static inline size_t
+art_size(const struct art *tree)
+{
+	return tree->size;
+}
+
+/** Return the record with the given key or NULL. */
+void *
+art_find(struct art *tree, const unsigned char *key, uint32_t len);
+
+/**
+ * Insert a record with the given key. If there's already a record with
+ * the same key, it is replaced and returned in @a replaced, otherwise
+ * @a replaced is set to NULL. Replacing a record never fails.
+ *
+ * @retval 0 success
+ * @retval -1 memory allocation error, the tree is left unchanged
+ */
+int
+art_insert(struct art *tree, const unsigned char *key, uint32_t len,
+	   void *record, void **replaced);
+
+/**
+ * Delete the record with the given key. Returns the deleted record or
+ * NULL if there's no such record. Never fails.
+ */
+void *
+art_delete(struct art *tree, const unsigned char *key, uint32_t len);
+
+/**
+ * Return the first record whose key is greater than or equal to the
+ * given key or NULL. If @a skip_prefix is set, records whose keys start
+ * with the given key are skipped. An empty key matches all records.
+ */
+void *
+art_seek_ge(struct art *tree, const unsigned char *key, uint32_t len,
+	    bool skip_prefix);
+
+/**
+ * Return the last record whose key is less than the given key or NULL.
+ * If @a include_prefix is set, records whose keys start with the given
+ * key are considered less than it.
+ */
+void *
+art_seek_le(struct art *tree, const unsigned char *key, uint32_t len,
+	    bool include_prefix);
+
+/**
+ * Invoke a callback for each record in the key order. Returns the
+ * value returned by the callback that stopped the iteration or 0.
+ * The tree must not be modified until the iteration completes.
+ */
+int
+art_foreach(struct art *tree, art_foreach_f cb, void *arg);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_SALAD_ART_H_INCLUDED */
@@ -306,6 +306,11 @@
 #error "BPS_TREE_IS_IDENTICAL must be defined"
 #endif
 
+#if defined(BPS_TREE_ELEM_HINT) && \
+	(!defined(BPS_TREE_KEY_HINT) || !defined(BPS_TREE_USE_HINT))
+#error "BPS_TREE_KEY_HINT and BPS_TREE_USE_HINT must be defined with hints"
+#endif
+
 /**
  * A switch to define the type of search in an array elements.
  * By default, bps_tree uses binary search to find a particular
@@ -315,6 +320,20 @@
  * #define BPS_BLOCK_LINEAR_SEARCH
  */
 
+/**
+ * Optional comparison hints. A hint is a 64-bit unsigned integer stored
+ * in an element (or a key) such that if hints of two elements differ,
+ * the elements compare the same way as their hints. UINT64_MAX means
+ * that the hint is unknown. If hints are defined, a search in a block
+ * compares the hints inline and calls the comparator only if the hints
+ * are equal or unknown, which is much cheaper if the comparator is heavy
+ * and has to dereference the elements. BPS_TREE_USE_HINT tells if the
+ * hints of a tree are comparison hints, it's evaluated once per search.
+ * #define BPS_TREE_ELEM_HINT(elem) (elem).hint
+ * #define BPS_TREE_KEY_HINT(key) (key)->hint
+ * #define BPS_TREE_USE_HINT(arg) true
+ */
+
 /**
  * A switch to make the tree store the cardinality of each of its
  * child blocks in an array. A block cardinality is the amount of
@@ -499,6 +518,7 @@ typedef int64_t bps_tree_block_card_t;
 #define bps_tree_root _bps_tree(root)
 #define bps_tree_touch_block _bps_tree(touch_block)
 #define bps_tree_calc_path_offset _bps_tree(calc_path_offset)
+#define bps_tree_hint_compare _bps_tree(hint_compare)
 #define bps_tree_find_ins_point_key _bps_tree(find_ins_point_key)
 #define bps_tree_find_ins_point_elem _bps_tree(find_ins_point_elem)
 #define bps_tree_find_ins_point_offset _bps_tree(find_ins_point_offset)
@@ -1999,6 +2019,32 @@ bps_tree_calc_path_offset(struct bps_tree_common *tree,
 
 #endif
 
+/**
+ * @brief Compare hints of an element and a value.
+ * @param elem_hint - hint of the element
+ * @param hint - hint of the value
+ * @return - -1 or 1 if the element is less or greater than the value,
+ *           0 if the hints are equal or unknown so the element must
+ *           be compared with the comparator
+ */
+static inline int
+bps_tree_hint_compare(uint64_t elem_hint, uint64_t hint)
+{
+	if (elem_hint == hint || elem_hint == UINT64_MAX || hint == UINT64_MAX)
+		return 0;
+	return elem_hint < hint ? -1 : 1;
+}
+
+#ifdef BPS_TREE_ELEM_HINT
+#define BPS_TREE_SEARCH_HINT(hint) \
+	(BPS_TREE_USE_HINT(tree->arg) ? (uint64_t)(hint) : UINT64_MAX)
+#define BPS_TREE_HINT_COMPARE(elem, hint) \
+	bps_tree_hint_compare(BPS_TREE_ELEM_HINT(elem), hint)
+#else
+#define BPS_TREE_SEARCH_HINT(hint) UINT64_MAX
+#define BPS_TREE_HINT_COMPARE(elem, hint) 0
+#endif
+
 /**
  * @brief Find the lowest element in sorted array that is >= than the key
  * @param tree - pointer to a tree
@@ -2016,9 +2062,13 @@ bps_tree_find_ins_point_key(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	uint64_t hint = BPS_TREE_SEARCH_HINT(BPS_TREE_KEY_HINT(key));
+	(void)hint;
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
-		int res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*begin, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
 		if (res >= 0) {
 			*exact = res == 0;
 			return (bps_tree_pos_t)(begin - arr);
@@ -2029,7 +2079,9 @@ bps_tree_find_ins_point_key(const struct bps_tree_common *tree,
 #else
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
-		int res = BPS_TREE_COMPARE_KEY(*mid, key, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*mid, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE_KEY(*mid, key, tree->arg);
 		if (res > 0) {
 			end = mid;
 		} else if (res < 0) {
@@ -2061,9 +2113,13 @@ bps_tree_find_ins_point_elem(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	uint64_t hint = BPS_TREE_SEARCH_HINT(BPS_TREE_ELEM_HINT(elem));
+	(void)hint;
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
-		int res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*begin, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
 		if (res >= 0) {
 			*exact = res == 0;
 			return (bps_tree_pos_t)(begin - arr);
@@ -2074,7 +2130,9 @@ bps_tree_find_ins_point_elem(const struct bps_tree_common *tree,
 #else
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
-		int res = BPS_TREE_COMPARE(*mid, elem, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*mid, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE(*mid, elem, tree->arg);
 		if (res > 0) {
 			end = mid;
 		} else if (res < 0) {
@@ -2148,9 +2206,13 @@ bps_tree_find_after_ins_point_key(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	uint64_t hint = BPS_TREE_SEARCH_HINT(BPS_TREE_KEY_HINT(key));
+	(void)hint;
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
-		int res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*begin, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE_KEY(*begin, key, tree->arg);
 		if (res == 0)
 			*exact = true;
 		else if (res > 0)
@@ -2161,7 +2223,9 @@ bps_tree_find_after_ins_point_key(const struct bps_tree_common *tree,
 #else
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
-		int res = BPS_TREE_COMPARE_KEY(*mid, key, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*mid, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE_KEY(*mid, key, tree->arg);
 		if (res > 0) {
 			end = mid;
 		} else if (res < 0) {
@@ -2193,9 +2257,13 @@ bps_tree_find_after_ins_point_elem(const struct bps_tree_common *tree,
 	bps_tree_elem_t *begin = arr;
 	bps_tree_elem_t *end = arr + size;
 	*exact = false;
+	uint64_t hint = BPS_TREE_SEARCH_HINT(BPS_TREE_ELEM_HINT(elem));
+	(void)hint;
 #ifdef BPS_BLOCK_LINEAR_SEARCH
 	while (begin != end) {
-		int res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*begin, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE(*begin, elem, tree->arg);
 		if (res == 0)
 			*exact = true;
 		else if (res > 0)
@@ -2206,7 +2274,9 @@ bps_tree_find_after_ins_point_elem(const struct bps_tree_common *tree,
 #else
 	while (begin != end) {
 		bps_tree_elem_t *mid = begin + (end - begin) / 2;
-		int res = BPS_TREE_COMPARE(*mid, elem, tree->arg);
+		int res = BPS_TREE_HINT_COMPARE(*mid, hint);
+		if (res == 0)
+			res = BPS_TREE_COMPARE(*mid, elem, tree->arg);
 		if (res > 0) {
 			end = mid;
 		} else if (res < 0) {
@@ -2219,6 +2289,9 @@ bps_tree_find_after_ins_point_elem(const struct bps_tree_common *tree,
 	return (bps_tree_pos_t)(end - arr);
 #endif
 }
+
+#undef BPS_TREE_SEARCH_HINT
+#undef BPS_TREE_HINT_COMPARE
 /**
  * @brief Get an invalid iterator. See iterator description.
  * @return - Invalid iterator
@@ -7956,6 +8029,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_root
 #undef bps_tree_touch_block
 #undef bps_tree_calc_path_offset
+#undef bps_tree_hint_compare
 #undef bps_tree_find_ins_point_key
 #undef bps_tree_find_ins_point_elem
 #undef bps_tree_find_ins_point_offset
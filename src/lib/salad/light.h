@@ -307,6 +307,17 @@ LIGHT(view_find_key)(const struct LIGHT(view) *v, uint32_t hash,
 static inline uint32_t
 LIGHT(insert)(struct LIGHT(core) *ht, uint32_t hash, LIGHT_DATA_TYPE data);
 
+/**
+ * @brief Allocate slots for the given number of records beforehand,
+ *  so that inserting them does not enlarge the table. Works only on
+ *  an empty hash table, does nothing if the table has any records.
+ * @param ht - pointer to a hash table struct
+ * @param count - number of records to allocate slots for
+ * @return 0 if ok, -1 on memory error
+ */
+static inline int
+LIGHT(reserve)(struct LIGHT(core) *ht, uint32_t count);
+
 /**
  * @brief Replace a record with given hash and value
  * @param ht - pointer to a hash table struct
@@ -643,6 +654,61 @@ LIGHT(view_find_key)(const struct LIGHT(view) *v, uint32_t hash,
 	return LIGHT(find_key_impl)(&v->common, hash, key);
 }
 
+/**
+ * @brief Prefetch the record a search for the given hash starts with
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash to be looked up soon
+ */
+static inline void
+LIGHT(prefetch)(const struct LIGHT(core) *ht, uint32_t hash)
+{
+	const struct LIGHT(common) *common = &ht->common;
+	if (common->count == 0)
+		return;
+	uint32_t slot = LIGHT(slot)(common, hash);
+	__builtin_prefetch(LIGHT(get_record)(common, slot));
+}
+
+/**
+ * @brief Find records with given hashes and values
+ * Works as light_find() called for each value, but prefetches the
+ * records of all values first so that cache misses of independent
+ * lookups overlap.
+ * @param ht - pointer to a hash table struct
+ * @param hashes - hashes to find
+ * @param values - values to find
+ * @param count - number of values
+ * @param slots - array where found record IDs (or light_end) are stored
+ */
+static inline void
+LIGHT(find_batch)(const struct LIGHT(core) *ht, const uint32_t *hashes,
+		  LIGHT_DATA_TYPE *values, uint32_t count, uint32_t *slots)
+{
+	for (uint32_t i = 0; i < count; i++)
+		LIGHT(prefetch)(ht, hashes[i]);
+	for (uint32_t i = 0; i < count; i++)
+		slots[i] = LIGHT(find)(ht, hashes[i], values[i]);
+}
+
+/**
+ * @brief Find records with given hashes and keys
+ * Same as light_find_batch(), but looks up by keys.
+ * @param ht - pointer to a hash table struct
+ * @param hashes - hashes to find
+ * @param keys - keys to find
+ * @param count - number of keys
+ * @param slots - array where found record IDs (or light_end) are stored
+ */
+static inline void
+LIGHT(find_key_batch)(const struct LIGHT(core) *ht, const uint32_t *hashes,
+		      LIGHT_KEY_TYPE *keys, uint32_t count, uint32_t *slots)
+{
+	for (uint32_t i = 0; i < count; i++)
+		LIGHT(prefetch)(ht, hashes[i]);
+	for (uint32_t i = 0; i < count; i++)
+		slots[i] = LIGHT(find_key)(ht, hashes[i], keys[i]);
+}
+
 /**
  * @brief Replace a record with given hash and value
  * @param htab - pointer to a hash table struct
@@ -941,6 +1007,48 @@ LIGHT(grow)(struct LIGHT(common) *ht)
 	return 0;
 }
 
+/**
+ * @brief Allocate slots for the given number of records beforehand
+ * @param htab - pointer to a hash table struct
+ * @param count - number of records to allocate slots for
+ * @return 0 if ok, -1 on memory error
+ */
+static inline int
+LIGHT(reserve)(struct LIGHT(core) *htab, uint32_t count)
+{
+	struct LIGHT(common) *ht = &htab->common;
+	/*
+	 * There are no chains to split in an empty table, so new slots
+	 * can be added in bulk just by linking them into the list of
+	 * empty records.
+	 */
+	if (ht->count != 0)
+		return 0;
+	assert(!matras_is_read_view_created(ht->view));
+	if (ht->table_size == 0)
+		ht->cover_mask = 0;
+	while (ht->table_size < count) {
+		/* See the comment in LIGHT(grow). */
+		if ((size_t)ht->table_size + LIGHT_GROW_INCREMENT >= UINT32_MAX)
+			return -1;
+		uint32_t slot;
+		struct LIGHT(record) *record = (struct LIGHT(record) *)
+			matras_alloc_range(ht->mtable, &slot,
+					   LIGHT_GROW_INCREMENT);
+		if (!record)
+			return -1;
+		assert(slot == ht->table_size);
+		ht->table_size += LIGHT_GROW_INCREMENT;
+		while (ht->cover_mask < ht->table_size - 1)
+			ht->cover_mask = (ht->cover_mask << 1) | (uint32_t)1;
+		for (int i = 0; i < LIGHT_GROW_INCREMENT; i++) {
+			if (LIGHT(enqueue_empty)(ht, slot + i, record + i) != 0)
+				return -1;
+		}
+	}
+	return 0;
+}
+
 /**
  * @brief Insert a record with given hash and value
  * @param htab - pointer to a hash table struct
@@ -35,6 +35,8 @@
 #include <stddef.h>
 #include <sys/types.h>
 
+#include "qsort_arg.h"
+
 /*------------------------------------------------------------------------- */
 /* R-tree internal structures definition */
 /*------------------------------------------------------------------------- */
@@ -174,6 +176,59 @@ rtree_rect_neigh_distance2(const struct rtree_rect *rect,
 	return result;
 }
 
+/*
+ * Distance from a point coordinate to a segment along one axis.
+ * The segment is normalized so at most one of the terms is not zero.
+ */
+static inline sq_coord_t
+rtree_coord_neigh_diff(const coord_t *coords, coord_t neigh_coord)
+{
+	sq_coord_t lo = neigh_coord < coords[0] ?
+			(sq_coord_t)(coords[0] - neigh_coord) : 0;
+	sq_coord_t hi = neigh_coord > coords[1] ?
+			(sq_coord_t)(neigh_coord - coords[1]) : 0;
+	return lo + hi;
+}
+
+/* Manhattan distance, two dimensions */
+static inline sq_coord_t
+rtree_rect_neigh_distance_2d(const struct rtree_rect *rect,
+			     const struct rtree_rect *neigh_rect)
+{
+	return rtree_coord_neigh_diff(&rect->coords[2],
+				      neigh_rect->coords[2]) +
+	       rtree_coord_neigh_diff(&rect->coords[0],
+				      neigh_rect->coords[0]);
+}
+
+/* Euclid distance, squared, two dimensions */
+static inline sq_coord_t
+rtree_rect_neigh_distance2_2d(const struct rtree_rect *rect,
+			      const struct rtree_rect *neigh_rect)
+{
+	sq_coord_t dy = rtree_coord_neigh_diff(&rect->coords[2],
+					       neigh_rect->coords[2]);
+	sq_coord_t dx = rtree_coord_neigh_diff(&rect->coords[0],
+					       neigh_rect->coords[0]);
+	return dy * dy + dx * dx;
+}
+
+/* Distance of the tree type from a rectangle to a point */
+static inline sq_coord_t
+rtree_neigh_distance(const struct rtree *tree, const struct rtree_rect *rect,
+		     const struct rtree_rect *neigh_rect)
+{
+	if (tree->dimension == 2) {
+		if (tree->distance_type == RTREE_EUCLID)
+			return rtree_rect_neigh_distance2_2d(rect, neigh_rect);
+		return rtree_rect_neigh_distance_2d(rect, neigh_rect);
+	}
+	if (tree->distance_type == RTREE_EUCLID)
+		return rtree_rect_neigh_distance2(rect, neigh_rect,
+						  tree->dimension);
+	return rtree_rect_neigh_distance(rect, neigh_rect, tree->dimension);
+}
+
 static area_t
 rtree_rect_area(const struct rtree_rect *rect, unsigned dimension)
 {
@@ -325,15 +380,72 @@ rtree_rect_equal_to_rect(const struct rtree_rect *rt1,
 	return true;
 }
 
-static bool
-rtree_always_true(const struct rtree_rect *rt1,
-		  const struct rtree_rect *rt2,
-		  unsigned dimension)
+/*
+ * Versions of the comparators above for two dimensions. They have no
+ * branches and the same results for NaN coordinates.
+ */
+static inline bool
+rtree_rect_intersects_rect_2d(const struct rtree_rect *rt1,
+			      const struct rtree_rect *rt2,
+			      unsigned dimension)
 {
-	(void) rt1;
-	(void) rt2;
 	(void) dimension;
-	return true;
+	const coord_t *c1 = rt1->coords;
+	const coord_t *c2 = rt2->coords;
+	return !(c1[0] > c2[1]) & !(c1[1] < c2[0]) &
+	       !(c1[2] > c2[3]) & !(c1[3] < c2[2]);
+}
+
+static inline bool
+rtree_rect_in_rect_2d(const struct rtree_rect *rt1,
+		      const struct rtree_rect *rt2,
+		      unsigned dimension)
+{
+	(void) dimension;
+	const coord_t *c1 = rt1->coords;
+	const coord_t *c2 = rt2->coords;
+	return !(c1[0] < c2[0]) & !(c1[1] > c2[1]) &
+	       !(c1[2] < c2[2]) & !(c1[3] > c2[3]);
+}
+
+static inline bool
+rtree_rect_strict_in_rect_2d(const struct rtree_rect *rt1,
+			     const struct rtree_rect *rt2,
+			     unsigned dimension)
+{
+	(void) dimension;
+	const coord_t *c1 = rt1->coords;
+	const coord_t *c2 = rt2->coords;
+	return !(c1[0] <= c2[0]) & !(c1[1] >= c2[1]) &
+	       !(c1[2] <= c2[2]) & !(c1[3] >= c2[3]);
+}
+
+static inline bool
+rtree_rect_holds_rect_2d(const struct rtree_rect *rt1,
+			 const struct rtree_rect *rt2,
+			 unsigned dimension)
+{
+	return rtree_rect_in_rect_2d(rt2, rt1, dimension);
+}
+
+static inline bool
+rtree_rect_strict_holds_rect_2d(const struct rtree_rect *rt1,
+				const struct rtree_rect *rt2,
+				unsigned dimension)
+{
+	return rtree_rect_strict_in_rect_2d(rt2, rt1, dimension);
+}
+
+static inline bool
+rtree_rect_equal_to_rect_2d(const struct rtree_rect *rt1,
+			    const struct rtree_rect *rt2,
+			    unsigned dimension)
+{
+	(void) dimension;
+	const coord_t *c1 = rt1->coords;
+	const coord_t *c2 = rt2->coords;
+	return (c1[0] == c2[0]) & (c1[1] == c2[1]) &
+	       (c1[2] == c2[2]) & (c1[3] == c2[3]);
 }
 
 /*------------------------------------------------------------------------- */
@@ -370,6 +482,56 @@ rtree_branch_get(const struct rtree *tree, const struct rtree_page *page,
 		((char *)page->data + ind * tree->page_branch_size);
 }
 
+/*
+ * Page matchers compare the iterator rectangle with all branches of a
+ * page in one pass. The comparator is inlined and the loop has no data
+ * dependent branches, which matters for the search since most branches
+ * of a visited page usually don't match.
+ */
+#define RTREE_PAGE_MATCHER(cmp)						\
+static uint64_t								\
+cmp##_page(const struct rtree *tree, const struct rtree_page *page,	\
+	   const struct rtree_rect *rect)				\
+{									\
+	unsigned d = tree->dimension;					\
+	uint64_t mask = 0;						\
+	for (unsigned i = 0, n = page->n; i < n; i++) {			\
+		const struct rtree_page_branch *b =			\
+			rtree_branch_get(tree, page, i);		\
+		mask |= (uint64_t)cmp(rect, &b->rect, d) << i;		\
+	}								\
+	return mask;							\
+}
+
+RTREE_PAGE_MATCHER(rtree_rect_intersects_rect)
+RTREE_PAGE_MATCHER(rtree_rect_in_rect)
+RTREE_PAGE_MATCHER(rtree_rect_strict_in_rect)
+RTREE_PAGE_MATCHER(rtree_rect_holds_rect)
+RTREE_PAGE_MATCHER(rtree_rect_strict_holds_rect)
+RTREE_PAGE_MATCHER(rtree_rect_equal_to_rect)
+RTREE_PAGE_MATCHER(rtree_rect_intersects_rect_2d)
+RTREE_PAGE_MATCHER(rtree_rect_in_rect_2d)
+RTREE_PAGE_MATCHER(rtree_rect_strict_in_rect_2d)
+RTREE_PAGE_MATCHER(rtree_rect_holds_rect_2d)
+RTREE_PAGE_MATCHER(rtree_rect_strict_holds_rect_2d)
+RTREE_PAGE_MATCHER(rtree_rect_equal_to_rect_2d)
+
+#undef RTREE_PAGE_MATCHER
+
+/* Select the page matcher of a comparator for a tree dimension */
+#define rtree_page_matcher(dimension, cmp)				\
+	((dimension) == 2 ? cmp##_2d_page : cmp##_page)
+
+static uint64_t
+rtree_always_true_page(const struct rtree *tree,
+		       const struct rtree_page *page,
+		       const struct rtree_rect *rect)
+{
+	(void) tree;
+	(void) rect;
+	return ((uint64_t)1 << page->n) - 1;
+}
+
 static void
 rtree_branch_copy(struct rtree_page_branch *to,
 		  const struct rtree_page_branch *from, unsigned dimension)
@@ -722,65 +884,47 @@ rtree_page_purge(struct rtree *tree, struct rtree_page *page, int level)
 
 static bool
 rtree_iterator_goto_first(struct rtree_iterator *itr, unsigned sp,
-			  struct rtree_page* pg)
+			  struct rtree_page *pg);
+
+/*
+ * Go to the next matching branch of the page at the given level of
+ * the search path that has matching records in its subtree.
+ */
+static bool
+rtree_iterator_goto_next_in_page(struct rtree_iterator *itr, unsigned sp)
 {
-	unsigned d = itr->tree->dimension;
-	if (sp + 1 == itr->tree->height) {
-		for (unsigned i = 0, n = pg->n; i < n; i++) {
-			struct rtree_page_branch *b;
-			b = rtree_branch_get(itr->tree, pg, i);
-			if (itr->leaf_cmp(&itr->rect, &b->rect, d)) {
-				itr->stack[sp].page = pg;
-				itr->stack[sp].pos = i;
-				return true;
-			}
-		}
-	} else {
-		for (unsigned i = 0, n = pg->n; i < n; i++) {
-			struct rtree_page_branch *b;
-			b = rtree_branch_get(itr->tree, pg, i);
-			if (itr->intr_cmp(&itr->rect, &b->rect, d)
-			    && rtree_iterator_goto_first(itr, sp + 1,
-							 b->data.page))
-			{
-				itr->stack[sp].page = pg;
-				itr->stack[sp].pos = i;
-				return true;
-			}
-		}
+	bool is_leaf = sp + 1 == itr->tree->height;
+	while (itr->stack[sp].mask != 0) {
+		uint64_t mask = itr->stack[sp].mask;
+		unsigned i = __builtin_ctzll(mask);
+		itr->stack[sp].mask = mask & (mask - 1);
+		itr->stack[sp].pos = i;
+		if (is_leaf)
+			return true;
+		struct rtree_page_branch *b;
+		b = rtree_branch_get(itr->tree, itr->stack[sp].page, i);
+		if (rtree_iterator_goto_first(itr, sp + 1, b->data.page))
+			return true;
 	}
 	return false;
 }
 
+static bool
+rtree_iterator_goto_first(struct rtree_iterator *itr, unsigned sp,
+			  struct rtree_page *pg)
+{
+	rtree_page_matcher_t match = sp + 1 == itr->tree->height ?
+				     itr->leaf_match : itr->intr_match;
+	itr->stack[sp].page = pg;
+	itr->stack[sp].mask = match(itr->tree, pg, &itr->rect);
+	return rtree_iterator_goto_next_in_page(itr, sp);
+}
 
 static bool
 rtree_iterator_goto_next(struct rtree_iterator *itr, unsigned sp)
 {
-	unsigned d = itr->tree->dimension;
-	struct rtree_page *pg = itr->stack[sp].page;
-	if (sp + 1 == itr->tree->height) {
-		for (unsigned i = itr->stack[sp].pos, n = pg->n; ++i < n;) {
-			struct rtree_page_branch *b;
-			b = rtree_branch_get(itr->tree, pg, i);
-			if (itr->leaf_cmp(&itr->rect, &b->rect, d)) {
-				itr->stack[sp].pos = i;
-				return true;
-			}
-		}
-	} else {
-		for (int i = itr->stack[sp].pos, n = pg->n; ++i < n;) {
-			struct rtree_page_branch *b;
-			b = rtree_branch_get(itr->tree, pg, i);
-			if (itr->intr_cmp(&itr->rect, &b->rect, d)
-			    && rtree_iterator_goto_first(itr, sp + 1,
-							 b->data.page))
-			{
-				itr->stack[sp].page = pg;
-				itr->stack[sp].pos = i;
-				return true;
-			}
-		}
-	}
+	if (rtree_iterator_goto_next_in_page(itr, sp))
+		return true;
 	return sp > 0 ? rtree_iterator_goto_next(itr, sp - 1) : false;
 }
 
@@ -865,7 +1009,6 @@ static void
 rtree_iterator_process_neigh(struct rtree_iterator *itr,
 			     struct rtree_neighbor *neighbor)
 {
-	unsigned d = itr->tree->dimension;
 	void *child = neighbor->child;
 	struct rtree_page *pg = (struct rtree_page *)child;
 	int level = neighbor->level;
@@ -873,13 +1016,8 @@ rtree_iterator_process_neigh(struct rtree_iterator *itr,
 	for (int i = 0, n = pg->n; i < n; i++) {
 		struct rtree_page_branch *b;
 		b = rtree_branch_get(itr->tree, pg, i);
-		coord_t distance;
-		if (itr->tree->distance_type == RTREE_EUCLID)
-			distance = rtree_rect_neigh_distance2(&b->rect,
-							      &itr->rect, d);
-		else
-			distance = rtree_rect_neigh_distance(&b->rect,
-							     &itr->rect, d);
+		coord_t distance = rtree_neigh_distance(itr->tree, &b->rect,
+							&itr->rect);
 		struct rtree_neighbor *neigh =
 			rtree_iterator_new_neighbor(itr, b->data.page,
 						    distance, level - 1);
@@ -966,6 +1104,8 @@ rtree_init(struct rtree *tree, unsigned dimension,
 	       tree->page_branch_size * RTREE_OPTIMAL_BRANCHES_IN_PAGE);
 	tree->page_max_fill = (tree->page_size - sizeof(int)) /
 		tree->page_branch_size;
+	/* Iterators keep a bit mask of page branches */
+	assert(tree->page_max_fill <= 64);
 	tree->page_min_fill = tree->page_max_fill * 2 / 5;
 	tree->neighbours_in_page = (tree->page_size - sizeof(void *))
 		/ sizeof(struct rtree_neighbor);
@@ -1067,44 +1207,46 @@ rtree_search(const struct rtree *tree, const struct rtree_rect *rect,
 	rtree_rect_copy(&itr->rect, rect, tree->dimension);
 	itr->op = op;
 	assert(tree->height <= RTREE_MAX_HEIGHT);
+	unsigned d = tree->dimension;
 	switch (op) {
 	case SOP_ALL:
-		itr->intr_cmp = itr->leaf_cmp = rtree_always_true;
+		itr->intr_match = itr->leaf_match = rtree_always_true_page;
 		break;
 	case SOP_EQUALS:
-		itr->intr_cmp = rtree_rect_in_rect;
-		itr->leaf_cmp = rtree_rect_equal_to_rect;
+		itr->intr_match = rtree_page_matcher(d, rtree_rect_in_rect);
+		itr->leaf_match =
+			rtree_page_matcher(d, rtree_rect_equal_to_rect);
 		break;
 	case SOP_CONTAINS:
-		itr->intr_cmp = itr->leaf_cmp = rtree_rect_in_rect;
+		itr->intr_match = itr->leaf_match =
+			rtree_page_matcher(d, rtree_rect_in_rect);
 		break;
 	case SOP_STRICT_CONTAINS:
-		itr->intr_cmp = itr->leaf_cmp = rtree_rect_strict_in_rect;
+		itr->intr_match = itr->leaf_match =
+			rtree_page_matcher(d, rtree_rect_strict_in_rect);
 		break;
 	case SOP_OVERLAPS:
-		itr->intr_cmp = itr->leaf_cmp = rtree_rect_intersects_rect;
+		itr->intr_match = itr->leaf_match =
+			rtree_page_matcher(d, rtree_rect_intersects_rect);
 		break;
 	case SOP_BELONGS:
-		itr->intr_cmp = rtree_rect_intersects_rect;
-		itr->leaf_cmp = rtree_rect_holds_rect;
+		itr->intr_match =
+			rtree_page_matcher(d, rtree_rect_intersects_rect);
+		itr->leaf_match =
+			rtree_page_matcher(d, rtree_rect_holds_rect);
 		break;
 	case SOP_STRICT_BELONGS:
-		itr->intr_cmp = rtree_rect_intersects_rect;
-		itr->leaf_cmp = rtree_rect_strict_holds_rect;
+		itr->intr_match =
+			rtree_page_matcher(d, rtree_rect_intersects_rect);
+		itr->leaf_match =
+			rtree_page_matcher(d, rtree_rect_strict_holds_rect);
 		break;
 	case SOP_NEIGHBOR:
 		if (tree->root) {
 			struct rtree_rect cover;
 			rtree_page_cover(tree, tree->root, &cover);
-			sq_coord_t distance;
-			if (tree->distance_type == RTREE_EUCLID)
-				distance =
-				rtree_rect_neigh_distance2(&cover, rect,
-							   tree->dimension);
-			else
-				distance =
-				rtree_rect_neigh_distance(&cover, rect,
-							  tree->dimension);
+			sq_coord_t distance =
+				rtree_neigh_distance(tree, &cover, rect);
 			struct rtree_neighbor *n =
 				rtree_iterator_new_neighbor(itr, tree->root,
 							    distance,
@@ -1116,8 +1258,9 @@ rtree_search(const struct rtree *tree, const struct rtree_rect *rect,
 		}
 	}
 	if (tree->root && rtree_iterator_goto_first(itr, 0, tree->root)) {
-		itr->stack[tree->height-1].pos -= 1;
-		/* will be incremented by goto_next */
+		unsigned sp = tree->height - 1;
+		itr->stack[sp].mask |= (uint64_t)1 << itr->stack[sp].pos;
+		/* will be returned by goto_next */
 		itr->eof = false;
 		return true;
 	} else {
@@ -1138,6 +1281,173 @@ rtree_purge(struct rtree *tree)
 	}
 }
 
+/*------------------------------------------------------------------------- */
+/* R-tree bulk load */
+/*------------------------------------------------------------------------- */
+
+size_t
+rtree_bulk_entry_size(const struct rtree *tree)
+{
+	return tree->page_branch_size;
+}
+
+void
+rtree_bulk_entry_set(const struct rtree *tree, void *entries, size_t i,
+		     const struct rtree_rect *rect, record_t obj)
+{
+	struct rtree_page_branch *b = (struct rtree_page_branch *)
+		((char *)entries + i * tree->page_branch_size);
+	b->data.record = obj;
+	rtree_rect_copy(&b->rect, rect, tree->dimension);
+}
+
+/* Number of branches in a page built by bulk load. Some room is left
+ * so that the first insertions after the build don't split pages. */
+static unsigned
+rtree_bulk_fill(const struct rtree *tree)
+{
+	return tree->page_max_fill - tree->page_max_fill / 5;
+}
+
+size_t
+rtree_bulk_load_page_count(const struct rtree *tree, size_t count)
+{
+	unsigned fill = rtree_bulk_fill(tree);
+	size_t total = 0;
+	while (count > 0) {
+		count = (count + fill - 1) / fill;
+		total += count;
+		if (count == 1)
+			break;
+	}
+	return total;
+}
+
+/* Compare branches by the center of their rectangles along an axis */
+static int
+rtree_bulk_cmp(const void *a, const void *b, void *arg)
+{
+	unsigned axis = *(unsigned *)arg;
+	const struct rtree_page_branch *b1 = (const struct rtree_page_branch *)a;
+	const struct rtree_page_branch *b2 = (const struct rtree_page_branch *)b;
+	coord_t c1 = b1->rect.coords[axis * 2] + b1->rect.coords[axis * 2 + 1];
+	coord_t c2 = b2->rect.coords[axis * 2] + b2->rect.coords[axis * 2 + 1];
+	return c1 < c2 ? -1 : c1 > c2;
+}
+
+/* Return the smallest s such that s ^ k >= n */
+static size_t
+rtree_bulk_slab_count(size_t n, unsigned k)
+{
+	for (size_t s = 1; ; s++) {
+		size_t p = 1;
+		for (unsigned i = 0; i < k && p < n; i++)
+			p *= s;
+		if (p >= n)
+			return s;
+	}
+}
+
+/* Sort-Tile-Recursive ordering of branches: sort them along an axis, cut
+ * into slabs of whole pages and order each slab along the next axis.
+ * Consecutive runs of fill branches of the result are packed into pages,
+ * which are then close to squares (cubes etc) with little overlap. */
+static void
+rtree_bulk_sort(const struct rtree *tree, char *entries, size_t count,
+		unsigned axis, unsigned fill)
+{
+	qsort_arg(entries, count, tree->page_branch_size, rtree_bulk_cmp,
+		  &axis);
+	if (axis + 1 == tree->dimension || count <= fill)
+		return;
+	size_t page_count = (count + fill - 1) / fill;
+	size_t slab_count = rtree_bulk_slab_count(page_count,
+						  tree->dimension - axis);
+	size_t slab_size = (page_count + slab_count - 1) / slab_count * fill;
+	for (size_t i = 0; i < count; i += slab_size) {
+		size_t n = count - i < slab_size ? count - i : slab_size;
+		rtree_bulk_sort(tree, entries + i * tree->page_branch_size, n,
+				axis + 1, fill);
+	}
+}
+
+/* Pack sorted branches into pages of the given level (1 for leaves) and
+ * replace them in place with branches pointing to the new pages.
+ * Returns the number of pages or -1 on memory allocation error, in which
+ * case all the pages referenced by the branches are freed. */
+static ssize_t
+rtree_bulk_pack(struct rtree *tree, char *entries, size_t count,
+		unsigned fill, int level)
+{
+	size_t size = tree->page_branch_size;
+	size_t page_count = (count + fill - 1) / fill;
+	size_t pos = 0;
+	for (size_t i = 0; i < page_count; i++) {
+		size_t n = count - pos < fill ? count - pos : fill;
+		if (i + 2 == page_count &&
+		    count - pos - n < tree->page_min_fill) {
+			/* Don't leave the last page underfilled */
+			n = (count - pos) / 2;
+		}
+		struct rtree_page *page = rtree_page_alloc(tree);
+		if (page == NULL) {
+			for (size_t j = 0; j < i; j++) {
+				struct rtree_page_branch *b =
+					(struct rtree_page_branch *)
+					(entries + j * size);
+				rtree_page_purge(tree, b->data.page, level);
+			}
+			for (size_t j = pos; j < count && level > 1; j++) {
+				struct rtree_page_branch *b =
+					(struct rtree_page_branch *)
+					(entries + j * size);
+				rtree_page_purge(tree, b->data.page,
+						 level - 1);
+			}
+			return -1;
+		}
+		page->n = n;
+		memcpy(page->data, entries + pos * size, n * size);
+		pos += n;
+		/* The branches of the page have been copied (i < pos) */
+		struct rtree_page_branch *b =
+			(struct rtree_page_branch *)(entries + i * size);
+		rtree_page_cover(tree, page, &b->rect);
+		b->data.page = page;
+	}
+	assert(pos == count);
+	return page_count;
+}
+
+int
+rtree_bulk_load(struct rtree *tree, void *entries, size_t count)
+{
+	assert(tree->root == NULL);
+	if (count == 0)
+		return 0;
+	unsigned fill = rtree_bulk_fill(tree);
+	assert(fill >= 2 * tree->page_min_fill);
+	size_t n_pages = rtree_bulk_load_page_count(tree, count);
+	size_t level_count = count;
+	int level = 0;
+	do {
+		rtree_bulk_sort(tree, (char *)entries, level_count, 0, fill);
+		level++;
+		assert(level <= RTREE_MAX_HEIGHT);
+		ssize_t rc = rtree_bulk_pack(tree, (char *)entries,
+					     level_count, fill, level);
+		if (rc < 0)
+			return -1;
+		level_count = rc;
+	} while (level_count > 1);
+	tree->root = ((struct rtree_page_branch *)entries)->data.page;
+	tree->height = level;
+	tree->n_records = count;
+	tree->n_pages = n_pages;
+	tree->version++;
+	return 0;
+}
+
 size_t
 rtree_used_size(const struct rtree *tree)
 {
@@ -32,6 +32,7 @@
  */
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "small/matras.h"
 
 #define RB_COMPACT 1
@@ -110,6 +111,17 @@ typedef bool (*rtree_comparator_t)(const struct rtree_rect *rt1,
 				   const struct rtree_rect *rt2,
 				   unsigned dimension);
 
+struct rtree;
+struct rtree_page;
+
+/*
+ * Type of function, comparing a rectangle with rectangles of all
+ * branches of a tree page. Returns a bit mask of matching branches.
+ */
+typedef uint64_t (*rtree_page_matcher_t)(const struct rtree *tree,
+					 const struct rtree_page *page,
+					 const struct rtree_rect *rect);
+
 /* Type distance comparison */
 enum rtree_distance_type {
 	RTREE_EUCLID = 0, /* Euclid distance, sqrt(dx*dx + dy*dy) */
@@ -178,19 +190,21 @@ struct rtree_iterator
 	/* Position of ready-to-use list entry in allocated page */
 	unsigned page_pos;
 
-	/* Comparators for comparison rectagnle of the iterator with
-	 * rectangles of tree nodes. If the comparator returns true,
-	 * the node is accepted; if false - skipped.
+	/* Matchers for comparison rectagnle of the iterator with
+	 * rectangles of tree nodes. If the bit of a node is set in
+	 * the returned mask, the node is accepted; if not - skipped.
 	 */
-	/* Comparator for interanal (not leaf) nodes of the tree */
-	rtree_comparator_t intr_cmp;
-	/* Comparator for leaf nodes of the tree */
-	rtree_comparator_t leaf_cmp;
+	/* Matcher for interanal (not leaf) nodes of the tree */
+	rtree_page_matcher_t intr_match;
+	/* Matcher for leaf nodes of the tree */
+	rtree_page_matcher_t leaf_match;
 
 	/* Current path of search in tree */
 	struct {
 		struct rtree_page *page;
 		int pos;
+		/* Matching branches of the page after pos to visit */
+		uint64_t mask;
 	} stack[RTREE_MAX_HEIGHT];
 };
 
@@ -284,6 +298,49 @@ rtree_insert(struct rtree *tree, struct rtree_rect *rect, record_t obj);
 bool
 rtree_remove(struct rtree *tree, const struct rtree_rect *rect, record_t obj);
 
+/**
+ * @brief Size of an entry of an array passed to rtree_bulk_load()
+ * @param tree - pointer to a tree
+ */
+size_t
+rtree_bulk_entry_size(const struct rtree *tree);
+
+/**
+ * @brief Set an entry of an array passed to rtree_bulk_load()
+ * @param tree - pointer to a tree
+ * @param entries - array of rtree_bulk_entry_size() sized entries
+ * @param i - number of the entry to set
+ * @param rect - rectangle of the record
+ * @param obj - record
+ */
+void
+rtree_bulk_entry_set(const struct rtree *tree, void *entries, size_t i,
+		     const struct rtree_rect *rect, record_t obj);
+
+/**
+ * @brief Number of pages allocated by rtree_bulk_load() for given number
+ * of records. Useful for reserving memory before the build.
+ * @param tree - pointer to a tree
+ * @param count - number of records
+ */
+size_t
+rtree_bulk_load_page_count(const struct rtree *tree, size_t count);
+
+/**
+ * @brief Build a tree from all its records at once. The records are
+ * packed into pages with the Sort-Tile-Recursive algorithm, which is
+ * much faster than inserting them one by one and produces better filled
+ * pages with less overlap.
+ * @return 0 on success, -1 on memory allocation error, in which case
+ *  the tree is left empty
+ * @param tree - pointer to an empty tree
+ * @param entries - array of records set with rtree_bulk_entry_set(),
+ *  the array is reordered and overwritten by the build
+ * @param count - number of records
+ */
+int
+rtree_bulk_load(struct rtree *tree, void *entries, size_t count);
+
 /**
  * @brief Size of memory used by tree
  * @param tree - pointer to a tree
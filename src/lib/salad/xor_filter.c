@@ -0,0 +1,252 @@
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "xor_filter.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include <string.h>
+
+enum {
+	/* Number of seeds to try before enlarging the table */
+	XOR_FILTER_SEED_ATTEMPTS = 16,
+};
+
+/** Size of the table in bytes, without padding. */
+static size_t
+xor_filter_table_size(uint32_t segment_size, uint16_t fingerprint_bits)
+{
+	return ((uint64_t)segment_size * 3 * fingerprint_bits + 7) / 8;
+}
+
+/**
+ * Allocate a zeroed table. It is padded so that a fingerprint can
+ * always be accessed with a 4-byte load.
+ */
+static unsigned char *
+xor_filter_table_new(uint32_t segment_size, uint16_t fingerprint_bits)
+{
+	return calloc(xor_filter_table_size(segment_size,
+					    fingerprint_bits) +
+		      sizeof(uint32_t), 1);
+}
+
+/** Xor a fingerprint into a slot of the table. */
+static void
+xor_filter_xor(struct xor_filter *filter, uint32_t slot, uint32_t value)
+{
+	uint64_t bit = (uint64_t)slot * filter->fingerprint_bits;
+	unsigned char *p = filter->table + bit / 8;
+	value <<= bit % 8;
+	for (int i = 0; i < 4; i++)
+		p[i] ^= (unsigned char)(value >> (8 * i));
+}
+
+static int
+xor_filter_cmp_hash(const void *a, const void *b)
+{
+	xor_filter_hash_t l = *(const xor_filter_hash_t *)a;
+	xor_filter_hash_t r = *(const xor_filter_hash_t *)b;
+	return l < r ? -1 : l > r;
+}
+
+/** Entry of the peeling stack: a value and its slot. */
+struct xor_filter_peeled {
+	uint64_t h;
+	uint32_t slot;
+};
+
+/**
+ * Try to build a filter with the current seed and segment size.
+ * @return 0 - OK, 1 - peeling failed, -1 - memory error
+ */
+static int
+xor_filter_build(struct xor_filter *filter, const xor_filter_hash_t *hashes,
+		 uint32_t count)
+{
+	uint32_t capacity = 3 * filter->segment_size;
+	uint64_t *xor_mask = calloc(capacity, sizeof(*xor_mask));
+	uint32_t *slot_count = calloc(capacity, sizeof(*slot_count));
+	uint32_t *queue = malloc(capacity * sizeof(*queue));
+	struct xor_filter_peeled *stack = malloc((count + 1) *
+						 sizeof(*stack));
+	int rc = -1;
+	if (xor_mask == NULL || slot_count == NULL ||
+	    queue == NULL || stack == NULL)
+		goto out;
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t h = xor_filter_mix(hashes[i], filter->seed);
+		for (int j = 0; j < 3; j++) {
+			uint32_t slot = xor_filter_slot(filter, h, j);
+			xor_mask[slot] ^= h;
+			slot_count[slot]++;
+		}
+	}
+	/* Peel off slots that are referenced by exactly one value. */
+	uint32_t queue_size = 0;
+	for (uint32_t slot = 0; slot < capacity; slot++) {
+		if (slot_count[slot] == 1)
+			queue[queue_size++] = slot;
+	}
+	uint32_t stack_size = 0;
+	while (queue_size > 0) {
+		uint32_t slot = queue[--queue_size];
+		if (slot_count[slot] != 1)
+			continue;
+		uint64_t h = xor_mask[slot];
+		stack[stack_size].h = h;
+		stack[stack_size].slot = slot;
+		stack_size++;
+		for (int j = 0; j < 3; j++) {
+			uint32_t other = xor_filter_slot(filter, h, j);
+			xor_mask[other] ^= h;
+			if (--slot_count[other] == 1)
+				queue[queue_size++] = other;
+		}
+	}
+	if (stack_size < count) {
+		rc = 1;
+		goto out;
+	}
+	/*
+	 * Assign fingerprints in the reverse peeling order so that
+	 * each value's slot is set after its other two slots.
+	 */
+	memset(filter->table, 0, xor_filter_table_size(filter->segment_size,
+						       filter->fingerprint_bits));
+	while (stack_size > 0) {
+		struct xor_filter_peeled *e = &stack[--stack_size];
+		uint32_t f = xor_filter_fingerprint(filter, e->h);
+		for (int j = 0; j < 3; j++)
+			f ^= xor_filter_get(filter,
+					    xor_filter_slot(filter, e->h, j));
+		xor_filter_xor(filter, e->slot, f);
+	}
+	rc = 0;
+out:
+	free(xor_mask);
+	free(slot_count);
+	free(queue);
+	free(stack);
+	return rc;
+}
+
+int
+xor_filter_create(struct xor_filter *filter, const xor_filter_hash_t *hashes,
+		  uint32_t count, double false_positive_rate)
+{
+	double bits = ceil(-log2(false_positive_rate));
+	if (bits < 1)
+		bits = 1;
+	if (bits > XOR_FILTER_MAX_FINGERPRINT_BITS)
+		bits = XOR_FILTER_MAX_FINGERPRINT_BITS;
+	filter->fingerprint_bits = bits;
+
+	/* Peeling fails if there are duplicates so sort them out. */
+	xor_filter_hash_t *values = malloc((count + 1) * sizeof(*values));
+	if (values == NULL)
+		return -1;
+	memcpy(values, hashes, count * sizeof(*values));
+	qsort(values, count, sizeof(*values), xor_filter_cmp_hash);
+	uint32_t unique_count = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (unique_count == 0 || values[unique_count - 1] != values[i])
+			values[unique_count++] = values[i];
+	}
+
+	uint64_t capacity = 32 + ceil(1.23 * unique_count);
+	filter->segment_size = (capacity + 2) / 3;
+	filter->seed = 0;
+	filter->table = NULL;
+	int rc;
+	do {
+		free(filter->table);
+		filter->table = xor_filter_table_new(filter->segment_size,
+						     filter->fingerprint_bits);
+		if (filter->table == NULL) {
+			rc = -1;
+			break;
+		}
+		rc = xor_filter_build(filter, values, unique_count);
+		if (rc > 0 && ++filter->seed % XOR_FILTER_SEED_ATTEMPTS == 0) {
+			/* Unlucky, give the peeling some more room. */
+			filter->segment_size += filter->segment_size / 8 + 1;
+		}
+	} while (rc > 0);
+	free(values);
+	if (rc != 0) {
+		free(filter->table);
+		filter->table = NULL;
+	}
+	return rc;
+}
+
+void
+xor_filter_destroy(struct xor_filter *filter)
+{
+	free(filter->table);
+}
+
+double
+xor_filter_fpr(const struct xor_filter *filter)
+{
+	return ldexp(1, -filter->fingerprint_bits);
+}
+
+size_t
+xor_filter_store_size(const struct xor_filter *filter)
+{
+	return xor_filter_table_size(filter->segment_size,
+				     filter->fingerprint_bits);
+}
+
+char *
+xor_filter_store(const struct xor_filter *filter, char *table)
+{
+	size_t store_size = xor_filter_store_size(filter);
+	memcpy(table, filter->table, store_size);
+	return table + store_size;
+}
+
+int
+xor_filter_load_table(struct xor_filter *filter, const char *table)
+{
+	filter->table = xor_filter_table_new(filter->segment_size,
+					     filter->fingerprint_bits);
+	if (filter->table == NULL)
+		return -1;
+	memcpy(filter->table, table, xor_filter_store_size(filter));
+	return 0;
+}
@@ -0,0 +1,214 @@
+#ifndef TARANTOOL_LIB_SALAD_XOR_FILTER_H_INCLUDED
+#define TARANTOOL_LIB_SALAD_XOR_FILTER_H_INCLUDED
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Static xor filter:
+ *  Graf, Thomas Mueller; Lemire, Daniel (2020),
+ *  "Xor Filters: Faster and Smaller Than Bloom and Cuckoo Filters"
+ *  https://arxiv.org/abs/1912.08258
+ *
+ * The filter is built once from a known set of values and can't be
+ * updated afterwards. It uses about 1.23 * b bits per value for the
+ * false positive rate of 2^-b while a bloom filter needs 1.44 * b
+ * bits per value for the same rate. Fingerprints are bit-packed so
+ * that any b from 1 to XOR_FILTER_MAX_FINGERPRINT_BITS can be used.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+enum {
+	/* Max number of bits in a fingerprint. */
+	XOR_FILTER_MAX_FINGERPRINT_BITS = 24,
+};
+
+typedef uint32_t xor_filter_hash_t;
+
+/**
+ * Xor filter data structure
+ */
+struct xor_filter {
+	/* Number of fingerprints in each of the three segments */
+	uint32_t segment_size;
+	/* Number of bits in a fingerprint */
+	uint16_t fingerprint_bits;
+	/* Seed mixed into hashes, chosen at construction */
+	uint32_t seed;
+	/* Bit-packed fingerprints, 3 * segment_size of them */
+	unsigned char *table;
+};
+
+/* {{{ API declaration */
+
+/**
+ * Build a xor filter storing the given set of values.
+ *
+ * @param filter - structure to initialize
+ * @param hashes - hashes of the values, may contain duplicates
+ * @param count - number of hashes
+ * @param false_positive_rate - desired false positive rate
+ * @return 0 - OK, -1 - memory error
+ */
+int
+xor_filter_create(struct xor_filter *filter, const xor_filter_hash_t *hashes,
+		  uint32_t count, double false_positive_rate);
+
+/**
+ * Free resources of the xor filter
+ *
+ * @param filter - the xor filter
+ */
+void
+xor_filter_destroy(struct xor_filter *filter);
+
+/**
+ * Query for presence of a value in the data set
+ * @param filter - the xor filter
+ * @param hash - hash of the value
+ * @return true - the value could be in data set; false - the value is
+ *  definitively not in data set
+ */
+static bool
+xor_filter_maybe_has(const struct xor_filter *filter, xor_filter_hash_t hash);
+
+/**
+ * Return the expected false positive rate of a xor filter.
+ * @param filter - the xor filter
+ * @return - expected false positive rate
+ */
+double
+xor_filter_fpr(const struct xor_filter *filter);
+
+/**
+ * Calculate size of a buffer that is needed for storing xor table
+ * @param filter - the xor filter to store
+ * @return - Exact size
+ */
+size_t
+xor_filter_store_size(const struct xor_filter *filter);
+
+/**
+ * Store xor filter table to the given buffer
+ * Other struct xor_filter members must be stored manually.
+ * @param filter - the xor filter to store
+ * @param table - buffer to store to
+ * #return - end of written buffer
+ */
+char *
+xor_filter_store(const struct xor_filter *filter, char *table);
+
+/**
+ * Allocate table and load it from given buffer.
+ * Other struct xor_filter members must be loaded manually.
+ *
+ * @param filter - structure to load to
+ * @param table - data to load
+ * @return 0 - OK, -1 - memory error
+ */
+int
+xor_filter_load_table(struct xor_filter *filter, const char *table);
+
+/* }}} API declaration */
+
+/* {{{ API definition */
+
+/** Mix a value hash with the filter seed into a 64-bit hash. */
+static inline uint64_t
+xor_filter_mix(xor_filter_hash_t hash, uint32_t seed)
+{
+	uint64_t h = ((uint64_t)seed << 32) | hash;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/** Map a 32-bit value to [0, n) without division. */
+static inline uint32_t
+xor_filter_reduce(uint32_t value, uint32_t n)
+{
+	return (uint32_t)(((uint64_t)value * n) >> 32);
+}
+
+/** Return the position of a value in the i-th segment. */
+static inline uint32_t
+xor_filter_slot(const struct xor_filter *filter, uint64_t h, int i)
+{
+	uint64_t r = i == 0 ? h : (h << (21 * i)) | (h >> (64 - 21 * i));
+	return i * filter->segment_size +
+	       xor_filter_reduce((uint32_t)r, filter->segment_size);
+}
+
+/** Return the fingerprint of a value. */
+static inline uint32_t
+xor_filter_fingerprint(const struct xor_filter *filter, uint64_t h)
+{
+	return (uint32_t)(h ^ (h >> 32)) &
+	       ((1U << filter->fingerprint_bits) - 1);
+}
+
+/** Return the fingerprint stored in a slot of the table. */
+static inline uint32_t
+xor_filter_get(const struct xor_filter *filter, uint32_t slot)
+{
+	uint64_t bit = (uint64_t)slot * filter->fingerprint_bits;
+	const unsigned char *p = filter->table + bit / 8;
+	uint32_t word = (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+			(uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+	return (word >> (bit % 8)) & ((1U << filter->fingerprint_bits) - 1);
+}
+
+static inline bool
+xor_filter_maybe_has(const struct xor_filter *filter, xor_filter_hash_t hash)
+{
+	uint64_t h = xor_filter_mix(hash, filter->seed);
+	uint32_t f = xor_filter_get(filter, xor_filter_slot(filter, h, 0)) ^
+		     xor_filter_get(filter, xor_filter_slot(filter, h, 1)) ^
+		     xor_filter_get(filter, xor_filter_slot(filter, h, 2));
+	return f == xor_filter_fingerprint(filter, h);
+}
+
+/* }}} API definition */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_SALAD_XOR_FILTER_H_INCLUDED */
@@ -353,6 +353,15 @@ struct swim_member {
 	 * time.
 	 */
 	struct rlist in_dissemination_queue;
+	/**
+	 * ID of the last round step which message carried the
+	 * event of this member. Only the events which were
+	 * actually sent have their TTDs decremented when the step
+	 * is complete.
+	 */
+	uint64_t diss_step_id;
+	/** Whether the payload was sent in that step as well. */
+	bool is_payload_sent;
 	/**
 	 * Each time a member is updated, or created, or dropped,
 	 * it is added to an event queue. Members from this queue
@@ -500,6 +509,8 @@ struct swim {
 	 * as long as the event TTD is non-zero.
 	 */
 	struct rlist dissemination_queue;
+	/** ID of the last round step, see swim_begin_step(). */
+	uint64_t round_step_id;
 	/**
 	 * Queue of updated, new, and dropped members to deliver
 	 * the events to triggers. Dropped members are also kept
@@ -1103,11 +1114,14 @@ swim_encode_failure_detection(struct swim *swim, struct swim_packet *packet,
 }
 
 /**
- * Encode dissemination component.
+ * Encode dissemination component. When the packet is a round
+ * step message, @a step_id is the step's ID, and the encoded
+ * events are marked with it. Otherwise it is 0.
  * @retval Number of key-values added to the packet's root map.
  */
 static int
-swim_encode_dissemination(struct swim *swim, struct swim_packet *packet)
+swim_encode_dissemination(struct swim *swim, struct swim_packet *packet,
+			  uint64_t step_id)
 {
 	struct swim_diss_header_bin diss_header_bin;
 	struct swim_member_payload_bin payload_header;
@@ -1121,10 +1135,26 @@ swim_encode_dissemination(struct swim *swim, struct swim_packet *packet)
 	struct swim_member *m;
 	rlist_foreach_entry(m, &swim->dissemination_queue,
 			    in_dissemination_queue) {
+		bool is_payload_sent = m->payload_ttd > 0 &&
+				       m->is_payload_up_to_date;
 		if (swim_encode_member(packet, m, &passport_bin,
-				       &payload_header,
-				       m->payload_ttd > 0) != 0)
-			break;
+				       &payload_header, is_payload_sent) != 0) {
+			/*
+			 * A big payload may not fit, while the
+			 * status still does. It is better to
+			 * send at least the status, and let the
+			 * payload go in a next message.
+			 */
+			if (!is_payload_sent ||
+			    swim_encode_member(packet, m, &passport_bin,
+					       &payload_header, false) != 0)
+				break;
+			is_payload_sent = false;
+		}
+		if (step_id != 0) {
+			m->diss_step_id = step_id;
+			m->is_payload_sent = is_payload_sent;
+		}
 		++i;
 	}
 	swim_diss_header_bin_create(&diss_header_bin, i);
@@ -1132,10 +1162,13 @@ swim_encode_dissemination(struct swim *swim, struct swim_packet *packet)
 	return 1;
 }
 
-/** Encode SWIM components into a UDP packet. */
+/**
+ * Encode SWIM components into a UDP packet. @a step_id is the ID
+ * of the round step which message is encoded, or 0.
+ */
 static void
 swim_encode_msg(struct swim *swim, struct swim_packet *packet,
-		enum swim_fd_msg_type fd_type)
+		enum swim_fd_msg_type fd_type, uint64_t step_id)
 {
 	char *header = swim_packet_alloc(packet, 1);
 	int map_size = 0;
@@ -1145,7 +1178,7 @@ swim_encode_msg(struct swim *swim, struct swim_packet *packet,
 		mp_encode_map(header, map_size);
 		return;
 	});
-	map_size += swim_encode_dissemination(swim, packet);
+	map_size += swim_encode_dissemination(swim, packet, step_id);
 	map_size += swim_encode_anti_entropy(swim, packet);
 
 	assert(mp_sizeof_map(map_size) == 1 && map_size >= 2);
@@ -1153,33 +1186,35 @@ swim_encode_msg(struct swim *swim, struct swim_packet *packet,
 }
 
 /**
- * Decrement TTDs of all events. It is done after each round step.
- * Note, since we decrement TTD of all events, even those which
- * have not been actually encoded and sent, if there are more
- * events than can fit into a packet, the tail of the queue begins
- * reeking and rotting. The most recently added members could even
- * be deleted without being sent once. This is, however, very
- * unlikely, since even 1000 bytes can fit 37 events containing
- * ~27 bytes each, which means only happens upon a failure of 37
- * instances. In such a case event loss is the mildest problem to
- * deal with.
+ * Decrement TTDs of the events sent in the just completed round
+ * step. The events which didn't fit into the packet keep their
+ * TTDs, and the sent ones are moved to the queue tail. So when
+ * there are more events than can fit into a packet, like upon a
+ * mass failure in a big cluster, they are sent in turns instead
+ * of the queue tail rotting without being sent once.
  */
 static void
 swim_decrease_event_ttd(struct swim *swim)
 {
 	struct swim_member *member, *tmp;
+	RLIST_HEAD(sent);
 	rlist_foreach_entry_safe(member, &swim->dissemination_queue,
 				 in_dissemination_queue,
 				 tmp) {
-		if (member->payload_ttd > 0)
+		if (member->diss_step_id != swim->round_step_id)
+			continue;
+		if (member->is_payload_sent && member->payload_ttd > 0)
 			--member->payload_ttd;
 		assert(member->status_ttd > 0);
-		if (--member->status_ttd == 0) {
-			rlist_del_entry(member, in_dissemination_queue);
-			if (member->status == MEMBER_LEFT)
-				swim_delete_member(swim, member);
+		rlist_del_entry(member, in_dissemination_queue);
+		if (--member->status_ttd > 0) {
+			rlist_add_tail_entry(&sent, member,
+					     in_dissemination_queue);
+		} else if (member->status == MEMBER_LEFT) {
+			swim_delete_member(swim, member);
 		}
 	}
+	rlist_splice_tail(&swim->dissemination_queue, &sent);
 }
 
 /**
@@ -1219,7 +1254,7 @@ swim_begin_step(struct ev_loop *loop, struct ev_timer *t, int events)
 	}
 	struct swim_packet *packet = &swim->round_step_task.packet;
 	swim_packet_create(packet);
-	swim_encode_msg(swim, packet, SWIM_FD_MSG_PING);
+	swim_encode_msg(swim, packet, SWIM_FD_MSG_PING, ++swim->round_step_id);
 	struct swim_member *m =
 		rlist_first_entry(&swim->round_queue, struct swim_member,
 				  in_round_queue);
@@ -1278,7 +1313,7 @@ swim_send_fd_msg(struct swim *swim, struct swim_task *task,
 	swim_packet_create(&task->packet);
 	if (proxy != NULL)
 		swim_task_set_proxy(task, proxy);
-	swim_encode_msg(swim, &task->packet, type);
+	swim_encode_msg(swim, &task->packet, type, 0);
 	say_verbose("SWIM %d: schedule %s to %s", swim_fd(swim),
 		    swim_fd_msg_type_strs[type], swim_inaddr_str(dst));
 	swim_task_send(task, dst, &swim->scheduler);
@@ -303,23 +303,24 @@ static inline int
 vclock_compare_generic(const struct vclock *a, const struct vclock *b,
 		       bool ignore_zero)
 {
-	bool le = true, ge = true;
+	/*
+	 * Vclocks are usually dense and small, so it is cheaper to scan
+	 * all the components up to the last used one without branches than
+	 * to iterate over the map bits. Such a loop can also be vectorized
+	 * by the compiler. Unused components are masked out by vclock_get().
+	 */
 	vclock_map_t map = a->map | b->map;
-	struct bit_iterator it;
-	bit_iterator_init(&it, &map, sizeof(map), true);
-
-	size_t replica_id = bit_iterator_next(&it);
-	if (replica_id == 0 && ignore_zero)
-		replica_id = bit_iterator_next(&it);
-
-	for (; replica_id < VCLOCK_MAX; replica_id = bit_iterator_next(&it)) {
+	unsigned int max_pos = VCLOCK_MAX - bit_clz_u32(map | 0x01);
+	bool le = true, ge = true;
+	for (unsigned int replica_id = ignore_zero ? 1 : 0;
+	     replica_id < max_pos; replica_id++) {
 		int64_t lsn_a = vclock_get(a, replica_id);
 		int64_t lsn_b = vclock_get(b, replica_id);
-		le = le && lsn_a <= lsn_b;
-		ge = ge && lsn_a >= lsn_b;
-		if (!ge && !le)
-			return VCLOCK_ORDER_UNDEFINED;
+		le &= lsn_a <= lsn_b;
+		ge &= lsn_a >= lsn_b;
 	}
+	if (!ge && !le)
+		return VCLOCK_ORDER_UNDEFINED;
 	if (ge && !le)
 		return 1;
 	if (le && !ge)
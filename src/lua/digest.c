@@ -67,8 +67,9 @@ lua_pbkdf2(lua_State *L)
 	int digest_len = lua_tointeger(L, 4);
 	unsigned char digest[PBKDF2_MAX_DIGEST_SIZE];
 
-	if (coio_call(digest_pbkdf2_f, password, strlen(password), salt,
-				  strlen(salt), digest, num_iterations, digest_len) < 0) {
+	if (coio_call_pool(COIO_POOL_USER, digest_pbkdf2_f, password,
+			   strlen(password), salt, strlen(salt), digest,
+			   num_iterations, digest_len) < 0) {
 		lua_pushnil(L);
 		return 1;
 	}
@@ -8,6 +8,7 @@ local utils = require('internal.utils')
 local cord_ibuf_take = buffer.internal.cord_ibuf_take
 local cord_ibuf_put = buffer.internal.cord_ibuf_put
 local check_param = utils.check_param
+local table_new = require('table.new')
 
 ffi.cdef[[
     /* from libc */
@@ -381,4 +382,39 @@ for _, var in ipairs({'32', '64'}) do
     m['xxhash' .. var] = xxHash
 end
 
+-- Batch versions of the hash functions. They take an array of strings
+-- and return the array of their hashes.
+local function hash_batch(name, hash, has_seed)
+    local usage = string.format('Usage: digest.%s(table of strings%s)', name,
+                                has_seed and '[, unsigned number]' or '')
+    return function(strs, seed)
+        if type(strs) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS, usage, 2)
+        end
+        local count = #strs
+        local res = table_new(count, 0)
+        for i = 1, count do
+            local str = strs[i]
+            if type(str) ~= 'string' then
+                box.error(box.error.ILLEGAL_PARAMS, usage, 2)
+            end
+            res[i] = hash(str, seed)
+        end
+        return res
+    end
+end
+
+m.crc32_batch = hash_batch('crc32_batch', function(str)
+    return builtin.crc32_calc(CRC32.crc_begin, str, #str)
+end)
+m.murmur_batch = hash_batch('murmur_batch', function(str)
+    return builtin.PMurHash32(PMurHash.default_seed, str, #str)
+end)
+m.xxhash32_batch = hash_batch('xxhash32_batch', function(str, seed)
+    return builtin.tnt_XXH32(str, #str, seed or 0)
+end, true)
+m.xxhash64_batch = hash_batch('xxhash64_batch', function(str, seed)
+    return builtin.tnt_XXH64(str, #str, seed or 0)
+end, true)
+
 return m
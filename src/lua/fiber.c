@@ -327,6 +327,26 @@ lbox_fiber_top(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Push statistics of the cache of fibers with custom stack size
+ * of the current cord.
+ */
+static int
+lbox_fiber_stack_cache_info(struct lua_State *L)
+{
+	struct fiber_stack_cache_stat *stat = &cord()->stack_cache_stat;
+	lua_createtable(L, 0, 4);
+	lua_pushinteger(L, stat->count);
+	lua_setfield(L, -2, "count");
+	lua_pushinteger(L, stat->size);
+	lua_setfield(L, -2, "size");
+	lua_pushinteger(L, stat->hits);
+	lua_setfield(L, -2, "hits");
+	lua_pushinteger(L, stat->misses);
+	lua_setfield(L, -2, "misses");
+	return 1;
+}
+
 static int
 lbox_fiber_top_enable(struct lua_State *L)
 {
@@ -1040,6 +1060,7 @@ static const struct luaL_Reg fiberlib[] = {
 	{"top", lbox_fiber_top},
 	{"top_enable", lbox_fiber_top_enable},
 	{"top_disable", lbox_fiber_top_disable},
+	{"stack_cache_info", lbox_fiber_stack_cache_info},
 #ifdef ENABLE_BACKTRACE
 	{"parent_backtrace_enable", lbox_fiber_parent_backtrace_enable},
 	{"parent_backtrace_disable", lbox_fiber_parent_backtrace_disable},
@@ -24,6 +24,29 @@ ffi.cdef[[
     extern bool
     say_logger_initialized(void);
 
+    enum say_async_overflow {
+        SAY_ASYNC_OVERFLOW_BLOCK,
+        SAY_ASYNC_OVERFLOW_DROP,
+        say_async_overflow_MAX,
+    };
+
+    struct say_async_stat {
+        int64_t written;
+        int64_t dropped;
+    };
+
+    int
+    say_logger_async_start(void);
+
+    void
+    say_set_log_async_overflow(enum say_async_overflow overflow);
+
+    enum say_async_overflow
+    say_async_overflow_by_name(const char *name);
+
+    void
+    say_logger_async_stat(struct say_async_stat *stat);
+
     extern void
     say_from_lua(int level, const char *module, const char *filename, int line,
                  const char *format, ...);
@@ -126,6 +149,8 @@ local default_cfg = {
     level           = S_INFO,
     modules         = nil,
     format          = fmt_num2str[ffi.C.SF_PLAIN],
+    async           = nil,
+    async_overflow  = nil,
 }
 
 local log_cfg = table.copy(default_cfg)
@@ -139,6 +164,8 @@ local log2box_keys = {
     ['level']           = 'log_level',
     ['modules']         = 'log_modules',
     ['format']          = 'log_format',
+    ['async']           = 'log_async',
+    ['async_overflow']  = 'log_async_overflow',
 }
 
 -- Return level as a number, level must be valid.
@@ -247,6 +274,16 @@ local function log_pid()
     return tonumber(ffi.C.log_pid)
 end
 
+-- Returns statistics of the async logger.
+local function log_stat()
+    local stat = ffi.new('struct say_async_stat')
+    ffi.C.say_logger_async_stat(stat)
+    return {
+        written = tonumber(stat.written),
+        dropped = tonumber(stat.dropped),
+    }
+end
+
 local ratelimit_enabled = true
 
 local function ratelimit_enable()
@@ -327,6 +364,8 @@ local option_types = {
     level = 'number, string',
     modules = 'table',
     format = 'string',
+    async = 'boolean',
+    async_overflow = 'string',
 }
 
 local log_initialized = false
@@ -390,6 +429,17 @@ local function log_check_cfg(cfg)
         if log_cfg.nonblock ~= cfg.nonblock then
             box.error(box.error.RELOAD_CFG, 'log_nonblock');
         end
+        -- nil means false, the logger is synchronous by default.
+        if (log_cfg.async or false) ~= (cfg.async or false) then
+            box.error(box.error.RELOAD_CFG, 'log_async');
+        end
+    end
+
+    if cfg.async_overflow ~= nil and
+       ffi.C.say_async_overflow_by_name(cfg.async_overflow) ==
+       ffi.C.say_async_overflow_MAX then
+        box.error(box.error.CFG, 'log_async_overflow',
+                  "expected 'block' or 'drop'")
     end
 
     local cfg_C = log_C_cfg(cfg)
@@ -454,6 +504,12 @@ local function log_configure(self, cfg, box_api)
                           cfg_C.nonblock, cfg_C.format)
     log_initialized = true
 
+    ffi.C.say_set_log_async_overflow(
+        ffi.C.say_async_overflow_by_name(cfg.async_overflow or 'block'))
+    if cfg.async and ffi.C.say_logger_async_start() ~= 0 then
+        box.error()
+    end
+
     for o in pairs(option_types) do
         log_cfg[o] = cfg[o]
     end
@@ -512,6 +568,7 @@ log_main = {
     new = log_new,
     rotate = log_rotate,
     pid = log_pid,
+    stat = log_stat,
     level = set_log_level,
     log_format = set_log_format,
     cfg = setmetatable(log_cfg, {
@@ -55,6 +55,7 @@
 
 #include "cord_buf.h"
 #include <fiber.h>
+#include <lua-cjson/lua_cjson.h> /* luaT_json_push_from_msgpack() */
 
 /**
  * Lua object that stores raw msgpack data and implements methods for decoding
@@ -1177,6 +1178,32 @@ luamp_iterator_skip(struct lua_State *L)
 	return 0;
 }
 
+/**
+ * Converts MsgPack data to a JSON string without decoding it to Lua values.
+ * The data is given either by a msgpack object or by a Lua string.
+ */
+static int
+lua_msgpack_to_json(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1)
+		goto error;
+	size_t data_len;
+	const char *data = luamp_get(L, 1, &data_len);
+	if (data == NULL) {
+		if (lua_type(L, 1) != LUA_TSTRING)
+			goto error;
+		data = lua_tolstring(L, 1, &data_len);
+		const char *p = data;
+		if (mp_check_exact(&p, data + data_len) != 0)
+			return luaT_error(L);
+	}
+	luaT_json_push_from_msgpack(L, data);
+	return 1;
+error:
+	return luaL_error(L, "msgpack.to_json: "
+			  "a Lua string or msgpack object expected");
+}
+
 static int
 lua_msgpack_new(struct lua_State *L);
 
@@ -1190,6 +1217,7 @@ static const luaL_Reg msgpacklib[] = {
 	{ "object", lua_msgpack_object },
 	{ "object_from_raw", lua_msgpack_object_from_raw },
 	{ "is_object", lua_msgpack_is_object },
+	{ "to_json", lua_msgpack_to_json },
 	{ "new", lua_msgpack_new },
 	{ NULL, NULL }
 };
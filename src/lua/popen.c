@@ -1896,6 +1896,105 @@ lbox_popen_write(struct lua_State *L)
 	return luaT_error(L);
 }
 
+/**
+ * Write a file to a child peer.
+ *
+ * @param handle        a handle of a child process
+ * @param path          a path of the file to write
+ * @param opts          table of options
+ * @param opts.offset   offset in the file to start from
+ *                      (default: 0)
+ * @param opts.size     number of bytes to write
+ *                      (default: up to the end of the file)
+ * @param opts.timeout  time quota in seconds
+ *                      (default: 100 years)
+ *
+ * Write the file at @a path to stdin stream of a child process.
+ * On Linux the data is moved with sendfile(2) without copying it
+ * through user space, which makes it cheap to stream big files,
+ * like checkpoint files returned by box.backup.start(), to an
+ * external command.
+ *
+ * Raise an error on incorrect parameters or when the fiber is
+ * cancelled, see ph:write().
+ *
+ * Return the number of written bytes on success.
+ *
+ * Return `nil, err` on a failure. Possible reasons:
+ *
+ * - SystemError: the file can't be opened or read.
+ * - SocketError: an IO error occurs at write.
+ * - TimedOut:    @a timeout quota is exceeded.
+ */
+static int
+lbox_popen_write_file(struct lua_State *L)
+{
+	struct popen_handle *handle;
+	bool is_closed;
+	const char *path;
+	ev_tstamp timeout = TIMEOUT_INFINITY;
+	off_t offset = 0;
+	size_t size = SIZE_MAX;
+
+	/* Extract handle and path. */
+	if ((handle = luaT_check_popen_handle(L, 1, &is_closed)) == NULL ||
+	    lua_type(L, 2) != LUA_TSTRING)
+		goto usage;
+	path = lua_tostring(L, 2);
+	if (is_closed)
+		return luaT_popen_handle_closed_error(L);
+
+	/* Extract options. */
+	if (!lua_isnoneornil(L, 3)) {
+		if (lua_type(L, 3) != LUA_TTABLE)
+			goto usage;
+
+		lua_getfield(L, 3, "timeout");
+		if (!lua_isnil(L, -1) &&
+		    (timeout = luaT_check_timeout(L, -1)) < 0.0)
+			goto usage;
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "offset");
+		if (!lua_isnil(L, -1)) {
+			if (lua_type(L, -1) != LUA_TNUMBER ||
+			    lua_tonumber(L, -1) < 0)
+				goto usage;
+			offset = lua_tointeger(L, -1);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "size");
+		if (!lua_isnil(L, -1)) {
+			if (lua_type(L, -1) != LUA_TNUMBER ||
+			    lua_tonumber(L, -1) < 0)
+				goto usage;
+			size = lua_tointeger(L, -1);
+		}
+		lua_pop(L, 1);
+	}
+
+	unsigned int flags = POPEN_FLAG_FD_STDIN;
+	ssize_t rc = popen_write_file_timeout(handle, path, offset, size,
+					      flags, timeout);
+	if (rc < 0) {
+		struct error *e = diag_last_error(diag_get());
+		if (e->type == &type_IllegalParams ||
+		    e->type == &type_FiberIsCancelled)
+			return luaT_error(L);
+		return luaT_push_nil_and_error(L);
+	}
+	lua_pushinteger(L, rc);
+	return 1;
+
+usage:
+	diag_set(IllegalParams, "Bad params, use: ph:write_file(path[, {"
+		 "offset = <number>, "
+		 "size = <number>, "
+		 "timeout = <number>}])");
+	return luaT_error(L);
+}
+
 /**
  * Close parent's ends of std* fds.
  *
@@ -2504,6 +2603,7 @@ tarantool_lua_popen_init(struct lua_State *L)
 		{"wait",		lbox_popen_wait,	},
 		{"read",		lbox_popen_read,	},
 		{"write",		lbox_popen_write,	},
+		{"write_file",		lbox_popen_write_file,	},
 		{"shutdown",		lbox_popen_shutdown,	},
 		{"info",		lbox_popen_info,	},
 		{"close",		lbox_popen_close,	},
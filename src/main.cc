@@ -333,6 +333,10 @@ daemonize(void)
 	 */
 	signal_init();
 
+	/* The logger cord doesn't survive fork. */
+	if (say_logger_async_restart() != 0)
+		goto error;
+
 	/* redirect stdin; stdout and stderr handled in say_logger_init */
 	fd = open("/dev/null", O_RDONLY);
 	if (fd < 0)
@@ -71,6 +71,10 @@
  * showing fiber call stack.
  */
 #cmakedefine ENABLE_BACKTRACE 1
+/*
+ * Defined if configured with ENABLE_USDT (USDT probes, see usdt.h).
+ */
+#cmakedefine ENABLE_USDT 1
 /*
  * Defined if configured with ABORT_ON_LEAK.
  */
@@ -99,6 +103,7 @@
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 #cmakedefine HAVE_MADV_DONTNEED 1
+#cmakedefine HAVE_MADV_FREE 1
 /*
  * Defined if O_DSYNC mode exists for open(2).
  */
@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2024, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include "trivia/config.h"
+
+/**
+ * USDT (User Statically-Defined Tracing) probes for tracing with bpftrace,
+ * BCC or SystemTap, for example:
+ *
+ *   bpftrace -e 'usdt:./tarantool:tarantool:txn_commit { @[pid] = count(); }'
+ *
+ * A probe compiles to a single nop instruction with the probe location and
+ * arguments described in an ELF note, so it costs next to nothing unless
+ * a tracer is attached. Probe arguments must be cheap to compute because
+ * they are evaluated anyway. The probes are compiled in if the system
+ * provides <sys/sdt.h> (ENABLE_USDT).
+ *
+ * Available probes, all in the 'tarantool' provider:
+ *
+ *   fiber_switch(caller fid, callee fid)
+ *   iproto_request_start(sync, request type)
+ *   iproto_request_finish(sync, request type)
+ *   txn_begin(txn id)
+ *   txn_commit(txn id, signature)
+ *   txn_rollback(txn id, signature)
+ *   wal_write_start(approximate batch size in bytes)
+ *   wal_write_finish(approximate batch size in bytes, success flag)
+ *   wal_fsync_start()
+ *   wal_fsync_finish(return code)
+ *   relay_send(replica id, lsn)
+ *   vy_dump_start(space id, index id)
+ *   vy_dump_finish(space id, index id, success flag)
+ *   vy_compaction_start(space id, index id)
+ *   vy_compaction_finish(space id, index id, success flag)
+ */
+#if defined(ENABLE_USDT)
+# include <sys/sdt.h>
+# define USDT(name, ...) STAP_PROBEV(tarantool, name, ##__VA_ARGS__)
+#else /* !defined(ENABLE_USDT) */
+# define USDT(name, ...) do {} while (0)
+#endif /* !defined(ENABLE_USDT) */
@@ -0,0 +1,36 @@
+local digest = require('digest')
+local t = require('luatest')
+
+local g = t.group()
+
+local strs = {'', 'a', 'abc', string.rep('x', 1000)}
+
+g.test_batch = function()
+    local function map(f)
+        local res = {}
+        for i, str in ipairs(strs) do
+            res[i] = f(str)
+        end
+        return res
+    end
+    t.assert_equals(digest.crc32_batch(strs), map(digest.crc32))
+    t.assert_equals(digest.murmur_batch(strs), map(digest.murmur))
+    t.assert_equals(digest.xxhash32_batch(strs), map(digest.xxhash32))
+    t.assert_equals(digest.xxhash64_batch(strs), map(digest.xxhash64))
+    t.assert_equals(digest.xxhash32_batch(strs, 42), map(function(str)
+        return digest.xxhash32(str, 42)
+    end))
+    t.assert_equals(digest.xxhash64_batch(strs, 42), map(function(str)
+        return digest.xxhash64(str, 42)
+    end))
+    t.assert_equals(digest.crc32_batch({}), {})
+end
+
+g.test_batch_invalid = function()
+    t.assert_error_msg_equals(
+        'Usage: digest.crc32_batch(table of strings)',
+        digest.crc32_batch, 'abc')
+    t.assert_error_msg_equals(
+        'Usage: digest.xxhash64_batch(table of strings[, unsigned number])',
+        digest.xxhash64_batch, {'a', 1})
+end
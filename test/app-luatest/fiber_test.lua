@@ -57,3 +57,13 @@ g.test_gh_9406_shutdown_with_lingering_fiber_join = function()
     local cmd = string.format('%s -e "%s"', tarantool_bin, script)
     t.assert(os.execute(cmd) == 0)
 end
+
+-- Test statistics of the cache of fibers with custom stack size.
+g.test_stack_cache_info = function()
+    local info = fiber.stack_cache_info()
+    t.assert_equals(type(info), 'table')
+    for _, k in ipairs({'count', 'size', 'hits', 'misses'}) do
+        t.assert_type(info[k], 'number')
+        t.assert_ge(info[k], 0)
+    end
+end
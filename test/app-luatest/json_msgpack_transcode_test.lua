@@ -0,0 +1,103 @@
+local decimal = require('decimal')
+local json = require('json')
+local msgpack = require('msgpack')
+local uuid = require('uuid')
+local t = require('luatest')
+
+local g = t.group()
+
+g.test_to_msgpack = function()
+    local cases = {
+        '1', '-1', '0', '18446744073709551615', '-9223372036854775808',
+        '1.5', '1e3', '-2.5e-3', '"str"', '"esc\\n\\"\\u0041"', 'true',
+        'false', 'null', '[]', '{}', '[1, "a", [2, [3, {}]], null]',
+        '{"a": {"b": [1, 2, 3]}, "c": "d"}',
+    }
+    -- Long containers that need array16/map16/array32 headers.
+    local arr = {}
+    local map = {}
+    for i = 1, 70000 do
+        table.insert(arr, i)
+        if i <= 100 then
+            map['k' .. i] = {i}
+        end
+    end
+    table.insert(cases, json.encode(arr))
+    table.insert(cases, json.encode(map))
+    table.insert(cases, json.encode({arr, map, {x = arr}}))
+    for _, s in ipairs(cases) do
+        local obj = json.to_msgpack(s)
+        t.assert(msgpack.is_object(obj), s)
+        -- The result is the same as on decoding to Lua and encoding back.
+        t.assert_equals(obj:decode(), json.decode(s), s)
+        t.assert_equals(msgpack.encode(obj),
+                        msgpack.encode(json.decode(s)), s)
+    end
+end
+
+g.test_to_msgpack_errors = function()
+    t.assert_error_msg_contains('expected 1 or 2 arguments', json.to_msgpack)
+    t.assert_error_msg_content_equals(
+        "Expected value but found invalid token on line 1 at character 1 " ..
+        "here ' >> foo'", json.to_msgpack, 'foo')
+    t.assert_error_msg_content_equals(
+        "Expected comma or ']' but found end on line 1 at character 3 " ..
+        "here '[1 >> '", json.to_msgpack, '[1')
+    t.assert_error_msg_content_equals(
+        "Expected the end but found unsigned int on line 1 at character 3 " ..
+        "here '1  >> 2'", json.to_msgpack, '1 2')
+    t.assert_error_msg_contains(
+        'Found too many nested data structures',
+        json.to_msgpack, '[[[1]]]', {decode_max_depth = 2})
+    t.assert_error_msg_content_equals(
+        "Expected value but found invalid token on line 1 at character 1 " ..
+        "here ' >> nan'", json.to_msgpack, 'nan',
+        {decode_invalid_numbers = false})
+    -- Errors don't break the following calls.
+    t.assert_equals(json.to_msgpack('[1]'):decode(), {1})
+end
+
+g.test_to_json = function()
+    local values = {
+        1, -1, 1.5, 'str', 'esc\n"/', true, false, json.NULL, {},
+        {1, 'a', {2, {3}}, 4}, {a = {b = {1, 2, 3}}, c = 'd'}, {[1] = 2},
+        decimal.new('1.25'),
+        uuid.fromstr('64d22e4d-ac92-4a23-899a-e5934af5479d'),
+        {d = decimal.new(10)},
+    }
+    for _, v in ipairs(values) do
+        local data = msgpack.encode(v)
+        t.assert_equals(msgpack.to_json(data), json.encode(v))
+        t.assert_equals(msgpack.to_json(msgpack.object_from_raw(data)),
+                        json.encode(v))
+        t.assert_equals(msgpack.to_json(json.to_msgpack(json.encode(v))),
+                        json.encode(v))
+    end
+    -- Integer map keys.
+    t.assert_equals(msgpack.to_json(msgpack.encode({[-1] = 1, [10] = 2})),
+                    json.encode({[-1] = 1, [10] = 2}))
+    -- Binary strings.
+    t.assert_equals(msgpack.to_json(string.fromhex('c403616263')), '"abc"')
+    -- Floats.
+    t.assert_equals(msgpack.to_json(string.fromhex('ca3fc00000')), '1.5')
+end
+
+g.test_to_json_errors = function()
+    local usage = 'msgpack.to_json: a Lua string or msgpack object expected'
+    t.assert_error_msg_content_equals(usage, msgpack.to_json)
+    t.assert_error_msg_content_equals(usage, msgpack.to_json, 1)
+    t.assert_error_msg_content_equals(usage, msgpack.to_json, 'a', 'b')
+    t.assert_error_msg_content_equals('Invalid MsgPack - truncated input',
+                                      msgpack.to_json, '\x92\x01')
+    t.assert_error_msg_content_equals('Invalid MsgPack - junk after input',
+                                      msgpack.to_json, '\x01\x01')
+    t.assert_error_msg_content_equals(
+        'table key must be a number or string',
+        msgpack.to_json, msgpack.encode({[true] = 1}))
+    local deep = string.rep('\x91', 200) .. '\x01'
+    t.assert_error_msg_content_equals('Too high nest level',
+                                      msgpack.to_json, deep)
+    -- NaN and Inf are allowed by default.
+    t.assert_equals(msgpack.to_json(msgpack.encode(0/0)),
+                    json.encode(0/0))
+end
@@ -58,3 +58,54 @@ g.test_inherit_fds = function()
     t.assert_equals(ffi.string(ibuf.rpos, #msg), msg)
     ibuf:recycle()
 end
+
+g.test_write_file = function()
+    local fiber = require('fiber')
+    local fio = require('fio')
+    local dir = fio.tempdir()
+    local path = fio.pathjoin(dir, 'data')
+    local data = string.rep('0123456789', 100000)
+    local f = fio.open(path, {'O_WRONLY', 'O_CREAT'}, tonumber('644', 8))
+    f:write(data)
+    f:close()
+
+    local function cat(opts)
+        local ph = popen.shell('cat', 'rw')
+        -- Read the output concurrently so that the pipes don't get full.
+        local reader = fiber.new(function()
+            local chunks = {}
+            while true do
+                local chunk = ph:read()
+                if chunk == '' then
+                    break
+                end
+                table.insert(chunks, chunk)
+            end
+            return table.concat(chunks)
+        end)
+        reader:set_joinable(true)
+        local n, err = ph:write_file(path, opts)
+        t.assert_equals(err, nil)
+        ph:shutdown({stdin = true})
+        local _, output = reader:join()
+        ph:close()
+        return n, output
+    end
+    t.assert_equals({cat()}, {#data, data})
+    t.assert_equals({cat({offset = 5, size = 10})}, {10, '5678901234'})
+    t.assert_equals({cat({offset = #data - 3})}, {3, '789'})
+    t.assert_equals({cat({offset = #data + 1})}, {0, ''})
+
+    local ph = popen.shell('cat', 'rw')
+    local n, err = ph:write_file(fio.pathjoin(dir, 'none'))
+    t.assert_equals(n, nil)
+    t.assert_str_contains(tostring(err), 'failed to open')
+    t.assert_error_msg_contains('Bad params, use: ph:write_file',
+                                ph.write_file, ph, path, {size = -1})
+    ph:close()
+    ph = popen.shell('cat', 'r')
+    t.assert_error_msg_contains('handle does not support the requested IO',
+                                ph.write_file, ph, path)
+    ph:close()
+    fio.rmtree(dir)
+end
@@ -3,7 +3,7 @@ local t = require('luatest')
 
 local g = t.group("invalid compression type", t.helpers.matrix({
     engine = {'memtx', 'vinyl'},
-    compression = {'zstd', 'lz4'}
+    compression = {'lz4'}
 }))
 
 g.before_all(function(cg)
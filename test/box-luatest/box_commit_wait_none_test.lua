@@ -0,0 +1,115 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.error.injection ~= nil then
+            box.error.injection.set('ERRINJ_WAL_DELAY', false)
+            box.error.injection.set('ERRINJ_WAL_IO', false)
+        end
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        box.begin()
+        t.assert_error_msg_equals(
+            "wait must be 'complete' or 'none'",
+            box.commit, {wait = 'foo'})
+        t.assert_error_msg_equals(
+            "wait must be 'complete' or 'none'",
+            box.commit, {wait = 1})
+        t.assert(box.is_in_txn())
+        box.space.test:insert({1})
+        box.commit({wait = 'complete'})
+        t.assert_not(box.is_in_txn())
+        t.assert_equals(box.space.test:get(1), {1})
+    end)
+end
+
+g.test_no_txn = function(cg)
+    cg.server:exec(function()
+        local f = box.commit({wait = 'none'})
+        t.assert_equals(tostring(f), 'box.commit_future')
+        t.assert(f:is_ready())
+        t.assert_equals(f:result(), true)
+        t.assert_equals(f:wait_result(), true)
+    end)
+end
+
+g.test_commit = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local futures = {}
+        for i = 1, 10 do
+            box.begin()
+            s:insert({i})
+            table.insert(futures, box.commit({wait = 'none'}))
+            t.assert_not(box.is_in_txn())
+        end
+        -- The fiber isn't blocked so it can wait for all the commits.
+        fiber.yield()
+        for _, f in ipairs(futures) do
+            t.assert_equals(f:wait_result(), true)
+            t.assert(f:is_ready())
+        end
+        t.assert_equals(s:count(), 10)
+    end)
+end
+
+g.test_pending = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local s = box.space.test
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        box.begin()
+        s:insert({1})
+        local f = box.commit({wait = 'none'})
+        t.assert_not(f:is_ready())
+        local ok, err = f:result()
+        t.assert_equals(ok, nil)
+        t.assert_equals(err.message, 'Transaction is not complete')
+        ok, err = f:wait_result(0.01)
+        t.assert_equals(ok, nil)
+        t.assert_equals(err.type, 'TimedOut')
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        t.assert_equals(f:wait_result(), true)
+        t.assert_equals(s:get(1), {1})
+    end)
+end
+
+g.test_rollback = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local s = box.space.test
+        box.error.injection.set('ERRINJ_WAL_IO', true)
+        box.begin()
+        s:insert({1})
+        local f = box.commit({wait = 'none'})
+        local ok, err = f:wait_result()
+        t.assert_equals(ok, nil)
+        t.assert_equals(err.message, 'Failed to write to disk')
+        t.assert(f:is_ready())
+        ok, err = f:result()
+        t.assert_equals(ok, nil)
+        t.assert_equals(err.message, 'Failed to write to disk')
+        t.assert_equals(s:get(1), nil)
+    end)
+end
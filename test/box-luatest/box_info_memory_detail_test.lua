@@ -0,0 +1,83 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {memtx_use_mvcc_engine = true}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_memory_detail = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}, unique = false})
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        local detail = box.info.memory_detail()
+        local stat = detail.spaces.test
+        t.assert_type(stat, 'table')
+        local tuple = s:stat().tuple
+        t.assert_equals(stat.tuple.data_size,
+                        tuple.memtx.data_size + tuple.malloc.data_size)
+        t.assert_equals(stat.tuple.data_size, s:bsize())
+        t.assert_equals(stat.index, {
+            pk = s.index.pk:bsize(),
+            sk = s.index.sk:bsize(),
+        })
+        t.assert_equals(stat.mvcc, {
+            stories = {total = 0, count = 0},
+            retained = {total = 0, count = 0},
+        })
+        t.assert_equals(stat.total, stat.tuple.data_size +
+                        stat.tuple.header_size + stat.tuple.field_map_size +
+                        stat.tuple.waste_size + stat.index.pk +
+                        stat.index.sk)
+        t.assert_type(detail.spaces._space, 'table')
+        t.assert_type(detail.read_view.data, 'number')
+        t.assert_type(detail.read_view.index, 'number')
+    end)
+end
+
+g.test_memory_detail_mvcc = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        local f = fiber.new(function()
+            box.begin()
+            s:delete({1})
+            fiber.sleep(1000)
+        end)
+        f:set_joinable(true)
+        fiber.yield()
+        local mvcc = box.info.memory_detail().spaces.test.mvcc
+        t.assert_gt(mvcc.stories.count, 0)
+        t.assert_gt(mvcc.stories.total, 0)
+        f:cancel()
+        f:join()
+    end)
+end
+
+g.test_memory_detail_vinyl = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_equals(box.info.memory_detail().spaces.test, nil)
+    end)
+end
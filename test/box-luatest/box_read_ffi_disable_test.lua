@@ -82,6 +82,20 @@ g.test_get = function(cg)
     end)
 end
 
+g.test_get_many = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_equals(
+            "Use index:get_many(...) instead of index.get_many(...)",
+            s.index.primary.get_many)
+        t.assert_error_msg_equals(
+            "Invalid key part count in an exact match (expected 1, got 0)",
+            s.index.primary.get_many, s.index.primary, {{}})
+        t.assert_equals(s:get_many({1, {3}, 100}), {{1, 1}, {3, 2}})
+        t.assert_equals(s.index.primary:get_many({}), {})
+    end)
+end
+
 g.test_select = function(cg)
     cg.server:exec(function()
         local s = box.space.test
@@ -0,0 +1,88 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'test_global', function(n)
+            if n == nil then
+                error('boom')
+            end
+            local tab = {}
+            for i = 1, n do
+                tab[i] = {i}
+            end
+            require('fiber').sleep(0)
+            return #tab
+        end)
+        box.schema.func.create('test_global')
+        box.schema.func.create('test_body', {
+            body = 'function(a, b) return a + b end',
+        })
+        box.schema.user.grant('guest', 'execute', 'universe')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        box.stat.reset()
+    end)
+end)
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.stat.func(), {})
+        t.assert_equals(box.func.test_global:call({1000}), 1000)
+        t.assert_error_msg_contains('boom', box.func.test_global.call,
+                                    box.func.test_global)
+        t.assert_equals(box.func.test_body:call({1, 2}), 3)
+        t.assert_equals(box.func.test_body:call({3, 4}), 7)
+        local stat = box.stat.func()
+        t.assert_equals(stat.test_body.calls, 2)
+        t.assert_equals(stat.test_body.errors, 0)
+        t.assert_equals(stat.test_body.yields, 0)
+        t.assert_ge(stat.test_body.time, 0)
+        t.assert_equals(stat.test_global.calls, 2)
+        t.assert_equals(stat.test_global.errors, 1)
+        t.assert_equals(stat.test_global.yields, 1)
+        t.assert_gt(stat.test_global.time, 0)
+        t.assert_gt(stat.test_global.lua_alloc, 1000 * 16)
+        t.assert_equals(stat['box.schema.user.info'], nil)
+        box.stat.reset()
+        t.assert_equals(box.stat.func(), {})
+    end)
+end
+
+g.test_iproto = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn:call('test_body', {5, 6}), 11)
+    t.assert_equals(conn:call('test_global', {10}), 10)
+    conn:close()
+    cg.server:exec(function()
+        local stat = box.stat.func()
+        t.assert_equals(stat.test_body.calls, 1)
+        t.assert_equals(stat.test_global.calls, 1)
+    end)
+end
+
+g.test_drop = function(cg)
+    cg.server:exec(function()
+        box.schema.func.create('test_drop', {
+            body = [[function()
+                box.schema.func.drop('test_drop')
+                return true
+            end]],
+        })
+        t.assert(box.func.test_drop:call())
+        t.assert_equals(box.func.test_drop, nil)
+        t.assert_equals(box.stat.func().test_drop, nil)
+    end)
+end
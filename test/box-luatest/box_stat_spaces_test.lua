@@ -0,0 +1,100 @@
+local msgpack = require('msgpack')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('box_stat_spaces', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        box.stat.reset()
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_stat = function(cg)
+    cg.server:exec(function(msgpack)
+        local s = box.space.test
+        t.assert_equals(box.stat.spaces().test, nil)
+        local bytes = 0
+        bytes = bytes + s:insert({1, 'a'}):bsize()
+        bytes = bytes + s:insert({2, 'b'}):bsize()
+        bytes = bytes + s:replace({3, 'c'}):bsize()
+        bytes = bytes + s:update({1}, {{'=', 2, 'aa'}}):bsize()
+        s:upsert({4, 'd'}, {{'=', 2, 'dd'}})
+        bytes = bytes + #msgpack.encode({4, 'd'})
+        s:delete({2})
+        t.assert_equals(#s:select(), 3)
+        t.assert_equals(#s:select({5}), 0)
+        t.assert_not_equals(s:get({1}), nil)
+        t.assert_equals(s:get({2}), nil)
+        local stat = {
+            select = 4,
+            insert = 2,
+            replace = 1,
+            update = 1,
+            upsert = 1,
+            delete = 1,
+            tuples_read = 4,
+            bytes_written = bytes,
+        }
+        t.assert_equals(box.stat.spaces().test, stat)
+        local space_stat = s:stat()
+        space_stat.tuple = nil
+        t.assert_equals(space_stat, stat)
+    end, {msgpack})
+end
+
+g.test_failed_request = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1})
+        t.assert_error_msg_contains('Duplicate key', s.insert, s, {1})
+        t.assert_equals(s:stat().insert, 1)
+    end)
+end
+
+g.test_reset = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1})
+        s:get({1})
+        t.assert_equals(s:stat().insert, 1)
+        t.assert_equals(s:stat().select, 1)
+        box.stat.reset()
+        t.assert_equals(s:stat().insert, 0)
+        t.assert_equals(s:stat().select, 0)
+        t.assert_equals(box.stat.spaces().test, nil)
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1})
+        s:create_index('sk', {parts = {1, 'unsigned'}})
+        s:format({{'id', 'unsigned'}})
+        t.assert_equals(s:stat().insert, 1)
+        s:insert({2})
+        t.assert_equals(s:stat().insert, 2)
+    end)
+end
@@ -254,11 +254,13 @@ g.test_box_schema = function(cg)
     local c = net.connect(cg.master.net_box_uri)
     local version = 0
     local version_n = 0
+    local space_id
 
     local watcher = c:watch('box.schema',
                             function(n, s)
                                 t.assert_equals(n, 'box.schema')
                                 version = s.version
+                                space_id = s.space_id
                                 version_n = version_n + 1
                             end)
 
@@ -267,20 +269,37 @@ g.test_box_schema = function(cg)
     local init_version = version
 
     version_n = 0
-    cg.master:exec(function() box.schema.create_space('p') end)
+    local id = cg.master:exec(function()
+        return box.schema.create_space('p').id
+    end)
     t.helpers.retrying({}, function() t.assert_equals(version_n, 1) end)
     t.assert_equals(version, init_version + 1)
+    t.assert_equals(space_id, id)
 
     version_n = 0
     cg.master:exec(function() box.space.p:create_index('i') end)
     t.helpers.retrying({}, function() t.assert_equals(version_n, 1) end)
     t.assert_equals(version, init_version + 2)
+    t.assert_equals(space_id, id)
 
     version_n = 0
     cg.master:exec(function() box.space.p:drop() end)
     t.helpers.retrying({}, function() t.assert_equals(version_n, 1) end)
     -- there'll be 2 changes - index and space
     t.assert_equals(version, init_version + 4)
+    t.assert_equals(space_id, id)
+
+    -- Changes not bound to a single space don't have space_id.
+    version_n = 0
+    cg.master:exec(function()
+        box.execute([[CREATE TABLE t (id INT PRIMARY KEY);]])
+        box.execute([[CREATE TRIGGER tr AFTER INSERT ON t FOR EACH ROW
+                      BEGIN SELECT 1; END;]])
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(space_id, nil)
+    end)
+    cg.master:exec(function() box.space.T:drop() end)
 
     watcher:unregister()
     c:close()
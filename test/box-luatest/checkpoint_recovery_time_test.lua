@@ -0,0 +1,76 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{checkpoint_recovery_time = 0}
+    end)
+end)
+
+-- Writes about 2 MB to WAL.
+local function write_wal(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local value = string.rep('x', 1024)
+        for i = 1, 2048 do
+            s:replace({i % 100, value})
+        end
+    end)
+end
+
+local function last_checkpoint_vclock(cg)
+    return cg.server:exec(function()
+        local checkpoints = box.info.gc().checkpoints
+        return checkpoints[#checkpoints].vclock
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.checkpoint_recovery_time, 0)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'checkpoint_recovery_time': " ..
+            "the value must not be negative",
+            box.cfg, {checkpoint_recovery_time = -1})
+        box.cfg{checkpoint_recovery_time = 60}
+        t.assert_equals(box.cfg.checkpoint_recovery_time, 60)
+    end)
+end
+
+g.test_disabled = function(cg)
+    cg.server:exec(function() box.snapshot() end)
+    local vclock = last_checkpoint_vclock(cg)
+    write_wal(cg)
+    t.assert_equals(last_checkpoint_vclock(cg), vclock)
+end
+
+g.test_checkpoint_triggered = function(cg)
+    cg.server:exec(function()
+        box.snapshot()
+        -- A tiny snapshot is loaded instantly, so the WAL written
+        -- after it is limited by the min size of 1 MB.
+        box.cfg{checkpoint_recovery_time = 0.001}
+    end)
+    local vclock = last_checkpoint_vclock(cg)
+    write_wal(cg)
+    t.helpers.retrying({}, function()
+        t.assert(cg.server:grep_log(
+            'WAL threshold exceeded, triggering checkpoint'))
+        t.assert_not_equals(last_checkpoint_vclock(cg), vclock)
+    end)
+end
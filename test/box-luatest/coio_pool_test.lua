@@ -0,0 +1,83 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        local tweaks = require('internal.tweaks')
+        tweaks.coio_pool_file_max = 0
+        box.cfg({worker_pool_threads = 4})
+    end)
+end)
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local stat = box.stat.coio()
+        t.assert_items_equals(table.keys(stat),
+                              {'default', 'dns', 'file', 'user'})
+        for _, pool in pairs(stat) do
+            t.assert_items_equals(table.keys(pool), {
+                'priority', 'limit', 'active', 'waiting', 'count',
+                'wait_time', 'wait_time_max', 'exec_time', 'exec_time_max',
+            })
+        end
+        -- Tasks requested from Lua are limited and go last.
+        t.assert_equals(stat.default.limit, 0)
+        t.assert_equals(stat.dns.limit, 0)
+        t.assert_equals(stat.file.limit, 3)
+        t.assert_equals(stat.user.limit, 3)
+        t.assert_lt(stat.file.priority, stat.default.priority)
+        t.assert_lt(stat.user.priority, stat.default.priority)
+        box.cfg({worker_pool_threads = 1})
+        t.assert_equals(box.stat.coio().file.limit, 1)
+    end)
+end
+
+g.test_limit = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local fio = require('fio')
+        local tweaks = require('internal.tweaks')
+        tweaks.coio_pool_file_max = 1
+        t.assert_equals(box.stat.coio().file.limit, 1)
+        local count = box.stat.coio().file.count
+        local fibers = {}
+        for i = 1, 10 do
+            fibers[i] = fiber.new(function()
+                t.assert(fio.stat('.'))
+            end)
+            fibers[i]:set_joinable(true)
+        end
+        fiber.yield()
+        local stat = box.stat.coio().file
+        t.assert_equals(stat.active, 1)
+        t.assert_equals(stat.waiting, 9)
+        for _, f in ipairs(fibers) do
+            t.assert_equals({f:join()}, {true})
+        end
+        stat = box.stat.coio().file
+        t.assert_equals(stat.active, 0)
+        t.assert_equals(stat.waiting, 0)
+        t.assert_equals(stat.count, count + 10)
+        t.assert_ge(stat.exec_time, 0)
+    end)
+end
+
+g.test_dns = function(cg)
+    cg.server:exec(function()
+        local socket = require('socket')
+        local count = box.stat.coio().dns.count
+        socket.getaddrinfo('localhost', 3301)
+        t.assert_equals(box.stat.coio().dns.count, count + 1)
+    end)
+end
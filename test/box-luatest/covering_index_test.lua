@@ -0,0 +1,112 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('covering_index', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+local function create_space(engine)
+    local s = box.schema.space.create('test', {engine = engine, format = {
+        {'id', 'unsigned'}, {'name', 'string'}, {'score', 'unsigned'},
+        {'data', 'string'},
+    }})
+    s:create_index('pk')
+    s:create_index('sk', {parts = {'name'}, include = {'score'},
+                          unique = false})
+end
+
+g.test_select = function(cg)
+    cg.server:exec(create_space, {cg.params.engine})
+    cg.server:exec(function()
+        local s = box.space.test
+        local sk = s.index.sk
+        t.assert_equals(sk.include, {3})
+        t.assert_equals(#sk.parts, 2)
+        t.assert_equals(s.index.pk.include, nil)
+        for i = 1, 10 do
+            s:insert({i, 'n' .. i % 3, i * 10, string.rep('x', 100)})
+        end
+        -- Full tuples are returned by default.
+        t.assert_equals(sk:select({'n1'}, {limit = 1}),
+                        {{1, 'n1', 10, string.rep('x', 100)}})
+        -- Covering select returns key, included and primary key fields.
+        t.assert_equals(sk:select({'n1'}, {covering = true}),
+                        {{'n1', 10, 1}, {'n1', 40, 4}, {'n1', 70, 7},
+                         {'n1', 100, 10}})
+        box.snapshot()
+        s:update(4, {{'=', 3, 5}})
+        s:update(7, {{'=', 4, 'y'}})
+        s:delete(10)
+        t.assert_equals(sk:select({'n1'}, {covering = true}),
+                        {{'n1', 5, 4}, {'n1', 10, 1}, {'n1', 70, 7}})
+        t.assert_equals(sk:select({'n1'}, {covering = true,
+                                           iterator = 'REQ', offset = 1}),
+                        {{'n1', 10, 1}, {'n1', 5, 4}})
+        box.begin()
+        s:replace({20, 'n1', 0, ''})
+        t.assert_equals(sk:select({'n1'}, {covering = true, limit = 2}),
+                        {{'n1', 0, 20}, {'n1', 5, 4}})
+        box.rollback()
+        t.assert_equals(sk:select({'n1'}, {covering = true, limit = 1}),
+                        {{'n1', 5, 4}})
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(create_space, {cg.params.engine})
+    cg.server:exec(function()
+        local s = box.space.test
+        local sk = s.index.sk
+        s:insert({1, 'a', 10, 'foo'})
+        sk:alter({include = {'score', 'data'}})
+        t.assert_equals(sk.include, {3, 4})
+        t.assert_equals(sk:select({}, {covering = true}),
+                        {{'a', 10, 'foo', 1}})
+        sk:alter({parts = {'data'}, include = {'score'}})
+        t.assert_equals(sk.include, {3})
+        t.assert_equals(sk.parts[1].fieldno, 4)
+        t.assert_equals(sk:select({}, {covering = true}), {{'foo', 10, 1}})
+        sk:alter({include = {}})
+        t.assert_equals(sk.include, nil)
+        t.assert_equals(#sk.parts, 1)
+        t.assert_equals(sk:select({}, {covering = true}), {{'foo', 1}})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(create_space, {cg.params.engine})
+    cg.server:exec(function()
+        local s = box.space.test
+        local function check(msg, opts)
+            t.assert_error_msg_contains(msg, s.create_index, s, 'tk', opts)
+        end
+        check('unique index can not include fields',
+              {parts = {'name'}, include = {'score'}})
+        local s2 = box.schema.space.create('test2')
+        t.assert_error_msg_contains(
+            'primary key can not include fields',
+            s2.create_index, s2, 'pk', {include = {2}})
+        s2:drop()
+        t.assert_error_msg_contains(
+            "covering select doesn't support pagination",
+            s.index.sk.select, s.index.sk, {}, {covering = true,
+                                                fetch_pos = true})
+    end)
+end
@@ -0,0 +1,96 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.skip_if(jit.os ~= 'Linux', 'Linux only')
+    cg.server = server:new({box_cfg = {iproto_threads = 2}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({
+            tx_cpu_affinity = box.NULL,
+            wal_cpu_affinity = box.NULL,
+            iproto_cpu_affinity = box.NULL,
+            memtx_numa_node = box.NULL,
+        })
+    end)
+end)
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'tx_cpu_affinity', 'wal_cpu_affinity',
+                               'iproto_cpu_affinity'}) do
+            for _, value in ipairs({'', 'a', '1,', '3-1', '-1', '1-2-3',
+                                    '100000'}) do
+                t.assert_error_msg_equals(
+                    string.format("Incorrect value for option '%s': " ..
+                                  "invalid CPU list '%s'", name, value),
+                    box.cfg, {[name] = value})
+            end
+        end
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'memtx_numa_node': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {memtx_numa_node = -1})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'memtx_numa_node': " ..
+            "no such NUMA node",
+            box.cfg, {memtx_numa_node = 1000})
+    end)
+end
+
+g.test_cpu_affinity = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        -- Returns the CPUs allowed for the threads with the given name.
+        local function thread_cpus(name)
+            local result = {}
+            for _, dir in ipairs(fio.glob('/proc/self/task/*')) do
+                local f = fio.open(fio.pathjoin(dir, 'comm'))
+                local comm = f:read():gsub('\n', '')
+                f:close()
+                if comm == name then
+                    f = fio.open(fio.pathjoin(dir, 'status'))
+                    local status = f:read()
+                    f:close()
+                    table.insert(result, status:match(
+                        'Cpus_allowed_list:%s*([^\n]+)'))
+                end
+            end
+            return result
+        end
+        local initial = thread_cpus('iproto')[1]
+        box.cfg({
+            wal_cpu_affinity = '0',
+            iproto_cpu_affinity = '0',
+        })
+        t.assert_equals(thread_cpus('wal'), {'0'})
+        t.assert_equals(thread_cpus('iproto'), {'0', '0'})
+        box.cfg({
+            wal_cpu_affinity = box.NULL,
+            iproto_cpu_affinity = box.NULL,
+        })
+        t.assert_equals(thread_cpus('wal'), {initial})
+        t.assert_equals(thread_cpus('iproto'), {initial, initial})
+        box.cfg({tx_cpu_affinity = '0'})
+        t.assert_equals(box.cfg.tx_cpu_affinity, '0')
+    end)
+end
+
+g.test_numa_node = function(cg)
+    cg.server:exec(function()
+        box.cfg({memtx_numa_node = 0})
+        t.assert_equals(box.cfg.memtx_numa_node, 0)
+        box.space._schema:select()
+    end)
+end
@@ -0,0 +1,115 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'burn', function(duration)
+            local clock = require('clock')
+            local deadline = clock.proc() + duration
+            local x = 0
+            while clock.proc() < deadline do
+                x = x + 1
+            end
+            return x
+        end)
+        box.schema.func.create('burn')
+        box.schema.user.grant('guest', 'execute', 'function', 'burn')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    local err = cg.server:exec(function()
+        local cpu_profiler = require('cpu_profiler')
+        local ok, err = pcall(cpu_profiler.start, {interval = 0.001})
+        if not ok then
+            return tostring(err)
+        end
+        cpu_profiler.stop()
+        cpu_profiler.reset()
+    end)
+    t.skip_if(err ~= nil, err)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        local cpu_profiler = require('cpu_profiler')
+        cpu_profiler.stop()
+        cpu_profiler.reset()
+    end)
+end)
+
+g.test_attribution = function(cg)
+    cg.server:exec(function()
+        local cpu_profiler = require('cpu_profiler')
+        cpu_profiler.start({interval = 0.001})
+        t.assert(cpu_profiler.info().running)
+    end)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_gt(conn:call('burn', {0.3}), 0)
+    conn:close()
+    cg.server:exec(function()
+        local cpu_profiler = require('cpu_profiler')
+        cpu_profiler.stop()
+        local info = cpu_profiler.info()
+        t.assert_not(info.running)
+        t.assert_equals(info.interval, 0.001)
+        t.assert_gt(info.samples, 0)
+        t.assert_gt(info.stacks, 0)
+        local samples = 0
+        for _, stack in ipairs(cpu_profiler.report()) do
+            t.assert_type(stack.fiber, 'string')
+            t.assert_type(stack.frames, 'table')
+            if stack.func == 'burn' then
+                t.assert_equals(stack.request, 'CALL')
+                samples = samples + stack.count
+            end
+        end
+        t.assert_gt(samples, 0)
+        local collapsed = cpu_profiler.collapsed()
+        t.assert_str_contains(collapsed, ';CALL;burn;')
+        for line in collapsed:gmatch('[^\n]+') do
+            t.assert_str_matches(line, '.* %d+')
+        end
+    end)
+end
+
+g.test_reset = function(cg)
+    cg.server:exec(function()
+        local cpu_profiler = require('cpu_profiler')
+        cpu_profiler.start({interval = 0.001})
+        _G.burn(0.1)
+        cpu_profiler.stop()
+        t.assert_gt(cpu_profiler.info().samples, 0)
+        -- Samples are kept after stop.
+        t.assert_not_equals(cpu_profiler.report(), {})
+        cpu_profiler.reset()
+        local info = cpu_profiler.info()
+        t.assert_equals(info.samples, 0)
+        t.assert_equals(info.stacks, 0)
+        t.assert_equals(cpu_profiler.report(), {})
+        t.assert_equals(cpu_profiler.collapsed(), '')
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local cpu_profiler = require('cpu_profiler')
+        t.assert_error_msg_equals('interval must be a positive number',
+                                  cpu_profiler.start, {interval = 0})
+        t.assert_error_msg_equals('interval must be a positive number',
+                                  cpu_profiler.start, {interval = 'x'})
+        cpu_profiler.start()
+        t.assert_error_msg_equals('CPU profiler is already running',
+                                  cpu_profiler.start)
+        t.assert_equals(cpu_profiler.info().interval, 0.01)
+    end)
+end
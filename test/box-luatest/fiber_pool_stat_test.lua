@@ -0,0 +1,73 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'ping', function() return true end)
+        box.schema.func.create('ping')
+        box.schema.user.grant('guest', 'execute', 'function', 'ping')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        require('internal.tweaks').fiber_pool_adaptive = false
+    end)
+end)
+
+-- Sends requests so that the fiber pool stats of the next stat period
+-- are not empty.
+local function send_requests(cg)
+    for _ = 1, 100 do
+        cg.server.net_box:call('ping')
+    end
+end
+
+g.test_stat = function(cg)
+    t.helpers.retrying({timeout = 10}, function()
+        send_requests(cg)
+        cg.server:exec(function()
+            local stat = box.stat.net()
+            local limit = box.cfg.net_msg_max * 5
+            t.assert_equals(stat.FIBER_POOL.max, limit)
+            t.assert_ge(stat.FIBER_POOL.current, 1)
+            t.assert_equals(box.stat.net.FIBER_POOL, stat.FIBER_POOL)
+            for _, name in ipairs({'QUEUE_TIME', 'SERVICE_TIME'}) do
+                local time = stat[name]
+                t.assert_gt(time.p50, 0, name)
+                t.assert_ge(time.p90, time.p50, name)
+                t.assert_ge(time.p99, time.p90, name)
+                t.assert_type(box.stat.net[name].p99, 'number')
+            end
+        end)
+    end)
+end
+
+g.test_adaptive = function(cg)
+    local limit = cg.server:exec(function()
+        require('internal.tweaks').fiber_pool_adaptive = true
+        return box.stat.net.FIBER_POOL.max
+    end)
+    -- The pool isn't saturated, so the adaptive limit goes down.
+    t.helpers.retrying({timeout = 20}, function()
+        send_requests(cg)
+        cg.server:exec(function(limit)
+            t.assert_lt(box.stat.net.FIBER_POOL.max, limit)
+        end, {limit})
+    end)
+    -- The fixed limit is restored when the adaptive sizing is disabled.
+    cg.server:exec(function(limit)
+        require('internal.tweaks').fiber_pool_adaptive = false
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.net.FIBER_POOL.max, limit)
+        end)
+    end, {limit})
+end
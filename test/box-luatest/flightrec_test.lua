@@ -0,0 +1,121 @@
+local fio = require('fio')
+local flightrec = require('flightrec')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_each(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            flightrec_enabled = true,
+            flightrec_metrics_interval = 0.01,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+    cg.path = fio.pathjoin(cg.server.workdir, 'tarantool.ttfr')
+end)
+
+g.after_each(function(cg)
+    cg.server:drop()
+end)
+
+-- Returns the records of the given section matching the predicate.
+local function find(records, predicate)
+    local result = {}
+    for _, record in ipairs(records) do
+        if predicate(record) then
+            table.insert(result, record)
+        end
+    end
+    return result
+end
+
+local function check_records(path)
+    local data = flightrec.read(path)
+    local logs = find(data.logs, function(r)
+        return r.message == 'flight recorder test message'
+    end)
+    t.assert_equals(#logs, 1)
+    t.assert_equals(logs[1].level, 5)
+    t.assert_type(logs[1].time, 'number')
+    local requests = find(data.requests, function(r)
+        return r.type == 'request' and r.data:find('flightrec_key') ~= nil
+    end)
+    t.assert_equals(#requests, 1)
+    t.assert_equals(requests[1].size, #requests[1].data)
+    local responses = find(data.requests, function(r)
+        return r.type == 'response'
+    end)
+    t.assert_not_equals(#responses, 0)
+    t.assert_not_equals(#data.metrics, 0)
+    local metrics = data.metrics[#data.metrics]
+    t.assert_ge(metrics.box.INSERT.total, 1)
+    t.assert_ge(metrics.net.REQUESTS.total, 1)
+end
+
+g.test_records = function(cg)
+    cg.server.net_box.space.test:insert({1, 'flightrec_key'})
+    cg.server:exec(function()
+        require('log').info('flight recorder test message')
+        require('fiber').sleep(0.1)
+    end)
+    check_records(cg.path)
+    -- The file is readable after a crash.
+    cg.server.process:kill('KILL')
+    t.helpers.retrying({}, function()
+        t.assert_not(cg.server.process:is_alive())
+    end)
+    check_records(cg.path)
+    -- The file left by the crashed instance is kept on restart.
+    cg.server:restart()
+    check_records(cg.path .. '.prev')
+end
+
+g.test_reconfigure = function(cg)
+    cg.server:exec(function()
+        require('log').info('flight recorder test message')
+    end)
+    t.assert_not_equals(#flightrec.read(cg.path).logs, 0)
+    cg.server:exec(function()
+        box.cfg({flightrec_enabled = false})
+    end)
+    cg.server.net_box.space.test:insert({1, 'flightrec_key'})
+    cg.server:exec(function()
+        require('log').info('flight recorder test message')
+        box.cfg({flightrec_enabled = true, flightrec_logs_size = 0})
+        require('log').info('flight recorder test message')
+    end)
+    local data = flightrec.read(cg.path)
+    t.assert_equals(data.logs, {})
+    t.assert_equals(find(data.requests, function(r)
+        return r.type == 'request' and r.data:find('flightrec_key') ~= nil
+    end), {})
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'flightrec_logs_size': " ..
+            "must be 0 or between 4096 and 1073741824",
+            box.cfg, {flightrec_logs_size = 100})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'flightrec_metrics_interval': " ..
+            "must be greater than 0",
+            box.cfg, {flightrec_metrics_interval = 0})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'flightrec_logs_max_msg_size': " ..
+            "must be greater than 0 and less than or equal to 16384",
+            box.cfg, {flightrec_logs_max_msg_size = 0})
+        t.assert_equals(box.cfg.flightrec_logs_size, 10485760)
+    end)
+    t.assert_error_msg_contains('is not a flight recorder file',
+                                flightrec.read,
+                                fio.pathjoin(cg.server.workdir,
+                                             '00000000000000000000.snap'))
+end
@@ -47,6 +47,8 @@ g.test_autocomplete = function()
                               'conn1:is_connected(',
                               'conn1:eval(',
                               'conn1:on_schema_reload(',
+                              'conn1:batch(',
+                              'conn1:vclock_token(',
                               })
 
     -- it should return all spaces and indexes
@@ -185,21 +185,23 @@ g2.test_space_stat_memtx = function(cg)
                                                 field_map_size = 4,
                                                 waste_size = 0 } }
                          }
-        t.assert_equals(s:stat(), old_stat)
+        t.assert_equals(s:stat().tuple, old_stat.tuple)
 
         box.begin()
         s:delete{3}
         s:insert{'new', 3}
-        t.assert_equals(s:stat(), use_mvcc and old_stat or new_stat)
+        t.assert_equals(s:stat().tuple,
+                        (use_mvcc and old_stat or new_stat).tuple)
         box.rollback()
-        t.assert_equals(s:stat(), old_stat)
+        t.assert_equals(s:stat().tuple, old_stat.tuple)
 
         box.begin()
         s:delete{3}
         s:insert{'new', 3}
-        t.assert_equals(s:stat(), use_mvcc and old_stat or new_stat)
+        t.assert_equals(s:stat().tuple,
+                        (use_mvcc and old_stat or new_stat).tuple)
         box.commit()
-        t.assert_equals(s:stat(), new_stat)
+        t.assert_equals(s:stat().tuple, new_stat.tuple)
     end, {cg.params.use_mvcc})
 end
 
@@ -209,7 +211,7 @@ g2.test_space_stat_vinyl = function(cg)
         local s = box.schema.space.create('vinyl', {engine = 'vinyl'})
         s:create_index('pk', {parts = {2}})
         s:insert{string.rep('a', 251), 0}
-        t.assert_equals(s:stat(), {})
+        t.assert_equals(s:stat().tuple, nil)
     end)
 end
 
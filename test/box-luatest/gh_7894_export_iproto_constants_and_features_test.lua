@@ -86,6 +86,11 @@ local reference_table = {
         INDEX_NAME = 0x5f,
         TUPLE_FORMATS = 0x60,
         IS_SYNC = 0x61,
+        COMPRESSION = 0x62,
+        FUNCTION_ID = 0x63,
+        CURSOR_ID = 0x64,
+        COMPRESSION_LEVEL = 0x65,
+        WAIT_VCLOCK = 0x66,
     },
 
     -- `iproto_metadata_key` enumeration.
@@ -166,7 +171,7 @@ local reference_table = {
     },
 
     -- `IPROTO_CURRENT_VERSION` constant
-    protocol_version = 7,
+    protocol_version = 11,
 
     -- `feature_id` enumeration
     protocol_features = {
@@ -180,6 +185,10 @@ local reference_table = {
         dml_tuple_extension = true,
         call_ret_tuple_extension = true,
         call_arg_tuple_extension = true,
+        compression = true,
+        call_by_function_id = true,
+        cursor = true,
+        wait_vclock = true,
     },
     feature = {
         streams = 0,
@@ -192,6 +201,10 @@ local reference_table = {
         dml_tuple_extension = 7,
         call_ret_tuple_extension = 8,
         call_arg_tuple_extension = 9,
+        compression = 10,
+        call_by_function_id = 11,
+        cursor = 12,
+        wait_vclock = 13,
     },
 }
 
@@ -0,0 +1,155 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({engine = {'memtx', 'vinyl'}}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {
+            engine = engine,
+            format = {
+                {'id', 'unsigned'},
+                {'group', 'string'},
+                {'value', 'any', is_nullable = true},
+            },
+        })
+        s:create_index('pk')
+        s:create_index('group', {parts = {{'group'}, {'id'}}})
+        s:insert({1, 'a', 10})
+        s:insert({2, 'b', 1.5})
+        s:insert({3, 'a', -3})
+        s:insert({4, 'c', box.NULL})
+        s:insert({5, 'b', 7})
+        s:insert({6, 'a'})
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_aggregate = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:aggregate(nil, {
+            'count', {'sum', 3}, {'min', 'value'}, {'max', 'value'},
+        }), {{6, 15.5, -3, 10}})
+        t.assert_equals(s:aggregate({3}, {'count', {'sum', 'value'},
+                                          iterator = 'GE'}), {{4, 4}})
+        t.assert_equals(s:aggregate({1}, {'count', {'sum', 'id'},
+                                          iterator = 'GT'}), {{5, 20}})
+        t.assert_equals(s:aggregate(nil, {{'sum', 'id'}}), {{21}})
+        -- Aggregates over nothing.
+        t.assert_equals(s:aggregate({100}, {'count', {'sum', 3},
+                                            {'min', 3}, {'max', 3}}),
+                        {{0, box.NULL, box.NULL, box.NULL}})
+        t.assert_equals(s:aggregate(nil, {{'max', 2}, {'min', 2}}),
+                        {{'c', 'a'}})
+    end)
+end
+
+g.test_group_by = function(cg)
+    cg.server:exec(function()
+        local sk = box.space.test.index.group
+        t.assert_equals(sk:aggregate(nil, {
+            'count', {'sum', 'value'}, {'max', 'id'}, group_by = 1,
+        }), {
+            {'a', 3, 7, 6},
+            {'b', 2, 8.5, 5},
+            {'c', 1, box.NULL, 4},
+        })
+        t.assert_equals(sk:aggregate('b', {'count', {'sum', 3},
+                                           group_by = 1, iterator = 'LE'}), {
+            {'b', 2, 8.5},
+            {'a', 3, 7},
+        })
+        t.assert_equals(sk:aggregate({'a'}, {'count', group_by = 2}), {
+            {'a', 1, 1}, {'a', 3, 1}, {'a', 6, 1},
+        })
+        t.assert_equals(sk:aggregate({'z'}, {'count', group_by = 1}), {})
+        t.assert_equals(sk:aggregate(nil, {'count', group_by = 0}), {{6}})
+    end)
+end
+
+g.test_overflow = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:truncate()
+        s:insert({1, 'a', 2^63 - 1})
+        s:insert({2, 'a', 2^63 - 1})
+        s:insert({3, 'a', -2^63})
+        local sum = s:aggregate(nil, {{'sum', 3}})[1][1]
+        t.assert_equals(type(sum), 'number')
+        t.assert_almost_equals(sum, 2^63, 2^20)
+        s:replace({3, 'a', 18446744073709551615ULL})
+        sum = s:aggregate({3}, {{'sum', 3}, {'max', 3}})[1]
+        t.assert_equals(sum, {2^64, 18446744073709551615ULL})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local sk = s.index.group
+        t.assert_error_msg_equals(
+            "Usage: index:aggregate(key, {aggregate, ...})",
+            s.aggregate, s)
+        t.assert_error_msg_equals(
+            "at least one aggregate expected",
+            s.aggregate, s, nil, {})
+        t.assert_error_msg_equals(
+            "unknown aggregate function 'avg'",
+            s.aggregate, s, nil, {{'avg', 3}})
+        t.assert_error_msg_equals(
+            "aggregate 2 must be a function name or {function, field}",
+            s.aggregate, s, nil, {'count', 3})
+        t.assert_error_msg_equals(
+            "aggregate function 'sum' needs a field",
+            s.aggregate, s, nil, {'sum'})
+        t.assert_error_msg_equals(
+            "aggregate 1 field must be a positive integer or a field name",
+            s.aggregate, s, nil, {{'sum', 0}})
+        t.assert_error_msg_equals(
+            "Field 'foo' was not found in the tuple",
+            s.aggregate, s, nil, {{'sum', 'foo'}})
+        t.assert_error_msg_equals(
+            "group_by must be an integer from 0 to 2",
+            sk.aggregate, sk, nil, {'count', group_by = 3})
+        t.assert_error_msg_equals(
+            "Tuple field 2 type does not match one required by " ..
+            "operation: expected number, got string",
+            s.aggregate, s, nil, {{'sum', 2}})
+        s:insert({7, 'd', {1, 2}})
+        t.assert_error_msg_equals(
+            "Tuple field 3 type does not match one required by " ..
+            "operation: expected scalar, got array",
+            s.aggregate, s, nil, {{'max', 3}})
+        t.assert_error_msg_equals(
+            "Invalid key part count (expected [0..1], got 2)",
+            s.aggregate, s, {1, 2}, {'count', iterator = 'GE'})
+    end)
+end
+
+g.test_unsupported_group_by = function(cg)
+    t.skip_if(cg.params.engine == 'vinyl', 'vinyl has only TREE indexes')
+    cg.server:exec(function()
+        local s = box.space.test
+        s:create_index('hash', {type = 'hash', parts = {'id'}})
+        t.assert_equals(s.index.hash:aggregate(nil, {'count'}), {{6}})
+        t.assert_error_msg_equals(
+            "HASH does not support aggregate with group_by",
+            s.index.hash.aggregate, s.index.hash, nil,
+            {'count', group_by = 1})
+    end)
+end
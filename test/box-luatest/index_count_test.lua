@@ -0,0 +1,105 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_memtx_tree = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}, {3, 'string'}},
+                              unique = false})
+        s:create_index('hk', {parts = {{3, 'string'}}, unique = false,
+                              hint = false})
+        s:create_index('mk', {parts = {{4, 'unsigned', path = '[*]'}},
+                              unique = false})
+        for i = 1, 3000 do
+            s:insert({i, i % 100, tostring(i % 7), {i % 10, i % 10 + 1}})
+        end
+        for i = 1, 3000, 3 do
+            s:delete(i)
+        end
+        local keys = {
+            pk = {{}, {1}, {2}, {1500}, {3000}, {5000}},
+            sk = {{}, {0}, {50}, {50, '1'}, {99, '6'}, {100}},
+            hk = {{}, {'0'}, {'3'}, {'7'}},
+            mk = {{}, {0}, {5}, {11}, {20}},
+        }
+        local iterators = {'EQ', 'REQ', 'GE', 'GT', 'LE', 'LT'}
+        for name, index_keys in pairs(keys) do
+            local index = s.index[name]
+            for _, key in ipairs(index_keys) do
+                for _, it in ipairs(iterators) do
+                    local opts = {iterator = it}
+                    local expected = #index:select(key, opts)
+                    local msg = string.format('%s %s %s', name,
+                                              require('json').encode(key), it)
+                    t.assert_equals(index:count(key, opts), expected, msg)
+                    opts.approximate = true
+                    t.assert_equals(index:count(key, opts), expected, msg)
+                end
+            end
+        end
+    end)
+end
+
+g.test_vinyl_approximate = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024})
+        s:create_index('sk', {parts = {{2, 'unsigned'}}, unique = false,
+                              page_size = 1024})
+        local pad = string.rep('x', 100)
+        for i = 1, 10000 do
+            s:insert({i, i % 10, pad})
+        end
+        box.snapshot()
+        for i = 10001, 11000 do
+            s:insert({i, i % 10, pad})
+        end
+        local function check(index, key, it, exact)
+            local count = index:count(key, {iterator = it,
+                                            approximate = true})
+            local msg = string.format('%s %s %s', index.name,
+                                      require('json').encode(key), it)
+            -- Only the pages at the range boundaries are inexact.
+            t.assert_ge(count, exact, msg)
+            t.assert_le(count, exact + 500, msg)
+        end
+        local pk = s.index.pk
+        check(pk, {}, 'ALL', 11000)
+        check(pk, {5000}, 'EQ', 1)
+        check(pk, {5000}, 'GE', 6001)
+        check(pk, {5000}, 'GT', 6000)
+        check(pk, {5000}, 'LE', 5000)
+        check(pk, {5000}, 'LT', 4999)
+        check(pk, {20000}, 'GE', 0)
+        check(pk, {0}, 'LE', 0)
+        local sk = s.index.sk
+        check(sk, {3}, 'EQ', 1100)
+        check(sk, {3}, 'LT', 3300)
+        -- Exact count still scans the index.
+        t.assert_equals(sk:count({3}), 1100)
+        t.assert_error_msg_contains(
+            'does not support requested iterator type',
+            pk.count, pk, {1}, {iterator = 'BITS_ALL_SET',
+                                approximate = true})
+    end)
+end
@@ -0,0 +1,76 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({engine = {'memtx', 'vinyl'}}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        for _, name in ipairs({'src', 'dst'}) do
+            local s = box.schema.space.create(name, {engine = engine})
+            s:create_index('pk')
+            s:create_index('bucket_id', {parts = {{2, 'unsigned'}},
+                                         unique = false})
+        end
+        for i = 1, 100 do
+            box.space.src:insert({i, i % 3, 'data' .. i})
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.src:drop()
+        box.space.dst:drop()
+    end)
+end)
+
+g.test_export = function(cg)
+    cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local function totable(tuples)
+            local res = {}
+            for _, tuple in ipairs(tuples) do
+                table.insert(res, tuple:totable())
+            end
+            return res
+        end
+        local src = box.space.src
+        local data = src.index.bucket_id:export(1)
+        t.assert_equals(type(data), 'string')
+        local bucket = totable(src.index.bucket_id:select(1))
+        t.assert_equals(#bucket, 34)
+        t.assert_equals(msgpack.decode(data), bucket)
+        -- A bucket is moved with export() and replace_batch().
+        t.assert_equals(box.space.dst:replace_batch(data), 34)
+        t.assert_equals(totable(box.space.dst:select()), bucket)
+        -- Options.
+        t.assert_equals(msgpack.decode(src:export({10}, {iterator = 'LT',
+                                                         limit = 2})),
+                        {{9, 0, 'data9'}, {8, 2, 'data8'}})
+        t.assert_equals(msgpack.decode(src:export({}, {limit = 0})), {})
+        t.assert_equals(msgpack.decode(src:export(1000)), {})
+        t.assert_equals(#msgpack.decode(src:export()), 100)
+    end)
+end
+
+g.test_export_invalid = function(cg)
+    cg.server:exec(function()
+        local src = box.space.src
+        t.assert_error_msg_equals('limit must be a non-negative integer',
+                                  src.export, src, {}, {limit = -1})
+        t.assert_error_msg_equals('limit must be a non-negative integer',
+                                  src.export, src, {}, {limit = 'a'})
+        t.assert_error_msg_contains('Supplied key type of part 0 does not ' ..
+                                    'match index part type',
+                                    src.export, src, 'a')
+    end)
+end
@@ -0,0 +1,77 @@
+local t = require('luatest')
+local server = require('luatest.server')
+
+local g = t.group('index_get_many', {
+    {engine = 'memtx', index = 'tree'},
+    {engine = 'memtx', index = 'hash'},
+    {engine = 'vinyl', index = 'tree'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_get_many = function(cg)
+    cg.server:exec(function(engine, index)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {type = index})
+        s:create_index('sk', {type = index, parts = {2, 'string'}})
+        for i = 1, 100 do
+            s:insert({i, 'v' .. i})
+        end
+        t.assert_equals(s:get_many({}), {})
+        t.assert_equals(s:get_many({1, {2}, 50}),
+                        {{1, 'v1'}, {2, 'v2'}, {50, 'v50'}})
+        -- Missing keys leave holes in the result.
+        local res = s.index.pk:get_many({1000, 3, 2000, 4})
+        t.assert_equals(res[1], nil)
+        t.assert_equals(res[2], {3, 'v3'})
+        t.assert_equals(res[3], nil)
+        t.assert_equals(res[4], {4, 'v4'})
+        local keys = {}
+        local expected = {}
+        for i = 1, 40 do
+            keys[i] = 'v' .. (i * 2)
+            expected[i] = {i * 2, 'v' .. (i * 2)}
+        end
+        t.assert_equals(s.index.sk:get_many(keys), expected)
+        -- More keys than fit in the preallocated memtx result array.
+        keys = {}
+        for i = 1, 100 do
+            keys[i] = 101 - i
+        end
+        res = s:get_many(keys)
+        t.assert_equals(#res, 100)
+        t.assert_equals(res[1], {100, 'v100'})
+        t.assert_equals(res[100], {1, 'v1'})
+    end, {cg.params.engine, cg.params.index})
+end
+
+g.test_get_many_invalid = function(cg)
+    cg.server:exec(function(engine, index)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {type = index})
+        t.assert_error_msg_content_equals(
+            "Usage: index:get_many({key1, key2, ...})",
+            s.get_many, s, 1)
+        t.assert_error_msg_content_equals(
+            "Invalid key part count in an exact match " ..
+            "(expected 1, got 0)", s.get_many, s, {1, {}})
+        t.assert_error_msg_content_equals(
+            "Supplied key type of part 0 does not match index part type: " ..
+            "expected unsigned", s.get_many, s, {'a'})
+    end, {cg.params.engine, cg.params.index})
+end
@@ -0,0 +1,42 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {iproto_busy_poll = 0.001}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.iproto_busy_poll, 0.001)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_busy_poll': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {iproto_busy_poll = -1})
+        t.assert_equals(box.cfg.iproto_busy_poll, 0.001)
+    end)
+end
+
+g.test_requests = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    for i = 1, 100 do
+        t.assert_equals(conn:eval('return ...', {i}), i)
+    end
+    -- Busy-polling may be disabled and enabled at runtime.
+    cg.server:exec(function()
+        box.cfg({iproto_busy_poll = 0})
+    end)
+    t.assert_equals(conn:eval('return 1'), 1)
+    cg.server:exec(function()
+        box.cfg({iproto_busy_poll = 0.001})
+    end)
+    t.assert_equals(conn:eval('return 2'), 2)
+    conn:close()
+end
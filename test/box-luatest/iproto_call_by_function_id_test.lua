@@ -0,0 +1,49 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'sum', function(a, b) return a + b end)
+        rawset(_G, 'secret', function() return 'secret' end)
+        box.schema.func.create('sum')
+        box.schema.func.create('secret')
+        box.schema.func.create('lua_sum', {
+            language = 'LUA',
+            body = 'function(a, b) return a + b end',
+        })
+        box.schema.user.grant('guest', 'execute', 'function', 'sum')
+        box.schema.user.grant('guest', 'execute', 'function', 'lua_sum')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_call_by_function_id = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    t.assert(conn.peer_protocol_features.call_by_function_id)
+    local id = conn.space._vfunc.index.name:get('sum').id
+    t.assert_equals(conn:call(id, {1, 2}), 3)
+    id = conn.space._vfunc.index.name:get('lua_sum').id
+    t.assert_equals(conn:call(id, {3, 4}), 7)
+    local f = conn:call(id, {5, 6}, {is_async = true})
+    t.assert_equals(f:wait_result(), {11})
+    -- Access is checked.
+    id = cg.server:exec(function()
+        return box.func.secret.id
+    end)
+    t.assert_error_msg_equals(
+        "Execute access to function 'secret' is denied for user 'guest'",
+        conn.call, conn, id)
+    -- Unknown function.
+    t.assert_error_msg_equals("Function '9999' does not exist",
+                              conn.call, conn, 9999)
+    conn:close()
+end
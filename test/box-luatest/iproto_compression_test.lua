@@ -0,0 +1,106 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'super')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({iproto_compression_threshold = 16384})
+    end)
+end)
+
+local function sent_bytes(cg)
+    return cg.server:exec(function()
+        return box.stat.net().SENT.total
+    end)
+end
+
+local function call_big(conn)
+    return conn:eval([[
+        local t = {}
+        for i = 1, 1000 do
+            table.insert(t, {i, string.rep('x', 100)})
+        end
+        return t
+    ]])
+end
+
+local function check_result(res)
+    t.assert_equals(#res, 1000)
+    for i, v in ipairs(res) do
+        t.assert_equals(v, {i, string.rep('x', 100)})
+    end
+end
+
+g.test_option = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.iproto_compression_threshold, 16384)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_compression_threshold': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {iproto_compression_threshold = -1})
+        box.cfg({iproto_compression_threshold = 0})
+        t.assert_equals(box.cfg.iproto_compression_threshold, 0)
+    end)
+end
+
+-- Checks that big responses are compressed only if the client allows it.
+g.test_compression = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    t.assert(conn.peer_protocol_features.compression)
+    local sent = sent_bytes(cg)
+    check_result(call_big(conn))
+    local uncompressed = sent_bytes(cg) - sent
+    conn:close()
+
+    conn = net.connect(cg.server.net_box_uri, {compression = true})
+    t.assert_equals(conn.state, 'active')
+    sent = sent_bytes(cg)
+    check_result(call_big(conn))
+    local compressed = sent_bytes(cg) - sent
+    t.assert_lt(compressed * 10, uncompressed)
+    -- Small responses aren't compressed.
+    t.assert_equals(conn:eval('return ...', {1, 2, 3}), {1, 2, 3})
+    -- Pipelined responses don't mix.
+    local futures = {}
+    for i = 1, 20 do
+        if i % 2 == 0 then
+            table.insert(futures, conn:eval([[
+                return string.rep('y', 20000)
+            ]], {}, {is_async = true}))
+        else
+            table.insert(futures, conn:eval('return ...', {i},
+                                            {is_async = true}))
+        end
+    end
+    for i, future in ipairs(futures) do
+        local res = future:wait_result()
+        if i % 2 == 0 then
+            t.assert_equals(res, {string.rep('y', 20000)})
+        else
+            t.assert_equals(res, {i})
+        end
+    end
+    -- Compression can be disabled.
+    cg.server:exec(function()
+        box.cfg({iproto_compression_threshold = 0})
+    end)
+    sent = sent_bytes(cg)
+    check_result(call_big(conn))
+    t.assert_ge(sent_bytes(cg) - sent, uncompressed)
+    conn:close()
+end
@@ -0,0 +1,96 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('iproto_cursor', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        for i = 1, 10 do
+            s:insert({i})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end, {cg.params.engine})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cursor = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert(conn.peer_protocol_features.cursor)
+    local s = conn.space.test
+    -- Open a cursor and fetch the first page.
+    local tuples, cursor = s:select({3}, {iterator = 'GE', limit = 3,
+                                          cursor = 0})
+    t.assert_equals(tuples, {{3}, {4}, {5}})
+    t.assert_type(cursor, 'number')
+    -- Tuples inserted after the cursor position are visible.
+    cg.server:exec(function()
+        box.space.test:insert({11})
+    end)
+    tuples, cursor = s:select(nil, {limit = 4, cursor = cursor})
+    t.assert_equals(tuples, {{6}, {7}, {8}, {9}})
+    t.assert_type(cursor, 'number')
+    -- The cursor is closed once exhausted.
+    local last = cursor
+    tuples, cursor = s:select(nil, {limit = 4, cursor = cursor})
+    t.assert_equals(tuples, {{10}, {11}})
+    t.assert_equals(cursor, nil)
+    t.assert_error_msg_equals('No such cursor', s.select, s, nil,
+                              {cursor = last})
+    -- Offset and limit 0 are handled on open.
+    tuples, cursor = s:select(nil, {offset = 8, limit = 1, cursor = 0})
+    t.assert_equals(tuples, {{9}})
+    t.assert_type(cursor, 'number')
+    -- Limit 0 closes the cursor.
+    tuples, last = s:select(nil, {limit = 0, cursor = cursor})
+    t.assert_equals(tuples, {})
+    t.assert_equals(last, nil)
+    t.assert_error_msg_equals('No such cursor', s.select, s, nil,
+                              {cursor = cursor})
+    -- A cursor may be opened after a position.
+    tuples = s:select(nil, {after = {7}, cursor = 0})
+    t.assert_equals(tuples, {{8}, {9}, {10}, {11}})
+    cg.server:exec(function()
+        box.space.test:delete({11})
+    end)
+    conn:close()
+end
+
+g.test_cursor_errors = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local s = conn.space.test
+    local _, cursor = s:select(nil, {limit = 1, cursor = 0})
+    -- A cursor is bound to the space and index it was opened for.
+    t.assert_error_msg_equals('No such cursor',
+                              conn.space._vspace.select, conn.space._vspace,
+                              nil, {cursor = cursor})
+    -- A cursor is bound to the connection.
+    local conn2 = net.connect(cg.server.net_box_uri)
+    t.assert_error_msg_equals('No such cursor', conn2.space.test.select,
+                              conn2.space.test, nil, {cursor = cursor})
+    conn2:close()
+    t.assert_error_msg_equals(
+        'options cursor and fetch_pos are mutually exclusive',
+        s.select, s, nil, {cursor = 0, fetch_pos = true})
+    -- The number of open cursors is limited.
+    for _ = 2, 64 do
+        s:select(nil, {limit = 1, cursor = 0})
+    end
+    t.assert_error_msg_equals('Too many open cursors', s.select, s, nil,
+                              {limit = 1, cursor = 0})
+    conn:close()
+    -- Cursors are freed on disconnect.
+    conn = net.connect(cg.server.net_box_uri)
+    s = conn.space.test
+    t.assert_equals(s:select(nil, {limit = 1, cursor = 0}), {{1}})
+    conn:close()
+end
@@ -0,0 +1,54 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'ping', function() return true end)
+        box.schema.func.create('ping')
+        box.schema.user.grant('guest', 'execute', 'function', 'ping')
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_latency = function(cg)
+    cg.server:exec(function()
+        box.stat.reset()
+        t.assert_equals(box.stat.net().LATENCY, {})
+    end)
+    local space = cg.server.net_box.space.test
+    for i = 1, 10 do
+        cg.server.net_box:call('ping')
+        space:insert({i})
+        space:select({i})
+    end
+    cg.server:exec(function()
+        local stat = box.stat.net().LATENCY
+        t.assert_equals(box.stat.net.LATENCY, stat)
+        for _, name in ipairs({'CALL', 'INSERT', 'SELECT'}) do
+            t.assert_equals(stat[name].count, 10, name)
+            for _, kind in ipairs({'queue', 'tx', 'wal'}) do
+                local latency = stat[name][kind]
+                local msg = name .. ' ' .. kind
+                t.assert_ge(latency.p50, 0, msg)
+                t.assert_ge(latency.p90, latency.p50, msg)
+                t.assert_ge(latency.p99, latency.p90, msg)
+                t.assert_ge(latency.max, latency.p99, msg)
+            end
+        end
+        -- Inserts wait for the WAL and the wait is a part of the TX time.
+        t.assert_gt(stat.INSERT.wal.max, 0)
+        t.assert_ge(stat.INSERT.tx.max, stat.INSERT.wal.max)
+        box.stat.reset()
+        t.assert_equals(box.stat.net().LATENCY, {})
+    end)
+end
@@ -0,0 +1,108 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            iproto_read_view_interval = 0.1,
+        },
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {iproto_read_view = true})
+        s:create_index('primary')
+        s:create_index('secondary', {type = 'hash', parts = {2, 'unsigned'}})
+        for i = 1, 10 do
+            s:insert({i, i * 10})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+        box.schema.space.create('private', {iproto_read_view = true})
+        box.space.private:create_index('primary')
+        box.space.private:insert({1})
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({iproto_read_view_interval = 0.1})
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.space.test.iproto_read_view, true)
+        t.assert_equals(box.space.private.iproto_read_view, true)
+        local s = box.schema.space.create('temp')
+        t.assert_equals(s.iproto_read_view, nil)
+        s:alter({iproto_read_view = true})
+        t.assert_equals(s.iproto_read_view, true)
+        s:alter({iproto_read_view = false})
+        t.assert_equals(s.iproto_read_view, nil)
+        s:drop()
+        t.assert_error_msg_equals(
+            "Vinyl does not support iproto_read_view",
+            box.schema.space.create, 'vinyl',
+            {engine = 'vinyl', iproto_read_view = true})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_read_view_interval': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {iproto_read_view_interval = -1})
+    end)
+end
+
+g.test_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    local s = conn.space.test
+    t.assert_equals(s:select({}, {limit = 3}), {{1, 10}, {2, 20}, {3, 30}})
+    t.assert_equals(s:select({5}, {iterator = 'ge', offset = 4}),
+                    {{9, 90}, {10, 100}})
+    t.assert_equals(s:select({3}, {iterator = 'lt'}), {{2, 20}, {1, 10}})
+    t.assert_equals(s:select({}, {iterator = 'req', limit = 2}),
+                    {{10, 100}, {9, 90}})
+    t.assert_equals(s.index.secondary:select({70}), {{7, 70}})
+    t.assert_equals(s:get({4}), {4, 40})
+    t.assert_equals(s:get({11}), nil)
+    t.assert_error_msg_contains(
+        "Read access to space 'private' is denied for user 'guest'",
+        conn.space.private.select, conn.space.private)
+    conn:close()
+end
+
+-- Checks that SELECT requests are served from a read view that may lag
+-- behind the actual database state by up to iproto_read_view_interval.
+g.test_stale_read = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    cg.server:exec(function()
+        box.space.test:replace({11, 110})
+        -- Refreshes the read view and effectively disables further
+        -- refreshes.
+        box.cfg({iproto_read_view_interval = 3600})
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(conn.space.test:get({11}), {11, 110})
+    end)
+    cg.server:exec(function()
+        box.space.test:replace({11, 111})
+    end)
+    t.assert_equals(conn.space.test:get({11}), {11, 110})
+    t.assert_equals(conn.space.test:replace({11, 112}), {11, 112})
+    cg.server:exec(function()
+        box.cfg({iproto_read_view_interval = 0})
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(conn.space.test:get({11}), {11, 112})
+    end)
+    cg.server:exec(function()
+        box.space.test:delete({11})
+    end)
+    conn:close()
+end
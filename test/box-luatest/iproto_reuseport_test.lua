@@ -0,0 +1,85 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+local THREADS = 4
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            iproto_threads = THREADS,
+            iproto_reuseport = true,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function listen(cg, uri)
+    return cg.server:exec(function(uri)
+        box.cfg({listen = uri})
+        return box.info.listen
+    end, {uri})
+end
+
+g.after_each(function(cg)
+    listen(cg, cg.server.net_box_uri)
+end)
+
+local function check_connections(cg, uri, count, thread_count)
+    local conns = {}
+    for i = 1, count do
+        conns[i] = net.connect(uri)
+        t.assert_equals(conns[i].state, 'active')
+        t.assert_equals(conns[i]:eval('return 1 + 1'), 2)
+    end
+    cg.server:exec(function(count, thread_count)
+        local total = 0
+        local used = 0
+        for i = 1, box.cfg.iproto_threads do
+            local current = box.stat.net.thread[i].CONNECTIONS.current
+            total = total + current
+            if current > 0 then
+                used = used + 1
+            end
+        end
+        t.assert_equals(total, count)
+        t.assert_ge(used, thread_count)
+    end, {count, thread_count})
+    for i = 1, count do
+        conns[i]:close()
+    end
+end
+
+g.test_option = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.iproto_reuseport, true)
+        t.assert_error_msg_equals(
+            "Can't set option 'iproto_reuseport' dynamically",
+            box.cfg, {iproto_reuseport = false})
+    end)
+end
+
+-- Checks that each thread accepts connections on its own socket.
+g.test_tcp = function(cg)
+    local uri = listen(cg, 'localhost:0')
+    t.assert_str_matches(uri, '.*:%d+')
+    -- The kernel balances connections by a hash of the client address,
+    -- so with many connections every socket must get some.
+    check_connections(cg, uri, 100, THREADS)
+    -- Rebinding to the same port works.
+    t.assert_equals(listen(cg, uri), uri)
+    check_connections(cg, uri, 100, THREADS)
+end
+
+-- UNIX sockets can't be bound twice so they are shared by the threads.
+g.test_unix = function(cg)
+    check_connections(cg, cg.server.net_box_uri, 10, 1)
+    listen(cg, {'localhost:0', cg.server.net_box_uri})
+    check_connections(cg, cg.server.net_box_uri, 10, 1)
+end
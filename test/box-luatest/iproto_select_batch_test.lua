@@ -0,0 +1,58 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('iproto_select_batch', {
+    {engine = 'memtx'},
+    {engine = 'vinyl'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('primary')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        -- Make vinyl read from disk so that selects yield.
+        box.snapshot()
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end, {cg.params.engine})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks that pipelined SELECT requests, which are sent to the tx thread
+-- in batches, are processed correctly.
+g.test_pipelined_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    local s = conn.space.test
+    local futures = {}
+    for i = 1, 200 do
+        if i % 50 == 0 then
+            table.insert(futures, s:replace({i + 1000}, {is_async = true}))
+        elseif i % 30 == 0 then
+            table.insert(futures, s.index.primary:select(
+                {'foo'}, {is_async = true}))
+        else
+            table.insert(futures, s:select({i % 100 + 1},
+                                           {is_async = true}))
+        end
+    end
+    for i, future in ipairs(futures) do
+        if i % 50 == 0 then
+            t.assert_equals(future:wait_result(), {i + 1000})
+        elseif i % 30 == 0 then
+            local _, err = future:wait_result()
+            t.assert_str_contains(tostring(err), 'Supplied key type')
+        else
+            t.assert_equals(future:wait_result(), {{i % 100 + 1}})
+        end
+    end
+    conn:close()
+end
@@ -0,0 +1,52 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'sleep', function(timeout)
+            require('fiber').sleep(timeout)
+        end)
+        box.schema.func.create('sleep')
+        box.schema.user.grant('guest', 'execute', 'function', 'sleep')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({iproto_slow_request_threshold = 0})
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.iproto_slow_request_threshold, 0)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_slow_request_threshold': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {iproto_slow_request_threshold = -1})
+        box.cfg({iproto_slow_request_threshold = 0.5})
+        t.assert_equals(box.cfg.iproto_slow_request_threshold, 0.5)
+    end)
+end
+
+g.test_slow_request = function(cg)
+    cg.server.net_box:call('sleep', {0.2})
+    t.assert_not(cg.server:grep_log('slow request'))
+    cg.server:exec(function()
+        box.cfg({iproto_slow_request_threshold = 0.1})
+    end)
+    cg.server.net_box:call('sleep', {0.01})
+    t.assert_not(cg.server:grep_log('slow request'))
+    cg.server.net_box:call('sleep', {0.2})
+    t.assert(cg.server:grep_log(
+        'slow request CALL, sync %d+: [%d.]+ sec %(read [%d.]+, ' ..
+        'queue [%d.]+, execution [%d.]+, wal [%d.]+, reply [%d.]+%)'))
+end
@@ -0,0 +1,95 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('iproto_stream_batch', {
+    {engine = 'memtx'},
+    {engine = 'vinyl'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('primary')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end, {cg.params.engine})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+-- Checks that pipelined stream requests, which are sent to the tx thread
+-- in batches, are processed in order.
+g.test_pipelined_stream = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    local streams = {}
+    for i = 1, 3 do
+        streams[i] = conn:new_stream()
+    end
+    local futures = {}
+    for i, stream in ipairs(streams) do
+        local s = stream.space.test
+        futures[i] = {}
+        table.insert(futures[i], stream:begin({is_async = true}))
+        for j = 1, 100 do
+            table.insert(futures[i], s:replace({i, j}, {is_async = true}))
+            table.insert(futures[i], s:get({i}, {is_async = true}))
+        end
+        table.insert(futures[i], s:insert({i}, {is_async = true}))
+        table.insert(futures[i], stream:commit({is_async = true}))
+    end
+    for i = 1, #streams do
+        local f = futures[i]
+        t.assert_equals(f[1]:wait_result(), nil)
+        for j = 1, 100 do
+            t.assert_equals(f[2 * j]:wait_result(), {{i, j}})
+            t.assert_equals(f[2 * j + 1]:wait_result(), {{i, j}})
+        end
+        local _, err = f[202]:wait_result()
+        t.assert_str_contains(tostring(err), 'Duplicate key exists')
+        t.assert_equals(f[203]:wait_result(), nil)
+    end
+    cg.server:exec(function(n)
+        local res = box.space.test:select()
+        t.assert_equals(#res, n)
+        for i, tuple in ipairs(res) do
+            t.assert_equals(tuple, {i, 100})
+        end
+    end, {#streams})
+    conn:close()
+end
+
+-- Checks that a transaction with pipelined requests is rolled back if
+-- the connection is closed before it's committed.
+g.test_pipelined_stream_disconnect = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local stream = conn:new_stream()
+    local s = stream.space.test
+    stream:begin({is_async = true})
+    local futures = {}
+    for i = 1, 100 do
+        table.insert(futures, s:replace({i}, {is_async = true}))
+    end
+    futures[#futures]:wait_result()
+    conn:close()
+    t.helpers.retrying({}, function()
+        cg.server:exec(function()
+            t.assert_equals(box.stat.net().STREAMS.current, 0)
+        end)
+    end)
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:select(), {})
+    end)
+end
@@ -0,0 +1,132 @@
+local t = require('luatest')
+local net = require('net.box')
+local replica_set = require('luatest.replica_set')
+local server = require('luatest.server')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.replica_set = replica_set:new({})
+    local box_cfg = {
+        replication = {
+            server.build_listen_uri('master', cg.replica_set.id),
+        },
+        replication_timeout = 0.1,
+        memtx_use_mvcc_engine = true,
+    }
+    cg.master = cg.replica_set:build_and_add_server({alias = 'master',
+                                                     box_cfg = box_cfg})
+    box_cfg.read_only = true
+    cg.replica = cg.replica_set:build_and_add_server({alias = 'replica',
+                                                      box_cfg = box_cfg})
+    cg.replica_set:start()
+    cg.master:exec(function()
+        box.schema.space.create('test'):create_index('pk')
+        box.schema.user.grant('guest', 'super')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    for _, s in ipairs({cg.master, cg.replica}) do
+        s:exec(function()
+            rawset(_G, 'get', function(key) return box.space.test:get(key) end)
+        end)
+    end
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+g.after_each(function(cg)
+    cg.replica:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        box.cfg({iproto_wait_vclock_timeout = 1})
+    end)
+end)
+
+-- Checks that the writes made over a connection are reflected in its token.
+g.test_vclock_token = function(cg)
+    local conn = net.connect(cg.master.net_box_uri)
+    t.assert(conn.peer_protocol_features.wait_vclock)
+    t.assert_equals(conn:vclock_token(), nil)
+    conn.space.test:replace({1})
+    local id, lsn = cg.master:exec(function()
+        return box.info.id, box.info.lsn
+    end)
+    t.assert_equals(conn:vclock_token(), {[id] = lsn})
+    conn.space.test:delete({1})
+    t.assert_equals(conn:vclock_token(), {[id] = lsn + 1})
+    -- Reads don't change the token.
+    conn.space.test:select()
+    conn:call('get', {1})
+    t.assert_equals(conn:vclock_token(), {[id] = lsn + 1})
+    -- The token of an interactive transaction is returned on commit.
+    local stream = conn:new_stream()
+    stream:begin()
+    stream.space.test:replace({2})
+    stream:commit()
+    t.assert_equals(conn:vclock_token(), {[id] = lsn + 2})
+    conn:close()
+end
+
+-- Checks that reads with a token wait for the replica to catch up.
+g.test_wait_vclock = function(cg)
+    local master = net.connect(cg.master.net_box_uri)
+    local replica = net.connect(cg.replica.net_box_uri)
+    cg.replica:exec(function()
+        box.cfg({iproto_wait_vclock_timeout = 0.01})
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+    end)
+    master.space.test:replace({10, 'foo'})
+    local token = master:vclock_token()
+    local opts = {wait_vclock = token}
+    t.assert_error_msg_equals('Timeout exceeded', replica.space.test.select,
+                              replica.space.test, {10}, opts)
+    t.assert_error_msg_equals('Timeout exceeded', replica.call, replica,
+                              'get', {10}, opts)
+    t.assert_error_msg_equals('Timeout exceeded', replica.eval, replica,
+                              'return box.space.test:get(...)', {10}, opts)
+    -- A read without a token doesn't wait.
+    t.assert_equals(replica.space.test:select({10}), {})
+
+    cg.replica:exec(function()
+        box.cfg({iproto_wait_vclock_timeout = 60})
+    end)
+    local futures = {
+        replica.space.test.index.pk:select({10}, {wait_vclock = token,
+                                                  is_async = true}),
+        replica:call('get', {10}, {wait_vclock = token, is_async = true}),
+        replica:eval('return box.space.test:get(...)', {10},
+                     {wait_vclock = token, is_async = true}),
+    }
+    cg.replica:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+    end)
+    t.assert_equals(futures[1]:wait_result(), {{10, 'foo'}})
+    t.assert_equals(futures[2]:wait_result(), {{10, 'foo'}})
+    t.assert_equals(futures[3]:wait_result(), {{10, 'foo'}})
+    -- No wait once the replica has caught up.
+    t.assert_equals(replica.space.test:select({10}, opts), {{10, 'foo'}})
+    master:close()
+    replica:close()
+end
+
+g.test_invalid_wait_vclock = function(cg)
+    local conn = net.connect(cg.replica.net_box_uri)
+    t.assert_error_msg_equals(
+        "wait_vclock must map replica ids to LSNs",
+        conn.call, conn, 'get', {1}, {wait_vclock = {foo = 1}})
+    t.assert_error_msg_contains(
+        "should be of type table",
+        conn.call, conn, 'get', {1}, {wait_vclock = 1})
+    t.assert_error_msg_content_equals(
+        "Invalid MsgPack - WAIT_VCLOCK",
+        conn.call, conn, 'get', {1}, {wait_vclock = {[1000] = 1}})
+    conn:close()
+    cg.replica:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_wait_vclock_timeout': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {iproto_wait_vclock_timeout = -1})
+    end)
+end
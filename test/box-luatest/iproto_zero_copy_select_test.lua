@@ -0,0 +1,63 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('primary')
+        for i = 1, 200 do
+            s:insert({i, string.rep(string.char(i % 26 + 65), 2000)})
+        end
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks that big SELECT results, which are sent directly from the tuple
+-- memory, don't mix with other responses.
+g.test_big_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    local s = conn.space.test
+    local expected = cg.server:exec(function()
+        return box.space.test:select()
+    end)
+    t.assert_equals(#expected, 200)
+    t.assert_equals(s:select(), expected)
+    local futures = {}
+    for i = 1, 100 do
+        if i % 3 == 0 then
+            table.insert(futures, s:select({}, {is_async = true}))
+        elseif i % 3 == 1 then
+            table.insert(futures, s:get({i}, {is_async = true}))
+        else
+            table.insert(futures, conn:eval('return ...', {i},
+                                            {is_async = true}))
+        end
+    end
+    for i, future in ipairs(futures) do
+        local res = future:wait_result()
+        if i % 3 == 0 then
+            t.assert_equals(res, expected)
+        elseif i % 3 == 1 then
+            t.assert_equals(res, expected[i])
+        else
+            t.assert_equals(res, {i})
+        end
+    end
+    -- The tuples sent to the socket must stay valid even if they are
+    -- deleted from the space.
+    local future = s:select({}, {is_async = true})
+    conn:eval('box.space.test:truncate()')
+    t.assert_equals(future:wait_result(), expected)
+    t.assert_equals(s:select(), {})
+    conn:close()
+end
@@ -0,0 +1,75 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INTEGER PRIMARY KEY, s STRING);]])
+        for i = 1, 200 do
+            box.execute('INSERT INTO t VALUES (?, ?);',
+                        {i, string.rep(string.char(i % 26 + 65), 2000)})
+        end
+        box.schema.user.grant('guest', 'read,write,execute', 'universe')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks that big SQL results, which are sent directly from the tuple
+-- memory, don't mix with other responses.
+g.test_big_sql_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    local sql = 'SELECT id, s FROM t WHERE id > ?;'
+    local expected = cg.server:exec(function(sql)
+        return box.execute(sql, {0})
+    end, {sql})
+    t.assert_equals(#expected.rows, 200)
+    local function totable(row)
+        return box.tuple.is(row) and row:totable() or row
+    end
+    local function check(res, expected)
+        t.assert_equals(res.metadata, expected.metadata)
+        t.assert_equals(#res.rows, #expected.rows)
+        for i, row in ipairs(res.rows) do
+            t.assert_equals(totable(row), totable(expected.rows[i]))
+        end
+    end
+    check(conn:execute(sql, {0}), expected)
+    local futures = {}
+    for i = 1, 60 do
+        if i % 3 == 0 then
+            table.insert(futures, conn:execute(sql, {0}, {},
+                                               {is_async = true}))
+        elseif i % 3 == 1 then
+            table.insert(futures, conn:execute('SELECT id FROM t ' ..
+                                               'WHERE id = ?;', {i}, {},
+                                               {is_async = true}))
+        else
+            table.insert(futures, conn:eval('return ...', {i},
+                                            {is_async = true}))
+        end
+    end
+    for i, future in ipairs(futures) do
+        local res = future:wait_result()
+        if i % 3 == 0 then
+            check(res, expected)
+        elseif i % 3 == 1 then
+            t.assert_equals(totable(res.rows[1]), {i})
+        else
+            t.assert_equals(res, {i})
+        end
+    end
+    -- The rows sent to the socket must stay valid even if the table is
+    -- dropped.
+    local future = conn:execute(sql, {0}, {}, {is_async = true})
+    conn:eval('box.execute("DROP TABLE t;")')
+    check(future:wait_result(), expected)
+    conn:close()
+end
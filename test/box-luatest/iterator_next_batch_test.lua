@@ -0,0 +1,61 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({engine = {'memtx', 'vinyl'}}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}}, unique = false})
+        for i = 1, 100 do
+            s:insert({i, i % 10})
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_next_batch = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local it = s:pairs()
+        local tuples = {}
+        while true do
+            local batch = it:next_batch(30)
+            t.assert_le(#batch, 30)
+            if #batch == 0 then
+                break
+            end
+            for _, tuple in ipairs(batch) do
+                table.insert(tuples, tuple)
+            end
+        end
+        t.assert_equals(tuples, s:select())
+        t.assert_equals(it:next_batch(10), {})
+
+        it = s.index.sk:pairs(3, {iterator = 'ge'})
+        local expected = s.index.sk:select(3, {iterator = 'ge'})
+        t.assert_equals(it:next_batch(5), {unpack(expected, 1, 5)})
+        -- The batch API can be mixed with the per-tuple one.
+        local _, tuple = it.gen(it.param, it.state)
+        t.assert_equals(tuple, expected[6])
+        t.assert_equals(it:next_batch(1000), {unpack(expected, 7)})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local it = box.space.test:pairs()
+        local msg = 'count must be an integer from 1 to 1048576'
+        t.assert_error_msg_equals(msg, it.next_batch, it, 0)
+        t.assert_error_msg_equals(msg, it.next_batch, it, 1.5)
+        t.assert_error_msg_equals(msg, it.next_batch, it, 'foo')
+        t.assert_error_msg_equals('Usage: iterator:next_batch(count)',
+                                  it.next_batch, {}, 10)
+    end)
+end
@@ -0,0 +1,60 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {log_async = true}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_write = function(cg)
+    cg.server:exec(function()
+        local log = require('log')
+        local written = log.stat().written
+        for i = 1, 100 do
+            log.info('log_async_test message %d', i)
+        end
+        t.helpers.retrying({}, function()
+            t.assert_ge(log.stat().written, written + 100)
+        end)
+        t.assert_equals(log.stat().dropped, 0)
+    end)
+    t.assert(cg.server:grep_log('log_async_test message 100'))
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local log = require('log')
+        t.assert_equals(box.cfg.log_async, true)
+        t.assert_equals(log.cfg.async, true)
+        t.assert_error_msg_equals(
+            "Can't set option 'log_async' dynamically",
+            box.cfg, {log_async = false})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'log_async_overflow': " ..
+            "expected 'block' or 'drop'",
+            box.cfg, {log_async_overflow = 'foo'})
+        box.cfg({log_async_overflow = 'drop'})
+        t.assert_equals(log.cfg.async_overflow, 'drop')
+        log.info('log_async_test drop policy')
+        box.cfg({log_async_overflow = 'block'})
+    end)
+    t.helpers.retrying({}, function()
+        t.assert(cg.server:grep_log('log_async_test drop policy'))
+    end)
+end
+
+-- Messages logged just before exit must not be lost.
+g.test_exit = function(cg)
+    cg.server:exec(function()
+        require('log').info('log_async_test last message')
+    end)
+    cg.server:restart()
+    t.assert(cg.server:grep_log('log_async_test last message', nil,
+                                {reset = false}))
+end
@@ -0,0 +1,183 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_iterators = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {
+            type = 'art', parts = {{2, 'integer'}, {3, 'string'}},
+        })
+        t.assert_equals(sk.type, 'ART')
+        t.assert_equals(sk.unique, true)
+        -- Tuple ids follow the expected index order.
+        local values = {
+            [1] = {-2^63, ''},
+            [2] = {-100, 'a'},
+            [3] = {-1, 'b'},
+            [4] = {0, ''},
+            [5] = {0, 'a'},
+            [6] = {0, 'a\0'},
+            [7] = {0, 'a\1'},
+            [8] = {0, 'ab'},
+            [9] = {1, 'z'},
+            [10] = {2^53, 'x'},
+            [11] = {18446744073709551615ULL, 'y'},
+        }
+        for _, id in ipairs({6, 5, 4, 8, 7, 1, 3, 2, 11, 9, 10}) do
+            s:insert({id, values[id][1], values[id][2]})
+        end
+        local function ids(...)
+            local res = {}
+            for _, tuple in sk:pairs(...) do
+                table.insert(res, tuple[1])
+            end
+            return res
+        end
+        t.assert_equals(ids(), {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11})
+        t.assert_equals(ids({}, {iterator = 'LE'}),
+                        {11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1})
+        t.assert_equals(sk:get({0, 'a\0'})[1], 6)
+        t.assert_equals(sk:get({0, 'a\2'}), nil)
+        t.assert_equals(ids({0}), {4, 5, 6, 7, 8})
+        t.assert_equals(ids({0}, {iterator = 'REQ'}), {8, 7, 6, 5, 4})
+        t.assert_equals(ids({0, 'a'}, {iterator = 'EQ'}), {5})
+        t.assert_equals(ids({0, 'a'}, {iterator = 'GT'}),
+                        {6, 7, 8, 9, 10, 11})
+        t.assert_equals(ids({0, 'a'}, {iterator = 'GE'}),
+                        {5, 6, 7, 8, 9, 10, 11})
+        t.assert_equals(ids({0}, {iterator = 'GT'}), {9, 10, 11})
+        t.assert_equals(ids({-1}, {iterator = 'LT'}), {2, 1})
+        t.assert_equals(ids({-1}, {iterator = 'LE'}), {3, 2, 1})
+        t.assert_equals(ids({0, 'a\0'}, {iterator = 'LT'}), {5, 4, 3, 2, 1})
+        t.assert_equals(sk:min({0})[1], 4)
+        t.assert_equals(sk:max({0})[1], 8)
+        t.assert_equals(sk:count(), 11)
+        t.assert_equals(sk:count({0}), 5)
+        t.assert_error_msg_equals(
+            "Index 'sk' (ART) of space 'test' (memtx) does not " ..
+            "support requested iterator type",
+            sk.select, sk, {0}, {iterator = 'BITS_ALL_SET'})
+    end)
+end
+
+g.test_dml = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art', parts = {{1, 'string'}}})
+        local sk = s:create_index('sk', {type = 'art',
+                                         parts = {{2, 'unsigned'}}})
+        for i = 1, 1000 do
+            s:insert({'key' .. i, i})
+        end
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {'key1', 2000})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {'new', 1})
+        t.assert_equals(s:get('new'), nil)
+        s:replace({'key1', 2000})
+        t.assert_equals(sk:get(1), nil)
+        t.assert_equals(sk:get(2000), {'key1', 2000})
+        for i = 1, 1000, 2 do
+            s:delete('key' .. i)
+        end
+        t.assert_equals(s:count(), 500)
+        t.assert_equals(sk:select({}, {limit = 3}),
+                        {{'key2', 2}, {'key4', 4}, {'key6', 6}})
+        t.assert_equals(s:select({'key99'}, {iterator = 'LT', limit = 2}),
+                        {{'key98', 98}, {'key96', 96}})
+        -- Modifications during iteration.
+        local count = 0
+        for _, tuple in sk:pairs() do
+            s:delete(tuple[1])
+            s:insert({tuple[1] .. 'x', tuple[2] + 10000})
+            count = count + 1
+            if count == 500 then
+                break
+            end
+        end
+        t.assert_equals(count, 500)
+        t.assert_equals(sk:select({10000}, {iterator = 'LE'}), {})
+        t.assert_equals(s:get('key2x'), {'key2x', 10002})
+        t.assert(sk:bsize() > 0)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'art', parts = {{1, 'integer'}}})
+        s:create_index('sk', {type = 'art', parts = {{2, 'string'}}})
+        for i = -50, 50 do
+            s:insert({i, tostring(i)})
+        end
+        box.snapshot()
+        s:insert({100, 'x'})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:count(), 102)
+        t.assert_equals(s:select({}, {limit = 2}), {{-50, '-50'}, {-49, '-49'}})
+        t.assert_equals(s.index.sk:get('x'), {100, 'x'})
+        t.assert_equals(s.index.sk:select({'1'}, {limit = 3}),
+                        {{1, '1'}, {10, '10'}, {11, '11'}})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'a', 'unsigned'}, {'b', 'string'}, {'c', 'number'},
+            {'d', 'array'},
+        }})
+        s:create_index('pk')
+        local function check(msg, opts)
+            opts.type = 'art'
+            t.assert_error_msg_equals(
+                "Can't create or modify index 'sk' in space 'test': " .. msg,
+                s.create_index, s, 'sk', opts)
+        end
+        check('ART index must be unique', {unique = false})
+        check('ART index field type must be UNSIGNED, INTEGER or STRING',
+              {parts = {'c'}})
+        check('ART index can not use collations',
+              {parts = {{'b', collation = 'unicode_ci'}}})
+        check('ART index can not use descending sort order',
+              {parts = {{'a', sort_order = 'desc'}}})
+        check('ART index cannot be multikey',
+              {parts = {{'d[*]', 'unsigned'}}})
+        t.assert_error_msg_equals(
+            'ART does not support nullable parts',
+            s.create_index, s, 'sk',
+            {type = 'art', parts = {{'b', is_nullable = true}}})
+    end)
+end
+
+g.test_vinyl = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_contains(
+            'Unsupported index type supplied for index',
+            s.create_index, s, 'pk', {type = 'art'})
+    end)
+end
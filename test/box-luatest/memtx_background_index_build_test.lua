@@ -0,0 +1,95 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server = server:new({
+        box_cfg = {memtx_background_index_build = true},
+        env = {['ERRINJ_MEMTX_INDEX_BUILD_DELAY'] = 'true'},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}}})
+        s:create_index('num', {parts = {{3, 'unsigned'}}, unique = false})
+        for i = 1, 1000 do
+            s:insert({i, 'v' .. i, i % 10})
+        end
+        box.snapshot()
+        s:insert({1001, 'v1001', 1})
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        s2:insert({1})
+        local s3 = box.schema.space.create('test3')
+        s3:create_index('pk')
+        s3:create_index('sk', {parts = {{2, 'unsigned'}}})
+    end)
+    cg.server:restart()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.test_background_index_build = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        -- The build is delayed by the error injection.
+        t.assert_equals(box.info.recovery, {
+            status = 'building_indexes',
+            spaces = {test = 'building'},
+        })
+
+        -- The primary index can be read.
+        t.assert_equals(s:get(1), {1, 'v1', 1})
+        t.assert_equals(s:count(), 1001)
+        t.assert_equals(s.index.pk:select({1001}), {{1001, 'v1001', 1}})
+
+        -- Secondary indexes can't be read.
+        local msg = "Instance bootstrap hasn't finished yet - " ..
+                    "index 'sk' of space 'test' is not built yet"
+        t.assert_error_covers({code = box.error.LOADING, message = msg,
+                               space = 'test', index = 'sk'},
+                              s.index.sk.get, s.index.sk, {'v1'})
+        t.assert_error_msg_equals(msg, s.index.sk.select, s.index.sk)
+        t.assert_error_msg_equals(msg, s.index.sk.count, s.index.sk)
+        t.assert_error_msg_equals(msg, box.execute,
+                                  [[SELECT * FROM "test"
+                                    INDEXED BY "sk" WHERE "sk" = 'v1']])
+
+        -- The space can't be modified or altered.
+        msg = "Instance bootstrap hasn't finished yet - " ..
+              "indexes of space 'test' are not built yet"
+        t.assert_error_msg_equals(msg, s.insert, s, {2000, 'v2000', 0})
+        t.assert_error_msg_equals(msg, s.delete, s, {1})
+        t.assert_error_msg_equals(msg, s.create_index, s, 'new',
+                                  {parts = {{3, 'unsigned'}}})
+        t.assert_error_msg_equals(msg, s.truncate, s)
+
+        -- Other spaces are available.
+        box.space.test2:insert({2})
+        t.assert_equals(box.space.test2:select(), {{1}, {2}})
+        box.space.test3:insert({1, 10})
+        t.assert_equals(box.space.test3.index.sk:get({10}), {1, 10})
+
+        box.error.injection.set('ERRINJ_MEMTX_INDEX_BUILD_DELAY', false)
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.info.recovery,
+                            {status = 'done', spaces = {}})
+        end)
+
+        t.assert_equals(s.index.sk:get({'v1001'}), {1001, 'v1001', 1})
+        t.assert_equals(s.index.num:count({1}), 101)
+        s:insert({2000, 'v2000', 0})
+        t.assert_equals(s.index.sk:get({'v2000'}), {2000, 'v2000', 0})
+        t.assert_error_covers({code = box.error.TUPLE_FOUND},
+                              s.insert, s, {2001, 'v2000', 0})
+        s:create_index('new', {parts = {{3, 'unsigned'}, {1, 'unsigned'}}})
+        t.assert_equals(s.index.new:count({0}), 101)
+    end)
+end
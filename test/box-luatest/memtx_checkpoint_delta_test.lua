@@ -0,0 +1,145 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, {{index_type = 'tree'}, {index_type = 'hash'}})
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            memtx_checkpoint_delta_count = 2,
+            checkpoint_count = 1,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Checks the number of full and delta snapshot files. Old files are
+-- removed in background so wait for the garbage collection.
+local function check_files(cg, snap_count, delta_count)
+    t.helpers.retrying({}, function()
+        local counts = cg.server:exec(function()
+            local fio = require('fio')
+            local dir = box.cfg.memtx_dir
+            return {
+                #fio.glob(fio.pathjoin(dir, '*.snap')),
+                #fio.glob(fio.pathjoin(dir, '*.dsnap')),
+            }
+        end)
+        t.assert_equals(counts, {snap_count, delta_count})
+    end)
+end
+
+g.before_each(function(cg)
+    cg.server:exec(function(index_type)
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = index_type, sequence = true})
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        for i = 1, 100 do
+            s:insert({box.NULL, i})
+        end
+        box.snapshot()
+    end, {cg.params.index_type})
+    -- Schema changes are never written to a delta snapshot.
+    check_files(cg, 1, 0)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+        box.snapshot()
+    end)
+end)
+
+g.test_delta = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        for i = 1, 10 do
+            s:delete({i})
+        end
+        s:update({11}, {{'=', 2, 1000}})
+        s:insert({box.NULL, 101})
+        box.snapshot()
+    end)
+    check_files(cg, 1, 1)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:replace({12, 2000})
+        s:delete({13})
+        s:insert({box.NULL, 102})
+        box.snapshot()
+        -- Nothing changed, the last delta snapshot is reused.
+        box.snapshot()
+    end)
+    check_files(cg, 1, 2)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:count(), 91)
+        t.assert_equals(s:get({1}), nil)
+        t.assert_equals(s:get({11}), {11, 1000})
+        t.assert_equals(s:get({12}), {12, 2000})
+        t.assert_equals(s:get({13}), nil)
+        t.assert_equals(s:get({102}), {102, 102})
+        t.assert_equals(s.index.sk:select({2000}), {{12, 2000}})
+        -- Sequence values are written to delta snapshots.
+        t.assert_equals(s:insert({box.NULL, 103}), {103, 103})
+        -- The delta chain is too long, a full snapshot is written.
+        box.snapshot()
+    end)
+    -- The old checkpoint files are collected.
+    check_files(cg, 1, 0)
+end
+
+g.test_rollback = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin()
+        s:replace({1, 1000})
+        s:delete({2})
+        box.rollback()
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:get({1}), {1, 1})
+        t.assert_equals(box.space.test:get({2}), {2, 2})
+    end)
+end
+
+g.test_disable = function(cg)
+    cg.server:exec(function()
+        box.space.test:delete({1})
+        box.cfg({memtx_checkpoint_delta_count = 0})
+        box.snapshot()
+    end)
+    check_files(cg, 1, 0)
+    cg.server:exec(function()
+        box.space.test:delete({2})
+        -- The first checkpoint after the option is enabled is full.
+        box.cfg({memtx_checkpoint_delta_count = 2})
+        box.snapshot()
+    end)
+    check_files(cg, 1, 0)
+    cg.server:exec(function()
+        box.space.test:delete({3})
+        box.snapshot()
+    end)
+    check_files(cg, 1, 1)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:count(), 97)
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'memtx_checkpoint_delta_count': " ..
+            "the value must not be less than zero",
+            box.cfg, {memtx_checkpoint_delta_count = -1})
+    end)
+end
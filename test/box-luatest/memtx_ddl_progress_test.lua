@@ -0,0 +1,107 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 1000 do
+            s:insert({i, i})
+        end
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{memtx_ddl_rate_limit = 0}
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_ddl_rate_limit, 0)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'memtx_ddl_rate_limit': " ..
+            "the value must not be negative",
+            box.cfg, {memtx_ddl_rate_limit = -1})
+        box.cfg{memtx_ddl_rate_limit = 100}
+        t.assert_equals(box.cfg.memtx_ddl_rate_limit, 100)
+    end)
+end
+
+g.test_progress = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        t.assert_equals(box.stat.memtx().ddl, {})
+
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', true)
+        local f = fiber.new(s.create_index, s, 'sk',
+                            {parts = {{2, 'unsigned'}}})
+        f:set_joinable(true)
+        t.helpers.retrying({}, function()
+            t.assert_not_equals(box.stat.memtx().ddl, {})
+        end)
+        local stat = box.stat.memtx().ddl.test
+        t.assert_equals(stat.op, 'build_index')
+        t.assert_equals(stat.index, 'sk')
+        t.assert_equals(stat.total, 1000)
+        t.assert_ge(stat.processed, 1)
+        t.assert_ge(stat.time, 0)
+        box.error.injection.set('ERRINJ_BUILD_INDEX_DELAY', false)
+        t.assert_equals({f:join()}, {true, s.index.sk})
+        t.assert_equals(box.stat.memtx().ddl, {})
+
+        box.error.injection.set('ERRINJ_CHECK_FORMAT_DELAY', true)
+        f = fiber.new(s.format, s, {{'a', 'unsigned'}, {'b', 'unsigned'}})
+        f:set_joinable(true)
+        t.helpers.retrying({}, function()
+            t.assert_not_equals(box.stat.memtx().ddl, {})
+        end)
+        stat = box.stat.memtx().ddl.test
+        t.assert_equals(stat.op, 'check_format')
+        t.assert_equals(stat.index, nil)
+        t.assert_equals(stat.total, 1000)
+        box.error.injection.set('ERRINJ_CHECK_FORMAT_DELAY', false)
+        t.assert_equals({f:join()}, {true})
+        t.assert_equals(box.stat.memtx().ddl, {})
+    end)
+end
+
+g.test_rate_limit = function(cg)
+    cg.server:exec(function()
+        local clock = require('clock')
+        local fiber = require('fiber')
+        local s = box.space.test
+        box.cfg{memtx_ddl_rate_limit = 1000}
+        local start = clock.monotonic()
+        -- Other fibers run while the index is built.
+        local count = 0
+        local f = fiber.new(function()
+            while true do
+                count = count + 1
+                fiber.sleep(0.01)
+            end
+        end)
+        s:create_index('sk', {parts = {{2, 'unsigned'}}})
+        f:cancel()
+        t.assert_ge(clock.monotonic() - start, 0.9)
+        t.assert_ge(count, 10)
+        t.assert_equals(s.index.sk:count(), 1000)
+    end)
+end
@@ -0,0 +1,134 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {memtx_allocator = 'small'}})
+    cg.server:start()
+    cg.server:exec(function()
+        -- Helper function that frees tuples referenced from Lua.
+        rawset(_G, 'gc', function()
+            box.tuple.new() -- drop blessed tuple ref
+            collectgarbage('collect') -- drop Lua refs
+        end)
+        -- Returns the number of slabs used for tuples.
+        rawset(_G, 'slab_count', function()
+            local count = 0
+            for _, stat in pairs(box.slab.stats()) do
+                if stat.item_size < 16384 then
+                    count = count + stat.slab_count
+                end
+            end
+            return count
+        end)
+        -- Runs a defragmentation pass and waits for it to complete.
+        rawset(_G, 'defragment', function()
+            local passes = box.stat.memtx().defrag.passes
+            box.slab.defragment()
+            t.helpers.retrying({}, function()
+                t.assert_equals(box.stat.memtx().defrag.passes, passes + 1)
+            end)
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        local payload = string.rep('x', 200)
+        box.begin()
+        for i = 1, 40000 do
+            s:insert({i, i % 100, payload})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_defragment = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local payload = string.rep('x', 200)
+
+        -- Delete three tuples out of four.
+        box.begin()
+        for i = 1, 40000 do
+            if i % 4 ~= 0 then
+                s:delete(i)
+            end
+        end
+        box.commit()
+
+        -- A tuple referenced from Lua must not be moved.
+        local held = s:get(4)
+        _G.gc()
+        local slabs_before = _G.slab_count()
+        local relocated = box.stat.memtx().defrag.relocated
+        _G.defragment()
+        t.assert_gt(box.stat.memtx().defrag.relocated, relocated)
+        t.assert_lt(_G.slab_count(), slabs_before / 2)
+
+        -- Data is intact.
+        t.assert_equals(held, {4, 4, payload})
+        t.assert_equals(s:count(), 10000)
+        t.assert_equals(s.index.sk:count(), 10000)
+        for i = 4, 40000, 4 do
+            t.assert_equals(s:get(i), {i, i % 100, payload})
+        end
+        t.assert_equals(s.index.sk:count({8}), 100)
+        for _, tuple in s.index.sk:pairs({8}) do
+            t.assert_equals(s:get(tuple[1]), tuple)
+        end
+
+        -- Nothing to move when memory isn't fragmented.
+        relocated = box.stat.memtx().defrag.relocated
+        _G.defragment()
+        t.assert_equals(box.stat.memtx().defrag.relocated, relocated)
+    end)
+end
+
+g.test_defragment_during_checkpoint = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+
+        box.begin()
+        for i = 1, 40000, 2 do
+            s:delete(i)
+        end
+        box.commit()
+        _G.gc()
+
+        -- Defragmentation is postponed while a checkpoint is in progress.
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', true)
+        local f = fiber.new(box.snapshot)
+        f:set_joinable(true)
+        fiber.yield()
+        local relocated = box.stat.memtx().defrag.relocated
+        box.slab.defragment()
+        fiber.sleep(0.1)
+        t.assert_equals(box.stat.memtx().defrag.relocated, relocated)
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', false)
+        t.assert_equals({f:join()}, {true, 'ok'})
+        t.helpers.retrying({}, function()
+            t.assert_gt(box.stat.memtx().defrag.relocated, relocated)
+        end)
+        t.assert_equals(s:count(), 20000)
+        t.assert_equals(s.index.sk:count(), 20000)
+    end)
+end
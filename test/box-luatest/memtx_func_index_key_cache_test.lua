@@ -0,0 +1,154 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.func.keys ~= nil then
+            box.func.keys:drop()
+        end
+    end)
+end)
+
+local function create_space(is_multikey)
+    local s = box.schema.space.create('test')
+    s:create_index('pk')
+    local body
+    if is_multikey then
+        -- Return a key twice to check that duplicates are handled.
+        body = [[function(tuple)
+            local keys = {}
+            for _, v in ipairs(tuple[2]) do
+                table.insert(keys, {v})
+            end
+            if #keys > 0 then
+                table.insert(keys, keys[1])
+            end
+            return keys
+        end]]
+    else
+        body = 'function(tuple) return {tuple[2]} end'
+    end
+    box.schema.func.create('keys', {
+        body = body, is_deterministic = true, is_sandboxed = true,
+        opts = {is_multikey = is_multikey},
+    })
+    s:create_index('sk', {
+        func = 'keys', unique = false,
+        parts = {{1, is_multikey and 'unsigned' or 'string',
+                  is_nullable = not is_multikey,
+                  exclude_null = not is_multikey}},
+    })
+    return s
+end
+
+g.test_func_index = function(cg)
+    cg.server:exec(create_space, {false})
+    cg.server:exec(function()
+        local function calls()
+            return box.stat.func().keys.calls
+        end
+        local s = box.space.test
+        box.stat.reset()
+        for i = 1, 100 do
+            s:insert({i, 'k' .. i})
+        end
+        s:insert({101, box.NULL})
+        t.assert_equals(calls(), 101)
+        -- Only the new tuple keys are computed on replace.
+        for i = 1, 100 do
+            s:replace({i, 'x' .. i})
+        end
+        t.assert_equals(calls(), 201)
+        t.assert_equals(s.index.sk:get('x7'), {7, 'x7'})
+        t.assert_equals(s.index.sk:get('k7'), nil)
+        s:update(5, {{'=', 2, 'y'}})
+        t.assert_equals(calls(), 202)
+        t.assert_equals(s.index.sk:select('y'), {{5, 'y'}})
+        -- No calls on delete.
+        for i = 1, 99, 2 do
+            s:delete(i)
+        end
+        t.assert_equals(calls(), 202)
+        -- Tuples without keys in the index are not cached.
+        s:delete(101)
+        t.assert_equals(calls(), 203)
+        t.assert_equals(s.index.sk:len(), 50)
+        t.assert_equals(s.index.sk:select({}, {limit = 2}),
+                        {{10, 'x10'}, {100, 'x100'}})
+        -- Transaction rollback.
+        box.begin()
+        s:replace({2, 'z'})
+        s:delete(4)
+        box.rollback()
+        t.assert_equals(s.index.sk:get('x2'), {2, 'x2'})
+        t.assert_equals(s.index.sk:get('x4'), {4, 'x4'})
+        t.assert_equals(s.index.sk:get('z'), nil)
+        t.assert_equals(s.index.sk:len(), 50)
+    end)
+end
+
+g.test_multikey = function(cg)
+    cg.server:exec(create_space, {true})
+    cg.server:exec(function()
+        local function calls()
+            return box.stat.func().keys.calls
+        end
+        local s = box.space.test
+        box.stat.reset()
+        for i = 1, 10 do
+            s:insert({i, {i * 10, i * 10 + 1, i * 10 + 2}})
+        end
+        s:insert({11, {}})
+        t.assert_equals(calls(), 11)
+        t.assert_equals(s.index.sk:len(), 30)
+        s:replace({1, {1000}})
+        t.assert_equals(calls(), 12)
+        t.assert_equals(s.index.sk:select(10), {})
+        t.assert_equals(s.index.sk:select(1000), {{1, {1000}}})
+        s:delete(2)
+        t.assert_equals(calls(), 12)
+        -- The tuple has no keys, so they are computed again.
+        s:delete(11)
+        t.assert_equals(calls(), 13)
+        t.assert_equals(s.index.sk:len(), 25)
+        t.assert_equals(s.index.sk:select(20), {})
+        t.assert_equals(s.index.sk:select(31), {{3, {30, 31, 32}}})
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(create_space, {false})
+    cg.server:exec(function()
+        local s = box.space.test
+        for i = 1, 100 do
+            s:insert({i, 'k' .. i})
+        end
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        box.stat.reset()
+        for i = 1, 50 do
+            s:delete(i)
+        end
+        t.assert_equals(box.stat.func().keys, nil)
+        t.assert_equals(s.index.sk:len(), 50)
+        t.assert_equals(s.index.sk:get('k1'), nil)
+        t.assert_equals(s.index.sk:get('k51'), {51, 'k51'})
+    end)
+end
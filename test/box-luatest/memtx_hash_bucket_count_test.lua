@@ -0,0 +1,103 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_bucket_count = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', bucket_count = 100000})
+        s:create_index('sk', {type = 'hash', parts = {{2, 'string'}}})
+        t.assert_equals(s.index.pk.bucket_count, 100000)
+        t.assert_equals(s.index.sk.bucket_count, nil)
+        -- The table is allocated on creation and doesn't grow.
+        local bsize = s.index.pk:bsize()
+        t.assert_ge(bsize, 100000 * 16)
+        for i = 1, 50000 do
+            s:insert({i, tostring(i)})
+        end
+        t.assert_equals(s.index.pk:bsize(), bsize)
+        -- The hint doesn't limit the number of tuples.
+        for i = 50001, 150000 do
+            s:insert({i, tostring(i)})
+        end
+        t.assert_equals(s.index.pk:len(), 150000)
+        t.assert_equals(s:get(120000), {120000, '120000'})
+        t.assert_equals(s.index.sk:get('777'), {777, '777'})
+        s.index.pk:alter({bucket_count = 10})
+        t.assert_equals(s.index.pk.bucket_count, 10)
+        t.assert_equals(s.index.pk:len(), 150000)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', bucket_count = 1000})
+        s:create_index('sk', {type = 'hash', parts = {{2, 'string'}}})
+        s:create_index('tk', {type = 'hash', hash_func = 'xxh3',
+                              parts = {{3, 'unsigned'}, {2, 'string'}}})
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, 'k' .. i, i % 10})
+        end
+        box.commit()
+        box.snapshot()
+        s:delete(1)
+        s:insert({10001, 'k10001', 1})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.index.pk.bucket_count, 1000)
+        for _, idx in ipairs({s.index.pk, s.index.sk, s.index.tk}) do
+            t.assert_equals(idx:len(), 10000)
+            t.assert_equals(#idx:select(), 10000)
+        end
+        for i = 2, 10001 do
+            local tuple = {i, 'k' .. i, i % 10}
+            t.assert_equals(s:get(i), tuple)
+            t.assert_equals(s.index.sk:get('k' .. i), tuple)
+            t.assert_equals(s.index.tk:get({i % 10, 'k' .. i}), tuple)
+        end
+        t.assert_equals(s:get(1), nil)
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {2, 'x', 0})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {0, 'k2', 0})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_contains(
+            "'bucket_count' must be unsigned",
+            s.create_index, s, 'pk', {type = 'hash', bucket_count = -1})
+        t.assert_error_msg_contains(
+            "bucket_count is only reasonable with memtx hash index",
+            s.create_index, s, 'pk', {type = 'tree', bucket_count = 10})
+        s:drop()
+        s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_contains(
+            "bucket_count is only reasonable with memtx hash index",
+            s.create_index, s, 'pk', {bucket_count = 10})
+    end)
+end
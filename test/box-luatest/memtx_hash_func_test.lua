@@ -0,0 +1,97 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_hash_func = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', hash_func = 'xxh3',
+                              parts = {{1, 'string'}}})
+        s:create_index('i2', {type = 'hash', hash_func = 'xxh3',
+                              parts = {{2, 'unsigned'}, {3, 'string'}}})
+        s:create_index('i3', {type = 'hash', hash_func = 'xxh3',
+                              parts = {{3, 'string',
+                                        collation = 'unicode_ci'}}})
+        s:create_index('i4', {type = 'hash', hash_func = 'xxh3',
+                              parts = {{4, 'double'}}})
+        s:create_index('i5', {type = 'hash', hash_func = 'xxh3',
+                              parts = {{5, 'unsigned'}}})
+        t.assert_equals(s.index.pk.hash_func, 'xxh3')
+        for i = 1, 1000 do
+            s:insert({'k' .. i, i, 'v' .. i, i + 0.5, i})
+        end
+        for i = 1, 1000 do
+            local tuple = {'k' .. i, i, 'v' .. i, i + 0.5, i}
+            t.assert_equals(s.index.pk:get('k' .. i), tuple)
+            t.assert_equals(s.index.i2:get({i, 'v' .. i}), tuple)
+            t.assert_equals(s.index.i3:get('V' .. i), tuple)
+            t.assert_equals(s.index.i4:get(i + 0.5), tuple)
+            t.assert_equals(s.index.i5:get(i), tuple)
+        end
+        t.assert_equals(s.index.i3:select('V1', {iterator = 'eq'}),
+                        {{'k1', 1, 'v1', 1.5, 1}})
+        s:delete('k1')
+        t.assert_equals(s.index.i2:get({1, 'v1'}), nil)
+        t.assert_equals(s.index.pk:len(), 999)
+        t.assert_equals(#s.index.pk:select(), 999)
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', parts = {{1, 'string'}}})
+        t.assert_equals(s.index.pk.hash_func, nil)
+        for i = 1, 100 do
+            s:insert({'k' .. i})
+        end
+        s.index.pk:alter({hash_func = 'xxh3'})
+        t.assert_equals(s.index.pk.hash_func, 'xxh3')
+        for i = 1, 100 do
+            t.assert_equals(s:get('k' .. i), {'k' .. i})
+        end
+        s.index.pk:alter({hash_func = 'murmur'})
+        t.assert_equals(s.index.pk.hash_func, nil)
+        for i = 1, 100 do
+            t.assert_equals(s:get('k' .. i), {'k' .. i})
+        end
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_content_equals(
+            "Wrong index options: hash_func must be either 'murmur' " ..
+            "or 'xxh3'",
+            s.create_index, s, 'pk', {type = 'hash', hash_func = 'foo'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "hash_func is only reasonable with memtx hash index",
+            s.create_index, s, 'pk', {type = 'tree', hash_func = 'xxh3'})
+        s:drop()
+        s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "hash_func is only reasonable with memtx hash index",
+            s.create_index, s, 'pk', {hash_func = 'xxh3'})
+    end)
+end
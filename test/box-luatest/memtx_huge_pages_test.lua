@@ -0,0 +1,45 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.skip_if(jit.os ~= 'Linux', 'Linux only')
+    cg.server = server:new({box_cfg = {memtx_use_huge_pages = true}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'memtx_use_huge_pages': " ..
+            "should be of type boolean",
+            box.cfg, {memtx_use_huge_pages = 1})
+    end)
+end
+
+g.test_huge_pages = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_use_huge_pages, true)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 10000 do
+            s:replace({i, string.rep('x', 100)})
+        end
+        local info = box.slab.info()
+        t.assert_type(info.huge_pages_size, 'number')
+        t.assert_le(info.huge_pages_size, info.quota_size)
+
+        box.cfg({memtx_use_huge_pages = false})
+        t.assert_equals(box.slab.info().huge_pages_size, nil)
+        box.cfg({memtx_use_huge_pages = true})
+        t.assert_type(box.slab.info().huge_pages_size, 'number')
+        s:drop()
+    end)
+end
@@ -0,0 +1,94 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_CHECK_FORMAT_DELAY', false)
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Appending nullable fields beyond the stored tuples doesn't scan the space.
+g.test_instant = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'a', 'unsigned'}, {'b', 'string'}},
+        })
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, tostring(i)})
+        end
+        -- The data check would hang with this injection.
+        box.error.injection.set('ERRINJ_CHECK_FORMAT_DELAY', true)
+        s:format({{'a', 'unsigned'}, {'b', 'string'},
+                  {'c', 'unsigned', is_nullable = true},
+                  {'d', 'map', is_nullable = true}})
+        t.assert_equals(#s:format(), 4)
+        t.assert_equals(s:get(1), {1, '1'})
+        t.assert_error_msg_contains(
+            "Tuple field 3 (c) type does not match one required by " ..
+            "operation: expected unsigned, got string",
+            s.insert, s, {101, '101', 'x'})
+        s:insert({101, '101', 101})
+        box.error.injection.set('ERRINJ_CHECK_FORMAT_DELAY', false)
+    end)
+end
+
+-- Tuples having the appended fields are still checked.
+g.test_check = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        s:insert({2, 'x'})
+        t.assert_error_msg_contains(
+            "Tuple field 2 (b) type does not match one required by " ..
+            "operation: expected unsigned, got string",
+            s.format, s, {{'a', 'unsigned'},
+                          {'b', 'unsigned', is_nullable = true}})
+        -- The bound on the field count never decreases, so the data is
+        -- checked even after the tuple is fixed.
+        s:replace({2, 2})
+        s:format({{'a', 'unsigned'}, {'b', 'unsigned', is_nullable = true}})
+        t.assert_equals(s:select(), {{1}, {2, 2}})
+    end)
+end
+
+-- The field count bound is restored on recovery.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1, 'x'})
+        box.snapshot()
+        s:insert({2, 2, 'y'})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_contains(
+            "Tuple field 3 (c) type does not match one required by " ..
+            "operation: expected unsigned, got string",
+            s.format, s, {{'a', 'unsigned'}, {'b', 'any'},
+                          {'c', 'unsigned', is_nullable = true}})
+        t.assert_error_msg_contains(
+            "Tuple field 2 (b) type does not match one required by " ..
+            "operation: expected unsigned, got string",
+            s.format, s, {{'a', 'unsigned'},
+                          {'b', 'unsigned', is_nullable = true}})
+    end)
+end
@@ -0,0 +1,105 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.space.plain ~= nil then
+            box.space.plain:drop()
+        end
+    end)
+end)
+
+g.test_interned_field = function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server:exec(function()
+        local format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'status', type = 'string', interned = true},
+            {name = 'tenant', type = 'string', interned = true,
+             is_nullable = true},
+        }
+        local s = box.schema.space.create('test', {format = format})
+        s:create_index('pk')
+        local p = box.schema.space.create('plain')
+        p:create_index('pk')
+
+        local statuses = {'active customer', 'suspended customer',
+                          'deleted customer'}
+        for i = 1, 300 do
+            local status = statuses[i % 3 + 1]
+            local tenant = i % 2 == 0 and 'tenant with a long name' or nil
+            s:insert({i, status, tenant})
+            p:insert({i, status, tenant})
+        end
+        t.assert_lt(s:bsize(), p:bsize())
+
+        t.assert_equals(s:get(1), {1, 'deleted customer'})
+        t.assert_equals(s:get(2).tenant, 'tenant with a long name')
+        t.assert_equals(s:select(), p:select())
+        t.assert_equals(s:update(1, {{'=', 'status', 'new status'}}),
+                        {1, 'new status'})
+        t.assert_equals(s:update(1, {{'=', 'tenant', 'x'}}),
+                        {1, 'new status', 'x'})
+        t.assert_equals(s:replace({2, 'abc', 'tenant with a long name'}),
+                        {2, 'abc', 'tenant with a long name'})
+        t.assert_equals(s:delete(3), {3, 'active customer'})
+        t.assert_equals(s:get(1), {1, 'new status', 'x'})
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:len(), 299)
+        t.assert_equals(s:get(1), {1, 'new status', 'x'})
+        t.assert_equals(s:get(2), {2, 'abc', 'tenant with a long name'})
+        t.assert_equals(s:get(4), {4, 'suspended customer',
+                                   'tenant with a long name'})
+    end)
+end
+
+g.test_interned_field_errors = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_content_equals(
+            "Wrong space format field 2: interning is reasonable only " ..
+            "for 'string' fields",
+            box.schema.space.create, 'test', {format = {
+                {name = 'id', type = 'unsigned'},
+                {name = 'data', type = 'any', interned = true},
+            }})
+        t.assert_error_msg_content_equals(
+            "Wrong space format field 2: interned field can't be compressed",
+            box.schema.space.create, 'test', {format = {
+                {name = 'id', type = 'unsigned'},
+                {name = 'data', type = 'string', interned = true,
+                 compression = 'zstd'},
+            }})
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support interned fields",
+            box.schema.space.create, 'test', {engine = 'vinyl', format = {
+                {name = 'id', type = 'unsigned'},
+                {name = 'data', type = 'string', interned = true},
+            }})
+        local s = box.schema.space.create('test', {format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'data', type = 'string', interned = true},
+        }})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Indexed field does not support interning",
+            s.create_index, s, 'sk', {parts = {'data'}})
+    end)
+end
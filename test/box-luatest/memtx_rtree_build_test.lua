@@ -0,0 +1,71 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that an RTREE index built in bulk on recovery returns the same
+-- results as one filled by insertions.
+g.test_build = function(cg)
+    local function check()
+        local s = box.space.test
+        t.assert_equals(s.index.bulk:count(), 1000)
+        for _, rect in ipairs({{0, 0, 10, 10}, {25, 5, 27, 30}}) do
+            local expected = {}
+            for _, tuple in s.index.seq:pairs(rect, {iterator = 'LE'}) do
+                table.insert(expected, tuple[1])
+            end
+            local found = {}
+            for _, tuple in s.index.bulk:pairs(rect, {iterator = 'LE'}) do
+                table.insert(found, tuple[1])
+            end
+            table.sort(expected)
+            table.sort(found)
+            t.assert_equals(found, expected)
+            t.assert_not_equals(found, {})
+        end
+        local nearest = s.index.bulk:select({15.2, 15.1},
+                                            {iterator = 'NEIGHBOR',
+                                             limit = 3})
+        t.assert_equals(nearest[1][2], {15, 15})
+        t.assert_equals(#nearest, 3)
+    end
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('seq', {type = 'rtree', unique = false,
+                               parts = {2, 'array'}})
+        for i = 1, 1000 do
+            s:insert({i, {i % 40, math.floor(i / 40)}})
+        end
+        s:create_index('bulk', {type = 'rtree', unique = false,
+                                parts = {2, 'array'}})
+        box.snapshot()
+    end)
+    cg.server:exec(check)
+    cg.server:restart()
+    cg.server:exec(check)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:delete({1})
+        s:insert({1001, {15, 15}})
+        t.assert_equals(s.index.bulk:count(), 1000)
+        t.assert_equals(#s.index.bulk:select({15, 15}), 2)
+    end)
+end
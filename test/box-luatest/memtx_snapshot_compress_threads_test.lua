@@ -0,0 +1,89 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_snapshot_compress_threads = 4},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        box.cfg{memtx_snapshot_compress_threads = 4}
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_snapshot_compress_threads, 4)
+        local msg = "Incorrect value for option " ..
+                    "'memtx_snapshot_compress_threads': must be greater " ..
+                    "than 0 and less than or equal to 64"
+        t.assert_error_msg_equals(msg, box.cfg,
+                                  {memtx_snapshot_compress_threads = 0})
+        t.assert_error_msg_equals(msg, box.cfg,
+                                  {memtx_snapshot_compress_threads = 65})
+        box.cfg{memtx_snapshot_compress_threads = 1}
+        t.assert_equals(box.cfg.memtx_snapshot_compress_threads, 1)
+    end)
+end
+
+g.test_snapshot = function(cg)
+    local count = 20000
+    cg.server:exec(function(count)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, count do
+            s:insert({i, string.rep(tostring(i), 20)})
+        end
+        box.snapshot()
+        -- Rows are written in order and numbered sequentially.
+        local fio = require('fio')
+        local xlog = require('xlog')
+        local files = fio.glob(fio.pathjoin(box.cfg.memtx_dir, '*.snap'))
+        table.sort(files)
+        local lsn = 0
+        local found = 0
+        for _, row in xlog.pairs(files[#files]) do
+            lsn = lsn + 1
+            t.assert_equals(row.HEADER.lsn, lsn)
+            if row.BODY.space_id == s.id then
+                found = found + 1
+                t.assert_equals(row.BODY.tuple[1], found)
+            end
+        end
+        t.assert_equals(found, count)
+    end, {count})
+    cg.server:restart()
+    cg.server:exec(function(count)
+        local s = box.space.test
+        t.assert_equals(s:count(), count)
+        for i = 1, count, 997 do
+            t.assert_equals(s:get(i), {i, string.rep(tostring(i), 20)})
+        end
+    end, {count})
+end
+
+g.test_small_snapshot = function(cg)
+    cg.server:exec(function()
+        box.cfg{memtx_snapshot_compress_threads = 2}
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.space.test:select(), {{1}})
+    end)
+end
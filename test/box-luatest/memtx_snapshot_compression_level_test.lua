@@ -0,0 +1,65 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_snapshot_compression_level = 1},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_snapshot_compression_level, 1)
+        local msg = "Incorrect value for option " ..
+                    "'memtx_snapshot_compression_level': must be greater " ..
+                    "than 0 and less than or equal to 22"
+        t.assert_error_msg_equals(msg, box.cfg,
+                                  {memtx_snapshot_compression_level = 0})
+        t.assert_error_msg_equals(msg, box.cfg,
+                                  {memtx_snapshot_compression_level = 23})
+        t.assert_equals(box.cfg.memtx_snapshot_compression_level, 1)
+    end)
+end
+
+g.test_snapshot = function(cg)
+    local count = 20000
+    cg.server:exec(function(count)
+        local fio = require('fio')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, count do
+            s:insert({i, string.format('value %08d', i % 1000)})
+        end
+        local function snapshot_size()
+            box.snapshot()
+            local files = fio.glob(fio.pathjoin(box.cfg.memtx_dir, '*.snap'))
+            table.sort(files)
+            return fio.stat(files[#files]).size
+        end
+        box.cfg{memtx_snapshot_compression_level = 1}
+        local fast = snapshot_size()
+        box.cfg{memtx_snapshot_compression_level = 19}
+        s:replace(s:get(1))
+        local small = snapshot_size()
+        t.assert_lt(small, fast)
+        box.cfg{memtx_snapshot_compress_threads = 2}
+        s:replace(s:get(1))
+        t.assert_equals(snapshot_size(), small)
+    end, {count})
+    cg.server:restart()
+    cg.server:exec(function(count)
+        local s = box.space.test
+        t.assert_equals(s:count(), count)
+        for i = 1, count, 997 do
+            t.assert_equals(s:get(i),
+                            {i, string.format('value %08d', i % 1000)})
+        end
+    end, {count})
+end
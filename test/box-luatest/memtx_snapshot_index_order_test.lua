@@ -0,0 +1,116 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_snapshot_index_order = true},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Returns {index_id = number of positions} for index order rows of the
+-- space written to the last snapshot.
+local function snapshot_index_orders(cg, space_id)
+    return cg.server:exec(function(space_id)
+        local fio = require('fio')
+        local xlog = require('xlog')
+        local files = fio.glob(fio.pathjoin(box.cfg.memtx_dir, '*.snap'))
+        table.sort(files)
+        local orders = {}
+        for _, row in xlog.pairs(files[#files]) do
+            if row.HEADER.type == 'INDEXORDER' and
+                    row.BODY.space_id == space_id then
+                local iid = row.BODY.index_id
+                t.assert_equals(row.BODY.offset, orders[iid] or 0)
+                orders[iid] = (orders[iid] or 0) + #row.BODY.data
+            end
+        end
+        return orders
+    end, {space_id})
+end
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.memtx_snapshot_index_order, true)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'memtx_snapshot_index_order'",
+            box.cfg, {memtx_snapshot_index_order = 'yes'})
+    end)
+end
+
+g.test_index_order = function(cg)
+    local count = 50000
+    local space_id = cg.server:exec(function(count)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('str', {parts = {{2, 'string'}}})
+        s:create_index('num', {parts = {{3, 'unsigned'}}, unique = false})
+        s:create_index('hash', {type = 'hash', parts = {{2, 'string'}}})
+        s:create_index('multikey', {parts = {{'[4][*]', 'unsigned'}},
+                                    unique = false})
+        for i = 1, count do
+            s:insert({i, tostring(count - i), i % 100, {i % 7, i % 11}})
+        end
+        box.snapshot()
+        -- Changes written to the WAL after the snapshot.
+        for i = 1, 100 do
+            s:delete({i})
+            s:insert({count + i, 'new' .. i, i, {}})
+        end
+        return s.id
+    end, {count})
+    -- Only the order of secondary tree indexes is written.
+    t.assert_equals(snapshot_index_orders(cg, space_id),
+                    {[1] = count, [2] = count})
+    cg.server:restart()
+    t.assert_not(cg.server:grep_log('is invalid, sorting the index'))
+    cg.server:exec(function(count)
+        local s = box.space.test
+        t.assert_equals(s:count(), count)
+        for _, index in ipairs({s.index.str, s.index.num,
+                                s.index.multikey}) do
+            t.assert_equals(index:count(), index:len())
+            local prev
+            for _, tuple in index:pairs() do
+                if prev ~= nil then
+                    t.assert_le(index:compare(prev, tuple), 0)
+                end
+                prev = tuple
+            end
+        end
+        t.assert_equals(s.index.str:get('new1'), {count + 1, 'new1', 1, {}})
+        t.assert_equals(s.index.str:get(tostring(count - 1)), nil)
+        t.assert_equals(s.index.str:get(tostring(count - 101)),
+                        {101, tostring(count - 101), 1, {3, 2}})
+        t.assert_equals(s.index.num:count(7), count / 100)
+        t.assert_equals(s.index.str:count(), s.index.hash:count())
+    end, {count})
+end
+
+g.test_disabled = function(cg)
+    local space_id = cg.server:exec(function()
+        box.cfg{memtx_snapshot_index_order = false}
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}}})
+        s:insert({1, 2})
+        box.snapshot()
+        box.cfg{memtx_snapshot_index_order = true}
+        return s.id
+    end)
+    t.assert_equals(snapshot_index_orders(cg, space_id), {})
+end
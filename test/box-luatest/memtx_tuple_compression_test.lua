@@ -0,0 +1,97 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.space.plain ~= nil then
+            box.space.plain:drop()
+        end
+    end)
+end)
+
+g.test_zstd_compression = function(cg)
+    cg.server:exec(function()
+        local format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'data', type = 'string', compression = 'zstd'},
+            {name = 'short', type = 'string', compression = 'zstd'},
+        }
+        local s = box.schema.space.create('test', {format = format})
+        s:create_index('pk')
+        local p = box.schema.space.create('plain')
+        p:create_index('pk')
+
+        local data = string.rep('tarantool', 1000)
+        for i = 1, 100 do
+            s:insert({i, data, 'x'})
+            p:insert({i, data, 'x'})
+        end
+        t.assert_lt(s:bsize(), p:bsize() / 10)
+
+        t.assert_equals(s:get(1), {1, data, 'x'})
+        t.assert_equals(s:get(1).data, data)
+        t.assert_equals(#s:select(), 100)
+        t.assert_equals(s:replace({1, data .. '!', 'y'}),
+                        {1, data .. '!', 'y'})
+        t.assert_equals(s:update(2, {{'=', 3, 'z'}}), {2, data, 'z'})
+        t.assert_equals(s:update(2, {{':', 2, 1, 9, ''}}),
+                        {2, data:sub(10), 'z'})
+        t.assert_equals(s:delete(3), {3, data, 'x'})
+        t.assert_equals(s:get(2), {2, data:sub(10), 'z'})
+        t.assert_equals(s:get(1), {1, data .. '!', 'y'})
+        t.assert_equals(s:len(), 99)
+
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        local data = string.rep('tarantool', 1000)
+        t.assert_equals(s:len(), 99)
+        t.assert_equals(s:get(1), {1, data .. '!', 'y'})
+        t.assert_equals(s:get(4), {4, data, 'x'})
+        t.assert_lt(s:bsize(), box.space.plain:bsize() / 10)
+    end)
+end
+
+g.test_compressed_field_index = function(cg)
+    cg.server:exec(function()
+        local format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'data', type = 'string', compression = 'zstd'},
+        }
+        local s = box.schema.space.create('test', {format = format})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Indexed field does not support compression",
+            s.create_index, s, 'sk', {parts = {'data'}})
+    end)
+end
+
+g.test_vinyl = function(cg)
+    cg.server:exec(function()
+        local format = {
+            {name = 'id', type = 'unsigned'},
+            {name = 'data', type = 'string', compression = 'zstd'},
+        }
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support compression",
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', format = format})
+    end)
+end
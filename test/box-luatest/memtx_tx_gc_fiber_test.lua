@@ -0,0 +1,51 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {memtx_use_mvcc_engine = true}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_gc_stat = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+
+        local stat = box.stat.memtx.tx().mvcc.gc
+        t.assert_equals(stat.pending_steps, 0)
+        t.assert_type(stat.background_steps, 'number')
+
+        local f = fiber.new(function()
+            box.begin()
+            for i = 1, 1000 do
+                s:replace({i, i})
+            end
+            box.commit()
+        end)
+        f:set_joinable(true)
+        box.begin()
+        for i = 1, 1000 do
+            s:replace({i, -i})
+        end
+        box.rollback()
+        t.assert(f:join())
+
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.memtx.tx().mvcc.gc.pending_steps, 0)
+        end)
+        box.internal.memtx_tx_gc(10000)
+        local tuples = box.stat.memtx.tx().mvcc.tuples
+        t.assert_equals(tuples.used.stories.count, 0)
+        t.assert_equals(tuples.read_view.stories.count, 0)
+        t.assert_equals(tuples.tracking.stories.count, 0)
+        t.assert_equals(s:len(), 1000)
+        s:drop()
+    end)
+end
@@ -0,0 +1,97 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('memtx_tx_read_only', t.helpers.matrix({
+    mvcc = {false, true},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {memtx_use_mvcc_engine = cg.params.mvcc},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        s:insert({1, 10})
+        s:insert({2, 20})
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.is_in_txn() then
+            box.rollback()
+        end
+        box.space.test:drop()
+    end)
+end)
+
+g.test_options = function(cg)
+    cg.server:exec(function()
+        t.assert_error_covers({
+            type = 'ClientError',
+            message = "Illegal parameters, read_only must be a boolean",
+        }, box.begin, {read_only = 'yes'})
+        t.assert_not(box.is_in_txn())
+        box.begin({read_only = false})
+        box.space.test:replace({3, 30})
+        box.commit()
+        t.assert_equals(box.space.test:get(3), {3, 30})
+    end)
+end
+
+g.test_write_is_forbidden = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin({read_only = true})
+        t.assert_equals(s:get(1), {1, 10})
+        local err = {
+            type = 'ClientError',
+            name = 'TXN_READ_ONLY',
+            message = "Can't modify data in a read-only transaction",
+        }
+        t.assert_error_covers(err, s.replace, s, {3, 30})
+        t.assert_error_covers(err, s.delete, s, {1})
+        t.assert_error_covers(err, s.update, s, {1}, {{'=', 2, 11}})
+        t.assert_equals(s:select(), {{1, 10}, {2, 20}})
+        box.commit()
+        t.assert_equals(s:select(), {{1, 10}, {2, 20}})
+    end)
+end
+
+g.test_snapshot = function(cg)
+    t.skip_if(not cg.params.mvcc, 'MVCC is disabled')
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local trackers = box.stat.memtx.tx().mvcc.trackers.total
+        box.begin({read_only = true})
+        t.assert_equals(s:get(1), {1, 10})
+        t.assert_equals(s.index.sk:select({20}), {{2, 20}})
+        local f = fiber.new(function()
+            s:replace({1, 11})
+            s:delete({2})
+            s:insert({3, 30})
+        end)
+        f:set_joinable(true)
+        t.assert(f:join())
+        t.assert_equals(s:get(1), {1, 10})
+        t.assert_equals(s:get(2), {2, 20})
+        t.assert_equals(s:get(3), nil)
+        t.assert_equals(s:select(), {{1, 10}, {2, 20}})
+        t.assert_equals(s.index.sk:select({20}), {{2, 20}})
+        t.assert_equals(s:count(), 2)
+        t.assert_equals(box.stat.memtx.tx().mvcc.trackers.total, trackers)
+        box.commit()
+        t.assert_equals(s:select(), {{1, 11}, {3, 30}})
+    end)
+end
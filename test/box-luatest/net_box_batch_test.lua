@@ -0,0 +1,93 @@
+local fiber = require('fiber')
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'super')
+        rawset(_G, 'counter', 0)
+        rawset(_G, 'incr', function()
+            _G.counter = _G.counter + 1
+            return _G.counter
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        _G.counter = 0
+    end)
+end)
+
+local function counter(cg)
+    return cg.server:exec(function()
+        return _G.counter
+    end)
+end
+
+g.test_batch = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(conn.state, 'active')
+    local futures = {}
+    local res = {conn:batch(function(a, b)
+        for _ = 1, 10 do
+            table.insert(futures, conn:call('incr', {}, {is_async = true}))
+        end
+        -- Nothing is sent until the batch ends even if we yield.
+        fiber.sleep(0.1)
+        t.assert_equals(counter(cg), 0)
+        return a, b
+    end, 1, 2)}
+    t.assert_equals(res, {1, 2})
+    for i, future in ipairs(futures) do
+        t.assert_equals(future:wait_result(), {i})
+    end
+    -- Waiting for a response flushes the batch.
+    t.assert_equals(conn:batch(function()
+        conn:call('incr', {}, {is_async = true})
+        return conn:call('incr')
+    end), 12)
+    -- Errors are propagated and the batch is closed.
+    t.assert_error_msg_equals('test', conn.batch, conn, function()
+        conn:call('incr', {}, {is_async = true})
+        error('test', 0)
+    end)
+    t.assert_equals(conn:call('incr'), 14)
+    t.assert_error_msg_equals('func must be a function',
+                              conn.batch, conn, 1)
+    conn:close()
+end
+
+g.test_coalesce = function(cg)
+    local conn = net.connect(cg.server.net_box_uri, {coalesce_timeout = 0.5})
+    t.assert_equals(conn.state, 'active')
+    local future = conn:call('incr', {}, {is_async = true})
+    fiber.sleep(0.1)
+    t.assert_equals(counter(cg), 0)
+    t.assert_equals(future:wait_result(), {1})
+    conn:close()
+
+    -- The send buffer size limit overrides the timeout.
+    conn = net.connect(cg.server.net_box_uri, {
+        coalesce_timeout = 1000,
+        coalesce_size = 100,
+    })
+    t.assert_equals(conn.state, 'active')
+    local futures = {}
+    for _ = 1, 10 do
+        table.insert(futures, conn:call('incr', {}, {is_async = true}))
+    end
+    for i, f in ipairs(futures) do
+        t.assert_equals(f:wait_result(), {i + 1})
+    end
+    conn:close()
+end
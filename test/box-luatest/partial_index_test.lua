@@ -0,0 +1,147 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('partial_index', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+local function create_space(engine)
+    local s = box.schema.space.create('test', {engine = engine, format = {
+        {'id', 'unsigned'}, {'status', 'string'}, {'time', 'unsigned'},
+    }})
+    s:create_index('pk')
+    s:create_index('sk', {
+        parts = {'status', 'time'}, unique = false,
+        filter = {field = 'status', value = 'pending'},
+    })
+end
+
+g.test_dml = function(cg)
+    cg.server:exec(create_space, {cg.params.engine})
+    cg.server:exec(function()
+        local s = box.space.test
+        local sk = s.index.sk
+        t.assert_equals(sk.filter, {field = 2, value = 'pending'})
+        t.assert_equals(s.index.pk.filter, nil)
+        for i = 1, 100 do
+            s:insert({i, i % 10 == 0 and 'pending' or 'done', 1000 - i})
+        end
+        t.assert_equals(sk:len(), 10)
+        t.assert_equals(sk:select({}, {limit = 2}),
+                        {{100, 'pending', 900}, {90, 'pending', 910}})
+        t.assert_equals(sk:select({'done'}), {})
+        -- Updates move tuples in and out of the index.
+        s:update(100, {{'=', 2, 'done'}})
+        s:update(1, {{'=', 2, 'pending'}})
+        s:replace({2, 'pending', 0})
+        s:delete(90)
+        t.assert_equals(sk:len(), 10)
+        t.assert_equals(sk:select({'pending'}, {limit = 3}),
+                        {{2, 'pending', 0}, {80, 'pending', 920},
+                         {70, 'pending', 930}})
+        t.assert_equals(sk:get({'pending', 900}), nil)
+        t.assert_equals(sk:select({'pending', 999}), {{1, 'pending', 999}})
+        -- Transaction rollback.
+        box.begin()
+        s:update(1, {{'=', 2, 'done'}})
+        s:insert({200, 'pending', 1})
+        box.rollback()
+        t.assert_equals(sk:select({'pending', 999}), {{1, 'pending', 999}})
+        t.assert_equals(sk:get({'pending', 1}), nil)
+        t.assert_equals(sk:len(), 10)
+    end)
+end
+
+g.test_build_and_recovery = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, i % 2 == 0, i})
+        end
+        s:create_index('sk', {parts = {{2, 'boolean'}, {3, 'unsigned'}},
+                              filter = {field = 2, value = true}})
+        t.assert_equals(s.index.sk:len(), 50)
+        box.snapshot()
+        s:insert({101, true, 101})
+    end, {cg.params.engine})
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        local sk = s.index.sk
+        t.assert_equals(sk.filter, {field = 2, value = true})
+        t.assert_equals(sk:len(), 51)
+        t.assert_equals(sk:select({true}, {iterator = 'LE', limit = 2}),
+                        {{101, true, 101}, {100, true, 100}})
+        t.assert_equals(sk:select({false}), {})
+        -- Changing the filter rebuilds the index.
+        sk:alter({filter = {field = 2, value = false}})
+        t.assert_equals(sk.filter, {field = 2, value = false})
+        t.assert_equals(sk:len(), 50)
+        t.assert_equals(sk:select({}, {limit = 1}), {{1, false, 1}})
+    end)
+end
+
+g.test_sql = function(cg)
+    cg.server:exec(create_space, {cg.params.engine})
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1, 'pending', 10})
+        s:insert({2, 'done', 20})
+        -- The partial index isn't used for lookups implicitly.
+        local res = box.execute([[SELECT "id" FROM "test"
+                                  WHERE "status" = 'done';]])
+        t.assert_equals(res.rows, {{2}})
+        res = box.execute([[SELECT "id" FROM "test" INDEXED BY "sk"
+                            WHERE "status" = 'pending';]])
+        t.assert_equals(res.rows, {{1}})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine, format = {
+            {'a', 'unsigned'}, {'b', 'string'}, {'c', 'unsigned'},
+        }})
+        t.assert_error_msg_contains(
+            "primary key can not be partial", s.create_index, s, 'pk',
+            {filter = {field = 1, value = 1}})
+        s:create_index('pk')
+        local function check(msg, filter, opts)
+            opts = opts or {parts = {'b'}, unique = false}
+            opts.filter = filter
+            t.assert_error_msg_contains(msg, s.create_index, s, 'sk', opts)
+        end
+        check("field was not found by name 'x'", {field = 'x', value = 1})
+        check("JSON paths are not supported", {field = 'b.x', value = 1})
+        check("'filter' must have 'field' and 'value' keys", {field = 2})
+        check("'filter.value' must be a number, string, varbinary or boolean",
+              {field = 2, value = {1, 2}})
+        check("'filter.value' is too long",
+              {field = 2, value = string.rep('x', 100)})
+        if engine == 'memtx' then
+            check("filter is only reasonable with memtx tree index",
+                  {field = 2, value = 'x'}, {type = 'hash', parts = {'b'}})
+        else
+            check("filter field must be indexed by the partial index",
+                  {field = 3, value = 1})
+        end
+    end, {cg.params.engine})
+end
@@ -4,19 +4,112 @@ local t = require('luatest')
 local g = t.group()
 
 g.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
     cg.server = server:new({alias = 'master'})
     cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'id', 'unsigned'}, {'val', 'string'}},
+        })
+        s:create_index('pk')
+        s:create_index('val', {type = 'hash', parts = {'val'}})
+        for i = 1, 10 do
+            s:insert({i, 'v' .. i})
+        end
+        box.schema.space.create('other'):create_index('pk')
+        box.schema.space.create('vinyl', {engine = 'vinyl'})
+    end)
 end)
 
 g.after_all(function(cg)
-    cg.server:stop()
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
 end)
 
 g.test_read_view = function(cg)
-    t.tarantool.skip_if_enterprise()
     cg.server:exec(function()
-        t.assert_error_msg_equals(
-            "Community edition does not support read view",
-            function() box.read_view.open() end)
+        local rv = box.read_view.open({name = 'test', spaces = {'test'}})
+        t.assert_equals(rv.name, 'test')
+        t.assert_equals(rv.status, 'open')
+        local ids = {}
+        for _, v in ipairs(box.read_view.list()) do
+            table.insert(ids, v.id)
+        end
+        t.assert_items_include(ids, {rv.id})
+        t.assert_equals(rv.space.other, nil)
+        local s = rv.space.test
+        t.assert_is(rv.space[s.id], s)
+        t.assert_is(s.index[1], s.index.val)
+
+        -- Changes done after the read view was opened aren't visible.
+        box.space.test:delete(1)
+        box.space.test:insert({11, 'v11'})
+        box.space.test:update(2, {{'=', 2, 'x'}})
+        local res = s:select()
+        t.assert_equals(#res, 10)
+        t.assert_equals(res[1], {1, 'v1'})
+        t.assert_equals(res[2], {2, 'v2'})
+        t.assert_equals(res[2].val, 'v2')
+        t.assert_equals(s.index.pk:select({}, {offset = 8}),
+                        {{9, 'v9'}, {10, 'v10'}})
+        t.assert_equals(s.index.pk:select(nil, {limit = 1}), {{1, 'v1'}})
+        t.assert_equals(#s.index.val:select(), 10)
+        local count = 0
+        for _, tuple in s:pairs() do
+            count = count + 1
+            t.assert_equals(tuple.id, count)
+        end
+        t.assert_equals(count, 10)
+
+        -- Only full scans are supported.
+        local msg = 'Read view does not support iterator types other than ALL'
+        t.assert_error_msg_equals(msg, s.select, s, 1)
+        t.assert_error_msg_equals(msg, s.pairs, s, {}, {iterator = 'GE'})
+        t.assert_error_msg_equals('Use space:select(...) instead of ' ..
+                                  'space.select(...)', s.select)
+
+        local gen, param, state = s:pairs()
+        rv:close()
+        t.assert_equals(rv.status, 'closed')
+        msg = 'The read view is closed'
+        t.assert_error_msg_equals(msg, s.select, s)
+        t.assert_error_msg_equals(msg, gen, param, state)
+        t.assert_error_msg_equals(msg, rv.close, rv)
+        box.space.test:delete(11)
+        box.space.test:replace({1, 'v1'})
+        box.space.test:replace({2, 'v2'})
+    end)
+end
+
+g.test_read_view_spaces = function(cg)
+    cg.server:exec(function()
+        -- All user spaces supporting read views are included by default.
+        local rv = box.read_view.open()
+        t.assert_equals(rv.name, 'unknown')
+        t.assert_not_equals(rv.space.test, nil)
+        t.assert_not_equals(rv.space.other, nil)
+        t.assert_equals(rv.space.vinyl, nil)
+        t.assert_equals(rv.space._space, nil)
+        rv:close()
+        t.assert_error_msg_equals("Space 'foo' does not exist",
+                                  box.read_view.open, {spaces = {'foo'}})
+        t.assert_error_msg_equals("unexpected option 'foo'",
+                                  box.read_view.open, {foo = 1})
+    end)
+end
+
+g.test_read_view_access = function(cg)
+    cg.server:exec(function()
+        box.schema.user.create('alice')
+        box.session.su('alice', function()
+            t.assert_error_msg_contains(
+                "Read access to space 'test' is denied",
+                box.read_view.open, {spaces = {'test'}})
+            local rv = box.read_view.open()
+            t.assert_equals(rv.space.test, nil)
+            rv:close()
+        end)
+        box.schema.user.drop('alice')
     end)
 end
@@ -0,0 +1,65 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'ping', function() return true end)
+        box.schema.func.create('ping')
+        box.schema.user.grant('guest', 'execute', 'function', 'ping')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        require('internal.tweaks').cord_ibuf_max_cached = 1024 * 1024
+    end)
+end)
+
+g.test_requests = function(cg)
+    cg.server:exec(function()
+        box.stat.reset()
+        t.assert_equals(box.stat.region().requests, {})
+    end)
+    for _ = 1, 10 do
+        cg.server.net_box:call('ping')
+    end
+    cg.server:exec(function()
+        local stat = box.stat.region().requests.CALL
+        t.assert_equals(stat.count, 10)
+        t.assert_ge(stat.max, stat.avg)
+        box.stat.reset()
+        t.assert_equals(box.stat.region().requests, {})
+    end)
+end
+
+g.test_ibuf_shrink = function(cg)
+    cg.server:exec(function()
+        local buffer = require('buffer')
+        box.stat.reset()
+        local size = 2 * 1024 * 1024
+        local buf = buffer.internal.cord_ibuf_take()
+        buf:alloc(size)
+        buffer.internal.cord_ibuf_put(buf)
+        local stat = box.stat.region().ibuf
+        t.assert_ge(stat.used_max, size)
+        t.assert_ge(stat.capacity_max, size)
+        t.assert_equals(stat.shrink_count, 1)
+        t.assert_equals(stat.capacity, 0)
+
+        require('internal.tweaks').cord_ibuf_max_cached = 4 * size
+        buf = buffer.internal.cord_ibuf_take()
+        buf:alloc(size)
+        buffer.internal.cord_ibuf_put(buf)
+        stat = box.stat.region().ibuf
+        t.assert_equals(stat.shrink_count, 1)
+        t.assert_ge(stat.capacity, size)
+    end)
+end
@@ -0,0 +1,73 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.sequence.test ~= nil then
+            box.sequence.test:drop()
+        end
+    end)
+end)
+
+--
+-- Checks that a sequence with the cache option writes to _sequence_data
+-- once per block and resumes after the block on recovery.
+--
+g.test_sequence_cache = function(cg)
+    cg.server:exec(function()
+        local seq = box.schema.sequence.create('test', {cache = 10})
+        local lsn = box.info.lsn
+        for i = 1, 10 do
+            t.assert_equals(seq:next(), i)
+        end
+        t.assert_equals(seq:current(), 10)
+        t.assert_equals(box.info.lsn, lsn + 1)
+        t.assert_equals(seq:next(), 11)
+        t.assert_equals(seq:next(), 12)
+        t.assert_equals(box.info.lsn, lsn + 2)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local seq = box.sequence.test
+        t.assert_equals(seq:current(), 20)
+        t.assert_equals(seq:next(), 21)
+        -- An explicit set drops the preallocated block.
+        seq:set(5)
+        t.assert_equals(seq:next(), 6)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.sequence.test:next(), 16)
+    end)
+end
+
+--
+-- Checks the block is clipped by the sequence bounds.
+--
+g.test_sequence_cache_bounds = function(cg)
+    cg.server:exec(function()
+        local seq = box.schema.sequence.create('test', {
+            cache = 10, step = -3, min = -5, max = 10, start = 10,
+            cycle = true,
+        })
+        local lsn = box.info.lsn
+        for _, v in ipairs({10, 7, 4, 1, -2, -5}) do
+            t.assert_equals(seq:next(), v)
+        end
+        t.assert_equals(box.info.lsn, lsn + 1)
+        -- Wrapped around, the new block is written.
+        t.assert_equals(seq:next(), 10)
+        t.assert_equals(box.info.lsn, lsn + 2)
+    end)
+end
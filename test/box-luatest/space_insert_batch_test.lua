@@ -0,0 +1,124 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({engine = {'memtx', 'vinyl'}}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}}})
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_insert_batch = function(cg)
+    cg.server:exec(function()
+        local buffer = require('buffer')
+        local msgpack = require('msgpack')
+        local s = box.space.test
+        -- Lua string.
+        t.assert_equals(s:insert_batch(msgpack.encode({{1, 'a'}, {2, 'b'}})),
+                        2)
+        -- Msgpack object.
+        t.assert_equals(s:insert_batch(msgpack.object({{3, 'c'}})), 1)
+        -- Buffer.
+        local buf = buffer.ibuf()
+        msgpack.encode({{4, 'd'}, {5, 'e'}, {6, 'f'}}, buf)
+        t.assert_equals(s:insert_batch(buf.rpos, buf:size()), 3)
+        buf:recycle()
+        t.assert_equals(s:insert_batch(msgpack.encode({})), 0)
+        t.assert_equals(s:select(), {
+            {1, 'a'}, {2, 'b'}, {3, 'c'}, {4, 'd'}, {5, 'e'}, {6, 'f'},
+        })
+        t.assert_equals(s.index.sk:get('e'), {5, 'e'})
+        t.assert_equals(s:replace_batch(msgpack.encode({{1, 'x'}, {7, 'y'}})),
+                        2)
+        t.assert_equals(s:select({}, {limit = 1}), {{1, 'x'}})
+        t.assert_equals(s:get(7), {7, 'y'})
+        t.assert_equals(s.index.sk:get('a'), nil)
+    end)
+end
+
+g.test_atomic = function(cg)
+    cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local s = box.space.test
+        s:insert({1, 'a'})
+        -- Duplicate key in the middle of the batch.
+        t.assert_error_msg_contains(
+            'Duplicate key exists',
+            s.insert_batch, s, msgpack.encode({{2, 'b'}, {1, 'c'}, {3, 'd'}}))
+        t.assert_error_msg_equals(
+            'Tuple/Key must be MsgPack array',
+            s.insert_batch, s, msgpack.encode({{2, 'b'}, 3}))
+        t.assert_equals(s:select(), {{1, 'a'}})
+        -- Only the batch is rolled back in a transaction.
+        box.begin()
+        s:insert({2, 'b'})
+        t.assert_error_msg_contains(
+            'Duplicate key exists',
+            s.insert_batch, s, msgpack.encode({{3, 'c'}, {2, 'd'}}))
+        t.assert_equals(s:insert_batch(msgpack.encode({{4, 'e'}})), 1)
+        box.commit()
+        t.assert_equals(s:select(), {{1, 'a'}, {2, 'b'}, {4, 'e'}})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local ffi = require('ffi')
+        local msgpack = require('msgpack')
+        local s = box.space.test
+        local usage = 'Usage: space:insert_batch(msgpack) or ' ..
+                      'space:insert_batch(ptr, size)'
+        t.assert_error_msg_equals(usage, s.insert_batch, s)
+        t.assert_error_msg_equals(usage, s.insert_batch, s, 1)
+        t.assert_error_msg_equals(usage, s.insert_batch, s,
+                                  ffi.cast('char *', 'abc'))
+        t.assert_error_msg_equals(
+            'insert_batch expects a MsgPack array of tuples',
+            s.insert_batch, s, msgpack.encode(1))
+        t.assert_error_msg_contains(
+            'Invalid MsgPack',
+            s.replace_batch, s, msgpack.encode({{1}}):sub(1, -2))
+        t.assert_equals(s:select(), {})
+    end)
+end
+
+g.test_upsert_batch = function(cg)
+    cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local s = box.space.test
+        s:insert({1, 'a', 10})
+        t.assert_equals(s:upsert_batch(msgpack.encode({
+            {{1, 'a', 0}, {{'+', 3, 1}}},
+            {{2, 'b', 0}, {{'+', 3, 1}}},
+            {{1, 'a', 0}, {{'+', 3, 5}}},
+            {{2, 'b', 0}, {{'+', 3, 2}}},
+        })), 4)
+        t.assert_equals(s:select(), {{1, 'a', 16}, {2, 'b', 2}})
+        local err = 'upsert_batch expects {tuple, operations} pairs'
+        t.assert_error_msg_equals(err, s.upsert_batch, s,
+                                  msgpack.encode({{{3, 'c'}}}))
+        t.assert_error_msg_equals(err, s.upsert_batch, s,
+                                  msgpack.encode({{{3, 'c'}, 1}}))
+        t.assert_error_msg_equals(err, s.upsert_batch, s,
+                                  msgpack.encode({{{4, 'd'}, {}}, {1, 2}}))
+        t.assert_equals(s:select(), {{1, 'a', 16}, {2, 'b', 2}})
+    end)
+end
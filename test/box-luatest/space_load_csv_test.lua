@@ -0,0 +1,83 @@
+local fio = require('fio')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'},
+            {'name', 'string'},
+            {'score', 'number', is_nullable = true},
+            {'flag', 'boolean', is_nullable = true},
+        }})
+        s:create_index('pk')
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+local function write_file(cg, name, data)
+    local path = fio.pathjoin(cg.server.workdir, name)
+    local f = fio.open(path, {'O_WRONLY', 'O_CREAT', 'O_TRUNC'},
+                       tonumber('644', 8))
+    f:write(data)
+    f:close()
+    return path
+end
+
+g.test_load_csv = function(cg)
+    local rows = {'id,name,score,flag'}
+    for i = 1, 25 do
+        table.insert(rows, string.format('%d,"name %d",%s,%s', i, i,
+                                         i % 2 == 0 and i / 2 or '',
+                                         i % 3 == 0 and 'true' or 'false'))
+    end
+    local path = write_file(cg, 'data.csv', table.concat(rows, '\n') .. '\n')
+    cg.server:exec(function(path)
+        local s = box.space.test
+        t.assert_equals(s:load_csv(path, {skip_head_lines = 1,
+                                          batch_size = 10}), 25)
+        t.assert_equals(s:count(), 25)
+        t.assert_equals(s:get(1):totable(), {1, 'name 1', box.NULL, false})
+        t.assert_equals(s:get(6):totable(), {6, 'name 6', 3, true})
+        -- Duplicates are rejected unless mode is 'replace'.
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.load_csv, s, path,
+                                    {skip_head_lines = 1})
+        t.assert_equals(s:load_csv(path, {skip_head_lines = 1,
+                                          mode = 'replace'}), 25)
+        t.assert_equals(s:count(), 25)
+    end, {path})
+end
+
+g.test_load_csv_invalid = function(cg)
+    local path = write_file(cg, 'bad.csv', '1,a\nx,b\n')
+    cg.server:exec(function(path)
+        local s = box.space.test
+        t.assert_error_msg_equals(
+            'Failed to convert field 1 of line 2 to unsigned',
+            s.load_csv, s, path)
+        t.assert_equals(s:count(), 0)
+        t.assert_error_msg_equals('batch_size must be a positive integer',
+                                  s.load_csv, s, path, {batch_size = 0})
+        t.assert_error_msg_equals("mode must be 'insert' or 'replace'",
+                                  s.load_csv, s, path, {mode = 'upsert'})
+        t.assert_error_msg_contains('Failed to open',
+                                    s.load_csv, s, '/no/such/file.csv')
+    end, {path})
+end
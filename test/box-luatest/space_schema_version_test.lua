@@ -0,0 +1,44 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'test1', 'test2'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_space_schema_version = function(cg)
+    cg.server:exec(function()
+        local s1 = box.schema.space.create('test1')
+        t.assert_equals(s1.schema_version, box.info.schema_version)
+        local s2 = box.schema.space.create('test2')
+        t.assert_equals(s2.schema_version, box.info.schema_version)
+        t.assert_lt(s1.schema_version, s2.schema_version)
+
+        -- Altering a space doesn't affect the others.
+        local v1 = s1.schema_version
+        s2:create_index('pk')
+        t.assert_equals(box.space.test2.schema_version,
+                        box.info.schema_version)
+        t.assert_equals(box.space.test1.schema_version, v1)
+
+        box.space.test1:format({{'a', 'unsigned'}})
+        t.assert_equals(box.space.test1.schema_version,
+                        box.info.schema_version)
+    end)
+end
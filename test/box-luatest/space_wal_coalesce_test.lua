@@ -0,0 +1,103 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_option = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_contains(
+            "options parameter 'wal_coalesce' should be of type boolean",
+            box.schema.space.create, 'test', {wal_coalesce = 'yes'})
+        t.assert_error_msg_equals(
+            "Vinyl does not support wal_coalesce",
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', wal_coalesce = true})
+        local s = box.schema.space.create('test')
+        t.assert_equals(s.wal_coalesce, nil)
+        s:alter({wal_coalesce = true})
+        t.assert_equals(s.wal_coalesce, true)
+    end)
+end
+
+g.test_coalesce = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {wal_coalesce = true})
+        t.assert_equals(s.wal_coalesce, true)
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        local function rows(f)
+            local lsn = box.info.lsn
+            box.atomic(f)
+            return box.info.lsn - lsn
+        end
+        t.assert_equals(rows(function()
+            for _ = 1, 100 do
+                s:upsert({1, 1}, {{'+', 2, 1}})
+            end
+        end), 1)
+        t.assert_equals(rows(function()
+            for i = 1, 10 do
+                s:upsert({1, 1}, {{'+', 2, 1}})
+                s:upsert({2, 1}, {{'+', 2, i}})
+                s:insert({i + 10, i})
+                s:delete({i + 10})
+            end
+            s:update({2}, {{'=', 3, 'x'}})
+        end), 12)
+        t.assert_equals(rows(function()
+            s:replace({3, 3})
+            s:delete({3})
+        end), 1)
+        t.assert_equals(s:select(), {{1, 110}, {2, 55, 'x'}})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:select(), {{1, 110}, {2, 55, 'x'}})
+        t.assert_equals(s.index.sk:select(), {{2, 55, 'x'}, {1, 110}})
+    end)
+end
+
+g.test_not_coalesced = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {wal_coalesce = true})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        local lsn = box.info.lsn
+        box.atomic(function()
+            s:replace({1, 1})
+            s:replace({1, 2})
+        end)
+        t.assert_equals(box.info.lsn - lsn, 2)
+        s.index.sk:drop()
+
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        lsn = box.info.lsn
+        box.atomic(function()
+            s2:replace({1, 1})
+            s2:replace({1, 2})
+            s:replace({1, 3})
+            s:replace({1, 4})
+        end)
+        t.assert_equals(box.info.lsn - lsn, 3)
+        s2:drop()
+    end)
+end
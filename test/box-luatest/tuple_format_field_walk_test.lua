@@ -0,0 +1,50 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that tuple fields past the last indexed or typed field are
+-- still validated.
+g.test_validate_trailing_fields = function(cg)
+    cg.server:exec(function()
+        local msgpack = require('msgpack')
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'}, {'a', 'any'}, {'b', 'any'},
+            {'c', 'string', is_nullable = true}, {'d', 'any'},
+        }})
+        s:create_index('pk')
+        s:insert({1, 2, 3, 'x', 5, 6})
+        s:insert({2, 2, 3})
+        t.assert_error_msg_contains(
+            "Tuple field 4 (c) type does not match one required by " ..
+            "operation: expected string, got unsigned",
+            s.insert, s, {3, 2, 3, 4})
+        -- An extension of unknown type isn't allowed in a formatted
+        -- field of type 'any'.
+        local ext = msgpack.object_from_raw(string.fromhex('d40000'))
+        t.assert_error_msg_contains(
+            "Tuple field 5 (d) type does not match one required by " ..
+            "operation: expected any, got extension",
+            s.insert, s, {4, 2, 3, 'x', ext})
+        -- But it is allowed in an unformatted field.
+        s:insert({5, 2, 3, 'x', 5, ext})
+        t.assert_equals(s:count(), 3)
+    end)
+end
@@ -0,0 +1,73 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that no offset is stored in the field map for a field preceded
+-- only by fixed size fields.
+g.test_fixed_prefix = function(cg)
+    cg.server:exec(function()
+        local uuid = require('uuid')
+        local s = box.schema.space.create('test', {format = {
+            {name = 'id', type = 'uuid'},
+            {name = 'flag', type = 'boolean'},
+            {name = 'name', type = 'string'},
+            {name = 'value', type = 'unsigned'},
+        }})
+        s:create_index('pk')
+        s:create_index('name', {parts = {'name'}})
+        s:create_index('flag', {parts = {'flag'}, unique = false})
+        local id1 = uuid.new()
+        local id2 = uuid.new()
+        t.assert_equals(s:insert({id1, true, 'a', 1}):info().field_map_size,
+                        0)
+        s:insert({id2, false, 'b', 2})
+        t.assert_equals(s.index.name:get('a'), {id1, true, 'a', 1})
+        t.assert_equals(s.index.name:get('b'), {id2, false, 'b', 2})
+        t.assert_equals(s.index.flag:select(false), {{id2, false, 'b', 2}})
+
+        -- A field following a field of variable size needs an offset.
+        s:create_index('value', {parts = {'value'}})
+        local id3 = uuid.new()
+        t.assert_equals(s:insert({id3, true, 'c', 3}):info().field_map_size,
+                        4)
+        t.assert_equals(s.index.value:get(2), {id2, false, 'b', 2})
+        t.assert_equals(s.index.value:get(3), {id3, true, 'c', 3})
+        t.assert_equals(s.index.name:get('c'), {id3, true, 'c', 3})
+    end)
+end
+
+-- Checks that an offset is stored for a field preceded by a nullable field.
+g.test_nullable_prefix = function(cg)
+    cg.server:exec(function()
+        local uuid = require('uuid')
+        local s = box.schema.space.create('test', {format = {
+            {name = 'id', type = 'uuid'},
+            {name = 'flag', type = 'boolean', is_nullable = true},
+            {name = 'name', type = 'string'},
+        }})
+        s:create_index('pk')
+        s:create_index('name', {parts = {'name'}})
+        local id = uuid.new()
+        t.assert_equals(s:insert({id, box.NULL, 'a'}):info().field_map_size,
+                        4)
+        t.assert_equals(s.index.name:get('a'), {id, box.NULL, 'a'})
+    end)
+end
@@ -0,0 +1,87 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_projection = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'}, {'name', 'string'}, {'data', 'map'},
+        }})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'data.a.b', 'unsigned'}},
+                              unique = false})
+        s:insert({1, 'one', {a = {b = 10, c = {20, 30}}}, 'x'})
+        s:insert({2, 'two', {a = {b = 20}}})
+        local proj = box.tuple.projection({
+            'name', 'data.a.b', '[3].a.c[2]', '[4]', 'id', 'missing', '[10]',
+        })
+        t.assert_equals(tostring(proj), '<tuple projection of 7 fields>')
+        -- The second round uses the cached field offsets.
+        for _ = 1, 2 do
+            t.assert_equals({proj(s:get(1))},
+                            {'one', 10, 30, 'x', 1, nil, nil})
+            t.assert_equals({proj(s:get(2))},
+                            {'two', 20, nil, nil, 2, nil, nil})
+        end
+        -- Field names are resolved per tuple format.
+        local tuple = box.tuple.new({3, 'three', {a = {b = 30}}})
+        t.assert_equals({proj(tuple)}, {nil, nil, nil, nil, nil, nil, nil})
+        proj = box.tuple.projection({'[2]', '[3].a.b'})
+        t.assert_equals({proj(tuple)}, {'three', 30})
+        t.assert_equals({proj(s:get(1))}, {'one', 10})
+        t.assert_equals({proj(tuple)}, {'three', 30})
+    end)
+end
+
+g.test_projection_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'}, {'name', 'string'},
+        }})
+        s:create_index('pk')
+        s:insert({1, 'one'})
+        local proj = box.tuple.projection({'name', 'id'})
+        t.assert_equals({proj(s:get(1))}, {'one', 1})
+        s:format({{'id', 'unsigned'}, {'alias', 'string'}})
+        t.assert_equals({proj(s:get(1))}, {nil, 1})
+        s:format({{'id', 'unsigned'}, {'name', 'string'}})
+        t.assert_equals({proj(s:get(1))}, {'one', 1})
+    end)
+end
+
+g.test_projection_invalid = function(cg)
+    cg.server:exec(function()
+        local usage = 'Usage: box.tuple.projection({path, ...})'
+        t.assert_error_msg_content_equals(usage, box.tuple.projection)
+        t.assert_error_msg_content_equals(usage, box.tuple.projection, 'a')
+        t.assert_error_msg_contains('projection must contain from 1 to',
+                                    box.tuple.projection, {})
+        t.assert_error_msg_content_equals(
+            'projection field 2 must be a non-empty string',
+            box.tuple.projection, {'a', 1})
+        t.assert_error_msg_content_equals(
+            'projection field 1 must be a non-empty string',
+            box.tuple.projection, {''})
+        local proj = box.tuple.projection({'a'})
+        t.assert_error_msg_content_equals('Usage: projection(tuple)',
+                                          proj, {1})
+    end)
+end
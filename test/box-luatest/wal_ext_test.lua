@@ -0,0 +1,105 @@
+local fio = require('fio')
+local server = require('luatest.server')
+local t = require('luatest')
+local xlog = require('xlog')
+
+local g = t.group(nil, t.helpers.matrix({engine = {'memtx', 'vinyl'}}))
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg({wal_ext = box.NULL})
+        for _, name in ipairs({'test', 'other'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+-- Returns the bodies of the rows written to the given space
+-- after the given LSN.
+local function read_rows(cg, lsn, space_id)
+    local rows = {}
+    local path = fio.pathjoin(cg.server.workdir,
+                              string.format('%020d.xlog', lsn))
+    for _, row in xlog.pairs(path) do
+        if row.BODY.space_id == space_id then
+            table.insert(rows, {row.HEADER.type, row.BODY})
+        end
+    end
+    return rows
+end
+
+g.test_wal_ext = function(cg)
+    local info = cg.server:exec(function(engine)
+        for _, name in ipairs({'test', 'other'}) do
+            local s = box.schema.space.create(name, {engine = engine})
+            s:create_index('pk')
+        end
+        box.cfg({wal_ext = {new = true, spaces = {test = {old = true}}}})
+        box.snapshot()
+        local lsn = box.info.lsn
+        for _, s in ipairs({box.space.test, box.space.other}) do
+            s:insert({1, 1})
+            s:update(1, {{'+', 2, 1}})
+            s:upsert({1, 0}, {{'+', 2, 1}})
+            s:replace({1, 10})
+            s:delete(1)
+        end
+        return {
+            lsn = lsn,
+            test = box.space.test.id,
+            other = box.space.other.id,
+        }
+    end, {cg.params.engine})
+    t.assert_equals(read_rows(cg, info.lsn, info.test), {
+        {'INSERT', {space_id = info.test, tuple = {1, 1}}},
+        {'UPDATE', {space_id = info.test, index_base = 1, key = {1},
+                    tuple = {{'+', 2, 1}}, old_tuple = {1, 1}}},
+        {'UPSERT', {space_id = info.test, index_base = 1, tuple = {1, 0},
+                    operations = {{'+', 2, 1}}, old_tuple = {1, 2}}},
+        {'REPLACE', {space_id = info.test, tuple = {1, 10},
+                     old_tuple = {1, 3}}},
+        {'DELETE', {space_id = info.test, key = {1}, old_tuple = {1, 10}}},
+    })
+    t.assert_equals(read_rows(cg, info.lsn, info.other), {
+        {'INSERT', {space_id = info.other, tuple = {1, 1}}},
+        {'UPDATE', {space_id = info.other, index_base = 1, key = {1},
+                    tuple = {{'+', 2, 1}}, new_tuple = {1, 2}}},
+        {'UPSERT', {space_id = info.other, index_base = 1,
+                    tuple = {1, 0},
+                    operations = {{'+', 2, 1}}, new_tuple = {1, 3}}},
+        {'REPLACE', {space_id = info.other, tuple = {1, 10}}},
+        {'DELETE', {space_id = info.other, key = {1}}},
+    })
+end
+
+g.test_wal_ext_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_ext': " ..
+            "unexpected option 'foo' in wal_ext",
+            box.cfg, {wal_ext = {foo = true}})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_ext': " ..
+            "wal_ext.spaces.test.old should be a boolean",
+            box.cfg, {wal_ext = {spaces = {test = {old = 1}}}})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'wal_ext': " ..
+            "wal_ext.spaces should be a table",
+            box.cfg, {wal_ext = {spaces = 'test'}})
+        t.assert(box.cfg.wal_ext == nil)
+    end)
+end
@@ -165,6 +165,7 @@ local expected = {
     rtree_indices = 0,
     hash_indices = 0,
     bitset_indices = 0,
+    art_indices = 0,
     jsonpath_indices = 0,
     jsonpath_multikey_indices = 0,
     functional_indices = 0,
@@ -181,6 +182,7 @@ box.space.features_vinyl:create_index('vinyl_pk', {type = 'tree', if_not_exists
 box.space.features_memtx:create_index('memtx_pk', {type = 'tree', if_not_exists = true})
 box.space.features_memtx:create_index('memtx_hash', {type = 'hash', if_not_exists = true})
 box.space.features_memtx:create_index('memtx_bitset', {type = 'bitset', if_not_exists = true})
+box.space.features_memtx:create_index('memtx_art', {type = 'art', if_not_exists = true})
 box.schema.create_space('features_sync', {is_sync=true, if_not_exists=true})
 box.space.features_memtx:create_index('memtx_rtree',
         {type = 'rtree', parts = {{field = 3, type = 'array'}}, if_not_exists = true})
@@ -207,7 +209,7 @@ box.space.features_memtx:create_index('functional_multikey',
 actual = daemon.generate_feedback()
 local schema_stats = actual.features.schema
 test:test('features.schema', function(t)
-    t:plan(13)
+    t:plan(14)
     t:is(schema_stats.memtx_spaces, 3, 'memtx engine usage gathered')
     t:is(schema_stats.vinyl_spaces, 1, 'vinyl engine usage gathered')
     t:is(schema_stats.temporary_spaces, 1, 'temporary space usage gathered')
@@ -217,6 +219,7 @@ test:test('features.schema', function(t)
     t:is(schema_stats.hash_indices, 1, 'hash index gathered')
     t:is(schema_stats.rtree_indices, 1, 'rtree index gathered')
     t:is(schema_stats.bitset_indices, 1, 'bitset index gathered')
+    t:is(schema_stats.art_indices, 1, 'art index gathered')
     t:is(schema_stats.jsonpath_indices, 2, 'jsonpath index gathered')
     t:is(schema_stats.jsonpath_multikey_indices, 1, 'jsonpath multikey index gathered')
     t:is(schema_stats.functional_indices, 2, 'functional index gathered')
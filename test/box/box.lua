@@ -27,15 +27,6 @@ local _enterprise_keys = {
     audit_filter = true,
     audit_spaces = true,
     audit_extract_key = true,
-    flightrec_enabled = true,
-    flightrec_logs_size = true,
-    flightrec_logs_max_msg_size = true,
-    flightrec_logs_log_level = true,
-    flightrec_metrics_interval = true,
-    flightrec_metrics_period = true,
-    flightrec_requests_size = true,
-    flightrec_requests_max_req_size = true,
-    flightrec_requests_max_res_size = true,
     auth_delay = true,
     auth_retries = true,
     disable_guest = true,
@@ -47,7 +38,6 @@ local _enterprise_keys = {
     password_enforce_digits = true,
     password_enforce_specialchars = true,
     password_history_length = true,
-    wal_ext = true,
     wal_retention_period = true,
 }
 
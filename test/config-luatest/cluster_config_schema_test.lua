@@ -145,7 +145,7 @@ g.test_defaults = function()
                 enabled = false,
             },
         },
-        flightrec = is_enterprise and {
+        flightrec = {
             enabled = false,
             logs_log_level = 6,
             logs_max_msg_size = 4096,
@@ -155,7 +155,7 @@ g.test_defaults = function()
             requests_max_req_size = 16384,
             requests_max_res_size = 16384,
             requests_size = 10485760,
-        } or nil,
+        },
         sql = {
             cache_size = 5242880,
         },
@@ -171,12 +171,15 @@ g.test_defaults = function()
             nonblock = false,
             level = 5,
             format = 'plain',
+            async = false,
+            async_overflow = 'block',
         },
         snapshot = {
             dir = 'var/lib/{{ instance_name }}',
             by = {
                 interval = 3600,
                 wal_size = 1000000000000000000,
+                recovery_time = 0,
             },
             count = 2,
             snap_io_rate_limit = box.NULL,
@@ -186,7 +189,14 @@ g.test_defaults = function()
                 client = box.NULL,
             },
             threads = 1,
+            reuseport = false,
+            cpu_affinity = box.NULL,
             net_msg_max = 768,
+            read_view_interval = 0,
+            compression_threshold = 16384,
+            busy_poll = 0,
+            slow_request_threshold = 0,
+            wait_vclock_timeout = 1,
             readahead = 16320,
         },
         process = {
@@ -197,15 +207,20 @@ g.test_defaults = function()
             username = box.NULL,
             work_dir = box.NULL,
             pid_file = 'var/run/{{ instance_name }}/tarantool.pid',
+            cpu_affinity = box.NULL,
         },
         vinyl = {
             dir = 'var/lib/{{ instance_name }}',
             max_tuple_size = 1048576,
             bloom_fpr = 0.05,
             page_size = 8192,
+            page_cache = 0,
+            os_cache = true,
             range_size = box.NULL,
             run_count_per_level = 2,
             run_size_ratio = 3.5,
+            read_ahead = 0,
+            read_latency_budget = 0,
             read_threads = 1,
             write_threads = 4,
             cache = 134217728,
@@ -228,14 +243,18 @@ g.test_defaults = function()
             threads = 1,
             timeout = 1,
             synchro_timeout = 5,
+            synchro_confirm_delay = 0,
             connect_timeout = 30,
             sync_timeout = 0,
             sync_lag = 10,
             synchro_quorum = 'N / 2 + 1',
             skip_conflict = false,
+            apply_workers = 1,
+            compression = 0,
             election_mode = box.NULL,
             election_timeout = 5,
             election_fencing_mode = 'soft',
+            election_lease_max_drift = box.NULL,
             bootstrap_strategy = 'auto',
         },
         wal = {
@@ -244,7 +263,9 @@ g.test_defaults = function()
             max_size = 268435456,
             dir_rescan_delay = 2,
             queue_max_size = 16777216,
+            ring_size = 0,
             cleanup_delay = 14400,
+            cpu_affinity = box.NULL,
             retention_period = is_enterprise and 0 or nil,
         },
         console = {
@@ -259,6 +280,14 @@ g.test_defaults = function()
             min_tuple_size = 16,
             max_tuple_size = 1048576,
             sort_threads = box.NULL,
+            numa_node = box.NULL,
+            use_huge_pages = false,
+            checkpoint_delta_count = 0,
+            snapshot_compress_threads = 1,
+            snapshot_compression_level = 3,
+            ddl_rate_limit = 0,
+            snapshot_index_order = false,
+            background_index_build = false,
         },
         config = {
             reload = 'auto',
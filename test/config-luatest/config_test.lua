@@ -626,7 +626,6 @@ g.test_bootstrap_leader = function(g)
 end
 
 g.test_flightrec_options = function()
-    t.tarantool.skip_if_not_enterprise()
     local dir = treegen.prepare_directory(g, {}, {})
     local config = [[
         credentials:
@@ -174,6 +174,7 @@ g.test_process = function()
             username = 'two',
             work_dir = 'three',
             pid_file = 'four',
+            cpu_affinity = '0-1',
         },
     }
     instance_config:validate(iconfig)
@@ -187,6 +188,7 @@ g.test_process = function()
         username = box.NULL,
         work_dir = box.NULL,
         pid_file = 'var/run/{{ instance_name }}/tarantool.pid',
+        cpu_affinity = box.NULL,
     }
     local res = instance_config:apply_default({}).process
     t.assert_equals(res, exp)
@@ -258,6 +260,8 @@ g.test_log = function()
             nonblock = true,
             level = 'debug',
             format = 'json',
+            async = true,
+            async_overflow = 'drop',
             modules = {
                 seven = 'debug',
             },
@@ -296,6 +300,8 @@ g.test_log = function()
         nonblock = false,
         level = 5,
         format = 'plain',
+        async = false,
+        async_overflow = 'block',
     }
     local res = instance_config:apply_default({}).log
     t.assert_equals(res, exp)
@@ -424,7 +430,14 @@ g.test_iproto = function()
                 },
             },
             threads = 1,
+            reuseport = true,
+            cpu_affinity = '0',
             net_msg_max = 1,
+            read_view_interval = 1,
+            compression_threshold = 1,
+            busy_poll = 1,
+            slow_request_threshold = 1,
+            wait_vclock_timeout = 1,
             readahead = 1,
         },
     }
@@ -436,7 +449,14 @@ g.test_iproto = function()
             client = box.NULL,
         },
         threads = 1,
+        reuseport = false,
+        cpu_affinity = box.NULL,
         net_msg_max = 768,
+        read_view_interval = 0,
+        compression_threshold = 16384,
+        busy_poll = 0,
+        slow_request_threshold = 0,
+        wait_vclock_timeout = 1,
         readahead = 16320,
     }
     local res = instance_config:apply_default({}).iproto
@@ -491,7 +511,14 @@ g.test_iproto_enterprise = function()
                 },
             },
             threads = 1,
+            reuseport = true,
+            cpu_affinity = '0',
             net_msg_max = 1,
+            read_view_interval = 1,
+            compression_threshold = 1,
+            busy_poll = 1,
+            slow_request_threshold = 1,
+            wait_vclock_timeout = 1,
             readahead = 1,
         },
     }
@@ -503,7 +530,14 @@ g.test_iproto_enterprise = function()
             client = box.NULL,
         },
         threads = 1,
+        reuseport = false,
+        cpu_affinity = box.NULL,
         net_msg_max = 768,
+        read_view_interval = 0,
+        compression_threshold = 16384,
+        busy_poll = 0,
+        slow_request_threshold = 0,
+        wait_vclock_timeout = 1,
         readahead = 16320,
     }
     local res = instance_config:apply_default({}).iproto
@@ -963,6 +997,14 @@ g.test_memtx = function()
             min_tuple_size = 1,
             max_tuple_size = 1,
             sort_threads = 1,
+            numa_node = 1,
+            use_huge_pages = true,
+            checkpoint_delta_count = 1,
+            snapshot_compress_threads = 1,
+            snapshot_compression_level = 3,
+            ddl_rate_limit = 0,
+            snapshot_index_order = true,
+            background_index_build = true,
         },
     }
     instance_config:validate(iconfig)
@@ -976,6 +1018,14 @@ g.test_memtx = function()
         min_tuple_size = 16,
         max_tuple_size = 1048576,
         sort_threads = box.NULL,
+        numa_node = box.NULL,
+        use_huge_pages = false,
+        checkpoint_delta_count = 0,
+        snapshot_compress_threads = 1,
+        snapshot_compression_level = 3,
+        ddl_rate_limit = 0,
+        snapshot_index_order = false,
+        background_index_build = false,
     }
     local res = instance_config:apply_default({}).memtx
     t.assert_equals(res, exp)
@@ -988,9 +1038,13 @@ g.test_vinyl = function()
             max_tuple_size = 1,
             bloom_fpr = 0.1,
             page_size = 123,
+            page_cache = 1024,
+            os_cache = false,
             range_size = 321,
             run_count_per_level = 11,
             run_size_ratio = 1.15,
+            read_ahead = 65536,
+            read_latency_budget = 0.05,
             read_threads = 7,
             write_threads = 9,
             cache = 10,
@@ -1007,9 +1061,13 @@ g.test_vinyl = function()
         max_tuple_size = 1048576,
         bloom_fpr = 0.05,
         page_size = 8192,
+        page_cache = 0,
+        os_cache = true,
         range_size = box.NULL,
         run_count_per_level = 2,
         run_size_ratio = 3.5,
+        read_ahead = 0,
+        read_latency_budget = 0,
         read_threads = 1,
         write_threads = 4,
         cache = 134217728,
@@ -1030,7 +1088,19 @@ g.test_wal = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            ring_size = 1,
             cleanup_delay = 1,
+            cpu_affinity = '0',
+            ext = {
+                old = true,
+                new = false,
+                spaces = {
+                    one = {
+                        old = false,
+                        new = true,
+                    },
+                },
+            },
         },
     }
     instance_config:validate(iconfig)
@@ -1042,7 +1112,9 @@ g.test_wal = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        ring_size = 0,
         cleanup_delay = 14400,
+        cpu_affinity = box.NULL,
     }
     local res = instance_config:apply_default({}).wal
     t.assert_equals(res, exp)
@@ -1057,7 +1129,9 @@ g.test_wal_enterprise = function()
             max_size = 1,
             dir_rescan_delay = 1,
             queue_max_size = 1,
+            ring_size = 1,
             cleanup_delay = 1,
+            cpu_affinity = '0',
             retention_period = 1,
             ext = {
                 old = true,
@@ -1080,7 +1154,9 @@ g.test_wal_enterprise = function()
         max_size = 268435456,
         dir_rescan_delay = 2,
         queue_max_size = 16777216,
+        ring_size = 0,
         cleanup_delay = 14400,
+        cpu_affinity = box.NULL,
         retention_period = 0,
     }
     local res = instance_config:apply_default({}).wal
@@ -1094,6 +1170,7 @@ g.test_snapshot = function()
             by = {
                 interval = 1,
                 wal_size = 1,
+                recovery_time = 1,
             },
             count = 1,
             snap_io_rate_limit = 1,
@@ -1107,6 +1184,7 @@ g.test_snapshot = function()
         by = {
             interval = 3600,
             wal_size = 1000000000000000000,
+            recovery_time = 0,
         },
         count = 2,
         snap_io_rate_limit = box.NULL,
@@ -1124,14 +1202,18 @@ g.test_replication = function()
             threads = 1,
             timeout = 1,
             synchro_timeout = 1,
+            synchro_confirm_delay = 1,
             connect_timeout = 1,
             sync_timeout = 1,
             sync_lag = 1,
             synchro_quorum = 1,
             skip_conflict = true,
+            apply_workers = 2,
+            compression = 1,
             election_mode = 'off',
             election_timeout = 1,
             election_fencing_mode = 'off',
+            election_lease_max_drift = 0.05,
             bootstrap_strategy = 'auto',
         },
     }
@@ -1145,14 +1227,18 @@ g.test_replication = function()
         threads = 1,
         timeout = 1,
         synchro_timeout = 5,
+        synchro_confirm_delay = 0,
         connect_timeout = 30,
         sync_timeout = 0,
         sync_lag = 10,
         synchro_quorum = 'N / 2 + 1',
         skip_conflict = false,
+        apply_workers = 1,
+        compression = 0,
         election_mode = box.NULL,
         election_timeout = 5,
         election_fencing_mode = 'soft',
+        election_lease_max_drift = box.NULL,
         bootstrap_strategy = 'auto',
     }
     local res = instance_config:apply_default({}).replication
@@ -1340,6 +1426,11 @@ g.test_box_cfg_coverage = function()
         -- actually it means false.
         log_nonblock = true,
         audit_nonblock = true,
+        -- box.cfg.log_async and box.cfg.log_async_overflow are
+        -- set to nil by default, but actually it means false and
+        -- 'block'.
+        log_async = true,
+        log_async_overflow = true,
 
         -- Adjusted to use {{ instance_name }}.
         custom_proc_title = true,
@@ -1484,7 +1575,6 @@ g.test_feedback_disabled = function()
 end
 
 g.test_flightrec = function()
-    t.tarantool.skip_if_not_enterprise()
     local iconfig = {
         flightrec = {
             enabled = false,
@@ -444,6 +444,33 @@ g.test_call = function(g)
 
         opts = {roles = {'one'}, groups = {'group-001'}}
         t.assert_equals(connpool.call('f1', nil, opts), 'instance-001')
+
+        -- Make sure map_call() calls all the candidates.
+        t.assert_equals(connpool.map_call('f1', nil, {roles = {'one'}}), {
+            ['instance-001'] = 'instance-001',
+            ['instance-003'] = 'instance-003',
+            ['instance-004'] = 'instance-004',
+        })
+        opts = {
+            roles = {'one'},
+            reduce = function(acc, res) return acc + res end,
+            initial = 0,
+        }
+        t.assert_equals(connpool.map_call('f2', {1, 2, 3}, opts), 21)
+
+        local exp_err = "Couldn't execute function f1 on instance " ..
+                        "\"instance-002\": Procedure 'f1' is not defined"
+        t.assert_error_msg_equals(exp_err, connpool.map_call, 'f1')
+        local res, errors = connpool.map_call('f1', nil, {partial = true})
+        t.assert_equals(res, {
+            ['instance-001'] = 'instance-001',
+            ['instance-003'] = 'instance-003',
+            ['instance-004'] = 'instance-004',
+        })
+        t.assert_equals(next(errors), 'instance-002')
+        t.assert_equals(next(errors, 'instance-002'), nil)
+        t.assert_equals(errors['instance-002'].message,
+                        "Procedure 'f1' is not defined")
     end
 
     g.server_1:exec(check)
@@ -575,6 +602,26 @@ g.test_call_mode = function(g)
                         '"prefer_rw", got "something"'
         opts = {mode = 'something'}
         t.assert_error_msg_equals(exp_err, connpool.call, 'f', nil, opts)
+
+        -- Make sure 'least_loaded' balancing avoids slow instances.
+        opts = {
+            mode = 'ro',
+            prefer_local = false,
+            balance = 'least_loaded',
+        }
+        exp_list = {'instance-002', 'instance-004'}
+        t.assert_items_include(exp_list, {connpool.call('f', nil, opts)})
+        local conn = connpool.connect('instance-002')
+        conn._latency = 100
+        for _ = 1, 10 do
+            t.assert_equals(connpool.call('f', nil, opts), 'instance-004')
+        end
+        conn._latency = nil
+        t.assert_equals(connpool.connect('instance-004')._in_flight, 0)
+
+        exp_err = 'Expected nil, "random" or "least_loaded", got "something"'
+        opts = {balance = 'something'}
+        t.assert_error_msg_equals(exp_err, connpool.call, 'f', nil, opts)
     end
 
     g.server_1:exec(check)
@@ -0,0 +1,90 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.relay = cg.replica_set:build_and_add_server{
+        alias = 'relay',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('master', cg.replica_set.id),
+            },
+            replication_anon = true,
+            read_only = true,
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('relay', cg.replica_set.id),
+            },
+            replication_anon = true,
+            read_only = true,
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.relay:wait_for_vclock_of(cg.master)
+    cg.replica:wait_for_vclock_of(cg.relay)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+-- An anonymous replica relays rows onward to another anonymous replica.
+g.test_cascade = function(cg)
+    cg.master:exec(function()
+        for i = 1, 10 do
+            box.space.test:replace{i}
+        end
+    end)
+    cg.relay:wait_for_vclock_of(cg.master)
+    cg.replica:wait_for_vclock_of(cg.relay)
+    cg.replica:exec(function()
+        t.assert_equals(box.info.id, 0)
+        t.assert_equals(box.space.test:count(), 10)
+    end)
+    cg.master:exec(function()
+        t.assert_equals(box.space._cluster:len(), 1)
+    end)
+end
+
+-- Anonymous followers hold WALs while they are subscribed.
+g.test_gc = function(cg)
+    local function check_consumers(instance, count)
+        instance:exec(function(count)
+            t.helpers.retrying({}, function()
+                local found = 0
+                for _, c in ipairs(box.info.gc().consumers) do
+                    if c.name:startswith('anonymous replica') then
+                        found = found + 1
+                    end
+                end
+                t.assert_equals(found, count)
+            end)
+        end, {count})
+    end
+    check_consumers(cg.master, 1)
+    check_consumers(cg.relay, 1)
+    cg.replica:stop()
+    check_consumers(cg.relay, 0)
+    cg.replica:start()
+    cg.replica:wait_for_vclock_of(cg.relay)
+    check_consumers(cg.relay, 1)
+end
@@ -0,0 +1,94 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('master', cg.replica_set.id),
+            },
+            replication_timeout = 0.1,
+            replication_apply_workers = 4,
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        for _, engine in ipairs({'memtx', 'vinyl'}) do
+            local s = box.schema.space.create(engine, {engine = engine})
+            s:create_index('pk')
+            s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+            s = box.schema.space.create(engine .. '_uniq', {engine = engine})
+            s:create_index('pk')
+            s:create_index('sk', {parts = {2, 'unsigned'}})
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        t.assert_equals(box.cfg.replication_apply_workers, 4)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_apply_workers': " ..
+            "must be greater than 0",
+            box.cfg, {replication_apply_workers = 0})
+    end)
+end
+
+-- Transactions modifying the same keys are applied in order.
+g.test_apply = function(cg)
+    cg.master:exec(function()
+        local spaces = {'memtx', 'vinyl', 'memtx_uniq', 'vinyl_uniq'}
+        local fiber = require('fiber')
+        local fibers = {}
+        for f = 1, 10 do
+            fibers[f] = fiber.new(function()
+                for i = 1, 100 do
+                    local s = box.space[spaces[(f + i) % #spaces + 1]]
+                    local k = (f * i) % 7
+                    box.begin()
+                    s:replace{k, f * 1000 + i}
+                    if not s.index.sk.unique then
+                        s:upsert({k + 1, 0}, {{'+', 2, 1}})
+                    end
+                    if i % 5 == 0 then
+                        s:delete{k + 2}
+                    end
+                    box.commit()
+                end
+            end)
+            fibers[f]:set_joinable(true)
+        end
+        for _, f in ipairs(fibers) do
+            f:join()
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    local spaces = {'memtx', 'vinyl', 'memtx_uniq', 'vinyl_uniq'}
+    for _, name in ipairs(spaces) do
+        local data = cg.master:exec(function(name)
+            return box.space[name]:select()
+        end, {name})
+        cg.replica:exec(function(name, data)
+            t.assert_equals(box.space[name]:select(), data)
+        end, {name, data})
+    end
+    cg.replica:exec(function(id)
+        t.assert_equals(box.info.replication[id].upstream.status, 'follow')
+    end, {cg.master:get_instance_id()})
+end
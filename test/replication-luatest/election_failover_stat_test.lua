@@ -0,0 +1,64 @@
+local t = require('luatest')
+local cluster = require('luatest.replica_set')
+local server = require('luatest.server')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    local cfg = {
+        replication = {
+            server.build_listen_uri('node1', cg.cluster.id),
+            server.build_listen_uri('node2', cg.cluster.id),
+        },
+        replication_timeout = 0.1,
+        election_mode = 'manual',
+    }
+    cg.node1 = cg.cluster:build_and_add_server({alias = 'node1', box_cfg = cfg})
+    cg.node2 = cg.cluster:build_and_add_server({alias = 'node2', box_cfg = cfg})
+    cg.cluster:start()
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+--
+-- Checks that box.info.election.failover shows the timings of the last
+-- promotion of the instance.
+--
+g.test_failover_stat = function(cg)
+    cg.node1:exec(function()
+        t.assert_equals(box.info.election.failover, nil)
+        box.ctl.promote()
+        t.helpers.retrying({}, function()
+            t.assert_not(box.info.ro)
+        end)
+        local info = box.info.election
+        local stat = info.failover
+        t.assert_equals(stat.term, info.term)
+        for _, k in ipairs({'election_time', 'limbo_wait_time',
+                            'promote_time', 'total_time'}) do
+            t.assert_ge(stat[k], 0, k)
+        end
+        t.assert_ge(stat.total_time, stat.limbo_wait_time + stat.promote_time)
+    end)
+    cg.node2:exec(function()
+        t.assert_equals(box.info.election.failover, nil)
+    end)
+    -- The stat is kept after the leadership is lost.
+    local term = cg.node1:exec(function()
+        return box.info.election.failover.term
+    end)
+    cg.node2:exec(function()
+        box.ctl.promote()
+        t.helpers.retrying({}, function()
+            t.assert_not(box.info.ro)
+        end)
+        t.assert_gt(box.info.election.failover.term, 0)
+    end)
+    cg.node1:wait_for_election_state('follower')
+    cg.node1:exec(function(term)
+        t.assert_equals(box.info.election.failover.term, term)
+    end, {term})
+end
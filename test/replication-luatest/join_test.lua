@@ -64,3 +64,49 @@ g.test_fetch_self_delete_during_final_join = function(lg)
         box.space._cluster:delete{replica_id}
     end, {replica_id})
 end
+
+--
+-- A replica restarted after maintenance recovers from its own checkpoint and
+-- fetches only the rows written since then from the master WALs, which are
+-- retained for it by the garbage collector, without re-join.
+--
+g.test_restart_without_rejoin = function(lg)
+    lg.master:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        s:replace{1}
+    end)
+    local box_cfg = table.deepcopy(lg.master.box_cfg)
+    box_cfg.replication = {lg.master.net_box_uri}
+    local replica = server:new({
+        alias = 'replica',
+        box_cfg = box_cfg,
+    })
+    replica:start()
+    replica:wait_for_vclock_of(lg.master)
+    replica:exec(function()
+        box.snapshot()
+    end)
+    replica:stop()
+    lg.master:exec(function()
+        local checkpoint_count = box.cfg.checkpoint_count
+        box.cfg{checkpoint_count = 1}
+        for i = 2, 3 do
+            box.space.test:replace{i}
+            box.snapshot()
+        end
+        box.cfg{checkpoint_count = checkpoint_count}
+    end)
+    replica:start()
+    replica:wait_for_vclock_of(lg.master)
+    t.assert_not(replica:grep_log('bootstrapping replica from'))
+    local replica_id = replica:exec(function()
+        t.assert_equals(box.space.test:select(), {{1}, {2}, {3}})
+        return box.info.id
+    end)
+    replica:drop()
+    lg.master:exec(function(replica_id)
+        box.space.test:drop()
+        box.space._cluster:delete{replica_id}
+    end, {replica_id})
+end
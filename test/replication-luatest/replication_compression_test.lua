@@ -0,0 +1,118 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('master', cg.replica_set.id),
+            },
+            replication_timeout = 0.1,
+            replication_compression = 3,
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        t.assert_equals(box.cfg.replication_compression, 3)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'replication_compression'",
+            box.cfg, {replication_compression = -1})
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'replication_compression'",
+            box.cfg, {replication_compression = 100})
+    end)
+end
+
+local function check_replication(cg)
+    cg.master:exec(function()
+        box.begin()
+        for i = 1, 100 do
+            box.space.test:replace{i, string.rep('x', 1000)}
+        end
+        box.commit()
+        for i = 1, 100 do
+            box.space.test:replace{i, string.rep(tostring(i), 100)}
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:count(), 100)
+        for i = 1, 100 do
+            t.assert_equals(box.space.test:get(i),
+                            {i, string.rep(tostring(i), 100)})
+        end
+    end)
+end
+
+-- Rows are compressed by the relay and decompressed by the applier.
+g.test_replication = function(cg)
+    check_replication(cg)
+    local id = cg.master:get_instance_id()
+    local upstream = cg.replica:exec(function(id)
+        return box.info.replication[id].upstream.compression
+    end, {id})
+    t.assert_equals(upstream.level, 3)
+    t.assert_gt(upstream.compressed_bytes, 0)
+    t.assert_gt(upstream.bytes, upstream.compressed_bytes * 10)
+    id = cg.replica:get_instance_id()
+    local downstream = cg.master:exec(function(id)
+        return box.info.replication[id].downstream.compression
+    end, {id})
+    t.assert_equals(downstream.level, 3)
+    t.assert_ge(downstream.bytes, upstream.bytes)
+    t.assert_ge(downstream.compressed_bytes, upstream.compressed_bytes)
+end
+
+-- The new level takes effect on resubscribe. A new zstd stream is
+-- started on each subscribe.
+g.test_reconnect = function(cg)
+    local replication = cg.replica:exec(function()
+        local replication = box.cfg.replication
+        box.cfg{replication = {}}
+        box.cfg{replication_compression = 0}
+        box.cfg{replication = replication}
+        return replication
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    check_replication(cg)
+    cg.replica:exec(function(id)
+        local upstream = box.info.replication[id].upstream
+        t.assert_equals(upstream.status, 'follow')
+        t.assert_equals(upstream.compression, nil)
+    end, {cg.master:get_instance_id()})
+    cg.replica:exec(function(replication)
+        box.cfg{replication = {}}
+        box.cfg{replication_compression = 1}
+        box.cfg{replication = replication}
+    end, {replication})
+    cg.replica:wait_for_vclock_of(cg.master)
+    check_replication(cg)
+    cg.replica:exec(function(id)
+        local upstream = box.info.replication[id].upstream
+        t.assert_equals(upstream.status, 'follow')
+        t.assert_equals(upstream.compression.level, 1)
+    end, {cg.master:get_instance_id()})
+end
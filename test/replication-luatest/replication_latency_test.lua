@@ -0,0 +1,67 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('master', cg.replica_set.id),
+            },
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+local function check_latency(latency, stages)
+    for _, stage in ipairs(stages) do
+        local l = latency[stage]
+        t.assert_type(l, 'table', stage)
+        t.assert_ge(l.p50, 0, stage)
+        t.assert_ge(l.p99, l.p50, stage)
+    end
+end
+
+g.test_latency = function(cg)
+    cg.master:exec(function()
+        for i = 1, 100 do
+            box.space.test:replace{i}
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    local latency = cg.replica:exec(function(id)
+        return box.info.replication[id].upstream.latency
+    end, {cg.master:get_instance_id()})
+    check_latency(latency, {'network', 'decode', 'wal'})
+    local id = cg.replica:get_instance_id()
+    cg.master:exec(function(id)
+        t.helpers.retrying({}, function()
+            local latency = box.info.replication[id].downstream.latency
+            t.assert_gt(latency.ack.p99, 0)
+        end)
+    end, {id})
+    latency = cg.master:exec(function(id)
+        return box.info.replication[id].downstream.latency
+    end, {id})
+    check_latency(latency, {'send', 'ack'})
+end
@@ -0,0 +1,108 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+            replication_synchro_quorum = 2,
+            replication_synchro_timeout = 120,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('master', cg.replica_set.id),
+            },
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        box.schema.space.create('test', {is_sync = true})
+        box.space.test:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+g.after_each(function(cg)
+    cg.master:exec(function()
+        box.cfg{replication_synchro_confirm_delay = 0}
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.master:exec(function()
+        t.assert_equals(box.cfg.replication_synchro_confirm_delay, 0)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option " ..
+            "'replication_synchro_confirm_delay': " ..
+            "the value must be greater than or equal to zero",
+            box.cfg, {replication_synchro_confirm_delay = -1})
+    end)
+end
+
+-- Commits the given number of synchronous transactions concurrently
+-- and returns the number of CONFIRM requests written by the master.
+local function commit_sync_txns(cg, count)
+    return cg.master:exec(function(count)
+        local fiber = require('fiber')
+        local fio = require('fio')
+        local xlog = require('xlog')
+        local function count_confirms()
+            local confirms = 0
+            for _, path in ipairs(fio.glob(box.cfg.wal_dir .. '/*.xlog')) do
+                for _, row in xlog.pairs(path) do
+                    if row.HEADER.type == 'CONFIRM' then
+                        confirms = confirms + 1
+                    end
+                end
+            end
+            return confirms
+        end
+        local confirms = count_confirms()
+        local fibers = {}
+        for i = 1, count do
+            fibers[i] = fiber.new(box.space.test.insert, box.space.test, {i})
+            fibers[i]:set_joinable(true)
+        end
+        for i = 1, count do
+            t.assert((fibers[i]:join()))
+        end
+        t.assert_equals(box.space.test:count(), count)
+        t.assert_equals(box.info.synchro.queue.len, 0)
+        return count_confirms() - confirms
+    end, {count})
+end
+
+-- ACKs received while a CONFIRM is written are confirmed together.
+g.test_batch = function(cg)
+    local confirms = commit_sync_txns(cg, 100)
+    t.assert_ge(confirms, 1)
+    t.assert_le(confirms, 100)
+end
+
+-- CONFIRM is delayed to collect more ACKs.
+g.test_delay = function(cg)
+    cg.master:exec(function()
+        box.cfg{replication_synchro_confirm_delay = 0.5}
+    end)
+    local confirms = commit_sync_txns(cg, 100)
+    t.assert_ge(confirms, 1)
+    t.assert_le(confirms, 5)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.test:count(), 100)
+    end)
+end
@@ -0,0 +1,121 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+            wal_ring_size = 1024 * 1024,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('master', cg.replica_set.id),
+            },
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica_set:start()
+    cg.master:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+g.after_each(function(cg)
+    cg.master:exec(function()
+        box.cfg{wal_ring_size = 1024 * 1024}
+        box.space.test:truncate()
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.test_cfg = function(cg)
+    cg.master:exec(function()
+        t.assert_equals(box.cfg.wal_ring_size, 1024 * 1024)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_ring_size': " ..
+            "wal_ring_size must be >= 0",
+            box.cfg, {wal_ring_size = -1})
+    end)
+end
+
+local function check_replication(cg, count)
+    cg.master:exec(function(count)
+        box.begin()
+        for i = 1, count do
+            box.space.test:replace{i, string.rep('x', 100)}
+        end
+        box.commit()
+        for i = 1, count do
+            box.space.test:replace{i, i}
+        end
+    end, {count})
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function(count)
+        t.assert_equals(box.space.test:count(), count)
+        for i = 1, count do
+            t.assert_equals(box.space.test:get(i), {i, i})
+        end
+    end, {count})
+end
+
+-- The relay sends rows from the ring.
+g.test_replication = function(cg)
+    check_replication(cg, 100)
+end
+
+-- The relay falls back on WAL files if rows are evicted from the ring
+-- and switches back to the ring once it catches up.
+g.test_small_ring = function(cg)
+    cg.master:exec(function()
+        box.cfg{wal_ring_size = 1000}
+    end)
+    check_replication(cg, 100)
+    check_replication(cg, 1)
+end
+
+-- The relay falls back on WAL files if the ring is disabled.
+g.test_disable = function(cg)
+    check_replication(cg, 10)
+    cg.master:exec(function()
+        box.cfg{wal_ring_size = 0}
+    end)
+    check_replication(cg, 20)
+    cg.master:exec(function()
+        box.cfg{wal_ring_size = 1024 * 1024}
+    end)
+    check_replication(cg, 30)
+end
+
+-- WAL files sent from the ring are garbage collected.
+g.test_gc = function(cg)
+    check_replication(cg, 10)
+    cg.master:exec(function()
+        box.snapshot()
+        box.space.test:replace{1}
+        box.snapshot()
+        box.space.test:replace{2}
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.master:exec(function()
+        t.helpers.retrying({}, function()
+            local signature = box.info.gc().checkpoints[1].signature
+            for _, consumer in ipairs(box.info.gc().consumers) do
+                t.assert_ge(consumer.signature, signature)
+            end
+        end)
+    end)
+end
@@ -17,9 +17,11 @@ test_run:wait_cond(function() return next(box.info.replication) ~= nil end)
 test_run:wait_upstream(1, {status = 'follow'})
 
 test_run:switch('replica1')
--- The anonymous replica wasn't registered.
+-- The anonymous replica wasn't registered. It only has an in-memory gc
+-- consumer while it is subscribed.
 assert(box.space._cluster:len() == 1)
-box.info.gc().consumers
+consumers = box.info.gc().consumers
+#consumers == 1 and consumers[1].name:startswith('anonymous replica')
 box.info.replication_anon.count == 1
 
 test_run:switch('default')
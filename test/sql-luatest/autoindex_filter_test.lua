@@ -0,0 +1,88 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE t1 (id INTEGER PRIMARY KEY, i INTEGER,
+                                       d DOUBLE, s STRING);]])
+        box.execute([[CREATE TABLE t2 (id INTEGER PRIMARY KEY, i INTEGER,
+                                       s STRING,
+                                       c STRING COLLATE "unicode_ci");]])
+        for i = 1, 100 do
+            box.execute('INSERT INTO t1 VALUES (?, ?, ?, ?);',
+                        {i, i * 3, i * 1.5, 'S' .. i})
+            box.execute('INSERT INTO t2 VALUES (?, ?, ?, ?);',
+                        {i, i * 2, 'S' .. i * 2, 's' .. i * 2})
+        end
+        box.execute('INSERT INTO t1 VALUES (101, NULL, NULL, NULL);')
+        box.execute('INSERT INTO t2 VALUES (101, NULL, NULL, NULL);')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Joins with automatic indexes return the same rows as nested loops
+-- whether or not a bloom filter is built for the automatic index.
+g.test_autoindex_filter = function(cg)
+    cg.server:exec(function()
+        local function opcodes(sql)
+            local res = {}
+            for _, row in ipairs(box.execute('EXPLAIN ' .. sql).rows) do
+                res[row[2]] = true
+            end
+            return res
+        end
+        -- Nested loop join over the spaces for reference.
+        local function join(f1, f2, eq)
+            local res = {}
+            for _, t1 in box.space.T1:pairs() do
+                for _, t2 in box.space.T2:pairs() do
+                    if t1[f1] ~= nil and t2[f2] ~= nil and
+                       eq(t1[f1], t2[f2]) then
+                        table.insert(res, {t1[1], t2[1]})
+                    end
+                end
+            end
+            return res
+        end
+        local function raw_eq(a, b)
+            return a == b
+        end
+        local function check(column, filter, eq)
+            local sql = ('SELECT t1.id, t2.id FROM t1 JOIN t2 ' ..
+                         'ON t1.%s = t2.%s ORDER BY 1, 2;'):format(
+                         column[1], column[2])
+            local ops = opcodes(sql)
+            t.assert_equals(ops['Filter'] == true, filter, column)
+            t.assert_equals(ops['FilterAdd'] == true, filter, column)
+            local t1_fields = {i = 2, d = 3, s = 4}
+            local t2_fields = {i = 2, s = 3, c = 4}
+            local exp = join(t1_fields[column[1]], t2_fields[column[2]],
+                             eq or raw_eq)
+            local rows = box.execute(sql).rows
+            t.assert_equals(rows, exp, column)
+            return rows
+        end
+        local rows = check({'i', 'i'}, true)
+        t.assert_equals(#rows, 33)
+        t.assert_equals(rows[1], {2, 3})
+        -- Integral doubles match integers.
+        rows = check({'d', 'i'}, true)
+        t.assert_equals(#rows, 25)
+        t.assert_equals(rows[1], {4, 3})
+        rows = check({'s', 's'}, true)
+        t.assert_equals(#rows, 50)
+        -- No filter is built for a comparison with a collation.
+        rows = check({'s', 'c'}, false, function(a, b)
+            return a:lower() == b:lower()
+        end)
+        t.assert_equals(#rows, 50)
+    end)
+end
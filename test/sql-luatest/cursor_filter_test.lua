@@ -0,0 +1,97 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE t (id INTEGER PRIMARY KEY, i INTEGER,
+                                      d DOUBLE, s STRING,
+                                      c STRING COLLATE "unicode_ci",
+                                      n NUMBER);]])
+        for i = 1, 100 do
+            box.execute('INSERT INTO t VALUES (?, ?, ?, ?, ?, ?);',
+                        {i, i % 10, i / 4, 'S' .. i % 7, 's' .. i % 7,
+                         i % 3 == 0 and require('decimal').new(i % 5) or
+                         i % 5})
+        end
+        box.execute('INSERT INTO t VALUES (101, NULL, NULL, NULL, NULL, NULL);')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Comparisons of columns with constants are checked by the cursor which
+-- scans the space, and the result is the same as without them.
+g.test_cursor_filter = function(cg)
+    cg.server:exec(function()
+        local function has_filter(sql, params)
+            for _, row in ipairs(box.execute('EXPLAIN ' .. sql, params).rows) do
+                if row[2] == 'CursorFilter' then
+                    return true
+                end
+            end
+            return false
+        end
+        local function check(cond, params, filter, pred)
+            local sql = 'SELECT id FROM t WHERE ' .. cond .. ' ORDER BY id;'
+            t.assert_equals(has_filter(sql, params), filter, cond)
+            local exp = {}
+            for _, tuple in box.space.T:pairs() do
+                if pred(tuple) then
+                    table.insert(exp, {tuple[1]})
+                end
+            end
+            t.assert_equals(box.execute(sql, params).rows, exp, cond)
+        end
+        check('i = 3', nil, true, function(tuple)
+            return tuple[2] ~= nil and tuple[2] == 3
+        end)
+        check('i > ? AND d <= ?', {5, 20.5}, true, function(tuple)
+            return tuple[2] ~= nil and tuple[2] > 5 and tuple[3] <= 20.5
+        end)
+        check('3 < i AND i < 4.5', nil, true, function(tuple)
+            return tuple[2] ~= nil and tuple[2] > 3 and tuple[2] < 4.5
+        end)
+        check('s >= ?', {'S5'}, true, function(tuple)
+            return tuple[4] ~= nil and tuple[4] >= 'S5'
+        end)
+        check('n = 2', nil, true, function(tuple)
+            return tuple[6] ~= nil and tuple[6] == 2
+        end)
+        check('i = ?', {box.NULL}, true, function()
+            return false
+        end)
+        -- No filter for a comparison with a collation.
+        check("c = 'S3'", nil, false, function(tuple)
+            return tuple[5] ~= nil and tuple[5] == 's3'
+        end)
+        check('i = 3 OR i = 4', nil, false, function(tuple)
+            return tuple[2] ~= nil and (tuple[2] == 3 or tuple[2] == 4)
+        end)
+        local sql = 'SELECT id FROM t WHERE s = 1;'
+        t.assert_equals(has_filter(sql), true)
+        local _, err = box.execute(sql)
+        t.assert_str_contains(err.message, 'Type mismatch')
+    end)
+end
+
+-- Rows found with cursor filters can be updated and deleted.
+g.test_cursor_filter_dml = function(cg)
+    cg.server:exec(function()
+        box.begin()
+        box.execute('UPDATE t SET i = i + 10 WHERE i = 5;')
+        t.assert_equals(box.execute('SELECT COUNT(*) FROM t WHERE i = 5;').rows,
+                        {{0}})
+        t.assert_equals(box.execute('SELECT COUNT(*) FROM t WHERE i = 15;')
+                        .rows, {{10}})
+        box.execute('DELETE FROM t WHERE i > 10;')
+        t.assert_equals(box.execute('SELECT COUNT(*) FROM t;').rows, {{91}})
+        box.rollback()
+    end)
+end
@@ -0,0 +1,66 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INTEGER PRIMARY KEY, a INTEGER,
+                                      b INTEGER);]])
+        box.execute('CREATE INDEX ta ON t (a);')
+        box.execute('CREATE INDEX tb ON t (b);')
+        -- Column a is skewed: almost all rows share the same value.
+        box.begin()
+        for i = 1, 2000 do
+            box.space.T:insert({i, i % 100 == 0 and i or 1, i % 20})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        require('internal.tweaks').sql_index_stat = false
+    end)
+end)
+
+-- The planner uses sampled index statistics to pick the more selective
+-- index on skewed data.
+g.test_index_stat = function(cg)
+    cg.server:exec(function()
+        local sql = 'SELECT id FROM t WHERE a = 1 AND b = 5;'
+        local function plan()
+            return box.execute('EXPLAIN QUERY PLAN ' .. sql).rows[1][4]
+        end
+        local exp = {}
+        for i = 1, 2000 do
+            if i % 20 == 5 and i % 100 ~= 0 then
+                table.insert(exp, {i})
+            end
+        end
+        local tweaks = require('internal.tweaks')
+        tweaks.sql_index_stat = true
+        t.assert_str_contains(plan(), 'INDEX TB')
+        t.assert_items_equals(box.execute(sql).rows, exp)
+        -- The statistics are collected again when the index grows.
+        box.begin()
+        for i = 2001, 10000 do
+            box.space.T:insert({i, i, 1})
+        end
+        box.commit()
+        t.assert_str_contains(plan(), 'INDEX TA')
+        box.begin()
+        for i = 2001, 10000 do
+            box.space.T:delete({i})
+        end
+        box.commit()
+        t.assert_str_contains(plan(), 'INDEX TB')
+        t.assert_items_equals(box.execute(sql).rows, exp)
+    end)
+end
@@ -0,0 +1,79 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group('point_lookup', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        box.execute([[SET SESSION "sql_default_engine" = ']] .. engine ..
+                    [[';]])
+        box.execute([[CREATE TABLE t (id INTEGER PRIMARY KEY, a INTEGER,
+                                      b STRING UNIQUE, c INTEGER);]])
+        box.execute([[CREATE UNIQUE INDEX t_ac ON t (a, c);]])
+        for i = 1, 10 do
+            box.execute('INSERT INTO t VALUES (?, ?, ?, ?);',
+                        {i, i * 10, 'b' .. i, i % 3})
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.execute('DROP TABLE t;')
+    end)
+end)
+
+-- Equality lookups by all parts of a unique index return the matching row
+-- or nothing.
+g.test_select = function(cg)
+    cg.server:exec(function()
+        local sql = 'SELECT a, b FROM t WHERE id = ?;'
+        t.assert_equals(box.execute(sql, {3}).rows, {{30, 'b3'}})
+        t.assert_equals(box.execute(sql, {11}).rows, {})
+        t.assert_equals(box.execute(sql, {3.0}).rows, {{30, 'b3'}})
+        t.assert_equals(box.execute(sql, {3.5}).rows, {})
+        t.assert_equals(box.execute('SELECT id FROM t WHERE b = ?;',
+                                    {'b7'}).rows, {{7}})
+        t.assert_equals(box.execute('SELECT id FROM t WHERE a = ? AND c = ?;',
+                                    {40, 1}).rows, {{4}})
+        t.assert_equals(box.execute('SELECT id FROM t WHERE a = ? AND c = ?;',
+                                    {40, 2}).rows, {})
+        t.assert_equals(box.execute([[SELECT t1.id, t2.id FROM t AS t1
+                                      JOIN t AS t2 ON t2.id = t1.c
+                                      WHERE t1.id < 4 ORDER BY 1;]]).rows,
+                        {{1, 1}, {2, 2}})
+        local rows = box.execute([[SELECT id FROM t WHERE id IN (2, 5, 11)
+                                   ORDER BY id;]]).rows
+        t.assert_equals(rows, {{2}, {5}})
+    end)
+end
+
+-- Rows found by a point lookup can be updated and deleted.
+g.test_dml = function(cg)
+    cg.server:exec(function()
+        box.execute('UPDATE t SET a = a + 1 WHERE id = 2;')
+        box.execute("DELETE FROM t WHERE b = 'b3';")
+        box.execute('DELETE FROM t WHERE id = 11;')
+        t.assert_equals(box.execute([[SELECT id, a FROM t WHERE id < 5
+                                      ORDER BY id;]]).rows,
+                        {{1, 10}, {2, 21}, {4, 40}})
+        box.begin()
+        box.execute('DELETE FROM t WHERE id = 4;')
+        t.assert_equals(box.execute('SELECT id FROM t WHERE id = 4;').rows,
+                        {})
+        box.rollback()
+        t.assert_equals(box.execute('SELECT id FROM t WHERE id = 4;').rows,
+                        {{4}})
+    end)
+end
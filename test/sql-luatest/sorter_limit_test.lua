@@ -0,0 +1,51 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE t (id INTEGER PRIMARY KEY, a INTEGER,
+                                      b STRING);]])
+        box.begin()
+        for i = 1, 5000 do
+            box.space.T:insert({i, (i * 7919) % 97, tostring(i % 13)})
+        end
+        box.commit()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- ORDER BY with LIMIT and mixed sort directions returns the same rows as
+-- the full sort while the sorter drops rows that are past the limit.
+g.test_sorter_limit = function(cg)
+    cg.server:exec(function()
+        local all = box.execute([[SELECT a, b, id FROM t
+                                  ORDER BY a DESC, b ASC, id ASC;]]).rows
+        local function check(limit, offset)
+            local sql = [[SELECT a, b, id FROM t ORDER BY a DESC, b ASC, id ASC
+                          LIMIT ? OFFSET ?;]]
+            local rows = box.execute(sql, {limit, offset}).rows
+            local exp = {}
+            for i = offset + 1, math.min(offset + limit, #all) do
+                table.insert(exp, all[i])
+            end
+            t.assert_equals(rows, exp, {limit, offset})
+        end
+        t.assert_equals(#all, 5000)
+        check(1, 0)
+        check(10, 0)
+        check(10, 300)
+        check(300, 10)
+        check(2000, 1000)
+        check(10, 4995)
+        check(10, 6000)
+        check(0, 0)
+    end)
+end
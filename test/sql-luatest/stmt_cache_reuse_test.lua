@@ -0,0 +1,58 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[CREATE TABLE t (id INTEGER PRIMARY KEY, a INTEGER);]])
+        box.execute([[INSERT INTO t VALUES (1, 10), (2, 20), (3, 30);]])
+        box.schema.user.grant('guest', 'read,write,execute', 'universe')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Execution of SQL text reuses the statement prepared by any session
+-- and the cache statistics account hits, misses and compilation time.
+g.test_stmt_cache_reuse = function(cg)
+    local sql = 'SELECT a FROM t WHERE id = ?;'
+    local conn = cg.server.net_box
+    local stmt = conn:prepare(sql)
+    cg.server:exec(function(sql)
+        local function stat()
+            local cache = box.info.sql().cache
+            return {hits = cache.hits, misses = cache.misses}
+        end
+        t.assert_gt(box.info.sql().cache.compile_time, 0)
+        local old = stat()
+        t.assert_equals(box.execute(sql, {2}).rows, {{20}})
+        t.assert_equals(box.execute(sql, {3}).rows, {{30}})
+        t.assert_equals(stat(), {hits = old.hits + 2, misses = old.misses})
+        -- Statements with other SQL text are compiled.
+        old = stat()
+        t.assert_equals(box.execute('SELECT a FROM t WHERE id = 1;').rows,
+                        {{10}})
+        t.assert_equals(stat(), {hits = old.hits, misses = old.misses + 1})
+        -- Statements compiled with other session flags are not reused.
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        old = stat()
+        t.assert_equals(box.execute(sql, {1}).rows, {{10}})
+        t.assert_equals(stat(), {hits = old.hits, misses = old.misses + 2})
+        box.execute([[SET SESSION "sql_seq_scan" = false;]])
+        -- Expired statements are not reused.
+        box.execute('CREATE INDEX ta ON t (a);')
+        old = stat()
+        t.assert_equals(box.execute(sql, {1}).rows, {{10}})
+        t.assert_equals(stat(), {hits = old.hits, misses = old.misses + 1})
+        t.assert(box.info.sql().cache.stmt_count > 0)
+    end, {sql})
+    stmt:unprepare()
+    cg.server:exec(function()
+        t.assert_equals(box.info.sql().cache.stmt_count, 0)
+    end)
+end
@@ -0,0 +1,46 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Columns of wide tuples of different lengths are fetched correctly when
+-- the cursor moves from one tuple to another.
+g.test_wide_tuple_columns = function(cg)
+    cg.server:exec(function()
+        local format = {{'id', 'integer'}}
+        for i = 2, 100 do
+            format[i] = {'f' .. i, 'integer', is_nullable = true}
+        end
+        local s = box.schema.space.create('t', {format = format})
+        s:create_index('pk')
+        for id = 1, 10 do
+            local tuple = {id}
+            for i = 2, id * 10 do
+                tuple[i] = id * 1000 + i
+            end
+            s:insert(tuple)
+        end
+        local sql = 'SELECT f90, f70, f5, f100, f65 FROM t ORDER BY id'
+        local rows = box.execute(sql).rows
+        for id = 1, 10 do
+            local exp = {}
+            for j, i in ipairs({90, 70, 5, 100, 65}) do
+                exp[j] = i <= id * 10 and id * 1000 + i or box.NULL
+            end
+            t.assert_equals(rows[id], exp, id)
+        end
+        s:drop()
+    end)
+end
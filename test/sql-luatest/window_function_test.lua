@@ -0,0 +1,114 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE t (id INTEGER PRIMARY KEY, g INTEGER,
+                                      v INTEGER);]])
+        box.execute([[INSERT INTO t VALUES (1, 1, 10), (2, 1, 20),
+                                           (3, 1, 20), (4, 2, 5), (5, 2, 7),
+                                           (6, 3, 1);]])
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Ranking functions are computed within partitions in the window order.
+g.test_ranking = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT id,
+                      ROW_NUMBER() OVER (PARTITION BY g ORDER BY v, id),
+                      RANK() OVER (PARTITION BY g ORDER BY v, id),
+                      DENSE_RANK() OVER (PARTITION BY g ORDER BY v, id)
+                      FROM t ORDER BY id;]]
+        t.assert_equals(box.execute(sql).rows, {
+            {1, 1, 1, 1}, {2, 2, 2, 2}, {3, 3, 3, 3},
+            {4, 1, 1, 1}, {5, 2, 2, 2}, {6, 1, 1, 1},
+        })
+        sql = [[SELECT id, RANK() OVER (PARTITION BY g ORDER BY v),
+                DENSE_RANK() OVER (PARTITION BY g ORDER BY v)
+                FROM t ORDER BY id;]]
+        t.assert_equals(box.execute(sql).rows, {
+            {1, 1, 1}, {2, 2, 2}, {3, 2, 2},
+            {4, 1, 1}, {5, 2, 2}, {6, 1, 1},
+        })
+        sql = [[SELECT id, RANK() OVER (ORDER BY v DESC) FROM t
+                ORDER BY id;]]
+        t.assert_equals(box.execute(sql).rows, {
+            {1, 3}, {2, 1}, {3, 1}, {4, 5}, {5, 4}, {6, 6},
+        })
+    end)
+end
+
+-- Aggregate functions are computed over the rows from the start of the
+-- partition up to the last peer of the row, or over the whole partition if
+-- the window has no ORDER BY.
+g.test_aggregates = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT id, SUM(v) OVER (PARTITION BY g ORDER BY v),
+                      COUNT(*) OVER (PARTITION BY g ORDER BY v)
+                      FROM t ORDER BY id;]]
+        t.assert_equals(box.execute(sql).rows, {
+            {1, 10, 1}, {2, 50, 3}, {3, 50, 3},
+            {4, 5, 1}, {5, 12, 2}, {6, 1, 1},
+        })
+        sql = [[SELECT id, SUM(v) OVER (PARTITION BY g),
+                MAX(v) OVER (PARTITION BY g) FROM t ORDER BY id;]]
+        t.assert_equals(box.execute(sql).rows, {
+            {1, 50, 20}, {2, 50, 20}, {3, 50, 20},
+            {4, 12, 7}, {5, 12, 7}, {6, 1, 1},
+        })
+        sql = [[SELECT id, COUNT(*) OVER (), SUM(v) OVER () FROM t
+                WHERE g < 3 ORDER BY id;]]
+        t.assert_equals(box.execute(sql).rows, {
+            {1, 5, 62}, {2, 5, 62}, {3, 5, 62}, {4, 5, 62}, {5, 5, 62},
+        })
+    end)
+end
+
+-- Window functions work together with WHERE, LIMIT and subqueries.
+g.test_select = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT id, ROW_NUMBER() OVER (ORDER BY id) FROM t
+                      WHERE g > 1 LIMIT 2;]]
+        t.assert_equals(box.execute(sql).rows, {{4, 1}, {5, 2}})
+        sql = [[SELECT id FROM (SELECT id, ROW_NUMBER() OVER
+                (PARTITION BY g ORDER BY v DESC, id) AS rn FROM t)
+                WHERE rn = 1 ORDER BY id;]]
+        t.assert_equals(box.execute(sql).rows, {{2}, {5}, {6}})
+        sql = [[SELECT id, SUM(v) OVER (ORDER BY id) AS s FROM t
+                ORDER BY s DESC LIMIT 1;]]
+        t.assert_equals(box.execute(sql).rows, {{6, 63}})
+    end)
+end
+
+-- Unsupported uses of window functions are reported.
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local function check(sql, msg)
+            local _, err = box.execute(sql)
+            t.assert_equals(err.message, msg)
+        end
+        check([[SELECT ROW_NUMBER() FROM t;]],
+              "window function ROW_NUMBER() requires an OVER clause")
+        check([[SELECT ABS(v) OVER () FROM t;]],
+              "ABS() is not a window function")
+        check([[SELECT id FROM t WHERE ROW_NUMBER() OVER () > 1;]],
+              "misuse of window function ROW_NUMBER()")
+        check([[SELECT SUM(ROW_NUMBER() OVER ()) FROM t;]],
+              "misuse of window function ROW_NUMBER()")
+        check([[SELECT g, ROW_NUMBER() OVER () FROM t GROUP BY g;]],
+              "window functions can't be used together with GROUP BY "..
+              "or aggregate functions")
+        check([[SELECT ROW_NUMBER() OVER (ORDER BY id),
+                RANK() OVER (ORDER BY v) FROM t;]],
+              "all window functions of a SELECT must use the same window")
+    end)
+end
@@ -46,8 +46,9 @@ execute([[SET SESSION "sql_seq_scan" = true;]])
 
 -- Check default cache statistics.
 --
-box.info.sql()
-box.info:sql()
+cache = box.info.sql().cache
+cache.size, cache.stmt_count
+box.info:sql().cache.stmt_count
 
 -- Test local interface and basic capabilities of prepared statements.
 --
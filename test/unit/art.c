@@ -0,0 +1,271 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "salad/art.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+enum { KEY_LEN_MAX = 32 };
+
+struct record {
+	uint32_t len;
+	unsigned char key[KEY_LEN_MAX];
+};
+
+static size_t allocated;
+
+static void *
+test_alloc(void *ctx, size_t size)
+{
+	(void)ctx;
+	allocated += size;
+	return malloc(size);
+}
+
+static void
+test_free(void *ctx, void *ptr, size_t size)
+{
+	(void)ctx;
+	allocated -= size;
+	free(ptr);
+}
+
+static const unsigned char *
+test_key_of(void *record, uint32_t *len, void *ctx)
+{
+	(void)ctx;
+	struct record *r = record;
+	*len = r->len;
+	return r->key;
+}
+
+static int
+key_compare(const unsigned char *a, uint32_t a_len,
+	    const unsigned char *b, uint32_t b_len)
+{
+	int rc = memcmp(a, b, a_len < b_len ? a_len : b_len);
+	if (rc != 0)
+		return rc;
+	return a_len < b_len ? -1 : a_len > b_len;
+}
+
+static int
+record_compare(const void *a, const void *b)
+{
+	const struct record *r1 = *(const struct record **)a;
+	const struct record *r2 = *(const struct record **)b;
+	return key_compare(r1->key, r1->len, r2->key, r2->len);
+}
+
+static bool
+record_starts_with(const struct record *r, const unsigned char *key,
+		   uint32_t len)
+{
+	return r->len >= len && memcmp(r->key, key, len) == 0;
+}
+
+/**
+ * Generate a random key terminated with 0, which makes the keys
+ * prefix-free. A small alphabet is used to get long shared prefixes.
+ */
+static void
+random_key(unsigned char *key, uint32_t *len, bool terminate)
+{
+	uint32_t n = rand() % (KEY_LEN_MAX - 1);
+	for (uint32_t i = 0; i < n; i++)
+		key[i] = 1 + rand() % 3;
+	if (terminate)
+		key[n++] = 0;
+	*len = n;
+}
+
+/** Check seeks with a key against a sorted array of records. */
+static bool
+check_seek(struct art *tree, struct record **sorted, size_t count,
+	   const unsigned char *key, uint32_t len)
+{
+	struct record *ge = NULL, *gt = NULL, *lt = NULL, *le = NULL;
+	for (size_t i = 0; i < count; i++) {
+		struct record *r = sorted[i];
+		int cmp = key_compare(r->key, r->len, key, len);
+		bool prefix = record_starts_with(r, key, len);
+		if (cmp >= 0 && ge == NULL)
+			ge = r;
+		if (cmp > 0 && !prefix && gt == NULL)
+			gt = r;
+		if (cmp < 0)
+			lt = r;
+		if (cmp < 0 || prefix)
+			le = r;
+	}
+	return art_seek_ge(tree, key, len, false) == ge &&
+	       art_seek_ge(tree, key, len, true) == gt &&
+	       art_seek_le(tree, key, len, false) == lt &&
+	       art_seek_le(tree, key, len, true) == le;
+}
+
+static int
+collect(void *record, void *arg)
+{
+	struct record ***pos = arg;
+	*(*pos)++ = record;
+	return 0;
+}
+
+static void
+test_random(void)
+{
+	header();
+	plan(6);
+
+	enum { RECORD_COUNT = 2000, OP_COUNT = 20000 };
+	struct record *records = calloc(RECORD_COUNT, sizeof(*records));
+	bool *present = calloc(RECORD_COUNT, sizeof(*present));
+	struct record **sorted = calloc(RECORD_COUNT, sizeof(*sorted));
+	struct record **walked = calloc(RECORD_COUNT, sizeof(*walked));
+	fail_if(records == NULL || present == NULL ||
+		sorted == NULL || walked == NULL);
+	/* Generate unique keys. */
+	for (int i = 0; i < RECORD_COUNT; i++) {
+		struct record *r = &records[i];
+again:
+		random_key(r->key, &r->len, true);
+		for (int j = 0; j < i; j++) {
+			if (key_compare(r->key, r->len, records[j].key,
+					records[j].len) == 0)
+				goto again;
+		}
+	}
+
+	struct art tree;
+	art_create(&tree, test_key_of, test_alloc, test_free, NULL);
+	size_t count = 0;
+	bool insert_ok = true, delete_ok = true, find_ok = true;
+	for (int op = 0; op < OP_COUNT; op++) {
+		int i = rand() % RECORD_COUNT;
+		struct record *r = &records[i];
+		/* Prefer insertions in the first half of the test. */
+		bool insert = rand() % 4 < (op < OP_COUNT / 2 ? 3 : 1);
+		if (insert) {
+			void *replaced;
+			if (art_insert(&tree, r->key, r->len, r,
+				       &replaced) != 0 ||
+			    replaced != (present[i] ? r : NULL))
+				insert_ok = false;
+			if (!present[i])
+				count++;
+			present[i] = true;
+		} else {
+			if (art_delete(&tree, r->key, r->len) !=
+			    (present[i] ? r : NULL))
+				delete_ok = false;
+			if (present[i])
+				count--;
+			present[i] = false;
+		}
+		i = rand() % RECORD_COUNT;
+		r = &records[i];
+		if (art_find(&tree, r->key, r->len) != (present[i] ? r : NULL))
+			find_ok = false;
+	}
+	ok(insert_ok, "insert");
+	ok(delete_ok, "delete");
+	ok(find_ok, "find");
+	is(art_size(&tree), count, "size");
+
+	size_t n = 0;
+	for (int i = 0; i < RECORD_COUNT; i++) {
+		if (present[i])
+			sorted[n++] = &records[i];
+	}
+	qsort(sorted, n, sizeof(*sorted), record_compare);
+	struct record **pos = walked;
+	art_foreach(&tree, collect, &pos);
+	ok(pos - walked == (ptrdiff_t)n &&
+	   memcmp(walked, sorted, n * sizeof(*sorted)) == 0,
+	   "foreach visits records in order");
+
+	bool seek_ok = true;
+	for (int i = 0; i < 5000 && seek_ok; i++) {
+		unsigned char key[KEY_LEN_MAX];
+		uint32_t len;
+		random_key(key, &len, rand() % 2 == 0);
+		seek_ok = check_seek(&tree, sorted, n, key, len);
+	}
+	for (size_t i = 0; i < n && seek_ok; i++)
+		seek_ok = check_seek(&tree, sorted, n, sorted[i]->key,
+				     sorted[i]->len);
+	ok(seek_ok, "seek");
+
+	art_destroy(&tree);
+	free(records);
+	free(present);
+	free(sorted);
+	free(walked);
+
+	check_plan();
+	footer();
+}
+
+static void
+test_node_types(void)
+{
+	header();
+	plan(5);
+
+	/* Keys {b, 0} for all b make the root node grow up to 256. */
+	struct record records[256];
+	struct art tree;
+	art_create(&tree, test_key_of, test_alloc, test_free, NULL);
+	bool order_ok = true;
+	for (int i = 0; i < 256; i++) {
+		/* Insert in a shuffled order. */
+		int b = (i * 97) % 256;
+		records[b].key[0] = b;
+		records[b].key[1] = 0;
+		records[b].len = 2;
+		void *replaced;
+		fail_if(art_insert(&tree, records[b].key, 2, &records[b],
+				   &replaced) != 0);
+		if (art_seek_ge(&tree, (const unsigned char *)"", 0,
+				false) == NULL)
+			order_ok = false;
+	}
+	is(art_size(&tree), 256, "size");
+	for (int b = 0; b < 256; b++) {
+		unsigned char key = b;
+		if (art_seek_ge(&tree, &key, 1, false) != &records[b] ||
+		    art_seek_le(&tree, &key, 1, false) !=
+		    (b > 0 ? &records[b - 1] : NULL))
+			order_ok = false;
+	}
+	ok(order_ok, "order is preserved in all node types");
+	size_t mem_used = tree.mem_used;
+	ok(mem_used == allocated, "memory is accounted");
+	/* Shrink the root node back. */
+	for (int b = 0; b < 255; b++)
+		art_delete(&tree, records[b].key, 2);
+	ok(allocated == 0 && tree.root != NULL &&
+	   art_find(&tree, records[255].key, 2) == &records[255],
+	   "node with one child is replaced with the child");
+	art_delete(&tree, records[255].key, 2);
+	ok(tree.root == NULL && art_size(&tree) == 0, "tree is empty");
+	art_destroy(&tree);
+
+	check_plan();
+	footer();
+}
+
+int
+main(void)
+{
+	header();
+	plan(2);
+	srand(0);
+	test_random();
+	test_node_types();
+	int rc = check_plan();
+	footer();
+	return rc;
+}
@@ -194,12 +194,61 @@ void test_get_set()
 	footer();
 }
 
+static
+void test_sparse()
+{
+	header();
+
+	struct tt_bitset bm;
+	tt_bitset_create(&bm, realloc);
+
+	struct tt_bitset_info info;
+	/* A page with a few bits set stores offsets instead of a bitmap */
+	for (size_t i = 0; i < 64; i++) {
+		fail_if(tt_bitset_set(&bm, 1000 - i * 3) < 0);
+		tt_bitset_info(&bm, &info);
+		fail_unless(info.pages == 1);
+		fail_unless(info.sparse_pages == 1);
+	}
+	fail_unless(info.mem_size < info.page_total_size);
+	fail_unless(tt_bitset_set(&bm, 1000) == 1);
+	fail_unless(tt_bitset_clear(&bm, 1001) == 0);
+	fail_unless(tt_bitset_test(&bm, 1000 - 63 * 3));
+	fail_if(tt_bitset_test(&bm, 1000 - 63 * 3 - 1));
+
+	/* Converted to a bitmap when there are too many bits */
+	fail_if(tt_bitset_set(&bm, 1) < 0);
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.pages == 1);
+	fail_unless(info.sparse_pages == 0);
+	fail_unless(info.mem_size == info.page_total_size);
+	fail_unless(tt_bitset_cardinality(&bm) == 65);
+
+	/* Converted back when most of the bits are cleared */
+	for (size_t i = 0; i < 32; i++)
+		fail_unless(tt_bitset_clear(&bm, 1000 - i * 3) == 1);
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.sparse_pages == 0);
+	fail_unless(tt_bitset_clear(&bm, 1) == 1);
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.pages == 1);
+	fail_unless(info.sparse_pages == 1);
+	fail_unless(tt_bitset_cardinality(&bm) == 32);
+	for (size_t i = 0; i < 64; i++)
+		fail_unless(tt_bitset_test(&bm, 1000 - i * 3) == (i >= 32));
+
+	tt_bitset_destroy(&bm);
+
+	footer();
+}
+
 int main(int argc, char *argv[])
 {
 	setbuf(stdout, NULL);
 	srand(time(NULL));
 	test_cardinality();
 	test_get_set();
+	test_sparse();
 
 	return 0;
 }
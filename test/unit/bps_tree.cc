@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <cstring>
 #include <cstdio>
 #include <cinttypes>
 #include <ctime>
@@ -122,6 +123,49 @@ static int compare_key(const elem_t &a, long b)
 #undef bps_tree_key_t
 #undef bps_tree_arg_t
 
+/*
+ * Tree with comparison hints. Some hints are unknown and neighbour
+ * values have equal hints, so that the comparator is needed, too.
+ */
+struct hint_elem_t {
+	long value;
+	uint64_t hint;
+};
+
+static uint64_t
+hint_of(long value)
+{
+	if (value % 5 == 0)
+		return UINT64_MAX;
+	return ((uint64_t)value ^ (1ULL << 63)) >> 2;
+}
+
+#define BPS_TREE_NAME hint_tree
+#define BPS_TREE_BLOCK_SIZE SMALL_BLOCK_SIZE /* small value for tests */
+#define BPS_TREE_EXTENT_SIZE 2048 /* value is to low specially for tests */
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a).value == (b).value)
+#define BPS_TREE_COMPARE(a, b, arg) compare((a).value, (b).value)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) compare((a).value, b)
+#define BPS_TREE_ELEM_HINT(a) ((a).hint)
+#define BPS_TREE_KEY_HINT(b) hint_of(b)
+#define BPS_TREE_USE_HINT(arg) (arg)
+#define bps_tree_elem_t struct hint_elem_t
+#define bps_tree_key_t long
+#define bps_tree_arg_t bool
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_ELEM_HINT
+#undef BPS_TREE_KEY_HINT
+#undef BPS_TREE_USE_HINT
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+
 /* tree for approximate_count test */
 #define BPS_TREE_NAME approx
 #define BPS_TREE_BLOCK_SIZE SMALL_BLOCK_SIZE /* small value for tests */
@@ -918,10 +962,63 @@ insert_successor_test()
 	ok(true, "successor test");
 }
 
+static void
+hint_test()
+{
+	const long range = 1000;
+	bool present[2 * range];
+	for (int use_hint = 0; use_hint < 2; use_hint++) {
+		hint_tree tree;
+		hint_tree_create(&tree, use_hint, extent_alloc, extent_free,
+				 &extents_count, NULL);
+		memset(present, 0, sizeof(present));
+		for (long i = 0; i < 20 * range; i++) {
+			long v = rand() % (2 * range) - range;
+			struct hint_elem_t e = {v, hint_of(v)};
+			if (rand() % 3 != 0) {
+				hint_tree_insert(&tree, e, NULL, NULL);
+				present[v + range] = true;
+			} else {
+				hint_tree_delete(&tree, e);
+				present[v + range] = false;
+			}
+		}
+		fail_unless(hint_tree_debug_check(&tree) == 0);
+		for (long v = -range - 2; v < range + 2; v++) {
+			bool is_present = v >= -range && v < range &&
+					  present[v + range];
+			long lower = v < -range ? -range : v;
+			while (lower < range && !present[lower + range])
+				lower++;
+			long upper = v < -range ? -range : v + 1;
+			while (upper < range && !present[upper + range])
+				upper++;
+			bool exact;
+			hint_tree_iterator itr;
+			struct hint_elem_t *e;
+			itr = hint_tree_lower_bound(&tree, v, &exact);
+			e = hint_tree_iterator_get_elem(&tree, &itr);
+			fail_unless(exact == is_present);
+			fail_unless(lower < range ? e != NULL && e->value == lower :
+					e == NULL);
+			itr = hint_tree_upper_bound(&tree, v, &exact);
+			e = hint_tree_iterator_get_elem(&tree, &itr);
+			fail_unless(exact == is_present);
+			fail_unless(upper < range ? e != NULL && e->value == upper :
+					e == NULL);
+			e = hint_tree_find(&tree, v);
+			fail_unless(is_present ? e != NULL && e->value == v :
+					e == NULL);
+		}
+		hint_tree_destroy(&tree);
+	}
+	ok(true, "search with hints");
+}
+
 int
 main(void)
 {
-	plan(12);
+	plan(13);
 	header();
 
 	simple_check();
@@ -936,6 +1033,7 @@ main(void)
 	insert_get_iterator();
 	delete_value_check();
 	insert_successor_test();
+	hint_test();
 
 	footer();
 	return check_plan();
@@ -19,7 +19,7 @@ int
 main()
 {
 	header();
-	plan(38);
+	plan(45);
 
 	srand(time(NULL));
 	double now = rand();
@@ -91,6 +91,29 @@ main()
 		   interval);
 	}
 
+	struct checkpoint_recovery_estimate est;
+	checkpoint_recovery_estimate_create(&est);
+	checkpoint_recovery_estimate_update(&est, 1000, 1, 1000, 1);
+	ok(est.snap_rate > 1000 && est.wal_rate > 1000,
+	   "recovery estimate - small samples are ignored");
+
+	int64_t mb = 1024 * 1024;
+	checkpoint_recovery_estimate_update(&est, 1000 * mb, 10,
+					    100 * mb, 10);
+	ok(feq(est.snap_rate, 100 * mb) && feq(est.wal_rate, 10 * mb),
+	   "recovery estimate - rates are updated");
+	ok(feq(checkpoint_recovery_estimate_time(&est, 1000 * mb, 100 * mb),
+	       20), "recovery estimate - recovery time");
+
+	is(checkpoint_recovery_wal_size(&est, 30, 1000 * mb), 200 * mb,
+	   "recovery estimate - WAL size");
+	is(checkpoint_recovery_wal_size(&est, 12, 1000 * mb), 20 * mb,
+	   "recovery estimate - WAL size if checkpoint takes most of target");
+	is(checkpoint_recovery_wal_size(&est, 5, 1000 * mb), 10 * mb,
+	   "recovery estimate - WAL size if target can't be met");
+	is(checkpoint_recovery_wal_size(&est, 0.001, 0), mb,
+	   "recovery estimate - min WAL size");
+
 	check_plan();
 	footer();
 
@@ -0,0 +1,56 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "clock_fast.h"
+#include "clock.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+/** Sleep time in microseconds. */
+#define SLEEP_USEC 100000
+
+static void
+test_monotonic(void)
+{
+	header();
+	bool success = true;
+	int64_t prev = clock_fast_ns();
+	for (int i = 0; i < 1000000; i++) {
+		int64_t now = clock_fast_ns();
+		if (now < prev) {
+			success = false;
+			break;
+		}
+		prev = now;
+	}
+	ok(success, "clock is monotonic");
+	footer();
+}
+
+static void
+test_interval(void)
+{
+	header();
+	int64_t fast_start = clock_fast_ns();
+	int64_t start = clock_monotonic64();
+	usleep(SLEEP_USEC);
+	int64_t end = clock_monotonic64();
+	int64_t fast_end = clock_fast_ns();
+	int64_t interval = end - start;
+	int64_t fast_interval = fast_end - fast_start;
+	/* Allow 5% divergence to pass the test on a loaded host. */
+	ok(llabs(fast_interval - interval) < interval / 20,
+	   "interval does not diverge from monotonic");
+	footer();
+}
+
+int
+main(void)
+{
+	plan(2);
+	clock_fast_init();
+	test_monotonic();
+	test_interval();
+	return check_plan();
+}
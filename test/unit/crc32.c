@@ -29,6 +29,7 @@
  * SUCH DAMAGE.
  */
 #include "crc32.h"
+#include "crc32_impl.h"
 
 #define UNIT_TAP_COMPATIBLE 1
 #include "unit.h"
@@ -61,14 +62,47 @@ test_alignment(void)
 	footer();
 }
 
+/**
+ * Checks that the CRC32 implementation chosen for the CPU gives
+ * the same result as the software one for buffers of different
+ * lengths and alignments, including ones processed by several
+ * interleaved streams.
+ */
+static void
+test_software_match(void)
+{
+	header();
+	plan(1);
+
+	static char buf[32 * 1024];
+	unsigned int seed = 0;
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+	int mismatch = 0;
+	for (unsigned int len = 0; len < sizeof(buf) - 8; len += 7) {
+		unsigned int offset = len % 8;
+		uint32_t init = len * 2654435761U;
+		if (crc32_calc(init, buf + offset, len) !=
+		    crc32c(init, buf + offset, len))
+			mismatch++;
+	}
+	is(mismatch, 0, "crc32 matches software implementation");
+
+	check_plan();
+	footer();
+}
+
 int
 main(void)
 {
 	crc32_init();
 
 	header();
-	plan(1);
+	plan(2);
 	test_alignment();
+	test_software_match();
 	int rc = check_plan();
 	footer();
 	return rc;
@@ -563,16 +563,44 @@ mp_print_test(void)
 	check_plan();
 }
 
+static void
+mp_datetime_compare_packed_test(void)
+{
+	static struct datetime values[] = {
+		{.epoch = -100},
+		{.epoch = 0},
+		{.epoch = 0, .nsec = 1},
+		{.epoch = 0, .nsec = 1, .tzoffset = 180},
+		{.epoch = 0, .nsec = 2},
+		{.epoch = 1, .tzindex = 1},
+		{.epoch = 1700000000, .nsec = 999999999},
+	};
+	plan(lengthof(values) * lengthof(values));
+	for (size_t i = 0; i < lengthof(values); i++) {
+		for (size_t j = 0; j < lengthof(values); j++) {
+			char lbuf[sizeof(struct datetime)];
+			char rbuf[sizeof(struct datetime)];
+			uint32_t llen = datetime_pack(lbuf, &values[i]) - lbuf;
+			uint32_t rlen = datetime_pack(rbuf, &values[j]) - rbuf;
+			is(datetime_compare_packed(lbuf, llen, rbuf, rlen),
+			   datetime_compare(&values[i], &values[j]),
+			   "datetime_compare_packed(%zu, %zu)", i, j);
+		}
+	}
+	check_plan();
+}
+
 int
 main(void)
 {
-	plan(6);
+	plan(7);
 	datetime_test();
 	tostring_datetime_test();
 	parse_date_test();
 	mp_datetime_unpack_valid_checks();
 	mp_datetime_test();
 	mp_print_test();
+	mp_datetime_compare_packed_test();
 
 	return check_plan();
 }
@@ -369,6 +369,46 @@ mp_snprint_ext_test(char *buf, int size, const char **data, int depth)
 	return mp_snprint_decimal(buf, size, data, len);
 }
 
+#define test_cmp_packed(lstr, rstr, applicable) ({\
+	decimal_t ldec, rdec;\
+	decimal_from_string(&ldec, lstr);\
+	decimal_from_string(&rdec, rstr);\
+	char lbuf[32], rbuf[32];\
+	uint32_t llen = decimal_pack(lbuf, &ldec) - lbuf;\
+	uint32_t rlen = decimal_pack(rbuf, &rdec) - rbuf;\
+	int r = 0;\
+	bool rc = decimal_compare_packed(lbuf, llen, rbuf, rlen, &r);\
+	is(rc, applicable, "decimal_compare_packed("lstr", "rstr") applicable");\
+	if (rc) {\
+		int expected = decimal_compare(&ldec, &rdec);\
+		is((r > 0) - (r < 0), expected,\
+		   "decimal_compare_packed("lstr", "rstr") result");\
+	}\
+})
+
+static int
+test_compare_packed(void)
+{
+	plan(21);
+	header();
+
+	test_cmp_packed("1.23", "1.23", true);
+	test_cmp_packed("1.23", "1.24", true);
+	test_cmp_packed("12.34", "1.23", true);
+	test_cmp_packed("-1.23", "1.23", true);
+	test_cmp_packed("-12.34", "-1.23", true);
+	test_cmp_packed("0.00", "-0.00", true);
+	test_cmp_packed("0.00", "-0.01", true);
+	test_cmp_packed("123456789012345678901234567890", "123", true);
+	test_cmp_packed("-10", "-9", true);
+	test_cmp_packed("1.0", "1.00", false);
+	test_cmp_packed("1.5", "15", false);
+	test_cmp_packed("100", "1e2", false);
+
+	footer();
+	return check_plan();
+}
+
 static void
 test_mp_print(void)
 {
@@ -410,7 +450,7 @@ test_mp_print(void)
 int
 main(void)
 {
-	plan(312);
+	plan(313);
 
 	dectest(314, 271, uint64, uint64_t);
 	dectest(65535, 23456, uint64, uint64_t);
@@ -476,6 +516,7 @@ main(void)
 
 	test_mp_decimal();
 	test_mp_print();
+	test_compare_packed();
 
 	test_strtodec("15.e", 'e', success);
 	test_strtodec("15.e+", 'e', success);
@@ -2,6 +2,7 @@
 #include "fiber.h"
 #include "trivia/util.h"
 #include "errinj.h"
+#include "tweaks.h"
 
 #define UNIT_TAP_COMPATIBLE 1
 #include "unit.h"
@@ -23,6 +24,71 @@ noop_f(va_list ap)
 	return 0;
 }
 
+/** Set the max number of cached fibers with custom stack size. */
+static void
+stack_cache_set_max(uint64_t max)
+{
+	struct tweak *t = tweak_find("fiber_stack_cache_max");
+	assert(t != NULL);
+	struct tweak_value v;
+	v.type = TWEAK_VALUE_UINT;
+	v.uval = max;
+	int rc = tweak_set(t, &v);
+	assert(rc == 0);
+	(void)rc;
+}
+
+/** Start a fiber with the given attributes and wait for it to finish. */
+static struct fiber *
+fiber_run(struct fiber_attr *fiber_attr)
+{
+	struct fiber *fiber = fiber_new_ex("test", fiber_attr, noop_f);
+	fail_if(fiber == NULL);
+	fiber_set_joinable(fiber, true);
+	fiber_start(fiber);
+	fiber_join(fiber);
+	return fiber;
+}
+
+static void
+test_stack_cache(void)
+{
+	plan(9);
+	header();
+
+	struct fiber_stack_cache_stat *stat = &cord()->stack_cache_stat;
+	int fiber_count = fiber_count_total();
+	struct fiber_attr *fiber_attr = fiber_attr_new();
+	fiber_attr_setstacksize(fiber_attr, default_attr.stack_size * 2);
+	stack_cache_set_max(1);
+
+	struct fiber *fiber = fiber_run(fiber_attr);
+	cord_collect_garbage(cord());
+	ok(fiber_count_total() == fiber_count + 1, "dead fiber is cached");
+	ok(stat->count == 1 && stat->size == (int64_t)fiber->stack_size,
+	   "cache size");
+
+	int64_t hits = stat->hits;
+	ok(fiber_run(fiber_attr) == fiber, "fiber is reused");
+	ok(stat->hits == hits + 1, "cache hit");
+	ok(fiber_count_total() == fiber_count + 1, "no new fiber allocated");
+
+	int64_t misses = stat->misses;
+	fiber_attr_setstacksize(fiber_attr, default_attr.stack_size * 4);
+	ok(fiber_run(fiber_attr) != fiber, "stack size mismatch");
+	ok(stat->misses == misses + 1, "cache miss");
+	cord_collect_garbage(cord());
+	ok(fiber_count_total() == fiber_count + 1,
+	   "fiber is deleted if cache is full");
+	ok(stat->count == 1, "cache size");
+
+	stack_cache_set_max(0);
+	fiber_attr_delete(fiber_attr);
+
+	footer();
+	check_plan();
+}
+
 static int
 main_f(va_list ap)
 {
@@ -35,11 +101,14 @@ main_f(va_list ap)
 
 	header();
 #ifdef NDEBUG
-	plan(1);
+	plan(2);
 #else
-	plan(11);
+	plan(12);
 #endif
 
+	/* Fibers with custom stack size are expected to be deleted. */
+	stack_cache_set_max(0);
+
 	/*
 	 * gh-9026. Stack size crafted to be close to 64k so we should
 	 * hit red zone around stack when writing watermark if bug is not
@@ -138,6 +207,7 @@ main_f(va_list ap)
 #endif /* ifndef NDEBUG */
 
 	fiber_attr_delete(fiber_attr);
+	test_stack_cache();
 	ev_break(loop(), EVBREAK_ALL);
 
 	footer();
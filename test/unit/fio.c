@@ -0,0 +1,66 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "fio.h"
+#include "trivia/util.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+/**
+ * Checks that fio_writevn() writes a vector longer than IOV_MAX
+ * with empty buffers in it and doesn't modify the vector.
+ */
+static void
+test_writevn(void)
+{
+	header();
+	plan(4);
+
+	char path[] = "/tmp/tarantool-unit-fio-XXXXXX";
+	int fd = mkstemp(path);
+	fail_if(fd < 0);
+	unlink(path);
+
+	enum { IOVCNT = 2 * IOV_MAX + 3 };
+	static struct iovec iov[IOVCNT];
+	static struct iovec iov_copy[IOVCNT];
+	static char data[IOVCNT * 3];
+	size_t total = 0;
+	for (int i = 0; i < IOVCNT; i++) {
+		size_t len = i % 3;
+		for (size_t j = 0; j < len; j++)
+			data[total + j] = (char)(i + j);
+		iov[i].iov_base = data + total;
+		iov[i].iov_len = len;
+		total += len;
+	}
+	memcpy(iov_copy, iov, sizeof(iov));
+
+	is(fio_writevn(fd, iov, IOVCNT), (ssize_t)total, "bytes written");
+	ok(memcmp(iov, iov_copy, sizeof(iov)) == 0, "vector isn't modified");
+
+	static char buf[sizeof(data)];
+	is(fio_pread(fd, buf, sizeof(buf), 0), (ssize_t)total, "bytes read");
+	ok(memcmp(buf, data, total) == 0, "data is written in order");
+
+	close(fd);
+
+	check_plan();
+	footer();
+}
+
+int
+main(void)
+{
+	header();
+	plan(1);
+
+	test_writevn();
+
+	footer();
+	return check_plan();
+}
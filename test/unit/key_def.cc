@@ -844,6 +844,68 @@ test_key_compare_singlepart(bool ascending_key, bool is_nullable)
 	check_plan();
 }
 
+/**
+ * Checks that precompiled integer comparators return correct results when
+ * the compared values have equal hints, both exact and clamped.
+ */
+static void
+test_tuple_compare_exact_hint(void)
+{
+	plan(8);
+	header();
+
+	struct key_def *key_def = test_key_def_new(
+		"[{%s%u%s%s}]", "field", 0, "type", "integer");
+	struct {
+		struct tuple *tuple_a;
+		struct tuple *tuple_b;
+		int expected;
+	} cases[] = {
+		{
+			test_tuple_new("[%u]", 100),
+			test_tuple_new("[%u]", 100),
+			0,
+		}, {
+			test_tuple_new("[%d]", -100),
+			test_tuple_new("[%d]", -100),
+			0,
+		}, {
+			test_tuple_new("[%llu]", (unsigned long long)UINT64_MAX),
+			test_tuple_new("[%llu]",
+				       (unsigned long long)UINT64_MAX - 1),
+			1,
+		}, {
+			test_tuple_new("[%lld]", (long long)INT64_MIN),
+			test_tuple_new("[%lld]", (long long)INT64_MIN + 1),
+			-1,
+		},
+	};
+	for (size_t i = 0; i < lengthof(cases); i++) {
+		struct tuple *a = cases[i].tuple_a;
+		struct tuple *b = cases[i].tuple_b;
+		hint_t hint_a = tuple_hint(a, key_def);
+		hint_t hint_b = tuple_hint(b, key_def);
+		int r = tuple_compare(a, hint_a, b, hint_b, key_def);
+		r = r > 0 ? 1 : r < 0 ? -1 : 0;
+		is(r, cases[i].expected, "tuple_compare(%s, %s) = %d",
+		   tuple_str(a), tuple_str(b), cases[i].expected);
+		const char *key = tuple_data(b);
+		uint32_t part_count = mp_decode_array(&key);
+		r = tuple_compare_with_key(a, hint_a, key, part_count,
+					   key_hint(key, part_count, key_def),
+					   key_def);
+		r = r > 0 ? 1 : r < 0 ? -1 : 0;
+		is(r, cases[i].expected, "tuple_compare_with_key(%s, %s) = %d",
+		   tuple_str(a), tuple_str(b), cases[i].expected);
+		tuple_delete(a);
+		tuple_delete(b);
+	}
+	key_def_delete(key_def);
+
+	footer();
+	check_plan();
+}
+
 static void
 test_key_compare(bool ascending_key, bool is_nullable)
 {
@@ -1398,7 +1460,7 @@ test_key_def_find_by_fieldno(void)
 static int
 test_main(void)
 {
-	plan(51);
+	plan(52);
 	header();
 
 	test_func_compare();
@@ -1452,6 +1514,7 @@ test_main(void)
 	test_key_compare_singlepart(false, true);
 	test_key_compare_singlepart(false, false);
 	test_key_def_find_by_fieldno();
+	test_tuple_compare_exact_hint();
 
 	footer();
 	return check_plan();
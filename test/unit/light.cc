@@ -351,6 +351,52 @@ slot_in_big_table_test()
 	footer();
 }
 
+/**
+ * Check that a hash table with reserved slots is not enlarged
+ * while the reserved number of records is inserted.
+ */
+static void
+reserve_test()
+{
+	header();
+
+	struct light_core ht;
+	light_create(&ht, 0, light_extent_size, my_light_alloc, my_light_free,
+		     &extents_count, NULL);
+	const uint32_t count = 10000;
+	fail_if(light_reserve(&ht, count) != 0);
+	uint32_t table_size = ht.common.table_size;
+	fail_if(table_size < count);
+	fail_if(light_selfcheck(&ht) != 0);
+	size_t extents = extents_count;
+	for (uint32_t i = 0; i < count; i++)
+		fail_if(light_insert(&ht, hash(i), i) == light_end);
+	fail_if(ht.common.table_size != table_size);
+	fail_if(extents_count != extents);
+	fail_if(light_count(&ht) != count);
+	fail_if(light_selfcheck(&ht) != 0);
+	for (uint32_t i = 0; i < count; i++)
+		fail_if(light_find(&ht, hash(i), i) == light_end);
+
+	/* A table that has records is left as is. */
+	fail_if(light_reserve(&ht, 2 * count) != 0);
+	fail_if(ht.common.table_size != table_size);
+
+	/* A table that became empty can be enlarged. */
+	for (uint32_t i = 0; i < count; i++)
+		fail_if(light_delete_value(&ht, hash(i), i) != 0);
+	fail_if(light_reserve(&ht, 2 * count) != 0);
+	fail_if(ht.common.table_size < 2 * count);
+	fail_if(light_selfcheck(&ht) != 0);
+	for (uint32_t i = 0; i < 2 * count; i++)
+		fail_if(light_insert(&ht, hash(i * 7), i * 7) == light_end);
+	fail_if(light_selfcheck(&ht) != 0);
+
+	light_destroy(&ht);
+
+	footer();
+}
+
 /**
  * Insert nearly 2^32 records into the hash table.
  */
@@ -413,6 +459,7 @@ main(int, const char**)
 	iterator_test();
 	iterator_freeze_check();
 	slot_in_big_table_test();
+	reserve_test();
 	max_capacity_test();
 
 	if (extents_count != 0)
@@ -2439,10 +2439,92 @@ raft_test_candidate_disable_during_wal_write(void)
 	raft_finish_test();
 }
 
+static void
+raft_test_lease(void)
+{
+	raft_start_test(12);
+	struct raft_node node;
+	raft_node_create(&node);
+	raft_node_cfg_is_candidate(&node, false);
+	raft_node_cfg_lease(&node, true, 0.1);
+
+	/* A follower doesn't vote against the leader until its lease ends. */
+
+	is(raft_node_send_leader(&node,
+		2 /* Term. */,
+		2 /* Source. */
+	), 0, "leader notification");
+	raft_node_send_heartbeat(&node, 2);
+	is(raft_node_send_vote_request(&node,
+		3 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		0 /* Leader. */,
+		3 /* Term. */,
+		0 /* Vote. */,
+		3 /* Volatile term. */,
+		0 /* Volatile vote. */,
+		"{0: 2}" /* Vclock. */
+	), "vote is not given while the lease of 2 is valid");
+
+	raft_run_for(node.cfg_death_timeout);
+	is(raft_node_send_vote_request(&node,
+		4 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		0 /* Leader. */,
+		4 /* Term. */,
+		3 /* Vote. */,
+		4 /* Volatile term. */,
+		3 /* Volatile vote. */,
+		"{0: 4}" /* Vclock. */
+	), "voted for 3 when the lease has expired");
+
+	raft_node_destroy(&node);
+
+	/* The leader collects the lease from the followers seeing it. */
+
+	raft_node_create(&node);
+	raft_node_cfg_election_quorum(&node, 2);
+	raft_node_cfg_lease(&node, true, 0.1);
+	raft_node_promote(&node);
+	is(raft_node_send_vote_response(&node,
+		2 /* Term. */,
+		1 /* Vote. */,
+		2 /* Source. */
+	), 0, "vote response from 2");
+	is(node.raft.state, RAFT_STATE_LEADER, "became leader");
+	ok(!raft_has_lease(&node.raft), "no lease without acks");
+
+	raft_process_lease_ack(&node.raft, 2, 2, raft_time());
+	ok(!raft_has_lease(&node.raft), "no lease from a node not seeing "
+	   "the leader");
+
+	is(raft_node_send_is_leader_seen(&node,
+		2 /* Term. */,
+		true /* Is leader seen. */,
+		2 /* Source. */
+	), 0, "leader is seen by 2");
+	raft_run_for(1);
+	raft_process_lease_ack(&node.raft, 2, 2, raft_time());
+	ok(raft_has_lease(&node.raft), "got the lease");
+	raft_run_for(node.cfg_death_timeout);
+	ok(!raft_has_lease(&node.raft), "the lease has expired");
+
+	raft_node_destroy(&node);
+	raft_finish_test();
+}
+
 static int
 main_f(va_list ap)
 {
-	raft_start_test(20);
+	raft_start_test(21);
 
 	(void) ap;
 	fakeev_init();
@@ -2467,6 +2549,7 @@ main_f(va_list ap)
 	raft_test_pre_vote();
 	raft_test_resign();
 	raft_test_candidate_disable_during_wal_write();
+	raft_test_lease();
 
 	fakeev_free();
 
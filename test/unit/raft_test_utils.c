@@ -404,6 +404,8 @@ raft_node_cfg(struct raft_node *node)
 	raft_cfg_election_quorum(&node->raft, node->cfg_election_quorum);
 	raft_cfg_death_timeout(&node->raft, node->cfg_death_timeout);
 	raft_cfg_max_shift(&node->raft, node->cfg_max_shift);
+	raft_cfg_lease(&node->raft, node->cfg_is_lease_enabled,
+		       node->cfg_lease_max_drift);
 	raft_cfg_instance_id(&node->raft, node->cfg_instance_id);
 	raft_cfg_cluster_size(&node->raft, node->cfg_cluster_size);
 	raft_cfg_vclock(&node->raft, node->cfg_vclock);
@@ -522,6 +524,17 @@ raft_node_cfg_max_shift(struct raft_node *node, double value)
 	}
 }
 
+void
+raft_node_cfg_lease(struct raft_node *node, bool is_enabled, double max_drift)
+{
+	node->cfg_is_lease_enabled = is_enabled;
+	node->cfg_lease_max_drift = max_drift;
+	if (raft_node_is_started(node)) {
+		raft_cfg_lease(&node->raft, is_enabled, max_drift);
+		raft_run_async_work();
+	}
+}
+
 bool
 raft_msg_check(const struct raft_msg *msg, enum raft_state state, uint64_t term,
 	       uint32_t vote, const char *vclock)
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <string.h>
 
 #include "unit.h"
 #include "salad/rtree.h"
@@ -299,12 +300,121 @@ neighbor_test()
 	footer();
 }
 
+static void
+bulk_load_check(unsigned dimension, size_t count)
+{
+	struct rtree tree;
+	rtree_init(&tree, dimension, RTREE_EUCLID, extent_size,
+		   extent_alloc, extent_free, &page_count, NULL);
+	struct rtree_rect *rects =
+		(struct rtree_rect *)calloc(count + 1, sizeof(*rects));
+	char *entries = (char *)calloc(count + 1,
+				       rtree_bulk_entry_size(&tree));
+	for (size_t i = 0; i < count; i++) {
+		for (unsigned d = 0; d < dimension; d++) {
+			coord_t c = rand() % 1000;
+			rects[i].coords[d * 2] = c;
+			rects[i].coords[d * 2 + 1] = c + rand() % 10;
+		}
+		rtree_bulk_entry_set(&tree, entries, i, &rects[i],
+				     (record_t)(i + 1));
+	}
+	if (rtree_bulk_load(&tree, entries, count) != 0)
+		fail("bulk load failed", "true");
+	free(entries);
+	if (rtree_number_of_records(&tree) != count)
+		fail("Tree count mismatch", "true");
+	if (rtree_used_size(&tree) !=
+	    rtree_bulk_load_page_count(&tree, count) * tree.page_size)
+		fail("Page count mismatch", "true");
+
+	struct rtree_iterator iterator;
+	rtree_iterator_init(&iterator);
+	/* Compare overlap search with a full scan */
+	for (int k = 0; k < 10; k++) {
+		struct rtree_rect rect;
+		for (unsigned d = 0; d < dimension; d++) {
+			coord_t c = rand() % 1000;
+			rect.coords[d * 2] = c;
+			rect.coords[d * 2 + 1] = c + 200;
+		}
+		size_t expected = 0;
+		for (size_t i = 0; i < count; i++) {
+			bool overlaps = true;
+			for (unsigned d = 0; d < dimension; d++) {
+				if (rects[i].coords[d * 2] >
+				    rect.coords[d * 2 + 1] ||
+				    rects[i].coords[d * 2 + 1] <
+				    rect.coords[d * 2])
+					overlaps = false;
+			}
+			expected += overlaps;
+		}
+		size_t found = 0;
+		rtree_search(&tree, &rect, SOP_OVERLAPS, &iterator);
+		while (rtree_iterator_next(&iterator) != NULL)
+			found++;
+		if (found != expected)
+			fail("overlap search result mismatch", "true");
+	}
+	/* Neighbors must be returned in order of distance */
+	struct rtree_rect point;
+	memset(&point, 0, sizeof(point));
+	rtree_search(&tree, &point, SOP_NEIGHBOR, &iterator);
+	coord_t prev = 0;
+	size_t found = 0;
+	record_t rec;
+	while ((rec = rtree_iterator_next(&iterator)) != NULL) {
+		const struct rtree_rect *r = &rects[(size_t)rec - 1];
+		coord_t dist = 0;
+		for (unsigned d = 0; d < dimension; d++)
+			dist += r->coords[d * 2] * r->coords[d * 2];
+		if (dist < prev)
+			fail("neighbor order", "wrong");
+		prev = dist;
+		found++;
+	}
+	if (found != count)
+		fail("neighbor count mismatch", "true");
+
+	/* The tree is fully functional after the build */
+	rtree_insert(&tree, &rects[0], (record_t)(count + 1));
+	for (size_t i = 0; i < count; i++) {
+		if (!rtree_remove(&tree, &rects[i], (record_t)(i + 1)))
+			fail("delete element in tree", "false");
+	}
+	if (rtree_number_of_records(&tree) != 1)
+		fail("Tree count mismatch", "true");
+	rtree_search(&tree, &rects[0], SOP_EQUALS, &iterator);
+	if (rtree_iterator_next(&iterator) != (record_t)(count + 1))
+		fail("inserted element in tree", "false");
+
+	rtree_iterator_destroy(&iterator);
+	rtree_destroy(&tree);
+	free(rects);
+}
+
+static void
+bulk_load_test()
+{
+	header();
+
+	const size_t counts[] = {0, 1, 2, 20, 21, 100, 1000, 20000};
+	const unsigned dimensions[] = {1, 2, 3, 8, RTREE_MAX_DIMENSION};
+	for (size_t i = 0; i < sizeof(dimensions) / sizeof(*dimensions); i++) {
+		for (size_t j = 0; j < sizeof(counts) / sizeof(*counts); j++)
+			bulk_load_check(dimensions[i], counts[j]);
+	}
+
+	footer();
+}
 
 int
 main(void)
 {
 	simple_check();
 	neighbor_test();
+	bulk_load_test();
 	if (page_count != 0) {
 		fail("memory leak!", "true");
 	}
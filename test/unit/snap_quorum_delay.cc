@@ -237,12 +237,18 @@ on_garbage_collection(void)
 	/* no-op. */
 }
 
+void
+on_checkpoint(void)
+{
+	/* no-op. */
+}
+
 int
 main(void)
 {
 	memory_init();
 	fiber_init(fiber_c_invoke);
-	gc_init(on_garbage_collection);
+	gc_init(on_garbage_collection, on_checkpoint);
 	txn_limbo_init();
 	instance_id = 1;
 
@@ -568,11 +568,45 @@ test_value(void)
 	footer();
 }
 
+/**
+ * Checks that the worker fiber yields while running lots of watchers.
+ */
+static void
+test_many_watchers(void)
+{
+	header();
+	plan(2);
+
+	enum { WATCHER_COUNT = 2500 };
+	struct test_watcher *w = xcalloc(WATCHER_COUNT, sizeof(*w));
+	for (int i = 0; i < WATCHER_COUNT; i++) {
+		test_watcher_create(&w[i]);
+		test_watcher_register(&w[i], "foo");
+	}
+	fiber_sleep(0);
+	ok(w[0].run_count == 1 && w[WATCHER_COUNT - 1].run_count == 0,
+	   "worker yields between batches");
+	for (int i = 0; i < 10 && w[WATCHER_COUNT - 1].run_count == 0; i++)
+		fiber_sleep(0);
+	bool all_run = true;
+	for (int i = 0; i < WATCHER_COUNT; i++) {
+		if (w[i].run_count != 1)
+			all_run = false;
+		test_watcher_unregister(&w[i]);
+		test_watcher_destroy(&w[i]);
+	}
+	ok(all_run, "all watchers run");
+	free(w);
+
+	check_plan();
+	footer();
+}
+
 static int
 main_f(va_list ap)
 {
 	header();
-	plan(9);
+	plan(10);
 	box_watcher_init();
 	test_basic();
 	test_async();
@@ -582,6 +616,7 @@ main_f(va_list ap)
 	test_ack_unregistered();
 	test_parallel();
 	test_value();
+	test_many_watchers();
 	test_free(); /* must be last */
 	test_result = check_plan();
 	footer();
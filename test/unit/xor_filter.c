@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "salad/xor_filter.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+static uint32_t
+h(uint32_t i)
+{
+	return i * 2654435761;
+}
+
+/**
+ * Build a filter over even numbers in [0, 2 * count) and check it
+ * against all numbers in [0, 20 * count).
+ */
+static void
+check_filter(const struct xor_filter *filter, uint32_t count,
+	     uint32_t *false_negative, uint32_t *false_positive)
+{
+	*false_negative = 0;
+	*false_positive = 0;
+	for (uint32_t i = 0; i < count * 20; i++) {
+		bool has = i % 2 == 0 && i < count * 2;
+		bool maybe_has = xor_filter_maybe_has(filter, h(i));
+		if (has && !maybe_has)
+			++*false_negative;
+		if (!has && maybe_has)
+			++*false_positive;
+	}
+}
+
+static int
+build_filter(struct xor_filter *filter, uint32_t count, double fpr)
+{
+	xor_filter_hash_t *hashes = malloc(sizeof(*hashes) * count);
+	fail_if(hashes == NULL);
+	for (uint32_t i = 0; i < count; i++)
+		hashes[i] = h(i * 2);
+	int rc = xor_filter_create(filter, hashes, count, fpr);
+	free(hashes);
+	return rc;
+}
+
+static void
+test_fpr(void)
+{
+	header();
+	plan(12);
+
+	double fprs[] = {0.5, 0.1, 0.01, 0.001};
+	for (size_t i = 0; i < sizeof(fprs) / sizeof(fprs[0]); i++) {
+		double fpr = fprs[i];
+		uint32_t count = 10000;
+		struct xor_filter filter;
+		ok(build_filter(&filter, count, fpr) == 0,
+		   "build filter with fpr %g", fpr);
+		uint32_t false_negative, false_positive;
+		check_filter(&filter, count, &false_negative, &false_positive);
+		is(false_negative, 0, "no false negatives with fpr %g", fpr);
+		double real_fpr = (double)false_positive / (count * 19);
+		ok(real_fpr <= fpr * 1.1 + 0.001 &&
+		   xor_filter_fpr(&filter) <= fpr,
+		   "false positive rate %g fits %g", real_fpr, fpr);
+		xor_filter_destroy(&filter);
+	}
+
+	check_plan();
+	footer();
+}
+
+static void
+test_duplicates(void)
+{
+	header();
+	plan(2);
+
+	uint32_t count = 1000;
+	xor_filter_hash_t *hashes = malloc(sizeof(*hashes) * count * 3);
+	fail_if(hashes == NULL);
+	for (uint32_t i = 0; i < count * 3; i++)
+		hashes[i] = h((i % count) * 2);
+	struct xor_filter filter;
+	ok(xor_filter_create(&filter, hashes, count * 3, 0.01) == 0,
+	   "build filter from duplicate hashes");
+	free(hashes);
+	uint32_t false_negative, false_positive;
+	check_filter(&filter, count, &false_negative, &false_positive);
+	is(false_negative, 0, "no false negatives");
+	xor_filter_destroy(&filter);
+
+	check_plan();
+	footer();
+}
+
+static void
+test_empty(void)
+{
+	header();
+	plan(2);
+
+	struct xor_filter filter;
+	ok(xor_filter_create(&filter, NULL, 0, 0.01) == 0,
+	   "build empty filter");
+	uint32_t false_positive = 0;
+	for (uint32_t i = 0; i < 1000; i++) {
+		if (xor_filter_maybe_has(&filter, h(i)))
+			false_positive++;
+	}
+	ok(false_positive < 50, "empty filter rejects most values");
+	xor_filter_destroy(&filter);
+
+	check_plan();
+	footer();
+}
+
+static void
+test_store_load(void)
+{
+	header();
+	plan(3);
+
+	uint32_t count = 3000;
+	struct xor_filter filter;
+	ok(build_filter(&filter, count, 0.05) == 0, "build filter");
+	size_t size = xor_filter_store_size(&filter);
+	char *buf = malloc(size);
+	fail_if(buf == NULL);
+	xor_filter_store(&filter, buf);
+
+	struct xor_filter test = filter;
+	test.table = NULL;
+	ok(xor_filter_load_table(&test, buf) == 0, "load filter table");
+	free(buf);
+
+	bool match = true;
+	for (uint32_t i = 0; i < count * 20; i++) {
+		if (xor_filter_maybe_has(&filter, h(i)) !=
+		    xor_filter_maybe_has(&test, h(i)))
+			match = false;
+	}
+	ok(match, "loaded filter matches the original");
+	xor_filter_destroy(&filter);
+	xor_filter_destroy(&test);
+
+	check_plan();
+	footer();
+}
+
+int
+main(void)
+{
+	header();
+	plan(4);
+	test_fpr();
+	test_duplicates();
+	test_empty();
+	test_store_load();
+	int rc = check_plan();
+	footer();
+	return rc;
+}
@@ -0,0 +1,53 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {vinyl_cache = 0}})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk', {
+            parts = {1, 'unsigned', 2, 'unsigned'},
+            page_size = 128, bloom_fpr = 0.01, bloom_partitioned = true,
+        })
+        for i = 1, 1000, 2 do
+            s:insert({i, i * 10, string.rep('x', 50)})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function check_lookups()
+    local s = box.space.test
+    t.assert_equals(s.index.pk.options.bloom_partitioned, true)
+    t.assert_equals(box.stat.vinyl().memory.bloom_filter, 0)
+    t.assert_gt(s.index.pk:stat().disk.pages, 16)
+
+    -- Lookups of missing keys are filtered out by bloom partitions,
+    -- both by full and by partial key.
+    local hit = s.index.pk:stat().disk.iterator.bloom.hit
+    for i = 2, 1000, 2 do
+        t.assert_equals(s:get({i, i * 10}), nil)
+        t.assert_equals(s:select({i}), {})
+    end
+    t.assert_ge(s.index.pk:stat().disk.iterator.bloom.hit - hit, 900)
+    t.assert_gt(box.stat.vinyl().memory.bloom_filter, 0)
+
+    -- All stored keys are found.
+    for i = 1, 1000, 2 do
+        t.assert_equals(s:get({i, i * 10}), {i, i * 10, string.rep('x', 50)})
+        t.assert_equals(s:select({i}), {{i, i * 10, string.rep('x', 50)}})
+    end
+end
+
+g.test_bloom_partitioned = function(cg)
+    cg.server:exec(check_lookups)
+    cg.server:restart()
+    cg.server:exec(check_lookups)
+end
@@ -0,0 +1,67 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {vinyl_cache = 0}})
+    cg.server:start()
+    cg.server:exec(function()
+        for _, name in ipairs({'bloom', 'xor'}) do
+            local s = box.schema.create_space(name, {engine = 'vinyl'})
+            s:create_index('pk', {
+                parts = {1, 'unsigned', 2, 'unsigned'},
+                bloom_fpr = 0.01, bloom_type = name,
+            })
+            for i = 1, 10000, 2 do
+                s:insert({i, i * 10})
+            end
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function check_lookups()
+    local s = box.space.xor
+    t.assert_equals(s.index.pk.options.bloom_type, 'xor')
+    t.assert_equals(box.space.bloom.index.pk.options.bloom_type, nil)
+
+    -- Xor filters take less memory than bloom filters.
+    t.assert_lt(s.index.pk:stat().disk.bloom_size,
+                box.space.bloom.index.pk:stat().disk.bloom_size)
+
+    -- Lookups of missing keys are filtered out both by full and
+    -- by partial key.
+    local hit = s.index.pk:stat().disk.iterator.bloom.hit
+    for i = 2, 10000, 2 do
+        t.assert_equals(s:get({i, i * 10}), nil)
+        t.assert_equals(s:select({i}), {})
+    end
+    t.assert_ge(s.index.pk:stat().disk.iterator.bloom.hit - hit, 9800)
+
+    -- All stored keys are found.
+    for i = 1, 10000, 2 do
+        t.assert_equals(s:get({i, i * 10}), {i, i * 10})
+        t.assert_equals(s:select({i}), {{i, i * 10}})
+    end
+end
+
+g.test_bloom_xor = function(cg)
+    cg.server:exec(check_lookups)
+    cg.server:restart()
+    cg.server:exec(check_lookups)
+end
+
+g.test_invalid_bloom_type = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        t.assert_error_msg_contains("bloom_type must be either",
+                                    s.create_index, s, 'pk',
+                                    {bloom_type = 'cuckoo'})
+        s:drop()
+    end)
+end
@@ -0,0 +1,69 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_compaction_strategy = function(cg)
+    cg.server:exec(function()
+        for _, strategy in ipairs({'leveled', 'tiered'}) do
+            local s = box.schema.create_space(strategy, {engine = 'vinyl'})
+            s:create_index('pk', {
+                compaction_strategy = strategy,
+                run_count_per_level = 2, run_size_ratio = 3.5,
+            })
+        end
+        t.assert_equals(box.space.leveled.index.pk.options.compaction_strategy,
+                        nil)
+        t.assert_equals(box.space.tiered.index.pk.options.compaction_strategy,
+                        'tiered')
+
+        -- Dump runs of the same size and let compaction settle
+        -- after each dump.
+        for i = 1, 24 do
+            for j = 1, 100 do
+                local key = i * 1000 + j
+                box.space.leveled:replace({key, string.rep('x', 100)})
+                box.space.tiered:replace({key, string.rep('x', 100)})
+            end
+            box.snapshot()
+            t.helpers.retrying({}, function()
+                t.assert_covers(box.stat.vinyl().scheduler, {
+                    tasks_inprogress = 0, compaction_queue = 0,
+                })
+            end)
+        end
+
+        -- Tiered compaction rewrites less data at the cost of
+        -- keeping more runs.
+        local leveled = box.space.leveled.index.pk:stat()
+        local tiered = box.space.tiered.index.pk:stat()
+        t.assert_lt(tiered.disk.compaction.output.bytes,
+                    leveled.disk.compaction.output.bytes)
+        t.assert_ge(tiered.run_count, leveled.run_count)
+        t.assert_le(tiered.run_count, 12)
+        t.assert_equals(box.space.tiered:select(),
+                        box.space.leveled:select())
+    end)
+end
+
+g.test_alter_compaction_strategy = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk', {compaction_strategy = 'tiered'})
+        s.index.pk:alter({compaction_strategy = 'leveled'})
+        t.assert_equals(s.index.pk.options.compaction_strategy, nil)
+        t.assert_error_msg_contains(
+            "compaction_strategy must be either 'leveled' or 'tiered'",
+            s.index.pk.alter, s.index.pk, {compaction_strategy = 'fifo'})
+        s:drop()
+    end)
+end
@@ -0,0 +1,77 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {vinyl_cache = 0}})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 128})
+        s:create_index('sk', {parts = {2, 'unsigned'}, page_size = 128})
+        -- Spread the history of the keys over several runs and
+        -- the memory level.
+        for i = 1, 300 do
+            s:replace({i, i + 1000, 0})
+        end
+        box.snapshot()
+        for i = 1, 300, 3 do
+            s:upsert({i, i + 1000, 0}, {{'+', 3, 1}})
+        end
+        box.snapshot()
+        for i = 2, 300, 3 do
+            s:delete({i})
+        end
+        box.snapshot()
+        for i = 1, 300, 30 do
+            s:upsert({i, i + 1000, 0}, {{'+', 3, 10}})
+        end
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_get_many = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        for _, index in ipairs({s.index.pk, s.index.sk}) do
+            local offset = index.id == 0 and 0 or 1000
+            local keys = {}
+            local expected = {}
+            for i = 1, 320, 7 do
+                table.insert(keys, i + offset)
+                expected[#keys] = index:get(i + offset)
+            end
+            t.assert_equals(index:get_many(keys), expected)
+        end
+        -- The result reflects transaction changes.
+        box.begin()
+        s:replace({2, 1002, 100})
+        s:delete({4})
+        t.assert_equals(s:get_many({2, 4, 7}),
+                        {{2, 1002, 100}, nil, {7, 1007, 1}})
+        box.rollback()
+        t.assert_equals(s:get_many({2, 4, 7}),
+                        {nil, {4, 1004, 1}, {7, 1007, 1}})
+    end)
+end
+
+g.test_get_many_bloom = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local stat = s.index.pk:stat().disk.iterator
+        local keys = {}
+        for i = 1001, 1100 do
+            table.insert(keys, i)
+        end
+        t.assert_equals(s:get_many(keys), {})
+        -- Most missing keys are filtered out by bloom filters of
+        -- all three runs without reading the disk.
+        local new_stat = s.index.pk:stat().disk.iterator
+        t.assert_ge(new_stat.bloom.hit - stat.bloom.hit, 250)
+        t.assert_lt(new_stat.read.pages - stat.read.pages, 50)
+    end)
+end
@@ -0,0 +1,52 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {vinyl_cache = 0, vinyl_page_cache = 1024 * 1024},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('primary', {page_size = 64 * 1024})
+        for i = 1, 10 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_page_cache = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local st1 = box.stat.vinyl()
+        t.assert_equals(st1.memory.page_cache, 0)
+        t.assert_equals(s:get(1), {1, string.rep('x', 100)})
+        local st2 = box.stat.vinyl()
+        t.assert_gt(st2.page_cache.miss, st1.page_cache.miss)
+        t.assert_gt(st2.memory.page_cache, 0)
+
+        -- All keys are stored in the same page.
+        for i = 2, 10 do
+            t.assert_equals(s:get(i), {i, string.rep('x', 100)})
+        end
+        local st3 = box.stat.vinyl()
+        t.assert_ge(st3.page_cache.hit - st2.page_cache.hit, 9)
+        t.assert_equals(st3.page_cache.miss, st2.page_cache.miss)
+
+        -- Shrinking the cache evicts pages.
+        box.cfg({vinyl_page_cache = 0})
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        t.assert_equals(s:get(1), {1, string.rep('x', 100)})
+        local st4 = box.stat.vinyl()
+        t.assert_equals(st4.page_cache.hit, st3.page_cache.hit)
+        t.assert_equals(st4.page_cache.miss, st3.page_cache.miss)
+        box.cfg({vinyl_page_cache = 1024 * 1024})
+    end)
+end
@@ -0,0 +1,56 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {vinyl_write_threads = 4},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_parallel_compaction = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk', {
+            range_size = 16 * 1024, page_size = 512,
+            run_count_per_level = 100, parallel_compaction = true,
+        })
+        t.assert_equals(s.index.pk.options.parallel_compaction, true)
+        -- Make a range that has never been compacted, but stores
+        -- far more data than range_size, so that each run spans
+        -- the whole key space.
+        for i = 1, 10 do
+            box.begin()
+            for j = 1, 100 do
+                s:replace({j, i, string.rep('x', 100)})
+            end
+            box.commit()
+            box.snapshot()
+        end
+        t.assert_equals(s.index.pk:stat().range_count, 1)
+        t.assert_equals(s.index.pk:stat().run_count, 10)
+
+        -- The range is split before compaction so that its parts
+        -- can be compacted in parallel.
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_covers(box.stat.vinyl().scheduler, {
+                tasks_inprogress = 0, compaction_queue = 0,
+            })
+        end)
+        local stat = s.index.pk:stat()
+        t.assert_gt(stat.range_count, 1)
+        t.assert_equals(stat.run_count, stat.range_count)
+        t.assert_equals(s:count(), 100)
+        for j = 1, 100 do
+            t.assert_equals(s:get(j), {j, 10, string.rep('x', 100)})
+        end
+        s:drop()
+    end)
+end
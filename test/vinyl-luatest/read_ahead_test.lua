@@ -0,0 +1,61 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            vinyl_cache = 0,
+            vinyl_os_cache = false,
+            vinyl_read_ahead = 4096,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.vinyl_os_cache, false)
+        t.assert_equals(box.cfg.vinyl_read_ahead, 4096)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'vinyl_read_ahead': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {vinyl_read_ahead = -1})
+    end)
+end
+
+g.test_scan = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 256})
+        local expected = {}
+        for i = 1, 500 do
+            local tuple = {i, string.rep('x', 50)}
+            s:replace(tuple)
+            table.insert(expected, tuple)
+        end
+        box.snapshot()
+        t.assert_gt(s.index.pk:stat().disk.pages, 50)
+
+        t.assert_equals(s:select(), expected)
+        t.assert_equals(s:select(100, {iterator = 'ge', limit = 100}),
+                        {unpack(expected, 100, 199)})
+        local reversed = {}
+        for i = #expected, 1, -1 do
+            table.insert(reversed, expected[i])
+        end
+        t.assert_equals(s:select({}, {iterator = 'le'}), reversed)
+        t.assert_equals(s:select(400, {iterator = 'lt', limit = 100}),
+                        {unpack(reversed, 102, 201)})
+
+        box.cfg({vinyl_os_cache = true, vinyl_read_ahead = 0})
+        t.assert_equals(s:select(), expected)
+        box.cfg({vinyl_os_cache = false, vinyl_read_ahead = 4096})
+        s:drop()
+    end)
+end
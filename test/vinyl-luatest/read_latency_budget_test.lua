@@ -0,0 +1,50 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {vinyl_read_latency_budget = 0.01},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.vinyl_read_latency_budget, 0.01)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'vinyl_read_latency_budget': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {vinyl_read_latency_budget = -1})
+        box.cfg({vinyl_read_latency_budget = 0})
+        box.cfg({vinyl_read_latency_budget = 0.01})
+    end)
+end
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 200 do
+            s:replace({i})
+        end
+        box.snapshot()
+        for _ = 1, 5 do
+            for i = 1, 200 do
+                s:get(i)
+            end
+        end
+        -- The regulator checks read latency once a second.
+        t.helpers.retrying({}, function()
+            t.assert_gt(box.stat.vinyl().regulator.read_latency, 0)
+        end)
+        -- Nothing to compact so writes aren't throttled.
+        t.assert_equals(box.stat.vinyl().scheduler.compaction_queue, 0)
+        s:drop()
+    end)
+end
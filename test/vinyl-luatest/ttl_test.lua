@@ -0,0 +1,96 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_read = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk', {ttl_field = 2})
+        s:create_index('sk', {parts = {3, 'unsigned'}})
+        t.assert_equals(s.index.pk.options.ttl_field, 2)
+        t.assert_equals(s.index.sk.options.ttl_field, nil)
+
+        local now = fiber.time()
+        s:insert({1, now - 10, 10})
+        s:insert({2, now + 1000, 20})
+        s:insert({3, now - 10, 30})
+        box.snapshot()
+        s:insert({4, now - 10, 40})
+        s:insert({5, 0, 50})
+
+        t.assert_equals(s:get(1), nil)
+        t.assert_equals(s:get(2), {2, now + 1000, 20})
+        t.assert_equals(s:select(), {{2, now + 1000, 20}})
+        t.assert_equals(s.index.sk:select(), {{2, now + 1000, 20}})
+        t.assert_equals(s.index.sk:get(30), nil)
+        t.assert_equals(s:count(), 1)
+
+        -- An expired tuple can be overwritten by INSERT.
+        s:insert({1, now + 1000, 11})
+        t.assert_equals(s:get(1), {1, now + 1000, 11})
+        t.assert_equals(s.index.sk:select(10), {})
+        t.assert_equals(s.index.sk:select(11), {{1, now + 1000, 11}})
+
+        -- UPSERT over an expired tuple inserts a new tuple.
+        s:upsert({3, now + 1000, 31}, {{'=', 3, 32}})
+        s:upsert({4, now + 1000, 41}, {{'=', 3, 42}})
+        t.assert_equals(s:get(3), {3, now + 1000, 31})
+        t.assert_equals(s:get(4), {4, now + 1000, 41})
+    end)
+end
+
+g.test_compaction = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk', {ttl_field = 2})
+        local now = fiber.time()
+        for i = 1, 100 do
+            s:replace({i, i % 2 == 0 and now - 10 or now + 1000})
+        end
+        box.snapshot()
+        -- The whole range is dumped to the last level so
+        -- expired tuples are discarded right away.
+        t.assert_equals(s.index.pk:stat().disk.statement.replaces, 50)
+
+        for i = 1, 100, 2 do
+            s:replace({i, now - 10})
+        end
+        box.snapshot()
+        t.assert_equals(s.index.pk:stat().run_count, 2)
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 0)
+        end)
+        t.assert_equals(s:select(), {})
+    end)
+end
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_error_msg_contains(
+            "ttl_field is only supported by primary index",
+            s.create_index, s, 'sk', {parts = {2, 'unsigned'}, ttl_field = 3})
+    end)
+end
@@ -49,6 +49,8 @@
 
 #include "lua/utils.h"
 #include "lua/serializer.h"
+#include "lua/msgpack.h" /* luamp_push(), luamp_decode() */
+#include "msgpuck.h"
 #include "mp_extension_types.h" /* MP_DECIMAL, MP_UUID */
 #include "diag.h"
 #include "tt_static.h"
@@ -1106,6 +1108,416 @@ static int json_decode(lua_State *l)
     return 1;
 }
 
+/* ===== MSGPACK TRANSCODING ===== */
+
+/* JSON -> MsgPack.
+ *
+ * The number of elements of a JSON container is unknown until its end,
+ * so the longest MsgPack header is reserved for it and replaced with the
+ * actual one when the container is parsed. */
+
+enum {
+    /* Size of the array32/map32 header. */
+    JSON_MP_CONTAINER_HEADER_MAX = 5,
+};
+
+static void json_mp_process_value(lua_State *l, json_parse_t *json,
+                                  json_token_t *token, strbuf_t *mp);
+
+static int json_mp_container_begin(strbuf_t *mp)
+{
+    int offset = strbuf_length(mp);
+    strbuf_ensure_empty_length(mp, JSON_MP_CONTAINER_HEADER_MAX);
+    strbuf_extend_length(mp, JSON_MP_CONTAINER_HEADER_MAX);
+    return offset;
+}
+
+static void json_mp_container_end(strbuf_t *mp, int offset, uint32_t size,
+                                  bool is_map)
+{
+    char header[JSON_MP_CONTAINER_HEADER_MAX];
+    char *end = is_map ? mp_encode_map(header, size) :
+                mp_encode_array(header, size);
+    int header_len = end - header;
+    char *start = mp->buf + offset;
+    if (header_len < JSON_MP_CONTAINER_HEADER_MAX) {
+        int body_len = strbuf_length(mp) - offset -
+                       JSON_MP_CONTAINER_HEADER_MAX;
+        memmove(start + header_len, start + JSON_MP_CONTAINER_HEADER_MAX,
+                body_len);
+        mp->length -= JSON_MP_CONTAINER_HEADER_MAX - header_len;
+    }
+    memcpy(start, header, header_len);
+}
+
+static void json_mp_append_str(strbuf_t *mp, const char *str, uint32_t len)
+{
+    strbuf_ensure_empty_length(mp, mp_sizeof_str(len));
+    char *end = mp_encode_str(strbuf_empty_ptr(mp), str, len);
+    strbuf_extend_length(mp, end - strbuf_empty_ptr(mp));
+}
+
+static void json_mp_append_int(strbuf_t *mp, int64_t num)
+{
+    strbuf_ensure_empty_length(mp, 9);
+    char *pos = strbuf_empty_ptr(mp);
+    char *end = num >= 0 ? mp_encode_uint(pos, num) : mp_encode_int(pos, num);
+    strbuf_extend_length(mp, end - pos);
+}
+
+static void json_mp_append_uint(strbuf_t *mp, uint64_t num)
+{
+    strbuf_ensure_empty_length(mp, 9);
+    char *pos = strbuf_empty_ptr(mp);
+    strbuf_extend_length(mp, mp_encode_uint(pos, num) - pos);
+}
+
+/* Numbers are encoded the same way as msgpack.encode() encodes Lua
+ * numbers, so json.to_msgpack(s) is equal to
+ * msgpack.encode(json.decode(s)). */
+static void json_mp_append_number(strbuf_t *mp, double num)
+{
+    double intpart;
+    if (!isfinite(num) || modf(num, &intpart) == 0.0) {
+        if (num >= 0 && num < exp2(64))
+            return json_mp_append_uint(mp, (uint64_t)num);
+        if (num >= -exp2(63) && num < exp2(63))
+            return json_mp_append_int(mp, (int64_t)num);
+    }
+    strbuf_ensure_empty_length(mp, 9);
+    char *pos = strbuf_empty_ptr(mp);
+    strbuf_extend_length(mp, mp_encode_double(pos, num) - pos);
+}
+
+static void json_mp_append_bool(strbuf_t *mp, bool val)
+{
+    strbuf_ensure_empty_length(mp, 1);
+    char *pos = strbuf_empty_ptr(mp);
+    strbuf_extend_length(mp, mp_encode_bool(pos, val) - pos);
+}
+
+static void json_mp_append_nil(strbuf_t *mp)
+{
+    strbuf_ensure_empty_length(mp, 1);
+    char *pos = strbuf_empty_ptr(mp);
+    strbuf_extend_length(mp, mp_encode_nil(pos) - pos);
+}
+
+static void json_mp_parse_object_context(lua_State *l, json_parse_t *json,
+                                         strbuf_t *mp)
+{
+    json_token_t token;
+    uint32_t size = 0;
+
+    json_decode_descend(l, json, 0);
+    int offset = json_mp_container_begin(mp);
+
+    json_next_token(json, &token);
+
+    /* Handle empty objects */
+    if (token.type == T_OBJ_END) {
+        json_mp_container_end(mp, offset, size, true);
+        json_decode_ascend(json);
+        return;
+    }
+
+    while (1) {
+        if (token.type != T_STRING)
+            json_throw_parse_error(l, json, "object key string", &token);
+
+        json_mp_append_str(mp, token.value.string, token.string_len);
+
+        json_next_token(json, &token);
+        if (token.type != T_COLON)
+            json_throw_parse_error(l, json, "colon", &token);
+
+        json_next_token(json, &token);
+        json_mp_process_value(l, json, &token, mp);
+        size++;
+
+        json_next_token(json, &token);
+
+        if (token.type == T_OBJ_END) {
+            json_mp_container_end(mp, offset, size, true);
+            json_decode_ascend(json);
+            return;
+        }
+
+        if (token.type != T_COMMA)
+            json_throw_parse_error(l, json, "comma or '}'", &token);
+
+        json_next_token(json, &token);
+    }
+}
+
+static void json_mp_parse_array_context(lua_State *l, json_parse_t *json,
+                                        strbuf_t *mp)
+{
+    json_token_t token;
+    uint32_t size = 0;
+
+    json_decode_descend(l, json, 0);
+    int offset = json_mp_container_begin(mp);
+
+    json_next_token(json, &token);
+
+    /* Handle empty arrays */
+    if (token.type == T_ARR_END) {
+        json_mp_container_end(mp, offset, size, false);
+        json_decode_ascend(json);
+        return;
+    }
+
+    while (1) {
+        json_mp_process_value(l, json, &token, mp);
+        size++;
+
+        json_next_token(json, &token);
+
+        if (token.type == T_ARR_END) {
+            json_mp_container_end(mp, offset, size, false);
+            json_decode_ascend(json);
+            return;
+        }
+
+        if (token.type != T_COMMA)
+            json_throw_parse_error(l, json, "comma or ']'", &token);
+
+        json_next_token(json, &token);
+    }
+}
+
+static void json_mp_process_value(lua_State *l, json_parse_t *json,
+                                  json_token_t *token, strbuf_t *mp)
+{
+    switch (token->type) {
+    case T_STRING:
+        json_mp_append_str(mp, token->value.string, token->string_len);
+        break;
+    case T_UINT:
+        json_mp_append_uint(mp, token->value.ival);
+        break;
+    case T_INT:
+        json_mp_append_int(mp, token->value.ival);
+        break;
+    case T_NUMBER:
+        luaL_checkfinite(l, json->cfg, token->value.number);
+        json_mp_append_number(mp, token->value.number);
+        break;
+    case T_BOOLEAN:
+        json_mp_append_bool(mp, token->value.boolean);
+        break;
+    case T_OBJ_BEGIN:
+        json_mp_parse_object_context(l, json, mp);
+        break;
+    case T_ARR_BEGIN:
+        json_mp_parse_array_context(l, json, mp);
+        break;
+    case T_NULL:
+        json_mp_append_nil(mp);
+        break;
+    default:
+        json_throw_parse_error(l, json, "value", token);
+    }
+}
+
+/* Convert a JSON string to a msgpack object without creating
+ * intermediate Lua values. */
+static int json_to_msgpack(lua_State *l)
+{
+    json_parse_t json;
+    json_token_t token;
+    size_t json_len;
+
+    luaL_argcheck(l, lua_gettop(l) == 2 || lua_gettop(l) == 1, 1,
+                  "expected 1 or 2 arguments");
+
+    struct luaL_serializer *cfg = luaL_checkserializer(l);
+    struct luaL_serializer user_cfg;
+    json.cfg = cfg;
+    if (lua_gettop(l) == 2) {
+        luaL_serializer_copy_options(&user_cfg, cfg);
+        luaL_serializer_parse_options(l, &user_cfg);
+        lua_pop(l, 1);
+        json.cfg = &user_cfg;
+    }
+
+    json.data = luaL_checklstring(l, 1, &json_len);
+    json.current_depth = 0;
+    json.ptr = json.data;
+    json.line_count = 1;
+    json.cur_line_ptr = json.data;
+
+    if (json_len >= 2 && (!json.data[0] || !json.data[1]))
+        luaL_error(l, "JSON parser does not support UTF-16 or UTF-32");
+
+    strbuf_t decode_buf;
+    json.tmp = &decode_buf;
+    struct ibuf *ibuf = cord_ibuf_take();
+    strbuf_create(&decode_buf, json_len, ibuf);
+
+    /*
+     * Same as on encoding, it is fine to skip the output buffer
+     * destruction on a parse error, see json_encode().
+     */
+    strbuf_t mp_buf;
+    struct ibuf *mp_ibuf = cord_ibuf_take();
+    strbuf_create(&mp_buf, json_len + JSON_MP_CONTAINER_HEADER_MAX, mp_ibuf);
+
+    json_next_token(&json, &token);
+    json_mp_process_value(l, &json, &token, &mp_buf);
+
+    /* Ensure there is no more input left */
+    json_next_token(&json, &token);
+
+    if (token.type != T_END)
+        json_throw_parse_error(l, &json, "the end", &token);
+
+    strbuf_destroy(&decode_buf);
+    cord_ibuf_put(ibuf);
+
+    luamp_push(l, mp_buf.buf, mp_buf.buf + strbuf_length(&mp_buf));
+    strbuf_destroy(&mp_buf);
+    cord_ibuf_put(mp_ibuf);
+    return 1;
+}
+
+/* MsgPack -> JSON. */
+
+static void json_append_msgpack(lua_State *l, struct luaL_serializer *cfg,
+                                int current_depth, strbuf_t *json,
+                                const char **data);
+
+static void json_append_msgpack_number(lua_State *l,
+                                       struct luaL_serializer *cfg,
+                                       strbuf_t *json, double num)
+{
+    if (!isfinite(num) && !cfg->encode_invalid_numbers) {
+        if (!cfg->encode_invalid_as_nil)
+            luaL_error(l, "number must not be NaN or Inf");
+        return json_append_nil(cfg, json);
+    }
+    json_append_number(cfg, json, num);
+}
+
+static void json_append_msgpack_key(lua_State *l, struct luaL_serializer *cfg,
+                                    strbuf_t *json, const char **data)
+{
+    switch (mp_typeof(**data)) {
+    case MP_UINT:
+        strbuf_append_char(json, '"');
+        json_append_uint(cfg, json, mp_decode_uint(data));
+        strbuf_append_mem(json, "\":", 2);
+        break;
+    case MP_INT:
+        strbuf_append_char(json, '"');
+        json_append_int(cfg, json, mp_decode_int(data));
+        strbuf_append_mem(json, "\":", 2);
+        break;
+    case MP_STR:
+    {
+        uint32_t len;
+        const char *str = mp_decode_str(data, &len);
+        json_append_string(cfg, json, str, len);
+        strbuf_append_char(json, ':');
+        break;
+    }
+    default:
+        luaL_error(l, "table key must be a number or string");
+    }
+}
+
+static void json_append_msgpack(lua_State *l, struct luaL_serializer *cfg,
+                                int current_depth, strbuf_t *json,
+                                const char **data)
+{
+    uint32_t len, i;
+    const char *str;
+
+    switch (mp_typeof(**data)) {
+    case MP_UINT:
+        return json_append_uint(cfg, json, mp_decode_uint(data));
+    case MP_INT:
+        return json_append_int(cfg, json, mp_decode_int(data));
+    case MP_STR:
+        str = mp_decode_str(data, &len);
+        return json_append_string(cfg, json, str, len);
+    case MP_BIN:
+        str = mp_decode_bin(data, &len);
+        return json_append_string(cfg, json, str, len);
+    case MP_FLOAT:
+        return json_append_msgpack_number(l, cfg, json,
+                                          mp_decode_float(data));
+    case MP_DOUBLE:
+        return json_append_msgpack_number(l, cfg, json,
+                                          mp_decode_double(data));
+    case MP_BOOL:
+        if (mp_decode_bool(data))
+            strbuf_append_mem(json, "true", 4);
+        else
+            strbuf_append_mem(json, "false", 5);
+        return;
+    case MP_NIL:
+        mp_decode_nil(data);
+        return json_append_nil(cfg, json);
+    case MP_MAP:
+        if (current_depth >= cfg->encode_max_depth) {
+            if (! cfg->encode_deep_as_nil)
+                luaL_error(l, "Too high nest level");
+            mp_next(data);
+            return json_append_nil(cfg, json); /* Limit nested maps */
+        }
+        len = mp_decode_map(data);
+        strbuf_append_char(json, '{');
+        for (i = 0; i < len; i++) {
+            if (i > 0)
+                strbuf_append_char(json, ',');
+            json_append_msgpack_key(l, cfg, json, data);
+            json_append_msgpack(l, cfg, current_depth + 1, json, data);
+        }
+        strbuf_append_char(json, '}');
+        return;
+    case MP_ARRAY:
+        if (current_depth >= cfg->encode_max_depth) {
+            if (! cfg->encode_deep_as_nil)
+                luaL_error(l, "Too high nest level");
+            mp_next(data);
+            return json_append_nil(cfg, json); /* Limit nested arrays */
+        }
+        len = mp_decode_array(data);
+        strbuf_append_char(json, '[');
+        for (i = 0; i < len; i++) {
+            if (i > 0)
+                strbuf_append_char(json, ',');
+            json_append_msgpack(l, cfg, current_depth + 1, json, data);
+        }
+        strbuf_append_char(json, ']');
+        return;
+    case MP_EXT:
+        /* Extensions are rare, convert them via Lua values to share
+         * the formatting with json.encode(). */
+        luamp_decode(l, luaL_msgpack_default, data);
+        json_append_data(l, cfg, current_depth, json);
+        lua_pop(l, 1);
+        return;
+    default:
+        unreachable();
+    }
+}
+
+void
+luaT_json_push_from_msgpack(struct lua_State *L, const char *data)
+{
+    strbuf_t encode_buf;
+    struct ibuf *ibuf = cord_ibuf_take();
+    strbuf_create(&encode_buf, STRBUF_DEFAULT_SIZE, ibuf);
+    json_append_msgpack(L, luaL_json_default, 0, &encode_buf, &data);
+    lua_pushlstring(L, encode_buf.buf, strbuf_length(&encode_buf));
+    /* See the comment in json_encode(). */
+    strbuf_destroy(&encode_buf);
+    cord_ibuf_put(ibuf);
+}
+
 /* ===== INITIALISATION ===== */
 
 static int
@@ -1114,6 +1526,7 @@ json_new(lua_State *L);
 static const luaL_Reg jsonlib[] = {
     { "encode", json_encode },
     { "decode", json_decode },
+    { "to_msgpack", json_to_msgpack },
     { "new",    json_new },
     { NULL, NULL}
 };
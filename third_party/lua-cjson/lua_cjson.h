@@ -10,6 +10,15 @@ extern "C" {
 LUALIB_API  int
 luaopen_json(lua_State *L);
 
+/**
+ * Encode the MsgPack value at @a data as JSON with the default json
+ * serializer options and push the resulting string to the Lua stack.
+ * The data must be valid MsgPack. Raises a Lua error if the value
+ * can't be represented in JSON.
+ */
+void
+luaT_json_push_from_msgpack(struct lua_State *L, const char *data);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif